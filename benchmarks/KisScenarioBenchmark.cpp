@@ -0,0 +1,384 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisScenarioBenchmark.h"
+
+#include <atomic>
+#include <cmath>
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+#include <QThread>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KritaVersionWrapper.h>
+
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/KisStrokeRecording.h>
+#include <filter/kis_filter.h>
+#include <filter/kis_filter_configuration.h>
+#include <filter/kis_filter_registry.h>
+#include <KisGlobalResourcesInterface.h>
+#include "tiles3/kis_tile_data_store.h"
+
+namespace {
+
+/// a phase is reported as a regression if it became slower by this ratio...
+const qreal regressionRatio = 1.10;
+
+/// ...and by at least this number of milliseconds, to skip the noise of the short phases
+const qint64 regressionMinDelta = 50;
+
+/**
+ * Polls the tile engine in the background to catch the peak memory
+ * usage of a phase, the phases themselves block the main thread
+ */
+class MemorySampler : public QThread
+{
+public:
+    MemorySampler()
+        : m_stop(false),
+          m_peak(0)
+    {
+    }
+
+    void startSampling() {
+        m_stop = false;
+        m_peak = currentMemory();
+        start();
+    }
+
+    qint64 stopSampling() {
+        m_stop = true;
+        wait();
+        return qMax(m_peak.load(), currentMemory());
+    }
+
+    static qint64 currentMemory() {
+        return KisTileDataStore::instance()->memoryStatistics().totalMemorySize;
+    }
+
+protected:
+    void run() override {
+        while (!m_stop) {
+            const qint64 value = currentMemory();
+            if (value > m_peak) {
+                m_peak = value;
+            }
+            msleep(5);
+        }
+    }
+
+private:
+    std::atomic<bool> m_stop;
+    std::atomic<qint64> m_peak;
+};
+
+qint64 peakProcessMemory()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) {
+#ifdef Q_OS_MACOS
+        return usage.ru_maxrss;
+#else
+        return qint64(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return -1;
+}
+
+KisPaintLayerSP findPaintLayer(KisNodeSP node)
+{
+    for (KisNodeSP child = node->firstChild(); child; child = child->nextSibling()) {
+        if (KisPaintLayer *layer = dynamic_cast<KisPaintLayer*>(child.data())) {
+            return layer;
+        }
+
+        KisPaintLayerSP layer = findPaintLayer(child);
+        if (layer) return layer;
+    }
+
+    return 0;
+}
+
+QStringList corpusFiles()
+{
+    const QString corpusDir = QString::fromLocal8Bit(qgetenv("KRITA_BENCHMARK_CORPUS"));
+    if (corpusDir.isEmpty()) {
+        return QStringList() << QString(FILES_DATA_DIR) + '/' + "load_test.kra";
+    }
+
+    QStringList files;
+    QDir dir(corpusDir);
+    Q_FOREACH (const QString &fileName, dir.entryList(QStringList() << "*.kra", QDir::Files, QDir::Name)) {
+        files << dir.absoluteFilePath(fileName);
+    }
+    return files;
+}
+
+class ScenarioRunner
+{
+public:
+    ScenarioRunner(const QString &fileName)
+        : m_fileName(fileName)
+    {
+    }
+
+    template <typename Func>
+    bool runPhase(const QString &name, Func func) {
+        MemorySampler sampler;
+        QElapsedTimer timer;
+
+        sampler.startSampling();
+        timer.start();
+
+        const bool result = func();
+        if (m_document && m_document->image()) {
+            m_document->image()->waitForDone();
+        }
+
+        const qint64 time = timer.elapsed();
+        const qint64 peakMemory = sampler.stopSampling();
+
+        QJsonObject phase;
+        phase["name"] = name;
+        phase["success"] = result;
+        phase["time_ms"] = time;
+        phase["peak_tiles_memory_bytes"] = peakMemory;
+        phase["tiles_memory_bytes"] = MemorySampler::currentMemory();
+        m_phases.append(phase);
+
+        qDebug() << QFileInfo(m_fileName).fileName() << name << time << "ms"
+                 << "peak tiles memory:" << peakMemory / (1024 * 1024) << "MiB";
+
+        return result;
+    }
+
+    QJsonObject run() {
+        const QString outputBase = QString(FILES_OUTPUT_DIR) + '/' + QFileInfo(m_fileName).completeBaseName();
+
+        const bool opened = runPhase("open", [this] () {
+            m_document.reset(KisPart::instance()->createDocument());
+            m_document->setFileBatchMode(true);
+            return m_document->loadNativeFormat(m_fileName);
+        });
+
+        QJsonObject report;
+        report["file"] = QFileInfo(m_fileName).fileName();
+
+        if (opened) {
+            KisImageSP image = m_document->image();
+            report["width"] = image->width();
+            report["height"] = image->height();
+            report["color_space"] = image->colorSpace()->id();
+
+            runPhase("paint", [this] () { return paint(); });
+            runPhase("filter", [this] () { return filter(); });
+            runPhase("transform", [this] () {
+                m_document->image()->rotateImage(M_PI / 2);
+                return true;
+            });
+
+            const QString savedFile = outputBase + "_scenario.kra";
+            runPhase("save", [this, savedFile] () {
+                return m_document->exportDocumentSync(QUrl::fromLocalFile(savedFile), "application/x-krita");
+            });
+            QFile::remove(savedFile);
+
+            const QString exportedFile = outputBase + "_scenario.png";
+            runPhase("export", [this, exportedFile] () {
+                return m_document->exportDocumentSync(QUrl::fromLocalFile(exportedFile), "image/png");
+            });
+            QFile::remove(exportedFile);
+        }
+
+        m_document.reset();
+
+        report["phases"] = m_phases;
+        return report;
+    }
+
+private:
+    bool paint() {
+        KisImageSP image = m_document->image();
+
+        KisPaintOpPresetSP preset(new KisPaintOpPreset(QString(FILES_DATA_DIR) + '/' + "autobrush_300px.kpp"));
+        if (!preset->load(KisGlobalResourcesInterface::instance())) return false;
+
+        KisPaintLayerSP layer = new KisPaintLayer(image, "scenario stroke", OPACITY_OPAQUE_U8);
+        image->addNode(layer, image->root());
+        m_strokeLayer = layer;
+
+        KisPainter painter(layer->paintDevice());
+        painter.setPaintColor(KoColor(Qt::black, layer->colorSpace()));
+        painter.setPaintOpPreset(preset, layer, image);
+
+        KisStrokeRecording recording;
+        const QString recordingFileName = QString::fromLocal8Bit(qgetenv("KRITA_STROKE_RECORDING"));
+
+        if (!recordingFileName.isEmpty() && recording.load(recordingFileName)) {
+            KisDistanceInformation currentDistance;
+            recording.replay(&painter, &currentDistance);
+        } else {
+            // a zigzag over the whole image, like a few long hatching strokes
+            const QRect bounds = image->bounds();
+            const int numStrokes = 10;
+
+            for (int i = 0; i < numStrokes; i++) {
+                const qreal y0 = bounds.top() + bounds.height() * qreal(i) / numStrokes;
+                const qreal y1 = bounds.top() + bounds.height() * qreal(i + 1) / numStrokes;
+
+                KisDistanceInformation currentDistance;
+                painter.paintLine(KisPaintInformation(QPointF(bounds.left(), y0), 0.2),
+                                  KisPaintInformation(QPointF(bounds.right(), y1), 1.0),
+                                  &currentDistance);
+            }
+        }
+
+        layer->setDirty(painter.takeDirtyRegion());
+        return true;
+    }
+
+    bool filter() {
+        KisImageSP image = m_document->image();
+
+        KisPaintLayerSP layer = findPaintLayer(image->root());
+        if (!layer) {
+            layer = m_strokeLayer;
+        }
+        if (!layer) return false;
+
+        KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+        if (!filter) return false;
+
+        KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+        const QRect rc = layer->paintDevice()->exactBounds() & image->bounds();
+        filter->process(layer->paintDevice(), rc, config);
+        layer->setDirty(rc);
+
+        return true;
+    }
+
+private:
+    QString m_fileName;
+    QScopedPointer<KisDocument> m_document;
+    KisPaintLayerSP m_strokeLayer;
+    QJsonArray m_phases;
+};
+
+QJsonArray findRegressions(const QJsonArray &documents, const QString &baselineFileName)
+{
+    QJsonArray regressions;
+
+    QFile file(baselineFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open the baseline report" << baselineFileName;
+        return regressions;
+    }
+
+    QHash<QString, qint64> baselineTimes;
+
+    const QJsonArray baselineDocuments = QJsonDocument::fromJson(file.readAll()).object()["documents"].toArray();
+    Q_FOREACH (const QJsonValue &document, baselineDocuments) {
+        const QString fileName = document.toObject()["file"].toString();
+        Q_FOREACH (const QJsonValue &phase, document.toObject()["phases"].toArray()) {
+            baselineTimes.insert(fileName + '/' + phase.toObject()["name"].toString(),
+                                 qint64(phase.toObject()["time_ms"].toDouble()));
+        }
+    }
+
+    Q_FOREACH (const QJsonValue &document, documents) {
+        const QString fileName = document.toObject()["file"].toString();
+        Q_FOREACH (const QJsonValue &phase, document.toObject()["phases"].toArray()) {
+            const QString name = phase.toObject()["name"].toString();
+            const QString key = fileName + '/' + name;
+            if (!baselineTimes.contains(key)) continue;
+
+            const qint64 baselineTime = baselineTimes.value(key);
+            const qint64 time = qint64(phase.toObject()["time_ms"].toDouble());
+
+            if (time > baselineTime * regressionRatio &&
+                time - baselineTime >= regressionMinDelta) {
+
+                QJsonObject regression;
+                regression["file"] = fileName;
+                regression["phase"] = name;
+                regression["baseline_time_ms"] = baselineTime;
+                regression["time_ms"] = time;
+                regressions.append(regression);
+
+                qWarning() << "Regression:" << key << baselineTime << "ms ->" << time << "ms";
+            }
+        }
+    }
+
+    return regressions;
+}
+
+}
+
+void KisScenarioBenchmark::benchmarkScenarios()
+{
+    const QStringList files = corpusFiles();
+    if (files.isEmpty()) {
+        QSKIP("The corpus contains no .kra files");
+    }
+
+    QJsonArray documents;
+    Q_FOREACH (const QString &fileName, files) {
+        ScenarioRunner runner(fileName);
+        documents.append(runner.run());
+    }
+
+    QJsonObject report;
+    report["krita_version"] = KritaVersionWrapper::versionString(true);
+    report["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["ideal_thread_count"] = QThread::idealThreadCount();
+    report["peak_process_memory_bytes"] = peakProcessMemory();
+    report["documents"] = documents;
+
+    const QString baselineFileName = QString::fromLocal8Bit(qgetenv("KRITA_BENCHMARK_BASELINE"));
+    if (!baselineFileName.isEmpty()) {
+        report["regressions"] = findRegressions(documents, baselineFileName);
+    }
+
+    QString reportFileName = QString::fromLocal8Bit(qgetenv("KRITA_BENCHMARK_REPORT"));
+    if (reportFileName.isEmpty()) {
+        reportFileName = QString(FILES_OUTPUT_DIR) + '/' + "scenario_benchmark.json";
+    }
+
+    QFile reportFile(reportFileName);
+    QVERIFY(reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    reportFile.write(QJsonDocument(report).toJson());
+
+    qDebug() << "The scenario report is written to" << reportFileName;
+}
+
+QTEST_MAIN(KisScenarioBenchmark)
@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSCENARIOBENCHMARK_H
+#define KISSCENARIOBENCHMARK_H
+
+#include <QtTest>
+
+/**
+ * Runs the typical session on every document of the corpus: open, paint
+ * replay, filter, transform, save and export. The time and the peak
+ * memory of every phase are written into a JSON report, which can be
+ * compared against the report of another version.
+ *
+ * Environment variables:
+ *
+ * KRITA_BENCHMARK_CORPUS    a directory with the .kra files, by default
+ *                           load_test.kra from the benchmarks data
+ * KRITA_BENCHMARK_REPORT    the path of the JSON report, by default
+ *                           scenario_benchmark.json in the output directory
+ * KRITA_BENCHMARK_BASELINE  a report of a previous run; the phases that
+ *                           became noticeably slower are listed in the
+ *                           "regressions" section of the new report
+ * KRITA_STROKE_RECORDING    a stroke recording to replay in the paint
+ *                           phase, see KisStrokeRecording
+ */
+class KisScenarioBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkScenarios();
+};
+
+#endif // KISSCENARIOBENCHMARK_H
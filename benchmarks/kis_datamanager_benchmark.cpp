@@ -8,6 +8,7 @@
 #include "kis_benchmark_values.h"
 
 #include <QTest>
+#include <QThread>
 #include <kis_datamanager.h>
 
 // RGBA
@@ -186,5 +187,119 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+/**
+ * Number of tile fetches every thread does per benchmark iteration
+ */
+#define TILE_ACCESS_CYCLES 1000
+
+class ConcurrentTileAccessJob : public QThread
+{
+public:
+    ConcurrentTileAccessJob(KisDataManager *dm, bool writable, int seed, int numCols, int numRows)
+        : m_dm(dm),
+          m_writable(writable),
+          m_seed(seed),
+          m_numCols(numCols),
+          m_numRows(numRows)
+    {
+    }
+
+    void run() override {
+        /**
+         * Every thread walks the tiles in its own order, so that
+         * the accesses to the same cells of the hash table
+         * overlap as much as possible
+         */
+        int col = m_seed % m_numCols;
+        int row = (m_seed / m_numCols) % m_numRows;
+
+        for (int i = 0; i < TILE_ACCESS_CYCLES; i++) {
+            KisTileSP tile = m_dm->getTile(col, row, m_writable);
+            Q_UNUSED(tile);
+
+            col = (col + 1) % m_numCols;
+            if (!col) {
+                row = (row + 1) % m_numRows;
+            }
+        }
+    }
+
+private:
+    KisDataManager *m_dm;
+    bool m_writable;
+    int m_seed;
+    int m_numCols;
+    int m_numRows;
+};
+
+void populateThreadsData()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        QTest::addRow("%d threads", numThreads) << numThreads;
+    }
+}
+
+void runConcurrentTileAccess(bool writable, int numThreads)
+{
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    const int numCols = TEST_IMAGE_WIDTH / KisTileData::WIDTH;
+    const int numRows = TEST_IMAGE_HEIGHT / KisTileData::HEIGHT;
+
+    /**
+     * Only a half of the image is filled with real tiles, so that
+     * both, the hits and the misses in the hash table were measured
+     */
+    quint8 *bytes = new quint8[PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT / 2];
+    memset(bytes, 128, PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT / 2);
+    dm.writeBytes(bytes, 0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT / 2);
+    delete[] bytes;
+
+    QBENCHMARK {
+        QVector<ConcurrentTileAccessJob*> jobs;
+
+        for (int i = 0; i < numThreads; i++) {
+            jobs << new ConcurrentTileAccessJob(&dm, writable, i * 17, numCols, numRows);
+        }
+
+        Q_FOREACH (ConcurrentTileAccessJob *job, jobs) {
+            job->start();
+        }
+
+        Q_FOREACH (ConcurrentTileAccessJob *job, jobs) {
+            job->wait();
+        }
+
+        qDeleteAll(jobs);
+    }
+
+    delete[] p;
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentGetTile_data()
+{
+    populateThreadsData();
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentGetTile()
+{
+    QFETCH(int, numThreads);
+    runConcurrentTileAccess(true, numThreads);
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentGetReadOnlyTile_data()
+{
+    populateThreadsData();
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentGetReadOnlyTile()
+{
+    QFETCH(int, numThreads);
+    runConcurrentTileAccess(false, numThreads);
+}
 
 QTEST_MAIN(KisDatamanagerBenchmark)
@@ -24,6 +24,11 @@ private Q_SLOTS:
     void benchmarkExtent();
     void benchmarkClear();
     void benchmarkMemCpy();
+
+    void benchmarkConcurrentGetTile_data();
+    void benchmarkConcurrentGetTile();
+    void benchmarkConcurrentGetReadOnlyTile_data();
+    void benchmarkConcurrentGetReadOnlyTile();
 };
 
 #endif
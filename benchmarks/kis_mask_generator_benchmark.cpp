@@ -25,6 +25,11 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_cubic_curve.h"
 
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
@@ -96,4 +101,110 @@ void KisMaskGeneratorBenchmark::benchmarkSquare()
     }
 }
 
+template <class MaskGenerator>
+void benchmarkApplicator(MaskGenerator &gen, bool forceScalar)
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+    dev->setRect(QRect(0, 0, 1000, 1000));
+    dev->initialize();
+
+    MaskProcessingData data(dev, cs, nullptr,
+                            0.0, 1.0,
+                            500, 500, 0);
+
+    gen.setSoftness(0.5);
+    gen.resetMaskApplicator(forceScalar);
+
+    KisBrushMaskApplicatorBase *applicator = gen.applicator();
+    applicator->initializeData(&data);
+
+    QVector<QRect> rects = KritaUtils::splitRectIntoPatches(dev->bounds(), QSize(63, 63));
+
+    QBENCHMARK{
+        Q_FOREACH (const QRect &rc, rects) {
+            applicator->process(rc);
+        }
+    }
+}
+
+KisCubicCurve benchmarkCurve()
+{
+    KisCubicCurve curve;
+    curve.fromString(QString("0,1;0.5,0.3;1,0"));
+    return curve;
+}
+
+void KisMaskGeneratorBenchmark::benchmarkCircleScalar()
+{
+    KisCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkCircleVector()
+{
+    KisCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGaussCircleScalar()
+{
+    KisGaussCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGaussCircleVector()
+{
+    KisGaussCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSoftCircleScalar()
+{
+    KisCurveCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, benchmarkCurve(), true);
+    benchmarkApplicator(gen, true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSoftCircleVector()
+{
+    KisCurveCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, benchmarkCurve(), true);
+    benchmarkApplicator(gen, false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkRectangleScalar()
+{
+    KisRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkRectangleVector()
+{
+    KisRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGaussRectangleScalar()
+{
+    KisGaussRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGaussRectangleVector()
+{
+    KisGaussRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(gen, false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSoftRectangleScalar()
+{
+    KisCurveRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, benchmarkCurve(), true);
+    benchmarkApplicator(gen, true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSoftRectangleVector()
+{
+    KisCurveRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, benchmarkCurve(), true);
+    benchmarkApplicator(gen, false);
+}
+
 QTEST_MAIN(KisMaskGeneratorBenchmark)
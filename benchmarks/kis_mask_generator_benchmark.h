@@ -18,6 +18,19 @@ private Q_SLOTS:
     void benchmarkSIMD_FadedBrush();
     void benchmarkSquare();
 
+    void benchmarkCircleScalar();
+    void benchmarkCircleVector();
+    void benchmarkGaussCircleScalar();
+    void benchmarkGaussCircleVector();
+    void benchmarkSoftCircleScalar();
+    void benchmarkSoftCircleVector();
+    void benchmarkRectangleScalar();
+    void benchmarkRectangleVector();
+    void benchmarkGaussRectangleScalar();
+    void benchmarkGaussRectangleVector();
+    void benchmarkSoftRectangleScalar();
+    void benchmarkSoftRectangleVector();
+
 };
 
 #endif
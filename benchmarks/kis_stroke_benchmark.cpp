@@ -14,6 +14,7 @@ inline double drand48()
 }
 #endif
 
+#include <QElapsedTimer>
 #include <QPainterPath>
 #include <QTest>
 
@@ -32,6 +33,7 @@ inline double drand48()
 
 #include <brushengine/kis_paint_information.h>
 #include <brushengine/kis_paintop_preset.h>
+#include <brushengine/KisStrokeRecording.h>
 
 #define GMP_IMAGE_WIDTH 3274
 #define GMP_IMAGE_HEIGHT 2067
@@ -584,6 +586,67 @@ void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
 #endif
 }
 
+void KisStrokeBenchmark::benchmarkRecordedStroke(QString presetFileName, QString recordingFileName)
+{
+    KisStrokeRecording recording;
+    if (!recording.load(recordingFileName)) {
+        QSKIP("The stroke recording was not loaded");
+    }
+
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
+    bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
+    if (!loadedOk){
+        dbgKrita << "The preset was not loaded correctly. Done.";
+        return;
+    } else {
+        dbgKrita << "preset : " << presetFileName << "recording : " << recordingFileName;
+    }
+
+    m_painter->setPaintOpPreset(preset, m_layer, m_image);
+
+    {
+        // a separate run to report the statistics of a single replay
+        KisDistanceInformation currentDistance;
+        QElapsedTimer timer;
+        timer.start();
+        recording.replay(m_painter, &currentDistance);
+        const qreal strokeTime = timer.nsecsElapsed() / 1000000.0;
+
+        const int numDabs = currentDistance.currentDabSeqNo();
+
+        qDebug() << "Replayed" << recording.numSamples() << "samples,"
+                 << "recorded stroke time:" << recording.duration() << "ms";
+        qDebug() << "Replay time:" << strokeTime << "ms,"
+                 << "dabs:" << numDabs << ","
+                 << "dabs per second:" << (strokeTime > 0 ? 1000.0 * numDabs / strokeTime : 0.0) << ","
+                 << "average dab time:" << (numDabs > 0 ? strokeTime / numDabs : 0.0) << "ms";
+    }
+
+    QBENCHMARK{
+        KisDistanceInformation currentDistance;
+        recording.replay(m_painter, &currentDistance);
+    }
+
+#ifdef SAVE_OUTPUT
+    m_layer->paintDevice()->convertToQImage(0).save(m_outputPath + presetFileName + "_recorded" + OUTPUT_FORMAT);
+#endif
+}
+
+void KisStrokeBenchmark::recordedStroke()
+{
+    const QString recordingFileName = QString::fromLocal8Bit(qgetenv("KRITA_STROKE_RECORDING"));
+    if (recordingFileName.isEmpty()) {
+        QSKIP("Set KRITA_STROKE_RECORDING to a stroke recorded into KisConfig::strokeRecordingDirectory()");
+    }
+
+    QString presetFileName = QString::fromLocal8Bit(qgetenv("KRITA_STROKE_PRESET"));
+    if (presetFileName.isEmpty()) {
+        presetFileName = "softbrush_30px.kpp";
+    }
+
+    benchmarkRecordedStroke(presetFileName, recordingFileName);
+}
+
 static const int COUNT = 1000000;
 void KisStrokeBenchmark::benchmarkRand48()
 {
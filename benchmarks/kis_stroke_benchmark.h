@@ -56,6 +56,7 @@ private:
         inline void benchmarkLine(QString presetFileName);
         inline void benchmarkCircle(QString presetFileName);
         inline void benchmarkRectangle(QString presetFileName);
+        inline void benchmarkRecordedStroke(QString presetFileName, QString recordingFileName);
 
 private Q_SLOTS:
     void initTestCase();
@@ -127,6 +128,9 @@ private Q_SLOTS:
     void predefinedBrush();
     void predefinedBrushRL();
 */
+    // Replays KRITA_STROKE_RECORDING with KRITA_STROKE_PRESET
+    void recordedStroke();
+
     void benchmarkRand();
     void benchmarkRand48();
 
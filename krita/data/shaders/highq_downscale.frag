@@ -10,6 +10,10 @@ uniform sampler2D texture0;
 uniform sampler3D texture1;
 #endif
 
+#ifdef USE_DISPLAY_LUT
+uniform sampler3D texture2;
+#endif
+
 in vec4 v_textureCoordinate;
 out vec4 fragColor;
 
@@ -80,6 +84,42 @@ vec4 filterPureLinear8(sampler2D texture, vec2 texcoord)
 
 #endif /* HIGHQ_SCALING */
 
+#ifdef USE_DISPLAY_LUT
+
+vec4 applyDisplayLut(vec4 col, sampler3D lut)
+{
+    vec3 rgb = clamp(col.rgb, 0.0, 1.0);
+
+#ifdef DISPLAY_LUT_SHAPER
+    rgb = sqrt(rgb);
+#endif /* DISPLAY_LUT_SHAPER */
+
+    // sample the centers of the edge texels
+    const float scale = (DISPLAY_LUT_SIZE - 1.0) / DISPLAY_LUT_SIZE;
+    const float offset = 0.5 / DISPLAY_LUT_SIZE;
+
+    return vec4(texture(lut, rgb * scale + offset).rgb, col.a);
+}
+
+#endif /* USE_DISPLAY_LUT */
+
+#ifdef ENCODE_SURFACE_PQ
+
+// the same curve as the one of the p2020-pq color spaces, 1.0 is 80 nits
+vec4 applySmpte2048Curve(vec4 col)
+{
+    const float m1 = 2610.0 / 4096.0 / 4.0;
+    const float m2 = 2523.0 / 4096.0 * 128.0;
+    const float a1 = 3424.0 / 4096.0;
+    const float c2 = 2413.0 / 4096.0 * 32.0;
+    const float c3 = 2392.0 / 4096.0 * 32.0;
+
+    vec3 x_p = pow(0.008 * max(col.rgb, vec3(0.0)), vec3(m1));
+    return vec4(pow((a1 + c2 * x_p) / (1.0 + c3 * x_p), vec3(m2)), col.a);
+}
+
+#endif /* ENCODE_SURFACE_PQ */
+
 void main() {
     vec4 col;
 
@@ -121,6 +161,14 @@ void main() {
         }
     }
 
+#ifdef USE_DISPLAY_LUT
+    col = applyDisplayLut(col, texture2);
+#endif /* USE_DISPLAY_LUT */
+
+#ifdef ENCODE_SURFACE_PQ
+    col = applySmpte2048Curve(col);
+#endif /* ENCODE_SURFACE_PQ */
+
 #ifdef USE_OCIO
     fragColor = OCIODisplay(col, texture1);
 #else /* USE_OCIO */
@@ -54,6 +54,7 @@
 #include "input/KisQtWidgetsTweaker.h"
 #include <KisUsageLogger.h>
 #include <kis_image_config.h>
+#include <KisCpuAffinity.h>
 
 #ifdef Q_OS_ANDROID
 #include <QtAndroid>
@@ -515,7 +516,7 @@ extern "C" int main(int argc, char **argv)
     if (app.isRunning()) {
         // only pass arguments to main instance if they are not for batch processing
         // any batch processing would be done in this separate instance
-        const bool batchRun = args.exportAs() || args.exportSequence();
+        const bool batchRun = args.exportAs() || args.exportSequence() || !args.exportBatch().isEmpty();
 
         if (!batchRun) {
             QByteArray ba = args.serialize();
@@ -525,6 +526,20 @@ extern "C" int main(int argc, char **argv)
         }
     }
 
+    {
+        // pin the process before any worker threads are started,
+        // so that all of them inherit the affinity
+        const QString cpuAffinity = !args.cpuAffinity().isEmpty() ?
+            args.cpuAffinity() : KisImageConfig(true).cpuAffinity();
+
+        if (!cpuAffinity.isEmpty()) {
+            const QVector<int> cpus = KisCpuAffinity::parseCpuList(cpuAffinity);
+            if (!KisCpuAffinity::setProcessAffinity(cpus)) {
+                qWarning() << "Could not set CPU affinity to" << cpuAffinity;
+            }
+        }
+    }
+
     if (!runningInKDE) {
         // Icons in menus are ugly and distracting
         app.setAttribute(Qt::AA_DontShowIconsInMenus);
@@ -79,6 +79,16 @@ public:
 
     void next() override
     {
+        /**
+         * The brushes are iterated to be added to the database, which
+         * needs only their thumbnails. Their tips are decoded again when
+         * they are used, so that a library of a thousand big brushes
+         * doesn't stay decoded in memory.
+         */
+        if (m_currentResource) {
+            m_currentResource->releaseBrushTipImage();
+        }
+
         m_brushCollectionIterator++;
         m_currentResource = m_brushCollectionIterator.value();
         m_currentUrl = m_brushCollectionIterator.key();
@@ -90,6 +100,10 @@ public:
 
     KoResourceSP resource() const override
     {
+        if (m_currentResource) {
+            // decodes the tip, which generates the thumbnail
+            m_currentResource->brushTipImage();
+        }
         return m_currentResource;
     }
 };
@@ -38,6 +38,7 @@ KisAbrBrush::KisAbrBrush(const QString& filename, KisAbrBrushCollection *parent)
 KisAbrBrush::KisAbrBrush(const KisAbrBrush& rhs)
     : KoEphemeralResource<KisScalingSizeBrush>(rhs)
     , m_parent(0)
+    , m_brushTipDecoded(true)
 {
     // Warning! The brush became detached from the parent collection!
 }
@@ -45,11 +46,16 @@ KisAbrBrush::KisAbrBrush(const KisAbrBrush& rhs)
 KisAbrBrush::KisAbrBrush(const KisAbrBrush& rhs, KisAbrBrushCollection *parent)
     : KoEphemeralResource<KisScalingSizeBrush>(rhs)
     , m_parent(parent)
+    , m_brushTipDecoded(rhs.m_brushTipDecoded)
 {
 }
 
 KoResourceSP KisAbrBrush::clone() const
 {
+    // the clone is detached from the collection, so it cannot decode the tip itself
+    brushTipImage();
+
+    QMutexLocker l(&m_brushTipMutex);
     return KoResourceSP(new KisAbrBrush(*this));
 }
 
@@ -58,9 +64,32 @@ void KisAbrBrush::setBrushTipImage(const QImage& image)
     setValid(true);
     setBrushType(MASK);
 
+    QMutexLocker l(&m_brushTipMutex);
+    m_brushTipDecoded = true;
     KisBrush::setBrushTipImage(image);
 }
 
+void KisAbrBrush::setLazyBrushTip(qint32 width, qint32 height)
+{
+    setValid(true);
+    setBrushType(MASK);
+    setWidth(width);
+    setHeight(height);
+
+    QMutexLocker l(&m_brushTipMutex);
+    m_brushTipDecoded = false;
+    clearBrushPyramid();
+}
+
+void KisAbrBrush::releaseBrushTipImage()
+{
+    QMutexLocker l(&m_brushTipMutex);
+    if (!m_parent || !m_brushTipDecoded) return;
+
+    m_brushTipDecoded = false;
+    KisBrush::setBrushTipImage(QImage());
+}
+
 void KisAbrBrush::toXML(QDomDocument& d, QDomElement& e) const
 {
     e.setAttribute("name", name()); // legacy
@@ -75,8 +104,13 @@ QString KisAbrBrush::defaultFileExtension() const
 
 QImage KisAbrBrush::brushTipImage() const
 {
-    if (KisBrush::brushTipImage().isNull() && m_parent) {
-        m_parent->load();
+    QMutexLocker l(&m_brushTipMutex);
+
+    if (!m_brushTipDecoded && m_parent) {
+        m_brushTipDecoded = true;
+        // sets the thumbnail as well, which is needed when the brush is added to the database
+        const_cast<KisAbrBrush*>(this)->KisBrush::setBrushTipImage(m_parent->decodeBrushTip(filename()));
     }
+
     return KisBrush::brushTipImage();
 }
@@ -10,6 +10,7 @@
 
 #include <QImage>
 #include <QVector>
+#include <QMutex>
 
 #include <kis_scaling_size_brush.h>
 #include <kis_types.h>
@@ -55,8 +56,20 @@ public:
 
     void toXML(QDomDocument& d, QDomElement& e) const override;
 
+    /**
+     * Drops the decoded tip of a brush that is still attached to its
+     * collection, it is decoded again when needed. The thumbnail and the
+     * size of the brush are kept.
+     */
+    void releaseBrushTipImage();
+
 private:
+    /// sets up a brush whose tip is decoded by the parent collection on first use
+    void setLazyBrushTip(qint32 width, qint32 height);
+
     KisAbrBrushCollection *m_parent;
+    mutable QMutex m_brushTipMutex;
+    mutable bool m_brushTipDecoded {false};
 };
 
 typedef QSharedPointer<KisAbrBrush> KisAbrBrushSP;
@@ -53,7 +53,7 @@ static QImage convertToQImage(char * buffer, qint32 width, qint32 height)
     return img;
 }
 
-static qint32 rle_decode(QDataStream & abr, char *buffer, qint32 height)
+static qint32 rle_decode(QDataStream & abr, char *buffer, qint32 bufferSize, qint32 height)
 {
     qint32 n;
     char ptmp;
@@ -61,6 +61,7 @@ static qint32 rle_decode(QDataStream & abr, char *buffer, qint32 height)
     int i, j, c;
     short *cscanline_len;
     char *data = buffer;
+    char *const dataEnd = buffer + bufferSize;
 
     // read compressed size foreach scanline
     cscanline_len = new short[ height ];
@@ -91,7 +92,7 @@ static qint32 rle_decode(QDataStream & abr, char *buffer, qint32 height)
                 }
 
                 j++;
-                for (c = 0; c < n; c++, data++) {
+                for (c = 0; c < n && data < dataEnd; c++, data++) {
                     *data = ch;
                 }
             }
@@ -99,7 +100,7 @@ static qint32 rle_decode(QDataStream & abr, char *buffer, qint32 height)
                 // read the following n + 1 chars (no compr)
                 for (c = 0; c < n + 1; c++, j++, data++) {
                     // char
-                    if (!abr.device()->getChar(data))  {
+                    if (data >= dataEnd || !abr.device()->getChar(data))  {
                         break;
                     }
                 }
@@ -312,12 +313,9 @@ quint32 KisAbrBrushCollection::abr_brush_load_v6(QDataStream & abr, AbrInfo *abr
 
     qint32 width = 0;
     qint32 height = 0;
-    qint32 size = 0;
 
     qint32 layer_ID = -1;
 
-    char *buffer;
-
     abr >> brush_size;
     brush_end = brush_size;
     // complement to 4
@@ -348,43 +346,17 @@ quint32 KisAbrBrushCollection::abr_brush_load_v6(QDataStream & abr, AbrInfo *abr
 
     width = right - left;
     height = bottom - top;
-    size = width * (depth >> 3) * height;
 
     // remove .abr and add some id, so something like test.abr -> test_12345
     QString name = abr_v1_brush_name(filename, id);
 
-    buffer = (char*)malloc(size);
-
-    // data decoding
-    if (!compression) {
-        // not compressed - read raw bytes as brush data
-        //fread (buffer, size, 1, abr);
-        abr.readRawData(buffer, size);
-    } else {
-        rle_decode(abr, buffer, height);
-    }
-
-    if (width < quint16_MAX && height < quint16_MAX) {
+    if (width > 0 && height > 0 && width < quint16_MAX && height < quint16_MAX) {
         // filename - filename of the file , e.g. test.abr
         // name - test_number_of_the_brush, e.g test_1, test_2
-        KisAbrBrushSP abrBrush;
-        if (m_abrBrushes->contains(name)) {
-            abrBrush = m_abrBrushes.data()->operator[](name);
-        }
-        else {
-            abrBrush = KisAbrBrushSP(new KisAbrBrush(name, this));
-            abrBrush->setMD5(md5());
-        }
-
-        abrBrush->setBrushTipImage(convertToQImage(buffer, width, height));
-        // XXX: call extra setters on abrBrush for other options of ABR brushes
-        abrBrush->setValid(true);
-        abrBrush->setName(name);
-        m_abrBrushes.data()->operator[](name) = abrBrush;
-
+        // the sample is decoded when the brush is used, see decodeBrushTip()
+        addBrush(name, abr.device()->pos(), width, height, depth, compression);
     }
 
-    free(buffer);
     abr.device()->seek(next_brush);
 
     layer_ID = id;
@@ -408,7 +380,6 @@ qint32 KisAbrBrushCollection::abr_brush_load_v12(QDataStream & abr, AbrInfo *abr
     qint32 size;
 
     qint32 layer_ID = -1;
-    char   *buffer;
 
     // short
     abr >> brush_type;
@@ -457,29 +428,24 @@ qint32 KisAbrBrushCollection::abr_brush_load_v12(QDataStream & abr, AbrInfo *abr
             abr.device()->seek(next_brush);
         }
         else {
-            buffer = (char*)malloc(size);
+            const qint64 dataOffset = abr.device()->pos();
 
+            // skip the sample, it is decoded when the brush is used, see decodeBrushTip()
             if (!compression) {
-                // not compressed - read raw bytes as brush data
-                abr.readRawData(buffer, size);
+                abr.device()->seek(dataOffset + size);
             } else {
-                rle_decode(abr, buffer, height);
+                qint64 compressedSize = 0;
+                for (int i = 0; i < height; i++) {
+                    short scanlineSize;
+                    abr >> scanlineSize;
+                    compressedSize += scanlineSize;
+                }
+                abr.device()->seek(abr.device()->pos() + compressedSize);
             }
 
-            KisAbrBrushSP abrBrush;
-            if (m_abrBrushes->contains(name)) {
-                abrBrush = m_abrBrushes.data()->operator[](name);
-            }
-            else {
-                abrBrush = KisAbrBrushSP(new KisAbrBrush(name, this));
-                abrBrush->setMD5(md5());
+            if (width > 0 && height > 0) {
+                addBrush(name, dataOffset, width, height, depth, compression);
             }
-
-            abrBrush->setBrushTipImage(convertToQImage(buffer, width, height));
-            // XXX: call extra setters on abrBrush for other options of ABR brushes   free (buffer);
-            abrBrush->setValid(true);
-            abrBrush->setName(name);
-            m_abrBrushes.data()->operator[](name) = abrBrush;
             layer_ID = 1;
         }
     }
@@ -511,6 +477,60 @@ qint32 KisAbrBrushCollection::abr_brush_load(QDataStream & abr, AbrInfo *abr_hdr
 }
 
 
+void KisAbrBrushCollection::addBrush(const QString &name, qint64 dataOffset, qint32 width, qint32 height, qint16 depth, bool compressed)
+{
+    KisAbrBrushSP abrBrush;
+    if (m_abrBrushes->contains(name)) {
+        abrBrush = m_abrBrushes.data()->operator[](name);
+    }
+    else {
+        abrBrush = KisAbrBrushSP(new KisAbrBrush(name, this));
+        abrBrush->setMD5(md5());
+    }
+
+    SampleInfo sample;
+    sample.dataOffset = dataOffset;
+    sample.width = width;
+    sample.height = height;
+    sample.depth = depth;
+    sample.compressed = compressed;
+    m_samples.insert(abrBrush->filename(), sample);
+
+    abrBrush->setLazyBrushTip(width, height);
+    // XXX: call extra setters on abrBrush for other options of ABR brushes
+    abrBrush->setName(name);
+    m_abrBrushes.data()->operator[](name) = abrBrush;
+}
+
+QImage KisAbrBrushCollection::decodeBrushTip(const QString &brushFilename) const
+{
+    QHash<QString, SampleInfo>::const_iterator it = m_samples.constFind(brushFilename);
+    if (it == m_samples.constEnd()) {
+        warnKrita << "No sample for brush" << brushFilename << "in" << filename();
+        return QImage();
+    }
+
+    const SampleInfo &sample = it.value();
+
+    // only the first byte of every pixel is used, as it always was
+    QVector<char> buffer(sample.width * qMax(1, sample.depth >> 3) * sample.height, 0);
+
+    // every caller gets its own device, the data itself is shared
+    QBuffer buf;
+    buf.setData(m_data);
+    buf.open(QIODevice::ReadOnly);
+    buf.seek(sample.dataOffset);
+    QDataStream abr(&buf);
+
+    if (!sample.compressed) {
+        abr.readRawData(buffer.data(), buffer.size());
+    } else {
+        rle_decode(abr, buffer.data(), buffer.size(), sample.height);
+    }
+
+    return convertToQImage(buffer.data(), sample.width, sample.height);
+}
+
 KisAbrBrushCollection::KisAbrBrushCollection(const QString& filename)
     : m_isLoaded(false)
     , m_lastModified()
@@ -522,6 +542,10 @@ KisAbrBrushCollection::KisAbrBrushCollection(const QString& filename)
 KisAbrBrushCollection::KisAbrBrushCollection(const KisAbrBrushCollection& rhs)
     : m_isLoaded(rhs.m_isLoaded)
     , m_lastModified(rhs.m_lastModified)
+    , m_filename(rhs.m_filename)
+    , m_md5(rhs.m_md5)
+    , m_data(rhs.m_data)
+    , m_samples(rhs.m_samples)
 {
     m_abrBrushes.reset(new QMap<QString, KisAbrBrushSP>());
     for (auto it = rhs.m_abrBrushes->begin();
@@ -561,6 +585,8 @@ bool KisAbrBrushCollection::loadFromDevice(QIODevice *dev)
     QByteArray ba = dev->readAll();
 
     m_md5 = KoMD5Generator::generateHash(ba);
+    m_data = ba;
+    m_samples.clear();
 
     QBuffer buf(&ba);
     buf.open(QIODevice::ReadOnly);
@@ -12,6 +12,7 @@
 #include <QVector>
 #include <QDataStream>
 #include <QString>
+#include <QHash>
 #include <kis_debug.h>
 
 #include <kis_scaling_size_brush.h>
@@ -89,6 +90,15 @@ public:
         return m_md5;
     }
 
+    /**
+     * Decodes the sample of the brush with \p brushFilename from the loaded
+     * file. The samples are not decoded by load(), only their positions
+     * are read, each brush decodes its own tip on first use.
+     *
+     * It is safe to call it from any thread.
+     */
+    QImage decodeBrushTip(const QString &brushFilename) const;
+
 protected:
     KisAbrBrushCollection(const KisAbrBrushCollection& rhs);
 
@@ -100,12 +110,26 @@ private:
     qint32 abr_brush_load_v12(QDataStream & abr, AbrInfo *abr_hdr, const QString filename, qint32 image_ID, qint32 id);
     quint32 abr_brush_load_v6(QDataStream & abr, AbrInfo *abr_hdr, const QString filename, qint32 image_ID, qint32 id);
 
+    void addBrush(const QString &name, qint64 dataOffset, qint32 width, qint32 height, qint16 depth, bool compressed);
+
+    struct SampleInfo {
+        qint64 dataOffset {0};
+        qint32 width {0};
+        qint32 height {0};
+        qint16 depth {8};
+        bool compressed {false};
+    };
+
     bool m_isLoaded;
     QDateTime m_lastModified;
     QString m_filename;
     QSharedPointer<QMap<QString, KisAbrBrushSP>> m_abrBrushes;
     QByteArray m_md5;
 
+    /// the contents of the file, the RLE compressed samples take a fraction of the decoded images
+    QByteArray m_data;
+    QHash<QString, SampleInfo> m_samples;
+
 };
 
 typedef QSharedPointer<KisAbrBrushCollection> KisAbrBrushCollectionSP;
@@ -6,8 +6,8 @@
 
 #include "kis_qimage_pyramid.h"
 
-#include <limits>
-#include <QPainter>
+#include <cmath>
+#include <QRgb>
 #include <kis_debug.h>
 
 #define MIPMAP_SIZE_THRESHOLD 512
@@ -115,6 +115,101 @@ inline QRect roundRect(const QRectF &rc)
     return rect.toAlignedRect();
 }
 
+namespace {
+
+/**
+ * Interpolates two premultiplied pixels with the weights \p a and \p b,
+ * where a + b == 256. Two channels are processed in one 32-bit integer.
+ */
+inline uint interpolatePixel256(uint x, uint a, uint y, uint b)
+{
+    uint t = (x & 0xff00ff) * a + (y & 0xff00ff) * b;
+    t >>= 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a + ((y >> 8) & 0xff00ff) * b;
+    x &= 0xff00ff00;
+    x |= t;
+    return x;
+}
+
+inline uint fetchPremultiplied(const QRgb *pixels, int width, int height, int stride, int x, int y)
+{
+    return x < 0 || y < 0 || x >= width || y >= height ? 0 :
+        qPremultiply(pixels[y * stride + x]);
+}
+
+/**
+ * Resamples \p srcImage into \p dstImage with bilinear interpolation.
+ * \p transform maps the source image into the destination one, and the
+ * pixels outside the source image are considered transparent. The
+ * interpolation is done in premultiplied space, the same way as QPainter
+ * does it for the smooth pixmap transform, but without QPainter's
+ * overhead of setting up a raster paint engine for every dab.
+ */
+void transformImageBilinear(const QImage &srcImage, QImage *dstImage, const QTransform &transform)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(srcImage.format() == QImage::Format_ARGB32);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dstImage->format() == QImage::Format_ARGB32);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(transform.type() != QTransform::TxProject);
+
+    bool invertible = false;
+    const QTransform inv = transform.inverted(&invertible);
+
+    if (!invertible) {
+        dstImage->fill(0);
+        return;
+    }
+
+    const QRgb *srcPixels = reinterpret_cast<const QRgb*>(srcImage.constBits());
+    const int srcWidth = srcImage.width();
+    const int srcHeight = srcImage.height();
+    const int srcStride = srcImage.bytesPerLine() / int(sizeof(QRgb));
+
+    const int dstWidth = dstImage->width();
+    const int dstHeight = dstImage->height();
+
+    for (int y = 0; y < dstHeight; y++) {
+        QRgb *dstPixels = reinterpret_cast<QRgb*>(dstImage->scanLine(y));
+
+        // map the center of the first pixel of the row, the sample
+        // positions are shifted by half a pixel to the centers of the
+        // source pixels
+        qreal sx = inv.m11() * 0.5 + inv.m21() * (y + 0.5) + inv.dx() - 0.5;
+        qreal sy = inv.m12() * 0.5 + inv.m22() * (y + 0.5) + inv.dy() - 0.5;
+
+        for (int x = 0; x < dstWidth; x++) {
+            const qreal floorX = std::floor(sx);
+            const qreal floorY = std::floor(sy);
+
+            const int x0 = int(floorX);
+            const int y0 = int(floorY);
+
+            if (x0 < -1 || y0 < -1 || x0 >= srcWidth || y0 >= srcHeight) {
+                dstPixels[x] = 0;
+            } else {
+                const uint distX = uint((sx - floorX) * 256.0);
+                const uint distY = uint((sy - floorY) * 256.0);
+
+                const uint tl = fetchPremultiplied(srcPixels, srcWidth, srcHeight, srcStride, x0, y0);
+                const uint tr = fetchPremultiplied(srcPixels, srcWidth, srcHeight, srcStride, x0 + 1, y0);
+                const uint bl = fetchPremultiplied(srcPixels, srcWidth, srcHeight, srcStride, x0, y0 + 1);
+                const uint br = fetchPremultiplied(srcPixels, srcWidth, srcHeight, srcStride, x0 + 1, y0 + 1);
+
+                const uint top = interpolatePixel256(tl, 256 - distX, tr, distX);
+                const uint bottom = interpolatePixel256(bl, 256 - distX, br, distX);
+
+                dstPixels[x] = qUnpremultiply(interpolatePixel256(top, 256 - distY, bottom, distY));
+            }
+
+            sx += inv.m11();
+            sy += inv.m12();
+        }
+    }
+}
+
+}
+
 QTransform baseBrushTransform(KisDabShape const& shape,
                               qreal subPixelX, qreal subPixelY,
                               const QRectF &baseBounds)
@@ -282,30 +377,10 @@ QImage KisQImagePyramid::createImage(KisDabShape const& shape,
     }
 
     QImage dstImage(dstSize, QImage::Format_ARGB32);
-    dstImage.fill(0);
 
-
-    /**
-     * QPainter has one more bug: when a QTransform is TxTranslate, it
-     * does wrong sampling (probably, Nearest Neighbour) even though
-     * we tell it directly that we need SmoothPixmapTransform.
-     *
-     * So here is a workaround: we set a negligible scale to convince
-     * Qt we use a non-only-translating transform.
-     */
-    while (transform.type() == QTransform::TxTranslate) {
-        const qreal scale = transform.m11();
-        const qreal fakeScale = scale - 10 * std::numeric_limits<qreal>::epsilon();
-        transform *= QTransform::fromScale(fakeScale, fakeScale);
-    }
-
-    QPainter gc(&dstImage);
-    gc.setTransform(
-        QTransform::fromTranslate(-QPAINTER_WORKAROUND_BORDER,
-                                  -QPAINTER_WORKAROUND_BORDER) * transform);
-    gc.setRenderHints(QPainter::SmoothPixmapTransform);
-    gc.drawImage(QPointF(), srcImage);
-    gc.end();
+    transformImageBilinear(srcImage, &dstImage,
+                           QTransform::fromTranslate(-QPAINTER_WORKAROUND_BORDER,
+                                                     -QPAINTER_WORKAROUND_BORDER) * transform);
 
     return dstImage;
 }
@@ -324,6 +399,16 @@ QImage KisQImagePyramid::getClosest(QTransform transform, qreal *scale) const
     return m_levels[level].image;
 }
 
+QImage KisQImagePyramid::getClosest(QTransform transform, qreal *scale, QRect *sourceRect) const
+{
+    QImage image = getClosest(transform, scale);
+    *sourceRect = image.rect().adjusted(QPAINTER_WORKAROUND_BORDER,
+                                        QPAINTER_WORKAROUND_BORDER,
+                                        -QPAINTER_WORKAROUND_BORDER,
+                                        -QPAINTER_WORKAROUND_BORDER);
+    return image;
+}
+
 QImage KisQImagePyramid::getClosestWithoutWorkaroundBorder(QTransform transform, qreal *scale) const
 {
     QImage image = getClosest(transform, scale);
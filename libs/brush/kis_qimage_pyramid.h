@@ -33,6 +33,15 @@ public:
 
     QImage getClosestWithoutWorkaroundBorder(QTransform transform, qreal *scale) const;
 
+    /**
+     * The same as getClosestWithoutWorkaroundBorder(), but returns the
+     * level itself instead of its copy, \p sourceRect is set to the
+     * part of the level without the border. The returned image keeps
+     * its cacheKey(), so the texture the OpenGL paint engine uploads
+     * for it is reused on the following paints.
+     */
+    QImage getClosest(QTransform transform, qreal *scale, QRect *sourceRect) const;
+
 private:
     friend class KisGbrBrushTest;
     int findNearestLevel(qreal scale, qreal *baseScale) const;
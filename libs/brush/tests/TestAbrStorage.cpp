@@ -14,6 +14,7 @@
 #include <KoConfig.h>
 
 #include <KisAbrStorage.h>
+#include <kis_abr_brush.h>
 #include <KisBundleStorage.h>
 #include <KisResourceLoader.h>
 #include <KoResource.h>
@@ -81,6 +82,32 @@ void TestAbrStorage::testResource()
     QVERIFY(res->filename() == resourceName);
 }
 
+void TestAbrStorage::testLazyBrushTip()
+{
+    QString name = "brushes_by_mar_ka_d338ela";
+    QString filename = name + ".abr";
+    QString resourceName = name + "_2";
+    KisAbrStorage storage(QString(FILES_DATA_DIR) + '/' + filename);
+
+    KisAbrBrushSP brush = storage.resource(resourceName).dynamicCast<KisAbrBrush>();
+    QVERIFY(brush);
+
+    // the size is known before the tip is decoded
+    QVERIFY(brush->width() > 0);
+    QVERIFY(brush->height() > 0);
+
+    QImage tip = brush->brushTipImage();
+    QCOMPARE(tip.size(), QSize(brush->width(), brush->height()));
+    QVERIFY(!brush->image().isNull());
+
+    brush->releaseBrushTipImage();
+    QCOMPARE(brush->brushTipImage(), tip);
+
+    brush->releaseBrushTipImage();
+    KisAbrBrushSP clone = brush->clone().dynamicCast<KisAbrBrush>();
+    QCOMPARE(clone->brushTipImage(), tip);
+}
+
 
 QTEST_MAIN(TestAbrStorage)
 
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void testTagIterator();
     void testResourceItem();
     void testResource();
+    void testLazyBrushTip();
 };
 
 #endif // TESTABRSTORAGE_H
@@ -9,6 +9,8 @@
 #include <QTest>
 #include <QString>
 #include <QDir>
+#include <QPainter>
+#include <limits>
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
@@ -239,6 +241,92 @@ void KisGbrBrushTest::testPyramidDabTransform()
     QCOMPARE(dabTransformHelper(KisDabShape(1.0, 0.5, M_PI / 4)), QSize(160, 160));
 }
 
+void KisGbrBrushTest::testPyramidSamplerMatchesQPainter_data()
+{
+    QTest::addColumn<qreal>("scale");
+    QTest::addColumn<qreal>("ratio");
+    QTest::addColumn<qreal>("rotation");
+    QTest::addColumn<qreal>("subPixel");
+
+    QTest::newRow("subpixel") << 1.0 << 1.0 << 0.0 << 0.3;
+    QTest::newRow("scaled") << 0.7 << 1.0 << 0.0 << 0.0;
+    QTest::newRow("enlarged") << 1.6 << 1.0 << 0.0 << 0.5;
+    QTest::newRow("rotated") << 1.0 << 1.0 << M_PI / 6 << 0.0;
+    QTest::newRow("rotated-squashed") << 0.8 << 0.5 << 2.0 << 0.25;
+}
+
+void KisGbrBrushTest::testPyramidSamplerMatchesQPainter()
+{
+    QFETCH(qreal, scale);
+    QFETCH(qreal, ratio);
+    QFETCH(qreal, rotation);
+    QFETCH(qreal, subPixel);
+
+    QImage srcImage(40, 30, QImage::Format_ARGB32);
+    for (int y = 0; y < srcImage.height(); y++) {
+        for (int x = 0; x < srcImage.width(); x++) {
+            srcImage.setPixel(x, y, qRgba(x * 6, y * 8, 128, (x * y * 7) % 256));
+        }
+    }
+
+    KisQImagePyramid pyramid(srcImage);
+    KisDabShape shape(scale, ratio, rotation);
+
+    const QImage result = pyramid.createImage(shape, subPixel, subPixel);
+
+    // render the same dab the way it used to be rendered with QPainter
+    qreal baseScale = -1.0;
+    const int level = pyramid.findNearestLevel(shape.scale(), &baseScale);
+    const QImage &levelImage = pyramid.m_levels[level].image;
+
+    QTransform transform;
+    QSize dstSize;
+    KisQImagePyramid::calculateParams(shape, subPixel, subPixel,
+                                      pyramid.m_originalSize, baseScale,
+                                      pyramid.m_levels[level].size,
+                                      &transform, &dstSize);
+
+    QCOMPARE(result.size(), dstSize);
+
+    while (transform.type() == QTransform::TxTranslate) {
+        const qreal fakeScale = transform.m11() - 10 * std::numeric_limits<qreal>::epsilon();
+        transform *= QTransform::fromScale(fakeScale, fakeScale);
+    }
+
+    QImage reference(dstSize, QImage::Format_ARGB32);
+    reference.fill(0);
+
+    QPainter gc(&reference);
+    gc.setTransform(QTransform::fromTranslate(-1, -1) * transform);
+    gc.setRenderHints(QPainter::SmoothPixmapTransform);
+    gc.drawImage(QPointF(), levelImage);
+    gc.end();
+
+    // QPainter uses lower precision for the interpolation weights, so
+    // allow a small difference in premultiplied values
+    const int tolerance = 3;
+
+    for (int y = 0; y < dstSize.height(); y++) {
+        for (int x = 0; x < dstSize.width(); x++) {
+            const QRgb value = qPremultiply(result.pixel(x, y));
+            const QRgb expected = qPremultiply(reference.pixel(x, y));
+
+            const bool matches =
+                qAbs(qRed(value) - qRed(expected)) <= tolerance &&
+                qAbs(qGreen(value) - qGreen(expected)) <= tolerance &&
+                qAbs(qBlue(value) - qBlue(expected)) <= tolerance &&
+                qAbs(qAlpha(value) - qAlpha(expected)) <= tolerance;
+
+            if (!matches) {
+                qDebug() << "Pixel" << x << y << "differs:"
+                         << QString::number(value, 16) << "expected"
+                         << QString::number(expected, 16);
+                QFAIL("The bilinear sampler differs from QPainter");
+            }
+        }
+    }
+}
+
 // see comment in KisQImagePyramid::appendPyramidLevel
 void KisGbrBrushTest::testQPainterTransformationBorder()
 {
@@ -28,6 +28,8 @@ private Q_SLOTS:
 
     void testPyramidLevelRounding();
     void testPyramidDabTransform();
+    void testPyramidSamplerMatchesQPainter();
+    void testPyramidSamplerMatchesQPainter_data();
 
     void testQPainterTransformationBorder();
 };
@@ -567,6 +567,47 @@ void KUndo2QStack::purgeRedoState()
     }
 }
 
+/*!
+    Deletes up to \a count oldest commands from the bottom of the stack. The
+    commands that can be redone are never touched. Used for reducing the memory
+    consumed by the history without losing the most recent actions.
+
+    Returns the number of commands that were actually deleted.
+*/
+int KUndo2QStack::purgeUndoHistory(int count)
+{
+    if (!m_macro_stack.isEmpty() || count <= 0)
+        return 0;
+
+    const int del_count = qMin(count, m_index);
+    if (del_count <= 0)
+        return 0;
+
+    const bool was_clean = isClean();
+
+    for (int i = 0; i < del_count; ++i)
+        delete m_command_list.takeFirst();
+
+    m_index -= del_count;
+    m_lastMergedIndex = qMax(0, m_lastMergedIndex - del_count);
+
+    if (m_clean_index != -1) {
+        if (m_clean_index < del_count)
+            m_clean_index = -1; // we've deleted the clean command
+        else
+            m_clean_index -= del_count;
+    }
+
+    emit indexChanged(m_index);
+    emit canUndoChanged(canUndo());
+    emit undoTextChanged(undoText());
+
+    if (was_clean != isClean())
+        emit cleanChanged(isClean());
+
+    return del_count;
+}
+
 /*! \internal
     If the number of commands on the stack exceeds the undo limit, deletes commands from
     the bottom of the stack.
@@ -187,6 +187,7 @@ public:
 
     void setUndoLimit(int limit);
     int undoLimit() const;
+    int purgeUndoHistory(int count);
 
     const KUndo2Command *command(int index) const;
 
@@ -17,6 +17,9 @@
 #include <QRectF>
 #include <QVarLengthArray>
 
+#include <algorithm>
+#include <cmath>
+
 #include <QDebug>
 #include "kis_assert.h"
 
@@ -33,6 +36,10 @@
  *
  * It only supports 2 dimensional bounding boxes which are represented by a QRectF.
  * For node splitting the Quadratic-Cost Algorithm is used as described by Guttman.
+ *
+ * Big sets of items can be loaded at once with load(), which packs the
+ * tree with the Sort-Tile-Recursive algorithm described in "STR: A Simple
+ * and Efficient Algorithm for R-Tree Packing" by Leutenegger et al.
  */
 template <typename T>
 class KoRTree
@@ -62,6 +69,18 @@ public:
      */
     virtual void insert(const QRectF& bb, const T& data);
 
+    /**
+     * @brief Replace the content of the tree with \p items
+     *
+     * The tree is packed bottom-up instead of inserting the items one by
+     * one, which is much faster for big sets of items and gives nodes
+     * with less overlap. The items keep the given order as their
+     * insertion order.
+     *
+     * @param items the bounding boxes and the data items to load
+     */
+    void load(const QVector<QPair<QRectF, T>> &items);
+
     /**
      * @brief Show if a shape is a part of the tree
      * @param data
@@ -322,12 +341,22 @@ class LeafNode : virtual public Node
     }
 
     // methods for insert
+    static QRectF normalizedBoundingBox(const QRectF &bb);
     QPair<Node *, Node *> splitNode(Node * node);
     QPair<int, int> pickSeeds(Node * node);
     QPair<int, int> pickNext(Node * node, QVector<bool> & marker, Node * group1, Node * group2);
     virtual void adjustTree(Node * node1, Node * node2);
     void insertHelper(const QRectF& bb, const T& data, int id);
 
+    // methods for bulk loading
+    struct PackedEntry {
+        QRectF bb;
+        T data;
+        int id;
+        Node *node;
+    };
+    QVector<Node *> packLevel(QVector<PackedEntry> &entries, int level);
+
     // methods for delete
     void insert(Node * node);
     virtual void condenseTree(Node * node, QVector<Node *> & reinsert);
@@ -365,7 +394,7 @@ void KoRTree<T>::insert(const QRectF& bb, const T& data)
 }
 
 template <typename T>
-void KoRTree<T>::insertHelper(const QRectF& bb, const T& data, int id)
+QRectF KoRTree<T>::normalizedBoundingBox(const QRectF &bb)
 {
     QRectF nbb(bb.normalized());
     // This has to be done as it is not possible to use QRectF::united() with a isNull()
@@ -385,6 +414,13 @@ void KoRTree<T>::insertHelper(const QRectF& bb, const T& data, int id)
             nbb.setHeight(0.0001);
         }
     }
+    return nbb;
+}
+
+template <typename T>
+void KoRTree<T>::insertHelper(const QRectF& bb, const T& data, int id)
+{
+    const QRectF nbb = normalizedBoundingBox(bb);
 
     LeafNode * leaf = m_root->chooseLeaf(nbb);
     //debugFlake << " leaf" << leaf->nodeId() << nbb;
@@ -410,6 +446,105 @@ void KoRTree<T>::insertHelper(const QRectF& bb, const T& data, int id)
     }
 }
 
+template <typename T>
+void KoRTree<T>::load(const QVector<QPair<QRectF, T>> &items)
+{
+    clear();
+
+    if (items.size() <= m_capacity) {
+        for (auto it = items.begin(); it != items.end(); ++it) {
+            insert(it->first, it->second);
+        }
+        return;
+    }
+
+    QVector<PackedEntry> entries;
+    entries.reserve(items.size());
+
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        // check if the shape is not already registered
+        KIS_SAFE_ASSERT_RECOVER(!m_leafMap.contains(it->second)) { continue; }
+        m_leafMap.insert(it->second, 0);
+
+        PackedEntry entry = {normalizedBoundingBox(it->first), it->second, LeafNode::dataIdCounter++, 0};
+        entries << entry;
+    }
+
+    if (entries.isEmpty()) return;
+
+    QVector<Node *> nodes = packLevel(entries, 0);
+
+    for (int level = 1; nodes.size() > 1; level++) {
+        entries.clear();
+
+        Q_FOREACH (Node *node, nodes) {
+            PackedEntry entry = {node->boundingBox(), T(), 0, node};
+            entries << entry;
+        }
+
+        nodes = packLevel(entries, level);
+    }
+
+    delete m_root;
+    m_root = nodes.first();
+    m_root->setParent(0);
+}
+
+template <typename T>
+QVector<typename KoRTree<T>::Node *> KoRTree<T>::packLevel(QVector<PackedEntry> &entries, int level)
+{
+    /**
+     * The entries are sorted by x and cut into vertical slices of about
+     * sqrt(numNodes) nodes each, then every slice is sorted by y and cut
+     * into nodes. The entries are spread evenly over the nodes, so every
+     * node is filled at least to the minimum.
+     */
+    const int numEntries = entries.size();
+    const int numNodes = (numEntries + m_capacity - 1) / m_capacity;
+    const int numSlices = int(std::ceil(std::sqrt(qreal(numNodes))));
+
+    auto nodeBegin = [numEntries, numNodes] (int node) {
+        return int(qint64(node) * numEntries / numNodes);
+    };
+
+    std::sort(entries.begin(), entries.end(),
+              [] (const PackedEntry &a, const PackedEntry &b) {
+                  return a.bb.center().x() < b.bb.center().x();
+              });
+
+    QVector<Node *> nodes;
+    nodes.reserve(numNodes);
+
+    for (int slice = 0; slice < numSlices; slice++) {
+        const int firstNode = qint64(slice) * numNodes / numSlices;
+        const int lastNode = qint64(slice + 1) * numNodes / numSlices;
+
+        std::sort(entries.begin() + nodeBegin(firstNode), entries.begin() + nodeBegin(lastNode),
+                  [] (const PackedEntry &a, const PackedEntry &b) {
+                      return a.bb.center().y() < b.bb.center().y();
+                  });
+
+        for (int i = firstNode; i < lastNode; i++) {
+            if (level == 0) {
+                LeafNode *leaf = createLeafNode(m_capacity + 1, level, 0);
+                for (int j = nodeBegin(i); j < nodeBegin(i + 1); j++) {
+                    leaf->insert(entries[j].bb, entries[j].data, entries[j].id);
+                    m_leafMap[entries[j].data] = leaf;
+                }
+                nodes << leaf;
+            } else {
+                NonLeafNode *node = createNonLeafNode(m_capacity + 1, level, 0);
+                for (int j = nodeBegin(i); j < nodeBegin(i + 1); j++) {
+                    node->insert(entries[j].bb, entries[j].node);
+                }
+                nodes << node;
+            }
+        }
+    }
+
+    return nodes;
+}
+
 template <typename T>
 void KoRTree<T>::insert(Node * node)
 {
@@ -432,7 +567,7 @@ void KoRTree<T>::insert(Node * node)
 template <typename T>
 bool KoRTree<T>::contains(const T &data)
 {
-    return m_leafMap[data];
+    return m_leafMap.value(data);
 }
 
 
@@ -261,12 +261,38 @@ void KoShapeManager::Private::updateTree()
             anyModified = true;
         }
 
-        foreach (KoShape *shape, aggregate4update) {
-            if (!shapeUsedInRenderingTree(shape)) continue;
+        /**
+         * When a big part of the shapes has changed, e.g. when moving a big
+         * selection, the tree is packed anew instead of removing and
+         * reinserting every shape. The order of the items is kept.
+         */
+        const int minShapesForRebuild = 64;
+        QList<KoShape*> treeShapes;
 
-            tree.remove(shape);
-            QRectF br(shape->boundingRect());
-            tree.insert(br, shape);
+        if (aggregate4update.size() >= minShapesForRebuild) {
+            treeShapes = tree.values();
+        }
+
+        if (aggregate4update.size() >= minShapesForRebuild &&
+            aggregate4update.size() * 4 >= treeShapes.size()) {
+
+            QVector<QPair<QRectF, KoShape*>> treeItems;
+            treeItems.reserve(treeShapes.size());
+
+            Q_FOREACH (KoShape *shape, treeShapes) {
+                treeItems << qMakePair(shape->boundingRect(), shape);
+            }
+
+            tree.load(treeItems);
+
+        } else {
+            foreach (KoShape *shape, aggregate4update) {
+                if (!shapeUsedInRenderingTree(shape)) continue;
+
+                tree.remove(shape);
+                QRectF br(shape->boundingRect());
+                tree.insert(br, shape);
+            }
         }
 
         aggregate4update.clear();
@@ -357,8 +383,32 @@ KoShapeManager::~KoShapeManager()
     delete d;
 }
 
+void KoShapeManager::Private::linkToShapesRecursively(const QList<KoShape *> &shapes,
+                                                      QSet<KoShape *> *addedShapes,
+                                                      QVector<QPair<QRectF, KoShape *>> *treeItems)
+{
+    Q_FOREACH (KoShape *shape, shapes) {
+        if (addedShapes->contains(shape)) continue;
+        addedShapes->insert(shape);
+
+        shape->addShapeManager(q);
+        this->shapes.append(shape);
+
+        if (shapeUsedInRenderingTree(shape)) {
+            treeItems->append(qMakePair(shape->boundingRect(), shape));
+        }
+
+        KoShapeContainer *container = dynamic_cast<KoShapeContainer*>(shape);
+        if (container) {
+            linkToShapesRecursively(container->shapes(), addedShapes, treeItems);
+        }
+    }
+}
+
 void KoShapeManager::setShapes(const QList<KoShape *> &shapes, Repaint repaint)
 {
+    QList<KoShape*> addedShapes;
+
     {
         QMutexLocker l1(&d->shapesMutex);
         QMutexLocker l2(&d->treeMutex);
@@ -372,10 +422,23 @@ void KoShapeManager::setShapes(const QList<KoShape *> &shapes, Repaint repaint)
         d->shapeIndexesBeforeUpdate.clear();
         d->tree.clear();
         d->shapes.clear();
+
+        /**
+         * Documents may contain thousands of shapes, so the tree is
+         * bulk loaded instead of adding the shapes one by one
+         */
+        QSet<KoShape*> addedShapesSet;
+        QVector<QPair<QRectF, KoShape*>> treeItems;
+        d->linkToShapesRecursively(shapes, &addedShapesSet, &treeItems);
+        d->tree.load(treeItems);
+
+        addedShapes = d->shapes;
     }
 
-    Q_FOREACH (KoShape *shape, shapes) {
-        addShape(shape, repaint);
+    if (repaint == PaintShapeOnAdd) {
+        Q_FOREACH (KoShape *shape, addedShapes) {
+            shape->update();
+        }
     }
 }
 
@@ -54,6 +54,15 @@ public:
      */
     void unlinkFromShapesRecursively(const QList<KoShape *> &shapes);
 
+    /**
+     * Recursively attach the shapes to this shape manager without
+     * adding them to the tree, the shapes that should be put into
+     * the tree are added to \p treeItems instead
+     */
+    void linkToShapesRecursively(const QList<KoShape *> &shapes,
+                                 QSet<KoShape *> *addedShapes,
+                                 QVector<QPair<QRectF, KoShape *>> *treeItems);
+
     QList<KoShape *> shapes;
     KoSelection *selection;
     KoCanvasBase *canvas;
@@ -23,6 +23,8 @@
 #include <QStringList>
 #include <QColor>
 #include <QGradientStops>
+#include <QHash>
+#include <QSet>
 
 class Q_DECL_HIDDEN SvgStyleParser::Private
 {
@@ -43,14 +45,55 @@ public:
         styleAttributes << "stroke-dasharray" << "stroke-dashoffset" << "stroke-opacity" << "stroke-miterlimit";
         styleAttributes << "opacity" << "filter" << "clip-path" << "clip-rule" << "mask";
         styleAttributes << "marker" << "marker-start" << "marker-mid" << "marker-end" << "krita:marker-fill-method";
+
+        Q_FOREACH (const QString &attribute, fontAttributes + styleAttributes + textAttributes) {
+            knownAttributes.insert(attribute);
+        }
     }
 
     SvgLoadingContext &context;
     QStringList textAttributes; ///< text related attributes
     QStringList fontAttributes; ///< font related attributes
     QStringList styleAttributes; ///< style related attributes
+    QSet<QString> knownAttributes; ///< all the attributes above
+
+    /// the css styles already split into properties, most of the elements
+    /// of a document share just a few distinct style strings
+    QHash<QString, SvgStyles> parsedCssStyles;
+
+    const SvgStyles& parsedCssStyle(const QString &style);
 };
 
+const SvgStyles& SvgStyleParser::Private::parsedCssStyle(const QString &style)
+{
+    auto it = parsedCssStyles.find(style);
+
+    if (it == parsedCssStyles.end()) {
+        SvgStyles styleMap;
+
+        QStringList substyles = style.split(';', QString::SkipEmptyParts);
+        for (QStringList::Iterator it = substyles.begin(); it != substyles.end(); ++it) {
+            QStringList substyle = it->split(':');
+            if (substyle.count() != 2)
+                continue;
+            QString command = substyle[0].trimmed();
+            QString params  = substyle[1].trimmed();
+
+            // toggle the namespace selector into the xml-like one
+            command.replace("|", ":");
+
+            // only use style and font attributes
+            if (knownAttributes.contains(command)) {
+                styleMap[command] = params;
+            }
+        }
+
+        it = parsedCssStyles.insert(style, styleMap);
+    }
+
+    return it.value();
+}
+
 SvgStyleParser::SvgStyleParser(SvgLoadingContext &context)
     : d(new Private(context))
 {
@@ -451,22 +494,17 @@ SvgStyles SvgStyleParser::collectStyles(const KoXmlElement &e)
     SvgStyles styleMap;
 
     // collect individual presentation style attributes which have the priority 0
-    // according to SVG standard
-    // NOTE: font attributes should be parsed the first, because they defines 'em' and 'ex'
-    Q_FOREACH (const QString & command, d->fontAttributes) {
-        const QString attribute = e.attribute(command);
-        if (!attribute.isEmpty())
-            styleMap[command] = attribute;
-    }
-    Q_FOREACH (const QString &command, d->styleAttributes) {
-        const QString attribute = e.attribute(command);
-        if (!attribute.isEmpty())
-            styleMap[command] = attribute;
-    }
-    Q_FOREACH (const QString & command, d->textAttributes) {
-        const QString attribute = e.attribute(command);
-        if (!attribute.isEmpty())
-            styleMap[command] = attribute;
+    // according to SVG standard. The element usually has just a few attributes,
+    // so they are walked once instead of looking up every known attribute.
+    // NOTE: the order of the font attributes is restored in parseFont()
+    const QDomNamedNodeMap attributes = e.attributes();
+    for (int i = 0; i < attributes.count(); i++) {
+        const QDomAttr attribute = attributes.item(i).toAttr();
+        const QString command = attribute.name();
+
+        if (d->knownAttributes.contains(command) && !attribute.value().isEmpty()) {
+            styleMap[command] = attribute.value();
+        }
     }
 
     // match css style rules to element
@@ -474,26 +512,10 @@ SvgStyles SvgStyleParser::collectStyles(const KoXmlElement &e)
 
     // collect all css style attributes
     Q_FOREACH (const QString &style, cssStyles) {
-        QStringList substyles = style.split(';', QString::SkipEmptyParts);
-        if (!substyles.count())
-            continue;
-        for (QStringList::Iterator it = substyles.begin(); it != substyles.end(); ++it) {
-            QStringList substyle = it->split(':');
-            if (substyle.count() != 2)
-                continue;
-            QString command = substyle[0].trimmed();
-            QString params  = substyle[1].trimmed();
+        const SvgStyles &cssStyle = d->parsedCssStyle(style);
 
-            // toggle the namespace selector into the xml-like one
-            command.replace("|", ":");
-
-            // only use style and font attributes
-            if (d->styleAttributes.contains(command) ||
-                d->fontAttributes.contains(command) ||
-                d->textAttributes.contains(command)) {
-
-                styleMap[command] = params;
-            }
+        for (auto it = cssStyle.constBegin(); it != cssStyle.constEnd(); ++it) {
+            styleMap[it.key()] = it.value();
         }
     }
 
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoRTree.h"
+
+#include <QTest>
+#include <KoRTree.h>
+
+namespace {
+
+QVector<QPair<QRectF, int>> generateItems(int numItems)
+{
+    QVector<QPair<QRectF, int>> items;
+
+    for (int i = 0; i < numItems; i++) {
+        // a deterministic scatter of overlapping rects of different sizes
+        const qreal x = (i * 37) % 1000;
+        const qreal y = (i * 91) % 1000;
+        items << qMakePair(QRectF(x, y, 5 + i % 17, 5 + i % 23), i);
+    }
+
+    return items;
+}
+
+QList<int> bruteForceIntersects(const QVector<QPair<QRectF, int>> &items, const QRectF &rect)
+{
+    QList<int> result;
+
+    Q_FOREACH (const auto &item, items) {
+        if (item.first.intersects(rect)) {
+            result << item.second;
+        }
+    }
+
+    return result;
+}
+
+}
+
+void TestKoRTree::testLoad()
+{
+    const QVector<QPair<QRectF, int>> items = generateItems(5000);
+
+    KoRTree<int> tree(4, 2);
+    tree.load(items);
+
+    QCOMPARE(tree.values().size(), items.size());
+
+    const QVector<QRectF> queries = {
+        QRectF(0, 0, 100, 100),
+        QRectF(450, 450, 20, 20),
+        QRectF(900, 10, 300, 50),
+        QRectF(-10, -10, 2000, 2000),
+        QRectF(5000, 5000, 10, 10)
+    };
+
+    Q_FOREACH (const QRectF &rect, queries) {
+        // the results are sorted by the insertion order, i.e. the order of the loaded items
+        QCOMPARE(tree.intersects(rect), bruteForceIntersects(items, rect));
+    }
+
+    QVERIFY(tree.contains(1234));
+    QVERIFY(!tree.contains(5000));
+}
+
+void TestKoRTree::testLoadSmall()
+{
+    KoRTree<int> tree(4, 2);
+
+    tree.load(generateItems(3));
+    QCOMPARE(tree.values(), QList<int>({0, 1, 2}));
+
+    tree.load(QVector<QPair<QRectF, int>>());
+    QVERIFY(tree.values().isEmpty());
+}
+
+void TestKoRTree::testModifyAfterLoad()
+{
+    QVector<QPair<QRectF, int>> items = generateItems(1000);
+
+    KoRTree<int> tree(4, 2);
+    tree.load(items);
+
+    for (int i = 0; i < 1000; i += 3) {
+        tree.remove(i);
+    }
+
+    for (int i = 1; i < 1000; i += 3) {
+        tree.remove(i);
+        items[i].first.translate(13, 7);
+        tree.insert(items[i].first, i);
+    }
+
+    QVector<QPair<QRectF, int>> expected;
+    Q_FOREACH (const auto &item, items) {
+        if (item.second % 3) {
+            expected << item;
+        }
+    }
+
+    const QRectF rect(100, 100, 400, 300);
+
+    QList<int> result = tree.intersects(rect);
+    QList<int> expectedResult = bruteForceIntersects(expected, rect);
+
+    // the moved items got new insertion ids, so compare them unordered
+    std::sort(result.begin(), result.end());
+    std::sort(expectedResult.begin(), expectedResult.end());
+
+    QCOMPARE(result, expectedResult);
+    QCOMPARE(tree.values().size(), expected.size());
+}
+
+QTEST_MAIN(TestKoRTree)
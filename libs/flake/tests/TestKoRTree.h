@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKORTREE_H
+#define TESTKORTREE_H
+
+#include <QtTest>
+
+class TestKoRTree : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLoad();
+    void testLoadSmall();
+    void testModifyAfterLoad();
+};
+
+#endif // TESTKORTREE_H
@@ -44,17 +44,31 @@
 
 #include <QSharedData>
 
+struct TextChunk;
+
 class KoSvgTextShape::Private
 {
 public:
 
-    // NOTE: the cache data is shared between all the instances of
-    //       the shape, though it will be reset locally if the
-    //       accessing thread changes
+    // NOTE: the layouts are bound to the thread they have been created
+    //       in, so they are never copied to the clones of the shape
     std::vector<std::shared_ptr<QTextLayout>> cachedLayouts;
     std::vector<QPointF> cachedLayoutsOffsets;
     QThread *cachedLayoutsWorkingThread = 0;
 
+    // NOTE: the text chunks and the outline don't depend on the thread,
+    //       they are updated in relayout() only and are shared with the
+    //       clones of the shape
+    std::shared_ptr<const QVector<TextChunk>> cachedChunks;
+    QPainterPath cachedOutline;
+    bool hasCachedOutline = false;
+
+    std::shared_ptr<const QVector<TextChunk>> textChunks(const KoSvgTextShape *q) const;
+    void updateCachedLayouts(const KoSvgTextShape *q);
+
+    static void createLayouts(const QVector<TextChunk> &textChunks,
+                              std::vector<std::shared_ptr<QTextLayout>> *layouts,
+                              std::vector<QPointF> *layoutsOffsets);
 
     void clearAssociatedOutlines(const KoShape *rootShape);
 
@@ -72,8 +86,15 @@ KoSvgTextShape::KoSvgTextShape(const KoSvgTextShape &rhs)
     , d(new Private)
 {
     setShapeId(KoSvgTextShape_SHAPEID);
-    // QTextLayout has no copy-ctor, so just relayout everything!
-    relayout();
+
+    /**
+     * QTextLayout has no copy-ctor, the layouts are recreated from the shared
+     * text chunks when the clone is painted. The children have copied their
+     * associated outlines already, so there is no need to relayout everything.
+     */
+    d->cachedChunks = rhs.d->cachedChunks;
+    d->cachedOutline = rhs.d->cachedOutline;
+    d->hasCachedOutline = rhs.d->hasCachedOutline;
 }
 
 KoSvgTextShape::~KoSvgTextShape()
@@ -106,25 +127,34 @@ void KoSvgTextShape::paintComponent(QPainter &painter, KoShapePaintingContext &p
      * recreate the layouts in the current thread to be able to render them.
      */
 
-    if (QThread::currentThread() != d->cachedLayoutsWorkingThread) {
-        relayout();
-    }
-
-    for (int i = 0; i < (int)d->cachedLayouts.size(); i++) {
-        d->cachedLayouts[i]->draw(&painter, d->cachedLayoutsOffsets[i]);
-    }
+    if (QThread::currentThread() == qApp->thread()) {
+        if (QThread::currentThread() != d->cachedLayoutsWorkingThread) {
+            d->updateCachedLayouts(this);
+        }
 
-    /**
-     * HACK ALERT:
-     * The layouts of non-gui threads must be destroyed in the same thread
-     * they have been created. Because the thread might be restarted in the
-     * meantime or just destroyed, meaning that the per-thread freetype data
-     * will not be available.
-     */
-    if (QThread::currentThread() != qApp->thread()) {
-        d->cachedLayouts.clear();
-        d->cachedLayoutsOffsets.clear();
-        d->cachedLayoutsWorkingThread = 0;
+        for (int i = 0; i < (int)d->cachedLayouts.size(); i++) {
+            d->cachedLayouts[i]->draw(&painter, d->cachedLayoutsOffsets[i]);
+        }
+    } else {
+        /**
+         * HACK ALERT:
+         * The layouts of non-gui threads must be destroyed in the same thread
+         * they have been created. Because the thread might be restarted in the
+         * meantime or just destroyed, meaning that the per-thread freetype data
+         * will not be available.
+         *
+         * Several threads may also paint the same shape at once, e.g. the
+         * patches of a shape layer, so they use temporary layouts created
+         * from the cached chunks instead of touching the cache.
+         */
+        std::vector<std::shared_ptr<QTextLayout>> layouts;
+        std::vector<QPointF> layoutsOffsets;
+
+        Private::createLayouts(*d->textChunks(this), &layouts, &layoutsOffsets);
+
+        for (int i = 0; i < (int)layouts.size(); i++) {
+            layouts[i]->draw(&painter, layoutsOffsets[i]);
+        }
     }
 }
 
@@ -136,12 +166,23 @@ void KoSvgTextShape::paintStroke(QPainter &painter, KoShapePaintingContext &pain
     // do nothing! everything is painted in paintComponent()
 }
 
+QPainterPath KoSvgTextShape::outline() const
+{
+    // the union of the outlines of all the chunks is expensive to
+    // calculate, so it is done once in relayout()
+    return d->hasCachedOutline ? d->cachedOutline : KoSvgTextChunkShape::outline();
+}
+
 QPainterPath KoSvgTextShape::textOutline()
 {
 
     QPainterPath result;
     result.setFillRule(Qt::WindingFill);
 
+    if (QThread::currentThread() != d->cachedLayoutsWorkingThread) {
+        d->updateCachedLayouts(this);
+    }
+
 
     for (int i = 0; i < (int)d->cachedLayouts.size(); i++) {
         const QPointF layoutOffset = d->cachedLayoutsOffsets[i];
@@ -399,16 +440,29 @@ private:
     QTextLine m_danglingLine;
 };
 
-void KoSvgTextShape::relayout() const
+std::shared_ptr<const QVector<TextChunk>> KoSvgTextShape::Private::textChunks(const KoSvgTextShape *q) const
 {
+    if (cachedChunks) {
+        return cachedChunks;
+    }
 
-    d->cachedLayouts.clear();
-    d->cachedLayoutsOffsets.clear();
-    d->cachedLayoutsWorkingThread = QThread::currentThread();
+    return std::make_shared<const QVector<TextChunk>>(mergeIntoChunks(q->layoutInterface()->collectSubChunks()));
+}
 
-    QPointF currentTextPos;
+void KoSvgTextShape::Private::updateCachedLayouts(const KoSvgTextShape *q)
+{
+    cachedLayouts.clear();
+    cachedLayoutsOffsets.clear();
+    cachedLayoutsWorkingThread = QThread::currentThread();
 
-    QVector<TextChunk> textChunks = mergeIntoChunks(layoutInterface()->collectSubChunks());
+    createLayouts(*textChunks(q), &cachedLayouts, &cachedLayoutsOffsets);
+}
+
+void KoSvgTextShape::Private::createLayouts(const QVector<TextChunk> &textChunks,
+                                            std::vector<std::shared_ptr<QTextLayout>> *layouts,
+                                            std::vector<QPointF> *layoutsOffsets)
+{
+    QPointF currentTextPos;
 
     Q_FOREACH (const TextChunk &chunk, textChunks) {
         std::shared_ptr<QTextLayout> layout(new QTextLayout());
@@ -473,10 +527,15 @@ void KoSvgTextShape::relayout() const
             diff.ry() = 0;
         }
 
-        d->cachedLayouts.push_back(layout);
-        d->cachedLayoutsOffsets.push_back(-diff);
-
+        layouts->push_back(layout);
+        layoutsOffsets->push_back(-diff);
     }
+}
+
+void KoSvgTextShape::relayout() const
+{
+    d->cachedChunks = std::make_shared<const QVector<TextChunk>>(mergeIntoChunks(layoutInterface()->collectSubChunks()));
+    d->updateCachedLayouts(this);
 
     d->clearAssociatedOutlines(this);
 
@@ -549,6 +608,9 @@ void KoSvgTextShape::relayout() const
             }
         }
     }
+
+    d->cachedOutline = KoSvgTextChunkShape::outline();
+    d->hasCachedOutline = true;
 }
 
 void KoSvgTextShape::Private::clearAssociatedOutlines(const KoShape *rootShape)
@@ -31,6 +31,12 @@ public:
     void paintComponent(QPainter &painter, KoShapePaintingContext &paintContext) const override;
     void paintStroke(QPainter &painter, KoShapePaintingContext &paintContext) const override;
 
+    /**
+     * The outline of the whole text, it is cached when the text is laid
+     * out, so it doesn't need to be united from the chunks on every call
+     */
+    QPainterPath outline() const override;
+
     /**
      * Reset the text shape into initial shape, removing all the child shapes
      * and precalculated layouts. This method is used by text-updating code to
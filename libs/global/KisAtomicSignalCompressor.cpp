@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAtomicSignalCompressor.h"
+
+#include <QThread>
+
+
+KisAtomicSignalCompressor::KisAtomicSignalCompressor(QObject *parent)
+    : QObject(parent),
+      m_pending(false),
+      m_generation(0)
+{
+}
+
+bool KisAtomicSignalCompressor::isActive() const
+{
+    return m_pending.load();
+}
+
+void KisAtomicSignalCompressor::start()
+{
+    if (QThread::currentThread() == thread()) {
+        /**
+         * The signal is delivered right now, so a delivery that might
+         * have been posted by another thread becomes redundant
+         */
+        m_pending.store(false);
+        emit timeout();
+        return;
+    }
+
+    if (!m_pending.exchange(true)) {
+        QMetaObject::invokeMethod(this, "slotDeliver", Qt::QueuedConnection,
+                                  Q_ARG(int, m_generation.load()));
+    }
+}
+
+void KisAtomicSignalCompressor::stop()
+{
+    /**
+     * The events posted before the stop are still in the queue, so
+     * we mark them as outdated. Otherwise they could consume the
+     * requests that come after the stop.
+     */
+    m_generation++;
+    m_pending.store(false);
+}
+
+void KisAtomicSignalCompressor::slotDeliver(int generation)
+{
+    if (generation != m_generation.load()) return;
+
+    /**
+     * The flag should be reset *before* emitting the signal, so that
+     * the calls that come during the emission post a new event
+     */
+    if (m_pending.exchange(false)) {
+        emit timeout();
+    }
+}
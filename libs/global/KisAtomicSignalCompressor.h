@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISATOMICSIGNALCOMPRESSOR_H
+#define KISATOMICSIGNALCOMPRESSOR_H
+
+#include <QObject>
+#include <atomic>
+
+#include "kritaglobal_export.h"
+
+/**
+ * A lightweight compressor for notifications that come from the
+ * worker threads at a high rate, e.g. "the image has been modified".
+ *
+ * Unlike KisThreadSafeSignalCompressor, start() does not post an event
+ * on every call. It just raises an atomic flag, and only the call that
+ * raised it posts a single event into the thread of the compressor.
+ * All the calls that happen before that event is delivered are merged
+ * into one timeout() signal. There is no timer involved, so the signal
+ * is delivered on the next iteration of the event loop.
+ *
+ * When start() is called from the thread of the compressor itself, the
+ * signal is emitted synchronously, just like a direct connection would
+ * do.
+ *
+ * The guarantee is the same as for the other compressors: after every
+ * call to start() at least one timeout() signal is emitted.
+ */
+class KRITAGLOBAL_EXPORT KisAtomicSignalCompressor : public QObject
+{
+    Q_OBJECT
+public:
+    KisAtomicSignalCompressor(QObject *parent = 0);
+
+    /**
+     * \return true if there is a delivery pending
+     */
+    bool isActive() const;
+
+public Q_SLOTS:
+    void start();
+
+    /**
+     * Cancels the delivery requested by the previous calls to start(),
+     * if it has not happened yet
+     */
+    void stop();
+
+Q_SIGNALS:
+    void timeout();
+
+private Q_SLOTS:
+    void slotDeliver(int generation);
+
+private:
+    std::atomic<bool> m_pending;
+    std::atomic<int> m_generation;
+};
+
+#endif // KISATOMICSIGNALCOMPRESSOR_H
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisCpuAffinity.h"
+
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#endif
+
+namespace KisCpuAffinity {
+
+QVector<int> parseCpuList(const QString &list)
+{
+    QVector<int> result;
+
+    const QStringList chunks = list.split(',', QString::SkipEmptyParts);
+    Q_FOREACH (const QString &chunk, chunks) {
+        const QStringList range = chunk.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = false;
+
+        if (range.size() == 1) {
+            const int cpu = range[0].toInt(&firstOk);
+            if (!firstOk || cpu < 0) return QVector<int>();
+            result << cpu;
+        } else if (range.size() == 2) {
+            const int first = range[0].toInt(&firstOk);
+            const int last = range[1].toInt(&lastOk);
+            if (!firstOk || !lastOk || first < 0 || last < first) return QVector<int>();
+
+            for (int cpu = first; cpu <= last; cpu++) {
+                result << cpu;
+            }
+        } else {
+            return QVector<int>();
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+bool setProcessAffinity(const QVector<int> &cpus)
+{
+    if (cpus.isEmpty()) return false;
+
+#ifdef Q_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    Q_FOREACH (int cpu, cpus) {
+        if (cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &set);
+    }
+
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+int availableCpuCount()
+{
+#ifdef Q_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        const int count = CPU_COUNT(&set);
+        if (count > 0) {
+            return qMin(count, QThread::idealThreadCount());
+        }
+    }
+#endif
+
+    return QThread::idealThreadCount();
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCPUAFFINITY_H
+#define KISCPUAFFINITY_H
+
+#include "kritaglobal_export.h"
+
+#include <QVector>
+
+class QString;
+
+/**
+ * Helpers for pinning Krita to a subset of the CPU cores. It is mostly
+ * useful for render farms, where several batch instances of Krita share
+ * the same machine and each of them should use its own set of cores.
+ *
+ * The affinity should be applied by the main thread before any worker
+ * threads are created, so that all the threads of Krita and the child
+ * processes (e.g. ffmpeg) inherit it.
+ *
+ * Supported on Linux only, on other systems the functions do nothing.
+ */
+namespace KisCpuAffinity {
+
+/**
+ * Parses a list of cores in the format of taskset(1), e.g. "0-3,8,10-11".
+ * Returns an empty list if the string is empty or malformed.
+ */
+QVector<int> KRITAGLOBAL_EXPORT parseCpuList(const QString &list);
+
+/**
+ * Restricts the calling thread and all the threads and processes it
+ * spawns later to the cores in \p cpus.
+ * \return false if the affinity could not be changed
+ */
+bool KRITAGLOBAL_EXPORT setProcessAffinity(const QVector<int> &cpus);
+
+/**
+ * \return the number of cores the current process is allowed to run
+ * on. Unlike QThread::idealThreadCount(), it respects the affinity mask
+ * of the process.
+ */
+int KRITAGLOBAL_EXPORT availableCpuCount();
+
+}
+
+#endif // KISCPUAFFINITY_H
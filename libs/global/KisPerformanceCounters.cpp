@@ -0,0 +1,31 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPerformanceCounters.h"
+
+#include <atomic>
+
+#include "kis_assert.h"
+
+namespace {
+std::atomic<qint64> s_counters[KisPerformanceCounters::NumCounters];
+}
+
+namespace KisPerformanceCounters {
+
+void add(Counter counter, qint64 value)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(counter >= 0 && counter < NumCounters);
+    s_counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+qint64 value(Counter counter)
+{
+    KIS_SAFE_ASSERT_RECOVER(counter >= 0 && counter < NumCounters) { return 0; }
+    return s_counters[counter].load(std::memory_order_relaxed);
+}
+
+}
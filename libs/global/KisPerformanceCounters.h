@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERFORMANCECOUNTERS_H
+#define KISPERFORMANCECOUNTERS_H
+
+#include "kritaglobal_export.h"
+
+#include <QtGlobal>
+
+/**
+ * Process-wide monotonic counters of the work done by the subsystems
+ * that are not bound to a single image, e.g. the swapper or the openGL
+ * canvas. The counters are never reset, the users are expected to sample
+ * them periodically and compute the rates from the difference of the
+ * samples (see the profiler docker).
+ *
+ * Incrementing a counter is a single relaxed atomic addition, so it is
+ * safe and cheap enough to be called from any thread in the hot paths.
+ */
+namespace KisPerformanceCounters {
+
+enum Counter {
+    TextureUploadBytes = 0,
+    SwappedInBytes,
+    SwappedOutBytes,
+    RenderedDabs,
+
+    NumCounters
+};
+
+void KRITAGLOBAL_EXPORT add(Counter counter, qint64 value);
+
+/**
+ * \return the total value accumulated in \p counter since Krita started
+ */
+qint64 KRITAGLOBAL_EXPORT value(Counter counter);
+
+}
+
+#endif // KISPERFORMANCECOUNTERS_H
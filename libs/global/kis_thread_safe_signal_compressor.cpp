@@ -8,11 +8,19 @@
 
 #include <QApplication>
 
+#include "KisAtomicSignalCompressor.h"
+
 
 KisThreadSafeSignalCompressor::KisThreadSafeSignalCompressor(int delay, KisSignalCompressor::Mode mode)
-    : m_compressor(new KisSignalCompressor(delay, mode, this))
+    : m_compressor(new KisSignalCompressor(delay, mode, this)),
+      m_requestCompressor(new KisAtomicSignalCompressor(this))
 {
-    connect(this, SIGNAL(internalRequestSignal()), m_compressor, SLOT(start()), Qt::AutoConnection);
+    /**
+     * The requests coming from other threads are merged before they
+     * reach the event loop, so a burst of them posts a single event
+     */
+    connect(this, SIGNAL(internalRequestSignal()), m_requestCompressor, SLOT(start()), Qt::DirectConnection);
+    connect(m_requestCompressor, SIGNAL(timeout()), m_compressor, SLOT(start()));
     connect(this, SIGNAL(internalStopSignal()), m_compressor, SLOT(stop()), Qt::AutoConnection);
     connect(this, SIGNAL(internalSetDelay(int)), m_compressor, SLOT(setDelay(int)), Qt::AutoConnection);
     connect(m_compressor, SIGNAL(timeout()), SIGNAL(timeout()));
@@ -39,5 +47,7 @@ void KisThreadSafeSignalCompressor::start()
 
 void KisThreadSafeSignalCompressor::stop()
 {
+    // the stop request should also cancel the requests that are not delivered yet
+    m_requestCompressor->stop();
     emit internalStopSignal();
 }
@@ -12,12 +12,15 @@
 
 #include "kis_signal_compressor.h"
 
+class KisAtomicSignalCompressor;
+
 /**
  * A special class which works exactly like KisSignalCompressor, but
  * supports calling \p start() method from within the context of
  * another thread. If it happens, it posts a message to Qt's event
  * loop and the \p start() signal is delivered when event loop gets
- * executes again.
+ * executes again. Several calls to \p start() coming from another
+ * thread before the event is processed post only one message.
  *
  * WARNING: After creation this object moves itself into the main
  *          thread, so one must *not* delete it explicitly. Use
@@ -45,6 +48,7 @@ Q_SIGNALS:
 
 private:
     KisSignalCompressor *m_compressor;
+    KisAtomicSignalCompressor *m_requestCompressor;
 };
 
 #endif /* __KIS_THREAD_SAFE_SIGNAL_COMPRESSOR_H */
@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisCpuAffinityTest.h"
+
+#include "KisCpuAffinity.h"
+
+void KisCpuAffinityTest::testParseCpuList()
+{
+    QCOMPARE(KisCpuAffinity::parseCpuList(""), QVector<int>());
+    QCOMPARE(KisCpuAffinity::parseCpuList("3"), QVector<int>({3}));
+    QCOMPARE(KisCpuAffinity::parseCpuList("0-3"), QVector<int>({0, 1, 2, 3}));
+    QCOMPARE(KisCpuAffinity::parseCpuList("8, 0-2,10-11"), QVector<int>({0, 1, 2, 8, 10, 11}));
+
+    // duplicates are merged
+    QCOMPARE(KisCpuAffinity::parseCpuList("0-2,1-3"), QVector<int>({0, 1, 2, 3}));
+
+    // malformed lists are rejected completely
+    QCOMPARE(KisCpuAffinity::parseCpuList("0-2,x"), QVector<int>());
+    QCOMPARE(KisCpuAffinity::parseCpuList("3-1"), QVector<int>());
+    QCOMPARE(KisCpuAffinity::parseCpuList("-1"), QVector<int>());
+    QCOMPARE(KisCpuAffinity::parseCpuList("1-2-3"), QVector<int>());
+}
+
+void KisCpuAffinityTest::testAvailableCpuCount()
+{
+    const int count = KisCpuAffinity::availableCpuCount();
+
+    QVERIFY(count >= 1);
+    QVERIFY(count <= QThread::idealThreadCount());
+}
+
+QTEST_MAIN(KisCpuAffinityTest)
@@ -0,0 +1,23 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCPUAFFINITYTEST_H
+#define KISCPUAFFINITYTEST_H
+
+#include <QtTest>
+
+class KisCpuAffinityTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testParseCpuList();
+    void testAvailableCpuCount();
+
+};
+
+#endif // KISCPUAFFINITYTEST_H
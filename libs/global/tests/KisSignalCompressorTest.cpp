@@ -8,6 +8,10 @@
 
 #include "QTimer"
 #include "kis_signal_compressor.h"
+#include "KisAtomicSignalCompressor.h"
+#include "kis_thread_safe_signal_compressor.h"
+
+#include <QtConcurrent>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
@@ -115,6 +119,74 @@ void KisSignalCompressorTest::testSlowHandlerAdditive()
     }
 }
 
+void KisSignalCompressorTest::testAtomicCompressor()
+{
+    KisAtomicSignalCompressor compressor;
+    QSignalSpy spy(&compressor, SIGNAL(timeout()));
+
+    // the calls from the own thread are delivered synchronously
+    compressor.start();
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!compressor.isActive());
+
+    const int numRequests = 10000;
+
+    QFuture<void> future = QtConcurrent::run([&compressor] () {
+        for (int i = 0; i < numRequests; i++) {
+            compressor.start();
+        }
+    });
+    future.waitForFinished();
+
+    // nothing is delivered until the event loop runs
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(compressor.isActive());
+
+    QTest::qWait(10);
+
+    // all the requests are merged into one signal
+    QCOMPARE(spy.count(), 2);
+    QVERIFY(!compressor.isActive());
+
+    // a stopped request is not delivered
+    future = QtConcurrent::run([&compressor] () { compressor.start(); });
+    future.waitForFinished();
+    compressor.stop();
+
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 2);
+}
+
+void KisSignalCompressorTest::testThreadSafeCompressorFromThread()
+{
+    KisThreadSafeSignalCompressor *compressor =
+        new KisThreadSafeSignalCompressor(10, KisSignalCompressor::FIRST_INACTIVE);
+    QSignalSpy spy(compressor, SIGNAL(timeout()));
+
+    QFuture<void> future = QtConcurrent::run([compressor] () {
+        for (int i = 0; i < 10000; i++) {
+            compressor->start();
+        }
+    });
+    future.waitForFinished();
+
+    QVERIFY(spy.wait(100));
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 1);
+
+    // the last request after a stop is still delivered
+    future = QtConcurrent::run([compressor] () {
+        compressor->start();
+        compressor->stop();
+        compressor->start();
+    });
+    future.waitForFinished();
+
+    QVERIFY(spy.wait(100));
+    QCOMPARE(spy.count(), 2);
+
+    compressor->deleteLater();
+}
 
 QTEST_MAIN(KisSignalCompressorTest)
 
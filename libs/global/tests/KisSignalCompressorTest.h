@@ -18,6 +18,9 @@ private Q_SLOTS:
     void test();
     void testSlowHandlerPrecise();
     void testSlowHandlerAdditive();
+
+    void testAtomicCompressor();
+    void testThreadSafeCompressorFromThread();
 };
 
 #endif // KISSIGNALCOMPRESSORTEST_H
@@ -44,6 +44,14 @@ private:
     KisLocklessStack<Action> m_migrationReclaimActions;
 
     void releasePoolSafely(KisLocklessStack<Action> *pool, bool force = false) {
+        /**
+         * update() is called after every access to the hash table, so
+         * the common case of an empty pool should not touch the shared
+         * stack top, otherwise all the reader threads start bouncing the
+         * same cache line between the cores.
+         */
+        if (pool->isEmpty()) return;
+
         KisLocklessStack<Action> tmp;
         tmp.mergeFrom(*pool);
         if (tmp.isEmpty()) return;
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAdaptiveLodEstimator.h"
+
+#include "kis_debug.h"
+
+
+KisAdaptiveLodEstimator::KisAdaptiveLodEstimator(qreal targetLatency, int maxLevelOfDetail)
+    : m_targetLatency(targetLatency),
+      m_maxLevelOfDetail(maxLevelOfDetail),
+      m_strokeTime(0),
+      m_strokeJobs(0),
+      m_estimatedLatency(-1.0),
+      m_preferredLevelOfDetail(0)
+{
+}
+
+void KisAdaptiveLodEstimator::setTargetLatency(qreal value)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(value > 0.0);
+    m_targetLatency = value;
+    recalculateLevelOfDetail();
+}
+
+qreal KisAdaptiveLodEstimator::targetLatency() const
+{
+    return m_targetLatency;
+}
+
+void KisAdaptiveLodEstimator::setMaxLevelOfDetail(int value)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(value >= 0);
+    m_maxLevelOfDetail = value;
+    recalculateLevelOfDetail();
+}
+
+int KisAdaptiveLodEstimator::maxLevelOfDetail() const
+{
+    return m_maxLevelOfDetail;
+}
+
+void KisAdaptiveLodEstimator::reportMergeJob(int levelOfDetail, qint64 nsecs)
+{
+    // every LODN pixel covers 4^N pixels of LOD0
+    m_strokeTime.fetch_add(nsecs << (2 * levelOfDetail), std::memory_order_relaxed);
+    m_strokeJobs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KisAdaptiveLodEstimator::notifyStrokeFinished()
+{
+    const int numJobs = m_strokeJobs.exchange(0);
+    const qint64 totalTime = m_strokeTime.exchange(0);
+
+    if (!numJobs) return;
+
+    const qreal strokeLatency = qreal(totalTime) / numJobs / 1000000.0;
+
+    m_estimatedLatency =
+        m_estimatedLatency < 0 ?
+        strokeLatency : 0.5 * (m_estimatedLatency + strokeLatency);
+
+    recalculateLevelOfDetail();
+}
+
+qreal KisAdaptiveLodEstimator::estimatedLatency() const
+{
+    return m_estimatedLatency;
+}
+
+int KisAdaptiveLodEstimator::preferredLevelOfDetail() const
+{
+    return m_preferredLevelOfDetail;
+}
+
+void KisAdaptiveLodEstimator::reset()
+{
+    m_strokeJobs = 0;
+    m_strokeTime = 0;
+    m_estimatedLatency = -1.0;
+    m_preferredLevelOfDetail = 0;
+}
+
+qreal KisAdaptiveLodEstimator::latencyAt(int levelOfDetail) const
+{
+    return m_estimatedLatency / (1 << (2 * levelOfDetail));
+}
+
+void KisAdaptiveLodEstimator::recalculateLevelOfDetail()
+{
+    if (m_estimatedLatency < 0) return;
+
+    int lod = qMin(m_preferredLevelOfDetail, m_maxLevelOfDetail);
+
+    while (lod < m_maxLevelOfDetail && latencyAt(lod) > m_targetLatency) {
+        lod++;
+    }
+
+    while (lod > 0 && latencyAt(lod - 1) < 0.5 * m_targetLatency) {
+        lod--;
+    }
+
+    m_preferredLevelOfDetail = lod;
+}
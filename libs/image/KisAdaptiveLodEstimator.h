@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISADAPTIVELODESTIMATOR_H
+#define KISADAPTIVELODESTIMATOR_H
+
+#include <atomic>
+#include <QtGlobal>
+
+#include "kritaimage_export.h"
+
+/**
+ * Chooses the level of detail for the strokes of the document from
+ * the measured latency of its merge jobs.
+ *
+ * The updater threads report the duration of every merge job with
+ * reportMergeJob(). The duration is normalized to LOD0, that is,
+ * multiplied by the number of LOD0 pixels covered by a single LODN
+ * pixel. When a stroke is finished, the average latency of the stroke
+ * is folded into a running estimate and the preferred level of detail
+ * is recalculated: the smallest one whose expected latency fits into
+ * the target latency. To avoid flickering between two levels on a
+ * borderline document, the level is decreased only when the lower
+ * level would take less than a half of the target.
+ *
+ * reportMergeJob() may be called from any thread, all the other
+ * methods should be guarded by the owner.
+ */
+class KRITAIMAGE_EXPORT KisAdaptiveLodEstimator
+{
+public:
+    KisAdaptiveLodEstimator(qreal targetLatency = 20.0, int maxLevelOfDetail = 3);
+
+    /**
+     * \param value the desired duration of a merge job in milliseconds
+     */
+    void setTargetLatency(qreal value);
+    qreal targetLatency() const;
+
+    void setMaxLevelOfDetail(int value);
+    int maxLevelOfDetail() const;
+
+    void reportMergeJob(int levelOfDetail, qint64 nsecs);
+    void notifyStrokeFinished();
+
+    /**
+     * \return the estimated LOD0 latency of a merge job in
+     *         milliseconds or -1 if nothing has been measured yet
+     */
+    qreal estimatedLatency() const;
+
+    int preferredLevelOfDetail() const;
+
+    void reset();
+
+private:
+    qreal latencyAt(int levelOfDetail) const;
+    void recalculateLevelOfDetail();
+
+private:
+    qreal m_targetLatency;
+    int m_maxLevelOfDetail;
+
+    std::atomic<qint64> m_strokeTime;
+    std::atomic<int> m_strokeJobs;
+
+    qreal m_estimatedLatency;
+    int m_preferredLevelOfDetail;
+};
+
+#endif // KISADAPTIVELODESTIMATOR_H
@@ -13,6 +13,7 @@
 #include <QApplication>
 
 #include "kis_image.h"
+#include "KisSchedulerTracer.h"
 
 
 Q_GLOBAL_STATIC(KisBusyWaitBroker, s_instance)
@@ -53,6 +54,8 @@ void KisBusyWaitBroker::notifyWaitOnImageStarted(KisImage* image)
         m_d->waitingOnImages.insert(image);
     }
 
+    KisSchedulerTracer::instance()->reportBusyWaitStarted("wait on image");
+
     if (m_d->feedbackCallback && image->refCount()) {
         m_d->feedbackCallback(image);
     }
@@ -68,12 +71,16 @@ void KisBusyWaitBroker::notifyWaitOnImageEnded(KisImage* image)
         KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->waitingOnImages.contains(image));
         m_d->waitingOnImages.remove(image);
     }
+
+    KisSchedulerTracer::instance()->reportBusyWaitEnded();
 }
 
 void KisBusyWaitBroker::notifyGeneralWaitStarted()
 {
     if (QThread::currentThread() != qApp->thread()) return;
 
+    KisSchedulerTracer::instance()->reportBusyWaitStarted("general wait");
+
     QMutexLocker l(&m_d->lock);
     m_d->guiThreadLockCount++;
 }
@@ -82,6 +89,8 @@ void KisBusyWaitBroker::notifyGeneralWaitEnded()
 {
     if (QThread::currentThread() != qApp->thread()) return;
 
+    KisSchedulerTracer::instance()->reportBusyWaitEnded();
+
     QMutexLocker l(&m_d->lock);
     m_d->guiThreadLockCount--;
 }
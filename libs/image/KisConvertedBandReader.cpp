@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisConvertedBandReader.h"
+
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoCompositeOp.h>
+#include <KoCompositeOpRegistry.h>
+
+#include "kis_paint_device.h"
+
+
+KisConvertedBandReader::KisConvertedBandReader(KisPaintDeviceSP device,
+                                               const KoColorSpace *dstColorSpace,
+                                               KoColorConversionTransformation::Intent renderingIntent,
+                                               KoColorConversionTransformation::ConversionFlags conversionFlags)
+    : m_device(device),
+      m_dstColorSpace(dstColorSpace ? dstColorSpace : device->colorSpace()),
+      m_renderingIntent(renderingIntent),
+      m_conversionFlags(conversionFlags),
+      m_hasBackgroundColor(false)
+{
+}
+
+void KisConvertedBandReader::setBackgroundColor(const KoColor &color)
+{
+    m_backgroundColor = color.convertedTo(m_device->colorSpace());
+    m_hasBackgroundColor = true;
+}
+
+void KisConvertedBandReader::setColorSpace(const KoColorSpace *dstColorSpace)
+{
+    m_dstColorSpace = dstColorSpace ? dstColorSpace : m_device->colorSpace();
+}
+
+const KoColorSpace* KisConvertedBandReader::colorSpace() const
+{
+    return m_dstColorSpace;
+}
+
+int KisConvertedBandReader::pixelSize() const
+{
+    return m_dstColorSpace->pixelSize();
+}
+
+bool KisConvertedBandReader::isPassThrough() const
+{
+    return !m_hasBackgroundColor && *m_dstColorSpace == *m_device->colorSpace();
+}
+
+void KisConvertedBandReader::readBytes(quint8 *data, const QRect &rect) const
+{
+    if (rect.isEmpty()) return;
+
+    if (isPassThrough()) {
+        m_device->readBytes(data, rect);
+        return;
+    }
+
+    const KoColorSpace *srcColorSpace = m_device->colorSpace();
+    const int srcPixelSize = srcColorSpace->pixelSize();
+    const int numPixels = rect.width() * rect.height();
+    const bool needsConversion = !(*m_dstColorSpace == *srcColorSpace);
+
+    // without conversion the pixels are flattened right in the destination
+    QVector<quint8> buffer(needsConversion ? numPixels * srcPixelSize : 0);
+    quint8 *srcData = needsConversion ? buffer.data() : data;
+
+    m_device->readBytes(srcData, rect);
+
+    if (m_hasBackgroundColor) {
+        QVector<quint8> background(numPixels * srcPixelSize);
+        for (int i = 0; i < numPixels; i++) {
+            memcpy(background.data() + i * srcPixelSize, m_backgroundColor.data(), srcPixelSize);
+        }
+
+        KoCompositeOp::ParameterInfo params;
+        params.dstRowStart = background.data();
+        params.dstRowStride = rect.width() * srcPixelSize;
+        params.srcRowStart = srcData;
+        params.srcRowStride = rect.width() * srcPixelSize;
+        params.rows = rect.height();
+        params.cols = rect.width();
+
+        srcColorSpace->compositeOp(COMPOSITE_OVER)->composite(params);
+
+        memcpy(srcData, background.constData(), numPixels * srcPixelSize);
+    }
+
+    if (needsConversion) {
+        srcColorSpace->convertPixelsTo(srcData, data, m_dstColorSpace, numPixels,
+                                       m_renderingIntent, m_conversionFlags);
+    }
+}
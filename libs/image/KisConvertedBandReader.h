@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCONVERTEDBANDREADER_H
+#define KISCONVERTEDBANDREADER_H
+
+#include <QRect>
+
+#include <KoColor.h>
+#include <KoColorConversionTransformation.h>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class KoColorSpace;
+
+/**
+ * Reads the pixels of a device converted into another color space
+ * and, optionally, flattened over a background color, one band of
+ * rows at a time.
+ *
+ * The export filters use it to pull the pixels straight from the
+ * projection, instead of converting or flattening a copy of the whole
+ * image before writing it, so only one band per thread has to be kept
+ * in memory additionally to the projection itself.
+ *
+ * readBytes() can be called from several threads at the same time.
+ */
+class KRITAIMAGE_EXPORT KisConvertedBandReader
+{
+public:
+    /**
+     * \p dstColorSpace may be null, then the pixels are read in the
+     * color space of \p device
+     */
+    KisConvertedBandReader(KisPaintDeviceSP device,
+                           const KoColorSpace *dstColorSpace = 0,
+                           KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent(),
+                           KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags());
+
+    /**
+     * Composite the pixels over \p color before converting them, i.e.
+     * the pixels are read opaque if \p color is opaque
+     */
+    void setBackgroundColor(const KoColor &color);
+
+    /**
+     * Convert the pixels into \p dstColorSpace, replacing the
+     * previously set color space
+     */
+    void setColorSpace(const KoColorSpace *dstColorSpace);
+
+    /// \return the color space of the read pixels
+    const KoColorSpace* colorSpace() const;
+    int pixelSize() const;
+
+    /// \return true if the pixels are read from the device as they are
+    bool isPassThrough() const;
+
+    /**
+     * Reads \p rect of the device into \p data, which should have
+     * space for rect.width() * rect.height() * pixelSize() bytes
+     */
+    void readBytes(quint8 *data, const QRect &rect) const;
+
+private:
+    KisPaintDeviceSP m_device;
+    const KoColorSpace *m_dstColorSpace;
+    KoColorConversionTransformation::Intent m_renderingIntent;
+    KoColorConversionTransformation::ConversionFlags m_conversionFlags;
+    KoColor m_backgroundColor;
+    bool m_hasBackgroundColor;
+};
+
+#endif // KISCONVERTEDBANDREADER_H
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFusedLayersBlender.h"
+
+#include <QBitArray>
+
+#include <KoColorSpace.h>
+#include <KoCompositeOp.h>
+#include <KoCompositeOpRegistry.h>
+
+#include "kis_paint_device.h"
+#include "kis_paint_layer.h"
+#include "kis_projection_leaf.h"
+#include "kis_layer_projection_plane.h"
+#include "kis_random_accessor_ng.h"
+#include "tiles3/kis_random_accessor.h"
+
+
+bool KisFusedLayersBlender::canFuse(KisProjectionLeafSP leaf, KisPaintDeviceSP dstDevice)
+{
+    if (!dstDevice) return false;
+
+    KisPaintLayer *layer = dynamic_cast<KisPaintLayer*>(leaf->node().data());
+    if (!layer || layer->hasEffectMasks()) return false;
+
+    /**
+     * Layer styles replace the projection plane of the layer, so
+     * checking the type of the plane covers them as well
+     */
+    if (!dynamic_cast<KisLayerProjectionPlane*>(layer->projectionPlane().data())) return false;
+
+    KisPaintDeviceSP device = layer->projection();
+    if (!device || *device->colorSpace() != *dstDevice->colorSpace()) return false;
+
+    const QBitArray channelFlags = leaf->channelFlags();
+    if (!channelFlags.isEmpty() &&
+        channelFlags != QBitArray(channelFlags.size(), true)) {
+
+        return false;
+    }
+
+    const QString compositeOpId = layer->compositeOpId();
+
+    return compositeOpId != COMPOSITE_COPY &&
+        compositeOpId != COMPOSITE_DESTINATION_IN &&
+        compositeOpId != COMPOSITE_DESTINATION_ATOP;
+}
+
+void KisFusedLayersBlender::addLayer(KisProjectionLeafSP leaf)
+{
+    if (!leaf->visible()) return;
+
+    KisLayer *layer = qobject_cast<KisLayer*>(leaf->node().data());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(layer);
+
+    KisPaintDeviceSP device = layer->projection();
+    addSource(device, device->colorSpace()->compositeOp(layer->compositeOpId()), leaf->opacity());
+}
+
+void KisFusedLayersBlender::addSource(KisPaintDeviceSP device, const KoCompositeOp *op, quint8 opacity)
+{
+    const QRect extent = device->extent();
+    if (extent.isEmpty()) return;
+
+    m_sources.append({device, op, opacity, extent});
+}
+
+int KisFusedLayersBlender::numSources() const
+{
+    return m_sources.size();
+}
+
+void KisFusedLayersBlender::clear()
+{
+    m_sources.clear();
+}
+
+void KisFusedLayersBlender::blend(KisPaintDeviceSP dstDevice, const QRect &rect) const
+{
+    QRect sourcesRect;
+    Q_FOREACH (const Source &source, m_sources) {
+        sourcesRect |= source.extent;
+    }
+
+    const QRect blendRect = rect & sourcesRect;
+    if (blendRect.isEmpty()) return;
+
+    const int pixelSize = dstDevice->pixelSize();
+
+    KisRandomAccessorSP dstIt = dstDevice->createRandomAccessorNG();
+
+    QVector<KisRandomConstAccessorSP> srcIts;
+    srcIts.reserve(m_sources.size());
+    Q_FOREACH (const Source &source, m_sources) {
+        srcIts.append(source.device->createRandomConstAccessorNG());
+    }
+
+    KoCompositeOp::ParameterInfo params;
+
+    for (int dstY = blendRect.y(); dstY <= blendRect.bottom();) {
+        const int rows = qMin(dstIt->numContiguousRows(dstY), blendRect.bottom() - dstY + 1);
+
+        for (int dstX = blendRect.x(); dstX <= blendRect.right();) {
+            const int columns = qMin(dstIt->numContiguousColumns(dstX), blendRect.right() - dstX + 1);
+            const QRect dstChunk(dstX, dstY, columns, rows);
+
+            dstIt->moveTo(dstX, dstY);
+            quint8 *dstChunkStart = dstIt->rawData();
+            const int dstRowStride = dstIt->rowStride(dstX, dstY);
+
+            /**
+             * The destination tile stays locked and in the cache while
+             * all the layers are composited into it
+             */
+            for (int i = 0; i < m_sources.size(); i++) {
+                const Source &source = m_sources[i];
+                const QRect srcChunk = dstChunk & source.extent;
+                if (srcChunk.isEmpty()) continue;
+
+                KisRandomConstAccessorSP srcIt = srcIts[i];
+
+                params.opacity = float(source.opacity) / 255.0f;
+
+                for (int y = srcChunk.y(); y <= srcChunk.bottom();) {
+                    const int srcRows = qMin(srcIt->numContiguousRows(y), srcChunk.bottom() - y + 1);
+
+                    for (int x = srcChunk.x(); x <= srcChunk.right();) {
+                        const int srcColumns = qMin(srcIt->numContiguousColumns(x), srcChunk.right() - x + 1);
+
+                        srcIt->moveTo(x, y);
+
+                        params.dstRowStart = dstChunkStart +
+                            (y - dstY) * dstRowStride + (x - dstX) * pixelSize;
+                        params.dstRowStride = dstRowStride;
+                        params.srcRowStart = static_cast<KisRandomAccessor2*>(srcIt.data())->rawData();
+                        params.srcRowStride = srcIt->rowStride(x, y);
+                        params.rows = srcRows;
+                        params.cols = srcColumns;
+
+                        source.op->composite(params);
+
+                        x += srcColumns;
+                    }
+
+                    y += srcRows;
+                }
+            }
+
+            dstX += columns;
+        }
+
+        dstY += rows;
+    }
+}
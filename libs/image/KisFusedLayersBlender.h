@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFUSEDLAYERSBLENDER_H
+#define KISFUSEDLAYERSBLENDER_H
+
+#include <QVector>
+#include <QRect>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class KoCompositeOp;
+
+/**
+ * Blends a run of consecutive simple layers into the destination
+ * device in a single pass per tile. Every tile of the destination is
+ * locked once and all the layers are composited into it while it is
+ * still hot in the cache, instead of rereading and rewriting the whole
+ * projection for every layer.
+ *
+ * The layers are blended in the order they were added, i.e. from the
+ * bottom to the top. All the sources must have the same color space as
+ * the destination, see canFuse().
+ */
+class KRITAIMAGE_EXPORT KisFusedLayersBlender
+{
+public:
+    /**
+     * \return true if \p leaf is a plain paint layer, whose projection
+     * plane does nothing but a bitBlt of the layer onto \p dstDevice,
+     * that is: no masks, no layer styles, no channel flags, the same
+     * color space and a composite op that doesn't touch the pixels
+     * outside the layer's extent.
+     */
+    static bool canFuse(KisProjectionLeafSP leaf, KisPaintDeviceSP dstDevice);
+
+    void addLayer(KisProjectionLeafSP leaf);
+    void addSource(KisPaintDeviceSP device, const KoCompositeOp *op, quint8 opacity);
+
+    int numSources() const;
+    void clear();
+
+    /**
+     * Composites all the added sources onto \p dstDevice in \p rect
+     */
+    void blend(KisPaintDeviceSP dstDevice, const QRect &rect) const;
+
+private:
+    struct Source {
+        KisPaintDeviceSP device;
+        const KoCompositeOp *op;
+        quint8 opacity;
+        QRect extent;
+    };
+
+    QVector<Source> m_sources;
+};
+
+#endif // KISFUSEDLAYERSBLENDER_H
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisImageMemoryBudget.h"
+
+#include "kis_debug.h"
+#include "kis_image.h"
+#include "kis_image_config.h"
+#include "kis_layer_utils.h"
+#include "kis_memory_statistics_server.h"
+#include "kis_paint_device.h"
+#include "KisImageConfigNotifier.h"
+
+namespace {
+
+/**
+ * A step that keeps freeing memory (e.g. trims the undo history
+ * by portions) is not allowed to run forever
+ */
+const int MAX_STEP_ITERATIONS = 8;
+
+template <typename Func>
+void applyToNodeDevices(KisNodeSP root, Func func)
+{
+    KisLayerUtils::recursiveApplyNodes(root,
+        [func] (KisNodeSP node) {
+            KisPaintDeviceSP devices[] = {node->paintDevice(),
+                                          node->original(),
+                                          node->projection()};
+
+            for (KisPaintDeviceSP dev : devices) {
+                if (dev) {
+                    func(dev);
+                }
+            }
+        });
+}
+
+}
+
+struct KisImageMemoryBudget::Private
+{
+    Private(KisImage *_image)
+        : image(_image)
+    {
+    }
+
+    KisImage *image;
+    qint64 budget = 0;
+    StepHandler handlers[NumDegradationSteps];
+
+    bool dropLevelOfDetail();
+    bool swapOut();
+};
+
+bool KisImageMemoryBudget::Private::dropLevelOfDetail()
+{
+    if (image->currentLevelOfDetail() > 0) return false;
+    if (!image->tryBarrierLock()) return false;
+
+    bool hasReleasedData = false;
+
+    /**
+     * The barrier lock is not read-only, so unlocking the image
+     * will make the strokes queue resync LoD planes when needed
+     */
+    if (!image->currentLevelOfDetail()) {
+        applyToNodeDevices(image->root(),
+            [&hasReleasedData] (KisPaintDeviceSP dev) {
+                qint64 imageData = 0;
+                qint64 temporaryData = 0;
+                qint64 lodData = 0;
+
+                dev->estimateMemoryStats(imageData, temporaryData, lodData);
+
+                if (lodData > 0) {
+                    dev->releaseLodData();
+                    hasReleasedData = true;
+                }
+            });
+    }
+
+    image->unlock();
+
+    return hasReleasedData;
+}
+
+bool KisImageMemoryBudget::Private::swapOut()
+{
+    qint32 numSwappedTiles = 0;
+
+    applyToNodeDevices(image->root(),
+        [&numSwappedTiles] (KisPaintDeviceSP dev) {
+            numSwappedTiles += dev->swapOutData();
+        });
+
+    return numSwappedTiles > 0;
+}
+
+KisImageMemoryBudget::KisImageMemoryBudget(KisImage *image)
+    : m_d(new Private(image))
+{
+    m_d->handlers[DropLevelOfDetail] = [this] () { return m_d->dropLevelOfDetail(); };
+    m_d->handlers[SwapOut] = [this] () { return m_d->swapOut(); };
+
+    connect(KisMemoryStatisticsServer::instance(), SIGNAL(sigUpdateMemoryStatistics()),
+            this, SLOT(slotMemoryStatisticsUpdated()));
+    connect(KisImageConfigNotifier::instance(), SIGNAL(configChanged()),
+            this, SLOT(slotConfigChanged()));
+
+    slotConfigChanged();
+}
+
+KisImageMemoryBudget::~KisImageMemoryBudget()
+{
+}
+
+qint64 KisImageMemoryBudget::budget() const
+{
+    return m_d->budget;
+}
+
+void KisImageMemoryBudget::setBudget(qint64 value)
+{
+    m_d->budget = value;
+}
+
+void KisImageMemoryBudget::setStepHandler(DegradationStep step, StepHandler handler)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(step >= 0 && step < NumDegradationSteps);
+    m_d->handlers[step] = handler;
+}
+
+qint64 KisImageMemoryBudget::memoryUsage() const
+{
+    KisMemoryStatisticsServer::Statistics stats =
+        KisMemoryStatisticsServer::instance()->fetchMemoryStatistics(KisImageSP(m_d->image));
+
+    return stats.imageSize + stats.historySize;
+}
+
+bool KisImageMemoryBudget::enforceBudget()
+{
+    if (m_d->budget <= 0) return true;
+
+    qint64 usage = memoryUsage();
+
+    for (int step = 0; step < NumDegradationSteps; step++) {
+        if (!m_d->handlers[step]) continue;
+
+        for (int i = 0; i < MAX_STEP_ITERATIONS && usage > m_d->budget; i++) {
+            if (!m_d->handlers[step]()) break;
+
+            /**
+             * Some memory (swapped tiles, cached frames) is not
+             * accounted in memoryUsage(), so repeat the step only
+             * while it makes any visible progress
+             */
+            const qint64 newUsage = memoryUsage();
+            if (newUsage >= usage) break;
+
+            usage = newUsage;
+        }
+
+        if (usage <= m_d->budget) break;
+    }
+
+    return usage <= m_d->budget;
+}
+
+void KisImageMemoryBudget::slotMemoryStatisticsUpdated()
+{
+    enforceBudget();
+}
+
+void KisImageMemoryBudget::slotConfigChanged()
+{
+    KisImageConfig cfg(true);
+    setBudget(cfg.documentMemoryBudget() * MiB);
+}
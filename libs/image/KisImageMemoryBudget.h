@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISIMAGEMEMORYBUDGET_H
+#define KISIMAGEMEMORYBUDGET_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <functional>
+
+#include "kritaimage_export.h"
+
+class KisImage;
+
+/**
+ * Keeps the memory consumed by a single image within the budget
+ * set by KisImageConfig::documentMemoryBudget().
+ *
+ * The usage of the image (its layers, projections, LoD planes and
+ * undo history) is rechecked every time KisMemoryStatisticsServer
+ * updates the statistics. When the image is over budget, it frees
+ * its own memory in a fixed order:
+ *
+ * 1) TrimUndoHistory: removes the oldest undo commands
+ * 2) DropFrameCache: drops the cached animation frames
+ * 3) DropLevelOfDetail: releases the LoD planes of the devices
+ * 4) SwapOut: moves the tiles of the image into the swap
+ *
+ * The next step is started only when the previous one cannot free
+ * anything more. Only when all the steps are exhausted the global
+ * tiles limits come into play and the swapper starts evicting the
+ * tiles of the other open images.
+ *
+ * The image owns the undo stack and the frame cache only indirectly,
+ * so the first two steps are implemented by the UI, which should
+ * register them with setStepHandler(). The last two are built-in.
+ */
+class KRITAIMAGE_EXPORT KisImageMemoryBudget : public QObject
+{
+    Q_OBJECT
+public:
+    enum DegradationStep {
+        TrimUndoHistory = 0,
+        DropFrameCache,
+        DropLevelOfDetail,
+        SwapOut,
+        NumDegradationSteps
+    };
+
+    /**
+     * The handler should free some memory of the image and
+     * return true, or return false if it has nothing to free.
+     */
+    using StepHandler = std::function<bool()>;
+
+public:
+    KisImageMemoryBudget(KisImage *image);
+    ~KisImageMemoryBudget() override;
+
+    /**
+     * The budget in bytes, zero means unlimited
+     */
+    qint64 budget() const;
+    void setBudget(qint64 value);
+
+    /**
+     * Replaces the handler of \p step. Pass an empty handler
+     * to disable the step.
+     */
+    void setStepHandler(DegradationStep step, StepHandler handler);
+
+    /**
+     * \return the memory currently used by the image in bytes
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * Runs the degradation steps until the image fits its budget
+     * or all the steps are exhausted.
+     *
+     * \return true if the image fits the budget afterwards
+     */
+    bool enforceBudget();
+
+public Q_SLOTS:
+    void slotMemoryStatisticsUpdated();
+
+private Q_SLOTS:
+    void slotConfigChanged();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISIMAGEMEMORYBUDGET_H
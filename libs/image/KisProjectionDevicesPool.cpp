@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisProjectionDevicesPool.h"
+
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRect>
+#include <QVector>
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "tiles3/kis_tile_data_interface.h"
+
+Q_GLOBAL_STATIC(KisProjectionDevicesPool, s_instance)
+
+namespace {
+
+const int maxExtentClass = 8;
+const int maxDevicesPerBucket = 4;
+const int maxPooledDevices = 64;
+
+struct PooledDevice {
+    const KoColorSpace *colorSpace;
+    int extentClass;
+    KisPaintDeviceSP device;
+};
+
+}
+
+struct KisProjectionDevicesPool::Private
+{
+    mutable QMutex lock;
+    QVector<PooledDevice> devices;
+
+    int numDevicesInBucket(const KoColorSpace *colorSpace, int extentClass) const;
+};
+
+int KisProjectionDevicesPool::Private::numDevicesInBucket(const KoColorSpace *colorSpace, int extentClass) const
+{
+    return std::count_if(devices.begin(), devices.end(),
+                         [colorSpace, extentClass] (const PooledDevice &item) {
+                             return item.extentClass == extentClass &&
+                                 *item.colorSpace == *colorSpace;
+                         });
+}
+
+KisProjectionDevicesPool::KisProjectionDevicesPool()
+    : m_d(new Private)
+{
+}
+
+KisProjectionDevicesPool::~KisProjectionDevicesPool()
+{
+}
+
+KisProjectionDevicesPool *KisProjectionDevicesPool::instance()
+{
+    return s_instance;
+}
+
+int KisProjectionDevicesPool::extentClass(const QRect &rc)
+{
+    const int numTiles =
+        qCeil(qreal(rc.width()) / KisTileData::WIDTH) *
+        qCeil(qreal(rc.height()) / KisTileData::HEIGHT);
+
+    int result = 0;
+    for (int limit = 1; numTiles > limit && result < maxExtentClass; limit *= 4) {
+        result++;
+    }
+
+    return result;
+}
+
+KisPaintDeviceSP KisProjectionDevicesPool::acquireDevice(KisPaintDeviceSP prototype)
+{
+    const KoColorSpace *colorSpace = prototype->colorSpace();
+    const int requestedClass = extentClass(prototype->extent());
+
+    KisPaintDeviceSP device;
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        /**
+         * Prefer the device of exactly the same class, otherwise take
+         * the closest one, larger devices first
+         */
+        int bestIndex = -1;
+        int bestDistance = std::numeric_limits<int>::max();
+
+        for (int i = 0; i < m_d->devices.size(); i++) {
+            const PooledDevice &item = m_d->devices[i];
+            if (*item.colorSpace != *colorSpace) continue;
+
+            const int distance =
+                item.extentClass >= requestedClass ?
+                2 * (item.extentClass - requestedClass) :
+                2 * (requestedClass - item.extentClass) + 1;
+
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                bestIndex = i;
+                if (!distance) break;
+            }
+        }
+
+        if (bestIndex < 0) return KisPaintDeviceSP();
+
+        device = m_d->devices[bestIndex].device;
+        m_d->devices.remove(bestIndex);
+    }
+
+    device->makeCloneFromRough(prototype, prototype->extent());
+    return device;
+}
+
+void KisProjectionDevicesPool::releaseDevice(KisPaintDeviceSP device)
+{
+    /**
+     * The caller should pass its last reference to the device, so the
+     * device is referenced by the caller and our argument only
+     */
+    if (!device || device->refCount() > 2 || device->keyframeChannel()) return;
+
+    const KoColorSpace *colorSpace = device->colorSpace();
+    const int deviceClass = extentClass(device->extent());
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        if (m_d->devices.size() >= maxPooledDevices ||
+            m_d->numDevicesInBucket(colorSpace, deviceClass) >= maxDevicesPerBucket) {
+
+            return;
+        }
+    }
+
+    device->clear();
+    device->setParentNode(0);
+
+    QMutexLocker l(&m_d->lock);
+    m_d->devices.append({colorSpace, deviceClass, device});
+}
+
+void KisProjectionDevicesPool::clear()
+{
+    QVector<PooledDevice> devices;
+
+    {
+        QMutexLocker l(&m_d->lock);
+        std::swap(devices, m_d->devices);
+    }
+}
+
+int KisProjectionDevicesPool::numPooledDevices() const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->devices.size();
+}
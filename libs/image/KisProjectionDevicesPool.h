@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPROJECTIONDEVICESPOOL_H
+#define KISPROJECTIONDEVICESPOOL_H
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class QRect;
+
+/**
+ * A global pool of empty projection devices, shared by all the nodes
+ * of all the documents.
+ *
+ * KisSafeNodeProjectionStore recycles the projection of a node only
+ * for the node itself, so when the projection of another node is
+ * needed, e.g. after switching a group into pass-through mode or
+ * toggling the visibility of a layer with masks, a new device with
+ * a new tile hash table is allocated. The store puts its spare devices
+ * into this pool instead, and takes them from here before allocating
+ * new ones.
+ *
+ * The devices are grouped by their color space and by the class of the
+ * extent they used to have, so that the hash table of the reused device
+ * has roughly the necessary size.
+ *
+ * A device may be put into the pool only when no one else can access
+ * it, i.e. from KisRecycleProjectionsJob or when its owner is being
+ * destroyed.
+ */
+class KRITAIMAGE_EXPORT KisProjectionDevicesPool
+{
+public:
+    KisProjectionDevicesPool();
+    ~KisProjectionDevicesPool();
+
+    static KisProjectionDevicesPool* instance();
+
+    /**
+     * Takes a device from the pool and makes it a rough clone of
+     * \p prototype. Returns null if there are no devices with a
+     * suitable color space in the pool.
+     */
+    KisPaintDeviceSP acquireDevice(KisPaintDeviceSP prototype);
+
+    /**
+     * Clears \p device and puts it into the pool. The device is
+     * dropped if someone else still holds a reference to it, or the
+     * pool is full.
+     */
+    void releaseDevice(KisPaintDeviceSP device);
+
+    /**
+     * Drops all the pooled devices
+     */
+    void clear();
+
+    int numPooledDevices() const;
+
+    /**
+     * The size class of a device with extent \p rc. Devices with the
+     * number of tiles in the same power of four share the class.
+     */
+    static int extentClass(const QRect &rc);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISPROJECTIONDEVICESPOOL_H
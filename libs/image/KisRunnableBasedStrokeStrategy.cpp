@@ -58,6 +58,13 @@ void KisRunnableBasedStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
     KisRunnableStrokeJobDataBase *runnable = dynamic_cast<KisRunnableStrokeJobDataBase*>(data);
     if (!runnable) return;
 
+    /**
+     * The jobs spawned by the running jobs after the stroke has been
+     * cancelled have no chance to be removed from the queue, so just
+     * skip them.
+     */
+    if (runnable->isCancellable() && isCancellationRequested()) return;
+
     runnable->run();
 }
 
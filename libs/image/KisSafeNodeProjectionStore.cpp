@@ -14,6 +14,7 @@
 #include "kis_paint_device.h"
 #include "kis_selection.h"
 #include "KisRecycleProjectionsJob.h"
+#include "KisProjectionDevicesPool.h"
 
 /**********************************************************************/
 /*     StoreImplementaionInterface                                    */
@@ -56,11 +57,15 @@ struct StoreImplementation : public StoreImplementaionInterface
 
     virtual void recycleProjectionsInSafety() override {
 //        qDebug() << "recycle caches";
-        Q_FOREACH (DeviceSP projection, m_dirtyProjections) {
-            projection->clear();
-            m_cleanProjections.append(projection);
+        while (!m_dirtyProjections.isEmpty()) {
+            recycleProjection(m_dirtyProjections.takeLast());
         }
-        m_dirtyProjections.clear();
+    }
+
+protected:
+    virtual void recycleProjection(DeviceSP projection) {
+        projection->clear();
+        m_cleanProjections.append(projection);
     }
 
 protected:
@@ -81,6 +86,25 @@ struct StoreImplementationForDevice : StoreImplementation<KisPaintDeviceSP>
         m_projection = new KisPaintDevice(prototype);
     }
 
+    ~StoreImplementationForDevice() override {
+        /**
+         * The node is being destroyed, so no one can access its
+         * projections anymore and they can be shared with other nodes
+         */
+        KisProjectionDevicesPool *pool = KisProjectionDevicesPool::instance();
+        if (!pool) return;
+
+        if (m_projection) {
+            KisPaintDeviceSP projection = m_projection;
+            m_projection = 0;
+            pool->releaseDevice(projection);
+        }
+
+        while (!m_dirtyProjections.isEmpty()) {
+            pool->releaseDevice(m_dirtyProjections.takeLast());
+        }
+    }
+
     StoreImplementaionInterface* clone() const override {
         return m_projection ?
             new StoreImplementationForDevice(*m_projection) :
@@ -91,9 +115,11 @@ struct StoreImplementationForDevice : StoreImplementation<KisPaintDeviceSP>
         if(!m_projection ||
            *m_projection->colorSpace() != *prototype->colorSpace()) {
 
-            if (!m_cleanProjections.isEmpty()) {
-                m_projection = m_cleanProjections.takeLast();
-                m_projection->makeCloneFromRough(prototype, prototype->extent());
+            KisPaintDeviceSP pooledDevice =
+                KisProjectionDevicesPool::instance()->acquireDevice(prototype);
+
+            if (pooledDevice) {
+                m_projection = pooledDevice;
             } else {
                 m_projection = new KisPaintDevice(*prototype);
             }
@@ -102,6 +128,12 @@ struct StoreImplementationForDevice : StoreImplementation<KisPaintDeviceSP>
         }
         return m_projection;
     }
+
+protected:
+    void recycleProjection(KisPaintDeviceSP projection) override {
+        // the clean devices are shared with all the other nodes
+        KisProjectionDevicesPool::instance()->releaseDevice(projection);
+    }
 };
 
 
@@ -0,0 +1,295 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSchedulerTracer.h"
+
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QThread>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+#include "kis_base_rects_walker.h"
+#include "kis_stroke_job.h"
+#include "kis_spontaneous_job.h"
+
+Q_GLOBAL_STATIC(KisSchedulerTracer, s_instance)
+
+namespace {
+
+QString sequentialityToString(KisStrokeJobData::Sequentiality value)
+{
+    switch (value) {
+    case KisStrokeJobData::SEQUENTIAL:
+        return "sequential";
+    case KisStrokeJobData::CONCURRENT:
+        return "concurrent";
+    case KisStrokeJobData::BARRIER:
+        return "barrier";
+    case KisStrokeJobData::UNIQUELY_CONCURRENT:
+        return "uniquely concurrent";
+    }
+
+    return "unknown";
+}
+
+QJsonArray rectToJson(const QRect &rc)
+{
+    return QJsonArray({rc.x(), rc.y(), rc.width(), rc.height()});
+}
+
+}
+
+struct KisSchedulerTracer::Private
+{
+    QMutex lock;
+    QElapsedTimer timer;
+    QString fileName;
+
+    QJsonArray events;
+    QHash<Qt::HANDLE, int> threadIds;
+    QHash<const void*, QString> strokeNames;
+
+    /**
+     * Chrome trace wants small integer ids for the threads, so we
+     * just enumerate them in the order of their first event
+     */
+    int currentThreadId();
+
+    void addEvent(QJsonObject event);
+};
+
+int KisSchedulerTracer::Private::currentThreadId()
+{
+    const Qt::HANDLE handle = QThread::currentThreadId();
+
+    auto it = threadIds.find(handle);
+    if (it != threadIds.end()) return *it;
+
+    const int id = threadIds.size() + 1;
+    threadIds.insert(handle, id);
+
+    const bool isGuiThread =
+        qApp && QThread::currentThread() == qApp->thread();
+
+    QJsonObject metadata;
+    metadata["ph"] = "M";
+    metadata["name"] = "thread_name";
+    metadata["pid"] = 1;
+    metadata["tid"] = id;
+    metadata["args"] = QJsonObject({{"name", isGuiThread ?
+                                     QString("GUI thread") :
+                                     QString("Worker %1").arg(id)}});
+    events.append(metadata);
+
+    return id;
+}
+
+void KisSchedulerTracer::Private::addEvent(QJsonObject event)
+{
+    QMutexLocker l(&lock);
+
+    event["pid"] = 1;
+    event["tid"] = currentThreadId();
+    events.append(event);
+}
+
+KisSchedulerTracer::KisSchedulerTracer()
+    : m_d(new Private),
+      m_enabled(false)
+{
+    const QString fileName = KisImageConfig(true).schedulerTraceFile();
+    if (!fileName.isEmpty()) {
+        startTracing(fileName);
+    }
+}
+
+KisSchedulerTracer::~KisSchedulerTracer()
+{
+    if (isEnabled()) {
+        stopTracing();
+    }
+}
+
+KisSchedulerTracer *KisSchedulerTracer::instance()
+{
+    return s_instance;
+}
+
+void KisSchedulerTracer::startTracing(const QString &fileName)
+{
+    QMutexLocker l(&m_d->lock);
+
+    m_d->fileName = fileName;
+    m_d->events = QJsonArray();
+    m_d->threadIds.clear();
+    m_d->strokeNames.clear();
+    m_d->timer.start();
+
+    m_enabled.store(true);
+}
+
+bool KisSchedulerTracer::stopTracing()
+{
+    QMutexLocker l(&m_d->lock);
+
+    if (!m_enabled.exchange(false)) return false;
+
+    QJsonObject root;
+    root["traceEvents"] = m_d->events;
+    root["displayTimeUnit"] = "ms";
+
+    m_d->events = QJsonArray();
+
+    QFile file(m_d->fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnImage << "Could not open scheduler trace file" << m_d->fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+qint64 KisSchedulerTracer::timestamp() const
+{
+    return m_d->timer.nsecsElapsed() / 1000;
+}
+
+void KisSchedulerTracer::reportMergeJob(qint64 startTime, KisBaseRectsWalkerSP walker)
+{
+    if (!isEnabled()) return;
+
+    KisNodeSP node = walker->startNode();
+
+    QJsonObject event;
+    event["ph"] = "X";
+    event["cat"] = "merge";
+    event["name"] = QString("merge: %1").arg(node ? node->name() : QString());
+    event["ts"] = startTime;
+    event["dur"] = timestamp() - startTime;
+    event["args"] = QJsonObject({
+        {"node", node ? node->name() : QString()},
+        {"requestedRect", rectToJson(walker->requestedRect())},
+        {"changeRect", rectToJson(walker->changeRect())},
+        {"accessRect", rectToJson(walker->accessRect())},
+        {"lod", walker->levelOfDetail()}
+    });
+
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::reportStrokeJob(qint64 startTime, KisStrokeJob *job)
+{
+    if (!isEnabled()) return;
+
+    QJsonObject event;
+    event["ph"] = "X";
+    event["cat"] = "stroke";
+    event["name"] = job->debugName();
+    event["ts"] = startTime;
+    event["dur"] = timestamp() - startTime;
+    event["args"] = QJsonObject({
+        {"sequentiality", sequentialityToString(job->sequentiality())},
+        {"exclusive", job->isExclusive()},
+        {"lod", job->levelOfDetail()}
+    });
+
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::reportSpontaneousJob(qint64 startTime, KisSpontaneousJob *job)
+{
+    if (!isEnabled()) return;
+
+    QJsonObject event;
+    event["ph"] = "X";
+    event["cat"] = "spontaneous";
+    event["name"] = job->debugName();
+    event["ts"] = startTime;
+    event["dur"] = timestamp() - startTime;
+    event["args"] = QJsonObject({
+        {"exclusive", job->isExclusive()},
+        {"lod", job->levelOfDetail()}
+    });
+
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::reportStrokeStarted(const void *stroke, const QString &name, int levelOfDetail)
+{
+    if (!isEnabled()) return;
+
+    QJsonObject event;
+    event["ph"] = "b";
+    event["cat"] = "strokes";
+    event["name"] = name;
+    event["id"] = QString::number(quintptr(stroke), 16);
+    event["ts"] = timestamp();
+    event["args"] = QJsonObject({{"lod", levelOfDetail}});
+
+    {
+        QMutexLocker l(&m_d->lock);
+        m_d->strokeNames.insert(stroke, name);
+    }
+
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::reportStrokeEnded(const void *stroke)
+{
+    if (!isEnabled()) return;
+
+    QString name;
+
+    {
+        QMutexLocker l(&m_d->lock);
+        name = m_d->strokeNames.take(stroke);
+    }
+
+    // async events are matched by their category, name and id
+    QJsonObject event;
+    event["ph"] = "e";
+    event["cat"] = "strokes";
+    event["name"] = name;
+    event["id"] = QString::number(quintptr(stroke), 16);
+    event["ts"] = timestamp();
+
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::reportBusyWaitStarted(const QString &name)
+{
+    if (!isEnabled()) return;
+
+    QJsonObject event;
+    event["ph"] = "B";
+    event["cat"] = "wait";
+    event["name"] = name;
+    event["ts"] = timestamp();
+
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::reportBusyWaitEnded()
+{
+    if (!isEnabled()) return;
+
+    QJsonObject event;
+    event["ph"] = "E";
+    event["cat"] = "wait";
+    event["ts"] = timestamp();
+
+    m_d->addEvent(event);
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSCHEDULERTRACER_H
+#define KISSCHEDULERTRACER_H
+
+#include <atomic>
+
+#include <QScopedPointer>
+#include <QString>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class KisStrokeJob;
+class KisSpontaneousJob;
+
+/**
+ * An opt-in recorder of the timeline of the update scheduler. Every
+ * stroke job, merge walker and spontaneous job executed by the
+ * updater threads is recorded with its thread, node, rect, level of
+ * detail and duration. The lifetime of the strokes and the busy-waits
+ * of the GUI thread go into the same timeline.
+ *
+ * The result is saved in Chrome Trace Event format, so it can be
+ * opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is started automatically when
+ * KisImageConfig::schedulerTraceFile() is set, and the file is written
+ * on exit or by stopTracing(). When tracing is disabled, the cost of
+ * every reporting point is a single relaxed atomic read.
+ */
+class KRITAIMAGE_EXPORT KisSchedulerTracer
+{
+public:
+    KisSchedulerTracer();
+    ~KisSchedulerTracer();
+
+    static KisSchedulerTracer* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Drops all the events recorded so far and starts recording
+     * the new timeline, which will be saved into \p fileName
+     */
+    void startTracing(const QString &fileName);
+
+    /**
+     * Stops recording and saves the timeline
+     * \return false if the file could not be written
+     */
+    bool stopTracing();
+
+    /**
+     * \return time in microseconds since the start of tracing
+     */
+    qint64 timestamp() const;
+
+    void reportMergeJob(qint64 startTime, KisBaseRectsWalkerSP walker);
+    void reportStrokeJob(qint64 startTime, KisStrokeJob *job);
+    void reportSpontaneousJob(qint64 startTime, KisSpontaneousJob *job);
+
+    void reportStrokeStarted(const void *stroke, const QString &name, int levelOfDetail);
+    void reportStrokeEnded(const void *stroke);
+
+    void reportBusyWaitStarted(const QString &name);
+    void reportBusyWaitEnded();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+    std::atomic<bool> m_enabled;
+};
+
+#endif // KISSCHEDULERTRACER_H
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSEQUENTIALITERATOROUTOFCORE_H
+#define KISSEQUENTIALITERATOROUTOFCORE_H
+
+#include "kis_sequential_iterator.h"
+#include "tiles3/kis_tile_data_interface.h"
+
+/**
+ * A progress policy for processing devices that are bigger than
+ * the physical memory.
+ *
+ * The sequential iterator walks the rect in scanline order, so as
+ * soon as it enters a new band of tiles, the band above it will
+ * never be accessed again. The policy moves such bands into the
+ * swap right away instead of waiting for the swapper to find them.
+ * Together with the swap prefetcher loading the bands ahead, it
+ * keeps the memory used by the processing bounded by a couple of
+ * tile rows, and the swapper doesn't have to evict tiles of other
+ * devices (or the tiles still being processed).
+ *
+ * The policy wraps another progress policy, so progress reporting
+ * still works as usual:
+ *
+ * \code{.cpp}
+ * KisSequentialIteratorOutOfCore it(dev, rect, OutOfCoreProgressPolicy<>(dev, rect));
+ * while (it.nextPixel()) {
+ *     // process it.rawData()
+ * }
+ * \endcode
+ */
+template <class BaseProgressPolicy = NoProgressPolicy>
+struct OutOfCoreProgressPolicy
+{
+    OutOfCoreProgressPolicy(KisPaintDeviceSP dev, const QRect &rect,
+                            BaseProgressPolicy baseProgressPolicy = BaseProgressPolicy())
+        : m_dev(dev),
+          m_baseProgressPolicy(baseProgressPolicy),
+          m_left(rect.left()),
+          m_width(rect.width()),
+          m_bottom(rect.top() + rect.height()),
+          m_releasedTop(rect.top()),
+          m_nextBandTop(nextBandTop(rect.top()))
+    {
+    }
+
+    ALWAYS_INLINE void setRange(int minimum, int maximum)
+    {
+        m_baseProgressPolicy.setRange(minimum, maximum);
+    }
+
+    ALWAYS_INLINE void setValue(int value)
+    {
+        m_baseProgressPolicy.setValue(value);
+
+        if (value >= m_nextBandTop) {
+            releaseBandsAbove(value);
+        }
+    }
+
+    ALWAYS_INLINE void setFinished()
+    {
+        releaseRows(m_bottom);
+        m_baseProgressPolicy.setFinished();
+    }
+
+private:
+    int nextBandTop(int y) const {
+        const int tileHeight = KisTileData::HEIGHT;
+        const int offset = y - m_dev->y();
+        const int row = offset >= 0 ? offset / tileHeight : -((-offset + tileHeight - 1) / tileHeight);
+        return m_dev->y() + (row + 1) * tileHeight;
+    }
+
+    void releaseBandsAbove(int y) {
+        // rows above the current band have been fully processed
+        releaseRows(nextBandTop(y) - KisTileData::HEIGHT);
+        m_nextBandTop = nextBandTop(y);
+    }
+
+    void releaseRows(int bottom) {
+        if (bottom <= m_releasedTop) return;
+
+        m_dev->swapOutData(QRect(m_left, m_releasedTop, m_width, bottom - m_releasedTop));
+        m_releasedTop = bottom;
+    }
+
+private:
+    KisPaintDeviceSP m_dev;
+    BaseProgressPolicy m_baseProgressPolicy;
+    int m_left;
+    int m_width;
+    int m_bottom;
+    int m_releasedTop;
+    int m_nextBandTop;
+};
+
+typedef KisSequentialIteratorBase<ReadOnlyIteratorPolicy<>, DevicePolicy, OutOfCoreProgressPolicy<> > KisSequentialConstIteratorOutOfCore;
+typedef KisSequentialIteratorBase<WritableIteratorPolicy<>, DevicePolicy, OutOfCoreProgressPolicy<> > KisSequentialIteratorOutOfCore;
+
+#endif // KISSEQUENTIALITERATOROUTOFCORE_H
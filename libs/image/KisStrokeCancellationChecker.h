@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKECANCELLATIONCHECKER_H
+#define KISSTROKECANCELLATIONCHECKER_H
+
+#include "kis_stroke_strategy.h"
+
+/**
+ * A cooperative preemption point for long running stroke jobs. Call
+ * isCancelled() every time a piece of work (e.g. a row of tiles) is
+ * done; the actual flag of the stroke is read only once every \p
+ * interval calls. As soon as the stroke is cancelled the checker
+ * keeps returning true, so the job can exit its loops.
+ *
+ * Use it only in cancellable jobs: the changes they leave behind
+ * are reverted by the cancel job of the stroke.
+ *
+ * \see KisStrokeStrategy::isCancellationRequested()
+ */
+class KisStrokeCancellationChecker
+{
+public:
+    KisStrokeCancellationChecker(const KisStrokeStrategy *strategy, int interval = 1)
+        : m_strategy(strategy),
+          m_interval(interval),
+          m_counter(0),
+          m_cancelled(false)
+    {
+    }
+
+    inline bool isCancelled() {
+        if (m_cancelled) return true;
+
+        if (++m_counter >= m_interval) {
+            m_counter = 0;
+            m_cancelled = m_strategy->isCancellationRequested();
+        }
+
+        return m_cancelled;
+    }
+
+private:
+    const KisStrokeStrategy *m_strategy;
+    int m_interval;
+    int m_counter;
+    bool m_cancelled;
+};
+
+#endif // KISSTROKECANCELLATIONCHECKER_H
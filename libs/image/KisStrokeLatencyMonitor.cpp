@@ -0,0 +1,374 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeLatencyMonitor.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGlobalStatic>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRect>
+#include <QRegion>
+#include <QtMath>
+
+#include "kis_image_config.h"
+#include "kis_lod_transform.h"
+
+Q_GLOBAL_STATIC(KisStrokeLatencyMonitor, s_instance)
+
+namespace {
+
+/// the events that haven't reached the screen in this time are considered lost
+const qint64 maxEventLifetime = 2000000; // in microseconds
+
+struct Ticket
+{
+    quint64 id = 0;
+    qint64 stageTime[KisStrokeLatencyMonitor::NumStages] = {0};
+
+    /// the area that is still to pass the current stage
+    QRegion pendingRegion;
+    int levelOfDetail = 0;
+    QRect dirtyBounds;
+};
+
+qreal percentile(const QVector<qint64> &sortedValues, qreal fraction)
+{
+    if (sortedValues.isEmpty()) return 0.0;
+
+    const int index = qBound(0, qCeil(fraction * sortedValues.size()) - 1, sortedValues.size() - 1);
+    return sortedValues[index] / 1000.0;
+}
+
+}
+
+struct KisStrokeLatencyMonitor::Private
+{
+    QMutex mutex;
+    QElapsedTimer clock;
+
+    quint64 lastEventId = 0;
+
+    QMap<quint64, Ticket> inputTickets;
+    QList<Ticket> paintedTickets;
+    QList<Ticket> dirtyTickets;
+    QList<Ticket> mergedTickets;
+    QList<Ticket> uploadedTickets;
+
+    bool strokeIsActive = false;
+    int numDroppedEvents = 0;
+
+    /// the latencies of every stage of the presented events, in microseconds
+    QVector<qint64> stageLatencies[NumStages];
+
+    Statistics lastStatistics;
+
+    qint64 now() const {
+        return clock.nsecsElapsed() / 1000;
+    }
+
+    bool hasPendingTickets() const {
+        return !inputTickets.isEmpty() || !paintedTickets.isEmpty() ||
+            !dirtyTickets.isEmpty() || !mergedTickets.isEmpty() ||
+            !uploadedTickets.isEmpty();
+    }
+
+    void dropOutdatedTickets(QList<Ticket> &tickets, qint64 time);
+    void dropOutdatedTickets(qint64 time);
+
+    void reset();
+    void tryFinishStroke();
+};
+
+void KisStrokeLatencyMonitor::Private::dropOutdatedTickets(QList<Ticket> &tickets, qint64 time)
+{
+    while (!tickets.isEmpty() && time - tickets.first().stageTime[Input] > maxEventLifetime) {
+        tickets.removeFirst();
+        numDroppedEvents++;
+    }
+}
+
+void KisStrokeLatencyMonitor::Private::dropOutdatedTickets(qint64 time)
+{
+    while (!inputTickets.isEmpty() && time - inputTickets.first().stageTime[Input] > maxEventLifetime) {
+        inputTickets.erase(inputTickets.begin());
+        numDroppedEvents++;
+    }
+
+    dropOutdatedTickets(paintedTickets, time);
+    dropOutdatedTickets(dirtyTickets, time);
+    dropOutdatedTickets(mergedTickets, time);
+    dropOutdatedTickets(uploadedTickets, time);
+}
+
+void KisStrokeLatencyMonitor::Private::reset()
+{
+    inputTickets.clear();
+    paintedTickets.clear();
+    dirtyTickets.clear();
+    mergedTickets.clear();
+    uploadedTickets.clear();
+
+    numDroppedEvents = 0;
+
+    for (int i = 0; i < NumStages; i++) {
+        stageLatencies[i].clear();
+    }
+}
+
+void KisStrokeLatencyMonitor::Private::tryFinishStroke()
+{
+    if (strokeIsActive || hasPendingTickets()) return;
+
+    QVector<qint64> &totalLatencies = stageLatencies[Input];
+    if (totalLatencies.isEmpty() && !numDroppedEvents) return;
+
+    Statistics stats;
+    stats.numEvents = totalLatencies.size();
+    stats.numDroppedEvents = numDroppedEvents;
+
+    for (int i = 0; i < NumStages; i++) {
+        std::sort(stageLatencies[i].begin(), stageLatencies[i].end());
+    }
+
+    stats.p50 = percentile(totalLatencies, 0.50);
+    stats.p90 = percentile(totalLatencies, 0.90);
+    stats.p99 = percentile(totalLatencies, 0.99);
+    stats.max = percentile(totalLatencies, 1.0);
+
+    for (int i = Paintop; i < NumStages; i++) {
+        stats.stageMedian[i] = percentile(stageLatencies[i], 0.50);
+    }
+
+    lastStatistics = stats;
+
+    qInfo().noquote() << QString("Stroke latency: %1 events (%2 dropped), p50 %3 ms, p90 %4 ms, p99 %5 ms, max %6 ms; "
+                                 "median per stage: paintop %7 ms, dirty %8 ms, merged %9 ms, uploaded %10 ms, presented %11 ms")
+                         .arg(stats.numEvents).arg(stats.numDroppedEvents)
+                         .arg(stats.p50, 0, 'f', 1).arg(stats.p90, 0, 'f', 1)
+                         .arg(stats.p99, 0, 'f', 1).arg(stats.max, 0, 'f', 1)
+                         .arg(stats.stageMedian[Paintop], 0, 'f', 1)
+                         .arg(stats.stageMedian[Dirty], 0, 'f', 1)
+                         .arg(stats.stageMedian[Merged], 0, 'f', 1)
+                         .arg(stats.stageMedian[Uploaded], 0, 'f', 1)
+                         .arg(stats.stageMedian[Presented], 0, 'f', 1);
+
+    reset();
+}
+
+KisStrokeLatencyMonitor::KisStrokeLatencyMonitor()
+    : m_enabled(false),
+      m_d(new Private)
+{
+    m_d->clock.start();
+    m_enabled = KisImageConfig(true).trackStrokeLatency();
+}
+
+KisStrokeLatencyMonitor::~KisStrokeLatencyMonitor()
+{
+}
+
+KisStrokeLatencyMonitor* KisStrokeLatencyMonitor::instance()
+{
+    return s_instance;
+}
+
+void KisStrokeLatencyMonitor::setEnabled(bool value)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->reset();
+    m_d->strokeIsActive = false;
+    m_d->lastStatistics = Statistics();
+    m_enabled = value;
+}
+
+void KisStrokeLatencyMonitor::startStrokeMeasure()
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    if (m_d->hasPendingTickets()) {
+        // the previous stroke has not reached the screen yet,
+        // report it with whatever has been presented
+        m_d->numDroppedEvents += m_d->inputTickets.size() + m_d->paintedTickets.size() +
+            m_d->dirtyTickets.size() + m_d->mergedTickets.size() + m_d->uploadedTickets.size();
+
+        m_d->inputTickets.clear();
+        m_d->paintedTickets.clear();
+        m_d->dirtyTickets.clear();
+        m_d->mergedTickets.clear();
+        m_d->uploadedTickets.clear();
+
+        m_d->strokeIsActive = false;
+        m_d->tryFinishStroke();
+    }
+
+    m_d->reset();
+    m_d->strokeIsActive = true;
+}
+
+void KisStrokeLatencyMonitor::endStrokeMeasure()
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->strokeIsActive = false;
+    m_d->tryFinishStroke();
+}
+
+quint64 KisStrokeLatencyMonitor::registerInputEvent()
+{
+    if (!isEnabled()) return 0;
+
+    QMutexLocker l(&m_d->mutex);
+
+    if (!m_d->strokeIsActive) return 0;
+
+    const qint64 time = m_d->now();
+    m_d->dropOutdatedTickets(time);
+
+    Ticket ticket;
+    ticket.id = ++m_d->lastEventId;
+    ticket.stageTime[Input] = time;
+
+    m_d->inputTickets.insert(ticket.id, ticket);
+
+    return ticket.id;
+}
+
+void KisStrokeLatencyMonitor::reportEventPainted(quint64 eventId)
+{
+    if (!isEnabled() || !eventId) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    const qint64 time = m_d->now();
+
+    /**
+     * With the Level of Detail the event is painted twice, the second, LoD0,
+     * time it is already gone from the input tickets and is ignored
+     */
+    auto it = m_d->inputTickets.begin();
+    while (it != m_d->inputTickets.end() && it.key() <= eventId) {
+        it->stageTime[Paintop] = time;
+        m_d->paintedTickets.append(*it);
+        it = m_d->inputTickets.erase(it);
+    }
+}
+
+void KisStrokeLatencyMonitor::reportDirtyRects(const QVector<QRect> &rects, int levelOfDetail)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    if (m_d->paintedTickets.isEmpty()) return;
+
+    QRegion region;
+    Q_FOREACH (const QRect &rc, rects) {
+        region += rc;
+    }
+
+    if (region.isEmpty()) return;
+
+    const qint64 time = m_d->now();
+
+    Q_FOREACH (Ticket ticket, m_d->paintedTickets) {
+        ticket.stageTime[Dirty] = time;
+        ticket.pendingRegion = region;
+        ticket.dirtyBounds = region.boundingRect();
+        ticket.levelOfDetail = levelOfDetail;
+        m_d->dirtyTickets.append(ticket);
+    }
+
+    m_d->paintedTickets.clear();
+}
+
+void KisStrokeLatencyMonitor::reportProjectionUpdated(const QRect &rect, int levelOfDetail)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    const qint64 time = m_d->now();
+
+    for (auto it = m_d->dirtyTickets.begin(); it != m_d->dirtyTickets.end();) {
+        if (it->levelOfDetail == levelOfDetail) {
+            it->pendingRegion -= rect;
+        }
+
+        if (it->pendingRegion.isEmpty()) {
+            it->stageTime[Merged] = time;
+
+            // the canvas works with the full-size coordinates
+            it->pendingRegion = it->levelOfDetail ?
+                KisLodTransform::upscaledRect(it->dirtyBounds, it->levelOfDetail) :
+                it->dirtyBounds;
+
+            m_d->mergedTickets.append(*it);
+            it = m_d->dirtyTickets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KisStrokeLatencyMonitor::reportTexturesUploaded(const QRect &imageRect)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    const qint64 time = m_d->now();
+
+    for (auto it = m_d->mergedTickets.begin(); it != m_d->mergedTickets.end();) {
+        it->pendingRegion -= imageRect;
+
+        if (it->pendingRegion.isEmpty()) {
+            it->stageTime[Uploaded] = time;
+            m_d->uploadedTickets.append(*it);
+            it = m_d->mergedTickets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KisStrokeLatencyMonitor::reportFramePresented()
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    const qint64 time = m_d->now();
+
+    Q_FOREACH (const Ticket &ticket, m_d->uploadedTickets) {
+        m_d->stageLatencies[Input].append(time - ticket.stageTime[Input]);
+
+        for (int i = Paintop; i < Presented; i++) {
+            m_d->stageLatencies[i].append(ticket.stageTime[i] - ticket.stageTime[i - 1]);
+        }
+        m_d->stageLatencies[Presented].append(time - ticket.stageTime[Uploaded]);
+    }
+    m_d->uploadedTickets.clear();
+
+    m_d->dropOutdatedTickets(time);
+    m_d->tryFinishStroke();
+}
+
+KisStrokeLatencyMonitor::Statistics KisStrokeLatencyMonitor::lastStrokeStatistics() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->lastStatistics;
+}
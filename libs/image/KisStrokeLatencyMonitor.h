@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKELATENCYMONITOR_H
+#define KISSTROKELATENCYMONITOR_H
+
+#include <atomic>
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class QRect;
+
+/**
+ * Measures the end-to-end latency of the freehand strokes, from the
+ * moment an input event arrives to the frame where its dabs are shown.
+ *
+ * Every input event of a stroke gets an id, which travels with its
+ * KisPaintInformation through the paintop. From there on the event is
+ * followed by the area it dirtied: through the merge of the projection,
+ * the upload of the canvas textures and the swap of the buffers. Like
+ * in KisUpdateTimeMonitor, an event passes a stage when all its dirty
+ * area has passed it.
+ *
+ * The events are measured in stages:
+ *
+ * Input     the event has been converted into the paint information
+ * Paintop   the paintop has processed the paint information
+ * Dirty     the dabs are rendered and the layer is marked dirty
+ * Merged    the projection of the dirty area is updated
+ * Uploaded  the canvas has uploaded the area into its textures
+ * Presented the frame with the area has been swapped to the screen
+ *
+ * The percentiles of the latency are printed when the stroke is
+ * finished and all its events are presented. The monitor is enabled by
+ * KisImageConfig::trackStrokeLatency(), when it is disabled every
+ * reporting point costs a single relaxed atomic read.
+ */
+class KRITAIMAGE_EXPORT KisStrokeLatencyMonitor
+{
+public:
+    enum Stage {
+        Input = 0,
+        Paintop,
+        Dirty,
+        Merged,
+        Uploaded,
+        Presented,
+
+        NumStages
+    };
+
+    struct Statistics {
+        int numEvents = 0;
+
+        /// the events that never reached the screen, e.g. painted outside the image
+        int numDroppedEvents = 0;
+
+        /// the percentiles of the whole latency, in milliseconds
+        qreal p50 = 0.0;
+        qreal p90 = 0.0;
+        qreal p99 = 0.0;
+        qreal max = 0.0;
+
+        /// the median time each event spent between the previous stage and this one
+        qreal stageMedian[NumStages] = {0.0};
+    };
+
+public:
+    KisStrokeLatencyMonitor();
+    ~KisStrokeLatencyMonitor();
+
+    static KisStrokeLatencyMonitor* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void setEnabled(bool value);
+
+    void startStrokeMeasure();
+    void endStrokeMeasure();
+
+    /**
+     * \return the id to be assigned to the paint information of the
+     * new input event with KisPaintInformation::setInputEventId(), or
+     * 0 if the monitor is disabled
+     */
+    quint64 registerInputEvent();
+
+    /**
+     * Called when the paintop has processed the paint information of
+     * \p eventId. The events cannot overtake each other, so all the
+     * earlier events, e.g. merged by the smoothing, pass the stage too.
+     */
+    void reportEventPainted(quint64 eventId);
+
+    /**
+     * All the painted events produced the dabs in \p rects, in the
+     * coordinates of \p levelOfDetail
+     */
+    void reportDirtyRects(const QVector<QRect> &rects, int levelOfDetail);
+
+    void reportProjectionUpdated(const QRect &rect, int levelOfDetail);
+
+    /**
+     * The canvas has uploaded \p imageRect, in the coordinates
+     * of the full-size image
+     */
+    void reportTexturesUploaded(const QRect &imageRect);
+
+    void reportFramePresented();
+
+    /**
+     * \return the statistics of the last finished stroke
+     */
+    Statistics lastStrokeStatistics() const;
+
+private:
+    std::atomic<bool> m_enabled;
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISSTROKELATENCYMONITOR_H
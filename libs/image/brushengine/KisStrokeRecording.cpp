@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeRecording.h"
+
+#include <QDataStream>
+#include <QFile>
+
+#include "kis_painter.h"
+#include "kis_paint_information.h"
+#include "kis_distance_information.h"
+
+namespace {
+const quint32 recordingMagic = 0x4B535452; // "KSTR"
+const quint16 recordingVersion = 1;
+}
+
+void KisStrokeRecording::addSample(const KisPaintInformation &pi)
+{
+    Sample sample;
+    sample.pos = pi.pos();
+    sample.pressure = pi.pressure();
+    sample.xTilt = pi.xTilt();
+    sample.yTilt = pi.yTilt();
+    sample.rotation = pi.rotation();
+    sample.tangentialPressure = pi.tangentialPressure();
+    sample.perspective = pi.perspective();
+    sample.time = pi.currentTime();
+    sample.speed = pi.drawingSpeed();
+
+    m_samples.append(sample);
+}
+
+void KisStrokeRecording::clear()
+{
+    m_samples.clear();
+}
+
+bool KisStrokeRecording::isEmpty() const
+{
+    return m_samples.isEmpty();
+}
+
+int KisStrokeRecording::numSamples() const
+{
+    return m_samples.size();
+}
+
+KisPaintInformation KisStrokeRecording::sample(int index) const
+{
+    const Sample &s = m_samples[index];
+
+    return KisPaintInformation(s.pos, s.pressure,
+                               s.xTilt, s.yTilt,
+                               s.rotation, s.tangentialPressure,
+                               s.perspective, s.time, s.speed);
+}
+
+qreal KisStrokeRecording::duration() const
+{
+    return !m_samples.isEmpty() ? m_samples.last().time : 0.0;
+}
+
+bool KisStrokeRecording::save(QIODevice *device) const
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << recordingMagic << recordingVersion << quint32(m_samples.size());
+
+    Q_FOREACH (const Sample &s, m_samples) {
+        stream << float(s.pos.x()) << float(s.pos.y())
+               << s.pressure << s.xTilt << s.yTilt
+               << s.rotation << s.tangentialPressure << s.perspective
+               << s.time << s.speed;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool KisStrokeRecording::load(QIODevice *device)
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 numSamples = 0;
+
+    stream >> magic >> version >> numSamples;
+
+    if (stream.status() != QDataStream::Ok ||
+        magic != recordingMagic ||
+        version != recordingVersion) {
+
+        return false;
+    }
+
+    QVector<Sample> samples;
+    samples.reserve(numSamples);
+
+    for (quint32 i = 0; i < numSamples; i++) {
+        Sample s;
+        float x = 0.0;
+        float y = 0.0;
+
+        stream >> x >> y
+               >> s.pressure >> s.xTilt >> s.yTilt
+               >> s.rotation >> s.tangentialPressure >> s.perspective
+               >> s.time >> s.speed;
+
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+
+        s.pos = QPointF(x, y);
+        samples.append(s);
+    }
+
+    m_samples = samples;
+    return true;
+}
+
+bool KisStrokeRecording::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    return save(&file);
+}
+
+bool KisStrokeRecording::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    return load(&file);
+}
+
+void KisStrokeRecording::replay(KisPainter *painter, KisDistanceInformation *currentDistance) const
+{
+    if (m_samples.isEmpty()) return;
+
+    KisPaintInformation previous = sample(0);
+    painter->paintAt(previous, currentDistance);
+
+    for (int i = 1; i < m_samples.size(); i++) {
+        const KisPaintInformation current = sample(i);
+        painter->paintLine(previous, current, currentDistance);
+        previous = current;
+    }
+}
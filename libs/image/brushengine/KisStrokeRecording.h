@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKERECORDING_H
+#define KISSTROKERECORDING_H
+
+#include "kritaimage_export.h"
+
+#include <QPointF>
+#include <QVector>
+
+class QIODevice;
+class QString;
+class KisPainter;
+class KisPaintInformation;
+class KisDistanceInformation;
+
+/**
+ * A stream of the paint information of a stroke, as it came from the
+ * input device. The recording can be saved into a compact binary file
+ * and replayed later with any preset, which lets the paintops be
+ * benchmarked with the real tablet strokes instead of synthetic lines.
+ *
+ * Only the values coming from the input device are stored, i.e. the
+ * position, pressure, tilt, rotation, tangential pressure, perspective,
+ * time and speed. All of them are stored with single precision.
+ */
+class KRITAIMAGE_EXPORT KisStrokeRecording
+{
+public:
+    void addSample(const KisPaintInformation &pi);
+    void clear();
+
+    bool isEmpty() const;
+    int numSamples() const;
+
+    /**
+     * @return the paint information of the sample \p index
+     */
+    KisPaintInformation sample(int index) const;
+
+    /**
+     * @return the time of the last sample of the recording in
+     * milliseconds
+     */
+    qreal duration() const;
+
+    bool save(QIODevice *device) const;
+    bool load(QIODevice *device);
+
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+    /**
+     * Paints the recorded stroke with \p painter as fast as possible.
+     * The dabs are counted in \p currentDistance.
+     */
+    void replay(KisPainter *painter, KisDistanceInformation *currentDistance) const;
+
+private:
+    struct Sample {
+        QPointF pos;
+        float pressure;
+        float xTilt;
+        float yTilt;
+        float rotation;
+        float tangentialPressure;
+        float perspective;
+        float time;
+        float speed;
+    };
+
+    QVector<Sample> m_samples;
+};
+
+#endif // KISSTROKERECORDING_H
@@ -80,6 +80,7 @@ struct KisPaintInformation::Private {
         }
 
         levelOfDetail = rhs.levelOfDetail;
+        inputEventId = rhs.inputEventId;
     }
 
 
@@ -129,6 +130,7 @@ struct KisPaintInformation::Private {
     boost::optional<DirectionHistoryInfo> directionHistoryInfo;
 
     int levelOfDetail;
+    quint64 inputEventId = 0;
 
     void registerDistanceInfo(KisDistanceInformation *di) {
         directionHistoryInfo = DirectionHistoryInfo(di->scalarDistanceApprox(),
@@ -525,6 +527,16 @@ void KisPaintInformation::setLevelOfDetail(int levelOfDetail)
     d->levelOfDetail = levelOfDetail;
 }
 
+quint64 KisPaintInformation::inputEventId() const
+{
+    return d->inputEventId;
+}
+
+void KisPaintInformation::setInputEventId(quint64 value)
+{
+    d->inputEventId = value;
+}
+
 QDebug operator<<(QDebug dbg, const KisPaintInformation &info)
 {
 #ifdef NDEBUG
@@ -598,6 +610,7 @@ void KisPaintInformation::mixOtherImpl(const QPointF &p, qreal t, const KisPaint
         this->d->pos = p;
         this->d->isHoveringMode = false;
         this->d->levelOfDetail = 0;
+        this->d->inputEventId = qMax(this->d->inputEventId, other.d->inputEventId);
         return;
     }
     else {
@@ -621,6 +634,7 @@ void KisPaintInformation::mixOtherImpl(const QPointF &p, qreal t, const KisPaint
         qreal speed = (1 - t) * other.drawingSpeed() + t * this->drawingSpeed();
 
         KIS_ASSERT_RECOVER_NOOP(other.isHoveringMode() == this->isHoveringMode());
+        const quint64 inputEventId = qMax(this->d->inputEventId, other.d->inputEventId);
         *(this->d) = Private(p, pressure, xTilt, yTilt, rotation, tangentialPressure, perspective, time, speed, other.isHoveringMode());
         this->d->canvasRotation = other.d->canvasRotation;
         this->d->canvasMirroredH = other.d->canvasMirroredH;
@@ -629,6 +643,7 @@ void KisPaintInformation::mixOtherImpl(const QPointF &p, qreal t, const KisPaint
         this->d->perStrokeRandomSource = other.d->perStrokeRandomSource;
         // this->d->isHoveringMode = other.isHoveringMode();
         this->d->levelOfDetail = other.d->levelOfDetail;
+        this->d->inputEventId = inputEventId;
     }
 }
 
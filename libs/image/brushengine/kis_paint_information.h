@@ -222,6 +222,14 @@ public:
     // set level of detail which info object has been generated for
     void setLevelOfDetail(int levelOfDetail);
 
+    /**
+     * The id of the input event the info object has been generated for,
+     * 0 if the event is not tracked. The mixed objects get the id of the
+     * later event. \see KisStrokeLatencyMonitor
+     */
+    quint64 inputEventId() const;
+    void setInputEventId(quint64 value);
+
     /**
      * The paint information may be generated not only during real
      * stroke when the actual painting is happening, but also when the
@@ -17,11 +17,18 @@ struct Q_DECL_HIDDEN KisColorTransformationConfiguration::Private {
 
     ~Private()
     {
-        qDeleteAll(colorTransformation);
+        Q_FOREACH (const CachedTransformation &cached, colorTransformation) {
+            delete cached.transformation;
+        }
     }
 
+    struct CachedTransformation {
+        const KoColorSpace *colorSpace = 0;
+        KoColorTransformation *transformation = 0;
+    };
+
     // XXX: Threadlocal storage!!!
-    QMap<QThread*, KoColorTransformation*> colorTransformation;
+    QMap<QThread*, CachedTransformation> colorTransformation;
     QMutex mutex;
 };
 
@@ -50,12 +57,22 @@ KisFilterConfigurationSP KisColorTransformationConfiguration::clone() const
 KoColorTransformation* KisColorTransformationConfiguration::colorTransformation(const KoColorSpace *cs, const KisColorTransformationFilter *filter) const
 {
     QMutexLocker locker(&d->mutex);
-    KoColorTransformation *transformation = d->colorTransformation.value(QThread::currentThread(), 0);
-    if (!transformation) {
+    Private::CachedTransformation &cached = d->colorTransformation[QThread::currentThread()];
+
+    /**
+     * The transformation is reused for all the tiles the thread processes,
+     * but the same configuration may be applied to the devices of
+     * different color spaces, e.g. by a filter mask
+     */
+    if (!cached.transformation || cached.colorSpace != cs) {
+        delete cached.transformation;
+
         KisFilterConfigurationSP config(const_cast<KisColorTransformationConfiguration*>(this));
-        transformation = filter->createTransformation(cs, config);
-        d->colorTransformation.insert(QThread::currentThread(), transformation);
+        cached.transformation = filter->createTransformation(cs, config);
+        cached.colorSpace = cs;
     }
+
+    KoColorTransformation *transformation = cached.transformation;
     locker.unlock();
     return transformation;
 }
@@ -9,6 +9,7 @@
 #include <KoAlwaysInline.h>
 
 #include <QStack>
+#include <QtConcurrent>
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -125,11 +126,19 @@ class DifferencePolicySlow
 public:
     ALWAYS_INLINE void initDifferences(KisPaintDeviceSP device, const KoColor &srcPixel, int threshold) {
         m_colorSpace = device->colorSpace();
+        m_pixelSize = m_colorSpace->pixelSize();
         m_srcPixel = srcPixel;
         m_srcPixelPtr = m_srcPixel.data();
         m_threshold = threshold;
     }
 
+    ALWAYS_INLINE void calculateDifferences(quint8 *pixelPtr, int numPixels, quint8 *differences) {
+        for (int i = 0; i < numPixels; i++) {
+            differences[i] = calculateDifference(pixelPtr);
+            pixelPtr += m_pixelSize;
+        }
+    }
+
     ALWAYS_INLINE quint8 calculateDifference(quint8* pixelPtr) {
         if (m_threshold == 1) {
             if (memcmp(m_srcPixelPtr, pixelPtr, m_colorSpace->pixelSize()) == 0) {
@@ -144,6 +153,7 @@ public:
 
 private:
     const KoColorSpace *m_colorSpace;
+    int m_pixelSize;
     KoColor m_srcPixel;
     const quint8 *m_srcPixelPtr;
     int m_threshold;
@@ -190,6 +200,25 @@ public:
         return result;
     }
 
+    /**
+     * The areas of the fill are usually flat, so the neighbouring pixels
+     * reuse the difference of the previous one without a hash lookup
+     */
+    ALWAYS_INLINE void calculateDifferences(quint8 *pixelPtr, int numPixels, quint8 *differences) {
+        HashKeyType *pixels = reinterpret_cast<HashKeyType*>(pixelPtr);
+
+        HashKeyType lastKey = pixels[0];
+        quint8 lastDifference = calculateDifference(pixelPtr);
+
+        for (int i = 0; i < numPixels; i++) {
+            if (pixels[i] != lastKey) {
+                lastKey = pixels[i];
+                lastDifference = calculateDifference(reinterpret_cast<quint8*>(pixels + i));
+            }
+            differences[i] = lastDifference;
+        }
+    }
+
 private:
     HashType m_differences;
 
@@ -248,13 +277,35 @@ public:
     {
         this->initDifferences(device, srcPixel, threshold);
         m_srcIt = this->createSourceDeviceAccessor(device);
+
+        for (int diff = 0; diff <= quint8_MAX; diff++) {
+            m_opacityForDifference[diff] = opacityForDifference(diff);
+        }
     }
 
     ALWAYS_INLINE quint8 calculateOpacity(quint8* pixelPtr, int x, int y) {
-        quint8 diff = this->calculateDifference(pixelPtr);
+        Q_UNUSED(x);
+        Q_UNUSED(y);
+        return m_opacityForDifference[this->calculateDifference(pixelPtr)];
+    }
 
+    /**
+     * Calculates the opacities of \p numPixels consecutive pixels of
+     * the row at once, avoiding the per-pixel dispatch into the policies
+     */
+    ALWAYS_INLINE void calculateOpacities(quint8 *pixelPtr, int numPixels, int x, int y, quint8 *opacities) {
         Q_UNUSED(x);
         Q_UNUSED(y);
+
+        this->calculateDifferences(pixelPtr, numPixels, opacities);
+
+        for (int i = 0; i < numPixels; i++) {
+            opacities[i] = m_opacityForDifference[opacities[i]];
+        }
+    }
+
+private:
+    quint8 opacityForDifference(quint8 diff) const {
         if (!useSmoothSelection) {
             return diff <= m_threshold ? MAX_SELECTED : MIN_SELECTED;
         } else {
@@ -270,6 +321,9 @@ public:
         }
     }
 
+protected:
+    quint8 m_opacityForDifference[quint8_MAX + 1];
+
 private:
     int m_threshold;
 };
@@ -289,7 +343,6 @@ public:
     SelectionPolicyExtended(KisPaintDeviceSP mainDevice, KisPaintDeviceSP selectionDevice, const KoColor &srcPixel, int threshold)
         : SelectionPolicy<useSmoothSelection, DifferencePolicy, PixelFiller>(mainDevice, srcPixel, threshold)
     {
-        m_threshold = threshold;
         this->initSelectedness(selectionDevice, threshold);
     }
 
@@ -298,24 +351,17 @@ public:
         quint8 diff = this->calculateDifference(pixelPtr);
         quint8 selectedness = this->calculateSelectedness(x, y);
 
-        if (!useSmoothSelection) {
-            return (diff <= m_threshold && selectedness > 0) ? MAX_SELECTED : MIN_SELECTED;
-        } else {
-            quint8 selectionValue = qMax(0, m_threshold - diff);
-            quint8 result = MIN_SELECTED;
+        return selectedness > 0 ? this->m_opacityForDifference[diff] : MIN_SELECTED;
+    }
 
-            if (selectionValue > 0 && selectedness > 0) {
-                qreal selectionNorm = qreal(selectionValue) / m_threshold;
-                result = MAX_SELECTED * selectionNorm;
-            }
+    ALWAYS_INLINE void calculateOpacities(quint8 *pixelPtr, int numPixels, int x, int y, quint8 *opacities) {
+        this->calculateDifferences(pixelPtr, numPixels, opacities);
 
-            return result;
+        for (int i = 0; i < numPixels; i++) {
+            quint8 selectedness = this->calculateSelectedness(x + i, y);
+            opacities[i] = selectedness > 0 ? this->m_opacityForDifference[opacities[i]] : MIN_SELECTED;
         }
     }
-
-private:
-    int m_threshold;
-
 };
 
 
@@ -340,6 +386,13 @@ public:
         return quint8_MAX;
     }
 
+    ALWAYS_INLINE void calculateDifferences(quint8 *pixelPtr, int numPixels, quint8 *differences) {
+        for (int i = 0; i < numPixels; i++) {
+            differences[i] = calculateDifference(pixelPtr);
+            pixelPtr += m_pixelSize;
+        }
+    }
+
 private:
     int m_pixelSize {0};
     QByteArray m_testPixel;
@@ -358,6 +411,14 @@ public:
         SrcPixelType *pixel = reinterpret_cast<SrcPixelType*>(pixelPtr);
         return *pixel == 0;
     }
+
+    ALWAYS_INLINE void calculateDifferences(quint8 *pixelPtr, int numPixels, quint8 *differences) {
+        SrcPixelType *pixels = reinterpret_cast<SrcPixelType*>(pixelPtr);
+
+        for (int i = 0; i < numPixels; i++) {
+            differences[i] = pixels[i] == 0;
+        }
+    }
 };
 
 class GroupSplitPolicy
@@ -392,6 +453,12 @@ public:
         return diff <= m_threshold ? MAX_SELECTED : MIN_SELECTED;
     }
 
+    ALWAYS_INLINE void calculateOpacities(quint8 *pixelPtr, int numPixels, int x, int y, quint8 *opacities) {
+        for (int i = 0; i < numPixels; i++) {
+            opacities[i] = calculateOpacity(pixelPtr + i, x + i, y);
+        }
+    }
+
     ALWAYS_INLINE void fillPixel(quint8 *dstPtr, quint8 opacity, int x, int y) {
         Q_UNUSED(opacity);
 
@@ -420,6 +487,274 @@ private:
 
 
 
+namespace {
+
+/**
+ * A horizontal run of the pixels with non-null opacity
+ */
+struct FillRun {
+    int start;
+    int end;
+};
+
+/**
+ * A band of rows of the bounding rect, labelled independently from the
+ * other bands
+ */
+struct FillBand {
+    QRect rect;
+    QVector<FillRun> runs;
+
+    /// the index of the first run of every row plus the total number of runs
+    QVector<int> rowOffsets;
+
+    /// the disjoint-set forest of the runs, local to the band
+    QVector<int> parents;
+
+    /// the index of the first run of the band in the global forest
+    int offset = 0;
+};
+
+inline int findRoot(int *parents, int i)
+{
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+inline int findRootConst(const int *parents, int i)
+{
+    while (parents[i] != i) {
+        i = parents[i];
+    }
+    return i;
+}
+
+inline void uniteRuns(int *parents, int a, int b)
+{
+    a = findRoot(parents, a);
+    b = findRoot(parents, b);
+
+    if (a < b) {
+        parents[b] = a;
+    } else if (b < a) {
+        parents[a] = b;
+    }
+}
+
+/**
+ * Unites the runs of two consecutive rows sharing at least one
+ * column, i.e. the ones that are 4-connected
+ */
+void uniteOverlappingRuns(const FillRun *upper, int upperBase, int numUpper,
+                          const FillRun *lower, int lowerBase, int numLower,
+                          int *parents)
+{
+    int i = 0;
+    int j = 0;
+
+    while (i < numUpper && j < numLower) {
+        if (upper[i].end >= lower[j].start && lower[j].end >= upper[i].start) {
+            uniteRuns(parents, upperBase + i, lowerBase + j);
+        }
+
+        if (upper[i].end < lower[j].end) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+}
+
+template <class T>
+void collectRuns(T &pixelPolicy, int row, int left, int right, QVector<quint8> *opacities, QVector<FillRun> *runs)
+{
+    int runStart = -1;
+
+    for (int x = left; x <= right;) {
+        pixelPolicy.m_srcIt->moveTo(x, row);
+        const int numPixels = qMin(pixelPolicy.m_srcIt->numContiguousColumns(x), right - x + 1);
+        quint8 *dataPtr = const_cast<quint8*>(pixelPolicy.m_srcIt->rawDataConst());
+
+        if (opacities->size() < numPixels) {
+            opacities->resize(numPixels);
+        }
+        pixelPolicy.calculateOpacities(dataPtr, numPixels, x, row, opacities->data());
+
+        for (int i = 0; i < numPixels; i++, x++) {
+            if ((*opacities)[i]) {
+                if (runStart < 0) {
+                    runStart = x;
+                }
+            } else if (runStart >= 0) {
+                runs->append({runStart, x - 1});
+                runStart = -1;
+            }
+        }
+    }
+
+    if (runStart >= 0) {
+        runs->append({runStart, right});
+    }
+}
+
+/**
+ * The parallel version of the fill. Since the policy doesn't modify the
+ * source device, the filled area is just the 4-connected component of
+ * the pixels with non-null opacity containing the start point, whatever
+ * the order of the traversal is. So the rect is split into tile-aligned
+ * bands, every band gets its runs labelled independently, the labels
+ * are merged at the borders of the bands and, finally, the runs of the
+ * component of the start point are filled in parallel.
+ *
+ * \p T must be a thread-unsafe policy with a const source, so every
+ * band constructs its own copy with \p createPolicy
+ */
+template <class T, class PolicyFactory>
+void runParallelImpl(const QRect &boundingRect, const QPoint &startPoint, PolicyFactory createPolicy)
+{
+    if (!boundingRect.contains(startPoint)) return;
+
+    const int bandHeight = 64;
+
+    QVector<FillBand> bands;
+
+    for (int y = boundingRect.top(); y <= boundingRect.bottom();) {
+        const int bandTop = y - (y % bandHeight + bandHeight) % bandHeight;
+        const int bottom = qMin(bandTop + bandHeight - 1, boundingRect.bottom());
+
+        FillBand band;
+        band.rect = QRect(boundingRect.left(), y, boundingRect.width(), bottom - y + 1);
+        bands.append(band);
+
+        y = bottom + 1;
+    }
+
+    QtConcurrent::blockingMap(bands,
+        [&] (FillBand &band) {
+            QScopedPointer<T> policy(createPolicy());
+            QVector<quint8> opacities;
+
+            for (int row = band.rect.top(); row <= band.rect.bottom(); row++) {
+                const int rowBegin = band.runs.size();
+                collectRuns(*policy, row, band.rect.left(), band.rect.right(), &opacities, &band.runs);
+                band.rowOffsets.append(rowBegin);
+            }
+            band.rowOffsets.append(band.runs.size());
+
+            band.parents.resize(band.runs.size());
+            for (int i = 0; i < band.parents.size(); i++) {
+                band.parents[i] = i;
+            }
+
+            for (int row = 1; row < band.rect.height(); row++) {
+                const int upperBegin = band.rowOffsets[row - 1];
+                const int lowerBegin = band.rowOffsets[row];
+                const int lowerEnd = band.rowOffsets[row + 1];
+
+                uniteOverlappingRuns(band.runs.constData() + upperBegin, upperBegin, lowerBegin - upperBegin,
+                                     band.runs.constData() + lowerBegin, lowerBegin, lowerEnd - lowerBegin,
+                                     band.parents.data());
+            }
+
+            // flatten the forest, so that the merged one stays shallow
+            for (int i = 0; i < band.parents.size(); i++) {
+                findRoot(band.parents.data(), i);
+            }
+        });
+
+    int numRuns = 0;
+    for (FillBand &band : bands) {
+        band.offset = numRuns;
+        numRuns += band.runs.size();
+    }
+
+    QVector<int> parents(numRuns);
+    for (const FillBand &band : bands) {
+        for (int i = 0; i < band.parents.size(); i++) {
+            parents[band.offset + i] = band.offset + band.parents[i];
+        }
+    }
+
+    for (int i = 1; i < bands.size(); i++) {
+        const FillBand &upperBand = bands[i - 1];
+        const FillBand &lowerBand = bands[i];
+
+        const int upperRow = upperBand.rect.height() - 1;
+        const int upperBegin = upperBand.rowOffsets[upperRow];
+        const int upperEnd = upperBand.rowOffsets[upperRow + 1];
+        const int lowerEnd = lowerBand.rowOffsets[1];
+
+        uniteOverlappingRuns(upperBand.runs.constData() + upperBegin, upperBand.offset + upperBegin, upperEnd - upperBegin,
+                             lowerBand.runs.constData(), lowerBand.offset, lowerEnd,
+                             parents.data());
+    }
+
+    int startRoot = -1;
+
+    for (const FillBand &band : bands) {
+        if (!band.rect.contains(startPoint)) continue;
+
+        const int row = startPoint.y() - band.rect.top();
+        for (int i = band.rowOffsets[row]; i < band.rowOffsets[row + 1]; i++) {
+            if (band.runs[i].start <= startPoint.x() && startPoint.x() <= band.runs[i].end) {
+                startRoot = findRoot(parents.data(), band.offset + i);
+                break;
+            }
+        }
+    }
+
+    if (startRoot < 0) return;
+
+    for (int i = 0; i < parents.size(); i++) {
+        findRoot(parents.data(), i);
+    }
+
+    QtConcurrent::blockingMap(bands,
+        [&] (const FillBand &band) {
+            QScopedPointer<T> policy;
+
+            for (int row = 0; row < band.rect.height(); row++) {
+                const int y = band.rect.top() + row;
+
+                for (int i = band.rowOffsets[row]; i < band.rowOffsets[row + 1]; i++) {
+                    if (findRootConst(parents.constData(), band.offset + i) != startRoot) continue;
+
+                    if (!policy) {
+                        policy.reset(createPolicy());
+                    }
+
+                    const FillRun &run = band.runs[i];
+                    for (int x = run.start; x <= run.end; x++) {
+                        policy->m_srcIt->moveTo(x, y);
+                        quint8 *pixelPtr = const_cast<quint8*>(policy->m_srcIt->rawDataConst());
+                        policy->fillPixel(pixelPtr, policy->calculateOpacity(pixelPtr, x, y), x, y);
+                    }
+                }
+            }
+        });
+}
+
+template <class T>
+struct SelectionFillPolicyFactory
+{
+    KisPaintDeviceSP device;
+    KoColor srcColor;
+    int threshold;
+    KisPixelSelectionSP pixelSelection;
+
+    T* operator()() const {
+        T *policy = new T(device, srcColor, threshold);
+        policy->setDestinationSelection(pixelSelection);
+        return policy;
+    }
+};
+
+}
+
+
 struct Q_DECL_HIDDEN KisScanlineFill::Private
 {
     KisPaintDeviceSP device;
@@ -430,6 +765,7 @@ struct Q_DECL_HIDDEN KisScanlineFill::Private
     int rowIncrement;
     KisFillIntervalMap backwardMap;
     QStack<KisFillInterval> forwardStack;
+    QVector<quint8> opacities;
 
 
     inline void swapDirection() {
@@ -533,6 +869,7 @@ void KisScanlineFill::processLine(KisFillInterval interval, const int rowIncreme
 
     int numPixelsLeft = 0;
     quint8 *dataPtr = 0;
+    const quint8 *opacityPtr = 0;
     const int pixelSize = m_d->device->pixelSize();
 
     while(x <= lastX) {
@@ -540,15 +877,27 @@ void KisScanlineFill::processLine(KisFillInterval interval, const int rowIncreme
         // methods too often
         if (numPixelsLeft <= 0) {
             pixelPolicy.m_srcIt->moveTo(x, row);
-            numPixelsLeft = pixelPolicy.m_srcIt->numContiguousColumns(x) - 1;
+            const int numPixels = qMin(pixelPolicy.m_srcIt->numContiguousColumns(x), lastX - x + 1);
+            numPixelsLeft = numPixels - 1;
             dataPtr = const_cast<quint8*>(pixelPolicy.m_srcIt->rawDataConst());
+
+            /**
+             * The fill never changes the pixels of the chunk before
+             * testing them, so their opacities can be calculated at once
+             */
+            if (m_d->opacities.size() < numPixels) {
+                m_d->opacities.resize(numPixels);
+            }
+            pixelPolicy.calculateOpacities(dataPtr, numPixels, x, row, m_d->opacities.data());
+            opacityPtr = m_d->opacities.constData();
         } else {
             numPixelsLeft--;
             dataPtr += pixelSize;
+            opacityPtr++;
         }
 
         quint8 *pixelPtr = dataPtr;
-        quint8 opacity = pixelPolicy.calculateOpacity(pixelPtr, x, row);
+        quint8 opacity = *opacityPtr;
 
         if (opacity) {
             if (!currentForwardInterval.isValid()) {
@@ -768,6 +1117,35 @@ void KisScanlineFill::fillSelection(KisPixelSelectionSP pixelSelection)
     }
 }
 
+void KisScanlineFill::fillSelectionParallel(KisPixelSelectionSP pixelSelection)
+{
+    KoColor srcColor(m_d->device->pixel(m_d->startPoint));
+
+    const int pixelSize = m_d->device->pixelSize();
+
+    if (pixelSize == 1) {
+        typedef SelectionPolicy<true, DifferencePolicyOptimized<quint8>, CopyToSelection> Policy;
+        SelectionFillPolicyFactory<Policy> factory {m_d->device, srcColor, m_d->threshold, pixelSelection};
+        runParallelImpl<Policy>(m_d->boundingRect, m_d->startPoint, factory);
+    } else if (pixelSize == 2) {
+        typedef SelectionPolicy<true, DifferencePolicyOptimized<quint16>, CopyToSelection> Policy;
+        SelectionFillPolicyFactory<Policy> factory {m_d->device, srcColor, m_d->threshold, pixelSelection};
+        runParallelImpl<Policy>(m_d->boundingRect, m_d->startPoint, factory);
+    } else if (pixelSize == 4) {
+        typedef SelectionPolicy<true, DifferencePolicyOptimized<quint32>, CopyToSelection> Policy;
+        SelectionFillPolicyFactory<Policy> factory {m_d->device, srcColor, m_d->threshold, pixelSelection};
+        runParallelImpl<Policy>(m_d->boundingRect, m_d->startPoint, factory);
+    } else if (pixelSize == 8) {
+        typedef SelectionPolicy<true, DifferencePolicyOptimized<quint64>, CopyToSelection> Policy;
+        SelectionFillPolicyFactory<Policy> factory {m_d->device, srcColor, m_d->threshold, pixelSelection};
+        runParallelImpl<Policy>(m_d->boundingRect, m_d->startPoint, factory);
+    } else {
+        typedef SelectionPolicy<true, DifferencePolicySlow, CopyToSelection> Policy;
+        SelectionFillPolicyFactory<Policy> factory {m_d->device, srcColor, m_d->threshold, pixelSelection};
+        runParallelImpl<Policy>(m_d->boundingRect, m_d->startPoint, factory);
+    }
+}
+
 void KisScanlineFill::clearNonZeroComponent()
 {
     const int pixelSize = m_d->device->pixelSize();
@@ -44,6 +44,17 @@ public:
      */
     void fillSelection(KisPixelSelectionSP pixelSelection);
 
+    /**
+     * Fill \p pixelSelection with the opacity of the contiguous area,
+     * exactly like fillSelection() does, but using all the cores.
+     *
+     * The whole bounding rect is scanned in tile-aligned bands to find
+     * the connected runs of pixels, so the method pays off only when the
+     * area is expected to cover a big part of the rect. For small areas
+     * in a huge rect fillSelection() is much faster.
+     */
+    void fillSelectionParallel(KisPixelSelectionSP pixelSelection);
+
     /**
      * Clear the contiguous non-zero area of the device
      *
@@ -79,6 +79,17 @@ public:
      */ 
     virtual bool allowsSplittingIntoPatches() const { return true; }
 
+    /**
+     * Reports whether the generated pixels depend on the bounds of the
+     * image, e.g. when the pattern is stretched over the whole image.
+     *
+     * The generator layer regenerates all its pixels on image resize only
+     * for the generators that return true. The other generators should
+     * override this function and return false, so that only the newly
+     * exposed area is generated.
+     */
+    virtual bool dependsOnImageBounds() const { return true; }
+
 protected:
 
     /// @return the name of config group in KConfig
@@ -25,10 +25,30 @@
 #include "kis_thread_safe_signal_compressor.h"
 #include <kis_generator_stroke_strategy.h>
 #include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+#include "kis_painter.h"
 
 
 #define UPDATE_DELAY 100 /*ms */
 
+/**
+ * The number of previously generated configurations kept around, so that
+ * switching back to one of them (e.g. in the layer dialog) doesn't need
+ * to regenerate the pixels
+ */
+#define MAX_CACHED_CONFIGURATIONS 2
+
+namespace {
+
+struct CachedGeneration {
+    QString configurationXml;
+    QRect imageBounds;
+    QRect rect;
+    KisPaintDeviceSP device;
+};
+
+}
+
 struct Q_DECL_HIDDEN KisGeneratorLayer::Private
 {
     Private()
@@ -42,6 +62,8 @@ struct Q_DECL_HIDDEN KisGeneratorLayer::Private
     KisFilterConfigurationSP preparedForFilter;
     QWeakPointer<bool> updateCookie;
     QMutex mutex;
+
+    QList<CachedGeneration> cachedGenerations;
 };
 
 
@@ -75,11 +97,8 @@ void KisGeneratorLayer::setFilter(KisFilterConfigurationSP filterConfig)
 void KisGeneratorLayer::setFilterWithoutUpdate(KisFilterConfigurationSP filterConfig)
 {
     if (filter().isNull() || !filter()->compareTo(filterConfig.constData())) {
+        // the prepared pixels are dropped (or cached) by the next update
         KisSelectionBasedLayer::setFilter(filterConfig);
-        {
-            QMutexLocker(&m_d->mutex);
-            m_d->preparedRect = QRect();
-        }
     }
 }
 
@@ -110,30 +129,95 @@ void KisGeneratorLayer::requestUpdateJobsWithStroke(KisStrokeId strokeId, KisFil
     KisImageSP image = this->image().toStrongRef();
     const QRect updateRect = extent() | image->bounds();
 
-    if (filterConfig != m_d->preparedForFilter) {
-        locker.unlock();
-        resetCacheWithoutUpdate();
-        locker.relock();
+    KisGeneratorSP f = KisGeneratorRegistry::instance()->value(filterConfig->name());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(f);
+
+    KisProcessingVisitor::ProgressHelper helper(this);
+
+    KisPaintDeviceSP originalDevice = original();
+    QVector<KisStrokeJobData*> jobs;
+
+    if (m_d->preparedForFilter != filterConfig &&
+        (!m_d->preparedForFilter || !m_d->preparedForFilter->compareTo(filterConfig.data()))) {
+
+        KisPaintDeviceSP snapshot;
+
+        if (m_d->preparedForFilter && !m_d->preparedRect.isEmpty()) {
+            snapshot = new KisPaintDevice(originalDevice->colorSpace());
+
+            CachedGeneration cached;
+            cached.configurationXml = m_d->preparedForFilter->toXML();
+            cached.imageBounds = m_d->preparedImageBounds;
+            cached.rect = m_d->preparedRect;
+            cached.device = snapshot;
+
+            m_d->cachedGenerations.prepend(cached);
+            while (m_d->cachedGenerations.size() > MAX_CACHED_CONFIGURATIONS + 1) {
+                m_d->cachedGenerations.removeLast();
+            }
+        }
+
+        m_d->preparedRect = QRect();
+
+        CachedGeneration restored;
+        const QString configurationXml = filterConfig->toXML();
+
+        for (auto it = m_d->cachedGenerations.begin(); it != m_d->cachedGenerations.end(); ++it) {
+            if (it->configurationXml != configurationXml) continue;
+
+            if (*it->device->colorSpace() == *image->colorSpace() &&
+                (!f->dependsOnImageBounds() || it->imageBounds == image->bounds())) {
+
+                restored = *it;
+                m_d->preparedRect = restored.rect;
+                m_d->preparedImageBounds = restored.imageBounds;
+            }
+
+            m_d->cachedGenerations.erase(it);
+            break;
+        }
+
+        while (m_d->cachedGenerations.size() > MAX_CACHED_CONFIGURATIONS) {
+            m_d->cachedGenerations.removeLast();
+        }
+
+        /**
+         * The device may still be in use by the previous update, so
+         * take the snapshot and reset it in the stroke only
+         */
+        KritaUtils::addJobBarrier(jobs, [this, snapshot, restored, originalDevice] () {
+            if (snapshot) {
+                snapshot->makeCloneFrom(originalDevice, originalDevice->extent());
+            }
+
+            KisSelectionBasedLayer::resetCache();
+
+            // the pixels of this configuration have already been generated
+            // once, so just bring them back and generate the rest only
+            if (restored.device) {
+                KisPainter::copyAreaOptimized(restored.rect.topLeft(), restored.device, originalDevice, restored.rect);
+                setDirtyWithoutUpdate({restored.rect});
+            }
+        });
     }
 
     if (m_d->preparedImageBounds != image->bounds()) {
-        m_d->preparedRect = QRect();
+        if (f->dependsOnImageBounds()) {
+            m_d->preparedRect = QRect();
+        } else {
+            m_d->preparedRect &= image->bounds();
+        }
     }
 
     const QRegion processRegion(QRegion(updateRect) - m_d->preparedRect);
-    if (processRegion.isEmpty())
+    if (processRegion.isEmpty() && jobs.isEmpty())
         return;
 
-    KisGeneratorSP f = KisGeneratorRegistry::instance()->value(filterConfig->name());
-    KIS_SAFE_ASSERT_RECOVER_RETURN(f);
-
-    KisProcessingVisitor::ProgressHelper helper(this);
-
-    KisPaintDeviceSP originalDevice = original();
-
     QSharedPointer<bool> cookie(new bool(true));
 
-    auto jobs = KisGeneratorStrokeStrategy::createJobsData(this, cookie, f, originalDevice, processRegion, filterConfig);
+    if (!processRegion.isEmpty()) {
+        jobs += KisGeneratorStrokeStrategy::createJobsData(this, cookie, f, originalDevice, processRegion, filterConfig);
+    }
 
     Q_FOREACH (auto job, jobs) {
         image->addJob(strokeId, job);
@@ -200,8 +284,9 @@ void KisGeneratorLayer::setX(qint32 x)
 
     KisSelectionBasedLayer::setX(x);
     {
-        QMutexLocker(&m_d->mutex);
+        QMutexLocker l(&m_d->mutex);
         m_d->preparedRect = QRect();
+        m_d->cachedGenerations.clear();
     }
     m_d->updateSignalCompressor.start();
 }
@@ -210,8 +295,9 @@ void KisGeneratorLayer::setY(qint32 y)
 {
     KisSelectionBasedLayer::setY(y);
     {
-        QMutexLocker(&m_d->mutex);
+        QMutexLocker l(&m_d->mutex);
         m_d->preparedRect = QRect();
+        m_d->cachedGenerations.clear();
     }
     m_d->updateSignalCompressor.start();
 }
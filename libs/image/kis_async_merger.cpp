@@ -33,6 +33,7 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisFusedLayersBlender.h"
 
 
 //#define DEBUG_MERGER
@@ -225,6 +226,19 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         QRect applyRect = item.m_applyRect;
 
+        /**
+         * The deferred layers should be blended before anything else
+         * touches the projection
+         */
+        if (!m_fusedLeaves.isEmpty() &&
+            (currentLeaf->isRoot() ||
+             item.m_position & KisMergeWalker::N_EXTRA ||
+             applyRect != m_fusedRect ||
+             !KisFusedLayersBlender::canFuse(currentLeaf, m_currentProjection))) {
+
+            compositeFusedLayers();
+        }
+
         if (currentLeaf->isRoot()) {
             currentLeaf->projectionPlane()->recalculate(applyRect, walker.startNode());
             continue;
@@ -279,9 +293,18 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
             /* nothing to do */
         }
 
-        compositeWithProjection(currentLeaf, applyRect);
+        if (m_currentProjection &&
+            KisFusedLayersBlender::canFuse(currentLeaf, m_currentProjection)) {
+
+            DEBUG_NODE_ACTION("Deferring compositing", "", currentLeaf, applyRect);
+            m_fusedLeaves.append(currentLeaf);
+            m_fusedRect = applyRect;
+        } else {
+            compositeWithProjection(currentLeaf, applyRect);
+        }
 
         if(item.m_position & KisMergeWalker::N_TOPMOST) {
+            compositeFusedLayers();
             writeProjection(currentLeaf, useTempProjections, applyRect);
             resetProjection();
         }
@@ -306,6 +329,7 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 }
 
 void KisAsyncMerger::resetProjection() {
+    m_fusedLeaves.clear();
     m_currentProjection = 0;
     m_finalProjection = 0;
 }
@@ -361,6 +385,25 @@ bool KisAsyncMerger::compositeWithProjection(KisProjectionLeafSP leaf, const QRe
     return true;
 }
 
+void KisAsyncMerger::compositeFusedLayers() {
+    if (m_fusedLeaves.isEmpty()) return;
+
+    if (m_fusedLeaves.size() == 1) {
+        compositeWithProjection(m_fusedLeaves.first(), m_fusedRect);
+    } else {
+        KisFusedLayersBlender blender;
+
+        Q_FOREACH (KisProjectionLeafSP leaf, m_fusedLeaves) {
+            blender.addLayer(leaf);
+        }
+
+        blender.blend(m_currentProjection, m_fusedRect);
+        DEBUG_NODE_ACTION("Compositing fused layers", m_fusedLeaves.size(), m_fusedLeaves.last(), m_fusedRect);
+    }
+
+    m_fusedLeaves.clear();
+}
+
 void KisAsyncMerger::doNotifyClones(KisBaseRectsWalker &walker) {
     KisBaseRectsWalker::CloneNotificationsVector &vector =
         walker.cloneNotifications();
@@ -6,10 +6,12 @@
 #ifndef __KIS_ASYNC_MERGER_H
 #define __KIS_ASYNC_MERGER_H
 
+#include <QRect>
+#include <QVector>
+
 #include "kritaimage_export.h"
 #include "kis_types.h"
 
-class QRect;
 class KisBaseRectsWalker;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
@@ -22,6 +24,7 @@ private:
     inline void setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection);
     inline void writeProjection(KisProjectionLeafSP topmostLeaf, bool useTempProjection, const QRect &rect);
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
+    inline void compositeFusedLayers();
     inline void doNotifyClones(KisBaseRectsWalker &walker);
 
 private:
@@ -49,6 +52,14 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    /**
+     * A run of consecutive simple paint layers, whose compositing
+     * has been deferred to blend them into the projection in a
+     * single pass, see KisFusedLayersBlender
+     */
+    QVector<KisProjectionLeafSP> m_fusedLeaves;
+    QRect m_fusedRect;
 };
 
 
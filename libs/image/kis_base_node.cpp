@@ -236,6 +236,11 @@ QImage KisBaseNode::createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspe
 
 }
 
+KisPaintDeviceSP KisBaseNode::thumbnailSourceDevice() const
+{
+    return 0;
+}
+
 QImage KisBaseNode::createThumbnailForFrame(qint32 w, qint32 h, int time, Qt::AspectRatioMode aspectRatioMode)
 {
     Q_UNUSED(time);
@@ -324,6 +324,14 @@ public:
      */
     virtual QImage createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio);
 
+    /**
+     * @return the paint device createThumbnail() scales down to the
+     * thumbnail, or null if the node type doesn't generate thumbnails
+     * from a paint device. Lets the thumbnails be generated outside the
+     * node, e.g. in the background.
+     */
+    virtual KisPaintDeviceSP thumbnailSourceDevice() const;
+
     /**
      * @return a thumbnail in requested size for the defined timestamp.
      * The thumbnail is a rgba Image and may have transparent parts.
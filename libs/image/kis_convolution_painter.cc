@@ -38,6 +38,7 @@
 
 #include "kis_convolution_worker.h"
 #include "kis_convolution_worker_spatial.h"
+#include "kis_convolution_worker_recursive_gaussian.h"
 
 #include "config_convolution.h"
 
@@ -126,6 +127,58 @@ void KisConvolutionPainter::setEnginePreference(EnginePreference value)
     m_enginePreference = value;
 }
 
+namespace {
+
+/**
+ * We don't use defaultBounds->topLevelWrapRect(), because
+ * the main purpose of this wrapping is "getting expected
+ * results when applying to the the layer". If a mask is bigger
+ * than the image, then it should be wrapped around the mask
+ * instead.
+ */
+QRect repeatDataRect(const KisPaintDeviceSP src, const QRect &requestedRect)
+{
+    const QRect boundsRect = src->defaultBounds()->bounds();
+    QRect dataRect = requestedRect | boundsRect;
+
+    KIS_SAFE_ASSERT_RECOVER(boundsRect != KisDefaultBounds().bounds()) {
+        dataRect = requestedRect | src->exactBounds();
+    }
+
+    return dataRect;
+}
+
+}
+
+void KisConvolutionPainter::applyRecursiveGaussian(const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize,
+                                                   qreal xSigma, qreal ySigma,
+                                                   KisConvolutionBorderOp borderOp,
+                                                   GaussianApproximation approximation)
+{
+    if (src->defaultBounds()->wrapAroundMode()) {
+        borderOp = BORDER_IGNORE;
+    }
+
+    const bool useBoxBlur = approximation == TRIPLE_BOX_BLUR;
+
+    switch (borderOp) {
+    case BORDER_REPEAT: {
+        const QRect dataRect = repeatDataRect(src, QRect(srcPos, areaSize));
+
+        if (dataRect.isValid()) {
+            KisConvolutionWorkerRecursiveGaussian<RepeatIteratorFactory> worker(this, progressUpdater(), xSigma, ySigma, useBoxBlur);
+            worker.execute(0, src, srcPos, dstPos, areaSize, dataRect);
+        }
+        break;
+    }
+    case BORDER_IGNORE:
+    default: {
+        KisConvolutionWorkerRecursiveGaussian<StandardIteratorFactory> worker(this, progressUpdater(), xSigma, ySigma, useBoxBlur);
+        worker.execute(0, src, srcPos, dstPos, areaSize, QRect());
+    }
+    }
+}
+
 void KisConvolutionPainter::applyMatrix(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, KisConvolutionBorderOp borderOp)
 {
     /**
@@ -140,20 +193,7 @@ void KisConvolutionPainter::applyMatrix(const KisConvolutionKernelSP kernel, con
     // Determine whether we convolve border pixels, or not.
     switch (borderOp) {
     case BORDER_REPEAT: {
-        /**
-         * We don't use defaultBounds->topLevelWrapRect(), because
-         * the main purpose of this wrapping is "getting expected
-         * results when applying to the the layer". If a mask is bigger
-         * than the image, then it should be wrapped around the mask
-         * instead.
-         */
-        const QRect boundsRect = src->defaultBounds()->bounds();
-        const QRect requestedRect = QRect(srcPos, areaSize);
-        QRect dataRect = requestedRect | boundsRect;
-
-        KIS_SAFE_ASSERT_RECOVER(boundsRect != KisDefaultBounds().bounds()) {
-            dataRect = requestedRect | src->exactBounds();
-        }
+        const QRect dataRect = repeatDataRect(src, QRect(srcPos, areaSize));
 
         /**
          * FIXME: Implementation can return empty destination device
@@ -42,6 +42,14 @@ public:
     };
 
 
+    /**
+     * The approximations of the Gaussian used by applyRecursiveGaussian()
+     */
+    enum GaussianApproximation {
+        RECURSIVE_GAUSSIAN, // the IIR filter of Young and van Vliet
+        TRIPLE_BOX_BLUR     // three successive box blurs
+    };
+
     KisConvolutionPainter(KisPaintDeviceSP device, EnginePreference enginePreference);
 
     void setEnginePreference(EnginePreference value);
@@ -71,6 +79,24 @@ public:
     void applyMatrix(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize,
                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
 
+    /**
+     * Blurs \p src with a Gaussian of \p xSigma and \p ySigma with the
+     * recursive filter, whose cost doesn't depend on the sigmas, see
+     * KisConvolutionWorkerRecursiveGaussian. The painter reads the same area
+     * as applyMatrix() would read for the kernel of KisGaussianKernel with
+     * the same sigmas.
+     *
+     * \p approximation selects the filter, the triple box blur is
+     * a bit cheaper and coarser than the recursive one.
+     *
+     * All the pixels are cached before writing, so no transaction is needed
+     * when \p src coincides with the device of the painter.
+     */
+    void applyRecursiveGaussian(const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize,
+                                qreal xSigma, qreal ySigma,
+                                KisConvolutionBorderOp borderOp = BORDER_REPEAT,
+                                GaussianApproximation approximation = RECURSIVE_GAUSSIAN);
+
     /**
      * The caller should ask if the painter needs an explicit transaction iff
      * the source and destination devices coincide. Otherwise, the transaction is
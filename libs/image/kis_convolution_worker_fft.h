@@ -15,8 +15,12 @@
 #include "kis_convolution_worker.h"
 #include "kis_math_toolbox.h"
 
+#include <QHash>
 #include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
 #include <QVector>
+#include <QtConcurrent>
 #include <QTextStream>
 #include <QFile>
 #include <QDir>
@@ -29,10 +33,77 @@ class KisConvolutionWorkerFFTLock
 private:
     static QMutex fftwMutex;
     template<class _IteratorFactory_> friend class KisConvolutionWorkerFFT;
+    friend struct KisConvolutionWorkerFFTPlans;
 };
 
 QMutex KisConvolutionWorkerFFTLock::fftwMutex;
 
+/**
+ * The forward and the backward in-place plans for one size of the
+ * FFT block. Creating a plan is expensive and is serialized by the
+ * FFTW mutex, so the plans are cached and shared by all the blocks
+ * and all the invocations of the worker. Executing a plan with the
+ * new-array functions is thread-safe.
+ */
+struct KisConvolutionWorkerFFTPlans
+{
+    KisConvolutionWorkerFFTPlans(int width, int height)
+    {
+        const int length = height * (width / 2 + 1);
+        fftw_complex *buffer = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length);
+
+        QMutexLocker l(&KisConvolutionWorkerFFTLock::fftwMutex);
+        forward = fftw_plan_dft_r2c_2d(height, width, (double*)buffer, buffer, FFTW_ESTIMATE);
+        backward = fftw_plan_dft_c2r_2d(height, width, buffer, (double*)buffer, FFTW_ESTIMATE);
+
+        fftw_free(buffer);
+    }
+
+    ~KisConvolutionWorkerFFTPlans()
+    {
+        QMutexLocker l(&KisConvolutionWorkerFFTLock::fftwMutex);
+        fftw_destroy_plan(forward);
+        fftw_destroy_plan(backward);
+    }
+
+    static QSharedPointer<KisConvolutionWorkerFFTPlans> fetch(int width, int height)
+    {
+        QHash<QPair<int, int>, QSharedPointer<KisConvolutionWorkerFFTPlans>> evicted;
+        QSharedPointer<KisConvolutionWorkerFFTPlans> plans;
+
+        {
+            QMutexLocker l(&cacheMutex);
+
+            // the cache is tiny, so just drop it when it gets full
+            if (cache.size() >= maxCacheSize) {
+                std::swap(evicted, cache);
+            }
+
+            plans = cache.value(qMakePair(width, height));
+
+            if (!plans) {
+                plans.reset(new KisConvolutionWorkerFFTPlans(width, height));
+                cache.insert(qMakePair(width, height), plans);
+            }
+        }
+
+        // the evicted plans are destroyed here, out of the cache lock
+
+        return plans;
+    }
+
+    fftw_plan forward;
+    fftw_plan backward;
+
+private:
+    static const int maxCacheSize = 16;
+    static QMutex cacheMutex;
+    static QHash<QPair<int, int>, QSharedPointer<KisConvolutionWorkerFFTPlans>> cache;
+};
+
+QMutex KisConvolutionWorkerFFTPlans::cacheMutex;
+QHash<QPair<int, int>, QSharedPointer<KisConvolutionWorkerFFTPlans>> KisConvolutionWorkerFFTPlans::cache;
+
 
 template<class _IteratorFactory_>
 class KisConvolutionWorkerFFT : public KisConvolutionWorker<_IteratorFactory_>
@@ -48,6 +119,14 @@ public:
     }
 
 
+    /**
+     * The area is convolved in blocks with the overlap-save method:
+     * every block of the destination is transformed together with the
+     * margins it needs, so the memory is bounded by the size of the
+     * block instead of the size of the area. The blocks are aligned to
+     * a grid in the destination coordinates and are processed in
+     * parallel.
+     */
     virtual void execute(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, const QRect& dataRect)
     {
         // Make the area we cover as small as possible
@@ -68,8 +147,11 @@ public:
         const quint32 halfKernelWidth = (kernel->width() - 1) / 2;
         const quint32 halfKernelHeight = (kernel->height() - 1) / 2;
 
-        m_fftWidth = areaSize.width() + 4 * halfKernelWidth;
-        m_fftHeight = areaSize.height() + 2 * halfKernelHeight;
+        const int blockSize = blockSizeForKernel(kernel);
+        const QVector<QRect> blocks = splitIntoBlocks(QRect(dstPos, areaSize), blockSize);
+
+        m_fftWidth = qMin(areaSize.width(), blockSize) + 4 * halfKernelWidth;
+        m_fftHeight = qMin(areaSize.height(), blockSize) + 2 * halfKernelHeight;
 
         /**
          * FIXME: check whether this "optimization" is needed to
@@ -81,75 +163,82 @@ public:
         m_fftLength = m_fftHeight * (m_fftWidth / 2 + 1);
         m_extraMem = (m_fftWidth % 2) ? 1 : 2;
 
+        QSharedPointer<KisConvolutionWorkerFFTPlans> plans =
+            KisConvolutionWorkerFFTPlans::fetch(m_fftWidth, m_fftHeight);
+
         // create and fill kernel
         m_kernelFFT = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
         memset(m_kernelFFT, 0, sizeof(fftw_complex) * m_fftLength);
         fftFillKernelMatrix(kernel, m_kernelFFT);
+        fftw_execute_dft_r2c(plans->forward, (double*)m_kernelFFT, m_kernelFFT);
+
+        addToProgress(10);
+        if (isInterrupted()) return;
 
         // find out which channels need convolving
         QList<KoChannelInfo*> convChannelList = this->convolvableChannelList(src);
 
-        m_channelFFT.resize(convChannelList.count());
-        for (auto i = m_channelFFT.begin(); i != m_channelFFT.end(); ++i) {
-            *i = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
-        }
-
         const double kernelFactor = kernel->factor() ? kernel->factor() : 1;
         const double fftScale = 1.0 / (m_fftHeight * m_fftWidth) / kernelFactor;
 
-        FFTInfo info (fftScale, convChannelList, kernel, this->m_painter->device()->colorSpace());
-        int cacheRowStride = m_fftWidth + m_extraMem;
-
-        fillCacheFromDevice(src,
-                            QRect(srcPos.x() - halfKernelWidth,
-                                  srcPos.y() - halfKernelHeight,
-                                  m_fftWidth,
-                                  m_fftHeight),
-                            cacheRowStride,
-                            info, dataRect);
-
-        addToProgress(10);
-        if (isInterrupted()) return;
+        const FFTInfo info (fftScale, convChannelList, kernel, this->m_painter->device()->colorSpace());
+        const int cacheRowStride = m_fftWidth + m_extraMem;
+        const QPoint srcOffset = srcPos - dstPos;
 
-        // calculate number off fft operations required for progress reporting
-        const float progressPerFFT = (100 - 30) / (double)(convChannelList.count() * 2 + 1);
-
-        // perform FFT
-        fftw_plan fftwPlanForward, fftwPlanBackward;
+        /**
+         * The margins of a block overlap the neighbouring blocks, so when
+         * the area is convolved in place, the blocks should read a copy
+         * of the device. The copy shares the tiles with the original
+         * device, so it is cheap.
+         */
+        KisPaintDeviceSP source = src;
+        if (blocks.size() > 1 && src == this->m_painter->device()) {
+            source = new KisPaintDevice(*src);
+        }
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)m_kernelFFT, m_kernelFFT, FFTW_ESTIMATE);
-        fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, m_kernelFFT, (double*)m_kernelFFT, FFTW_ESTIMATE);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+        QMutex progressMutex;
+        int numBlocksDone = 0;
 
-        fftw_execute(fftwPlanForward);
-        addToProgress(progressPerFFT);
-        if (isInterrupted()) return;
+        QVector<QRect> blocksToProcess = blocks;
+        QtConcurrent::blockingMap(blocksToProcess,
+            [&] (const QRect &dstBlock) {
+                if (this->m_progress && this->m_progress->interrupted()) return;
 
-        for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
-        {
-            fftw_execute_dft_r2c(fftwPlanForward, (double*)(*k), *k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+                QVector<fftw_complex*> channelFFT(convChannelList.count());
+                for (auto i = channelFFT.begin(); i != channelFFT.end(); ++i) {
+                    *i = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
+                }
 
-            fftMultiply(*k, m_kernelFFT);
+                fillCacheFromDevice(source,
+                                    QRect(dstBlock.x() + srcOffset.x() - int(halfKernelWidth),
+                                          dstBlock.y() + srcOffset.y() - int(halfKernelHeight),
+                                          m_fftWidth,
+                                          m_fftHeight),
+                                    cacheRowStride,
+                                    info, dataRect, channelFFT);
+
+                for (auto k = channelFFT.begin(); k != channelFFT.end(); ++k)
+                {
+                    fftw_execute_dft_r2c(plans->forward, (double*)(*k), *k);
+                    fftMultiply(*k, m_kernelFFT);
+                    fftw_execute_dft_c2r(plans->backward, *k, (double*)*k);
+                }
 
-            fftw_execute_dft_c2r(fftwPlanBackward, *k, (double*)*k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
-        }
+                writeResultToDevice(dstBlock,
+                                    cacheRowStride, halfKernelWidth, halfKernelHeight,
+                                    info, dataRect, channelFFT);
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftw_destroy_plan(fftwPlanForward);
-        fftw_destroy_plan(fftwPlanBackward);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+                Q_FOREACH (fftw_complex *channel, channelFFT) {
+                    fftw_free(channel);
+                }
 
+                QMutexLocker l(&progressMutex);
+                numBlocksDone++;
+                addToProgress(10 + 90.0 * numBlocksDone / blocks.size() - m_currentProgress);
+            });
 
-        writeResultToDevice(QRect(dstPos.x(), dstPos.y(), areaSize.width(), areaSize.height()),
-                            cacheRowStride, halfKernelWidth, halfKernelHeight,
-                            info, dataRect);
+        if (isInterrupted()) return;
 
-        addToProgress(20);
         cleanUp();
     }
 
@@ -209,7 +298,8 @@ public:
                              const QRect &rect,
                              const int cacheRowStride,
                              const FFTInfo &info,
-                             const QRect &dataRect) {
+                             const QRect &dataRect,
+                             const QVector<fftw_complex*> &channelFFT) {
 
         typename _IteratorFactory_::HLineConstIterator hitSrc =
             _IteratorFactory_::createHLineConstIterator(src,
@@ -221,7 +311,7 @@ public:
         const auto channelPtrBegin = channelPtr.begin();
         const auto channelPtrEnd = channelPtr.end();
 
-        auto iFFt = m_channelFFT.constBegin();
+        auto iFFt = channelFFT.constBegin();
         for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iFFt) {
             *i = (double*)*iFFt;
         }
@@ -314,7 +404,8 @@ public:
                              const int halfKernelWidth,
                              const int halfKernelHeight,
                              const FFTInfo &info,
-                             const QRect &dataRect) {
+                             const QRect &dataRect,
+                             const QVector<fftw_complex*> &channelFFT) {
 
         typename _IteratorFactory_::HLineIterator hitDst =
             _IteratorFactory_::createHLineIterator(this->m_painter->device(),
@@ -328,7 +419,7 @@ public:
         const auto channelPtrBegin = channelPtr.begin();
         const auto channelPtrEnd = channelPtr.end();
 
-        auto iFFt = m_channelFFT.constBegin();
+        auto iFFt = channelFFT.constBegin();
         for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iFFt) {
             *i = (double*)*iFFt + initialOffset;
         }
@@ -529,12 +620,42 @@ private:
         // free kernel fft data
         if (m_kernelFFT) {
             fftw_free(m_kernelFFT);
+            m_kernelFFT = 0;
+        }
+    }
+
+    /**
+     * The blocks should be big enough for the margins to be a small part
+     * of the transformed data, but small enough to keep the memory use
+     * bounded. They are multiples of the tile size.
+     */
+    static int blockSizeForKernel(const KisConvolutionKernelSP kernel)
+    {
+        const int tileSize = 64;
+        const int size = qMax(512, 2 * int(qMax(kernel->width(), kernel->height())));
+        return (size + tileSize - 1) / tileSize * tileSize;
+    }
+
+    static QVector<QRect> splitIntoBlocks(const QRect &rc, int blockSize)
+    {
+        QVector<QRect> blocks;
+
+        if (rc.width() <= blockSize && rc.height() <= blockSize) {
+            blocks << rc;
+            return blocks;
         }
 
-        Q_FOREACH (fftw_complex *channel, m_channelFFT) {
-            fftw_free(channel);
+        auto alignDown = [blockSize] (int value) {
+            return value - ((value % blockSize) + blockSize) % blockSize;
+        };
+
+        for (int y = alignDown(rc.y()); y <= rc.bottom(); y += blockSize) {
+            for (int x = alignDown(rc.x()); x <= rc.right(); x += blockSize) {
+                blocks << (QRect(x, y, blockSize, blockSize) & rc);
+            }
         }
-        m_channelFFT.clear();
+
+        return blocks;
     }
 private:
     quint32 m_fftWidth {0};
@@ -544,7 +665,6 @@ private:
     float m_currentProgress {0.0};
 
     fftw_complex* m_kernelFFT {0};
-    QVector<fftw_complex*> m_channelFFT;
 };
 
 #endif
@@ -0,0 +1,570 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_CONVOLUTION_WORKER_RECURSIVE_GAUSSIAN_H
+#define KIS_CONVOLUTION_WORKER_RECURSIVE_GAUSSIAN_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <KoChannelInfo.h>
+
+#include "kis_convolution_worker.h"
+#include "kis_global.h"
+#include "kis_math_toolbox.h"
+
+#include <QVector>
+#include <QtConcurrent>
+
+/**
+ * Applies a Gaussian blur with the recursive (IIR) filter of
+ * Young and van Vliet ("Recursive implementation of the Gaussian
+ * filter", 1995). The cost per pixel doesn't depend on sigma, so
+ * the worker is used for the huge radii, where both the spatial
+ * and the FFT workers become slow and the latter needs a lot of
+ * memory.
+ *
+ * When \p useBoxBlur is set, the Gaussian is approximated with three
+ * successive box blurs instead, each of them computed with a running
+ * sum. It is a bit faster and the result doesn't ring, but the shape
+ * of the kernel is coarser (see "Fast Almost-Gaussian Filtering" by
+ * Kovesi, 2010).
+ *
+ * The filter is separable: the rows and then the columns of the
+ * cache are filtered in parallel stripes. The kernel passed to
+ * execute() is ignored, the blur is defined by the sigmas passed
+ * to the constructor.
+ */
+template<class _IteratorFactory_>
+class KisConvolutionWorkerRecursiveGaussian : public KisConvolutionWorker<_IteratorFactory_>
+{
+public:
+    KisConvolutionWorkerRecursiveGaussian(KisPainter *painter, KoUpdater *progress,
+                                          qreal xSigma, qreal ySigma,
+                                          bool useBoxBlur = false)
+        : KisConvolutionWorker<_IteratorFactory_>(painter, progress),
+          m_xSigma(xSigma),
+          m_ySigma(ySigma),
+          m_useBoxBlur(useBoxBlur)
+    {
+    }
+
+    /**
+     * The number of pixels the worker reads around the processed area.
+     * It is the same as the half-size of KisGaussianKernel's kernel, so
+     * all the workers use the same need and change rects.
+     */
+    static int marginFromSigma(qreal sigma) {
+        return sigma > 0.0 ? 3 * std::ceil(sigma) : 0;
+    }
+
+    void execute(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, const QRect& dataRect) override
+    {
+        Q_UNUSED(kernel);
+
+        // Make the area we cover as small as possible
+        if (this->m_painter->selection())
+        {
+            QRect r = this->m_painter->selection()->selectedRect().intersected(QRect(srcPos, areaSize));
+            dstPos += r.topLeft() - srcPos;
+            srcPos = r.topLeft();
+            areaSize = r.size();
+        }
+
+        if (areaSize.width() == 0 || areaSize.height() == 0)
+            return;
+
+        setProgress(0);
+        if (isInterrupted()) return;
+
+        const int xMargin = marginFromSigma(m_xSigma);
+        const int yMargin = marginFromSigma(m_ySigma);
+
+        m_cacheWidth = areaSize.width() + 2 * xMargin;
+        m_cacheHeight = areaSize.height() + 2 * yMargin;
+
+        ChannelInfo info(this->convolvableChannelList(src));
+
+        m_channels.resize(info.numChannels());
+        m_planes.resize(info.numChannels());
+        for (int k = 0; k < m_channels.size(); ++k) {
+            m_channels[k].resize(m_cacheWidth * m_cacheHeight);
+            m_planes[k] = m_channels[k].data();
+        }
+
+        fillCacheFromDevice(src,
+                            QRect(srcPos.x() - xMargin,
+                                  srcPos.y() - yMargin,
+                                  m_cacheWidth,
+                                  m_cacheHeight),
+                            info, dataRect);
+
+        setProgress(10);
+        if (isInterrupted()) return;
+
+        if (m_xSigma > 0.0) {
+            if (m_useBoxBlur) {
+                boxFilterRows(BoxSizes(m_xSigma));
+            } else {
+                filterRows(Coefficients(m_xSigma));
+            }
+        }
+
+        setProgress(45);
+        if (isInterrupted()) return;
+
+        if (m_ySigma > 0.0) {
+            if (m_useBoxBlur) {
+                boxFilterColumns(BoxSizes(m_ySigma));
+            } else {
+                filterColumns(Coefficients(m_ySigma));
+            }
+        }
+
+        setProgress(80);
+        if (isInterrupted()) return;
+
+        writeResultToDevice(QRect(dstPos, areaSize), xMargin, yMargin, info, dataRect);
+
+        setProgress(100);
+        cleanUp();
+    }
+
+private:
+    /**
+     * The coefficients of the third-order recursion, as defined by
+     * Young and van Vliet
+     */
+    struct Coefficients {
+        Coefficients(qreal sigma) {
+            const qreal q = sigma >= 2.5 ?
+                0.98711 * sigma - 0.96330 :
+                3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+
+            const qreal q2 = q * q;
+            const qreal q3 = q2 * q;
+
+            const qreal b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+
+            b1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+            b2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+            b3 = 0.422205 * q3 / b0;
+            B = 1.0 - (b1 + b2 + b3);
+        }
+
+        qreal B;
+        qreal b1;
+        qreal b2;
+        qreal b3;
+    };
+
+    /**
+     * The radii of the three boxes whose convolution has the variance
+     * of the Gaussian. The widths are odd and differ by two at most.
+     */
+    struct BoxSizes {
+        BoxSizes(qreal sigma) {
+            const int numBoxes = 3;
+            const qreal variance = 12.0 * pow2(sigma);
+
+            int lowerWidth = std::floor(std::sqrt(variance / numBoxes + 1.0));
+            if (lowerWidth % 2 == 0) lowerWidth--;
+            lowerWidth = qMax(1, lowerWidth);
+
+            const int upperWidth = lowerWidth + 2;
+            const int numLowerBoxes =
+                qBound(0,
+                       qRound((variance - numBoxes * pow2(lowerWidth) - 4 * numBoxes * lowerWidth - 3 * numBoxes) /
+                              (-4.0 * lowerWidth - 4.0)),
+                       numBoxes);
+
+            for (int i = 0; i < numBoxes; i++) {
+                radii[i] = ((i < numLowerBoxes ? lowerWidth : upperWidth) - 1) / 2;
+            }
+        }
+
+        int radii[3];
+    };
+
+    struct ChannelInfo {
+        ChannelInfo(const QList<KoChannelInfo*> &_convChannelList)
+            : convChannelList(_convChannelList)
+        {
+            KisMathToolbox mathToolbox;
+
+            for (int i = 0; i < convChannelList.count(); ++i) {
+                minClamp.append(mathToolbox.minChannelValue(convChannelList[i]));
+                maxClamp.append(mathToolbox.maxChannelValue(convChannelList[i]));
+
+                if (convChannelList[i]->channelType() == KoChannelInfo::ALPHA) {
+                    alphaCachePos = i;
+                    alphaRealPos = convChannelList[i]->pos();
+                }
+            }
+
+            toDoubleFuncPtr.resize(convChannelList.count());
+            fromDoubleFuncPtr.resize(convChannelList.count());
+            fromDoubleCheckNullFuncPtr.resize(convChannelList.count());
+
+            bool result = mathToolbox.getToDoubleChannelPtr(convChannelList, toDoubleFuncPtr);
+            result &= mathToolbox.getFromDoubleChannelPtr(convChannelList, fromDoubleFuncPtr);
+            result &= mathToolbox.getFromDoubleCheckNullChannelPtr(convChannelList, fromDoubleCheckNullFuncPtr);
+
+            KIS_ASSERT(result);
+        }
+
+        inline int numChannels() const {
+            return convChannelList.size();
+        }
+
+        QVector<qreal> minClamp;
+        QVector<qreal> maxClamp;
+
+        QList<KoChannelInfo*> convChannelList;
+
+        QVector<PtrToDouble> toDoubleFuncPtr;
+        QVector<PtrFromDouble> fromDoubleFuncPtr;
+        QVector<PtrFromDoubleCheckNull> fromDoubleCheckNullFuncPtr;
+
+        int alphaCachePos {-1};
+        int alphaRealPos {-1};
+    };
+
+    struct Stripe {
+        int start;
+        int size;
+    };
+
+    static QVector<Stripe> splitIntoStripes(int length) {
+        const int stripeSize = 64;
+        QVector<Stripe> stripes;
+
+        for (int start = 0; start < length; start += stripeSize) {
+            stripes.append({start, qMin(stripeSize, length - start)});
+        }
+
+        return stripes;
+    }
+
+    void fillCacheFromDevice(KisPaintDeviceSP src,
+                             const QRect &rect,
+                             const ChannelInfo &info,
+                             const QRect &dataRect) {
+
+        const int channelCount = info.numChannels();
+
+        QVector<Stripe> stripes = splitIntoStripes(rect.height());
+        QtConcurrent::blockingMap(stripes,
+            [&] (const Stripe &stripe) {
+                typename _IteratorFactory_::HLineConstIterator hitSrc =
+                    _IteratorFactory_::createHLineConstIterator(src,
+                                                                rect.x(), rect.y() + stripe.start, rect.width(),
+                                                                dataRect);
+
+                for (int y = stripe.start; y < stripe.start + stripe.size; ++y) {
+                    const int rowOffset = y * m_cacheWidth;
+
+                    for (int x = 0; x < rect.width(); ++x) {
+                        const quint8 *data = hitSrc->oldRawData();
+
+                        // no alpha is a rare case, so just multiply by 1.0 in that case
+                        const double alphaValue = info.alphaRealPos >= 0 ?
+                            info.toDoubleFuncPtr[info.alphaCachePos](data, info.alphaRealPos) : 1.0;
+
+                        for (int k = 0; k < channelCount; ++k) {
+                            m_planes[k][rowOffset + x] =
+                                k != info.alphaCachePos ?
+                                info.toDoubleFuncPtr[k](data, info.convChannelList[k]->pos()) * alphaValue :
+                                alphaValue;
+                        }
+
+                        hitSrc->nextPixel();
+                    }
+
+                    hitSrc->nextRow();
+                }
+            });
+    }
+
+    /**
+     * Runs the causal and the anti-causal passes over \p size values.
+     * Both passes are initialized with the steady state of the edge
+     * values, the edges themselves are in the margins, which are dropped.
+     */
+    static inline void filterLine(float *line, int size, const Coefficients &c) {
+        double w1 = line[0];
+        double w2 = w1;
+        double w3 = w1;
+
+        for (int i = 0; i < size; i++) {
+            float *value = line + i;
+            const double w = c.B * *value + c.b1 * w1 + c.b2 * w2 + c.b3 * w3;
+            *value = w;
+            w3 = w2;
+            w2 = w1;
+            w1 = w;
+        }
+
+        w1 = line[size - 1];
+        w2 = w1;
+        w3 = w1;
+
+        for (int i = size - 1; i >= 0; i--) {
+            float *value = line + i;
+            const double w = c.B * *value + c.b1 * w1 + c.b2 * w2 + c.b3 * w3;
+            *value = w;
+            w3 = w2;
+            w2 = w1;
+            w1 = w;
+        }
+    }
+
+    void filterRows(const Coefficients &c) {
+        QVector<Stripe> stripes = splitIntoStripes(m_cacheHeight);
+
+        QtConcurrent::blockingMap(stripes,
+            [&] (const Stripe &stripe) {
+                Q_FOREACH (float *plane, m_planes) {
+                    for (int y = stripe.start; y < stripe.start + stripe.size; y++) {
+                        filterLine(plane + y * m_cacheWidth, m_cacheWidth, c);
+                    }
+                }
+            });
+    }
+
+    /**
+     * The columns of a stripe are filtered together row by row, which is
+     * much friendlier to the CPU cache than walking every column separately
+     */
+    void filterColumns(const Coefficients &c) {
+        QVector<Stripe> stripes = splitIntoStripes(m_cacheWidth);
+
+        QtConcurrent::blockingMap(stripes,
+            [&] (const Stripe &stripe) {
+                QVector<double> w1(stripe.size);
+                QVector<double> w2(stripe.size);
+                QVector<double> w3(stripe.size);
+
+                auto filterRow = [&] (float *row) {
+                    for (int i = 0; i < stripe.size; i++) {
+                        const double w = c.B * row[i] + c.b1 * w1[i] + c.b2 * w2[i] + c.b3 * w3[i];
+                        row[i] = w;
+                        w3[i] = w2[i];
+                        w2[i] = w1[i];
+                        w1[i] = w;
+                    }
+                };
+
+                auto initState = [&] (const float *row) {
+                    for (int i = 0; i < stripe.size; i++) {
+                        w1[i] = w2[i] = w3[i] = row[i];
+                    }
+                };
+
+                Q_FOREACH (float *plane, m_planes) {
+                    float *firstRow = plane + stripe.start;
+                    float *lastRow = firstRow + (m_cacheHeight - 1) * m_cacheWidth;
+
+                    initState(firstRow);
+                    for (int y = 0; y < m_cacheHeight; y++) {
+                        filterRow(firstRow + y * m_cacheWidth);
+                    }
+
+                    initState(lastRow);
+                    for (int y = m_cacheHeight - 1; y >= 0; y--) {
+                        filterRow(firstRow + y * m_cacheWidth);
+                    }
+                }
+            });
+    }
+
+    /**
+     * Averages every value of \p src with its \p radius neighbours on
+     * both sides and writes the result into \p dst. The values beyond
+     * the edges repeat the edge values, the edges are in the margins anyway.
+     */
+    static inline void boxFilterLine(const float *src, float *dst, int size, int radius) {
+        const int lastIndex = size - 1;
+        const double norm = 1.0 / (2 * radius + 1);
+
+        double sum = src[0] * (radius + 1);
+        for (int i = 1; i <= radius; i++) {
+            sum += src[qMin(i, lastIndex)];
+        }
+
+        for (int i = 0; i < size; i++) {
+            dst[i] = sum * norm;
+            sum += src[qMin(i + radius + 1, lastIndex)] - src[qMax(i - radius, 0)];
+        }
+    }
+
+    /**
+     * Applies the three boxes to \p line, \p temp should be
+     * of the same size
+     */
+    static inline void boxFilterLine(float *line, float *temp, int size, const BoxSizes &boxes) {
+        boxFilterLine(line, temp, size, boxes.radii[0]);
+        boxFilterLine(temp, line, size, boxes.radii[1]);
+        boxFilterLine(line, temp, size, boxes.radii[2]);
+        std::copy(temp, temp + size, line);
+    }
+
+    void boxFilterRows(const BoxSizes &boxes) {
+        QVector<Stripe> stripes = splitIntoStripes(m_cacheHeight);
+
+        QtConcurrent::blockingMap(stripes,
+            [&] (const Stripe &stripe) {
+                QVector<float> temp(m_cacheWidth);
+
+                Q_FOREACH (float *plane, m_planes) {
+                    for (int y = stripe.start; y < stripe.start + stripe.size; y++) {
+                        boxFilterLine(plane + y * m_cacheWidth, temp.data(), m_cacheWidth, boxes);
+                    }
+                }
+            });
+    }
+
+    /**
+     * The columns of a stripe are transposed into contiguous lines,
+     * filtered like the rows and written back
+     */
+    void boxFilterColumns(const BoxSizes &boxes) {
+        QVector<Stripe> stripes = splitIntoStripes(m_cacheWidth);
+
+        QtConcurrent::blockingMap(stripes,
+            [&] (const Stripe &stripe) {
+                QVector<float> columns(stripe.size * m_cacheHeight);
+                QVector<float> temp(m_cacheHeight);
+
+                Q_FOREACH (float *plane, m_planes) {
+                    for (int y = 0; y < m_cacheHeight; y++) {
+                        const float *row = plane + y * m_cacheWidth + stripe.start;
+                        for (int i = 0; i < stripe.size; i++) {
+                            columns[i * m_cacheHeight + y] = row[i];
+                        }
+                    }
+
+                    for (int i = 0; i < stripe.size; i++) {
+                        boxFilterLine(columns.data() + i * m_cacheHeight, temp.data(), m_cacheHeight, boxes);
+                    }
+
+                    for (int y = 0; y < m_cacheHeight; y++) {
+                        float *row = plane + y * m_cacheWidth + stripe.start;
+                        for (int i = 0; i < stripe.size; i++) {
+                            row[i] = columns[i * m_cacheHeight + y];
+                        }
+                    }
+                }
+            });
+    }
+
+    inline void limitValue(qreal *value, qreal lowBound, qreal highBound) const {
+        if (*value > highBound) {
+            *value = highBound;
+        } else if (!(*value >= lowBound)) {  // value < lowBound or value == NaN
+            // IEEE compliant comparisons with NaN are always false
+            *value = lowBound;
+        }
+    }
+
+    void writeResultToDevice(const QRect &rect,
+                             const int xMargin,
+                             const int yMargin,
+                             const ChannelInfo &info,
+                             const QRect &dataRect) {
+
+        const int channelCount = info.numChannels();
+
+        QVector<Stripe> stripes = splitIntoStripes(rect.height());
+        QtConcurrent::blockingMap(stripes,
+            [&] (const Stripe &stripe) {
+                typename _IteratorFactory_::HLineIterator hitDst =
+                    _IteratorFactory_::createHLineIterator(this->m_painter->device(),
+                                                           rect.x(), rect.y() + stripe.start, rect.width(),
+                                                           dataRect);
+
+                for (int y = stripe.start; y < stripe.start + stripe.size; ++y) {
+                    const int rowOffset = (y + yMargin) * m_cacheWidth + xMargin;
+
+                    for (int x = 0; x < rect.width(); ++x) {
+                        quint8 *dstPtr = hitDst->rawData();
+                        const int offset = rowOffset + x;
+
+                        qreal alphaValue = 1.0;
+                        bool alphaIsNullInDstSpace = false;
+
+                        if (info.alphaCachePos >= 0) {
+                            const int k = info.alphaCachePos;
+
+                            alphaValue = m_planes[k][offset];
+                            limitValue(&alphaValue, info.minClamp[k], info.maxClamp[k]);
+                            info.fromDoubleCheckNullFuncPtr[k](dstPtr, info.alphaRealPos, alphaValue, &alphaIsNullInDstSpace);
+
+                            alphaIsNullInDstSpace |= alphaValue <= std::numeric_limits<qreal>::epsilon();
+                        }
+
+                        const qreal alphaValueInv = !alphaIsNullInDstSpace ? 1.0 / alphaValue : 0.0;
+
+                        for (int k = 0; k < channelCount; ++k) {
+                            if (k == info.alphaCachePos) continue;
+
+                            qreal value = 0.0;
+
+                            if (!alphaIsNullInDstSpace) {
+                                value = m_planes[k][offset] * alphaValueInv;
+                                limitValue(&value, info.minClamp[k], info.maxClamp[k]);
+                            }
+
+                            info.fromDoubleFuncPtr[k](dstPtr, info.convChannelList[k]->pos(), value);
+                        }
+
+                        hitDst->nextPixel();
+                    }
+
+                    hitDst->nextRow();
+                }
+            });
+    }
+
+    void cleanUp()
+    {
+        m_planes.clear();
+        m_channels.clear();
+    }
+
+    void setProgress(int value)
+    {
+        if (this->m_progress) {
+            this->m_progress->setProgress(value);
+        }
+    }
+
+    bool isInterrupted()
+    {
+        if (this->m_progress && this->m_progress->interrupted()) {
+            cleanUp();
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    qreal m_xSigma;
+    qreal m_ySigma;
+    bool m_useBoxBlur;
+
+    int m_cacheWidth {0};
+    int m_cacheHeight {0};
+
+    QVector<QVector<float>> m_channels;
+
+    // the raw pointers to m_channels, shared by the threads
+    QVector<float*> m_planes;
+};
+
+#endif
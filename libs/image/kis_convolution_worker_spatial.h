@@ -10,6 +10,9 @@
 
 #include "kis_convolution_worker.h"
 #include "kis_math_toolbox.h"
+#include "kis_convolution_kernel.h"
+
+#include <algorithm>
 
 template <class _IteratorFactory_>
 class KisConvolutionWorkerSpatial : public KisConvolutionWorker<_IteratorFactory_>
@@ -24,13 +27,14 @@ public:
         ,  m_minClamp(0)
         ,  m_maxClamp(0)
         ,  m_absoluteOffset(0)
+        ,  m_convoTotals(0)
     {
     }
 
     ~KisConvolutionWorkerSpatial() override {
     }
 
-    inline void loadPixelToCache(qreal **cache, const quint8 *data, int index) {
+    inline void loadPixel(qreal *dst, const quint8 *data) {
         // no alpha is rare case, so just multiply by 1.0 in that case
         qreal alphaValue = m_alphaRealPos >= 0 ?
             m_toDoubleFuncPtr[m_alphaCachePos](data, m_alphaRealPos) : 1.0;
@@ -38,12 +42,62 @@ public:
         for (quint32 k = 0; k < m_convolveChannelsNo; ++k) {
             if (k != (quint32)m_alphaCachePos) {
                 const quint32 channelPos = m_convChannelList[k]->pos();
-                cache[index][k] = m_toDoubleFuncPtr[k](data, channelPos) * alphaValue;
+                dst[k] = m_toDoubleFuncPtr[k](data, channelPos) * alphaValue;
             } else {
-                cache[index][k] = alphaValue;
+                dst[k] = alphaValue;
             }
         }
+    }
 
+    inline void loadPixelToCache(qreal **cache, const quint8 *data, int index) {
+        loadPixel(cache[index], data);
+    }
+
+    /**
+     * Splits \p kernel into a product of a column and a row vector if
+     * it is possible. The vectors are stored in the order of the cache,
+     * i.e. they are already flipped.
+     *
+     * @return true if the kernel is separable
+     */
+    static bool separateKernel(const KisConvolutionKernelSP kernel,
+                               QVector<qreal> &rowKernel,
+                               QVector<qreal> &columnKernel) {
+        const Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> &data = *kernel->data();
+        const int kw = kernel->width();
+        const int kh = kernel->height();
+
+        int pivotRow = 0;
+        int pivotColumn = 0;
+        const qreal maxValue = data.cwiseAbs().maxCoeff(&pivotRow, &pivotColumn);
+
+        if (maxValue == 0.0) return false;
+
+        rowKernel.resize(kw);
+        columnKernel.resize(kh);
+
+        const qreal pivotValue = data(pivotRow, pivotColumn);
+
+        for (int c = 0; c < kw; c++) {
+            rowKernel[kw - c - 1] = data(pivotRow, c) / pivotValue;
+        }
+
+        for (int r = 0; r < kh; r++) {
+            columnKernel[kh - r - 1] = data(r, pivotColumn);
+        }
+
+        const qreal tolerance = 1e-6 * maxValue;
+
+        for (int r = 0; r < kh; r++) {
+            for (int c = 0; c < kw; c++) {
+                const qreal value = columnKernel[kh - r - 1] * rowKernel[kw - c - 1];
+                if (qAbs(data(r, c) - value) > tolerance) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
     }
 
     void execute(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, const QRect& dataRect) override {
@@ -57,13 +111,13 @@ public:
         quint32 channelCount = src->colorSpace()->channelCount();
 
         m_kernelData = new qreal[m_cacheSize];
-        qreal *kernelDataPtr = m_kernelData;
+        qreal *kernelDataPtr = m_kernelData + m_cacheSize - 1;
 
-        // fill in data
+        // fill in data, the kernel is flipped to be in the order of the cache
         for (quint32 r = 0; r < kernel->height(); r++) {
             for (quint32 c = 0; c < kernel->width(); c++) {
                 *kernelDataPtr = (*(kernel->data()))(r, c);
-                kernelDataPtr++;
+                kernelDataPtr--;
             }
         }
 
@@ -130,6 +184,17 @@ public:
             m_absoluteOffset[i] = (m_maxClamp[i] - m_minClamp[i]) * kernel->offset();
         }
 
+        m_convoTotals = new qreal[m_convolveChannelsNo];
+
+        QVector<qreal> rowKernel;
+        QVector<qreal> columnKernel;
+
+        if (m_kw > 1 && m_kh > 1 && separateKernel(kernel, rowKernel, columnKernel)) {
+            executeSeparable(src, srcPos, dstPos, areaSize, dataRect, rowKernel, columnKernel);
+            cleanUp();
+            return;
+        }
+
         qint32 row = srcPos.y();
         qint32 col = srcPos.x();
 
@@ -248,14 +313,7 @@ public:
     }
 
     template <bool additionalMultiplierActive>
-    inline qreal convolveOneChannelFromCache(quint8* dstPtr, quint32 channel, qreal additionalMultiplier = 0.0) {
-        qreal interimConvoResult = 0;
-
-        for (quint32 pIndex = 0; pIndex < m_cacheSize; ++pIndex) {
-            qreal cacheValue = m_pixelPtrCache[pIndex][channel];
-            interimConvoResult += m_kernelData[m_cacheSize - pIndex - 1] * cacheValue;
-        }
-
+    inline qreal writeChannelValue(quint8* dstPtr, quint32 channel, qreal interimConvoResult, qreal additionalMultiplier = 0.0) {
         qreal channelPixelValue;
         if (additionalMultiplierActive) {
             channelPixelValue = interimConvoResult * m_kernelFactor * additionalMultiplier + m_absoluteOffset[channel];
@@ -271,9 +329,13 @@ public:
         return channelPixelValue;
     }
 
-    inline void convolveCache(quint8* dstPtr) {
+    /**
+     * Writes the convolved channels stored in \p totals into the pixel,
+     * the color channels are still premultiplied by alpha
+     */
+    inline void writeConvolvedPixel(quint8* dstPtr, const qreal *totals) {
         if (m_alphaCachePos >= 0) {
-            qreal alphaValue = convolveOneChannelFromCache<false>(dstPtr, m_alphaCachePos);
+            qreal alphaValue = writeChannelValue<false>(dstPtr, m_alphaCachePos, totals[m_alphaCachePos]);
 
             // TODO: we need a special case for applying LoG filter,
             // when the alpha i suniform and therefore should not be
@@ -285,7 +347,7 @@ public:
 
                 for (quint32 k = 0; k < m_convolveChannelsNo; ++k) {
                     if (k == (quint32)m_alphaCachePos) continue;
-                    convolveOneChannelFromCache<true>(dstPtr, k, alphaValueInv);
+                    writeChannelValue<true>(dstPtr, k, totals[k], alphaValueInv);
                 }
             } else {
                 for (quint32 k = 0; k < m_convolveChannelsNo; ++k) {
@@ -298,7 +360,132 @@ public:
             }
         } else {
             for (quint32 k = 0; k < m_convolveChannelsNo; ++k) {
-                convolveOneChannelFromCache<false>(dstPtr, k);
+                writeChannelValue<false>(dstPtr, k, totals[k]);
+            }
+        }
+    }
+
+    /**
+     * All the channels are accumulated in one pass over the cache, the
+     * innermost loop goes over the channels of the pixel stored
+     * continuously, so it can be vectorized by the compiler.
+     */
+    inline void convolveCache(quint8* dstPtr) {
+        qreal *totals = m_convoTotals;
+        const quint32 channelsNo = m_convolveChannelsNo;
+
+        std::fill(totals, totals + channelsNo, 0.0);
+
+        for (quint32 pIndex = 0; pIndex < m_cacheSize; ++pIndex) {
+            const qreal weight = m_kernelData[pIndex];
+            const qreal *cacheValue = m_pixelPtrCache[pIndex];
+
+            for (quint32 k = 0; k < channelsNo; ++k) {
+                totals[k] += weight * cacheValue[k];
+            }
+        }
+
+        writeConvolvedPixel(dstPtr, totals);
+    }
+
+    /**
+     * Loads a row of the source pixels and convolves it with the
+     * horizontal part of a separable kernel
+     */
+    inline void loadFilteredRow(typename _IteratorFactory_::HLineConstIterator& kitSrc,
+                                qreal *lineBuffer, qreal *dstRow, int width,
+                                const QVector<qreal> &rowKernel) {
+        const quint32 channelsNo = m_convolveChannelsNo;
+
+        qreal *linePtr = lineBuffer;
+        do {
+            loadPixel(linePtr, kitSrc->oldRawData());
+            linePtr += channelsNo;
+        } while (kitSrc->nextPixel());
+        kitSrc->nextRow();
+
+        std::fill(dstRow, dstRow + width * channelsNo, 0.0);
+
+        for (quint32 kc = 0; kc < m_kw; kc++) {
+            const qreal weight = rowKernel[kc];
+            const qreal *srcPtr = lineBuffer + kc * channelsNo;
+
+            for (quint32 i = 0; i < width * channelsNo; i++) {
+                dstRow[i] += weight * srcPtr[i];
+            }
+        }
+    }
+
+    /**
+     * Convolves the area with a kernel that is a product of a column and
+     * a row vector. The source rows are filtered horizontally once and
+     * kept in a ring buffer of m_kh rows, then every destination row is
+     * a weighted sum of the buffered rows. It needs m_kw + m_kh
+     * multiplications per channel instead of m_kw * m_kh.
+     */
+    void executeSeparable(const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, const QRect& dataRect,
+                          const QVector<qreal> &rowKernel, const QVector<qreal> &columnKernel) {
+
+        const int width = areaSize.width();
+        const int rowSize = width * m_convolveChannelsNo;
+
+        QVector<qreal> lineBuffer((width + m_kw - 1) * m_convolveChannelsNo);
+        QVector<qreal> filteredRows(m_kh * rowSize);
+        QVector<qreal> totals(rowSize);
+
+        typename _IteratorFactory_::HLineConstIterator kitSrc =
+            _IteratorFactory_::createHLineConstIterator(src, srcPos.x() - m_khalfWidth, srcPos.y() - m_khalfHeight,
+                                                       width + m_kw - 1, dataRect);
+
+        for (quint32 krow = 0; krow < m_kh - 1; krow++) {
+            loadFilteredRow(kitSrc, lineBuffer.data(), filteredRows.data() + krow * rowSize, width, rowKernel);
+        }
+
+        typename _IteratorFactory_::HLineIterator hitDst = _IteratorFactory_::createHLineIterator(this->m_painter->device(), dstPos.x(), dstPos.y(), width, dataRect);
+        typename _IteratorFactory_::HLineConstIterator hitSrc = _IteratorFactory_::createHLineConstIterator(src, srcPos.x(), srcPos.y(), width, dataRect);
+
+        const bool hasProgressUpdater = this->m_progress;
+        if (hasProgressUpdater) {
+            this->m_progress->setRange(0, areaSize.height());
+        }
+
+        for (int prow = 0; prow < areaSize.height(); ++prow) {
+            loadFilteredRow(kitSrc, lineBuffer.data(),
+                            filteredRows.data() + ((prow + m_kh - 1) % m_kh) * rowSize,
+                            width, rowKernel);
+
+            std::fill(totals.begin(), totals.end(), 0.0);
+
+            for (quint32 krow = 0; krow < m_kh; krow++) {
+                const qreal weight = columnKernel[krow];
+                const qreal *srcPtr = filteredRows.constData() + ((prow + krow) % m_kh) * rowSize;
+
+                for (int i = 0; i < rowSize; i++) {
+                    totals[i] += weight * srcPtr[i];
+                }
+            }
+
+            const qreal *totalsPtr = totals.constData();
+
+            for (int pcol = 0; pcol < width; ++pcol) {
+                // write original channel values
+                memcpy(hitDst->rawData(), hitSrc->oldRawData(), m_pixelSize);
+                writeConvolvedPixel(hitDst->rawData(), totalsPtr);
+
+                totalsPtr += m_convolveChannelsNo;
+                hitDst->nextPixel();
+                hitSrc->nextPixel();
+            }
+
+            hitDst->nextRow();
+            hitSrc->nextRow();
+
+            if (hasProgressUpdater) {
+                this->m_progress->setValue(prow);
+
+                if (this->m_progress->interrupted()) {
+                    return;
+                }
             }
         }
     }
@@ -349,6 +536,7 @@ public:
         delete[] m_minClamp;
         delete[] m_maxClamp;
         delete[] m_absoluteOffset;
+        delete[] m_convoTotals;
     }
 
 private:
@@ -363,6 +551,7 @@ private:
     qreal *m_kernelData;
     qreal** m_pixelPtrCache, ** m_pixelPtrCacheCopy;
     qreal* m_minClamp, *m_maxClamp, *m_absoluteOffset;
+    qreal* m_convoTotals;
 
     qreal m_kernelFactor;
     QList<KoChannelInfo *> m_convChannelList;
@@ -10,6 +10,9 @@
 
 #include <QPointF>
 #include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QSharedData>
 #include <QStringList>
 #include "kis_dom_utils.h"
@@ -225,6 +228,81 @@ static bool pointLessThan(const QPointF &a, const QPointF &b)
     return a.x() < b.x();
 }
 
+namespace {
+
+/**
+ * The transfer tables of all the curves of the application. Every
+ * preset and every clone of the paintop settings loads its curves
+ * from strings, so the same curve gets created many times, and
+ * rebuilding the tables from the spline each time is expensive.
+ * The tables are keyed by the raw values of the points, so only
+ * the exactly equal curves share them.
+ */
+class TransferCache
+{
+public:
+    template<typename T>
+    bool fetch(const QByteArray &key, QVector<T> *transfer);
+
+    template<typename T>
+    void store(const QByteArray &key, const QVector<T> &transfer);
+
+private:
+    template<typename T>
+    QHash<QByteArray, QVector<T>>& tables();
+
+private:
+    /**
+     * The cache is cleared when it gets this big, the curves are
+     * rarely edited, so it almost never happens
+     */
+    static const int maxTablesCount = 512;
+
+    QMutex m_mutex;
+    QHash<QByteArray, QVector<quint16>> m_u16Tables;
+    QHash<QByteArray, QVector<qreal>> m_floatTables;
+};
+
+template<>
+QHash<QByteArray, QVector<quint16>>& TransferCache::tables<quint16>()
+{
+    return m_u16Tables;
+}
+
+template<>
+QHash<QByteArray, QVector<qreal>>& TransferCache::tables<qreal>()
+{
+    return m_floatTables;
+}
+
+template<typename T>
+bool TransferCache::fetch(const QByteArray &key, QVector<T> *transfer)
+{
+    QMutexLocker l(&m_mutex);
+
+    auto it = tables<T>().constFind(key);
+    if (it == tables<T>().constEnd()) return false;
+
+    *transfer = *it;
+    return true;
+}
+
+template<typename T>
+void TransferCache::store(const QByteArray &key, const QVector<T> &transfer)
+{
+    QMutexLocker l(&m_mutex);
+
+    if (tables<T>().size() >= maxTablesCount) {
+        tables<T>().clear();
+    }
+
+    tables<T>().insert(key, transfer);
+}
+
+Q_GLOBAL_STATIC(TransferCache, s_transferCache)
+
+}
+
 struct Q_DECL_HIDDEN KisCubicCurve::Data : public QSharedData {
     Data() {
         init();
@@ -233,6 +311,17 @@ struct Q_DECL_HIDDEN KisCubicCurve::Data : public QSharedData {
         init();
         points = data.points;
         name = data.name;
+
+        /**
+         * The curve is detached every time a transfer is requested from
+         * a shared copy, so keep the tables, they are shared implicitly
+         */
+        spline = data.spline;
+        validSpline = data.validSpline;
+        u16Transfer = data.u16Transfer;
+        validU16Transfer = data.validU16Transfer;
+        fTransfer = data.fTransfer;
+        validFTransfer = data.validFTransfer;
     }
     void init() {
         validSpline = false;
@@ -256,6 +345,7 @@ struct Q_DECL_HIDDEN KisCubicCurve::Data : public QSharedData {
     void keepSorted();
     qreal value(qreal x);
     void invalidate();
+    QByteArray transferKey(int size) const;
     template<typename _T_, typename _T2_>
     void updateTransfer(QVector<_T_>* transfer, bool& valid, _T2_ min, _T2_ max, int size);
 };
@@ -290,10 +380,31 @@ qreal KisCubicCurve::Data::value(qreal x)
     return qBound(qreal(0.0), y, qreal(1.0));
 }
 
+QByteArray KisCubicCurve::Data::transferKey(int size) const
+{
+    QByteArray key;
+    key.reserve(int(sizeof(int) + points.size() * 2 * sizeof(qreal)));
+    key.append(reinterpret_cast<const char*>(&size), sizeof(int));
+
+    Q_FOREACH (const QPointF &pt, points) {
+        const qreal coords[2] = {pt.x(), pt.y()};
+        key.append(reinterpret_cast<const char*>(coords), sizeof(coords));
+    }
+
+    return key;
+}
+
 template<typename _T_, typename _T2_>
 void KisCubicCurve::Data::updateTransfer(QVector<_T_>* transfer, bool& valid, _T2_ min, _T2_ max, int size)
 {
     if (!valid || transfer->size() != size) {
+        const QByteArray key = transferKey(size);
+
+        if (s_transferCache->fetch(key, transfer)) {
+            valid = true;
+            return;
+        }
+
         if (transfer->size() != size) {
             transfer->resize(size);
         }
@@ -305,6 +416,8 @@ void KisCubicCurve::Data::updateTransfer(QVector<_T_>* transfer, bool& valid, _T
             (*transfer)[i] = val;
         }
         valid = true;
+
+        s_transferCache->store(key, *transfer);
     }
 }
 
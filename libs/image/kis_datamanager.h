@@ -113,8 +113,8 @@ public:
         return ACTUAL_DATAMGR::write(writer);
     }
 
-    inline bool read(QIODevice *io) {
-        return ACTUAL_DATAMGR::read(io);
+    inline bool read(QIODevice *io, bool keepCompressed = false) {
+        return ACTUAL_DATAMGR::read(io, keepCompressed);
     }
 
     inline void purge(const QRect& area) {
@@ -155,6 +155,20 @@ public:
         return ACTUAL_DATAMGR::region();
     }
 
+    /**
+     * Incremental change tracking: take a revision token and later
+     * ask for the tiles changed since then.
+     *
+     * \see KisTiledDataManager::changedTilesSince()
+     */
+    inline int takeChangeRevision() {
+        return ACTUAL_DATAMGR::takeChangeRevision();
+    }
+
+    inline bool changedTilesSince(int revision, QVector<QPoint> *tiles) const {
+        return ACTUAL_DATAMGR::changedTilesSince(revision, tiles);
+    }
+
 public:
 
     /**
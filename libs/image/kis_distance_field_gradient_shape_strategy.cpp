@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_distance_field_gradient_shape_strategy.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QtConcurrent>
+
+#include "kis_assert.h"
+
+
+namespace {
+
+/**
+ * The columns and the rows are processed in the bands of this size
+ */
+const int bandSize = 64;
+
+struct Band {
+    int start;
+    int size;
+};
+
+QVector<Band> splitIntoBands(int length)
+{
+    QVector<Band> bands;
+
+    for (int start = 0; start < length; start += bandSize) {
+        bands.append({start, qMin(bandSize, length - start)});
+    }
+
+    return bands;
+}
+
+}
+
+
+KisDistanceFieldGradientShapeStrategy::KisDistanceFieldGradientShapeStrategy(const QPainterPath &path, const QRect &rc)
+    : m_rc(rc),
+      m_scaleCoeff(0.0)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!rc.isEmpty());
+
+    const int width = rc.width();
+    const int height = rc.height();
+
+    QImage mask(width, height, QImage::Format_Grayscale8);
+    mask.fill(0);
+
+    {
+        QPainter gc(&mask);
+        gc.translate(-rc.topLeft());
+        gc.fillPath(path, Qt::white);
+    }
+
+    /**
+     * The pixels outside of the rect are treated as the pixels outside
+     * of the path, so the distances are never bigger than this value
+     */
+    const qint64 infinity = width + height;
+
+    /**
+     * Phase 1: the vertical distance of every pixel to the nearest
+     * outside pixel of its column. The rows are stored with one extra
+     * outside column on each side to handle the borders of the rect
+     * in the second phase.
+     */
+    const int paddedWidth = width + 2;
+    QVector<qint64> columnDistances(paddedWidth * height, 0);
+
+    QVector<Band> columnBands = splitIntoBands(width);
+    QtConcurrent::blockingMap(columnBands,
+        [&] (const Band &band) {
+            for (int x = band.start; x < band.start + band.size; x++) {
+                qint64 *g = columnDistances.data() + x + 1;
+
+                qint64 distance = 0;
+                for (int y = 0; y < height; y++) {
+                    const bool inside = mask.constScanLine(y)[x] >= 128;
+                    distance = inside ? qMin(distance + 1, infinity) : 0;
+                    g[y * paddedWidth] = distance;
+                }
+
+                distance = 0;
+                for (int y = height - 1; y >= 0; y--) {
+                    distance = g[y * paddedWidth] ? qMin(distance + 1, infinity) : 0;
+                    g[y * paddedWidth] = qMin(g[y * paddedWidth], distance);
+                }
+            }
+        });
+
+    /**
+     * Phase 2: the lower envelope of the parabolas that are placed at
+     * every pixel of the row with the heights of phase 1.
+     */
+    m_distances.resize(width * height);
+
+    QVector<Band> rowBands = splitIntoBands(height);
+    QtConcurrent::blockingMap(rowBands,
+        [&] (const Band &band) {
+            QVector<int> s(paddedWidth);
+            QVector<int> t(paddedWidth);
+
+            for (int y = band.start; y < band.start + band.size; y++) {
+                const qint64 *g = columnDistances.constData() + y * paddedWidth;
+
+                auto f = [g] (qint64 x, int i) {
+                    return (x - i) * (x - i) + g[i] * g[i];
+                };
+
+                auto sep = [g] (int i, int u) {
+                    return (qint64(u) * u - qint64(i) * i + g[u] * g[u] - g[i] * g[i]) / (2 * (u - i));
+                };
+
+                int q = 0;
+                s[0] = 0;
+                t[0] = 0;
+
+                for (int u = 1; u < paddedWidth; u++) {
+                    while (q >= 0 && f(t[q], s[q]) > f(t[q], u)) {
+                        q--;
+                    }
+
+                    if (q < 0) {
+                        q = 0;
+                        s[0] = u;
+                    } else {
+                        const qint64 w = 1 + sep(s[q], u);
+                        if (w < paddedWidth) {
+                            q++;
+                            s[q] = u;
+                            t[q] = int(w);
+                        }
+                    }
+                }
+
+                float *dst = m_distances.data() + y * width;
+
+                for (int u = paddedWidth - 1; u >= 0; u--) {
+                    if (u >= 1 && u <= width) {
+                        dst[u - 1] = std::sqrt(float(f(u, s[q])));
+                    }
+
+                    if (u == t[q]) {
+                        q--;
+                    }
+                }
+            }
+        });
+
+    const float maxDistance = *std::max_element(m_distances.constBegin(), m_distances.constEnd());
+    m_scaleCoeff = maxDistance > 0 ? 1.0 / maxDistance : 0.0;
+}
+
+KisDistanceFieldGradientShapeStrategy::~KisDistanceFieldGradientShapeStrategy()
+{
+}
+
+qreal KisDistanceFieldGradientShapeStrategy::distanceAt(int x, int y) const
+{
+    if (!m_rc.contains(x, y) || m_distances.isEmpty()) return 0.0;
+
+    return m_distances[(y - m_rc.y()) * m_rc.width() + (x - m_rc.x())];
+}
+
+double KisDistanceFieldGradientShapeStrategy::valueAt(double x, double y) const
+{
+    return distanceAt(std::floor(x), std::floor(y)) * m_scaleCoeff;
+}
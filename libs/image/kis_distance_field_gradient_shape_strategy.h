@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_DISTANCE_FIELD_GRADIENT_SHAPE_STRATEGY_H
+#define __KIS_DISTANCE_FIELD_GRADIENT_SHAPE_STRATEGY_H
+
+#include "kis_gradient_shape_strategy.h"
+
+#include <QRect>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class QPainterPath;
+
+
+/**
+ * A shaped gradient driven by the exact Euclidean distance of every
+ * pixel of the path to the nearest pixel outside of it. The value is
+ * 0.0 outside of the path and grows towards 1.0 at the pixels that are
+ * the farthest from the edges.
+ *
+ * The distance transform is computed with the linear-time algorithm of
+ * Meijster et al. The columns and then the rows are processed in
+ * parallel bands, so the cost doesn't depend on the complexity of the
+ * path, in contrast to KisPolygonalGradientShapeStrategy, which sums
+ * the contribution of every edge.
+ */
+class KRITAIMAGE_EXPORT KisDistanceFieldGradientShapeStrategy : public KisGradientShapeStrategy
+{
+public:
+    KisDistanceFieldGradientShapeStrategy(const QPainterPath &path, const QRect &rc);
+    ~KisDistanceFieldGradientShapeStrategy() override;
+
+    double valueAt(double x, double y) const override;
+
+    /**
+     * @return the distance of the pixel (\p x, \p y) to the nearest
+     * pixel outside of the path
+     */
+    qreal distanceAt(int x, int y) const;
+
+private:
+    QRect m_rc;
+    QVector<float> m_distances;
+    qreal m_scaleCoeff;
+};
+
+#endif /* __KIS_DISTANCE_FIELD_GRADIENT_SHAPE_STRATEGY_H */
@@ -10,7 +10,9 @@
 #include <kis_convolution_painter.h>
 #include <KoCompositeOpRegistry.h>
 #include <QRect>
+#include <QBitArray>
 #include <KoColorSpace.h>
+#include <KoChannelInfo.h>
 #include <kis_iterator_ng.h>
 #include <QVector3D>
 
@@ -224,7 +226,6 @@ void KisEdgeDetectionKernel::applyEdgeDetection(KisPaintDeviceSP device,
         KisSequentialIterator yItterator(y_denormalised, rect);
         KisSequentialIterator xItterator(x_denormalised, rect);
         KisSequentialIterator finalIt(device, rect);
-        const int pixelSize = device->colorSpace()->pixelSize();
         const int channels = device->colorSpace()->channelCount();
         const int alphaPos = device->colorSpace()->alphaPos();
         KIS_SAFE_ASSERT_RECOVER_RETURN(alphaPos >= 0);
@@ -249,21 +250,17 @@ void KisEdgeDetectionKernel::applyEdgeDetection(KisPaintDeviceSP device,
             }
 
             if (writeToAlpha) {
-                KoColor col(finalIt.rawData(), device->colorSpace());
                 qreal alpha = 0;
 
                 for (int c = 0; c<(channels-1); c++) {
                     alpha = alpha+finalNorm[c];
                 }
 
-                alpha = qMin(alpha/(channels-1), col.opacityF());
-                col.setOpacity(alpha);
-                memcpy(finalIt.rawData(), col.data(), pixelSize);
+                alpha = qMin(alpha/(channels-1), device->colorSpace()->opacityF(finalIt.rawData()));
+                device->colorSpace()->setOpacity(finalIt.rawData(), alpha, 1);
             } else {
-                quint8* f = finalIt.rawData();
                 finalNorm[alphaPos] = 1.0;
-                device->colorSpace()->fromNormalisedChannelsValue(f, finalNorm);
-                memcpy(finalIt.rawData(), f, pixelSize);
+                device->colorSpace()->fromNormalisedChannelsValue(finalIt.rawData(), finalNorm);
             }
 
         }
@@ -292,20 +289,16 @@ void KisEdgeDetectionKernel::applyEdgeDetection(KisPaintDeviceSP device,
                                 rect.size(), BORDER_REPEAT);
             KisSequentialIterator iterator(denormalised, rect);
             KisSequentialIterator finalIt(device, rect);
-            const int pixelSize = device->colorSpace()->pixelSize();
             const int channels = device->colorSpace()->colorChannelCount();
             QVector<float> normalised(channels);
             while (iterator.nextPixel() && finalIt.nextPixel()) {
                 device->colorSpace()->normalisedChannelsValue(iterator.rawData(), normalised);
-                KoColor col(finalIt.rawData(), device->colorSpace());
                 qreal alpha = 0;
                 for (int c = 0; c<channels; c++) {
                     alpha = alpha+normalised[c];
                 }
-                alpha = qMin(alpha/channels, col.opacityF());
-                col.setOpacity(alpha);
-                memcpy(finalIt.rawData(), col.data(), pixelSize);
-
+                alpha = qMin(alpha/channels, device->colorSpace()->opacityF(finalIt.rawData()));
+                device->colorSpace()->setOpacity(finalIt.rawData(), alpha, 1);
             }
 
         } else {
@@ -350,13 +343,36 @@ void KisEdgeDetectionKernel::convertToNormalMap(KisPaintDeviceSP device,
     KisConvolutionKernelSP kernelHorizLeftRight = KisEdgeDetectionKernel::createHorizontalKernel(yRadius, type, true, !channelFlip[1]);
     KisConvolutionKernelSP kernelVerticalTopBottom = KisEdgeDetectionKernel::createVerticalKernel(xRadius, type, true, !channelFlip[0]);
 
+    /**
+     * Only the height channel of the gradients is used, so the other color
+     * channels are not convolved at all. The alpha channel is kept, because
+     * the convolution weights the colors with it.
+     */
+    QBitArray gradientChannelFlags = channelFlags;
+    {
+        const QList<KoChannelInfo *> channelInfo = device->colorSpace()->channels();
+        const QBitArray allChannels(channelInfo.size(), true);
+        const QBitArray &flags = channelFlags.isEmpty() ? allChannels : channelFlags;
+
+        if (channelToConvert >= 0 && channelToConvert < flags.size() && flags.testBit(channelToConvert)) {
+            gradientChannelFlags = QBitArray(channelInfo.size(), false);
+            gradientChannelFlags.setBit(channelToConvert);
+
+            for (int c = 0; c < channelInfo.size(); c++) {
+                if (channelInfo[c]->channelType() == KoChannelInfo::ALPHA && flags.testBit(c)) {
+                    gradientChannelFlags.setBit(c);
+                }
+            }
+        }
+    }
+
     KisConvolutionPainter horizPainterLR(y_denormalised);
 
     if (useFftw) {
         horizPainterLR.setEnginePreference(*useFftw ? KisConvolutionPainter::FFTW : KisConvolutionPainter::SPATIAL);
     }
 
-    horizPainterLR.setChannelFlags(channelFlags);
+    horizPainterLR.setChannelFlags(gradientChannelFlags);
     horizPainterLR.setProgress(progressUpdater);
     horizPainterLR.applyMatrix(kernelHorizLeftRight, device,
                                srcTopLeft, srcTopLeft,
@@ -369,7 +385,7 @@ void KisEdgeDetectionKernel::convertToNormalMap(KisPaintDeviceSP device,
         verticalPainterTB.setEnginePreference(*useFftw ? KisConvolutionPainter::FFTW : KisConvolutionPainter::SPATIAL);
     }
 
-    verticalPainterTB.setChannelFlags(channelFlags);
+    verticalPainterTB.setChannelFlags(gradientChannelFlags);
     verticalPainterTB.setProgress(progressUpdater);
     verticalPainterTB.applyMatrix(kernelVerticalTopBottom, device,
                                   srcTopLeft,
@@ -379,7 +395,6 @@ void KisEdgeDetectionKernel::convertToNormalMap(KisPaintDeviceSP device,
     KisSequentialIterator yItterator(y_denormalised, rect);
     KisSequentialIterator xItterator(x_denormalised, rect);
     KisSequentialIterator finalIt(device, rect);
-    const int pixelSize = device->colorSpace()->pixelSize();
     const int channels = device->colorSpace()->channelCount();
     const int alphaPos = device->colorSpace()->alphaPos();
     KIS_SAFE_ASSERT_RECOVER_RETURN(alphaPos >= 0);
@@ -388,26 +403,29 @@ void KisEdgeDetectionKernel::convertToNormalMap(KisPaintDeviceSP device,
     QVector<float> xNormalised(channels);
     QVector<float> finalNorm(channels);
 
+    const qreal z = channelFlip[2] ? -1.0 : 1.0;
+
+    int displayPositions[3];
+    {
+        const QList<KoChannelInfo *> channelInfo = device->colorSpace()->channels();
+        for (int c = 0; c<3; c++) {
+            displayPositions[c] = channelInfo.at(channelOrder[c])->displayPosition();
+        }
+    }
+
     while(yItterator.nextPixel() && xItterator.nextPixel() && finalIt.nextPixel()) {
         device->colorSpace()->normalisedChannelsValue(yItterator.rawData(), yNormalised);
         device->colorSpace()->normalisedChannelsValue(xItterator.rawData(), xNormalised);
 
-        qreal z = 1.0;
-        if (channelFlip[2]==true){
-            z=-1.0;
-        }
         QVector3D normal = QVector3D((xNormalised[channelToConvert]-0.5)*2, (yNormalised[channelToConvert]-0.5)*2, z);
         normal.normalize();
         finalNorm.fill(1.0);
         for (int c = 0; c<3; c++) {
-            finalNorm[device->colorSpace()->channels().at(channelOrder[c])->displayPosition()] = (normal[channelOrder[c]]/2)+0.5;
+            finalNorm[displayPositions[c]] = (normal[channelOrder[c]]/2)+0.5;
         }
 
         finalNorm[alphaPos]= 1.0;
 
-        quint8* pixel = finalIt.rawData();
-        device->colorSpace()->fromNormalisedChannelsValue(pixel, finalNorm);
-        memcpy(finalIt.rawData(), pixel, pixelSize);
-
+        device->colorSpace()->fromNormalisedChannelsValue(finalIt.rawData(), finalNorm);
     }
 }
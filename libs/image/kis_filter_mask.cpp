@@ -8,12 +8,16 @@
 #include <KoIcon.h>
 #include <kis_icon.h>
 #include <KoCompositeOpRegistry.h>
+#include <KoColorTransformation.h>
 
 #include "kis_layer.h"
 #include "kis_filter_mask.h"
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/kis_color_transformation_filter.h"
+#include "filter/kis_color_transformation_configuration.h"
+#include "kis_pixel_selection.h"
 #include "kis_selection.h"
 #include "kis_processing_information.h"
 #include "kis_node.h"
@@ -88,6 +92,52 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
     return r;
 }
 
+QSharedPointer<KoColorTransformation> KisFilterMask::pixelTransformation(const KoColorSpace *cs, const QRect &applyRect) const
+{
+    KisFilterConfigurationSP filterConfig = filter();
+    if (!filterConfig) return QSharedPointer<KoColorTransformation>();
+
+    const KisColorTransformationFilter *filter =
+        dynamic_cast<const KisColorTransformationFilter*>(
+            KisFilterRegistry::instance()->value(filterConfig->name()).data());
+
+    if (!filter) return QSharedPointer<KoColorTransformation>();
+
+    {
+        KisIndirectPaintingSupport::ReadLocker l(this);
+        if (hasTemporaryTarget()) return QSharedPointer<KoColorTransformation>();
+    }
+
+    KisSelectionSP selection = this->selection();
+    if (selection) {
+        flattenSelectionProjection(selection, applyRect);
+
+        KisPixelSelectionSP projection = selection->projection();
+        if (*projection->defaultPixel().data() != MAX_SELECTED ||
+            projection->extent().intersects(applyRect)) {
+
+            return QSharedPointer<KoColorTransformation>();
+        }
+    }
+
+    KisColorTransformationConfiguration *colorTransformationConfiguration =
+        dynamic_cast<KisColorTransformationConfiguration*>(filterConfig.data());
+
+    if (colorTransformationConfiguration) {
+        // the transformation is cached by the configuration, so keep the
+        // configuration alive for as long as the transformation is used
+        KoColorTransformation *transformation =
+            colorTransformationConfiguration->colorTransformation(cs, filter);
+
+        return transformation ?
+            QSharedPointer<KoColorTransformation>(transformation,
+                                                  [filterConfig] (KoColorTransformation*) { Q_UNUSED(filterConfig); }) :
+            QSharedPointer<KoColorTransformation>();
+    }
+
+    return QSharedPointer<KoColorTransformation>(filter->createTransformation(cs, filterConfig));
+}
+
 bool KisFilterMask::accept(KisNodeVisitor &v)
 {
     return v.visit(this);
@@ -6,12 +6,15 @@
 #ifndef _KIS_FILTER_MASK_
 #define _KIS_FILTER_MASK_
 
+#include <QSharedPointer>
+
 #include "kis_types.h"
 #include "kis_effect_mask.h"
 
 #include "kis_node_filter_interface.h"
 
 class KisFilterConfiguration;
+class KoColorTransformation;
 
 /**
    An filter mask is a single channel mask that applies a particular
@@ -53,6 +56,19 @@ public:
 
     QRect changeRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
     QRect needRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
+
+    /**
+     * Returns a color transformation that has exactly the same effect on
+     * \p applyRect of a device with color space \p cs as applying the
+     * mask itself, or null if the mask cannot be represented as a pure
+     * per-pixel transformation there (e.g. the filter is not a color
+     * transformation, the selection is not fully opaque in the rect or
+     * the user is painting on the mask right now).
+     *
+     * The layer uses it to merge a chain of adjustment masks into a
+     * single pass over the pixels.
+     */
+    QSharedPointer<KoColorTransformation> pixelTransformation(const KoColorSpace *cs, const QRect &applyRect) const;
 };
 
 #endif //_KIS_FILTER_MASK_
@@ -250,25 +250,24 @@ public:
             memcpy(bufPtr, borderPixel, pixelSize);
         }
 
-        const quint8 **colors = new const quint8* [buffer->maxSpan()];
-
+        /**
+         * The source pixels of every span are contiguous in the line
+         * buffer, so they are passed to the mixing op as a plain array.
+         * It saves building an array of pointers for every pixel and
+         * lets the op read the channels with a constant stride.
+         */
         T dstIt = tmp::createIterator<T>(m_dst, dstStart, line, dstEnd - dstStart);
         for (int i = dstStart; i < dstEnd; i++) {
             BlendSpan span = calculateBlendSpan(i, line, buffer);
 
-            int bufIndexStart = span.firstBlendPixel - leftSrcBorder;
-            int bufIndexEnd = bufIndexStart + span.weights->span;
-
-            const quint8 **colorsPtr = colors;
-            for (int j = bufIndexStart; j < bufIndexEnd; j++) {
-                *(colorsPtr++) = srcLineBuf + j * pixelSize;
-            }
+            const int bufIndexStart = span.firstBlendPixel - leftSrcBorder;
 
-            mixOp->mixColors(colors, span.weights->weight, span.weights->span, dstIt->rawData());
+            mixOp->mixColors(srcLineBuf + bufIndexStart * pixelSize,
+                             span.weights->weight, span.weights->span,
+                             dstIt->rawData());
             dstIt->nextPixel();
         }
 
-        delete[] colors;
         delete[] srcLineBuf;
 
         return LinePos(dstStart, qMax(0, dstEnd - dstStart));
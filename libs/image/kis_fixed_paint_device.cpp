@@ -6,6 +6,8 @@
  */
 #include "kis_fixed_paint_device.h"
 
+#include <algorithm>
+
 #include <KoColorSpaceRegistry.h>
 #include <KoColor.h>
 #include <KoColorModelStandardIds.h>
@@ -227,11 +229,8 @@ QImage KisFixedPaintDevice::convertToQImage(const KoColorProfile *  dstProfile,
 void KisFixedPaintDevice::clear(const QRect & rc)
 {
     KoColor c(Qt::black, m_colorSpace);
-    quint8* black = new quint8[pixelSize()];
-    memcpy(black, c.data(), m_colorSpace->pixelSize());
-    m_colorSpace->setOpacity(black, OPACITY_TRANSPARENT_U8, 1);
-    fill(rc.x(), rc.y(), rc.width(), rc.height(), black);
-    delete[] black;
+    c.setOpacity(OPACITY_TRANSPARENT_U8);
+    fill(rc.x(), rc.y(), rc.width(), rc.height(), c.data());
 }
 
 void KisFixedPaintDevice::fill(const QRect &rc, const KoColor &color)
@@ -313,26 +312,23 @@ void KisFixedPaintDevice::mirror(bool horizontal, bool vertical)
     int h = m_bounds.height();
 
     if (horizontal){
-        int rowSize = pixelSize * w;
-
-        quint8 * dabPointer = data();
-        quint8 * row = new quint8[ rowSize ];
-        quint8 * mirror = 0;
+        quint8 * rowPointer = data();
+        const int rowSize = pixelSize * w;
 
+        // swap the pixels in place, the mirroring is done
+        // for every dab, so avoid allocating a temporary row
         for (int y = 0; y < h ; y++){
-            // TODO: implement better flipping of the data
-
-            memcpy(row, dabPointer, rowSize);
-            mirror = row;
-            mirror += (w-1) * pixelSize;
-            for (int x = 0; x < w; x++){
-                memcpy(dabPointer,mirror,pixelSize);
-                dabPointer += pixelSize;
-                mirror -= pixelSize;
+            quint8 *left = rowPointer;
+            quint8 *right = rowPointer + (w - 1) * pixelSize;
+
+            while (left < right) {
+                std::swap_ranges(left, left + pixelSize, right);
+                left += pixelSize;
+                right -= pixelSize;
             }
-        }
 
-        delete [] row;
+            rowPointer += rowSize;
+        }
     }
 
     if (vertical){
@@ -341,18 +337,13 @@ void KisFixedPaintDevice::mirror(bool horizontal, bool vertical)
 
         quint8 * startRow = data();
         quint8 * endRow = data() + (h-1) * w * pixelSize;
-        quint8 * row = new quint8[ rowSize ];
 
         for (int y = 0; y < rowsToMove; y++){
-            memcpy(row, startRow, rowSize);
-            memcpy(startRow, endRow, rowSize);
-            memcpy(endRow, row, rowSize);
+            std::swap_ranges(startRow, startRow + rowSize, endRow);
 
             startRow += rowSize;
             endRow -= rowSize;
         }
-
-        delete [] row;
     }
 
 }
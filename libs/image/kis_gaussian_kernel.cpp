@@ -109,8 +109,25 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
 {
     QPoint srcTopLeft = rect.topLeft();
 
+    /**
+     * For the huge radii both the spatial and the FFT convolutions become
+     * slow and the latter needs huge buffers, so use the recursive filter,
+     * which costs the same for any radius. For the small radii the exact
+     * kernel is still used, since the recursive filter is an approximation.
+     */
+    const qreal recursiveGaussianThreshold = 100.0;
+
+    if (qMax(xRadius, yRadius) >= recursiveGaussianThreshold) {
+        KisConvolutionPainter painter(device);
+        painter.setChannelFlags(channelFlags);
+        painter.setProgress(progressUpdater);
 
-    if (KisConvolutionPainter::supportsFFTW()) {
+        painter.applyRecursiveGaussian(device, srcTopLeft, srcTopLeft, rect.size(),
+                                       xRadius > 0.0 ? sigmaFromRadius(xRadius) : 0.0,
+                                       yRadius > 0.0 ? sigmaFromRadius(yRadius) : 0.0,
+                                       borderOp);
+
+    } else if (KisConvolutionPainter::supportsFFTW()) {
         KisConvolutionPainter painter(device, KisConvolutionPainter::FFTW);
         painter.setChannelFlags(channelFlags);
         painter.setProgress(progressUpdater);
@@ -177,6 +194,28 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
     }
 }
 
+void KisGaussianKernel::applyFastGaussian(KisPaintDeviceSP device,
+                                          const QRect& rect,
+                                          qreal xRadius, qreal yRadius,
+                                          const QBitArray &channelFlags,
+                                          KoUpdater *progressUpdater,
+                                          KisConvolutionBorderOp borderOp)
+{
+    if (xRadius <= 0.0 && yRadius <= 0.0) return;
+
+    const QPoint srcTopLeft = rect.topLeft();
+
+    KisConvolutionPainter painter(device);
+    painter.setChannelFlags(channelFlags);
+    painter.setProgress(progressUpdater);
+
+    painter.applyRecursiveGaussian(device, srcTopLeft, srcTopLeft, rect.size(),
+                                   xRadius > 0.0 ? sigmaFromRadius(xRadius) : 0.0,
+                                   yRadius > 0.0 ? sigmaFromRadius(yRadius) : 0.0,
+                                   borderOp,
+                                   KisConvolutionPainter::TRIPLE_BOX_BLUR);
+}
+
 Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic>
 KisGaussianKernel::createLoGMatrix(qreal radius, qreal coeff, bool zeroCentered, bool includeWrappedArea)
 {
@@ -44,6 +44,18 @@ public:
                               bool createTransaction = false,
                               KisConvolutionBorderOp borderOp = BORDER_REPEAT);
 
+    /**
+     * Approximates the Gaussian blur of applyGaussian() with three
+     * box blurs. It reads and changes the same area, but its cost
+     * doesn't depend on the radius. No transaction is ever needed.
+     */
+    static void applyFastGaussian(KisPaintDeviceSP device,
+                                  const QRect& rect,
+                                  qreal xRadius, qreal yRadius,
+                                  const QBitArray &channelFlags,
+                                  KoUpdater *updater,
+                                  KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+
     static Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> createLoGMatrix(qreal radius, qreal coeff, bool zeroCentered, bool includeWrappedArea);
 
     static void applyLoG(KisPaintDeviceSP device,
@@ -9,6 +9,11 @@
 
 #include <cfloat>
 
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtConcurrent>
+
 #include <KoColorSpace.h>
 #include <resources/KoAbstractGradient.h>
 #include <KoUpdater.h>
@@ -24,6 +29,7 @@
 #include "kis_random_accessor_ng.h"
 #include "kis_gradient_shape_strategy.h"
 #include "kis_polygonal_gradient_shape_strategy.h"
+#include "kis_distance_field_gradient_shape_strategy.h"
 #include "kis_cached_gradient_shape_strategy.h"
 #include "krita_utils.h"
 #include "KoMixColorsOp.h"
@@ -1031,6 +1037,18 @@ void KisGradientPainter::setGradientShape(enumGradientShape shape)
 
 KisGradientShapeStrategy* createPolygonShapeStrategy(const QPainterPath &path, const QRect &boundingRect)
 {
+    /**
+     * The polygonal strategy sums the contribution of every edge for
+     * every sample, which becomes prohibitively slow for the complex
+     * selections (e.g. the ones created with a magic wand). Use the
+     * distance field for them, its cost depends on the area only.
+     */
+    const int maxPolygonalElements = 1000;
+
+    if (path.elementCount() > maxPolygonalElements) {
+        return new KisDistanceFieldGradientShapeStrategy(path, boundingRect);
+    }
+
     // TODO: implement UI for exponent option
     const qreal exponent = 2.0;
     KisGradientShapeStrategy *strategy =
@@ -1271,8 +1289,6 @@ bool KisGradientPainter::paintGradient(const QPointF& gradientVectorStart,
 
         KoCachedGradient cachedGradient(gradient(), qMax(processRect.width(), processRect.height()), colorSpace);
 
-        KisSequentialIteratorProgress it(dev, processRect, progressUpdater());
-
         paintPolicy.setup(gradientVectorStart,
                           gradientVectorEnd,
                           shapeStrategy,
@@ -1281,8 +1297,45 @@ bool KisGradientPainter::paintGradient(const QPointF& gradientVectorStart,
                           reverseGradient,
                           &cachedGradient);
 
-        while (it.nextPixel()) {
-            memcpy(it.rawData(), paintPolicy.colorAt(it.x(), it.y()), pixelSize);
+        /**
+         * The big areas are split into tile-aligned patches and filled
+         * in parallel. The shape strategies and the cached gradient
+         * are read-only, but the paint policies keep a buffer for the
+         * mixed colors, so every patch gets its own copy of the policy.
+         */
+        QVector<QRect> patches =
+            KritaUtils::splitRectIntoPatches(processRect, QSize(256, 256));
+
+        if (patches.size() > 1) {
+            KoUpdater *updater = progressUpdater();
+            QAtomicInt numPatchesDone(0);
+            QMutex updaterMutex;
+
+            if (updater) {
+                updater->setProgress(0);
+            }
+
+            QtConcurrent::blockingMap(patches,
+                [&] (const QRect &patch) {
+                    T localPolicy(paintPolicy);
+                    KisSequentialIterator it(dev, patch);
+
+                    while (it.nextPixel()) {
+                        memcpy(it.rawData(), localPolicy.colorAt(it.x(), it.y()), pixelSize);
+                    }
+
+                    if (updater) {
+                        const int done = numPatchesDone.fetchAndAddOrdered(1) + 1;
+                        QMutexLocker l(&updaterMutex);
+                        updater->setProgress(100 * done / patches.size());
+                    }
+                });
+        } else {
+            KisSequentialIteratorProgress it(dev, processRect, progressUpdater());
+
+            while (it.nextPixel()) {
+                memcpy(it.rawData(), paintPolicy.colorAt(it.x(), it.y()), pixelSize);
+            }
         }
 
         bitBlt(processRect.topLeft(), dev, processRect);
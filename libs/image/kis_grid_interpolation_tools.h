@@ -11,6 +11,7 @@
 #include <algorithm>
 
 #include <QImage>
+#include <QtConcurrent>
 
 #include "kis_algebra_2d.h"
 #include "kis_four_point_interpolator_forward.h"
@@ -167,12 +168,23 @@ struct PaintDevicePolygonOp
     PaintDevicePolygonOp(KisPaintDeviceSP srcDev, KisPaintDeviceSP dstDev)
         : m_srcDev(srcDev), m_dstDev(dstDev) {}
 
+    /**
+     * Limits the written area of the destination to \p rc,
+     * an empty rect means no limit
+     */
+    void setClipRect(const QRect &rc) {
+        m_clipRect = rc;
+    }
+
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
         this->operator() (srcPolygon, dstPolygon, dstPolygon);
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
         QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect();
+        if (!m_clipRect.isEmpty()) {
+            boundRect &= m_clipRect;
+        }
         if (boundRect.isEmpty()) return;
 
         KisSequentialIterator dstIt(m_dstDev, boundRect);
@@ -215,6 +227,7 @@ struct PaintDevicePolygonOp
 
     KisPaintDeviceSP m_srcDev;
     KisPaintDeviceSP m_dstDev;
+    QRect m_clipRect;
 };
 
 struct QImagePolygonOp
@@ -226,8 +239,24 @@ struct QImagePolygonOp
           m_srcImageOffset(srcImageOffset),
           m_dstImageOffset(dstImageOffset),
           m_srcImageRect(m_srcImage.rect()),
-          m_dstImageRect(m_dstImage.rect())
+          m_dstImageRect(m_dstImage.rect()),
+          // detach the images once here, so that the pixels could be
+          // accessed from multiple threads afterwards
+          m_srcBits(m_srcImage.constBits()),
+          m_srcBytesPerLine(m_srcImage.bytesPerLine()),
+          m_dstBits(m_dstImage.bits()),
+          m_dstBytesPerLine(m_dstImage.bytesPerLine())
     {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(m_srcImage.depth() == 32);
+        KIS_SAFE_ASSERT_RECOVER_NOOP(m_dstImage.depth() == 32);
+    }
+
+    /**
+     * Limits the written area of the destination to \p rc (in the
+     * coordinates of the polygons), an empty rect means no limit
+     */
+    void setClipRect(const QRect &rc) {
+        m_clipRect = rc;
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
@@ -236,6 +265,11 @@ struct QImagePolygonOp
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
         QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect();
+        if (!m_clipRect.isEmpty()) {
+            boundRect &= m_clipRect;
+        }
+        if (boundRect.isEmpty()) return;
+
         KisFourPointInterpolatorBackward interp(srcPolygon, dstPolygon);
 
         for (int y = boundRect.top(); y <= boundRect.bottom(); y++) {
@@ -260,7 +294,12 @@ struct QImagePolygonOp
                     if (!m_dstImageRect.contains(srcPointI)) continue;
                     if (!m_srcImageRect.contains(dstPointI)) continue;
 
-                    m_dstImage.setPixel(srcPointI, m_srcImage.pixel(dstPointI));
+                    const QRgb *srcPixel =
+                        reinterpret_cast<const QRgb*>(m_srcBits + dstPointI.y() * m_srcBytesPerLine) + dstPointI.x();
+                    QRgb *dstPixel =
+                        reinterpret_cast<QRgb*>(m_dstBits + srcPointI.y() * m_dstBytesPerLine) + srcPointI.x();
+
+                    *dstPixel = *srcPixel;
                 }
             }
         }
@@ -287,6 +326,161 @@ struct QImagePolygonOp
 
     QRect m_srcImageRect;
     QRect m_dstImageRect;
+    QRect m_clipRect;
+
+    const uchar *m_srcBits;
+    int m_srcBytesPerLine;
+    uchar *m_dstBits;
+    int m_dstBytesPerLine;
+};
+
+/**
+ * Doesn't rasterize anything, just collects the cells of the grid,
+ * so that the caller could render them as a textured mesh
+ */
+struct MeshPolygonOp
+{
+    MeshPolygonOp(QVector<QPolygonF> *srcPolygons, QVector<QPolygonF> *dstPolygons)
+        : m_srcPolygons(srcPolygons),
+          m_dstPolygons(dstPolygons)
+    {
+    }
+
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
+        m_srcPolygons->append(srcPolygon);
+        m_dstPolygons->append(dstPolygon);
+    }
+
+    QVector<QPolygonF> *m_srcPolygons;
+    QVector<QPolygonF> *m_dstPolygons;
+};
+
+/**
+ * Collects the cells of the grid and renders them later with \p PolygonOp
+ * using multiple threads.
+ *
+ * The destination area is split into tile-aligned buckets and every bucket
+ * is processed by a single thread, with the copy of the polygon op clipped
+ * to the bucket. A cell is rendered into every bucket its bounds touch,
+ * in the order of the grid, so the overlapping (folded) parts of the grid
+ * look exactly like with the sequential iteration.
+ *
+ * PolygonOp should be copyable and support setClipRect().
+ */
+template <class PolygonOp>
+struct ParallelPolygonOp
+{
+    /**
+     * \p limitRect, if not empty, limits the processed area of the
+     * destination, the cells outside it are not even stored
+     */
+    ParallelPolygonOp(PolygonOp &polygonOp, const QRect &limitRect = QRect())
+        : m_polygonOp(polygonOp),
+          m_limitRect(limitRect)
+    {
+    }
+
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
+        this->operator() (srcPolygon, dstPolygon, dstPolygon);
+    }
+
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
+        Cell cell;
+        cell.bounds = clipDstPolygon.boundingRect().toAlignedRect();
+        if (!m_limitRect.isEmpty()) {
+            cell.bounds &= m_limitRect;
+        }
+        if (cell.bounds.isEmpty()) return;
+
+        cell.srcPolygon = srcPolygon;
+        cell.dstPolygon = dstPolygon;
+        cell.clipDstPolygon = clipDstPolygon;
+
+        m_cells.append(cell);
+        m_cellsBounds |= cell.bounds;
+    }
+
+    /**
+     * Renders all the collected cells and returns when all the
+     * threads are done
+     */
+    void process() {
+        if (m_cells.isEmpty()) return;
+
+        const int bucketSize = 256;
+
+        const int firstCol = divideFloor(m_cellsBounds.left(), bucketSize);
+        const int firstRow = divideFloor(m_cellsBounds.top(), bucketSize);
+        const int numCols = divideFloor(m_cellsBounds.right(), bucketSize) - firstCol + 1;
+        const int numRows = divideFloor(m_cellsBounds.bottom(), bucketSize) - firstRow + 1;
+
+        QVector<Bucket> buckets(numCols * numRows);
+
+        for (int row = 0; row < numRows; row++) {
+            for (int col = 0; col < numCols; col++) {
+                Bucket &bucket = buckets[col + row * numCols];
+                bucket.rect = QRect((firstCol + col) * bucketSize,
+                                    (firstRow + row) * bucketSize,
+                                    bucketSize, bucketSize);
+                if (!m_limitRect.isEmpty()) {
+                    bucket.rect &= m_limitRect;
+                }
+            }
+        }
+
+        for (int i = 0; i < m_cells.size(); i++) {
+            const QRect &rc = m_cells[i].bounds;
+
+            const int left = divideFloor(rc.left(), bucketSize) - firstCol;
+            const int top = divideFloor(rc.top(), bucketSize) - firstRow;
+            const int right = divideFloor(rc.right(), bucketSize) - firstCol;
+            const int bottom = divideFloor(rc.bottom(), bucketSize) - firstRow;
+
+            for (int row = top; row <= bottom; row++) {
+                for (int col = left; col <= right; col++) {
+                    buckets[col + row * numCols].cells.append(i);
+                }
+            }
+        }
+
+        QtConcurrent::blockingMap(buckets,
+            [this] (Bucket &bucket) {
+                if (bucket.cells.isEmpty() || bucket.rect.isEmpty()) return;
+
+                PolygonOp op(m_polygonOp);
+                op.setClipRect(bucket.rect);
+
+                Q_FOREACH (int index, bucket.cells) {
+                    const Cell &cell = m_cells[index];
+                    op(cell.srcPolygon, cell.dstPolygon, cell.clipDstPolygon);
+                }
+            });
+
+        m_cells.clear();
+        m_cellsBounds = QRect();
+    }
+
+private:
+    static inline int divideFloor(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    struct Cell {
+        QPolygonF srcPolygon;
+        QPolygonF dstPolygon;
+        QPolygonF clipDstPolygon;
+        QRect bounds;
+    };
+
+    struct Bucket {
+        QRect rect;
+        QVector<int> cells;
+    };
+
+    PolygonOp &m_polygonOp;
+    QRect m_limitRect;
+    QVector<Cell> m_cells;
+    QRect m_cellsBounds;
 };
 
 /*************************************************************/
@@ -86,6 +86,7 @@
 #include "kis_layer_projection_plane.h"
 
 #include "kis_update_time_monitor.h"
+#include "KisStrokeLatencyMonitor.h"
 #include "kis_lockless_stack.h"
 
 #include <QtCore>
@@ -100,6 +101,7 @@
 #include "KisRunnableStrokeJobsInterface.h"
 
 #include "KisBusyWaitBroker.h"
+#include "KisImageMemoryBudget.h"
 
 
 // #define SANITY_CHECKS
@@ -141,6 +143,7 @@ public:
         , signalRouter(_q)
         , animationInterface(_animationInterface)
         , scheduler(_q, _q)
+        , memoryBudget(_q)
         , axesCenter(QPointF(0.5, 0.5))
     {
         {
@@ -227,6 +230,7 @@ public:
     KisImageSignalRouter signalRouter;
     KisImageAnimationInterface *animationInterface;
     KisUpdateScheduler scheduler;
+    KisImageMemoryBudget memoryBudget;
     QAtomicInt disableDirtyRequests;
 
     KisCompositeProgressProxy compositeProgressProxy;
@@ -1201,7 +1205,8 @@ void KisImage::convertLayerColorSpace(KisNodeSP node,
     emitSignals << ModifiedSignal;
 
     KisProcessingApplicator applicator(this, node,
-                                       KisProcessingApplicator::RECURSIVE,
+                                       KisProcessingApplicator::RECURSIVE |
+                                       KisProcessingApplicator::PARALLEL_TILE_BANDS,
                                        emitSignals, actionName);
 
     applicator.applyVisitor(
@@ -1256,7 +1261,8 @@ void KisImage::KisImagePrivate::convertImageColorSpaceImpl(const KoColorSpace *d
 
     KisProcessingApplicator applicator(q, this->rootLayer,
                                        KisProcessingApplicator::RECURSIVE |
-                                       KisProcessingApplicator::NO_UI_UPDATES,
+                                       KisProcessingApplicator::NO_UI_UPDATES |
+                                       KisProcessingApplicator::PARALLEL_TILE_BANDS,
                                        emitSignals, actionName);
 
     applicator.applyCommand(
@@ -2153,6 +2159,8 @@ void KisImage::notifyProjectionUpdated(const QRect &rc)
 
         if (dirtyRect.isEmpty()) return;
 
+        KisStrokeLatencyMonitor::instance()->reportProjectionUpdated(rc, lod);
+
         emit sigImageUpdated(dirtyRect);
     } else {
         m_d->savedDisabledUIUpdates.push(rc);
@@ -2169,6 +2177,11 @@ int KisImage::workingThreadsLimit() const
     return m_d->scheduler.threadsLimit();
 }
 
+KisUpdateSchedulerStatistics KisImage::schedulerStatistics() const
+{
+    return m_d->scheduler.statistics();
+}
+
 void KisImage::notifySelectionChanged()
 {
     /**
@@ -2376,6 +2389,11 @@ void KisImage::setDesiredLevelOfDetail(int lod)
     m_d->scheduler.setDesiredLevelOfDetail(lod);
 }
 
+void KisImage::setUpdatesPriorityRegion(const QRect &rect)
+{
+    m_d->scheduler.setUpdatesPriorityRegion(rect);
+}
+
 int KisImage::currentLevelOfDetail() const
 {
     if (m_d->blockLevelOfDetail) {
@@ -2393,6 +2411,7 @@ void KisImage::setLevelOfDetailBlocked(bool value)
         m_d->scheduler.setDesiredLevelOfDetail(0);
     }
 
+    m_d->scheduler.setAdaptiveLevelOfDetailAllowed(!value);
     m_d->blockLevelOfDetail = value;
 }
 
@@ -2419,6 +2438,11 @@ KisImageAnimationInterface* KisImage::animationInterface() const
     return m_d->animationInterface;
 }
 
+KisImageMemoryBudget* KisImage::memoryBudget() const
+{
+    return &m_d->memoryBudget;
+}
+
 void KisImage::setProofingConfiguration(KisProofingConfigurationSP proofingConfig)
 {
     m_d->proofingConfig = proofingConfig;
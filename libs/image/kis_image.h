@@ -37,6 +37,8 @@ class KoColorProfile;
 class KisLayerComposition;
 class KisSpontaneousJob;
 class KisImageAnimationInterface;
+struct KisUpdateSchedulerStatistics;
+class KisImageMemoryBudget;
 class KUndo2MagicString;
 class KisProofingConfiguration;
 class KisPaintDevice;
@@ -102,6 +104,12 @@ public:
      */
     int workingThreadsLimit() const;
 
+    /**
+     * Return the current load of the image's working threads and the
+     * sizes of its update and stroke queues
+     */
+    KisUpdateSchedulerStatistics schedulerStatistics() const;
+
     /**
      * Makes a copy of the image with all the layers. If possible, shallow
      * copies of the layers are made.
@@ -703,6 +711,14 @@ public:
      */
     void setDesiredLevelOfDetail(int lod);
 
+    /**
+     * Notify KisImage which area of the image is currently visible on
+     * the canvas. The projection updates inside this area are processed
+     * first, the off-screen ones are postponed till there are spare
+     * threads. Pass an empty rect to reset the region.
+     */
+    void setUpdatesPriorityRegion(const QRect &rect);
+
     /**
      * Relative position of the mirror axis center
      *     0,0 - topleft corner of the image
@@ -752,6 +768,14 @@ public:
 
     KisImageAnimationInterface *animationInterface() const;
 
+    /**
+     * The memory budget of the image. The UI registers the
+     * undo trimming and frame cache dropping steps here.
+     *
+     * \see KisImageMemoryBudget
+     */
+    KisImageMemoryBudget* memoryBudget() const;
+
     /**
      * @brief setProofingConfiguration, this sets the image's proofing configuration, and signals
      * the proofingConfiguration has changed.
@@ -21,6 +21,7 @@
 #include <QDir>
 
 #include "kis_global.h"
+#include "KisCpuAffinity.h"
 #include <cmath>
 #include <QTemporaryFile>
 
@@ -78,6 +79,28 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+QString KisImageConfig::schedulerTraceFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("schedulerTraceFile", QString()) : QString();
+}
+
+void KisImageConfig::setSchedulerTraceFile(const QString &value)
+{
+    m_config.writeEntry("schedulerTraceFile", value);
+}
+
+bool KisImageConfig::trackStrokeLatency(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("trackStrokeLatency", false) : false;
+}
+
+void KisImageConfig::setTrackStrokeLatency(bool value)
+{
+    m_config.writeEntry("trackStrokeLatency", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
@@ -131,6 +154,28 @@ void KisImageConfig::setSchedulerBalancingRatio(qreal value)
     m_config.writeEntry("schedulerBalancingRatio", value);
 }
 
+bool KisImageConfig::adaptiveLevelOfDetail(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLevelOfDetail", false) : false;
+}
+
+void KisImageConfig::setAdaptiveLevelOfDetail(bool value)
+{
+    m_config.writeEntry("adaptiveLevelOfDetail", value);
+}
+
+qreal KisImageConfig::adaptiveLevelOfDetailTargetLatency(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLevelOfDetailTargetLatency", 20.0) : 20.0; // in ms
+}
+
+void KisImageConfig::setAdaptiveLevelOfDetailTargetLatency(qreal value)
+{
+    m_config.writeEntry("adaptiveLevelOfDetailTargetLatency", value);
+}
+
 int KisImageConfig::maxSwapSize(bool requestDefault) const
 {
     return !requestDefault ?
@@ -162,6 +207,85 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompression(bool requestDefault) const
+{
+    const QString defaultValue = "LZ4";
+    return !requestDefault ?
+        m_config.readEntry("swapCompression", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setSwapCompression(const QString &value)
+{
+    m_config.writeEntry("swapCompression", value);
+}
+
+int KisImageConfig::swapInMemoryLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapInMemoryLimit", 256) : 256; // in MiB
+}
+
+void KisImageConfig::setSwapInMemoryLimit(int value)
+{
+    m_config.writeEntry("swapInMemoryLimit", value);
+}
+
+bool KisImageConfig::swapDirectIO(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapDirectIO", false) : false;
+}
+
+void KisImageConfig::setSwapDirectIO(bool value)
+{
+    m_config.writeEntry("swapDirectIO", value);
+}
+
+bool KisImageConfig::lazyLoadHiddenLayers(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("lazyLoadHiddenLayers", true) : true;
+}
+
+void KisImageConfig::setLazyLoadHiddenLayers(bool value)
+{
+    m_config.writeEntry("lazyLoadHiddenLayers", value);
+}
+
+int KisImageConfig::historyMemoryLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("historyMemoryLimit", 0) : 0; // in MiB
+}
+
+void KisImageConfig::setHistoryMemoryLimit(int value)
+{
+    m_config.writeEntry("historyMemoryLimit", value);
+}
+
+int KisImageConfig::documentMemoryBudget(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("documentMemoryBudget", 0) : 0; // in MiB
+}
+
+void KisImageConfig::setDocumentMemoryBudget(int value)
+{
+    m_config.writeEntry("documentMemoryBudget", value);
+}
+
+QString KisImageConfig::tilesStreamCompression(bool requestDefault) const
+{
+    const QString defaultValue = "LZF";
+    return !requestDefault ?
+        m_config.readEntry("tilesStreamCompression", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setTilesStreamCompression(const QString &value)
+{
+    m_config.writeEntry("tilesStreamCompression", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -527,12 +651,13 @@ void KisImageConfig::setUseLodForColorizeMask(bool value)
 
 int KisImageConfig::maxNumberOfThreads(bool defaultValue) const
 {
-    return (defaultValue ? QThread::idealThreadCount() : m_config.readEntry("maxNumberOfThreads", QThread::idealThreadCount()));
+    const int defaultThreads = KisCpuAffinity::availableCpuCount();
+    return (defaultValue ? defaultThreads : m_config.readEntry("maxNumberOfThreads", defaultThreads));
 }
 
 void KisImageConfig::setMaxNumberOfThreads(int value)
 {
-    if (value == QThread::idealThreadCount()) {
+    if (value == KisCpuAffinity::availableCpuCount()) {
         m_config.deleteEntry("maxNumberOfThreads");
     } else {
         m_config.writeEntry("maxNumberOfThreads", value);
@@ -550,6 +675,37 @@ void KisImageConfig::setFrameRenderingClones(int value)
     m_config.writeEntry("frameRenderingClones", value);
 }
 
+int KisImageConfig::frameRenderingThreads(bool defaultValue) const
+{
+    const int value = defaultValue ? 0 : m_config.readEntry("frameRenderingThreads", 0);
+    return value > 0 ? value : maxNumberOfThreads(defaultValue);
+}
+
+void KisImageConfig::setFrameRenderingThreads(int value)
+{
+    m_config.writeEntry("frameRenderingThreads", value);
+}
+
+int KisImageConfig::videoEncoderThreads(bool defaultValue) const
+{
+    return defaultValue ? 0 : qMax(0, m_config.readEntry("videoEncoderThreads", 0));
+}
+
+void KisImageConfig::setVideoEncoderThreads(int value)
+{
+    m_config.writeEntry("videoEncoderThreads", value);
+}
+
+QString KisImageConfig::cpuAffinity(bool defaultValue) const
+{
+    return defaultValue ? QString() : m_config.readEntry("cpuAffinity", QString());
+}
+
+void KisImageConfig::setCpuAffinity(const QString &value)
+{
+    m_config.writeEntry("cpuAffinity", value);
+}
+
 int KisImageConfig::fpsLimit(bool defaultValue) const
 {
     int limit = defaultValue ? 100 : m_config.readEntry("fpsLimit", 100);
@@ -632,6 +788,16 @@ void KisImageConfig::setSelectionOverlayMaskColor(const QColor &color)
     m_config.writeEntry("selectionOverlayMaskColor", color);
 }
 
+bool KisImageConfig::fastLayerStyleBlur(bool defaultValue) const
+{
+    return defaultValue ? false : m_config.readEntry("fastLayerStyleBlur", false);
+}
+
+void KisImageConfig::setFastLayerStyleBlur(bool value)
+{
+    m_config.writeEntry("fastLayerStyleBlur", value);
+}
+
 void KisImageConfig::resetConfig()
 {
     KConfigGroup config = KSharedConfig::openConfig()->group(QString());
@@ -24,6 +24,22 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    /**
+     * If not empty, the timeline of the update scheduler is recorded
+     * and saved into this file in Chrome Trace Event format
+     * \see KisSchedulerTracer
+     */
+    QString schedulerTraceFile(bool requestDefault = false) const;
+    void setSchedulerTraceFile(const QString &value);
+
+    /**
+     * Measure the latency of the freehand strokes from the input event
+     * to the screen and print its percentiles after every stroke
+     * \see KisStrokeLatencyMonitor
+     */
+    bool trackStrokeLatency(bool requestDefault = false) const;
+    void setTrackStrokeLatency(bool value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
@@ -37,6 +53,12 @@ public:
     qreal schedulerBalancingRatio() const;
     void setSchedulerBalancingRatio(qreal value);
 
+    bool adaptiveLevelOfDetail(bool requestDefault = false) const;
+    void setAdaptiveLevelOfDetail(bool value);
+
+    qreal adaptiveLevelOfDetailTargetLatency(bool requestDefault = false) const;
+    void setAdaptiveLevelOfDetailTargetLatency(qreal value);
+
     int maxSwapSize(bool requestDefault = false) const;
     void setMaxSwapSize(int value);
 
@@ -46,6 +68,66 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * Algorithm used for compressing tiles in the swap file: "LZF",
+     * "LZ4" or "ZSTD". Falls back to "LZF" if the requested one is
+     * not supported by the build.
+     */
+    QString swapCompression(bool requestDefault = false) const;
+    void setSwapCompression(const QString &value);
+
+    /**
+     * Size of the RAM budget for keeping compressed swapped out
+     * tiles before they are written to the swap file on disk.
+     * Zero disables the in-memory tier.
+     */
+    int swapInMemoryLimit(bool requestDefault = false) const; // MiB
+    void setSwapInMemoryLimit(int value);
+
+    /**
+     * Access the swap file with O_DIRECT, bypassing the page cache of
+     * the OS, so that the swapped out tiles don't occupy the RAM twice.
+     * The chunks of the swap file are aligned to the page size in this
+     * mode. Supported on Linux only, ignored on other systems.
+     */
+    bool swapDirectIO(bool requestDefault = false) const;
+    void setSwapDirectIO(bool value);
+
+    /**
+     * Keep the pixel data of the hidden layers and of the inactive
+     * animation frames compressed in the swap when loading .kra
+     * files, so it is decompressed only when accessed for the
+     * first time.
+     */
+    bool lazyLoadHiddenLayers(bool requestDefault = false) const;
+    void setLazyLoadHiddenLayers(bool value);
+
+    /**
+     * The maximum amount of RAM the undo history tiles may occupy.
+     * When exceeded, the tiles of the oldest revisions are swapped
+     * out (compressed). Zero means the history is limited by the
+     * soft memory limit only.
+     */
+    int historyMemoryLimit(bool requestDefault = false) const; // MiB
+    void setHistoryMemoryLimit(int value);
+
+    /**
+     * Memory budget of a single document: its layers, projections,
+     * LoD planes and undo history. When the budget is exceeded, the
+     * document frees its own memory first, see KisImageMemoryBudget.
+     * Zero means the document is limited by the global limits only.
+     */
+    int documentMemoryBudget(bool requestDefault = false) const; // MiB
+    void setDocumentMemoryBudget(int value);
+
+    /**
+     * Algorithm used for compressing tiles saved into .kra files.
+     * Defaults to "LZF", because older versions of Krita cannot
+     * read tiles compressed with other algorithms.
+     */
+    QString tilesStreamCompression(bool requestDefault = false) const;
+    void setTilesStreamCompression(const QString &value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -108,6 +190,29 @@ public:
     int frameRenderingClones(bool defaultValue = false) const;
     void setFrameRenderingClones(int value);
 
+    /**
+     * The total number of threads used by the clones of the image
+     * rendering animation frames. Zero means maxNumberOfThreads().
+     */
+    int frameRenderingThreads(bool defaultValue = false) const;
+    void setFrameRenderingThreads(int value);
+
+    /**
+     * The number of threads passed to ffmpeg when encoding a video.
+     * Zero lets ffmpeg choose it.
+     */
+    int videoEncoderThreads(bool defaultValue = false) const;
+    void setVideoEncoderThreads(int value);
+
+    /**
+     * The set of cores Krita is pinned to on startup, in the format of
+     * taskset(1), e.g. "0-3,8". Empty means no pinning. Can be overridden
+     * by --cpu-affinity command line option.
+     * \see KisCpuAffinity
+     */
+    QString cpuAffinity(bool defaultValue = false) const;
+    void setCpuAffinity(const QString &value);
+
     int fpsLimit(bool defaultValue = false) const;
     void setFpsLimit(int value);
 
@@ -132,6 +237,13 @@ public:
     QColor selectionOverlayMaskColor(bool defaultValue = false) const;
     void setSelectionOverlayMaskColor(const QColor &color);
 
+    /**
+     * Approximate the Gaussian blurs of the layer styles with box
+     * blurs, which is faster on the big radii but a bit coarser
+     */
+    bool fastLayerStyleBlur(bool defaultValue = false) const;
+    void setFastLayerStyleBlur(bool value);
+
     template<class T>
     void writeEntry(const QString& name, const T& value) {
         m_config.writeEntry(name, value);
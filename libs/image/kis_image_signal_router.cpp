@@ -33,6 +33,14 @@ KisImageSignalRouter::KisImageSignalRouter(KisImageWSP image)
     connect(this, SIGNAL(sigNotification(KisImageSignalType)),
             SLOT(slotNotification(KisImageSignalType)));
 
+    /**
+     * Modification notifications come from the worker threads at the
+     * rate of the stroke jobs, but the recipients only need to know
+     * that something has changed, so they are compressed.
+     */
+    connect(&m_modifiedSignalCompressor, SIGNAL(timeout()),
+            SIGNAL(sigImageModified()));
+
     CONNECT_TO_IMAGE(sigImageModified());
     CONNECT_TO_IMAGE(sigSizeChanged(const QPointF&, const QPointF&));
     CONNECT_TO_IMAGE(sigResolutionChanged(double, double));
@@ -71,11 +79,14 @@ void KisImageSignalRouter::emitNotification(KisImageSignalType type)
     /**
      * All the notifications except LayersChangedSignal should go in a
      * queued way. And LayersChangedSignal should be delivered to the
-     * recipients in a non-reordered way
+     * recipients in a non-reordered way. ModifiedSignal is
+     * compressed by m_modifiedSignalCompressor.
      */
 
     if (type.id == LayersChangedSignal) {
         slotNotification(type);
+    } else if (type.id == ModifiedSignal) {
+        m_modifiedSignalCompressor.start();
     } else {
         emit sigNotification(type);
     }
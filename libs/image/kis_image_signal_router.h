@@ -9,6 +9,7 @@
 
 #include <QObject>
 #include "KisImageSignals.h"
+#include "KisAtomicSignalCompressor.h"
 
 class KoColorSpace;
 class KoColorProfile;
@@ -88,6 +89,7 @@ Q_SIGNALS:
 
 private:
     KisImageWSP m_image;
+    KisAtomicSignalCompressor m_modifiedSignalCompressor;
 };
 
 #endif /* __KIS_IMAGE_SIGNAL_ROUTER_H */
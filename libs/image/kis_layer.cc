@@ -24,6 +24,7 @@
 #include <KoProperties.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorTransformation.h>
 
 #include "kis_debug.h"
 #include "kis_image.h"
@@ -31,6 +32,7 @@
 #include "kis_painter.h"
 #include "kis_mask.h"
 #include "kis_effect_mask.h"
+#include "kis_filter_mask.h"
 #include "kis_selection_mask.h"
 #include "kis_meta_data_store.h"
 #include "kis_selection.h"
@@ -48,6 +50,8 @@
 #include "kis_layer_utils.h"
 #include "kis_projection_leaf.h"
 #include "KisSafeNodeProjectionStore.h"
+#include "kis_sequential_iterator.h"
+#include "kis_busy_progress_indicator.h"
 
 
 class KisCloneLayersList {
@@ -628,6 +632,55 @@ KisNode::PositionToFilthy calculatePositionToFilthy(KisNodeSP nodeInQuestion,
     return KisNode::N_BELOW_FILTHY;
 }
 
+namespace {
+
+/**
+ * A chain of adjacent masks that can be applied as a single
+ * per-pixel transformation
+ */
+struct FusedMasksChain
+{
+    QRect applyRect;
+    QList<KisEffectMaskSP> masks;
+    QVector<QSharedPointer<KoColorTransformation>> transformations;
+    QVector<KisNode::PositionToFilthy> positions;
+
+    void clear() {
+        applyRect = QRect();
+        masks.clear();
+        transformations.clear();
+        positions.clear();
+    }
+
+    void apply(KisPaintDeviceSP device) {
+        if (masks.isEmpty()) return;
+
+        if (masks.size() == 1) {
+            masks.first()->apply(device, applyRect, applyRect, positions.first());
+        } else {
+            Q_FOREACH (KisEffectMaskSP mask, masks) {
+                KIS_SAFE_ASSERT_RECOVER(mask->busyProgressIndicator()) { continue; }
+                mask->busyProgressIndicator()->update();
+            }
+
+            KisSequentialIterator it(device, applyRect);
+
+            int conseq = it.nConseqPixels();
+            while (it.nextPixels(conseq)) {
+                conseq = it.nConseqPixels();
+
+                Q_FOREACH (const QSharedPointer<KoColorTransformation> &transformation, transformations) {
+                    transformation->transform(it.rawData(), it.rawData(), conseq);
+                }
+            }
+        }
+
+        clear();
+    }
+};
+
+}
+
 QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
                            KisPaintDeviceSP destination,
                            const QRect &requestedRect,
@@ -676,14 +729,42 @@ QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
                 copyOriginalToProjection(source, destination, needRect);
             }
 
+            /**
+             * Adjacent masks that are pure per-pixel color transformations
+             * are fused into a single pass over the device, so the pixels
+             * are read and written only once for the whole chain.
+             */
+            FusedMasksChain chain;
+
             Q_FOREACH (const KisEffectMaskSP& mask, masks) {
                 const QRect maskApplyRect = applyRects.pop();
                 const QRect maskNeedRect =
                     applyRects.isEmpty() ? needRect : applyRects.top();
 
                 PositionToFilthy maskPosition = calculatePositionToFilthy(mask, filthyNode, const_cast<KisLayer*>(this));
-                mask->apply(destination, maskApplyRect, maskNeedRect, maskPosition);
+
+                KisFilterMask *filterMask = dynamic_cast<KisFilterMask*>(mask.data());
+                QSharedPointer<KoColorTransformation> transformation;
+
+                if (filterMask && maskApplyRect == maskNeedRect) {
+                    transformation = filterMask->pixelTransformation(destination->colorSpace(), maskApplyRect);
+                }
+
+                if (transformation) {
+                    if (!chain.masks.isEmpty() && chain.applyRect != maskApplyRect) {
+                        chain.apply(destination);
+                    }
+
+                    chain.applyRect = maskApplyRect;
+                    chain.masks.append(mask);
+                    chain.transformations.append(transformation);
+                    chain.positions.append(maskPosition);
+                } else {
+                    chain.apply(destination);
+                    mask->apply(destination, maskApplyRect, maskNeedRect, maskPosition);
+                }
             }
+            chain.apply(destination);
             Q_ASSERT(applyRects.isEmpty());
         } else {
             /**
@@ -890,7 +971,7 @@ QImage KisLayer::createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectR
         return QImage();
     }
 
-    KisPaintDeviceSP originalDevice = original();
+    KisPaintDeviceSP originalDevice = thumbnailSourceDevice();
 
     return originalDevice ?
            originalDevice->createThumbnail(w, h, aspectRatioMode, 1,
@@ -898,6 +979,11 @@ QImage KisLayer::createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectR
                                            KoColorConversionTransformation::internalConversionFlags()) : QImage();
 }
 
+KisPaintDeviceSP KisLayer::thumbnailSourceDevice() const
+{
+    return original();
+}
+
 QImage KisLayer::createThumbnailForFrame(qint32 w, qint32 h, int time, Qt::AspectRatioMode aspectRatioMode)
 {
     if (w == 0 || h == 0) {
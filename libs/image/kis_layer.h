@@ -235,6 +235,7 @@ public:
     QRect exactBounds() const override;
 
     QImage createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio) override;
+    KisPaintDeviceSP thumbnailSourceDevice() const override;
 
     QImage createThumbnailForFrame(qint32 w, qint32 h, int time, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio) override;
 
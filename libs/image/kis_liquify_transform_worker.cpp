@@ -6,6 +6,10 @@
 
 #include "kis_liquify_transform_worker.h"
 
+#include <cstring>
+
+#include <QTransform>
+
 #include "kis_grid_interpolation_tools.h"
 #include "kis_dom_utils.h"
 #include "krita_utils.h"
@@ -31,8 +35,28 @@ struct Q_DECL_HIDDEN KisLiquifyTransformWorker::Private
     int pixelPrecision;
     QSize gridSize;
 
+    /**
+     * The result of the last runOnQImage() call. The liquify tool asks
+     * for a new preview after every brush sample, which moves only a
+     * few points of the grid, so only the cells around them are
+     * rendered again.
+     */
+    struct PreviewCache {
+        qint64 srcImageKey = 0;
+        QPointF srcImageOffset;
+        QTransform imageToThumbTransform;
+        QRectF dstBounds;
+        QVector<QPointF> originalPoints;
+        QVector<QPointF> transformedPoints;
+        QImage dstImage;
+    };
+
+    PreviewCache previewCache;
+
     void preparePoints();
 
+    QRect calculateChangedPreviewRect(const QVector<QPointF> &transformedPointsLocal) const;
+
     struct MapIndexesOp;
 
     template <class ProcessOp>
@@ -386,11 +410,13 @@ void KisLiquifyTransformWorker::run(KisPaintDeviceSP device)
     using namespace GridIterationTools;
 
     PaintDevicePolygonOp polygonOp(srcDev, device);
+    ParallelPolygonOp<PaintDevicePolygonOp> parallelOp(polygonOp);
     RegularGridIndexesOp indexesOp(m_d->gridSize);
-    iterateThroughGrid<AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+    iterateThroughGrid<AlwaysCompletePolygonPolicy>(parallelOp, indexesOp,
                                                     m_d->gridSize,
                                                     m_d->originalPoints,
                                                     m_d->transformedPoints);
+    parallelOp.process();
 }
 
 QRect KisLiquifyTransformWorker::approxChangeRect(const QRect &rc)
@@ -474,19 +500,119 @@ QImage KisLiquifyTransformWorker::runOnQImage(const QImage &srcImage,
 
     QRect dstBoundsI = dstBounds.toAlignedRect();
 
-    QImage dstImage(dstBoundsI.size(), srcImage.format());
-    dstImage.fill(0);
+    Private::PreviewCache &cache = m_d->previewCache;
+
+    const bool canReuseCache =
+        !cache.dstImage.isNull() &&
+        cache.srcImageKey == srcImage.cacheKey() &&
+        cache.srcImageOffset == srcImageOffset &&
+        cache.imageToThumbTransform == imageToThumbTransform &&
+        cache.dstBounds == dstBounds &&
+        cache.originalPoints == originalPointsLocal &&
+        cache.transformedPoints.size() == transformedPointsLocal.size();
+
+    QImage dstImage;
+
+    /**
+     * The area of the grid whose cells have moved. An empty rect
+     * means the full render.
+     */
+    QRect changedRect;
+
+    if (canReuseCache) {
+        changedRect = m_d->calculateChangedPreviewRect(transformedPointsLocal);
+
+        if (changedRect.isEmpty()) {
+            return cache.dstImage;
+        }
+
+        // if most of the image has changed, the full render is cheaper
+        if (changedRect.width() * changedRect.height() * 2 >
+            dstBoundsI.width() * dstBoundsI.height()) {
+
+            changedRect = QRect();
+        }
+    }
+
+    QRect renderRect;
+
+    if (!changedRect.isEmpty()) {
+        dstImage = cache.dstImage;
+        cache.dstImage = QImage();
+
+        /**
+         * The polygon op rounds the fractional offset of the image,
+         * so we erase the changed pixels with a margin of one pixel and
+         * render everything that can touch these pixels. Every pixel
+         * has only one source position, so re-rendering a few
+         * non-erased pixels in the margin gives exactly the same result.
+         */
+        const QRect eraseRect =
+            changedRect.translated(-dstBoundsI.topLeft()).adjusted(-1, -1, 1, 1) & dstImage.rect();
+        renderRect = changedRect.adjusted(-2, -2, 2, 2);
+
+        const int bytesPerLine = eraseRect.width() * 4;
+
+        for (int y = eraseRect.top(); y <= eraseRect.bottom(); y++) {
+            std::memset(dstImage.scanLine(y) + eraseRect.left() * 4, 0, bytesPerLine);
+        }
+    } else {
+        dstImage = QImage(dstBoundsI.size(), srcImage.format());
+        dstImage.fill(0);
+    }
 
     GridIterationTools::QImagePolygonOp polygonOp(srcImage, dstImage, srcImageOffset, dstQImageOffset);
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp, renderRect);
     GridIterationTools::RegularGridIndexesOp indexesOp(m_d->gridSize);
     GridIterationTools::iterateThroughGrid
-        <GridIterationTools::AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+        <GridIterationTools::AlwaysCompletePolygonPolicy>(parallelOp, indexesOp,
                                                           m_d->gridSize,
                                                           originalPointsLocal,
                                                           transformedPointsLocal);
+    parallelOp.process();
+
+    cache.srcImageKey = srcImage.cacheKey();
+    cache.srcImageOffset = srcImageOffset;
+    cache.imageToThumbTransform = imageToThumbTransform;
+    cache.dstBounds = dstBounds;
+    cache.originalPoints = originalPointsLocal;
+    cache.transformedPoints = transformedPointsLocal;
+    cache.dstImage = dstImage;
+
     return dstImage;
 }
 
+QRect KisLiquifyTransformWorker::Private::calculateChangedPreviewRect(const QVector<QPointF> &transformedPointsLocal) const
+{
+    const QVector<QPointF> &cachedPoints = previewCache.transformedPoints;
+    const int width = gridSize.width();
+    const int height = gridSize.height();
+
+    QPolygonF changedPoints;
+
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            const int index = col + row * width;
+            if (transformedPointsLocal[index] == cachedPoints[index]) continue;
+
+            // the cells around the point change, so we should
+            // cover all their corners, in old and new positions
+            for (int y = qMax(0, row - 1); y <= qMin(height - 1, row + 1); y++) {
+                for (int x = qMax(0, col - 1); x <= qMin(width - 1, col + 1); x++) {
+                    const int neighbourIndex = x + y * width;
+                    changedPoints << transformedPointsLocal[neighbourIndex];
+                    changedPoints << cachedPoints[neighbourIndex];
+                }
+            }
+        }
+    }
+
+    if (changedPoints.isEmpty()) return QRect();
+
+    // toAlignedRect() never returns an empty rect for a degenerated one
+    return changedPoints.boundingRect().toAlignedRect();
+}
+
 void KisLiquifyTransformWorker::toXML(QDomElement *e) const
 {
     QDomDocument doc = e->ownerDocument();
@@ -451,8 +451,7 @@ QRect KisMask::nonDependentExtent() const
 
 QImage KisMask::createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectRatioMode)
 {
-    KisPaintDeviceSP originalDevice =
-        selection() ? selection()->projection() : 0;
+    KisPaintDeviceSP originalDevice = thumbnailSourceDevice();
 
     return originalDevice ?
            originalDevice->createThumbnail(w, h, aspectRatioMode, 1,
@@ -460,6 +459,11 @@ QImage KisMask::createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectRa
                                            KoColorConversionTransformation::internalConversionFlags()) : QImage();
 }
 
+KisPaintDeviceSP KisMask::thumbnailSourceDevice() const
+{
+    return selection() ? KisPaintDeviceSP(selection()->projection()) : KisPaintDeviceSP();
+}
+
 void KisMask::testingInitSelection(const QRect &rect, KisLayerSP parentLayer)
 {
     if (parentLayer) {
@@ -16,6 +16,7 @@
 
 #include <QVector>
 #include <QGlobalStatic>
+#include <QtConcurrent>
 
 #include <KoColorSpaceMaths.h>
 
@@ -256,93 +257,81 @@ double KisMathToolbox::maxChannelValue(KoChannelInfo *c)
     }
 }
 
-void KisMathToolbox::wavetrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
+namespace {
+
+/**
+ * One level of the Haar transform done in place: every 2x2 block of the
+ * previous level's approximation is replaced with its approximation and
+ * detail coefficients. The blocks of one level are independent, so the
+ * rows of blocks are processed in parallel.
+ */
+void liftLevel(KisMathToolbox::KisWavelet* wav, uint step, bool inverse)
 {
-    uint l = (2 * halfsize) * wav->depth * sizeof(float);
-    for (uint i = 0; i < halfsize; i++) {
-        float * itLL = buff->coeffs + i * buff->size * buff->depth;
-        float * itHL = buff->coeffs + (i * buff->size + halfsize) * buff->depth;
-        float * itLH = buff->coeffs + (halfsize + i) * buff->size * buff->depth;
-        float * itHH = buff->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
-        float * itS11 = wav->coeffs + 2 * i * wav->size * wav->depth;
-        float * itS12 = wav->coeffs + (2 * i * wav->size + 1) * wav->depth;
-        float * itS21 = wav->coeffs + (2 * i + 1) * wav->size * wav->depth;
-        float * itS22 = wav->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
-        for (uint j = 0; j < halfsize; j++) {
-            for (uint k = 0; k < wav->depth; k++) {
-                *(itLL++) = (*itS11 + *itS12 + *itS21 + *itS22) * M_SQRT1_2;
-                *(itHL++) = (*itS11 - *itS12 + *itS21 - *itS22) * M_SQRT1_2;
-                *(itLH++) = (*itS11 + *itS12 - *itS21 - *itS22) * M_SQRT1_2;
-                *(itHH++) = (*(itS11++) - *(itS12++) - *(itS21++) + *(itS22++)) * M_SQRT1_2;
-            }
-            itS11 += wav->depth; itS12 += wav->depth;
-            itS21 += wav->depth; itS22 += wav->depth;
-        }
-    }
-    for (uint i = 0; i < halfsize; i++) {
-        uint p = i * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-        p = (i + halfsize) * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-    }
-    if (halfsize != 1) {
-        wavetrans(wav, buff, halfsize / 2);
+    const uint depth = wav->depth;
+    const uint rowStride = wav->size * depth;
+    const float scale = inverse ? 0.25 * M_SQRT2 : M_SQRT1_2;
+
+    QVector<uint> blockRows;
+    for (uint i = 0; i < wav->size; i += 2 * step) {
+        blockRows << i;
     }
+
+    QtConcurrent::blockingMap(blockRows,
+        [=] (const uint &i) {
+            float *it11 = wav->coeffs + i * rowStride;
+            float *it12 = it11 + step * depth;
+            float *it21 = it11 + step * rowStride;
+            float *it22 = it21 + step * depth;
+
+            for (uint j = 0; j < wav->size; j += 2 * step) {
+                for (uint k = 0; k < depth; k++) {
+                    const float s11 = it11[k];
+                    const float s12 = it12[k];
+                    const float s21 = it21[k];
+                    const float s22 = it22[k];
+
+                    it11[k] = (s11 + s12 + s21 + s22) * scale;
+                    it12[k] = (s11 - s12 + s21 - s22) * scale;
+                    it21[k] = (s11 + s12 - s21 - s22) * scale;
+                    it22[k] = (s11 - s12 - s21 + s22) * scale;
+                }
+                it11 += 2 * step * depth; it12 += 2 * step * depth;
+                it21 += 2 * step * depth; it22 += 2 * step * depth;
+            }
+        });
 }
 
-void KisMathToolbox::waveuntrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
+}
+
+void KisMathToolbox::wavetrans(KisMathToolbox::KisWavelet* wav)
 {
-    uint l = (2 * halfsize) * wav->depth * sizeof(float);
-    for (uint i = 0; i < halfsize; i++) {
-        float * itLL = wav->coeffs + i * buff->size * buff->depth;
-        float * itHL = wav->coeffs + (i * buff->size + halfsize) * buff->depth;
-        float * itLH = wav->coeffs + (halfsize + i) * buff->size * buff->depth;
-        float * itHH = wav->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
-        float * itS11 = buff->coeffs + 2 * i * wav->size * wav->depth;
-        float * itS12 = buff->coeffs + (2 * i * wav->size + 1) * wav->depth;
-        float * itS21 = buff->coeffs + (2 * i + 1) * wav->size * wav->depth;
-        float * itS22 = buff->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
-        for (uint j = 0; j < halfsize; j++) {
-            for (uint k = 0; k < wav->depth; k++) {
-                *(itS11++) = (*itLL + *itHL + *itLH + *itHH) * 0.25 * M_SQRT2;
-                *(itS12++) = (*itLL - *itHL + *itLH - *itHH) * 0.25 * M_SQRT2;
-                *(itS21++) = (*itLL + *itHL - *itLH - *itHH) * 0.25 * M_SQRT2;
-                *(itS22++) = (*(itLL++) - *(itHL++) - *(itLH++) + *(itHH++)) * 0.25 * M_SQRT2;
-            }
-            itS11 += wav->depth; itS12 += wav->depth;
-            itS21 += wav->depth; itS22 += wav->depth;
-        }
-    }
-    for (uint i = 0; i < halfsize; i++) {
-        uint p = i * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-        p = (i + halfsize) * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
+    for (uint step = 1; step < wav->size; step *= 2) {
+        liftLevel(wav, step, false);
     }
+}
 
-    if (halfsize != wav->size / 2) {
-        waveuntrans(wav, buff, halfsize*2);
+void KisMathToolbox::waveuntrans(KisMathToolbox::KisWavelet* wav)
+{
+    for (uint step = wav->size / 2; step >= 1; step /= 2) {
+        liftLevel(wav, step, true);
     }
 }
 
 KisMathToolbox::KisWavelet* KisMathToolbox::fastWaveletTransformation(KisPaintDeviceSP src, const QRect& rect,  KisWavelet* buff)
 {
-    if (buff == 0) {
-        buff = initWavelet(src, rect);
-    }
+    Q_UNUSED(buff);
+
     KisWavelet* wav = initWavelet(src, rect);
     transformToFR(src, wav, rect);
-    wavetrans(wav, buff, wav->size / 2);
+    wavetrans(wav);
 
     return wav;
 }
 
 void KisMathToolbox::fastWaveletUntransformation(KisPaintDeviceSP dst, const QRect& rect, KisWavelet* wav, KisWavelet* buff)
 {
-    if (buff == 0) {
-        buff = initWavelet(dst, rect);
-    }
+    Q_UNUSED(buff);
 
-    waveuntrans(wav, buff, 1);
+    waveuntrans(wav);
     transformFromFR(dst, wav, rect);
 }
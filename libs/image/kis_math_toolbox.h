@@ -69,13 +69,14 @@ public:
     inline uint fastWaveletTotalSteps(const QRect&);
 
     /**
-     * This function reconstruct the layer from the information of a wavelet
+     * This function computes the Haar wavelet of the layer. The transform is
+     * done in place, so the coefficients of the levels are interleaved in the
+     * wavelet: the approximation of the coarsest level is the first pixel and
+     * the detail coefficients of the level with the step s are stored at the
+     * odd multiples of s.
      * @param src layer from which the wavelet will be computed
      * @param rect the rectangular for reconstruction
-     * @param buff if set to 0, the buffer will be initialized by the function,
-     * you might want to give a buff to the function if you want to use the same buffer
-     * in transformToWavelet and in untransformToWavelet, use initWavelet to initialize
-     * the buffer
+     * @param buff unused, the transform needs no extra buffer anymore
      */
     KisWavelet* fastWaveletTransformation(KisPaintDeviceSP src, const QRect&, KisWavelet* buff = 0);
 
@@ -83,11 +84,8 @@ public:
      * This function reconstruct the layer from the information of a wavelet
      * @param dst layer on which the wavelet will be untransform
      * @param rect the rectangular for reconstruction
-     * @param wav the wavelet
-     * @param buff if set to 0, the buffer will be initialized by the function,
-     * you might want to give a buff to the function if you want to use the same buffer
-     * in transformToWavelet and in untransformToWavelet, use initWavelet to initialize
-     * the buffer
+     * @param wav the wavelet, it is overwritten by the reconstruction
+     * @param buff unused, the transform needs no extra buffer anymore
      */
     void fastWaveletUntransformation(KisPaintDeviceSP dst, const QRect&, KisWavelet* wav, KisWavelet* buff = 0);
 
@@ -100,8 +98,8 @@ public:
 
 private:
 
-    void wavetrans(KisWavelet* wav, KisWavelet* buff, uint halfsize);
-    void waveuntrans(KisWavelet* wav, KisWavelet* buff, uint halfsize);
+    void wavetrans(KisWavelet* wav);
+    void waveuntrans(KisWavelet* wav);
 
     /**
      * This function transform a paint device into a KisFloatRepresentation, this function is colorspace independent,
@@ -55,7 +55,8 @@ inline void addDevice(KisPaintDeviceSP dev,
                       qint64 &memBound,
                       qint64 &layersSize,
                       qint64 &projectionsSize,
-                      qint64 &lodSize)
+                      qint64 &lodSize,
+                      qint64 &historySize)
 {
     if (dev && !devices.contains(dev.data())) {
         devices.insert(dev.data());
@@ -76,6 +77,7 @@ inline void addDevice(KisPaintDeviceSP dev,
         }
 
         lodSize += lodData;
+        historySize += dev->estimateHistoryMemorySize();
     }
 }
 
@@ -83,7 +85,8 @@ qint64 calculateNodeMemoryHiBoundStep(KisNodeSP node,
                                       QSet<KisPaintDevice*> &devices,
                                       qint64 &layersSize,
                                       qint64 &projectionsSize,
-                                      qint64 &lodSize)
+                                      qint64 &lodSize,
+                                      qint64 &historySize)
 {
     qint64 memBound = 0;
 
@@ -92,14 +95,15 @@ qint64 calculateNodeMemoryHiBoundStep(KisNodeSP node,
             node->inherits("KisAdjustmentLayer");
 
 
-    addDevice(node->paintDevice(), false, devices, memBound, layersSize, projectionsSize, lodSize);
-    addDevice(node->original(), originalIsProjection, devices, memBound, layersSize, projectionsSize, lodSize);
-    addDevice(node->projection(), true, devices, memBound, layersSize, projectionsSize, lodSize);
+    addDevice(node->paintDevice(), false, devices, memBound, layersSize, projectionsSize, lodSize, historySize);
+    addDevice(node->original(), originalIsProjection, devices, memBound, layersSize, projectionsSize, lodSize, historySize);
+    addDevice(node->projection(), true, devices, memBound, layersSize, projectionsSize, lodSize, historySize);
 
     node = node->firstChild();
     while (node) {
         memBound += calculateNodeMemoryHiBoundStep(node, devices,
-                                                   layersSize, projectionsSize, lodSize);
+                                                   layersSize, projectionsSize,
+                                                   lodSize, historySize);
         node = node->nextSibling();
     }
 
@@ -109,18 +113,21 @@ qint64 calculateNodeMemoryHiBoundStep(KisNodeSP node,
 qint64 calculateNodeMemoryHiBound(KisNodeSP node,
                                   qint64 &layersSize,
                                   qint64 &projectionsSize,
-                                  qint64 &lodSize)
+                                  qint64 &lodSize,
+                                  qint64 &historySize)
 {
     layersSize = 0;
     projectionsSize = 0;
     lodSize = 0;
+    historySize = 0;
 
     QSet<KisPaintDevice*> devices;
     return calculateNodeMemoryHiBoundStep(node,
                                           devices,
                                           layersSize,
                                           projectionsSize,
-                                          lodSize);
+                                          lodSize,
+                                          historySize);
 }
 
 
@@ -136,7 +143,8 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
             calculateNodeMemoryHiBound(image->root(),
                                        stats.layersSize,
                                        stats.projectionsSize,
-                                       stats.lodSize);
+                                       stats.lodSize,
+                                       stats.historySize);
     }
     stats.totalMemorySize = tileStats.totalMemorySize;
     stats.realMemorySize = tileStats.realMemorySize;
@@ -144,6 +152,12 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.swapInMemorySize = tileStats.swapInMemorySize;
+    stats.swapFileSize = tileStats.swapFileSize;
+    stats.swapFileUsage = tileStats.swapFileUsage;
+
+    stats.poolHits = tileStats.poolHits;
+    stats.poolMisses = tileStats.poolMisses;
 
     KisImageConfig cfg(true);
 
@@ -151,6 +165,7 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.tilesSoftLimit = cfg.tilesSoftLimit() * MiB;
     stats.tilesPoolLimit = cfg.poolLimit() * MiB;
     stats.totalMemoryLimit = stats.tilesHardLimit + stats.tilesPoolLimit;
+    stats.documentMemoryBudget = cfg.documentMemoryBudget() * MiB;
 
     return stats;
 }
@@ -26,6 +26,7 @@ public:
               layersSize(0),
               projectionsSize(0),
               lodSize(0),
+              historySize(0),
 
               totalMemorySize(0),
               realMemorySize(0),
@@ -33,11 +34,17 @@ public:
               poolSize(0),
 
               swapSize(0),
+              swapInMemorySize(0),
+              swapFileSize(0),
+              swapFileUsage(0),
+              poolHits(0),
+              poolMisses(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
               tilesSoftLimit(0),
-              tilesPoolLimit(0)
+              tilesPoolLimit(0),
+              documentMemoryBudget(0)
         {
         }
 
@@ -45,6 +52,7 @@ public:
         qint64 layersSize;
         qint64 projectionsSize;
         qint64 lodSize;
+        qint64 historySize;
 
         qint64 totalMemorySize;
         qint64 realMemorySize;
@@ -52,11 +60,18 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapInMemorySize;
+        qint64 swapFileSize;
+        qint64 swapFileUsage;
+
+        qint64 poolHits;
+        qint64 poolMisses;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
         qint64 tilesSoftLimit;
         qint64 tilesPoolLimit;
+        qint64 documentMemoryBudget;
     };
 
 
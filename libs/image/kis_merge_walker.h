@@ -45,6 +45,13 @@ protected:
      * changeRects (it calls @ref registerChangeRect for every node).
      * Then it goes down to the bottom collecting needRects
      * for every branch.
+     *
+     * Please note that the walker never enters the groups that are
+     * siblings of the filthy node or of its parents. The projections
+     * of such groups are still valid, so they are just blended as they
+     * are (N_ABOVE_FILTHY and N_BELOW_FILTHY positions). Pass-through
+     * groups are the only exception, since KisProjectionLeaf presents
+     * their children as the siblings of the group itself.
      */
     void startTrip(KisProjectionLeafSP startWith) override;
 
@@ -24,6 +24,9 @@ struct KisOnionSkinCache::Private
 {
     KisPaintDeviceSP cachedProjection;
 
+    /// the tinted frames are reused when only the current time changes
+    KisOnionSkinCompositor::TintedFramesCache tintedFrames;
+
     int cacheTime = 0;
     int cacheConfigSeqNo = 0;
     int framesHash = 0;
@@ -91,7 +94,7 @@ KisPaintDeviceSP KisOnionSkinCache::projection(KisPaintDeviceSP source)
             }
 
             const QRect extent = compositor->calculateExtent(source);
-            compositor->composite(source, cachedProjection, extent);
+            compositor->composite(source, cachedProjection, extent, &m_d->tintedFrames);
 
             cachedProjection->setDefaultBounds(source->defaultBounds());
 
@@ -119,6 +122,7 @@ void KisOnionSkinCache::reset()
 {
     QWriteLocker writeLocker(&m_d->lock);
     m_d->cachedProjection = 0;
+    m_d->tintedFrames.clear();
 }
 
 KisPaintDeviceSP KisOnionSkinCache::lodCapableDevice() const
@@ -15,9 +15,48 @@
 
 #include "kis_image_config.h"
 #include "kis_raster_keyframe_channel.h"
+#include "kis_paint_device_frames_interface.h"
+#include "kis_datamanager.h"
 
 Q_GLOBAL_STATIC(KisOnionSkinCompositor, s_instance)
 
+namespace {
+
+struct TintedFrame
+{
+    KisPaintDeviceSP device;
+
+    /// the data of the frame and the change revision it was tinted at
+    KisDataManagerSP dataManager;
+    int revision = 0;
+
+    QPoint offset;
+    int configSeqNo = -1;
+    bool isForward = false;
+};
+
+}
+
+struct KisOnionSkinCompositor::TintedFramesCache::Private
+{
+    /// the tinted frames keyed by the frame ID
+    QHash<int, TintedFrame> frames;
+};
+
+KisOnionSkinCompositor::TintedFramesCache::TintedFramesCache()
+    : m_d(new Private)
+{
+}
+
+KisOnionSkinCompositor::TintedFramesCache::~TintedFramesCache()
+{
+}
+
+void KisOnionSkinCompositor::TintedFramesCache::clear()
+{
+    m_d->frames.clear();
+}
+
 struct KisOnionSkinCompositor::Private
 {
     int numberOfSkins = 0;
@@ -73,6 +112,73 @@ struct KisOnionSkinCompositor::Private
         gcDest.bitBlt(rect.topLeft(), gcFrame.device(), rect);
     }
 
+    /**
+     * Same as tryCompositeFrame(), but the frame is tinted only when it is
+     * not in \p tintedFrames yet or when it has changed since it was tinted.
+     * The transparent pixels of the frame are not affected by the tint, so
+     * only the extent of the frame is tinted, not \p rect. The frames with
+     * a non-transparent default pixel are tinted everywhere, so they are
+     * not cached.
+     */
+    void tryCompositeCachedFrame(KisPaintDeviceSP sourceDevice, KisRasterKeyframeSP keyframe, bool isForward,
+                                 KisPainter &gcDest, KisPaintDeviceSP tintSource, int opacity, const QRect &rect,
+                                 QHash<int, TintedFrame> &tintedFrames, QHash<int, TintedFrame> &usedFrames)
+    {
+        if (keyframe.isNull() || opacity == OPACITY_TRANSPARENT_U8) return;
+
+        KisPaintDeviceFramesInterface *frames = sourceDevice->framesInterface();
+        const int frameId = keyframe->frameID();
+
+        if (frames->frameDefaultPixel(frameId).opacityU8() != OPACITY_TRANSPARENT_U8) {
+            KisPaintDeviceSP frameDevice = new KisPaintDevice(sourceDevice->colorSpace());
+            KisPainter gcFrame(frameDevice);
+            gcFrame.setChannelFlags(sourceDevice->colorSpace()->channelFlags(true, false));
+            gcFrame.setOpacity(tintFactor);
+
+            tryCompositeFrame(keyframe, gcFrame, gcDest, tintSource, opacity, rect);
+            return;
+        }
+
+        TintedFrame tinted = usedFrames.contains(frameId) ? usedFrames.value(frameId) : tintedFrames.take(frameId);
+
+        KisDataManagerSP dataManager = frames->frameDataManager(frameId);
+        const QPoint offset = frames->frameOffset(frameId);
+
+        QVector<QPoint> changedTiles;
+        const bool isValid =
+            tinted.device &&
+            tinted.dataManager == dataManager &&
+            tinted.offset == offset &&
+            tinted.configSeqNo == configSeqNo &&
+            tinted.isForward == isForward &&
+            *tinted.device->colorSpace() == *sourceDevice->colorSpace() &&
+            dataManager->changedTilesSince(tinted.revision, &changedTiles) &&
+            changedTiles.isEmpty();
+
+        if (!isValid) {
+            tinted.dataManager = dataManager;
+            tinted.revision = dataManager->takeChangeRevision();
+            tinted.offset = offset;
+            tinted.configSeqNo = configSeqNo;
+            tinted.isForward = isForward;
+            tinted.device = new KisPaintDevice(sourceDevice->colorSpace());
+
+            keyframe->writeFrameToDevice(tinted.device);
+
+            KisPainter gcFrame(tinted.device);
+            gcFrame.setChannelFlags(sourceDevice->colorSpace()->channelFlags(true, false));
+            gcFrame.setOpacity(tintFactor);
+
+            const QRect frameRect = tinted.device->extent();
+            gcFrame.bitBlt(frameRect.topLeft(), tintSource, frameRect);
+        }
+
+        usedFrames.insert(frameId, tinted);
+
+        gcDest.setOpacity(opacity);
+        gcDest.bitBlt(rect.topLeft(), tinted.device, rect);
+    }
+
     void refreshConfig()
     {
         KisImageConfig config(true);
@@ -124,7 +230,8 @@ void KisOnionSkinCompositor::setColorLabelFilter(QList<int> colors)
     m_d->colorLabelFilter = colors;
 }
 
-void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect& rect)
+void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect& rect,
+                                       TintedFramesCache *tintedFrames)
 {
     KisRasterKeyframeChannel *keyframes = sourceDevice->keyframeChannel();
 
@@ -151,10 +258,23 @@ void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisP
 
     keyframeTimeBck = keyframeTimeFwd = keyframes->activeKeyframeTime(time);
 
+    const bool useTintedFrames = tintedFrames;
+
+    // the frames that have scrolled out of the onion skins are dropped
+    QHash<int, TintedFrame> usedFrames;
+
     for (int offset = 1; offset <= m_d->numberOfSkins; offset++) {
         KisRasterKeyframeSP backKeyframe = m_d->getNextFrameToComposite(keyframes, keyframeTimeBck, true);
         KisRasterKeyframeSP forwardKeyframe = m_d->getNextFrameToComposite(keyframes, keyframeTimeFwd, false);
 
+        if (useTintedFrames) {
+            m_d->tryCompositeCachedFrame(sourceDevice, backKeyframe, false, gcDest, backwardTintDevice, m_d->skinOpacity(-offset),
+                                         rect, tintedFrames->m_d->frames, usedFrames);
+            m_d->tryCompositeCachedFrame(sourceDevice, forwardKeyframe, true, gcDest, forwardTintDevice, m_d->skinOpacity(offset),
+                                         rect, tintedFrames->m_d->frames, usedFrames);
+            continue;
+        }
+
         if (!backKeyframe.isNull()) {
             m_d->tryCompositeFrame(backKeyframe, gcFrame, gcDest, backwardTintDevice, m_d->skinOpacity(-offset), rect);
         }
@@ -164,6 +284,9 @@ void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisP
         }
     }
 
+    if (useTintedFrames) {
+        tintedFrames->m_d->frames = usedFrames;
+    }
 }
 
 QRect KisOnionSkinCompositor::calculateFullExtent(const KisPaintDeviceSP device)
@@ -14,12 +14,41 @@ class KRITAIMAGE_EXPORT KisOnionSkinCompositor : public QObject
 {
     Q_OBJECT
 
+public:
+    /**
+     * Keeps the tinted copies of the frames of a device between the calls
+     * of composite(), so that a frame is tinted again only when its content
+     * or the onion skin settings change. It is not thread-safe, the owner
+     * should guard it.
+     */
+    class KRITAIMAGE_EXPORT TintedFramesCache
+    {
+    public:
+        TintedFramesCache();
+        ~TintedFramesCache();
+
+        void clear();
+
+    private:
+        Q_DISABLE_COPY(TintedFramesCache)
+
+        friend class KisOnionSkinCompositor;
+        struct Private;
+        const QScopedPointer<Private> m_d;
+    };
+
 public:
     KisOnionSkinCompositor();
     ~KisOnionSkinCompositor() override;
     static KisOnionSkinCompositor *instance();
 
-    void composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect &rect);
+    /**
+     * Composites the onion skins of \p sourceDevice into \p targetDevice. If
+     * \p tintedFrames is not null, the tinted frames are taken from it and
+     * the ones that are not there are added to it.
+     */
+    void composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect &rect,
+                   TintedFramesCache *tintedFrames = 0);
 
     QRect calculateFullExtent(const KisPaintDeviceSP device);
     QRect calculateExtent(const KisPaintDeviceSP device);
@@ -12,6 +12,8 @@
 #include <QImage>
 #include <QList>
 #include <QHash>
+#include <QMap>
+#include <QMutex>
 #include <QIODevice>
 #include <qmath.h>
 #include <KisRegion.h>
@@ -67,6 +69,24 @@ static KisPaintDeviceSPStaticRegistrar __registrar;
 
 
 
+namespace Impl
+{
+
+/**
+ * The exact bounds of the content of the tiles of a data manager,
+ * stored in the coordinates of the data manager. The entries of the
+ * tiles changed since \p revision are outdated.
+ */
+struct ExactTileBoundsCache {
+    QMutex mutex;
+    KisWeakSharedPtr<KisDataManager> dataManager;
+    int revision = -1;
+    bool nonDefaultOnly = false;
+    QHash<qint64, QRect> tileBounds;
+};
+
+}
+
 struct KisPaintDevice::Private
 {
     /**
@@ -100,7 +120,7 @@ public:
     KisPaintDeviceStrategy* currentStrategy();
 
     void init(const KoColorSpace *cs, const quint8 *defaultPixel);
-    void convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand);
+    void convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KisRunnableStrokeJobsInterface *jobsInterface);
     bool assignProfile(const KoColorProfile * profile, KUndo2Command *parentCommand);
 
     KUndo2Command* reincarnateWithDetachedHistory(bool copyContent);
@@ -137,6 +157,11 @@ public:
         return currentData()->cache();
     }
 
+    inline Impl::ExactTileBoundsCache& exactTileBoundsCache() const
+    {
+        return m_exactTileBoundsCache;
+    }
+
     inline KisIteratorCompleteListener* cacheInvalidator() {
         return currentData()->cacheInvalidator();
     }
@@ -364,16 +389,29 @@ public:
         data->setY(offset.y());
     }
 
+    bool frameContentEquals(int frameId, int otherFrameId)
+    {
+        DataSP data = m_frames[frameId];
+        DataSP otherData = m_frames[otherFrameId];
+        KIS_ASSERT_RECOVER(data && otherData) { return false; }
+
+        return data->x() == otherData->x() &&
+            data->y() == otherData->y() &&
+            *data->colorSpace() == *otherData->colorSpace() &&
+            data->dataManager()->hasSameContent(otherData->dataManager().data());
+    }
+
     const QList<int> frameIds() const
     {
         return m_frames.keys();
     }
 
-    bool readFrame(QIODevice *stream, int frameId)
+    bool readFrame(QIODevice *stream, int frameId, bool keepCompressed)
     {
         bool retval = false;
-        DataSP data = m_frames[frameId];
-        retval = data->dataManager()->read(stream);
+        // the frames of the same device may be read concurrently
+        DataSP data = m_frames.value(frameId);
+        retval = data->dataManager()->read(stream, keepCompressed);
         data->cache()->invalidate();
         return retval;
     }
@@ -405,10 +443,12 @@ public:
     void uploadFrameData(DataSP srcData, DataSP dstData);
 
     struct LodDataStructImpl;
-    LodDataStruct* createLodDataStruct(int lod);
+    LodDataStruct* createLodDataStruct(int lod, bool incremental);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
     KisRegion regionForLodSyncing() const;
+    KisRegion regionForLodSyncing(LodDataStruct *dst) const;
+    bool calculateLodChangedRegion(Data *srcData, KisRegion *region) const;
 
     void updateLodDataManager(KisDataManager *srcDataManager,
                               KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
@@ -553,6 +593,35 @@ private:
                *colorSpace() == *srcData->colorSpace();
     }
 
+    qint64 estimateHistoryMemorySize() const {
+        qint64 numTiles = 0;
+
+        Q_FOREACH (Data *data, allDataObjects()) {
+            if (!data) continue;
+            numTiles += data->dataManager()->numHistoricalTiles();
+        }
+
+        return numTiles * KisTileData::WIDTH * KisTileData::HEIGHT * q->pixelSize();
+    }
+
+    void releaseLodData() {
+        KIS_SAFE_ASSERT_RECOVER_RETURN(!defaultBounds->currentLevelOfDetail());
+
+        QMutexLocker l(&m_dataSwitchLock);
+        m_lodData.reset();
+    }
+
+    qint32 swapOutData() {
+        qint32 numTiles = 0;
+
+        Q_FOREACH (Data *data, allDataObjects()) {
+            if (!data) continue;
+            numTiles += data->dataManager()->swapOutTiles();
+        }
+
+        return numTiles;
+    }
+
     QList<Data*> allDataObjects() const
     {
         QList<Data*> dataObjects;
@@ -585,6 +654,21 @@ private:
     mutable QScopedPointer<Data> m_externalFrameData;
     mutable QMutex m_dataSwitchLock;
 
+    /**
+     * The state of the source and LOD data managers at the moment
+     * of the last LOD synchronization. The tiles changed since then
+     * are the only ones that need to be regenerated on the next sync.
+     */
+    struct LodSyncState {
+        KisWeakSharedPtr<KisDataManager> srcDataManager;
+        KisWeakSharedPtr<KisDataManager> lodDataManager;
+        int srcRevision = -1;
+        int lodRevision = -1;
+    };
+    LodSyncState m_lodSyncState;
+
+    mutable Impl::ExactTileBoundsCache m_exactTileBoundsCache;
+
     FramesHash m_frames;
     int m_nextFreeFrameId;
 };
@@ -664,6 +748,10 @@ struct KisPaintDevice::Private::StrategyPolicy {
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
     LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
     QScopedPointer<Data> lodData;
+
+    KisRegion syncRegion;
+    KisWeakSharedPtr<KisDataManager> srcDataManager;
+    int srcRevision = -1;
 };
 
 KisRegion KisPaintDevice::Private::regionForLodSyncing() const
@@ -672,18 +760,106 @@ KisRegion KisPaintDevice::Private::regionForLodSyncing() const
     return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
 }
 
-KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
+KisRegion KisPaintDevice::Private::regionForLodSyncing(LodDataStruct *_dst) const
+{
+    LodDataStructImpl *dst = dynamic_cast<LodDataStructImpl*>(_dst);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(dst, regionForLodSyncing());
+
+    return dst->syncRegion;
+}
+
+bool KisPaintDevice::Private::calculateLodChangedRegion(Data *srcData, KisRegion *region) const
+{
+    if (!m_lodData ||
+        m_lodSyncState.srcRevision < 0 ||
+        !(m_lodSyncState.srcDataManager == srcData->dataManager().data()) ||
+        !(m_lodSyncState.lodDataManager == m_lodData->dataManager().data())) {
+
+        return false;
+    }
+
+    const int lod = m_lodData->levelOfDetail();
+
+    QVector<QPoint> srcTiles;
+    QVector<QPoint> lodTiles;
+
+    if (!srcData->dataManager()->changedTilesSince(m_lodSyncState.srcRevision, &srcTiles) ||
+        !m_lodData->dataManager()->changedTilesSince(m_lodSyncState.lodRevision, &lodTiles)) {
+
+        return false;
+    }
+
+    QVector<QRect> rects;
+    rects.reserve(srcTiles.size() + lodTiles.size());
+
+    Q_FOREACH (const QPoint &tile, srcTiles) {
+        rects << QRect(tile.x() * KisTileData::WIDTH, tile.y() * KisTileData::HEIGHT,
+                       KisTileData::WIDTH, KisTileData::HEIGHT)
+            .translated(srcData->x(), srcData->y());
+    }
+
+    /**
+     * LodN strokes paint on the LOD plane directly, so the areas
+     * they touched should be regenerated from the source as well
+     */
+    Q_FOREACH (const QPoint &tile, lodTiles) {
+        const QRect lodRect =
+            QRect(tile.x() * KisTileData::WIDTH, tile.y() * KisTileData::HEIGHT,
+                  KisTileData::WIDTH, KisTileData::HEIGHT)
+            .translated(m_lodData->x(), m_lodData->y());
+
+        rects << KisLodTransform::upscaledRect(lodRect, lod);
+    }
+
+    *region = KisRegion::fromOverlappingRects(rects, KisTileData::WIDTH);
+    return true;
+}
+
+KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod, bool incremental)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(newLod > 0);
 
     Data *srcData = currentNonLodData();
 
-    Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
-
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
     int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
 
+    /**
+     * LOD planes are synchronized by a LodN stroke, so nobody writes
+     * into the LOD0 data concurrently and the current revision can be
+     * skipped.
+     */
+    KisWeakSharedPtr<KisDataManager> srcDataManager = srcData->dataManager().data();
+    const int srcRevision = srcData->dataManager()->takeChangeRevision() + 1;
+
+    /**
+     * If the current LOD plane is still compatible with the source,
+     * we can start from its content and regenerate only the tiles
+     * changed since the previous synchronization.
+     */
+    KisRegion changedRegion;
+    if (incremental &&
+        m_lodData &&
+        m_lodData->levelOfDetail() == newLod &&
+        m_lodData->colorSpace() == srcData->colorSpace() &&
+        m_lodData->x() == expectedX &&
+        m_lodData->y() == expectedY &&
+        calculateLodChangedRegion(srcData, &changedRegion)) {
+
+        LodDataStructImpl *lodStruct =
+            new LodDataStructImpl(new Data(q, m_lodData.data(), true));
+
+        lodStruct->syncRegion = changedRegion;
+        lodStruct->srcDataManager = srcDataManager;
+        lodStruct->srcRevision = srcRevision;
+        lodStruct->lodData->cache()->invalidate();
+
+        return lodStruct;
+    }
+
+    Data *lodData = new Data(q, srcData, false);
+    LodDataStructImpl *lodStruct = new LodDataStructImpl(lodData);
+
     /**
      * We compare color spaces as pure pointers, because they must be
      * exactly the same, since they come from the common source.
@@ -705,6 +881,10 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
 
     lodData->cache()->invalidate();
 
+    lodStruct->syncRegion = regionForLodSyncing();
+    lodStruct->srcDataManager = srcDataManager;
+    lodStruct->srcRevision = srcRevision;
+
     return lodStruct;
 }
 
@@ -844,6 +1024,16 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
 
     m_lodData->prepareClone(dst->lodData.data());
     m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+
+    m_lodSyncState.srcDataManager = dst->srcDataManager;
+    m_lodSyncState.srcRevision = dst->srcRevision;
+    m_lodSyncState.lodDataManager = m_lodData->dataManager().data();
+
+    /**
+     * Start a new revision of the LOD plane, so that our own writes
+     * are not reported as changes on the next synchronization
+     */
+    m_lodSyncState.lodRevision = m_lodData->dataManager()->takeChangeRevision() + 1;
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -978,7 +1168,7 @@ public:
     }
 };
 
-void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand)
+void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KisRunnableStrokeJobsInterface *jobsInterface)
 {
     QList<Data*> dataObjects = allDataObjects();
     if (dataObjects.isEmpty()) return;
@@ -989,7 +1179,7 @@ void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpa
     Q_FOREACH (Data *data, dataObjects) {
         if (!data) continue;
 
-        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand);
+        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand, jobsInterface);
     }
 
     q->emitColorSpaceChanged();
@@ -1187,6 +1377,26 @@ void KisPaintDevice::estimateMemoryStats(qint64 &imageData, qint64 &temporaryDat
     m_d->estimateMemoryStats(imageData, temporaryData, lodData);
 }
 
+qint64 KisPaintDevice::estimateHistoryMemorySize() const
+{
+    return m_d->estimateHistoryMemorySize();
+}
+
+void KisPaintDevice::releaseLodData()
+{
+    m_d->releaseLodData();
+}
+
+qint32 KisPaintDevice::swapOutData()
+{
+    return m_d->swapOutData();
+}
+
+qint32 KisPaintDevice::swapOutData(const QRect &rect)
+{
+    return m_d->dataManager()->swapOutTiles(rect.translated(-x(), -y()));
+}
+
 void KisPaintDevice::setParentNode(KisNodeWSP parent)
 {
     m_d->parent = parent;
@@ -1425,6 +1635,116 @@ QRect calculateExactBoundsImpl(const KisPaintDevice *device, const QRect &startR
                  boundBottom - boundTop + 1);
 }
 
+inline qint64 tileKey(qint32 col, qint32 row)
+{
+    return (qint64(row) << 32) | quint32(col);
+}
+
+/**
+ * Calculates the exact bounds from the border tiles of the device only.
+ * The tiles are scanned row by row (or column by column) from every side
+ * until a row containing a non-empty tile is found. The bounds of every
+ * scanned tile are cached till the tile is changed, so the next call
+ * rescans only the border tiles that have been painted on.
+ */
+template <class ComparePixelOp>
+QRect calculateExactBoundsFromTiles(const KisPaintDevice *device, ExactTileBoundsCache &cache,
+                                    bool nonDefaultOnly, ComparePixelOp compareOp)
+{
+    KisDataManagerSP dataManager = device->dataManager();
+    const QPoint offset(device->x(), device->y());
+
+    QMutexLocker l(&cache.mutex);
+
+    QVector<QPoint> changedTiles;
+
+    if (!(cache.dataManager == dataManager.data()) ||
+        cache.revision < 0 ||
+        cache.nonDefaultOnly != nonDefaultOnly ||
+        !dataManager->changedTilesSince(cache.revision, &changedTiles)) {
+
+        cache.tileBounds.clear();
+        changedTiles.clear();
+    }
+
+    Q_FOREACH (const QPoint &tile, changedTiles) {
+        cache.tileBounds.remove(tileKey(tile.x(), tile.y()));
+    }
+
+    cache.dataManager = dataManager.data();
+    cache.nonDefaultOnly = nonDefaultOnly;
+    cache.revision = dataManager->takeChangeRevision();
+
+    QMap<qint32, QVector<QPoint>> tilesByRow;
+    QMap<qint32, QVector<QPoint>> tilesByColumn;
+
+    Q_FOREACH (const QRect &rc, dataManager->region().rects()) {
+        const int firstColumn = qFloor(qreal(rc.left()) / KisTileData::WIDTH);
+        const int lastColumn = qFloor(qreal(rc.right()) / KisTileData::WIDTH);
+        const int firstRow = qFloor(qreal(rc.top()) / KisTileData::HEIGHT);
+        const int lastRow = qFloor(qreal(rc.bottom()) / KisTileData::HEIGHT);
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                tilesByRow[row].append(QPoint(column, row));
+                tilesByColumn[column].append(QPoint(column, row));
+            }
+        }
+    }
+
+    auto boundsOfTiles = [&] (const QVector<QPoint> &tiles) {
+        QRect bounds;
+
+        Q_FOREACH (const QPoint &tile, tiles) {
+            const qint64 key = tileKey(tile.x(), tile.y());
+            auto it = cache.tileBounds.find(key);
+
+            if (it == cache.tileBounds.end()) {
+                const QRect tileRect(tile.x() * KisTileData::WIDTH, tile.y() * KisTileData::HEIGHT,
+                                     KisTileData::WIDTH, KisTileData::HEIGHT);
+
+                const QRect tileBounds =
+                    calculateExactBoundsImpl(device, tileRect.translated(offset), QRect(), compareOp);
+
+                it = cache.tileBounds.insert(key, tileBounds.translated(-offset));
+            }
+
+            bounds |= *it;
+        }
+
+        return bounds;
+    };
+
+    QRect topBounds;
+    for (auto it = tilesByRow.constBegin(); it != tilesByRow.constEnd() && topBounds.isEmpty(); ++it) {
+        topBounds = boundsOfTiles(it.value());
+    }
+
+    if (topBounds.isEmpty()) {
+        return QRect();
+    }
+
+    QRect bottomBounds;
+    for (auto it = tilesByRow.constEnd(); it != tilesByRow.constBegin() && bottomBounds.isEmpty();) {
+        --it;
+        bottomBounds = boundsOfTiles(it.value());
+    }
+
+    QRect leftBounds;
+    for (auto it = tilesByColumn.constBegin(); it != tilesByColumn.constEnd() && leftBounds.isEmpty(); ++it) {
+        leftBounds = boundsOfTiles(it.value());
+    }
+
+    QRect rightBounds;
+    for (auto it = tilesByColumn.constEnd(); it != tilesByColumn.constBegin() && rightBounds.isEmpty();) {
+        --it;
+        rightBounds = boundsOfTiles(it.value());
+    }
+
+    return QRect(QPoint(leftBounds.left(), topBounds.top()),
+                 QPoint(rightBounds.right(), bottomBounds.bottom())).translated(offset);
+}
+
 }
 
 QRect KisPaintDevice::calculateExactBounds(bool nonDefaultOnly) const
@@ -1448,13 +1768,27 @@ QRect KisPaintDevice::calculateExactBounds(bool nonDefaultOnly) const
         }
     }
 
+    /**
+     * When the whole extent has to be scanned, only its border tiles are
+     * actually needed. The search outside the image bounds for the
+     * devices with non-transparent default pixel and the wrapped
+     * devices stay pixel-based.
+     */
+    const bool useTiles =
+        endRect.isEmpty() && startRect.isValid() &&
+        !m_d->defaultBounds->wrapAroundMode();
+
     if (nonDefaultOnly) {
         const KoColor defaultPixel = this->defaultPixel();
         Impl::CheckNonDefault compareOp(pixelSize(), defaultPixel.data());
-        endRect = Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
+        endRect = useTiles ?
+            Impl::calculateExactBoundsFromTiles(this, m_d->exactTileBoundsCache(), true, compareOp) :
+            Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
     } else {
         Impl::CheckFullyTransparent compareOp(m_d->colorSpace());
-        endRect = Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
+        endRect = useTiles ?
+            Impl::calculateExactBoundsFromTiles(this, m_d->exactTileBoundsCache(), false, compareOp) :
+            Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
     }
 
     return endRect;
@@ -1501,6 +1835,11 @@ void KisPaintDevice::purgeDefaultPixels()
     dm->purge(dm->extent());
 }
 
+void KisPaintDevice::shareUniformTiles(const QRect &rc)
+{
+    m_d->dataManager()->shareUniformTiles(rc.translated(-m_d->x(), -m_d->y()));
+}
+
 void KisPaintDevice::setDefaultPixel(const KoColor &defPixel)
 {
     KoColor color(defPixel);
@@ -1543,11 +1882,11 @@ bool KisPaintDevice::write(KisPaintDeviceWriter &store)
     return m_d->dataManager()->write(store);
 }
 
-bool KisPaintDevice::read(QIODevice *stream)
+bool KisPaintDevice::read(QIODevice *stream, bool keepCompressed)
 {
     bool retval;
 
-    retval = m_d->dataManager()->read(stream);
+    retval = m_d->dataManager()->read(stream, keepCompressed);
     m_d->cache()->invalidate();
 
     return retval;
@@ -1563,9 +1902,9 @@ void KisPaintDevice::emitProfileChanged()
     emit profileChanged(m_d->colorSpace()->profile());
 }
 
-void KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand)
+void KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KisRunnableStrokeJobsInterface *jobsInterface)
 {
-    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand);
+    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand, jobsInterface);
 }
 
 bool KisPaintDevice::setProfile(const KoColorProfile * profile, KUndo2Command *parentCommand)
@@ -2128,9 +2467,14 @@ KisRegion KisPaintDevice::regionForLodSyncing() const
     return m_d->regionForLodSyncing();
 }
 
-KisPaintDevice::LodDataStruct* KisPaintDevice::createLodDataStruct(int lod)
+KisRegion KisPaintDevice::regionForLodSyncing(LodDataStruct *dst) const
 {
-    return m_d->createLodDataStruct(lod);
+    return m_d->regionForLodSyncing(dst);
+}
+
+KisPaintDevice::LodDataStruct* KisPaintDevice::createLodDataStruct(int lod, bool incremental)
+{
+    return m_d->createLodDataStruct(lod, incremental);
 }
 
 void KisPaintDevice::updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect)
@@ -2193,6 +2537,11 @@ void KisPaintDeviceFramesInterface::uploadFrame(int dstFrameId, KisPaintDeviceSP
     q->m_d->uploadFrame(dstFrameId, srcDevice);
 }
 
+bool KisPaintDeviceFramesInterface::frameContentEquals(int frameId, int otherFrameId)
+{
+    return q->m_d->frameContentEquals(frameId, otherFrameId);
+}
+
 QRect KisPaintDeviceFramesInterface::frameBounds(int frameId)
 {
     return q->m_d->frameBounds(frameId);
@@ -2225,12 +2574,12 @@ bool KisPaintDeviceFramesInterface::writeFrame(KisPaintDeviceWriter &store, int
     return q->m_d->writeFrame(store, frameId);
 }
 
-bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId)
+bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId, bool keepCompressed)
 {
     KIS_ASSERT_RECOVER(frameId >= 0) {
         return false;
     }
-    return q->m_d->readFrame(stream, frameId);
+    return q->m_d->readFrame(stream, frameId, keepCompressed);
 }
 
 int KisPaintDeviceFramesInterface::currentFrameId() const
@@ -40,6 +40,7 @@ class KisKeyframe;
 class KisRasterKeyframeChannel;
 
 class KisPaintDeviceFramesInterface;
+class KisRunnableStrokeJobsInterface;
 
 typedef KisSharedPtr<KisDataManager> KisDataManagerSP;
 
@@ -120,8 +121,12 @@ public:
 
     /**
      * Fill this paint device with the pixels from the specified file store.
+     *
+     * If \p keepCompressed is true, the compressed pixels are put into
+     * the swap as they are and are decompressed on the first access, which
+     * is useful for the devices that will likely not be accessed soon.
      */
-    bool read(QIODevice *stream);
+    bool read(QIODevice *stream, bool keepCompressed = false);
 
 public:
 
@@ -279,6 +284,14 @@ public:
      */
     void purgeDefaultPixels();
 
+    /**
+     * Makes the tiles of \p rc that are filled with a single color share
+     * one tile data with all the other such tiles of that color. Mostly
+     * useful for hard-edged selections, whose interior and exterior are
+     * uniform. The pixels of the device are not changed.
+     */
+    void shareUniformTiles(const QRect &rc);
+
     /**
      * Sets the default pixel. New data will be initialised with this pixel. The pixel is copied: the
      * caller still owns the pointer and needs to delete it to avoid memory leaks.
@@ -471,11 +484,16 @@ public:
 
     /**
      * Converts the paint device to a different colorspace
+     *
+     * If \p jobsInterface is set, the pixels are converted by concurrent
+     * stroke jobs, one per row of tiles, that are added to the current
+     * stroke. The device must not be accessed until they are completed.
      */
     void convertTo(const KoColorSpace * dstColorSpace,
                    KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent(),
                    KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags(),
-                   KUndo2Command *parentCommand = 0);
+                   KUndo2Command *parentCommand = 0,
+                   KisRunnableStrokeJobsInterface *jobsInterface = 0);
 
     /**
      * Changes the profile of the colorspace of this paint device to the given
@@ -782,6 +800,39 @@ public:
 
     void estimateMemoryStats(qint64 &imageData, qint64 &temporaryData, qint64 &lodData) const;
 
+    /**
+     * \return an upper bound of the memory occupied by the undo
+     *         history of the device (all its frames included)
+     */
+    qint64 estimateHistoryMemorySize() const;
+
+    /**
+     * Frees the level of detail plane of the device. It will be
+     * regenerated on the next LoD synchronization.
+     *
+     * WARNING: the image must be locked with a barrier lock and
+     *          the device must be in LoD0 mode
+     */
+    void releaseLodData();
+
+    /**
+     * Moves all the tiles of the device into the swap, except the
+     * ones being accessed right now.
+     *
+     * \return the number of the tiles actually swapped out
+     */
+    qint32 swapOutData();
+
+    /**
+     * Moves the tiles of the current data object intersecting
+     * \p rect into the swap. Unlike swapOutData() it doesn't give
+     * recently accessed tiles a second chance. Used by the
+     * out-of-core processing to release already processed bands.
+     *
+     * \return the number of the tiles actually swapped out
+     */
+    qint32 swapOutData(const QRect &rect);
+
 public:
 
     KisHLineIteratorSP createHLineIteratorNG(qint32 x, qint32 y, qint32 w);
@@ -873,7 +924,25 @@ public:
     };
 
     KisRegion regionForLodSyncing() const;
-    LodDataStruct* createLodDataStruct(int lod);
+
+    /**
+     * \return the area of the device that should be passed to
+     *         updateLodDataStruct() to bring \p dst up to date. For an
+     *         incremental struct it covers only the tiles changed since
+     *         the previous upload.
+     */
+    KisRegion regionForLodSyncing(LodDataStruct *dst) const;
+
+    /**
+     * Creates a struct for regenerating the LOD plane of the device.
+     *
+     * If \p incremental is true and the current LOD plane is compatible
+     * with the source, the struct starts from its content, so only the
+     * tiles changed since the previous uploadLodDataStruct() are to be
+     * regenerated. Otherwise, the struct is empty and the whole device
+     * should be processed.
+     */
+    LodDataStruct* createLodDataStruct(int lod, bool incremental = false);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
 
@@ -10,34 +10,10 @@
 #include "KoAlwaysInline.h"
 #include "kundo2command.h"
 #include "kis_command_utils.h"
+#include "KisRunnableStrokeJobUtils.h"
+#include "KisRunnableStrokeJobsInterface.h"
 
 
-struct DirectDataAccessPolicy {
-    DirectDataAccessPolicy(KisDataManager *dataManager, KisIteratorCompleteListener *completionListener)
-        : m_dataManager(dataManager),
-          m_completionListener(completionListener){}
-
-
-    KisHLineConstIteratorSP createConstIterator(const QRect &rect) {
-        const int xOffset = 0;
-        const int yOffset = 0;
-        return new KisHLineIterator2(m_dataManager, rect.x(), rect.y(), rect.width(), xOffset, yOffset, false, m_completionListener);
-    }
-
-    KisHLineIteratorSP createIterator(const QRect &rect) {
-        const int xOffset = 0;
-        const int yOffset = 0;
-        return new KisHLineIterator2(m_dataManager, rect.x(), rect.y(), rect.width(), xOffset, yOffset, true, m_completionListener);
-    }
-
-    int pixelSize() const {
-        return m_dataManager->pixelSize();
-    }
-
-    KisDataManager *m_dataManager;
-    KisIteratorCompleteListener *m_completionListener;
-};
-
 class KisPaintDeviceData
 {
 public:
@@ -152,10 +128,7 @@ public:
         }
     }
 
-    void convertDataColorSpace(const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand) {
-        typedef KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy> InternalSequentialConstIterator;
-        typedef KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy> InternalSequentialIterator;
-
+    void convertDataColorSpace(const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KisRunnableStrokeJobsInterface *jobsInterface = 0) {
         if (m_colorSpace == dstColorSpace || *m_colorSpace == *dstColorSpace) {
             return;
         }
@@ -171,26 +144,99 @@ public:
 
 
         if (!rc.isEmpty()) {
-            InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), rc);
-            InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager.data(), cacheInvalidator()), rc);
-
-            int nConseqPixels = srcIt.nConseqPixels();
-
-            // since we are accessing data managers directly, the columns are always aligned
-            KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
-
-            while(srcIt.nextPixels(nConseqPixels) &&
-                  dstIt.nextPixels(nConseqPixels)) {
-
-                nConseqPixels = srcIt.nConseqPixels();
-
-                const quint8 *srcData = srcIt.rawDataConst();
-                quint8 *dstData = dstIt.rawData();
-
-                m_colorSpace->convertPixelsTo(srcData, dstData,
-                                              dstColorSpace,
-                                              nConseqPixels,
-                                              renderingIntent, conversionFlags);
+            const KoColorSpace *srcColorSpace = m_colorSpace;
+            KisDataManagerSP srcDataManager = m_dataManager;
+            KisIteratorCompleteListener *completionListener = cacheInvalidator();
+
+            auto convertRect =
+                [srcColorSpace, dstColorSpace, srcDataManager, dstDataManager,
+                 completionListener, renderingIntent, conversionFlags] (const QRect &rc) {
+
+                KisRandomConstAccessorSP srcIt =
+                    new KisRandomAccessor2(srcDataManager.data(), 0, 0, false, completionListener);
+                KisRandomAccessorSP dstIt =
+                    new KisRandomAccessor2(dstDataManager.data(), 0, 0, true, completionListener);
+
+                const qint32 srcPixelSize = srcColorSpace->pixelSize();
+                const qint32 dstPixelSize = dstColorSpace->pixelSize();
+
+                qint32 rowsRemaining = rc.height();
+                qint32 y = rc.y();
+
+                while (rowsRemaining > 0) {
+                    // since we are accessing data managers directly, the tiles are always aligned
+                    const qint32 rows = qMin(srcIt->numContiguousRows(y), rowsRemaining);
+
+                    qint32 columnsRemaining = rc.width();
+                    qint32 x = rc.x();
+
+                    while (columnsRemaining > 0) {
+                        const qint32 columns = qMin(srcIt->numContiguousColumns(x), columnsRemaining);
+
+                        srcIt->moveTo(x, y);
+                        dstIt->moveTo(x, y);
+
+                        const quint8 *srcData = srcIt->rawDataConst();
+                        quint8 *dstData = dstIt->rawData();
+                        const qint32 srcRowStride = srcIt->rowStride(x, y);
+                        const qint32 dstRowStride = dstIt->rowStride(x, y);
+
+                        /**
+                         * When the block spans the whole width of the tiles,
+                         * its rows are contiguous, so the entire block is
+                         * converted in one call
+                         */
+                        if (srcRowStride == columns * srcPixelSize &&
+                            dstRowStride == columns * dstPixelSize) {
+
+                            srcColorSpace->convertPixelsTo(srcData, dstData,
+                                                           dstColorSpace,
+                                                           columns * rows,
+                                                           renderingIntent, conversionFlags);
+                        } else {
+                            for (qint32 row = 0; row < rows; row++) {
+                                srcColorSpace->convertPixelsTo(srcData, dstData,
+                                                               dstColorSpace,
+                                                               columns,
+                                                               renderingIntent, conversionFlags);
+                                srcData += srcRowStride;
+                                dstData += dstRowStride;
+                            }
+                        }
+
+                        x += columns;
+                        columnsRemaining -= columns;
+                    }
+
+                    y += rows;
+                    rowsRemaining -= rows;
+                }
+            };
+
+            if (jobsInterface) {
+                /**
+                 * Every band covers its own row of tiles, so the jobs
+                 * never write into the same tile of the destination.
+                 * The data managers are swapped right now, but the
+                 * pixels are filled by the jobs later, so the caller
+                 * must not read the device until they are completed.
+                 */
+                QVector<KisRunnableStrokeJobDataBase*> jobs;
+
+                const int firstRow = std::floor(qreal(rc.top()) / KisTileData::HEIGHT);
+                const int lastRow = std::floor(qreal(rc.bottom()) / KisTileData::HEIGHT);
+
+                for (int row = firstRow; row <= lastRow; row++) {
+                    const QRect bandRect =
+                        rc & QRect(rc.x(), row * KisTileData::HEIGHT,
+                                   rc.width(), KisTileData::HEIGHT);
+
+                    KritaUtils::addJobConcurrent(jobs, std::bind(convertRect, bandRect));
+                }
+
+                jobsInterface->addRunnableJobs(jobs);
+            } else {
+                convertRect(rc);
             }
         }
 
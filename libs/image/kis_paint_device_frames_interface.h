@@ -62,6 +62,13 @@ public:
      */
     void uploadFrame(int dstFrameId, KisPaintDeviceSP srcDevice);
 
+    /**
+     * @return true if \p frameId and \p otherFrameId have the same
+     * offset and pixels. The frames sharing their tiles copy-on-write,
+     * e.g. a frame and its unchanged copy, are compared very quickly.
+     */
+    bool frameContentEquals(int frameId, int otherFrameId);
+
     /**
      * @return extent() of \p frameId
      */
@@ -92,8 +99,10 @@ public:
      *
      * NOTE: the frame must be created manually with createFrame()
      *       beforehand!
+     *
+     * \see KisPaintDevice::read() for \p keepCompressed
      */
-    bool readFrame(QIODevice *stream, int frameId);
+    bool readFrame(QIODevice *stream, int frameId, bool keepCompressed = false);
 
 
     /**
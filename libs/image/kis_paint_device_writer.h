@@ -8,11 +8,26 @@
 
 #include <kritaimage_export.h>
 
+class KisTileStreamCache;
+
 class KRITAIMAGE_EXPORT KisPaintDeviceWriter {
 public:
     virtual ~KisPaintDeviceWriter() {}
     virtual bool write(const QByteArray &data) = 0;
     virtual bool write(const char* data, qint64 length) = 0;
+
+    /**
+     * The cache of the compressed tiles written by the previous saves
+     * of the same document, or null if the tiles should be compressed
+     * from scratch
+     */
+    virtual KisTileStreamCache* tileStreamCache() const { return 0; }
+
+    /**
+     * If true, the tiles are written as they are, without compression.
+     * The stream is bigger, but can be written and read much faster.
+     */
+    virtual bool storeRawTiles() const { return false; }
 };
 
 
@@ -441,6 +441,14 @@ void KisPainter::addDirtyRects(const QVector<QRect> &rects)
     }
 }
 
+quint8* KisPainter::Private::reserveBuffer(QVector<quint8> &buffer, int size)
+{
+    if (buffer.size() < size) {
+        buffer.resize(size);
+    }
+    return buffer.data();
+}
+
 inline bool KisPainter::Private::tryReduceSourceRect(const KisPaintDevice *srcDev,
                                                      QRect *srcRect,
                                                      qint32 *srcX,
@@ -559,7 +567,7 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
     to the current paint device (d->device) */
     quint8* dstBytes = 0;
     try {
-        dstBytes = new quint8[srcWidth * srcHeight * d->device->pixelSize()];
+        dstBytes = d->reserveBuffer(d->dstBytesBuffer, srcWidth * srcHeight * d->device->pixelSize());
     } catch (const std::bad_alloc&) {
         warnKrita << "KisPainter::bitBltWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "dst bytes";
         return;
@@ -570,7 +578,7 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
     // Copy the relevant bytes of raw data from srcDev
     quint8* srcBytes = 0;
     try {
-        srcBytes = new quint8[srcWidth * srcHeight * srcDev->pixelSize()];
+        srcBytes = d->reserveBuffer(d->srcBytesBuffer, srcWidth * srcHeight * srcDev->pixelSize());
     } catch (const std::bad_alloc&) {
         warnKrita << "KisPainter::bitBltWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "src bytes";
         return;
@@ -604,7 +612,7 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
         quint32 totalBytes = srcWidth * srcHeight * selection->pixelSize();
         quint8* mergedSelectionBytes = 0;
         try {
-            mergedSelectionBytes = new quint8[ totalBytes ];
+            mergedSelectionBytes = d->reserveBuffer(d->selectionBytesBuffer, totalBytes);
         } catch (const std::bad_alloc&) {
             warnKrita << "KisPainter::bitBltWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "total bytes";
             return;
@@ -637,14 +645,10 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
         d->paramInfo.rows          = srcHeight;
         d->paramInfo.cols          = srcWidth;
         d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
-        delete[] mergedSelectionBytes;
     }
 
     d->device->writeBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
 
-    delete[] dstBytes;
-    delete[] srcBytes;
-
     addDirtyRect(QRect(dstX, dstY, srcWidth, srcHeight));
 }
 
@@ -969,7 +973,7 @@ void KisPainter::bltFixed(qint32 dstX, qint32 dstY,
     to the current paint device (aka: d->device) */
     quint8* dstBytes = 0;
     try {
-         dstBytes = new quint8[srcWidth * srcHeight * d->device->pixelSize()];
+         dstBytes = d->reserveBuffer(d->dstBytesBuffer, srcWidth * srcHeight * d->device->pixelSize());
     } catch (const std::bad_alloc&) {
         warnKrita << "KisPainter::bltFixed std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "total bytes";
         return;
@@ -994,10 +998,9 @@ void KisPainter::bltFixed(qint32 dstX, qint32 dstY,
         KisPaintDeviceSP selectionProjection(d->selection->projection());
         quint8* selBytes = 0;
         try {
-            selBytes = new quint8[srcWidth * srcHeight * selectionProjection->pixelSize()];
+            selBytes = d->reserveBuffer(d->selectionBytesBuffer, srcWidth * srcHeight * selectionProjection->pixelSize());
         }
         catch (const std::bad_alloc&) {
-            delete[] dstBytes;
             return;
         }
 
@@ -1010,9 +1013,6 @@ void KisPainter::bltFixed(qint32 dstX, qint32 dstY,
     d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
     d->device->writeBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
 
-    delete[] d->paramInfo.maskRowStart;
-    delete[] dstBytes;
-
     addDirtyRect(QRect(dstX, dstY, srcWidth, srcHeight));
 }
 
@@ -1056,7 +1056,7 @@ void KisPainter::bltFixedWithFixedSelection(qint32 dstX, qint32 dstY,
     to the current paint device (aka: d->device) */
     quint8* dstBytes = 0;
     try {
-        dstBytes = new quint8[srcWidth * srcHeight * d->device->pixelSize()];
+        dstBytes = d->reserveBuffer(d->dstBytesBuffer, srcWidth * srcHeight * d->device->pixelSize());
     } catch (const std::bad_alloc&) {
         warnKrita << "KisPainter::bltFixedWithFixedSelection std::bad_alloc for " << srcWidth << " * " << srcHeight << " * " << d->device->pixelSize() << "total bytes";
         return;
@@ -1087,10 +1087,9 @@ void KisPainter::bltFixedWithFixedSelection(qint32 dstX, qint32 dstY,
         quint32 totalBytes = srcWidth * srcHeight * selection->pixelSize();
         quint8 * mergedSelectionBytes = 0;
         try {
-            mergedSelectionBytes = new quint8[ totalBytes ];
+            mergedSelectionBytes = d->reserveBuffer(d->selectionBytesBuffer, totalBytes);
         } catch (const std::bad_alloc&) {
             warnKrita << "KisPainter::bltFixedWithFixedSelection std::bad_alloc for " << totalBytes << "total bytes";
-            delete[] dstBytes;
             return;
         }
         d->selection->projection()->readBytes(mergedSelectionBytes, dstX, dstY, srcWidth, srcHeight);
@@ -1120,14 +1119,10 @@ void KisPainter::bltFixedWithFixedSelection(qint32 dstX, qint32 dstY,
         d->paramInfo.rows          = srcHeight;
         d->paramInfo.cols          = srcWidth;
         d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
-
-        delete[] mergedSelectionBytes;
     }
 
     d->device->writeBytes(dstBytes, dstX, dstY, srcWidth, srcHeight);
 
-    delete[] dstBytes;
-
     addDirtyRect(QRect(dstX, dstY, srcWidth, srcHeight));
 }
 
@@ -12,118 +12,91 @@
 #include "kis_random_accessor_ng.h"
 #include "KisRenderedDab.h"
 
-void KisPainter::Private::applyDevice(const QRect &applyRect,
-                                      const KisRenderedDab &dab,
-                                      KisRandomAccessorSP dstIt,
-                                      const KoColorSpace *srcColorSpace,
-                                      KoCompositeOp::ParameterInfo &localParamInfo)
+void KisPainter::Private::applyDevicesTileGrouped(const QRect &applyRect,
+                                                  const QList<KisRenderedDab> &devices,
+                                                  KisRandomAccessorSP dstIt,
+                                                  KisRandomConstAccessorSP maskIt,
+                                                  const KoColorSpace *srcColorSpace,
+                                                  KoCompositeOp::ParameterInfo &localParamInfo)
 {
-    const QRect dabRect = dab.realBounds();
-    const QRect rc = applyRect & dabRect;
+    /**
+     * The area is walked tile by tile, and all the dabs overlapping a
+     * tile are composited while the tile is fetched. That is, every tile
+     * is locked only once for the whole batch of dabs and stays in the
+     * processor cache while the dabs are blended into it. The dabs are
+     * still applied to every pixel in their original order.
+     */
 
     const int srcPixelSize = srcColorSpace->pixelSize();
-    const int dabRowStride = srcPixelSize * dabRect.width();
+    const int dstPixelSize = device->pixelSize();
+    const int maskPixelSize = maskIt ? selection->projection()->pixelSize() : 0;
 
-
-    qint32 dstY = rc.y();
-    qint32 rowsRemaining = rc.height();
-
-    while (rowsRemaining > 0) {
-        qint32 dstX = rc.x();
-
-        qint32 numContiguousDstRows = dstIt->numContiguousRows(dstY);
-        qint32 rows = qMin(rowsRemaining, numContiguousDstRows);
-
-        qint32 columnsRemaining = rc.width();
-
-        while (columnsRemaining > 0) {
-
-            qint32 numContiguousDstColumns = dstIt->numContiguousColumns(dstX);
-            qint32 columns = qMin(numContiguousDstColumns, columnsRemaining);
-
-            qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
-            dstIt->moveTo(dstX, dstY);
-
-            localParamInfo.dstRowStart   = dstIt->rawData();
-            localParamInfo.dstRowStride  = dstRowStride;
-            localParamInfo.maskRowStart  = 0;
-            localParamInfo.maskRowStride = 0;
-            localParamInfo.rows          = rows;
-            localParamInfo.cols          = columns;
-
-
-            const int dabX = dstX - dabRect.x();
-            const int dabY = dstY - dabRect.y();
-
-            localParamInfo.srcRowStart   = dab.device->constData() + dabX * srcPixelSize + dabY * dabRowStride;
-            localParamInfo.srcRowStride  = dabRowStride;
-            localParamInfo.setOpacityAndAverage(dab.opacity, dab.averageOpacity);
-            localParamInfo.flow = dab.flow;
-            colorSpace->bitBlt(srcColorSpace, localParamInfo, compositeOp, renderingIntent, conversionFlags);
-
-            dstX += columns;
-            columnsRemaining -= columns;
-        }
-
-        dstY += rows;
-        rowsRemaining -= rows;
+    QVector<QRect> dabRects;
+    dabRects.reserve(devices.size());
+    Q_FOREACH (const KisRenderedDab &dab, devices) {
+        dabRects.append(dab.realBounds());
     }
 
-}
-
-void KisPainter::Private::applyDeviceWithSelection(const QRect &applyRect,
-                                                   const KisRenderedDab &dab,
-                                                   KisRandomAccessorSP dstIt,
-                                                   KisRandomConstAccessorSP maskIt,
-                                                   const KoColorSpace *srcColorSpace,
-                                                   KoCompositeOp::ParameterInfo &localParamInfo)
-{
-    const QRect dabRect = dab.realBounds();
-    const QRect rc = applyRect & dabRect;
-
-    const int srcPixelSize = srcColorSpace->pixelSize();
-    const int dabRowStride = srcPixelSize * dabRect.width();
-
-
-    qint32 dstY = rc.y();
-    qint32 rowsRemaining = rc.height();
+    qint32 dstY = applyRect.y();
+    qint32 rowsRemaining = applyRect.height();
 
     while (rowsRemaining > 0) {
-        qint32 dstX = rc.x();
+        qint32 dstX = applyRect.x();
 
-        qint32 numContiguousDstRows = dstIt->numContiguousRows(dstY);
-        qint32 numContiguousMaskRows = maskIt->numContiguousRows(dstY);
-        qint32 rows = qMin(rowsRemaining, qMin(numContiguousDstRows, numContiguousMaskRows));
+        qint32 rows = qMin(rowsRemaining, dstIt->numContiguousRows(dstY));
+        if (maskIt) {
+            rows = qMin(rows, maskIt->numContiguousRows(dstY));
+        }
 
-        qint32 columnsRemaining = rc.width();
+        qint32 columnsRemaining = applyRect.width();
 
         while (columnsRemaining > 0) {
+            qint32 columns = qMin(columnsRemaining, dstIt->numContiguousColumns(dstX));
+            if (maskIt) {
+                columns = qMin(columns, maskIt->numContiguousColumns(dstX));
+            }
 
-            qint32 numContiguousDstColumns = dstIt->numContiguousColumns(dstX);
-            qint32 numContiguousMaskColumns = maskIt->numContiguousColumns(dstX);
-            qint32 columns = qMin(columnsRemaining, qMin(numContiguousDstColumns, numContiguousMaskColumns));
+            const QRect tileRect(dstX, dstY, columns, rows);
 
-            qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
-            qint32 maskRowStride = maskIt->rowStride(dstX, dstY);
             dstIt->moveTo(dstX, dstY);
-            maskIt->moveTo(dstX, dstY);
-
-            localParamInfo.dstRowStart   = dstIt->rawData();
-            localParamInfo.dstRowStride  = dstRowStride;
-            localParamInfo.maskRowStart  = maskIt->rawDataConst();
-            localParamInfo.maskRowStride = maskRowStride;
-            localParamInfo.rows          = rows;
-            localParamInfo.cols          = columns;
-
-
-            const int dabX = dstX - dabRect.x();
-            const int dabY = dstY - dabRect.y();
-
-            localParamInfo.srcRowStart   = dab.device->constData() + dabX * srcPixelSize + dabY * dabRowStride;
-            localParamInfo.srcRowStride  = dabRowStride;
-            localParamInfo.setOpacityAndAverage(dab.opacity, dab.averageOpacity);
-            localParamInfo.flow = dab.flow;
-            colorSpace->bitBlt(srcColorSpace, localParamInfo, compositeOp, renderingIntent, conversionFlags);
+            const qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
+            quint8 *dstTileStart = dstIt->rawData();
+
+            qint32 maskRowStride = 0;
+            const quint8 *maskTileStart = 0;
+            if (maskIt) {
+                maskIt->moveTo(dstX, dstY);
+                maskRowStride = maskIt->rowStride(dstX, dstY);
+                maskTileStart = maskIt->rawDataConst();
+            }
+
+            for (int i = 0; i < devices.size(); i++) {
+                const KisRenderedDab &dab = devices[i];
+                const QRect &dabRect = dabRects[i];
+                const QRect rc = tileRect & dabRect;
+
+                if (rc.isEmpty()) continue;
+
+                const int tileX = rc.x() - dstX;
+                const int tileY = rc.y() - dstY;
+
+                localParamInfo.dstRowStart   = dstTileStart + tileX * dstPixelSize + tileY * dstRowStride;
+                localParamInfo.dstRowStride  = dstRowStride;
+                localParamInfo.maskRowStart  = maskTileStart ? maskTileStart + tileX * maskPixelSize + tileY * maskRowStride : 0;
+                localParamInfo.maskRowStride = maskRowStride;
+                localParamInfo.rows          = rc.height();
+                localParamInfo.cols          = rc.width();
+
+                const int dabRowStride = srcPixelSize * dabRect.width();
+                const int dabX = rc.x() - dabRect.x();
+                const int dabY = rc.y() - dabRect.y();
+
+                localParamInfo.srcRowStart   = dab.device->constData() + dabX * srcPixelSize + dabY * dabRowStride;
+                localParamInfo.srcRowStride  = dabRowStride;
+                localParamInfo.setOpacityAndAverage(dab.opacity, dab.averageOpacity);
+                localParamInfo.flow = dab.flow;
+                colorSpace->bitBlt(srcColorSpace, localParamInfo, compositeOp, renderingIntent, conversionFlags);
+            }
 
             dstX += columns;
             columnsRemaining -= columns;
@@ -132,7 +105,6 @@ void KisPainter::Private::applyDeviceWithSelection(const QRect &applyRect,
         dstY += rows;
         rowsRemaining -= rows;
     }
-
 }
 
 void KisPainter::bltFixed(const QRect &applyRect, const QList<KisRenderedDab> allSrcDevices)
@@ -168,15 +140,7 @@ void KisPainter::bltFixed(const QRect &applyRect, const QList<KisRenderedDab> al
     KisRandomAccessorSP dstIt = d->device->createRandomAccessorNG();
     KisRandomConstAccessorSP maskIt = d->selection ? d->selection->projection()->createRandomConstAccessorNG() : 0;
 
-    if (maskIt) {
-        Q_FOREACH (const KisRenderedDab &dab, devices) {
-            d->applyDeviceWithSelection(rc, dab, dstIt, maskIt, srcColorSpace, localParamInfo);
-        }
-    } else {
-        Q_FOREACH (const KisRenderedDab &dab, devices) {
-            d->applyDevice(rc, dab, dstIt, srcColorSpace, localParamInfo);
-        }
-    }
+    d->applyDevicesTileGrouped(rc, devices, dstIt, maskIt, srcColorSpace, localParamInfo);
 
 
 #if 0
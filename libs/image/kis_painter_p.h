@@ -65,6 +65,18 @@ struct Q_DECL_HIDDEN KisPainter::Private {
     QScopedPointer<KisRunnableStrokeJobsInterface> fakeRunnableStrokeJobsInterface;
     QTransform                  patternTransform;
 
+    /**
+     * The intermediate buffers of the blitting functions. They are
+     * reused by all the dabs painted with this painter, so painting
+     * a dab doesn't allocate any memory unless it is bigger than all
+     * the previous ones.
+     */
+    QVector<quint8>             dstBytesBuffer;
+    QVector<quint8>             srcBytesBuffer;
+    QVector<quint8>             selectionBytesBuffer;
+
+    static quint8* reserveBuffer(QVector<quint8> &buffer, int size);
+
     bool tryReduceSourceRect(const KisPaintDevice *srcDev,
                              QRect *srcRect,
                              qint32 *srcX,
@@ -76,18 +88,12 @@ struct Q_DECL_HIDDEN KisPainter::Private {
 
     void fillPainterPathImpl(const QPainterPath& path, const QRect &requestedRect);
 
-    void applyDevice(const QRect &applyRect,
-                     const KisRenderedDab &dab,
-                     KisRandomAccessorSP dstIt,
-                     const KoColorSpace *srcColorSpace,
-                     KoCompositeOp::ParameterInfo &localParamInfo);
-
-    void applyDeviceWithSelection(const QRect &applyRect,
-                                  const KisRenderedDab &dab,
-                                  KisRandomAccessorSP dstIt,
-                                  KisRandomConstAccessorSP maskIt,
-                                  const KoColorSpace *srcColorSpace,
-                                  KoCompositeOp::ParameterInfo &localParamInfo);
+    void applyDevicesTileGrouped(const QRect &applyRect,
+                                 const QList<KisRenderedDab> &devices,
+                                 KisRandomAccessorSP dstIt,
+                                 KisRandomConstAccessorSP maskIt,
+                                 const KoColorSpace *srcColorSpace,
+                                 KoCompositeOp::ParameterInfo &localParamInfo);
 
     template<class T> QVector<T> calculateMirroredObjects(const T &object);
 
@@ -38,6 +38,13 @@ struct Q_DECL_HIDDEN KisPixelSelection::Private {
     bool outlineCacheValid;
     QMutex outlineCacheMutex;
 
+    /**
+     * Incremented on every invalidation, so that a recalculation that
+     * was overtaken by a change of the selection doesn't mark its stale
+     * result as valid
+     */
+    quint64 outlineCacheGeneration = 0;
+
     bool thumbnailImageValid;
     QImage thumbnailImage;
     QTransform thumbnailImageTransform;
@@ -139,6 +146,8 @@ void KisPixelSelection::select(const QRect & rc, quint8 selectedness)
 
 void KisPixelSelection::applySelection(KisPixelSelectionSP selection, SelectionAction action)
 {
+    QRect changedRect = selection->selectedRect();
+
     switch (action) {
     case SELECTION_REPLACE:
         clear();
@@ -151,14 +160,23 @@ void KisPixelSelection::applySelection(KisPixelSelectionSP selection, SelectionA
         subtractSelection(selection);
         break;
     case SELECTION_INTERSECT:
+        changedRect |= selectedRect();
         intersectSelection(selection);
         break;
     case SELECTION_SYMMETRICDIFFERENCE:
+        changedRect |= selectedRect();
         symmetricdifferenceSelection(selection);
         break;
     default:
         break;
     }
+
+    /**
+     * Most of the selections are hard-edged, so the composited tiles
+     * are usually either fully selected or fully deselected. Let them
+     * share the memory instead of keeping a copy per tile.
+     */
+    shareUniformTiles(changedRect);
 }
 
 void KisPixelSelection::copyAlphaFrom(KisPaintDeviceSP src, const QRect &processRect)
@@ -202,7 +220,13 @@ void KisPixelSelection::addSelection(KisPixelSelectionSP selection)
     m_d->outlineCacheValid &= selection->outlineCacheValid();
 
     if (m_d->outlineCacheValid) {
-        m_d->outlineCache += selection->outlineCache();
+        // uniting complex paths is expensive, but it is not needed
+        // when replacing the selection
+        if (m_d->outlineCache.isEmpty()) {
+            m_d->outlineCache = selection->outlineCache();
+        } else {
+            m_d->outlineCache += selection->outlineCache();
+        }
     }
 
     m_d->invalidateThumbnailImage();
@@ -453,17 +477,29 @@ void KisPixelSelection::invalidateOutlineCache()
 {
     QMutexLocker locker(&m_d->outlineCacheMutex);
     m_d->outlineCacheValid = false;
+    m_d->outlineCacheGeneration++;
     m_d->thumbnailImageValid = false;
 }
 
 void KisPixelSelection::recalculateOutlineCache()
 {
-    QMutexLocker locker(&m_d->outlineCacheMutex);
+    quint64 generation = 0;
 
-    m_d->outlineCache = QPainterPath();
+    {
+        QMutexLocker locker(&m_d->outlineCacheMutex);
+        generation = m_d->outlineCacheGeneration;
+    }
+
+    /**
+     * The outline of a complex selection may take a lot of time to
+     * generate, so it is done without holding the lock. Otherwise the
+     * GUI thread would block in outlineCacheValid() until the
+     * generation is finished.
+     */
+    QPainterPath cache;
 
     Q_FOREACH (const QPolygon &polygon, outline()) {
-        m_d->outlineCache.addPolygon(polygon);
+        cache.addPolygon(polygon);
 
         /**
          * The outline generation algorithm has a small bug, which
@@ -474,10 +510,15 @@ void KisPixelSelection::recalculateOutlineCache()
          *
          * \see KisSelectionTest::testOutlineGeneration()
          */
-        m_d->outlineCache.closeSubpath();
+        cache.closeSubpath();
     }
 
-    m_d->outlineCacheValid = true;
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+
+    if (generation == m_d->outlineCacheGeneration) {
+        m_d->outlineCache = cache;
+        m_d->outlineCacheValid = true;
+    }
 }
 
 bool KisPixelSelection::thumbnailImageValid() const
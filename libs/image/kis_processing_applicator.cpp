@@ -231,6 +231,7 @@ KisProcessingApplicator::KisProcessingApplicator(KisImageWSP image,
       m_node(node),
       m_flags(flags),
       m_emitSignals(emitSignals),
+      m_runnableJobsInterface(0),
       m_finalSignalsEmitted(false),
       m_sharedAllFramesToken(new bool(false))
 {
@@ -247,6 +248,11 @@ KisProcessingApplicator::KisProcessingApplicator(KisImageWSP image,
 
     strategy->setMacroId(macroId);
 
+    if (m_flags.testFlag(PARALLEL_TILE_BANDS)) {
+        // the strategy is owned by the stroke, which outlives the applicator
+        m_runnableJobsInterface = strategy->runnableJobsInterface();
+    }
+
     m_strokeId = m_image->startStroke(strategy);
     if(!m_emitSignals.isEmpty()) {
         applyCommand(new EmitImageSignalsCommand(m_image, m_emitSignals, false), KisStrokeJobData::BARRIER);
@@ -276,6 +282,10 @@ void KisProcessingApplicator::applyVisitor(KisProcessingVisitorSP visitor,
                                            KisStrokeJobData::Sequentiality sequentiality,
                                            KisStrokeJobData::Exclusivity exclusivity)
 {
+    if (m_runnableJobsInterface) {
+        visitor->setRunnableJobsInterface(m_runnableJobsInterface);
+    }
+
     KUndo2Command *initCommand = visitor->createInitCommand();
     if (initCommand) {
         applyCommand(initCommand,
@@ -297,6 +307,10 @@ void KisProcessingApplicator::applyVisitorAllFrames(KisProcessingVisitorSP visit
 {
     *m_sharedAllFramesToken = true;
 
+    if (m_runnableJobsInterface) {
+        visitor->setRunnableJobsInterface(m_runnableJobsInterface);
+    }
+
     KUndo2Command *initCommand = visitor->createInitCommand();
     if (initCommand) {
         applyCommand(initCommand,
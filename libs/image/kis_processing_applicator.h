@@ -16,6 +16,8 @@
 #include "kundo2commandextradata.h"
 
 
+class KisRunnableStrokeJobsInterface;
+
 class KRITAIMAGE_EXPORT KisProcessingApplicator
 {
 public:
@@ -24,7 +26,15 @@ public:
         RECURSIVE = 0x1,
         NO_UI_UPDATES = 0x2,
         SUPPORTS_WRAPAROUND_MODE = 0x4,
-        NO_IMAGE_UPDATES = 0x8
+        NO_IMAGE_UPDATES = 0x8,
+
+        /**
+         * Let the visitors split the processing of every node into
+         * concurrent jobs, e.g. one per band of tiles, so that a single
+         * huge layer could be processed by all the worker threads.
+         * \see KisProcessingVisitor::setRunnableJobsInterface()
+         */
+        PARALLEL_TILE_BANDS = 0x10
     };
 
     Q_DECLARE_FLAGS(ProcessingFlags, ProcessingFlag)
@@ -98,6 +108,7 @@ private:
     ProcessingFlags m_flags;
     KisImageSignalVector m_emitSignals;
     KisStrokeId m_strokeId;
+    KisRunnableStrokeJobsInterface *m_runnableJobsInterface;
     bool m_finalSignalsEmitted;
     QSharedPointer<bool> m_sharedAllFramesToken;
 };
@@ -28,6 +28,7 @@ class KisSelectionMask;
 class KisGeneratorLayer;
 class KisColorizeMask;
 class KUndo2Command;
+class KisRunnableStrokeJobsInterface;
 
 /**
  * A visitor that processes a single layer; it does not recurse into the
@@ -59,6 +60,18 @@ public:
      */
     virtual KUndo2Command* createInitCommand();
 
+    /**
+     * When the interface is set, the visitor may split the processing of
+     * a single node into concurrent jobs of the stroke it is executed in,
+     * e.g. one job per band of tiles. It is set by KisProcessingApplicator
+     * in KisProcessingApplicator::PARALLEL_TILE_BANDS mode.
+     */
+    void setRunnableJobsInterface(KisRunnableStrokeJobsInterface *interface);
+    KisRunnableStrokeJobsInterface* runnableJobsInterface() const;
+
+private:
+    KisRunnableStrokeJobsInterface *m_runnableJobsInterface = 0;
+
 public:
     class KRITAIMAGE_EXPORT ProgressHelper {
     public:
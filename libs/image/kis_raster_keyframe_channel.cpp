@@ -116,6 +116,13 @@ struct KisRasterKeyframeChannel::Private
     QMultiHash<int, int> frameIDTimesMap;
 
     QMap<int, QString> frameFilenames;
+
+    /** @brief The frames identical to another frame of the device, and the
+     * filenames of these source frames. Their pixel data is not stored in
+     * the file, the frames are recreated as copy-on-write copies of the
+     * source frames on loading. Updated on every save and load. */
+    QHash<int, QString> frameCopySources;
+
     QString filenameSuffix;
     bool onionSkinsEnabled;
 };
@@ -187,6 +194,14 @@ QString KisRasterKeyframeChannel::frameFilename(int frameId) const
     return m_d->frameFilenames.value(frameId, QString());
 }
 
+int KisRasterKeyframeChannel::frameCopySource(int frameId) const
+{
+    if (!m_d->frameCopySources.contains(frameId)) return -1;
+
+    const int sourceFrameId = m_d->frameFilenames.key(m_d->frameCopySources.value(frameId), -1);
+    return sourceFrameId != frameId ? sourceFrameId : -1;
+}
+
 void KisRasterKeyframeChannel::setFilenameSuffix(const QString &suffix)
 {
     m_d->filenameSuffix = suffix;
@@ -217,6 +232,7 @@ QString KisRasterKeyframeChannel::chooseFrameFilename(int frameId, const QString
 QDomElement KisRasterKeyframeChannel::toXML(QDomDocument doc, const QString &layerFilename)
 {
     m_d->frameFilenames.clear();
+    m_d->frameCopySources.clear();
 
     return KisKeyframeChannel::toXML(doc, layerFilename);
 }
@@ -224,6 +240,7 @@ QDomElement KisRasterKeyframeChannel::toXML(QDomDocument doc, const QString &lay
 void KisRasterKeyframeChannel::loadXML(const QDomElement &channelNode)
 {
     m_d->frameFilenames.clear();
+    m_d->frameCopySources.clear();
 
     KisKeyframeChannel::loadXML(channelNode);
 }
@@ -356,10 +373,31 @@ void KisRasterKeyframeChannel::saveKeyframe(KisKeyframeSP keyframe, QDomElement
 
     QString filename = frameFilename(frame);
     if (filename.isEmpty()) {
+        /**
+         * The duplicated frames often stay the same, e.g. holds drawn
+         * as separate keyframes, so look for an identical frame among
+         * the ones saved so far. The check is trivial for the tiles
+         * still shared copy-on-write with the source frame.
+         */
+        KisPaintDeviceFramesInterface *framesInterface = m_d->paintDevice->framesInterface();
+
+        for (auto it = m_d->frameFilenames.constBegin(); it != m_d->frameFilenames.constEnd(); ++it) {
+            if (!m_d->frameCopySources.contains(it.key()) &&
+                framesInterface->frameContentEquals(frame, it.key())) {
+
+                m_d->frameCopySources.insert(frame, it.value());
+                break;
+            }
+        }
+
         filename = chooseFrameFilename(frame, layerFilename);
     }
     keyframeElement.setAttribute("frame", filename);
 
+    if (m_d->frameCopySources.contains(frame)) {
+        keyframeElement.setAttribute("copyOf", m_d->frameCopySources.value(frame));
+    }
+
     QPoint offset = m_d->paintDevice->framesInterface()->frameOffset(frame);
     KisDomUtils::saveValue(&keyframeElement, "offset", offset);
 }
@@ -403,6 +441,10 @@ QPair<int, KisKeyframeSP> KisRasterKeyframeChannel::loadKeyframe(const QDomEleme
 
     setFrameFilename(keyframe->frameID(), frameFilename);
 
+    if (keyframeNode.hasAttribute("copyOf")) {
+        m_d->frameCopySources.insert(keyframe->frameID(), keyframeNode.attribute("copyOf"));
+    }
+
     return QPair<int, KisKeyframeSP>(time, keyframe);
 }
 
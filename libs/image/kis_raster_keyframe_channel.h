@@ -89,6 +89,14 @@ public:
     QRect frameExtents(KisKeyframeSP keyframe);
 
     QString frameFilename(int frameId) const;
+
+    /**
+     * @return the ID of the frame \p frameId is a copy of in the file
+     * being saved or loaded, or -1 if the frame has its own pixel data.
+     * The copies are not written into the file and should be recreated
+     * with uploadFrame() from their source frames on loading.
+     */
+    int frameCopySource(int frameId) const;
     /** When choosing filenames for frames, this will be appended to the node filename. */
     void setFilenameSuffix(const QString &suffix);
 
@@ -351,13 +351,17 @@ QRect KisSelectionBasedLayer::exactBounds() const
 
 QImage KisSelectionBasedLayer::createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectRatioMode)
 {
-    KisSelectionSP originalSelection = internalSelection();
-    KisPaintDeviceSP originalDevice = original();
+    KisPaintDeviceSP originalDevice = thumbnailSourceDevice();
 
-    return originalDevice && originalSelection ?
+    return originalDevice ?
            originalDevice->createThumbnail(w, h, aspectRatioMode, 1,
                                            KoColorConversionTransformation::internalRenderingIntent(),
                                            KoColorConversionTransformation::internalConversionFlags()) :
            QImage();
 }
 
+KisPaintDeviceSP KisSelectionBasedLayer::thumbnailSourceDevice() const
+{
+    return internalSelection() ? original() : KisPaintDeviceSP();
+}
+
@@ -161,6 +161,7 @@ public:
      * @return the thumbnail image created.
      */
     QImage createThumbnail(qint32 w, qint32 h, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio) override;
+    KisPaintDeviceSP thumbnailSourceDevice() const override;
 
 
 protected:
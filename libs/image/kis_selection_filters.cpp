@@ -7,17 +7,299 @@
 
 #include "kis_selection_filters.h"
 
+#include <algorithm>
+
+#include <QtConcurrent>
+
 #include <klocalizedstring.h>
 
 #include <KoColorSpace.h>
 #include "kis_convolution_painter.h"
 #include "kis_convolution_kernel.h"
 #include "kis_pixel_selection.h"
+#include "krita_utils.h"
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define RINT(x) floor ((x) + 0.5)
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAVE_SSE2_MORPHOLOGY
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HAVE_NEON_MORPHOLOGY
+#endif
+
+namespace {
+
+struct MaxOp {
+    static inline quint8 apply(quint8 a, quint8 b) {
+        return a > b ? a : b;
+    }
+#if defined HAVE_SSE2_MORPHOLOGY
+    static inline __m128i apply(__m128i a, __m128i b) {
+        return _mm_max_epu8(a, b);
+    }
+#elif defined HAVE_NEON_MORPHOLOGY
+    static inline uint8x16_t apply(uint8x16_t a, uint8x16_t b) {
+        return vmaxq_u8(a, b);
+    }
+#endif
+};
+
+struct MinOp {
+    static inline quint8 apply(quint8 a, quint8 b) {
+        return a < b ? a : b;
+    }
+#if defined HAVE_SSE2_MORPHOLOGY
+    static inline __m128i apply(__m128i a, __m128i b) {
+        return _mm_min_epu8(a, b);
+    }
+#elif defined HAVE_NEON_MORPHOLOGY
+    static inline uint8x16_t apply(uint8x16_t a, uint8x16_t b) {
+        return vminq_u8(a, b);
+    }
+#endif
+};
+
+/**
+ * dst[i] = op(a[i], b[i]). The destination may coincide with \p a
+ * as long as \p b does not lag behind it.
+ */
+template <class Op>
+inline void applyToRow(quint8 *dst, const quint8 *a, const quint8 *b, int numPixels)
+{
+    int i = 0;
+
+#if defined HAVE_SSE2_MORPHOLOGY
+    for (; i + 16 <= numPixels; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Op::apply(va, vb));
+    }
+#elif defined HAVE_NEON_MORPHOLOGY
+    for (; i + 16 <= numPixels; i += 16) {
+        vst1q_u8(dst + i, Op::apply(vld1q_u8(a + i), vld1q_u8(b + i)));
+    }
+#endif
+
+    for (; i < numPixels; i++) {
+        dst[i] = Op::apply(a[i], b[i]);
+    }
+}
+
+/**
+ * Writes the extremum of src[c - radius, c + radius] into
+ * dst[c - begin] for every c in [begin, end). The windows are
+ * combined from two overlapping power-of-two windows, which are
+ * built by doubling right in \p src, so its content is lost.
+ */
+template <class Op>
+void applyToWindows(quint8 *dst, quint8 *src, int begin, int end, int radius)
+{
+    const int windowSize = 2 * radius + 1;
+    quint8 *base = src + begin - radius;
+    int numPixels = end - begin + 2 * radius;
+    int length = 1;
+
+    while (2 * length <= windowSize) {
+        numPixels -= length;
+        applyToRow<Op>(base, base, base + length, numPixels);
+        length *= 2;
+    }
+
+    applyToRow<Op>(dst, src + begin - radius, src + begin + radius - length + 1, end - begin);
+}
+
+/**
+ * The elliptic structuring element of the grow and shrink filters
+ * (see computeBorder()) decomposed into a staircase of nested
+ * rectangles. The k-th rectangle spans [-widths[k], widths[k]] x
+ * [-heights[k], heights[k]], the heights decrease and the widths
+ * increase with k. The vertical extremum over the k-th rectangle is
+ * fetched with two lookups from the table of the extrema of
+ * 2^levels[k] rows.
+ */
+struct EllipseSteps
+{
+    EllipseSteps(const QVector<qint32> &circ, int _xRadius, int _yRadius)
+        : xRadius(_xRadius),
+          yRadius(_yRadius)
+    {
+        for (int i = 0; i <= xRadius; i++) {
+            const int height = circ[xRadius + i];
+
+            if (!heights.isEmpty() && heights.last() == height) {
+                widths.last() = i;
+            } else {
+                heights.append(height);
+                widths.append(i);
+            }
+        }
+
+        Q_FOREACH (int height, heights) {
+            int level = 0;
+            while ((2 << level) <= 2 * height + 1) {
+                level++;
+            }
+            levels.append(level);
+        }
+    }
+
+    int xRadius;
+    int yRadius;
+    QVector<int> widths;
+    QVector<int> heights;
+    QVector<int> levels;
+};
+
+/**
+ * Applies the morphological operation to a patch of \p width x \p height
+ * pixels. The source is padded by the radii of the structuring element
+ * on every side.
+ *
+ * The cost per pixel depends on the number of the steps of the ellipse
+ * instead of its area: every step costs a few passes over the row, and
+ * the steps are joined from the widest one inwards, so that each of them
+ * widens the accumulated row by the difference of the widths only.
+ */
+template <class Op>
+void processPatch(const quint8 *src, quint8 *dst, int width, int height, const EllipseSteps &steps)
+{
+    const int srcWidth = width + 2 * steps.xRadius;
+    const int srcHeight = height + 2 * steps.yRadius;
+    const int numSteps = steps.heights.size();
+    const int maxLevel = steps.levels.first();
+
+    QVector<QVector<quint8>> levels(maxLevel + 1);
+    QVector<quint8> work(srcWidth * srcHeight);
+    memcpy(work.data(), src, work.size());
+
+    int numRows = srcHeight;
+
+    for (int level = 0; level <= maxLevel; level++) {
+        if (level > 0) {
+            const int offset = (1 << (level - 1)) * srcWidth;
+            numRows -= 1 << (level - 1);
+
+            for (int row = 0; row < numRows; row++) {
+                quint8 *rowPtr = work.data() + row * srcWidth;
+                applyToRow<Op>(rowPtr, rowPtr, rowPtr + offset, srcWidth);
+            }
+        }
+
+        if (steps.levels.contains(level)) {
+            levels[level] = work.mid(0, numRows * srcWidth);
+        }
+    }
+
+    QVector<quint8> accumulator(srcWidth);
+    QVector<quint8> windows(srcWidth);
+
+    for (int y = 0; y < height; y++) {
+        const int centerRow = y + steps.yRadius;
+
+        for (int k = numSteps - 1; k >= 0; k--) {
+            const int stepHeight = steps.heights[k];
+            const int length = 1 << steps.levels[k];
+            const quint8 *levelPtr = levels[steps.levels[k]].constData();
+            const quint8 *topPtr = levelPtr + (centerRow - stepHeight) * srcWidth;
+            const quint8 *bottomPtr = levelPtr + (centerRow + stepHeight - length + 1) * srcWidth;
+
+            const int begin = steps.xRadius - steps.widths[k];
+            const int end = width + steps.xRadius + steps.widths[k];
+
+            if (k == numSteps - 1) {
+                applyToRow<Op>(accumulator.data() + begin, topPtr + begin, bottomPtr + begin, end - begin);
+            } else {
+                const int radius = steps.widths[k + 1] - steps.widths[k];
+                applyToWindows<Op>(windows.data(), accumulator.data(), begin, end, radius);
+                applyToRow<Op>(accumulator.data() + begin, windows.constData(), topPtr + begin, end - begin);
+                applyToRow<Op>(accumulator.data() + begin, accumulator.constData() + begin, bottomPtr + begin, end - begin);
+            }
+        }
+
+        quint8 *dstPtr = dst + y * width;
+
+        if (steps.widths.first() > 0) {
+            applyToWindows<Op>(dstPtr, accumulator.data(), steps.xRadius, width + steps.xRadius, steps.widths.first());
+        } else {
+            memcpy(dstPtr, accumulator.constData() + steps.xRadius, width);
+        }
+    }
+}
+
+/**
+ * Applies the morphological operation to \p rect of the selection in
+ * parallel patches. The pixels outside \p rect are either replaced with
+ * the nearest pixels of the rect (\p edgeLock) or considered to be
+ * unselected.
+ */
+template <class Op>
+void applyMorphology(KisPixelSelectionSP pixelSelection, const QRect &rect, const EllipseSteps &steps, bool edgeLock)
+{
+    const int xRadius = steps.xRadius;
+    const int yRadius = steps.yRadius;
+
+    // the patches are written in parallel, so read from a snapshot
+    KisPaintDeviceSP source = new KisPaintDevice(*pixelSelection);
+
+    const int patchSize = qBound(512, 4 * qMax(xRadius, yRadius), 2048);
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rect, QSize(patchSize, patchSize));
+
+    QtConcurrent::blockingMap(patches,
+        [&] (const QRect &patch) {
+            const QRect srcRect = patch.adjusted(-xRadius, -yRadius, xRadius, yRadius);
+            const QRect readRect = srcRect & rect;
+            const int srcWidth = srcRect.width();
+
+            QVector<quint8> src(srcWidth * srcRect.height(), MIN_SELECTED);
+            QVector<quint8> readBuffer(readRect.width() * readRect.height());
+            source->readBytes(readBuffer.data(), readRect);
+
+            const int left = readRect.x() - srcRect.x();
+            const int top = readRect.y() - srcRect.y();
+            const int right = left + readRect.width();
+            const int bottom = top + readRect.height();
+
+            for (int row = top; row < bottom; row++) {
+                quint8 *rowPtr = src.data() + row * srcWidth;
+                memcpy(rowPtr + left, readBuffer.constData() + (row - top) * readRect.width(), readRect.width());
+
+                if (edgeLock) {
+                    memset(rowPtr, rowPtr[left], left);
+                    memset(rowPtr + right, rowPtr[right - 1], srcWidth - right);
+                }
+            }
+
+            if (edgeLock) {
+                for (int row = 0; row < top; row++) {
+                    memcpy(src.data() + row * srcWidth, src.constData() + top * srcWidth, srcWidth);
+                }
+                for (int row = bottom; row < srcRect.height(); row++) {
+                    memcpy(src.data() + row * srcWidth, src.constData() + (bottom - 1) * srcWidth, srcWidth);
+                }
+            }
+
+            QVector<quint8> dst(patch.width() * patch.height());
+
+            const quint8 value = src.first();
+            if (std::find_if(src.constBegin(), src.constEnd(),
+                             [value] (quint8 v) { return v != value; }) == src.constEnd()) {
+
+                dst.fill(value);
+            } else {
+                processPatch<Op>(src.constData(), dst.data(), patch.width(), patch.height(), steps);
+            }
+
+            pixelSelection->writeBytes(dst.constData(), patch);
+        });
+}
+
+}
+
+
 KisSelectionFilter::~KisSelectionFilter()
 {
 }
@@ -559,108 +841,14 @@ void KisGrowSelectionFilter::process(KisPixelSelectionSP pixelSelection, const Q
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
     /**
-        * Much code resembles Shrink filter, so please fix bugs
-        * in both filters
-        */
-
-    quint8  **buf;  // caches the region's pixel data
-    quint8  **max;  // caches the largest values for each column
-
-    max = new quint8* [rect.width() + 2 * m_xRadius];
-    buf = new quint8* [m_yRadius + 1];
-    for (qint32 i = 0; i < m_yRadius + 1; i++) {
-        buf[i] = new quint8[rect.width()];
-    }
-    quint8* buffer = new quint8[(rect.width() + 2 * m_xRadius) *(m_yRadius + 1)];
-    for (qint32 i = 0; i < rect.width() + 2 * m_xRadius; i++) {
-        if (i < m_xRadius)
-            max[i] = buffer;
-        else if (i < rect.width() + m_xRadius)
-            max[i] = &buffer[(m_yRadius + 1) * (i - m_xRadius)];
-        else
-            max[i] = &buffer[(m_yRadius + 1) * (rect.width() + m_xRadius - 1)];
-
-        for (qint32 j = 0; j < m_xRadius + 1; j++)
-            max[i][j] = 0;
-    }
-    /* offset the max pointer by m_xRadius so the range of the array
-        is [-m_xRadius] to [region->w + m_xRadius] */
-    max += m_xRadius;
-
-    quint8* out = new quint8[ rect.width()];  // holds the new scan line we are computing
-
-    qint32* circ = new qint32[ 2 * m_xRadius + 1 ]; // holds the y coords of the filter's mask
-    computeBorder(circ, m_xRadius, m_yRadius);
-
-    /* offset the circ pointer by m_xRadius so the range of the array
-        is [-m_xRadius] to [m_xRadius] */
-    circ += m_xRadius;
-
-    memset(buf[0], 0, rect.width());
-    for (qint32 i = 0; i < m_yRadius && i < rect.height(); i++) { // load top of image
-        pixelSelection->readBytes(buf[i + 1], rect.x(), rect.y() + i, rect.width(), 1);
-    }
+     * Much code resembles Shrink filter, so please fix bugs
+     * in both filters
+     */
 
-    for (qint32 x = 0; x < rect.width() ; x++) { // set up max for top of image
-        max[x][0] = 0;         // buf[0][x] is always 0
-        max[x][1] = buf[1][x]; // MAX (buf[1][x], max[x][0]) always = buf[1][x]
-        for (qint32 j = 2; j < m_yRadius + 1; j++) {
-            max[x][j] = MAX(buf[j][x], max[x][j-1]);
-        }
-    }
-
-    for (qint32 y = 0; y < rect.height(); y++) {
-        rotatePointers(buf, m_yRadius + 1);
-        if (y < rect.height() - (m_yRadius))
-            pixelSelection->readBytes(buf[m_yRadius], rect.x(), rect.y() + y + m_yRadius, rect.width(), 1);
-        else
-            memset(buf[m_yRadius], 0, rect.width());
-        for (qint32 x = 0; x < rect.width(); x++) { /* update max array */
-            for (qint32 i = m_yRadius; i > 0; i--) {
-                max[x][i] = MAX(MAX(max[x][i - 1], buf[i - 1][x]), buf[i][x]);
-            }
-            max[x][0] = buf[0][x];
-        }
-        qint32 last_max = max[0][circ[-1]];
-        qint32 last_index = 1;
-        for (qint32 x = 0; x < rect.width(); x++) { /* render scan line */
-            last_index--;
-            if (last_index >= 0) {
-                if (last_max == 255)
-                    out[x] = 255;
-                else {
-                    last_max = 0;
-                    for (qint32 i = m_xRadius; i >= 0; i--)
-                        if (last_max < max[x + i][circ[i]]) {
-                            last_max = max[x + i][circ[i]];
-                            last_index = i;
-                        }
-                    out[x] = last_max;
-                }
-            } else {
-                last_index = m_xRadius;
-                last_max = max[x + m_xRadius][circ[m_xRadius]];
-                for (qint32 i = m_xRadius - 1; i >= -m_xRadius; i--)
-                    if (last_max < max[x + i][circ[i]]) {
-                        last_max = max[x + i][circ[i]];
-                        last_index = i;
-                    }
-                out[x] = last_max;
-            }
-        }
-        pixelSelection->writeBytes(out, rect.x(), rect.y() + y, rect.width(), 1);
-    }
-    /* undo the offsets to the pointers so we can free the malloced memory */
-    circ -= m_xRadius;
-    max -= m_xRadius;
+    QVector<qint32> circ(2 * m_xRadius + 1); // holds the y coords of the filter's mask
+    computeBorder(circ.data(), m_xRadius, m_yRadius);
 
-    delete[] circ;
-    delete[] buffer;
-    delete[] max;
-    for (qint32 i = 0; i < m_yRadius + 1; i++)
-        delete[] buf[i];
-    delete[] buf;
-    delete[] out;
+    applyMorphology<MaxOp>(pixelSelection, rect, EllipseSteps(circ, m_xRadius, m_yRadius), false);
 }
 
 
@@ -685,132 +873,16 @@ void KisShrinkSelectionFilter::process(KisPixelSelectionSP pixelSelection, const
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
-    /*
-        pretty much the same as fatten_region only different
-        blame all bugs in this function on jaycox@gimp.org
-    */
-    /* If edge_lock is true  we assume that pixels outside the region
-        we are passed are identical to the edge pixels.
-        If edge_lock is false, we assume that pixels outside the region are 0
-    */
-    quint8  **buf;  // caches the region's pixels
-    quint8  **max;  // caches the smallest values for each column
-    qint32    last_max, last_index;
-
-    max = new quint8* [rect.width() + 2 * m_xRadius];
-    buf = new quint8* [m_yRadius + 1];
-    for (qint32 i = 0; i < m_yRadius + 1; i++) {
-        buf[i] = new quint8[rect.width()];
-    }
-
-    qint32 buffer_size = (rect.width() + 2 * m_xRadius + 1) * (m_yRadius + 1);
-    quint8* buffer = new quint8[buffer_size];
-
-    if (m_edgeLock)
-        memset(buffer, 255, buffer_size);
-    else
-        memset(buffer, 0, buffer_size);
-
-    for (qint32 i = 0; i < rect.width() + 2 * m_xRadius; i++) {
-        if (i < m_xRadius)
-            if (m_edgeLock)
-                max[i] = buffer;
-            else
-                max[i] = &buffer[(m_yRadius + 1) * (rect.width() + m_xRadius)];
-        else if (i < rect.width() + m_xRadius)
-            max[i] = &buffer[(m_yRadius + 1) * (i - m_xRadius)];
-        else if (m_edgeLock)
-            max[i] = &buffer[(m_yRadius + 1) * (rect.width() + m_xRadius - 1)];
-        else
-            max[i] = &buffer[(m_yRadius + 1) * (rect.width() + m_xRadius)];
-    }
-    if (!m_edgeLock)
-        for (qint32 j = 0 ; j < m_xRadius + 1; j++) max[0][j] = 0;
-
-    // offset the max pointer by m_xRadius so the range of the array is [-m_xRadius] to [region->w + m_xRadius]
-    max += m_xRadius;
-
-    quint8* out = new quint8[rect.width()]; // holds the new scan line we are computing
-
-    qint32* circ = new qint32[2 * m_xRadius + 1]; // holds the y coords of the filter's mask
-
-    computeBorder(circ, m_xRadius, m_yRadius);
-
-    // offset the circ pointer by m_xRadius so the range of the array is [-m_xRadius] to [m_xRadius]
-    circ += m_xRadius;
-
-    for (qint32 i = 0; i < m_yRadius && i < rect.height(); i++) // load top of image
-        pixelSelection->readBytes(buf[i + 1], rect.x(), rect.y() + i, rect.width(), 1);
-
-    if (m_edgeLock)
-        memcpy(buf[0], buf[1], rect.width());
-    else
-        memset(buf[0], 0, rect.width());
-
-
-    for (qint32 x = 0; x < rect.width(); x++) { // set up max for top of image
-        max[x][0] = buf[0][x];
-        for (qint32 j = 1; j < m_yRadius + 1; j++)
-            max[x][j] = MIN(buf[j][x], max[x][j-1]);
-    }
-
-    for (qint32 y = 0; y < rect.height(); y++) {
-        rotatePointers(buf, m_yRadius + 1);
-        if (y < rect.height() - m_yRadius)
-            pixelSelection->readBytes(buf[m_yRadius], rect.x(), rect.y() + y + m_yRadius, rect.width(), 1);
-        else if (m_edgeLock)
-            memcpy(buf[m_yRadius], buf[m_yRadius - 1], rect.width());
-        else
-            memset(buf[m_yRadius], 0, rect.width());
-
-        for (qint32 x = 0 ; x < rect.width(); x++) { // update max array
-            for (qint32 i = m_yRadius; i > 0; i--) {
-                max[x][i] = MIN(MIN(max[x][i - 1], buf[i - 1][x]), buf[i][x]);
-            }
-            max[x][0] = buf[0][x];
-        }
-        last_max =  max[0][circ[-1]];
-        last_index = 0;
-
-        for (qint32 x = 0 ; x < rect.width(); x++) { // render scan line
-            last_index--;
-            if (last_index >= 0) {
-                if (last_max == 0)
-                    out[x] = 0;
-                else {
-                    last_max = 255;
-                    for (qint32 i = m_xRadius; i >= 0; i--)
-                        if (last_max > max[x + i][circ[i]]) {
-                            last_max = max[x + i][circ[i]];
-                            last_index = i;
-                        }
-                    out[x] = last_max;
-                }
-            } else {
-                last_index = m_xRadius;
-                last_max = max[x + m_xRadius][circ[m_xRadius]];
-                for (qint32 i = m_xRadius - 1; i >= -m_xRadius; i--)
-                    if (last_max > max[x + i][circ[i]]) {
-                        last_max = max[x + i][circ[i]];
-                        last_index = i;
-                    }
-                out[x] = last_max;
-            }
-        }
-        pixelSelection->writeBytes(out, rect.x(), rect.y() + y, rect.width(), 1);
-    }
+    /**
+     * If edge_lock is true we assume that pixels outside the region
+     * we are passed are identical to the edge pixels.
+     * If edge_lock is false, we assume that pixels outside the region are 0
+     */
 
-    // undo the offsets to the pointers so we can free the malloced memory
-    circ -= m_xRadius;
-    max -= m_xRadius;
+    QVector<qint32> circ(2 * m_xRadius + 1); // holds the y coords of the filter's mask
+    computeBorder(circ.data(), m_xRadius, m_yRadius);
 
-    delete[] circ;
-    delete[] buffer;
-    delete[] max;
-    for (qint32 i = 0; i < m_yRadius + 1; i++)
-        delete[] buf[i];
-    delete[] buf;
-    delete[] out;
+    applyMorphology<MinOp>(pixelSelection, rect, EllipseSteps(circ, m_xRadius, m_yRadius), m_edgeLock);
 }
 
 
@@ -12,6 +12,7 @@
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_lod_transform.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -89,31 +90,18 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 {
     QMutexLocker locker(&m_lock);
 
-    KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
     bool jobAdded = false;
 
-    int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
-
-    while(iter.hasNext()) {
-        item = iter.next();
-
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            !item->checksumValid()) {
-
-            m_overrideLevelOfDetail = item->levelOfDetail();
-            item->recalculate(item->requestedRect());
-            m_overrideLevelOfDetail = -1;
-        }
-
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            updaterContext.isJobAllowed(item)) {
+    /**
+     * The walkers visible to the user go first. Off-screen ones
+     * fill the threads that are still spare after that.
+     */
+    if (!m_priorityRegion.isEmpty()) {
+        jobAdded = tryAddMergeJob(updaterContext, true);
+    }
 
-            updaterContext.addMergeJob(item);
-            iter.remove();
-            jobAdded = true;
-            break;
-        }
+    if (!jobAdded) {
+        jobAdded = tryAddMergeJob(updaterContext, false);
     }
 
     if (jobAdded) return true;
@@ -143,6 +131,58 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
     return jobAdded;
 }
 
+bool KisSimpleUpdateQueue::tryAddMergeJob(KisUpdaterContext &updaterContext, bool priorityOnly)
+{
+    KisBaseRectsWalkerSP item;
+    KisMutableWalkersListIterator iter(m_updatesList);
+
+    int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
+
+    while(iter.hasNext()) {
+        item = iter.next();
+
+        if (priorityOnly && !isPriorityWalker(item)) continue;
+
+        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
+            !item->checksumValid()) {
+
+            m_overrideLevelOfDetail = item->levelOfDetail();
+            item->recalculate(item->requestedRect());
+            m_overrideLevelOfDetail = -1;
+        }
+
+        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
+            updaterContext.isJobAllowed(item)) {
+
+            updaterContext.addMergeJob(item);
+            iter.remove();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool KisSimpleUpdateQueue::isPriorityWalker(KisBaseRectsWalkerSP walker) const
+{
+    const QRect changeRect =
+        KisLodTransform::upscaledRect(walker->changeRect(), walker->levelOfDetail());
+
+    return changeRect.intersects(m_priorityRegion);
+}
+
+void KisSimpleUpdateQueue::setPriorityRegion(const QRect &rect)
+{
+    QMutexLocker locker(&m_lock);
+    m_priorityRegion = rect;
+}
+
+QRect KisSimpleUpdateQueue::priorityRegion() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_priorityRegion;
+}
+
 void KisSimpleUpdateQueue::addUpdateJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail)
 {
     addJob(node, rects, cropRect, levelOfDetail, KisBaseRectsWalker::UPDATE);
@@ -201,11 +241,50 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
 
     if (!walkers.isEmpty()) {
         m_lock.lock();
-        m_updatesList.append(walkers);
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkers) {
+            if (!isWalkerCovered(walker)) {
+                m_updatesList.append(walker);
+            }
+        }
         m_lock.unlock();
     }
 }
 
+/**
+ * Strokes working on different nodes of the same branch (e.g. a brush
+ * stroke on a layer and a filter mask on its group) generate updates
+ * that cannot be merged by tryMergeJob(), because the walkers start
+ * from different nodes. But when the queue already has a full refresh
+ * of an ancestor, which rebuilds all the projections of the subtree in
+ * the same area, the update of the descendant is just a duplicate.
+ *
+ * The walkers of the same node are not checked here, they are handled
+ * by tryMergeJob() and collectJobs().
+ */
+bool KisSimpleUpdateQueue::isWalkerCovered(KisBaseRectsWalkerSP walker) const
+{
+    KisBaseRectsWalkerSP item;
+    KisWalkersListIterator iter(m_updatesList);
+
+    while(iter.hasNext()) {
+        item = iter.next();
+
+        if(item->type() != KisBaseRectsWalker::FULL_REFRESH) continue;
+        if(item->cropRect() != walker->cropRect()) continue;
+        if(item->levelOfDetail() != walker->levelOfDetail()) continue;
+        if(item->startNode() == walker->startNode()) continue;
+
+        if(!item->requestedRect().contains(walker->requestedRect())) continue;
+        if(!item->changeRect().contains(walker->changeRect())) continue;
+
+        for (KisNodeSP node = walker->startNode()->parent(); node; node = node->parent()) {
+            if (node == item->startNode()) return true;
+        }
+    }
+
+    return false;
+}
+
 void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
 {
     QMutexLocker locker(&m_lock);
@@ -244,7 +323,18 @@ bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
                                        int levelOfDetail,
                                        KisBaseRectsWalker::UpdateType type)
 {
-    if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
+    /**
+     * Long strips, e.g. a filter mask updated over the whole width of
+     * a very wide layer, should also be split, otherwise they are
+     * processed by a single thread. Small rects that just cross a
+     * patch boundary are not worth the overhead of extra walkers.
+     */
+    const bool isLongStrip =
+        qint64(rc.width()) * rc.height() >
+        2 * qint64(m_patchWidth) * m_patchHeight;
+
+    if((rc.width() <= m_patchWidth || rc.height() <= m_patchHeight) &&
+       !isLongStrip)
         return false;
 
     // a bit of recursive splitting...
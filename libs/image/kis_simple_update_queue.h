@@ -44,13 +44,26 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * The walkers that change anything inside \p rect (in the
+     * coordinates of LoD0) are started before all the others.
+     * The rest of the walkers are started only when none of the
+     * priority ones can be started. Pass an empty rect to return
+     * to plain FIFO order.
+     */
+    void setPriorityRegion(const QRect &rect);
+    QRect priorityRegion() const;
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
+    bool tryAddMergeJob(KisUpdaterContext &updaterContext, bool priorityOnly);
+    bool isPriorityWalker(KisBaseRectsWalkerSP walker) const;
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
+    bool isWalkerCovered(KisBaseRectsWalkerSP walker) const;
 
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
@@ -92,6 +105,11 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    /**
+     * The area the user is currently looking at
+     */
+    QRect m_priorityRegion;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
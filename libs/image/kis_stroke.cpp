@@ -178,11 +178,13 @@ void KisStroke::cancelStroke()
          */
         KIS_ASSERT_RECOVER_NOOP(type() == LODN ||
                                 sanityCheckAllJobsAreCancellable());
+        m_strokeStrategy->notifyCancellationRequested();
         clearQueueOnCancel();
     }
     else if(effectivelyInitialized &&
             (!m_jobsQueue.isEmpty() || !m_strokeEnded)) {
 
+        m_strokeStrategy->notifyCancellationRequested();
         clearQueueOnCancel();
         enqueue(m_cancelStrategy.data(),
                 m_strokeStrategy->createCancelData());
@@ -18,6 +18,7 @@ KisStrokeStrategy::KisStrokeStrategy(const QLatin1String &id, const KUndo2MagicS
       m_canForgetAboutMe(false),
       m_needsExplicitCancel(false),
       m_balancingRatioOverride(-1.0),
+      m_cancellationRequested(false),
       m_id(id),
       m_name(name),
       m_mutatedJobsInterface(0)
@@ -32,6 +33,7 @@ KisStrokeStrategy::KisStrokeStrategy(const KisStrokeStrategy &rhs)
       m_canForgetAboutMe(rhs.m_canForgetAboutMe),
       m_needsExplicitCancel(rhs.m_needsExplicitCancel),
       m_balancingRatioOverride(rhs.m_balancingRatioOverride),
+      m_cancellationRequested(false),
       m_id(rhs.m_id),
       m_name(rhs.m_name),
       m_mutatedJobsInterface(0)
@@ -199,6 +201,16 @@ bool KisStrokeStrategy::needsExplicitCancel() const
     return m_needsExplicitCancel;
 }
 
+bool KisStrokeStrategy::isCancellationRequested() const
+{
+    return m_cancellationRequested.load(std::memory_order_relaxed);
+}
+
+void KisStrokeStrategy::notifyCancellationRequested()
+{
+    m_cancellationRequested.store(true, std::memory_order_relaxed);
+}
+
 void KisStrokeStrategy::setNeedsExplicitCancel(bool value)
 {
     m_needsExplicitCancel = value;
@@ -7,6 +7,8 @@
 #ifndef __KIS_STROKE_STRATEGY_H
 #define __KIS_STROKE_STRATEGY_H
 
+#include <atomic>
+
 #include <QString>
 #include "kis_types.h"
 #include "kundo2magicstring.h"
@@ -92,6 +94,22 @@ public:
 
     bool needsExplicitCancel() const;
 
+    /**
+     * Returns true if the stroke has been cancelled by the user or by
+     * the strokes queue. Long running cancellable jobs may poll this
+     * flag (e.g. with KisStrokeCancellationChecker) to stop their work
+     * early instead of delaying the cancellation until they finish.
+     * All the changes are reverted by the cancel job anyway.
+     *
+     * Can be called from any thread.
+     */
+    bool isCancellationRequested() const;
+
+    /**
+     * Called by KisStroke when the stroke is cancelled.
+     */
+    void notifyCancellationRequested();
+
     /**
      * \see setBalancingRatioOverride() for details
      */
@@ -171,6 +189,7 @@ private:
     bool m_canForgetAboutMe;
     bool m_needsExplicitCancel;
     qreal m_balancingRatioOverride;
+    std::atomic<bool> m_cancellationRequested;
 
     QLatin1String m_id;
     KUndo2MagicString m_name;
@@ -20,6 +20,8 @@ typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
 
 #include "kis_image_interfaces.h"
+#include "KisSchedulerTracer.h"
+#include "KisAdaptiveLodEstimator.h"
 class KisStrokesQueue::LodNUndoStrokesFacade : public KisStrokesFacade
 {
 public:
@@ -83,6 +85,8 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     bool lodNNeedsSynchronization;
     int desiredLevelOfDetail;
     int nextDesiredLevelOfDetail;
+    bool adaptiveLodEnabled = false;
+    KisAdaptiveLodEstimator adaptiveLodEstimator;
     QMutex mutex;
     KisLodSyncStrokeStrategyFactory lod0ToNStrokeStrategyFactory;
     KisSuspendResumeStrategyPairFactory suspendResumeUpdatesStrokeStrategyFactory;
@@ -98,6 +102,7 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     StrokesQueueIterator findNewLodNPos(KisStrokeSP lodN);
     bool shouldWrapInSuspendUpdatesStroke() const;
 
+    int effectiveDesiredLevelOfDetail() const;
     void switchDesiredLevelOfDetail(bool forced);
     bool hasUnfinishedStrokes() const;
     void tryClearUndoOnStrokeCompletion(KisStrokeSP finishingStroke);
@@ -560,9 +565,18 @@ qint32 KisStrokesQueue::sizeMetric() const
     return qMax(1, m_d->strokesQueue.head()->numJobs()) * m_d->strokesQueue.size();
 }
 
+int KisStrokesQueue::Private::effectiveDesiredLevelOfDetail() const
+{
+    return adaptiveLodEnabled ?
+        qMax(nextDesiredLevelOfDetail, adaptiveLodEstimator.preferredLevelOfDetail()) :
+        nextDesiredLevelOfDetail;
+}
+
 void KisStrokesQueue::Private::switchDesiredLevelOfDetail(bool forced)
 {
-    if (forced || nextDesiredLevelOfDetail != desiredLevelOfDetail) {
+    const int newLevelOfDetail = effectiveDesiredLevelOfDetail();
+
+    if (forced || newLevelOfDetail != desiredLevelOfDetail) {
         Q_FOREACH (KisStrokeSP stroke, strokesQueue) {
             if (stroke->type() != KisStroke::LEGACY)
                 return;
@@ -570,9 +584,9 @@ void KisStrokesQueue::Private::switchDesiredLevelOfDetail(bool forced)
 
         const bool forgettable =
             forced && !lodNNeedsSynchronization &&
-            desiredLevelOfDetail == nextDesiredLevelOfDetail;
+            desiredLevelOfDetail == newLevelOfDetail;
 
-        desiredLevelOfDetail = nextDesiredLevelOfDetail;
+        desiredLevelOfDetail = newLevelOfDetail;
         lodNNeedsSynchronization |= !forgettable;
 
         if (desiredLevelOfDetail) {
@@ -597,6 +611,33 @@ void KisStrokesQueue::setDesiredLevelOfDetail(int lod)
     m_d->switchDesiredLevelOfDetail(false);
 }
 
+void KisStrokesQueue::setAdaptiveLevelOfDetailEnabled(bool value)
+{
+    QMutexLocker locker(&m_d->mutex);
+
+    if (value == m_d->adaptiveLodEnabled) return;
+
+    m_d->adaptiveLodEnabled = value;
+    m_d->switchDesiredLevelOfDetail(false);
+}
+
+void KisStrokesQueue::setAdaptiveLevelOfDetailTargetLatency(qreal value)
+{
+    QMutexLocker locker(&m_d->mutex);
+    m_d->adaptiveLodEstimator.setTargetLatency(value);
+}
+
+int KisStrokesQueue::adaptiveLevelOfDetail() const
+{
+    QMutexLocker locker(&m_d->mutex);
+    return m_d->adaptiveLodEstimator.preferredLevelOfDetail();
+}
+
+void KisStrokesQueue::reportMergeJobTime(int levelOfDetail, qint64 nsecs)
+{
+    m_d->adaptiveLodEstimator.reportMergeJob(levelOfDetail, nsecs);
+}
+
 void KisStrokesQueue::notifyUFOChangedImage()
 {
     QMutexLocker locker(&m_d->mutex);
@@ -703,6 +744,10 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
             m_d->wrapAroundModeSupported = stroke->supportsWrapAroundMode();
             m_d->balancingRatioOverride = stroke->balancingRatioOverride();
             m_d->currentStrokeLoaded = true;
+
+            KisSchedulerTracer::instance()->reportStrokeStarted(stroke.data(),
+                                                                stroke->name().toString(),
+                                                                stroke->worksOnLevelOfDetail());
         }
 
         result = true;
@@ -717,6 +762,10 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
             m_d->wrapAroundModeSupported = stroke->supportsWrapAroundMode();
             m_d->balancingRatioOverride = stroke->balancingRatioOverride();
             m_d->currentStrokeLoaded = true;
+
+            KisSchedulerTracer::instance()->reportStrokeStarted(stroke.data(),
+                                                                stroke->name().toString(),
+                                                                stroke->worksOnLevelOfDetail());
         }
 
         result = true;
@@ -724,12 +773,17 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
     else if(stroke->isEnded() && !hasJobs && !hasStrokeJobsRunning) {
         m_d->tryClearUndoOnStrokeCompletion(stroke);
 
+        if (m_d->currentStrokeLoaded) {
+            KisSchedulerTracer::instance()->reportStrokeEnded(stroke.data());
+        }
+
         m_d->strokesQueue.dequeue(); // deleted by shared pointer
         m_d->needsExclusiveAccess = false;
         m_d->wrapAroundModeSupported = false;
         m_d->balancingRatioOverride = -1.0;
         m_d->currentStrokeLoaded = false;
 
+        m_d->adaptiveLodEstimator.notifyStrokeFinished();
         m_d->switchDesiredLevelOfDetail(false);
 
         if(!m_d->strokesQueue.isEmpty()) {
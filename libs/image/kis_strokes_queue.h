@@ -55,6 +55,22 @@ public:
 
     void setDesiredLevelOfDetail(int lod);
     void explicitRegenerateLevelOfDetail();
+
+    /**
+     * When enabled, the level of detail of the strokes is not lower
+     * than the one chosen by KisAdaptiveLodEstimator from the merge
+     * latency of the previous strokes
+     */
+    void setAdaptiveLevelOfDetailEnabled(bool value);
+    void setAdaptiveLevelOfDetailTargetLatency(qreal value);
+    int adaptiveLevelOfDetail() const;
+
+    /**
+     * Reports the duration of a merge job to the adaptive
+     * LOD estimator. Can be called from any thread.
+     */
+    void reportMergeJobTime(int levelOfDetail, qint64 nsecs);
+
     void setLod0ToNStrokeStrategyFactory(const KisLodSyncStrokeStrategyFactory &factory);
     void setSuspendResumeUpdatesStrokeStrategyFactory(const KisSuspendResumeStrategyPairFactory &factory);
     KisPostExecutionUndoAdapter* lodNPostExecutionUndoAdapter() const;
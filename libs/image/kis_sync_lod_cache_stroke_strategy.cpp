@@ -10,6 +10,8 @@
 #include <kundo2magicstring.h>
 #include "krita_utils.h"
 #include "kis_layer_utils.h"
+#include "KisStrokeCancellationChecker.h"
+#include "tiles3/kis_tile_data_interface.h"
 
 
 struct KisSyncLodCacheStrokeStrategy::Private
@@ -24,12 +26,12 @@ struct KisSyncLodCacheStrokeStrategy::Private
 
     class InitData : public KisStrokeJobData {
     public:
-        InitData(KisPaintDeviceSP _device)
+        InitData(const KisPaintDeviceList &_devices)
             : KisStrokeJobData(SEQUENTIAL),
-              device(_device)
+              devices(_devices)
             {}
 
-        KisPaintDeviceSP device;
+        KisPaintDeviceList devices;
     };
 
     class ProcessData : public KisStrokeJobData {
@@ -85,15 +87,52 @@ void KisSyncLodCacheStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
     Private::AdditionalProcessNode *additionalProcessNode = dynamic_cast<Private::AdditionalProcessNode*>(data);
 
     if (initData) {
-        KisPaintDeviceSP dev = initData->device;
-        const int lod = dev->defaultBounds()->currentLevelOfDetail();
-        m_d->dataObjects.insert(dev, dev->createLodDataStruct(lod));
+        using KritaUtils::splitRegionIntoPatches;
+        using KritaUtils::optimalPatchSize;
+
+        /**
+         * The regions are calculated right here, when all the
+         * preceding strokes have already finished. The LOD planes
+         * that were synchronized before are regenerated only in the
+         * areas changed since then.
+         */
+        QVector<KisStrokeJobData*> jobsData;
+
+        Q_FOREACH (KisPaintDeviceSP dev, initData->devices) {
+            const int lod = dev->defaultBounds()->currentLevelOfDetail();
+
+            KisPaintDevice::LodDataStruct *lodData = dev->createLodDataStruct(lod, true);
+            m_d->dataObjects.insert(dev, lodData);
+
+            KisRegion region = dev->regionForLodSyncing(lodData);
+            QVector<QRect> rects = splitRegionIntoPatches(region, optimalPatchSize());
+
+            Q_FOREACH (const QRect &rc, rects) {
+                jobsData << new Private::ProcessData(dev, rc);
+            }
+        }
+
+        addMutatedJobs(jobsData);
     } else if (processData) {
         KisPaintDeviceSP dev = processData->device;
         KIS_ASSERT(m_d->dataObjects.contains(dev));
 
         KisPaintDevice::LodDataStruct *data = m_d->dataObjects.value(dev);
-        dev->updateLodDataStruct(data, processData->rect);
+
+        /**
+         * Forgettable syncs are cancelled as soon as the user starts
+         * a new stroke, so process the patch row-by-row to let it
+         * stop early.
+         */
+        KisStrokeCancellationChecker checker(this);
+        const QRect &rc = processData->rect;
+
+        for (int y = rc.top(); y <= rc.bottom(); y += KisTileData::HEIGHT) {
+            if (checker.isCancelled()) break;
+
+            const QRect rowRect(rc.left(), y, rc.width(), qMin(KisTileData::HEIGHT, rc.bottom() - y + 1));
+            dev->updateLodDataStruct(data, rowRect);
+        }
     } else if (additionalProcessNode) {
         additionalProcessNode->node->syncLodCache();
     }
@@ -122,8 +161,6 @@ void KisSyncLodCacheStrokeStrategy::cancelStrokeCallback()
 QList<KisStrokeJobData*> KisSyncLodCacheStrokeStrategy::createJobsData(KisImageWSP _image)
 {
     using KisLayerUtils::recursiveApplyNodes;
-    using KritaUtils::splitRegionIntoPatches;
-    using KritaUtils::optimalPatchSize;
 
     KisImageSP image = _image;
 
@@ -137,18 +174,7 @@ QList<KisStrokeJobData*> KisSyncLodCacheStrokeStrategy::createJobsData(KisImageW
 
     KritaUtils::makeContainerUnique(deviceList);
 
-    Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-        jobsData << new Private::InitData(device);
-    }
-
-    Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-        KisRegion region = device->regionForLodSyncing();
-        QVector<QRect> rects = splitRegionIntoPatches(region, optimalPatchSize());
-
-        Q_FOREACH (const QRect &rc, rects) {
-            jobsData << new Private::ProcessData(device, rc);
-        }
-    }
+    jobsData << new Private::InitData(deviceList);
 
     recursiveApplyNodes(image->root(),
                         [&jobsData](KisNodeSP node) {
@@ -14,6 +14,8 @@
 #include <klocalizedstring.h>
 
 #include <QTransform>
+#include <QMutex>
+#include <QtConcurrent>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -165,6 +167,37 @@ template <> void calcDimensions <KisVLineIteratorSP>
 
 }
 
+namespace {
+
+struct LineStripe {
+    int firstLine;
+    int numLines;
+    KisFilterWeightsApplicator::LinePos dstBounds;
+};
+
+QVector<LineStripe> splitIntoStripes(int firstLine, int numLines)
+{
+    const int stripeSize = 64;
+    QVector<LineStripe> stripes;
+
+    const int endLine = firstLine + numLines;
+    int start = firstLine;
+
+    while (start < endLine) {
+        // align the stripes to the tile grid
+        const int alignedEnd =
+            (start >= 0 ? start / stripeSize + 1 : -((-start - 1) / stripeSize)) * stripeSize;
+        const int end = qMin(alignedEnd, endLine);
+
+        stripes.append({start, end - start, KisFilterWeightsApplicator::LinePos()});
+        start = end;
+    }
+
+    return stripes;
+}
+
+}
+
 template <class iter>
 void updateBounds(QRect &boundRect,
                   const KisFilterWeightsApplicator::LinePos &newBounds);
@@ -194,20 +227,36 @@ void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
     qint32 srcStart, srcLen, firstLine, numLines;
     calcDimensions<T>(m_boundRect, srcStart, srcLen, firstLine, numLines);
 
-    KisProgressUpdateHelper progressHelper(m_progressUpdater, portion, numLines);
     KisFilterWeightsBuffer buf(filterStrategy, qAbs(floatscale));
     KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
+    const qreal filterSupport = filterStrategy->support(buf.weightsPositionScale().toFloat());
 
-    KisFilterWeightsApplicator::LinePos dstBounds;
+    /**
+     * Every line is read and written back to the same line of the device,
+     * so the lines are independent. They are processed in parallel stripes
+     * aligned to the tiles, so the threads don't share any tiles.
+     */
+    QVector<LineStripe> stripes = splitIntoStripes(firstLine, numLines);
 
-    for (int i = firstLine; i < firstLine + numLines; i++) {
-        KisFilterWeightsApplicator::LinePos dstPos;
-        KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+    KisProgressUpdateHelper progressHelper(m_progressUpdater, portion, stripes.size());
+    QMutex progressMutex;
 
-        dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support(buf.weightsPositionScale().toFloat()));
-        dstBounds.unite(dstPos);
+    QtConcurrent::blockingMap(stripes,
+        [&] (LineStripe &stripe) {
+            KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
 
-        progressHelper.step();
+            for (int i = stripe.firstLine; i < stripe.firstLine + stripe.numLines; i++) {
+                stripe.dstBounds.unite(applicator.processLine<T>(srcPos, i, &buf, filterSupport));
+            }
+
+            QMutexLocker l(&progressMutex);
+            progressHelper.step();
+        });
+
+    KisFilterWeightsApplicator::LinePos dstBounds;
+
+    Q_FOREACH (const LineStripe &stripe, stripes) {
+        dstBounds.unite(stripe.dstBounds);
     }
 
     updateBounds<T>(m_boundRect, dstBounds);
@@ -11,12 +11,14 @@
 
 #include <QRunnable>
 #include <QReadWriteLock>
+#include <QElapsedTimer>
 
 #include "kis_stroke_job.h"
 #include "kis_spontaneous_job.h"
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisSchedulerTracer.h"
 
 //#define DEBUG_JOBS_SEQUENCE
 
@@ -70,8 +72,15 @@ public:
                 m_updaterContext->m_exclusiveJobLock.lockForRead();
             }
 
+            KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+            const qint64 traceStartTime = tracer->isEnabled() ? tracer->timestamp() : -1;
+
             if(m_atomicType == Type::MERGE) {
                 runMergeJob();
+
+                if (traceStartTime >= 0) {
+                    tracer->reportMergeJob(traceStartTime, m_walker);
+                }
             } else {
                 KIS_ASSERT(m_atomicType == Type::STROKE ||
                            m_atomicType == Type::SPONTANEOUS);
@@ -88,6 +97,14 @@ public:
 #endif
 
                     m_runnableJob->run();
+
+                    if (traceStartTime >= 0) {
+                        if (m_atomicType == Type::STROKE) {
+                            tracer->reportStrokeJob(traceStartTime, static_cast<KisStrokeJob*>(m_runnableJob));
+                        } else {
+                            tracer->reportSpontaneousJob(traceStartTime, static_cast<KisSpontaneousJob*>(m_runnableJob));
+                        }
+                    }
                 }
             }
 
@@ -120,8 +137,13 @@ public:
 
 #endif
 
+        QElapsedTimer timer;
+        timer.start();
+
         m_merger.startMerge(*m_walker);
 
+        m_updaterContext->reportMergeJobTime(m_walker->levelOfDetail(), timer.nsecsElapsed());
+
         QRect changeRect = m_walker->changeRect();
         m_updaterContext->continueUpdate(changeRect);
     }
@@ -132,6 +154,7 @@ public:
 
         m_accessRect = walker->accessRect();
         m_changeRect = walker->changeRect();
+        m_lastMergeRect = m_changeRect;
         m_walker = walker;
 
         m_exclusive = false;
@@ -197,6 +220,24 @@ public:
         return m_strokeJobSequentiality;
     }
 
+    /**
+     * The change rect of the last merge job executed by the item. The
+     * tiles of this area are likely to be still hot in the caches of
+     * the item's thread.
+     */
+    inline const QRect& lastMergeRect() const {
+        return m_lastMergeRect;
+    }
+
+    /**
+     * The thread of the item has just finished a job and is still
+     * spinning in run(), so a job assigned to the item will be
+     * picked up without waking up any other thread.
+     */
+    inline bool isWaiting() const {
+        return m_atomicType == Type::WAITING;
+    }
+
 private:
     /**
      * Open walker and stroke job for the testing suite.
@@ -247,6 +288,8 @@ private:
      */
     QRect m_accessRect;
     QRect m_changeRect;
+
+    QRect m_lastMergeRect;
 };
 
 
@@ -17,6 +17,7 @@
 
 #include "kis_queues_progress_updater.h"
 #include "KisImageConfigNotifier.h"
+#include "KisSchedulerTracer.h"
 
 #include <QReadWriteLock>
 #include "kis_lazy_wait_condition.h"
@@ -49,6 +50,8 @@ struct Q_DECL_HIDDEN KisUpdateScheduler::Private {
     KisUpdaterContext updaterContext;
     bool processingBlocked = false;
     qreal defaultBalancingRatio = 1.0; // desired strokes-queue-size / updates-queue-size
+    bool adaptiveLodEnabled = false;
+    bool adaptiveLodAllowed = true;
     KisProjectionUpdateListener *projectionUpdateListener;
     KisQueuesProgressUpdater *progressUpdater = 0;
 
@@ -68,6 +71,9 @@ KisUpdateScheduler::KisUpdateScheduler(KisProjectionUpdateListener *projectionUp
 {
     updateSettings();
     connectSignals();
+
+    // create the tracer in the GUI thread, it reads the config on creation
+    KisSchedulerTracer::instance();
 }
 
 KisUpdateScheduler::KisUpdateScheduler()
@@ -103,6 +109,22 @@ int KisUpdateScheduler::threadsLimit() const
     return m_d->updaterContext.threadsLimit();
 }
 
+KisUpdateSchedulerStatistics KisUpdateScheduler::statistics() const
+{
+    KisUpdateSchedulerStatistics stats;
+
+    {
+        std::lock_guard<KisUpdaterContext> l(m_d->updaterContext);
+        stats.threadsLimit = m_d->updaterContext.threadsLimit();
+        m_d->updaterContext.getJobsSnapshot(stats.numMergeJobs, stats.numStrokeJobs);
+    }
+
+    stats.updatesQueueSize = m_d->updatesQueue.sizeMetric();
+    stats.strokesQueueSize = m_d->strokesQueue.sizeMetric();
+
+    return stats;
+}
+
 void KisUpdateScheduler::connectSignals()
 {
     connect(KisImageConfigNotifier::instance(), SIGNAL(configChanged()),
@@ -259,6 +281,20 @@ void KisUpdateScheduler::explicitRegenerateLevelOfDetail()
     processQueues();
 }
 
+void KisUpdateScheduler::setUpdatesPriorityRegion(const QRect &rect)
+{
+    m_d->updatesQueue.setPriorityRegion(rect);
+}
+
+void KisUpdateScheduler::setAdaptiveLevelOfDetailAllowed(bool value)
+{
+    m_d->adaptiveLodAllowed = value;
+    m_d->strokesQueue.setAdaptiveLevelOfDetailEnabled(m_d->adaptiveLodEnabled && m_d->adaptiveLodAllowed);
+
+    // \see a comment in setDesiredLevelOfDetail()
+    processQueues();
+}
+
 int KisUpdateScheduler::currentLevelOfDetail() const
 {
     int levelOfDetail = m_d->updaterContext.currentLevelOfDetail();
@@ -295,6 +331,10 @@ void KisUpdateScheduler::updateSettings()
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
     setThreadsLimit(config.maxNumberOfThreads());
+
+    m_d->adaptiveLodEnabled = config.adaptiveLevelOfDetail();
+    m_d->strokesQueue.setAdaptiveLevelOfDetailTargetLatency(config.adaptiveLevelOfDetailTargetLatency());
+    m_d->strokesQueue.setAdaptiveLevelOfDetailEnabled(m_d->adaptiveLodEnabled && m_d->adaptiveLodAllowed);
 }
 
 void KisUpdateScheduler::lock()
@@ -455,6 +495,11 @@ void KisUpdateScheduler::spareThreadAppeared()
     processQueues();
 }
 
+void KisUpdateScheduler::reportMergeJobTime(int levelOfDetail, qint64 nsecs)
+{
+    m_d->strokesQueue.reportMergeJobTime(levelOfDetail, nsecs);
+}
+
 KisTestableUpdateScheduler::KisTestableUpdateScheduler(KisProjectionUpdateListener *projectionUpdateListener,
                                                        qint32 threadCount)
 {
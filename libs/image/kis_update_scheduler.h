@@ -21,6 +21,20 @@ class KisProjectionUpdateListener;
 class KisSpontaneousJob;
 class KisPostExecutionUndoAdapter;
 
+/**
+ * A snapshot of the load of the scheduler, e.g. for the profiling tools
+ */
+struct KisUpdateSchedulerStatistics
+{
+    int threadsLimit = 0;
+    int numMergeJobs = 0;
+    int numStrokeJobs = 0;
+
+    /// the size metrics of the queues, see KisSimpleUpdateQueue::sizeMetric()
+    int updatesQueueSize = 0;
+    int strokesQueueSize = 0;
+};
+
 
 class KRITAIMAGE_EXPORT KisUpdateScheduler : public QObject, public KisStrokesFacade
 {
@@ -40,6 +54,13 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Return the number of the currently running jobs and the sizes
+     * of the queues. The values are sampled without blocking the
+     * queues, so they are only approximately consistent.
+     */
+    KisUpdateSchedulerStatistics statistics() const;
+
     /**
      * Sets the proxy that is going to be notified about the progress
      * of processing of the queues. If you want to switch the proxy
@@ -153,6 +174,21 @@ public:
      */
     void explicitRegenerateLevelOfDetail();
 
+    /**
+     * Sets the area of the image (in LoD0 coordinates) the user is
+     * looking at. The updates inside it are processed before the
+     * off-screen ones. An empty rect disables the prioritization.
+     */
+    void setUpdatesPriorityRegion(const QRect &rect);
+
+    /**
+     * Allows the scheduler to raise the level of detail of the strokes
+     * when the merge jobs of the image become too slow. The adaptive
+     * level of detail is applied only when it is enabled in
+     * KisImageConfig and allowed here.
+     */
+    void setAdaptiveLevelOfDetailAllowed(bool value);
+
     /**
      * Install a factory of a stroke strategy, that will be started
      * every time when the scheduler needs to synchronize LOD caches
@@ -192,6 +228,7 @@ public:
     void continueUpdate(const QRect &rect);
     void doSomeUsefulWork();
     void spareThreadAppeared();
+    void reportMergeJobTime(int levelOfDetail, qint64 nsecs);
 
 protected:
     // Trivial constructor for testing support
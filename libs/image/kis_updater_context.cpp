@@ -11,6 +11,28 @@
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
+#include "tiles3/kis_tile_data_interface.h"
+
+namespace {
+
+inline int floorDiv(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+/**
+ * Returns the rect in the tile coordinates, that is the
+ * indexes of the tiles \p rc touches
+ */
+QRect alignToTiles(const QRect &rc)
+{
+    return QRect(QPoint(floorDiv(rc.left(), KisTileData::WIDTH),
+                        floorDiv(rc.top(), KisTileData::HEIGHT)),
+                 QPoint(floorDiv(rc.right(), KisTileData::WIDTH),
+                        floorDiv(rc.bottom(), KisTileData::HEIGHT)));
+}
+
+}
 
 const int KisUpdaterContext::useIdealThreadCountTag = -1;
 
@@ -128,7 +150,7 @@ bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
 void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
 {
     m_lodCounter.addLod(walker->levelOfDetail());
-    qint32 jobIndex = findSpareThread();
+    qint32 jobIndex = findSpareThread(walker->changeRect());
     Q_ASSERT(jobIndex >= 0);
 
     const bool shouldStartThread = m_jobs[jobIndex]->setWalker(walker);
@@ -182,13 +204,49 @@ bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
         (job->accessRect().intersects(walker->changeRect()));
 }
 
-qint32 KisUpdaterContext::findSpareThread()
+/**
+ * All the items are equal from the point of view of correctness, but
+ * not from the point of view of performance. Threads that have just
+ * finished their jobs are still spinning in KisUpdateJobItem::run(),
+ * so giving them the next job saves a (costly) wake up of a sleeping
+ * thread. Among these, we prefer the one that has recently processed
+ * the same tiles, since the tiles are likely to be still in its
+ * caches.
+ */
+qint32 KisUpdaterContext::findSpareThread(const QRect &affinityRect)
 {
-    for(qint32 i=0; i < m_jobs.size(); i++)
-        if(!m_jobs[i]->isRunning())
-            return i;
+    const QRect affinityTiles =
+        !affinityRect.isEmpty() ? alignToTiles(affinityRect) : QRect();
+
+    qint32 bestIndex = -1;
+    int bestScore = -1;
 
-    return -1;
+    for (qint32 i = 0; i < m_jobs.size(); i++) {
+        const KisUpdateJobItem *item = m_jobs[i];
+        if (item->isRunning()) continue;
+
+        int score = 0;
+
+        if (item->isWaiting()) {
+            score += 2;
+        }
+
+        if (!affinityTiles.isEmpty() &&
+            !item->lastMergeRect().isEmpty() &&
+            alignToTiles(item->lastMergeRect()).intersects(affinityTiles)) {
+
+            score += 1;
+        }
+
+        if (score > bestScore) {
+            bestIndex = i;
+            bestScore = score;
+
+            if (bestScore == 3) break;
+        }
+    }
+
+    return bestIndex;
 }
 
 void KisUpdaterContext::lock()
@@ -243,6 +301,11 @@ void KisUpdaterContext::jobFinished()
     if (m_scheduler) m_scheduler->spareThreadAppeared();
 }
 
+void KisUpdaterContext::reportMergeJobTime(int levelOfDetail, qint64 nsecs)
+{
+    if (m_scheduler) m_scheduler->reportMergeJobTime(levelOfDetail, nsecs);
+}
+
 void KisUpdaterContext::setTestingMode(bool value)
 {
     m_testingMode = value;
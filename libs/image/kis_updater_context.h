@@ -129,13 +129,14 @@ public:
     void continueUpdate(const QRect& rc);
     void doSomeUsefulWork();
     void jobFinished();
+    void reportMergeJobTime(int levelOfDetail, qint64 nsecs);
 
     void setTestingMode(bool value);
 
 protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
-    qint32 findSpareThread();
+    qint32 findSpareThread(const QRect &affinityRect = QRect());
 
 protected:
     /**
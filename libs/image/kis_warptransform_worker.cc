@@ -177,20 +177,7 @@ KisWarpTransformWorker::KisWarpTransformWorker(WarpType warpType, KisPaintDevice
     m_transfPoint = transfPoint;
     m_alpha = alpha;
 
-    switch(warpType) {
-    case AFFINE_TRANSFORM:
-        m_warpMathFunction = &affineTransformMath;
-        break;
-    case SIMILITUDE_TRANSFORM:
-        m_warpMathFunction = &similitudeTransformMath;
-        break;
-    case RIGID_TRANSFORM:
-        m_warpMathFunction = &rigidTransformMath;
-        break;
-    default:
-        m_warpMathFunction = 0;
-        break;
-    }
+    m_warpMathFunction = warpMathFunctionForType(warpType);
 }
 
 KisWarpTransformWorker::~KisWarpTransformWorker()
@@ -246,8 +233,10 @@ void KisWarpTransformWorker::run()
 
     FunctionTransformOp functionOp(m_warpMathFunction, m_origPoint, m_transfPoint, m_alpha);
     GridIterationTools::PaintDevicePolygonOp polygonOp(srcdev, m_dev);
-    GridIterationTools::processGrid(polygonOp, functionOp,
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::PaintDevicePolygonOp> parallelOp(polygonOp);
+    GridIterationTools::processGrid(parallelOp, functionOp,
                                     srcBounds, pixelPrecision);
+    parallelOp.process();
 }
 
 #include "krita_utils.h"
@@ -268,6 +257,48 @@ QRect KisWarpTransformWorker::approxNeedRect(const QRect &rc, const QRect &fullB
     return fullBounds;
 }
 
+KisWarpTransformWorker::WarpMathFunction
+KisWarpTransformWorker::warpMathFunctionForType(WarpType warpType)
+{
+    switch (warpType) {
+    case AFFINE_TRANSFORM:
+        return &affineTransformMath;
+    case SIMILITUDE_TRANSFORM:
+        return &similitudeTransformMath;
+    case RIGID_TRANSFORM:
+        return &rigidTransformMath;
+    default:
+        return 0;
+    }
+}
+
+bool KisWarpTransformWorker::transformMesh(WarpType warpType,
+                                           const QVector<QPointF> &origPoint,
+                                           const QVector<QPointF> &transfPoint,
+                                           qreal alpha,
+                                           const QRectF &srcBounds,
+                                           QVector<QPolygonF> *srcPolygons,
+                                           QVector<QPolygonF> *dstPolygons)
+{
+    WarpMathFunction warpMathFunction = warpMathFunctionForType(warpType);
+    KIS_ASSERT_RECOVER(warpMathFunction && "Unknown warp mode") { return false; }
+
+    if (origPoint.size() < 2 ||
+        origPoint.size() != transfPoint.size()) {
+
+        return false;
+    }
+
+    FunctionTransformOp functionOp(warpMathFunction, origPoint, transfPoint, alpha);
+
+    // the same precision as transformQImage() uses
+    const int pixelPrecision = 32;
+    GridIterationTools::MeshPolygonOp polygonOp(srcPolygons, dstPolygons);
+    GridIterationTools::processGrid(polygonOp, functionOp, srcBounds.toAlignedRect(), pixelPrecision);
+
+    return true;
+}
+
 QImage KisWarpTransformWorker::transformQImage(WarpType warpType,
                                                const QVector<QPointF> &origPoint,
                                                const QVector<QPointF> &transfPoint,
@@ -280,21 +311,8 @@ QImage KisWarpTransformWorker::transformQImage(WarpType warpType,
         return QImage();
     }
 
-    WarpMathFunction warpMathFunction = &rigidTransformMath;
-
-    switch (warpType) {
-    case AFFINE_TRANSFORM:
-        warpMathFunction = &affineTransformMath;
-        break;
-    case SIMILITUDE_TRANSFORM:
-        warpMathFunction = &similitudeTransformMath;
-        break;
-    case RIGID_TRANSFORM:
-        warpMathFunction = &rigidTransformMath;
-        break;
-    default:
-        KIS_ASSERT_RECOVER(0 && "Unknown warp mode") { return QImage(); }
-    }
+    WarpMathFunction warpMathFunction = warpMathFunctionForType(warpType);
+    KIS_ASSERT_RECOVER(warpMathFunction && "Unknown warp mode") { return QImage(); }
 
     if (!warpMathFunction ||
         origPoint.isEmpty() ||
@@ -347,7 +365,9 @@ QImage KisWarpTransformWorker::transformQImage(WarpType warpType,
 
     const int pixelPrecision = 32;
     GridIterationTools::QImagePolygonOp polygonOp(srcImage, dstImage, srcQImageOffset, dstQImageOffset);
-    GridIterationTools::processGrid(polygonOp, functionOp, srcBounds.toAlignedRect(), pixelPrecision);
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp);
+    GridIterationTools::processGrid(parallelOp, functionOp, srcBounds.toAlignedRect(), pixelPrecision);
+    parallelOp.process();
 
     return dstImage;
 }
@@ -49,6 +49,22 @@ public:
                                   const QPointF &srcQImageOffset,
                                   QPointF *newOffset);
 
+    /**
+     * Calculates the same grid as transformQImage() does, but doesn't
+     * rasterize it. Every cell of \p srcBounds is written into
+     * \p srcPolygons and its transformed version into \p dstPolygons,
+     * so the caller can paint the source image as a textured mesh.
+     *
+     * \return false if the points don't define a warp
+     */
+    static bool transformMesh(WarpType warpType,
+                              const QVector<QPointF> &origPoint,
+                              const QVector<QPointF> &transfPoint,
+                              qreal alpha,
+                              const QRectF &srcBounds,
+                              QVector<QPolygonF> *srcPolygons,
+                              QVector<QPolygonF> *dstPolygons);
+
     // Prepare the transformation on dev
     KisWarpTransformWorker(WarpType warpType, KisPaintDeviceSP dev, QVector<QPointF> origPoint, QVector<QPointF> transfPoint, qreal alpha, KoUpdater *progress);
     ~KisWarpTransformWorker() override;
@@ -61,6 +77,7 @@ public:
 private:
     struct FunctionTransformOp;
     typedef QPointF (*WarpMathFunction)(QPointF, QVector<QPointF>, QVector<QPointF>, qreal);
+    static WarpMathFunction warpMathFunctionForType(WarpType warpType);
 
 private:
     WarpMathFunction m_warpMathFunction;
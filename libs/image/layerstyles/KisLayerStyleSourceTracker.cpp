@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisLayerStyleSourceTracker.h"
+
+#include <cstring>
+
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
+#include "kis_default_bounds_base.h"
+#include "kis_iterator_ng.h"
+
+namespace {
+
+/**
+ * The granularity of the comparison, aligned to the tiles of the devices
+ */
+const int trackingCellSize = 64;
+
+/**
+ * When too many cells have changed, the caller gets their bounding
+ * rect instead to keep the bookkeeping of the styles cheap
+ */
+const int maxReportedChanges = 64;
+
+}
+
+
+KisLayerStyleSourceTracker::KisLayerStyleSourceTracker()
+{
+}
+
+KisLayerStyleSourceTracker::~KisLayerStyleSourceTracker()
+{
+}
+
+QVector<QRect> KisLayerStyleSourceTracker::fetchChanges(KisPaintDeviceSP source, const QRect &rect)
+{
+    if (rect.isEmpty()) return QVector<QRect>();
+
+    const KoColorSpace *cs = source->colorSpace();
+    const QRect imageBounds = source->defaultBounds()->bounds();
+
+    KisPixelSelectionSP snapshot;
+    QRegion knownRegion;
+
+    {
+        QMutexLocker l(&m_mutex);
+
+        if (!m_snapshot || *m_colorSpace != *cs || m_imageBounds != imageBounds) {
+            m_snapshot = new KisPixelSelection();
+            m_knownRegion = QRegion();
+            m_colorSpace = cs;
+            m_imageBounds = imageBounds;
+        }
+
+        snapshot = m_snapshot;
+        knownRegion = m_knownRegion & rect;
+    }
+
+    QVector<QRect> changes;
+    QRect changesBounds;
+
+    QVector<quint8> newAlpha(trackingCellSize * trackingCellSize);
+    QVector<quint8> oldAlpha(trackingCellSize * trackingCellSize);
+
+    const int firstCellX = rect.x() - (rect.x() % trackingCellSize + trackingCellSize) % trackingCellSize;
+    const int firstCellY = rect.y() - (rect.y() % trackingCellSize + trackingCellSize) % trackingCellSize;
+
+    for (int cellY = firstCellY; cellY <= rect.bottom(); cellY += trackingCellSize) {
+        for (int cellX = firstCellX; cellX <= rect.right(); cellX += trackingCellSize) {
+            const QRect cellRect = QRect(cellX, cellY, trackingCellSize, trackingCellSize) & rect;
+            const int numPixels = cellRect.width() * cellRect.height();
+
+            {
+                quint8 *dstPtr = newAlpha.data();
+                KisSequentialConstIterator srcIt(source, cellRect);
+                while (srcIt.nextPixel()) {
+                    *dstPtr++ = cs->opacityU8(srcIt.rawDataConst());
+                }
+            }
+
+            const bool isKnown = (QRegion(cellRect) - knownRegion).isEmpty();
+
+            if (isKnown) {
+                snapshot->readBytes(oldAlpha.data(), cellRect);
+                if (!std::memcmp(oldAlpha.constData(), newAlpha.constData(), numPixels)) {
+                    continue;
+                }
+            }
+
+            snapshot->writeBytes(newAlpha.constData(), cellRect);
+            changes.append(cellRect);
+            changesBounds |= cellRect;
+        }
+    }
+
+    {
+        QMutexLocker l(&m_mutex);
+
+        // the snapshot might have been reset in the meantime
+        if (m_snapshot == snapshot) {
+            m_knownRegion += rect;
+        }
+    }
+
+    if (changes.size() > maxReportedChanges) {
+        changes = {changesBounds};
+    }
+
+    return changes;
+}
+
+void KisLayerStyleSourceTracker::reset()
+{
+    QMutexLocker l(&m_mutex);
+
+    m_snapshot = 0;
+    m_knownRegion = QRegion();
+    m_colorSpace = 0;
+    m_imageBounds = QRect();
+}
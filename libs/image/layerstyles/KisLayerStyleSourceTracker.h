@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISLAYERSTYLESOURCETRACKER_H
+#define KISLAYERSTYLESOURCETRACKER_H
+
+#include <QMutex>
+#include <QRect>
+#include <QRegion>
+#include <QVector>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KoColorSpace;
+
+
+/**
+ * Finds the parts of the source of the layer styles that have actually
+ * changed since the styles were calculated for them the last time.
+ *
+ * All the layer styles depend on the alpha channel of the source only,
+ * so the tracker keeps a snapshot of it and compares the new alpha with
+ * the snapshot tile by tile. The areas that have never been seen by the
+ * tracker are always reported as changed.
+ *
+ * The snapshot is dropped when the color space of the source or the
+ * bounds of the image change, since the projections of the styles are
+ * regenerated in that case.
+ */
+class KRITAIMAGE_EXPORT KisLayerStyleSourceTracker
+{
+public:
+    KisLayerStyleSourceTracker();
+    ~KisLayerStyleSourceTracker();
+
+    /**
+     * Compares the alpha channel of \p source in \p rect with the
+     * snapshot, updates the snapshot and returns the changed areas
+     */
+    QVector<QRect> fetchChanges(KisPaintDeviceSP source, const QRect &rect);
+
+    /**
+     * Forgets the snapshot, so the next fetch will report everything
+     */
+    void reset();
+
+private:
+    Q_DISABLE_COPY(KisLayerStyleSourceTracker)
+
+    QMutex m_mutex;
+    KisPixelSelectionSP m_snapshot;
+    QRegion m_knownRegion;
+    const KoColorSpace *m_colorSpace = 0;
+    QRect m_imageBounds;
+};
+
+#endif // KISLAYERSTYLESOURCETRACKER_H
@@ -17,6 +17,7 @@
 #include "kis_image.h"
 
 #include "krita_utils.h"
+#include "kis_image_config.h"
 
 #include <boost/random/mersenne_twister.hpp>
 #include "kis_random_accessor_ng.h"
@@ -30,6 +31,7 @@ struct Q_DECL_HIDDEN KisLayerStyleFilterEnvironment::Private
     KisPixelSelectionSP cachedRandomSelection;
     KisCachedSelection globalCachedSelection;
     KisCachedPaintDevice globalCachedPaintDevice;
+    bool useFastBlur = false;
 
     static KisPixelSelectionSP generateRandomSelection(const QRect &rc);
 };
@@ -72,6 +74,9 @@ KisLayerStyleFilterEnvironment::KisLayerStyleFilterEnvironment(KisLayer *sourceL
 {
     Q_ASSERT(sourceLayer);
     m_d->sourceLayer = sourceLayer;
+
+    KisImageConfig cfg(true);
+    m_d->useFastBlur = cfg.fastLayerStyleBlur();
 }
 
 KisLayerStyleFilterEnvironment::~KisLayerStyleFilterEnvironment()
@@ -95,6 +100,11 @@ int KisLayerStyleFilterEnvironment::currentLevelOfDetail() const
         m_d->sourceLayer->original()->defaultBounds()->currentLevelOfDetail() : 0;
 }
 
+bool KisLayerStyleFilterEnvironment::useFastBlur() const
+{
+    return m_d->useFastBlur;
+}
+
 void KisLayerStyleFilterEnvironment::setupFinalPainter(KisPainter *gc,
                                                        quint8 opacity,
                                                        const QBitArray &channelFlags) const
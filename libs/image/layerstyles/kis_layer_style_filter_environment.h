@@ -31,6 +31,12 @@ public:
     QRect defaultBounds() const;
     int currentLevelOfDetail() const;
 
+    /**
+     * @return true if the blurs of the styles should be approximated
+     * with the fast box blur, see KisImageConfig::fastLayerStyleBlur()
+     */
+    bool useFastBlur() const;
+
     void setupFinalPainter(KisPainter *gc,
                            quint8 opacity,
                            const QBitArray &channelFlags) const;
@@ -18,6 +18,9 @@
 #include "kis_multiple_projection.h"
 #include "KisLayerStyleKnockoutBlower.h"
 
+#include <QMutex>
+#include <QRegion>
+
 
 struct KisLayerStyleFilterProjectionPlane::Private
 {
@@ -48,6 +51,9 @@ struct KisLayerStyleFilterProjectionPlane::Private
     KisLayerStyleKnockoutBlower knockoutBlower;
 
     KisMultipleProjection projection;
+
+    QMutex dirtyRegionLock;
+    QRegion dirtyRegion;
 };
 
 KisLayerStyleFilterProjectionPlane::
@@ -80,6 +86,11 @@ QRect KisLayerStyleFilterProjectionPlane::recalculate(const QRect& rect, KisNode
         return QRect();
     }
 
+    {
+        QMutexLocker l(&m_d->dirtyRegionLock);
+        m_d->dirtyRegion -= rect;
+    }
+
     m_d->projection.clear(rect);
     m_d->filter->processDirectly(m_d->sourceLayer->projection(),
                                  &m_d->projection,
@@ -90,6 +101,38 @@ QRect KisLayerStyleFilterProjectionPlane::recalculate(const QRect& rect, KisNode
     return rect;
 }
 
+QRect KisLayerStyleFilterProjectionPlane::recalculateChanged(const QRect &rect, const QVector<QRect> &changedSourceRects)
+{
+    if (!m_d->sourceLayer || !m_d->filter) {
+        warnKrita << "KisLayerStyleFilterProjectionPlane::recalculateChanged(): [BUG] is not initialized";
+        return QRect();
+    }
+
+    QRect processRect;
+
+    {
+        QMutexLocker l(&m_d->dirtyRegionLock);
+
+        Q_FOREACH (const QRect &sourceRect, changedSourceRects) {
+            m_d->dirtyRegion += m_d->filter->changedRect(sourceRect, m_d->style, m_d->environment.data());
+        }
+
+        processRect = (m_d->dirtyRegion & rect).boundingRect();
+        m_d->dirtyRegion -= processRect;
+    }
+
+    if (processRect.isEmpty()) return QRect();
+
+    m_d->projection.clear(processRect);
+    m_d->filter->processDirectly(m_d->sourceLayer->projection(),
+                                 &m_d->projection,
+                                 &m_d->knockoutBlower,
+                                 processRect,
+                                 m_d->style,
+                                 m_d->environment.data());
+    return processRect;
+}
+
 void KisLayerStyleFilterProjectionPlane::apply(KisPainter *painter, const QRect &rect)
 {
     m_d->projection.apply(painter->device(), rect, m_d->environment.data());
@@ -10,6 +10,7 @@
 #include "kis_abstract_projection_plane.h"
 
 #include <QScopedPointer>
+#include <QVector>
 
 #include "kis_types.h"
 
@@ -26,6 +27,16 @@ public:
     void setStyle(KisLayerStyleFilter *filter, KisPSDLayerStyleSP style);
 
     QRect recalculate(const QRect& rect, KisNodeSP filthyNode) override;
+
+    /**
+     * Recalculates only the part of \p rect that is affected by the
+     * changes of the source in \p changedSourceRects. The affected areas
+     * that lie outside \p rect are remembered and recalculated by the
+     * next calls that cover them.
+     *
+     * \return the rect that has actually been recalculated
+     */
+    QRect recalculateChanged(const QRect &rect, const QVector<QRect> &changedSourceRects);
     void apply(KisPainter *painter, const QRect &rect) override;
 
     QRect needRect(const QRect &rect, KisLayer::PositionToFilthy pos) const override;
@@ -21,6 +21,9 @@
 #include "kis_painter.h"
 #include "kis_ls_utils.h"
 #include "KisLayerStyleKnockoutBlower.h"
+#include "KisLayerStyleSourceTracker.h"
+#include "kis_paint_device.h"
+#include "kis_default_bounds_base.h"
 
 
 struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
@@ -33,6 +36,7 @@ struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
 
     KisCachedPaintDevice cachedPaintDevice;
     KisCachedSelection cachedSelection;
+    KisLayerStyleSourceTracker sourceTracker;
     KisLayer *sourceLayer = 0;
 
 
@@ -213,10 +217,27 @@ QRect KisLayerStyleProjectionPlane::recalculate(const QRect& rect, KisNodeSP fil
     QRect result = rect;
 
     if (m_d->style->isEnabled()) {
-        result = sourcePlane->recalculate(stylesNeedRect(rect), filthyNode);
+        const QRect needRect = stylesNeedRect(rect);
+        result = sourcePlane->recalculate(needRect, filthyNode);
+
+        /**
+         * Most of the updates come from painting on the layer, which changes
+         * just a small part of the need rect, while the styles are expensive
+         * to compute. So every style is recalculated only around the areas
+         * of the source that have actually changed. The level of detail
+         * mode is rare and short-living, so it is just recalculated fully.
+         */
+        if (m_d->sourceLayer->original()->defaultBounds()->currentLevelOfDetail() > 0) {
+            Q_FOREACH (const KisAbstractProjectionPlaneSP plane, m_d->allStyles()) {
+                plane->recalculate(rect, filthyNode);
+            }
+        } else {
+            const QVector<QRect> changes =
+                m_d->sourceTracker.fetchChanges(m_d->sourceLayer->projection(), needRect);
 
-        Q_FOREACH (const KisAbstractProjectionPlaneSP plane, m_d->allStyles()) {
-            plane->recalculate(rect, filthyNode);
+            Q_FOREACH (const KisLayerStyleFilterProjectionPlaneSP plane, m_d->allStyles()) {
+                plane->recalculateChanged(rect, changes);
+            }
         }
     } else {
         result = sourcePlane->recalculate(rect, filthyNode);
@@ -149,7 +149,7 @@ void KisLsDropShadowFilter::applyDropShadow(KisPaintDeviceSP srcDevice,
      * Spread and blur the selection
      */
     if (d.spread_size) {
-        KisLsUtils::applyGaussianWithTransaction(selection, d.blurNeedRect, d.spread_size);
+        KisLsUtils::applyGaussianWithTransaction(selection, d.blurNeedRect, d.spread_size, env->useFastBlur());
 
         // TODO: find out why in libpsd we pass false here. If we do so,
         //       the result is fully black, which is not expected
@@ -159,7 +159,7 @@ void KisLsDropShadowFilter::applyDropShadow(KisPaintDeviceSP srcDevice,
     //selection->convertToQImage(0, QRect(0,0,300,300)).save("1_selection_spread.png");
 
     if (d.blur_size) {
-        KisLsUtils::applyGaussianWithTransaction(selection, d.noiseNeedRect, d.blur_size);
+        KisLsUtils::applyGaussianWithTransaction(selection, d.noiseNeedRect, d.blur_size, env->useFastBlur());
     }
     //selection->convertToQImage(0, QRect(0,0,300,300)).save("2_selection_blur.png");
 
@@ -143,7 +143,7 @@ void KisLsSatinFilter::applySatin(KisPaintDeviceSP srcDevice,
 
     //KIS_DUMP_DEVICE_2(tempSelection, QRect(0,0,64,64), "00_selection", "dd");
 
-    KisLsUtils::applyGaussianWithTransaction(tempSelection, d.satinNeedRect, d.blur_size);
+    KisLsUtils::applyGaussianWithTransaction(tempSelection, d.satinNeedRect, d.blur_size, env->useFastBlur());
 
     //KIS_DUMP_DEVICE_2(tempSelection, QRect(0,0,64,64), "01_gauss", "dd");
 
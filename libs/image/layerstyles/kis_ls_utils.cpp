@@ -100,12 +100,20 @@ namespace KisLsUtils
 
     void applyGaussianWithTransaction(KisPixelSelectionSP selection,
                                       const QRect &applyRect,
-                                      qreal radius)
+                                      qreal radius,
+                                      bool fast)
     {
-        KisGaussianKernel::applyGaussian(selection, applyRect,
-                                         radius, radius,
-                                         QBitArray(), 0, true,
-                                         BORDER_IGNORE);
+        if (fast) {
+            KisGaussianKernel::applyFastGaussian(selection, applyRect,
+                                                 radius, radius,
+                                                 QBitArray(), 0,
+                                                 BORDER_IGNORE);
+        } else {
+            KisGaussianKernel::applyGaussian(selection, applyRect,
+                                             radius, radius,
+                                             QBitArray(), 0, true,
+                                             BORDER_IGNORE);
+        }
     }
 
     namespace Private {
@@ -35,7 +35,8 @@ namespace KisLsUtils
     QRect growRectFromRadius(const QRect &rc, int radius);
     void applyGaussianWithTransaction(KisPixelSelectionSP selection,
                                       const QRect &applyRect,
-                                      qreal radius);
+                                      qreal radius,
+                                      bool fast = false);
 
     static const int FULL_PERCENT_RANGE = 100;
     void adjustRange(KisPixelSelectionSP selection, const QRect &applyRect, const int range);
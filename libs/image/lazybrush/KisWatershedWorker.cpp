@@ -21,6 +21,9 @@
 #include "kis_scanline_fill.h"
 
 #include "kis_random_accessor_ng.h"
+#include "krita_utils.h"
+
+#include <QtConcurrent>
 
 #include <boost/heap/fibonacci_heap.hpp>
 #include <set>
@@ -136,20 +139,26 @@ struct CompareTaskPoints {
  */
 void mergeHeightmapOntoStroke(KisPaintDeviceSP stroke, KisPaintDeviceSP heightMap, const QRect &rc)
 {
-    KisSequentialIterator dstIt(stroke, rc);
-    KisSequentialConstIterator mapIt(heightMap, rc);
-
-    while (dstIt.nextPixel() && mapIt.nextPixel()) {
-        quint8 *dstPtr = dstIt.rawData();
-
-        if (*dstPtr > 0) {
-            const quint8 *mapPtr = mapIt.rawDataConst();
-            *dstPtr = qMax(quint8(1), *mapPtr);
-        } else {
-            *dstPtr = 0;
-        }
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(rc, KritaUtils::optimalPatchSize());
+
+    QtConcurrent::blockingMap(patches,
+        [stroke, heightMap] (const QRect &patchRect) {
+            KisSequentialIterator dstIt(stroke, patchRect);
+            KisSequentialConstIterator mapIt(heightMap, patchRect);
+
+            while (dstIt.nextPixel() && mapIt.nextPixel()) {
+                quint8 *dstPtr = dstIt.rawData();
+
+                if (*dstPtr > 0) {
+                    const quint8 *mapPtr = mapIt.rawDataConst();
+                    *dstPtr = qMax(quint8(1), *mapPtr);
+                } else {
+                    *dstPtr = 0;
+                }
 
-    }
+            }
+        });
 }
 
 void parseColorIntoGroups(QVector<FillGroup> &groups,
@@ -198,6 +207,7 @@ struct KisWatershedWorker::Private
 
     KisPaintDeviceSP heightMap;
     KisPaintDeviceSP dstDevice;
+    KisPaintDeviceSP colorIndexMap;
 
     QRect boundingRect;
     QVector<KeyStroke> keyStrokes;
@@ -294,6 +304,12 @@ void KisWatershedWorker::addKeyStroke(KisPaintDeviceSP dev, const KoColor &color
     }
 }
 
+void KisWatershedWorker::setColorIndexMap(KisPaintDeviceSP dev)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!dev || dev->pixelSize() == 4);
+    m_d->colorIndexMap = dev;
+}
+
 void KisWatershedWorker::run(qreal cleanUpAmount)
 {
     if (!m_d->heightMap) return;
@@ -706,9 +722,6 @@ void KisWatershedWorker::Private::processQueue(qint32 _backgroundGroupId)
 
 void KisWatershedWorker::Private::writeColoring()
 {
-    KisSequentialConstIterator srcIt(groupsMap, boundingRect);
-    KisSequentialIterator dstIt(dstDevice, boundingRect);
-
     QVector<KoColor> colors;
     for (auto it = keyStrokes.begin(); it != keyStrokes.end(); ++it) {
         KoColor color = it->color;
@@ -717,16 +730,37 @@ void KisWatershedWorker::Private::writeColoring()
     }
     const int colorPixelSize = dstDevice->pixelSize();
 
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(boundingRect, KritaUtils::optimalPatchSize());
 
-    while (srcIt.nextPixel() && dstIt.nextPixel()) {
-        const qint32 *srcPtr = reinterpret_cast<const qint32*>(srcIt.rawDataConst());
+    const QVector<FillGroup> &constGroups = groups;
+    const QVector<KoColor> &constColors = colors;
 
-        const int colorIndex = groups[*srcPtr].colorIndex;
-        if (colorIndex >= 0) {
-            memcpy(dstIt.rawData(), colors[colorIndex].data(), colorPixelSize);
-        }
+    QtConcurrent::blockingMap(patches,
+        [&] (const QRect &patchRect) {
+            KisSequentialConstIterator srcIt(groupsMap, patchRect);
+            KisSequentialIterator dstIt(dstDevice, patchRect);
 
-    }
+            while (srcIt.nextPixel() && dstIt.nextPixel()) {
+                const qint32 *srcPtr = reinterpret_cast<const qint32*>(srcIt.rawDataConst());
+
+                const int colorIndex = constGroups[*srcPtr].colorIndex;
+                if (colorIndex >= 0) {
+                    memcpy(dstIt.rawData(), constColors[colorIndex].data(), colorPixelSize);
+                }
+
+            }
+
+            if (colorIndexMap) {
+                KisSequentialConstIterator groupIt(groupsMap, patchRect);
+                KisSequentialIterator indexIt(colorIndexMap, patchRect);
+
+                while (groupIt.nextPixel() && indexIt.nextPixel()) {
+                    const qint32 *groupPtr = reinterpret_cast<const qint32*>(groupIt.rawDataConst());
+                    *reinterpret_cast<qint32*>(indexIt.rawData()) = constGroups[*groupPtr].colorIndex + 1;
+                }
+            }
+        });
 }
 
 QVector<TaskPoint> KisWatershedWorker::Private::tryRemoveConflictingPlane(qint32 group, quint8 level)
@@ -46,6 +46,16 @@ public:
      */
     void addKeyStroke(KisPaintDeviceSP dev, const KoColor &color);
 
+    /**
+     * @brief Makes the worker additionally write the index of the key stroke
+     *        owning every pixel into \p dev
+     *
+     * @param dev a device with 4 bytes per pixel, every pixel of the bounding
+     *            rect gets the index of the stroke (in the order of addKeyStroke()
+     *            calls) plus one, or zero if the pixel is not colored
+     */
+    void setColorIndexMap(KisPaintDeviceSP dev);
+
     /**
      * @brief run the filling process using the passes height map, strokes, and write
      *        the result coloring into the destination device
@@ -37,6 +37,29 @@
 
 using namespace KisLazyFillTools;
 
+namespace {
+
+/**
+ * Everything the segmentation depends on, except for the colors
+ * of the key strokes
+ */
+struct ColorIndexMapState : public boost::equality_comparable<ColorIndexMapState>
+{
+    int sourceSequenceNumber = -1;
+    FilteringOptions filteringOptions;
+    QRect fillBounds;
+    QVector<QPair<KisPaintDeviceSP, int>> keyStrokes;
+
+    friend bool operator==(const ColorIndexMapState &lhs, const ColorIndexMapState &rhs) {
+        return lhs.sourceSequenceNumber == rhs.sourceSequenceNumber &&
+            lhs.filteringOptions == rhs.filteringOptions &&
+            lhs.fillBounds == rhs.fillBounds &&
+            lhs.keyStrokes == rhs.keyStrokes;
+    }
+};
+
+}
+
 struct KisColorizeMask::Private
 {
     Private(KisColorizeMask *_q, KisImageWSP image)
@@ -44,6 +67,7 @@ struct KisColorizeMask::Private
           coloringProjection(new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8())),
           fakePaintDevice(new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8())),
           filteredSource(new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8())),
+          colorIndexMap(new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8())),
           needAddCurrentKeyStroke(false),
           showKeyStrokes(true),
           showColoring(true),
@@ -68,6 +92,7 @@ struct KisColorizeMask::Private
           coloringProjection(new KisPaintDevice(*rhs.coloringProjection)),
           fakePaintDevice(new KisPaintDevice(*rhs.fakePaintDevice)),
           filteredSource(new KisPaintDevice(*rhs.filteredSource)),
+          colorIndexMap(new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8())),
           filteredDeviceBounds(rhs.filteredDeviceBounds),
           needAddCurrentKeyStroke(rhs.needAddCurrentKeyStroke),
           showKeyStrokes(rhs.showKeyStrokes),
@@ -93,6 +118,18 @@ struct KisColorizeMask::Private
     KisPaintDeviceSP coloringProjection;
     KisPaintDeviceSP fakePaintDevice;
     KisPaintDeviceSP filteredSource;
+
+    /**
+     * The index of the key stroke owning every pixel of the last coloring,
+     * see KisColorizeStrokeStrategy::setColorIndexMap(). The coloring
+     * doesn't depend on the colors of the key strokes, so when nothing
+     * but the colors has changed since the last run, the map is just
+     * repainted instead of running the segmentation again.
+     */
+    KisPaintDeviceSP colorIndexMap;
+    bool colorIndexMapValid = false;
+    ColorIndexMapState colorIndexMapState;
+
     QRect filteredDeviceBounds;
 
     KoColor currentColor;
@@ -350,6 +387,27 @@ void KisColorizeMask::slotUpdateRegenerateFilling(bool prefilterOnly)
 
         strategy->setFilteringOptions(m_d->filteringOptions);
 
+        if (!prefilterOnly) {
+            ColorIndexMapState state;
+            state.sourceSequenceNumber = src->sequenceNumber();
+            state.filteringOptions = m_d->filteringOptions;
+            state.fillBounds = fillBounds;
+            Q_FOREACH (const KeyStroke &stroke, m_d->keyStrokes) {
+                state.keyStrokes.append(qMakePair(stroke.dev, stroke.dev->sequenceNumber()));
+            }
+
+            const bool colorIndexMapValid =
+                filteredSourceValid &&
+                m_d->colorIndexMapValid &&
+                m_d->colorIndexMapState == state;
+
+            strategy->setColorIndexMap(m_d->colorIndexMap, colorIndexMapValid);
+
+            // the map becomes valid again only when the stroke has finished
+            m_d->colorIndexMapValid = false;
+            m_d->colorIndexMapState = state;
+        }
+
         Q_FOREACH (const KeyStroke &stroke, m_d->keyStrokes) {
             const KoColor color =
                 !stroke.isTransparent ?
@@ -403,6 +461,7 @@ void KisColorizeMask::slotRegenerationFinished(bool prefilterOnly)
 
     if (!prefilterOnly) {
         m_d->setNeedsUpdateImpl(false, false);
+        m_d->colorIndexMapValid = true;
     }
 
     QRect oldExtent;
@@ -418,6 +477,7 @@ void KisColorizeMask::slotRegenerationFinished(bool prefilterOnly)
 
 void KisColorizeMask::slotRegenerationCancelled()
 {
+    m_d->colorIndexMapValid = false;
     slotRegenerationFinished(true);
 }
 
@@ -988,6 +1048,7 @@ void KisColorizeMask::resetCache()
     m_d->filteredSource->clear();
     m_d->originalSequenceNumber = -1;
     m_d->filteringDirty = true;
+    m_d->colorIndexMapValid = false;
 
     rerenderFakePaintDevice();
     slotUpdateRegenerateFilling(true);
@@ -1163,4 +1224,6 @@ void KisColorizeMask::moveAllInternalDevices(const QPoint &diff)
     Q_FOREACH (KisPaintDeviceSP dev, devices) {
         dev->moveTo(dev->offset() + diff);
     }
+
+    m_d->colorIndexMapValid = false;
 }
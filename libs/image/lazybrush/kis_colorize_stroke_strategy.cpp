@@ -21,6 +21,9 @@
 #include "kis_processing_visitor.h"
 
 #include "kis_transaction.h"
+#include "kis_sequential_iterator.h"
+#include <KoColorSpaceRegistry.h>
+#include <KoColorSpaceMaths.h>
 
 #include <KisRunnableStrokeJobData.h>
 #include <KisRunnableStrokeJobUtils.h>
@@ -43,7 +46,16 @@ struct KisColorizeStrokeStrategy::Private
         , levelOfDetail(_levelOfDetail)
         , keyStrokes(rhs.keyStrokes)
         , filteringOptions(rhs.filteringOptions)
-    {}
+    {
+        // the map is never downscaled, so the clones segment from scratch
+        if (levelOfDetail > 0) {
+            colorIndexMap = 0;
+            colorIndexMapValid = false;
+        } else {
+            colorIndexMap = rhs.colorIndexMap;
+            colorIndexMapValid = rhs.colorIndexMapValid;
+        }
+    }
 
     KisNodeSP progressNode;
     KisPaintDeviceSP src;
@@ -54,6 +66,9 @@ struct KisColorizeStrokeStrategy::Private
     bool filteredSourceValid;
     QRect boundingRect;
 
+    KisPaintDeviceSP colorIndexMap;
+    bool colorIndexMapValid = false;
+
     bool prefilterOnly = false;
     int levelOfDetail = 0;
 
@@ -120,6 +135,12 @@ void KisColorizeStrokeStrategy::addKeyStroke(KisPaintDeviceSP dev, const KoColor
     m_d->keyStrokes << KeyStroke(dev, convertedColor);
 }
 
+void KisColorizeStrokeStrategy::setColorIndexMap(KisPaintDeviceSP colorIndexMap, bool colorIndexMapValid)
+{
+    m_d->colorIndexMap = colorIndexMap;
+    m_d->colorIndexMapValid = colorIndexMapValid && colorIndexMap;
+}
+
 void KisColorizeStrokeStrategy::initStrokeCallback()
 {
     using namespace KritaUtils;
@@ -130,10 +151,34 @@ void KisColorizeStrokeStrategy::initStrokeCallback()
         splitRectIntoPatches(m_d->boundingRect, optimalPatchSize());
 
     if (!m_d->filteredSourceValid) {
-        // TODO: make this conversion concurrent!!!
-        KisPaintDeviceSP filteredMainDev = KisPainter::convertToAlphaAsAlpha(m_d->src);
+        KisPaintDeviceSP filteredMainDev = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
         filteredMainDev->setDefaultBounds(m_d->src->defaultBounds());
 
+        /**
+         * The same conversion as KisPainter::convertToAlphaAsAlpha() does,
+         * but split into patches. The whole extent of the source is
+         * converted, because the filters below read outside the
+         * bounding rect.
+         */
+        KisPaintDeviceSP src = m_d->src;
+        Q_FOREACH (const QRect &rc, splitRectIntoPatches(src->extent(), optimalPatchSize())) {
+            addJobConcurrent(jobs, [src, filteredMainDev, rc] () {
+                const KoColorSpace *srcCS = src->colorSpace();
+
+                KisSequentialConstIterator srcIt(src, rc);
+                KisSequentialIterator dstIt(filteredMainDev, rc);
+
+                while (srcIt.nextPixel() && dstIt.nextPixel()) {
+                    const quint8 *srcPtr = srcIt.rawDataConst();
+
+                    const quint8 white = srcCS->intensity8(srcPtr);
+                    const quint8 alpha = srcCS->opacityU8(srcPtr);
+
+                    *dstIt.rawData() = KoColorSpaceMaths<quint8>::multiply(alpha, KoColorSpaceMathsTraits<quint8>::unitValue - white);
+                }
+            });
+        }
+
         struct PrefilterSharedState {
             QRect boundingRect;
             KisPaintDeviceSP filteredMainDev;
@@ -222,7 +267,30 @@ void KisColorizeStrokeStrategy::initStrokeCallback()
         });
     }
 
-    if (!m_d->prefilterOnly) {
+    if (!m_d->prefilterOnly && m_d->colorIndexMapValid) {
+        QVector<KoColor> colors;
+        Q_FOREACH (const KeyStroke &stroke, m_d->keyStrokes) {
+            colors << (!stroke.isTransparent ?
+                       stroke.color : KoColor(Qt::transparent, m_d->dst->colorSpace()));
+        }
+
+        Q_FOREACH (const QRect &rc, patchRects) {
+            addJobConcurrent(jobs, [this, colors, rc] () {
+                KisSequentialConstIterator srcIt(m_d->colorIndexMap, rc);
+                KisSequentialIterator dstIt(m_d->dst, rc);
+
+                const int colorPixelSize = m_d->dst->pixelSize();
+
+                while (srcIt.nextPixel() && dstIt.nextPixel()) {
+                    const qint32 index = *reinterpret_cast<const qint32*>(srcIt.rawDataConst());
+
+                    if (index > 0 && index <= colors.size()) {
+                        memcpy(dstIt.rawData(), colors[index - 1].data(), colorPixelSize);
+                    }
+                }
+            });
+        }
+    } else if (!m_d->prefilterOnly) {
         addJobSequential(jobs, [this] () {
             m_d->heightMap = new KisPaintDevice(*m_d->filteredSource);
         });
@@ -247,6 +315,7 @@ void KisColorizeStrokeStrategy::initStrokeCallback()
 
                 worker.addKeyStroke(stroke.dev, color);
             }
+            worker.setColorIndexMap(m_d->colorIndexMap);
             worker.run(m_d->filteringOptions.cleanUpAmount);
         });
     }
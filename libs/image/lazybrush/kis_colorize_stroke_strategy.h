@@ -40,6 +40,17 @@ public:
 
     void addKeyStroke(KisPaintDeviceSP dev, const KoColor &color);
 
+    /**
+     * Sets a 4-byte-per-pixel device storing the index of the key stroke
+     * owning every pixel of the coloring (plus one, zero means the pixel
+     * is not colored). When \p colorIndexMapValid is true, the map is
+     * expected to be the result of the segmentation of exactly the same
+     * source and key strokes, so the stroke just repaints the map with
+     * the current colors of the key strokes. Otherwise the map is
+     * regenerated together with the coloring.
+     */
+    void setColorIndexMap(KisPaintDeviceSP colorIndexMap, bool colorIndexMapValid);
+
     void initStrokeCallback() override;
     void cancelStrokeCallback() override;
     // TODO: suspend/resume
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeLatencyMonitorTest.h"
+
+#include <QTest>
+
+#include "KisStrokeLatencyMonitor.h"
+
+void KisStrokeLatencyMonitorTest::init()
+{
+    KisStrokeLatencyMonitor::instance()->setEnabled(true);
+}
+
+void KisStrokeLatencyMonitorTest::cleanup()
+{
+    KisStrokeLatencyMonitor::instance()->setEnabled(false);
+}
+
+void KisStrokeLatencyMonitorTest::testDisabled()
+{
+    KisStrokeLatencyMonitor *monitor = KisStrokeLatencyMonitor::instance();
+    monitor->setEnabled(false);
+
+    monitor->startStrokeMeasure();
+    QCOMPARE(monitor->registerInputEvent(), quint64(0));
+    monitor->endStrokeMeasure();
+}
+
+void KisStrokeLatencyMonitorTest::testFullPipeline()
+{
+    KisStrokeLatencyMonitor *monitor = KisStrokeLatencyMonitor::instance();
+
+    monitor->startStrokeMeasure();
+
+    const quint64 id1 = monitor->registerInputEvent();
+    const quint64 id2 = monitor->registerInputEvent();
+    QVERIFY(id1);
+    QVERIFY(id2 > id1);
+
+    QTest::qSleep(10);
+
+    // the smoothing has merged the two events into a single dab
+    monitor->reportEventPainted(id2);
+    monitor->reportDirtyRects({QRect(0, 0, 64, 64)}, 0);
+    monitor->reportProjectionUpdated(QRect(0, 0, 64, 64), 0);
+    monitor->reportTexturesUploaded(QRect(0, 0, 128, 128));
+
+    monitor->endStrokeMeasure();
+
+    // the stroke is reported only when its events are on screen
+    QCOMPARE(monitor->lastStrokeStatistics().numEvents, 0);
+
+    monitor->reportFramePresented();
+
+    const KisStrokeLatencyMonitor::Statistics stats = monitor->lastStrokeStatistics();
+    QCOMPARE(stats.numEvents, 2);
+    QCOMPARE(stats.numDroppedEvents, 0);
+    QVERIFY(stats.p50 >= 10.0);
+    QVERIFY(stats.p99 >= stats.p50);
+    QVERIFY(stats.max >= stats.p99);
+}
+
+void KisStrokeLatencyMonitorTest::testPartialUpdates()
+{
+    KisStrokeLatencyMonitor *monitor = KisStrokeLatencyMonitor::instance();
+
+    monitor->startStrokeMeasure();
+
+    monitor->reportEventPainted(monitor->registerInputEvent());
+    monitor->reportDirtyRects({QRect(0, 0, 64, 64)}, 0);
+    monitor->endStrokeMeasure();
+
+    // only a half of the dab is merged and presented
+    monitor->reportProjectionUpdated(QRect(0, 0, 32, 64), 0);
+    monitor->reportTexturesUploaded(QRect(0, 0, 32, 64));
+    monitor->reportFramePresented();
+    QCOMPARE(monitor->lastStrokeStatistics().numEvents, 0);
+
+    monitor->reportProjectionUpdated(QRect(32, 0, 32, 64), 0);
+    monitor->reportFramePresented();
+    QCOMPARE(monitor->lastStrokeStatistics().numEvents, 0);
+
+    monitor->reportTexturesUploaded(QRect(32, 0, 32, 64));
+    monitor->reportFramePresented();
+    QCOMPARE(monitor->lastStrokeStatistics().numEvents, 1);
+}
+
+void KisStrokeLatencyMonitorTest::testLevelOfDetail()
+{
+    KisStrokeLatencyMonitor *monitor = KisStrokeLatencyMonitor::instance();
+
+    monitor->startStrokeMeasure();
+
+    const quint64 id = monitor->registerInputEvent();
+    monitor->reportEventPainted(id);
+    monitor->reportDirtyRects({QRect(0, 0, 32, 32)}, 1);
+
+    // the updates of the other levels of detail do not count
+    monitor->reportProjectionUpdated(QRect(0, 0, 32, 32), 0);
+    monitor->reportTexturesUploaded(QRect(0, 0, 64, 64));
+    monitor->reportFramePresented();
+
+    monitor->reportProjectionUpdated(QRect(0, 0, 32, 32), 1);
+
+    // the canvas works in the full-size coordinates
+    monitor->reportTexturesUploaded(QRect(0, 0, 32, 32));
+    monitor->endStrokeMeasure();
+    monitor->reportFramePresented();
+    QCOMPARE(monitor->lastStrokeStatistics().numEvents, 0);
+
+    monitor->reportTexturesUploaded(QRect(0, 0, 64, 64));
+
+    // the LoD0 stroke paints the same event once more
+    monitor->reportEventPainted(id);
+
+    monitor->reportFramePresented();
+    QCOMPARE(monitor->lastStrokeStatistics().numEvents, 1);
+}
+
+void KisStrokeLatencyMonitorTest::testDroppedEvents()
+{
+    KisStrokeLatencyMonitor *monitor = KisStrokeLatencyMonitor::instance();
+
+    monitor->startStrokeMeasure();
+    monitor->reportEventPainted(monitor->registerInputEvent());
+    monitor->reportDirtyRects({QRect(0, 0, 64, 64)}, 0);
+    monitor->endStrokeMeasure();
+
+    // the next stroke has started before the previous one was shown
+    monitor->startStrokeMeasure();
+
+    const KisStrokeLatencyMonitor::Statistics stats = monitor->lastStrokeStatistics();
+    QCOMPARE(stats.numEvents, 0);
+    QCOMPARE(stats.numDroppedEvents, 1);
+
+    monitor->endStrokeMeasure();
+}
+
+QTEST_MAIN(KisStrokeLatencyMonitorTest)
@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKELATENCYMONITORTEST_H
+#define KISSTROKELATENCYMONITORTEST_H
+
+#include <QtTest>
+
+class KisStrokeLatencyMonitorTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testDisabled();
+    void testFullPipeline();
+    void testPartialUpdates();
+    void testLevelOfDetail();
+    void testDroppedEvents();
+};
+
+#endif // KISSTROKELATENCYMONITORTEST_H
@@ -9,6 +9,8 @@
 #include "kis_merge_walker.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_async_merger.h"
+#include "KisFusedLayersBlender.h"
+#include "kis_painter.h"
 
 #include <QTest>
 #include <KoColorSpaceRegistry.h>
@@ -497,5 +499,70 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
 }
 
 
+void KisAsyncMergerTest::testFusedPaintLayers()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 300, 300, cs, "fused merger test");
+
+    struct LayerInfo {
+        QRect rect;
+        QColor color;
+        quint8 opacity;
+        QString compositeOp;
+        QPoint offset;
+    };
+
+    // the third layer has channel flags, so it breaks the run of fused layers
+    const QVector<LayerInfo> layers({
+        {QRect(10, 10, 200, 200), Qt::red, OPACITY_OPAQUE_U8, COMPOSITE_OVER, QPoint()},
+        {QRect(50, 50, 150, 100), Qt::green, 128, COMPOSITE_MULT, QPoint(13, 7)},
+        {QRect(0, 0, 100, 250), Qt::blue, 200, COMPOSITE_OVER, QPoint()},
+        {QRect(30, 100, 200, 150), Qt::yellow, 100, COMPOSITE_ADD, QPoint(-5, 31)},
+        {QRect(100, 20, 150, 230), Qt::cyan, 77, COMPOSITE_OVER, QPoint(70, 3)}
+    });
+
+    KisPaintDeviceSP reference = new KisPaintDevice(cs);
+    KisLayerSP topLayer;
+
+    for (int i = 0; i < layers.size(); i++) {
+        const LayerInfo &info = layers[i];
+
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i), info.opacity);
+        layer->setCompositeOpId(info.compositeOp);
+        layer->paintDevice()->fill(info.rect, KoColor(info.color, cs));
+        layer->paintDevice()->moveTo(info.offset);
+
+        QBitArray channelFlags;
+        if (i == 2) {
+            channelFlags = cs->channelFlags(true, true);
+            channelFlags.clearBit(0);
+            layer->setChannelFlags(channelFlags);
+        }
+
+        image->addNode(layer, image->rootLayer());
+        topLayer = layer;
+
+        KisPainter gc(reference);
+        gc.setCompositeOp(info.compositeOp);
+        gc.setOpacity(info.opacity);
+        gc.setChannelFlags(channelFlags);
+        gc.bitBlt(info.rect.topLeft() + info.offset, layer->paintDevice(), info.rect.translated(info.offset));
+    }
+
+    QVERIFY(KisFusedLayersBlender::canFuse(image->root()->firstChild()->projectionLeaf(),
+                                           image->rootLayer()->original()));
+    QVERIFY(!KisFusedLayersBlender::canFuse(image->root()->at(2)->projectionLeaf(),
+                                            image->rootLayer()->original()));
+
+    KisMergeWalker walker(image->bounds());
+    KisAsyncMerger merger;
+
+    walker.collectRects(topLayer, image->bounds());
+    merger.startMerge(walker);
+
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(image->rootLayer()->projection(), reference));
+}
+
+
 QTEST_MAIN(KisAsyncMergerTest)
 
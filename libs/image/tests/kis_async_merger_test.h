@@ -29,6 +29,8 @@ private Q_SLOTS:
 
     void testFilterMaskOnFilterLayer();
 
+    void testFusedPaintLayers();
+
 };
 
 #endif /* KIS_ASYNC_MERGER_TEST_H */
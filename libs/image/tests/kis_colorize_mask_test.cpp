@@ -204,4 +204,48 @@ void KisColorizeMaskTest::testCrop()
     QCOMPARE(strokes[2].dev->exactBounds(), QRect(0,0,5,5));
 }
 
+void KisColorizeMaskTest::testRecolorKeyStrokes()
+{
+    ColorizeMaskTester t;
+
+    // deliver the signals of the finished regeneration
+    QTest::qWait(50);
+
+    KisColorizeMask::KeyStrokeColors colors = t.mask->keyStrokesColors();
+    colors.colors[0] = KoColor(Qt::yellow, t.mask->colorSpace());
+    colors.transparentIndex = 1;
+
+    t.mask->setKeyStrokesColors(colors);
+    t.p.image->waitForDone();
+
+    // only the colors have changed, so the coloring is repainted from the cached map
+    t.mask->testingRegenerateMask();
+    t.p.image->waitForDone();
+    QTest::qWait(50);
+
+    KisPaintDeviceSP recolored = new KisPaintDevice(*t.mask->coloringProjection());
+
+    QColor c;
+    recolored->pixel(55, 60, &c);
+    QCOMPARE(c, QColor(Qt::yellow));
+
+    // the full segmentation should give exactly the same result
+    t.mask->resetCache();
+    t.p.image->waitForDone();
+    t.mask->testingRegenerateMask();
+    t.p.image->waitForDone();
+
+    KisPaintDeviceSP regenerated = t.mask->coloringProjection();
+
+    QCOMPARE(recolored->exactBounds(), regenerated->exactBounds());
+
+    const QRect rc = t.refRect;
+    QByteArray recoloredBytes(rc.width() * rc.height() * recolored->pixelSize(), 0);
+    QByteArray regeneratedBytes(rc.width() * rc.height() * regenerated->pixelSize(), 0);
+    recolored->readBytes(reinterpret_cast<quint8*>(recoloredBytes.data()), rc);
+    regenerated->readBytes(reinterpret_cast<quint8*>(regeneratedBytes.data()), rc);
+
+    QVERIFY(recoloredBytes == regeneratedBytes);
+}
+
 KISTEST_MAIN(KisColorizeMaskTest)
@@ -15,6 +15,7 @@ class KisColorizeMaskTest : public QObject
 private Q_SLOTS:
     void test();
     void testCrop();
+    void testRecolorKeyStrokes();
 };
 
 #endif /* __KIS_COLORIZE_MASK_TEST_H */
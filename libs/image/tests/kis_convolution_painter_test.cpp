@@ -269,6 +269,87 @@ void KisConvolutionPainterTest::testAsymmSkipAlpha()
 
 
 // #include <valgrind/callgrind.h>
+void KisConvolutionPainterTest::testSeparableConvolution()
+{
+    const QRect imageRect(0, 0, 32, 32);
+    const int kernelSize = 5;
+    const int kernelRadius = kernelSize / 2;
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const int pixelSize = cs->pixelSize();
+
+    QByteArray initialData(imageRect.width() * imageRect.height() * pixelSize, 0);
+    quint8 *ptr = reinterpret_cast<quint8*>(initialData.data());
+    for (int i = 0; i < imageRect.width() * imageRect.height(); i++) {
+        ptr[0] = (i * 37) % 256;
+        ptr[1] = (i * 91 + 13) % 256;
+        ptr[2] = (i * 53 + 101) % 256;
+        ptr[3] = 255;
+        ptr += pixelSize;
+    }
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(imageRect);
+
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    src->setDefaultBounds(bounds);
+    src->writeBytes(reinterpret_cast<const quint8*>(initialData.constData()), imageRect);
+
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    dst->setDefaultBounds(bounds);
+
+    // an asymmetric product of two vectors
+    const qreal rowVector[kernelSize] = {1, 2, 3, 2, 0};
+    const qreal columnVector[kernelSize] = {1, 4, 6, 4, 1};
+
+    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> filter(kernelSize, kernelSize);
+    qreal factor = 0;
+    for (int r = 0; r < kernelSize; r++) {
+        for (int c = 0; c < kernelSize; c++) {
+            filter(r, c) = columnVector[r] * rowVector[c];
+            factor += filter(r, c);
+        }
+    }
+
+    KisConvolutionKernelSP kernel = KisConvolutionKernel::fromMatrix(filter, 0, factor);
+
+    const QRect filterRect = imageRect.adjusted(kernelRadius, kernelRadius, -kernelRadius, -kernelRadius);
+
+    KisConvolutionPainter gc(dst, KisConvolutionPainter::SPATIAL);
+    gc.applyMatrix(kernel, src, filterRect.topLeft(), filterRect.topLeft(), filterRect.size());
+
+    QByteArray resultData(filterRect.width() * filterRect.height() * pixelSize, 0);
+    dst->readBytes(reinterpret_cast<quint8*>(resultData.data()), filterRect);
+
+    const quint8 *srcPtr = reinterpret_cast<const quint8*>(initialData.constData());
+    const quint8 *resPtr = reinterpret_cast<const quint8*>(resultData.constData());
+
+    for (int y = filterRect.top(); y <= filterRect.bottom(); y++) {
+        for (int x = filterRect.left(); x <= filterRect.right(); x++) {
+            for (int ch = 0; ch < 3; ch++) {
+                qreal expected = 0;
+
+                for (int r = 0; r < kernelSize; r++) {
+                    for (int c = 0; c < kernelSize; c++) {
+                        const int srcX = x + kernelRadius - c;
+                        const int srcY = y + kernelRadius - r;
+                        expected += filter(r, c) * srcPtr[(srcY * imageRect.width() + srcX) * pixelSize + ch];
+                    }
+                }
+                expected /= factor;
+
+                if (qAbs(resPtr[ch] - expected) > 1.0) {
+                    printPixel("Actual:  ", pixelSize, const_cast<quint8*>(resPtr));
+                    dbgKrita << "Expected channel" << ch << expected << "at" << x << y;
+                    QFAIL("Failed to filter with a separable kernel");
+                }
+            }
+
+            QCOMPARE(resPtr[3], quint8(255));
+            resPtr += pixelSize;
+        }
+    }
+}
+
 void KisConvolutionPainterTest::benchmarkConvolution()
 {
     QImage referenceImage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
@@ -451,6 +532,129 @@ void KisConvolutionPainterTest::testGaussianDetailsFFTW()
     testGaussianDetails(true);
 }
 
+void KisConvolutionPainterTest::testRecursiveGaussian()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+
+    const QRect imageRect(0,0,256,256);
+    const qreal radius = 20.0;
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    refDev->fill(QRect(50,50,100,20), KoColor(Qt::white, cs));
+    refDev->fill(QRect(150,50,20,100), KoColor(Qt::white, cs));
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(imageRect);
+    refDev->setDefaultBounds(bounds);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*refDev);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createUniform2DKernel(radius, radius);
+    KisPaintDeviceSP src = new KisPaintDevice(*refDev);
+    KisConvolutionPainter refPainter(refDev, KisConvolutionPainter::SPATIAL);
+    refPainter.applyMatrix(kernel, src, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), BORDER_IGNORE);
+
+    const qreal sigma = KisGaussianKernel::sigmaFromRadius(radius);
+    KisConvolutionPainter painter(dev);
+    painter.applyRecursiveGaussian(dev, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), sigma, sigma, BORDER_IGNORE);
+
+    const QImage refImage = refDev->convertToQImage(0, imageRect);
+    const QImage image = dev->convertToQImage(0, imageRect);
+
+    int maxDifference = 0;
+
+    for (int y = 0; y < imageRect.height(); y++) {
+        for (int x = 0; x < imageRect.width(); x++) {
+            maxDifference = qMax(maxDifference, qAbs(qGray(refImage.pixel(x, y)) - qGray(image.pixel(x, y))));
+        }
+    }
+
+    // the recursive filter is an approximation of the kernel
+    QVERIFY2(maxDifference <= 4, QString("maxDifference = %1").arg(maxDifference).toLatin1());
+}
+
+void KisConvolutionPainterTest::testTripleBoxGaussian()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+
+    const QRect imageRect(0,0,256,256);
+    const qreal radius = 20.0;
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    refDev->fill(QRect(50,50,100,20), KoColor(Qt::white, cs));
+    refDev->fill(QRect(150,50,20,100), KoColor(Qt::white, cs));
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(imageRect);
+    refDev->setDefaultBounds(bounds);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*refDev);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createUniform2DKernel(radius, radius);
+    KisPaintDeviceSP src = new KisPaintDevice(*refDev);
+    KisConvolutionPainter refPainter(refDev, KisConvolutionPainter::SPATIAL);
+    refPainter.applyMatrix(kernel, src, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), BORDER_IGNORE);
+
+    KisGaussianKernel::applyFastGaussian(dev, imageRect, radius, radius, QBitArray(), 0, BORDER_IGNORE);
+
+    const QImage refImage = refDev->convertToQImage(0, imageRect);
+    const QImage image = dev->convertToQImage(0, imageRect);
+
+    int maxDifference = 0;
+
+    for (int y = 0; y < imageRect.height(); y++) {
+        for (int x = 0; x < imageRect.width(); x++) {
+            maxDifference = qMax(maxDifference, qAbs(qGray(refImage.pixel(x, y)) - qGray(image.pixel(x, y))));
+        }
+    }
+
+    // the box blurs are a coarser approximation than the recursive filter
+    QVERIFY2(maxDifference <= 6, QString("maxDifference = %1").arg(maxDifference).toLatin1());
+}
+
+void KisConvolutionPainterTest::testBlockedFFTW()
+{
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+
+    // the area is bigger than a single FFT block
+    const QRect imageRect(0,0,1400,600);
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    for (int i = 0; i < 20; i++) {
+        refDev->fill(QRect(70 * i, 25 * i, 40, 60), KoColor(Qt::white, cs));
+    }
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(imageRect);
+    refDev->setDefaultBounds(bounds);
+
+    KisPaintDeviceSP src = new KisPaintDevice(*refDev);
+    KisPaintDeviceSP dev = new KisPaintDevice(*refDev);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createUniform2DKernel(5, 5);
+
+    KisConvolutionPainter refPainter(refDev, KisConvolutionPainter::SPATIAL);
+    refPainter.applyMatrix(kernel, src, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), BORDER_REPEAT);
+
+    // convolve in place to check the blocks don't read the results of their neighbours
+    KisConvolutionPainter painter(dev, KisConvolutionPainter::FFTW);
+    painter.applyMatrix(kernel, dev, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), BORDER_REPEAT);
+
+    const QImage refImage = refDev->convertToQImage(0, imageRect);
+    const QImage image = dev->convertToQImage(0, imageRect);
+
+    int maxDifference = 0;
+
+    for (int y = 0; y < imageRect.height(); y++) {
+        for (int x = 0; x < imageRect.width(); x++) {
+            maxDifference = qMax(maxDifference, qAbs(qGray(refImage.pixel(x, y)) - qGray(image.pixel(x, y))));
+        }
+    }
+
+    QVERIFY2(maxDifference <= 1, QString("maxDifference = %1").arg(maxDifference).toLatin1());
+}
+
 #include "kis_transaction.h"
 
 void KisConvolutionPainterTest::testDilate()
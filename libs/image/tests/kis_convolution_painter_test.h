@@ -37,6 +37,8 @@ private Q_SLOTS:
     void testAsymmSkipBlue();
     void testAsymmSkipAlpha();
 
+    void testSeparableConvolution();
+
     void benchmarkConvolution();
     void testGaussianSpatial();
     void testGaussianFFTW();
@@ -47,6 +49,10 @@ private Q_SLOTS:
     void testGaussianDetailsSpatial();
     void testGaussianDetailsFFTW();
 
+    void testRecursiveGaussian();
+    void testTripleBoxGaussian();
+    void testBlockedFFTW();
+
     void testDilate();
     void testErode();
 
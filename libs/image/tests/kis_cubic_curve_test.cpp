@@ -172,4 +172,34 @@ void KisCubicCurveTest::testTransfer()
     }
 }
 
+void KisCubicCurveTest::testTransferSharing()
+{
+    const QString curveString("0,0;0.3,0.6;0.7,0.8;1,1;");
+
+    KisCubicCurve cc1;
+    cc1.fromString(curveString);
+    const QVector<qreal> transfer1 = cc1.floatTransfer();
+
+    // the equal curve gets the same table without rebuilding it
+    KisCubicCurve cc2;
+    cc2.fromString(curveString);
+    const QVector<qreal> transfer2 = cc2.floatTransfer();
+    QCOMPARE(transfer2.constData(), transfer1.constData());
+
+    // a modified curve gets its own table
+    cc2.setPoint(1, QPointF(0.3, 0.2));
+    const QVector<qreal> transfer3 = cc2.floatTransfer();
+    QVERIFY(transfer3.constData() != transfer1.constData());
+
+    const qreal denom = 1 / 255.0;
+    for (int i = 0; i < 256; ++i) {
+        QCOMPARE(transfer1[i], cc1.value(i * denom));
+        QCOMPARE(transfer3[i], cc2.value(i * denom));
+    }
+
+    // the copies keep the table of the original curve
+    KisCubicCurve cc3(cc1);
+    QCOMPARE(cc3.floatTransfer().constData(), transfer1.constData());
+}
+
 QTEST_MAIN(KisCubicCurveTest)
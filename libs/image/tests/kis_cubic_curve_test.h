@@ -26,6 +26,7 @@ private Q_SLOTS:
     void testValue();
     void testNull();
     void testTransfer();
+    void testTransferSharing();
 private:
     QPointF pt0, pt1, pt2, pt3, pt4, pt5;
 };
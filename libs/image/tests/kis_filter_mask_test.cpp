@@ -20,6 +20,7 @@
 #include "kis_types.h"
 #include "kis_image.h"
 #include <KisGlobalResourcesInterface.h>
+#include <KoColorTransformation.h>
 
 
 #include <testutil.h>
@@ -98,4 +99,68 @@ void KisFilterMaskTest::testProjectionSelected()
 
 }
 
+void KisFilterMaskTest::testFusedMasksChain()
+{
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    QImage inverted(QString(FILES_DATA_DIR) + '/' + "inverted_hakonepa.png");
+    layer->paintDevice()->convertFromQImage(qimage, 0, 0, 0);
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+    Q_ASSERT(f);
+    KisFilterConfigurationSP kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+
+    QList<KisFilterMaskSP> masks;
+
+    for (int i = 0; i < 3; i++) {
+        KisFilterMaskSP mask = new KisFilterMask(image, QString("mask%1").arg(i));
+        image->addNode(mask, layer);
+        mask->setFilter(kfc->cloneWithResourcesSnapshot());
+        mask->initSelection(layer);
+        mask->createNodeProgressProxy();
+        masks << mask;
+    }
+
+    const KoColorSpace *cs = layer->paintDevice()->colorSpace();
+
+    Q_FOREACH (KisFilterMaskSP mask, masks) {
+        QVERIFY(mask->pixelTransformation(cs, qimage.rect()));
+    }
+
+    // three inversions in a single pass
+    layer->setDirty();
+    image->waitForDone();
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, inverted, layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height()))) {
+        layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height()).save("filtermasktest3.png");
+        QFAIL(QString("Failed to create inverted image, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+
+    // the partially selected mask should break the chain
+    masks[1]->select(QRect(0, 0, qimage.width() / 2, qimage.height()), MIN_SELECTED);
+    QVERIFY(!masks[1]->pixelTransformation(cs, qimage.rect()));
+    QVERIFY(masks[1]->pixelTransformation(cs, QRect(qimage.width() / 2 + 64, 0, 64, 64)));
+
+    layer->setDirty();
+    image->waitForDone();
+
+    const QImage result = layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height());
+
+    // the left half is inverted twice, the right half three times
+    const QRect leftRect(0, 0, qimage.width() / 2, qimage.height());
+    const QRect rightRect(qimage.width() / 2, 0, qimage.width() - qimage.width() / 2, qimage.height());
+
+    if (!TestUtil::compareQImages(errpoint, qimage.copy(leftRect), result.copy(leftRect)) ||
+        !TestUtil::compareQImages(errpoint, inverted.copy(rightRect), result.copy(rightRect))) {
+
+        result.save("filtermasktest4.png");
+        QFAIL(QString("Failed to apply the broken chain, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 QTEST_MAIN(KisFilterMaskTest)
@@ -318,4 +318,33 @@ void KisGradientPainterTest::testCachedStrategy()
     QVERIFY(maxError < 2 * maxRelError);
 }
 
+#include "kis_distance_field_gradient_shape_strategy.h"
+
+void KisGradientPainterTest::testDistanceFieldStrategy()
+{
+    const QRect rc(10, 10, 100, 60);
+
+    QPainterPath path;
+    path.addRect(rc);
+
+    KisDistanceFieldGradientShapeStrategy strategy(path, rc);
+
+    // the borders of the rect are one pixel away from the outside
+    QCOMPARE(strategy.distanceAt(10, 39), 1.0);
+    QCOMPARE(strategy.distanceAt(109, 39), 1.0);
+    QCOMPARE(strategy.distanceAt(59, 10), 1.0);
+    QCOMPARE(strategy.distanceAt(59, 69), 1.0);
+    QCOMPARE(strategy.distanceAt(11, 11), 2.0);
+
+    // the middle line is the farthest from the borders
+    QCOMPARE(strategy.distanceAt(59, 39), 30.0);
+    QCOMPARE(strategy.distanceAt(59, 40), 30.0);
+    QCOMPARE(strategy.valueAt(59.5, 39.5), 1.0);
+    QCOMPARE(strategy.valueAt(10.5, 39.5), 1.0 / 30.0);
+
+    // nothing outside of the path
+    QCOMPARE(strategy.valueAt(5.0, 39.5), 0.0);
+    QCOMPARE(strategy.valueAt(59.5, 75.0), 0.0);
+}
+
 QTEST_MAIN(KisGradientPainterTest)
@@ -25,6 +25,8 @@ private Q_SLOTS:
     void testSplitDisjointPaths();
 
     void testCachedStrategy();
+
+    void testDistanceFieldStrategy();
 };
 
 #endif
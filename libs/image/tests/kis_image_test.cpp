@@ -1280,4 +1280,47 @@ void KisImageTest::testPaintOverlayMask()
     KIS_DUMP_DEVICE_2(p.image->projection(), refRect, "03_deactivated", "dd");
 }
 
+#include "KisImageMemoryBudget.h"
+
+void KisImageTest::testMemoryBudgetDegradationOrder()
+{
+    QRect refRect(0, 0, 512, 512);
+    TestUtil::MaskParent p(refRect);
+
+    p.layer->paintDevice()->fill(refRect, KoColor(Qt::yellow, p.layer->colorSpace()));
+
+    KisImageMemoryBudget *budget = p.image->memoryBudget();
+    QVector<int> calledSteps;
+
+    for (int i = 0; i < KisImageMemoryBudget::NumDegradationSteps; i++) {
+        budget->setStepHandler(KisImageMemoryBudget::DegradationStep(i),
+            [i, &calledSteps] () {
+                calledSteps << i;
+                return i == KisImageMemoryBudget::TrimUndoHistory;
+            });
+    }
+
+    // the budget fits the image, nothing should be degraded
+    budget->setBudget(budget->memoryUsage() + 1);
+    QVERIFY(budget->enforceBudget());
+    QVERIFY(calledSteps.isEmpty());
+
+    // the handlers free nothing, so every step is tried once in order
+    budget->setBudget(1);
+    QVERIFY(!budget->enforceBudget());
+
+    QVector<int> expectedSteps;
+    expectedSteps << KisImageMemoryBudget::TrimUndoHistory
+                  << KisImageMemoryBudget::DropFrameCache
+                  << KisImageMemoryBudget::DropLevelOfDetail
+                  << KisImageMemoryBudget::SwapOut;
+    QCOMPARE(calledSteps, expectedSteps);
+
+    // zero budget means unlimited
+    calledSteps.clear();
+    budget->setBudget(0);
+    QVERIFY(budget->enforceBudget());
+    QVERIFY(calledSteps.isEmpty());
+}
+
 KISTEST_MAIN(KisImageTest)
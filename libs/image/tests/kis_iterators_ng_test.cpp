@@ -462,6 +462,50 @@ void KisIteratorNGTest::sequentialIteratorWithProgressIncomplete()
     QCOMPARE(proxy.value(), proxy.max());
 }
 
+#include <KisSequentialIteratorOutOfCore.h>
+#include "tiles3/kis_tile_data_store.h"
+
+void KisIteratorNGTest::sequentialIteratorOutOfCore()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect rc(0, 0, 8 * KisTileData::WIDTH, 8 * KisTileData::HEIGHT);
+    const int numTiles = 64;
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    const qint32 numTilesBefore = store->numTilesInMemory();
+
+    {
+        KisSequentialIteratorOutOfCore it(dev, rc, OutOfCoreProgressPolicy<>(dev, rc));
+
+        while (it.nextPixel()) {
+            quint8 *ptr = it.rawData();
+            ptr[0] = quint8(it.x());
+            ptr[1] = quint8(it.y());
+            ptr[2] = quint8(it.x() ^ it.y());
+            ptr[3] = 255;
+
+            // only a couple of bands are kept in memory
+            if (it.x() == rc.left()) {
+                QVERIFY(store->numTilesInMemory() - numTilesBefore <= 3 * 8);
+            }
+        }
+    }
+
+    // all the bands are released when the iteration is completed
+    QVERIFY(store->numTilesInMemory() - numTilesBefore < numTiles);
+
+    KisSequentialConstIterator it(dev, rc);
+    while (it.nextPixel()) {
+        const quint8 *ptr = it.rawDataConst();
+        QCOMPARE(ptr[0], quint8(it.x()));
+        QCOMPARE(ptr[1], quint8(it.y()));
+        QCOMPARE(ptr[2], quint8(it.x() ^ it.y()));
+        QCOMPARE(ptr[3], quint8(255));
+    }
+}
+
 void KisIteratorNGTest::hLineIter()
 {
     allCsApplicator(&KisIteratorNGTest::hLineIter);
@@ -35,6 +35,7 @@ private Q_SLOTS:
     void sequentialIter();
     void sequentialIteratorWithProgress();
     void sequentialIteratorWithProgressIncomplete();
+    void sequentialIteratorOutOfCore();
     void hLineIter();
     void randomAccessor();
 };
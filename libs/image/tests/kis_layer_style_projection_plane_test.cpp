@@ -639,4 +639,72 @@ void KisLayerStyleProjectionPlaneTest::testBlending()
     KIS_DUMP_DEVICE_2(originalBg, rc, "04_knockout", "dd");
 }
 
+void KisLayerStyleProjectionPlaneTest::testIncrementalUpdate()
+{
+    const QRect imageRect(0, 0, 300, 300);
+    const QRect fillRect(20, 20, 200, 200);
+    const QRect strokeRect(150, 150, 40, 10);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "styles test");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+    style->dropShadow()->setSize(15);
+    style->dropShadow()->setDistance(15);
+    style->dropShadow()->setOpacity(70);
+    style->dropShadow()->setNoise(30);
+    style->dropShadow()->setEffectEnabled(true);
+
+    style->stroke()->setSize(3);
+    style->stroke()->setEffectEnabled(true);
+
+    layer->paintDevice()->fill(fillRect, KoColor(Qt::red, cs));
+
+    KisLayerStyleProjectionPlane plane(layer.data(), style);
+    KisPaintDeviceSP projection = new KisPaintDevice(cs);
+
+    {
+        plane.recalculate(imageRect, layer);
+        KisPainter painter(projection);
+        plane.apply(&painter, imageRect);
+    }
+
+    // nothing has changed, the styles should stay the same
+    {
+        const QRect changeRect = plane.changeRect(fillRect, KisLayer::N_FILTHY);
+        projection->clear(changeRect);
+
+        plane.recalculate(changeRect, layer);
+        KisPainter painter(projection);
+        plane.apply(&painter, changeRect);
+    }
+
+    // a small stroke in the middle of the shape
+    layer->paintDevice()->clear(strokeRect);
+
+    {
+        const QRect changeRect = plane.changeRect(strokeRect, KisLayer::N_FILTHY);
+        projection->clear(changeRect);
+
+        plane.recalculate(changeRect, layer);
+        KisPainter painter(projection);
+        plane.apply(&painter, changeRect);
+    }
+
+    KisLayerStyleProjectionPlane refPlane(layer.data(), style);
+    KisPaintDeviceSP refProjection = new KisPaintDevice(cs);
+
+    {
+        refPlane.recalculate(imageRect, layer);
+        KisPainter painter(refProjection);
+        refPlane.apply(&painter, imageRect);
+    }
+
+    QCOMPARE(projection->convertToQImage(0, imageRect),
+             refProjection->convertToQImage(0, imageRect));
+}
+
 KISTEST_MAIN(KisLayerStyleProjectionPlaneTest)
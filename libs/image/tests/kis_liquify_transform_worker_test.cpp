@@ -142,4 +142,47 @@ void KisLiquifyTransformWorkerTest::testIdentityTransform()
     TestUtil::checkQImage(result, "liquify_transform_test", "liquify_dev", "identity");
 }
 
+void KisLiquifyTransformWorkerTest::testIncrementalQImage()
+{
+    QImage image(TestUtil::fetchDataFileLazy("test_transform_quality_second.png"));
+    image = image.convertToFormat(QImage::Format_ARGB32);
+
+    const QRect bounds = image.rect();
+    const QTransform imageToThumbTransform = QTransform::fromScale(0.5, 0.5);
+    const QPointF srcOffset(10.3, 10.7);
+
+    QImage thumb(image.size() / 2, QImage::Format_ARGB32);
+    thumb.fill(0);
+    {
+        QPainter gc(&thumb);
+        gc.setTransform(imageToThumbTransform);
+        gc.drawImage(QPoint(), image);
+    }
+
+    KisLiquifyTransformWorker worker(bounds, 0, 8);
+
+    worker.translatePoints(QPointF(100,100), QPointF(50, 0), 50, false, 0.2);
+
+    QPointF offset;
+    worker.runOnQImage(thumb, srcOffset, imageToThumbTransform, &offset);
+
+    // a small stroke in the middle is rendered incrementally
+    worker.translatePoints(QPointF(300,300), QPointF(10, 5), 20, false, 0.2);
+    worker.rotatePoints(QPointF(320,300), M_PI / 8, 20, false, 0.2);
+
+    QPointF incrementalOffset;
+    QImage incrementalResult =
+        worker.runOnQImage(thumb, srcOffset, imageToThumbTransform, &incrementalOffset);
+
+    KisLiquifyTransformWorker refWorker(bounds, 0, 8);
+    refWorker.transformedPoints() = worker.transformedPoints();
+
+    QPointF refOffset;
+    QImage refResult =
+        refWorker.runOnQImage(thumb, srcOffset, imageToThumbTransform, &refOffset);
+
+    QCOMPARE(incrementalOffset, refOffset);
+    QCOMPARE(incrementalResult, refResult);
+}
+
 QTEST_MAIN(KisLiquifyTransformWorkerTest)
@@ -7,13 +7,63 @@
 #include "kis_math_toolbox_test.h"
 
 #include <QTest>
+#include <cmath>
 #include "kis_math_toolbox.h"
 
+#include <KoColorSpaceRegistry.h>
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+
 void KisMathToolboxTest::testCreation()
 {
     KisMathToolbox tb;
     Q_UNUSED(tb);
 }
 
+void KisMathToolboxTest::testWaveletRoundTrip()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rect(0, 0, 37, 21);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    {
+        KisSequentialIterator it(dev, rect);
+        while (it.nextPixel()) {
+            quint8 *pixel = it.rawData();
+            pixel[0] = (it.x() * 7) % 256;
+            pixel[1] = (it.y() * 11) % 256;
+            pixel[2] = (it.x() * it.y()) % 256;
+            pixel[3] = 255;
+        }
+    }
+
+    KisPaintDeviceSP orig = new KisPaintDevice(*dev);
+
+    KisMathToolbox tb;
+    KisMathToolbox::KisWavelet *wav = tb.fastWaveletTransformation(dev, rect);
+
+    // every level scales the sum of a block by sqrt(1/2), so the coarsest
+    // approximation is the sum of all the pixels divided by sqrt(size)
+    double blueSum = 0;
+    {
+        KisSequentialConstIterator it(orig, rect);
+        while (it.nextPixel()) {
+            blueSum += it.oldRawData()[0];
+        }
+    }
+    QVERIFY(qAbs(wav->coeffs[0] * std::sqrt(qreal(wav->size)) - blueSum) < blueSum * 1e-5);
+
+    dev->clear();
+    tb.fastWaveletUntransformation(dev, rect, wav);
+    delete wav;
+
+    KisSequentialConstIterator srcIt(orig, rect);
+    KisSequentialConstIterator dstIt(dev, rect);
+    while (srcIt.nextPixel() && dstIt.nextPixel()) {
+        for (int i = 0; i < 3; i++) {
+            QCOMPARE(dstIt.oldRawData()[i], srcIt.oldRawData()[i]);
+        }
+    }
+}
 
 QTEST_MAIN(KisMathToolboxTest)
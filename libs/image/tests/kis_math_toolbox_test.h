@@ -15,6 +15,7 @@ class KisMathToolboxTest : public QObject
 private Q_SLOTS:
 
     void testCreation();
+    void testWaveletRoundTrip();
 
 };
 
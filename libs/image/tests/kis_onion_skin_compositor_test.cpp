@@ -146,4 +146,70 @@ void KisOnionSkinCompositorTest::testSettings()
     QVERIFY(chk.checkDevice(compositeDevice, p.image, "02_single_skin_tinted"));
 }
 
+void KisOnionSkinCompositorTest::testTintedFramesCache()
+{
+    KisImageConfig config(false);
+    config.setOnionSkinTintFactor(64);
+    config.setOnionSkinTintColorBackward(Qt::blue);
+    config.setOnionSkinTintColorForward(Qt::red);
+    config.setNumberOfOnionSkins(1);
+    config.setOnionSkinOpacity(-1, 128);
+    config.setOnionSkinOpacity(1, 128);
+
+    KisOnionSkinCompositor *compositor = KisOnionSkinCompositor::instance();
+    compositor->configChanged();
+
+    TestUtil::MaskParent p;
+
+    KisImageAnimationInterface *i = p.image->animationInterface();
+    KisPaintDeviceSP paintDevice = p.layer->paintDevice();
+    paintDevice->createKeyframeChannel(KoID());
+    KisKeyframeChannel *keyframes = paintDevice->keyframeChannel();
+
+    keyframes->addKeyframe(0);
+    keyframes->addKeyframe(10);
+    keyframes->addKeyframe(20);
+
+    paintDevice->fill(QRect(0,0,256,512), KoColor(Qt::red, paintDevice->colorSpace()));
+
+    i->switchCurrentTimeAsync(20);
+    p.image->waitForDone();
+
+    paintDevice->fill(QRect(0,256,512,256), KoColor(Qt::blue, paintDevice->colorSpace()));
+
+    i->switchCurrentTimeAsync(10);
+    p.image->waitForDone();
+
+    KisOnionSkinCompositor::TintedFramesCache tintedFrames;
+
+    auto compareWithUncached = [&] () {
+        KisPaintDeviceSP cachedDevice = new KisPaintDevice(p.image->colorSpace());
+        compositor->composite(paintDevice, cachedDevice, QRect(0,0,512,512), &tintedFrames);
+
+        KisPaintDeviceSP uncachedDevice = new KisPaintDevice(p.image->colorSpace());
+        compositor->composite(paintDevice, uncachedDevice, QRect(0,0,512,512));
+
+        QPoint pt;
+        return TestUtil::comparePaintDevices(pt, cachedDevice, uncachedDevice);
+    };
+
+    // the first pass fills the cache, the second one reuses it
+    QVERIFY(compareWithUncached());
+    QVERIFY(compareWithUncached());
+
+    // the changed frame should be tinted again
+    i->switchCurrentTimeAsync(0);
+    p.image->waitForDone();
+    paintDevice->fill(QRect(256,0,256,512), KoColor(Qt::green, paintDevice->colorSpace()));
+
+    i->switchCurrentTimeAsync(10);
+    p.image->waitForDone();
+    QVERIFY(compareWithUncached());
+
+    // so should the frames after the tint settings change
+    config.setOnionSkinTintColorBackward(Qt::yellow);
+    compositor->configChanged();
+    QVERIFY(compareWithUncached());
+}
+
 QTEST_MAIN(KisOnionSkinCompositorTest)
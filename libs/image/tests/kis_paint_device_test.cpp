@@ -826,6 +826,39 @@ void KisPaintDeviceTest::testExactBoundsNonTransparent()
     QCOMPARE(dev->nonDefaultPixelArea(), QRect(-1,-1,1002,1002));
 }
 
+void KisPaintDeviceTest::testExactBoundsTileCache()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const KoColor red(Qt::red, cs);
+
+    dev->fill(QRect(10, 20, 300, 200), red);
+    QCOMPARE(dev->calculateExactBounds(false), QRect(10, 20, 300, 200));
+
+    // extend the content within an already existing border tile
+    dev->setPixel(5, 100, red);
+    QCOMPARE(dev->calculateExactBounds(false), QRect(5, 20, 305, 200));
+
+    // a new tile far from the content
+    dev->setPixel(1000, 500, red);
+    QCOMPARE(dev->calculateExactBounds(false), QRect(5, 20, 996, 481));
+
+    // the tile stays allocated, but becomes empty
+    dev->clear(QRect(1000, 500, 1, 1));
+    QVERIFY(dev->extent().contains(QPoint(1000, 500)));
+    QCOMPARE(dev->calculateExactBounds(false), QRect(5, 20, 305, 200));
+
+    dev->crop(QRect(0, 0, 100, 100));
+    QCOMPARE(dev->calculateExactBounds(false), QRect(5, 20, 95, 80));
+
+    dev->moveTo(QPoint(7, -3));
+    QCOMPARE(dev->calculateExactBounds(false), QRect(12, 17, 95, 80));
+
+    dev->clear();
+    QVERIFY(dev->calculateExactBounds(false).isEmpty());
+}
+
 KisPaintDeviceSP createWrapAroundPaintDevice(const KoColorSpace *cs)
 {
     struct TestingDefaultBounds : public KisDefaultBoundsBase {
@@ -1527,6 +1560,117 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+void incrementalSyncLodCache(KisPaintDeviceSP dev, int levelOfDetail, KisRegion *syncedRegion)
+{
+    KisPaintDevice::LodDataStruct* s = dev->createLodDataStruct(levelOfDetail, true);
+
+    KisRegion region = dev->regionForLodSyncing(s);
+    Q_FOREACH(QRect rect2, KritaUtils::splitRegionIntoPatches(region, KritaUtils::optimalPatchSize())) {
+        dev->updateLodDataStruct(s, rect2);
+    }
+
+    dev->uploadLodDataStruct(s);
+    delete s;
+
+    *syncedRegion = region;
+}
+
+void KisPaintDeviceTest::testIncrementalLodSync()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds();
+    dev->setDefaultBounds(bounds);
+
+    fillGradientDevice(dev, QRect(0,0,64,64));
+    fillGradientDevice(dev, QRect(200,200,30,30));
+
+    KisRegion region;
+
+    // the first sync has nothing to start from
+    bounds->testingSetLevelOfDetail(1);
+    incrementalSyncLodCache(dev, 1, &region);
+    QCOMPARE(region, dev->regionForLodSyncing());
+
+    // nothing has changed, nothing to regenerate
+    incrementalSyncLodCache(dev, 1, &region);
+    QVERIFY(region.isEmpty());
+
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(10,10,5,5), KoColor(Qt::blue, cs));
+
+    // only the changed tile is regenerated
+    bounds->testingSetLevelOfDetail(1);
+    incrementalSyncLodCache(dev, 1, &region);
+    QCOMPARE(region.boundingRect(), QRect(0,0,64,64));
+
+    const QImage incrementalResult = dev->convertToQImage(0,0,0,120,120);
+
+    syncLodCache(dev, 1);
+    const QImage fullResult = dev->convertToQImage(0,0,0,120,120);
+
+    QCOMPARE(incrementalResult, fullResult);
+
+    // painting on the LOD plane directly is overwritten on the next sync
+    dev->fill(QRect(100,100,5,5), KoColor(Qt::blue, cs));
+    incrementalSyncLodCache(dev, 1, &region);
+    QCOMPARE(region.boundingRect(), QRect(128,128,128,128));
+    QCOMPARE(dev->convertToQImage(0,0,0,120,120), fullResult);
+
+    // a different level of detail needs a full regeneration
+    bounds->testingSetLevelOfDetail(2);
+    incrementalSyncLodCache(dev, 2, &region);
+    QCOMPARE(region, dev->regionForLodSyncing());
+}
+
+#include "KisProjectionDevicesPool.h"
+
+void KisPaintDeviceTest::testProjectionDevicesPool()
+{
+    QCOMPARE(KisProjectionDevicesPool::extentClass(QRect()), 0);
+    QCOMPARE(KisProjectionDevicesPool::extentClass(QRect(0,0,64,64)), 0);
+    QCOMPARE(KisProjectionDevicesPool::extentClass(QRect(0,0,128,128)), 1);
+    QCOMPARE(KisProjectionDevicesPool::extentClass(QRect(0,0,256,256)), 2);
+
+    KisProjectionDevicesPool pool;
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(0,0,100,100), KoColor(Qt::red, cs));
+
+    // the device is still referenced by someone else
+    {
+        KisPaintDeviceSP extraReference = dev;
+        pool.releaseDevice(dev);
+        QCOMPARE(pool.numPooledDevices(), 0);
+        QCOMPARE(dev->extent(), QRect(0,0,128,128));
+    }
+
+    pool.releaseDevice(dev);
+    QCOMPARE(pool.numPooledDevices(), 1);
+    QVERIFY(dev->extent().isEmpty());
+
+    KisPaintDevice *pooledDevice = dev.data();
+    dev = 0;
+
+    // the color space doesn't match
+    KisPaintDeviceSP prototype16 = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb16());
+    QVERIFY(!pool.acquireDevice(prototype16));
+    QCOMPARE(pool.numPooledDevices(), 1);
+
+    KisPaintDeviceSP prototype = new KisPaintDevice(cs);
+    prototype->fill(QRect(10,10,50,50), KoColor(Qt::green, cs));
+
+    KisPaintDeviceSP result = pool.acquireDevice(prototype);
+    QCOMPARE(result.data(), pooledDevice);
+    QCOMPARE(pool.numPooledDevices(), 0);
+    QCOMPARE(result->exactBounds(), QRect(10,10,50,50));
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, result, prototype));
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -2198,6 +2342,51 @@ void KisPaintDeviceTest::testCopyPaintDeviceWithFrames()
     QVERIFY(channel->keyframeAt(10));
 }
 
+#include "KisConvertedBandReader.h"
+
+void KisPaintDeviceTest::testConvertedBandReader()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->rgb16();
+    const QRect rc(0, 0, 100, 230);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(10, 10, 50, 200), KoColor(QColor(255, 0, 0, 128), cs));
+    dev->fill(QRect(30, 100, 60, 100), KoColor(QColor(0, 255, 0, 255), cs));
+
+    const KoColor background(Qt::white, cs);
+
+    // the reference is flattened and converted as a whole
+    KisPaintDeviceSP ref = new KisPaintDevice(cs);
+    ref->fill(rc, background);
+    KisPainter gc(ref);
+    gc.bitBlt(rc.topLeft(), dev, rc);
+    gc.end();
+    ref->convertTo(dstCs);
+
+    KisConvertedBandReader reader(dev, dstCs);
+    reader.setBackgroundColor(background);
+    QVERIFY(!reader.isPassThrough());
+    QCOMPARE(reader.pixelSize(), int(dstCs->pixelSize()));
+
+    QVector<quint8> refBand(rc.width() * 64 * dstCs->pixelSize());
+    QVector<quint8> band(refBand.size());
+
+    for (int y = rc.y(); y <= rc.bottom(); y += 64) {
+        const QRect bandRect(rc.x(), y, rc.width(), qMin(64, rc.bottom() - y + 1));
+        const int numBytes = bandRect.width() * bandRect.height() * dstCs->pixelSize();
+
+        ref->readBytes(refBand.data(), bandRect);
+        reader.readBytes(band.data(), bandRect);
+
+        QVERIFY(memcmp(refBand.constData(), band.constData(), numBytes) == 0);
+    }
+
+    KisConvertedBandReader passThroughReader(dev);
+    QVERIFY(passThroughReader.isPassThrough());
+    QVERIFY(*passThroughReader.colorSpace() == *cs);
+}
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
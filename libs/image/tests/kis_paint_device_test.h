@@ -40,6 +40,7 @@ private Q_SLOTS:
     void testAmortizedExactBounds();
     void testNonDefaultPixelArea();
     void testExactBoundsNonTransparent();
+    void testExactBoundsTileCache();
 
     void testReadBytesWrapAround();
     void testWrappedRandomAccessor();
@@ -53,6 +54,8 @@ private Q_SLOTS:
 
     void testLodTransform();
     void testLodDevice();
+    void testIncrementalLodSync();
+    void testProjectionDevicesPool();
     void benchmarkLod1Generation();
     void benchmarkLod2Generation();
     void benchmarkLod3Generation();
@@ -66,6 +69,8 @@ private Q_SLOTS:
     void testLazyFrameCreation();
     void testCopyPaintDeviceWithFrames();
 
+    void testConvertedBandReader();
+
     void testCompositionAssociativity();
 
     void stressTestMemoryFragmentation();
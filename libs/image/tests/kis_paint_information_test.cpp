@@ -9,8 +9,11 @@
 
 #include <QTest>
 #include <brushengine/kis_paint_information.h>
+#include <brushengine/KisStrokeRecording.h>
 #include "kis_debug.h"
 
+#include <QBuffer>
+
 
 #include <QDomDocument>
 #include <Eigen/Core>
@@ -43,6 +46,49 @@ void KisPaintInformationTest::testSerialisation()
      */
 }
 
+void KisPaintInformationTest::testStrokeRecording()
+{
+    KisStrokeRecording recording;
+
+    for (int i = 0; i < 10; i++) {
+        recording.addSample(KisPaintInformation(QPointF(10.5 * i, 2.25 * i),
+                                                0.1 * i, 0.5, -0.25, 30.0,
+                                                0.75, 1.0, 8.0 * i, 0.5));
+    }
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(recording.save(&buffer));
+
+    // 40 bytes per sample plus the header
+    QCOMPARE(buffer.size(), qint64(10 + 10 * 40));
+
+    buffer.seek(0);
+
+    KisStrokeRecording loaded;
+    QVERIFY(loaded.load(&buffer));
+    QCOMPARE(loaded.numSamples(), 10);
+    QCOMPARE(loaded.duration(), 72.0);
+
+    for (int i = 0; i < 10; i++) {
+        const KisPaintInformation pi = loaded.sample(i);
+        QCOMPARE(pi.pos(), QPointF(10.5 * i, 2.25 * i));
+        QCOMPARE(float(pi.pressure()), float(0.1 * i));
+        QCOMPARE(pi.xTilt(), 0.5);
+        QCOMPARE(pi.yTilt(), -0.25);
+        QCOMPARE(pi.rotation(), 30.0);
+        QCOMPARE(pi.tangentialPressure(), 0.75);
+        QCOMPARE(pi.currentTime(), 8.0 * i);
+        QCOMPARE(pi.drawingSpeed(), 0.5);
+    }
+
+    QBuffer garbage;
+    garbage.setData(QByteArray("not a recording"));
+    garbage.open(QIODevice::ReadOnly);
+    QVERIFY(!loaded.load(&garbage));
+    QCOMPARE(loaded.numSamples(), 10);
+}
+
 #include <boost/random/taus88.hpp>
 #include <boost/random/uniform_smallint.hpp>
 
@@ -17,6 +17,7 @@ private Q_SLOTS:
 
     void testCreation();
     void testSerialisation();
+    void testStrokeRecording();
 
     void benchmarkTausRandomGeneration();
 };
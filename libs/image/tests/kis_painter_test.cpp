@@ -609,6 +609,53 @@ void KisPainterTest::testMassiveBltFixedCornerCases()
     QVERIFY(dst->extent().isEmpty());
 }
 
+void KisPainterTest::testMassiveBltFixedTileGrouped()
+{
+    const KoColorSpace* cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    KisPaintDeviceSP ref = new KisPaintDevice(cs);
+
+    QList<QColor> colors;
+    colors << QColor(255, 0, 0, 128);
+    colors << QColor(0, 255, 0, 200);
+    colors << QColor(0, 0, 255, 64);
+
+    // overlapping dabs crossing the borders of the tiles in both directions
+    QList<KisRenderedDab> devices;
+    QRect devicesRect;
+
+    for (int i = 0; i < 24; i++) {
+        const QRect rc(17 + (i % 6) * 23, 9 + (i / 6) * 31, 50, 45);
+        KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+        dev->setRect(rc);
+        dev->initialize();
+        dev->fill(rc, KoColor(colors[i % 3], cs));
+
+        devices << KisRenderedDab(dev);
+        devicesRect |= rc;
+    }
+
+    {
+        KisPainter painter(dst);
+        painter.bltFixed(devicesRect, devices);
+        painter.end();
+    }
+
+    {
+        KisPainter painter(ref);
+        Q_FOREACH (const KisRenderedDab &dab, devices) {
+            painter.bltFixed(dab.realBounds().topLeft(), dab.device, dab.device->bounds());
+        }
+        painter.end();
+    }
+
+    QPoint pt;
+    if (!TestUtil::comparePaintDevices(pt, dst, ref)) {
+        QFAIL(QString("Tile-grouped blit differs from the sequential one at %1,%2")
+              .arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+}
+
 
 #include "kis_lod_transform.h"
 
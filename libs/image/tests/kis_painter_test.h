@@ -49,6 +49,8 @@ private Q_SLOTS:
 
     void testMassiveBltFixedCornerCases();
 
+    void testMassiveBltFixedTileGrouped();
+
 
     void testOptimizedCopying();
 };
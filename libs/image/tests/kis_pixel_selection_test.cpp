@@ -10,6 +10,7 @@
 
 #include <kis_debug.h>
 #include <QRect>
+#include <QtMath>
 
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
@@ -25,6 +26,7 @@
 #include "kis_transaction.h"
 #include "kis_surrogate_undo_adapter.h"
 #include "commands/kis_selection_commands.h"
+#include "kis_selection_filters.h"
 
 
 void KisPixelSelectionTest::testCreation()
@@ -579,5 +581,121 @@ void KisPixelSelectionTest::testOutlineArtifacts()
                    QPoint(0,0)})}));
 }
 
+namespace {
+
+/**
+ * Straightforward implementation of the grow/shrink over the elliptic
+ * structuring element defined by KisSelectionFilter::computeBorder()
+ */
+QVector<quint8> referenceMorphology(const QVector<quint8> &src, const QRect &rect,
+                                    int xRadius, int yRadius,
+                                    bool grow, bool edgeLock)
+{
+    QVector<int> circ(2 * xRadius + 1);
+    for (int i = 0; i < circ.size(); i++) {
+        const qreal tmp = i == xRadius ? 0.0 : qAbs(i - xRadius) - 0.5;
+        circ[i] = qFloor(yRadius * std::sqrt(xRadius * xRadius - tmp * tmp) / xRadius + 0.5);
+    }
+
+    QVector<quint8> result(src.size());
+
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            int value = grow ? 0 : 255;
+
+            for (int i = -xRadius; i <= xRadius; i++) {
+                for (int j = -circ[i + xRadius]; j <= circ[i + xRadius]; j++) {
+                    int sx = x + i;
+                    int sy = y + j;
+                    int pixel = 0;
+
+                    if (edgeLock) {
+                        sx = qBound(0, sx, rect.width() - 1);
+                        sy = qBound(0, sy, rect.height() - 1);
+                    }
+
+                    if (sx >= 0 && sx < rect.width() && sy >= 0 && sy < rect.height()) {
+                        pixel = src[sy * rect.width() + sx];
+                    }
+
+                    value = grow ? qMax(value, pixel) : qMin(value, pixel);
+                }
+            }
+
+            result[y * rect.width() + x] = value;
+        }
+    }
+
+    return result;
+}
+
+}
+
+void KisPixelSelectionTest::testGrowShrinkFilters()
+{
+    const QRect dataRect(0, 0, 1300, 260);
+    const QRect processRect(40, 30, 1200, 200);
+
+    KisPixelSelectionSP source = new KisPixelSelection();
+
+    QVector<quint8> data(dataRect.width() * dataRect.height());
+    for (int y = 0; y < dataRect.height(); y++) {
+        for (int x = 0; x < dataRect.width(); x++) {
+            const quint32 hash = (x * 73856093U) ^ (y * 19349663U);
+            quint8 value = hash % 211 < 5 ? hash % 256 : 0;
+
+            if ((x / 90 + y / 70) % 3 == 0) {
+                value = hash % 17 ? 255 : 128;
+            }
+
+            data[y * dataRect.width() + x] = value;
+        }
+    }
+    source->writeBytes(data.constData(), dataRect);
+
+    QVector<quint8> processData(processRect.width() * processRect.height());
+    source->readBytes(processData.data(), processRect);
+
+    struct TestCase {
+        int xRadius;
+        int yRadius;
+        bool grow;
+        bool edgeLock;
+    };
+
+    const QVector<TestCase> testCases({
+        {1, 1, true, false},
+        {7, 3, true, false},
+        {3, 9, true, false},
+        {12, 12, false, false},
+        {2, 11, false, true},
+        {10, 4, false, true},
+    });
+
+    Q_FOREACH (const TestCase &testCase, testCases) {
+        KisPixelSelectionSP selection = new KisPixelSelection(*source);
+
+        if (testCase.grow) {
+            KisGrowSelectionFilter filter(testCase.xRadius, testCase.yRadius);
+            filter.process(selection, processRect);
+        } else {
+            KisShrinkSelectionFilter filter(testCase.xRadius, testCase.yRadius, testCase.edgeLock);
+            filter.process(selection, processRect);
+        }
+
+        QVector<quint8> result(processData.size());
+        selection->readBytes(result.data(), processRect);
+
+        const QVector<quint8> reference =
+            referenceMorphology(processData, processRect,
+                                testCase.xRadius, testCase.yRadius,
+                                testCase.grow, testCase.edgeLock);
+
+        QVERIFY2(result == reference,
+                 QString("radius %1x%2, %3").arg(testCase.xRadius).arg(testCase.yRadius)
+                 .arg(testCase.grow ? "grow" : "shrink").toLatin1());
+    }
+}
+
 KISTEST_MAIN(KisPixelSelectionTest)
 
@@ -35,6 +35,8 @@ private Q_SLOTS:
     void testOutlineCacheTransactions();
 
     void testOutlineArtifacts();
+
+    void testGrowShrinkFilters();
 };
 
 #endif
@@ -17,6 +17,7 @@
 #include "kis_undo_stores.h"
 #include "kis_processing_applicator.h"
 #include "processing/kis_crop_processing_visitor.h"
+#include "processing/kis_convert_color_space_processing_visitor.h"
 #include "kis_image.h"
 
 #include <testutil.h>
@@ -195,4 +196,52 @@ void KisProcessingApplicatorTest::testNoUIUpdates()
     QCOMPARE(uiSignalsCounter.size(), 0);
 }
 
+void KisProcessingApplicatorTest::testParallelTileBands()
+{
+    KisSurrogateUndoStore *undoStore = new KisSurrogateUndoStore();
+    KisPaintLayerSP paintLayer1;
+    KisPaintLayerSP paintLayer2;
+    KisImageSP image = createImage(undoStore, paintLayer1, paintLayer2);
+
+    const KoColorSpace *srcColorSpace = image->colorSpace();
+    const KoColorSpace *dstColorSpace = KoColorSpaceRegistry::instance()->rgb16();
+
+    KisPaintDeviceSP originalDevice1 = new KisPaintDevice(*paintLayer1->paintDevice());
+    KisPaintDeviceSP originalDevice2 = new KisPaintDevice(*paintLayer2->paintDevice());
+
+    // the reference is converted in a single pass
+    KisPaintDeviceSP refDevice1 = new KisPaintDevice(*originalDevice1);
+    KisPaintDeviceSP refDevice2 = new KisPaintDevice(*originalDevice2);
+    refDevice1->convertTo(dstColorSpace);
+    refDevice2->convertTo(dstColorSpace);
+
+    {
+        KisProcessingApplicator applicator(image, image->rootLayer(),
+                                           KisProcessingApplicator::RECURSIVE |
+                                           KisProcessingApplicator::PARALLEL_TILE_BANDS);
+
+        KisProcessingVisitorSP visitor =
+            new KisConvertColorSpaceProcessingVisitor(srcColorSpace, dstColorSpace,
+                                                      KoColorConversionTransformation::internalRenderingIntent(),
+                                                      KoColorConversionTransformation::internalConversionFlags());
+        applicator.applyVisitor(visitor, KisStrokeJobData::CONCURRENT);
+        applicator.end();
+        image->waitForDone();
+    }
+
+    const QRect rc = image->bounds();
+
+    QVERIFY(*paintLayer1->paintDevice()->colorSpace() == *dstColorSpace);
+    QVERIFY(*paintLayer2->paintDevice()->colorSpace() == *dstColorSpace);
+    QCOMPARE(paintLayer1->paintDevice()->convertToQImage(0, rc), refDevice1->convertToQImage(0, rc));
+    QCOMPARE(paintLayer2->paintDevice()->convertToQImage(0, rc), refDevice2->convertToQImage(0, rc));
+
+    undoStore->undo();
+    image->waitForDone();
+
+    QVERIFY(*paintLayer1->paintDevice()->colorSpace() == *srcColorSpace);
+    QCOMPARE(paintLayer1->paintDevice()->convertToQImage(0, rc), originalDevice1->convertToQImage(0, rc));
+    QCOMPARE(paintLayer2->paintDevice()->convertToQImage(0, rc), originalDevice2->convertToQImage(0, rc));
+}
+
 QTEST_MAIN(KisProcessingApplicatorTest)
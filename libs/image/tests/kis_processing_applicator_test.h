@@ -16,6 +16,7 @@ private Q_SLOTS:
     void testNonRecursiveProcessing();
     void testRecursiveProcessing();
     void testNoUIUpdates();
+    void testParallelTileBands();
 };
 
 #endif /* __KIS_PROCESSING_APPLICATOR_TEST_H */
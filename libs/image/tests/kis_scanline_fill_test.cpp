@@ -18,6 +18,7 @@
 #include <KoColorSpaceRegistry.h>
 #include "kis_types.h"
 #include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
 
 
 void KisScanlineFillTest::testFillGeneral(const QVector<KisFillInterval> &initialBackwardIntervals,
@@ -283,4 +284,54 @@ void KisScanlineFillTest::testExternalFill()
     QCOMPARE(c, QColor(Qt::blue));
 }
 
+void KisScanlineFillTest::testParallelFillSelection()
+{
+    const QRect boundingRect(-10, -20, 300, 270);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    /**
+     * A noisy maze of black and gray pixels, so that the areas wind
+     * across the borders of the bands in both directions
+     */
+    QVector<quint8> data(boundingRect.width() * boundingRect.height() * 4);
+    quint32 seed = 1;
+    for (int i = 0; i < data.size(); i += 4) {
+        seed = seed * 1103515245 + 12345;
+        const quint8 value = (seed >> 16) % 5 < 2 ? 0 : 128 + (seed >> 8) % 16;
+        data[i] = data[i + 1] = data[i + 2] = value;
+        data[i + 3] = 255;
+    }
+    dev->writeBytes(data.constData(), boundingRect);
+
+    const QVector<QPoint> startPoints({QPoint(-10, -20), QPoint(100, 100), QPoint(289, 249), QPoint(37, 63)});
+
+    Q_FOREACH (const QPoint &startPoint, startPoints) {
+        Q_FOREACH (int threshold, QVector<int>({0, 8, 200})) {
+            KisPixelSelectionSP expected = new KisPixelSelection();
+            KisPixelSelectionSP result = new KisPixelSelection();
+
+            {
+                KisScanlineFill fill(dev, startPoint, boundingRect);
+                fill.setThreshold(threshold);
+                fill.fillSelection(expected);
+            }
+
+            {
+                KisScanlineFill fill(dev, startPoint, boundingRect);
+                fill.setThreshold(threshold);
+                fill.fillSelectionParallel(result);
+            }
+
+            QVector<quint8> expectedBytes(boundingRect.width() * boundingRect.height());
+            QVector<quint8> resultBytes(boundingRect.width() * boundingRect.height());
+            expected->readBytes(expectedBytes.data(), boundingRect);
+            result->readBytes(resultBytes.data(), boundingRect);
+
+            QCOMPARE(result->exactBounds(), expected->exactBounds());
+            QVERIFY(resultBytes == expectedBytes);
+        }
+    }
+}
+
 QTEST_MAIN(KisScanlineFillTest)
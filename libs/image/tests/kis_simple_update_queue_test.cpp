@@ -140,6 +140,39 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testSplitLongStrip()
+{
+    QRect imageRect(0,0,2048,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    // a small rect crossing the patch boundary is not split
+    queue.addUpdateJob(paintLayer, QRect(400,0,200,100), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 1);
+    QVERIFY(checkWalker(walkersList[0], QRect(400,0,200,100)));
+    walkersList.clear();
+
+    // a long strip is split into patches
+    queue.addUpdateJob(paintLayer, QRect(0,0,2000,300), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 4);
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,512,300)));
+    QVERIFY(checkWalker(walkersList[1], QRect(512,0,512,300)));
+    QVERIFY(checkWalker(walkersList[2], QRect(1024,0,512,300)));
+    QVERIFY(checkWalker(walkersList[3], QRect(1536,0,464,300)));
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
@@ -231,6 +264,47 @@ void KisSimpleUpdateQueueTest::testMixingTypes()
     QCOMPARE(walkersList[2]->type(), KisBaseRectsWalker::UPDATE_NO_FILTHY);
 }
 
+void KisSimpleUpdateQueueTest::testCoveredByFullRefresh()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisGroupLayerSP groupLayer = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(groupLayer);
+    image->addNode(paintLayer, groupLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addFullRefreshJob(groupLayer, QRect(0,0,200,200), imageRect, 0);
+
+    // the update of the child is already covered by the refresh of its parent
+    queue.addUpdateJob(paintLayer, QRect(10,10,50,50), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 1);
+    QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::FULL_REFRESH);
+
+    // the update spanning outside the refreshed area is still needed
+    queue.addUpdateJob(paintLayer, QRect(150,150,100,100), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 2);
+    QCOMPARE(walkersList[1]->type(), KisBaseRectsWalker::UPDATE);
+    QVERIFY(checkWalker(walkersList[1], QRect(150,150,100,100)));
+
+    // the refresh of a child doesn't cover the update of the parent
+    walkersList.clear();
+    queue.addFullRefreshJob(paintLayer, QRect(0,0,200,200), imageRect, 0);
+    queue.addUpdateJob(groupLayer, QRect(10,10,50,50), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 2);
+}
+
 void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
 {
     KisTestableSimpleUpdateQueue queue;
@@ -267,5 +341,51 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testPriorityRegion()
+{
+    KisTestableUpdaterContext context(1);
+
+    QRect imageRect(0,0,200,200);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect dirtyRect1(0,0,50,50);
+    QRect dirtyRect2(150,150,50,50);
+
+    KisTestableSimpleUpdateQueue queue;
+    queue.setPriorityRegion(QRect(100,100,100,100));
+
+    queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+    queue.addUpdateJob(paintLayer, dirtyRect2, imageRect, 0);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+
+    // the visible update overtakes the off-screen one
+    QCOMPARE(jobs.size(), 1);
+    QVERIFY(checkWalker(jobs[0]->walker(), dirtyRect2));
+
+    KisWalkersList &walkersList = queue.getWalkersList();
+    QCOMPARE(walkersList.size(), 1);
+    QVERIFY(checkWalker(walkersList[0], dirtyRect1));
+
+    // the off-screen update is not lost
+    context.clear();
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QCOMPARE(jobs.size(), 1);
+    QVERIFY(checkWalker(jobs[0]->walker(), dirtyRect1));
+    QVERIFY(queue.isEmpty());
+}
+
 KISTEST_MAIN(KisSimpleUpdateQueueTest)
 
@@ -21,9 +21,12 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testSplitLongStrip();
     void testChecksum();
     void testMixingTypes();
+    void testCoveredByFullRefresh();
     void testSpontaneousJobsCompression();
+    void testPriorityRegion();
 };
 
 #endif /* KIS_SIMPLE_UPDATE_QUEUE_TEST_H */
@@ -178,4 +178,47 @@ void KisStrokeTest::testCancelStrokeCase6()
     stroke.clearQueueOnCancel();
 }
 
+#include "KisStrokeCancellationChecker.h"
+
+void KisStrokeTest::testCancellationRequested()
+{
+    {
+        KisTestingStrokeStrategy *strategy = new KisTestingStrokeStrategy();
+        KisStroke stroke(strategy);
+
+        stroke.addJob(0);
+        delete stroke.popOneJob(); // init
+
+        KisStrokeCancellationChecker checker(strategy, 3);
+        QVERIFY(!strategy->isCancellationRequested());
+        QVERIFY(!checker.isCancelled());
+
+        // "initialized, has jobs"
+        stroke.cancelStroke();
+        QVERIFY(strategy->isCancellationRequested());
+
+        // the checker reads the flag only on every third call
+        QVERIFY(!checker.isCancelled());
+        QVERIFY(checker.isCancelled());
+        QVERIFY(checker.isCancelled());
+
+        stroke.clearQueueOnCancel();
+    }
+
+    {
+        KisTestingStrokeStrategy *strategy = new KisTestingStrokeStrategy();
+        KisStroke stroke(strategy);
+
+        stroke.addJob(0);
+        stroke.endStroke();
+        delete stroke.popOneJob(); // init
+        delete stroke.popOneJob(); // dab
+        delete stroke.popOneJob(); // finish
+
+        // too late to cancel, the finishing jobs must not be interrupted
+        stroke.cancelStroke();
+        QVERIFY(!strategy->isCancellationRequested());
+    }
+}
+
 QTEST_MAIN(KisStrokeTest)
@@ -21,6 +21,7 @@ private Q_SLOTS:
     void testCancelStrokeCase5();
     void testCancelStrokeCase4();
     void testCancelStrokeCase6();
+    void testCancellationRequested();
 };
 
 #endif /* __KIS_STROKE_TEST_H */
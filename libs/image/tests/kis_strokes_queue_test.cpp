@@ -570,6 +570,83 @@ void KisStrokesQueueTest::testStrokesLevelOfDetail()
     context.clear();
 }
 
+#include "KisAdaptiveLodEstimator.h"
+
+void KisStrokesQueueTest::testAdaptiveLodEstimator()
+{
+    const qint64 msec = 1000000;
+
+    KisAdaptiveLodEstimator estimator(20.0, 3);
+    QCOMPARE(estimator.estimatedLatency(), -1.0);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 0);
+
+    // a light document stays at full resolution
+    estimator.reportMergeJob(0, 5 * msec);
+    estimator.reportMergeJob(0, 7 * msec);
+    estimator.notifyStrokeFinished();
+    QCOMPARE(estimator.estimatedLatency(), 6.0);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 0);
+
+    // an empty stroke changes nothing
+    estimator.notifyStrokeFinished();
+    QCOMPARE(estimator.estimatedLatency(), 6.0);
+
+    // a heavy stroke: (6 + 154) / 2 = 80ms, fits into 20ms only at LOD2
+    estimator.reportMergeJob(0, 154 * msec);
+    estimator.notifyStrokeFinished();
+    QCOMPARE(estimator.estimatedLatency(), 80.0);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 2);
+
+    // LODN jobs are normalized to LOD0: 5ms at LOD2 is 80ms at LOD0
+    estimator.reportMergeJob(2, 5 * msec);
+    estimator.notifyStrokeFinished();
+    QCOMPARE(estimator.estimatedLatency(), 80.0);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 2);
+
+    // 60ms would take 30ms at LOD1, which is not low enough to go down
+    estimator.reportMergeJob(1, 10 * msec);
+    estimator.notifyStrokeFinished();
+    QCOMPARE(estimator.estimatedLatency(), 60.0);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 2);
+
+    // the level is limited by the maximum one
+    estimator.reportMergeJob(0, 10000 * msec);
+    estimator.notifyStrokeFinished();
+    QCOMPARE(estimator.preferredLevelOfDetail(), 3);
+
+    estimator.setMaxLevelOfDetail(1);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 1);
+
+    estimator.reset();
+    QCOMPARE(estimator.estimatedLatency(), -1.0);
+    QCOMPARE(estimator.preferredLevelOfDetail(), 0);
+}
+
+void KisStrokesQueueTest::testAdaptiveLevelOfDetail()
+{
+    LodStrokesQueueTester t;
+    KisStrokesQueue &queue = t.queue;
+
+    queue.setAdaptiveLevelOfDetailEnabled(true);
+    QCOMPARE(queue.adaptiveLevelOfDetail(), 0);
+
+    KisStrokeId id = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("lod_"), false, true));
+    queue.addJob(id, new KisTestingStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.endStroke(id);
+
+    t.processQueue();
+    t.checkOnlyJob("lod_dab");
+
+    // the merge jobs of the stroke take 200ms each
+    queue.reportMergeJobTime(0, 200000000);
+    queue.reportMergeJobTime(0, 200000000);
+
+    // the stroke is finished and the queue switches to LOD2
+    t.processQueue();
+    QCOMPARE(queue.adaptiveLevelOfDetail(), 2);
+    t.checkOnlyJob("sync_u_init");
+}
+
 #include <kundo2command.h>
 #include <kis_post_execution_undo_adapter.h>
 struct TestUndoCommand : public KUndo2Command
@@ -25,6 +25,8 @@ private Q_SLOTS:
     void testOpenedStrokeCounter();
     void testAsyncCancelWhileOpenedStroke();
     void testStrokesLevelOfDetail();
+    void testAdaptiveLodEstimator();
+    void testAdaptiveLevelOfDetail();
     void testLodUndoBase();
     void testLodUndoBase2();
     void testMutatedJobs();
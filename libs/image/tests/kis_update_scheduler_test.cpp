@@ -400,6 +400,48 @@ void KisUpdateSchedulerTest::testTimeMonitor()
     KisUpdateTimeMonitor::instance()->endStrokeMeasure();
 }
 
+#include "KisSchedulerTracer.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+void KisUpdateSchedulerTest::testSchedulerTracer()
+{
+    KisImageSP image = buildTestingImage();
+    KisNodeSP rootLayer = image->rootLayer();
+    KisNodeSP paintLayer1 = rootLayer->firstChild();
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "scheduler_trace.json";
+
+    KisSchedulerTracer::instance()->startTracing(fileName);
+    QVERIFY(KisSchedulerTracer::instance()->isEnabled());
+
+    paintLayer1->setDirty(QRect(10,10,100,100));
+    image->waitForDone();
+
+    QVERIFY(KisSchedulerTracer::instance()->stopTracing());
+    QVERIFY(!KisSchedulerTracer::instance()->isEnabled());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    const QJsonArray events = root["traceEvents"].toArray();
+
+    bool hasMergeEvent = false;
+    Q_FOREACH (const QJsonValue &value, events) {
+        const QJsonObject event = value.toObject();
+        if (event["cat"].toString() == "merge" &&
+            event["args"].toObject()["node"].toString() == "paint1") {
+
+            hasMergeEvent = true;
+            QCOMPARE(event["ph"].toString(), QString("X"));
+        }
+    }
+
+    QVERIFY(hasMergeEvent);
+}
+
 void KisUpdateSchedulerTest::testLodSync()
 {
     KisImageSP image = buildTestingImage();
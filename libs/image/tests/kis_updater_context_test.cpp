@@ -85,6 +85,52 @@ void KisUpdaterContextTest::testJobInterference()
     }
 }
 
+void KisUpdaterContextTest::testThreadAffinity()
+{
+    KisTestableUpdaterContext context(3);
+
+    QRect imageRect(0,0,300,100);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    auto createWalker = [&] (const QRect &rc) {
+        KisBaseRectsWalkerSP walker = new KisMergeWalker(imageRect);
+        walker->collectRects(paintLayer, rc);
+        return walker;
+    };
+
+    context.lock();
+    context.addMergeJob(createWalker(QRect(0,0,50,100)));
+    context.addMergeJob(createWalker(QRect(200,0,50,100)));
+    context.unlock();
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,50,100)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(200,0,50,100)));
+
+    // the first two items are "waiting" now, the third one is empty
+    context.clear();
+
+    context.lock();
+
+    // the jobs go to the threads that processed the same tiles
+    QCOMPARE(context.findSpareThread(QRect(210,10,20,20)), 1);
+    QCOMPARE(context.findSpareThread(QRect(10,10,20,20)), 0);
+
+    // otherwise a waiting thread is preferred over an empty one
+    QCOMPARE(context.findSpareThread(QRect(120,10,20,20)), 0);
+    QCOMPARE(context.findSpareThread(), 0);
+
+    context.unlock();
+}
+
 void KisUpdaterContextTest::testSnapshot()
 {
     KisTestableUpdaterContext context(3);
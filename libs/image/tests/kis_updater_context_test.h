@@ -16,6 +16,7 @@ class KisUpdaterContextTest : public QObject
 private Q_SLOTS:
     void testJobInterference();
     void testSnapshot();
+    void testThreadAffinity();
     void stressTestExclusiveJobs();
 };
 
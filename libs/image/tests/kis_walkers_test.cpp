@@ -286,6 +286,17 @@ void KisWalkersTest::testUsualVisiting()
         walker.startTrip(groupLayer->projectionLeaf());
         QVERIFY(walker.popResult() == orderList);
     }
+
+    {
+        // the group is blended from its projection, its children are not visited
+        QString order("paint1,group,paint5,root,"
+                      "root_TF,paint5_TA,group_NA,paint1_BF");
+        QStringList orderList = order.split(',');
+
+        reportStartWith("paint1");
+        walker.startTrip(paintLayer1->projectionLeaf());
+        QVERIFY(walker.popResult() == orderList);
+    }
 }
 
     /*
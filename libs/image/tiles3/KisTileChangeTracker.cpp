@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileChangeTracker.h"
+
+#include "kis_tile.h"
+
+
+KisTileChangeTracker::KisTileChangeTracker()
+    : m_revision(1),
+      m_allTilesChangedRevision(0)
+{
+}
+
+void KisTileChangeTracker::notifyTileChanged(KisTile *tile)
+{
+    const int revision = m_revision.loadAcquire();
+
+    if (tile->testAndSetChangeRevision(revision)) {
+        QWriteLocker l(&m_lock);
+        m_tileRevisions[tileKey(tile->col(), tile->row())] = revision;
+    }
+}
+
+void KisTileChangeTracker::notifyTileChanged(qint32 col, qint32 row)
+{
+    const int revision = m_revision.loadAcquire();
+
+    QWriteLocker l(&m_lock);
+    m_tileRevisions[tileKey(col, row)] = revision;
+}
+
+void KisTileChangeTracker::notifyAllTilesChanged()
+{
+    const int revision = m_revision.loadAcquire();
+
+    QWriteLocker l(&m_lock);
+    m_allTilesChangedRevision = revision;
+
+    /**
+     * The per-tile records older than the global change
+     * are of no interest to anyone anymore
+     */
+    m_tileRevisions.clear();
+}
+
+int KisTileChangeTracker::currentRevision() const
+{
+    return m_revision.loadAcquire();
+}
+
+int KisTileChangeTracker::takeRevision()
+{
+    return m_revision.fetchAndAddOrdered(1);
+}
+
+bool KisTileChangeTracker::changedTilesSince(int revision, QVector<QPoint> *tiles) const
+{
+    QReadLocker l(&m_lock);
+
+    if (m_allTilesChangedRevision >= revision) {
+        return false;
+    }
+
+    for (auto it = m_tileRevisions.constBegin(); it != m_tileRevisions.constEnd(); ++it) {
+        if (it.value() >= revision) {
+            const qint64 key = it.key();
+            tiles->append(QPoint(qint32(key & 0xFFFFFFFF), qint32(key >> 32)));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILECHANGETRACKER_H
+#define KISTILECHANGETRACKER_H
+
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include <QHash>
+#include <QVector>
+#include <QPoint>
+#include "kritaimage_export.h"
+
+class KisTile;
+
+/**
+ * Keeps the revision of the last change for every tile of a data
+ * manager, so that incremental consumers (thumbnails, texture
+ * updates and so on) can ask which tiles have changed since the
+ * moment they looked at the device for the last time, instead of
+ * rescanning the whole hash table.
+ *
+ * How to use:
+ *   1) takeRevision() returns a token and starts a new revision
+ *   2) later, changedTilesSince(token, ...) returns the tiles that
+ *      were written in the token's revision or after it
+ *
+ * The tiles of the token's own revision are included, because they
+ * might still be written while the consumer was reading them.
+ */
+class KRITAIMAGE_EXPORT KisTileChangeTracker
+{
+public:
+    KisTileChangeTracker();
+
+    /**
+     * Called on every writable access to a tile. The tile caches
+     * the revision it has been registered in, so only the first
+     * write into it within a revision takes the lock.
+     */
+    void notifyTileChanged(KisTile *tile);
+    void notifyTileChanged(qint32 col, qint32 row);
+
+    /**
+     * Marks all the tiles as changed, e.g. when the default
+     * pixel of the device changes
+     */
+    void notifyAllTilesChanged();
+
+    int currentRevision() const;
+    int takeRevision();
+
+    /**
+     * Fills \p tiles with (col, row) indexes of the tiles changed
+     * in \p revision or later.
+     *
+     * \return false if the whole device has changed since
+     *         \p revision, then \p tiles is left empty and the
+     *         consumer should rescan everything
+     */
+    bool changedTilesSince(int revision, QVector<QPoint> *tiles) const;
+
+private:
+    static inline qint64 tileKey(qint32 col, qint32 row) {
+        return (qint64(row) << 32) | quint32(col);
+    }
+
+private:
+    QAtomicInt m_revision;
+
+    mutable QReadWriteLock m_lock;
+    int m_allTilesChangedRevision;
+    QHash<qint64, int> m_tileRevisions;
+};
+
+#endif // KISTILECHANGETRACKER_H
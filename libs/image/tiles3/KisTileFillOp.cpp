@@ -0,0 +1,24 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileFillOp.h"
+
+#include <QScopedPointer>
+
+#include "KisTileFillOpFactory.h"
+
+
+KisTileFillOp::~KisTileFillOp()
+{
+}
+
+const KisTileFillOp* KisTileFillOp::instance()
+{
+    static const QScopedPointer<KisTileFillOp> s_instance(
+        createOptimizedClass<KisTileFillOpFactory>(0));
+
+    return s_instance.data();
+}
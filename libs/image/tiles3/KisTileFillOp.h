@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEFILLOP_H
+#define KISTILEFILLOP_H
+
+#include <QtGlobal>
+
+#include "kritaimage_export.h"
+
+/**
+ * Fills memory with copies of a single pixel. Used by the tiles
+ * engine for filling tiles with the default pixel and for
+ * clearing areas of a data manager.
+ *
+ * The implementation is chosen at runtime by createOptimizedClass(),
+ * so the op uses the widest vector instructions available on the
+ * current CPU. Pixel sizes that evenly divide the vector width (1, 2,
+ * 4, 8 and 16 bytes) are written with whole vector stores, the other
+ * sizes fall back to memcpy() doubling the already filled area.
+ */
+class KRITAIMAGE_EXPORT KisTileFillOp
+{
+public:
+    virtual ~KisTileFillOp();
+
+    /**
+     * Writes \p numPixels copies of \p pixel into \p dst
+     */
+    virtual void fillPixels(quint8 *dst, const quint8 *pixel,
+                            qint32 pixelSize, qint32 numPixels) const = 0;
+
+    /**
+     * Returns the op optimized for the current CPU
+     */
+    static const KisTileFillOp* instance();
+};
+
+#endif // KISTILEFILLOP_H
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileFillOpFactory.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "KisTileFillOp.h"
+
+namespace {
+
+/**
+ * Copies the pixel once and then doubles the filled area on every
+ * step, so the work is done by a few big memcpy() calls instead of
+ * one call per pixel.
+ */
+inline void fillPixelsByDoubling(quint8 *dst, const quint8 *pixel,
+                                 qint32 pixelSize, qint32 numPixels)
+{
+    if (numPixels <= 0) return;
+
+    if (pixelSize == 1) {
+        memset(dst, *pixel, numPixels);
+        return;
+    }
+
+    const qint32 totalBytes = pixelSize * numPixels;
+
+    memcpy(dst, pixel, pixelSize);
+    qint32 filledBytes = pixelSize;
+
+    while (filledBytes < totalBytes) {
+        const qint32 chunkSize = qMin(filledBytes, totalBytes - filledBytes);
+        memcpy(dst + filledBytes, dst, chunkSize);
+        filledBytes += chunkSize;
+    }
+}
+
+}
+
+template<Vc::Implementation _impl, typename EnableDummyType = void>
+struct KisTileFillOpImpl : public KisTileFillOp
+{
+    void fillPixels(quint8 *dst, const quint8 *pixel,
+                    qint32 pixelSize, qint32 numPixels) const override
+    {
+        fillPixelsByDoubling(dst, pixel, pixelSize, numPixels);
+    }
+};
+
+#ifdef HAVE_VC
+
+template<Vc::Implementation _impl>
+struct KisTileFillOpImpl<_impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl>::type> : public KisTileFillOp
+{
+    void fillPixels(quint8 *dst, const quint8 *pixel,
+                    qint32 pixelSize, qint32 numPixels) const override
+    {
+        using uint_v = Vc::uint_v;
+        constexpr qint32 vectorBytes = qint32(uint_v::Size * sizeof(quint32));
+
+        const qint32 totalBytes = pixelSize * numPixels;
+
+        /**
+         * Single bytes are handled by memset() perfectly well, and
+         * the pixels that do not fit into a vector evenly cannot be
+         * written by a repeated store of the same pattern
+         */
+        if (pixelSize == 1 ||
+            vectorBytes % pixelSize != 0 ||
+            totalBytes < vectorBytes) {
+
+            fillPixelsByDoubling(dst, pixel, pixelSize, numPixels);
+            return;
+        }
+
+        quint8 pattern[vectorBytes];
+        for (qint32 i = 0; i < vectorBytes; i += pixelSize) {
+            memcpy(pattern + i, pixel, pixelSize);
+        }
+
+        uint_v value;
+        value.load(reinterpret_cast<const quint32*>(pattern), Vc::Unaligned);
+
+        qint32 offset = 0;
+        for (; offset + vectorBytes <= totalBytes; offset += vectorBytes) {
+            value.store(reinterpret_cast<quint32*>(dst + offset), Vc::Unaligned);
+        }
+
+        // the tail starts at a pixel boundary, since vectorBytes % pixelSize == 0
+        if (offset < totalBytes) {
+            memcpy(dst + offset, pattern, totalBytes - offset);
+        }
+    }
+};
+
+#endif /* HAVE_VC */
+
+template<Vc::Implementation _impl>
+KisTileFillOp* KisTileFillOpFactory::create(int)
+{
+    return new KisTileFillOpImpl<_impl>();
+}
+
+template KisTileFillOp* KisTileFillOpFactory::create<Vc::CurrentImplementation::current()>(int);
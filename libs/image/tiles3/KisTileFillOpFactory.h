@@ -0,0 +1,23 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEFILLOPFACTORY_H
+#define KISTILEFILLOPFACTORY_H
+
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
+class KisTileFillOp;
+
+struct KisTileFillOpFactory
+{
+    typedef int ParamType;
+    typedef KisTileFillOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KisTileFillOp* create(int);
+};
+
+#endif // KISTILEFILLOPFACTORY_H
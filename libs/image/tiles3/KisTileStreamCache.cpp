@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileStreamCache.h"
+
+#include <QMutexLocker>
+
+#include "kis_tile_data.h"
+
+
+KisTileStreamCache::KisTileStreamCache(qint64 maxSize)
+    : m_generation(0),
+      m_totalSize(0),
+      m_maxSize(maxSize)
+{
+}
+
+KisTileStreamCache::~KisTileStreamCache()
+{
+    QMutexLocker l(&m_mutex);
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        it.key()->release();
+    }
+}
+
+void KisTileStreamCache::beginSaving()
+{
+    QMutexLocker l(&m_mutex);
+    m_generation++;
+}
+
+void KisTileStreamCache::endSaving()
+{
+    QMutexLocker l(&m_mutex);
+
+    auto it = m_entries.begin();
+    while (it != m_entries.end()) {
+        if (it->generation < m_generation) {
+            it.key()->release();
+            m_totalSize -= it->stream.size();
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool KisTileStreamCache::fetch(KisTileData *tileData, const QString &compressionName, QByteArray *stream)
+{
+    QMutexLocker l(&m_mutex);
+
+    auto it = m_entries.find(tileData);
+    if (it == m_entries.end() || it->compressionName != compressionName) {
+        return false;
+    }
+
+    it->generation = m_generation;
+    *stream = it->stream;
+    return true;
+}
+
+void KisTileStreamCache::store(KisTileData *tileData, const QString &compressionName, const QByteArray &stream)
+{
+    QMutexLocker l(&m_mutex);
+
+    auto it = m_entries.find(tileData);
+    if (it != m_entries.end()) {
+        m_totalSize -= it->stream.size();
+        it->compressionName = compressionName;
+        it->stream = stream;
+        it->generation = m_generation;
+        m_totalSize += stream.size();
+        return;
+    }
+
+    if (m_totalSize + stream.size() > m_maxSize) {
+        return;
+    }
+
+    tileData->acquire();
+    m_entries.insert(tileData, {compressionName, stream, m_generation});
+    m_totalSize += stream.size();
+}
+
+qint64 KisTileStreamCache::totalSize() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_totalSize;
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILESTREAMCACHE_H
+#define KISTILESTREAMCACHE_H
+
+#include <QMutex>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QSharedPointer>
+#include "kritaimage_export.h"
+
+class KisTileData;
+
+/**
+ * Keeps the compressed streams of the tiles written into the
+ * previous saves of a document, so that the next save compresses
+ * only the tiles that have changed since then.
+ *
+ * The document is saved from a copy-on-write clone of the image,
+ * so the tiles which have not been changed since the previous save
+ * still point to the same tile data. The cache acquires every tile
+ * data it keeps a stream for, like one more tile would do, so the
+ * tile data is never changed in place or reused for other pixels
+ * while it is cached: the first write into the tile after it has
+ * been saved detaches the tile from the cached data.
+ *
+ * Every save should be wrapped into beginSaving() and endSaving().
+ * The streams of the tile data that have not been saved for the
+ * last time are dropped in endSaving().
+ *
+ * All the methods can be called from any thread.
+ */
+class KRITAIMAGE_EXPORT KisTileStreamCache
+{
+public:
+    /**
+     * \p maxSize is the limit of the total size of the cached
+     * streams, the streams beyond it are not cached
+     */
+    KisTileStreamCache(qint64 maxSize = 512 * 1024 * 1024);
+    ~KisTileStreamCache();
+
+    void beginSaving();
+    void endSaving();
+
+    /**
+     * Fills \p stream with the cached stream of \p tileData compressed
+     * with \p compressionName.
+     *
+     * \return false if there is no such stream in the cache
+     */
+    bool fetch(KisTileData *tileData, const QString &compressionName, QByteArray *stream);
+
+    /**
+     * Puts \p stream of \p tileData compressed with \p compressionName
+     * into the cache
+     */
+    void store(KisTileData *tileData, const QString &compressionName, const QByteArray &stream);
+
+    qint64 totalSize() const;
+
+private:
+    Q_DISABLE_COPY(KisTileStreamCache)
+
+    struct Entry {
+        QString compressionName;
+        QByteArray stream;
+        int generation;
+    };
+
+private:
+    mutable QMutex m_mutex;
+    QHash<KisTileData*, Entry> m_entries;
+    int m_generation;
+    qint64 m_totalSize;
+    qint64 m_maxSize;
+};
+
+typedef QSharedPointer<KisTileStreamCache> KisTileStreamCacheSP;
+
+#endif // KISTILESTREAMCACHE_H
@@ -368,6 +368,21 @@ void KisMementoManager::purgeHistory(KisMementoSP oldestMemento)
     DEBUG_DUMP_MESSAGE("PURGE_HISTORY");
 }
 
+qint32 KisMementoManager::numHistoricalTiles() const
+{
+    qint32 numTiles = 0;
+
+    Q_FOREACH (const KisHistoryItem &item, m_revisions) {
+        numTiles += item.itemList.size();
+    }
+
+    Q_FOREACH (const KisHistoryItem &item, m_cancelledRevisions) {
+        numTiles += item.itemList.size();
+    }
+
+    return numTiles;
+}
+
 qint32 KisMementoManager::findRevisionByMemento(KisMementoSP memento) const
 {
     qint32 index = -1;
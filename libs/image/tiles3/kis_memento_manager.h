@@ -113,6 +113,13 @@ public:
      */
     void purgeHistory(KisMementoSP oldestMemento);
 
+    /**
+     * Returns the number of tiles stored in the undo and redo
+     * revisions. Tiles shared with the current state of the
+     * device are counted as well, so the value is an upper bound.
+     */
+    qint32 numHistoricalTiles() const;
+
 protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
@@ -204,6 +204,20 @@ inline void KisTile::safeReleaseOldTileData(KisTileData *td)
     }
 }
 
+KisTileData* KisTile::refTileData() const
+{
+    /**
+     * While we hold the barrier lock, the old tile data
+     * cannot be released by safeReleaseOldTileData() or
+     * unblockSwapping(), so the pointer stays valid.
+     */
+    QMutexLocker locker(&m_swapBarrierLock);
+
+    KisTileData *td = m_tileData;
+    td->ref();
+    return td;
+}
+
 void KisTile::lockForRead() const
 {
 #ifdef DEAD_TILES_SANITY_CHECK
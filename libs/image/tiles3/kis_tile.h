@@ -119,6 +119,25 @@ public:
         return m_tileData;
     }
 
+    /**
+     * Returns the tile data with its reference counter
+     * incremented. Unlike tileData() it is safe to call while
+     * other threads are doing copy-on-write on the tile. The
+     * caller should deref() the tile data after use.
+     */
+    KisTileData* refTileData() const;
+
+    /**
+     * Used by KisTileChangeTracker to register the tile only once
+     * per revision. Returns true if the tile has not been marked
+     * as changed in \p revision yet.
+     */
+    inline bool testAndSetChangeRevision(int revision) {
+        const int oldRevision = m_changeRevision.loadAcquire();
+        return oldRevision != revision &&
+            m_changeRevision.testAndSetOrdered(oldRevision, revision);
+    }
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
@@ -148,6 +167,12 @@ private:
 
     QAtomicPointer<KisMementoManager> m_mementoManager;
 
+    /**
+     * The last revision of KisTileChangeTracker the tile
+     * has been registered in
+     */
+    QAtomicInt m_changeRevision;
+
     /**
      * This is a special mutex for guarding copy-on-write
      * operations. We do not use lockless way here as it'll
@@ -13,13 +13,19 @@
 
 #include <boost/pool/singleton_pool.hpp>
 #include "kis_tile_data_store_iterators.h"
+#include "kis_tile_data_allocator.h"
+#include "KisTileFillOp.h"
 
 // BPP == bytes per pixel
 #define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
 #define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
 
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+/**
+ * The pools grow in 4 MiB steps (for the default tile size), so almost
+ * all the block is backed by huge pages in KisTileDataAllocator
+ */
+typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, KisTileDataAllocator, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
+typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, KisTileDataAllocator, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
@@ -104,11 +110,7 @@ KisTileData::~KisTileData()
 
 void KisTileData::fillWithPixel(const quint8 *defPixel)
 {
-    quint8 *it = m_data;
-
-    for (int i = 0; i < WIDTH * HEIGHT; i++, it += m_pixelSize) {
-        memcpy(it, defPixel, m_pixelSize);
-    }
+    KisTileFillOp::instance()->fillPixels(m_data, defPixel, m_pixelSize, WIDTH * HEIGHT);
 }
 
 void KisTileData::releaseMemory()
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_allocator.h"
+
+#include <QtGlobal>
+#include <new>
+
+#ifdef Q_OS_LINUX
+#include <stdlib.h>
+#include <sys/mman.h>
+#endif /* Q_OS_LINUX */
+
+const KisTileDataAllocator::size_type KisTileDataAllocator::HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+char* KisTileDataAllocator::malloc(const size_type bytes)
+{
+#ifdef Q_OS_LINUX
+    void *ptr = 0;
+    if (posix_memalign(&ptr, HUGE_PAGE_SIZE, bytes)) {
+        return 0;
+    }
+
+    /**
+     * Only the fully covered huge pages can be backed by THP,
+     * the tail of the block stays in normal pages. The advice
+     * is just a hint, so the result is not checked.
+     */
+    const size_type hugePagesSize = bytes & ~(HUGE_PAGE_SIZE - 1);
+    if (hugePagesSize) {
+        madvise(ptr, hugePagesSize, MADV_HUGEPAGE);
+    }
+
+    return static_cast<char*>(ptr);
+#else
+    return new (std::nothrow) char[bytes];
+#endif /* Q_OS_LINUX */
+}
+
+void KisTileDataAllocator::free(char* const block)
+{
+#ifdef Q_OS_LINUX
+    ::free(block);
+#else
+    delete[] block;
+#endif /* Q_OS_LINUX */
+}
@@ -13,6 +13,7 @@
 
 #include "kis_lockless_stack.h"
 #include "swap/kis_chunk_allocator.h"
+#include "config-tile-size.h"
 
 class KisTileData;
 class KisTileDataStore;
@@ -20,9 +21,13 @@ class KisTileDataStore;
 /**
  * WARNING: Those definitions for internal use only!
  * Please use KisTileData::WIDTH/HEIGHT instead
+ *
+ * The size is chosen at build time with KRITA_TILE_SIZE option.
+ * Files saved with a different tile size are still readable,
+ * see KisAbstractTileCompressor::setStreamTileSize()
  */
-#define __TILE_DATA_WIDTH 64
-#define __TILE_DATA_HEIGHT 64
+#define __TILE_DATA_WIDTH KRITA_TILE_SIZE
+#define __TILE_DATA_HEIGHT KRITA_TILE_SIZE
 
 typedef KisLocklessStack<KisTileData*> KisTileDataCache;
 
@@ -223,6 +228,14 @@ private:
      */
     KisTileDataCache m_clonesStack;
 
+    /**
+     * How many times the tile data has been duplicated by
+     * copy-on-write since it was accessed for the last time.
+     * The pooler uses it to decide which tiles are really
+     * likely to be written and, therefore, worth pre-cloning.
+     */
+    QAtomicInt m_numDuplications;
+
 private:
     friend class KisTile;
     friend class KisTileDataStore;
@@ -230,6 +243,7 @@ private:
     friend class KisTileDataStoreIterator;
     friend class KisTileDataStoreReverseIterator;
     friend class KisTileDataStoreClockIterator;
+    friend class KisTileDataSwapper;
 
     /**
      * The state of the tile.
@@ -6,6 +6,7 @@
 
 
 #include <stdio.h>
+#include <algorithm>
 #include "kis_tile_data.h"
 #include "kis_tile_data_store.h"
 #include "kis_tile_data_store_iterators.h"
@@ -18,6 +19,7 @@ const qint32 KisTileDataPooler::MAX_NUM_CLONES = 16;
 const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
+const qint32 KisTileDataPooler::MIN_ADAPTATION_SAMPLES = 256;
 
 //#define DEBUG_POOLER
 
@@ -83,6 +85,12 @@ KisTileDataPooler::KisTileDataPooler(KisTileDataStore *store, qint32 memoryLimit
     m_lastRealMemoryMetric = 0;
     m_lastHistoricalMemoryMetric = 0;
 
+    m_speculativeClonesLimit = MAX_NUM_CLONES;
+    m_lastPoolHits = 0;
+    m_lastPoolMisses = 0;
+    m_numWastedClones = 0;
+    m_lastPoolHitRate = 0.0;
+
     if(memoryLimit >= 0) {
         m_memoryLimit = memoryLimit;
     }
@@ -114,7 +122,16 @@ qint32 KisTileDataPooler::numClonesNeeded(KisTileData *td) const
     RUNTIME_SANITY_CHECK(td);
     qint32 numUsers = td->m_usersCount;
     qint32 numPresentClones = td->m_clonesStack.size();
-    qint32 totalClones = qMin(numUsers - 1, MAX_NUM_CLONES);
+
+    /**
+     * Tiles that are being actively written keep the full set of
+     * clones, others are pre-cloned speculatively, as much as the
+     * observed hit rate allows
+     */
+    qint32 maxClones = td->m_numDuplications.loadAcquire() ?
+        MAX_NUM_CLONES : m_speculativeClonesLimit;
+
+    qint32 totalClones = qMin(numUsers - 1, maxClones);
 
     return totalClones - numPresentClones;
 }
@@ -203,6 +220,8 @@ void KisTileDataPooler::run()
 
         m_store->endIteration(iter);
 
+        updateSpeculativeClonesLimit();
+
         DEBUG_TILE_STATISTICS();
         DEBUG_SIMPLE_ACTION("cycle finished");
     }
@@ -248,6 +267,44 @@ qint64 KisTileDataPooler::lastHistoricalMemoryMetric() const
     return m_lastHistoricalMemoryMetric;
 }
 
+qreal KisTileDataPooler::lastPoolHitRate() const
+{
+    return m_lastPoolHitRate;
+}
+
+qint32 KisTileDataPooler::speculativeClonesLimit() const
+{
+    return m_speculativeClonesLimit;
+}
+
+void KisTileDataPooler::updateSpeculativeClonesLimit()
+{
+    const qint64 poolHits = m_store->m_poolHits.loadAcquire();
+    const qint64 poolMisses = m_store->m_poolMisses.loadAcquire();
+
+    const qint64 hits = poolHits - m_lastPoolHits;
+    const qint64 misses = poolMisses - m_lastPoolMisses;
+
+    if (hits + misses + m_numWastedClones < MIN_ADAPTATION_SAMPLES) return;
+
+    m_lastPoolHitRate = hits + misses > 0 ? qreal(hits) / (hits + misses) : 0.0;
+
+    /**
+     * Every clone freed without being used is wasted memory and
+     * time. If they outnumber the hits, the speculation is too
+     * aggressive. If we miss more often than hit, it is too shy.
+     */
+    if (m_numWastedClones > hits) {
+        m_speculativeClonesLimit = qMax(1, m_speculativeClonesLimit / 2);
+    } else if (misses > hits) {
+        m_speculativeClonesLimit = qMin(MAX_NUM_CLONES, m_speculativeClonesLimit * 2);
+    }
+
+    m_lastPoolHits = poolHits;
+    m_lastPoolMisses = poolMisses;
+    m_numWastedClones = 0;
+}
+
 inline int KisTileDataPooler::clonesMetric(KisTileData *td, int numClones) {
     return numClones * td->pixelSize();
 }
@@ -262,6 +319,7 @@ inline void KisTileDataPooler::tryFreeOrphanedClones(KisTileData *td)
 
     if(extraClones > 0) {
         cloneTileData(td, -extraClones);
+        m_numWastedClones += extraClones;
     }
 }
 
@@ -299,6 +357,14 @@ void KisTileDataPooler::getLists(Iter *iter,
     while(iter->hasNext()) {
         item = iter->next();
 
+        /**
+         * The tile has not been accessed for a while, so its
+         * duplication history is not relevant anymore
+         */
+        if (item->age()) {
+            item->m_numDuplications.storeRelease(0);
+        }
+
         tryFreeOrphanedClones(item);
 
         if((neededMemory = needMemory(item))) {
@@ -339,6 +405,7 @@ qint32 KisTileDataPooler::tryGetMemory(QList<KisTileData*> &donors,
         qint32 numClones = item->m_clonesStack.size();
         cloneTileData(item, -numClones);
         memoryFreed += clonesMetric(item, numClones);
+        m_numWastedClones += numClones;
 
         iter.remove();
     }
@@ -352,6 +419,15 @@ bool KisTileDataPooler::processLists(QList<KisTileData*> &beggers,
 {
     bool hadWork = false;
 
+    /**
+     * When the memory is limited, the tiles that are being
+     * written right now should get their clones first
+     */
+    std::stable_sort(beggers.begin(), beggers.end(),
+                     [] (KisTileData *lhs, KisTileData *rhs) {
+                         return lhs->m_numDuplications.loadAcquire() >
+                             rhs->m_numDuplications.loadAcquire();
+                     });
 
     Q_FOREACH (KisTileData *item, beggers) {
         qint32 clonesNeeded = numClonesNeeded(item);
@@ -34,6 +34,18 @@ public:
     qint64 lastRealMemoryMetric() const;
     qint64 lastHistoricalMemoryMetric() const;
 
+    /**
+     * The share of copy-on-write duplications served from the
+     * pool of pre-cloned tiles during the last adaptation period
+     */
+    qreal lastPoolHitRate() const;
+
+    /**
+     * The current limit of clones prepared for a single tile
+     * data that has not been duplicated recently
+     */
+    qint32 speculativeClonesLimit() const;
+
 
     /**
      * Is case the pooler thread is not running, the user might force
@@ -46,6 +58,7 @@ protected:
     static const qint32 MAX_TIMEOUT;
     static const qint32 MIN_TIMEOUT;
     static const qint32 TIMEOUT_FACTOR;
+    static const qint32 MIN_ADAPTATION_SAMPLES;
 
     void waitForWork();
     qint32 numClonesNeeded(KisTileData *td) const;
@@ -71,6 +84,8 @@ protected:
                       QList<KisTileData*> &donors,
                       qint32 &memoryOccupied);
 
+    void updateSpeculativeClonesLimit();
+
 private:
     void debugTileStatistics();
 protected:
@@ -83,6 +98,18 @@ protected:
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+
+    /**
+     * Adaptive pre-cloning state. Tile data objects that were
+     * duplicated recently get up to MAX_NUM_CLONES clones, all
+     * the others only m_speculativeClonesLimit. The limit is
+     * tuned by the ratio of pool hits and clones freed unused.
+     */
+    qint32 m_speculativeClonesLimit;
+    qint64 m_lastPoolHits;
+    qint64 m_lastPoolMisses;
+    qint64 m_numWastedClones;
+    qreal m_lastPoolHitRate;
 };
 
 
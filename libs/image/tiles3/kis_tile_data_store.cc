@@ -18,6 +18,8 @@
 
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
+const int KisTileDataStore::MAX_UNIFORM_CACHE_SIZE = 64;
+
 //#define DEBUG_PRECLONE
 
 #ifdef DEBUG_PRECLONE
@@ -61,7 +63,9 @@ KisTileDataStore::KisTileDataStore()
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
-      m_clockIndex(1)
+      m_clockIndex(1),
+      m_poolHits(0),
+      m_poolMisses(0)
 {
     m_pooler.start();
     m_swapper.start();
@@ -72,6 +76,8 @@ KisTileDataStore::~KisTileDataStore()
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
+    releaseUniformTileDataCache();
+
     if (numTiles() > 0) {
         errKrita << "Warning: some tiles have leaked:";
         errKrita << "\tTiles in memory:" << numTilesInMemory() << "\n"
@@ -105,6 +111,12 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
+    stats.swapInMemorySize = m_swappedStore.compressedMemoryUsage();
+    stats.swapFileSize = m_swappedStore.swapFileSize();
+    stats.swapFileUsage = m_swappedStore.swapFileUsage();
+
+    stats.poolHits = m_poolHits.loadAcquire();
+    stats.poolMisses = m_poolMisses.loadAcquire();
 
     return stats;
 }
@@ -166,17 +178,60 @@ KisTileData *KisTileDataStore::allocTileData(qint32 pixelSize, const quint8 *def
     return td;
 }
 
+KisTileData *KisTileDataStore::acquireUniformTileData(qint32 pixelSize, const quint8 *pixel)
+{
+    const QByteArray key(reinterpret_cast<const char*>(pixel), pixelSize);
+
+    QMutexLocker l(&m_uniformCacheLock);
+
+    KisTileData *td = m_uniformTileDataCache.value(key, 0);
+
+    if (!td) {
+        if (m_uniformTileDataCache.size() >= MAX_UNIFORM_CACHE_SIZE) {
+            KisTileData *oldTD = m_uniformTileDataCache.take(m_uniformTileDataCacheOrder.dequeue());
+
+            // the tiles might still reference it, so just release our link
+            oldTD->release();
+        }
+
+        td = allocTileData(pixelSize, pixel);
+        td->acquire();
+
+        m_uniformTileDataCache.insert(key, td);
+        m_uniformTileDataCacheOrder.enqueue(key);
+    }
+
+    td->acquire();
+    return td;
+}
+
+void KisTileDataStore::releaseUniformTileDataCache()
+{
+    QMutexLocker l(&m_uniformCacheLock);
+
+    Q_FOREACH (KisTileData *td, m_uniformTileDataCache) {
+        td->release();
+    }
+
+    m_uniformTileDataCache.clear();
+    m_uniformTileDataCacheOrder.clear();
+}
+
 KisTileData *KisTileDataStore::duplicateTileData(KisTileData *rhs)
 {
     KisTileData *td = 0;
 
+    rhs->m_numDuplications.ref();
+
     if (rhs->m_clonesStack.pop(td)) {
+        m_poolHits.ref();
         DEBUG_PRECLONE_ACTION("+ Pre-clone HIT", rhs, td);
         DEBUG_COUNT_PRECLONE_HIT(rhs);
     } else {
         rhs->blockSwapping();
         td = new KisTileData(*rhs);
         rhs->unblockSwapping();
+        m_poolMisses.ref();
         DEBUG_PRECLONE_ACTION("- Pre-clone #MISS#", rhs, td);
         DEBUG_COUNT_PRECLONE_MISS(rhs);
     }
@@ -274,6 +329,42 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+bool KisTileDataStore::swapOutTileDataStream(KisTileData *td, const QByteArray &stream, const QString &compressionName)
+{
+    bool result = false;
+
+    m_iteratorLock.lockForWrite();
+    td->m_swapLock.lockForWrite();
+
+    // the swapper might have been faster than us
+    if (td->data()) {
+        if (m_swappedStore.storeTileDataStream(td, stream, compressionName)) {
+            unregisterTileDataImp(td);
+            result = true;
+        }
+    }
+
+    td->m_swapLock.unlock();
+    m_iteratorLock.unlock();
+
+    return result;
+}
+
+qint32 KisTileDataStore::trySwapOutTileData(const QVector<KisTileData*> &tileDataList)
+{
+    qint32 numSwapped = 0;
+
+    m_iteratorLock.lockForWrite();
+    Q_FOREACH (KisTileData *td, tileDataList) {
+        if (trySwapTileData(td)) {
+            numSwapped++;
+        }
+    }
+    m_iteratorLock.unlock();
+
+    return numSwapped;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -344,6 +435,8 @@ void KisTileDataStore::debugSwapAll()
 
 void KisTileDataStore::debugClear()
 {
+    releaseUniformTileDataCache();
+
     QWriteLocker l(&m_iteratorLock);
     ConcurrentMap<int, KisTileData*>::Iterator iter(m_tileDataMap);
 
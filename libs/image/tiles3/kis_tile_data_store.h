@@ -11,6 +11,10 @@
 #include "kritaimage_export.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
+#include <QQueue>
+#include <QVector>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
@@ -42,6 +46,17 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapInMemorySize;
+
+        qint64 swapFileSize;
+        qint64 swapFileUsage;
+
+        /**
+         * The number of copy-on-write duplications served from the
+         * pre-cloned pool and the ones that had to copy the data
+         */
+        qint64 poolHits;
+        qint64 poolMisses;
     };
 
     MemoryStatistics memoryStatistics();
@@ -90,6 +105,18 @@ public:
         return allocTileData(pixelSize, defPixel);
     }
 
+    /**
+     * Returns a tile data uniformly filled with \p pixel. Such tile
+     * data objects are cached and shared between all the data
+     * managers, so filling huge areas with a solid color costs
+     * just one tile data per color. The first write into a tile
+     * referencing the shared data causes the usual copy-on-write.
+     *
+     * The returned tile data is already acquired, the caller should
+     * release() it when it is not needed anymore.
+     */
+    KisTileData* acquireUniformTileData(qint32 pixelSize, const quint8 *pixel);
+
     // Called by The Memento Manager after every commit
     inline void kickPooler()
     {
@@ -106,6 +133,36 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Tries to swap out all the tile data objects in \p tileDataList.
+     * Unlike trySwapTileData() it takes all the needed locks itself.
+     * The caller must hold a reference to every tile data in the list.
+     *
+     * Returns the number of tile data objects actually swapped out.
+     */
+    qint32 trySwapOutTileData(const QVector<KisTileData*> &tileDataList);
+
+    /**
+     * Swaps out \p td, which is the only user of its data, taking
+     * \p stream as its compressed content instead of compressing
+     * the data of the tile data. The stream should be written by
+     * KisTileCompressor2::compressTileData() with \p compressionName
+     * algorithm, e.g. loaded from a file. It is decompressed on the
+     * first access to the tile data.
+     *
+     * Returns false if the stream doesn't fit into the swap, then
+     * the data of \p td stays unchanged.
+     */
+    bool swapOutTileDataStream(KisTileData *td, const QByteArray &stream, const QString &compressionName);
+
+    /**
+     * Defragments and shrinks the swap file if it has too much
+     * free space. Called by the swapper thread.
+     */
+    inline bool tryCompactSwapFile() {
+        return m_swappedStore.tryCompactSwapFile();
+    }
+
 
     /**
      * WARN: The following three method are only for usage
@@ -138,6 +195,8 @@ private:
     inline void unregisterTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
 
+    void releaseUniformTileDataCache();
+
     friend class DeadlockyThread;
     friend class KisLowMemoryTests;
     void debugSwapAll();
@@ -166,8 +225,24 @@ private:
     QAtomicInt m_memoryMetric;
     QAtomicInt m_counter;
     QAtomicInt m_clockIndex;
+
+    friend class KisTileDataPooler;
+    QAtomicInt m_poolHits;
+    QAtomicInt m_poolMisses;
+
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
+
+    /**
+     * Tile data objects filled with a single color, the key
+     * is the raw pixel value. Every cached tile data is
+     * acquired once by the cache itself, which guarantees
+     * that any write into it will cause copy-on-write.
+     */
+    static const int MAX_UNIFORM_CACHE_SIZE;
+    QMutex m_uniformCacheLock;
+    QHash<QByteArray, KisTileData*> m_uniformTileDataCache;
+    QQueue<QByteArray> m_uniformTileDataCacheOrder;
 };
 
 template<typename T>
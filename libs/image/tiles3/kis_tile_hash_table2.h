@@ -222,9 +222,19 @@ public:
         m_iter.next();
     }
 
+    /**
+     * The iterator lock blocks insertions only, the tiles can still be
+     * erased from the table concurrently (e.g. by KisMementoManager while
+     * committing a transaction), so the raw pointer must be converted
+     * into a shared one under the protection of the GC.
+     */
     TileTypeSP tile() const
     {
-        return TileTypeSP(m_iter.getValue());
+        m_ht->m_map.getGC().lockRawPointerAccess();
+        TileTypeSP tile = m_iter.getValue();
+        m_ht->m_map.getGC().unlockRawPointerAccess();
+
+        return tile;
     }
 
     bool isDone() const
@@ -240,9 +250,11 @@ public:
 
     void moveCurrentToHashTable(KisTileHashTableTraits2<T> *newHashTable)
     {
-        TileTypeSP tile = m_iter.getValue();
+        TileTypeSP tile = this->tile();
         next();
 
+        if (!tile) return;
+
         quint32 idx = m_ht->calculateHash(tile->col(), tile->row());
         m_ht->erase(idx);
         newHashTable->insert(idx, tile);
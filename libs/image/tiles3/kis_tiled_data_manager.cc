@@ -14,12 +14,15 @@
 #include "kis_tile_data_wrapper.h"
 #include "kis_tiled_data_manager_p.h"
 #include "kis_memento_manager.h"
+#include "KisTileFillOp.h"
 #include "swap/kis_legacy_tile_compressor.h"
 #include "swap/kis_tile_compressor_factory.h"
+#include "swap/kis_tile_swap_prefetcher.h"
 
 #include "kis_paint_device_writer.h"
 
 #include "kis_global.h"
+#include "kis_image_config.h"
 
 
 /* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
@@ -88,6 +91,127 @@ void KisTiledDataManager::setDefaultPixel(const quint8 *defaultPixel)
     setDefaultPixelImpl(defaultPixel);
 }
 
+void KisTiledDataManager::prefetchSwappedNeighbours(qint32 col, qint32 row)
+{
+    /**
+     * Iterators walk the tiles row by row, so read a bit more
+     * ahead along the current row than in other directions.
+     */
+    const qint32 rowReadAhead = 4;
+
+    KisTileSwapPrefetcher *prefetcher = KisTileSwapPrefetcher::instance();
+
+    for (qint32 i = 1; i <= rowReadAhead; i++) {
+        prefetcher->prefetch(m_hashTable->getExistingTile(col + i, row));
+    }
+    prefetcher->prefetch(m_hashTable->getExistingTile(col - 1, row));
+
+    for (qint32 i = -1; i <= 1; i++) {
+        prefetcher->prefetch(m_hashTable->getExistingTile(col + i, row - 1));
+        prefetcher->prefetch(m_hashTable->getExistingTile(col + i, row + 1));
+    }
+}
+
+void KisTiledDataManager::notifyMementoChanged(KisMementoSP memento)
+{
+    qint32 x, y, w, h;
+    memento->extent(x, y, w, h);
+
+    if (w <= 0 || h <= 0) return;
+
+    const qint32 firstColumn = xToCol(x);
+    const qint32 lastColumn = xToCol(x + w - 1);
+    const qint32 firstRow = yToRow(y);
+    const qint32 lastRow = yToRow(y + h - 1);
+
+    for (qint32 row = firstRow; row <= lastRow; ++row) {
+        for (qint32 column = firstColumn; column <= lastColumn; ++column) {
+            m_changeTracker.notifyTileChanged(column, row);
+        }
+    }
+}
+
+int KisTiledDataManager::takeChangeRevision()
+{
+    return m_changeTracker.takeRevision();
+}
+
+bool KisTiledDataManager::changedTilesSince(int revision, QVector<QPoint> *tiles) const
+{
+    return m_changeTracker.changedTilesSince(revision, tiles);
+}
+
+qint32 KisTiledDataManager::swapOutTiles()
+{
+    QVector<KisTileData*> tileDataList;
+
+    {
+        QReadLocker locker(&m_lock);
+
+        KisTileHashTableConstIterator iter(m_hashTable);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            KisTileData *td = tile->refTileData();
+
+            /**
+             * Give recently accessed tiles a second chance: they
+             * will be swapped out on the next call if nobody
+             * touches them in between
+             */
+            if (td->age() > 0) {
+                tileDataList.append(td);
+            } else {
+                td->markOld();
+                td->deref();
+            }
+
+            iter.next();
+        }
+    }
+
+    return swapOutTileDataList(tileDataList);
+}
+
+qint32 KisTiledDataManager::swapOutTiles(const QRect &rect)
+{
+    if (rect.isEmpty()) return 0;
+
+    QVector<KisTileData*> tileDataList;
+
+    {
+        QReadLocker locker(&m_lock);
+
+        const qint32 firstColumn = xToCol(rect.left());
+        const qint32 lastColumn = xToCol(rect.right());
+        const qint32 firstRow = yToRow(rect.top());
+        const qint32 lastRow = yToRow(rect.bottom());
+
+        for (qint32 row = firstRow; row <= lastRow; row++) {
+            for (qint32 column = firstColumn; column <= lastColumn; column++) {
+                KisTileSP tile = m_hashTable->getExistingTile(column, row);
+                if (tile) {
+                    tileDataList.append(tile->refTileData());
+                }
+            }
+        }
+    }
+
+    return swapOutTileDataList(tileDataList);
+}
+
+qint32 KisTiledDataManager::swapOutTileDataList(const QVector<KisTileData*> &tileDataList)
+{
+    const qint32 numSwapped =
+        KisTileDataStore::instance()->trySwapOutTileData(tileDataList);
+
+    Q_FOREACH (KisTileData *td, tileDataList) {
+        td->deref();
+    }
+
+    return numSwapped;
+}
+
 void KisTiledDataManager::setDefaultPixelImpl(const quint8 *defaultPixel)
 {
     KisTileData *td = KisTileDataStore::instance()->createDefaultTileData(pixelSize(), defaultPixel);
@@ -95,6 +219,8 @@ void KisTiledDataManager::setDefaultPixelImpl(const quint8 *defaultPixel)
     m_mementoManager->setDefaultTileData(td);
 
     memcpy(m_defaultPixel, defaultPixel, pixelSize());
+
+    m_changeTracker.notifyAllTilesChanged();
 }
 
 bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
@@ -117,7 +243,8 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
     KisTileSP tile;
 
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(CURRENT_VERSION,
+                                         KisImageConfig(true).tilesStreamCompression());
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -130,7 +257,7 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 
     return retval;
 }
-bool KisTiledDataManager::read(QIODevice *stream)
+bool KisTiledDataManager::read(QIODevice *stream, bool keepCompressed)
 {
     clear();
 
@@ -148,6 +275,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     quint32 numTiles;
     qint32 tilesVersion = LEGACY_VERSION;
+    QSize tileSize(KisTileData::WIDTH, KisTileData::HEIGHT);
 
     if (line[0] == 'V') {
         QList<QByteArray> lineItems = line.split(' ');
@@ -157,7 +285,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
         tilesVersion = lineItems.takeFirst().toInt();
 
-        if(!processTilesHeader(stream, numTiles))
+        if(!processTilesHeader(stream, numTiles, tileSize))
             return false;
     }
     else {
@@ -166,6 +294,8 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     KisAbstractTileCompressorSP compressor =
         KisTileCompressorFactory::create(tilesVersion);
+    compressor->setStreamTileSize(tileSize);
+    compressor->setKeepCompressed(keepCompressed);
 
     bool readSuccess = true;
     for (quint32 i = 0; i < numTiles; i++) {
@@ -206,7 +336,7 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
     } while(0)                                                  \
 
 
-bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles)
+bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles, QSize &tileSize)
 {
     /**
      * We assume that there is only one version of this header
@@ -225,13 +355,19 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
     while(!foundDataMark && stream->canReadLine()) {
         takeOneLine(stream, maxLineLength, keyword, value);
 
+        /**
+         * Tiles of a different size can be loaded as well, the
+         * compressor will split them between our own tiles
+         */
         if (keyword == "TILEWIDTH") {
-            if(value != KisTileData::WIDTH)
+            if(value <= 0 || value > MAX_STREAM_TILE_SIZE)
                 goto wrongString;
+            tileSize.setWidth(value);
         }
         else if (keyword == "TILEHEIGHT") {
-            if(value != KisTileData::HEIGHT)
+            if(value <= 0 || value > MAX_STREAM_TILE_SIZE)
                 goto wrongString;
+            tileSize.setHeight(value);
         }
         else if (keyword == "PIXELSIZE") {
             if((quint32)value != pixelSize())
@@ -293,16 +429,61 @@ void KisTiledDataManager::purge(const QRect& area)
     }
 }
 
+void KisTiledDataManager::shareUniformTiles(const QRect &area)
+{
+    const qint32 pixelSize = this->pixelSize();
+    const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize;
+
+    QList<KisTileSP> uniformTiles;
+    {
+        KisTileHashTableConstIterator iter(m_hashTable);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            if (tile->extent().intersects(area)) {
+                tile->lockForRead();
+                const quint8 *data = tile->data();
+
+                // every pixel equals to the next one
+                if (memcmp(data, data + pixelSize, tileDataSize - pixelSize) == 0) {
+                    uniformTiles.push_back(tile);
+                }
+                tile->unlockForRead();
+            }
+            iter.next();
+        }
+    }
+
+    QVector<quint8> pixel(pixelSize);
+
+    Q_FOREACH (KisTileSP tile, uniformTiles) {
+        tile->lockForRead();
+        KisTileData *oldTileData = tile->tileData();
+        memcpy(pixel.data(), tile->data(), pixelSize);
+        tile->unlockForRead();
+
+        if (!memcmp(pixel.constData(), m_defaultPixel, pixelSize)) {
+            if (m_hashTable->deleteTile(tile)) {
+                m_extentManager.notifyTileRemoved(tile->col(), tile->row());
+            }
+        } else {
+            KisTileData *td = KisTileDataStore::instance()->acquireUniformTileData(pixelSize, pixel.constData());
+
+            if (td != oldTileData) {
+                KisTileSP sharedTile = KisTileSP(new KisTile(tile->col(), tile->row(), td, m_mementoManager));
+                m_hashTable->addTile(sharedTile);
+            }
+
+            td->release();
+        }
+    }
+}
+
 quint8* KisTiledDataManager::duplicatePixel(qint32 num, const quint8 *pixel)
 {
     const qint32 pixelSize = this->pixelSize();
-    /* FIXME:  Make a fun filling here */
     quint8 *dstBuf = new quint8[num * pixelSize];
-    quint8 *dstIt = dstBuf;
-    for (qint32 i = 0; i < num; i++) {
-        memcpy(dstIt, pixel, pixelSize);
-        dstIt += pixelSize;
-    }
+    KisTileFillOp::instance()->fillPixels(dstBuf, pixel, pixelSize, num);
     return dstBuf;
 }
 
@@ -348,8 +529,7 @@ void KisTiledDataManager::clear(QRect clearRect, const quint8 *clearPixel)
         clearRect.width() >= KisTileData::WIDTH &&
         clearRect.height() >= KisTileData::HEIGHT) {
 
-        td = KisTileDataStore::instance()->createDefaultTileData(pixelSize, clearPixel);
-        td->acquire();
+        td = KisTileDataStore::instance()->acquireUniformTileData(pixelSize, clearPixel);
     }
 
     for (qint32 row = firstRow; row <= lastRow; ++row) {
@@ -364,6 +544,8 @@ void KisTiledDataManager::clear(QRect clearRect, const quint8 *clearPixel)
                  const bool wasDeleted =
                      m_hashTable->deleteTile(column, row);
 
+                 m_changeTracker.notifyTileChanged(column, row);
+
                  if (wasDeleted) {
                      m_extentManager.notifyTileRemoved(column, row);
                  }
@@ -426,6 +608,7 @@ void KisTiledDataManager::clear()
 {
     m_hashTable->clear();
     m_extentManager.clear();
+    m_changeTracker.notifyAllTilesChanged();
 }
 
 
@@ -465,6 +648,8 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
                  const bool wasDeleted =
                      m_hashTable->deleteTile(column, row);
 
+                 m_changeTracker.notifyTileChanged(column, row);
+
                  if (srcTileExists || !defaultPixelsCoincide) {
                      srcTile->lockForRead();
                      KisTileData *td = srcTile->tileData();
@@ -539,6 +724,8 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
             const bool wasDeleted =
                 m_hashTable->deleteTile(column, row);
 
+            m_changeTracker.notifyTileChanged(column, row);
+
             if (srcTileExists || !defaultPixelsCoincide) {
                 srcTile->lockForRead();
                 KisTileData *td = srcTile->tileData();
@@ -577,6 +764,49 @@ void KisTiledDataManager::bitBltRoughOldData(KisTiledDataManager *srcDM, const Q
     bitBltRoughImpl<true>(srcDM, rect);
 }
 
+bool KisTiledDataManager::hasSameContent(KisTiledDataManager *other)
+{
+    if (other == this) return true;
+
+    QReadLocker locker(&m_lock);
+    QReadLocker otherLocker(&other->m_lock);
+
+    const qint32 pixelSize = this->pixelSize();
+    const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize;
+
+    if (other->pixelSize() != pixelSize ||
+        memcmp(other->defaultPixel(), m_defaultPixel, pixelSize) ||
+        other->m_hashTable->numTiles() != m_hashTable->numTiles()) {
+
+        return false;
+    }
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        bool otherTileExists = false;
+        KisTileSP otherTile = other->m_hashTable->getReadOnlyTileLazy(tile->col(), tile->row(), otherTileExists);
+        if (!otherTileExists) return false;
+
+        tile->lockForRead();
+        otherTile->lockForRead();
+
+        const bool isSame =
+            tile->tileData() == otherTile->tileData() ||
+            !memcmp(tile->data(), otherTile->data(), tileDataSize);
+
+        otherTile->unlockForRead();
+        tile->unlockForRead();
+
+        if (!isSame) return false;
+
+        iter.next();
+    }
+
+    return true;
+}
+
 void KisTiledDataManager::setExtent(qint32 x, qint32 y, qint32 w, qint32 h)
 {
     setExtent(QRect(x, y, w, h));
@@ -609,17 +839,23 @@ void KisTiledDataManager::setExtent(QRect newRect)
 
                 const qint32 pixelSize = this->pixelSize();
 
+                const KisTileFillOp *fillOp = KisTileFillOp::instance();
+
+                m_changeTracker.notifyTileChanged(tile.data());
+
                 tile->lockForWrite();
                 quint8* data = tile->data();
-                quint8* ptr;
 
-                /* FIXME: make it faster */
                 for (int y = 0; y < KisTileData::HEIGHT; y++) {
-                    for (int x = 0; x < KisTileData::WIDTH; x++) {
-                        if (!intersection.contains(x, y)) {
-                            ptr = data + pixelSize * (y * KisTileData::WIDTH + x);
-                            memcpy(ptr, m_defaultPixel, pixelSize);
-                        }
+                    quint8 *rowPtr = data + pixelSize * y * KisTileData::WIDTH;
+
+                    if (y < intersection.top() || y > intersection.bottom()) {
+                        fillOp->fillPixels(rowPtr, m_defaultPixel, pixelSize, KisTileData::WIDTH);
+                    } else {
+                        fillOp->fillPixels(rowPtr, m_defaultPixel, pixelSize, intersection.left());
+                        fillOp->fillPixels(rowPtr + pixelSize * (intersection.right() + 1),
+                                           m_defaultPixel, pixelSize,
+                                           KisTileData::WIDTH - intersection.right() - 1);
                     }
                 }
                 tile->unlockForWrite();
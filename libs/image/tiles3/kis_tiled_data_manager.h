@@ -27,6 +27,7 @@
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
 #include "KisTiledExtentManager.h"
+#include "KisTileChangeTracker.h"
 
 class KisTiledDataManager;
 typedef KisSharedPtr<KisTiledDataManager> KisTiledDataManagerSP;
@@ -58,6 +59,12 @@ private:
     static const qint32 LEGACY_VERSION = 1;
     static const qint32 CURRENT_VERSION = 2;
 
+    /**
+     * The biggest tile size supported in the streams written by
+     * builds with a different KRITA_TILE_SIZE option
+     */
+    static const qint32 MAX_STREAM_TILE_SIZE = 1024;
+
 protected:
     /*FIXME:*/
 public:
@@ -103,18 +110,30 @@ public:
     }
 
     inline KisTileSP getTile(qint32 col, qint32 row, bool writable) {
+        KisTileSP tile;
+
         if (writable) {
             bool newTile;
-            KisTileSP tile = m_hashTable->getTileLazy(col, row, newTile);
+            tile = m_hashTable->getTileLazy(col, row, newTile);
             if (newTile) {
                 m_extentManager.notifyTileAdded(col, row);
             }
-            return tile;
-
+            m_changeTracker.notifyTileChanged(tile.data());
         } else {
             bool unused;
-            return m_hashTable->getReadOnlyTileLazy(col, row, unused);
+            tile = m_hashTable->getReadOnlyTileLazy(col, row, unused);
         }
+
+        /**
+         * The tile is swapped out, so its neighbours are most
+         * probably swapped out as well. Ask the prefetcher to load
+         * them while we are still busy with the current one.
+         */
+        if (!tile->tileData()->data()) {
+            prefetchSwappedNeighbours(col, row);
+        }
+
+        return tile;
     }
 
     inline KisTileSP getReadOnlyTileLazy(qint32 col, qint32 row, bool &existingTile) {
@@ -157,6 +176,7 @@ public:
 
         QWriteLocker locker(&m_lock);
         m_mementoManager->rollback(m_hashTable, memento);
+        notifyMementoChanged(memento);
         const quint8 *defaultPixel = memento->oldDefaultPixel();
         if(memcmp(m_defaultPixel, defaultPixel, m_pixelSize)) {
             setDefaultPixelImpl(defaultPixel);
@@ -168,6 +188,7 @@ public:
 
         QWriteLocker locker(&m_lock);
         m_mementoManager->rollforward(m_hashTable, memento);
+        notifyMementoChanged(memento);
         const quint8 *defaultPixel = memento->newDefaultPixel();
         if(memcmp(m_defaultPixel, defaultPixel, m_pixelSize)) {
             setDefaultPixelImpl(defaultPixel);
@@ -190,6 +211,35 @@ public:
         m_mementoManager->purgeHistory(oldestMemento);
     }
 
+    /**
+     * Returns the number of tiles kept in the undo history
+     * of the device, see KisMementoManager::numHistoricalTiles()
+     */
+    qint32 numHistoricalTiles() const {
+        QReadLocker locker(&m_lock);
+        return m_mementoManager->numHistoricalTiles();
+    }
+
+    /**
+     * Tries to move all the tiles of the device into the swap.
+     * The tiles being accessed right now or accessed since the
+     * previous call are skipped. Used for freeing memory occupied
+     * by a single document without touching the others.
+     *
+     * Returns the number of tiles actually swapped out.
+     */
+    qint32 swapOutTiles();
+
+    /**
+     * Moves the tiles intersecting \p rect into the swap, no matter
+     * how recently they were accessed. Used by the out-of-core
+     * processing, which knows the tiles are not needed anymore.
+     * The tiles locked right now are skipped.
+     *
+     * \see OutOfCoreProgressPolicy
+     */
+    qint32 swapOutTiles(const QRect &rect);
+
     static void releaseInternalPools();
 
 protected:
@@ -197,7 +247,12 @@ protected:
      * Reads and writes the tiles 
      */
     bool write(KisPaintDeviceWriter &store);
-    bool read(QIODevice *stream);
+
+    /**
+     * \see KisAbstractTileCompressor::setKeepCompressed() for
+     * \p keepCompressed
+     */
+    bool read(QIODevice *stream, bool keepCompressed = false);
 
     void purge(const QRect& area);
 
@@ -216,12 +271,41 @@ public:
 
     KisRegion region() const;
 
+    /**
+     * Starts a new change revision and returns the token of the
+     * previous one. Pass the token to changedTilesSince() later to
+     * get the tiles written since this moment.
+     *
+     * \see KisTileChangeTracker
+     */
+    int takeChangeRevision();
+
+    /**
+     * Fills \p tiles with (col, row) indexes of the tiles changed
+     * since \p revision has been taken. Returns false if the whole
+     * device has changed (e.g. it was cleared or its default pixel
+     * was changed), then the caller should rescan the device.
+     */
+    bool changedTilesSince(int revision, QVector<QPoint> *tiles) const;
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
     void clear(qint32 x, qint32 y,  qint32 w, qint32 h, const quint8 *clearPixel);
     void clear();
 
+    /**
+     * Makes the tiles in \p area that are filled with a single pixel
+     * value reference the shared uniform tile data of the store
+     * (see KisTileDataStore::acquireUniformTileData()). The tiles of
+     * the default pixel are freed like in purge(). The content of the
+     * data manager is not changed.
+     *
+     * Like purge(), it should not be called while the data manager is
+     * being written by someone else.
+     */
+    void shareUniformTiles(const QRect &area);
+
     /**
      * Clones rect from another datamanager. The cloned area will be
      * shared between both datamanagers as much as possible using
@@ -249,6 +333,13 @@ public:
      */
     void bitBltRoughOldData(KisTiledDataManager *srcDM, const QRect &rect);
 
+    /**
+     * @return true if \p other has exactly the same tiles and default
+     * pixel as this data manager. The tiles shared with \p other
+     * copy-on-write are not compared byte by byte.
+     */
+    bool hasSameContent(KisTiledDataManager *other);
+
     /**
      * write the specified data to x, y. There is no checking on pixelSize!
      */
@@ -337,6 +428,7 @@ private:
     quint8* m_defaultPixel;
     qint32 m_pixelSize;
     KisTiledExtentManager m_extentManager;
+    KisTileChangeTracker m_changeTracker;
 
     mutable QReadWriteLock m_lock;
 
@@ -350,14 +442,18 @@ private:
 
 private:
     void setDefaultPixelImpl(const quint8 *defPixel);
+    void notifyMementoChanged(KisMementoSP memento);
 
     bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
-    bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
+    bool processTilesHeader(QIODevice *stream, quint32 &numTiles, QSize &tileSize);
 
     qint32 divideRoundDown(qint32 x, const qint32 y) const;
 
     void recalculateExtent();
 
+    void prefetchSwappedNeighbours(qint32 col, qint32 row);
+    qint32 swapOutTileDataList(const QVector<KisTileData*> &tileDataList);
+
     quint8* duplicatePixel(qint32 num, const quint8 *pixel);
 
     template<bool useOldSrcData>
@@ -7,9 +7,31 @@
 #include "kis_abstract_tile_compressor.h"
 
 KisAbstractTileCompressor::KisAbstractTileCompressor()
+    : m_streamTileSize(KisTileData::WIDTH, KisTileData::HEIGHT),
+      m_keepCompressed(false)
 {
 }
 
 KisAbstractTileCompressor::~KisAbstractTileCompressor()
 {
 }
+
+void KisAbstractTileCompressor::setStreamTileSize(const QSize &size)
+{
+    m_streamTileSize = size;
+}
+
+QSize KisAbstractTileCompressor::streamTileSize() const
+{
+    return m_streamTileSize;
+}
+
+void KisAbstractTileCompressor::setKeepCompressed(bool value)
+{
+    m_keepCompressed = value;
+}
+
+bool KisAbstractTileCompressor::keepCompressed() const
+{
+    return m_keepCompressed;
+}
@@ -7,6 +7,8 @@
 #ifndef __KIS_ABSTRACT_TILE_COMPRESSOR_H
 #define __KIS_ABSTRACT_TILE_COMPRESSOR_H
 
+#include <QSize>
+
 #include "kritaimage_export.h"
 #include "../kis_tile.h"
 #include "../kis_tiled_data_manager.h"
@@ -78,7 +80,35 @@ public:
      */
     virtual qint32 tileDataBufferSize(KisTileData *tileData) = 0;
 
+    /**
+     * Sets the size of the tiles stored in the stream. It may differ
+     * from KisTileData::WIDTH/HEIGHT when the stream was written by a
+     * build with a different tile size. In such a case readTile()
+     * splits the data between the tiles of the data manager itself.
+     */
+    void setStreamTileSize(const QSize &size);
+    QSize streamTileSize() const;
+
+    /**
+     * If \p value is true, readTile() may keep the compressed data
+     * of the tiles in the swap instead of decompressing it, so the
+     * data is decompressed only when the tiles are accessed for the
+     * first time. It is used for the layers that are not likely to
+     * be accessed soon, e.g. hidden ones.
+     */
+    void setKeepCompressed(bool value);
+    bool keepCompressed() const;
+
 protected:
+    inline bool streamTileSizeMatches() const {
+        return m_streamTileSize == QSize(KisTileData::WIDTH, KisTileData::HEIGHT);
+    }
+
+    inline void writeBytes(KisTiledDataManager *dm, const quint8 *data,
+                           qint32 x, qint32 y, qint32 width, qint32 height) {
+        dm->writeBytesBody(data, x, y, width, height);
+    }
+
     inline qint32 xToCol(KisTiledDataManager *dm, qint32 x) {
         return dm->xToCol(x);
     }
@@ -90,6 +120,10 @@ protected:
     inline qint32 pixelSize(KisTiledDataManager *dm) {
         return dm->pixelSize();
     }
+
+private:
+    QSize m_streamTileSize;
+    bool m_keepCompressed;
 };
 
 #endif /* __KIS_ABSTRACT_TILE_COMPRESSOR_H */
@@ -18,13 +18,19 @@
 #define WRAP_PREVIOUS_CHUNK_DATA(iter) (KisChunk((iter)-1))
 
 
-KisChunkAllocator::KisChunkAllocator(quint64 slabSize, quint64 storeSize)
+KisChunkAllocator::KisChunkAllocator(quint64 slabSize, quint64 storeSize, quint64 alignment)
 {
+    KIS_SAFE_ASSERT_RECOVER(!(alignment & (alignment - 1))) {
+        alignment = 0;
+    }
+
     m_storeMaxSize = storeSize;
     m_storeSlabSize = slabSize;
+    m_alignment = alignment;
 
     m_iterator = m_list.begin();
     m_storeSize = m_storeSlabSize;
+    m_allocatedSize = 0;
     INIT_FAIL_COUNTER();
 }
 
@@ -33,6 +39,24 @@ KisChunkAllocator::~KisChunkAllocator()
 }
 
 KisChunk KisChunkAllocator::getChunk(quint64 size)
+{
+    /**
+     * All the chunks have aligned sizes and the first one starts
+     * at zero, so the beginnings of all of them are aligned as well.
+     * compact() keeps this invariant, since it packs the chunks
+     * one after another.
+     */
+    const quint64 dataSize = size;
+    if (m_alignment) {
+        size = (size + m_alignment - 1) & ~(m_alignment - 1);
+    }
+
+    KisChunk chunk = getAlignedChunk(size);
+    chunk.position()->m_dataSize = dataSize;
+    return chunk;
+}
+
+KisChunk KisChunkAllocator::getAlignedChunk(quint64 size)
 {
     KisChunkDataListIterator startPosition = m_iterator;
     START_COUNTING();
@@ -95,6 +119,7 @@ bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
 
     if(GAP_SIZE(lowBound, highBound) >= size) {
         list.insert(iterator, KisChunkData(lowBound + shift, size));
+        m_allocatedSize += size;
         result = true;
     }
 
@@ -103,6 +128,8 @@ bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
 
 void KisChunkAllocator::freeChunk(KisChunk chunk)
 {
+    m_allocatedSize -= chunk.size();
+
     if(m_iterator != m_list.end() && m_iterator == chunk.position()) {
         m_iterator = m_list.erase(m_iterator);
         return;
@@ -112,6 +139,54 @@ void KisChunkAllocator::freeChunk(KisChunk chunk)
     m_list.erase(chunk.position());
 }
 
+quint64 KisChunkAllocator::usedStoreSize() const
+{
+    return !m_list.isEmpty() ? m_list.last().m_end + 1 : 0;
+}
+
+KisChunkAllocator::CompactionResult
+KisChunkAllocator::compact(quint64 maxBytesToMove, MoveChunkFunction moveChunk)
+{
+    quint64 bytesMoved = 0;
+    quint64 position = 0;
+
+    KisChunkDataListIterator i;
+
+    for(i = m_list.begin(); i != m_list.end(); ++i) {
+        if(i->m_begin > position) {
+            if(bytesMoved >= maxBytesToMove)
+                return CompactionInterrupted;
+
+            const KisChunkData newChunk(position, i->size());
+            if(!moveChunk(*i, newChunk))
+                return CompactionFailed;
+
+            bytesMoved += i->size();
+            i->setChunk(newChunk.m_begin, newChunk.size());
+        }
+
+        position = i->m_end + 1;
+    }
+
+    /**
+     * All the free space is now in the end of the store, so there
+     * is no need to search for it in the middle of the list
+     */
+    m_iterator = m_list.end();
+
+    return CompactionFinished;
+}
+
+quint64 KisChunkAllocator::shrinkStore()
+{
+    const quint64 usedSize = usedStoreSize();
+    const quint64 numSlabs = qMax(quint64(1), (usedSize + m_storeSlabSize - 1) / m_storeSlabSize);
+
+    m_storeSize = qMin(m_storeSize, numSlabs * m_storeSlabSize);
+
+    return m_storeSize;
+}
+
 
 
 /**************************************************************/
@@ -8,6 +8,7 @@
 #define __KIS_CHUNK_LIST_H
 
 #include <QLinkedList>
+#include <functional>
 #include "kritaimage_export.h"
 
 #define MiB (1ULL << 20)
@@ -50,6 +51,7 @@ class KRITAIMAGE_EXPORT KisChunkData
 {
 public:
     KisChunkData(quint64 begin, quint64 size)
+        : m_dataSize(size)
     {
         setChunk(begin, size);
     }
@@ -76,6 +78,12 @@ public:
 
     quint64 m_begin;
     quint64 m_end;
+
+    /**
+     * The number of bytes actually requested by the user of the chunk.
+     * Can be smaller than size() when the allocator aligns the chunks.
+     */
+    quint64 m_dataSize;
 };
 
 class KRITAIMAGE_EXPORT KisChunk
@@ -100,6 +108,10 @@ public:
         return m_iterator->size();
     }
 
+    inline quint64 dataSize() const {
+        return m_iterator->m_dataSize;
+    }
+
     inline KisChunkDataListIterator position() {
         return m_iterator;
     }
@@ -116,10 +128,20 @@ private:
 class KRITAIMAGE_EXPORT KisChunkAllocator
 {
 public:
+    /**
+     * @param alignment if not zero, the beginning and the size of
+     *                  every chunk are rounded up to a multiple of
+     *                  \p alignment, which must be a power of two
+     */
     KisChunkAllocator(quint64 slabSize = DEFAULT_SLAB_SIZE,
-                      quint64 storeSize = DEFAULT_STORE_SIZE);
+                      quint64 storeSize = DEFAULT_STORE_SIZE,
+                      quint64 alignment = 0);
     ~KisChunkAllocator();
 
+    inline quint64 alignment() const {
+        return m_alignment;
+    }
+
     inline quint64 numChunks() const {
         return m_list.size();
     }
@@ -127,11 +149,76 @@ public:
     KisChunk getChunk(quint64 size);
     void freeChunk(KisChunk chunk);
 
+    /**
+     * Returns the number of bytes occupied by the allocated chunks
+     */
+    inline quint64 allocatedSize() const {
+        return m_allocatedSize;
+    }
+
+    /**
+     * Returns the position right after the last allocated chunk,
+     * that is the minimal size of the store needed to keep all
+     * the chunks
+     */
+    quint64 usedStoreSize() const;
+
+    /**
+     * Returns the current size of the store (always a multiple of the
+     * slab size). The store might be shrunk by compact() and
+     * shrinkStore()
+     */
+    inline quint64 storeSize() const {
+        return m_storeSize;
+    }
+
+    /**
+     * A callback used by compact() to move the actual data of a
+     * chunk. The first argument is the old position of the chunk,
+     * the second one is the new position.
+     */
+    typedef std::function<bool (const KisChunkData&, const KisChunkData&)> MoveChunkFunction;
+
+    /**
+     * Moves the chunks towards the beginning of the store, closing the
+     * gaps between them. The chunks are moved in-place, that is they
+     * stay in the same nodes of the list, so all the KisChunk objects
+     * held by the users stay valid, only their offsets change.
+     *
+     * For every relocated chunk \p moveChunk is called *before* the
+     * chunk is updated, so the caller can move the actual data. If
+     * the callback fails, the compaction is stopped.
+     *
+     * \param maxBytesToMove the compaction stops after moving this
+     *                       amount of data, so it can be done
+     *                       incrementally
+     * \return CompactionFinished if there are no gaps between the
+     *         chunks anymore, CompactionInterrupted if the limit of
+     *         \p maxBytesToMove is reached and CompactionFailed if
+     *         \p moveChunk has failed
+     */
+    enum CompactionResult {
+        CompactionFinished = 0,
+        CompactionInterrupted,
+        CompactionFailed
+    };
+
+    CompactionResult compact(quint64 maxBytesToMove, MoveChunkFunction moveChunk);
+
+    /**
+     * Shrinks the store to the minimal number of slabs
+     * needed to keep all the allocated chunks.
+     * \return the new size of the store
+     */
+    quint64 shrinkStore();
+
     void debugChunks();
     bool sanityCheck(bool pleaseCrash = true);
     qreal debugFragmentation(bool toStderr = true);
 
 private:
+    KisChunk getAlignedChunk(quint64 size);
+
     bool tryInsertChunk(KisChunkDataList &list,
                         KisChunkDataListIterator &iterator,
                         quint64 size);
@@ -139,11 +226,13 @@ private:
 private:
     quint64 m_storeMaxSize;
     quint64 m_storeSlabSize;
+    quint64 m_alignment;
 
 
     KisChunkDataList m_list;
     KisChunkDataListIterator m_iterator;
     quint64 m_storeSize;
+    quint64 m_allocatedSize;
     DECLARE_FAIL_COUNTER()
 };
 
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_lz4_compression.h"
+
+#include <config-tile-compression.h>
+#include "kis_debug.h"
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+
+KisLz4Compression::KisLz4Compression()
+{
+}
+
+KisLz4Compression::~KisLz4Compression()
+{
+}
+
+qint32 KisLz4Compression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+#ifdef HAVE_LZ4
+    return LZ4_compress_default(reinterpret_cast<const char*>(input),
+                                reinterpret_cast<char*>(output),
+                                inputLength, outputLength);
+#else
+    Q_UNUSED(input);
+    Q_UNUSED(inputLength);
+    Q_UNUSED(output);
+    Q_UNUSED(outputLength);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "Krita is built without LZ4 support");
+    return 0;
+#endif
+}
+
+qint32 KisLz4Compression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+#ifdef HAVE_LZ4
+    const int result = LZ4_decompress_safe(reinterpret_cast<const char*>(input),
+                                           reinterpret_cast<char*>(output),
+                                           inputLength, outputLength);
+    return qMax(0, result);
+#else
+    Q_UNUSED(input);
+    Q_UNUSED(inputLength);
+    Q_UNUSED(output);
+    Q_UNUSED(outputLength);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "Krita is built without LZ4 support");
+    return 0;
+#endif
+}
+
+qint32 KisLz4Compression::outputBufferSize(qint32 dataSize)
+{
+#ifdef HAVE_LZ4
+    return LZ4_compressBound(dataSize);
+#else
+    return dataSize;
+#endif
+}
+
+bool KisLz4Compression::isAvailable()
+{
+#ifdef HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_LZ4_COMPRESSION_H
+#define __KIS_LZ4_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+/**
+ * LZ4 compression. It is a bit worse in compression ratio than LZF,
+ * but decompresses several times faster, which makes it a good choice
+ * for the swap file, where tiles are decompressed right on the painting
+ * thread.
+ *
+ * The class is always declared, but is usable only when Krita is
+ * built with LZ4 support (HAVE_LZ4).
+ */
+class KRITAIMAGE_EXPORT KisLz4Compression : public KisAbstractCompression
+{
+public:
+    KisLz4Compression();
+    ~KisLz4Compression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+    /**
+     * \return true if Krita was built with LZ4 support
+     */
+    static bool isAvailable();
+};
+
+#endif /* __KIS_LZ4_COMPRESSION_H */
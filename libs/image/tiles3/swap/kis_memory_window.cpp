@@ -9,9 +9,31 @@
 
 #include <QDir>
 
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
-KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
+KisMemoryWindow::AlignedBuffer::~AlignedBuffer()
+{
+    qFreeAligned(data);
+}
+
+quint8* KisMemoryWindow::AlignedBuffer::reserve(quint64 newSize)
+{
+    if (newSize > size) {
+        qFreeAligned(data);
+        data = static_cast<quint8*>(qMallocAligned(newSize, directIOAlignment()));
+        size = data ? newSize : 0;
+    }
+
+    return data;
+}
+
+KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize, bool directIO)
     : m_readWindowEx(writeWindowSize / 4),
       m_writeWindowEx(writeWindowSize)
 {
@@ -41,14 +63,123 @@ KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize
     if (!m_valid) {
         qWarning() << "Could not create or open swapfile; disabling swapfile" << swapFileTemplate;
     }
+
+    if (m_valid && directIO && !openDirectIO()) {
+        qWarning() << "Could not open swapfile for direct I/O; using memory mapping instead" << m_file.fileName();
+    }
 }
 
 KisMemoryWindow::~KisMemoryWindow()
 {
+#ifdef Q_OS_LINUX
+    if (m_directFd >= 0) {
+        ::close(m_directFd);
+    }
+#endif
+}
+
+bool KisMemoryWindow::openDirectIO()
+{
+#ifdef Q_OS_LINUX
+    /**
+     * QTemporaryFile still owns the file and removes it on
+     * destruction, we just open one more descriptor to it
+     */
+    m_directFd = ::open(QFile::encodeName(m_file.fileName()).constData(), O_RDWR | O_DIRECT);
+    return m_directFd >= 0;
+#else
+    return false;
+#endif
+}
+
+bool KisMemoryWindow::isDirectIO() const
+{
+    return m_directFd >= 0;
+}
+
+quint64 KisMemoryWindow::directIOAlignment()
+{
+#ifdef Q_OS_LINUX
+    static const quint64 pageSize = quint64(sysconf(_SC_PAGESIZE));
+    return pageSize;
+#else
+    return 4096;
+#endif
+}
+
+quint8* KisMemoryWindow::directRead(const KisChunkData &chunk)
+{
+#ifdef Q_OS_LINUX
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!(chunk.m_begin % directIOAlignment()), nullptr);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!(chunk.size() % directIOAlignment()), nullptr);
+
+    quint8 *buffer = m_directReadBuffer.reserve(chunk.size());
+    if (!buffer) return nullptr;
+
+    quint64 bytesRead = 0;
+    while (bytesRead < chunk.size()) {
+        const ssize_t result = ::pread(m_directFd, buffer + bytesRead,
+                                       chunk.size() - bytesRead,
+                                       chunk.m_begin + bytesRead);
+        if (result < 0 && errno == EINTR) continue;
+
+        /**
+         * The tail of the last chunk might have never been written,
+         * treat the end of the file as zeroes
+         */
+        if (result == 0) {
+            memset(buffer + bytesRead, 0, chunk.size() - bytesRead);
+            break;
+        }
+
+        if (result < 0) return nullptr;
+        bytesRead += result;
+    }
+
+    return buffer;
+#else
+    Q_UNUSED(chunk);
+    return nullptr;
+#endif
+}
+
+bool KisMemoryWindow::directWrite(const KisChunkData &chunk, const quint8 *data, quint64 size)
+{
+#ifdef Q_OS_LINUX
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!(chunk.m_begin % directIOAlignment()), false);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!(chunk.size() % directIOAlignment()), false);
+
+    quint8 *buffer = m_directWriteBuffer.reserve(chunk.size());
+    if (!buffer) return false;
+
+    memcpy(buffer, data, size);
+    memset(buffer + size, 0, chunk.size() - size);
+
+    quint64 bytesWritten = 0;
+    while (bytesWritten < chunk.size()) {
+        const ssize_t result = ::pwrite(m_directFd, buffer + bytesWritten,
+                                        chunk.size() - bytesWritten,
+                                        chunk.m_begin + bytesWritten);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) return false;
+        bytesWritten += result;
+    }
+
+    return true;
+#else
+    Q_UNUSED(chunk);
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    return false;
+#endif
 }
 
 quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 {
+    if (isDirectIO()) {
+        return directRead(readChunk);
+    }
+
     if (!adjustWindow(readChunk, &m_readWindowEx, &m_writeWindowEx)) {
         return nullptr;
     }
@@ -58,6 +189,8 @@ quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 
 quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
 {
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!isDirectIO(), nullptr);
+
     if (!adjustWindow(writeChunk, &m_writeWindowEx, &m_readWindowEx)) {
         return nullptr;
     }
@@ -65,6 +198,65 @@ quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
     return m_writeWindowEx.calculatePointer(writeChunk);
 }
 
+bool KisMemoryWindow::writeChunk(const KisChunkData &chunk, const quint8 *data, quint64 size)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(size <= chunk.size(), false);
+
+    if (isDirectIO()) {
+        return directWrite(chunk, data, size);
+    }
+
+    quint8 *ptr = getWriteChunkPtr(chunk);
+    if (!ptr) return false;
+
+    memcpy(ptr, data, size);
+    return true;
+}
+
+bool KisMemoryWindow::moveChunk(const KisChunkData &from, const KisChunkData &to)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(from.size() == to.size(), false);
+
+    /**
+     * The chunks may be mapped into two different windows, so even
+     * if they overlap in the file, their pointers would not. Hence
+     * memmove() would not help us, we should use a separate buffer.
+     */
+    const quint8 *src = getReadChunkPtr(from);
+    if (!src) return false;
+
+    m_moveBuffer.resize(from.size());
+    memcpy(m_moveBuffer.data(), src, from.size());
+
+    return writeChunk(to, reinterpret_cast<const quint8*>(m_moveBuffer.constData()), to.size());
+}
+
+void KisMemoryWindow::resetWindow(MappingWindow *window)
+{
+    if (window->window) {
+        m_file.unmap(window->window);
+    }
+
+    window->window = 0;
+    window->chunk.setChunk(0, 0);
+}
+
+bool KisMemoryWindow::truncate(quint64 size)
+{
+    if (!m_valid) return false;
+    if (size >= quint64(m_file.size())) return true;
+
+    resetWindow(&m_readWindowEx);
+    resetWindow(&m_writeWindowEx);
+
+    return m_file.resize(size);
+}
+
+quint64 KisMemoryWindow::fileSize() const
+{
+    return m_valid ? m_file.size() : 0;
+}
+
 bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
                                    MappingWindow *adjustingWindow,
                                    MappingWindow *otherWindow)
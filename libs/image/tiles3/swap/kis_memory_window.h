@@ -20,10 +20,29 @@ public:
     /**
      * @param swapDir If the dir doesn't exist, it'll be created, if it's empty QDir::tempPath will be used.
      * @param writeWindowSize write window size.
+     * @param directIO access the file with O_DIRECT instead of mapping
+     *                 it into memory (Linux only). Falls back to mapping
+     *                 if the file system doesn't support it, check
+     *                 isDirectIO() for the mode actually used.
      */
-    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE);
+    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE,
+                    bool directIO = false);
     ~KisMemoryWindow();
 
+    /**
+     * In direct I/O mode the data doesn't pass through the page cache,
+     * but all the chunks must start and end at the multiple of
+     * directIOAlignment(), and the data can be written by writeChunk()
+     * only.
+     */
+    bool isDirectIO() const;
+
+    /**
+     * The alignment of the file offsets and the sizes of the chunks
+     * required by the direct I/O mode
+     */
+    static quint64 directIOAlignment();
+
     inline quint8* getReadChunkPtr(KisChunk readChunk) {
         return getReadChunkPtr(readChunk.data());
     }
@@ -32,9 +51,40 @@ public:
         return getWriteChunkPtr(writeChunk.data());
     }
 
+    /**
+     * In direct I/O mode the returned pointer stays valid until
+     * the next call to getReadChunkPtr() or moveChunk() only
+     */
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
+
+    /**
+     * Not available in direct I/O mode, use writeChunk() instead
+     */
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
 
+    /**
+     * Writes \p size bytes of \p data into the beginning of \p chunk.
+     * Works in both modes.
+     */
+    bool writeChunk(const KisChunkData &chunk, const quint8 *data, quint64 size);
+
+    /**
+     * Copies the data of chunk \p from into the chunk \p to. The
+     * chunks may overlap.
+     */
+    bool moveChunk(const KisChunkData &from, const KisChunkData &to);
+
+    /**
+     * Releases both mapping windows and cuts the swap file
+     * down to \p size bytes
+     */
+    bool truncate(quint64 size);
+
+    /**
+     * Current size of the swap file on disk
+     */
+    quint64 fileSize() const;
+
 private:
     struct MappingWindow {
         MappingWindow(quint64 _defaultSize)
@@ -59,12 +109,31 @@ private:
                       MappingWindow *adjustingWindow,
                       MappingWindow *otherWindow);
 
+    void resetWindow(MappingWindow *window);
+
+    struct AlignedBuffer {
+        ~AlignedBuffer();
+        quint8* reserve(quint64 size);
+
+        quint8 *data = nullptr;
+        quint64 size = 0;
+    };
+
+    bool openDirectIO();
+    quint8* directRead(const KisChunkData &chunk);
+    bool directWrite(const KisChunkData &chunk, const quint8 *data, quint64 size);
+
 private:
     QTemporaryFile m_file;
+    QByteArray m_moveBuffer;
 
     bool m_valid;
     MappingWindow m_readWindowEx;
     MappingWindow m_writeWindowEx;
+
+    int m_directFd = -1;
+    AlignedBuffer m_directReadBuffer;
+    AlignedBuffer m_directWriteBuffer;
 };
 
 #endif /* __KIS_MEMORY_WINDOW_H */
@@ -8,24 +8,36 @@
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
+#include "kis_assert.h"
+#include "KisPerformanceCounters.h"
 
 #include "kis_tile_compressor_2.h"
 
-//#define COMPRESSOR_VERSION 2
-
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_memoryMetric(0)
+    : m_compressedMemoryUsage(0),
+      m_memoryMetric(0)
 {
     KisImageConfig config(true);
+    m_compressedMemoryLimit = qint64(config.swapInMemoryLimit()) * MiB;
+
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
     const quint64 swapSlabSize = config.swapSlabSize() * MiB;
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
-    m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize, config.swapDirectIO());
+
+    /**
+     * O_DIRECT requests must be aligned both in the file and
+     * in memory, so the chunks should be aligned as well
+     */
+    const quint64 alignment = m_swapSpace->isDirectIO() ? KisMemoryWindow::directIOAlignment() : 0;
+    m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize, alignment);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    /**
+     * Swapped tiles never leave the current session, so we can freely
+     * choose the fastest algorithm available in the current build
+     */
+    m_compressor = new KisTileCompressor2(config.swapCompression());
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
@@ -40,7 +52,7 @@ quint64 KisSwappedDataStore::numTiles() const
     // We are not acquiring the lock here...
     // Hope QLinkedList will ensure atomic access to it's size...
 
-    return m_allocator->numChunks();
+    return m_allocator->numChunks() + m_compressedQueue.size();
 }
 
 bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
@@ -61,17 +73,71 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     qint32 bytesWritten;
     m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
 
+    if (bytesWritten <= m_compressedMemoryLimit) {
+        while (m_compressedMemoryUsage + bytesWritten > m_compressedMemoryLimit) {
+            if (!evictOldestCompressedTile()) break;
+        }
+
+        if (m_compressedMemoryUsage + bytesWritten <= m_compressedMemoryLimit) {
+            CompressedTile compressedTile;
+            compressedTile.data = QByteArray(m_buffer.constData(), bytesWritten);
+            compressedTile.queuePosition = m_compressedQueue.insert(m_compressedQueue.end(), td);
+            m_compressedTiles.insert(td, compressedTile);
+            m_compressedMemoryUsage += bytesWritten;
+
+            td->releaseMemory();
+            td->setSwapChunk(KisChunk());
+
+            m_memoryMetric += td->pixelSize();
+            KisPerformanceCounters::add(KisPerformanceCounters::SwappedOutBytes, td->pixelSize());
+
+            return true;
+        }
+    }
+
     KisChunk chunk = m_allocator->getChunk(bytesWritten);
-    quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
-    if (!ptr) {
+    if (!m_swapSpace->writeChunk(chunk.data(), (const quint8*) m_buffer.constData(), bytesWritten)) {
         qWarning() << "swap out of tile failed";
+        m_allocator->freeChunk(chunk);
         return false;
     }
-    memcpy(ptr, m_buffer.data(), bytesWritten);
 
     td->releaseMemory();
     td->setSwapChunk(chunk);
 
+    m_memoryMetric += td->pixelSize();
+    KisPerformanceCounters::add(KisPerformanceCounters::SwappedOutBytes, td->pixelSize());
+
+    return true;
+}
+
+bool KisSwappedDataStore::storeTileDataStream(KisTileData *td, const QByteArray &stream, const QString &compressionName)
+{
+    Q_ASSERT(td->data());
+    QMutexLocker locker(&m_lock);
+
+    const qint64 size = stream.size();
+
+    if (size > m_compressedMemoryLimit) return false;
+
+    while (m_compressedMemoryUsage + size > m_compressedMemoryLimit) {
+        if (!evictOldestCompressedTile()) break;
+    }
+
+    if (m_compressedMemoryUsage + size > m_compressedMemoryLimit) return false;
+
+    CompressedTile compressedTile;
+    compressedTile.data = stream;
+    if (compressionName != m_compressor->compressionName()) {
+        compressedTile.compressionName = compressionName;
+    }
+    compressedTile.queuePosition = m_compressedQueue.insert(m_compressedQueue.end(), td);
+    m_compressedTiles.insert(td, compressedTile);
+    m_compressedMemoryUsage += size;
+
+    td->releaseMemory();
+    td->setSwapChunk(KisChunk());
+
     m_memoryMetric += td->pixelSize();
 
     return true;
@@ -84,6 +150,25 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
 
     // see comment in swapOutTileData()
 
+    auto it = m_compressedTiles.find(td);
+    if (it != m_compressedTiles.end()) {
+        td->allocateMemory();
+
+        if (it->compressionName.isEmpty()) {
+            m_compressor->decompressTileData((quint8*)it->data.data(), it->data.size(), td);
+        } else {
+            m_compressor->decompressTileData(it->compressionName, (quint8*)it->data.data(), it->data.size(), td);
+        }
+
+        m_compressedMemoryUsage -= it->data.size();
+        m_compressedQueue.erase(it->queuePosition);
+        m_compressedTiles.erase(it);
+
+        m_memoryMetric -= td->pixelSize();
+        KisPerformanceCounters::add(KisPerformanceCounters::SwappedInBytes, td->pixelSize());
+        return;
+    }
+
     KisChunk chunk = td->swapChunk();
 
     td->allocateMemory();
@@ -91,16 +176,27 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
 
     quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
     Q_ASSERT(ptr);
-    m_compressor->decompressTileData(ptr, chunk.size(), td);
+    m_compressor->decompressTileData(ptr, chunk.dataSize(), td);
     m_allocator->freeChunk(chunk);
 
     m_memoryMetric -= td->pixelSize();
+    KisPerformanceCounters::add(KisPerformanceCounters::SwappedInBytes, td->pixelSize());
 }
 
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
+    auto it = m_compressedTiles.find(td);
+    if (it != m_compressedTiles.end()) {
+        m_compressedMemoryUsage -= it->data.size();
+        m_compressedQueue.erase(it->queuePosition);
+        m_compressedTiles.erase(it);
+
+        m_memoryMetric -= td->pixelSize();
+        return;
+    }
+
     m_allocator->freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
 
@@ -112,6 +208,118 @@ qint64 KisSwappedDataStore::totalMemoryMetric() const
     return m_memoryMetric;
 }
 
+qint64 KisSwappedDataStore::compressedMemoryUsage() const
+{
+    return m_compressedMemoryUsage;
+}
+
+qint64 KisSwappedDataStore::swapFileSize() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_swapSpace->fileSize();
+}
+
+qint64 KisSwappedDataStore::swapFileUsage() const
+{
+    // We are not acquiring the lock here, the value is statistical only
+    return m_allocator->allocatedSize();
+}
+
+bool KisSwappedDataStore::tryCompactSwapFile()
+{
+    /**
+     * Don't bother compacting the file unless at least a half of it
+     * is free and the free space is big enough to be worth it
+     */
+    const qreal minFreeFraction = 0.5;
+    const quint64 minFreeSize = 16 * MiB;
+    const quint64 bytesPerStep = 4 * MiB;
+
+    {
+        QMutexLocker locker(&m_lock);
+
+        const quint64 fileSize = m_swapSpace->fileSize();
+        const quint64 freeSize = fileSize - qMin(fileSize, quint64(m_allocator->allocatedSize()));
+
+        if (freeSize < minFreeSize || freeSize < minFreeFraction * fileSize) {
+            return false;
+        }
+    }
+
+    KisChunkAllocator::CompactionResult result = KisChunkAllocator::CompactionInterrupted;
+
+    while (result == KisChunkAllocator::CompactionInterrupted) {
+        QMutexLocker locker(&m_lock);
+
+        result = m_allocator->compact(
+            bytesPerStep,
+            [this] (const KisChunkData &from, const KisChunkData &to) {
+                return m_swapSpace->moveChunk(from, to);
+            });
+    }
+
+    if (result == KisChunkAllocator::CompactionFailed) {
+        qWarning() << "swap file compaction failed";
+        return false;
+    }
+
+    QMutexLocker locker(&m_lock);
+
+    const quint64 newStoreSize = m_allocator->shrinkStore();
+    return m_swapSpace->truncate(newStoreSize);
+}
+
+bool KisSwappedDataStore::evictOldestCompressedTile()
+{
+    if (m_compressedQueue.isEmpty()) return false;
+
+    /**
+     * The data of the evicted tile is not in memory, so nobody
+     * but us (and we hold m_lock) can access its swap chunk.
+     * Therefore, it is safe to move it without taking the
+     * tile data's swap lock.
+     */
+    KisTileData *td = m_compressedQueue.first();
+    auto it = m_compressedTiles.find(td);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(it != m_compressedTiles.end(), false);
+
+    QByteArray data = it->data;
+
+    if (!it->compressionName.isEmpty()) {
+        /**
+         * The chunks in the swap file are always compressed with our
+         * own algorithm, so recompress the streams loaded from files.
+         * m_buffer may keep the data of the tile being swapped out,
+         * so use a separate buffer.
+         */
+        td->allocateMemory();
+        m_compressor->decompressTileData(it->compressionName, (quint8*)data.data(), data.size(), td);
+
+        data.resize(m_compressor->tileDataBufferSize(td));
+        qint32 bytesWritten;
+        m_compressor->compressTileData(td, (quint8*)data.data(), data.size(), bytesWritten);
+        data.resize(bytesWritten);
+
+        td->releaseMemory();
+    }
+
+    const qint32 size = data.size();
+
+    KisChunk chunk = m_allocator->getChunk(size);
+    if (!m_swapSpace->writeChunk(chunk.data(), (const quint8*) data.constData(), size)) {
+        qWarning() << "eviction of a compressed tile to swap failed";
+        m_allocator->freeChunk(chunk);
+        return false;
+    }
+    td->setSwapChunk(chunk);
+
+    m_compressedMemoryUsage -= it->data.size();
+    m_compressedQueue.removeFirst();
+    m_compressedTiles.erase(it);
+
+    return true;
+}
+
 void KisSwappedDataStore::debugStatistics()
 {
     m_allocator->sanityCheck();
@@ -11,14 +11,27 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QHash>
+#include <QLinkedList>
 
 
 class QMutex;
 class KisTileData;
-class KisAbstractTileCompressor;
+class KisTileCompressor2;
 class KisChunkAllocator;
 class KisMemoryWindow;
 
+/**
+ * Stores the data of the swapped out tiles.
+ *
+ * The store has two tiers. Freshly swapped out tiles are first kept
+ * compressed in RAM (zram-style), as long as the total size of the
+ * compressed data fits into KisImageConfig::swapInMemoryLimit(). When
+ * the budget is exhausted, the oldest compressed tiles are moved to
+ * the swap file on disk without recompression. Therefore, most of
+ * the swap hits caused by panning or undo become cheap decompressions
+ * instead of file reads.
+ */
 class KRITAIMAGE_EXPORT KisSwappedDataStore
 {
 public:
@@ -38,6 +51,19 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Puts \p stream into the in-memory tier as the compressed data
+     * of \p td, and frees memory occupied by td->data(). The stream
+     * should be written with \p compressionName algorithm, which
+     * may differ from the one the swap uses itself.
+     *
+     * \return false if the stream doesn't fit into the in-memory
+     *         tier, then \p td is left unchanged
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool storeTileDataStream(KisTileData *td, const QByteArray &stream, const QString &compressionName);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -59,19 +85,74 @@ public:
      */
     qint64 totalMemoryMetric() const;
 
+    /**
+     * Returns the number of bytes occupied by the compressed
+     * tiles kept in RAM
+     */
+    qint64 compressedMemoryUsage() const;
+
+    /**
+     * Returns the size of the swap file on disk
+     */
+    qint64 swapFileSize() const;
+
+    /**
+     * Returns the number of bytes in the swap file
+     * occupied by the swapped tiles
+     */
+    qint64 swapFileUsage() const;
+
+    /**
+     * Defragments the swap file if the fraction of free space in
+     * it is too high: moves the chunks towards the beginning of
+     * the file, coalescing the free slices, and truncates the file.
+     * The compaction happens in small steps, releasing the lock in
+     * between, so the swapping threads are not blocked for long.
+     *
+     * Called by the swapper thread.
+     *
+     * \return true if the swap file has been shrunk
+     */
+    bool tryCompactSwapFile();
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
+private:
+    /**
+     * Moves the oldest compressed tile from RAM to the swap file
+     * LOCKING: m_lock should be taken by the caller
+     */
+    bool evictOldestCompressedTile();
+
+private:
+    struct CompressedTile {
+        QByteArray data;
+        /// empty if compressed by the algorithm of the swap itself
+        QString compressionName;
+        QLinkedList<KisTileData*>::iterator queuePosition;
+    };
+
+    QHash<KisTileData*, CompressedTile> m_compressedTiles;
+
+    /**
+     * Tiles compressed in RAM, the oldest one is in the front
+     */
+    QLinkedList<KisTileData*> m_compressedQueue;
+
+    qint64 m_compressedMemoryUsage;
+    qint64 m_compressedMemoryLimit;
+
 private:
     QByteArray m_buffer;
-    KisAbstractTileCompressor *m_compressor;
+    KisTileCompressor2 *m_compressor;
 
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
-    QMutex m_lock;
+    mutable QMutex m_lock;
 
     qint64 m_memoryMetric;
 };
@@ -6,33 +6,134 @@
 
 #include "kis_tile_compressor_2.h"
 #include "kis_lzf_compression.h"
+#include "kis_lz4_compression.h"
+#include "kis_zstd_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
+#include "../KisTileStreamCache.h"
+#include "../kis_tile_data_store.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(const QString &compressionName)
+    : m_compressionName(compressionName.toUpper())
 {
-    m_compression = new KisLzfCompression();
+    if (!isCompressionSupported(m_compressionName)) {
+        warnTiles << "Tile compression" << compressionName << "is not supported, falling back to LZF";
+        m_compressionName = lzfCompressionName();
+    }
+
+    m_compression = createCompression(m_compressionName);
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
     delete m_compression;
+    qDeleteAll(m_readCompressions);
+}
+
+QString KisTileCompressor2::lzfCompressionName()
+{
+    return QStringLiteral("LZF");
+}
+
+QString KisTileCompressor2::lz4CompressionName()
+{
+    return QStringLiteral("LZ4");
+}
+
+QString KisTileCompressor2::zstdCompressionName()
+{
+    return QStringLiteral("ZSTD");
+}
+
+bool KisTileCompressor2::isCompressionSupported(const QString &compressionName)
+{
+    return compressionName == lzfCompressionName() ||
+        (compressionName == lz4CompressionName() && KisLz4Compression::isAvailable()) ||
+        (compressionName == zstdCompressionName() && KisZstdCompression::isAvailable());
+}
+
+QString KisTileCompressor2::compressionName() const
+{
+    return m_compressionName;
+}
+
+KisAbstractCompression* KisTileCompressor2::createCompression(const QString &compressionName)
+{
+    if (compressionName == lz4CompressionName()) {
+        return new KisLz4Compression();
+    } else if (compressionName == zstdCompressionName()) {
+        return new KisZstdCompression();
+    }
+
+    return new KisLzfCompression();
+}
+
+KisAbstractCompression* KisTileCompressor2::compressionForName(const QString &compressionName)
+{
+    if (compressionName == m_compressionName) {
+        return m_compression;
+    }
+
+    if (!isCompressionSupported(compressionName)) {
+        return 0;
+    }
+
+    KisAbstractCompression *compression = m_readCompressions.value(compressionName, 0);
+    if (!compression) {
+        compression = createCompression(compressionName);
+        m_readCompressions.insert(compressionName, compression);
+    }
+
+    return compression;
 }
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
+    KisTileStreamCache *cache = store.tileStreamCache();
+    QByteArray cachedStream;
+
+    // the raw streams have the same header, so any reader can load them
+    const bool storeRaw = store.storeRawTiles();
+    const QString streamName = storeRaw ? QStringLiteral("RAW") : m_compressionName;
+
+    tile->lockForRead();
+
+    if (cache && cache->fetch(tile->tileData(), streamName, &cachedStream)) {
+        tile->unlockForRead();
+
+        bool retval = store.write(getHeader(tile, cachedStream.size()).toLatin1());
+        if (!retval) {
+            warnFile << "Failed to write the tile header";
+        }
+        retval = store.write(cachedStream);
+        if (!retval) {
+            warnFile << "Failed to write the tile datak";
+        }
+        return retval;
+    }
+
     const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
     prepareStreamingBuffer(tileDataSize);
 
     qint32 bytesWritten;
 
-    tile->lockForRead();
-    compressTileData(tile->tileData(), (quint8*)m_streamingBuffer.data(),
-                     m_streamingBuffer.size(), bytesWritten);
+    if (storeRaw) {
+        m_streamingBuffer[0] = RAW_DATA_FLAG;
+        memcpy(m_streamingBuffer.data() + 1, tile->tileData()->data(), tileDataSize);
+        bytesWritten = tileDataSize + 1;
+    } else {
+        compressTileData(tile->tileData(), (quint8*)m_streamingBuffer.data(),
+                         m_streamingBuffer.size(), bytesWritten);
+    }
+
+    if (cache) {
+        // the tile data should not go away until the cache acquires it
+        cache->store(tile->tileData(), streamName,
+                     QByteArray(m_streamingBuffer.data(), bytesWritten));
+    }
+
     tile->unlockForRead();
 
     QString header = getHeader(tile, bytesWritten);
@@ -50,7 +151,9 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+    const qint32 tilePixelSize = pixelSize(dm);
+    const QSize tileSize = streamTileSize();
+    const qint32 tileDataSize = tilePixelSize * tileSize.width() * tileSize.height();
     prepareStreamingBuffer(tileDataSize);
 
     QByteArray header = stream->readLine(maxHeaderLength());
@@ -63,23 +166,74 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        KisAbstractCompression *compression = compressionForName(compressionName);
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
 
-        KisTileSP tile = dm->getTile(col, row, true);
-
         stream->read(m_streamingBuffer.data(), dataSize);
 
+        if (!compression) {
+            warnTiles << "Failed to read a tile: unsupported compression" << compressionName;
+            return false;
+        }
+
+        if (!streamTileSizeMatches()) {
+            /**
+             * The file was saved with a different tile size, so the
+             * stored tile may cover several tiles of ours (or only
+             * a part of one)
+             */
+            m_retilingBuffer.resize(tileDataSize);
+
+            bool res = decompressData(compression, (quint8*)m_streamingBuffer.data(), dataSize,
+                                      (quint8*)m_retilingBuffer.data(), tileDataSize, tilePixelSize);
+            if (res) {
+                writeBytes(dm, (const quint8*)m_retilingBuffer.constData(),
+                           x, y, tileSize.width(), tileSize.height());
+            }
+            return res;
+        }
+
+        KisTileSP tile = dm->getTile(col, row, true);
+
         tile->lockForWrite();
-        bool res = decompressTileData((quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
+
+        if (keepCompressed() && dataSize > 0 &&
+            (m_streamingBuffer[0] == RAW_DATA_FLAG || m_streamingBuffer[0] == COMPRESSED_DATA_FLAG)) {
+
+            /**
+             * Locking for write has detached the tile from the default
+             * tile data, so its tile data can be swapped out with the
+             * stream as it is. It will be decompressed on first access.
+             */
+            KisTileData *td = tile->tileData();
+            tile->unlockForWrite();
+
+            if (KisTileDataStore::instance()->swapOutTileDataStream(td, QByteArray(m_streamingBuffer.constData(), dataSize),
+                                                                   compressionName)) {
+                return true;
+            }
+
+            tile->lockForWrite();
+        }
+
+        bool res = decompressTileData(compression, (quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
         tile->unlockForWrite();
         return res;
     }
     return false;
 }
 
+bool KisTileCompressor2::decompressTileData(const QString &compressionName,
+                                            quint8 *buffer, qint32 bufferSize,
+                                            KisTileData *tileData)
+{
+    KisAbstractCompression *compression = compressionForName(compressionName);
+    return compression && decompressTileData(compression, buffer, bufferSize, tileData);
+}
+
 void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
 {
     /**
@@ -89,9 +243,9 @@ void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
     m_streamingBuffer.resize(tileDataSize + 1);
 }
 
-void KisTileCompressor2::prepareWorkBuffers(qint32 tileDataSize)
+void KisTileCompressor2::prepareWorkBuffers(KisAbstractCompression *compression, qint32 tileDataSize)
 {
-    const qint32 bufferSize = m_compression->outputBufferSize(tileDataSize);
+    const qint32 bufferSize = compression->outputBufferSize(tileDataSize);
 
     m_linearizationBuffer.resize(tileDataSize);
     m_compressionBuffer.resize(bufferSize);
@@ -109,7 +263,7 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     Q_UNUSED(bufferSize);
     Q_ASSERT(bufferSize >= tileDataSize + 1);
 
-    prepareWorkBuffers(tileDataSize);
+    prepareWorkBuffers(m_compression, tileDataSize);
 
     KisAbstractCompression::linearizeColors(tileData->data(), (quint8*)m_linearizationBuffer.data(),
                                             tileDataSize, pixelSize);
@@ -117,7 +271,7 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
         buffer[0] = COMPRESSED_DATA_FLAG;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
@@ -132,26 +286,43 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
 bool KisTileCompressor2::decompressTileData(quint8 *buffer,
                                             qint32 bufferSize,
                                             KisTileData *tileData)
+{
+    return decompressTileData(m_compression, buffer, bufferSize, tileData);
+}
+
+bool KisTileCompressor2::decompressTileData(KisAbstractCompression *compression,
+                                            quint8 *buffer,
+                                            qint32 bufferSize,
+                                            KisTileData *tileData)
 {
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
+    return decompressData(compression, buffer, bufferSize,
+                          tileData->data(), tileDataSize, pixelSize);
+}
+
+bool KisTileCompressor2::decompressData(KisAbstractCompression *compression,
+                                        quint8 *buffer, qint32 bufferSize,
+                                        quint8 *data, qint32 dataSize,
+                                        qint32 pixelSize)
+{
     if(buffer[0] == COMPRESSED_DATA_FLAG) {
-        prepareWorkBuffers(tileDataSize);
+        prepareWorkBuffers(compression, dataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
-        if (bytesWritten == tileDataSize) {
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                                 (quint8*)m_linearizationBuffer.data(), dataSize);
+        if (bytesWritten == dataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
-                                                      tileData->data(),
-                                                      tileDataSize, pixelSize);
+                                                      data,
+                                                      dataSize, pixelSize);
             return true;
         }
         return false;
     }
     else {
-        memcpy(tileData->data(), buffer + 1, tileDataSize);
+        memcpy(data, buffer + 1, dataSize);
         return true;
     }
     return false;
@@ -9,14 +9,41 @@
 
 #include "kis_abstract_tile_compressor.h"
 
+#include <QHash>
+
 class KisAbstractCompression;
 
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    /**
+     * Creates a compressor that will write the tiles using
+     * \p compressionName algorithm ("LZF", "LZ4" or "ZSTD").
+     * The name is saved in the header of every tile, so
+     * readTile() can load tiles written with any supported
+     * algorithm, independently of the one passed here.
+     *
+     * If the requested algorithm is not supported by the
+     * current build, LZF is used instead.
+     */
+    KisTileCompressor2(const QString &compressionName = lzfCompressionName());
     ~KisTileCompressor2() override;
 
+    static QString lzfCompressionName();
+    static QString lz4CompressionName();
+    static QString zstdCompressionName();
+
+    /**
+     * \return true if the current build can compress and
+     * decompress tiles with \p compressionName algorithm
+     */
+    static bool isCompressionSupported(const QString &compressionName);
+
+    /**
+     * The name of the algorithm actually used for writing tiles
+     */
+    QString compressionName() const;
+
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *io, KisTiledDataManager *dm) override;
 
@@ -26,6 +53,14 @@ public:
     bool decompressTileData(quint8 *buffer, qint32 bufferSize, KisTileData *tileData) override;
     qint32 tileDataBufferSize(KisTileData *tileData) override;
 
+    /**
+     * Decompresses \p buffer written by compressTileData() of a
+     * compressor using \p compressionName algorithm
+     */
+    bool decompressTileData(const QString &compressionName,
+                            quint8 *buffer, qint32 bufferSize,
+                            KisTileData *tileData);
+
 private:
     /**
      * Quite self describing
@@ -34,7 +69,20 @@ private:
 
     QString getHeader(KisTileSP tile, qint32 compressedSize);
 
-    void prepareWorkBuffers(qint32 tileDataSize);
+    void prepareWorkBuffers(KisAbstractCompression *compression, qint32 tileDataSize);
+
+    bool decompressTileData(KisAbstractCompression *compression,
+                            quint8 *buffer, qint32 bufferSize,
+                            KisTileData *tileData);
+
+    bool decompressData(KisAbstractCompression *compression,
+                        quint8 *buffer, qint32 bufferSize,
+                        quint8 *data, qint32 dataSize,
+                        qint32 pixelSize);
+
+    KisAbstractCompression* compressionForName(const QString &compressionName);
+
+    static KisAbstractCompression* createCompression(const QString &compressionName);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
 private:
@@ -45,8 +93,20 @@ private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+
+    /**
+     * Used only for reading streams with a foreign tile size
+     */
+    QByteArray m_retilingBuffer;
+
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    QString m_compressionName;
+
+    /**
+     * Compressions used for reading tiles written with an algorithm
+     * different from m_compressionName. Created on demand.
+     */
+    QHash<QString, KisAbstractCompression*> m_readCompressions;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
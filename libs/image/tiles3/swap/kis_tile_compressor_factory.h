@@ -27,6 +27,20 @@ public:
         };
     }
 
+    /**
+     * Creates a compressor of version \p version that writes tiles
+     * using \p compressionName algorithm. The legacy compressor has
+     * no notion of the algorithm, so the name is ignored for it.
+     *
+     * \see KisTileCompressor2::KisTileCompressor2()
+     */
+    static KisAbstractTileCompressorSP create(qint32 version, const QString &compressionName) {
+        if (version == 2) {
+            return KisAbstractTileCompressorSP(new KisTileCompressor2(compressionName));
+        }
+        return create(version);
+    }
+
 private:
     KisTileCompressorFactory();
 };
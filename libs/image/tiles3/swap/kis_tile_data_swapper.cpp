@@ -5,6 +5,8 @@
  */
 
 #include <QSemaphore>
+#include <QVector>
+#include <algorithm>
 
 #include "tiles3/swap/kis_tile_data_swapper.h"
 #include "tiles3/swap/kis_tile_data_swapper_p.h"
@@ -85,6 +87,12 @@ void KisTileDataSwapper::run()
         QThread::msleep(DELAY);
 
         doJob();
+
+        /**
+         * The swap file only grows while swapping out the tiles, so
+         * check if we can give some disk space back to the system
+         */
+        m_d->store->tryCompactSwapFile();
     }
 }
 
@@ -103,6 +111,13 @@ void KisTileDataSwapper::doJob()
      */
     QMutexLocker locker(&m_d->cycleLock);
 
+    if (m_d->limits.historyLimitThreshold() > 0) {
+        DEBUG_ACTION("\t history pass");
+        qint64 historyFreed = historyPass();
+        DEBUG_VALUE(historyFreed);
+        Q_UNUSED(historyFreed);
+    }
+
     qint32 memoryMetric = m_d->store->memoryMetric();
 
     DEBUG_ACTION("Started swap cycle");
@@ -223,6 +238,49 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     return freedMetric;
 }
 
+qint64 KisTileDataSwapper::historyPass()
+{
+    qint64 historicalMetric = 0;
+    qint64 freedMetric = 0;
+    QVector<KisTileData*> candidates;
+
+    KisTileDataStoreIterator *iter = m_d->store->beginIteration();
+
+    while (iter->hasNext()) {
+        KisTileData *item = iter->next();
+
+        if (item->historical() && item->data()) {
+            historicalMetric += item->pixelSize();
+            candidates.append(item);
+        }
+    }
+
+    if (historicalMetric > m_d->limits.historyLimitThreshold()) {
+        const qint64 needToFreeMetric = historicalMetric - m_d->limits.historyLimit();
+
+        /**
+         * Tile data objects are numbered in the order of creation,
+         * so the smallest numbers belong to the oldest revisions
+         */
+        std::sort(candidates.begin(), candidates.end(),
+                  [] (KisTileData *lhs, KisTileData *rhs) {
+                      return lhs->m_tileNumber < rhs->m_tileNumber;
+                  });
+
+        Q_FOREACH (KisTileData *item, candidates) {
+            if (freedMetric >= needToFreeMetric) break;
+
+            if (iter->trySwapOut(item)) {
+                freedMetric += item->pixelSize();
+            }
+        }
+    }
+
+    m_d->store->endIteration(iter);
+
+    return freedMetric;
+}
+
 void KisTileDataSwapper::testingRereadConfig()
 {
     m_d->limits = KisStoreLimits();
@@ -36,6 +36,7 @@ private:
 
     void doJob();
     template<class strategy> qint64 pass(qint64 needToFreeMetric);
+    qint64 historyPass();
 
 private:
     static const qint32 TIMEOUT;
@@ -41,6 +41,11 @@
   |                        |
   +------------------------+  <-- 0 MiB
 
+  Independently of the total memory usage, the memento tiles of the
+  oldest revisions are swapped out when the memento tiles alone
+  occupy more than historyLimitThreshold, until they fit into
+  historyLimit.
+
  */
 
 
@@ -57,6 +62,9 @@ public:
 
         m_softLimitThreshold = qBound(0, MiB_TO_METRIC(config.tilesSoftLimit()), m_hardLimitThreshold);
         m_softLimit = m_softLimitThreshold - m_softLimitThreshold / 8;
+
+        m_historyLimitThreshold = qMax(0, MiB_TO_METRIC(config.historyMemoryLimit()));
+        m_historyLimit = m_historyLimitThreshold - m_historyLimitThreshold / 8;
     }
 
     /**
@@ -83,12 +91,26 @@ public:
         return m_softLimit;
     }
 
+    /**
+     * The limits for the memory occupied by historical tiles only.
+     * Zero threshold means there is no such limit.
+     */
+    inline qint32 historyLimitThreshold() {
+        return m_historyLimitThreshold;
+    }
+
+    inline qint32 historyLimit() {
+        return m_historyLimit;
+    }
+
 private:
     qint32 m_emergencyThreshold;
     qint32 m_hardLimitThreshold;
     qint32 m_hardLimit;
     qint32 m_softLimitThreshold;
     qint32 m_softLimit;
+    qint32 m_historyLimitThreshold;
+    qint32 m_historyLimit;
 };
 
 
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_swap_prefetcher.h"
+
+#include <QGlobalStatic>
+#include "kis_debug.h"
+
+Q_GLOBAL_STATIC(KisTileSwapPrefetcher, s_instance)
+
+const int KisTileSwapPrefetcher::MAX_QUEUE_SIZE = 256;
+
+
+KisTileSwapPrefetcher::KisTileSwapPrefetcher()
+    : QThread(),
+      m_shouldExitFlag(0),
+      m_isProcessing(false)
+{
+    start(QThread::LowPriority);
+}
+
+KisTileSwapPrefetcher::~KisTileSwapPrefetcher()
+{
+    terminatePrefetcher();
+}
+
+KisTileSwapPrefetcher* KisTileSwapPrefetcher::instance()
+{
+    return s_instance;
+}
+
+void KisTileSwapPrefetcher::prefetch(KisTileSP tile)
+{
+    /**
+     * Reading the data pointer without the swap lock is racy, but
+     * we don't care: in the worst case we either skip the tile or
+     * just lock an already loaded one.
+     */
+    if (!tile || tile->tileData()->data()) return;
+
+    QMutexLocker l(&m_lock);
+    if (m_queue.size() >= MAX_QUEUE_SIZE) return;
+
+    m_queue.enqueue(tile);
+    m_semaphore.release();
+}
+
+void KisTileSwapPrefetcher::terminatePrefetcher()
+{
+    unsigned long exitTimeout = 100;
+    do {
+        m_shouldExitFlag = true;
+        m_semaphore.release();
+    } while(!wait(exitTimeout));
+
+    QMutexLocker l(&m_lock);
+    m_queue.clear();
+    m_idleCondition.wakeAll();
+}
+
+void KisTileSwapPrefetcher::testingWaitForIdle()
+{
+    QMutexLocker l(&m_lock);
+    while (!m_queue.isEmpty() || m_isProcessing) {
+        m_idleCondition.wait(&m_lock);
+    }
+}
+
+void KisTileSwapPrefetcher::run()
+{
+    while (1) {
+        m_semaphore.acquire();
+
+        if (m_shouldExitFlag)
+            return;
+
+        KisTileSP tile;
+
+        {
+            QMutexLocker l(&m_lock);
+            if (m_queue.isEmpty()) continue;
+            tile = m_queue.dequeue();
+            m_isProcessing = true;
+        }
+
+        /**
+         * Locking the tile for read forces KisTileDataStore to load
+         * its data from the swap, if it is still swapped out
+         */
+        tile->lockForRead();
+        tile->unlockForRead();
+        tile = 0;
+
+        {
+            QMutexLocker l(&m_lock);
+            m_isProcessing = false;
+            if (m_queue.isEmpty()) {
+                m_idleCondition.wakeAll();
+            }
+        }
+    }
+}
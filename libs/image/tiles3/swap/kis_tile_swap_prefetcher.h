@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_SWAP_PREFETCHER_H
+#define __KIS_TILE_SWAP_PREFETCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QQueue>
+#include <QSemaphore>
+#include <QWaitCondition>
+
+#include "kritaimage_export.h"
+#include "tiles3/kis_tile.h"
+
+
+/**
+ * Loads swapped out tiles in background, before the painting
+ * threads actually need them.
+ *
+ * When a painting thread hits a swapped out tile, its neighbours
+ * are most probably swapped out as well and will be requested
+ * in a few moments, because iterators walk tiles in a predictable
+ * order. KisTiledDataManager passes such neighbours to the
+ * prefetcher, which swaps them in on its own thread, so the
+ * painting thread doesn't stall on every one of them.
+ *
+ * The prefetcher holds shared pointers to the tiles, so the tiles
+ * stay alive until they are processed. The queue is bounded, the
+ * requests that do not fit are silently dropped: prefetching is
+ * just a hint.
+ */
+class KRITAIMAGE_EXPORT KisTileSwapPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileSwapPrefetcher();
+    ~KisTileSwapPrefetcher() override;
+
+    static KisTileSwapPrefetcher* instance();
+
+    /**
+     * Queues \p tile for loading if its data is swapped out
+     */
+    void prefetch(KisTileSP tile);
+
+    void terminatePrefetcher();
+
+    /**
+     * Blocks until all the queued tiles are processed.
+     * Used in unittests only.
+     */
+    void testingWaitForIdle();
+
+protected:
+    void run() override;
+
+private:
+    static const int MAX_QUEUE_SIZE;
+
+    QMutex m_lock;
+    QWaitCondition m_idleCondition;
+    QQueue<KisTileSP> m_queue;
+    QSemaphore m_semaphore;
+    QAtomicInt m_shouldExitFlag;
+    bool m_isProcessing;
+};
+
+#endif /* __KIS_TILE_SWAP_PREFETCHER_H */
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_zstd_compression.h"
+
+#include <config-tile-compression.h>
+#include "kis_debug.h"
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+
+struct KisZstdCompression::Private
+{
+    int compressionLevel = 3;
+
+#ifdef HAVE_ZSTD
+    /**
+     * The contexts are reused between the calls to avoid
+     * reallocation of the working memory for every tile.
+     * The compressor object itself is never shared between
+     * threads, so no locking is needed.
+     */
+    ZSTD_CCtx *compressionContext = nullptr;
+    ZSTD_DCtx *decompressionContext = nullptr;
+#endif
+};
+
+KisZstdCompression::KisZstdCompression(int compressionLevel)
+    : m_d(new Private)
+{
+    m_d->compressionLevel = compressionLevel;
+
+#ifdef HAVE_ZSTD
+    m_d->compressionContext = ZSTD_createCCtx();
+    m_d->decompressionContext = ZSTD_createDCtx();
+#endif
+}
+
+KisZstdCompression::~KisZstdCompression()
+{
+#ifdef HAVE_ZSTD
+    ZSTD_freeCCtx(m_d->compressionContext);
+    ZSTD_freeDCtx(m_d->decompressionContext);
+#endif
+}
+
+qint32 KisZstdCompression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+#ifdef HAVE_ZSTD
+    const size_t result = ZSTD_compressCCtx(m_d->compressionContext,
+                                            output, outputLength,
+                                            input, inputLength,
+                                            m_d->compressionLevel);
+    return ZSTD_isError(result) ? 0 : qint32(result);
+#else
+    Q_UNUSED(input);
+    Q_UNUSED(inputLength);
+    Q_UNUSED(output);
+    Q_UNUSED(outputLength);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "Krita is built without Zstandard support");
+    return 0;
+#endif
+}
+
+qint32 KisZstdCompression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+#ifdef HAVE_ZSTD
+    const size_t result = ZSTD_decompressDCtx(m_d->decompressionContext,
+                                              output, outputLength,
+                                              input, inputLength);
+    return ZSTD_isError(result) ? 0 : qint32(result);
+#else
+    Q_UNUSED(input);
+    Q_UNUSED(inputLength);
+    Q_UNUSED(output);
+    Q_UNUSED(outputLength);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "Krita is built without Zstandard support");
+    return 0;
+#endif
+}
+
+qint32 KisZstdCompression::outputBufferSize(qint32 dataSize)
+{
+#ifdef HAVE_ZSTD
+    return ZSTD_compressBound(dataSize);
+#else
+    return dataSize;
+#endif
+}
+
+bool KisZstdCompression::isAvailable()
+{
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
@@ -30,6 +30,104 @@ void KisChunkAllocatorTest::testOperations()
     QVERIFY(qFuzzyCompare(allocator.debugFragmentation(), 1./6));
 }
 
+void KisChunkAllocatorTest::testCompaction()
+{
+    const quint64 slabSize = 100;
+    KisChunkAllocator allocator(slabSize, 10 * slabSize);
+
+    QList<KisChunk> chunks;
+    for (int i = 0; i < 30; i++) {
+        chunks.append(allocator.getChunk(10));
+    }
+
+    QCOMPARE(allocator.allocatedSize(), quint64(300));
+    QCOMPARE(allocator.usedStoreSize(), quint64(300));
+
+    // free every other chunk to fragment the store
+    QList<KisChunk> survivors;
+    for (int i = 0; i < chunks.size(); i++) {
+        if (i % 2) {
+            survivors.append(chunks[i]);
+        } else {
+            allocator.freeChunk(chunks[i]);
+        }
+    }
+
+    QCOMPARE(allocator.allocatedSize(), quint64(150));
+    QCOMPARE(allocator.usedStoreSize(), quint64(300));
+
+    int numMoves = 0;
+    auto countMoves = [&numMoves] (const KisChunkData &from, const KisChunkData &to) {
+        Q_ASSERT(from.size() == to.size());
+        Q_ASSERT(to.m_begin < from.m_begin);
+        numMoves++;
+        return true;
+    };
+
+    // the limit is reached after the first moved chunk
+    QCOMPARE(allocator.compact(1, countMoves), KisChunkAllocator::CompactionInterrupted);
+    QCOMPARE(numMoves, 1);
+    allocator.sanityCheck();
+
+    while (allocator.compact(20, countMoves) == KisChunkAllocator::CompactionInterrupted);
+    QCOMPARE(numMoves, 15);
+    allocator.sanityCheck();
+
+    QCOMPARE(allocator.usedStoreSize(), quint64(150));
+    QVERIFY(qFuzzyIsNull(allocator.debugFragmentation()));
+
+    // the chunks are moved in-place, so the handles are still valid
+    for (int i = 0; i < survivors.size(); i++) {
+        QCOMPARE(survivors[i].begin(), quint64(i * 10));
+        QCOMPARE(survivors[i].size(), quint64(10));
+    }
+
+    QCOMPARE(allocator.storeSize(), 3 * slabSize);
+    QCOMPARE(allocator.shrinkStore(), 2 * slabSize);
+
+    // new chunks are allocated right after the compacted ones
+    KisChunk newChunk = allocator.getChunk(10);
+    QCOMPARE(newChunk.begin(), quint64(150));
+    allocator.sanityCheck();
+}
+
+void KisChunkAllocatorTest::testAlignment()
+{
+    const quint64 alignment = 64;
+    KisChunkAllocator allocator(1024, 16 * 1024, alignment);
+
+    QList<KisChunk> chunks;
+    for (int i = 0; i < 20; i++) {
+        chunks.append(allocator.getChunk(1 + i * 7));
+    }
+
+    for (int i = 0; i < chunks.size(); i++) {
+        QCOMPARE(chunks[i].begin() % alignment, quint64(0));
+        QCOMPARE(chunks[i].size() % alignment, quint64(0));
+        QCOMPARE(chunks[i].dataSize(), quint64(1 + i * 7));
+    }
+    allocator.sanityCheck();
+
+    for (int i = 0; i < chunks.size(); i += 2) {
+        allocator.freeChunk(chunks[i]);
+    }
+
+    auto noop = [] (const KisChunkData &, const KisChunkData &) { return true; };
+    QCOMPARE(allocator.compact(16 * 1024, noop), KisChunkAllocator::CompactionFinished);
+    allocator.sanityCheck();
+
+    // compaction keeps both the alignment and the data size
+    for (int i = 1; i < chunks.size(); i += 2) {
+        QCOMPARE(chunks[i].begin() % alignment, quint64(0));
+        QCOMPARE(chunks[i].dataSize(), quint64(1 + i * 7));
+    }
+
+    KisChunk newChunk = allocator.getChunk(100);
+    QCOMPARE(newChunk.begin() % alignment, quint64(0));
+    QCOMPARE(newChunk.size(), quint64(128));
+    allocator.sanityCheck();
+}
+
 
 #define NUM_TRANSACTIONS 30
 #define NUM_CHUNKS_ALLOC 15000
@@ -14,6 +14,7 @@
 #include "tiles_test_utils.h"
 #include "tiles3/kis_tiled_data_manager.h"
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_tile_swap_prefetcher.h"
 #include <kis_debug.h>
 #include "config-limit-long-tests.h"
 
@@ -206,4 +207,31 @@ void KisLowMemoryTests::hangingTilesTest()
     dstTile = 0;
 }
 
+void KisLowMemoryTests::swapPrefetchTest()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel = 128;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    const int numTiles = 6;
+    dm.clear(QRect(0, 0, numTiles * 64, 64), &oddPixel);
+
+    KisTileDataStore::instance()->debugSwapAll();
+
+    // fetching the first tile should read ahead along the row
+    KisTileSP firstTile = dm.getTile(0, 0, false);
+    QVERIFY(!firstTile->tileData()->data());
+
+    KisTileSwapPrefetcher::instance()->testingWaitForIdle();
+
+    for (int i = 1; i < 5; i++) {
+        KisTileSP tile = dm.getTile(i, 0, false);
+        QVERIFY(tile->tileData()->data());
+
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(oddPixel, tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+}
+
 QTEST_MAIN(KisLowMemoryTests)
@@ -17,6 +17,7 @@ private Q_SLOTS:
 
     void readWriteOnSharedTiles();
     void hangingTilesTest();
+    void swapPrefetchTest();
 };
 
 #endif /* __KIS_LOW_MEMORY_TESTS_H */
@@ -42,6 +42,51 @@ void KisMemoryWindowTest::testWindow()
     QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
 }
 
+void KisMemoryWindowTest::testDirectIO()
+{
+    QTemporaryDir swapDir;
+    KisMemoryWindow memory(swapDir.path(), 1024, true);
+
+    if (!memory.isDirectIO()) {
+        QSKIP("O_DIRECT is not supported by the file system of the temporary dir");
+    }
+
+    const quint64 alignment = KisMemoryWindow::directIOAlignment();
+    const quint8 chunkLength = 10;
+
+    quint8 oddBuf[chunkLength];
+    memset(oddBuf, 0xee, chunkLength);
+
+    quint8 evenBuf[chunkLength];
+    memset(evenBuf, 0x11, chunkLength);
+
+    KisChunkData chunk1(0, alignment);
+    KisChunkData chunk2(3 * alignment, alignment);
+
+    QVERIFY(memory.writeChunk(chunk1, oddBuf, chunkLength));
+    QVERIFY(memory.writeChunk(chunk2, evenBuf, chunkLength));
+
+    quint8 *ptr;
+
+    ptr = memory.getReadChunkPtr(chunk2);
+    QVERIFY(ptr);
+    QVERIFY(!memcmp(ptr, evenBuf, chunkLength));
+
+    ptr = memory.getReadChunkPtr(chunk1);
+    QVERIFY(ptr);
+    QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
+
+    KisChunkData chunk3(alignment, alignment);
+    QVERIFY(memory.moveChunk(chunk2, chunk3));
+
+    ptr = memory.getReadChunkPtr(chunk3);
+    QVERIFY(ptr);
+    QVERIFY(!memcmp(ptr, evenBuf, chunkLength));
+
+    QVERIFY(memory.truncate(2 * alignment));
+    QCOMPARE(memory.fileSize(), 2 * alignment);
+}
+
 void KisMemoryWindowTest::testTopReports()
 {
 
@@ -36,5 +36,29 @@ void KisStoreLimitsTest::testLimits()
     QCOMPARE(limits.softLimit(), softLimit);
 }
 
+void KisStoreLimitsTest::testHistoryLimits()
+{
+    KisImageConfig config(false);
+
+    config.setHistoryMemoryLimit(0);
+    {
+        KisStoreLimits limits;
+        QCOMPARE(limits.historyLimitThreshold(), 0);
+        QCOMPARE(limits.historyLimit(), 0);
+    }
+
+    config.setHistoryMemoryLimit(512);
+    {
+        int historyLimitThreshold = MiB_TO_METRIC(512);
+        int historyLimit = historyLimitThreshold - historyLimitThreshold / 8;
+
+        KisStoreLimits limits;
+        QCOMPARE(limits.historyLimitThreshold(), historyLimitThreshold);
+        QCOMPARE(limits.historyLimit(), historyLimit);
+    }
+
+    config.setHistoryMemoryLimit(0);
+}
+
 QTEST_MAIN(KisStoreLimitsTest)
 
@@ -16,6 +16,7 @@ private:
 
 private Q_SLOTS:
     void testLimits();
+    void testHistoryLimits();
 };
 
 #endif /* KIS_STORE_LIMITS_TEST_H */
@@ -29,6 +29,7 @@ void KisSwappedDataStoreTest::testRoundTrip()
     config.setMaxSwapSize(4);
     config.setSwapSlabSize(1);
     config.setSwapWindowSize(1);
+    config.setSwapInMemoryLimit(0);
 
 
     KisSwappedDataStore store;
@@ -119,5 +120,61 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testInMemoryTier()
+{
+    qsrand(10);
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 1000;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(40);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setSwapInMemoryLimit(1);
+
+    KisSwappedDataStore store;
+
+    QList<KisTileData*> tileDataList;
+    QList<QByteArray> referenceData;
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+
+        // the tiles are incompressible, so the
+        // budget will be exhausted pretty fast
+        for (qint32 j = 0; j < TILESIZE; j++) {
+            td->data()[j] = qrand() % 256;
+        }
+
+        referenceData.append(QByteArray((const char*)td->data(), TILESIZE));
+        tileDataList.append(td);
+
+        // FIXME: take a lock of the tile data
+        QVERIFY(store.trySwapOutTileData(td));
+        QVERIFY(store.compressedMemoryUsage() <= qint64(MiB));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+    QVERIFY(store.compressedMemoryUsage() > 0);
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+        QVERIFY(!memcmp(td->data(), referenceData[i].constData(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.compressedMemoryUsage(), qint64(0));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+
+    config.setSwapInMemoryLimit(config.swapInMemoryLimit(true));
+}
+
 QTEST_MAIN(KisSwappedDataStoreTest)
 
@@ -167,6 +167,63 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRoundTripAlgorithms_data()
+{
+    QTest::addColumn<QString>("compressionName");
+
+    QTest::newRow("lzf") << KisTileCompressor2::lzfCompressionName();
+    QTest::newRow("lz4") << KisTileCompressor2::lz4CompressionName();
+    QTest::newRow("zstd") << KisTileCompressor2::zstdCompressionName();
+}
+
+void KisTileCompressorsTest::testRoundTripAlgorithms()
+{
+    QFETCH(QString, compressionName);
+
+    if (!KisTileCompressor2::isCompressionSupported(compressionName)) {
+        QSKIP("The compression algorithm is not supported by the build");
+    }
+
+    KisTileCompressor2 compressor(compressionName);
+    QCOMPARE(compressor.compressionName(), compressionName);
+
+    doRoundTrip(&compressor);
+    doLowLevelRoundTrip(&compressor);
+    doLowLevelRoundTripIncompressible(&compressor);
+}
+
+void KisTileCompressorsTest::testReadForeignAlgorithm()
+{
+    const QString compressionName = KisTileCompressor2::zstdCompressionName();
+
+    if (!KisTileCompressor2::isCompressionSupported(compressionName)) {
+        QSKIP("Zstandard is not supported by the build");
+    }
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    dm.clear(64, 64, 64, 64, &oddPixel1);
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+
+    KisTileCompressor2 writingCompressor(compressionName);
+    QVERIFY(writingCompressor.writeTile(dm.getTile(1, 1, false), writer));
+
+    fakeStore.startReading();
+    dm.clear();
+
+    // the header of the tile tells the reader which algorithm to use
+    KisTileCompressor2 readingCompressor;
+    QCOMPARE(readingCompressor.compressionName(), KisTileCompressor2::lzfCompressionName());
+    QVERIFY(readingCompressor.readTile(fakeStore.device(), &dm));
+
+    KisTileSP tile11 = dm.getTile(1, 1, false);
+    QVERIFY(memoryIsFilled(oddPixel1, tile11->data(), TILESIZE));
+}
+
 
 QTEST_MAIN(KisTileCompressorsTest)
 
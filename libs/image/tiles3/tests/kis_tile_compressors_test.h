@@ -26,6 +26,10 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testRoundTripAlgorithms_data();
+    void testRoundTripAlgorithms();
+    void testReadForeignAlgorithm();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
@@ -99,4 +99,41 @@ void KisTileDataPoolerTest::testCycles()
     KisTileDataStore::instance()->debugClear();
 }
 
+void KisTileDataPoolerTest::testDuplicatedTilesFirst()
+{
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+
+    KisTileDataStore::instance()->debugClear();
+
+    KisTileData *idleTile =
+        KisTileDataStore::instance()->createDefaultTileData(pixelSize, &defaultPixel);
+    KisTileData *writtenTile =
+        KisTileDataStore::instance()->createDefaultTileData(pixelSize, &defaultPixel);
+
+    for (int i = 0; i < 2; i++) {
+        idleTile->acquire();
+        writtenTile->acquire();
+    }
+
+    // simulate a copy-on-write that has just happened
+    writtenTile->m_numDuplications.ref();
+
+    {
+        // there is memory for one clone only
+        KisTileDataPooler pooler(KisTileDataStore::instance(), 1);
+        pooler.start();
+        pooler.kick();
+
+        QTest::qSleep(500);
+
+        pooler.terminatePooler();
+    }
+
+    QCOMPARE(writtenTile->m_clonesStack.size(), 1);
+    QCOMPARE(idleTile->m_clonesStack.size(), 0);
+
+    KisTileDataStore::instance()->debugClear();
+}
+
 QTEST_MAIN(KisTileDataPoolerTest)
@@ -15,6 +15,7 @@ class KisTileDataPoolerTest : public QObject
 
 private Q_SLOTS:
     void testCycles();
+    void testDuplicatedTilesFirst();
 };
 
 #endif /* __KIS_TILE_DATA_POOLER_TEST_H */
@@ -6,8 +6,10 @@
 
 #include "kis_tiled_data_manager_test.h"
 #include <QTest>
+#include <QBuffer>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/KisTileStreamCache.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -529,6 +531,355 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+void KisTiledDataManagerTest::testUniformTilesSharing()
+{
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 200;
+    quint8 oddPixel = 100;
+
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    dm1.clear(QRect(0, 0, 128, 128), &fillPixel);
+    dm2.clear(QRect(64, 64, 128, 128), &fillPixel);
+
+    // all the fully covered tiles share the same data across devices
+    KisTileData *td = dm1.getTile(0, 0, false)->tileData();
+    QCOMPARE(dm1.getTile(1, 1, false)->tileData(), td);
+    QCOMPARE(dm2.getTile(1, 1, false)->tileData(), td);
+    QCOMPARE(dm2.getTile(2, 2, false)->tileData(), td);
+
+    // writing causes copy-on-write and doesn't affect other tiles
+    dm2.clear(QRect(64, 64, 1, 1), &oddPixel);
+    QVERIFY(dm2.getTile(1, 1, false)->tileData() != td);
+    QCOMPARE(dm2.getTile(2, 2, false)->tileData(), td);
+
+    quint8 pixel = 0;
+    dm1.readBytes(&pixel, 64, 64, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+
+    dm2.readBytes(&pixel, 64, 64, 1, 1);
+    QCOMPARE(pixel, oddPixel);
+}
+
+void KisTiledDataManagerTest::testReadForeignTileSize_data()
+{
+    QTest::addColumn<int>("tileSize");
+
+    QTest::newRow("32") << 32;
+    QTest::newRow("128") << 128;
+    QTest::newRow("256") << 256;
+}
+
+void KisTiledDataManagerTest::testReadForeignTileSize()
+{
+    QFETCH(int, tileSize);
+
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 200;
+
+    /**
+     * A stream with one raw tile in position (1, 1) saved
+     * by a build with a different tile size
+     */
+    QByteArray data;
+    data += QString("VERSION 2\n"
+                    "TILEWIDTH %1\n"
+                    "TILEHEIGHT %1\n"
+                    "PIXELSIZE 1\n"
+                    "DATA 1\n").arg(tileSize).toLatin1();
+    data += QString("%1,%1,LZF,%2\n").arg(tileSize).arg(tileSize * tileSize + 1).toLatin1();
+    data += char(0); // RAW_DATA_FLAG
+    data += QByteArray(tileSize * tileSize, char(fillPixel));
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+
+    KisTiledDataManager dm(1, &defaultPixel);
+    QVERIFY(dm.read(&buffer));
+
+    const QRect expectedRect(tileSize, tileSize, tileSize, tileSize);
+    const QRect checkRect = expectedRect.adjusted(-1, -1, 1, 1);
+
+    quint8 *bytes = new quint8[checkRect.width() * checkRect.height()];
+    dm.readBytes(bytes, checkRect.x(), checkRect.y(), checkRect.width(), checkRect.height());
+
+    QVERIFY(checkHole(bytes, fillPixel, expectedRect, defaultPixel, checkRect));
+
+    delete[] bytes;
+}
+
+void KisTiledDataManagerTest::testChangeTracking()
+{
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 200;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    dm.clear(QRect(0, 0, 10, 10), &fillPixel);
+
+    const int revision = dm.takeChangeRevision();
+
+    // partial write into one tile and a whole tile clear of another
+    dm.clear(QRect(70, 5, 10, 10), &fillPixel);
+    dm.clear(QRect(-KisTileData::WIDTH, 0, KisTileData::WIDTH, KisTileData::HEIGHT), &fillPixel);
+
+    // reading doesn't mark anything
+    quint8 pixel;
+    dm.readBytes(&pixel, 200, 200, 1, 1);
+
+    auto sortTiles = [] (QVector<QPoint> &tiles) {
+        std::sort(tiles.begin(), tiles.end(),
+                  [] (const QPoint &lhs, const QPoint &rhs) { return lhs.x() < rhs.x(); });
+    };
+
+    // the tiles written in the revision itself are reported as well
+    QVector<QPoint> tiles;
+    QVERIFY(dm.changedTilesSince(revision, &tiles));
+    sortTiles(tiles);
+
+    QCOMPARE(tiles.size(), 3);
+    QCOMPARE(tiles[0], QPoint(-1, 0));
+    QCOMPARE(tiles[1], QPoint(0, 0));
+    QCOMPARE(tiles[2], QPoint(1, 0));
+
+    tiles.clear();
+    QVERIFY(dm.changedTilesSince(revision + 1, &tiles));
+    sortTiles(tiles);
+
+    QCOMPARE(tiles.size(), 2);
+    QCOMPARE(tiles[0], QPoint(-1, 0));
+    QCOMPARE(tiles[1], QPoint(1, 0));
+
+    // nothing has changed since the next revision
+    const int nextRevision = dm.takeChangeRevision() + 1;
+
+    tiles.clear();
+    QVERIFY(dm.changedTilesSince(nextRevision, &tiles));
+    QVERIFY(tiles.isEmpty());
+
+    // change of the default pixel affects all the tiles
+    dm.setDefaultPixel(&fillPixel);
+    QVERIFY(!dm.changedTilesSince(nextRevision, &tiles));
+}
+
+class KisCachingPaintDeviceWriter : public KisPaintDeviceWriter {
+public:
+    KisCachingPaintDeviceWriter(KisTileStreamCache *cache, bool storeRawTiles = false)
+        : m_cache(cache),
+          m_storeRawTiles(storeRawTiles)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_data += data;
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_data.append(data, length);
+        return true;
+    }
+
+    KisTileStreamCache* tileStreamCache() const override {
+        return m_cache;
+    }
+
+    bool storeRawTiles() const override {
+        return m_storeRawTiles;
+    }
+
+    QByteArray m_data;
+
+private:
+    KisTileStreamCache *m_cache;
+    bool m_storeRawTiles;
+};
+
+void KisTiledDataManagerTest::testTileStreamCache()
+{
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 200;
+    quint8 changedPixel = 100;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    dm.clear(QRect(0, 0, 2 * KisTileData::WIDTH, KisTileData::HEIGHT), &fillPixel);
+
+    KisTileStreamCache cache;
+
+    auto save = [&dm, &cache] () {
+        KisCachingPaintDeviceWriter writer(&cache);
+        cache.beginSaving();
+        KIS_SAFE_ASSERT_RECOVER_NOOP(dm.write(writer));
+        cache.endSaving();
+        return writer.m_data;
+    };
+
+    const QByteArray firstStream = save();
+    const qint64 cachedSize = cache.totalSize();
+    QVERIFY(cachedSize > 0);
+
+    // the cached streams are the same as the compressed ones
+    QCOMPARE(save(), firstStream);
+    QCOMPARE(cache.totalSize(), cachedSize);
+
+    // the write into a saved tile detaches it from the cached tile data
+    dm.clear(QRect(5, 5, 1, 1), &changedPixel);
+
+    QByteArray secondStream = save();
+    QVERIFY(secondStream != firstStream);
+
+    QBuffer buffer(&secondStream);
+    buffer.open(QIODevice::ReadOnly);
+
+    KisTiledDataManager loadedDm(1, &defaultPixel);
+    QVERIFY(loadedDm.read(&buffer));
+
+    quint8 pixel;
+    loadedDm.readBytes(&pixel, 5, 5, 1, 1);
+    QCOMPARE(pixel, changedPixel);
+    loadedDm.readBytes(&pixel, 6, 5, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+    loadedDm.readBytes(&pixel, KisTileData::WIDTH + 5, 5, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+}
+
+void KisTiledDataManagerTest::testReadKeepCompressed()
+{
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 200;
+    quint8 changedPixel = 100;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    dm.clear(QRect(0, 0, 2 * KisTileData::WIDTH, KisTileData::HEIGHT), &fillPixel);
+    dm.clear(QRect(5, 5, 1, 1), &changedPixel);
+
+    KisCachingPaintDeviceWriter writer(0);
+    QVERIFY(dm.write(writer));
+
+    QBuffer buffer(&writer.m_data);
+    buffer.open(QIODevice::ReadOnly);
+
+    // the tiles are swapped in on the first access
+    KisTiledDataManager loadedDm(1, &defaultPixel);
+    QVERIFY(loadedDm.read(&buffer, true));
+    QCOMPARE(loadedDm.extent(), dm.extent());
+
+    quint8 pixel;
+    loadedDm.readBytes(&pixel, 5, 5, 1, 1);
+    QCOMPARE(pixel, changedPixel);
+    loadedDm.readBytes(&pixel, 6, 5, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+    loadedDm.readBytes(&pixel, KisTileData::WIDTH + 5, 5, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+}
+
+void KisTiledDataManagerTest::testWriteRawTiles()
+{
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 200;
+    quint8 changedPixel = 100;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    dm.clear(QRect(0, 0, 2 * KisTileData::WIDTH, KisTileData::HEIGHT), &fillPixel);
+    dm.clear(QRect(5, 5, 1, 1), &changedPixel);
+
+    KisCachingPaintDeviceWriter compressedWriter(0);
+    QVERIFY(dm.write(compressedWriter));
+
+    KisCachingPaintDeviceWriter rawWriter(0, true);
+    QVERIFY(dm.write(rawWriter));
+    QVERIFY(rawWriter.m_data.size() > 2 * KisTileData::WIDTH * KisTileData::HEIGHT);
+    QVERIFY(rawWriter.m_data.size() > compressedWriter.m_data.size());
+
+    QBuffer buffer(&rawWriter.m_data);
+    buffer.open(QIODevice::ReadOnly);
+
+    KisTiledDataManager loadedDm(1, &defaultPixel);
+    QVERIFY(loadedDm.read(&buffer));
+    QCOMPARE(loadedDm.extent(), dm.extent());
+
+    quint8 pixel;
+    loadedDm.readBytes(&pixel, 5, 5, 1, 1);
+    QCOMPARE(pixel, changedPixel);
+    loadedDm.readBytes(&pixel, 6, 5, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+    loadedDm.readBytes(&pixel, KisTileData::WIDTH + 5, 5, 1, 1);
+    QCOMPARE(pixel, fillPixel);
+}
+
+#include "tiles3/KisTileFillOp.h"
+
+void KisTiledDataManagerTest::testFillPixels_data()
+{
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<int>("numPixels");
+
+    QList<int> pixelSizes = {1, 2, 3, 4, 5, 8, 10, 16, 20};
+    QList<int> numPixels = {0, 1, 3, 17, 64, 4096};
+
+    Q_FOREACH (int pixelSize, pixelSizes) {
+        Q_FOREACH (int num, numPixels) {
+            QTest::addRow("%d bytes x %d", pixelSize, num) << pixelSize << num;
+        }
+    }
+}
+
+void KisTiledDataManagerTest::testFillPixels()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(int, numPixels);
+
+    QByteArray pixel(pixelSize, 0);
+    for (int i = 0; i < pixelSize; i++) {
+        pixel[i] = char(i * 37 + 11);
+    }
+
+    // one guard pixel after the end should stay untouched
+    QByteArray buffer((numPixels + 1) * pixelSize, char(0xAA));
+
+    KisTileFillOp::instance()->fillPixels(reinterpret_cast<quint8*>(buffer.data()),
+                                          reinterpret_cast<const quint8*>(pixel.constData()),
+                                          pixelSize, numPixels);
+
+    for (int i = 0; i < numPixels; i++) {
+        QCOMPARE(buffer.mid(i * pixelSize, pixelSize), pixel);
+    }
+
+    QCOMPARE(buffer.mid(numPixels * pixelSize), QByteArray(pixelSize, char(0xAA)));
+}
+
+void KisTiledDataManagerTest::testShareUniformTiles()
+{
+    quint8 defaultPixel = 0;
+    quint8 fillPixel = 255;
+
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    // written pixel by pixel, so every tile gets its own data
+    QVector<quint8> data(160 * 128, fillPixel);
+    dm.writeBytes(data.constData(), 0, 0, 160, 128);
+
+    QVector<quint8> zeros(64 * 64, defaultPixel);
+    dm.writeBytes(zeros.constData(), 256, 256, 64, 64);
+
+    QCOMPARE(dm.extent(), QRect(0, 0, 320, 320));
+    QVERIFY(dm.getTile(0, 0, false)->tileData() != dm.getTile(1, 1, false)->tileData());
+
+    dm.shareUniformTiles(dm.extent());
+
+    KisTileData *td = dm.getTile(0, 0, false)->tileData();
+    QCOMPARE(dm.getTile(1, 0, false)->tileData(), td);
+    QCOMPARE(dm.getTile(1, 1, false)->tileData(), td);
+    QVERIFY(dm.getTile(2, 0, false)->tileData() != td);
+
+    // the tile of the default pixel has been freed
+    QCOMPARE(dm.extent(), QRect(0, 0, 192, 128));
+
+    QVector<quint8> result(160 * 128);
+    dm.readBytes(result.data(), 0, 0, 160, 128);
+    QCOMPARE(result, data);
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
@@ -40,6 +40,16 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testUniformTilesSharing();
+    void testShareUniformTiles();
+    void testReadForeignTileSize_data();
+    void testReadForeignTileSize();
+    void testChangeTracking();
+    void testTileStreamCache();
+    void testReadKeepCompressed();
+    void testWriteRawTiles();
+    void testFillPixels_data();
+    void testFillPixels();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
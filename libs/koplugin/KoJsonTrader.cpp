@@ -110,11 +110,8 @@ KoJsonTrader* KoJsonTrader::instance()
     return s_instance;
 }
 
-QList<QPluginLoader *> KoJsonTrader::query(const QString &servicetype, const QString &mimetype) const
+void KoJsonTrader::scanPlugins() const
 {
-    QMutexLocker l(&m_mutex);
-
-    QList<QPluginLoader *>list;
     QDirIterator dirIter(m_pluginPath, QDirIterator::Subdirectories);
     while (dirIter.hasNext()) {
         dirIter.next();
@@ -125,39 +122,59 @@ QList<QPluginLoader *> KoJsonTrader::query(const QString &servicetype, const QSt
         if (dirIter.fileInfo().isFile() && dirIter.fileName().startsWith("krita") && !dirIter.fileName().endsWith(".debug")) {
 #endif
             debugPlugin << dirIter.fileName();
-            QPluginLoader *loader = new QPluginLoader(dirIter.filePath());
-            QJsonObject json = loader->metaData().value("MetaData").toObject();
-
-            debugPlugin << mimetype << json << json.value("X-KDE-ServiceTypes");
+            QPluginLoader loader(dirIter.filePath());
+            QJsonObject json = loader.metaData().value("MetaData").toObject();
 
             if (json.isEmpty()) {
-                delete loader;
                 qWarning() << dirIter.filePath() << "has no json!";
+                continue;
             }
-            else {
-                QJsonArray  serviceTypes = json.value("X-KDE-ServiceTypes").toArray();
-                if (serviceTypes.isEmpty()) {
-                    qWarning() << dirIter.fileName() << "has no X-KDE-ServiceTypes";
-                }
-                if (!serviceTypes.contains(QJsonValue(servicetype))) {
-                    delete loader;
-                    continue;
-                }
 
-                if (!mimetype.isEmpty()) {
-                    QStringList mimeTypes = json.value("X-KDE-ExtraNativeMimeTypes").toString().split(',');
-                    mimeTypes += json.value("MimeType").toString().split(';');
-                    mimeTypes += json.value("X-KDE-NativeMimeType").toString();
-                    if (! mimeTypes.contains(mimetype)) {
-                        qWarning() << dirIter.filePath() << "doesn't contain mimetype" << mimetype << "in" << mimeTypes;
-                        delete loader;
-                        continue;
-                    }
-                }
-                list.append(loader);
+            if (json.value("X-KDE-ServiceTypes").toArray().isEmpty()) {
+                qWarning() << dirIter.fileName() << "has no X-KDE-ServiceTypes";
+            }
+
+            PluginInfo info;
+            info.filePath = dirIter.filePath();
+            info.metaData = json;
+            m_plugins.append(info);
+        }
+    }
+
+    m_pluginsScanned = true;
+}
+
+QList<QPluginLoader *> KoJsonTrader::query(const QString &servicetype, const QString &mimetype) const
+{
+    QMutexLocker l(&m_mutex);
+
+    // every query used to read the metadata of every plugin file again
+    if (!m_pluginsScanned) {
+        scanPlugins();
+    }
+
+    QList<QPluginLoader *>list;
+    Q_FOREACH (const PluginInfo &info, m_plugins) {
+        const QJsonObject &json = info.metaData;
+
+        debugPlugin << mimetype << json << json.value("X-KDE-ServiceTypes");
+
+        QJsonArray  serviceTypes = json.value("X-KDE-ServiceTypes").toArray();
+        if (!serviceTypes.contains(QJsonValue(servicetype))) {
+            continue;
+        }
+
+        if (!mimetype.isEmpty()) {
+            QStringList mimeTypes = json.value("X-KDE-ExtraNativeMimeTypes").toString().split(',');
+            mimeTypes += json.value("MimeType").toString().split(';');
+            mimeTypes += json.value("X-KDE-NativeMimeType").toString();
+            if (! mimeTypes.contains(mimetype)) {
+                qWarning() << info.filePath << "doesn't contain mimetype" << mimetype << "in" << mimeTypes;
+                continue;
             }
         }
 
+        list.append(new QPluginLoader(info.filePath));
     }
     return list;
 }
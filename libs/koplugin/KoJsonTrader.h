@@ -11,6 +11,7 @@
 #include <QList>
 #include <QString>
 #include <QMutex>
+#include <QJsonObject>
 #include "kritaplugin_export.h"
 
 class QPluginLoader;
@@ -55,8 +56,22 @@ public:
      KoJsonTrader();
 
 private:
+     struct PluginInfo {
+         QString filePath;
+         QJsonObject metaData;
+     };
+
+     /**
+      * Reads the metadata of all the plugins once. Only the metadata is
+      * read, the libraries are loaded when the caller instantiates the
+      * plugins from the returned loaders.
+      */
+     void scanPlugins() const;
+
      QString m_pluginPath;
      mutable QMutex m_mutex;
+     mutable QList<PluginInfo> m_plugins;
+     mutable bool m_pluginsScanned {false};
 };
 
 #endif
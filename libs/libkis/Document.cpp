@@ -182,7 +182,7 @@ bool Document::setColorProfile(const QString &value)
     const KoColorProfile *profile = KoColorSpaceRegistry::instance()->profileByName(value);
     if (!profile) return false;
     bool retval = d->document->image()->assignImageProfile(profile);
-    d->document->image()->waitForDone();
+    LibKisUtils::waitForOperations(d->document->image());
     return retval;
 }
 
@@ -197,7 +197,7 @@ bool Document::setColorSpace(const QString &colorModel, const QString &colorDept
                                                  KoColorConversionTransformation::IntentPerceptual,
                                                  KoColorConversionTransformation::HighQuality | KoColorConversionTransformation::NoOptimization);
 
-    d->document->image()->waitForDone();
+    LibKisUtils::waitForOperations(d->document->image());
     return true;
 }
 
@@ -261,6 +261,7 @@ int Document::height() const
     if (!d->document) return 0;
     KisImageSP image = d->document->image();
     if (!image) return 0;
+    LibKisUtils::waitForBatchedOperations(image);
     return image->height();
 }
 
@@ -268,6 +269,7 @@ void Document::setHeight(int value)
 {
     if (!d->document) return;
     if (!d->document->image()) return;
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     resizeImage(d->document->image()->bounds().x(),
                 d->document->image()->bounds().y(),
                 d->document->image()->width(),
@@ -307,7 +309,7 @@ void Document::setResolution(int value)
     KIS_SAFE_ASSERT_RECOVER_RETURN(strategy);
 
     image->scaleImage(image->size(), value / 72.0, value / 72.0, strategy);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 
@@ -346,6 +348,7 @@ int Document::width() const
     if (!d->document) return 0;
     KisImageSP image = d->document->image();
     if (!image) return 0;
+    LibKisUtils::waitForBatchedOperations(image);
     return image->width();
 }
 
@@ -353,6 +356,7 @@ void Document::setWidth(int value)
 {
     if (!d->document) return;
     if (!d->document->image()) return;
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     resizeImage(d->document->image()->bounds().x(),
                 d->document->image()->bounds().y(),
                 value,
@@ -372,6 +376,7 @@ void Document::setXOffset(int x)
 {
     if (!d->document) return;
     if (!d->document->image()) return;
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     resizeImage(x,
                 d->document->image()->bounds().y(),
                 d->document->image()->width(),
@@ -391,6 +396,7 @@ void Document::setYOffset(int y)
 {
     if (!d->document) return;
     if (!d->document->image()) return;
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     resizeImage(d->document->image()->bounds().x(),
                 y,
                 d->document->image()->width(),
@@ -415,7 +421,7 @@ void Document::setXRes(double xRes) const
     KIS_SAFE_ASSERT_RECOVER_RETURN(strategy);
 
     image->scaleImage(image->size(), xRes / 72.0, image->yRes(), strategy);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 double Document::yRes() const
@@ -435,7 +441,7 @@ void Document::setYRes(double yRes) const
     KIS_SAFE_ASSERT_RECOVER_RETURN(strategy);
 
     image->scaleImage(image->size(), image->xRes(), yRes / 72.0, strategy);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 
@@ -447,6 +453,8 @@ QByteArray Document::pixelData(int x, int y, int w, int h) const
     KisImageSP image = d->document->image();
     if (!image) return ba;
 
+    LibKisUtils::waitForBatchedOperations(image);
+
     KisPaintDeviceSP dev = image->projection();
     ba.resize(w * h * dev->pixelSize());
     dev->readBytes(reinterpret_cast<quint8*>(ba.data()), x, y, w, h);
@@ -481,7 +489,7 @@ void Document::crop(int x, int y, int w, int h)
     if (!image) return;
     QRect rc(x, y, w, h);
     image->cropImage(rc);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 bool Document::exportImage(const QString &filename, const InfoObject &exportConfiguration)
@@ -499,7 +507,7 @@ void Document::flatten()
     if (!d->document) return;
     if (!d->document->image()) return;
     d->document->image()->flatten(0);
-    d->document->image()->waitForDone();
+    LibKisUtils::waitForOperations(d->document->image());
 }
 
 void Document::resizeImage(int x, int y, int w, int h)
@@ -514,7 +522,7 @@ void Document::resizeImage(int x, int y, int w, int h)
     rc.setHeight(h);
 
     image->resizeImage(rc);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 void Document::scaleImage(int w, int h, int xres, int yres, QString strategy)
@@ -530,7 +538,7 @@ void Document::scaleImage(int w, int h, int xres, int yres, QString strategy)
     if (!actualStrategy) actualStrategy = KisFilterStrategyRegistry::instance()->get("Bicubic");
 
     image->scaleImage(rc.size(), xres/72, yres/72, actualStrategy);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 void Document::rotateImage(double radians)
@@ -539,7 +547,7 @@ void Document::rotateImage(double radians)
     KisImageSP image = d->document->image();
     if (!image) return;
     image->rotateImage(radians);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 void Document::shearImage(double angleX, double angleY)
@@ -548,7 +556,7 @@ void Document::shearImage(double angleX, double angleY)
     KisImageSP image = d->document->image();
     if (!image) return;
     image->shear(angleX, angleY);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 }
 
 bool Document::save()
@@ -736,12 +744,14 @@ SelectionMask *Document::createSelectionMask(const QString &name)
 QImage Document::projection(int x, int y, int w, int h) const
 {
     if (!d->document || !d->document->image()) return QImage();
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     return d->document->image()->convertToQImage(x, y, w, h, 0);
 }
 
 QImage Document::thumbnail(int w, int h) const
 {
     if (!d->document || !d->document->image()) return QImage();
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     return d->document->generatePreview(QSize(w, h)).toImage();
 }
 
@@ -764,6 +774,18 @@ void Document::waitForDone()
     d->document->image()->waitForDone();
 }
 
+void Document::beginBatch()
+{
+    if (!d->document || !d->document->image()) return;
+    LibKisUtils::beginBatch(d->document->image());
+}
+
+void Document::endBatch()
+{
+    if (!d->document || !d->document->image()) return;
+    LibKisUtils::endBatch(d->document->image());
+}
+
 bool Document::tryBarrierLock()
 {
     if (!d->document || !d->document->image()) return false;
@@ -882,6 +904,7 @@ bool Document::modified() const
 QRect Document::bounds() const
 {
     if (!d->document) return QRect();
+    LibKisUtils::waitForBatchedOperations(d->document->image());
     return d->document->image()->bounds();
 }
 
@@ -713,6 +713,39 @@ print(root.childNodes())
      */
     void waitForDone();
 
+    /**
+     * @brief beginBatch starts a batch of operations on the image
+     *
+     * Usually every operation, like crop(), scaleImage() or Node::cropNode(),
+     * waits until the image has completed it. Inside a batch the operations
+     * are only queued, the image executes them in the background, one after
+     * another, and the script continues right away. The script waits once,
+     * in endBatch():
+     *
+     * @code
+     * doc.beginBatch()
+     * for node in doc.topLevelNodes():
+     *     node.scaleNode(QPointF(0, 0), 256, 256, "Bicubic")
+     * doc.endBatch()
+     * @endcode
+     *
+     * The functions that read the image, like pixelData(), bounds() or
+     * Node::thumbnail(), wait for the queued operations to see their
+     * results, so the batches are the most efficient when the reads are
+     * done after endBatch(). Node::mergeDown() waits too, because it
+     * returns the merged layer.
+     *
+     * The batches can be nested, the operations are waited for when
+     * the outermost batch ends.
+     */
+    void beginBatch();
+
+    /**
+     * @brief endBatch ends the batch started by beginBatch() and waits
+     * until the image has completed all the queued operations
+     */
+    void endBatch();
+
     /**
      * @brief Tries to lock the image without waiting for the jobs to finish
      *
@@ -13,6 +13,8 @@
 #include <KisGlobalResourcesInterface.h>
 #include <kis_assert.h>
 
+#include "LibKisUtils.h"
+
 FillLayer::FillLayer(KisImageSP image, QString name, KisFilterConfigurationSP filterConfig, Selection &selection, QObject *parent) :
     Node(image, new KisGeneratorLayer(image, name, filterConfig->cloneWithResourcesSnapshot(), selection.selection()), parent)
 {
@@ -65,7 +67,7 @@ bool FillLayer::setGenerator(const QString &generatorName, InfoObject *config)
             layer->forceUpdateTimedNode();
         }
 
-        image()->waitForDone();
+        LibKisUtils::waitForOperations(image());
         return true;
     }
     return false;
@@ -24,6 +24,7 @@
 #include "Document.h"
 #include "InfoObject.h"
 #include "Node.h"
+#include "LibKisUtils.h"
 
 struct Filter::Private {
     Private() {}
@@ -89,6 +90,9 @@ bool Filter::apply(Node *node, int x, int y, int w, int h)
     KisPaintDeviceSP dev = node->paintDevice();
     if (!dev) return false;
 
+    // the filter is applied right away, after the operations queued before
+    LibKisUtils::waitForBatchedOperations(node->image());
+
     QRect applyRect = QRect(x, y, w, h);
     KisFilterConfigurationSP config = static_cast<KisFilterConfiguration*>(d->configuration->configuration().data());
     filter->process(dev, applyRect, config->cloneWithResourcesSnapshot());
@@ -107,6 +111,7 @@ bool Filter::startFilter(Node *node, int x, int y, int w, int h)
 
     KisFilterConfigurationSP filterConfig = static_cast<KisFilterConfiguration*>(d->configuration->configuration().data());
 
+    // the size of the image may be changed by the queued operations
     image->waitForDone();
     QRect initialApplyRect = QRect(x, y, w, h);
 
@@ -148,7 +153,7 @@ bool Filter::startFilter(Node *node, int x, int y, int w, int h)
     }
 
     image->endStroke(currentStrokeId);
-    image->waitForDone();
+    LibKisUtils::waitForOperations(image);
 
     return true;
 }
@@ -8,6 +8,7 @@
 #include <QPointer>
 #include <QVariant>
 #include <QStringList>
+#include <QDebug>
 
 #include <ksharedconfig.h>
 #include <kconfiggroup.h>
@@ -26,6 +27,7 @@
 #include <KisPart.h>
 #include <KisMainWindow.h>
 #include <KisDocument.h>
+#include <KisBatchExporter.h>
 #include <kis_image.h>
 #include <kis_action.h>
 #include <KisViewManager.h>
@@ -327,6 +329,43 @@ Document* Krita::openDocument(const QString &filename)
     return new Document(document, true);
 }
 
+bool Krita::batchExport(const QStringList &inputFiles, const QStringList &outputFiles, int maxConcurrentJobs)
+{
+    if (inputFiles.size() != outputFiles.size()) {
+        qWarning() << "Krita::batchExport: the number of the input and output files differs";
+        return false;
+    }
+
+    KisBatchExporter exporter;
+    if (maxConcurrentJobs > 0) {
+        exporter.setMaxConcurrentJobs(maxConcurrentJobs);
+    }
+
+    for (int i = 0; i < inputFiles.size(); i++) {
+        KisBatchExporter::Job job;
+        job.inputFileName = inputFiles[i];
+        job.outputFileName = outputFiles[i];
+        exporter.addJob(job);
+    }
+
+    return exporter.exec();
+}
+
+bool Krita::batchExportJobList(const QString &jobListFile)
+{
+    QVector<KisBatchExporter::Job> jobs;
+    QString errorMessage;
+
+    if (!KisBatchExporter::loadJobList(jobListFile, &jobs, &errorMessage)) {
+        qWarning() << "Krita::batchExportJobList:" << errorMessage;
+        return false;
+    }
+
+    KisBatchExporter exporter;
+    exporter.addJobs(jobs);
+    return exporter.exec();
+}
+
 Window* Krita::openWindow()
 {
     KisMainWindow *mw = KisPart::instance()->createMainWindow();
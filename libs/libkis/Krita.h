@@ -260,6 +260,31 @@ add_document_to_window()
      */
     Document *openDocument(const QString &filename);
 
+    /**
+     * @brief batchExport converts every file of @p inputFiles into the file with the same
+     * index in @p outputFiles, without showing any dialogs. The format of the output files
+     * is determined by their extensions, the last used export settings are used for them.
+     *
+     * Several files are converted at the same time, while the number of the documents
+     * kept in memory is limited. The documents are not registered with the Krita application.
+     *
+     * @param inputFiles the files to load
+     * @param outputFiles the files to export to
+     * @param maxConcurrentJobs the maximum number of the documents loaded at the same time,
+     * if 0, it depends on the number of the cores
+     * @return true if all the files were converted successfully
+     */
+    bool batchExport(const QStringList &inputFiles, const QStringList &outputFiles, int maxConcurrentJobs = 0);
+
+    /**
+     * @brief batchExportJobList converts all the files listed in @p jobListFile, like the
+     * --export-batch command line option. Every line of the job list contains the input
+     * filename, the output filename and, optionally, the output mimetype, separated by tabs.
+     * @param jobListFile the job list
+     * @return true if all the files were converted successfully
+     */
+    bool batchExportJobList(const QString &jobListFile);
+
     /**
      * @brief openWindow create a new main window. The window is not shown by default.
      */
@@ -20,6 +20,8 @@
 #include <kis_selection_mask.h>
 #include <lazybrush/kis_colorize_mask.h>
 #include <kis_layer.h>
+#include <kis_image.h>
+#include <kis_assert.h>
 
 #include "Node.h"
 #include "GroupLayer.h"
@@ -39,3 +41,45 @@ QList<Node *> LibKisUtils::createNodeList(KisNodeList kisnodes, KisImageWSP imag
     }
     return nodes;
 }
+
+namespace {
+// the property lives and dies with the image, the scripts may drop it in the middle of a batch
+const char *batchDepthProperty = "libkisBatchDepth";
+}
+
+void LibKisUtils::beginBatch(KisImageSP image)
+{
+    if (!image) return;
+    image->setProperty(batchDepthProperty, image->property(batchDepthProperty).toInt() + 1);
+}
+
+void LibKisUtils::endBatch(KisImageSP image)
+{
+    if (!image) return;
+
+    const int depth = image->property(batchDepthProperty).toInt();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(depth > 0);
+
+    image->setProperty(batchDepthProperty, depth - 1);
+
+    if (depth == 1) {
+        image->waitForDone();
+    }
+}
+
+bool LibKisUtils::isBatchActive(KisImageSP image)
+{
+    return image && image->property(batchDepthProperty).toInt() > 0;
+}
+
+void LibKisUtils::waitForOperations(KisImageSP image)
+{
+    if (!image || isBatchActive(image)) return;
+    image->waitForDone();
+}
+
+void LibKisUtils::waitForBatchedOperations(KisImageSP image)
+{
+    if (!isBatchActive(image)) return;
+    image->waitForDone();
+}
@@ -16,6 +16,29 @@ namespace LibKisUtils
 
 QList<Node *> createNodeList(KisNodeList kisnodes, KisImageWSP image);
 
+/**
+ * The batches of operations started with Document::beginBatch(). Inside
+ * a batch the operations are only queued on the image, so the scheduler
+ * can execute them back to back, and the script waits once, in
+ * Document::endBatch(). The batches can be nested.
+ */
+void beginBatch(KisImageSP image);
+void endBatch(KisImageSP image);
+bool isBatchActive(KisImageSP image);
+
+/**
+ * Waits until the image completes the operations queued by the
+ * script, unless a batch is active on the image
+ */
+void waitForOperations(KisImageSP image);
+
+/**
+ * Waits until the image completes the queued operations if a batch
+ * is active. The functions reading the image call it to see the results
+ * of the operations the script has queued before.
+ */
+void waitForBatchedOperations(KisImageSP image);
+
 }
 
 #endif // LIBKISUTILS_H
@@ -36,6 +36,9 @@
 #include <commands/kis_node_compositeop_command.h>
 #include <commands/kis_image_layer_add_command.h>
 #include <kis_processing_applicator.h>
+#include <kis_command_utils.h>
+#include <kundo2magicstring.h>
+#include <kis_transaction.h>
 
 #include <kis_raster_keyframe_channel.h>
 #include <kis_keyframe.h>
@@ -47,6 +50,7 @@
 #include "Channel.h"
 #include "Filter.h"
 #include "Selection.h"
+#include "PixelAccessor.h"
 
 #include "GroupLayer.h"
 #include "CloneLayer.h"
@@ -167,7 +171,7 @@ void Node::setBlendingMode(QString value)
                                                        value);
 
     KisProcessingApplicator::runSingleCommandStroke(d->image, cmd);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
 }
 
 
@@ -213,7 +217,7 @@ bool Node::addChildNode(Node *child, Node *above)
     }
 
     KisProcessingApplicator::runSingleCommandStroke(d->image, cmd);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
 
     return true;
 }
@@ -278,7 +282,7 @@ bool Node::setColorProfile(const QString &colorProfile)
     KisLayer *layer = qobject_cast<KisLayer*>(d->node.data());
     const KoColorProfile *profile = KoColorSpaceRegistry::instance()->profileByName(colorProfile);
     bool result = d->image->assignLayerProfile(layer, profile);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
     return result;
 }
 
@@ -291,7 +295,7 @@ bool Node::setColorSpace(const QString &colorModel, const QString &colorDepth, c
                                                                              colorDepth,
                                                                              profile);
     d->image->convertLayerColorSpace(d->node, dstCs, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
     return true;
 }
 
@@ -489,6 +493,8 @@ QByteArray Node::pixelData(int x, int y, int w, int h) const
     KisPaintDeviceSP dev = d->node->paintDevice();
     if (!dev) return ba;
 
+    LibKisUtils::waitForBatchedOperations(d->image);
+
     ba.resize(w * h * dev->pixelSize());
     dev->readBytes(reinterpret_cast<quint8*>(ba.data()), x, y, w, h);
     return ba;
@@ -500,6 +506,8 @@ QByteArray Node::pixelDataAtTime(int x, int y, int w, int h, int time) const
 
     if (!d->node || !d->node->isAnimated()) return ba;
 
+    LibKisUtils::waitForBatchedOperations(d->image);
+
     //
     KisRasterKeyframeChannel *rkc = dynamic_cast<KisRasterKeyframeChannel*>(d->node->getKeyframeChannel(KisKeyframeChannel::Raster.id()));
     if (!rkc) return ba;
@@ -525,6 +533,8 @@ QByteArray Node::projectionPixelData(int x, int y, int w, int h) const
     KisPaintDeviceSP dev = d->node->projection();
     if (!dev) return ba;
 
+    LibKisUtils::waitForBatchedOperations(d->image);
+
     ba.resize(w * h * dev->pixelSize());
     dev->readBytes(reinterpret_cast<quint8*>(ba.data()), x, y, w, h);
     return ba;
@@ -535,12 +545,33 @@ void Node::setPixelData(QByteArray value, int x, int y, int w, int h)
     if (!d->node) return;
     KisPaintDeviceSP dev = d->node->paintDevice();
     if (!dev) return;
+
+    if (LibKisUtils::isBatchActive(d->image)) {
+        // the device may still be changed by the queued operations, so the write is queued too
+        const QRect rc(x, y, w, h);
+
+        KisProcessingApplicator::runSingleCommandStroke(d->image,
+            new KisCommandUtils::LambdaCommand(kundo2_i18n("Set Pixel Data"),
+                [dev, value, rc] () {
+                    KisTransaction transaction(dev);
+                    dev->writeBytes((const quint8*)value.constData(), rc);
+                    return transaction.endAndTake();
+                }));
+        return;
+    }
+
     dev->writeBytes((const quint8*)value.constData(), x, y, w, h);
 }
 
+PixelAccessor *Node::pixelAccessor() const
+{
+    return new PixelAccessor(d->image, d->node);
+}
+
 QRect Node::bounds() const
 {
     if (!d->node) return QRect();
+    LibKisUtils::waitForBatchedOperations(d->image);
     return d->node->exactBounds();
 }
 
@@ -609,6 +640,8 @@ Node* Node::mergeDown()
     if (!d->node->prevSibling()) return 0;
 
     d->image->mergeDown(qobject_cast<KisLayer*>(d->node.data()), KisMetaData::MergeStrategyRegistry::instance()->get("Drop"));
+
+    // the merged layer is returned, so the merge cannot be postponed even in a batch
     d->image->waitForDone();
 
     return Node::createNode(d->image, d->node->prevSibling());
@@ -630,7 +663,7 @@ void Node::scaleNode(QPointF origin, int width, int height, QString strategy)
                         qreal(width) / bounds.width(),
                         qreal(height) / bounds.height(),
                         actualStrategy, 0);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
 }
 
 void Node::rotateNode(double radians)
@@ -640,7 +673,7 @@ void Node::rotateNode(double radians)
     if (!d->node->parent()) return;
 
     d->image->rotateNode(d->node, radians, 0);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
 }
 
 void Node::cropNode(int x, int y, int w, int h)
@@ -651,7 +684,7 @@ void Node::cropNode(int x, int y, int w, int h)
 
     QRect rect = QRect(x, y, w, h);
     d->image->cropNode(d->node, rect);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
 }
 
 void Node::shearNode(double angleX, double angleY)
@@ -661,12 +694,13 @@ void Node::shearNode(double angleX, double angleY)
     if (!d->node->parent()) return;
 
     d->image->shearNode(d->node, angleX, angleY, 0);
-    d->image->waitForDone();
+    LibKisUtils::waitForOperations(d->image);
 }
 
 QImage Node::thumbnail(int w, int h)
 {
     if (!d->node) return QImage();
+    LibKisUtils::waitForBatchedOperations(d->image);
     return d->node->createThumbnail(w, h);
 }
 
@@ -432,6 +432,14 @@ public Q_SLOTS:
      */
     void setPixelData(QByteArray value, int x, int y, int w, int h);
 
+    /**
+     * @brief pixelAccessor creates an object for the bulk access to
+     * the pixels of the node, tile by tile. The writes made through
+     * it are batched into a single undo step and a single update.
+     * @return a new PixelAccessor, owned by the caller
+     */
+    PixelAccessor *pixelAccessor() const;
+
     /**
      * @brief bounds return the exact bounds of the node's paint device
      * @return the bounds, or an empty QRect if the node has no paint device or is empty.
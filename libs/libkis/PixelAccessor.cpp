@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+#include "PixelAccessor.h"
+
+#include <QByteArray>
+
+#include <klocalizedstring.h>
+#include <kundo2magicstring.h>
+
+#include <kis_image.h>
+#include <kis_node.h>
+#include <kis_paint_device.h>
+#include <kis_transaction.h>
+#include <krita_utils.h>
+#include <tiles3/kis_tile_data.h>
+
+#include "LibKisUtils.h"
+
+struct PixelAccessor::Private {
+    Private() {}
+
+    KisImageWSP image;
+    KisNodeSP node;
+
+    QVector<QRect> tiles;
+    int currentTile {-1};
+
+    QScopedPointer<KisTransaction> transaction;
+    QRect changedRect;
+
+    KisPaintDeviceSP device() const {
+        return node ? node->paintDevice() : KisPaintDeviceSP();
+    }
+
+    void write(const QByteArray &value, const QRect &rect);
+};
+
+void PixelAccessor::Private::write(const QByteArray &value, const QRect &rect)
+{
+    KisPaintDeviceSP dev = device();
+    if (!dev || rect.isEmpty()) return;
+
+    LibKisUtils::waitForBatchedOperations(image);
+
+    // Krita would read past the end of the array otherwise
+    if (value.size() < rect.width() * rect.height() * int(dev->pixelSize())) return;
+
+    if (!transaction) {
+        transaction.reset(new KisTransaction(kundo2_i18n("Set Pixel Data"), dev));
+    }
+
+    dev->writeBytes(reinterpret_cast<const quint8*>(value.constData()), rect);
+    changedRect |= rect;
+}
+
+PixelAccessor::PixelAccessor(KisImageSP image, KisNodeSP node, QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    d->image = image;
+    d->node = node;
+}
+
+PixelAccessor::~PixelAccessor()
+{
+    commit();
+}
+
+QSize PixelAccessor::tileSize() const
+{
+    return QSize(KisTileData::WIDTH, KisTileData::HEIGHT);
+}
+
+int PixelAccessor::pixelSize() const
+{
+    KisPaintDeviceSP dev = d->device();
+    return dev ? dev->pixelSize() : 0;
+}
+
+QList<QRect> PixelAccessor::tileRects(const QRect &rect) const
+{
+    KisPaintDeviceSP dev = d->device();
+    if (!dev) return QList<QRect>();
+
+    // the tiles are aligned to the offset of the device
+    const QPoint offset = dev->offset();
+
+    QList<QRect> rects;
+    Q_FOREACH (const QRect &rc, KritaUtils::splitRectIntoPatches(rect.translated(-offset), tileSize())) {
+        rects << rc.translated(offset);
+    }
+    return rects;
+}
+
+void PixelAccessor::beginIteration(const QRect &rect)
+{
+    d->tiles = tileRects(rect).toVector();
+    d->currentTile = -1;
+}
+
+bool PixelAccessor::nextTile()
+{
+    if (d->currentTile >= d->tiles.size()) return false;
+
+    d->currentTile++;
+    return d->currentTile < d->tiles.size();
+}
+
+QRect PixelAccessor::tileRect() const
+{
+    if (d->currentTile < 0 || d->currentTile >= d->tiles.size()) return QRect();
+    return d->tiles[d->currentTile];
+}
+
+QByteArray PixelAccessor::tileData() const
+{
+    const QRect rect = tileRect();
+    if (rect.isEmpty()) return QByteArray();
+
+    return pixelData(rect);
+}
+
+void PixelAccessor::setTileData(QByteArray value)
+{
+    d->write(value, tileRect());
+}
+
+QByteArray PixelAccessor::pixelData(const QRect &rect) const
+{
+    QByteArray ba;
+
+    KisPaintDeviceSP dev = d->device();
+    if (!dev || rect.isEmpty()) return ba;
+
+    LibKisUtils::waitForBatchedOperations(d->image);
+
+    ba.resize(rect.width() * rect.height() * dev->pixelSize());
+    dev->readBytes(reinterpret_cast<quint8*>(ba.data()), rect);
+    return ba;
+}
+
+void PixelAccessor::setPixelData(QByteArray value, const QRect &rect)
+{
+    d->write(value, rect);
+}
+
+void PixelAccessor::commit()
+{
+    if (!d->transaction) return;
+
+    KisImageSP image = d->image.toStrongRef();
+    if (image) {
+        d->transaction->commit(image->postExecutionUndoAdapter());
+    } else {
+        d->transaction->end();
+    }
+    d->transaction.reset();
+
+    d->node->setDirty(d->changedRect);
+    d->changedRect = QRect();
+}
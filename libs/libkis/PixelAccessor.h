@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+#ifndef LIBKIS_PIXELACCESSOR_H
+#define LIBKIS_PIXELACCESSOR_H
+
+#include <QObject>
+#include <QRect>
+#include <QScopedPointer>
+#include <QSize>
+
+#include "kritalibkis_export.h"
+#include "libkis.h"
+
+#include <kis_types.h>
+
+/**
+ * PixelAccessor gives a script bulk access to the pixels of a Node,
+ * organized the way Krita stores them: in tiles.
+ *
+ * Reading and writing the regions aligned to the tiles of the node
+ * is much faster than reading arbitrary rectangles, every row of the
+ * region is a single copy from the tile memory. The tiles are iterated
+ * with beginIteration() and nextTile():
+ *
+ * @code
+ * accessor = node.pixelAccessor()
+ * accessor.beginIteration(node.bounds())
+ * while accessor.nextTile():
+ *     rect = accessor.tileRect()
+ *     data = accessor.tileData()
+ *     pixels = numpy.frombuffer(data, dtype=numpy.uint8).reshape(rect.height(), rect.width(), -1)
+ *     pixels[:, :, 3] //= 2
+ *     accessor.setTileData(data)
+ * accessor.commit()
+ * @endcode
+ *
+ * The returned QByteArray supports the buffer protocol, so numpy wraps
+ * it without copying. When the same byte array is modified in place and
+ * passed back, it is not copied either: the only copies are the ones
+ * from and into the tiles.
+ *
+ * The writes are not visible on the canvas until commit() is called.
+ * All the writes made before the commit form a single undo step and the
+ * node is updated once, for the whole changed area. The writes that are
+ * not committed when the accessor is destroyed are committed then.
+ *
+ * The layout of the pixel data is the same as in Node::pixelData().
+ */
+class KRITALIBKIS_EXPORT PixelAccessor : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(PixelAccessor)
+
+public:
+    explicit PixelAccessor(KisImageSP image, KisNodeSP node, QObject *parent = 0);
+    ~PixelAccessor() override;
+
+public Q_SLOTS:
+
+    /**
+     * @return the size of the tiles Krita stores the pixels in
+     */
+    QSize tileSize() const;
+
+    /**
+     * @return the number of bytes per pixel, or 0 if the node has no pixel data
+     */
+    int pixelSize() const;
+
+    /**
+     * @brief tileRects splits the rectangle into the regions aligned to
+     * the tiles of the node, ordered row-first
+     * @param rect the rectangle to split
+     * @return the parts of the rectangle, at most one per tile
+     */
+    QList<QRect> tileRects(const QRect &rect) const;
+
+    /**
+     * @brief beginIteration starts iterating over the tiles that
+     * intersect with the given rectangle. The first tile is available
+     * after the first call to nextTile().
+     * @param rect the rectangle to iterate over
+     */
+    void beginIteration(const QRect &rect);
+
+    /**
+     * @brief nextTile moves the iteration to the next tile
+     * @return false if there are no more tiles
+     */
+    bool nextTile();
+
+    /**
+     * @return the part of the iteration rectangle covered by the current tile
+     */
+    QRect tileRect() const;
+
+    /**
+     * @return the pixel data of the current tile's rectangle, or an
+     * empty byte array if the iteration is not running
+     */
+    QByteArray tileData() const;
+
+    /**
+     * @brief setTileData writes the pixel data of the current tile's
+     * rectangle. There must be enough bytes for the whole rectangle.
+     */
+    void setTileData(QByteArray value);
+
+    /**
+     * @brief pixelData reads an arbitrary rectangle of the node,
+     * like Node::pixelData()
+     */
+    QByteArray pixelData(const QRect &rect) const;
+
+    /**
+     * @brief setPixelData writes an arbitrary rectangle of the node.
+     * Unlike Node::setPixelData() the change is a part of the batch,
+     * it becomes visible on commit().
+     * @param value the pixel data, there must be enough bytes for the whole rectangle
+     * @param rect the rectangle to write to
+     */
+    void setPixelData(QByteArray value, const QRect &rect);
+
+    /**
+     * @brief commit adds all the writes made since the last commit to
+     * the undo history as a single step and updates the node
+     */
+    void commit();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> d;
+};
+
+#endif // LIBKIS_PIXELACCESSOR_H
@@ -23,6 +23,7 @@ class InfoObject;
 class Krita;
 class Node;
 class Notifier;
+class PixelAccessor;
 class Resource;
 class Scratchpad;
 class Selection;
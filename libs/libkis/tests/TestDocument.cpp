@@ -9,6 +9,7 @@
 #include <QColor>
 #include <QDataStream>
 #include <QDir>
+#include <QtMath>
 
 #include <Node.h>
 #include <Krita.h>
@@ -172,5 +173,60 @@ void TestDocument::testCreateFillLayer()
 
 
 
+void TestDocument::testBatch()
+{
+    QScopedPointer<KisDocument> kisdoc(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
+    KisNodeSP layer = new KisPaintLayer(image, "test1", 255);
+    KisFillPainter gc(layer->paintDevice());
+    gc.fillRect(0, 0, 100, 100, KoColor(Qt::red, layer->colorSpace()));
+    image->addNode(layer);
+    kisdoc->setCurrentImage(image);
+
+    Document d(kisdoc.data(), false);
+    QScopedPointer<Node> node(Node::createNode(image, layer));
+
+    d.beginBatch();
+
+    d.crop(0, 0, 80, 80);
+    node->cropNode(10, 10, 50, 50);
+
+    // the write is queued after the crops
+    QByteArray ba(20 * 20 * 4, char(0xff));
+    node->setPixelData(ba, 20, 20, 20, 20);
+
+    d.endBatch();
+
+    QVERIFY(image->isIdle());
+    QCOMPARE(image->bounds(), QRect(0, 0, 80, 80));
+    QCOMPARE(layer->exactBounds(), QRect(10, 10, 50, 50));
+
+    QColor pixel;
+    layer->paintDevice()->pixel(25, 25, &pixel);
+    QCOMPARE(pixel, QColor(Qt::white));
+    layer->paintDevice()->pixel(15, 15, &pixel);
+    QCOMPARE(pixel, QColor(Qt::red));
+
+    // the nested batches wait at the end of the outermost one
+    d.beginBatch();
+    d.beginBatch();
+    d.rotateImage(M_PI / 2);
+    d.endBatch();
+    d.resizeImage(0, 0, 60, 60);
+    d.endBatch();
+
+    QVERIFY(image->isIdle());
+    QCOMPARE(image->bounds(), QRect(0, 0, 60, 60));
+
+    // the reads see the results of the operations queued before them
+    d.beginBatch();
+    d.scaleImage(30, 30, 72, 72, "Bicubic");
+    QCOMPARE(d.width(), 30);
+    QCOMPARE(d.height(), 30);
+    d.endBatch();
+
+    KisPart::instance()->removeDocument(kisdoc.data(), false);
+}
+
 KISTEST_MAIN(TestDocument)
 
@@ -9,6 +9,7 @@
 
 #include <KritaVersionWrapper.h>
 #include <Node.h>
+#include <PixelAccessor.h>
 #include <Krita.h>
 
 #include <KoColorSpaceRegistry.h>
@@ -84,6 +85,58 @@ void TestNode::testPixelData()
     }
 }
 
+void TestNode::testPixelAccessor()
+{
+    KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
+    KisNodeSP layer = new KisPaintLayer(image, "test1", 255);
+    image->addNode(layer);
+
+    KisFillPainter gc(layer->paintDevice());
+    gc.fillRect(0, 0, 100, 100, KoColor(Qt::red, layer->colorSpace()));
+
+    NodeSP node = NodeSP(Node::createNode(image, layer));
+    QScopedPointer<PixelAccessor> accessor(node->pixelAccessor());
+
+    QCOMPARE(accessor->pixelSize(), 4);
+    QCOMPARE(accessor->tileRects(QRect(0, 0, 100, 100)),
+             QList<QRect>({QRect(0, 0, 64, 64), QRect(64, 0, 36, 64),
+                           QRect(0, 64, 64, 36), QRect(64, 64, 36, 36)}));
+
+    // the tiles follow the offset of the layer
+    layer->paintDevice()->setX(10);
+    QCOMPARE(accessor->tileRects(QRect(0, 0, 20, 20)),
+             QList<QRect>({QRect(0, 0, 10, 20), QRect(10, 0, 10, 20)}));
+    layer->paintDevice()->setX(0);
+
+    int numTiles = 0;
+    accessor->beginIteration(QRect(0, 0, 100, 100));
+    while (accessor->nextTile()) {
+        const QRect rect = accessor->tileRect();
+        QByteArray data = accessor->tileData();
+        QCOMPARE(data.size(), rect.width() * rect.height() * 4);
+
+        for (int i = 0; i < data.size(); i += 4) {
+            QCOMPARE(quint8(data[i + 2]), quint8(255));
+            data[i + 2] = char(0);
+        }
+
+        accessor->setTileData(data);
+        numTiles++;
+    }
+    QCOMPARE(numTiles, 4);
+    QVERIFY(!accessor->nextTile());
+
+    accessor->commit();
+
+    for (int i = 0; i < 100 ; i++) {
+        for (int j = 0; j < 100 ; j++) {
+            QColor pixel;
+            layer->paintDevice()->pixel(i, j, &pixel);
+            QCOMPARE(pixel, QColor(Qt::black));
+        }
+    }
+}
+
 void TestNode::testProjectionPixelData()
 {
     KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
@@ -16,6 +16,7 @@ private Q_SLOTS:
     void testSetColorProfile();
     void testPixelData();
     void testProjectionPixelData();
+    void testPixelAccessor();
     void testThumbnail();
     void testMergeDown();
 };
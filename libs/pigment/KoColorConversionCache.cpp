@@ -11,6 +11,8 @@
 #include <QMutex>
 #include <QThreadStorage>
 
+#include <atomic>
+
 #include <KoColorSpace.h>
 
 struct KoColorConversionCacheKey {
@@ -68,6 +70,9 @@ struct KoColorConversionCache::Private {
     QMutex cacheMutex;
 
     QThreadStorage<FastPathCacheItem*> fastStorage;
+
+    std::atomic<quint64> hits {0};
+    std::atomic<quint64> misses {0};
 };
 
 
@@ -95,6 +100,7 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 
     if (cacheItem) {
         if (cacheItem->first == key) {
+            d->hits.fetch_add(1, std::memory_order_relaxed);
             return cacheItem->second;
         }
     }
@@ -110,6 +116,7 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
                 ct->transfo->setDstColorSpace(dst);
 
                 cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+                d->hits.fetch_add(1, std::memory_order_relaxed);
                 break;
             }
         }
@@ -119,6 +126,7 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
         CachedTransformation* ct = new CachedTransformation(transfo);
         d->cache.insert(key, ct);
         cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+        d->misses.fetch_add(1, std::memory_order_relaxed);
     }
 
     d->fastStorage.setLocalData(cacheItem);
@@ -142,6 +150,14 @@ void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
     }
 }
 
+KoColorConversionCache::Statistics KoColorConversionCache::statistics() const
+{
+    Statistics stats;
+    stats.hits = d->hits.load(std::memory_order_relaxed);
+    stats.misses = d->misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
 //--------- KoCachedColorConversionTransformation ----------//
 
 struct KoCachedColorConversionTransformation::Private {
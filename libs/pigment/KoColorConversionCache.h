@@ -12,15 +12,27 @@ class KoColorSpace;
 
 #include "KoColorConversionTransformation.h"
 
+#include "kritapigment_export.h"
+
 /**
  * This class holds a cache of KoColorConversionTransformations.
  *
  * This class is not part of public API, and can be changed without notice.
  */
-class KoColorConversionCache
+class KRITAPIGMENT_EXPORT KoColorConversionCache
 {
 public:
     struct CachedTransformation;
+
+    /**
+     * The counters of the cache lookups done by cachedConverter()
+     */
+    struct Statistics {
+        /// the number of lookups that reused an existing transformation
+        quint64 hits = 0;
+        /// the number of lookups that had to create a new transformation
+        quint64 misses = 0;
+    };
 public:
     KoColorConversionCache();
     ~KoColorConversionCache();
@@ -45,6 +57,11 @@ public:
      * @param src source color space
      */
     void colorSpaceIsDestroyed(const KoColorSpace* src);
+
+    /**
+     * @return the lookup counters of the cache since its creation
+     */
+    Statistics statistics() const;
 private:
     struct Private;
     Private* const d;
@@ -66,6 +66,24 @@ void KoColorConversionTransformation::transformInPlace(const quint8 *src, quint8
     }
 }
 
+void KoColorConversionTransformation::transformLines(const quint8 *src, qint32 srcRowStride,
+                                                     quint8 *dst, qint32 dstRowStride,
+                                                     qint32 nPixels, qint32 nRows) const
+{
+    const qint32 srcLineSize = srcColorSpace()->pixelSize() * nPixels;
+    const qint32 dstLineSize = dstColorSpace()->pixelSize() * nPixels;
+
+    if (srcRowStride == srcLineSize && dstRowStride == dstLineSize) {
+        transform(src, dst, nPixels * nRows);
+    } else {
+        for (qint32 row = 0; row < nRows; row++) {
+            transform(src, dst, nPixels);
+            src += srcRowStride;
+            dst += dstRowStride;
+        }
+    }
+}
+
 void KoColorConversionTransformation::setSrcColorSpace(const KoColorSpace* cs) const
 {
     Q_ASSERT(*d->srcColorSpace == *cs);
@@ -117,6 +117,23 @@ public:
      */
     void transformInPlace(const quint8 *src, quint8 *dst, qint32 nPixels) const;
 
+    /**
+     * perform the color conversion of a rectangular block of pixels, e.g. a
+     * part of a tile, in one call. The rows of the block may be placed with
+     * arbitrary strides in \p src and \p dst. The default implementation
+     * calls transform() for every row, or just once if the rows are
+     * contiguous in both buffers. Make sure that \p src is not the same as
+     * \p dst!
+     *
+     * @param srcRowStride the distance between the rows of \p src in bytes
+     * @param dstRowStride the distance between the rows of \p dst in bytes
+     * @param nPixels the number of pixels in every row
+     * @param nRows the number of rows
+     */
+    virtual void transformLines(const quint8 *src, qint32 srcRowStride,
+                                quint8 *dst, qint32 dstRowStride,
+                                qint32 nPixels, qint32 nRows) const;
+
     /**
      * @return false if the  transformation is not valid
      */
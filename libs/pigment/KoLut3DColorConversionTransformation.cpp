@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoLut3DColorConversionTransformation.h"
+
+#include <QVector>
+
+#include "KoColorSpace.h"
+#include "KoColorSpaceMaths.h"
+#include "KoColorModelStandardIds.h"
+
+namespace {
+
+const int lutChannels = 3;
+
+template <typename channel_type>
+void fillGrid(quint8 *pixels, int gridSize)
+{
+    const float unitValue = KoColorSpaceMathsTraits<channel_type>::unitValue;
+    const float nodeScale = unitValue / (gridSize - 1);
+
+    channel_type *p = reinterpret_cast<channel_type*>(pixels);
+
+    for (int z = 0; z < gridSize; z++) {
+        for (int y = 0; y < gridSize; y++) {
+            for (int x = 0; x < gridSize; x++) {
+                p[0] = channel_type(x * nodeScale + 0.5f);
+                p[1] = channel_type(y * nodeScale + 0.5f);
+                p[2] = channel_type(z * nodeScale + 0.5f);
+                p[3] = KoColorSpaceMathsTraits<channel_type>::unitValue;
+                p += 4;
+            }
+        }
+    }
+}
+
+template <typename channel_type>
+void readGrid(const quint8 *pixels, int numNodes, float *lut)
+{
+    const channel_type *p = reinterpret_cast<const channel_type*>(pixels);
+
+    for (int i = 0; i < numNodes; i++) {
+        lut[0] = p[0];
+        lut[1] = p[1];
+        lut[2] = p[2];
+        lut += lutChannels;
+        p += 4;
+    }
+}
+
+template <typename src_channel_type, typename dst_channel_type>
+void transformPixels(const float *lut, int gridSize, const quint8 *srcU8, quint8 *dstU8, qint32 nPixels)
+{
+    const src_channel_type *src = reinterpret_cast<const src_channel_type*>(srcU8);
+    dst_channel_type *dst = reinterpret_cast<dst_channel_type*>(dstU8);
+
+    const float srcScale = float(gridSize - 1) / KoColorSpaceMathsTraits<src_channel_type>::unitValue;
+    const float dstMax = KoColorSpaceMathsTraits<dst_channel_type>::unitValue;
+    const int maxBase = gridSize - 2;
+
+    // the distances between the neighbouring nodes of the table
+    const int strideX = lutChannels;
+    const int strideY = lutChannels * gridSize;
+    const int strideZ = lutChannels * gridSize * gridSize;
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        const float x = src[0] * srcScale;
+        const float y = src[1] * srcScale;
+        const float z = src[2] * srcScale;
+
+        const int ix = qMin(int(x), maxBase);
+        const int iy = qMin(int(y), maxBase);
+        const int iz = qMin(int(z), maxBase);
+
+        const float fx = x - ix;
+        const float fy = y - iy;
+        const float fz = z - iz;
+
+        const float *c000 = lut + ix * strideX + iy * strideY + iz * strideZ;
+        const float *c111 = c000 + strideX + strideY + strideZ;
+
+        /**
+         * Tetrahedral interpolation: the cube is split into six
+         * tetrahedra along its main diagonal, and the pixel is
+         * interpolated between the four vertices of the tetrahedron
+         * it falls into. The path from c000 to c111 goes through the
+         * axes in the order of decreasing fractions.
+         */
+        const float *c1;
+        const float *c2;
+        float w1, w2, w3;
+
+        if (fx >= fy) {
+            if (fy >= fz) {
+                c1 = c000 + strideX;
+                c2 = c1 + strideY;
+                w1 = fx; w2 = fy; w3 = fz;
+            } else if (fx >= fz) {
+                c1 = c000 + strideX;
+                c2 = c1 + strideZ;
+                w1 = fx; w2 = fz; w3 = fy;
+            } else {
+                c1 = c000 + strideZ;
+                c2 = c1 + strideX;
+                w1 = fz; w2 = fx; w3 = fy;
+            }
+        } else {
+            if (fz >= fy) {
+                c1 = c000 + strideZ;
+                c2 = c1 + strideY;
+                w1 = fz; w2 = fy; w3 = fx;
+            } else if (fz >= fx) {
+                c1 = c000 + strideY;
+                c2 = c1 + strideZ;
+                w1 = fy; w2 = fz; w3 = fx;
+            } else {
+                c1 = c000 + strideY;
+                c2 = c1 + strideX;
+                w1 = fy; w2 = fx; w3 = fz;
+            }
+        }
+
+        for (int ch = 0; ch < lutChannels; ch++) {
+            const float value =
+                c000[ch] +
+                w1 * (c1[ch] - c000[ch]) +
+                w2 * (c2[ch] - c1[ch]) +
+                w3 * (c111[ch] - c2[ch]);
+
+            dst[ch] = dst_channel_type(qBound(0.0f, value + 0.5f, dstMax));
+        }
+
+        dst[3] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(src[3]);
+
+        src += 4;
+        dst += 4;
+    }
+}
+
+enum SupportedDepth {
+    UnsupportedDepth,
+    Depth8,
+    Depth16
+};
+
+SupportedDepth supportedDepth(const KoColorSpace *cs)
+{
+    if (cs->colorModelId() != RGBAColorModelID) {
+        return UnsupportedDepth;
+    }
+
+    if (cs->colorDepthId() == Integer8BitsColorDepthID) {
+        return Depth8;
+    } else if (cs->colorDepthId() == Integer16BitsColorDepthID) {
+        return Depth16;
+    }
+
+    return UnsupportedDepth;
+}
+
+}
+
+struct Q_DECL_HIDDEN KoLut3DColorConversionTransformation::Private {
+    typedef void (*TransformFunc)(const float *, int, const quint8 *, quint8 *, qint32);
+
+    int gridSize;
+    QVector<float> lut;
+    TransformFunc transformFunc;
+};
+
+KoLut3DColorConversionTransformation::KoLut3DColorConversionTransformation(const KoColorConversionTransformation *transformation,
+                                                                           int gridSize)
+    : KoColorConversionTransformation(transformation->srcColorSpace(),
+                                      transformation->dstColorSpace(),
+                                      transformation->renderingIntent(),
+                                      transformation->conversionFlags())
+    , d(new Private)
+{
+    const KoColorSpace *srcCs = transformation->srcColorSpace();
+    const KoColorSpace *dstCs = transformation->dstColorSpace();
+
+    const SupportedDepth srcDepth = supportedDepth(srcCs);
+    const SupportedDepth dstDepth = supportedDepth(dstCs);
+
+    const int numNodes = gridSize * gridSize * gridSize;
+
+    QVector<quint8> srcPixels(numNodes * srcCs->pixelSize());
+    QVector<quint8> dstPixels(numNodes * dstCs->pixelSize());
+
+    if (srcDepth == Depth8) {
+        fillGrid<quint8>(srcPixels.data(), gridSize);
+    } else {
+        fillGrid<quint16>(srcPixels.data(), gridSize);
+    }
+
+    transformation->transform(srcPixels.constData(), dstPixels.data(), numNodes);
+
+    d->gridSize = gridSize;
+    d->lut.resize(numNodes * lutChannels);
+
+    if (dstDepth == Depth8) {
+        readGrid<quint8>(dstPixels.constData(), numNodes, d->lut.data());
+    } else {
+        readGrid<quint16>(dstPixels.constData(), numNodes, d->lut.data());
+    }
+
+    if (srcDepth == Depth8) {
+        d->transformFunc = dstDepth == Depth8 ?
+            &transformPixels<quint8, quint8> :
+            &transformPixels<quint8, quint16>;
+    } else {
+        d->transformFunc = dstDepth == Depth8 ?
+            &transformPixels<quint16, quint8> :
+            &transformPixels<quint16, quint16>;
+    }
+}
+
+KoLut3DColorConversionTransformation::~KoLut3DColorConversionTransformation()
+{
+    delete d;
+}
+
+bool KoLut3DColorConversionTransformation::isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    return supportedDepth(srcCs) != UnsupportedDepth &&
+        supportedDepth(dstCs) != UnsupportedDepth;
+}
+
+KoLut3DColorConversionTransformation* KoLut3DColorConversionTransformation::create(const KoColorConversionTransformation *transformation,
+                                                                                 int gridSize)
+{
+    if (!transformation || gridSize < 2 ||
+        !isSupported(transformation->srcColorSpace(), transformation->dstColorSpace())) {
+
+        return 0;
+    }
+
+    return new KoLut3DColorConversionTransformation(transformation, gridSize);
+}
+
+void KoLut3DColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    d->transformFunc(d->lut.constData(), d->gridSize, src, dst, nPixels);
+}
+
+int KoLut3DColorConversionTransformation::gridSize() const
+{
+    return d->gridSize;
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef _KO_LUT3D_COLOR_CONVERSION_TRANSFORMATION_H_
+#define _KO_LUT3D_COLOR_CONVERSION_TRANSFORMATION_H_
+
+#include "KoColorConversionTransformation.h"
+
+#include "kritapigment_export.h"
+
+/**
+ * A color conversion that samples another conversion into a 3D lookup
+ * table and then converts the pixels with tetrahedral interpolation
+ * between the samples. It is meant for the conversions that are too
+ * expensive to be done per pixel, e.g. the display and soft-proofing
+ * conversions of the canvas.
+ *
+ * Only the conversions between integer RGBA color spaces are supported,
+ * the alpha channel is not sampled, but just scaled into the destination
+ * depth.
+ */
+class KRITAPIGMENT_EXPORT KoLut3DColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    /**
+     * The grid sizes for the fast and the accurate tables
+     */
+    static const int FastGridSize = 33;
+    static const int AccurateGridSize = 65;
+
+    ~KoLut3DColorConversionTransformation() override;
+
+    /**
+     * @return true if the conversion from \p srcCs to \p dstCs can be
+     * sampled into a lookup table
+     */
+    static bool isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs);
+
+    /**
+     * Samples \p transformation into a lookup table with \p gridSize
+     * nodes along every axis. The source transformation is not needed
+     * after the call.
+     *
+     * @return the baked transformation or null if the color spaces of
+     * \p transformation are not supported
+     */
+    static KoLut3DColorConversionTransformation* create(const KoColorConversionTransformation *transformation,
+                                                        int gridSize);
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+    int gridSize() const;
+
+private:
+    KoLut3DColorConversionTransformation(const KoColorConversionTransformation *transformation,
+                                         int gridSize);
+
+    struct Private;
+    Private * const d;
+};
+
+#endif
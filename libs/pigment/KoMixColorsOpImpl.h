@@ -50,7 +50,9 @@ public:
         mixColorsImpl(PointerToArray(colors, _CSTrait::pixelSize), NoWeightsSurrogate(nColors), nColors, dst);
     }
 
-private:
+protected:
+    typedef typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype compositetype;
+
     struct ArrayOfPointers {
         ArrayOfPointers(const quint8 * const* colors)
             : m_colors(colors)
@@ -141,16 +143,28 @@ private:
     template<class AbstractSource, class WeightsWrapper>
     void mixColorsImpl(AbstractSource source, WeightsWrapper weightsWrapper, quint32 nColors, quint8 *dst) const {
         // Create and initialize to 0 the array of totals
-        typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype totals[_CSTrait::channels_nb];
-        typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype totalAlpha = 0;
+        compositetype totals[_CSTrait::channels_nb];
+        compositetype totalAlpha = 0;
 
         memset(totals, 0, sizeof(totals));
 
+        accumulateColors(source, weightsWrapper, nColors, totals, totalAlpha);
+        writeMixedColor(totals, totalAlpha, weightsWrapper.normalizeFactor(), dst);
+    }
+
+    /**
+     * Adds \p nColors pixels of \p source to \p totals and \p totalAlpha.
+     * The source and the weights are advanced past the added pixels.
+     */
+    template<class AbstractSource, class WeightsWrapper>
+    static void accumulateColors(AbstractSource &source, WeightsWrapper &weightsWrapper, quint32 nColors,
+                                 compositetype *totals, compositetype &totalAlpha) {
+
         // Compute the total for each channel by summing each colors multiplied by the weightlabcache
 
         while (nColors--) {
             const typename _CSTrait::channels_type* color = _CSTrait::nativeArray(source.getPixel());
-            typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype alphaTimesWeight;
+            compositetype alphaTimesWeight;
 
             if (_CSTrait::alpha_pos != -1) {
                 alphaTimesWeight = color[_CSTrait::alpha_pos];
@@ -170,10 +184,16 @@ private:
             source.nextPixel();
             weightsWrapper.nextPixel();
         }
+    }
 
-        // set totalAlpha to the minimum between its value and the unit value of the channels
-        const typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype sumOfWeights = weightsWrapper.normalizeFactor();
+    /**
+     * Divides the accumulated totals by the total alpha and writes the
+     * resulting pixel into \p dst
+     */
+    static void writeMixedColor(const compositetype *totals, compositetype totalAlpha,
+                                const compositetype sumOfWeights, quint8 *dst) {
 
+        // set totalAlpha to the minimum between its value and the unit value of the channels
         if (totalAlpha > KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::unitValue * sumOfWeights) {
             totalAlpha = KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::unitValue * sumOfWeights;
         }
@@ -190,7 +210,7 @@ private:
             for (int i = 0; i < (int)_CSTrait::channels_nb; i++) {
                 if (i != _CSTrait::alpha_pos) {
 
-                    typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype v = safeDivideWithRound(totals[i], totalAlpha);
+                    compositetype v = safeDivideWithRound(totals[i], totalAlpha);
 
                     if (v > KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::max) {
                         v = KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::max;
@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOP_H
+#define KOOPTIMIZEDMIXCOLORSOP_H
+
+#include "KoColorSpaceTraits.h"
+#include "KoMixColorsOpImpl.h"
+#include "KoVcMultiArchBuildSupport.h"
+
+/**
+ * Mixes the colors of 4-channel spaces with alpha stored in the last
+ * channel. The generic version is the same as KoMixColorsOpImpl, the
+ * vectorized versions are used for 8-bit, 16-bit and 32-bit float
+ * channels.
+ *
+ * Only the mixing of the continuous arrays of pixels is vectorized,
+ * the arrays of pointers are mixed by the base class.
+ */
+template<typename _channels_type_,
+         Vc::Implementation _impl,
+         typename EnableDummyType = void>
+class KoOptimizedMixColorsOp : public KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, 4, 3>>
+{
+};
+
+#ifdef HAVE_VC
+
+#include "KoStreamedMath.h"
+
+template<Vc::Implementation _impl>
+class KoOptimizedMixColorsOp<
+        quint8, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl>::type>
+    : public KoMixColorsOpImpl<KoColorSpaceTrait<quint8, 4, 3>>
+{
+    using base_class = KoMixColorsOpImpl<KoColorSpaceTrait<quint8, 4, 3>>;
+    using compositetype = typename base_class::compositetype;
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+
+    static constexpr int pixelSize = 4;
+
+public:
+    using base_class::mixColors;
+
+    void mixColors(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, int weightSum = 255) const override {
+        mixColorsVector<true>(colors, weights, nColors, dst, weightSum);
+    }
+
+    void mixColors(const quint8 *colors, quint32 nColors, quint8 *dst) const override {
+        mixColorsVector<false>(colors, 0, nColors, dst, nColors);
+    }
+
+private:
+    /**
+     * All the pixels are loaded as 32-bit integers and split into the
+     * channels in the lanes. The totals are accumulated in 32-bit lanes,
+     * which gives exactly the same result as the scalar version, which
+     * uses 32-bit totals as well.
+     */
+    template<bool useWeights>
+    static void mixColorsVector(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, int weightSum) {
+        const int block1 = nColors / uint_v::size();
+        const int block2 = nColors % uint_v::size();
+        const int vectorPixelStride = pixelSize * uint_v::size();
+
+        const uint_v channelMask(0xFFu);
+
+        uint_v totals_0(Vc::Zero);
+        uint_v totals_1(Vc::Zero);
+        uint_v totals_2(Vc::Zero);
+        uint_v totalAlpha_v(Vc::Zero);
+
+        for (int i = 0; i < block1; i++) {
+            uint_v data_i;
+            data_i.load(reinterpret_cast<const quint32*>(colors), Vc::Unaligned);
+
+            uint_v alphaTimesWeight = data_i >> 24;
+
+            if (useWeights) {
+                const int_v weights_i(weights, Vc::Unaligned);
+                alphaTimesWeight *= uint_v(weights_i);
+                weights += uint_v::size();
+            }
+
+            totals_0 += (data_i & channelMask) * alphaTimesWeight;
+            totals_1 += ((data_i >> 8) & channelMask) * alphaTimesWeight;
+            totals_2 += ((data_i >> 16) & channelMask) * alphaTimesWeight;
+            totalAlpha_v += alphaTimesWeight;
+
+            colors += vectorPixelStride;
+        }
+
+        compositetype totals[4];
+        totals[0] = compositetype(totals_0.sum());
+        totals[1] = compositetype(totals_1.sum());
+        totals[2] = compositetype(totals_2.sum());
+        totals[3] = 0;
+        compositetype totalAlpha = compositetype(totalAlpha_v.sum());
+
+        typename base_class::PointerToArray source(colors, pixelSize);
+
+        if (useWeights) {
+            typename base_class::WeightsWrapper weightsWrapper(weights, weightSum);
+            base_class::accumulateColors(source, weightsWrapper, block2, totals, totalAlpha);
+        } else {
+            typename base_class::NoWeightsSurrogate weightsWrapper(weightSum);
+            base_class::accumulateColors(source, weightsWrapper, block2, totals, totalAlpha);
+        }
+
+        base_class::writeMixedColor(totals, totalAlpha, weightSum, dst);
+    }
+};
+
+/**
+ * Mixes the 16-bit and 32-bit float pixels. The channels are
+ * deinterleaved into double lanes, which keeps the precision of the
+ * scalar version.
+ *
+ * For the 16-bit channels the products of the colors, alpha and the
+ * weights are integers below 2^47, so the lanes are added exactly
+ * until the sums reach 2^53. The lanes are flushed into the 64-bit
+ * integer totals every \p flushInterval blocks to stay in this range.
+ */
+template<typename _channels_type_, Vc::Implementation _impl>
+class KoOptimizedMixColorsOp<
+        _channels_type_, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl &&
+                                (std::is_same<_channels_type_, quint16>::value ||
+                                 std::is_same<_channels_type_, float>::value)>::type>
+    : public KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, 4, 3>>
+{
+    using base_class = KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, 4, 3>>;
+    using compositetype = typename base_class::compositetype;
+    using double_v = Vc::SimdArray<double, Vc::float_v::size()>;
+
+    static constexpr int pixelSize = 4 * sizeof(_channels_type_);
+    static constexpr int flushInterval = 32;
+
+public:
+    using base_class::mixColors;
+
+    void mixColors(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, int weightSum = 255) const override {
+        mixColorsVector<true>(colors, weights, nColors, dst, weightSum);
+    }
+
+    void mixColors(const quint8 *colors, quint32 nColors, quint8 *dst) const override {
+        mixColorsVector<false>(colors, 0, nColors, dst, nColors);
+    }
+
+private:
+    static inline void flushTotals(double_v *totals_v, compositetype *totals) {
+        for (int ch = 0; ch < 4; ch++) {
+            for (size_t i = 0; i < double_v::size(); i++) {
+                totals[ch] += compositetype(totals_v[ch][i]);
+            }
+            totals_v[ch] = double_v(Vc::Zero);
+        }
+    }
+
+    template<bool useWeights>
+    static void mixColorsVector(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, int weightSum) {
+        const int block1 = nColors / double_v::size();
+        const int block2 = nColors % double_v::size();
+        const int vectorPixelStride = pixelSize * double_v::size();
+
+        const bool needsFlush = std::is_integral<compositetype>::value;
+
+        alignas(64) double buf[4][double_v::size()];
+
+        // the totals of the colors and alpha, alpha is the last one
+        double_v totals_v[4] = {double_v(Vc::Zero), double_v(Vc::Zero),
+                                double_v(Vc::Zero), double_v(Vc::Zero)};
+
+        compositetype totals[4] = {0, 0, 0, 0};
+
+        for (int i = 0; i < block1; i++) {
+            const _channels_type_ *pixels = reinterpret_cast<const _channels_type_*>(colors);
+
+            for (size_t j = 0; j < double_v::size(); j++) {
+                buf[0][j] = pixels[4 * j + 0];
+                buf[1][j] = pixels[4 * j + 1];
+                buf[2][j] = pixels[4 * j + 2];
+                buf[3][j] = pixels[4 * j + 3];
+            }
+
+            double_v alphaTimesWeight(buf[3], Vc::Aligned);
+
+            if (useWeights) {
+                alphaTimesWeight *= double_v(weights, Vc::Unaligned);
+                weights += double_v::size();
+            }
+
+            totals_v[0] += double_v(buf[0], Vc::Aligned) * alphaTimesWeight;
+            totals_v[1] += double_v(buf[1], Vc::Aligned) * alphaTimesWeight;
+            totals_v[2] += double_v(buf[2], Vc::Aligned) * alphaTimesWeight;
+            totals_v[3] += alphaTimesWeight;
+
+            if (needsFlush && (i + 1) % flushInterval == 0) {
+                flushTotals(totals_v, totals);
+            }
+
+            colors += vectorPixelStride;
+        }
+
+        flushTotals(totals_v, totals);
+
+        compositetype totalAlpha = totals[3];
+        totals[3] = 0;
+
+        typename base_class::PointerToArray source(colors, pixelSize);
+
+        if (useWeights) {
+            typename base_class::WeightsWrapper weightsWrapper(weights, weightSum);
+            base_class::accumulateColors(source, weightsWrapper, block2, totals, totalAlpha);
+        } else {
+            typename base_class::NoWeightsSurrogate weightsWrapper(weightSum);
+            base_class::accumulateColors(source, weightsWrapper, block2, totals, totalAlpha);
+        }
+
+        base_class::writeMixedColor(totals, totalAlpha, weightSum, dst);
+    }
+};
+
+#endif /* HAVE_VC */
+
+#endif // KOOPTIMIZEDMIXCOLORSOP_H
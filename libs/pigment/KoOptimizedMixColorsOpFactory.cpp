@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+
+KoMixColorsOp *KoOptimizedMixColorsOpFactory::create(KoID depthId, int numChannels, int alphaPos)
+{
+    if (numChannels != 4 || alphaPos != 3) {
+        return 0;
+    }
+
+    if (depthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<KoOptimizedMixColorsOpFactoryImpl<quint8>>(0);
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return createOptimizedClass<KoOptimizedMixColorsOpFactoryImpl<quint16>>(0);
+    } else if (depthId == Float32BitsColorDepthID) {
+        return createOptimizedClass<KoOptimizedMixColorsOpFactoryImpl<float>>(0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+#include "KoOptimizedMixColorsOp.h"
+
+template<typename _channels_type_>
+template<Vc::Implementation _impl>
+KoMixColorsOp*
+KoOptimizedMixColorsOpFactoryImpl<_channels_type_>::create(int)
+{
+    return new KoOptimizedMixColorsOp<_channels_type_, _impl>();
+}
+
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint8>::create<Vc::CurrentImplementation::current()>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint16>::create<Vc::CurrentImplementation::current()>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<float>::create<Vc::CurrentImplementation::current()>(int);
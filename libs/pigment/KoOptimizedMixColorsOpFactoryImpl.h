@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
+#define KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
+
+#include "kritapigment_export.h"
+
+#include <KoMixColorsOp.h>
+#include <KoVcMultiArchBuildSupport.h>
+
+template<typename _channels_type_>
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactoryImpl
+{
+public:
+    typedef int ParamType;
+    typedef KoMixColorsOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KoMixColorsOp* create(int);
+};
+
+#endif // KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
@@ -0,0 +1,255 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPALPHADARKEN64_H_
+#define KOOPTIMIZEDCOMPOSITEOPALPHADARKEN64_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include <klocalizedstring.h>
+#include "KoStreamedMath.h"
+#include <KoAlphaDarkenParamsWrapper.h>
+
+template<typename _ParamsWrapper>
+struct AlphaDarkenCompositor64 {
+    using ParamsWrapper = _ParamsWrapper;
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Vc::float_v src_alpha;
+        Vc::float_v dst_alpha;
+
+        // we don't use directly passed value
+        Q_UNUSED(opacity);
+
+        // instead we use value calculated by ParamsWrapper
+        opacity = oparams.opacity;
+        Vc::float_v opacity_vec(65535.0 * opacity);
+
+        Vc::float_v average_opacity_vec(65535.0 * oparams.averageOpacity);
+        Vc::float_v flow_norm_vec(oparams.flow);
+
+
+        Vc::float_v uint16MaxUint8MaxRec((float)1.0 / (65535.0 * 255.0));
+        Vc::float_v uint16MaxRec1((float)1.0 / 65535.0);
+        Vc::float_v uint16Max((float)65535.0);
+        Vc::float_v zeroValue(Vc::Zero);
+
+
+        Vc::float_v msk_norm_alpha;
+        src_alpha = KoStreamedMath<_impl>::fetch_alpha_64(src);
+
+        if (haveMask) {
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            msk_norm_alpha = src_alpha * mask_vec * uint16MaxUint8MaxRec;
+        } else {
+            msk_norm_alpha = src_alpha * uint16MaxRec1;
+        }
+
+        dst_alpha = KoStreamedMath<_impl>::fetch_alpha_64(dst);
+        src_alpha = msk_norm_alpha * opacity_vec;
+
+        Vc::float_m empty_dst_pixels_mask = dst_alpha == zeroValue;
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        bool srcAlphaIsZero = (src_alpha == zeroValue).isFull();
+        if (srcAlphaIsZero) return;
+
+        KoStreamedMath<_impl>::fetch_colors_64(src, src_c1, src_c2, src_c3);
+
+        bool dstAlphaIsZero = empty_dst_pixels_mask.isFull();
+
+        Vc::float_v dst_blend = src_alpha * uint16MaxRec1;
+
+        bool srcAlphaIsUnit = (src_alpha == uint16Max).isFull();
+
+        if (dstAlphaIsZero) {
+            dst_c1 = src_c1;
+            dst_c2 = src_c2;
+            dst_c3 = src_c3;
+        } else if (srcAlphaIsUnit) {
+            bool dstAlphaIsUnit = (dst_alpha == uint16Max).isFull();
+            if (dstAlphaIsUnit) {
+                memcpy(dst, src, 8 * Vc::float_v::size());
+                return;
+            } else {
+                dst_c1 = src_c1;
+                dst_c2 = src_c2;
+                dst_c3 = src_c3;
+            }
+        } else if (empty_dst_pixels_mask.isEmpty()) {
+            KoStreamedMath<_impl>::fetch_colors_64(dst, dst_c1, dst_c2, dst_c3);
+            dst_c1 = dst_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = dst_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = dst_blend * (src_c3 - dst_c3) + dst_c3;
+        } else {
+            KoStreamedMath<_impl>::fetch_colors_64(dst, dst_c1, dst_c2, dst_c3);
+            dst_c1(empty_dst_pixels_mask) = src_c1;
+            dst_c2(empty_dst_pixels_mask) = src_c2;
+            dst_c3(empty_dst_pixels_mask) = src_c3;
+
+            Vc::float_m not_empty_dst_pixels_mask = !empty_dst_pixels_mask;
+
+            dst_c1(not_empty_dst_pixels_mask) = dst_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2(not_empty_dst_pixels_mask) = dst_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3(not_empty_dst_pixels_mask) = dst_blend * (src_c3 - dst_c3) + dst_c3;
+        }
+
+        Vc::float_v fullFlowAlpha;
+
+        if (oparams.averageOpacity > opacity) {
+            Vc::float_m fullFlowAlpha_mask = average_opacity_vec > dst_alpha;
+
+            if (fullFlowAlpha_mask.isEmpty()) {
+                fullFlowAlpha = dst_alpha;
+            } else {
+                Vc::float_v reverse_blend = dst_alpha / average_opacity_vec;
+                Vc::float_v opt1 = (average_opacity_vec - src_alpha) * reverse_blend + src_alpha;
+                fullFlowAlpha(!fullFlowAlpha_mask) = dst_alpha;
+                fullFlowAlpha(fullFlowAlpha_mask) = opt1;
+            }
+        } else {
+            Vc::float_m fullFlowAlpha_mask = opacity_vec > dst_alpha;
+
+            if (fullFlowAlpha_mask.isEmpty()) {
+                fullFlowAlpha = dst_alpha;
+            } else {
+                Vc::float_v opt1 = (opacity_vec - dst_alpha) * msk_norm_alpha + dst_alpha;
+                fullFlowAlpha(!fullFlowAlpha_mask) = dst_alpha;
+                fullFlowAlpha(fullFlowAlpha_mask) = opt1;
+            }
+        }
+
+        if (oparams.flow == 1.0) {
+            dst_alpha = fullFlowAlpha;
+        } else {
+            Vc::float_v zeroFlowAlpha = ParamsWrapper::calculateZeroFlowAlpha(src_alpha, dst_alpha, uint16MaxRec1);
+            dst_alpha = (fullFlowAlpha - zeroFlowAlpha) * flow_norm_vec + zeroFlowAlpha;
+        }
+
+        KoStreamedMath<_impl>::write_channels_64(dst, dst_alpha, dst_c1, dst_c2, dst_c3);
+    }
+
+    /**
+     * Composes one pixel of the source into the destination
+     */
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const quint16 *s = reinterpret_cast<const quint16*>(src);
+        quint16 *d = reinterpret_cast<quint16*>(dst);
+
+        const float uint16Rec1 = 1.0 / 65535.0;
+        const float uint16Uint8Rec = 1.0 / (65535.0 * 255.0);
+        const float uint16Max = 65535.0;
+
+        quint16 dstAlphaInt = d[alpha_pos];
+        float dstAlphaNorm = dstAlphaInt ? dstAlphaInt * uint16Rec1 : 0.0;
+        float srcAlphaNorm;
+        float mskAlphaNorm;
+
+        Q_UNUSED(opacity);
+        opacity = oparams.opacity;
+
+        if (haveMask) {
+            mskAlphaNorm = float(*mask) * uint16Uint8Rec * s[alpha_pos];
+            srcAlphaNorm = mskAlphaNorm * opacity;
+        } else {
+            mskAlphaNorm = s[alpha_pos] * uint16Rec1;
+            srcAlphaNorm = mskAlphaNorm * opacity;
+        }
+
+        if (dstAlphaInt != 0) {
+            d[0] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[0], s[0], srcAlphaNorm);
+            d[1] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[1], s[1], srcAlphaNorm);
+            d[2] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[2], s[2], srcAlphaNorm);
+        } else {
+            KoStreamedMathFunctions::copyPixel<8>(src, dst);
+        }
+
+
+        float flow = oparams.flow;
+        float averageOpacity = oparams.averageOpacity;
+
+        float fullFlowAlpha;
+
+        if (averageOpacity > opacity) {
+            fullFlowAlpha = averageOpacity > dstAlphaNorm ? lerp(srcAlphaNorm, averageOpacity, dstAlphaNorm / averageOpacity) : dstAlphaNorm;
+        } else {
+            fullFlowAlpha = opacity > dstAlphaNorm ? lerp(dstAlphaNorm, opacity, mskAlphaNorm) : dstAlphaNorm;
+        }
+
+        float dstAlpha;
+
+        if (flow == 1.0) {
+            dstAlpha = fullFlowAlpha * uint16Max;
+        } else {
+            float zeroFlowAlpha = ParamsWrapper::calculateZeroFlowAlpha(srcAlphaNorm, dstAlphaNorm);
+            dstAlpha = lerp(zeroFlowAlpha, fullFlowAlpha, flow) * uint16Max;
+        }
+
+        d[alpha_pos] = KoStreamedMath<_impl>::round_float_to_u16(qBound(0.0f, dstAlpha, uint16Max));
+    }
+};
+
+/**
+ * An optimized version of a composite op for the use in 8 byte
+ * colorspaces with 16-bit channels and alpha channel placed at
+ * the last channel of the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl, class ParamsWrapper>
+class KoOptimizedCompositeOpAlphaDarken64Impl : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpAlphaDarken64Impl(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_ALPHA_DARKEN, i18n("Alpha darken"), KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            KoStreamedMath<_impl>::template genericComposite64<true, true, AlphaDarkenCompositor64<ParamsWrapper> >(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite64<false, true, AlphaDarkenCompositor64<ParamsWrapper> >(params);
+        }
+    }
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenHard64 :
+        public KoOptimizedCompositeOpAlphaDarken64Impl<_impl, KoAlphaDarkenParamsWrapperHard>
+{
+public:
+    KoOptimizedCompositeOpAlphaDarkenHard64(const KoColorSpace *cs)
+        : KoOptimizedCompositeOpAlphaDarken64Impl<_impl, KoAlphaDarkenParamsWrapperHard>(cs) {
+    }
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamy64 :
+        public KoOptimizedCompositeOpAlphaDarken64Impl<_impl, KoAlphaDarkenParamsWrapperCreamy>
+{
+public:
+    KoOptimizedCompositeOpAlphaDarkenCreamy64(const KoColorSpace *cs)
+        : KoOptimizedCompositeOpAlphaDarken64Impl<_impl, KoAlphaDarkenParamsWrapperCreamy>(cs) {
+    }
+};
+
+
+#endif // KOOPTIMIZEDCOMPOSITEOPALPHADARKEN64_H_
@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPF16_H
+#define KOOPTIMIZEDCOMPOSITEOPF16_H
+
+#include <KoConfig.h>
+
+#ifdef HAVE_OPENEXR
+
+#include <half.h>
+#include <QScopedPointer>
+
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+#include "KoCompositeOp.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAVE_F16C_HALF_CONVERSION
+#define F16C_TARGET __attribute__((target("f16c")))
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(_MSC_VER)
+#include <arm_neon.h>
+#define HAVE_NEON_HALF_CONVERSION
+#endif
+
+/**
+ * Converts the half channels into floats and back using hardware
+ * conversion instructions: F16C on x86 and the fp16 conversions of
+ * AArch64. The conversion of every half value into a float and back
+ * is exact, so the pixels that are not touched by the composition
+ * don't change.
+ *
+ * F16C is not a part of any instruction set Vc dispatches on, so the
+ * conversion functions are compiled for it explicitly and its presence
+ * is checked in runtime.
+ */
+template<Vc::Implementation _impl>
+struct KoStreamedHalfConversion
+{
+    static bool isSupported() {
+#if defined HAVE_F16C_HALF_CONVERSION
+        static const bool hasF16C = __builtin_cpu_supports("f16c");
+        return hasF16C;
+#elif defined HAVE_NEON_HALF_CONVERSION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#if defined HAVE_F16C_HALF_CONVERSION
+    static F16C_TARGET void halfToFloat(const half *src, float *dst, int numValues) {
+        int i = 0;
+        for (; i + 8 <= numValues; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+        for (; i < numValues; i++) {
+            dst[i] = float(src[i]);
+        }
+    }
+
+    static F16C_TARGET void floatToHalf(const float *src, half *dst, int numValues) {
+        int i = 0;
+        for (; i + 8 <= numValues; i += 8) {
+            const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+        }
+        for (; i < numValues; i++) {
+            dst[i] = half(src[i]);
+        }
+    }
+#elif defined HAVE_NEON_HALF_CONVERSION
+    static void halfToFloat(const half *src, float *dst, int numValues) {
+        int i = 0;
+        for (; i + 4 <= numValues; i += 4) {
+            const uint16x4_t h = vld1_u16(reinterpret_cast<const uint16_t*>(src + i));
+            vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(h)));
+        }
+        for (; i < numValues; i++) {
+            dst[i] = float(src[i]);
+        }
+    }
+
+    static void floatToHalf(const float *src, half *dst, int numValues) {
+        int i = 0;
+        for (; i + 4 <= numValues; i += 4) {
+            const float16x4_t h = vcvt_f16_f32(vld1q_f32(src + i));
+            vst1_u16(reinterpret_cast<uint16_t*>(dst + i), vreinterpret_u16_f16(h));
+        }
+        for (; i < numValues; i++) {
+            dst[i] = half(src[i]);
+        }
+    }
+#else
+    static void halfToFloat(const half *src, float *dst, int numValues) {
+        for (int i = 0; i < numValues; i++) {
+            dst[i] = float(src[i]);
+        }
+    }
+
+    static void floatToHalf(const float *src, half *dst, int numValues) {
+        for (int i = 0; i < numValues; i++) {
+            dst[i] = half(src[i]);
+        }
+    }
+#endif
+};
+
+/**
+ * A composite op for RGBA F16 pixels that runs the optimized RGBA F32
+ * composite op on the chunks of the row. The chunks are converted from
+ * half into small on-stack buffers and back with the conversion
+ * instructions of the CPU, which is much cheaper than the emulated half
+ * arithmetic of the generic ops.
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpF16 : public KoCompositeOp
+{
+    static const int chunkSize = 64;
+    static const int channelsNb = 4;
+
+    // the pixels are converted from half into float
+    static const int srcPixelSize = channelsNb * sizeof(half);
+    static const int bufferPixelSize = channelsNb * sizeof(float);
+
+public:
+    /**
+     * \p f32Op is the composite op working with RGBA F32 pixels, the
+     * class takes ownership over it
+     */
+    KoOptimizedCompositeOpF16(const KoColorSpace *cs, KoCompositeOp *f32Op)
+        : KoCompositeOp(cs, f32Op->id(), f32Op->description(), f32Op->category()),
+          m_f32Op(f32Op)
+    {
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        typedef KoStreamedHalfConversion<_impl> Conversion;
+
+        alignas(32) float srcBuffer[chunkSize * channelsNb];
+        alignas(32) float dstBuffer[chunkSize * channelsNb];
+
+        KoCompositeOp::ParameterInfo chunkParams(params);
+        chunkParams.rows = 1;
+        chunkParams.srcRowStart = reinterpret_cast<quint8*>(srcBuffer);
+        chunkParams.dstRowStart = reinterpret_cast<quint8*>(dstBuffer);
+        chunkParams.srcRowStride = params.srcRowStride ? chunkSize * bufferPixelSize : 0;
+        chunkParams.dstRowStride = chunkSize * bufferPixelSize;
+
+        if (!params.srcRowStride) {
+            Conversion::halfToFloat(reinterpret_cast<const half*>(params.srcRowStart), srcBuffer, channelsNb);
+        }
+
+        const quint8 *srcRowStart = params.srcRowStart;
+        quint8 *dstRowStart = params.dstRowStart;
+        const quint8 *maskRowStart = params.maskRowStart;
+
+        for (int row = 0; row < params.rows; row++) {
+            for (int col = 0; col < params.cols; col += chunkSize) {
+                const int numPixels = qMin(chunkSize, params.cols - col);
+                half *dst = reinterpret_cast<half*>(dstRowStart + col * srcPixelSize);
+
+                Conversion::halfToFloat(dst, dstBuffer, numPixels * channelsNb);
+
+                if (params.srcRowStride) {
+                    const half *src = reinterpret_cast<const half*>(srcRowStart + col * srcPixelSize);
+                    Conversion::halfToFloat(src, srcBuffer, numPixels * channelsNb);
+                }
+
+                chunkParams.maskRowStart = maskRowStart ? maskRowStart + col : 0;
+                chunkParams.cols = numPixels;
+                m_f32Op->composite(chunkParams);
+
+                Conversion::floatToHalf(dstBuffer, dst, numPixels * channelsNb);
+            }
+
+            srcRowStart += params.srcRowStride;
+            dstRowStart += params.dstRowStride;
+            if (maskRowStart) {
+                maskRowStart += params.maskRowStride;
+            }
+        }
+    }
+
+private:
+    QScopedPointer<KoCompositeOp> m_f32Op;
+};
+
+#endif /* HAVE_OPENEXR */
+
+#endif // KOOPTIMIZEDCOMPOSITEOPF16_H
@@ -8,7 +8,9 @@
 #define KOOPTIMIZEDCOMPOSITEOPFACTORY_H
 
 #include "kritapigment_export.h"
+#include <KoConfig.h>
 
+class QString;
 class KoCompositeOp;
 class KoColorSpace;
 
@@ -30,9 +32,28 @@ public:
     static KoCompositeOp* createAlphaDarkenOpHard32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamy32(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpHard64(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpCreamy64(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOp64(const KoColorSpace *cs);
+#ifdef HAVE_OPENEXR
+    /**
+     * The F16 ops return null if the CPU cannot convert half values
+     * in hardware, then the generic ops should be used
+     */
+    static KoCompositeOp* createAlphaDarkenOpHardF16(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpCreamyF16(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOpF16(const KoColorSpace *cs);
+#endif
     static KoCompositeOp* createAlphaDarkenOpHard128(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamy128(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp128(const KoColorSpace *cs);
+
+    /**
+     * \return an optimized version of a separable blending mode (multiply,
+     * screen, overlay and so on) for 32-bit pixels or null if there is
+     * no optimized version for \p id
+     */
+    static KoCompositeOp* createGenericSCOp32(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
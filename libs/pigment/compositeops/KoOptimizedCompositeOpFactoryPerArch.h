@@ -10,6 +10,9 @@
 
 #include <compositeops/KoVcMultiArchBuildSupport.h>
 
+#include <QString>
+#include <KoConfig.h>
+
 
 class KoCompositeOp;
 class KoColorSpace;
@@ -24,6 +27,15 @@ class KoOptimizedCompositeOpAlphaDarkenHard32;
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpOver32;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenHard64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamy64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64;
+
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpAlphaDarkenHard128;
 
@@ -43,5 +55,43 @@ struct KoOptimizedCompositeOpFactoryPerArch
     static ReturnType create(ParamType param);
 };
 
+/**
+ * Creates a vectorized version of KoCompositeOpGenericSC for 32-bit
+ * pixels, if there is one for the requested composite op id. Returns
+ * null otherwise.
+ */
+struct KoOptimizedCompositeOpGenericSCFactoryPerArch
+{
+    struct ParamType {
+        const KoColorSpace *cs;
+        QString id;
+        QString description;
+        QString category;
+    };
+    typedef KoCompositeOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType param);
+};
+
+#ifdef HAVE_OPENEXR
+/**
+ * Wraps an RGBA F32 composite op into an op for RGBA F16 pixels, if the
+ * CPU supports hardware half conversion. Returns null otherwise, the
+ * ownership over \p f32Op is passed to the created op only.
+ */
+struct KoOptimizedCompositeOpF16FactoryPerArch
+{
+    struct ParamType {
+        const KoColorSpace *cs;
+        KoCompositeOp *f32Op;
+    };
+    typedef KoCompositeOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType param);
+};
+#endif
+
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
@@ -10,13 +10,24 @@
 #include "KoCompositeOpAlphaDarken.h"
 #include "KoAlphaDarkenParamsWrapper.h"
 #include "KoCompositeOpOver.h"
+#include "KoOptimizedCompositeOpsNeon.h"
+#include "KoOptimizedCompositeOpF16.h"
+
+/**
+ * Vc has no implementation for ARM, so on AArch64 the scalar
+ * implementation is replaced by the NEON one
+ */
 
 template<>
 template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHard32>::ReturnType
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHard32>::create<Vc::ScalarImpl>(ParamType param)
 {
+#ifdef HAVE_NEON_COMPOSITE_OPS
+    return new KoOptimizedCompositeOpAlphaDarkenHard32Neon(param);
+#else
     return new KoCompositeOpAlphaDarken<KoBgrU8Traits, KoAlphaDarkenParamsWrapperHard>(param);
+#endif
 }
 
 template<>
@@ -24,7 +35,11 @@ template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy32>::ReturnType
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy32>::create<Vc::ScalarImpl>(ParamType param)
 {
+#ifdef HAVE_NEON_COMPOSITE_OPS
+    return new KoOptimizedCompositeOpAlphaDarkenCreamy32Neon(param);
+#else
     return new KoCompositeOpAlphaDarken<KoBgrU8Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+#endif
 }
 
 template<>
@@ -32,7 +47,35 @@ template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>::ReturnType
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>::create<Vc::ScalarImpl>(ParamType param)
 {
+#ifdef HAVE_NEON_COMPOSITE_OPS
+    return new KoOptimizedCompositeOpOver32Neon(param);
+#else
     return new KoCompositeOpOver<KoBgrU8Traits>(param);
+#endif
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHard64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHard64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperHard>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpOver<KoBgrU16Traits>(param);
 }
 
 template<>
@@ -40,7 +83,11 @@ template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHard128>::ReturnType
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHard128>::create<Vc::ScalarImpl>(ParamType param)
 {
+#ifdef HAVE_NEON_COMPOSITE_OPS
+    return new KoOptimizedCompositeOpAlphaDarkenHard128Neon(param);
+#else
     return new KoCompositeOpAlphaDarken<KoRgbF32Traits, KoAlphaDarkenParamsWrapperHard>(param);
+#endif
 }
 
 template<>
@@ -48,7 +95,11 @@ template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy128>::ReturnType
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy128>::create<Vc::ScalarImpl>(ParamType param)
 {
+#ifdef HAVE_NEON_COMPOSITE_OPS
+    return new KoOptimizedCompositeOpAlphaDarkenCreamy128Neon(param);
+#else
     return new KoCompositeOpAlphaDarken<KoRgbF32Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+#endif
 }
 
 
@@ -57,5 +108,32 @@ template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::ReturnType
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::ScalarImpl>(ParamType param)
 {
+#ifdef HAVE_NEON_COMPOSITE_OPS
+    return new KoOptimizedCompositeOpOver128Neon(param);
+#else
     return new KoCompositeOpOver<KoRgbF32Traits>(param);
+#endif
+}
+
+template<>
+KoOptimizedCompositeOpGenericSCFactoryPerArch::ReturnType
+KoOptimizedCompositeOpGenericSCFactoryPerArch::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+
+    // the generic implementation is used
+    return 0;
+}
+
+#ifdef HAVE_OPENEXR
+template<>
+KoOptimizedCompositeOpF16FactoryPerArch::ReturnType
+KoOptimizedCompositeOpF16FactoryPerArch::create<Vc::ScalarImpl>(ParamType param)
+{
+    if (!KoStreamedHalfConversion<Vc::ScalarImpl>::isSupported()) {
+        return 0;
+    }
+
+    return new KoOptimizedCompositeOpF16<Vc::ScalarImpl>(param.cs, param.f32Op);
 }
+#endif
@@ -0,0 +1,372 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H
+
+#include <algorithm>
+#include <cmath>
+
+#include <QScopedPointer>
+
+#include "KoColorSpaceTraits.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpFunctions.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Vectorized versions of the most popular separable blending functions.
+ *
+ * Every blending function is written once as a template over the value
+ * type, so the same code is used for both Vc::float_v and a plain float
+ * (the unaligned head and the tail of the row). The values are
+ * normalized into [0, 1] range. The results follow the integer
+ * cfXXX() functions from KoCompositeOpFunctions.h within the rounding
+ * error; composeChannel() gives the original function that is used
+ * when the channel flags are not trivial.
+ *
+ * The functions are parametrized by the implementation, because the
+ * header is compiled once per instruction set and the instantiations
+ * must not be shared between the per-arch objects.
+ */
+template<Vc::Implementation _impl>
+struct KoStreamedBlendFunctions {
+    static ALWAYS_INLINE float vMin(float a, float b) { return std::min(a, b); }
+    static ALWAYS_INLINE float vMax(float a, float b) { return std::max(a, b); }
+    static ALWAYS_INLINE float vAbs(float a) { return std::abs(a); }
+    static ALWAYS_INLINE float vSqrt(float a) { return std::sqrt(a); }
+    static ALWAYS_INLINE float vSelect(bool cond, float a, float b) { return cond ? a : b; }
+
+    static ALWAYS_INLINE Vc::float_v vMin(Vc::float_v::AsArg a, Vc::float_v::AsArg b) { return Vc::min(a, b); }
+    static ALWAYS_INLINE Vc::float_v vMax(Vc::float_v::AsArg a, Vc::float_v::AsArg b) { return Vc::max(a, b); }
+    static ALWAYS_INLINE Vc::float_v vAbs(Vc::float_v::AsArg a) { return Vc::abs(a); }
+    static ALWAYS_INLINE Vc::float_v vSqrt(Vc::float_v::AsArg a) { return Vc::sqrt(a); }
+    static ALWAYS_INLINE Vc::float_v vSelect(const Vc::float_v::Mask &cond, Vc::float_v::AsArg a, Vc::float_v::AsArg b) { return Vc::iif(cond, a, b); }
+
+    struct Multiply {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfMultiply<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return src * dst;
+        }
+    };
+
+    struct Screen {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfScreen<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return src + dst - src * dst;
+        }
+    };
+
+    struct DarkenOnly {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfDarkenOnly<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return vMin(src, dst);
+        }
+    };
+
+    struct LightenOnly {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfLightenOnly<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return vMax(src, dst);
+        }
+    };
+
+    struct Difference {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfDifference<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return vAbs(src - dst);
+        }
+    };
+
+    struct Addition {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfAddition<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return vMin(src + dst, T(1.0f));
+        }
+    };
+
+    struct Subtract {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfSubtract<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return vMax(dst - src, T(0.0f));
+        }
+    };
+
+    struct HardLight {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfHardLight<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            const T src2 = src + src;
+            const T screened = Screen::blend(src2 - T(1.0f), dst);
+            return vSelect(src > T(0.5f), screened, src2 * dst);
+        }
+    };
+
+    struct Overlay {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfOverlay<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            return HardLight::blend(dst, src);
+        }
+    };
+
+    struct SoftLight {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfSoftLight<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            const T src2 = src + src;
+            const T light = dst + (src2 - T(1.0f)) * (vSqrt(dst) - dst);
+            const T dark = dst - (T(1.0f) - src2) * dst * (T(1.0f) - dst);
+            return vSelect(src > T(0.5f), light, dark);
+        }
+    };
+
+    struct SoftLightSvg {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfSoftLightSvg<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            const T src2 = src + src;
+            const T D = vSelect(dst > T(0.25f),
+                                vSqrt(dst),
+                                ((T(16.0f) * dst - T(12.0f)) * dst + T(4.0f)) * dst);
+            const T light = dst + (src2 - T(1.0f)) * (D - dst);
+            const T dark = dst - (T(1.0f) - src2) * dst * (T(1.0f) - dst);
+            return vSelect(src > T(0.5f), light, dark);
+        }
+    };
+
+    struct ColorDodge {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfColorDodge<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            // the lanes with src == 1.0 divide by zero, they are replaced by select
+            const T result = vMin(dst / (T(1.0f) - src), T(1.0f));
+            return vSelect(src >= T(1.0f), T(1.0f), result);
+        }
+    };
+
+    struct ColorBurn {
+        static quint8 composeChannel(quint8 src, quint8 dst) { return cfColorBurn<quint8>(src, dst); }
+
+        template<class T>
+        static ALWAYS_INLINE T blend(const T &src, const T &dst) {
+            const T invDst = T(1.0f) - dst;
+
+            // the lanes with src == 0.0 divide by zero, they are replaced by select
+            T result = T(1.0f) - vMin(invDst / src, T(1.0f));
+            result = vSelect(src < invDst, T(0.0f), result);
+            return vSelect(dst >= T(1.0f), T(1.0f), result);
+        }
+    };
+};
+
+/**
+ * Implements KoCompositeOpGenericSC math for 4 byte pixels with
+ * the alpha channel placed at the last byte: C1_C2_C3_A
+ */
+template<class BlendFunc>
+struct GenericSCCompositor32 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+        {
+            Q_UNUSED(params);
+        }
+    };
+
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const Vc::float_v uint8Max((float)255.0);
+        const Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+
+        Vc::float_v src_alpha = KoStreamedMath<_impl>::template fetch_alpha_32<src_aligned>(src);
+        src_alpha *= Vc::float_v(opacity) * uint8MaxRec1;
+
+        if (haveMask) {
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_alpha = KoStreamedMath<_impl>::template fetch_alpha_32<true>(dst);
+        dst_alpha *= uint8MaxRec1;
+
+        const Vc::float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+
+        const Vc::float_v srcFactor = src_alpha * (oneValue - dst_alpha);
+        const Vc::float_v dstFactor = dst_alpha * (oneValue - src_alpha);
+        const Vc::float_v blendFactor = src_alpha * dst_alpha;
+
+        /**
+         * The lanes with zero new_alpha get NaN values here, but they
+         * keep the original colors of the destination anyway
+         */
+        const Vc::float_v newAlphaRec = uint8Max / new_alpha;
+        const Vc::float_v::Mask transparentMask = new_alpha == zeroValue;
+
+        Vc::float_v src_c[3];
+        Vc::float_v dst_c[3];
+
+        KoStreamedMath<_impl>::template fetch_colors_32<src_aligned>(src, src_c[0], src_c[1], src_c[2]);
+        KoStreamedMath<_impl>::template fetch_colors_32<true>(dst, dst_c[0], dst_c[1], dst_c[2]);
+
+        for (int i = 0; i < 3; i++) {
+            const Vc::float_v s = src_c[i] * uint8MaxRec1;
+            const Vc::float_v d = dst_c[i] * uint8MaxRec1;
+
+            const Vc::float_v result =
+                (dstFactor * d + srcFactor * s + blendFactor * BlendFunc::blend(s, d)) * newAlphaRec;
+
+            dst_c[i] = Vc::iif(transparentMask, dst_c[i], result);
+        }
+
+        KoStreamedMath<_impl>::write_channels_32(dst, new_alpha * uint8Max, dst_c[0], dst_c[1], dst_c[2]);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const qint32 alpha_pos = 3;
+        const float uint8Rec1 = 1.0 / 255.0;
+
+        float srcAlpha = src[alpha_pos] * opacity * uint8Rec1;
+
+        if (haveMask) {
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha == 0.0) return;
+
+        const float dstAlpha = dst[alpha_pos] * uint8Rec1;
+        const float newAlpha = srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+
+        if (newAlpha != 0.0) {
+            const float srcFactor = srcAlpha * (1.0f - dstAlpha);
+            const float dstFactor = dstAlpha * (1.0f - srcAlpha);
+            const float blendFactor = srcAlpha * dstAlpha;
+            const float newAlphaRec = 255.0f / newAlpha;
+
+            for (int i = 0; i < 3; i++) {
+                const float s = src[i] * uint8Rec1;
+                const float d = dst[i] * uint8Rec1;
+
+                const float result =
+                    (dstFactor * d + srcFactor * s + blendFactor * BlendFunc::blend(s, d)) * newAlphaRec;
+
+                dst[i] = KoStreamedMath<_impl>::round_float_to_uint(result);
+            }
+        }
+
+        dst[alpha_pos] = KoStreamedMath<_impl>::round_float_to_uint(newAlpha * 255.0f);
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in 4 byte
+ * colorspaces with alpha channel placed at the last byte of the pixel:
+ * C1_C2_C3_A. Non-trivial channel flags are handled by the generic
+ * implementation.
+ */
+template<Vc::Implementation _impl, class BlendFunc>
+class KoOptimizedCompositeOpGenericSC32 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpGenericSC32(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category),
+          m_genericOp(new KoCompositeOpGenericSC<KoBgrU8Traits, &BlendFunc::composeChannel>(cs, id, description, category))
+    {
+    }
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if (!params.channelFlags.isEmpty() &&
+            params.channelFlags != QBitArray(4, true)) {
+
+            m_genericOp->composite(params);
+            return;
+        }
+
+        if (params.maskRowStart) {
+            KoStreamedMath<_impl>::template genericComposite32<true, false, GenericSCCompositor32<BlendFunc> >(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite32<false, false, GenericSCCompositor32<BlendFunc> >(params);
+        }
+    }
+
+private:
+    QScopedPointer<KoCompositeOp> m_genericOp;
+};
+
+template<Vc::Implementation _impl>
+KoCompositeOp* createOptimizedCompositeOpGenericSC32(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    typedef KoStreamedBlendFunctions<_impl> F;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::Multiply>(cs, id, description, category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::Screen>(cs, id, description, category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::DarkenOnly>(cs, id, description, category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::LightenOnly>(cs, id, description, category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::Difference>(cs, id, description, category);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::Addition>(cs, id, description, category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::Subtract>(cs, id, description, category);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::HardLight>(cs, id, description, category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::Overlay>(cs, id, description, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::SoftLight>(cs, id, description, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_SVG) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::SoftLightSvg>(cs, id, description, category);
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::ColorDodge>(cs, id, description, category);
+    } else if (id == COMPOSITE_BURN) {
+        return new KoOptimizedCompositeOpGenericSC32<_impl, typename F::ColorBurn>(cs, id, description, category);
+    }
+
+    return 0;
+}
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H
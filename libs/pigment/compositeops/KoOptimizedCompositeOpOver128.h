@@ -22,8 +22,12 @@ struct OverCompositor128 {
         ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
             : channelFlags(params.channelFlags)
         {
+            for (int i = 0; i < 3; i++) {
+                colorChannelFlags[i] = channelFlags.isEmpty() || channelFlags.testBit(i);
+            }
         }
         const QBitArray &channelFlags;
+        bool colorChannelFlags[3];
     };
 
     struct Pixel {
@@ -48,8 +52,6 @@ struct OverCompositor128 {
             qInfo() << "count" << countOne << countTwo << countThree << countFour << countTotal << opacity;
         }
 #endif
-        Q_UNUSED(oparams);
-
         const Pixel *sp = reinterpret_cast<const Pixel*>(src);
         Pixel *dp = reinterpret_cast<Pixel*>(dst);
 
@@ -95,7 +97,7 @@ struct OverCompositor128 {
         Vc::float_v new_alpha;
 
         const Vc::float_v oneValue(NATIVE_OPACITY_OPAQUE);
-        if ((dst_alpha == oneValue).isFull()) {
+        if (alphaLocked || (dst_alpha == oneValue).isFull()) {
             new_alpha = dst_alpha;
             src_blend = src_alpha;
         } else if ((dst_alpha == zeroValue).isFull()) {
@@ -112,7 +114,30 @@ struct OverCompositor128 {
             src_blend.setZero(mask);
         }
 
-        if (!(src_blend == oneValue).isFull()) {
+        if (!allChannelsFlag) {
+            const Vc::float_v orig_c1 = dst_c1;
+            const Vc::float_v orig_c2 = dst_c2;
+            const Vc::float_v orig_c3 = dst_c3;
+
+            dst_c1 = src_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = src_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
+
+            /**
+             * The disabled channels keep the original values, except
+             * for the pixels that were transparent, they are cleared
+             * like in the scalar version
+             */
+            const Vc::float_m clearMask = alphaLocked ?
+                Vc::float_m(false) :
+                Vc::float_m((dst_alpha == zeroValue) && (src_alpha != zeroValue));
+
+            if (!oparams.colorChannelFlags[0]) dst_c1 = Vc::iif(clearMask, zeroValue, orig_c1);
+            if (!oparams.colorChannelFlags[1]) dst_c2 = Vc::iif(clearMask, zeroValue, orig_c2);
+            if (!oparams.colorChannelFlags[2]) dst_c3 = Vc::iif(clearMask, zeroValue, orig_c3);
+
+            dataDest[indexes] = tie(dst_c1, dst_c2, dst_c3, new_alpha);
+        } else if (!(src_blend == oneValue).isFull()) {
 #if INFO_DEBUG
             ++countOne;
 #endif
@@ -264,11 +289,11 @@ public:
                 !params.channelFlags.at(3);
 
             if (allChannelsFlag && alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, OverCompositor128<float, quint32, true, true> >(params);
+                KoStreamedMath<_impl>::template genericComposite128<haveMask, false, OverCompositor128<float, quint32, true, true> >(params);
             } else if (!allChannelsFlag && !alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, OverCompositor128<float, quint32, false, false> >(params);
+                KoStreamedMath<_impl>::template genericComposite128<haveMask, false, OverCompositor128<float, quint32, false, false> >(params);
             } else /*if (!allChannelsFlag && alphaLocked) */{
-                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, OverCompositor128<float, quint32, true, false> >(params);
+                KoStreamedMath<_impl>::template genericComposite128<haveMask, false, OverCompositor128<float, quint32, true, false> >(params);
             }
         }
     }
@@ -51,16 +51,18 @@ struct OverCompositor32 {
         ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
             : channelFlags(params.channelFlags)
         {
+            for (int i = 0; i < 3; i++) {
+                colorChannelFlags[i] = channelFlags.isEmpty() || channelFlags.testBit(i);
+            }
         }
         const QBitArray &channelFlags;
+        bool colorChannelFlags[3];
     };
 
     // \see docs in AlphaDarkenCompositor32
     template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
     static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
     {
-        Q_UNUSED(oparams);
-
         Vc::float_v src_alpha;
         Vc::float_v dst_alpha;
 
@@ -102,7 +104,7 @@ struct OverCompositor32 {
         Vc::float_v src_blend;
         Vc::float_v new_alpha;
 
-        if ((dst_alpha == uint8Max).isFull()) {
+        if (alphaLocked || (dst_alpha == uint8Max).isFull()) {
             new_alpha = dst_alpha;
             src_blend = src_alpha * uint8MaxRec1;
         } else if ((dst_alpha == zeroValue).isFull()) {
@@ -123,26 +125,55 @@ struct OverCompositor32 {
 
         }
 
+        Vc::float_v orig_c1;
+        Vc::float_v orig_c2;
+        Vc::float_v orig_c3;
+
+        if (!allChannelsFlag) {
+            KoStreamedMath<_impl>::template fetch_colors_32<true>(dst, orig_c1, orig_c2, orig_c3);
+            dst_c1 = orig_c1;
+            dst_c2 = orig_c2;
+            dst_c3 = orig_c3;
+        }
+
         if (!(src_blend == oneValue).isFull()) {
-            KoStreamedMath<_impl>::template fetch_colors_32<true>(dst, dst_c1, dst_c2, dst_c3);
+            if (allChannelsFlag) {
+                KoStreamedMath<_impl>::template fetch_colors_32<true>(dst, dst_c1, dst_c2, dst_c3);
+            }
 
             dst_c1 = src_blend * (src_c1 - dst_c1) + dst_c1;
             dst_c2 = src_blend * (src_c2 - dst_c2) + dst_c2;
             dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
 
         } else {
-            if (!haveMask && !haveOpacity) {
+            if (!haveMask && !haveOpacity && !alphaLocked && allChannelsFlag) {
                 memcpy(dst, src, 4 * Vc::float_v::size());
                 return;
             } else {
-                // opacity has changed the alpha of the source,
-                // so we can't just memcpy the bytes
+                // opacity has changed the alpha of the source or
+                // some channels are locked, so we can't just memcpy
+                // the bytes
                 dst_c1 = src_c1;
                 dst_c2 = src_c2;
                 dst_c3 = src_c3;
             }
         }
 
+        if (!allChannelsFlag) {
+            /**
+             * The disabled channels keep the original values, except
+             * for the pixels that were transparent, they are cleared
+             * like in the scalar version
+             */
+            const Vc::float_m clearMask = alphaLocked ?
+                Vc::float_m(false) :
+                Vc::float_m((dst_alpha == zeroValue) && (src_alpha != zeroValue));
+
+            if (!oparams.colorChannelFlags[0]) dst_c1 = Vc::iif(clearMask, zeroValue, orig_c1);
+            if (!oparams.colorChannelFlags[1]) dst_c2 = Vc::iif(clearMask, zeroValue, orig_c2);
+            if (!oparams.colorChannelFlags[2]) dst_c3 = Vc::iif(clearMask, zeroValue, orig_c3);
+        }
+
         KoStreamedMath<_impl>::write_channels_32(dst, new_alpha, dst_c1, dst_c2, dst_c3);
     }
 
@@ -261,11 +292,11 @@ public:
                 !params.channelFlags.at(3);
 
             if (allChannelsFlag && alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, OverCompositor32<quint8, quint32, true, true> >(params);
+                KoStreamedMath<_impl>::template genericComposite32<haveMask, false, OverCompositor32<quint8, quint32, true, true> >(params);
             } else if (!allChannelsFlag && !alphaLocked) {
-                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, OverCompositor32<quint8, quint32, false, false> >(params);
+                KoStreamedMath<_impl>::template genericComposite32<haveMask, false, OverCompositor32<quint8, quint32, false, false> >(params);
             } else /*if (!allChannelsFlag && alphaLocked) */{
-                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, OverCompositor32<quint8, quint32, true, false> >(params);
+                KoStreamedMath<_impl>::template genericComposite32<haveMask, false, OverCompositor32<quint8, quint32, true, false> >(params);
             }
         }
     }
@@ -0,0 +1,266 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+#define KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+
+template<bool alphaLocked, bool allChannelsFlag>
+struct OverCompositor64 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+            for (int i = 0; i < 3; i++) {
+                colorChannelFlags[i] = channelFlags.isEmpty() || channelFlags.testBit(i);
+            }
+        }
+        const QBitArray &channelFlags;
+        bool colorChannelFlags[3];
+    };
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Vc::float_v src_alpha;
+        Vc::float_v dst_alpha;
+
+        src_alpha = KoStreamedMath<_impl>::fetch_alpha_64(src);
+
+        bool haveOpacity = opacity != 1.0;
+        Vc::float_v opacity_norm_vec(opacity);
+
+        Vc::float_v uint16Max((float)65535.0);
+        Vc::float_v uint16MaxRec1((float)1.0 / 65535.0);
+        Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+        Vc::float_v zeroValue(Vc::Zero);
+        Vc::float_v oneValue(Vc::One);
+
+        src_alpha *= opacity_norm_vec;
+
+        if (haveMask) {
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        dst_alpha = KoStreamedMath<_impl>::fetch_alpha_64(dst);
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        KoStreamedMath<_impl>::fetch_colors_64(src, src_c1, src_c2, src_c3);
+        Vc::float_v src_blend;
+        Vc::float_v new_alpha;
+
+        if (alphaLocked || (dst_alpha == uint16Max).isFull()) {
+            new_alpha = dst_alpha;
+            src_blend = src_alpha * uint16MaxRec1;
+        } else if ((dst_alpha == zeroValue).isFull()) {
+            new_alpha = src_alpha;
+            src_blend = oneValue;
+        } else {
+            /**
+             * The value of new_alpha can have *some* zero values,
+             * which will result in NaN values while division.
+             */
+            new_alpha = dst_alpha + (uint16Max - dst_alpha) * src_alpha * uint16MaxRec1;
+            Vc::float_m mask = (new_alpha == zeroValue);
+            src_blend = src_alpha / new_alpha;
+            src_blend.setZero(mask);
+        }
+
+        Vc::float_v orig_c1;
+        Vc::float_v orig_c2;
+        Vc::float_v orig_c3;
+
+        if (!allChannelsFlag) {
+            KoStreamedMath<_impl>::fetch_colors_64(dst, orig_c1, orig_c2, orig_c3);
+            dst_c1 = orig_c1;
+            dst_c2 = orig_c2;
+            dst_c3 = orig_c3;
+        }
+
+        if (!(src_blend == oneValue).isFull()) {
+            if (allChannelsFlag) {
+                KoStreamedMath<_impl>::fetch_colors_64(dst, dst_c1, dst_c2, dst_c3);
+            }
+
+            dst_c1 = src_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = src_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
+
+        } else {
+            if (!haveMask && !haveOpacity && !alphaLocked && allChannelsFlag) {
+                memcpy(dst, src, 8 * Vc::float_v::size());
+                return;
+            } else {
+                // opacity has changed the alpha of the source or
+                // some channels are locked, so we can't just memcpy
+                // the bytes
+                dst_c1 = src_c1;
+                dst_c2 = src_c2;
+                dst_c3 = src_c3;
+            }
+        }
+
+        if (!allChannelsFlag) {
+            /**
+             * The disabled channels keep the original values, except
+             * for the pixels that were transparent, they are cleared
+             * like in the scalar version
+             */
+            const Vc::float_m clearMask = alphaLocked ?
+                Vc::float_m(false) :
+                Vc::float_m((dst_alpha == zeroValue) && (src_alpha != zeroValue));
+
+            if (!oparams.colorChannelFlags[0]) dst_c1 = Vc::iif(clearMask, zeroValue, orig_c1);
+            if (!oparams.colorChannelFlags[1]) dst_c2 = Vc::iif(clearMask, zeroValue, orig_c2);
+            if (!oparams.colorChannelFlags[2]) dst_c3 = Vc::iif(clearMask, zeroValue, orig_c3);
+        }
+
+        KoStreamedMath<_impl>::write_channels_64(dst, new_alpha, dst_c1, dst_c2, dst_c3);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const quint16 *s = reinterpret_cast<const quint16*>(src);
+        quint16 *d = reinterpret_cast<quint16*>(dst);
+
+        const float uint8Rec1 = 1.0 / 255.0;
+        const float uint16Rec1 = 1.0 / 65535.0;
+        const float uint16Max = 65535.0;
+
+        float srcAlpha = s[alpha_pos];
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha != 0.0) {
+
+            float dstAlpha = d[alpha_pos];
+            float srcBlendNorm;
+
+            if (alphaLocked || dstAlpha == uint16Max) {
+                srcBlendNorm = srcAlpha * uint16Rec1;
+            } else if (dstAlpha == 0.0) {
+                dstAlpha = srcAlpha;
+                srcBlendNorm = 1.0;
+
+                if (!allChannelsFlag) {
+                    KoStreamedMathFunctions::clearPixel<8>(dst); // dstAlpha is already null
+                }
+            } else {
+                dstAlpha += (uint16Max - dstAlpha) * srcAlpha * uint16Rec1;
+                srcBlendNorm = srcAlpha / dstAlpha;
+            }
+
+            if(allChannelsFlag) {
+                if (srcBlendNorm == 1.0) {
+                    if (!alphaLocked) {
+                        KoStreamedMathFunctions::copyPixel<8>(src, dst);
+                    } else {
+                        d[0] = s[0];
+                        d[1] = s[1];
+                        d[2] = s[2];
+                    }
+                } else if (srcBlendNorm != 0.0){
+                    d[0] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[0], s[0], srcBlendNorm);
+                    d[1] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[1], s[1], srcBlendNorm);
+                    d[2] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[2], s[2], srcBlendNorm);
+                }
+            } else {
+                const QBitArray &channelFlags = oparams.channelFlags;
+
+                if (srcBlendNorm == 1.0) {
+                    if(channelFlags.at(0)) d[0] = s[0];
+                    if(channelFlags.at(1)) d[1] = s[1];
+                    if(channelFlags.at(2)) d[2] = s[2];
+                } else if (srcBlendNorm != 0.0) {
+                    if(channelFlags.at(0)) d[0] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[0], s[0], srcBlendNorm);
+                    if(channelFlags.at(1)) d[1] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[1], s[1], srcBlendNorm);
+                    if(channelFlags.at(2)) d[2] = KoStreamedMath<_impl>::lerp_mixed_u16_float(d[2], s[2], srcBlendNorm);
+                }
+            }
+
+            if (!alphaLocked) {
+                d[alpha_pos] = KoStreamedMath<_impl>::round_float_to_u16(dstAlpha);
+            }
+        }
+    }
+};
+
+/**
+ * An optimized version of a composite op for the use in 8 byte
+ * colorspaces with 16-bit channels and alpha channel placed at
+ * the last channel of the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpOver64(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, i18n("Normal"), KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor64<false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor64<true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor64<false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor64<true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPOVER64_H_
@@ -0,0 +1,750 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPSNEON_H
+#define KOOPTIMIZEDCOMPOSITEOPSNEON_H
+
+/**
+ * Vc doesn't support ARM, so on AArch64 the optimized composite ops are
+ * implemented with NEON intrinsics directly. The math follows the Vc
+ * compositors (OverCompositor32, AlphaDarkenCompositor32 and their 128-bit
+ * counterparts) line by line, processing four pixels per step.
+ *
+ * The vector arithmetic uses GCC/Clang vector extensions on the NEON
+ * types, so MSVC is not supported.
+ */
+#if defined(__aarch64__) && defined(__ARM_NEON) && !defined(_MSC_VER)
+#define HAVE_NEON_COMPOSITE_OPS
+#endif
+
+#ifdef HAVE_NEON_COMPOSITE_OPS
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include <QBitArray>
+#include <QScopedPointer>
+#include <klocalizedstring.h>
+
+#include <KoAlwaysInline.h>
+#include "KoCompositeOp.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoColorSpaceMaths.h"
+#include "KoColorSpaceTraits.h"
+#include "KoCompositeOpOver.h"
+#include "KoAlphaDarkenParamsWrapper.h"
+
+namespace KoNeonMath {
+
+static const int vectorSize = 4;
+
+static ALWAYS_INLINE bool isFull(uint32x4_t mask) {
+    return vminvq_u32(mask) == 0xFFFFFFFFu;
+}
+
+static ALWAYS_INLINE bool isEmpty(uint32x4_t mask) {
+    return vmaxvq_u32(mask) == 0;
+}
+
+static ALWAYS_INLINE quint8 roundFloatToUint(float value) {
+    return quint8(value + float(0.5));
+}
+
+static ALWAYS_INLINE quint8 lerpMixedU8Float(quint8 a, quint8 b, float alpha) {
+    return roundFloatToUint(qint16(b - a) * alpha + a);
+}
+
+/**
+ * Get a vector of four 8-bit mask values. The mask row may end right
+ * after the last pixel, so we cannot fetch more bytes than needed.
+ */
+static ALWAYS_INLINE float32x4_t fetchMask8(const quint8 *data) {
+    const uint32_t values[vectorSize] = {data[0], data[1], data[2], data[3]};
+    return vcvtq_f32_u32(vld1q_u32(values));
+}
+
+static ALWAYS_INLINE uint32x4_t load32(const quint8 *data) {
+    return vreinterpretq_u32_u8(vld1q_u8(data));
+}
+
+/**
+ * \see KoStreamedMath::fetch_alpha_32()
+ */
+static ALWAYS_INLINE float32x4_t fetchAlpha32(const quint8 *data) {
+    return vcvtq_f32_u32(vshrq_n_u32(load32(data), 24));
+}
+
+/**
+ * \see KoStreamedMath::fetch_colors_32()
+ */
+static ALWAYS_INLINE void fetchColors32(const quint8 *data,
+                                        float32x4_t &c1,
+                                        float32x4_t &c2,
+                                        float32x4_t &c3) {
+    const uint32x4_t pixels = load32(data);
+    const uint32x4_t lowByteMask = vdupq_n_u32(0xFF);
+
+    c1 = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(pixels, 16), lowByteMask));
+    c2 = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(pixels, 8), lowByteMask));
+    c3 = vcvtq_f32_u32(vandq_u32(pixels, lowByteMask));
+}
+
+/**
+ * \see KoStreamedMath::write_channels_32()
+ *
+ * vcvtnq rounds to the nearest integer and converts NaN values into
+ * zeroes, which is exactly what the compositors expect.
+ */
+static ALWAYS_INLINE void writeChannels32(quint8 *data,
+                                          float32x4_t alpha,
+                                          float32x4_t c1,
+                                          float32x4_t c2,
+                                          float32x4_t c3) {
+    const uint32x4_t lowByteMask = vdupq_n_u32(0xFF);
+
+    const uint32x4_t v1 = vshlq_n_u32(vcvtnq_u32_f32(alpha), 24);
+    const uint32x4_t v2 = vshlq_n_u32(vandq_u32(vcvtnq_u32_f32(c1), lowByteMask), 16);
+    const uint32x4_t v3 = vshlq_n_u32(vandq_u32(vcvtnq_u32_f32(c2), lowByteMask), 8);
+    const uint32x4_t v4 = vandq_u32(vcvtnq_u32_f32(c3), lowByteMask);
+
+    vst1q_u8(data, vreinterpretq_u8_u32(vorrq_u32(vorrq_u32(v1, v2), vorrq_u32(v3, v4))));
+}
+
+/**
+ * Composes src into dst processing four pixels per step, the rest of the
+ * row is processed by the scalar version of the compositor.
+ * \see KoStreamedMath::genericComposite()
+ */
+template<bool haveMask, class Compositor, int pixelSize>
+void genericCompositeImpl(const KoCompositeOp::ParameterInfo& params)
+{
+    const qint32 vectorInc = pixelSize * vectorSize;
+    qint32 srcVectorInc = vectorInc;
+    qint32 srcLinearInc = pixelSize;
+
+    quint8*       dstRowStart  = params.dstRowStart;
+    const quint8* maskRowStart = params.maskRowStart;
+    const quint8* srcRowStart  = params.srcRowStart;
+    typename Compositor::ParamsWrapper paramsWrapper(params);
+
+    quint8 replicatedSrc[vectorInc];
+
+    if (!params.srcRowStride) {
+        for (int i = 0; i < vectorSize; i++) {
+            memcpy(replicatedSrc + i * pixelSize, params.srcRowStart, pixelSize);
+        }
+
+        srcRowStart = replicatedSrc;
+        srcLinearInc = 0;
+        srcVectorInc = 0;
+    }
+
+    for (qint32 r = params.rows; r > 0; --r) {
+        const quint8 *mask = maskRowStart;
+        const quint8 *src  = srcRowStart;
+        quint8       *dst  = dstRowStart;
+
+        int columnsRemaining = params.cols;
+
+        for (; columnsRemaining >= vectorSize; columnsRemaining -= vectorSize) {
+            Compositor::template compositeVector<haveMask>(src, dst, mask, params.opacity, paramsWrapper);
+            src += srcVectorInc;
+            dst += vectorInc;
+
+            if (haveMask) {
+                mask += vectorSize;
+            }
+        }
+
+        for (; columnsRemaining > 0; columnsRemaining--) {
+            Compositor::template compositeOnePixelScalar<haveMask>(src, dst, mask, params.opacity, paramsWrapper);
+            src += srcLinearInc;
+            dst += pixelSize;
+
+            if (haveMask) {
+                mask++;
+            }
+        }
+
+        srcRowStart += params.srcRowStride;
+        dstRowStart += params.dstRowStride;
+
+        if (haveMask) {
+            maskRowStart += params.maskRowStride;
+        }
+    }
+}
+
+template<class Compositor>
+void genericComposite(const KoCompositeOp::ParameterInfo& params)
+{
+    if (params.maskRowStart) {
+        genericCompositeImpl<true, Compositor, Compositor::pixelSize>(params);
+    } else {
+        genericCompositeImpl<false, Compositor, Compositor::pixelSize>(params);
+    }
+}
+
+struct OverCompositor32 {
+    static const int pixelSize = 4;
+
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo&) {}
+    };
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper&)
+    {
+        const float32x4_t uint8Max = vdupq_n_f32(255.0f);
+        const float32x4_t uint8MaxRec1 = vdupq_n_f32(1.0f / 255.0f);
+        const float32x4_t zeroValue = vdupq_n_f32(0.0f);
+        const float32x4_t oneValue = vdupq_n_f32(1.0f);
+
+        const bool haveOpacity = opacity != 1.0f;
+
+        float32x4_t src_alpha = fetchAlpha32(src) * vdupq_n_f32(opacity);
+
+        if (haveMask) {
+            src_alpha = src_alpha * (fetchMask8(mask) * uint8MaxRec1);
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if (isFull(vceqq_f32(src_alpha, zeroValue))) {
+            return;
+        }
+
+        const float32x4_t dst_alpha = fetchAlpha32(dst);
+
+        float32x4_t src_c1, src_c2, src_c3;
+        float32x4_t dst_c1, dst_c2, dst_c3;
+
+        fetchColors32(src, src_c1, src_c2, src_c3);
+
+        float32x4_t src_blend;
+        float32x4_t new_alpha;
+
+        if (isFull(vceqq_f32(dst_alpha, uint8Max))) {
+            new_alpha = dst_alpha;
+            src_blend = src_alpha * uint8MaxRec1;
+        } else if (isFull(vceqq_f32(dst_alpha, zeroValue))) {
+            new_alpha = src_alpha;
+            src_blend = oneValue;
+        } else {
+            // the NaN values in the fully transparent pixels are
+            // converted into zeroes by writeChannels32()
+            new_alpha = dst_alpha + (uint8Max - dst_alpha) * src_alpha * uint8MaxRec1;
+            src_blend = vdivq_f32(src_alpha, new_alpha);
+        }
+
+        if (!isFull(vceqq_f32(src_blend, oneValue))) {
+            fetchColors32(dst, dst_c1, dst_c2, dst_c3);
+
+            dst_c1 = src_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = src_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
+        } else {
+            if (!haveMask && !haveOpacity) {
+                memcpy(dst, src, pixelSize * vectorSize);
+                return;
+            } else {
+                // opacity has changed the alpha of the source,
+                // so we can't just memcpy the bytes
+                dst_c1 = src_c1;
+                dst_c2 = src_c2;
+                dst_c3 = src_c3;
+            }
+        }
+
+        writeChannels32(dst, new_alpha, dst_c1, dst_c2, dst_c3);
+    }
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper&)
+    {
+        const qint32 alpha_pos = 3;
+
+        const float uint8Rec1 = 1.0 / 255.0;
+        const float uint8Max = 255.0;
+
+        float srcAlpha = src[alpha_pos];
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha == 0.0) return;
+
+        float dstAlpha = dst[alpha_pos];
+        float srcBlendNorm;
+
+        if (dstAlpha == uint8Max) {
+            srcBlendNorm = srcAlpha * uint8Rec1;
+        } else if (dstAlpha == 0.0) {
+            dstAlpha = srcAlpha;
+            srcBlendNorm = 1.0;
+        } else {
+            dstAlpha += (uint8Max - dstAlpha) * srcAlpha * uint8Rec1;
+            srcBlendNorm = srcAlpha / dstAlpha;
+        }
+
+        if (srcBlendNorm == 1.0) {
+            memcpy(dst, src, pixelSize);
+        } else if (srcBlendNorm != 0.0) {
+            dst[0] = lerpMixedU8Float(dst[0], src[0], srcBlendNorm);
+            dst[1] = lerpMixedU8Float(dst[1], src[1], srcBlendNorm);
+            dst[2] = lerpMixedU8Float(dst[2], src[2], srcBlendNorm);
+        }
+
+        dst[alpha_pos] = roundFloatToUint(dstAlpha);
+    }
+};
+
+template<class _ParamsWrapper>
+struct AlphaDarkenCompositor32 {
+    static const int pixelSize = 4;
+    using ParamsWrapper = _ParamsWrapper;
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        // we don't use directly passed value, instead we use
+        // value calculated by ParamsWrapper
+        Q_UNUSED(opacity);
+        opacity = oparams.opacity;
+
+        const float32x4_t opacity_vec = vdupq_n_f32(255.0f * opacity);
+        const float32x4_t average_opacity_vec = vdupq_n_f32(255.0f * oparams.averageOpacity);
+        const float32x4_t flow_norm_vec = vdupq_n_f32(oparams.flow);
+
+        const float32x4_t uint8MaxRec2 = vdupq_n_f32(1.0f / (255.0f * 255.0f));
+        const float32x4_t uint8MaxRec1 = vdupq_n_f32(1.0f / 255.0f);
+        const float32x4_t uint8Max = vdupq_n_f32(255.0f);
+        const float32x4_t zeroValue = vdupq_n_f32(0.0f);
+
+        float32x4_t src_alpha = fetchAlpha32(src);
+        float32x4_t msk_norm_alpha;
+
+        if (haveMask) {
+            msk_norm_alpha = src_alpha * fetchMask8(mask) * uint8MaxRec2;
+        } else {
+            msk_norm_alpha = src_alpha * uint8MaxRec1;
+        }
+
+        float32x4_t dst_alpha = fetchAlpha32(dst);
+        src_alpha = msk_norm_alpha * opacity_vec;
+
+        if (isFull(vceqq_f32(src_alpha, zeroValue))) return;
+
+        const uint32x4_t empty_dst_pixels_mask = vceqq_f32(dst_alpha, zeroValue);
+
+        float32x4_t src_c1, src_c2, src_c3;
+        float32x4_t dst_c1, dst_c2, dst_c3;
+
+        fetchColors32(src, src_c1, src_c2, src_c3);
+
+        const float32x4_t dst_blend = src_alpha * uint8MaxRec1;
+
+        if (isFull(empty_dst_pixels_mask)) {
+            dst_c1 = src_c1;
+            dst_c2 = src_c2;
+            dst_c3 = src_c3;
+        } else if (isFull(vceqq_f32(src_alpha, uint8Max))) {
+            if (isFull(vceqq_f32(dst_alpha, uint8Max))) {
+                memcpy(dst, src, pixelSize * vectorSize);
+                return;
+            } else {
+                dst_c1 = src_c1;
+                dst_c2 = src_c2;
+                dst_c3 = src_c3;
+            }
+        } else {
+            fetchColors32(dst, dst_c1, dst_c2, dst_c3);
+
+            dst_c1 = dst_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = dst_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = dst_blend * (src_c3 - dst_c3) + dst_c3;
+
+            if (!isEmpty(empty_dst_pixels_mask)) {
+                dst_c1 = vbslq_f32(empty_dst_pixels_mask, src_c1, dst_c1);
+                dst_c2 = vbslq_f32(empty_dst_pixels_mask, src_c2, dst_c2);
+                dst_c3 = vbslq_f32(empty_dst_pixels_mask, src_c3, dst_c3);
+            }
+        }
+
+        float32x4_t fullFlowAlpha;
+
+        if (oparams.averageOpacity > opacity) {
+            const uint32x4_t fullFlowAlpha_mask = vcgtq_f32(average_opacity_vec, dst_alpha);
+
+            if (isEmpty(fullFlowAlpha_mask)) {
+                fullFlowAlpha = dst_alpha;
+            } else {
+                const float32x4_t reverse_blend = vdivq_f32(dst_alpha, average_opacity_vec);
+                const float32x4_t opt1 = (average_opacity_vec - src_alpha) * reverse_blend + src_alpha;
+                fullFlowAlpha = vbslq_f32(fullFlowAlpha_mask, opt1, dst_alpha);
+            }
+        } else {
+            const uint32x4_t fullFlowAlpha_mask = vcgtq_f32(opacity_vec, dst_alpha);
+
+            if (isEmpty(fullFlowAlpha_mask)) {
+                fullFlowAlpha = dst_alpha;
+            } else {
+                const float32x4_t opt1 = (opacity_vec - dst_alpha) * msk_norm_alpha + dst_alpha;
+                fullFlowAlpha = vbslq_f32(fullFlowAlpha_mask, opt1, dst_alpha);
+            }
+        }
+
+        if (oparams.flow == 1.0f) {
+            dst_alpha = fullFlowAlpha;
+        } else {
+            const float32x4_t zeroFlowAlpha = ParamsWrapper::calculateZeroFlowAlpha(src_alpha, dst_alpha, uint8MaxRec1);
+            dst_alpha = (fullFlowAlpha - zeroFlowAlpha) * flow_norm_vec + zeroFlowAlpha;
+        }
+
+        writeChannels32(dst, dst_alpha, dst_c1, dst_c2, dst_c3);
+    }
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const float uint8Rec1 = 1.0 / 255.0;
+        const float uint8Rec2 = 1.0 / (255.0 * 255.0);
+        const float uint8Max = 255.0;
+
+        quint8 dstAlphaInt = dst[alpha_pos];
+        float dstAlphaNorm = dstAlphaInt ? dstAlphaInt * uint8Rec1 : 0.0;
+        float srcAlphaNorm;
+        float mskAlphaNorm;
+
+        Q_UNUSED(opacity);
+        opacity = oparams.opacity;
+
+        if (haveMask) {
+            mskAlphaNorm = float(*mask) * uint8Rec2 * src[alpha_pos];
+            srcAlphaNorm = mskAlphaNorm * opacity;
+        } else {
+            mskAlphaNorm = src[alpha_pos] * uint8Rec1;
+            srcAlphaNorm = mskAlphaNorm * opacity;
+        }
+
+        if (dstAlphaInt != 0) {
+            dst[0] = lerpMixedU8Float(dst[0], src[0], srcAlphaNorm);
+            dst[1] = lerpMixedU8Float(dst[1], src[1], srcAlphaNorm);
+            dst[2] = lerpMixedU8Float(dst[2], src[2], srcAlphaNorm);
+        } else {
+            memcpy(dst, src, pixelSize);
+        }
+
+        const float flow = oparams.flow;
+        const float averageOpacity = oparams.averageOpacity;
+
+        float fullFlowAlpha;
+
+        if (averageOpacity > opacity) {
+            fullFlowAlpha = averageOpacity > dstAlphaNorm ? lerp(srcAlphaNorm, averageOpacity, dstAlphaNorm / averageOpacity) : dstAlphaNorm;
+        } else {
+            fullFlowAlpha = opacity > dstAlphaNorm ? lerp(dstAlphaNorm, opacity, mskAlphaNorm) : dstAlphaNorm;
+        }
+
+        float dstAlpha;
+
+        if (flow == 1.0) {
+            dstAlpha = fullFlowAlpha * uint8Max;
+        } else {
+            float zeroFlowAlpha = ParamsWrapper::calculateZeroFlowAlpha(srcAlphaNorm, dstAlphaNorm);
+            dstAlpha = lerp(zeroFlowAlpha, fullFlowAlpha, flow) * uint8Max;
+        }
+
+        dst[alpha_pos] = roundFloatToUint(dstAlpha);
+    }
+};
+
+struct OverCompositor128 {
+    static const int pixelSize = 16;
+
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo&) {}
+    };
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper&)
+    {
+        const float32x4_t zeroValue = vdupq_n_f32(0.0f);
+        const float32x4_t oneValue = vdupq_n_f32(1.0f);
+
+        // deinterleaves four pixels into the channel vectors
+        const float32x4x4_t s = vld4q_f32(reinterpret_cast<const float*>(src));
+
+        float32x4_t src_alpha = s.val[3] * vdupq_n_f32(opacity);
+
+        if (haveMask) {
+            src_alpha = src_alpha * (fetchMask8(mask) * vdupq_n_f32(1.0f / 255.0f));
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if (isFull(vceqq_f32(src_alpha, zeroValue))) return;
+
+        float32x4x4_t d = vld4q_f32(reinterpret_cast<const float*>(dst));
+        const float32x4_t dst_alpha = d.val[3];
+
+        float32x4_t src_blend;
+        float32x4_t new_alpha;
+
+        if (isFull(vceqq_f32(dst_alpha, oneValue))) {
+            new_alpha = dst_alpha;
+            src_blend = src_alpha;
+        } else if (isFull(vceqq_f32(dst_alpha, zeroValue))) {
+            new_alpha = src_alpha;
+            src_blend = oneValue;
+        } else {
+            new_alpha = dst_alpha + (oneValue - dst_alpha) * src_alpha;
+            const uint32x4_t zeroAlphaMask = vceqq_f32(new_alpha, zeroValue);
+            src_blend = vbslq_f32(zeroAlphaMask, zeroValue, vdivq_f32(src_alpha, new_alpha));
+        }
+
+        if (!isFull(vceqq_f32(src_blend, oneValue))) {
+            d.val[0] = src_blend * (s.val[0] - d.val[0]) + d.val[0];
+            d.val[1] = src_blend * (s.val[1] - d.val[1]) + d.val[1];
+            d.val[2] = src_blend * (s.val[2] - d.val[2]) + d.val[2];
+        } else {
+            d.val[0] = s.val[0];
+            d.val[1] = s.val[1];
+            d.val[2] = s.val[2];
+        }
+
+        d.val[3] = new_alpha;
+        vst4q_f32(reinterpret_cast<float*>(dst), d);
+    }
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper&)
+    {
+        const qint32 alpha_pos = 3;
+
+        const float *s = reinterpret_cast<const float*>(src);
+        float *d = reinterpret_cast<float*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0 / 255;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha == 0.0f) return;
+
+        float dstAlpha = d[alpha_pos];
+        float srcBlendNorm;
+
+        if (dstAlpha == 1.0f) {
+            srcBlendNorm = srcAlpha;
+        } else if (dstAlpha == 0.0f) {
+            dstAlpha = srcAlpha;
+            srcBlendNorm = 1.0f;
+        } else {
+            dstAlpha += (1.0f - dstAlpha) * srcAlpha;
+            srcBlendNorm = srcAlpha / dstAlpha;
+        }
+
+        if (srcBlendNorm == 1.0f) {
+            memcpy(dst, src, pixelSize);
+        } else if (srcBlendNorm != 0.0f) {
+            d[0] = srcBlendNorm * (s[0] - d[0]) + d[0];
+            d[1] = srcBlendNorm * (s[1] - d[1]) + d[1];
+            d[2] = srcBlendNorm * (s[2] - d[2]) + d[2];
+        }
+
+        d[alpha_pos] = dstAlpha;
+    }
+};
+
+template<class _ParamsWrapper>
+struct AlphaDarkenCompositor128 {
+    static const int pixelSize = 16;
+    using ParamsWrapper = _ParamsWrapper;
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        const float32x4_t zeroValue = vdupq_n_f32(0.0f);
+
+        const float32x4x4_t s = vld4q_f32(reinterpret_cast<const float*>(src));
+
+        float32x4_t msk_norm_alpha;
+
+        if (haveMask) {
+            msk_norm_alpha = fetchMask8(mask) * vdupq_n_f32(1.0f / 255.0f) * s.val[3];
+        } else {
+            msk_norm_alpha = s.val[3];
+        }
+
+        // we don't use directly passed value, instead we use
+        // value calculated by ParamsWrapper
+        Q_UNUSED(opacity);
+        opacity = oparams.opacity;
+        const float32x4_t opacity_vec = vdupq_n_f32(opacity);
+
+        const float32x4_t src_alpha = msk_norm_alpha * opacity_vec;
+
+        float32x4x4_t d = vld4q_f32(reinterpret_cast<const float*>(dst));
+        const float32x4_t dst_alpha = d.val[3];
+
+        const uint32x4_t empty_dst_pixels_mask = vceqq_f32(dst_alpha, zeroValue);
+
+        if (!isFull(empty_dst_pixels_mask)) {
+            d.val[0] = (s.val[0] - d.val[0]) * src_alpha + d.val[0];
+            d.val[1] = (s.val[1] - d.val[1]) * src_alpha + d.val[1];
+            d.val[2] = (s.val[2] - d.val[2]) * src_alpha + d.val[2];
+
+            if (!isEmpty(empty_dst_pixels_mask)) {
+                d.val[0] = vbslq_f32(empty_dst_pixels_mask, s.val[0], d.val[0]);
+                d.val[1] = vbslq_f32(empty_dst_pixels_mask, s.val[1], d.val[1]);
+                d.val[2] = vbslq_f32(empty_dst_pixels_mask, s.val[2], d.val[2]);
+            }
+        } else {
+            d.val[0] = s.val[0];
+            d.val[1] = s.val[1];
+            d.val[2] = s.val[2];
+        }
+
+        float32x4_t fullFlowAlpha = dst_alpha;
+
+        if (oparams.averageOpacity > opacity) {
+            const float32x4_t average_opacity_vec = vdupq_n_f32(oparams.averageOpacity);
+            const uint32x4_t fullFlowAlpha_mask = vcgtq_f32(average_opacity_vec, dst_alpha);
+            const float32x4_t opt1 = (average_opacity_vec - src_alpha) * vdivq_f32(dst_alpha, average_opacity_vec) + src_alpha;
+            fullFlowAlpha = vbslq_f32(fullFlowAlpha_mask, opt1, dst_alpha);
+        } else {
+            const uint32x4_t fullFlowAlpha_mask = vcgtq_f32(opacity_vec, dst_alpha);
+            const float32x4_t opt1 = (opacity_vec - dst_alpha) * msk_norm_alpha + dst_alpha;
+            fullFlowAlpha = vbslq_f32(fullFlowAlpha_mask, opt1, dst_alpha);
+        }
+
+        if (oparams.flow == 1.0f) {
+            d.val[3] = fullFlowAlpha;
+        } else {
+            const float32x4_t zeroFlowAlpha = ParamsWrapper::calculateZeroFlowAlpha(src_alpha, dst_alpha);
+            d.val[3] = (fullFlowAlpha - zeroFlowAlpha) * vdupq_n_f32(oparams.flow) + zeroFlowAlpha;
+        }
+
+        vst4q_f32(reinterpret_cast<float*>(dst), d);
+    }
+
+    template<bool haveMask>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *s, quint8 *d, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const float *src = reinterpret_cast<const float*>(s);
+        float *dst = reinterpret_cast<float*>(d);
+
+        float dstAlphaNorm = dst[alpha_pos];
+
+        const float uint8Rec1 = 1.0 / 255.0;
+        float mskAlphaNorm = haveMask ? float(*mask) * uint8Rec1 * src[alpha_pos] : src[alpha_pos];
+
+        Q_UNUSED(opacity);
+        opacity = oparams.opacity;
+
+        float srcAlphaNorm = mskAlphaNorm * opacity;
+
+        if (dstAlphaNorm != 0) {
+            dst[0] = lerp(dst[0], src[0], srcAlphaNorm);
+            dst[1] = lerp(dst[1], src[1], srcAlphaNorm);
+            dst[2] = lerp(dst[2], src[2], srcAlphaNorm);
+        } else {
+            memcpy(d, s, pixelSize);
+        }
+
+        const float flow = oparams.flow;
+        const float averageOpacity = oparams.averageOpacity;
+
+        float fullFlowAlpha;
+
+        if (averageOpacity > opacity) {
+            fullFlowAlpha = averageOpacity > dstAlphaNorm ? lerp(srcAlphaNorm, averageOpacity, dstAlphaNorm / averageOpacity) : dstAlphaNorm;
+        } else {
+            fullFlowAlpha = opacity > dstAlphaNorm ? lerp(dstAlphaNorm, opacity, mskAlphaNorm) : dstAlphaNorm;
+        }
+
+        if (flow == 1.0) {
+            dst[alpha_pos] = fullFlowAlpha;
+        } else {
+            float zeroFlowAlpha = ParamsWrapper::calculateZeroFlowAlpha(srcAlphaNorm, dstAlphaNorm);
+            dst[alpha_pos] = lerp(zeroFlowAlpha, fullFlowAlpha, flow);
+        }
+    }
+};
+
+}
+
+/**
+ * The over op is vectorized for the case of all channels enabled only,
+ * other channel flags are passed to the generic implementation.
+ */
+template<class Traits, class Compositor>
+class KoOptimizedCompositeOpOverNeon : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpOverNeon(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, i18n("Normal"), KoCompositeOp::categoryMix()),
+          m_genericOp(new KoCompositeOpOver<Traits>(cs))
+    {
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoNeonMath::genericComposite<Compositor>(params);
+        } else {
+            m_genericOp->composite(params);
+        }
+    }
+
+private:
+    QScopedPointer<KoCompositeOp> m_genericOp;
+};
+
+template<class Compositor>
+class KoOptimizedCompositeOpAlphaDarkenNeon : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpAlphaDarkenNeon(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_ALPHA_DARKEN, i18n("Alpha darken"), KoCompositeOp::categoryMix())
+    {
+    }
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        KoNeonMath::genericComposite<Compositor>(params);
+    }
+};
+
+typedef KoOptimizedCompositeOpOverNeon<KoBgrU8Traits, KoNeonMath::OverCompositor32> KoOptimizedCompositeOpOver32Neon;
+typedef KoOptimizedCompositeOpOverNeon<KoRgbF32Traits, KoNeonMath::OverCompositor128> KoOptimizedCompositeOpOver128Neon;
+
+typedef KoOptimizedCompositeOpAlphaDarkenNeon<KoNeonMath::AlphaDarkenCompositor32<KoAlphaDarkenParamsWrapperHard>> KoOptimizedCompositeOpAlphaDarkenHard32Neon;
+typedef KoOptimizedCompositeOpAlphaDarkenNeon<KoNeonMath::AlphaDarkenCompositor32<KoAlphaDarkenParamsWrapperCreamy>> KoOptimizedCompositeOpAlphaDarkenCreamy32Neon;
+typedef KoOptimizedCompositeOpAlphaDarkenNeon<KoNeonMath::AlphaDarkenCompositor128<KoAlphaDarkenParamsWrapperHard>> KoOptimizedCompositeOpAlphaDarkenHard128Neon;
+typedef KoOptimizedCompositeOpAlphaDarkenNeon<KoNeonMath::AlphaDarkenCompositor128<KoAlphaDarkenParamsWrapperCreamy>> KoOptimizedCompositeOpAlphaDarkenCreamy128Neon;
+
+#endif /* HAVE_NEON_COMPOSITE_OPS */
+
+#endif // KOOPTIMIZEDCOMPOSITEOPSNEON_H
@@ -84,6 +84,12 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite_novector<useMask, useFlow, Compositor, 4>(params);
 }
 
+template<bool useMask, bool useFlow, class Compositor>
+    static void genericComposite64_novector(const KoCompositeOp::ParameterInfo& params)
+{
+    genericComposite_novector<useMask, useFlow, Compositor, 8>(params);
+}
+
 template<bool useMask, bool useFlow, class Compositor>
     static void genericComposite128_novector(const KoCompositeOp::ParameterInfo& params)
 {
@@ -196,6 +202,94 @@ static inline void write_channels_32(quint8 *data,
     (v1 | v3).store((quint32*)data, Vc::Aligned);
 }
 
+static inline quint16 round_float_to_u16(float value) {
+    return quint16(value + float(0.5));
+}
+
+static inline quint16 lerp_mixed_u16_float(quint16 a, quint16 b, float alpha) {
+    return round_float_to_u16(qint32(b - a) * alpha + a);
+}
+
+/**
+ * Get an alpha values from Vc::float_v::size() pixels 64-bit each
+ * (4 channels, 16 bit per channel). The alpha value is considered
+ * to be stored in the last channel of the pixel.
+ *
+ * Vc cannot load 16-bit channels into a float vector directly, so
+ * the channels are deinterleaved through a temporary buffer. The
+ * loop is simple enough for the compiler to vectorize it.
+ */
+static inline Vc::float_v fetch_alpha_64(const quint8 *data) {
+    const quint16 *pixels = reinterpret_cast<const quint16*>(data);
+
+    float alpha[Vc::float_v::size()];
+    for (size_t i = 0; i < Vc::float_v::size(); i++) {
+        alpha[i] = pixels[4 * i + 3];
+    }
+
+    return Vc::float_v(alpha, Vc::Unaligned);
+}
+
+/**
+ * Get color values from Vc::float_v::size() pixels 64-bit each
+ * (4 channels, 16 bit per channel). The color data is considered
+ * to be stored in the first three channels of the pixel.
+ */
+static inline void fetch_colors_64(const quint8 *data,
+                                   Vc::float_v &c1,
+                                   Vc::float_v &c2,
+                                   Vc::float_v &c3) {
+    const quint16 *pixels = reinterpret_cast<const quint16*>(data);
+
+    float buf1[Vc::float_v::size()];
+    float buf2[Vc::float_v::size()];
+    float buf3[Vc::float_v::size()];
+
+    for (size_t i = 0; i < Vc::float_v::size(); i++) {
+        buf1[i] = pixels[4 * i + 0];
+        buf2[i] = pixels[4 * i + 1];
+        buf3[i] = pixels[4 * i + 2];
+    }
+
+    c1.load(buf1, Vc::Unaligned);
+    c2.load(buf2, Vc::Unaligned);
+    c3.load(buf3, Vc::Unaligned);
+}
+
+/**
+ * Pack color and alpha values to Vc::float_v::size() pixels 64-bit each
+ * (4 channels, 16 bit per channel). The values are rounded and clamped
+ * into the range of the channel.
+ */
+static inline void write_channels_64(quint8 *data,
+                                     Vc::float_v::AsArg alpha,
+                                     Vc::float_v::AsArg c1,
+                                     Vc::float_v::AsArg c2,
+                                     Vc::float_v::AsArg c3) {
+
+    const Vc::float_v zeroValue(Vc::Zero);
+    const Vc::float_v uint16Max(65535.0f);
+
+    float bufA[Vc::float_v::size()];
+    float buf1[Vc::float_v::size()];
+    float buf2[Vc::float_v::size()];
+    float buf3[Vc::float_v::size()];
+
+    Vc::max(Vc::min(alpha, uint16Max), zeroValue).store(bufA, Vc::Unaligned);
+    Vc::max(Vc::min(c1, uint16Max), zeroValue).store(buf1, Vc::Unaligned);
+    Vc::max(Vc::min(c2, uint16Max), zeroValue).store(buf2, Vc::Unaligned);
+    Vc::max(Vc::min(c3, uint16Max), zeroValue).store(buf3, Vc::Unaligned);
+
+    quint16 *pixels = reinterpret_cast<quint16*>(data);
+
+    for (size_t i = 0; i < Vc::float_v::size(); i++) {
+        pixels[4 * i + 0] = round_float_to_u16(buf1[i]);
+        pixels[4 * i + 1] = round_float_to_u16(buf2[i]);
+        pixels[4 * i + 2] = round_float_to_u16(buf3[i]);
+        pixels[4 * i + 3] = round_float_to_u16(bufA[i]);
+    }
+}
+
 /**
  * Composes src pixels into dst pixles. Is optimized for 32-bit-per-pixel
  * colorspaces. Uses \p Compositor strategy parameter for doing actual
@@ -363,6 +457,12 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite<useMask, useFlow, Compositor, 4>(params);
 }
 
+template<bool useMask, bool useFlow, class Compositor>
+    static void genericComposite64(const KoCompositeOp::ParameterInfo& params)
+{
+    genericComposite<useMask, useFlow, Compositor, 8>(params);
+}
+
 template<bool useMask, bool useFlow, class Compositor>
     static void genericComposite128(const KoCompositeOp::ParameterInfo& params)
 {
@@ -383,6 +483,13 @@ ALWAYS_INLINE void clearPixel<4>(quint8* dst)
     *d = 0;
 }
 
+template<>
+ALWAYS_INLINE void clearPixel<8>(quint8* dst)
+{
+    quint64 *d = reinterpret_cast<quint64*>(dst);
+    *d = 0;
+}
+
 template<>
 ALWAYS_INLINE void clearPixel<16>(quint8* dst)
 {
@@ -402,6 +509,14 @@ ALWAYS_INLINE void copyPixel<4>(const quint8 *src, quint8* dst)
     *d = *s;
 }
 
+template<>
+ALWAYS_INLINE void copyPixel<8>(const quint8 *src, quint8* dst)
+{
+    const quint64 *s = reinterpret_cast<const quint64*>(src);
+    quint64 *d = reinterpret_cast<quint64*>(dst);
+    *d = *s;
+}
+
 template<>
 ALWAYS_INLINE void copyPixel<16>(const quint8 *src, quint8* dst)
 {
@@ -6,10 +6,13 @@
 
 #include "KoColorSpaceAbstract.h"
 #include "KoColorSpaceTraits.h"
+#include "KoOptimizedMixColorsOpFactory.h"
+#include "KoColorModelStandardIds.h"
 
 #include <cfloat>
 
 #include <QTest>
+#include <QRandomGenerator>
 
 template <class T>
 T mixOpExpectedAlpha(T alpha1, T alpha2, const qint16 *weights)
@@ -398,5 +401,107 @@ void TestKoColorSpaceAbstract::testMixColorsOpU8NoAlphaLinear()
     QCOMPARE(outputPixel[COLOR_CHANNEL_2], mixOpNoAlphaExpectedColor(pixel1[COLOR_CHANNEL_2], pixel2[COLOR_CHANNEL_2], weights));
 }
 
+template <typename channel_type>
+channel_type randomChannelValue(QRandomGenerator &generator);
+
+template <>
+quint8 randomChannelValue<quint8>(QRandomGenerator &generator)
+{
+    return generator.bounded(256);
+}
+
+template <>
+quint16 randomChannelValue<quint16>(QRandomGenerator &generator)
+{
+    return generator.bounded(65536);
+}
+
+template <>
+float randomChannelValue<float>(QRandomGenerator &generator)
+{
+    return float(generator.generateDouble());
+}
+
+template <typename channel_type>
+void compareOptimizedMixColorsOp(const KoID &depthId, int numPixels)
+{
+    typedef KoColorSpaceTrait<channel_type, 4, 3> Traits;
+
+    QScopedPointer<KoMixColorsOp> optimizedOp(KoOptimizedMixColorsOpFactory::create(depthId, 4, 3));
+    QVERIFY(optimizedOp);
+
+    KoMixColorsOpImpl<Traits> referenceOp;
+
+    QRandomGenerator generator(1234);
+
+    QVector<channel_type> pixels(numPixels * 4);
+    for (int i = 0; i < pixels.size(); i++) {
+        pixels[i] = randomChannelValue<channel_type>(generator);
+    }
+
+    QVector<qint16> weights(numPixels);
+    int weightSum = 0;
+    for (int i = 0; i < numPixels; i++) {
+        weights[i] = generator.bounded(256);
+        weightSum += weights[i];
+    }
+
+    const quint8 *colors = reinterpret_cast<const quint8*>(pixels.constData());
+
+    channel_type expected[4];
+    channel_type result[4];
+
+    const channel_type precision =
+        std::is_floating_point<channel_type>::value ? channel_type(1e-5) : channel_type(0);
+
+    auto compareResult = [&] () {
+        for (int ch = 0; ch < 4; ch++) {
+            if (qAbs(result[ch] - expected[ch]) > precision) {
+                qDebug() << "channel" << ch << "result" << double(result[ch]) << "expected" << double(expected[ch]);
+                return false;
+            }
+        }
+        return true;
+    };
+
+    referenceOp.mixColors(colors, weights.constData(), numPixels,
+                          reinterpret_cast<quint8*>(expected), weightSum);
+    optimizedOp->mixColors(colors, weights.constData(), numPixels,
+                           reinterpret_cast<quint8*>(result), weightSum);
+    QVERIFY(compareResult());
+
+    referenceOp.mixColors(colors, numPixels, reinterpret_cast<quint8*>(expected));
+    optimizedOp->mixColors(colors, numPixels, reinterpret_cast<quint8*>(result));
+    QVERIFY(compareResult());
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<int>("numPixels");
+
+    // the odd sizes check the pixels that don't fill a whole vector,
+    // the 8-bit totals overflow with more than 128 opaque pixels
+    QTest::newRow("u8-small") << Integer8BitsColorDepthID.id() << 3;
+    QTest::newRow("u8") << Integer8BitsColorDepthID.id() << 101;
+    QTest::newRow("u16-small") << Integer16BitsColorDepthID.id() << 3;
+    QTest::newRow("u16") << Integer16BitsColorDepthID.id() << 1031;
+    QTest::newRow("f32-small") << Float32BitsColorDepthID.id() << 3;
+    QTest::newRow("f32") << Float32BitsColorDepthID.id() << 1031;
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp()
+{
+    QFETCH(QString, depthId);
+    QFETCH(int, numPixels);
+
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        compareOptimizedMixColorsOp<quint8>(Integer8BitsColorDepthID, numPixels);
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        compareOptimizedMixColorsOp<quint16>(Integer16BitsColorDepthID, numPixels);
+    } else {
+        compareOptimizedMixColorsOp<float>(Float32BitsColorDepthID, numPixels);
+    }
+}
 
 QTEST_GUILESS_MAIN(TestKoColorSpaceAbstract)
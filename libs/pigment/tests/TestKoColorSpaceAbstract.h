@@ -15,6 +15,8 @@ private Q_SLOTS:
     void testMixColorsOpF32();
     void testMixColorsOpU8NoAlpha();
     void testMixColorsOpU8NoAlphaLinear();
+    void testOptimizedMixColorsOp_data();
+    void testOptimizedMixColorsOp();
 };
 
 #endif
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "TestKoLut3DColorConversionTransformation.h"
+
+#include <QTest>
+#include <QRandomGenerator>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoLut3DColorConversionTransformation.h>
+
+namespace {
+
+KoColorConversionTransformation* createConverter(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    return srcCs->createColorConverter(dstCs,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+}
+
+template <typename channel_type>
+int maxDifference(const QByteArray &a, const QByteArray &b)
+{
+    const channel_type *pa = reinterpret_cast<const channel_type*>(a.constData());
+    const channel_type *pb = reinterpret_cast<const channel_type*>(b.constData());
+    const int numChannels = a.size() / sizeof(channel_type);
+
+    int result = 0;
+    for (int i = 0; i < numChannels; i++) {
+        result = qMax(result, qAbs(int(pa[i]) - int(pb[i])));
+    }
+    return result;
+}
+
+}
+
+void TestKoLut3DColorConversionTransformation::testUnsupported()
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *lab16 = KoColorSpaceRegistry::instance()->lab16();
+
+    QVERIFY(!KoLut3DColorConversionTransformation::isSupported(rgb8, lab16));
+    QVERIFY(!KoLut3DColorConversionTransformation::isSupported(lab16, rgb8));
+
+    QScopedPointer<KoColorConversionTransformation> transform(createConverter(rgb8, lab16));
+    QVERIFY(!KoLut3DColorConversionTransformation::create(transform.data(), KoLut3DColorConversionTransformation::FastGridSize));
+}
+
+void TestKoLut3DColorConversionTransformation::testConversion_data()
+{
+    QTest::addColumn<bool>("dstIs16Bit");
+    QTest::addColumn<int>("gridSize");
+    QTest::addColumn<int>("tolerance");
+
+    QTest::newRow("u8-fast") << false << int(KoLut3DColorConversionTransformation::FastGridSize) << 2;
+    QTest::newRow("u8-accurate") << false << int(KoLut3DColorConversionTransformation::AccurateGridSize) << 1;
+    QTest::newRow("u16-fast") << true << int(KoLut3DColorConversionTransformation::FastGridSize) << 2 * 257;
+    QTest::newRow("u16-accurate") << true << int(KoLut3DColorConversionTransformation::AccurateGridSize) << 257;
+}
+
+void TestKoLut3DColorConversionTransformation::testConversion()
+{
+    QFETCH(bool, dstIs16Bit);
+    QFETCH(int, gridSize);
+    QFETCH(int, tolerance);
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCs = dstIs16Bit ?
+        KoColorSpaceRegistry::instance()->rgb16() :
+        KoColorSpaceRegistry::instance()->rgb8();
+
+    QScopedPointer<KoColorConversionTransformation> transform(createConverter(srcCs, dstCs));
+    QScopedPointer<KoLut3DColorConversionTransformation> lut(
+        KoLut3DColorConversionTransformation::create(transform.data(), gridSize));
+
+    QVERIFY(lut);
+    QCOMPARE(lut->gridSize(), gridSize);
+    QCOMPARE(lut->srcColorSpace(), srcCs);
+    QCOMPARE(lut->dstColorSpace(), dstCs);
+
+    const int numPixels = 1000;
+
+    QByteArray src(numPixels * srcCs->pixelSize(), 0);
+    QRandomGenerator generator(1234);
+    for (int i = 0; i < src.size(); i++) {
+        src[i] = char(generator.bounded(256));
+    }
+
+    QByteArray dstExp(numPixels * dstCs->pixelSize(), 0);
+    QByteArray dstAct(numPixels * dstCs->pixelSize(), 0);
+
+    transform->transform(reinterpret_cast<const quint8*>(src.constData()),
+                         reinterpret_cast<quint8*>(dstExp.data()), numPixels);
+    lut->transform(reinterpret_cast<const quint8*>(src.constData()),
+                   reinterpret_cast<quint8*>(dstAct.data()), numPixels);
+
+    const int difference = dstIs16Bit ?
+        maxDifference<quint16>(dstAct, dstExp) :
+        maxDifference<quint8>(dstAct, dstExp);
+
+    QVERIFY2(difference <= tolerance, QString("difference: %1").arg(difference).toLatin1());
+}
+
+QTEST_GUILESS_MAIN(TestKoLut3DColorConversionTransformation)
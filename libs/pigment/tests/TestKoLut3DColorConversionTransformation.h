@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef TESTKOLUT3DCOLORCONVERSIONTRANSFORMATION_H
+#define TESTKOLUT3DCOLORCONVERSIONTRANSFORMATION_H
+
+#include <QObject>
+
+class TestKoLut3DColorConversionTransformation : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testUnsupported();
+    void testConversion_data();
+    void testConversion();
+};
+
+#endif
@@ -0,0 +1,483 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "TestKoOptimizedCompositeOps.h"
+
+#include <QTest>
+#include <QBitArray>
+#include <QRandomGenerator>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorSpaceTraits.h>
+#include <KoCompositeOp.h>
+#include <KoCompositeOpOver.h>
+#include <KoCompositeOpAlphaDarken.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpRegistry.h>
+#include <KoAlphaDarkenParamsWrapper.h>
+#include <KoOptimizedCompositeOpFactory.h>
+
+#include <kis_debug.h>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+namespace {
+
+/**
+ * The number of columns is deliberately not a multiple of the vector
+ * size, so that both the vectorized body and the scalar tail of the
+ * optimized ops are exercised
+ */
+const int numColumns = 37;
+const int numRows = 5;
+
+template <typename channel_type>
+void fillRandom(QVector<channel_type> &data, QRandomGenerator &generator);
+
+template <>
+void fillRandom(QVector<quint8> &data, QRandomGenerator &generator)
+{
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = generator.bounded(256);
+    }
+}
+
+template <>
+void fillRandom(QVector<quint16> &data, QRandomGenerator &generator)
+{
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = generator.bounded(65536);
+    }
+}
+
+template <>
+void fillRandom(QVector<float> &data, QRandomGenerator &generator)
+{
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = float(generator.generateDouble());
+    }
+}
+
+#ifdef HAVE_OPENEXR
+template <>
+void fillRandom(QVector<half> &data, QRandomGenerator &generator)
+{
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = half(float(generator.generateDouble()));
+    }
+}
+#endif
+
+inline bool fuzzyCompare(quint8 a, quint8 b, quint8 prec) {
+    return qAbs(int(a) - int(b)) <= prec;
+}
+
+inline bool fuzzyCompare(quint16 a, quint16 b, quint16 prec) {
+    return qAbs(int(a) - int(b)) <= prec;
+}
+
+inline bool fuzzyCompare(float a, float b, float prec) {
+    return qAbs(a - b) <= prec;
+}
+
+#ifdef HAVE_OPENEXR
+inline bool fuzzyCompare(half a, half b, half prec) {
+    return qAbs(float(a) - float(b)) <= float(prec);
+}
+#endif
+
+/**
+ * The colors of the pixels with alpha lower than \p minColorAlpha are
+ * not compared, the integer generic ops lose precision there
+ */
+template <typename channel_type>
+bool compareOps(const KoCompositeOp *opAct, const KoCompositeOp *opExp,
+                bool haveMask, qreal opacity, qreal flow, channel_type prec,
+                channel_type minColorAlpha = channel_type(0),
+                const QBitArray &channelFlags = QBitArray())
+{
+    const int pixelSize = 4 * sizeof(channel_type);
+    KIS_ASSERT(opAct->colorSpace()->pixelSize() == quint32(pixelSize));
+
+    QRandomGenerator generator(1234);
+
+    QVector<channel_type> src(4 * numColumns * numRows);
+    QVector<channel_type> dst(4 * numColumns * numRows);
+    QVector<quint8> mask(numColumns * numRows);
+
+    fillRandom(src, generator);
+    fillRandom(dst, generator);
+    fillRandom(mask, generator);
+
+    /**
+     * Make sure the transparent destination pixels are covered
+     */
+    for (int i = 0; i < numColumns * numRows; i += 7) {
+        dst[4 * i + 3] = channel_type(0);
+    }
+
+    QVector<channel_type> dstAct = dst;
+    QVector<channel_type> dstExp = dst;
+
+    const float lastOpacity = 0.8f;
+
+    KoCompositeOp::ParameterInfo params;
+    params.srcRowStart   = reinterpret_cast<quint8*>(src.data());
+    params.srcRowStride  = numColumns * pixelSize;
+    params.maskRowStart  = haveMask ? mask.data() : 0;
+    params.maskRowStride = numColumns;
+    params.dstRowStride  = numColumns * pixelSize;
+    params.rows          = numRows;
+    params.cols          = numColumns;
+    params.opacity       = opacity;
+    params.flow          = flow;
+    params.lastOpacity   = &lastOpacity;
+    params.channelFlags  = channelFlags;
+
+    params.dstRowStart = reinterpret_cast<quint8*>(dstAct.data());
+    opAct->composite(params);
+
+    params.dstRowStart = reinterpret_cast<quint8*>(dstExp.data());
+    opExp->composite(params);
+
+    for (int i = 0; i < numColumns * numRows; i++) {
+        const channel_type *act = dstAct.constData() + 4 * i;
+        const channel_type *exp = dstExp.constData() + 4 * i;
+
+        const bool bothTransparent = act[3] == channel_type(0) && exp[3] == channel_type(0);
+        const bool compareColors = !bothTransparent && exp[3] >= minColorAlpha;
+
+        if (!fuzzyCompare(act[3], exp[3], prec) ||
+            (compareColors &&
+             !(fuzzyCompare(act[0], exp[0], prec) &&
+               fuzzyCompare(act[1], exp[1], prec) &&
+               fuzzyCompare(act[2], exp[2], prec)))) {
+
+            qDebug() << "Wrong result:" << i;
+            qDebug() << "Act: " << act[0] << act[1] << act[2] << act[3];
+            qDebug() << "Exp: " << exp[0] << exp[1] << exp[2] << exp[3];
+            return false;
+        }
+    }
+
+    return true;
+}
+
+KoCompositeOp* createGenericSCOp32(const KoColorSpace *cs, const QString &id)
+{
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfMultiply<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfScreen<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfDarkenOnly<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfLightenOnly<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfDifference<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfAddition<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfSubtract<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfHardLight<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfOverlay<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfSoftLight<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_SOFT_LIGHT_SVG) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfSoftLightSvg<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfColorDodge<quint8>>(cs, id, QString(), QString());
+    } else if (id == COMPOSITE_BURN) {
+        return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfColorBurn<quint8>>(cs, id, QString(), QString());
+    }
+
+    return 0;
+}
+
+}
+
+void TestKoOptimizedCompositeOps::testOver32()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOp32(cs));
+    QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoBgrU8Traits>(cs));
+
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), false, 1.0, 1.0, 10));
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), true, 1.0, 1.0, 10));
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), false, 0.5, 1.0, 10));
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), true, 0.5, 1.0, 10));
+}
+
+void TestKoOptimizedCompositeOps::testOverChannelFlags_data()
+{
+    QTest::addColumn<QBitArray>("channelFlags");
+    QTest::addColumn<bool>("haveMask");
+    QTest::addColumn<qreal>("opacity");
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+
+    QBitArray firstChannelDisabled(4, true);
+    firstChannelDisabled.clearBit(0);
+
+    QBitArray bothDisabled = alphaLocked & firstChannelDisabled;
+
+    QTest::newRow("alpha-locked") << alphaLocked << false << 1.0;
+    QTest::newRow("alpha-locked-mask") << alphaLocked << true << 0.5;
+    QTest::newRow("channel-disabled") << firstChannelDisabled << false << 1.0;
+    QTest::newRow("channel-disabled-mask") << firstChannelDisabled << true << 0.5;
+    QTest::newRow("both") << bothDisabled << false << 1.0;
+    QTest::newRow("both-mask") << bothDisabled << true << 0.5;
+}
+
+void TestKoOptimizedCompositeOps::testOverChannelFlags()
+{
+    QFETCH(QBitArray, channelFlags);
+    QFETCH(bool, haveMask);
+    QFETCH(qreal, opacity);
+
+    {
+        const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOp32(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoBgrU8Traits>(cs));
+        QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), haveMask, opacity, 1.0, 10, 0, channelFlags));
+    }
+
+    {
+        const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOp64(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoBgrU16Traits>(cs));
+        QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), haveMask, opacity, 1.0, 5, 256, channelFlags));
+    }
+
+    {
+        const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+        QVERIFY(cs);
+
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOp128(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoRgbF32Traits>(cs));
+        QVERIFY(compareOps<float>(opAct.data(), opExp.data(), haveMask, opacity, 1.0, 1e-5f, 0.0f, channelFlags));
+    }
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarken32_data()
+{
+    QTest::addColumn<bool>("haveMask");
+    QTest::addColumn<qreal>("opacity");
+    QTest::addColumn<qreal>("flow");
+
+    QTest::newRow("no-mask") << false << 1.0 << 1.0;
+    QTest::newRow("mask") << true << 1.0 << 1.0;
+    QTest::newRow("opacity") << true << 0.5 << 1.0;
+    QTest::newRow("flow") << true << 1.0 << 0.3;
+    QTest::newRow("opacity-flow") << false << 0.5 << 0.3;
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarken32()
+{
+    QFETCH(bool, haveMask);
+    QFETCH(qreal, opacity);
+    QFETCH(qreal, flow);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoBgrU8Traits, KoAlphaDarkenParamsWrapperHard>(cs));
+        QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), haveMask, opacity, flow, 10));
+    }
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy32(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoBgrU8Traits, KoAlphaDarkenParamsWrapperCreamy>(cs));
+        QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), haveMask, opacity, flow, 10));
+    }
+}
+
+void TestKoOptimizedCompositeOps::testOver64()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOp64(cs));
+    QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoBgrU16Traits>(cs));
+
+    QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), false, 1.0, 1.0, 5));
+    QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), true, 1.0, 1.0, 5));
+    QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), false, 0.5, 1.0, 5, 256));
+    QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), true, 0.5, 1.0, 5, 256));
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarken64_data()
+{
+    testAlphaDarken32_data();
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarken64()
+{
+    QFETCH(bool, haveMask);
+    QFETCH(qreal, opacity);
+    QFETCH(qreal, flow);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard64(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperHard>(cs));
+        QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), haveMask, opacity, flow, 5, 256));
+    }
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy64(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs));
+        QVERIFY(compareOps<quint16>(opAct.data(), opExp.data(), haveMask, opacity, flow, 5, 256));
+    }
+}
+
+void TestKoOptimizedCompositeOps::testOver128()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    QVERIFY(cs);
+
+    QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOp128(cs));
+    QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoRgbF32Traits>(cs));
+
+    QVERIFY(compareOps<float>(opAct.data(), opExp.data(), false, 1.0, 1.0, 1e-5));
+    QVERIFY(compareOps<float>(opAct.data(), opExp.data(), true, 1.0, 1.0, 1e-5));
+    QVERIFY(compareOps<float>(opAct.data(), opExp.data(), false, 0.5, 1.0, 1e-5));
+    QVERIFY(compareOps<float>(opAct.data(), opExp.data(), true, 0.5, 1.0, 1e-5));
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarken128_data()
+{
+    testAlphaDarken32_data();
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarken128()
+{
+    QFETCH(bool, haveMask);
+    QFETCH(qreal, opacity);
+    QFETCH(qreal, flow);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    QVERIFY(cs);
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard128(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoRgbF32Traits, KoAlphaDarkenParamsWrapperHard>(cs));
+        QVERIFY(compareOps<float>(opAct.data(), opExp.data(), haveMask, opacity, flow, 1e-5));
+    }
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy128(cs));
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoRgbF32Traits, KoAlphaDarkenParamsWrapperCreamy>(cs));
+        QVERIFY(compareOps<float>(opAct.data(), opExp.data(), haveMask, opacity, flow, 1e-5));
+    }
+}
+
+void TestKoOptimizedCompositeOps::testOverF16()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    QVERIFY(cs);
+
+    QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createOverOpF16(cs));
+    if (!opAct) {
+        QSKIP("No hardware half conversion available");
+    }
+    QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpOver<KoRgbF16Traits>(cs));
+
+    const half prec(5e-3f);
+
+    QVERIFY(compareOps<half>(opAct.data(), opExp.data(), false, 1.0, 1.0, prec));
+    QVERIFY(compareOps<half>(opAct.data(), opExp.data(), true, 1.0, 1.0, prec));
+    QVERIFY(compareOps<half>(opAct.data(), opExp.data(), false, 0.5, 1.0, prec));
+    QVERIFY(compareOps<half>(opAct.data(), opExp.data(), true, 0.5, 1.0, prec));
+#else
+    QSKIP("Krita is built without OpenEXR");
+#endif
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarkenF16_data()
+{
+    testAlphaDarken32_data();
+}
+
+void TestKoOptimizedCompositeOps::testAlphaDarkenF16()
+{
+#ifdef HAVE_OPENEXR
+    QFETCH(bool, haveMask);
+    QFETCH(qreal, opacity);
+    QFETCH(qreal, flow);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    QVERIFY(cs);
+
+    const half prec(5e-3f);
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(cs));
+        if (!opAct) {
+            QSKIP("No hardware half conversion available");
+        }
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(cs));
+        QVERIFY(compareOps<half>(opAct.data(), opExp.data(), haveMask, opacity, flow, prec));
+    }
+
+    {
+        QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs));
+        QVERIFY(opAct);
+        QScopedPointer<KoCompositeOp> opExp(new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs));
+        QVERIFY(compareOps<half>(opAct.data(), opExp.data(), haveMask, opacity, flow, prec));
+    }
+#else
+    QSKIP("Krita is built without OpenEXR");
+#endif
+}
+
+void TestKoOptimizedCompositeOps::testGenericSC32_data()
+{
+    QTest::addColumn<QString>("id");
+
+    QTest::newRow("multiply") << COMPOSITE_MULT;
+    QTest::newRow("screen") << COMPOSITE_SCREEN;
+    QTest::newRow("darken") << COMPOSITE_DARKEN;
+    QTest::newRow("lighten") << COMPOSITE_LIGHTEN;
+    QTest::newRow("difference") << COMPOSITE_DIFF;
+    QTest::newRow("addition") << COMPOSITE_ADD;
+    QTest::newRow("subtract") << COMPOSITE_SUBTRACT;
+    QTest::newRow("hard-light") << COMPOSITE_HARD_LIGHT;
+    QTest::newRow("overlay") << COMPOSITE_OVERLAY;
+    QTest::newRow("soft-light") << COMPOSITE_SOFT_LIGHT_PHOTOSHOP;
+    QTest::newRow("soft-light-svg") << COMPOSITE_SOFT_LIGHT_SVG;
+    QTest::newRow("color-dodge") << COMPOSITE_DODGE;
+    QTest::newRow("color-burn") << COMPOSITE_BURN;
+}
+
+void TestKoOptimizedCompositeOps::testGenericSC32()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QScopedPointer<KoCompositeOp> opAct(KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, QString(), QString()));
+    if (!opAct) {
+        QSKIP("No optimized implementation on this architecture");
+    }
+
+    QScopedPointer<KoCompositeOp> opExp(createGenericSCOp32(cs, id));
+    QVERIFY(opExp);
+
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), false, 1.0, 1.0, 10, 64));
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), true, 1.0, 1.0, 10, 64));
+    QVERIFY(compareOps<quint8>(opAct.data(), opExp.data(), true, 0.5, 1.0, 10, 64));
+}
+
+QTEST_GUILESS_MAIN(TestKoOptimizedCompositeOps)
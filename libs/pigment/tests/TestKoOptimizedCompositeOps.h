@@ -0,0 +1,34 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef TESTKOOPTIMIZEDCOMPOSITEOPS_H
+#define TESTKOOPTIMIZEDCOMPOSITEOPS_H
+
+#include <QObject>
+
+class TestKoOptimizedCompositeOps : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testOver32();
+    void testOverChannelFlags_data();
+    void testOverChannelFlags();
+    void testAlphaDarken32_data();
+    void testAlphaDarken32();
+    void testOver64();
+    void testAlphaDarken64_data();
+    void testAlphaDarken64();
+    void testOver128();
+    void testAlphaDarken128_data();
+    void testAlphaDarken128();
+    void testOverF16();
+    void testAlphaDarkenF16_data();
+    void testAlphaDarkenF16();
+    void testGenericSC32_data();
+    void testGenericSC32();
+};
+
+#endif
@@ -6,20 +6,24 @@
  */
 #include "compression.h"
 
+#include <cstring>
 #include <QBuffer>
 #include "psd_utils.h"
 #include "kis_debug.h"
 #include <QtEndian>
 
 // from gimp's psd-save.c
-static quint32 pack_pb_line (const QByteArray &src,
-                             QByteArray &dst)
+static quint32 pack_pb_line (const char *start, quint32 length,
+                             char *dst)
 {
-    quint32 length = src.size();
+    /**
+     * The caller guarantees that \p dst can hold the worst case, which
+     * is a header byte per every source byte, so the packed bytes are
+     * written directly without any bounds checks
+     */
     quint32 remaining = length;
-    quint8  i, j;
+    quint8  i;
     quint32 dest_ptr = 0;
-    const char *start = src.constData();
 
     length = 0;
     while (remaining > 0)
@@ -61,10 +65,8 @@ static quint32 pack_pb_line (const QByteArray &src,
             if (i > 0)               /* Some distinct ones found */
             {
                 dst[dest_ptr++] = i - 1;
-                for (j = 0; j < i; j++)
-                {
-                    dst[dest_ptr++] = start[j];
-                }
+                memcpy(dst + dest_ptr, start, i);
+                dest_ptr += i;
                 start += i;
                 remaining -= i;
                 length += i + 1;
@@ -81,9 +83,12 @@ quint32 decode_packbits(const char *src, char* dst, quint16 packed_len, quint32
 {
     /*
      *  Decode a PackBits chunk.
+     *
+     *  The runs are filled and copied with memset() and memcpy(),
+     *  which are vectorized, instead of going byte by byte.
      */
     qint32    n;
-    char      dat;
+    qint32    count;
     qint32    unpack_left = unpacked_len;
     qint32    pack_left = packed_len;
     qint32    error_code = 0;
@@ -114,15 +119,11 @@ quint32 decode_packbits(const char *src, char* dst, quint16 packed_len, quint32
                 dbgFile << "Overrun in packbits replicate of" << n - unpack_left << "chars";
                 error_code = 2;
             }
-            dat = *src;
-            for (; n > 0; --n)
-            {
-                if (! unpack_left)
-                    break;
-                *dst = dat;
-                dst++;
-                unpack_left--;
-            }
+            count = qMin(n, unpack_left);
+            memset(dst, *src, count);
+            dst += count;
+            unpack_left -= count;
+
             if (unpack_left)
             {
                 src++;
@@ -132,25 +133,25 @@ quint32 decode_packbits(const char *src, char* dst, quint16 packed_len, quint32
         else              /* copy next n+1 gchars literally */
         {
             n++;
-            for (; n > 0; --n)
+            count = qMin(n, qMin(pack_left, unpack_left));
+            memcpy(dst, src, count);
+            dst += count;
+            src += count;
+            unpack_left -= count;
+            pack_left -= count;
+
+            if (count < n)
             {
                 if (! pack_left)
                 {
                     dbgFile << "Input buffer exhausted in copy";
                     error_code = 3;
-                    break;
                 }
-                if (! unpack_left)
+                else
                 {
                     dbgFile << "Output buffer exhausted in copy";
                     error_code = 4;
-                    break;
                 }
-                *dst = *src;
-                dst++;
-                unpack_left--;
-                src++;
-                pack_left--;
             }
         }
     }
@@ -197,10 +198,8 @@ QByteArray Compression::uncompress(quint32 unpacked_len, QByteArray bytes, Compr
         return bytes;
     case RLE:
     {
-        char *dst = new char[unpacked_len];
-        decode_packbits(bytes.constData(), dst, bytes.length(), unpacked_len);
-        QByteArray ba(dst, unpacked_len);
-        delete[] dst;
+        QByteArray ba(unpacked_len, Qt::Uninitialized);
+        decode_packbits(bytes.constData(), ba.data(), bytes.length(), unpacked_len);
         return ba;
      }
     case ZIP:
@@ -235,10 +234,11 @@ QByteArray Compression::compress(QByteArray bytes, Compression::CompressionType
         return bytes;
     case RLE:
     {
-        QByteArray dst;
-        int packed_len = pack_pb_line(bytes, dst);
-        Q_ASSERT(packed_len == dst.size());
-        Q_UNUSED(packed_len);
+        // the worst case is a header byte per every source byte
+        QByteArray dst(2 * bytes.size(), Qt::Uninitialized);
+        const int packed_len = pack_pb_line(bytes.constData(), bytes.size(), dst.data());
+        Q_ASSERT(packed_len <= dst.size());
+        dst.resize(packed_len);
         return dst;
     }
     case ZIP:
@@ -11,6 +11,7 @@
 #include <QDir>
 
 #include <KisTag.h>
+#include <KoStore.h>
 #include "KisResourceStorage.h"
 #include "KoResourceBundle.h"
 #include "KoResourceBundleManifest.h"
@@ -33,12 +34,8 @@ public:
                     tag->setUrl(tagname);
                     m_tags[tagname] = tag;
                 }
-                KoResourceSP resource = m_bundle->resource(resourceType, resourceReference.resourcePath);
-                if (resource) {
-                    m_tags[tagname]->setDefaultResources(m_tags[tagname]->defaultResources() << resource->filename());
-                } else {
-                    qWarning() << tagname << "The following resource could not be tagged:" << resourceReference.resourcePath << "from" << bundle->filename();
-                }
+                // the resources loaded from the bundle are named after their path, no need to load them
+                m_tags[tagname]->setDefaultResources(m_tags[tagname]->defaultResources() << QFileInfo(resourceReference.resourcePath).fileName());
             }
         }
         m_tagIterator.reset(new QListIterator<KisTagSP>(m_tags.values()));
@@ -107,12 +104,18 @@ public:
     /// This only loads the resource when called
     KoResourceSP resource() const override
     {
-        return m_bundle->resource(m_resourceType, m_resourceReference.resourcePath);
+        // the store is shared by all the resources, opening it reads the whole zip directory
+        if (!m_store) {
+            m_store.reset(m_bundle->openStore());
+            if (!m_store) return KoResourceSP();
+        }
+        return m_bundle->resource(m_resourceType, m_resourceReference.resourcePath, m_store.data());
     }
 
 private:
 
     KoResourceBundle *m_bundle {0};
+    mutable QScopedPointer<KoStore> m_store;
     QString m_resourceType;
     QScopedPointer<QListIterator<KoResourceBundleManifest::ResourceReference> > m_entriesIterator;
     KoResourceBundleManifest::ResourceReference m_resourceReference;
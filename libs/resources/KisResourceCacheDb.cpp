@@ -50,6 +50,25 @@ QString KisResourceCacheDb::lastError()
     return s_lastError;
 }
 
+void setConnectionOptions()
+{
+    /**
+     * The write-ahead log makes every commit a single append instead
+     * of rewriting the journal, and lets the models read while the
+     * storages are being synchronized. With the log, syncing only at
+     * the checkpoints cannot corrupt the database, the worst case is
+     * losing the last transactions on a power failure, which the next
+     * synchronization of the storages restores anyway.
+     */
+    QSqlQuery q;
+    if (!q.exec("PRAGMA journal_mode = WAL")) {
+        qWarning() << "Could not enable the write-ahead log of the resource cache database" << q.lastError();
+    }
+    if (!q.exec("PRAGMA synchronous = NORMAL")) {
+        qWarning() << "Could not set the synchronization mode of the resource cache database" << q.lastError();
+    }
+}
+
 QSqlError createDatabase(const QString &location)
 {
     // NOTE: if the id's of Unknown and Memory in the database
@@ -80,6 +99,8 @@ QSqlError createDatabase(const QString &location)
         return db.lastError();
     }
 
+    setConnectionOptions();
+
     QStringList tables = QStringList() << "version_information"
                                        << "storage_types"
                                        << "resource_types"
@@ -139,6 +160,7 @@ QSqlError createDatabase(const QString &location)
                 QFile::remove(location + "/" + KisResourceCacheDb::resourceCacheDbFilename);
                 }
                 db.open();
+                setConnectionOptions();
             }
 
         }
@@ -955,6 +977,45 @@ bool KisResourceCacheDb::deleteStorage(KisResourceStorageSP storage)
     return true;
 }
 
+QHash<QString, qint64> KisResourceCacheDb::latestResourceTimestamps(KisResourceStorageSP storage, const QString &resourceType)
+{
+    QHash<QString, qint64> timestamps;
+
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    if (!q.prepare("SELECT resources.filename\n"
+                   ",      versioned_resources.timestamp\n"
+                   "FROM   resources\n"
+                   ",      resource_types\n"
+                   ",      storages\n"
+                   ",      versioned_resources\n"
+                   "WHERE  resources.resource_type_id = resource_types.id\n"
+                   "AND    resource_types.name = :resource_type\n"
+                   "AND    resources.storage_id = storages.id\n"
+                   "AND    storages.location = :storage_location\n"
+                   "AND    versioned_resources.resource_id = resources.id\n"
+                   "AND    versioned_resources.version = (SELECT MAX(version)\n"
+                   "                                      FROM   versioned_resources\n"
+                   "                                      WHERE  resource_id = resources.id)")) {
+        qWarning() << "Could not prepare latest resource timestamps query" << q.lastError();
+        return timestamps;
+    }
+
+    q.bindValue(":resource_type", resourceType);
+    q.bindValue(":storage_location", KisResourceLocator::instance()->makeStorageLocationRelative(storage->location()));
+
+    if (!q.exec()) {
+        qWarning() << "Could not execute latest resource timestamps query" << q.boundValues() << q.lastError();
+        return timestamps;
+    }
+
+    while (q.next()) {
+        timestamps.insert(q.value(0).toString(), q.value(1).toLongLong());
+    }
+
+    return timestamps;
+}
+
 bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
 {
     qDebug() << "Going to synchronize" << storage->location();
@@ -1029,13 +1090,30 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
         Q_FOREACH(const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
             QStringList resourcesOnDisk;
 
+            /**
+             * Loading a resource parses the file and hashes it, which is
+             * what makes the startup slow. The files that haven't been
+             * modified since their latest version was added to the
+             * database are trusted to be the same, and are loaded only
+             * when they are used for the first time.
+             */
+            const QHash<QString, qint64> cachedTimestamps = latestResourceTimestamps(storage, resourceType);
+
             // Check the folder
             QSharedPointer<KisResourceStorage::ResourceIterator> iter = storage->resources(resourceType);
             while (iter->hasNext()) {
                 iter->next();
                 // debugResource << "\tadding resources" << iter->url();
+                const QString fileName = QFileInfo(iter->url()).fileName();
+                resourcesOnDisk << fileName;
+
+                QHash<QString, qint64>::const_iterator cached = cachedTimestamps.constFind(fileName);
+                if (cached != cachedTimestamps.constEnd() &&
+                    iter->lastModified().toSecsSinceEpoch() <= cached.value()) {
+                    continue;
+                }
+
                 KoResourceSP resource = iter->resource();
-                resourcesOnDisk << QFileInfo(iter->url()).fileName();
                 if (resource) {
                     if (!addResource(storage, iter->lastModified(), resource, iter->type())) {
                         qWarning() << "Could not add/update resource" << QFileInfo(resource->filename()).fileName() << "to the database";
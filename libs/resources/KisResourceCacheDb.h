@@ -8,6 +8,7 @@
 #define KISRESOURCECACHEDB_H
 
 #include <QObject>
+#include <QHash>
 
 #include <kritaresources_export.h>
 
@@ -75,6 +76,9 @@ private:
     static int resourceIdForResource(const QString &resourceName, const QString &resourceFileName, const QString &resourceType, const QString &storageLocation);
     static bool resourceNeedsUpdating(int resourceId, QDateTime timestamp);
 
+    /// @return the timestamps of the latest versions of the resources of @p resourceType in @p storage, keyed by filename
+    static QHash<QString, qint64> latestResourceTimestamps(KisResourceStorageSP storage, const QString &resourceType);
+
     /**
      * @brief addResourceVersion addes a new version of the resource to the database.
      * The resource itself already should be updated with the updated filename and version.
@@ -15,6 +15,7 @@
 #include <QMessageBox>
 #include <QVersionNumber>
 #include <QElapsedTimer>
+#include <QtConcurrent>
 #include <QSqlQuery>
 #include <QSqlError>
 
@@ -537,9 +538,24 @@ void KisResourceLocator::findStorages()
     // And add bundles and adobe libraries
     QStringList filters = QStringList() << "*.bundle" << "*.abr" << "*.asl";
     QDirIterator iter(d->resourceLocation, filters, QDir::Files, QDirIterator::Subdirectories);
+    QStringList locations;
     while (iter.hasNext()) {
         iter.next();
-        KisResourceStorageSP storage = QSharedPointer<KisResourceStorage>::create(iter.filePath());
+        locations << iter.filePath();
+    }
+
+    /**
+     * Opening a bundle reads and verifies its manifest, which takes a
+     * while for the big ones, so the storages are opened in parallel.
+     * Nothing touches the database here.
+     */
+    const QList<KisResourceStorageSP> containerStorages =
+        QtConcurrent::blockingMapped<QList<KisResourceStorageSP>>(locations,
+            [] (const QString &location) {
+                return QSharedPointer<KisResourceStorage>::create(location);
+            });
+
+    Q_FOREACH (KisResourceStorageSP storage, containerStorages) {
         d->storages[storage->location()] = storage;
     }
 }
@@ -9,6 +9,7 @@
 #include <QElapsedTimer>
 #include <QBuffer>
 #include <QImage>
+#include <QCache>
 #include <QtSql>
 #include <QStringList>
 
@@ -24,9 +25,107 @@ struct KisAllResourcesModel::Private {
     QSqlQuery resourcesQuery;
     QString resourceType;
     int columnCount {StorageActive};
-    int cachedRowCount {-1};
+
+    /**
+     * The columns the proxy models filter and sort on, read for every row
+     * whenever a filter changes. Seeking the query and looking the columns
+     * up by name for every row makes switching tags and searching slow
+     * with many resources, so they are kept in memory.
+     */
+    struct CachedRow {
+        int id;
+        QString name;
+        int resourceActive;
+        int storageActive;
+    };
+
+    QVector<CachedRow> rows;
+    QHash<int, int> rowForId;
+
+    /**
+     * The thumbnails are not part of resourcesQuery: the query keeps all
+     * the rows it has fetched in memory, so seeking to the last row would
+     * keep the blobs of all the resources. They are fetched and decoded
+     * when asked for, and the recently used ones are kept, the cost is in
+     * kilobytes.
+     */
+    QCache<int, QImage> thumbnails {16 * 1024};
+
+    void fetchRows();
+    QImage thumbnail(int resourceId);
 };
 
+QImage KisAllResourcesModel::Private::thumbnail(int resourceId)
+{
+    if (QImage *image = thumbnails.object(resourceId)) {
+        return *image;
+    }
+
+    QSqlQuery q;
+    if (!q.prepare("SELECT thumbnail\n"
+                   "FROM   resources\n"
+                   "WHERE  id = :resource_id")) {
+        qWarning() << "Could not prepare KisAllResourcesModel thumbnail query" << q.lastError();
+        return QImage();
+    }
+
+    q.bindValue(":resource_id", resourceId);
+
+    if (!q.exec() || !q.first()) {
+        qWarning() << "Could not select the thumbnail of resource" << resourceId << q.lastError();
+        return QImage();
+    }
+
+    QImage image;
+    image.loadFromData(q.value(0).toByteArray(), "PNG");
+
+    thumbnails.insert(resourceId, new QImage(image), qMax(1, image.byteCount() / 1024));
+
+    return image;
+}
+
+void KisAllResourcesModel::Private::fetchRows()
+{
+    rows.clear();
+    rowForId.clear();
+
+    // the same rows as resourcesQuery, without fetching the thumbnails
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    if (!q.prepare("SELECT resources.id\n"
+                   ",      resources.name\n"
+                   ",      resources.status\n"
+                   ",      storages.active\n"
+                   "FROM   resources\n"
+                   ",      resource_types\n"
+                   ",      storages\n"
+                   "WHERE  resources.resource_type_id = resource_types.id\n"
+                   "AND    resources.storage_id = storages.id\n"
+                   "AND    resource_types.name = :resource_type\n"
+                   "ORDER BY resources.id")) {
+        qWarning() << "Could not prepare KisAllResourcesModel rows query" << q.lastError();
+        return;
+    }
+
+    q.bindValue(":resource_type", resourceType);
+
+    if (!q.exec()) {
+        qWarning() << "Could not select" << resourceType << "rows" << q.lastError() << q.boundValues();
+        return;
+    }
+
+    while (q.next()) {
+        CachedRow row;
+        row.id = q.value(0).toInt();
+        row.name = q.value(1).toString();
+        row.resourceActive = q.value(2).toInt();
+        row.storageActive = q.value(3).toInt();
+
+        rowForId.insert(row.id, rows.size());
+        rows.append(row);
+    }
+}
+
 KisAllResourcesModel::KisAllResourcesModel(const QString &resourceType, QObject *parent)
     : QAbstractTableModel(parent)
     , d(new Private)
@@ -42,13 +141,16 @@ KisAllResourcesModel::KisAllResourcesModel(const QString &resourceType, QObject
                                        ",      resources.name\n"
                                        ",      resources.filename\n"
                                        ",      resources.tooltip\n"
-                                       ",      resources.thumbnail\n"
                                        ",      resources.status\n"
                                        ",      storages.location\n"
                                        ",      resources.version\n"
                                        ",      resource_types.name as resource_type\n"
                                        ",      resources.status as resource_active\n"
                                        ",      storages.active as storage_active\n"
+                                       ",      (SELECT versioned_resources.md5sum\n"
+                                       "        FROM   versioned_resources\n"
+                                       "        WHERE  versioned_resources.resource_id = resources.id\n"
+                                       "        AND    versioned_resources.version = resources.version) as md5sum\n"
                                        "FROM   resources\n"
                                        ",      resource_types\n"
                                        ",      storages\n"
@@ -82,7 +184,35 @@ QVariant KisAllResourcesModel::data(const QModelIndex &index, int role) const
     
     if (index.row() > rowCount()) return v;
     if (index.column() > d->columnCount) return v;
-    
+
+    if (index.row() < d->rows.size()) {
+        const Private::CachedRow &row = d->rows[index.row()];
+
+        if (role == Qt::DisplayRole && index.column() == Id) return row.id;
+        if (role == Qt::DisplayRole && index.column() == Name) return row.name;
+
+        switch (role) {
+        case Qt::UserRole + Id:
+            return row.id;
+        case Qt::UserRole + Name:
+            return row.name;
+        case Qt::UserRole + ResourceActive:
+            return row.resourceActive;
+        case Qt::UserRole + StorageActive:
+            return row.storageActive;
+        case Qt::UserRole + Thumbnail:
+            return QVariant::fromValue<QImage>(d->thumbnail(row.id));
+        case Qt::DisplayRole:
+        case Qt::DecorationRole:
+            if (index.column() == Thumbnail) {
+                return QVariant::fromValue<QImage>(d->thumbnail(row.id));
+            }
+            break;
+        default:
+            ;
+        }
+    }
+
     bool pos = const_cast<KisAllResourcesModel*>(this)->d->resourcesQuery.seek(index.row());
     
     if (pos) {
@@ -121,6 +251,8 @@ QVariant KisAllResourcesModel::headerData(int section, Qt::Orientation orientati
             return i18n("Active");
         case StorageActive:
             return i18n("Storage Active");
+        case MD5:
+            return i18n("md5sum");
         default:
             return QString::number(section);
         }
@@ -267,15 +399,15 @@ QModelIndex KisAllResourcesModel::indexForResource(KoResourceSP resource) const
 {
     if (!resource || !resource->valid() || resource->resourceId() < 0) return QModelIndex();
 
-    // For now a linear seek to find the first resource with the right id
-    d->resourcesQuery.first();
-    do {
-        if (d->resourcesQuery.value("id").toInt() == resource->resourceId()) {
-            return createIndex(d->resourcesQuery.at(), 0);
-        }
-    } while (d->resourcesQuery.next());
-    
-    return QModelIndex();
+    return indexForResourceId(resource->resourceId());
+}
+
+QModelIndex KisAllResourcesModel::indexForResourceId(int resourceId) const
+{
+    QHash<int, int>::const_iterator it = d->rowForId.constFind(resourceId);
+    if (it == d->rowForId.constEnd()) return QModelIndex();
+
+    return createIndex(it.value(), 0);
 }
 
 bool KisAllResourcesModel::setResourceInactive(const QModelIndex &index)
@@ -374,7 +506,8 @@ bool KisAllResourcesModel::resetQuery()
     if (!r) {
         qWarning() << "Could not select" << d->resourceType << "resources" << d->resourcesQuery.lastError() << d->resourcesQuery.boundValues();
     }
-    d->cachedRowCount = -1;
+    d->fetchRows();
+    d->thumbnails.clear();
 
     return r;
 }
@@ -421,21 +554,7 @@ QVector<KisTagSP> KisAllResourcesModel::tagsForResource(int resourceId) const
 
 int KisAllResourcesModel::rowCount(const QModelIndex &) const
 {
-    if (d->cachedRowCount < 0) {
-        QSqlQuery q;
-        q.prepare("SELECT count(*)\n"
-                  "FROM   resources\n"
-                  ",      resource_types\n"
-                  "WHERE  resources.resource_type_id = resource_types.id\n"
-                  "AND    resource_types.name = :resource_type\n");
-        q.bindValue(":resource_type", d->resourceType);
-        q.exec();
-        q.first();
-        
-        const_cast<KisAllResourcesModel*>(this)->d->cachedRowCount = q.value(0).toInt();
-    }
-    
-    return d->cachedRowCount;
+    return d->rows.size();
 }
 
 
@@ -459,8 +578,30 @@ struct KisResourceModel::Private
     ResourceFilter resourceFilter {ShowActiveResources};
     StorageFilter storageFilter {ShowActiveStorages};
     bool showOnlyUntaggedResources {false};
+
+    /// fetched once per filter change instead of querying the tags of every row
+    QSet<int> taggedResourceIds;
+
+    void fetchTaggedResourceIds();
 };
 
+void KisResourceModel::Private::fetchTaggedResourceIds()
+{
+    taggedResourceIds.clear();
+
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    if (!q.exec("SELECT DISTINCT resource_id\n"
+                "FROM   resource_tags")) {
+        qWarning() << "KisResourceModel: Could not execute resource_tags query" << q.lastError();
+        return;
+    }
+
+    while (q.next()) {
+        taggedResourceIds.insert(q.value(0).toInt());
+    }
+}
+
 KisResourceModel::KisResourceModel(const QString &type, QObject *parent)
     : QSortFilterProxyModel(parent)
     , d(new Private)
@@ -493,6 +634,9 @@ void KisResourceModel::setStorageFilter(StorageFilter filter)
 void KisResourceModel::showOnlyUntaggedResources(bool showOnlyUntagged)
 {
     d->showOnlyUntaggedResources = showOnlyUntagged;
+    if (showOnlyUntagged) {
+        d->fetchTaggedResourceIds();
+    }
     invalidateFilter();
 }
 
@@ -579,46 +723,13 @@ bool KisResourceModel::filterAcceptsRow(int source_row, const QModelIndex &sourc
     if (idx.isValid()) {
         int id = idx.data(Qt::DisplayRole + KisAbstractResourceModel::Id).toInt();
 
-        if (d->showOnlyUntaggedResources) {
-
-            QString queryString = ("SELECT COUNT(*)\n"
-                                   "FROM   resource_tags\n"
-                                   ",      resources\n"
-                                   ",      storages\n"
-                                   "WHERE  resource_tags.resource_id = resources.id\n"
-                                   "AND    storages.id               = resources.storage_id\n"
-                                   "AND    resources.id              = :resource_id\n");
-
-            if (d->resourceFilter == ShowActiveResources) {
-                queryString.append("AND    resources.status > 0\n");
-            }
-            else if (d->resourceFilter == ShowInactiveResources) {
-                queryString.append("AND    resources.status = 0\n");
-            }
-
-            if (d->storageFilter == ShowActiveStorages) {
-                queryString.append("AND    storages.active > 0\n");
-            }
-            else if (d->storageFilter == ShowInactiveStorages) {
-                queryString.append("AND    storages.active = 0\n");
-            }
-
-            QSqlQuery q;
-
-            if (!q.prepare((queryString))) {
-                qWarning() << "KisResourceModel: Could not prepare resource_tags query" << q.lastError();
-            }
-
-            q.bindValue(":resource_id", id);
-
-            if (!q.exec()) {
-                qWarning() << "KisResourceModel: Could not execute resource_tags query" << q.lastError() << q.boundValues();
-            }
-
-            q.first();
-            if (q.value(0).toInt() > 0) {
-                return false;
-            }
+        /**
+         * The resources that are tagged are rejected whatever the state of
+         * their tags, the inactive resources and storages are rejected
+         * below when they should be.
+         */
+        if (d->showOnlyUntaggedResources && d->taggedResourceIds.contains(id)) {
+            return false;
         }
     }
 
@@ -50,6 +50,8 @@ public:
         ResourceActive,
         /// Whether the current resource's storage is active
         StorageActive,
+        /// The md5sum of the current version of the resource, as a hex string
+        MD5,
     };
 
     virtual ~KisAbstractResourceModel(){}
@@ -156,6 +158,9 @@ public:
     bool renameResource(KoResourceSP resource, const QString &name) override;
     bool setResourceMetaData(KoResourceSP resource, QMap<QString, QVariant> metadata) override;
 
+    /// @return the index of the first column of the resource with @p resourceId, without querying the database
+    QModelIndex indexForResourceId(int resourceId) const;
+
 private Q_SLOTS:
 
     void addStorage(const QString &location);
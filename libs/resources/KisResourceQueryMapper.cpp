@@ -20,7 +20,6 @@
 QVariant KisResourceQueryMapper::variantFromResourceQuery(const QSqlQuery &query, int column, int role)
 {
     const QString resourceType = query.value("resource_type").toString();
-    KisResourceModel resourceModel(resourceType);
 
     switch(role) {
     case Qt::DisplayRole:
@@ -55,6 +54,8 @@ QVariant KisResourceQueryMapper::variantFromResourceQuery(const QSqlQuery &query
             return query.value("resource_active");
         case KisAbstractResourceModel::StorageActive:
             return query.value("storage_active");
+        case KisAbstractResourceModel::MD5:
+            return query.value("md5sum");
         default:
             ;
         };
@@ -107,6 +108,7 @@ QVariant KisResourceQueryMapper::variantFromResourceQuery(const QSqlQuery &query
         return query.value("resource_type");
     case Qt::UserRole + KisAbstractResourceModel::Tags:
     {
+        KisResourceModel resourceModel(resourceType);
         QStringList tagNames;
         Q_FOREACH(const KisTagSP tag, resourceModel.tagsForResource(query.value("id").toInt())) {
             tagNames << tag->name();
@@ -124,6 +126,7 @@ QVariant KisResourceQueryMapper::variantFromResourceQuery(const QSqlQuery &query
         }
         else {
             // Now we have to check the resource, but that's cheap since it's been loaded in any case
+            KisResourceModel resourceModel(resourceType);
             KoResourceSP resource = resourceModel.resourceForId(query.value("id").toInt());
             return resource->isDirty();
         }
@@ -141,6 +144,10 @@ QVariant KisResourceQueryMapper::variantFromResourceQuery(const QSqlQuery &query
     {
         return query.value("storage_active");
     }
+    case Qt::UserRole + KisAbstractResourceModel::MD5:
+    {
+        return query.value("md5sum");
+    }
     default:
         ;
     }
@@ -165,6 +172,10 @@ QVariant KisResourceQueryMapper::variantFromResourceQueryById(int resourceId, in
               ",      resource_types.name as resource_type\n"
               ",      resources.status as resource_active\n"
               ",      storages.active as storage_active\n"
+              ",      (SELECT versioned_resources.md5sum\n"
+              "        FROM   versioned_resources\n"
+              "        WHERE  versioned_resources.resource_id = resources.id\n"
+              "        AND    versioned_resources.version = resources.version) as md5sum\n"
               "FROM   resources\n"
               ",      resource_types\n"
               ",      storages\n"
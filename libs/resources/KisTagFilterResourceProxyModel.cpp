@@ -212,10 +212,14 @@ bool KisTagFilterResourceProxyModel::filterAcceptsRow(int source_row, const QMod
     }
 
     bool metaDataMatches = true;
-    QMap<QString, QVariant> resourceMetaData = sourceModel()->data(idx, Qt::UserRole + KisAbstractResourceModel::MetaData).toMap();
-    Q_FOREACH(const QString &key, d->metaDataMapFilter.keys()) {
-        if (resourceMetaData.contains(key)) {
-            metaDataMatches = (resourceMetaData[key] != d->metaDataMapFilter[key]);
+
+    // the metadata is queried from the database for every row, so only when it's needed
+    if (!d->metaDataMapFilter.isEmpty()) {
+        QMap<QString, QVariant> resourceMetaData = sourceModel()->data(idx, Qt::UserRole + KisAbstractResourceModel::MetaData).toMap();
+        Q_FOREACH(const QString &key, d->metaDataMapFilter.keys()) {
+            if (resourceMetaData.contains(key)) {
+                metaDataMatches = (resourceMetaData[key] != d->metaDataMapFilter[key]);
+            }
         }
     }
 
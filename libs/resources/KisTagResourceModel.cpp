@@ -8,13 +8,24 @@
 #include <QtSql>
 #include <KisResourceLocator.h>
 #include <KisResourceModel.h>
+#include <KisResourceModelProvider.h>
 #include <KisResourceQueryMapper.h>
 
 struct KisAllTagResourceModel::Private {
     QString resourceType;
     QSqlQuery query;
     int columnCount {ResourceName};
-    int cachedRowCount {-1};
+
+    /// the columns KisTagResourceModel filters on, see KisAllResourcesModel::Private::CachedRow
+    struct CachedRow {
+        int tagId;
+        int resourceId;
+        bool tagActive;
+        bool resourceActive;
+        bool resourceStorageActive;
+    };
+
+    QVector<CachedRow> rows;
 };
 
 
@@ -33,27 +44,7 @@ KisAllTagResourceModel::~KisAllTagResourceModel()
 
 int KisAllTagResourceModel::rowCount(const QModelIndex &/*parent*/) const
 {
-    if (d->cachedRowCount < 0) {
-        QSqlQuery q;
-        q.prepare("SELECT count(*)\n"
-                  "FROM   resource_tags\n"
-                  ",      resources\n"
-                  ",      resource_types\n"
-                  "WHERE  resource_tags.resource_id = resources.id\n"
-                  "AND    resources.resource_type_id = resource_types.id\n"
-                  "AND    resource_types.name = :resource_type");
-
-        q.bindValue(":resource_type", d->resourceType);
-
-        if (!q.exec()) {
-            qWarning() << "Could not execute tags rowcount query" << q.lastError();
-        }
-
-        q.first();
-
-        const_cast<KisAllTagResourceModel*>(this)->d->cachedRowCount = q.value(0).toInt();
-    }
-    return d->cachedRowCount;
+    return d->rows.size();
 }
 
 int KisAllTagResourceModel::columnCount(const QModelIndex &/*parent*/) const
@@ -69,6 +60,35 @@ QVariant KisAllTagResourceModel::data(const QModelIndex &index, int role) const
     if (index.row() > rowCount()) { return v; }
     if (index.column() > d->columnCount) { return v;}
 
+    if (index.row() < d->rows.size()) {
+        const Private::CachedRow &row = d->rows[index.row()];
+
+        switch (role) {
+        case Qt::UserRole + TagId:
+            return row.tagId;
+        case Qt::UserRole + ResourceId:
+            return row.resourceId;
+        case Qt::UserRole + TagActive:
+            return row.tagActive;
+        case Qt::UserRole + ResourceActive:
+            return row.resourceActive;
+        case Qt::UserRole + ResourceStorageActive:
+            return row.resourceStorageActive;
+        default:
+            ;
+        }
+
+        if (role < Qt::UserRole + TagId) {
+            // the resources model has the row of the resource fetched already
+            KisAllResourcesModel *resourceModel = KisResourceModelProvider::resourceModel(d->resourceType);
+            const QModelIndex resourceIndex = resourceModel->indexForResourceId(row.resourceId);
+
+            if (resourceIndex.isValid() && index.column() < resourceModel->columnCount()) {
+                return resourceModel->data(resourceIndex.sibling(resourceIndex.row(), index.column()), role);
+            }
+        }
+    }
+
     bool pos = const_cast<KisAllTagResourceModel*>(this)->d->query.seek(index.row());
     if (!pos) {return v;}
 
@@ -249,7 +269,26 @@ bool KisAllTagResourceModel::resetQuery()
         qWarning() << "Could not execute KisAllTagResourcesModel query" << d->query.lastError();
     }
 
-    d->cachedRowCount = -1;
+    d->rows.clear();
+
+    if (r) {
+        const QSqlRecord record = d->query.record();
+        const int tagIdColumn = record.indexOf("tag_id");
+        const int resourceIdColumn = record.indexOf("resource_id");
+        const int tagActiveColumn = record.indexOf("tag_active");
+        const int resourceActiveColumn = record.indexOf("resource_active");
+        const int resourceStorageActiveColumn = record.indexOf("resource_storage_active");
+
+        while (d->query.next()) {
+            Private::CachedRow row;
+            row.tagId = d->query.value(tagIdColumn).toInt();
+            row.resourceId = d->query.value(resourceIdColumn).toInt();
+            row.tagActive = d->query.value(tagActiveColumn).toBool();
+            row.resourceActive = d->query.value(resourceActiveColumn).toBool();
+            row.resourceStorageActive = d->query.value(resourceStorageActiveColumn).toBool();
+            d->rows.append(row);
+        }
+    }
 
     return r;
 }
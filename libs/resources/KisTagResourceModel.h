@@ -44,7 +44,7 @@ public:
 public:
 
     enum Columns {
-        TagId = KisAbstractResourceModel::StorageActive + 1,
+        TagId = KisAbstractResourceModel::MD5 + 1,
         ResourceId,
         Tag,
         Resource,
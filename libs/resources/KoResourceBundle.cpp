@@ -75,13 +75,10 @@ bool KoResourceBundle::load()
             }
             resourceStore->close();
 
-            Q_FOREACH (KoResourceBundleManifest::ResourceReference ref, m_manifest.files()) {
-                if (!resourceStore->open(ref.resourcePath)) {
+            Q_FOREACH (const KoResourceBundleManifest::ResourceReference &ref, m_manifest.files()) {
+                if (!resourceStore->hasFile(ref.resourcePath)) {
                     qWarning() << "Bundle is broken. File" << ref.resourcePath << "is missing";
                 }
-                else {
-                    resourceStore->close();
-                }
             }
 
         } else {
@@ -399,18 +396,31 @@ KoResourceBundleManifest &KoResourceBundle::manifest()
     return m_manifest;
 }
 
-KoResourceSP KoResourceBundle::resource(const QString &resourceType, const QString &filepath)
+KoStore *KoResourceBundle::openStore() const
 {
     if (m_filename.isEmpty()) return 0;
 
-
-    QScopedPointer<KoStore> resourceStore(KoStore::createStore(m_filename, KoStore::Read, "application/x-krita-resourcebundle", KoStore::Zip));
+    KoStore *resourceStore = KoStore::createStore(m_filename, KoStore::Read, "application/x-krita-resourcebundle", KoStore::Zip);
 
     if (!resourceStore || resourceStore->bad()) {
         qWarning() << "Could not open store on bundle" << m_filename;
+        delete resourceStore;
         return 0;
     }
 
+    return resourceStore;
+}
+
+KoResourceSP KoResourceBundle::resource(const QString &resourceType, const QString &filepath)
+{
+    QScopedPointer<KoStore> resourceStore(openStore());
+    if (!resourceStore) return 0;
+
+    return resource(resourceType, filepath, resourceStore.data());
+}
+
+KoResourceSP KoResourceBundle::resource(const QString &resourceType, const QString &filepath, KoStore *resourceStore)
+{
     if (!resourceStore->open(filepath)) {
         qWarning() << "Could not open file in bundle" << filepath;
         return 0;
@@ -420,6 +430,7 @@ KoResourceSP KoResourceBundle::resource(const QString &resourceType, const QStri
     KisResourceLoaderBase *loader = KisResourceLoaderRegistry::instance()->loader(resourceType, mime);
     if (!loader) {
         qWarning() << "Could not create loader for" << resourceType << filepath << mime;
+        resourceStore->close();
         return 0;
     }
     KoResourceSP res = loader->load(filepath, *resourceStore->device(), KisGlobalResourcesInterface::instance());
@@ -100,6 +100,17 @@ public:
 
     KoResourceSP resource(const QString &resourceType, const QString &filepath);
 
+    /**
+     * Loads a resource from @p store, which should have been opened with
+     * openStore(). Opening the bundle reads the whole directory of the
+     * zip file, so the callers that load many resources in a row should
+     * open it only once.
+     */
+    KoResourceSP resource(const QString &resourceType, const QString &filepath, KoStore *store);
+
+    /// @return a new store to read the bundle, or null if it cannot be opened
+    KoStore *openStore() const;
+
     QImage image() const;
 
     QString filename() const;
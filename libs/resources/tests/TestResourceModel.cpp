@@ -100,6 +100,23 @@ void TestResourceModel::testData()
     QVERIFY(resourceNames.contains("test2"));
 }
 
+void TestResourceModel::testCachedData()
+{
+    KisResourceModel resourceModel(m_resourceType);
+
+    for (int i = 0; i < resourceModel.rowCount(); ++i)  {
+        QModelIndex idx = resourceModel.index(i, 0);
+        KoResourceSP resource = resourceModel.resourceForIndex(idx);
+        QVERIFY(resource);
+
+        QCOMPARE(idx.data(Qt::UserRole + KisAbstractResourceModel::Id).toInt(), resource->resourceId());
+        QCOMPARE(idx.data(Qt::UserRole + KisAbstractResourceModel::Name).toString(), resource->name());
+        QCOMPARE(idx.data(Qt::UserRole + KisAbstractResourceModel::ResourceActive).toInt(), 1);
+        QCOMPARE(idx.data(Qt::UserRole + KisAbstractResourceModel::StorageActive).toInt(), 1);
+        QCOMPARE(resourceModel.indexForResource(resource), idx);
+    }
+}
+
 
 void TestResourceModel::testResourceForIndex()
 {
@@ -241,6 +258,9 @@ void TestResourceModel::testResourceForMD5()
     KoResourceSP resource2 = resourceModel.resourceForMD5(resource->md5());
     QVERIFY(!resource2.isNull());
     QCOMPARE(resource->md5(), resource2->md5());
+
+    QString md5 = resourceModel.data(resourceModel.index(0, 0), Qt::UserRole + KisAbstractResourceModel::MD5).toString();
+    QCOMPARE(md5, QString(resource->md5().toHex()));
 }
 
 void TestResourceModel::testRenameResource()
@@ -19,6 +19,7 @@ private Q_SLOTS:
     void initTestCase();
     void testRowCount();
     void testData();
+    void testCachedData();
     void testResourceForIndex();
     void testIndexFromResource();
     void testSetInactiveByIndex();
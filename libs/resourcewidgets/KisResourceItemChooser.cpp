@@ -40,6 +40,7 @@
 
 #include "KisResourceItemListView.h"
 #include "KisResourceItemDelegate.h"
+#include "KisResourceThumbnailCache.h"
 #include "KisTagFilterWidget.h"
 #include "KisTagChooserWidget.h"
 #include "KisResourceItemChooserSync.h"
@@ -103,6 +104,8 @@ KisResourceItemChooser::KisResourceItemChooser(const QString &resourceType, bool
     }
 
     d->view->setItemDelegate(new KisResourceItemDelegate(this));
+    connect(KisResourceThumbnailCache::instance(), SIGNAL(thumbnailReady(QString)),
+            d->view->viewport(), SLOT(update()));
     d->view->setSelectionMode(QAbstractItemView::SingleSelection);
     d->view->viewport()->installEventFilter(this);
 
@@ -11,6 +11,7 @@
 #include <QDebug>
 
 #include "KisResourceModel.h"
+#include "KisResourceThumbnailCache.h"
 
 KisResourceItemDelegate::KisResourceItemDelegate(QObject *parent)
     : QAbstractItemDelegate(parent)
@@ -32,18 +33,29 @@ void KisResourceItemDelegate::paint(QPainter *painter, const QStyleOptionViewIte
 
     QRect innerRect = option.rect.adjusted(2, 2, -2, -2);
 
-    QImage thumbnail = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
+    QString resourceType = index.data(Qt::UserRole + KisAbstractResourceModel::ResourceType).toString();
+
+    // The thumbnails are decoded in the background, only the gradients
+    // are stretched to the cell, the others are kept at their size if
+    // they fit, see below
+    const bool isGradient = resourceType == ResourceType::Gradients;
+    const QSize gradientSize = innerRect.size() * devicePixelRatioF;
+    QImage thumbnail = KisResourceThumbnailCache::instance()->thumbnail(index,
+                                                                        isGradient ? gradientSize : QSize(),
+                                                                        isGradient ? Qt::IgnoreAspectRatio : Qt::KeepAspectRatio);
     thumbnail.setDevicePixelRatio(devicePixelRatioF);
 
     QSize imageSize = thumbnail.size();
 
     painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
 
-    QString resourceType = index.data(Qt::UserRole + KisAbstractResourceModel::ResourceType).toString();
     // XXX: don't use a hardcoded string here to identify the resource type
-    if (resourceType == ResourceType::Gradients) {
+    if (isGradient) {
         m_checkerPainter.paint(*painter, innerRect, innerRect.topLeft());
-        thumbnail = thumbnail.scaled(innerRect.size()*devicePixelRatioF, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        if (!thumbnail.isNull() && thumbnail.size() != gradientSize) {
+            thumbnail = thumbnail.scaled(gradientSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            thumbnail.setDevicePixelRatio(devicePixelRatioF);
+        }
         painter->drawImage(innerRect.topLeft(), thumbnail);
     }
     else if (resourceType == ResourceType::Patterns) {
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "KisResourceThumbnailCache.h"
+
+#include <QGlobalStatic>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QModelIndex>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+#include "KisResourceModel.h"
+
+Q_GLOBAL_STATIC(KisResourceThumbnailCache, s_instance)
+
+namespace {
+
+QString thumbnailKey(const QString &md5, const QSize &size, Qt::AspectRatioMode aspectMode)
+{
+    return QString("%1/%2x%3/%4").arg(md5).arg(size.width()).arg(size.height()).arg(aspectMode);
+}
+
+QByteArray thumbnailBlob(int resourceId)
+{
+    QSqlQuery q;
+    if (!q.prepare("SELECT thumbnail\n"
+                   "FROM   resources\n"
+                   "WHERE  id = :resource_id")) {
+        qWarning() << "Could not prepare thumbnail query" << q.lastError();
+        return QByteArray();
+    }
+
+    q.bindValue(":resource_id", resourceId);
+
+    if (!q.exec() || !q.first()) {
+        qWarning() << "Could not fetch the thumbnail of resource" << resourceId << q.lastError();
+        return QByteArray();
+    }
+
+    return q.value(0).toByteArray();
+}
+
+}
+
+struct Q_DECL_HIDDEN KisResourceThumbnailCache::Private
+{
+    Private() {
+        // the thumbnails are small, a couple of threads is enough to
+        // keep up with scrolling without taking the CPU from the strokes
+        pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 2));
+
+        // the cost is measured in kilobytes
+        thumbnails.setMaxCost(32 * 1024);
+    }
+
+    ~Private() {
+        pool.waitForDone();
+    }
+
+    QThreadPool pool;
+    QCache<QString, QImage> thumbnails;
+    /// the key of the most recently decoded thumbnail of every md5
+    QHash<QString, QString> latestKeys;
+    QSet<QString> pendingKeys;
+};
+
+KisResourceThumbnailCache::KisResourceThumbnailCache()
+    : d(new Private)
+{
+}
+
+KisResourceThumbnailCache::~KisResourceThumbnailCache()
+{
+}
+
+KisResourceThumbnailCache* KisResourceThumbnailCache::instance()
+{
+    return s_instance;
+}
+
+QImage KisResourceThumbnailCache::thumbnail(const QModelIndex &index, const QSize &size, Qt::AspectRatioMode aspectMode)
+{
+    const QString md5 = index.data(Qt::UserRole + KisAbstractResourceModel::MD5).toString();
+
+    if (md5.isEmpty()) {
+        // the resource has no version in the database, nothing to key the cache with
+        QImage image = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
+        return image.isNull() ? image : image.scaled(size, aspectMode, Qt::SmoothTransformation);
+    }
+
+    const QString key = thumbnailKey(md5, size, aspectMode);
+
+    if (QImage *image = d->thumbnails.object(key)) {
+        return *image;
+    }
+
+    if (!d->pendingKeys.contains(key)) {
+        d->pendingKeys.insert(key);
+
+        // The database connection belongs to the GUI thread, so only the
+        // PNG blob is fetched here, decoding it is left to the workers
+        const QByteArray blob = thumbnailBlob(index.data(Qt::UserRole + KisAbstractResourceModel::Id).toInt());
+
+        QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+
+        connect(watcher, &QFutureWatcher<QImage>::finished, this,
+            [this, watcher, key, md5] () {
+                const QImage image = watcher->result();
+                watcher->deleteLater();
+
+                d->pendingKeys.remove(key);
+                d->thumbnails.insert(key, new QImage(image), qMax(1, image.byteCount() / 1024));
+                d->latestKeys.insert(md5, key);
+
+                emit thumbnailReady(md5);
+            });
+
+        watcher->setFuture(QtConcurrent::run(&d->pool,
+            [blob, size, aspectMode] () {
+                QImage image;
+                image.loadFromData(blob, "PNG");
+                if (!image.isNull() && !size.isEmpty()) {
+                    image = image.scaled(size, aspectMode, Qt::SmoothTransformation);
+                }
+                return image;
+            }));
+    }
+
+    if (QImage *image = d->thumbnails.object(d->latestKeys.value(md5))) {
+        return *image;
+    }
+
+    return QImage();
+}
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef KISRESOURCETHUMBNAILCACHE_H
+#define KISRESOURCETHUMBNAILCACHE_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QImage>
+
+#include "kritaresourcewidgets_export.h"
+
+class QModelIndex;
+
+/**
+ * KisResourceThumbnailCache is a singleton that keeps the scaled thumbnails
+ * of the resources shown in the resource item choosers.
+ *
+ * The thumbnails are stored as PNG blobs in the resource cache database.
+ * Decoding and scaling them is done on a pool of worker threads, and the
+ * results are kept in memory keyed by the md5sum of the resource, so the
+ * same resource shown in several choosers is decoded only once and
+ * a changed resource gets a new thumbnail automatically.
+ */
+class KRITARESOURCEWIDGETS_EXPORT KisResourceThumbnailCache : public QObject
+{
+    Q_OBJECT
+public:
+    KisResourceThumbnailCache();
+    ~KisResourceThumbnailCache() override;
+    static KisResourceThumbnailCache* instance();
+
+    /**
+     * @return the thumbnail of the resource at @p index scaled to @p size
+     * in device pixels. If that thumbnail is not ready yet, it is scheduled
+     * for decoding and the thumbnail of the resource of another size is
+     * returned instead, or a null image if there is none. thumbnailReady()
+     * is emitted when the requested thumbnail is ready.
+     */
+    QImage thumbnail(const QModelIndex &index, const QSize &size, Qt::AspectRatioMode aspectMode);
+
+Q_SIGNALS:
+    /// Emitted on the GUI thread when a thumbnail of the resource with @p md5 has been decoded
+    void thumbnailReady(const QString &md5);
+
+private:
+    Q_DISABLE_COPY(KisResourceThumbnailCache)
+
+    struct Private;
+    const QScopedPointer<Private> d;
+};
+
+#endif // KISRESOURCETHUMBNAILCACHE_H
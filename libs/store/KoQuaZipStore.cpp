@@ -19,6 +19,7 @@
 #include <QTextCodec>
 #include <QByteArray>
 #include <QBuffer>
+#include <QHash>
 
 #include <KConfig>
 #include <KSharedConfig>
@@ -35,6 +36,13 @@ struct KoQuaZipStore::Private {
     bool usingSaveFile {false};
     QByteArray cache;
     QBuffer buffer;
+
+    /**
+     * The positions of the entries in the central directory of the
+     * archive. QuaZip looks the entries up by name with a linear scan,
+     * which makes reading all the files of a big archive quadratic.
+     */
+    QHash<QString, QuaZipFilePos> entries;
 };
 
 
@@ -147,6 +155,10 @@ void KoQuaZipStore::init(const QByteArray &appIdentification)
     else {
         debugStore << dd->archive->getEntriesCount() << dd->archive->getFileNameList();
         d->good = dd->archive->getEntriesCount();
+
+        for (bool more = dd->archive->goToFirstFile(); more; more = dd->archive->goToNextFile()) {
+            dd->entries.insert(dd->archive->getCurrentFileName(), dd->archive->getCurrentFilePos());
+        }
     }
 }
 
@@ -207,7 +219,12 @@ bool KoQuaZipStore::openRead(const QString &name)
         fixedPath = fixedPath.replace(d->substituteThis, d->substituteWith);
     }
 
-    if (!dd->archive->setCurrentFile(fixedPath)) {
+    QHash<QString, QuaZipFilePos>::const_iterator entry = dd->entries.constFind(fixedPath);
+    const bool found = entry != dd->entries.constEnd() ?
+        dd->archive->goToFilePos(entry.value()) :
+        dd->archive->setCurrentFile(fixedPath);
+
+    if (!found) {
         qWarning() << "\t\tCould not set current file" << dd->archive->getZipError() << fixedPath;
         return false;
     }
@@ -274,5 +291,9 @@ bool KoQuaZipStore::fileExists(const QString &absPath) const
         fixedPath = fixedPath.replace(d->substituteThis, d->substituteWith);
     }
 
+    if (d->mode == Read) {
+        return dd->entries.contains(fixedPath);
+    }
+
     return dd->archive->getFileNameList().contains(fixedPath);
 }
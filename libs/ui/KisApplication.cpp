@@ -20,6 +20,7 @@
 #include <QStandardPaths>
 #include <QDesktopWidget>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QLocale>
 #include <QMessageBox>
@@ -50,6 +51,7 @@
 #include <KisMimeDatabase.h>
 #include "thememanager.h"
 #include "KisDocument.h"
+#include "KisBatchExporter.h"
 #include "KisMainWindow.h"
 #include "KisAutoSaveRecoveryDialog.h"
 #include "KisPart.h"
@@ -383,20 +385,34 @@ bool KisApplication::start(const KisApplicationArguments &args)
         cfg.setCanvasState("OPENGL_FAILED");
     }
 
+    // the duration of every phase is written to the usage log, to see what slows the startup down
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+    QStringList startupPhases;
+    qint64 lastPhaseEnd = 0;
+
+    auto finishStartupPhase = [&] (const QString &phase) {
+        const qint64 now = startupTimer.elapsed();
+        startupPhases << QString("%1 %2 ms").arg(phase).arg(now - lastPhaseEnd);
+        lastPhaseEnd = now;
+    };
+
     setSplashScreenLoadingText(i18n("Initializing Globals..."));
     processEvents();
     initializeGlobals(args);
+    finishStartupPhase("globals");
 
     const bool doNewImage = args.doNewImage();
     const bool doTemplate = args.doTemplate();
     const bool exportAs = args.exportAs();
     const bool exportSequence = args.exportSequence();
     const QString exportFileName = args.exportFileName();
+    const QString exportBatch = args.exportBatch();
 
-    d->batchRun = (exportAs || exportSequence || !exportFileName.isEmpty());
-    const bool needsMainWindow = (!exportAs && !exportSequence);
+    d->batchRun = (exportAs || exportSequence || !exportFileName.isEmpty() || !exportBatch.isEmpty());
+    const bool needsMainWindow = (!exportAs && !exportSequence && exportBatch.isEmpty());
     // only show the mainWindow when no command-line mode option is passed
-    bool showmainWindow = (!exportAs && !exportSequence); // would be !batchRun;
+    bool showmainWindow = (!exportAs && !exportSequence && exportBatch.isEmpty()); // would be !batchRun;
 
     const bool showSplashScreen = !d->batchRun && qEnvironmentVariableIsEmpty("NOSPLASH");
     if (showSplashScreen && d->splashScreen) {
@@ -417,17 +433,21 @@ bool KisApplication::start(const KisApplicationArguments &args)
     setSplashScreenLoadingText(i18n("Adding resource types..."));
     processEvents();
     addResourceTypes();
+    finishStartupPhase("resource types");
 
     // Load the plugins
     loadPlugins();
+    finishStartupPhase("plugins");
 
     // Load all resources
     if (!registerResources()) {
         return false;
     }
+    finishStartupPhase("resources");
 
     // Load the gui plugins
     loadGuiPlugins();
+    finishStartupPhase("gui plugins");
 
     KisPart *kisPart = KisPart::instance();
     if (needsMainWindow) {
@@ -485,7 +505,12 @@ bool KisApplication::start(const KisApplicationArguments &args)
         } else {
             d->mainWindow = kisPart->createMainWindow();
         }
+
+        finishStartupPhase("main window");
     }
+
+    KisUsageLogger::log(QString("Startup took %1 ms: %2").arg(startupTimer.elapsed()).arg(startupPhases.join(", ")));
+
     short int numberOfOpenDocuments = 0; // number of documents open
 
     // Check for autosave files that can be restored, if we're not running a batchrun (test)
@@ -510,6 +535,29 @@ bool KisApplication::start(const KisApplicationArguments &args)
         }
     }
 
+    // Convert all the files of the job list in this process, so that the
+    // resources are loaded only once
+    if (!exportBatch.isEmpty()) {
+        QVector<KisBatchExporter::Job> jobs;
+        QString errorMessage;
+
+        if (!KisBatchExporter::loadJobList(exportBatch, &jobs, &errorMessage)) {
+            errKrita << errorMessage;
+            QTimer::singleShot(0, this, SLOT(quit()));
+            return false;
+        }
+
+        KisBatchExporter exporter;
+        exporter.addJobs(jobs);
+
+        if (!exporter.exec()) {
+            errKrita << "Could not export" << exporter.numFailedJobs() << "of" << jobs.size() << "files";
+        }
+
+        QTimer::singleShot(0, this, SLOT(quit()));
+        return true;
+    }
+
     // Get the command line arguments which we have to parse
     int argsCount = args.filenames().count();
     if (argsCount > 0) {
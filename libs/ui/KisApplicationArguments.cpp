@@ -32,10 +32,12 @@ struct Q_DECL_HIDDEN KisApplicationArguments::Private
     bool exportAs {false};
     bool exportSequence {false};
     QString exportFileName;
+    QString exportBatch;
     QString workspace;
     QString windowLayout;
     QString session;
     QString fileLayer;
+    QString cpuAffinity;
     bool canvasOnly {false};
     bool noSplash {false};
     bool fullScreen {false};
@@ -89,7 +91,9 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export"), i18n("Export to the given filename and exit")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-sequence"), i18n("Export animation to the given filename and exit")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-filename"), i18n("Filename for export"), QLatin1String("filename")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-batch"), i18n("Export all the files listed in the given job list and exit. Every line of the list contains the input and output filenames separated by a tab"), QLatin1String("joblist")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("file-layer"), i18n("File layer to be added to existing or new file"), QLatin1String("file-layer")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("cpu-affinity"), i18n("Run Krita on the given set of cores only, e.g. \"0-3,8\""), QLatin1String("cpus")));
     parser.addPositionalArgument(QLatin1String("[file(s)]"), i18n("File(s) or URL(s) to open"));
     parser.process(app);
 
@@ -126,6 +130,8 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
 
     d->fileLayer = parser.value("file-layer");
     d->exportFileName = parser.value("export-filename");
+    d->exportBatch = parser.value("export-batch");
+    d->cpuAffinity = parser.value("cpu-affinity");
     d->workspace = parser.value("workspace");
     d->windowLayout = parser.value("windowlayout");
     d->session = parser.value("load-session");
@@ -151,10 +157,12 @@ KisApplicationArguments::KisApplicationArguments(const KisApplicationArguments &
     d->doTemplate = rhs.doTemplate();
     d->exportAs = rhs.exportAs();
     d->exportFileName = rhs.exportFileName();
+    d->exportBatch = rhs.exportBatch();
     d->canvasOnly = rhs.canvasOnly();
     d->workspace = rhs.workspace();
     d->windowLayout = rhs.windowLayout();
     d->session = rhs.session();
+    d->cpuAffinity = rhs.cpuAffinity();
     d->noSplash = rhs.noSplash();
     d->fullScreen = rhs.fullScreen();
 }
@@ -167,10 +175,12 @@ void KisApplicationArguments::operator=(const KisApplicationArguments &rhs)
     d->doTemplate = rhs.doTemplate();
     d->exportAs = rhs.exportAs();
     d->exportFileName = rhs.exportFileName();
+    d->exportBatch = rhs.exportBatch();
     d->canvasOnly = rhs.canvasOnly();
     d->workspace = rhs.workspace();
     d->windowLayout = rhs.windowLayout();
     d->session = rhs.session();
+    d->cpuAffinity = rhs.cpuAffinity();
     d->noSplash = rhs.noSplash();
     d->fullScreen = rhs.fullScreen();
 }
@@ -284,6 +294,16 @@ QString KisApplicationArguments::exportFileName() const
     return d->exportFileName;
 }
 
+QString KisApplicationArguments::exportBatch() const
+{
+    return d->exportBatch;
+}
+
+QString KisApplicationArguments::cpuAffinity() const
+{
+    return d->cpuAffinity;
+}
+
 QString KisApplicationArguments::workspace() const
 {
     return d->workspace;
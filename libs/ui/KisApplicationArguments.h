@@ -35,10 +35,12 @@ public:
     bool exportAs() const;
     bool exportSequence() const;
     QString exportFileName() const;
+    QString exportBatch() const;
     QString workspace() const;
     QString windowLayout() const;
     QString session() const;
     QString fileLayer() const;
+    QString cpuAffinity() const;
     bool canvasOnly() const;
     bool noSplash() const;
     bool fullScreen() const;
@@ -14,37 +14,65 @@
 #include "kis_time_span.h"
 #include "kis_paint_layer.h"
 
+#include <QtConcurrent>
 
-struct KisAsyncAnimationFramesSavingRenderer::Private
+
+namespace {
+
+struct SavingTarget
 {
-    Private(KisImageSP image, const KisTimeSpan &_range, int _sequenceNumberingOffset, bool _onlyNeedsUniqueFrames, KisPropertiesConfigurationSP _exportConfiguration)
-        : savingDoc(KisPart::instance()->createDocument()),
-          range(_range),
-          sequenceNumberingOffset(_sequenceNumberingOffset),
-          onlyNeedsUniqueFrames(_onlyNeedsUniqueFrames),
-          exportConfiguration(_exportConfiguration)
+    SavingTarget(KisImageSP image)
+        : doc(KisPart::instance()->createDocument())
     {
+        doc->setInfiniteAutoSaveInterval();
+        doc->setFileBatchMode(true);
 
-        savingDoc->setInfiniteAutoSaveInterval();
-        savingDoc->setFileBatchMode(true);
-
-        KisImageSP savingImage = new KisImage(savingDoc->createUndoStore(),
+        KisImageSP savingImage = new KisImage(doc->createUndoStore(),
                                               image->bounds().width(),
                                               image->bounds().height(),
                                               image->colorSpace(),
                                               QString());
 
         savingImage->setResolution(image->xRes(), image->yRes());
-        savingDoc->setCurrentImage(savingImage);
+        doc->setCurrentImage(savingImage);
 
         KisPaintLayer* paintLayer = new KisPaintLayer(savingImage, "paint device", 255);
         savingImage->addNode(paintLayer, savingImage->root(), KisLayerSP(0));
 
-        savingDevice = paintLayer->paintDevice();
+        device = paintLayer->paintDevice();
+    }
+
+    QScopedPointer<KisDocument> doc;
+    KisPaintDeviceSP device;
+};
+
+}
+
+struct KisAsyncAnimationFramesSavingRenderer::Private
+{
+    Private(KisImageSP image, const KisTimeSpan &_range, int _sequenceNumberingOffset, bool _onlyNeedsUniqueFrames, KisPropertiesConfigurationSP _exportConfiguration)
+        : range(_range),
+          sequenceNumberingOffset(_sequenceNumberingOffset),
+          onlyNeedsUniqueFrames(_onlyNeedsUniqueFrames),
+          exportConfiguration(_exportConfiguration)
+    {
+        /**
+         * Two documents are used in turns: while one of them is being
+         * written to disk, the projection of the next frame is already
+         * regenerated and copied into the other one.
+         */
+        savingTargets[0].reset(new SavingTarget(image));
+        savingTargets[1].reset(new SavingTarget(image));
     }
 
-    QScopedPointer<KisDocument> savingDoc;
-    KisPaintDeviceSP savingDevice;
+    bool saveFrame(SavingTarget *target, int frame, const KisTimeSpan &identicals);
+
+    QScopedPointer<SavingTarget> savingTargets[2];
+    int currentSavingTarget = 0;
+
+    /// the frame which is still being written to disk, if any
+    QFuture<bool> pendingSave;
+    bool hasPendingSave = false;
 
     KisTimeSpan range;
     int sequenceNumberingOffset = 0;
@@ -81,6 +109,7 @@ KisAsyncAnimationFramesSavingRenderer::KisAsyncAnimationFramesSavingRenderer(Kis
 
 KisAsyncAnimationFramesSavingRenderer::~KisAsyncAnimationFramesSavingRenderer()
 {
+    m_d->pendingSave.waitForFinished();
 }
 
 void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, const KisRegion &requestedRegion)
@@ -93,24 +122,50 @@ void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, co
         return;
     }
 
-    m_d->savingDevice->makeCloneFromRough(image->projection(), image->bounds());
-
-    KisImportExportErrorCode status = ImportExportCodes::OK;
+    if (!waitForPendingFrames()) {
+        emit sigCancelRegenerationInternal(frame);
+        return;
+    }
 
-    QString frameNumber = QString("%1").arg(frame + m_d->sequenceNumberingOffset, 4, 10, QChar('0'));
-    QString filename = m_d->filenamePrefix + frameNumber + m_d->filenameSuffix;
+    SavingTarget *target = m_d->savingTargets[m_d->currentSavingTarget].data();
+    m_d->currentSavingTarget = (m_d->currentSavingTarget + 1) % 2;
 
-    if (!m_d->savingDoc->exportDocumentSync(QUrl::fromLocalFile(filename), m_d->outputMimeType, m_d->exportConfiguration)) {
-        status = ImportExportCodes::InternalError;
-    }
+    target->device->makeCloneFromRough(image->projection(), image->bounds());
 
     //Get all identical frames to this one and either copy or symlink based on settings.
     KisTimeSpan identicals = KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
     identicals &= m_d->range;
-    if( !m_d->onlyNeedsUniqueFrames && identicals.start() < identicals.end() ) {
+
+    /**
+     * The image is free to regenerate the next frame as soon as its
+     * projection is copied, so the frame is written to disk in the
+     * background. The failure is reported when the next frame arrives
+     * or in waitForPendingFrames().
+     */
+    m_d->pendingSave = QtConcurrent::run(
+        [this, target, frame, identicals] () {
+            return m_d->saveFrame(target, frame, identicals);
+        });
+    m_d->hasPendingSave = true;
+
+    emit sigCompleteRegenerationInternal(frame);
+}
+
+bool KisAsyncAnimationFramesSavingRenderer::Private::saveFrame(SavingTarget *target, int frame, const KisTimeSpan &identicals)
+{
+    bool result = true;
+
+    QString frameNumber = QString("%1").arg(frame + sequenceNumberingOffset, 4, 10, QChar('0'));
+    QString filename = filenamePrefix + frameNumber + filenameSuffix;
+
+    if (!target->doc->exportDocumentSync(QUrl::fromLocalFile(filename), outputMimeType, exportConfiguration)) {
+        result = false;
+    }
+
+    if( !onlyNeedsUniqueFrames && identicals.start() < identicals.end() ) {
         for (int identicalFrame = (identicals.start() + 1); identicalFrame <= identicals.end(); identicalFrame++) {
-            QString identicalFrameNumber = QString("%1").arg(identicalFrame + m_d->sequenceNumberingOffset, 4, 10, QChar('0'));
-            QString identicalFrameName = m_d->filenamePrefix + identicalFrameNumber + m_d->filenameSuffix;
+            QString identicalFrameNumber = QString("%1").arg(identicalFrame + sequenceNumberingOffset, 4, 10, QChar('0'));
+            QString identicalFrameName = filenamePrefix + identicalFrameNumber + filenameSuffix;
 
             QFile::copy(filename, identicalFrameName);
 
@@ -126,11 +181,18 @@ void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, co
         }
     }
 
-    if (status.isOk()) {
-        emit sigCompleteRegenerationInternal(frame);
-    } else {
-        emit sigCancelRegenerationInternal(frame);
-    }
+    return result;
+}
+
+bool KisAsyncAnimationFramesSavingRenderer::waitForPendingFrames()
+{
+    if (!m_d->hasPendingSave) return true;
+
+    const bool result = m_d->pendingSave.result();
+    m_d->pendingSave = QFuture<bool>();
+    m_d->hasPendingSave = false;
+
+    return result;
 }
 
 void KisAsyncAnimationFramesSavingRenderer::frameCancelledCallback(int frame)
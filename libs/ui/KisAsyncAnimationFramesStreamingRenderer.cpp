@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAsyncAnimationFramesStreamingRenderer.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_time_span.h"
+
+
+struct KisAsyncAnimationFramesStreamingRenderer::Private
+{
+    Private(const KisTimeSpan &_range, bool _forceSRGB)
+        : range(_range),
+          forceSRGB(_forceSRGB)
+    {
+    }
+
+    KisTimeSpan range;
+    bool forceSRGB = false;
+};
+
+KisAsyncAnimationFramesStreamingRenderer::KisAsyncAnimationFramesStreamingRenderer(const KisTimeSpan &range, bool forceSRGB)
+    : m_d(new Private(range, forceSRGB))
+{
+    connect(this, SIGNAL(sigCompleteRegenerationInternal(int)), SLOT(notifyFrameCompleted(int)));
+    connect(this, SIGNAL(sigCancelRegenerationInternal(int)), SLOT(notifyFrameCancelled(int)));
+}
+
+KisAsyncAnimationFramesStreamingRenderer::~KisAsyncAnimationFramesStreamingRenderer()
+{
+}
+
+void KisAsyncAnimationFramesStreamingRenderer::frameCompletedCallback(int frame, const KisRegion &requestedRegion)
+{
+    KisImageSP image = requestedImage();
+    if (!image) return;
+
+    KIS_SAFE_ASSERT_RECOVER (requestedRegion == image->bounds()) {
+        emit sigCancelRegenerationInternal(frame);
+        return;
+    }
+
+    KisPaintDeviceSP device = image->projection();
+    const KoColorSpace *srgb = KoColorSpaceRegistry::instance()->rgb8();
+
+    if (m_d->forceSRGB && *device->colorSpace() != *srgb) {
+        device = new KisPaintDevice(*device);
+        device->convertTo(srgb);
+    }
+
+    const QRect bounds = image->bounds();
+    QByteArray pixels(bounds.width() * bounds.height() * device->pixelSize(), Qt::Uninitialized);
+    device->readBytes(reinterpret_cast<quint8*>(pixels.data()), bounds);
+
+    // the encoder gets a copy of the frame for every frame it is held for
+    KisTimeSpan identicals = KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
+    identicals &= m_d->range;
+
+    const int numFrames = identicals.isValid() ? identicals.end() - frame + 1 : 1;
+
+    emit sigFrameDataReady(frame, qMax(1, numFrames), pixels);
+    emit sigCompleteRegenerationInternal(frame);
+}
+
+void KisAsyncAnimationFramesStreamingRenderer::frameCancelledCallback(int frame)
+{
+    notifyFrameCancelled(frame);
+}
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISASYNCANIMATIONFRAMESSTREAMINGRENDERER_H
+#define KISASYNCANIMATIONFRAMESSTREAMINGRENDERER_H
+
+#include <KisAsyncAnimationRendererBase.h>
+
+class KisTimeSpan;
+
+/**
+ * Renders the frames into raw pixel buffers, which are passed to the
+ * video encoder directly instead of being saved as image files.
+ *
+ * The pixels are 8-bit BGRA, the same as the ones of an RGBA8 image.
+ * If \p forceSRGB is true, the frames are converted to sRGB first.
+ */
+class KisAsyncAnimationFramesStreamingRenderer : public KisAsyncAnimationRendererBase
+{
+    Q_OBJECT
+public:
+    KisAsyncAnimationFramesStreamingRenderer(const KisTimeSpan &range, bool forceSRGB);
+    ~KisAsyncAnimationFramesStreamingRenderer();
+
+protected:
+    void frameCompletedCallback(int frame, const KisRegion &requestedRegion) override;
+    void frameCancelledCallback(int frame) override;
+
+Q_SIGNALS:
+    /**
+     * Emitted from the image worker thread when the pixels of \p frame are
+     * ready. The frame is held for \p numFrames frames of the range.
+     */
+    void sigFrameDataReady(int frame, int numFrames, const QByteArray &pixels);
+
+    void sigCompleteRegenerationInternal(int frame);
+    void sigCancelRegenerationInternal(int frame);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISASYNCANIMATIONFRAMESSTREAMINGRENDERER_H
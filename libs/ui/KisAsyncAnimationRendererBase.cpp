@@ -77,6 +77,11 @@ bool KisAsyncAnimationRendererBase::isActive() const
     return m_d->requestedImage;
 }
 
+bool KisAsyncAnimationRendererBase::waitForPendingFrames()
+{
+    return true;
+}
+
 void KisAsyncAnimationRendererBase::cancelCurrentFrameRendering()
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->requestedImage);
@@ -48,6 +48,15 @@ public:
      */
     bool isActive() const;
 
+    /**
+     * Waits until the frames that have already been reported as completed
+     * are fully processed, e.g. written to disk. Should be called from the
+     * GUI thread when the image is idle.
+     *
+     * @return false if the processing of any of these frames has failed
+     */
+    virtual bool waitForPendingFrames();
+
 public Q_SLOTS:
     /**
      * @brief cancels current rendering operation
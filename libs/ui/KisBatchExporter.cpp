@@ -0,0 +1,282 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisBatchExporter.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+
+#include <klocalizedstring.h>
+
+#include <KisMimeDatabase.h>
+#include <KisUsageLogger.h>
+#include <kis_debug.h>
+#include <kis_memory_statistics_server.h>
+
+#include "KisDocument.h"
+#include "KisImportExportUtils.h"
+#include "KisPart.h"
+
+struct KisBatchExporter::Private
+{
+    QList<Job> pendingJobs;
+
+    /**
+     * The jobs whose documents are kept in memory, i.e. the ones being
+     * loaded or saved. The documents are owned by the exporter.
+     */
+    QHash<KisDocument*, Job> runningJobs;
+
+    int maxConcurrentJobs = qBound(1, QThread::idealThreadCount() / 2, 4);
+    int numFailedJobs = 0;
+    bool isRunning = false;
+    bool startScheduled = false;
+
+    static bool memoryIsExhausted();
+};
+
+bool KisBatchExporter::Private::memoryIsExhausted()
+{
+    const KisMemoryStatisticsServer::Statistics stats =
+        KisMemoryStatisticsServer::instance()->fetchMemoryStatistics(0);
+
+    return stats.tilesSoftLimit > 0 && stats.realMemorySize >= stats.tilesSoftLimit;
+}
+
+KisBatchExporter::KisBatchExporter(QObject *parent)
+    : QObject(parent),
+      m_d(new Private)
+{
+}
+
+KisBatchExporter::~KisBatchExporter()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->runningJobs.isEmpty());
+
+    Q_FOREACH (KisDocument *document, m_d->runningJobs.keys()) {
+        document->disconnect(this);
+        document->waitForSavingToComplete();
+        delete document;
+    }
+}
+
+bool KisBatchExporter::loadJobList(const QString &fileName, QVector<Job> *jobs, QString *errorMessage)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorMessage) {
+            *errorMessage = i18n("Could not open the job list %1: %2", fileName, file.errorString());
+        }
+        return false;
+    }
+
+    const QDir baseDir = QFileInfo(fileName).absoluteDir();
+
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+
+    int lineNumber = 0;
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine();
+        lineNumber++;
+
+        if (line.trimmed().isEmpty() || line.trimmed().startsWith('#')) continue;
+
+        const QStringList fields = line.split('\t');
+        if (fields.size() < 2 || fields.size() > 3 ||
+            fields[0].isEmpty() || fields[1].isEmpty()) {
+
+            if (errorMessage) {
+                *errorMessage = i18n("Line %1 of the job list %2 should contain the input and output filenames separated by a tab", lineNumber, fileName);
+            }
+            return false;
+        }
+
+        Job job;
+        job.inputFileName = baseDir.absoluteFilePath(fields[0]);
+        job.outputFileName = baseDir.absoluteFilePath(fields[1]);
+        if (fields.size() > 2) {
+            job.outputMimeType = fields[2].trimmed().toLatin1();
+        }
+        jobs->append(job);
+    }
+
+    return true;
+}
+
+void KisBatchExporter::addJob(const Job &job)
+{
+    m_d->pendingJobs.append(job);
+
+    if (m_d->isRunning) {
+        scheduleStartPendingJobs();
+    }
+}
+
+void KisBatchExporter::addJobs(const QVector<Job> &jobs)
+{
+    Q_FOREACH (const Job &job, jobs) {
+        addJob(job);
+    }
+}
+
+void KisBatchExporter::setMaxConcurrentJobs(int value)
+{
+    m_d->maxConcurrentJobs = qMax(1, value);
+}
+
+int KisBatchExporter::maxConcurrentJobs() const
+{
+    return m_d->maxConcurrentJobs;
+}
+
+void KisBatchExporter::start()
+{
+    if (m_d->isRunning) return;
+
+    KisUsageLogger::log(QString("Starting batch export of %1 files, %2 at a time")
+                        .arg(m_d->pendingJobs.size())
+                        .arg(m_d->maxConcurrentJobs));
+
+    m_d->isRunning = true;
+
+    scheduleStartPendingJobs();
+}
+
+bool KisBatchExporter::exec()
+{
+    const int numFailedBefore = m_d->numFailedJobs;
+
+    QEventLoop loop;
+    connect(this, SIGNAL(sigFinished()), &loop, SLOT(quit()));
+
+    start();
+    loop.exec();
+
+    return m_d->numFailedJobs == numFailedBefore;
+}
+
+bool KisBatchExporter::isRunning() const
+{
+    return m_d->isRunning;
+}
+
+int KisBatchExporter::numFailedJobs() const
+{
+    return m_d->numFailedJobs;
+}
+
+void KisBatchExporter::scheduleStartPendingJobs()
+{
+    if (m_d->startScheduled) return;
+
+    m_d->startScheduled = true;
+    QTimer::singleShot(0, this, SLOT(slotStartPendingJobs()));
+}
+
+void KisBatchExporter::slotStartPendingJobs()
+{
+    m_d->startScheduled = false;
+
+    if (!m_d->isRunning) return;
+
+    if (m_d->pendingJobs.isEmpty()) {
+        if (m_d->runningJobs.isEmpty()) {
+            m_d->isRunning = false;
+            emit sigFinished();
+        }
+        return;
+    }
+
+    if (m_d->runningJobs.size() >= m_d->maxConcurrentJobs) return;
+
+    /**
+     * Loading one more document while the memory is exhausted would
+     * just push the others into the swap. The next attempt is made
+     * when one of the running jobs completes.
+     */
+    if (!m_d->runningJobs.isEmpty() && m_d->memoryIsExhausted()) return;
+
+    const Job job = m_d->pendingJobs.takeFirst();
+
+    QByteArray mimeType = job.outputMimeType;
+    if (mimeType.isEmpty()) {
+        mimeType = KisMimeDatabase::mimeTypeForFile(job.outputFileName, false).toLatin1();
+    }
+
+    KisDocument *document = KisPart::instance()->createDocument();
+    document->setFileBatchMode(true);
+
+    // register the job before loading, loading may process the completion of other jobs
+    m_d->runningJobs.insert(document, job);
+
+    connect(document, SIGNAL(sigCompleteBackgroundSaving(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString)),
+            this, SLOT(slotSavingCompleted(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString)));
+
+    QString errorMessage;
+
+    if (mimeType.isEmpty()) {
+        errorMessage = i18n("Unknown file format of %1", job.outputFileName);
+    } else if (!document->openUrl(QUrl::fromLocalFile(job.inputFileName), KisDocument::DontAddToRecent)) {
+        errorMessage = i18n("Could not load %1: %2", job.inputFileName, document->errorMessage());
+    } else {
+        qApp->processEvents(); // For vector layers to be updated
+
+        /**
+         * The document is saved by a background saver, so the next
+         * document can be loaded while this one is being saved
+         */
+        const bool started =
+            document->exportDocument(QUrl::fromLocalFile(job.outputFileName),
+                                     mimeType, false, job.exportConfiguration);
+
+        if (!started && m_d->runningJobs.contains(document)) {
+            errorMessage = i18n("Could not export %1 to %2: %3", job.inputFileName, job.outputFileName, document->errorMessage());
+        }
+    }
+
+    if (!errorMessage.isEmpty() && m_d->runningJobs.contains(document)) {
+        m_d->runningJobs.remove(document);
+        m_d->numFailedJobs++;
+        document->deleteLater();
+
+        errKrita << errorMessage;
+        emit sigJobFinished(job.inputFileName, job.outputFileName, false, errorMessage);
+    }
+
+    scheduleStartPendingJobs();
+}
+
+void KisBatchExporter::slotSavingCompleted(const KritaUtils::ExportFileJob &exportJob, KisImportExportErrorCode status, const QString &errorMessage)
+{
+    Q_UNUSED(exportJob);
+
+    KisDocument *document = qobject_cast<KisDocument*>(sender());
+    if (!document || !m_d->runningJobs.contains(document)) return;
+
+    const Job job = m_d->runningJobs.take(document);
+    document->deleteLater();
+
+    QString message;
+    if (!status.isOk()) {
+        message = i18n("Could not export %1 to %2: %3", job.inputFileName, job.outputFileName,
+                       errorMessage.isEmpty() ? status.errorMessage() : errorMessage);
+        m_d->numFailedJobs++;
+        errKrita << message;
+    }
+
+    emit sigJobFinished(job.inputFileName, job.outputFileName, status.isOk(), message);
+
+    scheduleStartPendingJobs();
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISBATCHEXPORTER_H
+#define KISBATCHEXPORTER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QVector>
+
+#include "kritaui_export.h"
+#include "kis_properties_configuration.h"
+#include "KisImportExportErrorCode.h"
+
+namespace KritaUtils {
+struct ExportFileJob;
+}
+
+/**
+ * Converts a list of files in one go, without showing any windows or
+ * dialogs, e.g. for the --export-batch command line option or from
+ * the scripts.
+ *
+ * The resources are loaded only once, when Krita starts, and several
+ * jobs are run at the same time: while the previous documents are
+ * being saved by the background savers, the next one is loaded on the
+ * GUI thread. The number of the documents kept in memory is limited
+ * by maxConcurrentJobs(), and no new document is loaded while the tile
+ * engine uses more memory than its soft limit.
+ *
+ * All the methods should be called from the GUI thread.
+ */
+class KRITAUI_EXPORT KisBatchExporter : public QObject
+{
+    Q_OBJECT
+public:
+    struct Job {
+        QString inputFileName;
+        QString outputFileName;
+
+        /// if empty, the mimetype is guessed from the extension of outputFileName
+        QByteArray outputMimeType;
+
+        /// if null, the last used configuration of the export filter is used
+        KisPropertiesConfigurationSP exportConfiguration;
+    };
+
+    KisBatchExporter(QObject *parent = 0);
+    ~KisBatchExporter() override;
+
+    /**
+     * Reads the jobs from the job list in \p fileName. Every line of
+     * the list contains the input filename, the output filename and,
+     * optionally, the output mimetype, separated by tabs. Empty lines
+     * and lines starting with '#' are skipped, relative paths are
+     * resolved against the directory of the list.
+     *
+     * \return false and sets \p errorMessage if the list cannot be read
+     */
+    static bool loadJobList(const QString &fileName, QVector<Job> *jobs, QString *errorMessage = 0);
+
+    void addJob(const Job &job);
+    void addJobs(const QVector<Job> &jobs);
+
+    /**
+     * The maximum number of the documents loaded at the same time,
+     * by default it depends on the number of the cores.
+     */
+    void setMaxConcurrentJobs(int value);
+    int maxConcurrentJobs() const;
+
+    /**
+     * Starts processing the added jobs, sigFinished() is emitted
+     * when all of them are done
+     */
+    void start();
+
+    /**
+     * Processes the added jobs and returns when all of them are done,
+     * spinning an event loop meanwhile
+     *
+     * \return true if all the jobs have succeeded
+     */
+    bool exec();
+
+    bool isRunning() const;
+
+    /// \return the number of the jobs that failed since the exporter was created
+    int numFailedJobs() const;
+
+Q_SIGNALS:
+    void sigJobFinished(const QString &inputFileName, const QString &outputFileName,
+                        bool success, const QString &errorMessage);
+    void sigFinished();
+
+private Q_SLOTS:
+    void slotStartPendingJobs();
+    void slotSavingCompleted(const KritaUtils::ExportFileJob &job, KisImportExportErrorCode status, const QString &errorMessage);
+
+private:
+    void scheduleStartPendingJobs();
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISBATCHEXPORTER_H
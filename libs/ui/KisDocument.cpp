@@ -122,6 +122,7 @@
 #include <KisMirrorAxisConfig.h>
 #include <KisDecorationsWrapperLayer.h>
 #include "kis_simple_stroke_strategy.h"
+#include "KisImageMemoryBudget.h"
 
 // Define the protocol used here for embedded documents' URL
 // This used to "store" but QUrl didn't like it,
@@ -248,6 +249,7 @@ public:
             unit = KoUnit::Centimeter;
         }
         connect(&imageIdleWatcher, SIGNAL(startedIdleMode()), q, SLOT(slotPerformIdleRoutines()));
+        tileStreamCache.reset(new KisTileStreamCache());
     }
 
     Private(const Private &rhs, KisDocument *_q)
@@ -343,6 +345,9 @@ public:
     QString documentStorageID {QUuid::createUuid().toString()};
     KisResourceStorageSP documentResourceStorage;
 
+    /// shared with the clones of the document created for saving
+    KisTileStreamCacheSP tileStreamCache;
+
     void syncDecorationsWrapperLayerState();
 
     void setImageAndInitIdleWatcher(KisImageSP _image) {
@@ -445,6 +450,7 @@ void KisDocument::Private::copyFromImpl(const Private &rhs, KisDocument *q, KisD
     // XXX: the display properties will be shared between different snapshots
     globalAssistantsColor = rhs.globalAssistantsColor;
     batchMode = rhs.batchMode;
+    tileStreamCache = rhs.tileStreamCache;
 
     // CHECK THIS! This is what happened to the palette list -- but is it correct here as well? Ask Dmitry!!!
     //    if (policy == REPLACE) {
@@ -586,6 +592,9 @@ KisDocument::~KisDocument()
         d->image->requestStrokeCancellation();
         d->image->waitForDone();
 
+        d->image->memoryBudget()->setStepHandler(KisImageMemoryBudget::TrimUndoHistory,
+                                                 KisImageMemoryBudget::StepHandler());
+
         // clear undo commands that can still point to the image
         d->undoStack->clear();
         d->image->waitForDone();
@@ -1150,19 +1159,28 @@ void KisDocument::slotAutoSaveImpl(std::unique_ptr<KisDocument> &&optionalCloned
     KisUsageLogger::log(QString("Autosaving: %1").arg(autoSaveFileName));
 
     const bool hadClonedDocument = bool(optionalClonedDocument);
+    const bool imageIsIdle = d->image->isIdle();
     bool started = false;
 
-    if (d->image->isIdle() || hadClonedDocument) {
+    if (imageIsIdle || hadClonedDocument) {
         started = initiateSavingInBackground(i18n("Autosaving..."),
                                              this, SLOT(slotCompleteAutoSaving(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString)),
                                              KritaUtils::ExportFileJob(autoSaveFileName, nativeFormatMimeType(), KritaUtils::SaveIsExporting | KritaUtils::SaveInAutosaveMode),
                                              0,
                                              std::move(optionalClonedDocument));
-    } else {
-        emit statusBarMessage(i18n("Autosaving postponed: document is busy..."), errorMessageTimeout);
     }
 
-    if (!started && !hadClonedDocument && d->autoSaveFailureCount >= 3) {
+    if (!started && !hadClonedDocument &&
+        (!imageIsIdle || d->autoSaveFailureCount >= 3)) {
+
+        /**
+         * When the image is busy, we don't wait for it in a barrier lock,
+         * which would freeze the canvas. Instead we take a snapshot of the
+         * document in a barrier job of the strokes queue. Cloning shares
+         * the tiles of the paint devices in copy-on-write manner, so the
+         * exclusive part is short, and the user can continue painting
+         * while the snapshot is being saved.
+         */
         KisCloneDocumentStroke *stroke = new KisCloneDocumentStroke(this);
         connect(stroke, SIGNAL(sigDocumentCloned(KisDocument*)),
                 this, SLOT(slotInitiateAsyncAutosaving(KisDocument*)),
@@ -2349,12 +2367,19 @@ KisImageSP KisDocument::savingImage() const
     return d->savingImage;
 }
 
+KisTileStreamCacheSP KisDocument::tileStreamCache() const
+{
+    return d->tileStreamCache;
+}
+
 
 void KisDocument::setCurrentImage(KisImageSP image, bool forceInitialUpdate)
 {
     if (d->image) {
         // Disconnect existing sig/slot connections
         d->image->setUndoStore(new KisDumbUndoStore());
+        d->image->memoryBudget()->setStepHandler(KisImageMemoryBudget::TrimUndoHistory,
+                                                 KisImageMemoryBudget::StepHandler());
         d->image->disconnect(this);
         d->shapeController->setImage(0);
         d->image = 0;
@@ -2368,6 +2393,12 @@ void KisDocument::setCurrentImage(KisImageSP image, bool forceInitialUpdate)
 
     d->setImageAndInitIdleWatcher(image);
     d->image->setUndoStore(new KisDocumentUndoStore(this));
+    d->image->memoryBudget()->setStepHandler(KisImageMemoryBudget::TrimUndoHistory,
+        [this] () {
+            // drop the oldest half of the history on every step
+            const int numCommands = qMax(1, d->undoStack->index() / 2);
+            return d->undoStack->purgeUndoHistory(numCommands) > 0;
+        });
     d->shapeController->setImage(image);
     setModified(false);
     connect(d->image, SIGNAL(sigImageModified()), this, SLOT(setImageModified()), Qt::UniqueConnection);
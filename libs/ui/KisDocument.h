@@ -21,6 +21,7 @@
 #include <KisImportExportFilter.h>
 #include <kis_properties_configuration.h>
 #include <kis_types.h>
+#include <tiles3/KisTileStreamCache.h>
 #include <kis_painting_assistant.h>
 #include <KisReferenceImage.h>
 #include <kis_debug.h>
@@ -595,6 +596,13 @@ public:
      */
     KisImageSP savingImage() const;
 
+    /**
+     * @return the cache of the tiles compressed by the previous saves of
+     * the document. It is shared between the document and its clones, so
+     * the savers of the clones don't compress the unchanged tiles again.
+     */
+    KisTileStreamCacheSP tileStreamCache() const;
+
     /**
      * Set the current image to the specified image and turn undo on.
      */
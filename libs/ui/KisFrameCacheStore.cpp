@@ -115,8 +115,8 @@ FrameInfo::~FrameInfo()
 
 struct KRITAUI_NO_EXPORT KisFrameCacheStore::Private
 {
-    Private(const QString &frameCachePath)
-        : serializer(frameCachePath)
+    Private(KisFrameDataSerializer::StorageType storageType, const QString &frameCachePath)
+        : serializer(storageType, frameCachePath)
     {
     }
 
@@ -139,7 +139,12 @@ KisFrameCacheStore::KisFrameCacheStore()
 }
 
 KisFrameCacheStore::KisFrameCacheStore(const QString &frameCachePath)
-    : m_d(new Private(frameCachePath))
+    : KisFrameCacheStore(KisFrameDataSerializer::OnDisk, frameCachePath)
+{
+}
+
+KisFrameCacheStore::KisFrameCacheStore(KisFrameDataSerializer::StorageType storageType, const QString &frameCachePath)
+    : m_d(new Private(storageType, frameCachePath))
 {
 }
 
@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 #include "opengl/kis_texture_tile_info_pool.h"
+#include "KisFrameDataSerializer.h"
 
 class KisOpenGLUpdateInfoBuilder;
 
@@ -33,6 +34,9 @@ typedef KisSharedPtr<KisOpenGLUpdateInfo> KisOpenGLUpdateInfoSP;
  *
  * 4) The in-memory cache of the keyframes is stored in serializable
  *    KisFrameDataSerializer::Frame format.
+ *
+ * With KisFrameDataSerializer::InMemory storage type the compressed
+ * frames are kept in memory instead of the disk.
  */
 
 class KRITAUI_EXPORT KisFrameCacheStore
@@ -40,6 +44,7 @@ class KRITAUI_EXPORT KisFrameCacheStore
 public:
     KisFrameCacheStore();
     KisFrameCacheStore(const QString &frameCachePath);
+    KisFrameCacheStore(KisFrameDataSerializer::StorageType storageType, const QString &frameCachePath);
 
     ~KisFrameCacheStore();
 
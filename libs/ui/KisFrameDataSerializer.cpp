@@ -9,20 +9,26 @@
 
 #include <QTemporaryDir>
 #include <QElapsedTimer>
+#include <QBuffer>
+#include <QHash>
 
 #include "tiles3/swap/kis_lzf_compression.h"
 
 struct KRITAUI_NO_EXPORT KisFrameDataSerializer::Private
 {
-    Private(const QString &frameCachePath)
-        : framesDir(
-              (!frameCachePath.isEmpty() && QTemporaryDir(frameCachePath + "/KritaFrameCacheXXXXXX").isValid()
-               ? frameCachePath
-               : QDir::tempPath())
-              + "/KritaFrameCacheXXXXXX")
+    Private(StorageType _storageType, const QString &frameCachePath)
+        : storageType(_storageType)
     {
-        framesDirObject = QDir(framesDir.path());
-        framesDirObject.makeAbsolute();
+        if (storageType == OnDisk) {
+            framesDir.reset(new QTemporaryDir(
+                (!frameCachePath.isEmpty() && QTemporaryDir(frameCachePath + "/KritaFrameCacheXXXXXX").isValid()
+                 ? frameCachePath
+                 : QDir::tempPath())
+                + "/KritaFrameCacheXXXXXX"));
+
+            framesDirObject = QDir(framesDir->path());
+            framesDirObject.makeAbsolute();
+        }
     }
 
     QString subfolderNameForFrame(int frameId)
@@ -54,10 +60,22 @@ struct KRITAUI_NO_EXPORT KisFrameDataSerializer::Private
         return reinterpret_cast<quint8*>(compressionBuffer.data());
     }
 
-    QTemporaryDir framesDir;
+    void writeFrame(QIODevice *device, int frameId, const Frame &frame);
+    Frame readFrame(QIODevice *device, int frameId, KisTextureTileInfoPoolSP pool);
+
+    StorageType storageType;
+
+    QScopedPointer<QTemporaryDir> framesDir;
     QDir framesDirObject;
     int nextFrameId = 0;
 
+    /**
+     * The compressed frames, when they are kept in memory. The difference
+     * from the keyframes compresses so well, that a frame of a long
+     * animation takes only a fraction of its raw size.
+     */
+    QHash<int, QByteArray> inMemoryFrames;
+
     QByteArray compressionBuffer;
 };
 
@@ -67,7 +85,12 @@ KisFrameDataSerializer::KisFrameDataSerializer()
 }
 
 KisFrameDataSerializer::KisFrameDataSerializer(const QString &frameCachePath)
-    : m_d(new Private(frameCachePath))
+    : KisFrameDataSerializer(OnDisk, frameCachePath)
+{
+}
+
+KisFrameDataSerializer::KisFrameDataSerializer(StorageType storageType, const QString &frameCachePath)
+    : m_d(new Private(storageType, frameCachePath))
 {
 }
 
@@ -77,10 +100,22 @@ KisFrameDataSerializer::~KisFrameDataSerializer()
 
 int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame)
 {
-    KisLzfCompression compression;
-
     const int frameId = m_d->generateFrameId();
 
+    if (m_d->storageType == InMemory) {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(!m_d->inMemoryFrames.contains(frameId));
+
+        QByteArray &frameData = m_d->inMemoryFrames[frameId];
+        frameData.clear();
+
+        QBuffer buffer(&frameData);
+        buffer.open(QBuffer::WriteOnly);
+        m_d->writeFrame(&buffer, frameId, frame);
+        buffer.close();
+
+        return frameId;
+    }
+
     const QString frameSubfolder = m_d->subfolderNameForFrame(frameId);
 
     if (!m_d->framesDirObject.exists(frameSubfolder)) {
@@ -98,8 +133,17 @@ int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame
 
     QFile file(frameFilePath);
     file.open(QFile::WriteOnly);
+    m_d->writeFrame(&file, frameId, frame);
+    file.close();
 
-    QDataStream stream(&file);
+    return frameId;
+}
+
+void KisFrameDataSerializer::Private::writeFrame(QIODevice *device, int frameId, const Frame &frame)
+{
+    KisLzfCompression compression;
+
+    QDataStream stream(device);
     stream << frameId;
     stream << frame.pixelSize;
 
@@ -111,10 +155,13 @@ int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame
         stream << tile.col;
         stream << tile.row;
         stream << tile.rect;
+        stream << tile.isShared;
+
+        if (tile.isShared) continue;
 
         const int frameByteSize = frame.pixelSize * tile.rect.width() * tile.rect.height();
         const int maxBufferSize = compression.outputBufferSize(frameByteSize);
-        quint8 *buffer = m_d->getCompressionBuffer(maxBufferSize);
+        quint8 *buffer = getCompressionBuffer(maxBufferSize);
 
         const int compressedSize =
             compression.compress(tile.data.data(), frameByteSize, buffer, maxBufferSize);
@@ -132,13 +179,30 @@ int KisFrameDataSerializer::saveFrame(const KisFrameDataSerializer::Frame &frame
             stream.writeRawData((char*)tile.data.data(), frameByteSize);
         }
     }
+}
 
-    file.close();
+KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, KisTextureTileInfoPoolSP pool)
+{
+    if (m_d->storageType == InMemory) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->inMemoryFrames.contains(frameId), Frame());
 
-    return frameId;
+        QByteArray frameData = m_d->inMemoryFrames.value(frameId);
+
+        QBuffer buffer(&frameData);
+        buffer.open(QBuffer::ReadOnly);
+        return m_d->readFrame(&buffer, frameId, pool);
+    }
+
+    const QString framePath = m_d->filePathForFrame(frameId);
+
+    QFile file(framePath);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(file.exists());
+    if (!file.open(QFile::ReadOnly)) return Frame();
+
+    return m_d->readFrame(&file, frameId, pool);
 }
 
-KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, KisTextureTileInfoPoolSP pool)
+KisFrameDataSerializer::Frame KisFrameDataSerializer::Private::readFrame(QIODevice *device, int frameId, KisTextureTileInfoPoolSP pool)
 {
     KisLzfCompression compression;
 
@@ -150,13 +214,7 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
 
     qint64 compressionTime = 0;
 
-    const QString framePath = m_d->filePathForFrame(frameId);
-
-    QFile file(framePath);
-    KIS_SAFE_ASSERT_RECOVER_NOOP(file.exists());
-    if (!file.open(QFile::ReadOnly)) return frame;
-
-    QDataStream stream(&file);
+    QDataStream stream(device);
 
     int numTiles = 0;
 
@@ -172,6 +230,12 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
         stream >> tile.col;
         stream >> tile.row;
         stream >> tile.rect;
+        stream >> tile.isShared;
+
+        if (tile.isShared) {
+            frame.frameTiles.push_back(std::move(tile));
+            continue;
+        }
 
         const int frameByteSize = frame.pixelSize * tile.rect.width() * tile.rect.height();
         KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(frameByteSize <= pool->chunkSize(frame.pixelSize),
@@ -185,7 +249,7 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
 
         if (isCompressed) {
             const int maxBufferSize = compression.outputBufferSize(inputSize);
-            quint8 *buffer = m_d->getCompressionBuffer(maxBufferSize);
+            quint8 *buffer = getCompressionBuffer(maxBufferSize);
             stream.readRawData((char*)buffer, inputSize);
 
             tile.data.allocate(frame.pixelSize);
@@ -212,13 +276,19 @@ KisFrameDataSerializer::Frame KisFrameDataSerializer::loadFrame(int frameId, Kis
         frame.frameTiles.push_back(std::move(tile));
     }
 
-    file.close();
-
     return frame;
 }
 
 void KisFrameDataSerializer::moveFrame(int srcFrameId, int dstFrameId)
 {
+    if (m_d->storageType == InMemory) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->inMemoryFrames.contains(srcFrameId));
+        KIS_SAFE_ASSERT_RECOVER_NOOP(!m_d->inMemoryFrames.contains(dstFrameId));
+
+        m_d->inMemoryFrames.insert(dstFrameId, m_d->inMemoryFrames.take(srcFrameId));
+        return;
+    }
+
     const QString srcFramePath = m_d->filePathForFrame(srcFrameId);
     const QString dstFramePath = m_d->filePathForFrame(dstFrameId);
     KIS_SAFE_ASSERT_RECOVER_RETURN(QFileInfo(srcFramePath).exists());
@@ -232,12 +302,21 @@ void KisFrameDataSerializer::moveFrame(int srcFrameId, int dstFrameId)
 
 bool KisFrameDataSerializer::hasFrame(int frameId) const
 {
+    if (m_d->storageType == InMemory) {
+        return m_d->inMemoryFrames.contains(frameId);
+    }
+
     const QString framePath = m_d->filePathForFrame(frameId);
     return QFileInfo(framePath).exists();
 }
 
 void KisFrameDataSerializer::forgetFrame(int frameId)
 {
+    if (m_d->storageType == InMemory) {
+        m_d->inMemoryFrames.remove(frameId);
+        return;
+    }
+
     const QString framePath = m_d->filePathForFrame(frameId);
     QFile::remove(framePath);
 }
@@ -302,7 +381,26 @@ bool processData(T *dst, const T *src, int numUnits)
 
 
 template<template <typename U> class OpPolicy>
-bool KisFrameDataSerializer::processFrames(KisFrameDataSerializer::Frame &dst, const KisFrameDataSerializer::Frame &src)
+bool KisFrameDataSerializer::processTile(KisFrameDataSerializer::FrameTile &dstTile, const KisFrameDataSerializer::FrameTile &srcTile, int pixelSize)
+{
+    const int numBytes = srcTile.rect.width() * srcTile.rect.height() * pixelSize;
+    const int numQWords = numBytes / 8;
+
+    const quint64 *srcDataPtr = reinterpret_cast<const quint64*>(srcTile.data.data());
+    quint64 *dstDataPtr = reinterpret_cast<quint64*>(dstTile.data.data());
+
+    bool tileIsSame = processData<OpPolicy>(dstDataPtr, srcDataPtr, numQWords);
+
+    const int tailBytes = numBytes % 8;
+    const quint8 *srcTailDataPtr = srcTile.data.data() + numBytes - tailBytes;
+    quint8 *dstTailDataPtr = dstTile.data.data() + numBytes - tailBytes;
+
+    tileIsSame &= processData<OpPolicy>(dstTailDataPtr, srcTailDataPtr, tailBytes);
+
+    return tileIsSame;
+}
+
+bool KisFrameDataSerializer::subtractFrames(KisFrameDataSerializer::Frame &dst, const KisFrameDataSerializer::Frame &src)
 {
     bool framesAreSame = true;
 
@@ -312,32 +410,39 @@ bool KisFrameDataSerializer::processFrames(KisFrameDataSerializer::Frame &dst, c
         const FrameTile &srcTile = src.frameTiles[i];
         FrameTile &dstTile = dst.frameTiles[i];
 
-        const int numBytes = srcTile.rect.width() * srcTile.rect.height() * src.pixelSize;
-        const int numQWords = numBytes / 8;
-
-        const quint64 *srcDataPtr = reinterpret_cast<const quint64*>(srcTile.data.data());
-        quint64 *dstDataPtr = reinterpret_cast<quint64*>(dstTile.data.data());
-
-        framesAreSame &= processData<OpPolicy>(dstDataPtr, srcDataPtr, numQWords);
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!srcTile.isShared && !dstTile.isShared, false);
 
+        const bool tileIsSame = processTile<std::minus>(dstTile, srcTile, src.pixelSize);
 
-        const int tailBytes = numBytes % 8;
-        const quint8 *srcTailDataPtr = srcTile.data.data() + numBytes - tailBytes;
-        quint8 *dstTailDataPtr = dstTile.data.data() + numBytes - tailBytes;
+        if (tileIsSame) {
+            // most of the tiles of an animation frame don't change
+            dstTile.isShared = true;
+            dstTile.data = DataBuffer(dstTile.data.pool());
+        }
 
-        framesAreSame &= processData<OpPolicy>(dstTailDataPtr, srcTailDataPtr, tailBytes);
+        framesAreSame &= tileIsSame;
     }
 
     return framesAreSame;
 }
 
-bool KisFrameDataSerializer::subtractFrames(KisFrameDataSerializer::Frame &dst, const KisFrameDataSerializer::Frame &src)
-{
-    return processFrames<std::minus>(dst, src);
-}
-
 void KisFrameDataSerializer::addFrames(KisFrameDataSerializer::Frame &dst, const KisFrameDataSerializer::Frame &src)
 {
-    // TODO: don't spend time on calculation of "framesAreSame" in this case
-    (void) processFrames<std::plus>(dst, src);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(estimateFrameUniqueness(src, dst, 0.0));
+
+    for (int i = 0; i < int(src.frameTiles.size()); i++) {
+        const FrameTile &srcTile = src.frameTiles[i];
+        FrameTile &dstTile = dst.frameTiles[i];
+
+        KIS_SAFE_ASSERT_RECOVER_RETURN(!srcTile.isShared);
+
+        if (dstTile.isShared) {
+            dstTile.data.allocate(src.pixelSize);
+            memcpy(dstTile.data.data(), srcTile.data.data(),
+                   src.pixelSize * srcTile.rect.width() * srcTile.rect.height());
+            dstTile.isShared = false;
+        } else {
+            (void) processTile<std::plus>(dstTile, srcTile, src.pixelSize);
+        }
+    }
 }
@@ -27,7 +27,8 @@ class QString;
  *    which contains raw data in it (the data may be not a pixel data,
  *    but a preprocessed pixel differences)
  *
- * 2) Compress this data and save it on disk
+ * 2) Compress this data and save it on disk, or keep the compressed
+ *    data in memory when the swapping is disabled
  */
 
 class KRITAUI_EXPORT KisFrameDataSerializer
@@ -52,10 +53,14 @@ public:
             tile.col = col;
             tile.row = row;
             tile.rect = rect;
-            tile.data.allocate(data.pixelSize());
+            tile.isShared = isShared;
 
-            const int bufferSize = data.pixelSize() * rect.width() * rect.height();
-            memcpy(tile.data.data(), data.data(), bufferSize);
+            if (!isShared) {
+                tile.data.allocate(data.pixelSize());
+
+                const int bufferSize = data.pixelSize() * rect.width() * rect.height();
+                memcpy(tile.data.data(), data.data(), bufferSize);
+            }
 
             return tile;
         }
@@ -63,6 +68,13 @@ public:
         int col = -1;
         int row = -1;
         bool isCompressed = false;
+
+        /**
+         * The tile of a difference frame is the same as the tile of its
+         * base frame, so it has no data and is neither stored nor added
+         */
+        bool isShared = false;
+
         QRect rect;
         DataBuffer data;
     };
@@ -94,9 +106,15 @@ public:
         }
     };
 
+    enum StorageType {
+        OnDisk,
+        InMemory
+    };
+
 public:
     KisFrameDataSerializer();
     KisFrameDataSerializer(const QString &frameCachePath);
+    KisFrameDataSerializer(StorageType storageType, const QString &frameCachePath);
     ~KisFrameDataSerializer();
 
     int saveFrame(const Frame &frame);
@@ -108,12 +126,19 @@ public:
     void forgetFrame(int frameId);
 
     static boost::optional<qreal> estimateFrameUniqueness(const Frame &lhs, const Frame &rhs, qreal portion);
+
+    /**
+     * Subtracts \p src from \p dst. The tiles of \p dst which are the same
+     * as in \p src are marked as shared and their data is released.
+     *
+     * \return true if all the tiles are the same
+     */
     static bool subtractFrames(Frame &dst, const Frame &src);
     static void addFrames(Frame &dst, const Frame &src);
 
 private:
     template<template <typename U> class OpPolicy>
-    static bool processFrames(KisFrameDataSerializer::Frame &dst, const KisFrameDataSerializer::Frame &src);
+    static bool processTile(FrameTile &dst, const FrameTile &src, int pixelSize);
 
 private:
     Q_DISABLE_COPY(KisFrameDataSerializer)
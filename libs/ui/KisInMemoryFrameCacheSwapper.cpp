@@ -5,17 +5,25 @@
  */
 #include "KisInMemoryFrameCacheSwapper.h"
 
-#include <QMap>
-#include <kis_update_info.h>
+#include "KisFrameCacheStore.h"
 
+#include "kis_update_info.h"
+#include "opengl/KisOpenGLUpdateInfoBuilder.h"
 
 struct KRITAUI_NO_EXPORT KisInMemoryFrameCacheSwapper::Private
 {
-    QMap<int, KisOpenGLUpdateInfoSP> framesMap;
+    Private(const KisOpenGLUpdateInfoBuilder &_builder)
+        : frameStore(KisFrameDataSerializer::InMemory, QString()),
+          builder(_builder)
+    {
+    }
+
+    KisFrameCacheStore frameStore;
+    const KisOpenGLUpdateInfoBuilder &builder;
 };
 
-KisInMemoryFrameCacheSwapper::KisInMemoryFrameCacheSwapper()
-    : m_d(new Private)
+KisInMemoryFrameCacheSwapper::KisInMemoryFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &builder)
+    : m_d(new Private(builder))
 {
 }
 
@@ -25,48 +33,38 @@ KisInMemoryFrameCacheSwapper::~KisInMemoryFrameCacheSwapper()
 
 void KisInMemoryFrameCacheSwapper::saveFrame(int frameId, KisOpenGLUpdateInfoSP info, const QRect &imageBounds)
 {
-    Q_UNUSED(imageBounds);
-    KIS_SAFE_ASSERT_RECOVER_NOOP(!m_d->framesMap.contains(frameId));
-
-    m_d->framesMap.insert(frameId, info);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!m_d->frameStore.hasFrame(frameId));
+    m_d->frameStore.saveFrame(frameId, info, imageBounds);
 }
 
 KisOpenGLUpdateInfoSP KisInMemoryFrameCacheSwapper::loadFrame(int frameId)
 {
-    KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->framesMap.contains(frameId));
-    return m_d->framesMap.value(frameId, KisOpenGLUpdateInfoSP());
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->frameStore.hasFrame(frameId), KisOpenGLUpdateInfoSP());
+    return m_d->frameStore.loadFrame(frameId, m_d->builder);
 }
 
 void KisInMemoryFrameCacheSwapper::moveFrame(int srcFrameId, int dstFrameId)
 {
-    KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->framesMap.contains(srcFrameId));
-    KIS_SAFE_ASSERT_RECOVER_NOOP(!m_d->framesMap.contains(dstFrameId));
-
-    m_d->framesMap[dstFrameId] = m_d->framesMap[srcFrameId];
-    m_d->framesMap.remove(srcFrameId);
+    m_d->frameStore.moveFrame(srcFrameId, dstFrameId);
 }
 
 void KisInMemoryFrameCacheSwapper::forgetFrame(int frameId)
 {
-    KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->framesMap.contains(frameId));
-    m_d->framesMap.remove(frameId);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->frameStore.hasFrame(frameId));
+    m_d->frameStore.forgetFrame(frameId);
 }
 
 bool KisInMemoryFrameCacheSwapper::hasFrame(int frameId) const
 {
-    return m_d->framesMap.contains(frameId);
+    return m_d->frameStore.hasFrame(frameId);
 }
 
 int KisInMemoryFrameCacheSwapper::frameLevelOfDetail(int frameId) const
 {
-    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->framesMap.contains(frameId), 0);
-    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_d->framesMap[frameId].isNull(), 0);
-    return m_d->framesMap[frameId]->levelOfDetail();
+    return m_d->frameStore.frameLevelOfDetail(frameId);
 }
 
 QRect KisInMemoryFrameCacheSwapper::frameDirtyRect(int frameId) const
 {
-    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->framesMap.contains(frameId), QRect());
-    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_d->framesMap[frameId].isNull(), QRect());
-    return m_d->framesMap[frameId]->dirtyImageRect();
+    return m_d->frameStore.frameDirtyRect(frameId);
 }
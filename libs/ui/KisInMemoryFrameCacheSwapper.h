@@ -13,11 +13,17 @@
 
 class KisOpenGLUpdateInfoBuilder;
 
-
+/**
+ * KisInMemoryFrameCacheSwapper keeps the cached frames in memory when
+ * the swapping to disk is disabled. The frames are stored the same way
+ * KisFrameCacheSwapper stores them on disk: as LZF-compressed differences
+ * from the keyframes, so that a long animation of a big image would not
+ * exhaust the RAM.
+ */
 class KRITAUI_EXPORT KisInMemoryFrameCacheSwapper : public KisAbstractFrameCacheSwapper
 {
 public:
-    KisInMemoryFrameCacheSwapper();
+    KisInMemoryFrameCacheSwapper(const KisOpenGLUpdateInfoBuilder &builder);
     ~KisInMemoryFrameCacheSwapper();
 
     // WARNING: after transferring \p info to saveFrame() the object becomes invalid
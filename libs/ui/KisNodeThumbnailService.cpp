@@ -0,0 +1,442 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisNodeThumbnailService.h"
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <functional>
+#include <numeric>
+
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_debug.h>
+#include "kis_image.h"
+#include "kis_node.h"
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_signal_compressor.h"
+
+
+namespace {
+
+/**
+ * The sizes of a node that are not requested anymore are dropped, when
+ * there are more than that
+ */
+const int maxThumbnailSizesPerNode = 4;
+
+/**
+ * A long stroke emits thousands of updates, there is no point in
+ * tracking them separately, the thumbnails are small anyway
+ */
+const int maxDirtyRects = 16;
+
+struct ThumbnailPlane {
+    const KisPaintDevice *source = 0;
+    int sequenceNumber = -1;
+    QRect extent;
+    const KoColorSpace *colorSpace = 0;
+
+    KisPaintDeviceSP device;
+    QImage image;
+
+    QVector<QRect> dirtyRects;
+    quint64 lastUsed = 0;
+
+    /**
+     * The sequence number alone is not enough, the device may have been
+     * changed after the number was fetched by the job, but before the
+     * changed area was reported. So every reported area is regenerated.
+     */
+    bool isUpToDate(const KisPaintDevice *dev) const {
+        return dirtyRects.isEmpty() &&
+            source == dev &&
+            sequenceNumber == dev->sequenceNumber() &&
+            colorSpace == dev->colorSpace() &&
+            extent == dev->extent();
+    }
+};
+
+/**
+ * KisPaintDevice::createThumbnail() never returns an image with one
+ * of the dimensions being zero
+ */
+QSize fixThumbnailSize(QSize size)
+{
+    if (!size.width() && size.height()) {
+        size.setWidth(1);
+    }
+
+    if (size.width() && !size.height()) {
+        size.setHeight(1);
+    }
+
+    return size;
+}
+
+QRect mapToThumbnail(const QRect &rect, const QRect &extent, const QSize &deviceSize)
+{
+    const QRect rc = rect & extent;
+    if (rc.isEmpty()) return QRect();
+
+    const qreal xScale = qreal(deviceSize.width()) / extent.width();
+    const qreal yScale = qreal(deviceSize.height()) / extent.height();
+
+    const QRectF thumbnailRect((rc.x() - extent.x()) * xScale,
+                               (rc.y() - extent.y()) * yScale,
+                               rc.width() * xScale,
+                               rc.height() * yScale);
+
+    // the thumbnail pixels are point-sampled, so a pixel of margin is enough
+    return thumbnailRect.toAlignedRect().adjusted(-1, -1, 1, 1) &
+        QRect(QPoint(), deviceSize);
+}
+
+/**
+ * Generates the thumbnail of \p source exactly the way
+ * KisPaintDevice::createThumbnail() does. If \p oldPlane is still
+ * mapped onto the same extent, only its dirty rects are resampled.
+ *
+ * Can be called from any thread.
+ */
+ThumbnailPlane generatePlane(KisPaintDeviceSP source, int sequenceNumber, int maxSize, const ThumbnailPlane &oldPlane)
+{
+    ThumbnailPlane plane;
+    plane.source = source.data();
+    plane.sequenceNumber = sequenceNumber;
+    plane.extent = source->extent();
+    plane.colorSpace = source->colorSpace();
+    plane.lastUsed = oldPlane.lastUsed;
+
+    const QSize imageSize = fixThumbnailSize(plane.extent.size().scaled(maxSize, maxSize, Qt::KeepAspectRatio));
+    if (imageSize.isEmpty()) {
+        return plane;
+    }
+
+    QSize deviceSize = imageSize;
+    if (deviceSize.width() > plane.extent.width() || deviceSize.height() > plane.extent.height()) {
+        deviceSize.scale(plane.extent.size(), Qt::KeepAspectRatio);
+    }
+    deviceSize = fixThumbnailSize(deviceSize);
+
+    const bool canUpdateIncrementally =
+        oldPlane.device &&
+        oldPlane.source == plane.source &&
+        oldPlane.extent == plane.extent &&
+        oldPlane.colorSpace == plane.colorSpace &&
+        oldPlane.image.size() == imageSize &&
+        !oldPlane.dirtyRects.isEmpty();
+
+    if (canUpdateIncrementally) {
+        plane.device = oldPlane.device;
+
+        Q_FOREACH (const QRect &rc, oldPlane.dirtyRects) {
+            const QRect thumbnailRect = mapToThumbnail(rc, plane.extent, deviceSize);
+            if (thumbnailRect.isEmpty()) continue;
+
+            KisPaintDeviceSP patch =
+                source->createThumbnailDevice(deviceSize.width(), deviceSize.height(),
+                                              plane.extent, thumbnailRect);
+            KisPainter::copyAreaOptimized(thumbnailRect.topLeft(), patch, plane.device, thumbnailRect);
+        }
+    } else {
+        plane.device =
+            source->createThumbnailDevice(deviceSize.width(), deviceSize.height(),
+                                          plane.extent, QRect(QPoint(), deviceSize));
+    }
+
+    plane.image = plane.device->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(),
+                                                0, 0, imageSize.width(), imageSize.height(),
+                                                KoColorConversionTransformation::internalRenderingIntent(),
+                                                KoColorConversionTransformation::internalConversionFlags());
+    return plane;
+}
+
+struct JobResult {
+    QVector<int> sizes;
+    QVector<ThumbnailPlane> planes;
+};
+
+}
+
+struct KisNodeThumbnailService::Private
+{
+    Private() : jobsCompressor(250, KisSignalCompressor::FIRST_ACTIVE) {}
+
+    struct NodeEntry {
+        KisNodeWSP node;
+        QMap<int, ThumbnailPlane> planes;
+        QSet<int> wantedSizes;
+        int jobId = -1;
+    };
+
+    KisImageWSP image;
+
+    QHash<const KisNode*, NodeEntry> entries;
+    QVector<KisNodeWSP> pendingNodes;
+    KisSignalCompressor jobsCompressor;
+
+    quint64 useCounter = 0;
+    int nextJobId = 0;
+
+    QThreadPool threadPool;
+
+    NodeEntry* findEntry(const KisNode *node) {
+        auto it = entries.find(node);
+        if (it == entries.end()) return 0;
+
+        // the node has been deleted and another one took its address
+        if (!it->node.isValid()) {
+            entries.erase(it);
+            return 0;
+        }
+
+        return &(*it);
+    }
+
+    void requestJob(KisNodeSP node, NodeEntry *entry);
+    bool finishJob(KisNodeWSP node, int jobId, const JobResult &result);
+};
+
+KisNodeThumbnailService::KisNodeThumbnailService(QObject *parent)
+    : QObject(parent),
+      m_d(new Private)
+{
+    // the thumbnails are never urgent, so don't steal the time of the strokes
+    m_d->threadPool.setMaxThreadCount(1);
+
+    connect(&m_d->jobsCompressor, SIGNAL(timeout()), SLOT(slotStartPendingJobs()));
+}
+
+KisNodeThumbnailService::~KisNodeThumbnailService()
+{
+    m_d->threadPool.waitForDone();
+}
+
+void KisNodeThumbnailService::setImage(KisImageWSP image)
+{
+    if (m_d->image) {
+        m_d->image->disconnect(this);
+    }
+
+    m_d->image = image;
+    m_d->entries.clear();
+    m_d->pendingNodes.clear();
+
+    if (m_d->image) {
+        connect(m_d->image, SIGNAL(sigImageUpdated(QRect)), SLOT(notifyImageUpdated(QRect)));
+    }
+}
+
+QImage KisNodeThumbnailService::thumbnail(KisNodeSP node, int maxSize)
+{
+    KisPaintDeviceSP source = node->thumbnailSourceDevice();
+    if (!source) {
+        return node->createThumbnail(maxSize, maxSize, Qt::KeepAspectRatio);
+    }
+
+    Private::NodeEntry *entry = m_d->findEntry(node.data());
+
+    if (!entry) {
+        Private::NodeEntry newEntry;
+        newEntry.node = node;
+        entry = &(*m_d->entries.insert(node.data(), newEntry));
+    }
+
+    auto it = entry->planes.find(maxSize);
+
+    if (it == entry->planes.end()) {
+        if (entry->planes.isEmpty()) {
+            // the very first thumbnail is generated right away
+            ThumbnailPlane plane = generatePlane(source, source->sequenceNumber(), maxSize, ThumbnailPlane());
+            plane.lastUsed = ++m_d->useCounter;
+            entry->planes.insert(maxSize, plane);
+            return plane.image;
+        }
+
+        entry->wantedSizes.insert(maxSize);
+        m_d->requestJob(node, entry);
+
+        // show the closest size available until the right one is ready
+        const ThumbnailPlane &closest =
+            entry->planes.lowerBound(maxSize) != entry->planes.end() ?
+            *entry->planes.lowerBound(maxSize) : entry->planes.last();
+
+        const QSize imageSize =
+            fixThumbnailSize(closest.extent.size().scaled(maxSize, maxSize, Qt::KeepAspectRatio));
+
+        return !closest.image.isNull() ?
+            closest.image.scaled(imageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation) :
+            closest.image;
+    }
+
+    it->lastUsed = ++m_d->useCounter;
+
+    if (!it->isUpToDate(source.data())) {
+        m_d->requestJob(node, entry);
+    }
+
+    return it->image;
+}
+
+void KisNodeThumbnailService::forgetNode(KisNodeSP node)
+{
+    m_d->entries.remove(node.data());
+}
+
+void KisNodeThumbnailService::notifyImageUpdated(const QRect &rect)
+{
+    for (auto entryIt = m_d->entries.begin(); entryIt != m_d->entries.end(); ++entryIt) {
+        for (auto it = entryIt->planes.begin(); it != entryIt->planes.end(); ++it) {
+            QVector<QRect> &dirtyRects = it->dirtyRects;
+
+            if (dirtyRects.size() >= maxDirtyRects) {
+                const QRect boundingRect =
+                    std::accumulate(dirtyRects.constBegin(), dirtyRects.constEnd(),
+                                    rect, std::bit_or<QRect>());
+                dirtyRects = {boundingRect};
+            } else {
+                dirtyRects << rect;
+            }
+        }
+    }
+}
+
+void KisNodeThumbnailService::Private::requestJob(KisNodeSP node, NodeEntry *entry)
+{
+    if (entry->jobId >= 0) return;
+
+    if (!pendingNodes.contains(node)) {
+        pendingNodes.append(node);
+    }
+
+    jobsCompressor.start();
+}
+
+void KisNodeThumbnailService::slotStartPendingJobs()
+{
+    const QVector<KisNodeWSP> pendingNodes = m_d->pendingNodes;
+    m_d->pendingNodes.clear();
+
+    Q_FOREACH (KisNodeWSP weakNode, pendingNodes) {
+        KisNodeSP node = weakNode;
+        if (!node) continue;
+
+        Private::NodeEntry *entry = m_d->findEntry(node.data());
+        if (!entry || entry->jobId >= 0) continue;
+
+        KisPaintDeviceSP source = node->thumbnailSourceDevice();
+        if (!source) continue;
+
+        // the sequence number is fetched before reading the pixels,
+        // so the changes done while the job is running are not lost
+        const int sequenceNumber = source->sequenceNumber();
+
+        QVector<int> sizes;
+        QVector<ThumbnailPlane> oldPlanes;
+
+        for (auto it = entry->planes.begin(); it != entry->planes.end(); ++it) {
+            if (!it->isUpToDate(source.data())) {
+                sizes << it.key();
+                oldPlanes << *it;
+
+                // the rects are now handled by the job, the new ones are
+                // collected for the next one
+                it->dirtyRects.clear();
+            }
+        }
+
+        Q_FOREACH (int size, entry->wantedSizes) {
+            if (!entry->planes.contains(size)) {
+                sizes << size;
+                ThumbnailPlane plane;
+                plane.lastUsed = ++m_d->useCounter;
+                oldPlanes << plane;
+            }
+        }
+        entry->wantedSizes.clear();
+
+        if (sizes.isEmpty()) continue;
+
+        const int jobId = m_d->nextJobId++;
+        entry->jobId = jobId;
+
+        QFutureWatcher<JobResult> *watcher = new QFutureWatcher<JobResult>(this);
+
+        connect(watcher, &QFutureWatcher<JobResult>::finished, this,
+                [this, watcher, weakNode, jobId] () {
+                    const bool changed = m_d->finishJob(weakNode, jobId, watcher->result());
+                    watcher->deleteLater();
+
+                    KisNodeSP node = weakNode;
+                    if (node && changed) {
+                        emit sigThumbnailUpdated(node);
+                    }
+                });
+
+        watcher->setFuture(QtConcurrent::run(&m_d->threadPool,
+            [source, sequenceNumber, sizes, oldPlanes] () {
+                QThread::currentThread()->setPriority(QThread::LowPriority);
+
+                JobResult result;
+                result.sizes = sizes;
+
+                for (int i = 0; i < sizes.size(); i++) {
+                    result.planes << generatePlane(source, sequenceNumber, sizes[i], oldPlanes[i]);
+                }
+
+                return result;
+            }));
+    }
+}
+
+bool KisNodeThumbnailService::Private::finishJob(KisNodeWSP weakNode, int jobId, const JobResult &result)
+{
+    KisNodeSP node = weakNode;
+    if (!node) return false;
+
+    NodeEntry *entry = findEntry(node.data());
+    if (!entry || entry->jobId != jobId) return false;
+
+    entry->jobId = -1;
+
+    // most of the updates of the image don't touch this very node
+    bool changed = false;
+
+    for (int i = 0; i < result.sizes.size(); i++) {
+        ThumbnailPlane plane = result.planes[i];
+
+        // keep the updates that have come while the job was running
+        auto it = entry->planes.find(result.sizes[i]);
+        if (it != entry->planes.end()) {
+            plane.dirtyRects = it->dirtyRects;
+            plane.lastUsed = it->lastUsed;
+            changed |= plane.image != it->image;
+        } else {
+            changed = true;
+        }
+
+        entry->planes.insert(result.sizes[i], plane);
+    }
+
+    while (entry->planes.size() > maxThumbnailSizesPerNode) {
+        auto leastUsed = entry->planes.begin();
+        for (auto it = entry->planes.begin(); it != entry->planes.end(); ++it) {
+            if (it->lastUsed < leastUsed->lastUsed) {
+                leastUsed = it;
+            }
+        }
+        entry->planes.erase(leastUsed);
+    }
+
+    return changed;
+}
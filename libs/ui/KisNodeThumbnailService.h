@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISNODETHUMBNAILSERVICE_H
+#define KISNODETHUMBNAILSERVICE_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QImage>
+
+#include "kritaui_export.h"
+#include "kis_types.h"
+
+/**
+ * Keeps the thumbnails of the nodes shown in the layer docker.
+ *
+ * Every node has a cache of thumbnails of all the sizes requested for it.
+ * When the node changes, the outdated thumbnail is still returned, while
+ * the new one is generated on a low-priority worker thread. Only the
+ * parts of the thumbnail covering the areas of the image updated since
+ * the previous generation are resampled from the node, as long as the
+ * extent of the node stays the same. When the new thumbnail is ready,
+ * sigThumbnailUpdated() is emitted.
+ *
+ * The only thumbnail generated on the GUI thread is the very first one
+ * of a node, so that the docker never shows an empty thumbnail.
+ *
+ * All the methods should be called from the GUI thread.
+ */
+class KRITAUI_EXPORT KisNodeThumbnailService : public QObject
+{
+    Q_OBJECT
+public:
+    KisNodeThumbnailService(QObject *parent = 0);
+    ~KisNodeThumbnailService() override;
+
+    /**
+     * Drops all the caches and starts tracking the updates of \p image
+     */
+    void setImage(KisImageWSP image);
+
+    /**
+     * \return the thumbnail of \p node fitting into \p maxSize x \p maxSize,
+     * the same as node->createThumbnail(maxSize, maxSize, Qt::KeepAspectRatio).
+     * If the node has changed, the thumbnail may be outdated until
+     * sigThumbnailUpdated() is emitted for the node.
+     */
+    QImage thumbnail(KisNodeSP node, int maxSize);
+
+    /**
+     * Drops the cache of \p node, e.g. when the node is removed
+     */
+    void forgetNode(KisNodeSP node);
+
+public Q_SLOTS:
+    /**
+     * Marks \p rect of all the cached thumbnails as changed. Called
+     * automatically on the updates of the tracked image.
+     */
+    void notifyImageUpdated(const QRect &rect);
+
+Q_SIGNALS:
+    void sigThumbnailUpdated(KisNodeSP node);
+
+private Q_SLOTS:
+    void slotStartPendingJobs();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISNODETHUMBNAILSERVICE_H
@@ -221,7 +221,10 @@ void KisReferenceImage::paint(QPainter &gc, KoShapePaintingContext &/*paintconte
     QTransform devicePixelRatioFTransform = QTransform::fromScale(gc.device()->devicePixelRatioF(), gc.device()->devicePixelRatioF());
     // all three transformations: scale and rotation done by the user, scale from highDPI display, and zoom + rotation of the view
     // order: zoom/rotation of the view; scale to high res; scale and rotation done by the user
-    QImage prescaled = d->mipmap.getClosestWithoutWorkaroundBorder(transform * devicePixelRatioFTransform * gc.transform(), &scale);
+    // the level is drawn without copying it, so that the OpenGL canvas
+    // can keep its texture between the repaints
+    QRect prescaledRect;
+    QImage prescaled = d->mipmap.getClosest(transform * devicePixelRatioFTransform * gc.transform(), &scale, &prescaledRect);
     transform.scale(1.0 / scale, 1.0 / scale);
 
     if (scale > 1.0) {
@@ -233,7 +236,7 @@ void KisReferenceImage::paint(QPainter &gc, KoShapePaintingContext &/*paintconte
     }
     gc.setClipRect(QRectF(QPointF(), shapeSize), Qt::IntersectClip);
     gc.setTransform(transform, true);
-    gc.drawImage(QPoint(), prescaled);
+    gc.drawImage(QRectF(QPointF(), prescaledRect.size()), prescaled, prescaledRect);
 
     gc.restore();
 }
@@ -6,6 +6,8 @@
 
 #include "KisReferenceImagesDecoration.h"
 
+#include <QPaintEngine>
+
 #include "KoShapeManager.h"
 
 #include "kis_algebra_2d.h"
@@ -32,6 +34,14 @@ struct KisReferenceImagesDecoration::Private {
     QTransform previousTransform;
     QSizeF previousViewSize;
 
+    /**
+     * On the OpenGL canvas the references are painted right onto the
+     * canvas, the paint engine keeps the textures of the prescaled
+     * images and transforms them on the GPU, so there is no buffer to
+     * rerender on every pan, zoom or rotation
+     */
+    bool paintDirectly = false;
+
     explicit Private(KisReferenceImagesDecoration *q)
         : q(q)
     {}
@@ -123,7 +133,17 @@ void KisReferenceImagesDecoration::drawDecoration(QPainter &gc, const QRectF &/*
 
     KisSharedPtr<KisReferenceImagesLayer> layer = d->layer.toStrongRef();
 
-    if (!layer.isNull()) {
+    d->paintDirectly = gc.paintEngine() && gc.paintEngine()->type() == QPaintEngine::OpenGL2;
+
+    if (!layer.isNull() && d->paintDirectly) {
+        d->buffer.image = QImage();
+        d->previousViewSize = QSizeF();
+
+        gc.save();
+        gc.setTransform(converter->imageToWidgetTransform(), true);
+        layer->paintReferences(gc);
+        gc.restore();
+    } else if (!layer.isNull()) {
         QSizeF viewSize = view()->size();
 
         QTransform transform = converter->imageToWidgetTransform();
@@ -151,7 +171,9 @@ void KisReferenceImagesDecoration::slotNodeAdded(KisNodeSP node)
 
 void KisReferenceImagesDecoration::slotReferenceImagesChanged(const QRectF &dirtyRect)
 {
-    d->updateBufferByImageCoordinates(dirtyRect);
+    if (!d->paintDirectly) {
+        d->updateBufferByImageCoordinates(dirtyRect);
+    }
 
     QRectF documentRect = view()->viewConverter()->imageToDocument(dirtyRect);
     view()->canvasBase()->updateCanvas(documentRect);
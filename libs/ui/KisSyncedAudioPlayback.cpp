@@ -8,6 +8,9 @@
 
 #ifdef HAVE_QT_MULTIMEDIA
 #include <QtMultimedia/QMediaPlayer>
+#include <QtMultimedia/QAudioDecoder>
+#include <QtMultimedia/QAudioOutput>
+#include <QtMultimedia/QAudioDeviceInfo>
 #else
 class QIODevice;
 
@@ -59,13 +62,165 @@ namespace {
 
 
 #include <QFileInfo>
+#include <QIODevice>
+#include <QtMath>
+#include <cstring>
 
+#include "kis_debug.h"
+
+
+#ifdef HAVE_QT_MULTIMEDIA
+
+namespace {
+
+/// the decoded tracks longer than that are played from the file
+const qint64 maxDecodedTrackSize = 256 * 1024 * 1024;
+
+/// the length of the buffer of the audio output, keeps the latency low
+const qint64 outputBufferMsecs = 50;
+
+/**
+ * Feeds the audio output with the decoded samples, starting from the
+ * sample frame set with seek(). The speed is applied by stepping through
+ * the samples with a fractional step, which changes the pitch the same
+ * way the playback rate of the media player does.
+ */
+class DecodedAudioDevice : public QIODevice
+{
+public:
+    DecodedAudioDevice(const QByteArray &samples, int bytesPerFrame)
+        : m_samples(samples),
+          m_bytesPerFrame(bytesPerFrame),
+          m_numFrames(samples.size() / bytesPerFrame)
+    {
+    }
+
+    void seek(qint64 frame, qint64 endFrame = -1) {
+        m_position = qBound(qint64(0), frame, m_numFrames);
+        m_endFrame = endFrame >= 0 ? qMin(endFrame, m_numFrames) : m_numFrames;
+    }
+
+    qreal position() const {
+        return m_position;
+    }
+
+    void setSpeed(qreal value) {
+        m_speed = value;
+    }
+
+    bool isSequential() const override {
+        return true;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override {
+        const qint64 maxFrames = maxSize / m_bytesPerFrame;
+        const char *src = m_samples.constData();
+
+        qint64 numFrames = 0;
+
+        if (qFuzzyCompare(m_speed, 1.0)) {
+            const qint64 srcFrame = qFloor(m_position);
+            numFrames = qBound(qint64(0), m_endFrame - srcFrame, maxFrames);
+            memcpy(data, src + srcFrame * m_bytesPerFrame, numFrames * m_bytesPerFrame);
+            m_position += numFrames;
+        } else {
+            for (; numFrames < maxFrames; numFrames++) {
+                const qint64 srcFrame = qFloor(m_position);
+                if (srcFrame >= m_endFrame) break;
+
+                memcpy(data + numFrames * m_bytesPerFrame,
+                       src + srcFrame * m_bytesPerFrame,
+                       m_bytesPerFrame);
+
+                m_position += m_speed;
+            }
+        }
+
+        return numFrames * m_bytesPerFrame;
+    }
+
+    qint64 writeData(const char *data, qint64 maxSize) override {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+private:
+    const QByteArray &m_samples;
+    const int m_bytesPerFrame;
+    const qint64 m_numFrames;
+
+    qreal m_position = 0.0;
+    qint64 m_endFrame = 0;
+    qreal m_speed = 1.0;
+};
+
+}
+
+#endif
 
 
 struct KisSyncedAudioPlayback::Private
 {
     QMediaPlayer player;
     qint64 tolerance = 200;
+
+    qreal volume = 0.5;
+    qreal speed = 1.0;
+
+#ifdef HAVE_QT_MULTIMEDIA
+    QScopedPointer<QAudioDecoder> decoder;
+    QAudioFormat format;
+    QByteArray samples;
+
+    QScopedPointer<DecodedAudioDevice> device;
+    QScopedPointer<QAudioOutput> output;
+    bool outputPlaying = false;
+
+    bool isDecoded() const {
+        return !output.isNull();
+    }
+
+    qint64 msecToFrame(qint64 msec) const {
+        return qRound64(msec * format.sampleRate() / 1000.0);
+    }
+
+    qint64 frameToMSec(qreal frame) const {
+        return qRound64(frame * 1000.0 / format.sampleRate());
+    }
+
+    void startOutput(qint64 position, qint64 endPosition = -1) {
+        device->seek(msecToFrame(position), endPosition >= 0 ? msecToFrame(endPosition) : -1);
+
+        if (!outputPlaying) {
+            outputPlaying = true;
+            output->start(device.data());
+        }
+    }
+
+    void stopOutput() {
+        if (outputPlaying) {
+            outputPlaying = false;
+            output->stop();
+        }
+    }
+
+    /**
+     * The position of the sample the user hears right now, measured
+     * with the clock of the audio output: the samples still sitting
+     * in its buffer have been read from the device, but not played yet.
+     */
+    qint64 outputPosition() const {
+        const qint64 bufferedBytes = qMax(0, output->bufferSize() - output->bytesFree());
+        const qreal bufferedFrames = qreal(bufferedBytes) / format.bytesPerFrame();
+        return frameToMSec(qMax(0.0, device->position() - bufferedFrames * speed));
+    }
+#else
+    bool isDecoded() const {
+        return false;
+    }
+#endif
 };
 
 
@@ -80,6 +235,33 @@ KisSyncedAudioPlayback::KisSyncedAudioPlayback(const QString &fileName)
     m_d->player.setVolume(50);
 
     connect(&m_d->player, SIGNAL(error(QMediaPlayer::Error)), SLOT(slotOnError()));
+
+#ifdef HAVE_QT_MULTIMEDIA
+    /**
+     * Ask for the native format of the output device, so that
+     * the decoded samples can be played as they are
+     */
+    const QAudioDeviceInfo deviceInfo = QAudioDeviceInfo::defaultOutputDevice();
+    if (deviceInfo.isNull()) return;
+
+    QAudioFormat format = deviceInfo.preferredFormat();
+    format.setCodec("audio/pcm");
+    format.setSampleType(QAudioFormat::SignedInt);
+    format.setSampleSize(16);
+    format = deviceInfo.nearestFormat(format);
+    if (!format.isValid() || !deviceInfo.isFormatSupported(format)) return;
+
+    m_d->format = format;
+    m_d->decoder.reset(new QAudioDecoder());
+    m_d->decoder->setAudioFormat(format);
+    m_d->decoder->setSourceFilename(fileInfo.absoluteFilePath());
+
+    connect(m_d->decoder.data(), SIGNAL(bufferReady()), SLOT(slotDecodedBufferReady()));
+    connect(m_d->decoder.data(), SIGNAL(finished()), SLOT(slotDecodingFinished()));
+    connect(m_d->decoder.data(), SIGNAL(error(QAudioDecoder::Error)), SLOT(slotDecodingFailed()));
+
+    m_d->decoder->start();
+#endif
 }
 
 KisSyncedAudioPlayback::~KisSyncedAudioPlayback()
@@ -93,28 +275,86 @@ void KisSyncedAudioPlayback::setSoundOffsetTolerance(qint64 value)
 
 void KisSyncedAudioPlayback::syncWithVideo(qint64 position)
 {
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->isDecoded()) {
+        /**
+         * Moving the read position doesn't restart the output, so the
+         * correction costs only the samples already in its buffer
+         */
+        if (qAbs(position - m_d->outputPosition()) > m_d->tolerance) {
+            m_d->device->seek(m_d->msecToFrame(position));
+        }
+        return;
+    }
+#endif
+
     if (qAbs(position - m_d->player.position()) > m_d->tolerance) {
         m_d->player.setPosition(position);
     }
 }
 
+void KisSyncedAudioPlayback::scrub(qint64 position, qint64 duration)
+{
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->isDecoded()) {
+        m_d->startOutput(position, position + duration);
+        return;
+    }
+#else
+    Q_UNUSED(duration);
+#endif
+
+    if (!isPlaying()) {
+        play(position);
+    } else {
+        syncWithVideo(position);
+    }
+}
+
 bool KisSyncedAudioPlayback::isPlaying() const
 {
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->isDecoded()) {
+        return m_d->outputPlaying;
+    }
+#endif
+
     return m_d->player.state() == QMediaPlayer::PlayingState;
 }
 
 qint64 KisSyncedAudioPlayback::position() const
 {
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->isDecoded()) {
+        return m_d->outputPosition();
+    }
+#endif
+
     return m_d->player.position();
 }
 
 void KisSyncedAudioPlayback::setVolume(qreal value)
 {
+    m_d->volume = value;
     m_d->player.setVolume(qRound(100.0 * value));
+
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->output) {
+        m_d->output->setVolume(value);
+    }
+#endif
 }
 
 void KisSyncedAudioPlayback::setSpeed(qreal value)
 {
+    m_d->speed = value;
+
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->device) {
+        m_d->device->setSpeed(value);
+    }
+#endif
+
     if (qFuzzyCompare(value, m_d->player.playbackRate())) return;
 
     if (m_d->player.state() == QMediaPlayer::PlayingState) {
@@ -131,12 +371,26 @@ void KisSyncedAudioPlayback::setSpeed(qreal value)
 
 void KisSyncedAudioPlayback::play(qint64 startPosition)
 {
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->isDecoded()) {
+        m_d->startOutput(startPosition);
+        return;
+    }
+#endif
+
     m_d->player.setPosition(startPosition);
     m_d->player.play();
 }
 
 void KisSyncedAudioPlayback::stop()
 {
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->isDecoded()) {
+        m_d->stopOutput();
+        return;
+    }
+#endif
+
     m_d->player.stop();
 }
 
@@ -151,6 +405,65 @@ void KisSyncedAudioPlayback::slotOnError()
 #endif
 }
 
+void KisSyncedAudioPlayback::slotDecodedBufferReady()
+{
+#ifdef HAVE_QT_MULTIMEDIA
+    if (!m_d->decoder) return;
+
+    const QAudioBuffer buffer = m_d->decoder->read();
+    if (!buffer.isValid()) return;
+
+    if (buffer.format() != m_d->format ||
+        m_d->samples.size() + buffer.byteCount() > maxDecodedTrackSize) {
+
+        slotDecodingFailed();
+        return;
+    }
+
+    m_d->samples.append(buffer.constData<char>(), buffer.byteCount());
+#endif
+}
+
+void KisSyncedAudioPlayback::slotDecodingFinished()
+{
+#ifdef HAVE_QT_MULTIMEDIA
+    if (!m_d->decoder) return;
+    m_d->decoder.take()->deleteLater();
+
+    if (m_d->samples.isEmpty()) return;
+
+    m_d->device.reset(new DecodedAudioDevice(m_d->samples, m_d->format.bytesPerFrame()));
+    m_d->device->setSpeed(m_d->speed);
+    m_d->device->open(QIODevice::ReadOnly);
+
+    m_d->output.reset(new QAudioOutput(m_d->format));
+    m_d->output->setBufferSize(m_d->format.bytesForDuration(outputBufferMsecs * 1000));
+    m_d->output->setVolume(m_d->volume);
+
+    // continue the playback, if any, from the decoded samples
+    if (m_d->player.state() == QMediaPlayer::PlayingState) {
+        const qint64 position = m_d->player.position();
+        m_d->player.stop();
+        m_d->startOutput(position);
+    }
+#endif
+}
+
+void KisSyncedAudioPlayback::slotDecodingFailed()
+{
+#ifdef HAVE_QT_MULTIMEDIA
+    if (m_d->decoder) {
+        dbgUI << "Cannot decode the audio track into memory, playing it from the file:"
+              << m_d->decoder->errorString();
+
+        m_d->decoder->stop();
+        m_d->decoder.take()->deleteLater();
+    }
+
+    m_d->samples.clear();
+#endif
+}
+
 #ifndef HAVE_QT_MULTIMEDIA
 #include "KisSyncedAudioPlayback.moc"
 #endif
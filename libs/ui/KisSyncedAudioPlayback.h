@@ -8,6 +8,15 @@
 #include <QScopedPointer>
 #include <QObject>
 
+/**
+ * Plays the audio track of the animation in sync with the video.
+ *
+ * The track is decoded into memory in the background. Once that is
+ * done, the samples are fed to the audio output directly, so seeking,
+ * drift correction and the scrubbing snippets are just moves of the
+ * read position within the decoded samples. Until then, or if the
+ * track cannot be decoded, the file is played with a media player.
+ */
 class KisSyncedAudioPlayback : public QObject
 {
     Q_OBJECT
@@ -18,6 +27,14 @@ public:
     void setSoundOffsetTolerance(qint64 value);
     void syncWithVideo(qint64 position);
 
+    /**
+     * Plays \p duration msecs of the track starting at \p position,
+     * used for scrubbing. When the track is decoded, the snippet
+     * stops by itself and a new one starts immediately, otherwise
+     * it is the same as play() or syncWithVideo().
+     */
+    void scrub(qint64 position, qint64 duration);
+
     bool isPlaying() const;
     qint64 position() const;
 
@@ -33,6 +50,9 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void slotOnError();
+    void slotDecodedBufferReady();
+    void slotDecodingFinished();
+    void slotDecodingFailed();
 
 private:
     struct Private;
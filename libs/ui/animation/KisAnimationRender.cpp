@@ -17,12 +17,74 @@
 #include "KisAnimationRenderingOptions.h"
 #include "KisMimeDatabase.h"
 #include "dialogs/KisAsyncAnimationFramesSaveDialog.h"
+#include "dialogs/KisAsyncAnimationFramesStreamDialog.h"
 #include "kis_time_span.h"
 
 #include "krita_container_utils.h"
 
 #include "KisVideoSaver.h"
 
+namespace {
+
+void createVideoDirectory(const QString &resultFile)
+{
+    const QFileInfo info(resultFile);
+    QDir dir(info.absolutePath());
+
+    if (!dir.exists()) {
+        dir.mkpath(info.absolutePath());
+    }
+    KIS_SAFE_ASSERT_RECOVER_NOOP(dir.exists());
+}
+
+/**
+ * Renders the frames straight into the standard input of ffmpeg,
+ * without saving and compressing them as image files first
+ */
+void renderStreamed(KisDocument *doc, KisViewManager *viewManager, const KisAnimationRenderingOptions &encoderOptions, bool batchMode)
+{
+    const QString resultFile = encoderOptions.resolveAbsoluteVideoFilePath();
+    KIS_SAFE_ASSERT_RECOVER_NOOP(QFileInfo(resultFile).isAbsolute());
+    createVideoDirectory(resultFile);
+
+    KisVideoSaver encoder(doc, batchMode);
+    KisImportExportErrorCode res = encoder.startStreaming(encoderOptions);
+
+    if (res.isOk()) {
+        const bool forceSRGB = encoderOptions.frameExportConfig &&
+            encoderOptions.frameExportConfig->getBool("forceSRGB", false);
+
+        KisAsyncAnimationFramesStreamDialog exporter(doc->image(),
+                                                     KisTimeSpan::fromTimeToTime(encoderOptions.firstFrame,
+                                                                                 encoderOptions.lastFrame),
+                                                     forceSRGB,
+                                                     &encoder);
+        exporter.setBatchMode(batchMode);
+
+        KisAsyncAnimationFramesStreamDialog::Result result =
+            exporter.regenerateRange(viewManager->mainWindow()->viewManager());
+
+        if (result == KisAsyncAnimationFramesStreamDialog::RenderComplete) {
+            res = encoder.finishStreaming();
+        } else {
+            // don't leave a truncated video behind
+            encoder.cancelStreaming();
+            QFile::remove(resultFile);
+
+            if (result == KisAsyncAnimationFramesStreamDialog::RenderFailed) {
+                viewManager->mainWindow()->viewManager()->showFloatingMessage(i18n("Failed to render animation frames!"), QIcon());
+            }
+            return;
+        }
+    }
+
+    if (!res.isOk()) {
+        QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita"), i18n("Could not render animation:\n%1", res.errorMessage()));
+    }
+}
+
+}
+
 void KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, KisAnimationRenderingOptions encoderOptions) {
     const QString frameMimeType = encoderOptions.frameMimeType;
     const QString framesDirectory = encoderOptions.resolveAbsoluteFramesDirectory();
@@ -51,6 +113,12 @@ void KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
     }
 
     const bool batchMode = false; // TODO: fetch correctly!
+
+    if (KisVideoSaver::supportsStreaming(doc->image(), encoderOptions)) {
+        renderStreamed(doc, viewManager, encoderOptions, batchMode);
+        return;
+    }
+
     KisAsyncAnimationFramesSaveDialog exporter(doc->image(),
                                                KisTimeSpan::fromTimeToTime(encoderOptions.firstFrame,
                                                                       encoderOptions.lastFrame),
@@ -73,16 +141,7 @@ void KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
         if (encoderOptions.shouldEncodeVideo) {
             const QString resultFile = encoderOptions.resolveAbsoluteVideoFilePath();
             KIS_SAFE_ASSERT_RECOVER_NOOP(QFileInfo(resultFile).isAbsolute());
-
-            {
-                const QFileInfo info(resultFile);
-                QDir dir(info.absolutePath());
-
-                if (!dir.exists()) {
-                    dir.mkpath(info.absolutePath());
-                }
-                KIS_SAFE_ASSERT_RECOVER_NOOP(dir.exists());
-            }
+            createVideoDirectory(resultFile);
 
             KisImportExportErrorCode res;
             QFile fi(resultFile);
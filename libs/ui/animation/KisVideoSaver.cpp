@@ -32,6 +32,7 @@
 #include <kis_time_span.h>
 
 #include "kis_config.h"
+#include "kis_image_config.h"
 
 #include "KisAnimationRenderingOptions.h"
 #include <QFileSystemWatcher>
@@ -110,30 +111,80 @@ public:
                 << "logPath" << logPath
                 << "totalFrames" << totalFrames;
 
-        QTemporaryFile progressFile(QDir::tempPath() + '/' + "KritaFFmpegProgress.XXXXXX");
-        progressFile.open();
+        startFFMpeg(specialArgs, logPath, false);
+        return waitForFFMpegProcess(actionName, *m_progressFile, m_process, totalFrames);
+    }
+
+    /**
+     * Starts ffmpeg reading the frames from its standard input, which are
+     * passed with writeFrame(). The encoding is finished with finishStreaming().
+     */
+    bool startStreaming(const QStringList &specialArgs, const QString &logPath)
+    {
+        dbgFile << "startStreaming: specialArgs" << specialArgs
+                << "logPath" << logPath;
+
+        startFFMpeg(specialArgs, logPath, true);
+        return m_process.waitForStarted();
+    }
+
+    bool writeFrame(const QByteArray &pixels)
+    {
+        if (m_process.state() != QProcess::Running) return false;
+
+        m_process.write(pixels);
+
+        /**
+         * QProcess buffers everything that hasn't been written yet, so
+         * don't let the frames pile up in memory when ffmpeg is slower
+         * than the rendering.
+         */
+        const qint64 maxBufferedBytes = 4 * pixels.size();
+        while (m_process.bytesToWrite() > maxBufferedBytes &&
+               m_process.state() == QProcess::Running) {
+
+            m_process.waitForBytesWritten(100);
+        }
+
+        return m_process.state() == QProcess::Running;
+    }
+
+    KisImportExportErrorCode finishStreaming(const QString &actionName, int totalFrames)
+    {
+        // writes out the remaining frames and lets ffmpeg know no more will come
+        m_process.closeWriteChannel();
+        return waitForFFMpegProcess(actionName, *m_progressFile, m_process, totalFrames);
+    }
+
+    void cancel() {
+        m_cancelled = true;
+        m_process.kill();
+    }
+
+private:
+    void startFFMpeg(const QStringList &specialArgs, const QString &logPath, bool readsStandardInput)
+    {
+        m_progressFile.reset(new QTemporaryFile(QDir::tempPath() + '/' + "KritaFFmpegProgress.XXXXXX"));
+        m_progressFile->open();
 
         m_process.setStandardOutputFile(logPath);
         m_process.setProcessChannelMode(QProcess::MergedChannels);
         QStringList args;
-        args << "-v" << "debug"
-             << "-nostdin"
-             << "-progress" << progressFile.fileName()
+        args << "-v" << "debug";
+
+        if (!readsStandardInput) {
+            args << "-nostdin";
+        }
+
+        args << "-progress" << m_progressFile->fileName()
              << specialArgs;
 
         qDebug() << "\t" << m_ffmpegPath << args.join(" ");
 
         m_cancelled = false;
         m_process.start(m_ffmpegPath, args);
-        return waitForFFMpegProcess(actionName, progressFile, m_process, totalFrames);
-    }
-
-    void cancel() {
-        m_cancelled = true;
-        m_process.kill();
     }
 
-private:
     KisImportExportErrorCode waitForFFMpegProcess(const QString &message,
                                                 QFile &progressFile,
                                                 QProcess &ffmpegProcess,
@@ -179,6 +230,7 @@ private:
 
 private:
     QProcess m_process;
+    QScopedPointer<QTemporaryFile> m_progressFile;
     bool m_cancelled;
     QString m_ffmpegPath;
 };
@@ -209,8 +261,6 @@ KisImportExportErrorCode KisVideoSaver::encode(const QString &savedFilesMask, co
 
     KisImportExportErrorCode resultOuter = ImportExportCodes::OK;
 
-    KisImageAnimationInterface *animation = m_image->animationInterface();
-
     const int sequenceNumberingOffset = options.sequenceStart;
     const KisTimeSpan clipRange = KisTimeSpan::fromTimeToTime(sequenceNumberingOffset + options.firstFrame,
                                                         sequenceNumberingOffset + options.lastFrame);
@@ -232,6 +282,13 @@ KisImportExportErrorCode KisVideoSaver::encode(const QString &savedFilesMask, co
     const QStringList additionalOptionsList = options.customFFMpegOptions.split(' ', QString::SkipEmptyParts);
     QScopedPointer<KisFFMpegRunner> runner(new KisFFMpegRunner(options.ffmpegPath));
 
+    // the custom options of the user take precedence over the global limit
+    QStringList encoderThreadsArgs;
+    const int encoderThreads = KisImageConfig(true).videoEncoderThreads();
+    if (encoderThreads > 0 && !additionalOptionsList.contains("-threads")) {
+        encoderThreadsArgs << "-threads" << QString::number(encoderThreads);
+    }
+
     if (suffix == "gif") {
         {
             QStringList args;
@@ -267,6 +324,7 @@ KisImportExportErrorCode KisVideoSaver::encode(const QString &savedFilesMask, co
             }
 
             args << filterArgs.append("[0:v][1:v] paletteuse")
+                 << encoderThreadsArgs
                  << "-y" << resultFile;
 
 
@@ -287,37 +345,143 @@ KisImportExportErrorCode KisVideoSaver::encode(const QString &savedFilesMask, co
              << "-start_number" << QString::number(clipRange.start())
              << "-i" << savedFilesMask;
 
-        QFileInfo audioFileInfo = animation->audioChannelFileName();
-        if (options.includeAudio && audioFileInfo.exists()) {
-            const int msecStart = clipRange.start() * 1000 / animation->framerate();
-            const int msecDuration = clipRange.duration() * 1000 / animation->framerate();
+        resultOuter = runner->runFFMpeg(encodingArgs(args, options), i18n("Encoding frames..."),
+                                     videoDir.filePath("log_encode.log"),
+                                     clipRange.duration());
+    }
 
-            const QTime startTime = QTime::fromMSecsSinceStartOfDay(msecStart);
-            const QTime durationTime = QTime::fromMSecsSinceStartOfDay(msecDuration);
-            const QString ffmpegTimeFormat("H:m:s.zzz");
+    return resultOuter;
+}
 
-            args << "-ss" << startTime.toString(ffmpegTimeFormat);
-            args << "-t" << durationTime.toString(ffmpegTimeFormat);
+QStringList KisVideoSaver::encodingArgs(const QStringList &inputArgs, const KisAnimationRenderingOptions &options) const
+{
+    KisImageAnimationInterface *animation = m_image->animationInterface();
 
-            args << "-i" << audioFileInfo.absoluteFilePath();
-        }
+    const int sequenceNumberingOffset = options.sequenceStart;
+    const KisTimeSpan clipRange = KisTimeSpan::fromTimeToTime(sequenceNumberingOffset + options.firstFrame,
+                                                        sequenceNumberingOffset + options.lastFrame);
 
-        // if we are exporting out at a different image size, we apply scaling filter
-        // export options HAVE to go after input options, so make sure this is after the audio import
-        if (m_image->width() != options.width || m_image->height() != options.height) {
-            args << "-vf" << exportDimensions;
-        }
+    const QString exportDimensions =
+        QString("scale=w=")
+            .append(QString::number(options.width))
+            .append(":h=")
+            .append(QString::number(options.height));
+
+    const QString resultFile = options.resolveAbsoluteVideoFilePath();
+    const QStringList additionalOptionsList = options.customFFMpegOptions.split(' ', QString::SkipEmptyParts);
+
+    // the custom options of the user take precedence over the global limit
+    QStringList encoderThreadsArgs;
+    const int encoderThreads = KisImageConfig(true).videoEncoderThreads();
+    if (encoderThreads > 0 && !additionalOptionsList.contains("-threads")) {
+        encoderThreadsArgs << "-threads" << QString::number(encoderThreads);
+    }
 
-        args << additionalOptionsList;
+    QStringList args = inputArgs;
 
-        args << "-y" << resultFile;
+    QFileInfo audioFileInfo = animation->audioChannelFileName();
+    if (options.includeAudio && audioFileInfo.exists()) {
+        const int msecStart = clipRange.start() * 1000 / animation->framerate();
+        const int msecDuration = clipRange.duration() * 1000 / animation->framerate();
 
-        resultOuter = runner->runFFMpeg(args, i18n("Encoding frames..."),
-                                     videoDir.filePath("log_encode.log"),
-                                     clipRange.duration());
+        const QTime startTime = QTime::fromMSecsSinceStartOfDay(msecStart);
+        const QTime durationTime = QTime::fromMSecsSinceStartOfDay(msecDuration);
+        const QString ffmpegTimeFormat("H:m:s.zzz");
+
+        args << "-ss" << startTime.toString(ffmpegTimeFormat);
+        args << "-t" << durationTime.toString(ffmpegTimeFormat);
+
+        args << "-i" << audioFileInfo.absoluteFilePath();
     }
 
-    return resultOuter;
+    // if we are exporting out at a different image size, we apply scaling filter
+    // export options HAVE to go after input options, so make sure this is after the audio import
+    if (m_image->width() != options.width || m_image->height() != options.height) {
+        args << "-vf" << exportDimensions;
+    }
+
+    args << encoderThreadsArgs;
+    args << additionalOptionsList;
+
+    args << "-y" << resultFile;
+
+    return args;
+}
+
+bool KisVideoSaver::supportsStreaming(KisImageSP image, const KisAnimationRenderingOptions &options)
+{
+    const QString suffix = QFileInfo(options.resolveAbsoluteVideoFilePath()).suffix().toLower();
+    const KoColorSpace *cs = image->colorSpace();
+    KisPropertiesConfigurationSP frameConfig = options.frameExportConfig;
+
+    /**
+     * The frames are streamed only when nobody needs the image files,
+     * and only when the raw frames are exactly what ffmpeg would have
+     * read from the 8-bit PNG files. GIF needs two passes over the frames
+     * to generate the palette, so it is always encoded from the files.
+     */
+    return options.renderMode() == KisAnimationRenderingOptions::RENDER_VIDEO_ONLY &&
+        suffix != "gif" &&
+        options.frameMimeType == "image/png" &&
+        cs->colorModelId() == RGBAColorModelID &&
+        cs->colorDepthId() == Integer8BitsColorDepthID &&
+        (!frameConfig ||
+         (!frameConfig->getBool("saveAsHDR", false) &&
+          frameConfig->getBool("alpha", true)));
+}
+
+KisImportExportErrorCode KisVideoSaver::startStreaming(const KisAnimationRenderingOptions &options)
+{
+    if (!QFileInfo(options.ffmpegPath).exists()) {
+        m_doc->setErrorMessage(i18n("ffmpeg could not be found at %1", options.ffmpegPath));
+        return ImportExportCodes::Failure;
+    }
+
+    const QDir videoDir(QFileInfo(options.resolveAbsoluteVideoFilePath()).absolutePath());
+
+    QStringList args;
+    args << "-f" << "rawvideo"
+         << "-pix_fmt" << "bgra"
+         << "-s" << QString("%1x%2").arg(m_image->width()).arg(m_image->height())
+         << "-r" << QString::number(options.frameRate)
+         << "-i" << "-";
+
+    m_streamingRunner.reset(new KisFFMpegRunner(options.ffmpegPath));
+    m_streamingFrames = options.lastFrame - options.firstFrame + 1;
+
+    if (!m_streamingRunner->startStreaming(encodingArgs(args, options),
+                                           videoDir.filePath("log_encode.log"))) {
+        m_streamingRunner.reset();
+        m_doc->setErrorMessage(i18n("ffmpeg could not be started at %1", options.ffmpegPath));
+        return ImportExportCodes::Failure;
+    }
+
+    return ImportExportCodes::OK;
+}
+
+bool KisVideoSaver::writeFrame(const QByteArray &pixels)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_streamingRunner, false);
+    return m_streamingRunner->writeFrame(pixels);
+}
+
+KisImportExportErrorCode KisVideoSaver::finishStreaming()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_streamingRunner, ImportExportCodes::InternalError);
+
+    KisImportExportErrorCode result =
+        m_streamingRunner->finishStreaming(i18n("Encoding frames..."), m_streamingFrames);
+
+    m_streamingRunner.reset();
+    return result;
+}
+
+void KisVideoSaver::cancelStreaming()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_streamingRunner);
+
+    m_streamingRunner->cancel();
+    m_streamingRunner.reset();
 }
 
 KisImportExportErrorCode KisVideoSaver::convert(KisDocument *document, const QString &savedFilesMask, const KisAnimationRenderingOptions &options, bool batchMode)
@@ -18,6 +18,7 @@
 #define VIDEO_SAVER_H_
 
 #include <QObject>
+#include <QScopedPointer>
 
 #include "kis_types.h"
 
@@ -61,10 +62,44 @@ public:
 
     static KisImportExportErrorCode convert(KisDocument *document, const QString &savedFilesMask, const KisAnimationRenderingOptions &options, bool batchMode);
 
+    /**
+     * @return true if the frames of \p image can be streamed to ffmpeg with
+     * startStreaming() instead of being saved as files and encoded with encode()
+     */
+    static bool supportsStreaming(KisImageSP image, const KisAnimationRenderingOptions &options);
+
+    /**
+     * @brief starts ffmpeg reading the raw BGRA8 frames of the size of the image
+     * from its standard input. Every frame of the clip should be passed with
+     * writeFrame() in order, then the encoding is completed with finishStreaming().
+     */
+    KisImportExportErrorCode startStreaming(const KisAnimationRenderingOptions &options);
+
+    /**
+     * @brief passes the pixels of the next frame to ffmpeg. Blocks if ffmpeg
+     * is too far behind.
+     * @return false if ffmpeg has stopped
+     */
+    bool writeFrame(const QByteArray &pixels);
+
+    KisImportExportErrorCode finishStreaming();
+
+    /**
+     * @brief stops ffmpeg without completing the video, e.g. when the
+     * rendering of the frames has been cancelled
+     */
+    void cancelStreaming();
+
+private:
+    QStringList encodingArgs(const QStringList &inputArgs, const KisAnimationRenderingOptions &options) const;
+
 private:
     KisImageSP m_image;
     KisDocument* m_doc;
     bool m_batchMode;
+
+    QScopedPointer<KisFFMpegRunner> m_streamingRunner;
+    int m_streamingFrames = 0;
 };
 
 #endif
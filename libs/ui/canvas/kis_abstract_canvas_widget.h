@@ -49,6 +49,9 @@ public:
 
     virtual QList<KisCanvasDecorationSP> decorations() const = 0;
 
+    /// Called from KisCanvas2::updateCanvas, when the decorations may have changed
+    virtual void invalidateDecorationsCache() = 0;
+
     /// set the specified display filter on the canvas
     virtual void setDisplayFilter(QSharedPointer<KisDisplayFilter> displayFilter) = 0;
 
@@ -58,7 +58,8 @@ public:
           lastPaintedFrame(0),
           playbackStatisticsCompressor(1000, KisSignalCompressor::FIRST_INACTIVE),
           stopAudioOnScrubbingCompressor(100, KisSignalCompressor::POSTPONE),
-          audioOffsetTolerance(-1)
+          audioOffsetTolerance(-1),
+          scrubbingAudioChunkLength(0)
           {}
 
     KisAnimationPlayer *q;
@@ -103,6 +104,7 @@ public:
     KisSignalCompressor stopAudioOnScrubbingCompressor;
 
     int audioOffsetTolerance;
+    int scrubbingAudioChunkLength;
     QVector<KisNodeWSP> disabledDecoratedNodes;
 
     void stopImpl();
@@ -193,15 +195,14 @@ void KisAnimationPlayer::slotSyncScrubbingAudio(int msecTime)
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->syncedAudio);
 
-    if (!m_d->syncedAudio->isPlaying()) {
+    if (!isPlaying()) {
+        m_d->syncedAudio->scrub(msecTime, m_d->scrubbingAudioChunkLength);
+        m_d->stopAudioOnScrubbingCompressor.start();
+    } else if (!m_d->syncedAudio->isPlaying()) {
         m_d->syncedAudio->play(msecTime);
     } else {
         m_d->syncedAudio->syncWithVideo(msecTime);
     }
-
-    if (!isPlaying()) {
-        m_d->stopAudioOnScrubbingCompressor.start();
-    }
 }
 
 void KisAnimationPlayer::slotTryStopScrubbingAudio()
@@ -290,6 +291,7 @@ void KisAnimationPlayer::slotUpdateAudioChunkLength()
 
     m_d->audioSyncScrubbingCompressor->setDelay(scrubbingAudioUdpatesDelay);
     m_d->stopAudioOnScrubbingCompressor.setDelay(scrubbingAudioUdpatesDelay);
+    m_d->scrubbingAudioChunkLength = qMax(scrubbingAudioUdpatesDelay, animationFramePeriod);
 
     m_d->audioOffsetTolerance = cfg.audioOffsetTolerance();
     if (m_d->audioOffsetTolerance < 0) {
@@ -583,6 +585,11 @@ void KisAnimationPlayer::uploadFrame(int frame, bool forceSyncAudio)
         }
     }
 
+    if (m_d->canvas->frameCache() && isPlaying()) {
+        // decode the next frame while the current one is being shown
+        m_d->canvas->frameCache()->prefetchFrame(m_d->incFrame(frame, 1));
+    }
+
     if (useFallbackUploadMethod &&
         m_d->canvas->image()->animationInterface()->hasAnimation()) {
 
@@ -16,11 +16,14 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QTime>
+#include <QElapsedTimer>
 #include <QLabel>
 #include <QMouseEvent>
 #include <QDesktopWidget>
 #include <QScreen>
 #include <QWindow>
+#include <QTimer>
+#include <QOpenGLWidget>
 
 #include <kis_debug.h>
 
@@ -59,6 +62,7 @@
 #include "kis_image_config.h"
 #include "kis_infinity_manager.h"
 #include "kis_signal_compressor.h"
+#include "KisAtomicSignalCompressor.h"
 #include "kis_display_color_converter.h"
 #include "kis_exposure_gamma_correction_interface.h"
 #include "KisView.h"
@@ -84,6 +88,7 @@
 #include "KoZoomController.h"
 
 #include <KisStrokeSpeedMonitor.h>
+#include <KisStrokeLatencyMonitor.h>
 #include "opengl/kis_opengl_canvas_debugger.h"
 
 #include "kis_algebra_2d.h"
@@ -132,6 +137,7 @@ public:
     KisDisplayColorConverter displayColorConverter;
 
     KisCanvasUpdatesCompressor projectionUpdatesCompressor;
+    KisAtomicSignalCompressor canvasCacheUpdateCompressor;
     KisAnimationPlayer *animationPlayer;
     KisAnimationFrameCacheSP frameCache;
     bool lodAllowedInImage = false;
@@ -148,6 +154,33 @@ public:
     QRect renderingLimit;
     int isBatchUpdateActive = 0;
 
+    /**
+     * The time the GUI thread is allowed to spend on uploading the
+     * updates in one frame, the rest is postponed to the next frame
+     */
+    int uploadTimeBudget = 8;
+
+    /**
+     * The OpenGL canvas is repainted at the pace the frames are
+     * presented: while a frame is in flight, i.e. the widget update
+     * has been requested, but the frame has not been swapped yet, the
+     * projection updates are accumulated and uploaded in one batch
+     * right after the swap.
+     */
+    bool framePacingEnabled = false;
+    bool frameInFlight = false;
+    bool frameRenderPending = false;
+    QTimer frameSwapWatchdog;
+
+    /**
+     * The update latency is counted from the moment the first update of
+     * a frame arrives from the image until the frame is swapped
+     */
+    QElapsedTimer latencyClock;
+    QAtomicInt firstPendingUpdateTime = -1;
+    int frameUpdateStartTime = -1;
+    int inFlightUpdateStartTime = -1;
+
     bool effectiveLodAllowedInImage() {
         return lodAllowedInImage && !bootstrapLodBlocked;
     }
@@ -195,13 +228,19 @@ KisCanvas2::KisCanvas2(KisCoordinatesConverter *coordConverter, KoCanvasResource
     connect(mainWindow, SIGNAL(guiLoadingFinished()), SLOT(bootstrapFinished()));
     connect(mainWindow, SIGNAL(screenChanged()), SLOT(slotConfigChanged()));
 
-    KisImageConfig config(false);
-
-    m_d->canvasUpdateCompressor.setDelay(1000 / config.fpsLimit());
     m_d->canvasUpdateCompressor.setMode(KisSignalCompressor::FIRST_ACTIVE);
-
-    m_d->frameRenderStartCompressor.setDelay(1000 / config.fpsLimit());
     m_d->frameRenderStartCompressor.setMode(KisSignalCompressor::FIRST_ACTIVE);
+    updateFrameRateLimits();
+
+    /**
+     * If the frame is never swapped, e.g. when the canvas is hidden,
+     * don't hold the updates forever
+     */
+    m_d->frameSwapWatchdog.setSingleShot(true);
+    m_d->frameSwapWatchdog.setInterval(100);
+    connect(&m_d->frameSwapWatchdog, SIGNAL(timeout()), SLOT(slotCanvasFrameSwapped()));
+
+    m_d->latencyClock.start();
     snapGuide()->overrideSnapStrategy(KoSnapGuide::PixelSnapping, new KisSnapPixelStrategy());
 }
 
@@ -245,7 +284,9 @@ void KisCanvas2::setup()
 
     connect(&m_d->canvasUpdateCompressor, SIGNAL(timeout()), SLOT(slotDoCanvasUpdate()));
 
-    connect(this, SIGNAL(sigCanvasCacheUpdated()), &m_d->frameRenderStartCompressor, SLOT(start()));
+    // the updates come from the worker threads, so don't flood the event loop with them
+    connect(&m_d->canvasCacheUpdateCompressor, SIGNAL(timeout()), SIGNAL(sigCanvasCacheUpdated()));
+    connect(this, SIGNAL(sigCanvasCacheUpdated()), SLOT(slotRequestFrameRender()));
     connect(&m_d->frameRenderStartCompressor, SIGNAL(timeout()), SLOT(updateCanvasProjection()));
 
     connect(this, SIGNAL(sigContinueResizeImage(qint32,qint32)), SLOT(finishResizingImage(qint32,qint32)));
@@ -285,6 +326,26 @@ KisCanvas2::~KisCanvas2()
     delete m_d;
 }
 
+void KisCanvas2::updateFrameRateLimits()
+{
+    KisImageConfig config(true);
+    int frameRate = config.fpsLimit();
+
+    /**
+     * There is no point in rendering more frames than the display
+     * can show, they would just be dropped by the compositor
+     */
+    QWindow *window = m_d->canvasWidget ? m_d->canvasWidget->widget()->window()->windowHandle() : 0;
+    QScreen *screen = window ? window->screen() : QGuiApplication::primaryScreen();
+    if (screen && screen->refreshRate() > 1.0) {
+        frameRate = qMin(frameRate, qRound(screen->refreshRate()));
+    }
+
+    m_d->canvasUpdateCompressor.setDelay(1000 / frameRate);
+    m_d->frameRenderStartCompressor.setDelay(1000 / frameRate);
+    m_d->uploadTimeBudget = qMax(1, 1000 / frameRate / 2);
+}
+
 void KisCanvas2::setCanvasWidget(KisAbstractCanvasWidget *widget)
 {
     if (m_d->popupPalette) {
@@ -310,6 +371,16 @@ void KisCanvas2::setCanvasWidget(KisAbstractCanvasWidget *widget)
         m_d->canvasWidget = widget;
     }
 
+    m_d->frameSwapWatchdog.stop();
+    m_d->frameInFlight = false;
+    m_d->inFlightUpdateStartTime = -1;
+
+    QOpenGLWidget *glWidget = qobject_cast<QOpenGLWidget*>(widget->widget());
+    m_d->framePacingEnabled = glWidget && KisConfig(true).useOpenGLFramePacing();
+    if (m_d->framePacingEnabled) {
+        connect(glWidget, SIGNAL(frameSwapped()), SLOT(slotCanvasFrameSwapped()));
+    }
+
     if (!m_d->canvasWidget->decoration(INFINITY_DECORATION_ID)) {
         KisInfinityManager *manager = new KisInfinityManager(m_d->view, this);
         manager->setVisible(true);
@@ -765,16 +836,58 @@ void KisCanvas2::finishResizingImage(qint32 w, qint32 h)
 void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 {
     KisUpdateInfoSP info = m_d->canvasWidget->startUpdateCanvasProjection(rc, m_d->channelFlags);
+    m_d->firstPendingUpdateTime.testAndSetOrdered(-1, int(m_d->latencyClock.elapsed()));
+
     if (m_d->projectionUpdatesCompressor.putUpdateInfo(info)) {
-        emit sigCanvasCacheUpdated();
+        m_d->canvasCacheUpdateCompressor.start();
+    }
+}
+
+void KisCanvas2::slotRequestFrameRender()
+{
+    if (m_d->framePacingEnabled && m_d->frameInFlight) {
+        // the updates will be uploaded in one batch after the frame is swapped
+        m_d->frameRenderPending = true;
+        return;
+    }
+
+    m_d->frameRenderStartCompressor.start();
+}
+
+void KisCanvas2::slotCanvasFrameSwapped()
+{
+    // the watchdog is inactive when it has fired, the frame was never shown then
+    const bool frameWasSwapped = m_d->frameSwapWatchdog.isActive();
+    m_d->frameSwapWatchdog.stop();
+
+    if (frameWasSwapped && m_d->inFlightUpdateStartTime >= 0) {
+        KisOpenglCanvasDebugger::instance()->nofityFrameLatency(
+            int(m_d->latencyClock.elapsed()) - m_d->inFlightUpdateStartTime);
+    }
+
+    // without the frame pacing the slot is called by the swaps only
+    if (frameWasSwapped || !m_d->framePacingEnabled) {
+        KisStrokeLatencyMonitor::instance()->reportFramePresented();
+    }
+
+    m_d->inFlightUpdateStartTime = -1;
+    m_d->frameInFlight = false;
+
+    if (m_d->frameRenderPending) {
+        m_d->frameRenderPending = false;
+        m_d->frameRenderStartCompressor.start();
     }
 }
 
 void KisCanvas2::updateCanvasProjection()
 {
+    /**
+     * KisOpenGLCanvas2 reports the dirty rects in widget coordinates, it
+     * repaints only the scissored update rect of the widget. KisQPainterCanvas
+     * reports them in viewport coordinates.
+     */
     auto tryIssueCanvasUpdates = [this](const QRect &vRect) {
         if (!m_d->isBatchUpdateActive) {
-            // TODO: Implement info->dirtyViewportRect() for KisOpenGLCanvas2 to avoid updating whole canvas
             if (m_d->currentCanvasIsOpenGL) {
                 m_d->savedUpdateRect |= vRect;
 
@@ -794,26 +907,55 @@ void KisCanvas2::updateCanvasProjection()
         const QRect vRect = std::accumulate(viewportRects.constBegin(), viewportRects.constEnd(),
                                             QRect(), std::bit_or<QRect>());
 
+        KisStrokeLatencyMonitor *latencyMonitor = KisStrokeLatencyMonitor::instance();
+        if (latencyMonitor->isEnabled()) {
+            Q_FOREACH (KisUpdateInfoSP info, infoObjects) {
+                latencyMonitor->reportTexturesUploaded(info->dirtyImageRect());
+            }
+        }
+
         tryIssueCanvasUpdates(vRect);
     };
 
+    auto wholeImageUpdateRect = [this] () {
+        return m_d->currentCanvasIsOpenGL ?
+            m_d->coordinatesConverter->imageRectInWidgetPixels().toAlignedRect() :
+            m_d->coordinatesConverter->imageRectInViewportPixels().toAlignedRect();
+    };
+
     bool shouldExplicitlyIssueUpdates = false;
 
     QVector<KisUpdateInfoSP> infoObjects;
     KisUpdateInfoList originalInfoObjects;
     m_d->projectionUpdatesCompressor.takeUpdateInfo(originalInfoObjects);
 
-    for (auto it = originalInfoObjects.constBegin();
-         it != originalInfoObjects.constEnd();
-         ++it) {
+    const int updateStartTime = m_d->firstPendingUpdateTime.fetchAndStoreOrdered(-1);
+    if (m_d->frameUpdateStartTime < 0) {
+        m_d->frameUpdateStartTime = updateStartTime;
+    }
 
-        KisUpdateInfoSP info = *it;
+    /**
+     * Uploading a huge update (e.g. undo of a filter applied to the whole
+     * layer) can block the GUI thread for seconds. So the textures are
+     * uploaded in chunks of tiles, and when the time budget of the frame
+     * is exhausted, the rest of the updates is returned to the compressor
+     * and uploaded in the next frame. The GUI processes events in between.
+     */
+    const int maxTilesPerChunk = 32;
+    int numTilesInChunk = 0;
+
+    QElapsedTimer uploadTimer;
+    uploadTimer.start();
+
+    for (int i = 0; i < originalInfoObjects.size(); i++) {
+        KisUpdateInfoSP info = originalInfoObjects[i];
 
         const KisMarkerUpdateInfo *batchInfo = dynamic_cast<const KisMarkerUpdateInfo*>(info.data());
         if (batchInfo) {
             if (!infoObjects.isEmpty()) {
                 uploadData(infoObjects);
                 infoObjects.clear();
+                numTilesInChunk = 0;
             }
 
             if (batchInfo->type() == KisMarkerUpdateInfo::StartBatch) {
@@ -831,14 +973,41 @@ void KisCanvas2::updateCanvasProjection()
                 shouldExplicitlyIssueUpdates = true;
             }
         } else {
+            KisOpenGLUpdateInfo *glInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
+
+            if (glInfo && glInfo->tileList.size() > maxTilesPerChunk - numTilesInChunk) {
+                originalInfoObjects.insert(i + 1, glInfo->splitOff(qMax(1, maxTilesPerChunk - numTilesInChunk)));
+            }
+
             infoObjects << info;
+            numTilesInChunk += glInfo ? glInfo->tileList.size() : 1;
+
+            if (numTilesInChunk >= maxTilesPerChunk) {
+                uploadData(infoObjects);
+                infoObjects.clear();
+                numTilesInChunk = 0;
+
+                if (i < originalInfoObjects.size() - 1 &&
+                    uploadTimer.elapsed() > m_d->uploadTimeBudget) {
+
+                    m_d->projectionUpdatesCompressor.putBackUpdateInfo(originalInfoObjects.mid(i + 1));
+
+                    if (shouldExplicitlyIssueUpdates) {
+                        tryIssueCanvasUpdates(wholeImageUpdateRect());
+                    }
+
+                    // the rest is uploaded on the next frame
+                    slotRequestFrameRender();
+                    return;
+                }
+            }
         }
     }
 
     if (!infoObjects.isEmpty()) {
         uploadData(infoObjects);
     } else if (shouldExplicitlyIssueUpdates) {
-        tryIssueCanvasUpdates(m_d->coordinatesConverter->imageRectInImagePixels());
+        tryIssueCanvasUpdates(wholeImageUpdateRect());
     }
 }
 
@@ -848,7 +1017,7 @@ void KisCanvas2::slotBeginUpdatesBatch()
         new KisMarkerUpdateInfo(KisMarkerUpdateInfo::StartBatch,
                                       m_d->coordinatesConverter->imageRectInImagePixels());
     m_d->projectionUpdatesCompressor.putUpdateInfo(info);
-    emit sigCanvasCacheUpdated();
+    m_d->canvasCacheUpdateCompressor.start();
 }
 
 void KisCanvas2::slotEndUpdatesBatch()
@@ -857,7 +1026,7 @@ void KisCanvas2::slotEndUpdatesBatch()
         new KisMarkerUpdateInfo(KisMarkerUpdateInfo::EndBatch,
                                       m_d->coordinatesConverter->imageRectInImagePixels());
     m_d->projectionUpdatesCompressor.putUpdateInfo(info);
-    emit sigCanvasCacheUpdated();
+    m_d->canvasCacheUpdateCompressor.start();
 }
 
 void KisCanvas2::slotSetLodUpdatesBlocked(bool value)
@@ -868,7 +1037,7 @@ void KisCanvas2::slotSetLodUpdatesBlocked(bool value)
                                 KisMarkerUpdateInfo::UnblockLodUpdates,
                                 m_d->coordinatesConverter->imageRectInImagePixels());
     m_d->projectionUpdatesCompressor.putUpdateInfo(info);
-    emit sigCanvasCacheUpdated();
+    m_d->canvasCacheUpdateCompressor.start();
 }
 
 void KisCanvas2::slotDoCanvasUpdate()
@@ -912,6 +1081,13 @@ void KisCanvas2::slotDoCanvasUpdate()
         } else {
             m_d->canvasWidget->widget()->update(m_d->savedUpdateRect);
         }
+
+        if (m_d->framePacingEnabled && !m_d->frameInFlight) {
+            m_d->frameInFlight = true;
+            m_d->inFlightUpdateStartTime = m_d->frameUpdateStartTime;
+            m_d->frameUpdateStartTime = -1;
+            m_d->frameSwapWatchdog.start();
+        }
     }
 
     m_d->savedUpdateRect = QRect();
@@ -925,6 +1101,11 @@ void KisCanvas2::updateCanvasWidgetImpl(const QRect &rc)
 
 void KisCanvas2::updateCanvas()
 {
+    /**
+     * The decorations and tools request the full update when their
+     * state changes, so their cached layer should be repainted
+     */
+    m_d->canvasWidget->invalidateDecorationsCache();
     updateCanvasWidgetImpl();
 }
 
@@ -975,6 +1156,11 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     m_d->regionOfInterest = proposedRoi & imageRect;
 
     if (m_d->regionOfInterest != oldRegionOfInterest) {
+        KisImageSP image = this->image();
+        if (image) {
+            image->setUpdatesPriorityRegion(m_d->regionOfInterest);
+        }
+
         emit sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
 }
@@ -1084,6 +1270,7 @@ void KisCanvas2::slotConfigChanged()
     m_d->regionOfInterestMargin = KisImageConfig(true).animationCacheRegionOfInterestMargin();
 
     resetCanvas(cfg.useOpenGL());
+    updateFrameRateLimits();
 
     // HACK: Sometimes screenNumber(this->canvasWidget()) is not able to get the
     //       proper screenNumber when moving the window across screens. Using
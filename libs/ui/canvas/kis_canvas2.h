@@ -286,6 +286,9 @@ private Q_SLOTS:
 
     void slotDoCanvasUpdate();
 
+    void slotRequestFrameRender();
+    void slotCanvasFrameSwapped();
+
     void bootstrapFinished();
 
     void slotUpdateRegionOfInterest();
@@ -318,6 +321,7 @@ private:
     void createOpenGLCanvas();
     void updateCanvasWidgetImpl(const QRect &rc = QRect());
     void setCanvasWidget(KisAbstractCanvasWidget *widget);
+    void updateFrameRateLimits();
     void resetCanvas(bool useOpenGL);
     void setDisplayProfile(const KoColorProfile *profile);
 
@@ -81,6 +81,11 @@ void KisCanvasDecoration::setPriority(int value)
     d->priority = value;
 }
 
+bool KisCanvasDecoration::isCacheable() const
+{
+    return false;
+}
+
 bool KisCanvasDecoration::comparePriority(KisCanvasDecorationSP decoration1, KisCanvasDecorationSP decoration2)
 {
     return decoration1->priority() < decoration2->priority();
@@ -62,6 +62,16 @@ public:
 
     static bool comparePriority(KisCanvasDecorationSP decoration1, KisCanvasDecorationSP decoration2);
 
+    /**
+     * Return true if the decoration depends only on its own state and the
+     * transformation of the canvas. Such decorations are painted into a
+     * cached layer, which is repainted only on the full update of the canvas,
+     * so they should call KisCanvas2::updateCanvas() when they change.
+     *
+     * The default implementation returns false.
+     */
+    virtual bool isCacheable() const;
+
 public Q_SLOTS:
     /**
      * Set if the decoration is visible or not.
@@ -45,3 +45,9 @@ void KisCanvasUpdatesCompressor::takeUpdateInfo(KisUpdateInfoList &list)
     QMutexLocker l(&m_mutex);
     m_updatesList.swap(list);
 }
+
+void KisCanvasUpdatesCompressor::putBackUpdateInfo(const KisUpdateInfoList &list)
+{
+    QMutexLocker l(&m_mutex);
+    m_updatesList = list + m_updatesList;
+}
@@ -21,6 +21,12 @@ public:
     bool putUpdateInfo(KisUpdateInfoSP info);
     void takeUpdateInfo(KisUpdateInfoList &list);
 
+    /**
+     * Returns the updates that have been taken, but not processed,
+     * to the front of the queue
+     */
+    void putBackUpdateInfo(const KisUpdateInfoList &list);
+
 private:
     QMutex m_mutex;
     KisUpdateInfoList m_updatesList;
@@ -10,6 +10,8 @@
 #include <QPainter>
 #include <QTimer>
 #include <QMenu>
+#include <QTransform>
+#include <QVector>
 
 #include <KoShapeManager.h>
 #include <KoToolManager.h>
@@ -31,6 +33,31 @@
 #include "KisQPainterStateSaver.h"
 
 
+namespace {
+
+/**
+ * A run of the consecutive cacheable decorations painted into
+ * a single image of the size of the widget
+ */
+struct CachedDecorationsLayer {
+    QList<KisCanvasDecoration*> decorations;
+    QImage image;
+};
+
+void setupDecorationsPainter(QPainter &gc)
+{
+    gc.setRenderHint(QPainter::Antialiasing);
+    gc.setRenderHint(QPainter::TextAntialiasing);
+
+    // This option does not do anything anymore with Qt4.6, so don't re-enable it since it seems to break display
+    // https://lists.qt-project.org/pipermail/qt-interest-old/2009-December/017078.html
+    // gc.setRenderHint(QPainter::HighQualityAntialiasing);
+
+    gc.setRenderHint(QPainter::SmoothPixmapTransform);
+}
+
+}
+
 struct KisCanvasWidgetBase::Private
 {
 public:
@@ -52,8 +79,60 @@ public:
 
     bool ignorenextMouseEventExceptRightMiddleClick; // HACK work around Qt bug not sending tablet right/dblclick https://bugreports.qt.io/browse/QTBUG-8598
     QColor borderColor;
+
+    bool cacheDecorations = false;
+    QVector<CachedDecorationsLayer> cachedDecorationsLayers;
+    QTransform cachedDecorationsTransform;
+    QSize cachedDecorationsSize;
+    qreal cachedDecorationsDevicePixelRatio = 1.0;
+
+    void paintCachedDecorations(QPainter &gc, const QRect &updateWidgetRect,
+                                int layerIndex, const QList<KisCanvasDecorationSP> &decorations);
 };
 
+void KisCanvasWidgetBase::Private::paintCachedDecorations(QPainter &gc, const QRect &updateWidgetRect,
+                                                          int layerIndex, const QList<KisCanvasDecorationSP> &decorations)
+{
+    if (cachedDecorationsSize.isEmpty()) return;
+
+    QList<KisCanvasDecoration*> layerDecorations;
+    Q_FOREACH (KisCanvasDecorationSP deco, decorations) {
+        layerDecorations << deco.data();
+    }
+
+    if (layerIndex >= cachedDecorationsLayers.size()) {
+        cachedDecorationsLayers.resize(layerIndex + 1);
+    }
+
+    CachedDecorationsLayer &layer = cachedDecorationsLayers[layerIndex];
+
+    if (layer.image.isNull() || layer.decorations != layerDecorations) {
+        const QRect widgetRect(QPoint(), cachedDecorationsSize);
+
+        layer.image = QImage(cachedDecorationsSize * cachedDecorationsDevicePixelRatio,
+                             QImage::Format_ARGB32_Premultiplied);
+        layer.image.setDevicePixelRatio(cachedDecorationsDevicePixelRatio);
+        layer.image.fill(Qt::transparent);
+
+        QPainter cacheGc(&layer.image);
+        setupDecorationsPainter(cacheGc);
+
+        const QRectF documentRect = coordinatesConverter->widgetToDocument(QRectF(widgetRect));
+        Q_FOREACH (KisCanvasDecorationSP deco, decorations) {
+            deco->paint(cacheGc, documentRect, coordinatesConverter, canvas);
+        }
+
+        cacheGc.end();
+        layer.decorations = layerDecorations;
+    }
+
+    const qreal dpr = cachedDecorationsDevicePixelRatio;
+    const QRectF sourceRect(QPointF(updateWidgetRect.topLeft()) * dpr,
+                            QSizeF(updateWidgetRect.size()) * dpr);
+
+    gc.drawImage(QRectF(updateWidgetRect), layer.image, sourceRect);
+}
+
 KisCanvasWidgetBase::KisCanvasWidgetBase(KisCanvas2 * canvas, KisCoordinatesConverter *coordinatesConverter)
     : m_d(new Private(canvas, coordinatesConverter))
 {
@@ -83,14 +162,7 @@ void KisCanvasWidgetBase::drawDecorations(QPainter & gc, const QRect &updateWidg
 
     // Setup the painter to take care of the offset; all that the
     // classes that do painting need to keep track of is resolution
-    gc.setRenderHint(QPainter::Antialiasing);
-    gc.setRenderHint(QPainter::TextAntialiasing);
-
-    // This option does not do anything anymore with Qt4.6, so don't re-enable it since it seems to break display
-    // https://lists.qt-project.org/pipermail/qt-interest-old/2009-December/017078.html
-    // gc.setRenderHint(QPainter::HighQualityAntialiasing);
-
-    gc.setRenderHint(QPainter::SmoothPixmapTransform);
+    setupDecorationsPainter(gc);
 
     {
         KisQPainterStateSaver paintShapesState(&gc);
@@ -101,10 +173,48 @@ void KisCanvasWidgetBase::drawDecorations(QPainter & gc, const QRect &updateWidg
 
     }
 
+    if (m_d->cacheDecorations) {
+        const QTransform transform = m_d->coordinatesConverter->documentToWidgetTransform();
+        const QSize widgetSize = m_d->coordinatesConverter->getCanvasWidgetSize().toSize();
+        const qreal devicePixelRatio = m_d->coordinatesConverter->devicePixelRatio();
+
+        if (transform != m_d->cachedDecorationsTransform ||
+            widgetSize != m_d->cachedDecorationsSize ||
+            !qFuzzyCompare(devicePixelRatio, m_d->cachedDecorationsDevicePixelRatio)) {
+
+            m_d->cachedDecorationsLayers.clear();
+            m_d->cachedDecorationsTransform = transform;
+            m_d->cachedDecorationsSize = widgetSize;
+            m_d->cachedDecorationsDevicePixelRatio = devicePixelRatio;
+        }
+    }
+
     // ask the decorations to paint themselves
     // decorations are painted in "widget" coordinate system
-    Q_FOREACH (KisCanvasDecorationSP deco, m_d->decorations) {
-        if (deco->visible()) {
+    int cachedLayerIndex = 0;
+
+    for (int i = 0; i < m_d->decorations.size(); i++) {
+        KisCanvasDecorationSP deco = m_d->decorations[i];
+        if (!deco->visible()) continue;
+
+        if (m_d->cacheDecorations && deco->isCacheable()) {
+            /**
+             * The consecutive cacheable decorations share the cached layer,
+             * so the z-order of the decorations is preserved
+             */
+            QList<KisCanvasDecorationSP> layerDecorations;
+
+            for (; i < m_d->decorations.size(); i++) {
+                KisCanvasDecorationSP layerDeco = m_d->decorations[i];
+                if (!layerDeco->visible()) continue;
+                if (!layerDeco->isCacheable()) break;
+
+                layerDecorations << layerDeco;
+            }
+            i--;
+
+            m_d->paintCachedDecorations(gc, updateWidgetRect, cachedLayerIndex++, layerDecorations);
+        } else {
             deco->paint(gc, m_d->coordinatesConverter->widgetToDocument(updateWidgetRect), m_d->coordinatesConverter,m_d->canvas);
         }
     }
@@ -120,6 +230,11 @@ void KisCanvasWidgetBase::drawDecorations(QPainter & gc, const QRect &updateWidg
     gc.restore();
 }
 
+void KisCanvasWidgetBase::invalidateDecorationsCache()
+{
+    m_d->cachedDecorationsLayers.clear();
+}
+
 void KisCanvasWidgetBase::addDecoration(KisCanvasDecorationSP deco)
 {
     m_d->decorations.push_back(deco);
@@ -186,6 +301,9 @@ void KisCanvasWidgetBase::notifyConfigChanged()
 {
     KisConfig cfg(true);
     m_d->borderColor = cfg.canvasBorderColor();
+
+    m_d->cacheDecorations = cfg.cacheCanvasDecorations();
+    m_d->cachedDecorationsLayers.clear();
 }
 
 QColor KisCanvasWidgetBase::borderColor() const
@@ -46,6 +46,8 @@ public: // KisAbstractCanvasWidget
     void setDecorations(const QList<KisCanvasDecorationSP > &) override;
     QList<KisCanvasDecorationSP > decorations() const override;
 
+    void invalidateDecorationsCache() override;
+
     void setWrapAroundViewingMode(bool value) override;
 
     /**
@@ -41,6 +41,11 @@ void KisGridDecoration::setGridConfig(const KisGridConfig &config)
     m_d->config = config;
 }
 
+bool KisGridDecoration::isCacheable() const
+{
+    return true;
+}
+
 void KisGridDecoration::drawDecoration(QPainter& gc, const QRectF& updateArea, const KisCoordinatesConverter* converter, KisCanvas2* canvas)
 {
     if (!m_d->config.showGrid()) return;
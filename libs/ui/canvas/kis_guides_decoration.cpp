@@ -37,6 +37,10 @@ const KisGuidesConfig& KisGuidesDecoration::guidesConfig() const
     return m_d->guidesConfig;
 }
 
+bool KisGuidesDecoration::isCacheable() const
+{
+    return true;
+}
 
 void KisGuidesDecoration::drawDecoration(QPainter &painter, const QRectF& updateArea, const KisCoordinatesConverter *converter, KisCanvas2 *canvas)
 {
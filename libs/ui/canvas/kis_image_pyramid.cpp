@@ -6,11 +6,13 @@
 #include "kis_image_pyramid.h"
 
 #include <QBitArray>
+#include <QtConcurrent>
 #include <KoChannelInfo.h>
 #include <KoCompositeOp.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorSpaceMaths.h>
+#include <KoLut3DColorConversionTransformation.h>
 
 #include "kis_display_filter.h"
 #include "kis_painter.h"
@@ -41,9 +43,26 @@
 #include <half.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAVE_SSE2_DOWNSAMPLING
+#endif
+
 #define ceiledSize(sz) QSize(ceil((sz).width()), ceil((sz).height()))
 #define isOdd(x) ((x) & 0x01)
 
+/**
+ * The height of the stripes of the pyramid planes downsampled
+ * in parallel. It is equal to the tile height, so the stripes
+ * never share the tiles of the destination plane.
+ */
+const qint32 downsampleStripeHeight = 64;
+
+/**
+ * The updates smaller than that are not worth spawning the threads
+ */
+const qint32 minParallelDownsamplePixels = 256 * 256;
+
 /**
  * Aligns @p value to the lowest integer not smaller than @p value and
  * that is a divident of alignment
@@ -92,6 +111,7 @@ KisImagePyramid::KisImagePyramid(qint32 pyramidHeight)
         : m_monitorProfile(0)
         , m_monitorColorSpace(0)
         , m_pyramidHeight(pyramidHeight)
+        , m_displayLutGridSize(0)
 {
     configChanged();
     connect(KisConfigNotifier::instance(), SIGNAL(configChanged()), this, SLOT(configChanged()));
@@ -115,6 +135,11 @@ void KisImagePyramid::setMonitorProfile(const KoColorProfile* monitorProfile,
     m_renderingIntent = renderingIntent;
     m_conversionFlags = conversionFlags;
 
+    {
+        QMutexLocker l(&m_displayLutLock);
+        m_displayLut.clear();
+    }
+
     rebuildPyramid();
 }
 
@@ -152,6 +177,32 @@ void KisImagePyramid::rebuildPyramid()
     }
 }
 
+QSharedPointer<KoLut3DColorConversionTransformation> KisImagePyramid::displayLut(const KoColorSpace *srcCs)
+{
+    QMutexLocker l(&m_displayLutLock);
+
+    if (m_displayLutGridSize <= 0 || !m_monitorColorSpace ||
+        *srcCs == *m_monitorColorSpace ||
+        !KoLut3DColorConversionTransformation::isSupported(srcCs, m_monitorColorSpace)) {
+
+        return QSharedPointer<KoLut3DColorConversionTransformation>();
+    }
+
+    if (!m_displayLut ||
+        m_displayLut->gridSize() != m_displayLutGridSize ||
+        m_displayLut->dstColorSpace() != m_monitorColorSpace ||
+        !(*m_displayLut->srcColorSpace() == *srcCs)) {
+
+        QScopedPointer<KoColorConversionTransformation> transform(
+            srcCs->createColorConverter(m_monitorColorSpace, m_renderingIntent, m_conversionFlags));
+
+        m_displayLut.reset(
+            KoLut3DColorConversionTransformation::create(transform.data(), m_displayLutGridSize));
+    }
+
+    return m_displayLut;
+}
+
 void KisImagePyramid::clearPyramid()
 {
     for (qint32 i = 0; i < m_pyramidHeight; i++) {
@@ -283,7 +334,13 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
         }
 
         QScopedArrayPointer<quint8> dst(new quint8[m_monitorColorSpace->pixelSize() * numPixels]);
-        projectionCs->convertPixelsTo(originalBytes.data(), dst.data(), m_monitorColorSpace, numPixels, m_renderingIntent, m_conversionFlags);
+
+        QSharedPointer<KoLut3DColorConversionTransformation> lut = displayLut(projectionCs);
+        if (lut) {
+            lut->transform(originalBytes.data(), dst.data(), numPixels);
+        } else {
+            projectionCs->convertPixelsTo(originalBytes.data(), dst.data(), m_monitorColorSpace, numPixels, m_renderingIntent, m_conversionFlags);
+        }
         originalBytes.swap(dst);
     }
 
@@ -335,9 +392,47 @@ QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
     qint32 dstWidth = srcWidth / 2;
     qint32 dstHeight = srcHeight / 2;
 
+    const QRect dstRect(dstX, dstY, dstWidth, dstHeight);
+
+    if (dstWidth * dstHeight < minParallelDownsamplePixels) {
+        downsampleStripe(dstRect, src, dst);
+        return dstRect;
+    }
+
+    /**
+     * Big updates (e.g. loading of a new image) are split into
+     * stripes of the destination tiles, which are downsampled
+     * in parallel
+     */
+    QVector<QRect> stripes;
+
+    for (qint32 y = dstY; y < dstY + dstHeight;) {
+        const qint32 stripeEnd =
+            qMin(dstY + dstHeight, (y / downsampleStripeHeight + 1) * downsampleStripeHeight);
+
+        stripes << QRect(dstX, y, dstWidth, stripeEnd - y);
+        y = stripeEnd;
+    }
+
+    QtConcurrent::blockingMap(stripes,
+        [src, dst] (const QRect &stripe) {
+            downsampleStripe(stripe, src, dst);
+        });
+
+    return dstRect;
+}
+
+void KisImagePyramid::downsampleStripe(const QRect &dstRect,
+                                       KisPaintDevice *src, KisPaintDevice *dst)
+{
+    const qint32 srcX = 2 * dstRect.x();
+    const qint32 srcY = 2 * dstRect.y();
+    const qint32 srcWidth = 2 * dstRect.width();
+    const qint32 dstHeight = dstRect.height();
+
     KisHLineConstIteratorSP srcIt0 = src->createHLineConstIteratorNG(srcX, srcY, srcWidth);
     KisHLineConstIteratorSP srcIt1 = src->createHLineConstIteratorNG(srcX, srcY + 1, srcWidth);
-    KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(dstX, dstY, dstWidth);
+    KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(dstRect.x(), dstRect.y(), dstRect.width());
 
     int conseqPixels = 0;
     for (int row = 0; row < dstHeight; ++row) {
@@ -361,7 +456,6 @@ QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
         srcIt1->nextRow();
         dstIt->nextRow();
     }
-    return QRect(dstX, dstY, dstWidth, dstHeight);
 }
 
 void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
@@ -369,10 +463,6 @@ void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
                                         quint8 *dstRow,
                                         qint32 numSrcPixels)
 {
-    /**
-     * FIXME (mandatory): Use SSE and friends here.
-     */
-
     qint16 b = 0;
     qint16 g = 0;
     qint16 r = 0;
@@ -380,7 +470,38 @@ void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
 
     static const qint32 pixelSize = 4; // This is preview argb8 mode
 
-    for (qint32 i = 0; i < numSrcPixels / 2; i++) {
+    qint32 i = 0;
+
+#ifdef HAVE_SSE2_DOWNSAMPLING
+    /**
+     * Every step reads four pixels from each of the source rows and
+     * writes two destination pixels. The channels are summed in 16-bit,
+     * so the result is exactly the same as in the scalar loop below.
+     */
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 2 <= numSrcPixels / 2; i += 2) {
+        const __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcRow0));
+        const __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcRow1));
+
+        // vertical sums of the pixels 0, 1 and 2, 3
+        const __m128i sum01 = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+        const __m128i sum23 = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+
+        // horizontal sums: the pixels 0 + 1 and 2 + 3
+        const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sum01, sum23),
+                                          _mm_unpackhi_epi64(sum01, sum23));
+
+        const __m128i result = _mm_packus_epi16(_mm_srli_epi16(sum, 2), zero);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dstRow), result);
+
+        dstRow += 2 * pixelSize;
+        srcRow0 += 4 * pixelSize;
+        srcRow1 += 4 * pixelSize;
+    }
+#endif
+
+    for (; i < numSrcPixels / 2; i++) {
         b = srcRow0[0] + srcRow1[0] + srcRow0[4] + srcRow1[4];
         g = srcRow0[1] + srcRow1[1] + srcRow0[5] + srcRow1[5];
         r = srcRow0[2] + srcRow1[2] + srcRow0[6] + srcRow1[6];
@@ -491,5 +612,8 @@ void KisImagePyramid::configChanged()
 {
     KisConfig cfg(true);
     m_useOcio = cfg.useOcio();
+
+    QMutexLocker l(&m_displayLutLock);
+    m_displayLutGridSize = cfg.displayConversionLutGridSize();
 }
 
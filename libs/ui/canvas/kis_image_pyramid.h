@@ -10,12 +10,16 @@
 #include <QImage>
 #include <QVector>
 #include <QThreadStorage>
+#include <QMutex>
+#include <QSharedPointer>
 
 #include <KoColorSpace.h>
 #include <kis_image.h>
 #include <kis_paint_device.h>
 #include "kis_projection_backend.h"
 
+class KoLut3DColorConversionTransformation;
+
 
 class KisImagePyramid : QObject, public KisProjectionBackend
 {
@@ -65,6 +69,13 @@ private:
 
     void retrieveImageData(const QRect &rect);
     void rebuildPyramid();
+
+    /**
+     * Returns the lookup table the conversion from \p srcCs into
+     * the monitor color space is baked into, or null if the pixels
+     * should be converted directly
+     */
+    QSharedPointer<KoLut3DColorConversionTransformation> displayLut(const KoColorSpace *srcCs);
     void clearPyramid();
 
     /**
@@ -75,13 +86,20 @@ private:
     QRect downsampleByFactor2(const QRect& srcRect,
                               KisPaintDevice* src, KisPaintDevice* dst);
 
+    /**
+     * Downsamples the area of @src paint device covering
+     * @dstRect of @dst paint device
+     */
+    static void downsampleStripe(const QRect &dstRect,
+                                 KisPaintDevice *src, KisPaintDevice *dst);
+
     /**
      * Auxiliary function. Downsamples two lines in @srcRow0
      * and @srcRow1 into one line @dstRow
      * Note: @numSrcPixels must be EVEN
      */
-    void downsamplePixels(const quint8 *srcRow0, const quint8 *srcRow1,
-                          quint8 *dstRow, qint32 numSrcPixels);
+    static void downsamplePixels(const quint8 *srcRow0, const quint8 *srcRow1,
+                                 quint8 *dstRow, qint32 numSrcPixels);
 
     /**
      * Searches for the last pyramid plane that can cover
@@ -122,6 +140,10 @@ private:
 
     bool m_useOcio;
 
+    int m_displayLutGridSize;
+    QSharedPointer<KoLut3DColorConversionTransformation> m_displayLut;
+    QMutex m_displayLutLock;
+
     QBitArray m_channelFlags;
     bool m_allChannelsSelected;
     bool m_onlyOneChannelSelected;
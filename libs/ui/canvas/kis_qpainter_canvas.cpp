@@ -23,6 +23,7 @@
 
 #include <kis_debug.h>
 #include <kis_config.h>
+#include <KisStrokeLatencyMonitor.h>
 
 #include <KoColorProfile.h>
 #include "kis_coordinates_converter.h"
@@ -124,6 +125,8 @@ void KisQPainterCanvas::paintEvent(QPaintEvent * ev)
 #endif
 
     drawDecorations(gc, ev->rect());
+
+    KisStrokeLatencyMonitor::instance()->reportFramePresented();
 }
 
 void KisQPainterCanvas::drawImage(QPainter & gc, const QRect &updateWidgetRect) const
@@ -49,7 +49,8 @@ int KisPPUpdateInfo::levelOfDetail() const
 }
 
 KisOpenGLUpdateInfo::KisOpenGLUpdateInfo()
-    : m_levelOfDetail(0)
+    : m_levelOfDetail(0),
+      m_isProjectionPyramidUpdate(false)
 {
 }
 
@@ -78,9 +79,20 @@ int KisOpenGLUpdateInfo::levelOfDetail() const
     return m_levelOfDetail;
 }
 
+void KisOpenGLUpdateInfo::assignProjectionPyramidUpdate(bool value)
+{
+    m_isProjectionPyramidUpdate = value;
+}
+
+bool KisOpenGLUpdateInfo::isProjectionPyramidUpdate() const
+{
+    return m_isProjectionPyramidUpdate;
+}
+
 bool KisOpenGLUpdateInfo::tryMergeWith(const KisOpenGLUpdateInfo &rhs)
 {
     if (m_levelOfDetail != rhs.m_levelOfDetail) return false;
+    if (m_isProjectionPyramidUpdate != rhs.m_isProjectionPyramidUpdate) return false;
 
     // TODO: that makes the algorithm of updates compressor incorrect!
     m_dirtyImageRect |= rhs.m_dirtyImageRect;
@@ -90,6 +102,21 @@ bool KisOpenGLUpdateInfo::tryMergeWith(const KisOpenGLUpdateInfo &rhs)
     return true;
 }
 
+KisOpenGLUpdateInfoSP KisOpenGLUpdateInfo::splitOff(int numTiles)
+{
+    KisOpenGLUpdateInfoSP rest = new KisOpenGLUpdateInfo();
+    rest->m_dirtyImageRect = m_dirtyImageRect;
+    rest->m_levelOfDetail = m_levelOfDetail;
+    rest->m_isProjectionPyramidUpdate = m_isProjectionPyramidUpdate;
+
+    if (numTiles < tileList.size()) {
+        rest->tileList = tileList.mid(numTiles);
+        tileList.erase(tileList.begin() + numTiles, tileList.end());
+    }
+
+    return rest;
+}
+
 KisMarkerUpdateInfo::KisMarkerUpdateInfo(KisMarkerUpdateInfo::Type type, const QRect &dirtyImageRect)
     : m_type(type),
       m_dirtyImageRect(dirtyImageRect)
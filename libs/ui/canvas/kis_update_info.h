@@ -48,6 +48,13 @@ struct ConversionOptions {
     const KoColorSpace *m_destinationColorSpace = 0;
     KoColorConversionTransformation::Intent m_renderingIntent;
     KoColorConversionTransformation::ConversionFlags m_conversionFlags;
+
+    /**
+     * The grid size of the lookup table the display conversion is baked
+     * into, zero means that the pixels are converted directly
+     * \see KoLut3DColorConversionTransformation
+     */
+    int m_lutGridSize = 0;
 };
 
 class KisOpenGLUpdateInfo;
@@ -68,11 +75,27 @@ public:
 
     int levelOfDetail() const override;
 
+    /**
+     * Shows whether the tiles of the update were fetched from the
+     * downscaled projection of the zoomed out canvas instead of the
+     * image itself
+     */
+    void assignProjectionPyramidUpdate(bool value);
+    bool isProjectionPyramidUpdate() const;
+
     bool tryMergeWith(const KisOpenGLUpdateInfo& rhs);
 
+    /**
+     * Moves all the tiles except the first \p numTiles ones into a new
+     * update info with the same dirty rect and level of detail. Used for
+     * uploading huge updates in chunks.
+     */
+    KisOpenGLUpdateInfoSP splitOff(int numTiles);
+
 private:
     QRect m_dirtyImageRect;
     int m_levelOfDetail;
+    bool m_isProjectionPyramidUpdate;
 };
 
 
@@ -85,6 +85,37 @@ int KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(KisAnimationFrameCac
     return result;
 }
 
+int KisAsyncAnimationCacheRenderDialog::calcNearestDirtyFrame(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange, int currentTime)
+{
+    int result = -1;
+
+    KisImageSP image = cache->image();
+    if (!image) return result;
+
+    KisImageAnimationInterface *animation = image->animationInterface();
+    if (!animation->hasAnimation()) return result;
+
+    if (playbackRange.isValid()) {
+        KIS_ASSERT_RECOVER_RETURN_VALUE(!playbackRange.isInfinite(), result);
+
+        const int numFrames = playbackRange.duration();
+        const int startOffset = playbackRange.contains(currentTime) ? currentTime - playbackRange.start() : 0;
+
+        for (int i = 0; i < numFrames; i++) {
+            const int frame = playbackRange.start() + (startOffset + i) % numFrames;
+
+            if (skipRange.contains(frame)) continue;
+
+            if (cache->frameStatus(frame) != KisAnimationFrameCache::Cached) {
+                result = frame;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
 
 struct KisAsyncAnimationCacheRenderDialog::Private
 {
@@ -19,6 +19,13 @@ public:
 
     static int calcFirstDirtyFrame(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange);
 
+    /**
+     * @return the first dirty frame of \p playbackRange the playback would
+     * reach starting from \p currentTime, i.e. the frames after the current
+     * one are checked first and the search wraps around the end of the range
+     */
+    static int calcNearestDirtyFrame(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange, int currentTime);
+
 protected:
     QList<int> calcDirtyFrames() const override;
     KisAsyncAnimationRendererBase* createRenderer(KisImageSP image) override;
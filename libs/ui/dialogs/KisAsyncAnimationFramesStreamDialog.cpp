@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAsyncAnimationFramesStreamDialog.h"
+
+#include <QMap>
+
+#include <klocalizedstring.h>
+
+#include <kis_image.h>
+#include <kis_time_span.h>
+
+#include "KisAsyncAnimationFramesStreamingRenderer.h"
+#include "animation/KisVideoSaver.h"
+
+struct KisAsyncAnimationFramesStreamDialog::Private
+{
+    Private(KisImageSP _image, const KisTimeSpan &_range, bool _forceSRGB, KisVideoSaver *_encoder)
+        : image(_image),
+          range(_range),
+          forceSRGB(_forceSRGB),
+          encoder(_encoder)
+    {
+    }
+
+    struct PendingFrame {
+        int numFrames = 1;
+        QByteArray pixels;
+    };
+
+    KisImageSP image;
+    KisTimeSpan range;
+    bool forceSRGB = false;
+    KisVideoSaver *encoder = 0;
+
+    /// the frames completed before some of the preceding ones
+    QMap<int, PendingFrame> pendingFrames;
+    int nextFrame = 0;
+    bool encoderFailed = false;
+};
+
+KisAsyncAnimationFramesStreamDialog::KisAsyncAnimationFramesStreamDialog(KisImageSP image,
+                                                                         const KisTimeSpan &range,
+                                                                         bool forceSRGB,
+                                                                         KisVideoSaver *encoder)
+    : KisAsyncAnimationRenderDialogBase(i18n("Encoding frames..."), image, 0),
+      m_d(new Private(image, range, forceSRGB, encoder))
+{
+}
+
+KisAsyncAnimationFramesStreamDialog::~KisAsyncAnimationFramesStreamDialog()
+{
+}
+
+KisAsyncAnimationRenderDialogBase::Result KisAsyncAnimationFramesStreamDialog::regenerateRange(KisViewManager *viewManager)
+{
+    m_d->pendingFrames.clear();
+    m_d->nextFrame = m_d->range.start();
+    m_d->encoderFailed = false;
+
+    Result result = KisAsyncAnimationRenderDialogBase::regenerateRange(viewManager);
+
+    KIS_SAFE_ASSERT_RECOVER (result != RenderComplete || m_d->pendingFrames.isEmpty()) {
+        result = RenderFailed;
+    }
+    m_d->pendingFrames.clear();
+
+    return m_d->encoderFailed ? RenderFailed : result;
+}
+
+QList<int> KisAsyncAnimationFramesStreamDialog::calcDirtyFrames() const
+{
+    QList<int> result;
+    for (int frame = m_d->range.start(); frame <= m_d->range.end(); frame++) {
+        KisTimeSpan heldFrameTimeRange = KisTimeSpan::calculateIdenticalFramesRecursive(m_d->image->root(), frame);
+        heldFrameTimeRange &= m_d->range;
+
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(heldFrameTimeRange.isValid(), result);
+
+        result.append(heldFrameTimeRange.start());
+        frame = heldFrameTimeRange.end();
+    }
+    return result;
+}
+
+KisAsyncAnimationRendererBase *KisAsyncAnimationFramesStreamDialog::createRenderer(KisImageSP image)
+{
+    Q_UNUSED(image);
+
+    KisAsyncAnimationFramesStreamingRenderer *renderer =
+        new KisAsyncAnimationFramesStreamingRenderer(m_d->range, m_d->forceSRGB);
+
+    connect(renderer, SIGNAL(sigFrameDataReady(int,int,QByteArray)),
+            SLOT(slotFrameDataReady(int,int,QByteArray)));
+
+    return renderer;
+}
+
+void KisAsyncAnimationFramesStreamDialog::initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer, KisImageSP image, int frame)
+{
+    Q_UNUSED(renderer);
+    Q_UNUSED(image);
+    Q_UNUSED(frame);
+}
+
+void KisAsyncAnimationFramesStreamDialog::slotFrameDataReady(int frame, int numFrames, const QByteArray &pixels)
+{
+    if (m_d->encoderFailed) return;
+
+    Private::PendingFrame pendingFrame;
+    pendingFrame.numFrames = numFrames;
+    pendingFrame.pixels = pixels;
+    m_d->pendingFrames.insert(frame, pendingFrame);
+
+    while (m_d->pendingFrames.contains(m_d->nextFrame)) {
+        const Private::PendingFrame readyFrame = m_d->pendingFrames.take(m_d->nextFrame);
+
+        for (int i = 0; i < readyFrame.numFrames; i++) {
+            if (!m_d->encoder->writeFrame(readyFrame.pixels)) {
+                m_d->encoderFailed = true;
+                m_d->pendingFrames.clear();
+                abortRegeneration();
+                return;
+            }
+        }
+
+        m_d->nextFrame += readyFrame.numFrames;
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISASYNCANIMATIONFRAMESSTREAMDIALOG_H
+#define KISASYNCANIMATIONFRAMESSTREAMDIALOG_H
+
+#include "KisAsyncAnimationRenderDialogBase.h"
+#include "kis_types.h"
+
+class KisVideoSaver;
+
+/**
+ * Renders the frames of \p range and streams them into \p encoder, which
+ * should have been started with KisVideoSaver::startStreaming().
+ *
+ * The frames are rendered on several clones of the image at once, so they
+ * are completed out of order. They are kept until all the preceding frames
+ * are passed to the encoder, and the held frames are repeated, so the
+ * encoder gets exactly one picture per frame of the range.
+ */
+class KRITAUI_EXPORT KisAsyncAnimationFramesStreamDialog : public KisAsyncAnimationRenderDialogBase
+{
+    Q_OBJECT
+public:
+    KisAsyncAnimationFramesStreamDialog(KisImageSP image,
+                                        const KisTimeSpan &range,
+                                        bool forceSRGB,
+                                        KisVideoSaver *encoder);
+
+    ~KisAsyncAnimationFramesStreamDialog();
+
+    Result regenerateRange(KisViewManager *viewManager) override;
+
+protected:
+    QList<int> calcDirtyFrames() const override;
+    KisAsyncAnimationRendererBase* createRenderer(KisImageSP image) override;
+    void initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer,
+                                    KisImageSP image, int frame) override;
+
+private Q_SLOTS:
+    void slotFrameDataReady(int frame, int numFrames, const QByteArray &pixels);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISASYNCANIMATIONFRAMESSTREAMDIALOG_H
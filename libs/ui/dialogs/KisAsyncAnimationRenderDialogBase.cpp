@@ -165,9 +165,9 @@ KisAsyncAnimationRenderDialogBase::regenerateRange(KisViewManager *viewManager)
 
     KisImageConfig cfg(true);
 
-    const int maxThreads = cfg.maxNumberOfThreads();
+    const int maxThreads = cfg.frameRenderingThreads();
     const int numAllowedWorker = 1 + calculateNumberMemoryAllowedClones(m_d->image);
-    const int proposedNumWorkers = qMin(m_d->dirtyFramesCount, cfg.frameRenderingClones());
+    const int proposedNumWorkers = qMin(qMin(m_d->dirtyFramesCount, cfg.frameRenderingClones()), maxThreads);
     const int numWorkers = qMin(proposedNumWorkers, numAllowedWorker);
     const int numThreadsPerWorker = qMax(1, qCeil(qreal(maxThreads) / numWorkers));
 
@@ -204,6 +204,9 @@ KisAsyncAnimationRenderDialogBase::regenerateRange(KisViewManager *viewManager)
             pair.image->unlock();
         }
 
+        if (!pair.renderer->waitForPendingFrames() && m_d->result == RenderComplete) {
+            m_d->result = RenderFailed;
+        }
     }
     m_d->asyncRenderers.clear();
 
@@ -253,6 +256,11 @@ void KisAsyncAnimationRenderDialogBase::slotCancelRegeneration()
     cancelProcessingImpl(true);
 }
 
+void KisAsyncAnimationRenderDialogBase::abortRegeneration()
+{
+    cancelProcessingImpl(false);
+}
+
 void KisAsyncAnimationRenderDialogBase::cancelProcessingImpl(bool isUserCancelled)
 {
     for (auto &pair : m_d->asyncRenderers) {
@@ -133,6 +133,12 @@ protected:
     virtual void initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer,
                                             KisImageSP image, int frame) = 0;
 
+    /**
+     * @brief stops the regeneration with RenderFailed result, e.g. when
+     *        the derived class cannot pass the rendered frames anywhere
+     */
+    void abortRegeneration();
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
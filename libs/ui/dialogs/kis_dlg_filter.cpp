@@ -126,7 +126,7 @@ void KisDlgFilter::setDialogTitle(KisFilterSP filter)
     setWindowTitle(filter.isNull() ? i18nc("@title:window", "Filter") : i18nc("@title:window", "Filter: %1", filter->name()));
 }
 
-void KisDlgFilter::startApplyingFilter(KisFilterConfigurationSP config)
+void KisDlgFilter::startApplyingFilter(KisFilterConfigurationSP config, bool progressivePreview)
 {
     if (!d->uiFilterDialog.filterSelection->configuration()) return;
 
@@ -134,7 +134,7 @@ void KisDlgFilter::startApplyingFilter(KisFilterConfigurationSP config)
         config->setChannelFlags(qobject_cast<KisPaintLayer*>(d->node.data())->channelLockFlags());
     }
 
-    d->filterManager->apply(config);
+    d->filterManager->apply(config, progressivePreview);
 }
 
 void KisDlgFilter::updatePreview()
@@ -147,7 +147,7 @@ void KisDlgFilter::updatePreview()
 
     if (d->uiFilterDialog.checkBoxPreview->isChecked()) {
         KisFilterConfigurationSP config(d->uiFilterDialog.filterSelection->configuration());
-        startApplyingFilter(config);
+        startApplyingFilter(config, true);
     }
 
     d->uiFilterDialog.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
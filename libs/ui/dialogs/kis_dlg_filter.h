@@ -54,7 +54,7 @@ public Q_SLOTS:
     void adjustSize();
 
 private:
-    void startApplyingFilter(KisFilterConfigurationSP config);
+    void startApplyingFilter(KisFilterConfigurationSP config, bool progressivePreview = false);
     void setDialogTitle(KisFilterSP f);
     void updatePreview();
 
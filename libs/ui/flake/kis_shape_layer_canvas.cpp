@@ -8,6 +8,7 @@
 
 #include <QPainter>
 #include <QMutexLocker>
+#include <QtConcurrent>
 
 #include <KoShapeManager.h>
 #include <KoSelectedShapesProxySimple.h>
@@ -345,18 +346,14 @@ void KisShapeLayerCanvas::repaint()
     const qint32 MASK_IMAGE_WIDTH = 256;
     const qint32 MASK_IMAGE_HEIGHT = 256;
 
-    QImage image(MASK_IMAGE_WIDTH, MASK_IMAGE_HEIGHT, QImage::Format_ARGB32);
-    QPainter tempPainter(&image);
-
-    tempPainter.setRenderHint(QPainter::Antialiasing);
-    tempPainter.setRenderHint(QPainter::TextAntialiasing);
-
-    quint8 * dstData = new quint8[MASK_IMAGE_WIDTH * MASK_IMAGE_HEIGHT * m_projection->pixelSize()];
-
     QRect repaintRect = paintJobsOrder.uncroppedViewUpdateRect;
     m_projection->clear(repaintRect);
 
+    QList<KoShapeManager::PaintJob> paintJobs;
+
     Q_FOREACH (const KoShapeManager::PaintJob &job, paintJobsOrder.jobs) {
+        repaintRect |= job.viewUpdateRect;
+
         if (job.isEmpty()) {
             m_projection->clear(job.viewUpdateRect);
             continue;
@@ -367,53 +364,52 @@ void KisShapeLayerCanvas::repaint()
             continue;
         }
 
-        image.fill(0);
+        paintJobs << job;
+    }
+
+    /**
+     * Every job contains only the cloned shapes intersecting its patch,
+     * and paintJob() doesn't touch the internals of the shape manager,
+     * so the patches are rasterized in parallel, each one with its own
+     * image and painter. Writing into the projection is serialized by
+     * the data manager.
+     */
+    QtConcurrent::blockingMap(paintJobs,
+        [this] (const KoShapeManager::PaintJob &job) {
+            const int width = job.viewUpdateRect.width();
+            const int height = job.viewUpdateRect.height();
 
-        tempPainter.setTransform(QTransform());
-        tempPainter.setClipRect(QRect(0,0,job.viewUpdateRect.width(), job.viewUpdateRect.height()));
-        tempPainter.setTransform(m_viewConverter->documentToView() *
-                                 QTransform::fromTranslate(-job.viewUpdateRect.x(), -job.viewUpdateRect.y()));
+            QImage image(width, height, QImage::Format_ARGB32);
+            image.fill(0);
 
-        m_shapeManager->paintJob(tempPainter, job, false);
+            QPainter tempPainter(&image);
 
-        if (image.size() != job.viewUpdateRect.size()) {
-            const quint8 *imagePtr = image.constBits();
-            const int imageRowStride = 4 * image.width();
+            tempPainter.setRenderHint(QPainter::Antialiasing);
+            tempPainter.setRenderHint(QPainter::TextAntialiasing);
 
-            for (int y = 0; y < job.viewUpdateRect.height(); y++) {
+            tempPainter.setClipRect(QRect(0, 0, width, height));
+            tempPainter.setTransform(m_viewConverter->documentToView() *
+                                     QTransform::fromTranslate(-job.viewUpdateRect.x(), -job.viewUpdateRect.y()));
 
-                KoColorSpaceRegistry::instance()->rgb8()
-                        ->convertPixelsTo(imagePtr, dstData, m_projection->colorSpace(),
-                                          job.viewUpdateRect.width(),
-                                          KoColorConversionTransformation::internalRenderingIntent(),
-                                          KoColorConversionTransformation::internalConversionFlags());
+            m_shapeManager->paintJob(tempPainter, job, false);
+            tempPainter.end();
 
-                m_projection->writeBytes(dstData,
-                                         job.viewUpdateRect.x(),
-                                         job.viewUpdateRect.y() + y,
-                                         job.viewUpdateRect.width(),
-                                         1);
+            // QImage rows are 4-byte aligned, so there is no padding in ARGB32 images
+            QScopedArrayPointer<quint8> dstData(new quint8[width * height * m_projection->pixelSize()]);
 
-                imagePtr += imageRowStride;
-            }
-        } else {
             KoColorSpaceRegistry::instance()->rgb8()
-                    ->convertPixelsTo(image.constBits(), dstData, m_projection->colorSpace(),
-                                      MASK_IMAGE_WIDTH * MASK_IMAGE_HEIGHT,
+                    ->convertPixelsTo(image.constBits(), dstData.data(), m_projection->colorSpace(),
+                                      width * height,
                                       KoColorConversionTransformation::internalRenderingIntent(),
                                       KoColorConversionTransformation::internalConversionFlags());
 
-            m_projection->writeBytes(dstData,
+            m_projection->writeBytes(dstData.data(),
                                      job.viewUpdateRect.x(),
                                      job.viewUpdateRect.y(),
-                                     MASK_IMAGE_WIDTH,
-                                     MASK_IMAGE_HEIGHT);
-
-        }
-        repaintRect |= job.viewUpdateRect;
-    }
+                                     width,
+                                     height);
+        });
 
-    delete[] dstData;
     m_projection->purgeDefaultPixels();
     m_parentLayer->setDirty(repaintRect);
 
@@ -115,13 +115,17 @@ struct KisAnimationCachePopulator::Private
 
     bool tryRequestGeneration()
     {
-        if (!priorityFrames.isEmpty()) {
+        /**
+         * The most recently requested frames go first. The older requests
+         * may have already been cached in the meantime, so skip them.
+         */
+        while (!priorityFrames.isEmpty()) {
             KisImageSP image = priorityFrames.top().first;
             const int priorityFrame = priorityFrames.top().second;
             priorityFrames.pop();
 
             KisAnimationFrameCacheSP cache = KisAnimationFrameCache::cacheForImage(image);
-            KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(cache, false);
+            if (!cache || cache->frameStatus(priorityFrame) == KisAnimationFrameCache::Cached) continue;
 
             bool requested = tryRequestGeneration(cache, KisTimeSpan(), priorityFrame);
             if (requested) return true;
@@ -179,9 +183,23 @@ struct KisAnimationCachePopulator::Private
         if (!image) return false;
 
         KisImageAnimationInterface *animation = image->animationInterface();
-        KisTimeSpan currentRange = animation->fullClipRange();
+        const KisTimeSpan fullRange = animation->fullClipRange();
+        const KisTimeSpan playbackRange = animation->playbackRange();
+
+        int frame = priorityFrame;
 
-        const int frame = priorityFrame >= 0 ? priorityFrame : KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(cache, currentRange, skipRange);
+        /**
+         * The frames the playback would reach first are generated first,
+         * so that starting the playback is smooth even when the cache has
+         * not been filled completely yet
+         */
+        if (frame < 0) {
+            frame = KisAsyncAnimationCacheRenderDialog::calcNearestDirtyFrame(cache, playbackRange, skipRange, animation->currentUITime());
+        }
+
+        if (frame < 0 && !(playbackRange == fullRange)) {
+            frame = KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(cache, fullRange, skipRange);
+        }
 
         if (frame >= 0) {
             return regenerate(cache, frame);
@@ -204,6 +222,14 @@ struct KisAnimationCachePopulator::Private
          */
         enterState(WaitingForFrame);
 
+        requestedFrame = frame;
+        requestCache = cache;
+
+        imageRequestConnections.clear();
+        imageRequestConnections.addConnection(
+                    cache->image()->animationInterface(), SIGNAL(sigFramesChanged(KisTimeSpan,QRect)),
+                    q, SLOT(slotFramesChanged(KisTimeSpan)));
+
         regenerator.setFrameCache(cache);
 
         // if we ever decide to add ROI to background cache
@@ -213,6 +239,12 @@ struct KisAnimationCachePopulator::Private
         return true;
     }
 
+    void clearRequest() {
+        imageRequestConnections.clear();
+        requestedFrame = -1;
+        requestCache.clear();
+    }
+
     QString debugStateToString(State newState) {
         QString str = "<unknown>";
 
@@ -316,14 +348,32 @@ void KisAnimationCachePopulator::slotRequestRegeneration()
 void KisAnimationCachePopulator::slotRegeneratorFrameCancelled()
 {
     KIS_ASSERT_RECOVER_RETURN(m_d->state == Private::WaitingForFrame);
+    m_d->clearRequest();
     m_d->enterState(Private::NotWaitingForAnything);
 }
 
 void KisAnimationCachePopulator::slotRegeneratorFrameReady()
 {
+    m_d->clearRequest();
     m_d->enterState(Private::BetweenFrames);
 }
 
+void KisAnimationCachePopulator::slotFramesChanged(const KisTimeSpan &range)
+{
+    if (m_d->state != Private::WaitingForFrame || !range.contains(m_d->requestedFrame)) return;
+
+    /**
+     * The frame has been changed while it was being regenerated, so the
+     * result would be dropped anyway. Cancel it and let the idle check
+     * choose the frame anew, it is probably not the same one anymore.
+     */
+    if (m_d->regenerator.isActive()) {
+        m_d->regenerator.cancelCurrentFrameRendering();
+    }
+
+    m_d->enterState(Private::WaitingForIdle);
+}
+
 void KisAnimationCachePopulator::slotConfigChanged()
 {
     KisConfig cfg(true);
@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KisPart;
+class KisTimeSpan;
 
 class KisAnimationCachePopulator : public QObject
 {
@@ -37,6 +38,8 @@ private Q_SLOTS:
     void slotRegeneratorFrameCancelled();
     void slotRegeneratorFrameReady();
 
+    void slotFramesChanged(const KisTimeSpan &range);
+
     void slotConfigChanged();
 
 private:
@@ -7,6 +7,9 @@
 #include "kis_animation_frame_cache.h"
 
 #include <QMap>
+#include <QMutex>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include "kis_debug.h"
 
@@ -21,6 +24,7 @@
 #include "KisInMemoryFrameCacheSwapper.h"
 
 #include "kis_image_config.h"
+#include "KisImageMemoryBudget.h"
 #include "kis_config_notifier.h"
 
 #include "opengl/kis_opengl_image_textures.h"
@@ -39,6 +43,7 @@ struct KisAnimationFrameCache::Private
 
     ~Private()
     {
+        prefetchPool.waitForDone();
     }
 
     KisOpenGLImageTexturesSP textures;
@@ -47,6 +52,18 @@ struct KisAnimationFrameCache::Private
     QScopedPointer<KisAbstractFrameCacheSwapper> swapper;
     int frameSizeLimit = 777;
 
+    /**
+     * The cached frames are stored compressed, so the frames ahead of the
+     * playhead are decoded on a worker thread, not to stall the playback.
+     * The swapper itself is not thread-safe, all the calls that load or
+     * modify the frames are serialized with the lock.
+     */
+    QMutex swapperLock;
+    QThreadPool prefetchPool;
+    QMap<int, QFuture<KisOpenGLUpdateInfoSP>> prefetchedFrames;
+    int lastLoadedFrameId = -1;
+    static const int maxPrefetchedFrames = 2;
+
     KisOpenGLUpdateInfoSP fetchFrameDataImpl(KisImageSP image, const QRect &requestedRect, int lod);
 
     struct Frame
@@ -96,7 +113,51 @@ struct KisAnimationFrameCache::Private
     KisOpenGLUpdateInfoSP getFrame(int time)
     {
         const int frameId = getFrameIdAtTime(time);
-        return frameId >= 0 ? swapper->loadFrame(frameId) : 0;
+        if (frameId < 0) return 0;
+
+        lastLoadedFrameId = frameId;
+
+        auto it = prefetchedFrames.find(frameId);
+        if (it != prefetchedFrames.end()) {
+            // waits for the worker if the frame is still being decoded
+            KisOpenGLUpdateInfoSP info = it->result();
+            prefetchedFrames.erase(it);
+            return info;
+        }
+
+        QMutexLocker l(&swapperLock);
+        return swapper->loadFrame(frameId);
+    }
+
+    void prefetchFrame(int time)
+    {
+        const int frameId = getFrameIdAtTime(time);
+        // the held frames are not uploaded again, no need to decode them
+        if (frameId < 0 || frameId == lastLoadedFrameId ||
+            prefetchedFrames.contains(frameId)) return;
+
+        if (prefetchedFrames.size() >= maxPrefetchedFrames) {
+            prefetchedFrames.erase(prefetchedFrames.begin());
+        }
+
+        prefetchedFrames.insert(frameId, QtConcurrent::run(&prefetchPool,
+            [this, frameId] () {
+                QMutexLocker l(&swapperLock);
+
+                // the frame could have been dropped while the job was queued
+                return swapper->hasFrame(frameId) ?
+                    swapper->loadFrame(frameId) : KisOpenGLUpdateInfoSP();
+            }));
+    }
+
+    /**
+     * Drops the prefetched frames, should be called on every change of
+     * the cached frames, since the same frame id may get a new content
+     */
+    void dropPrefetchedFrames()
+    {
+        prefetchedFrames.clear();
+        lastLoadedFrameId = -1;
     }
 
     void addFrame(KisOpenGLUpdateInfoSP info, const KisTimeSpan& range)
@@ -105,6 +166,10 @@ struct KisAnimationFrameCache::Private
 
         const int length = range.isInfinite() ? -1 : range.end() - range.start() + 1;
         newFrames.insert(range.start(), length);
+
+        dropPrefetchedFrames();
+
+        QMutexLocker l(&swapperLock);
         swapper->saveFrame(range.start(), info, image->bounds());
     }
 
@@ -117,6 +182,9 @@ struct KisAnimationFrameCache::Private
     {
         if (newFrames.isEmpty()) return false;
 
+        dropPrefetchedFrames();
+        QMutexLocker l(&swapperLock);
+
         bool cacheChanged = false;
 
         auto it = newFrames.lowerBound(range.start());
@@ -216,6 +284,25 @@ KisAnimationFrameCache::KisAnimationFrameCache(KisOpenGLImageTexturesSP textures
 
     connect(m_d->image->animationInterface(), SIGNAL(sigFramesChanged(KisTimeSpan,QRect)), this, SLOT(framesChanged(KisTimeSpan,QRect)));
     connect(KisConfigNotifier::instance(), SIGNAL(configChanged()), SLOT(slotConfigChanged()));
+
+    /**
+     * There may be several caches for the same image (one per
+     * canvas), so the handler looks them up every time instead
+     * of keeping a pointer to this cache
+     */
+    KisImage *image = m_d->image.data();
+    image->memoryBudget()->setStepHandler(KisImageMemoryBudget::DropFrameCache,
+        [image] () {
+            bool framesDropped = false;
+
+            Q_FOREACH (KisAnimationFrameCache *cache, Private::caches) {
+                if (cache->image().data() == image) {
+                    framesDropped |= cache->dropAllFrames();
+                }
+            }
+
+            return framesDropped;
+        });
 }
 
 KisAnimationFrameCache::~KisAnimationFrameCache()
@@ -239,6 +326,11 @@ bool KisAnimationFrameCache::uploadFrame(int time)
     return bool(info);
 }
 
+void KisAnimationFrameCache::prefetchFrame(int time)
+{
+    m_d->prefetchFrame(time);
+}
+
 bool KisAnimationFrameCache::shouldUploadNewFrame(int newTime, int oldTime) const
 {
     if (oldTime < 0) return true;
@@ -276,13 +368,18 @@ void KisAnimationFrameCache::framesChanged(const KisTimeSpan &range, const QRect
 void KisAnimationFrameCache::slotConfigChanged()
 {
     m_d->newFrames.clear();
+    m_d->dropPrefetchedFrames();
 
     KisImageConfig cfg(true);
 
-    if (cfg.useOnDiskAnimationCacheSwapping()) {
-        m_d->swapper.reset(new KisFrameCacheSwapper(m_d->textures->updateInfoBuilder(), cfg.swapDir()));
-    } else {
-        m_d->swapper.reset(new KisInMemoryFrameCacheSwapper());
+    {
+        QMutexLocker l(&m_d->swapperLock);
+
+        if (cfg.useOnDiskAnimationCacheSwapping()) {
+            m_d->swapper.reset(new KisFrameCacheSwapper(m_d->textures->updateInfoBuilder(), cfg.swapDir()));
+        } else {
+            m_d->swapper.reset(new KisInMemoryFrameCacheSwapper(m_d->textures->updateInfoBuilder()));
+        }
     }
 
     m_d->frameSizeLimit = cfg.useAnimationCacheFrameSizeLimit() ? cfg.animationCacheFrameSizeLimit() : 0;
@@ -345,6 +442,9 @@ void KisAnimationFrameCache::dropLowQualityFrames(const KisTimeSpan &range, cons
     KIS_SAFE_ASSERT_RECOVER_RETURN(!range.isInfinite());
     if (m_d->newFrames.isEmpty()) return;
 
+    m_d->dropPrefetchedFrames();
+    QMutexLocker l(&m_d->swapperLock);
+
     auto it = m_d->newFrames.upperBound(range.start());
 
     // the vector is guaranteed to be non-empty,
@@ -372,6 +472,17 @@ void KisAnimationFrameCache::dropLowQualityFrames(const KisTimeSpan &range, cons
     }
 }
 
+bool KisAnimationFrameCache::dropAllFrames()
+{
+    const bool cacheChanged = m_d->invalidate(KisTimeSpan::infinite(0));
+
+    if (cacheChanged) {
+        emit changed();
+    }
+
+    return cacheChanged;
+}
+
 bool KisAnimationFrameCache::framesHaveValidRoi(const KisTimeSpan &range, const QRect &regionOfInterest)
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!range.isInfinite(), false);
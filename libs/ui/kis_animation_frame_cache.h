@@ -41,6 +41,13 @@ public:
     QImage getFrame(int time);
     bool uploadFrame(int time);
 
+    /**
+     * Starts decoding the cached frame at \p time on a worker thread,
+     * so that the following uploadFrame() for it doesn't need to wait
+     * for the frame to be loaded from the swapper
+     */
+    void prefetchFrame(int time);
+
     bool shouldUploadNewFrame(int newTime, int oldTime) const;
 
     enum CacheStatus {
@@ -63,6 +70,14 @@ public:
 
     bool framesHaveValidRoi(const KisTimeSpan &range, const QRect &regionOfInterest);
 
+    /**
+     * Drops all the cached frames, e.g. when the image is over
+     * its memory budget.
+     *
+     * \return true if any frames were dropped
+     */
+    bool dropAllFrames();
+
 Q_SIGNALS:
     void changed();
 
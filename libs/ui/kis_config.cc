@@ -26,6 +26,7 @@
 #include <KoColorSpaceRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorProfile.h>
+#include <KoLut3DColorConversionTransformation.h>
 
 #include <kis_debug.h>
 #include <kis_types.h>
@@ -607,6 +608,29 @@ void KisConfig::setUseBlackPointCompensation(bool useBlackPointCompensation) con
     m_cfg.writeEntry("useBlackPointCompensation", useBlackPointCompensation);
 }
 
+KisConfig::DisplayConversionLutMode KisConfig::displayConversionLutMode(bool defaultValue) const
+{
+    return (DisplayConversionLutMode)(defaultValue ? DISPLAY_LUT_DISABLED
+                                                   : m_cfg.readEntry("displayConversionLutMode", (int) DISPLAY_LUT_DISABLED));
+}
+
+void KisConfig::setDisplayConversionLutMode(DisplayConversionLutMode mode) const
+{
+    m_cfg.writeEntry("displayConversionLutMode", (int) mode);
+}
+
+int KisConfig::displayConversionLutGridSize(bool defaultValue) const
+{
+    switch (displayConversionLutMode(defaultValue)) {
+    case DISPLAY_LUT_FAST:
+        return KoLut3DColorConversionTransformation::FastGridSize;
+    case DISPLAY_LUT_ACCURATE:
+        return KoLut3DColorConversionTransformation::AccurateGridSize;
+    default:
+        return 0;
+    }
+}
+
 bool KisConfig::allowLCMSOptimization(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("allowLCMSOptimization", true));
@@ -748,6 +772,41 @@ int KisConfig::openGLTextureSize(bool defaultValue) const
     return (defaultValue ? 256 : m_cfg.readEntry("textureSize", 256));
 }
 
+int KisConfig::openGLTexturesMemoryLimit(bool defaultValue) const
+{
+    return (defaultValue ? 2048 : m_cfg.readEntry("openGLTexturesMemoryLimit", 2048));
+}
+
+bool KisConfig::useOpenGLProjectionPyramid(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("useOpenGLProjectionPyramid", true));
+}
+
+void KisConfig::setUseOpenGLProjectionPyramid(bool value)
+{
+    m_cfg.writeEntry("useOpenGLProjectionPyramid", value);
+}
+
+bool KisConfig::useOpenGLFramePacing(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("useOpenGLFramePacing", true));
+}
+
+void KisConfig::setUseOpenGLFramePacing(bool value)
+{
+    m_cfg.writeEntry("useOpenGLFramePacing", value);
+}
+
+bool KisConfig::cacheCanvasDecorations(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("cacheCanvasDecorations", true));
+}
+
+void KisConfig::setCacheCanvasDecorations(bool value)
+{
+    m_cfg.writeEntry("cacheCanvasDecorations", value);
+}
+
 bool KisConfig::disableVSync(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("disableVSync", true));
@@ -1795,6 +1854,36 @@ void KisConfig::setTrackTabletEventLatency(bool value)
     m_cfg.writeEntry("trackTabletEventLatency", value);
 }
 
+int KisConfig::freehandPredictionHorizon(bool defaultValue) const
+{
+    return (defaultValue ? 0 : m_cfg.readEntry("freehandPredictionHorizon", 0));
+}
+
+void KisConfig::setFreehandPredictionHorizon(int value)
+{
+    m_cfg.writeEntry("freehandPredictionHorizon", value);
+}
+
+QString KisConfig::strokeRecordingDirectory(bool defaultValue) const
+{
+    return (defaultValue ? QString() : m_cfg.readEntry("strokeRecordingDirectory", QString()));
+}
+
+void KisConfig::setStrokeRecordingDirectory(const QString &value)
+{
+    m_cfg.writeEntry("strokeRecordingDirectory", value);
+}
+
+bool KisConfig::parallelMultihandPainting(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("parallelMultihandPainting", true));
+}
+
+void KisConfig::setParallelMultihandPainting(bool value)
+{
+    m_cfg.writeEntry("parallelMultihandPainting", value);
+}
+
 bool KisConfig::testingAcceptCompressedTabletEvents(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("testingAcceptCompressedTabletEvents", false));
@@ -1855,6 +1944,16 @@ void KisConfig::setTrimKra(bool trim)
     m_cfg.writeEntry("TrimKra", trim);
 }
 
+bool KisConfig::fastSaveKra(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("FastSaveKra", false));
+}
+
+void KisConfig::setFastSaveKra(bool fastSave)
+{
+    m_cfg.writeEntry("FastSaveKra", fastSave);
+}
+
 bool KisConfig::toolOptionsInDocker(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("ToolOptionsInDocker", true));
@@ -151,6 +151,26 @@ public:
     bool allowLCMSOptimization(bool defaultValue = false) const;
     void setAllowLCMSOptimization(bool allowLCMSOptimization);
 
+    /**
+     * The display and soft-proofing conversions of the canvas can be
+     * baked into a 3D lookup table, which is much faster than converting
+     * every pixel with LCMS, but is slightly less precise.
+     */
+    enum DisplayConversionLutMode {
+        DISPLAY_LUT_DISABLED = 0,
+        DISPLAY_LUT_FAST,
+        DISPLAY_LUT_ACCURATE
+    };
+
+    DisplayConversionLutMode displayConversionLutMode(bool defaultValue = false) const;
+    void setDisplayConversionLutMode(DisplayConversionLutMode mode) const;
+
+    /**
+     * @return the grid size of the lookup table or 0 if the table
+     * shouldn't be used
+     */
+    int displayConversionLutGridSize(bool defaultValue = false) const;
+
     bool forcePaletteColors(bool defaultValue = false) const;
     void setForcePaletteColors(bool forcePaletteColors);
 
@@ -197,8 +217,37 @@ public:
 
     int numMipmapLevels(bool defaultValue = false) const;
     int openGLTextureSize(bool defaultValue = false) const;
+
+    /**
+     * @return the amount of video memory in MiB the canvas textures may
+     * take. The tiles exceeding the limit are uploaded only when visible.
+     */
+    int openGLTexturesMemoryLimit(bool defaultValue = false) const;
     int textureOverlapBorder() const;
 
+    /**
+     * @return true if the zoomed out OpenGL canvas should upload the
+     * level of the downscaled projection matching the zoom instead of
+     * filtering the full resolution textures
+     */
+    bool useOpenGLProjectionPyramid(bool defaultValue = false) const;
+    void setUseOpenGLProjectionPyramid(bool value);
+
+    /**
+     * @return true if the OpenGL canvas should be repainted at the pace
+     * its frames are swapped instead of the fixed frame rate timer
+     */
+    bool useOpenGLFramePacing(bool defaultValue = false) const;
+    void setUseOpenGLFramePacing(bool value);
+
+    /**
+     * @return true if the static decorations of the canvas (grid, guides,
+     * assistants) should be painted into a cached layer instead of being
+     * repainted on every update of the canvas
+     */
+    bool cacheCanvasDecorations(bool defaultValue = false) const;
+    void setCacheCanvasDecorations(bool value);
+
     quint32 getGridMainStyle(bool defaultValue = false) const;
     void setGridMainStyle(quint32 v) const;
 
@@ -487,6 +536,29 @@ public:
     bool trackTabletEventLatency(bool defaultValue = false) const;
     void setTrackTabletEventLatency(bool value);
 
+    /**
+     * The time in milliseconds the pen motion is extrapolated for
+     * in the stroke preview of the freehand tools, zero disables
+     * the prediction. The tiles under the predicted segment are
+     * also allocated ahead of the brush.
+     */
+    int freehandPredictionHorizon(bool defaultValue = false) const;
+    void setFreehandPredictionHorizon(int value);
+
+    /**
+     * The directory the freehand strokes are recorded into, see
+     * KisStrokeRecording. An empty string disables the recording.
+     */
+    QString strokeRecordingDirectory(bool defaultValue = false) const;
+    void setStrokeRecordingDirectory(const QString &value);
+
+    /**
+     * Paint the hands of the multihand tool in parallel when the areas
+     * they paint in do not intersect
+     */
+    bool parallelMultihandPainting(bool defaultValue = false) const;
+    void setParallelMultihandPainting(bool value);
+
     bool testingAcceptCompressedTabletEvents(bool defaultValue = false) const;
     void setTestingAcceptCompressedTabletEvents(bool value);
 
@@ -524,6 +596,14 @@ public:
     bool trimKra(bool defaultValue = false) const;
     void setTrimKra(bool trim);
 
+    /**
+     * Store the pixel data of .kra files uncompressed, both in the tiles
+     * and in the zip, which makes saving much faster for the price of
+     * a bigger file
+     */
+    bool fastSaveKra(bool defaultValue = false) const;
+    void setFastSaveKra(bool fastSave);
+
     bool toolOptionsInDocker(bool defaultValue = false) const;
     void setToolOptionsInDocker(bool inDocker);
 
@@ -261,7 +261,7 @@ void KisFilterManager::showFilterDialog(const QString &filterId, KisFilterConfig
     }
 }
 
-void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
+void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig, bool progressivePreview)
 {
     KisFilterConfigurationSP filterConfig = _filterConfig->cloneWithResourcesSnapshot();
 
@@ -302,10 +302,49 @@ void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
     QRect processRect = filter->changedRect(applyRect, filterConfig.data(), 0);
     processRect &= image->bounds();
 
+    QVector<QRect> rects;
+
     if (filter->supportsThreading()) {
         QSize size = KritaUtils::optimalPatchSize();
-        QVector<QRect> rects = KritaUtils::splitRectIntoPatches(processRect, size);
+        rects = KritaUtils::splitRectIntoPatches(processRect, size);
+    } else {
+        rects << processRect;
+    }
+
+    /**
+     * The small areas are filtered fast enough, the passes at reduced
+     * resolution would only waste time there. The previews are
+     * replaced by the full resolution result after all.
+     */
+    const int minPreviewArea = 1024 * 1024;
+
+    if (progressivePreview &&
+        processRect.width() * processRect.height() >= minPreviewArea) {
+
+        const QVector<int> previewLevels = {2, 1};
+        bool hasPreviewPasses = false;
 
+        Q_FOREACH (int levelOfDetail, previewLevels) {
+            if (!filter->supportsLevelOfDetail(filterConfig.data(), levelOfDetail)) continue;
+
+            image->addJob(d->currentStrokeId,
+                          new KisFilterStrokeStrategy::PreviewPassMarker());
+
+            Q_FOREACH (const QRect &rc, rects) {
+                image->addJob(d->currentStrokeId,
+                              new KisFilterStrokeStrategy::PreviewData(rc, levelOfDetail));
+            }
+
+            hasPreviewPasses = true;
+        }
+
+        if (hasPreviewPasses) {
+            image->addJob(d->currentStrokeId,
+                          new KisFilterStrokeStrategy::PreviewPassMarker());
+        }
+    }
+
+    if (filter->supportsThreading()) {
         Q_FOREACH (const QRect &rc, rects) {
             image->addJob(d->currentStrokeId,
                           new KisFilterStrokeStrategy::Data(rc, true));
@@ -34,7 +34,12 @@ public:
     void setup(KActionCollection * ac, KisActionManager *actionManager);
     void updateGUI();
 
-    void apply(KisFilterConfigurationSP filterConfig);
+    /**
+     * Starts applying the filter to the active node. With \p progressivePreview
+     * the result is shown at reduced resolutions first, which is useful
+     * for the previews of the slow filters.
+     */
+    void apply(KisFilterConfigurationSP filterConfig, bool progressivePreview = false);
     void finish();
     void cancel();
     bool isStrokeRunning() const;
@@ -102,6 +102,11 @@ QString KisFpsDecoration::getText() const
     if (KisOpenglCanvasDebugger::instance()->showFpsOnCanvas()) {
         const qreal value = KisOpenglCanvasDebugger::instance()->accumulatedFps();
         lines << QString("Canvas FPS: %1").arg(QString::number(value, 'f', 1));
+
+        const qreal latency = KisOpenglCanvasDebugger::instance()->averageFrameLatency();
+        if (latency > 0) {
+            lines << QString("Canvas update latency: %1 ms").arg(QString::number(latency, 'f', 1));
+        }
     }
 
     KisStrokeSpeedMonitor *monitor = KisStrokeSpeedMonitor::instance();
@@ -44,6 +44,7 @@
 #include "kis_config_notifier.h"
 #include "kis_signal_auto_connection.h"
 #include "kis_signal_compressor.h"
+#include "KisNodeThumbnailService.h"
 
 
 struct KisNodeModel::Private
@@ -74,6 +75,8 @@ struct KisNodeModel::Private
     QPointer<KisNodeDummy> parentOfRemovedNode = 0;
 
     QSet<quintptr> dropEnabled;
+
+    KisNodeThumbnailService thumbnailService;
 };
 
 KisNodeModel::KisNodeModel(QObject * parent)
@@ -81,6 +84,7 @@ KisNodeModel::KisNodeModel(QObject * parent)
         , m_d(new Private)
 {
     connect(&m_d->updateCompressor, SIGNAL(timeout()), SLOT(processUpdateQueue()));
+    connect(&m_d->thumbnailService, SIGNAL(sigThumbnailUpdated(KisNodeSP)), SLOT(slotThumbnailUpdated(KisNodeSP)));
 }
 
 KisNodeModel::~KisNodeModel()
@@ -285,6 +289,7 @@ void KisNodeModel::setDummiesFacade(KisDummiesFacadeBase *dummiesFacade,
     m_d->image = image;
     m_d->dummiesFacade = dummiesFacade;
     m_d->parentOfRemovedNode = 0;
+    m_d->thumbnailService.setImage(image);
     resetIndexConverter();
 
     if (m_d->dummiesFacade) {
@@ -358,6 +363,8 @@ void KisNodeModel::slotBeginRemoveDummy(KisNodeDummy *dummy)
 
     QModelIndex itemIndex = m_d->indexConverter->indexFromDummy(dummy);
 
+    m_d->thumbnailService.forgetNode(dummy->node());
+
     if (itemIndex.isValid()) {
         connectDummy(dummy, false);
         emit sigBeforeBeginRemoveRows(parentIndex, itemIndex.row(), itemIndex.row());
@@ -382,6 +389,16 @@ void KisNodeModel::slotDummyChanged(KisNodeDummy *dummy)
     m_d->updateCompressor.start();
 }
 
+void KisNodeModel::slotThumbnailUpdated(KisNodeSP node)
+{
+    if (!m_d->dummiesFacade) return;
+
+    QModelIndex index = indexFromNode(node);
+    if (index.isValid()) {
+        emit dataChanged(index, index);
+    }
+}
+
 void addChangedIndex(const QModelIndex &idx, QSet<QModelIndex> *indexes)
 {
     if (!idx.isValid() || indexes->contains(idx)) return;
@@ -507,7 +524,7 @@ QVariant KisNodeModel::data(const QModelIndex &index, int role) const
         if (role >= int(KisNodeModel::BeginThumbnailRole) && belongsToIsolatedGroup(node)) {
 
             const int maxSize = role - int(KisNodeModel::BeginThumbnailRole);
-            return node->createThumbnail(maxSize, maxSize, Qt::KeepAspectRatio);
+            return m_d->thumbnailService.thumbnail(node, maxSize);
         } else {
             return QVariant();
         }
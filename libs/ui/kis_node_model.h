@@ -147,6 +147,7 @@ protected Q_SLOTS:
     void slotBeginRemoveDummy(KisNodeDummy *dummy);
     void slotEndRemoveDummy();
     void slotDummyChanged(KisNodeDummy *dummy);
+    void slotThumbnailUpdated(KisNodeSP node);
 
     void slotIsolatedModeChanged();
 
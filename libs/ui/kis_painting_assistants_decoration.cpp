@@ -394,6 +394,12 @@ bool KisPaintingAssistantsDecoration::outlineVisibility()
 {
     return d->outlineVisible;
 }
+
+bool KisPaintingAssistantsDecoration::isCacheable() const
+{
+    // the preview is hidden while editing the assistants
+    return !d->outlineVisible || d->m_isEditingAssistants;
+}
 void KisPaintingAssistantsDecoration::uncache()
 {
     Q_FOREACH (KisPaintingAssistantSP assistant, assistants()) {
@@ -99,6 +99,9 @@ public:
     /// returns preview visibility
     bool outlineVisibility();
 
+    /// the assistants are cached unless their preview, which follows the cursor, is shown
+    bool isCacheable() const override;
+
     /// uncache all assistants
     void uncache();
 
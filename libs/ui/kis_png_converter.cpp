@@ -30,10 +30,13 @@
 #include <limits.h>
 #include <stdio.h>
 #include <zlib.h>
+#include <vector>
 
 #include <QBuffer>
 #include <QFile>
 #include <QApplication>
+#include <QtEndian>
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 #include <QUrl>
@@ -51,6 +54,7 @@
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <kis_iterator_ng.h>
+#include <KisConvertedBandReader.h>
 #include <kis_layer.h>
 #include <kis_paint_device.h>
 #include <kis_transaction.h>
@@ -330,6 +334,224 @@ private:
     quint8* m_buf;
 };
 
+/**
+ * The size of the chunks of the filtered image data which are deflated
+ * independently, the same as pigz uses. Every chunk is primed with the
+ * last 32 KiB of the data preceding it, so the compression ratio stays
+ * almost the same as the one of a single deflate stream.
+ */
+static const int deflateChunkSize = 128 * 1024;
+static const int deflateWindowSize = 32 * 1024;
+
+static inline int paethPredictor(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = qAbs(p - a);
+    const int pb = qAbs(p - b);
+    const int pc = qAbs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+template <int filter>
+static void applyFilter(const quint8 *row, const quint8 *prevRow, int rowBytes, int bpp, quint8 *dst)
+{
+    for (int i = 0; i < rowBytes; i++) {
+        const int a = i >= bpp ? row[i - bpp] : 0;
+        const int b = prevRow ? prevRow[i] : 0;
+        const int c = prevRow && i >= bpp ? prevRow[i - bpp] : 0;
+
+        int predictor = 0;
+        if (filter == PNG_FILTER_VALUE_SUB) {
+            predictor = a;
+        } else if (filter == PNG_FILTER_VALUE_UP) {
+            predictor = b;
+        } else if (filter == PNG_FILTER_VALUE_AVG) {
+            predictor = (a + b) >> 1;
+        } else if (filter == PNG_FILTER_VALUE_PAETH) {
+            predictor = paethPredictor(a, b, c);
+        }
+
+        dst[i] = quint8(row[i] - predictor);
+    }
+}
+
+static quint64 filteredRowCost(const quint8 *row, int rowBytes)
+{
+    quint64 cost = 0;
+    for (int i = 0; i < rowBytes; i++) {
+        cost += row[i] < 128 ? row[i] : 256 - row[i];
+    }
+    return cost;
+}
+
+/**
+ * Writes the filter type and the filtered bytes of \p row into \p dst.
+ * When \p adaptive is set, the filter with the minimum sum of absolute
+ * differences is chosen, the same heuristic libpng uses.
+ */
+static void filterRow(const quint8 *row, const quint8 *prevRow, int rowBytes, int bpp, bool adaptive, quint8 *dst, QVector<quint8> &scratch)
+{
+    dst[0] = PNG_FILTER_VALUE_NONE;
+    memcpy(dst + 1, row, rowBytes);
+
+    if (!adaptive) return;
+
+    scratch.resize(rowBytes);
+    quint64 bestCost = filteredRowCost(dst + 1, rowBytes);
+
+    for (int filter = PNG_FILTER_VALUE_SUB; filter <= PNG_FILTER_VALUE_PAETH; filter++) {
+        switch (filter) {
+        case PNG_FILTER_VALUE_SUB:
+            applyFilter<PNG_FILTER_VALUE_SUB>(row, prevRow, rowBytes, bpp, scratch.data());
+            break;
+        case PNG_FILTER_VALUE_UP:
+            applyFilter<PNG_FILTER_VALUE_UP>(row, prevRow, rowBytes, bpp, scratch.data());
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            applyFilter<PNG_FILTER_VALUE_AVG>(row, prevRow, rowBytes, bpp, scratch.data());
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            applyFilter<PNG_FILTER_VALUE_PAETH>(row, prevRow, rowBytes, bpp, scratch.data());
+            break;
+        }
+
+        const quint64 cost = filteredRowCost(scratch.constData(), rowBytes);
+        if (cost < bestCost) {
+            bestCost = cost;
+            dst[0] = filter;
+            memcpy(dst + 1, scratch.constData(), rowBytes);
+        }
+    }
+}
+
+struct DeflateChunkJob {
+    const quint8 *data = 0;
+    int size = 0;
+    int dictionarySize = 0;
+    bool isLast = false;
+
+    QByteArray result;
+    uLong adler = 0;
+    bool ok = false;
+};
+
+/**
+ * Deflates the chunk into a raw deflate stream, which can be concatenated
+ * with the streams of the other chunks. All the chunks except the last
+ * one end with a sync flush, so they finish on a byte boundary.
+ */
+static void deflateChunk(DeflateChunkJob &job, int level, int strategy)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) != Z_OK) {
+        return;
+    }
+
+    if (job.dictionarySize > 0) {
+        deflateSetDictionary(&stream, job.data - job.dictionarySize, job.dictionarySize);
+    }
+
+    job.result.resize(int(deflateBound(&stream, job.size)) + 16);
+
+    stream.next_in = const_cast<Bytef*>(job.data);
+    stream.avail_in = job.size;
+    stream.next_out = reinterpret_cast<Bytef*>(job.result.data());
+    stream.avail_out = job.result.size();
+
+    const int flush = job.isLast ? Z_FINISH : Z_SYNC_FLUSH;
+    bool done = false;
+
+    while (!done) {
+        if (stream.avail_out == 0) {
+            const int written = job.result.size();
+            job.result.resize(2 * written);
+            stream.next_out = reinterpret_cast<Bytef*>(job.result.data()) + written;
+            stream.avail_out = job.result.size() - written;
+        }
+
+        const int ret = deflate(&stream, flush);
+        if (ret == Z_STREAM_ERROR) {
+            break;
+        }
+
+        done = job.isLast ? ret == Z_STREAM_END : stream.avail_out > 0;
+    }
+
+    job.result.resize(job.result.size() - stream.avail_out);
+    job.ok = done;
+    deflateEnd(&stream);
+
+    job.adler = adler32(adler32(0L, Z_NULL, 0), job.data, job.size);
+}
+
+/**
+ * Filters the rows of the image and writes them as IDAT chunks, deflating
+ * chunks of the filtered data in parallel, the same way pigz does.
+ *
+ * @return false if the data could not be compressed
+ */
+static bool writeImageDataInParallel(png_structp png_ptr, png_byte **rows, int numRows, int rowBytes, int bpp, bool adaptiveFiltering, int level, int strategy)
+{
+    const size_t filteredRowBytes = rowBytes + 1;
+    std::vector<quint8> filteredData(filteredRowBytes * numRows);
+
+    QVector<int> rowStripes;
+    for (int row = 0; row < numRows; row += 64) {
+        rowStripes << row;
+    }
+
+    QtConcurrent::blockingMap(rowStripes,
+        [&] (int firstRow) {
+            QVector<quint8> scratch;
+            for (int row = firstRow; row < qMin(firstRow + 64, numRows); row++) {
+                filterRow(rows[row], row > 0 ? rows[row - 1] : 0, rowBytes, bpp,
+                          adaptiveFiltering, filteredData.data() + row * filteredRowBytes, scratch);
+            }
+        });
+
+    QVector<DeflateChunkJob> jobs;
+    for (size_t offset = 0; offset < filteredData.size(); offset += deflateChunkSize) {
+        DeflateChunkJob job;
+        job.data = filteredData.data() + offset;
+        job.size = int(qMin(size_t(deflateChunkSize), filteredData.size() - offset));
+        job.dictionarySize = int(qMin(size_t(deflateWindowSize), offset));
+        job.isLast = offset + job.size == filteredData.size();
+        jobs << job;
+    }
+
+    QtConcurrent::blockingMap(jobs,
+        [level, strategy] (DeflateChunkJob &job) {
+            deflateChunk(job, level, strategy);
+        });
+
+    // the zlib header for a 32 KiB window, with the level hint zlib itself would use
+    const quint8 cmf = 0x78;
+    const int levelHint = (strategy == Z_RLE || level < 2) ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    quint8 flg = levelHint << 6;
+    flg += (31 - (cmf * 256 + flg) % 31) % 31;
+
+    QByteArray header;
+    header.append(char(cmf));
+    header.append(char(flg));
+    png_write_chunk(png_ptr, (png_const_bytep)"IDAT", (png_const_bytep)header.constData(), header.size());
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+
+    Q_FOREACH (const DeflateChunkJob &job, jobs) {
+        if (!job.ok) return false;
+
+        png_write_chunk(png_ptr, (png_const_bytep)"IDAT", (png_const_bytep)job.result.constData(), job.result.size());
+        adler = adler32_combine(adler, job.adler, job.size);
+    }
+
+    const quint32 checksum = qToBigEndian(quint32(adler));
+    png_write_chunk(png_ptr, (png_const_bytep)"IDAT", (png_const_bytep)&checksum, sizeof(checksum));
+
+    return true;
+}
+
 class KisPNGReaderAbstract
 {
 public:
@@ -919,14 +1141,15 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(device, ImportExportCodes::InternalError);
 
+    /**
+     * The pixels are flattened and converted into the color space of
+     * the file row by row while writing, instead of making a flattened
+     * or converted copy of the whole device
+     */
+    KisConvertedBandReader reader(device);
+
     if (!options.alpha) {
-        KisPaintDeviceSP tmp = new KisPaintDevice(device->colorSpace());
-        KoColor c(options.transparencyFillColor, device->colorSpace());
-        tmp->fill(imageRect, c);
-        KisPainter gc(tmp);
-        gc.bitBlt(imageRect.topLeft(), device, imageRect);
-        gc.end();
-        device = tmp;
+        reader.setBackgroundColor(KoColor(options.transparencyFillColor, device->colorSpace()));
     }
 
     if (device->colorSpace()->colorDepthId() == Float16BitsColorDepthID
@@ -948,12 +1171,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
                         KoColorSpaceRegistry::instance()->p2020PQProfile());
         }
 
-        KisPaintDeviceSP tmp = new KisPaintDevice(device->colorSpace());
-        tmp->makeCloneFromRough(device, imageRect);
-        tmp->convertTo(dstCS);
-
-        device = tmp;
-
+        reader.setColorSpace(dstCS);
     }
 
     KIS_SAFE_ASSERT_RECOVER(!options.saveAsHDR || !options.forceSRGB) {
@@ -965,12 +1183,13 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     }
 
     QStringList colormodels = QStringList() << RGBAColorModelID.id() << GrayAColorModelID.id();
-    if (options.forceSRGB || !colormodels.contains(device->colorSpace()->colorModelId().id())) {
-        const KoColorSpace* cs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), device->colorSpace()->colorDepthId().id(), "sRGB built-in - (lcms internal)");
-        device = new KisPaintDevice(*device);
-        device->convertTo(cs);
+    if (options.forceSRGB || !colormodels.contains(reader.colorSpace()->colorModelId().id())) {
+        const KoColorSpace* cs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), reader.colorSpace()->colorDepthId().id(), "sRGB built-in - (lcms internal)");
+        reader.setColorSpace(cs);
     }
 
+    const KoColorSpace *colorSpace = reader.colorSpace();
+
     // Initialize structures
     png_structp png_ptr =  png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
     if (!png_ptr) {
@@ -1015,45 +1234,50 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
 
     /* set other zlib parameters */
     png_set_compression_mem_level(png_ptr, 8);
-    png_set_compression_strategy(png_ptr, Z_DEFAULT_STRATEGY);
+    const int strategy = options.compressionStrategy == KisPNGOptions::RleStrategy ? Z_RLE : Z_DEFAULT_STRATEGY;
+    png_set_compression_strategy(png_ptr, strategy);
     png_set_compression_window_bits(png_ptr, 15);
     png_set_compression_method(png_ptr, 8);
     png_set_compression_buffer_size(png_ptr, 8192);
 
-    int color_nb_bits = 8 * device->pixelSize() / device->channelCount();
-    int color_type = getColorTypeforColorSpace(device->colorSpace(), options.alpha);
+    int color_nb_bits = 8 * colorSpace->pixelSize() / colorSpace->channelCount();
+    int color_type = getColorTypeforColorSpace(colorSpace, options.alpha);
 
     Q_ASSERT(color_type > -1);
 
     // Try to compute a table of color if the colorspace is RGB8f
     QScopedArrayPointer<png_color> palette;
     int num_palette = 0;
-    if (!options.alpha && options.tryToSaveAsIndexed && KoID(device->colorSpace()->id()) == KoID("RGBA")) { // png doesn't handle indexed images and alpha, and only have indexed for RGB8
+    if (!options.alpha && options.tryToSaveAsIndexed && KoID(colorSpace->id()) == KoID("RGBA")) { // png doesn't handle indexed images and alpha, and only have indexed for RGB8
         palette.reset(new png_color[255]);
 
-        KisSequentialIterator it(device, imageRect);
+        QVector<quint8> row(imageRect.width() * colorSpace->pixelSize());
 
         bool toomuchcolor = false;
-        while (it.nextPixel()) {
-            const quint8* c = it.oldRawData();
-            bool findit = false;
-            for (int i = 0; i < num_palette; i++) {
-                if (palette[i].red == c[2] &&
-                        palette[i].green == c[1] &&
-                        palette[i].blue == c[0]) {
-                    findit = true;
-                    break;
+        for (int y = imageRect.y(); y <= imageRect.bottom() && !toomuchcolor; y++) {
+            reader.readBytes(row.data(), QRect(imageRect.x(), y, imageRect.width(), 1));
+
+            for (int x = 0; x < imageRect.width(); x++) {
+                const quint8* c = row.constData() + x * colorSpace->pixelSize();
+                bool findit = false;
+                for (int i = 0; i < num_palette; i++) {
+                    if (palette[i].red == c[2] &&
+                            palette[i].green == c[1] &&
+                            palette[i].blue == c[0]) {
+                        findit = true;
+                        break;
+                    }
                 }
-            }
-            if (!findit) {
-                if (num_palette == 255) {
-                    toomuchcolor = true;
-                    break;
+                if (!findit) {
+                    if (num_palette == 255) {
+                        toomuchcolor = true;
+                        break;
+                    }
+                    palette[num_palette].red = c[2];
+                    palette[num_palette].green = c[1];
+                    palette[num_palette].blue = c[0];
+                    num_palette++;
                 }
-                palette[num_palette].red = c[2];
-                palette[num_palette].green = c[1];
-                palette[num_palette].blue = c[0];
-                num_palette++;
             }
         }
 
@@ -1087,7 +1311,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
 
     // set sRGB only if the profile is sRGB  -- http://www.w3.org/TR/PNG/#11sRGB says sRGB and iCCP should not both be present
 
-    const bool sRGB = *device->colorSpace()->profile() == *KoColorSpaceRegistry::instance()->p709SRGBProfile();
+    const bool sRGB = *colorSpace->profile() == *KoColorSpaceRegistry::instance()->p709SRGBProfile();
     /*
      * This automatically writes the correct gamma and chroma chunks along with the sRGB chunk, but firefox's
      * color management is bugged, so once you give it any incentive to start color managing an sRGB image it
@@ -1170,7 +1394,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     }
 
     // Save the color profile
-    const KoColorProfile* colorProfile = device->colorSpace()->profile();
+    const KoColorProfile* colorProfile = colorSpace->profile();
     QByteArray colorProfileData = colorProfile->rawData();
     if (!sRGB || options.saveSRGBProfile) {
 
@@ -1281,9 +1505,17 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     png_write_info(png_ptr, info_ptr);
     png_write_flush(png_ptr);
 
+    /**
+     * Non-interlaced images are filtered and compressed by us in
+     * parallel, libpng only writes the other chunks. The interlaced
+     * ones are left to libpng, since the passes of Adam7 are filtered
+     * separately.
+     */
+    const bool writeImageDataDirectly = !options.interlace;
+
     // swap byteorder on little endian machines.
 #ifndef WORDS_BIGENDIAN
-    if (color_nb_bits > 8)
+    if (color_nb_bits > 8 && !writeImageDataDirectly)
         png_set_swap(png_ptr);
 #endif
 
@@ -1313,80 +1545,131 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     };
 
 
+    switch (color_type) {
+    case PNG_COLOR_TYPE_GRAY:
+    case PNG_COLOR_TYPE_GRAY_ALPHA:
+    case PNG_COLOR_TYPE_RGB:
+    case PNG_COLOR_TYPE_RGB_ALPHA:
+    case PNG_COLOR_TYPE_PALETTE:
+        break;
+    default:
+        return ImportExportCodes::FormatColorSpaceUnsupported;
+    }
+
     // Fill the data structure
-    RowPointersStruct rowPointers(imageRect.size(), device->pixelSize());
+    RowPointersStruct rowPointers(imageRect.size(), colorSpace->pixelSize());
 
-    int row = 0;
-    for (int y = imageRect.y(); y < imageRect.y() + imageRect.height(); y++, row++) {
-        KisHLineConstIteratorSP it = device->createHLineConstIteratorNG(imageRect.x(), y, imageRect.width());
+    // the bytes of the rows are swapped by libpng, unless we write them ourselves
+    const bool storeBigEndian = color_nb_bits == 16 && writeImageDataDirectly;
 
-        switch (color_type) {
-        case PNG_COLOR_TYPE_GRAY:
-        case PNG_COLOR_TYPE_GRAY_ALPHA:
-            if (color_nb_bits == 16) {
-                quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
-                do {
-                    const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                    *(dst++) = d[0];
-                    if (options.alpha) *(dst++) = d[1];
-                } while (it->nextPixel());
-            } else {
-                quint8 *dst = rowPointers.rows[row];
-                do {
-                    const quint8 *d = it->oldRawData();
-                    *(dst++) = d[0];
-                    if (options.alpha) *(dst++) = d[1];
-                } while (it->nextPixel());
-            }
-            break;
-        case PNG_COLOR_TYPE_RGB:
-        case PNG_COLOR_TYPE_RGB_ALPHA:
-            if (color_nb_bits == 16) {
-                quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
-                do {
-                    const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                    *(dst++) = d[2];
-                    *(dst++) = d[1];
-                    *(dst++) = d[0];
-                    if (options.alpha) *(dst++) = d[3];
-                } while (it->nextPixel());
-            } else {
-                quint8 *dst = rowPointers.rows[row];
-                do {
-                    const quint8 *d = it->oldRawData();
-                    *(dst++) = d[2];
-                    *(dst++) = d[1];
-                    *(dst++) = d[0];
-                    if (options.alpha) *(dst++) = d[3];
-                } while (it->nextPixel());
-            }
-            break;
-        case PNG_COLOR_TYPE_PALETTE: {
-            quint8 *dst = rowPointers.rows[row];
-            KisPNGWriteStream writestream(dst, color_nb_bits);
-            do {
-                const quint8 *d = it->oldRawData();
-                int i;
-                for (i = 0; i < num_palette; i++) {
-                    if (palette[i].red == d[2] &&
-                            palette[i].green == d[1] &&
-                            palette[i].blue == d[0]) {
-                        break;
+    QVector<QRect> stripes;
+    for (int y = imageRect.y(); y < imageRect.y() + imageRect.height(); y += 64) {
+        stripes << QRect(imageRect.x(), y, imageRect.width(), qMin(64, imageRect.y() + imageRect.height() - y));
+    }
+
+    /**
+     * The rows are converted in parallel. Every row is read at once into
+     * a buffer, so that the conversion is a plain loop the compiler
+     * can vectorize.
+     */
+    QtConcurrent::blockingMap(stripes,
+        [&] (const QRect &stripe) {
+            const int pixelSize = colorSpace->pixelSize();
+            const int width = stripe.width();
+            QVector<quint8> buffer(width * pixelSize);
+
+            for (int y = stripe.y(); y < stripe.y() + stripe.height(); y++) {
+                const int row = y - imageRect.y();
+                reader.readBytes(buffer.data(), QRect(stripe.x(), y, width, 1));
+
+                switch (color_type) {
+                case PNG_COLOR_TYPE_GRAY:
+                case PNG_COLOR_TYPE_GRAY_ALPHA:
+                    if (color_nb_bits == 16) {
+                        const quint16 *d = reinterpret_cast<const quint16 *>(buffer.constData());
+                        quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
+                        for (int x = 0; x < width; x++, d += 2) {
+                            *(dst++) = storeBigEndian ? qToBigEndian(d[0]) : d[0];
+                            if (options.alpha) *(dst++) = storeBigEndian ? qToBigEndian(d[1]) : d[1];
+                        }
+                    } else {
+                        const quint8 *d = buffer.constData();
+                        quint8 *dst = rowPointers.rows[row];
+                        for (int x = 0; x < width; x++, d += 2) {
+                            *(dst++) = d[0];
+                            if (options.alpha) *(dst++) = d[1];
+                        }
+                    }
+                    break;
+                case PNG_COLOR_TYPE_RGB:
+                case PNG_COLOR_TYPE_RGB_ALPHA:
+                    if (color_nb_bits == 16) {
+                        const quint16 *d = reinterpret_cast<const quint16 *>(buffer.constData());
+                        quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
+                        for (int x = 0; x < width; x++, d += 4) {
+                            *(dst++) = storeBigEndian ? qToBigEndian(d[2]) : d[2];
+                            *(dst++) = storeBigEndian ? qToBigEndian(d[1]) : d[1];
+                            *(dst++) = storeBigEndian ? qToBigEndian(d[0]) : d[0];
+                            if (options.alpha) *(dst++) = storeBigEndian ? qToBigEndian(d[3]) : d[3];
+                        }
+                    } else {
+                        const quint8 *d = buffer.constData();
+                        quint8 *dst = rowPointers.rows[row];
+                        for (int x = 0; x < width; x++, d += 4) {
+                            *(dst++) = d[2];
+                            *(dst++) = d[1];
+                            *(dst++) = d[0];
+                            if (options.alpha) *(dst++) = d[3];
+                        }
+                    }
+                    break;
+                case PNG_COLOR_TYPE_PALETTE: {
+                    quint8 *dst = rowPointers.rows[row];
+                    KisPNGWriteStream writestream(dst, color_nb_bits);
+                    const quint8 *d = buffer.constData();
+                    for (int x = 0; x < width; x++, d += 4) {
+                        int i;
+                        for (i = 0; i < num_palette; i++) {
+                            if (palette[i].red == d[2] &&
+                                    palette[i].green == d[1] &&
+                                    palette[i].blue == d[0]) {
+                                break;
+                            }
+                        }
+                        writestream.setNextValue(i);
                     }
                 }
-                writestream.setNextValue(i);
-            } while (it->nextPixel());
-        }
-            break;
-        default:
-            return ImportExportCodes::FormatColorSpaceUnsupported;
+                    break;
+                }
+            }
+        });
+
+    if (writeImageDataDirectly) {
+        const int bitsPerPixel = color_nb_bits * png_get_channels(png_ptr, info_ptr);
+        const int rowBytes = (imageRect.width() * bitsPerPixel + 7) / 8;
+
+        // libpng doesn't filter the palette images and the ones with less than 8 bits per channel
+        const bool adaptiveFiltering = color_type != PNG_COLOR_TYPE_PALETTE && color_nb_bits >= 8;
+
+        if (!writeImageDataInParallel(png_ptr, rowPointers.rows, rowPointers.numRows, rowBytes,
+                                      qMax(1, bitsPerPixel / 8), adaptiveFiltering,
+                                      options.compression, strategy)) {
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+            return ImportExportCodes::Failure;
         }
-    }
 
-    png_write_image(png_ptr, rowPointers.rows);
+        /**
+         * All the other chunks have been written by png_write_info(), and
+         * png_write_end() refuses to finish a file whose IDAT chunks have
+         * not been written by libpng itself
+         */
+        png_write_chunk(png_ptr, (png_const_bytep)"IEND", 0, 0);
+    } else {
+        png_write_image(png_ptr, rowPointers.rows);
 
-    // Writing is over
-    png_write_end(png_ptr, info_ptr);
+        // Writing is over
+        png_write_end(png_ptr, info_ptr);
+    }
 
     // Free memory
     png_destroy_write_struct(&png_ptr, &info_ptr);
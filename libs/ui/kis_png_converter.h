@@ -40,8 +40,14 @@ class Store;
 }
 
 struct KisPNGOptions {
+    enum CompressionStrategy {
+        DefaultStrategy, ///< zlib's default strategy
+        RleStrategy ///< run-length encoding only, much faster, but the files are bigger
+    };
+
     KisPNGOptions()
         : compression(0)
+        , compressionStrategy(DefaultStrategy)
         , interlace(false)
         , alpha(true)
         , exif(true)
@@ -57,6 +63,7 @@ struct KisPNGOptions {
     {}
 
     int compression;
+    CompressionStrategy compressionStrategy;
     bool interlace;
     bool alpha;
     bool exif;
@@ -12,6 +12,10 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QUrl>
+#include <QFutureWatcher>
+#include <QDateTime>
+#include <QSet>
+#include <QtConcurrent>
 
 #include <KoStore.h>
 
@@ -142,6 +146,138 @@ private:
 
 Q_GLOBAL_STATIC(FileSystemWatcherWrapper, s_fileSystemWatcher)
 
+/**
+ * Keeps the last loaded content of every file linked by the loaders, so
+ * that the file layers linking the same file share a single copy of it,
+ * which is loaded only once when the file changes. The paint devices are
+ * never modified, the layers make copy-on-write clones of them.
+ */
+class SharedLoadingResults : public QObject
+{
+    Q_OBJECT
+public:
+    struct Result {
+        qint64 fileSize = 0;
+        QDateTime fileTimeStamp;
+        KisPaintDeviceSP paintDevice;
+        qreal xRes = 1.0;
+        qreal yRes = 1.0;
+        QSize size;
+    };
+
+    void addUser(const QString &path) {
+        m_userCount[FileSystemWatcherWrapper::unifyFilePath(path)]++;
+    }
+
+    void removeUser(const QString &path) {
+        const QString upath = FileSystemWatcherWrapper::unifyFilePath(path);
+
+        if (--m_userCount[upath] <= 0) {
+            m_userCount.remove(upath);
+            m_results.remove(upath);
+        }
+    }
+
+    bool fetch(const QString &path, qint64 fileSize, const QDateTime &fileTimeStamp, Result *result) const {
+        auto it = m_results.constFind(FileSystemWatcherWrapper::unifyFilePath(path));
+
+        if (it == m_results.constEnd() ||
+            it->fileSize != fileSize ||
+            it->fileTimeStamp != fileTimeStamp) {
+
+            return false;
+        }
+
+        *result = *it;
+        return true;
+    }
+
+    /**
+     * @return false if another loader is already loading the file
+     */
+    bool startLoading(const QString &path) {
+        const QString upath = FileSystemWatcherWrapper::unifyFilePath(path);
+        if (m_pendingLoads.contains(upath)) return false;
+
+        m_pendingLoads.insert(upath);
+        return true;
+    }
+
+    void finishLoading(const QString &path, const Result *result) {
+        const QString upath = FileSystemWatcherWrapper::unifyFilePath(path);
+
+        if (result && m_userCount.contains(upath)) {
+            m_results.insert(upath, *result);
+        }
+
+        m_pendingLoads.remove(upath);
+        emit sigLoadingFinished(upath);
+    }
+
+Q_SIGNALS:
+    void sigLoadingFinished(const QString &path);
+
+private:
+    QHash<QString, Result> m_results;
+    QHash<QString, int> m_userCount;
+    QSet<QString> m_pendingLoads;
+};
+
+Q_GLOBAL_STATIC(SharedLoadingResults, s_sharedLoadingResults)
+
+namespace {
+
+struct MergedImage {
+    KisPaintDeviceSP paintDevice;
+    QSize size;
+};
+
+bool hasMergedImage(const QString &path)
+{
+    return path.toLower().endsWith("ora") || path.toLower().endsWith("kra");
+}
+
+/**
+ * Makes the temporary copy of the file and decodes the merged image of
+ * .kra and .ora files. Doesn't touch any GUI objects, so it is run on a
+ * worker thread, the network drives and the big PNG images do not block
+ * the GUI anymore.
+ */
+MergedImage copyAndLoadMergedImage(const QString &path, const QString &temporaryPath)
+{
+    MergedImage result;
+
+    QFile::copy(path, temporaryPath);
+
+    if (!hasMergedImage(path)) {
+        return result;
+    }
+
+    QScopedPointer<KoStore> store(KoStore::createStore(temporaryPath, KoStore::Read));
+    if (store && !store->bad()) {
+        if (store->open(QString("mergedimage.png"))) {
+            QByteArray bytes = store->read(store->size());
+            store->close();
+            QImage mergedImage;
+            mergedImage.loadFromData(bytes);
+            Q_ASSERT(!mergedImage.isNull());
+            result.paintDevice = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+            result.paintDevice->convertFromQImage(mergedImage, 0);
+            result.size = mergedImage.size();
+        }
+        else {
+            qWarning() << "copyAndLoadMergedImage: Could not open mergedimage.png";
+        }
+    }
+    else {
+        qWarning() << "copyAndLoadMergedImage: Store was bad";
+    }
+
+    return result;
+}
+
+}
+
 
 struct KisSafeDocumentLoader::Private
 {
@@ -152,8 +288,12 @@ struct KisSafeDocumentLoader::Private
 
     QScopedPointer<KisDocument> doc;
     KisSignalCompressor fileChangedSignalCompressor;
+    QFutureWatcher<MergedImage> copyWatcher;
+    MergedImage mergedImage;
     bool isLoading = false;
     bool fileChangedFlag = false;
+    bool ownsSharedLoading = false;
+    bool waitsForSharedLoading = false;
     QString path;
     QString temporaryPath;
 
@@ -171,13 +311,29 @@ KisSafeDocumentLoader::KisSafeDocumentLoader(const QString &path, QObject *paren
     connect(&m_d->fileChangedSignalCompressor, SIGNAL(timeout()),
             SLOT(fileChangedCompressed()));
 
+    connect(&m_d->copyWatcher, SIGNAL(finished()),
+            SLOT(copyFinished()));
+
+    connect(s_sharedLoadingResults, SIGNAL(sigLoadingFinished(QString)),
+            SLOT(sharedLoadingFinished(QString)));
+
     setPath(path);
 }
 
 KisSafeDocumentLoader::~KisSafeDocumentLoader()
 {
+    if (m_d->copyWatcher.isRunning()) {
+        m_d->copyWatcher.waitForFinished();
+        QFile::remove(m_d->temporaryPath);
+    }
+
     if (!m_d->path.isEmpty()) {
+        if (m_d->ownsSharedLoading) {
+            s_sharedLoadingResults->finishLoading(m_d->path, 0);
+        }
+
         s_fileSystemWatcher->removePath(m_d->path);
+        s_sharedLoadingResults->removeUser(m_d->path);
     }
 
     delete m_d;
@@ -189,10 +345,12 @@ void KisSafeDocumentLoader::setPath(const QString &path)
 
     if (!m_d->path.isEmpty()) {
         s_fileSystemWatcher->removePath(m_d->path);
+        s_sharedLoadingResults->removeUser(m_d->path);
     }
 
     m_d->path = path;
     s_fileSystemWatcher->addPath(m_d->path);
+    s_sharedLoadingResults->addUser(m_d->path);
 }
 
 void KisSafeDocumentLoader::reloadImage()
@@ -220,6 +378,21 @@ void KisSafeDocumentLoader::fileChangedCompressed(bool sync)
     // so other application
     if (!m_d->initialFileSize) return;
 
+    // another layer linking the same file may have loaded it already
+    SharedLoadingResults::Result result;
+    if (s_sharedLoadingResults->fetch(m_d->path, m_d->initialFileSize, m_d->initialFileTimeStamp, &result)) {
+        m_d->fileChangedFlag = false;
+        emit loadingFinished(result.paintDevice, result.xRes, result.yRes, result.size);
+        return;
+    }
+
+    // ... or be loading it right now, then wait for its result
+    m_d->ownsSharedLoading = s_sharedLoadingResults->startLoading(m_d->path);
+    if (!m_d->ownsSharedLoading && !sync) {
+        m_d->waitsForSharedLoading = true;
+        return;
+    }
+
     m_d->isLoading = true;
     m_d->fileChangedFlag = false;
 
@@ -230,17 +403,30 @@ void KisSafeDocumentLoader::fileChangedCompressed(bool sync)
             .arg(qrand())
             .arg(initialFileInfo.suffix());
 
-    QFile::copy(m_d->path, m_d->temporaryPath);
-
-
     if (!sync) {
-        QTimer::singleShot(100, this, SLOT(delayedLoadStart()));
+        m_d->copyWatcher.setFuture(
+            QtConcurrent::run(&copyAndLoadMergedImage, m_d->path, m_d->temporaryPath));
     } else {
+        m_d->mergedImage = copyAndLoadMergedImage(m_d->path, m_d->temporaryPath);
         QApplication::processEvents();
         delayedLoadStart();
     }
 }
 
+void KisSafeDocumentLoader::copyFinished()
+{
+    m_d->mergedImage = m_d->copyWatcher.result();
+    QTimer::singleShot(100, this, SLOT(delayedLoadStart()));
+}
+
+void KisSafeDocumentLoader::sharedLoadingFinished(const QString &path)
+{
+    if (m_d->waitsForSharedLoading && FileSystemWatcherWrapper::unifyFilePath(m_d->path) == path) {
+        m_d->waitsForSharedLoading = false;
+        fileChangedCompressed();
+    }
+}
+
 void KisSafeDocumentLoader::delayedLoadStart()
 {
     QFileInfo originalInfo(m_d->path);
@@ -252,34 +438,11 @@ void KisSafeDocumentLoader::delayedLoadStart()
             originalInfo.lastModified() == m_d->initialFileTimeStamp &&
             tempInfo.size() == m_d->initialFileSize) {
 
-        m_d->doc.reset(KisPart::instance()->createDocument());
-
-        if (m_d->path.toLower().endsWith("ora") || m_d->path.toLower().endsWith("kra")) {
-            QScopedPointer<KoStore> store(KoStore::createStore(m_d->temporaryPath, KoStore::Read));
-            if (store && !store->bad()) {
-                if (store->open(QString("mergedimage.png"))) {
-                    QByteArray bytes = store->read(store->size());
-                    store->close();
-                    QImage mergedImage;
-                    mergedImage.loadFromData(bytes);
-                    Q_ASSERT(!mergedImage.isNull());
-                    KisImageSP image = new KisImage(0, mergedImage.width(), mergedImage.height(), KoColorSpaceRegistry::instance()->rgb8(), "");
-                    KisPaintLayerSP layer = new KisPaintLayer(image, "", OPACITY_OPAQUE_U8);
-                    layer->paintDevice()->convertFromQImage(mergedImage, 0);
-                    image->addNode(layer, image->rootLayer());
-                    image->initialRefreshGraph();
-                    m_d->doc->setCurrentImage(image);
-                    successfullyLoaded = true;
-                }
-                else {
-                    qWarning() << "delayedLoadStart: Could not open mergedimage.png";
-                }
-            }
-            else {
-                qWarning() << "delayedLoadStart: Store was bad";
-            }
+        if (hasMergedImage(m_d->path)) {
+            successfullyLoaded = !m_d->mergedImage.paintDevice.isNull();
         }
         else {
+            m_d->doc.reset(KisPart::instance()->createDocument());
             successfullyLoaded = m_d->doc->openUrl(QUrl::fromLocalFile(m_d->temporaryPath),
                                                    KisDocument::DontAddToRecent);
         }
@@ -297,20 +460,42 @@ void KisSafeDocumentLoader::delayedLoadStart()
     m_d->isLoading = false;
 
     if (!successfullyLoaded) {
+        if (m_d->ownsSharedLoading) {
+            s_sharedLoadingResults->finishLoading(m_d->path, 0);
+            m_d->ownsSharedLoading = false;
+        }
+
         // Restart the attempt
         m_d->fileChangedSignalCompressor.start();
     }
     else {
-        KisPaintDeviceSP paintDevice = new KisPaintDevice(m_d->doc->image()->colorSpace());
-        KisPaintDeviceSP projection = m_d->doc->image()->projection();
-        paintDevice->makeCloneFrom(projection, projection->extent());
-        emit loadingFinished(paintDevice,
-                             m_d->doc->image()->xRes(),
-                             m_d->doc->image()->yRes(),
-                             m_d->doc->image()->size());
+        SharedLoadingResults::Result result;
+        result.fileSize = m_d->initialFileSize;
+        result.fileTimeStamp = m_d->initialFileTimeStamp;
+
+        if (m_d->doc) {
+            result.paintDevice = new KisPaintDevice(m_d->doc->image()->colorSpace());
+            KisPaintDeviceSP projection = m_d->doc->image()->projection();
+            result.paintDevice->makeCloneFrom(projection, projection->extent());
+            result.xRes = m_d->doc->image()->xRes();
+            result.yRes = m_d->doc->image()->yRes();
+            result.size = m_d->doc->image()->size();
+        } else {
+            // the merged images are loaded without any resolution
+            result.paintDevice = m_d->mergedImage.paintDevice;
+            result.size = m_d->mergedImage.size;
+        }
+
+        if (m_d->ownsSharedLoading) {
+            s_sharedLoadingResults->finishLoading(m_d->path, &result);
+            m_d->ownsSharedLoading = false;
+        }
+
+        emit loadingFinished(result.paintDevice, result.xRes, result.yRes, result.size);
     }
 
     m_d->doc.reset();
+    m_d->mergedImage = MergedImage();
 }
 
 #include "kis_safe_document_loader.moc"
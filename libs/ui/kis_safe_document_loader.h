@@ -24,6 +24,8 @@ private:
 private Q_SLOTS:
     void fileChanged(QString);
     void fileChangedCompressed(bool sync = false);
+    void copyFinished();
+    void sharedLoadingFinished(const QString &path);
     void delayedLoadStart();
 
 Q_SIGNALS:
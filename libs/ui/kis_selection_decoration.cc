@@ -6,8 +6,10 @@
 
 #include "kis_selection_decoration.h"
 
+#include <QHash>
 #include <QPainter>
 #include <QVarLengthArray>
+#include <QtMath>
 
 #include <kis_debug.h>
 #include <klocalizedstring.h>
@@ -35,6 +37,7 @@
 static const unsigned int ANT_LENGTH = 4;
 static const unsigned int ANT_SPACE = 4;
 static const unsigned int ANT_ADVANCE_WIDTH = ANT_LENGTH + ANT_SPACE;
+static const int OUTLINE_CHUNK_SIZE = 512;
 
 KisSelectionDecoration::KisSelectionDecoration(QPointer<KisView>view)
     : KisCanvasDecoration("selection", view),
@@ -105,7 +108,7 @@ void KisSelectionDecoration::selectionChanged()
             m_signalCompressor.stop();
 
             if (m_mode == Ants) {
-                m_outlinePath = selection->outlineCache();
+                setOutlinePath(selection->outlineCache());
                 m_antsTimer->start();
             } else {
                 m_thumbnailImage = selection->thumbnailImage();
@@ -120,7 +123,7 @@ void KisSelectionDecoration::selectionChanged()
         }
     } else {
         m_signalCompressor.stop();
-        m_outlinePath = QPainterPath();
+        setOutlinePath(QPainterPath());
         m_thumbnailImage = QImage();
         m_thumbnailImageTransform = QTransform();
         view()->canvasBase()->updateCanvas();
@@ -128,6 +131,60 @@ void KisSelectionDecoration::selectionChanged()
     }
 }
 
+void KisSelectionDecoration::setOutlinePath(const QPainterPath &path)
+{
+    m_outlinePath = path;
+    m_outlineChunks.clear();
+
+    if (path.isEmpty()) return;
+
+    /**
+     * Complex selections have huge outlines, so the subpaths are grouped
+     * into chunks by the cells of the image and only the chunks visible
+     * in the updated area are stroked. Every subpath is kept whole, and
+     * the dash pattern restarts on every subpath anyway, so the ants
+     * look exactly the same as when stroking the whole path.
+     */
+    QHash<QPair<int, int>, int> chunkIndexes;
+
+    auto addSubpath = [&] (const QPainterPath &subpath) {
+        if (subpath.isEmpty()) return;
+
+        const QRectF bounds = subpath.controlPointRect();
+        const QPair<int, int> cell(qFloor(bounds.center().x() / OUTLINE_CHUNK_SIZE),
+                                   qFloor(bounds.center().y() / OUTLINE_CHUNK_SIZE));
+
+        auto it = chunkIndexes.find(cell);
+        if (it == chunkIndexes.end()) {
+            it = chunkIndexes.insert(cell, m_outlineChunks.size());
+            m_outlineChunks.append(OutlineChunk());
+        }
+
+        OutlineChunk &chunk = m_outlineChunks[*it];
+        chunk.bounds |= bounds;
+        chunk.path.addPath(subpath);
+    };
+
+    QPainterPath subpath;
+
+    for (int i = 0; i < path.elementCount(); i++) {
+        const QPainterPath::Element &element = path.elementAt(i);
+
+        if (element.isMoveTo()) {
+            addSubpath(subpath);
+            subpath = QPainterPath();
+            subpath.moveTo(element);
+        } else if (element.isLineTo()) {
+            subpath.lineTo(element);
+        } else if (element.isCurveTo() && i + 2 < path.elementCount()) {
+            subpath.cubicTo(element, path.elementAt(i + 1), path.elementAt(i + 2));
+            i += 2;
+        }
+    }
+
+    addSubpath(subpath);
+}
+
 void KisSelectionDecoration::slotStartUpdateSelection()
 {
     KisSelectionSP selection = view()->selection();
@@ -153,13 +210,21 @@ void KisSelectionDecoration::antsAttackEvent()
     if (selectionIsActive()) {
         m_offset = (m_offset + 1) % ANT_ADVANCE_WIDTH;
         m_antsPen.setDashOffset(m_offset);
-        view()->canvasBase()->updateCanvas();
+
+        // only the ants move, so there is no need to repaint the whole canvas
+        KisCanvas2 *canvas = view()->canvasBase();
+        const QRectF outlineRect = m_outlinePath.controlPointRect();
+
+        if (outlineRect.isEmpty()) {
+            canvas->updateCanvas();
+        } else {
+            canvas->updateCanvas(canvas->coordinatesConverter()->imageToDocument(outlineRect));
+        }
     }
 }
 
 void KisSelectionDecoration::drawDecoration(QPainter& gc, const QRectF& updateRect, const KisCoordinatesConverter *converter, KisCanvas2 *canvas)
 {
-    Q_UNUSED(updateRect);
     Q_UNUSED(canvas);
 
     if (!selectionIsActive()) return;
@@ -194,13 +259,29 @@ void KisSelectionDecoration::drawDecoration(QPainter& gc, const QRectF& updateRe
     } else /* if (m_mode == Ants) */ {
         gc.setRenderHints(QPainter::Antialiasing | QPainter::HighQualityAntialiasing, m_antialiasSelectionOutline);
 
+        const QRectF widgetUpdateRect = converter->documentToWidget(updateRect);
+
+        const QVector<OutlineChunk> &chunks = m_outlineChunks;
+
+        QVarLengthArray<const OutlineChunk*, 64> visibleChunks;
+        for (const OutlineChunk &chunk : chunks) {
+            const QRectF widgetChunkRect = transform.mapRect(chunk.bounds).adjusted(-2, -2, 2, 2);
+            if (widgetChunkRect.intersects(widgetUpdateRect)) {
+                visibleChunks.append(&chunk);
+            }
+        }
+
         // render selection outline in white
         gc.setPen(m_outlinePen);
-        gc.drawPath(m_outlinePath);
+        for (const OutlineChunk *chunk : visibleChunks) {
+            gc.drawPath(chunk->path);
+        }
 
         // render marching ants in black (above the white outline)
         gc.setPen(m_antsPen);
-        gc.drawPath(m_outlinePath);
+        for (const OutlineChunk *chunk : visibleChunks) {
+            gc.drawPath(chunk->path);
+        }
     }
     gc.restore();
 }
@@ -45,10 +45,22 @@ public Q_SLOTS:
     void antsAttackEvent();
 private:
     bool selectionIsActive();
+    void setOutlinePath(const QPainterPath &path);
+
+private:
+    /**
+     * A group of the subpaths of the outline lying in the same cell
+     * of the image
+     */
+    struct OutlineChunk {
+        QRectF bounds;
+        QPainterPath path;
+    };
 
 private:
     KisSignalCompressor m_signalCompressor;
     QPainterPath m_outlinePath;
+    QVector<OutlineChunk> m_outlineChunks;
     QImage m_thumbnailImage;
     QTransform m_thumbnailImageTransform;
     QTimer* m_antsTimer;
@@ -0,0 +1,1180 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#define GL_GLEXT_PROTOTYPES
+
+#include "opengl/KisOpenGLCanvasRenderer.h"
+
+#include "kis_algebra_2d.h"
+#include "opengl/kis_opengl_shader_loader.h"
+#include "canvas/kis_canvas2.h"
+#include "canvas/kis_canvas_widget_base.h"
+#include "canvas/kis_coordinates_converter.h"
+#include "canvas/kis_display_filter.h"
+#include "canvas/kis_display_color_converter.h"
+#include "kis_config.h"
+#include "kis_debug.h"
+#include "kis_lod_transform.h"
+
+#include <QApplication>
+#include <QPainterPath>
+#include <QPointF>
+#include <QTransform>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLBuffer>
+#include <QOpenGLFramebufferObject>
+#include <QMessageBox>
+#include <KoColorModelStandardIds.h>
+
+#if !defined(Q_OS_MACOS) && !defined(HAS_ONLY_OPENGL_ES)
+#include <QOpenGLFunctions_2_1>
+#endif
+
+#define NEAR_VAL -1000.0
+#define FAR_VAL 1000.0
+
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+
+#define PROGRAM_VERTEX_ATTRIBUTE 0
+#define PROGRAM_TEXCOORD_ATTRIBUTE 1
+
+struct KisOpenGLCanvasRenderer::Private
+{
+public:
+    ~Private() {
+        delete displayShader;
+        delete checkerShader;
+        delete solidColorShader;
+        delete overlayInvertedShader;
+    }
+
+    CanvasBridge *canvasBridge{0};
+
+    bool canvasInitialized{false};
+
+    KisOpenGLImageTexturesSP openGLImageTextures;
+
+    KisOpenGLShaderLoader shaderLoader;
+    KisShaderProgram *displayShader{0};
+    KisShaderProgram *checkerShader{0};
+    KisShaderProgram *solidColorShader{0};
+    KisShaderProgram *overlayInvertedShader{0};
+
+    QScopedPointer<QOpenGLFramebufferObject> canvasFBO;
+
+    bool displayShaderCompiledWithDisplayFilterSupport{false};
+    QByteArray displayShaderColorProgram;
+    bool displayShaderCompiledWithDisplayLut{false};
+
+    GLfloat checkSizeScale;
+    bool scrollCheckers;
+
+    QSharedPointer<KisDisplayFilter> displayFilter;
+    KisOpenGL::FilterMode filterMode;
+
+    bool useProjectionPyramid{false};
+    int numMipmapLevels{0};
+
+    bool wrapAroundMode{false};
+
+    // the size of the surface in logical pixels
+    QSize widgetSize;
+
+    // Stores a quad for drawing the canvas
+    QOpenGLVertexArrayObject quadVAO;
+    QOpenGLBuffer quadBuffers[2];
+
+    // Stores the quads of all the texture tiles of the image, so the
+    // view changes only update the transformation uniform
+    QOpenGLVertexArrayObject tileGridVAO;
+    QOpenGLBuffer tileGridBuffers[2];
+    QRect tileGridImageBounds;
+    QRect tileGridFirstTileRect;
+    QRectF tileGridFirstTileTextureRect;
+
+    // Stores data for drawing tool outlines
+    QOpenGLVertexArrayObject outlineVAO;
+    QOpenGLBuffer lineVertexBuffer;
+    QOpenGLBuffer lineTexCoordBuffer;
+
+    QVector3D vertices[6];
+    QVector2D texCoords[6];
+
+#if !defined(Q_OS_MACOS) && !defined(HAS_ONLY_OPENGL_ES)
+    QOpenGLFunctions_2_1 *glFn201;
+#endif
+
+    qreal pixelGridDrawingThreshold;
+    bool pixelGridEnabled;
+    QColor gridColor;
+    QColor cursorColor;
+
+    bool lodSwitchInProgress = false;
+
+    int xToColWithWrapCompensation(int x, const QRect &imageRect) {
+        int firstImageColumn = openGLImageTextures->xToCol(imageRect.left());
+        int lastImageColumn = openGLImageTextures->xToCol(imageRect.right());
+
+        int colsPerImage = lastImageColumn - firstImageColumn + 1;
+        int numWraps = floor(qreal(x) / imageRect.width());
+        int remainder = x - imageRect.width() * numWraps;
+
+        return colsPerImage * numWraps + openGLImageTextures->xToCol(remainder);
+    }
+
+    int yToRowWithWrapCompensation(int y, const QRect &imageRect) {
+        int firstImageRow = openGLImageTextures->yToRow(imageRect.top());
+        int lastImageRow = openGLImageTextures->yToRow(imageRect.bottom());
+
+        int rowsPerImage = lastImageRow - firstImageRow + 1;
+        int numWraps = floor(qreal(y) / imageRect.height());
+        int remainder = y - imageRect.height() * numWraps;
+
+        return rowsPerImage * numWraps + openGLImageTextures->yToRow(remainder);
+    }
+
+};
+
+KisOpenGLCanvasRenderer::KisOpenGLCanvasRenderer(CanvasBridge *canvasBridge,
+                                                 KisImageWSP image,
+                                                 KisDisplayColorConverter *colorConverter)
+    : d(new Private())
+{
+    d->canvasBridge = canvasBridge;
+
+    d->openGLImageTextures =
+            KisOpenGLImageTextures::getImageTextures(image,
+                                                     colorConverter->openGLCanvasSurfaceProfile(),
+                                                     colorConverter->renderingIntent(),
+                                                     colorConverter->conversionFlags());
+
+    setDisplayFilterImpl(colorConverter->displayFilter(), true);
+
+    updateConfig();
+    updatePixelGridMode();
+}
+
+KisOpenGLCanvasRenderer::~KisOpenGLCanvasRenderer()
+{
+    delete d;
+}
+
+KisCanvas2 *KisOpenGLCanvasRenderer::canvas() const
+{
+    return d->canvasBridge->canvas();
+}
+
+KisCoordinatesConverter *KisOpenGLCanvasRenderer::coordinatesConverter() const
+{
+    return d->canvasBridge->coordinatesConverter();
+}
+
+void KisOpenGLCanvasRenderer::setDisplayFilter(QSharedPointer<KisDisplayFilter> displayFilter)
+{
+    setDisplayFilterImpl(displayFilter, false);
+}
+
+void KisOpenGLCanvasRenderer::setDisplayFilterImpl(QSharedPointer<KisDisplayFilter> displayFilter, bool initializing)
+{
+    bool needsInternalColorManagement =
+            !displayFilter || displayFilter->useInternalColorManagement();
+
+    bool needsFullRefresh = d->openGLImageTextures->setInternalColorManagementActive(needsInternalColorManagement);
+
+    d->displayFilter = displayFilter;
+
+    if (!initializing && needsFullRefresh) {
+        canvas()->startUpdateInPatches(canvas()->image()->bounds());
+    }
+    else if (!initializing)  {
+        canvas()->updateCanvas();
+    }
+}
+
+void KisOpenGLCanvasRenderer::notifyImageColorSpaceChanged(const KoColorSpace *cs)
+{
+    // FIXME: on color space change the data is refetched multiple
+    //        times by different actors!
+
+    if (d->openGLImageTextures->setImageColorSpace(cs)) {
+        canvas()->startUpdateInPatches(canvas()->image()->bounds());
+    }
+}
+
+void KisOpenGLCanvasRenderer::setWrapAroundViewingMode(bool value)
+{
+    d->wrapAroundMode = value;
+}
+
+bool KisOpenGLCanvasRenderer::wrapAroundViewingMode() const
+{
+    return d->wrapAroundMode;
+}
+
+inline void rectToVertices(QVector3D* vertices, const QRectF &rc)
+{
+    vertices[0] = QVector3D(rc.left(),  rc.bottom(), 0.f);
+    vertices[1] = QVector3D(rc.left(),  rc.top(),    0.f);
+    vertices[2] = QVector3D(rc.right(), rc.bottom(), 0.f);
+    vertices[3] = QVector3D(rc.left(),  rc.top(), 0.f);
+    vertices[4] = QVector3D(rc.right(), rc.top(), 0.f);
+    vertices[5] = QVector3D(rc.right(), rc.bottom(),    0.f);
+}
+
+inline void rectToTexCoords(QVector2D* texCoords, const QRectF &rc)
+{
+    texCoords[0] = QVector2D(rc.left(), rc.bottom());
+    texCoords[1] = QVector2D(rc.left(), rc.top());
+    texCoords[2] = QVector2D(rc.right(), rc.bottom());
+    texCoords[3] = QVector2D(rc.left(), rc.top());
+    texCoords[4] = QVector2D(rc.right(), rc.top());
+    texCoords[5] = QVector2D(rc.right(), rc.bottom());
+}
+
+void KisOpenGLCanvasRenderer::initializeGL()
+{
+    QOpenGLContext *ctx = d->canvasBridge->openglContext();
+
+    initializeOpenGLFunctions();
+#if !defined(Q_OS_MACOS) && !defined(HAS_ONLY_OPENGL_ES)
+    if (!KisOpenGL::hasOpenGLES()) {
+        d->glFn201 = ctx->versionFunctions<QOpenGLFunctions_2_1>();
+        if (!d->glFn201) {
+            warnUI << "Cannot obtain QOpenGLFunctions_2_1, glLogicOp cannot be used";
+        }
+    } else {
+        d->glFn201 = nullptr;
+    }
+#endif
+
+    KisConfig cfg(true);
+    d->openGLImageTextures->setProofingConfig(canvas()->proofingConfiguration());
+    d->openGLImageTextures->initGL(ctx->functions());
+    d->openGLImageTextures->generateCheckerTexture(KisCanvasWidgetBase::createCheckersImage(cfg.checkSize()));
+
+    initializeShaders();
+
+    // If we support OpenGL 3.2, then prepare our VAOs and VBOs for drawing
+    if (KisOpenGL::hasOpenGL3()) {
+        d->quadVAO.create();
+        d->quadVAO.bind();
+
+        glEnableVertexAttribArray(PROGRAM_VERTEX_ATTRIBUTE);
+        glEnableVertexAttribArray(PROGRAM_TEXCOORD_ATTRIBUTE);
+
+        // Create the vertex buffer object, it has 6 vertices with 3 components
+        d->quadBuffers[0].create();
+        d->quadBuffers[0].setUsagePattern(QOpenGLBuffer::StaticDraw);
+        d->quadBuffers[0].bind();
+        d->quadBuffers[0].allocate(d->vertices, 6 * 3 * sizeof(float));
+        glVertexAttribPointer(PROGRAM_VERTEX_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+        // Create the texture buffer object, it has 6 texture coordinates with 2 components
+        d->quadBuffers[1].create();
+        d->quadBuffers[1].setUsagePattern(QOpenGLBuffer::StaticDraw);
+        d->quadBuffers[1].bind();
+        d->quadBuffers[1].allocate(d->texCoords, 6 * 2 * sizeof(float));
+        glVertexAttribPointer(PROGRAM_TEXCOORD_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+
+        // The tile grid buffers are filled by updateTileGrid() when the
+        // tiles of the image are created
+        d->tileGridVAO.create();
+        d->tileGridVAO.bind();
+
+        glEnableVertexAttribArray(PROGRAM_VERTEX_ATTRIBUTE);
+        glEnableVertexAttribArray(PROGRAM_TEXCOORD_ATTRIBUTE);
+
+        d->tileGridBuffers[0].create();
+        d->tileGridBuffers[0].setUsagePattern(QOpenGLBuffer::StaticDraw);
+        d->tileGridBuffers[0].bind();
+        glVertexAttribPointer(PROGRAM_VERTEX_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+        d->tileGridBuffers[1].create();
+        d->tileGridBuffers[1].setUsagePattern(QOpenGLBuffer::StaticDraw);
+        d->tileGridBuffers[1].bind();
+        glVertexAttribPointer(PROGRAM_TEXCOORD_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+
+        // Create the outline buffer, this buffer will store the outlines of
+        // tools and will frequently change data
+        d->outlineVAO.create();
+        d->outlineVAO.bind();
+
+        glEnableVertexAttribArray(PROGRAM_VERTEX_ATTRIBUTE);
+        glEnableVertexAttribArray(PROGRAM_TEXCOORD_ATTRIBUTE);
+
+        // The outline buffer has a StreamDraw usage pattern, because it changes constantly
+        d->lineVertexBuffer.create();
+        d->lineVertexBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+        d->lineVertexBuffer.bind();
+        glVertexAttribPointer(PROGRAM_VERTEX_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+        d->lineTexCoordBuffer.create();
+        d->lineTexCoordBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+        d->lineTexCoordBuffer.bind();
+        glVertexAttribPointer(PROGRAM_TEXCOORD_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0 ,0);
+    }
+
+    d->canvasInitialized = true;
+}
+
+void KisOpenGLCanvasRenderer::initializeShaders()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!d->canvasInitialized);
+
+    delete d->checkerShader;
+    delete d->solidColorShader;
+    delete d->overlayInvertedShader;
+    d->checkerShader = 0;
+    d->solidColorShader = 0;
+    d->overlayInvertedShader = 0;
+
+    try {
+        d->checkerShader = d->shaderLoader.loadCheckerShader();
+        d->solidColorShader = d->shaderLoader.loadSolidColorShader();
+        d->overlayInvertedShader = d->shaderLoader.loadOverlayInvertedShader();
+    } catch (const ShaderLoaderException &e) {
+        reportFailedShaderCompilation(e.what());
+    }
+
+    initializeDisplayShader();
+}
+
+void KisOpenGLCanvasRenderer::initializeDisplayShader()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!d->canvasInitialized);
+
+    bool useHiQualityFiltering = d->filterMode == KisOpenGL::HighQualityFiltering;
+
+    delete d->displayShader;
+    d->displayShader = 0;
+
+    try {
+        const QByteArray colorProgram =
+            d->openGLImageTextures->displayShaderProgram();
+
+        d->displayShader = d->shaderLoader.loadDisplayShader(d->displayFilter, colorProgram, useHiQualityFiltering);
+        d->displayShaderCompiledWithDisplayFilterSupport = d->displayFilter;
+        d->displayShaderColorProgram = colorProgram;
+        d->displayShaderCompiledWithDisplayLut = !d->openGLImageTextures->displayLut()->shaderProgram().isEmpty();
+    } catch (const ShaderLoaderException &e) {
+        reportFailedShaderCompilation(e.what());
+    }
+}
+
+void KisOpenGLCanvasRenderer::reportFailedShaderCompilation(const QString &context)
+{
+    KisConfig cfg(false);
+
+    qDebug() << "Shader Compilation Failure: " << context;
+    QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita"),
+                          i18n("Krita could not initialize the OpenGL canvas:\n\n%1\n\n Krita will disable OpenGL and close now.", context),
+                          QMessageBox::Close);
+
+    cfg.disableOpenGL();
+    cfg.setCanvasState("OPENGL_FAILED");
+}
+
+void KisOpenGLCanvasRenderer::resizeGL(int width, int height)
+{
+    const qreal ratio = d->canvasBridge->devicePixelRatioF();
+
+    d->widgetSize = QSize(width, height);
+
+    if (KisOpenGL::useFBOForToolOutlineRendering()) {
+        d->canvasFBO.reset(new QOpenGLFramebufferObject(QSize(width * ratio, height * ratio)));
+    }
+
+    // The given size is the widget size but here we actually want to give
+    // KisCoordinatesConverter the viewport size aligned to device pixels.
+    coordinatesConverter()->setCanvasWidgetSize(widgetSizeAlignedToDevicePixel());
+}
+
+void KisOpenGLCanvasRenderer::paintCanvasOnly(const QRect &updateRect)
+{
+    if (d->canvasFBO) {
+        d->canvasFBO->bind();
+    }
+
+    renderCanvasGL(updateRect);
+
+    if (d->canvasFBO) {
+        const qreal ratio = d->canvasBridge->devicePixelRatioF();
+        const QTransform scale = QTransform::fromScale(1.0, -1.0) * QTransform::fromTranslate(0, d->widgetSize.height()) * QTransform::fromScale(ratio, ratio);
+
+        const QRect blitRect = scale.mapRect(QRectF(updateRect)).toAlignedRect();
+
+        d->canvasFBO->release();
+        QOpenGLFramebufferObject::blitFramebuffer(nullptr, blitRect, d->canvasFBO.data(), blitRect, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        QOpenGLFramebufferObject::bindDefault();
+    }
+}
+
+void KisOpenGLCanvasRenderer::paintToolOutline(const QPainterPath &path)
+{
+    if (!d->overlayInvertedShader->bind()) {
+        return;
+    }
+
+    QSizeF widgetSize = widgetSizeAlignedToDevicePixel();
+
+    // setup the mvp transformation
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.setToIdentity();
+    // FIXME: It may be better to have the projection in device pixel, but
+    //       this requires introducing a new coordinate system.
+    projectionMatrix.ortho(0, widgetSize.width(), widgetSize.height(), 0, NEAR_VAL, FAR_VAL);
+
+    // Set view/projection & texture matrices
+    QMatrix4x4 modelMatrix(coordinatesConverter()->flakeToWidgetTransform());
+    modelMatrix.optimize();
+    modelMatrix = projectionMatrix * modelMatrix;
+    d->overlayInvertedShader->setUniformValue(d->overlayInvertedShader->location(Uniform::ModelViewProjection), modelMatrix);
+
+    d->overlayInvertedShader->setUniformValue(
+                d->overlayInvertedShader->location(Uniform::FragmentColor),
+                QVector4D(d->cursorColor.redF(), d->cursorColor.greenF(), d->cursorColor.blueF(), 1.0f));
+
+    // NOTE: Texture matrix transforms flake space -> widget space -> OpenGL UV texcoord space..
+    const QMatrix4x4 widgetToFBOTexCoordTransform = KisAlgebra2D::mapToRectInverse(QRect(QPoint(0, d->widgetSize.height()),
+                                                                                         QSize(d->widgetSize.width(), -1 * d->widgetSize.height())));
+    const QMatrix4x4 textureMatrix = widgetToFBOTexCoordTransform *
+        QMatrix4x4(coordinatesConverter()->flakeToWidgetTransform());
+
+    d->overlayInvertedShader->setUniformValue(d->overlayInvertedShader->location(Uniform::TextureMatrix), textureMatrix);
+
+    bool shouldRestoreLogicOp = false;
+
+    // For the legacy shader, we should use old fixed function
+    // blending operations if available.
+    if (!d->canvasFBO && !KisOpenGL::supportsLoD() && !KisOpenGL::hasOpenGLES()) {
+        #ifndef HAS_ONLY_OPENGL_ES
+        glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+        glEnable(GL_COLOR_LOGIC_OP);
+
+        #ifndef Q_OS_MACOS
+        if (d->glFn201) {
+            d->glFn201->glLogicOp(GL_XOR);
+        }
+        #else   // Q_OS_MACOS
+        glLogicOp(GL_XOR);
+        #endif  // Q_OS_MACOS
+
+        shouldRestoreLogicOp = true;
+
+        #else   // HAS_ONLY_OPENGL_ES
+        KIS_ASSERT_X(false, "KisOpenGLCanvasRenderer::paintToolOutline",
+                        "Unexpected KisOpenGL::hasOpenGLES returned false");
+        #endif  // HAS_ONLY_OPENGL_ES
+    }
+
+    // Paint the tool outline
+    if (KisOpenGL::hasOpenGL3()) {
+        d->outlineVAO.bind();
+        d->lineVertexBuffer.bind();
+    }
+
+    // Convert every disjointed subpath to a polygon and draw that polygon
+    QList<QPolygonF> subPathPolygons = path.toSubpathPolygons();
+    for (int polyIndex = 0; polyIndex < subPathPolygons.size(); polyIndex++) {
+        const QPolygonF& polygon = subPathPolygons.at(polyIndex);
+
+        QVector<QVector3D> vertices;
+        QVector<QVector2D> texCoords;
+        vertices.resize(polygon.count());
+        texCoords.resize(polygon.count());
+
+        for (int vertIndex = 0; vertIndex < polygon.count(); vertIndex++) {
+            QPointF point = polygon.at(vertIndex);
+            vertices[vertIndex].setX(point.x());
+            vertices[vertIndex].setY(point.y());
+            texCoords[vertIndex].setX(point.x());
+            texCoords[vertIndex].setY(point.y());
+        }
+        if (KisOpenGL::hasOpenGL3()) {
+            d->lineVertexBuffer.bind();
+            d->lineVertexBuffer.allocate(vertices.constData(), 3 * vertices.size() * sizeof(float));
+            d->lineTexCoordBuffer.bind();
+            d->lineTexCoordBuffer.allocate(texCoords.constData(), 2 * texCoords.size() * sizeof(float));
+        }
+        else {
+            d->overlayInvertedShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
+            d->overlayInvertedShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, vertices.constData());
+            d->overlayInvertedShader->enableAttributeArray(PROGRAM_TEXCOORD_ATTRIBUTE);
+            d->overlayInvertedShader->setAttributeArray(PROGRAM_TEXCOORD_ATTRIBUTE, texCoords.constData());
+        }
+
+        if (d->canvasFBO){
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, d->canvasFBO->texture());
+
+            glDrawArrays(GL_LINE_STRIP, 0, vertices.size());
+
+            glBindTexture(GL_TEXTURE_2D, 0);
+        } else {
+            glDrawArrays(GL_LINE_STRIP, 0, vertices.size());
+        }
+    }
+
+    if (KisOpenGL::hasOpenGL3()) {
+        d->lineVertexBuffer.release();
+        d->outlineVAO.release();
+    }
+
+    if (shouldRestoreLogicOp) {
+#ifndef HAS_ONLY_OPENGL_ES
+        glDisable(GL_COLOR_LOGIC_OP);
+#else
+        KIS_ASSERT_X(false, "KisOpenGLCanvasRenderer::paintToolOutline",
+                "Unexpected KisOpenGL::hasOpenGLES returned false");
+#endif
+    }
+
+    d->overlayInvertedShader->release();
+}
+
+void KisOpenGLCanvasRenderer::setLodResetInProgress(bool value)
+{
+    d->lodSwitchInProgress = value;
+}
+
+void KisOpenGLCanvasRenderer::drawBackground(const QRect &updateRect)
+{
+    Q_UNUSED(updateRect);
+
+    // Draw the border (that is, clear the whole widget to the border color)
+    QColor widgetBackgroundColor = d->canvasBridge->borderColor();
+
+    const KoColorSpace *finalColorSpace =
+            KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                         d->openGLImageTextures->updateInfoBuilder().destinationColorSpace()->colorDepthId().id(),
+                                                         d->openGLImageTextures->monitorProfile());
+
+    KoColor convertedBackgroudColor = KoColor(widgetBackgroundColor, KoColorSpaceRegistry::instance()->rgb8());
+    convertedBackgroudColor.convertTo(finalColorSpace);
+
+    QVector<float> channels = QVector<float>(4);
+    convertedBackgroudColor.colorSpace()->normalisedChannelsValue(convertedBackgroudColor.data(), channels);
+
+
+    // Data returned by KoRgbU8ColorSpace comes in the order: blue, green, red.
+    glClearColor(channels[2], channels[1], channels[0], 1.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void KisOpenGLCanvasRenderer::drawCheckers(const QRect &updateRect)
+{
+    Q_UNUSED(updateRect);
+
+    if (!d->checkerShader) {
+        return;
+    }
+
+    KisCoordinatesConverter *converter = coordinatesConverter();
+    QTransform textureTransform;
+    QTransform modelTransform;
+    QRectF textureRect;
+    QRectF modelRect;
+
+    QSizeF widgetSize = widgetSizeAlignedToDevicePixel();
+    QRectF viewportRect = !d->wrapAroundMode ?
+                converter->imageRectInViewportPixels() :
+                converter->widgetToViewport(QRectF(0, 0, widgetSize.width(), widgetSize.height()));
+
+    // TODO: check if it works correctly
+    if (!canvas()->renderingLimit().isEmpty()) {
+        const QRect vrect = converter->imageToViewport(canvas()->renderingLimit()).toAlignedRect();
+        viewportRect &= vrect;
+    }
+
+    converter->getOpenGLCheckersInfo(viewportRect,
+                                     &textureTransform, &modelTransform, &textureRect, &modelRect, d->scrollCheckers);
+
+    textureTransform *= QTransform::fromScale(d->checkSizeScale / KisOpenGLImageTextures::BACKGROUND_TEXTURE_SIZE,
+                                              d->checkSizeScale / KisOpenGLImageTextures::BACKGROUND_TEXTURE_SIZE);
+
+    if (!d->checkerShader->bind()) {
+        qWarning() << "Could not bind checker shader";
+        return;
+    }
+
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.setToIdentity();
+    // FIXME: It may be better to have the projection in device pixel, but
+    //       this requires introducing a new coordinate system.
+    projectionMatrix.ortho(0, widgetSize.width(), widgetSize.height(), 0, NEAR_VAL, FAR_VAL);
+
+    // Set view/projection matrices
+    QMatrix4x4 modelMatrix(modelTransform);
+    modelMatrix.optimize();
+    modelMatrix = projectionMatrix * modelMatrix;
+    d->checkerShader->setUniformValue(d->checkerShader->location(Uniform::ModelViewProjection), modelMatrix);
+
+    QMatrix4x4 textureMatrix(textureTransform);
+    d->checkerShader->setUniformValue(d->checkerShader->location(Uniform::TextureMatrix), textureMatrix);
+
+    //Setup the geometry for rendering
+    if (KisOpenGL::hasOpenGL3()) {
+        rectToVertices(d->vertices, modelRect);
+        d->quadBuffers[0].bind();
+        d->quadBuffers[0].write(0, d->vertices, 3 * 6 * sizeof(float));
+
+        rectToTexCoords(d->texCoords, textureRect);
+        d->quadBuffers[1].bind();
+        d->quadBuffers[1].write(0, d->texCoords, 2 * 6 * sizeof(float));
+    }
+    else {
+        rectToVertices(d->vertices, modelRect);
+        d->checkerShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
+        d->checkerShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, d->vertices);
+
+        rectToTexCoords(d->texCoords, textureRect);
+        d->checkerShader->enableAttributeArray(PROGRAM_TEXCOORD_ATTRIBUTE);
+        d->checkerShader->setAttributeArray(PROGRAM_TEXCOORD_ATTRIBUTE, d->texCoords);
+    }
+
+    // render checkers
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, d->openGLImageTextures->checkerTexture());
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    d->checkerShader->release();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void KisOpenGLCanvasRenderer::drawGrid(const QRect &updateRect)
+{
+    if (!d->solidColorShader->bind()) {
+        return;
+    }
+
+    QSizeF widgetSize = widgetSizeAlignedToDevicePixel();
+
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.setToIdentity();
+    // FIXME: It may be better to have the projection in device pixel, but
+    //       this requires introducing a new coordinate system.
+    projectionMatrix.ortho(0, widgetSize.width(), widgetSize.height(), 0, NEAR_VAL, FAR_VAL);
+
+    // Set view/projection matrices
+    QMatrix4x4 modelMatrix(coordinatesConverter()->imageToWidgetTransform());
+    modelMatrix.optimize();
+    modelMatrix = projectionMatrix * modelMatrix;
+    d->solidColorShader->setUniformValue(d->solidColorShader->location(Uniform::ModelViewProjection), modelMatrix);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    d->solidColorShader->setUniformValue(
+                d->solidColorShader->location(Uniform::FragmentColor),
+                QVector4D(d->gridColor.redF(), d->gridColor.greenF(), d->gridColor.blueF(), 0.5f));
+
+    if (KisOpenGL::hasOpenGL3()) {
+        d->outlineVAO.bind();
+        d->lineVertexBuffer.bind();
+    }
+
+    QRectF widgetRect(0,0, widgetSize.width(), widgetSize.height());
+    QRectF widgetRectInImagePixels = coordinatesConverter()->documentToImage(coordinatesConverter()->widgetToDocument(widgetRect));
+    QRect wr = widgetRectInImagePixels.toAlignedRect();
+
+    if (!d->wrapAroundMode) {
+        wr &= d->openGLImageTextures->storedImageBounds();
+    }
+
+    if (!updateRect.isEmpty()) {
+        const QRect updateRectInImagePixels = coordinatesConverter()->widgetToImage(updateRect).toAlignedRect();
+        wr &= updateRectInImagePixels;
+    }
+
+    QPoint topLeftCorner = wr.topLeft();
+    QPoint bottomRightCorner = wr.bottomRight() + QPoint(1, 1);
+    QVector<QVector3D> grid;
+
+    for (int i = topLeftCorner.x(); i <= bottomRightCorner.x(); ++i) {
+        grid.append(QVector3D(i, topLeftCorner.y(), 0));
+        grid.append(QVector3D(i, bottomRightCorner.y(), 0));
+    }
+    for (int i = topLeftCorner.y(); i <= bottomRightCorner.y(); ++i) {
+        grid.append(QVector3D(topLeftCorner.x(), i, 0));
+        grid.append(QVector3D(bottomRightCorner.x(), i, 0));
+    }
+
+    if (KisOpenGL::hasOpenGL3()) {
+        d->lineVertexBuffer.allocate(grid.constData(), 3 * grid.size() * sizeof(float));
+    }
+    else {
+        d->solidColorShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
+        d->solidColorShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, grid.constData());
+    }
+
+    glDrawArrays(GL_LINES, 0, grid.size());
+
+    if (KisOpenGL::hasOpenGL3()) {
+        d->lineVertexBuffer.release();
+        d->outlineVAO.release();
+    }
+
+    d->solidColorShader->release();
+    glDisable(GL_BLEND);
+}
+
+void KisOpenGLCanvasRenderer::drawImage(const QRect &updateRect)
+{
+    if (!d->displayShader) {
+        return;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    KisCoordinatesConverter *converter = coordinatesConverter();
+
+    d->displayShader->bind();
+
+    QSizeF widgetSize = widgetSizeAlignedToDevicePixel();
+
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.setToIdentity();
+    // FIXME: It may be better to have the projection in device pixel, but
+    //       this requires introducing a new coordinate system.
+    projectionMatrix.ortho(0, widgetSize.width(), widgetSize.height(), 0, NEAR_VAL, FAR_VAL);
+
+    // Set view/projection matrices
+    QMatrix4x4 modelMatrix(converter->imageToWidgetTransform());
+    modelMatrix.optimize();
+    modelMatrix = projectionMatrix * modelMatrix;
+    d->displayShader->setUniformValue(d->displayShader->location(Uniform::ModelViewProjection), modelMatrix);
+
+    QMatrix4x4 textureMatrix;
+    textureMatrix.setToIdentity();
+    d->displayShader->setUniformValue(d->displayShader->location(Uniform::TextureMatrix), textureMatrix);
+
+    QRectF widgetRect(0,0, widgetSize.width(), widgetSize.height());
+
+    d->openGLImageTextures->startFrame(
+        converter->documentToImage(converter->widgetToDocument(widgetRect)).toAlignedRect());
+
+    if (!updateRect.isEmpty()) {
+        widgetRect &= updateRect;
+    }
+
+    QRectF widgetRectInImagePixels = converter->documentToImage(converter->widgetToDocument(widgetRect));
+
+    const QRect renderingLimit = canvas()->renderingLimit();
+
+    if (!renderingLimit.isEmpty()) {
+        widgetRectInImagePixels &= renderingLimit;
+    }
+
+    qreal scaleX, scaleY;
+    converter->imagePhysicalScale(&scaleX, &scaleY);
+
+    d->displayShader->setUniformValue(d->displayShader->location(Uniform::ViewportScale), (GLfloat) scaleX);
+
+    /**
+     * The mipmaps are sampled only when the canvas is zoomed out, so
+     * the tiles defer their regeneration until that happens
+     */
+    const bool mipmapsAreSampled =
+        (d->filterMode == KisOpenGL::TrilinearFilterMode &&
+         SCALE_LESS_THAN(scaleX, scaleY, 1.0)) ||
+        (d->filterMode == KisOpenGL::HighQualityFiltering &&
+         SCALE_LESS_THAN(scaleX, scaleY, 0.5));
+    d->displayShader->setUniformValue(d->displayShader->location(Uniform::TexelSize), (GLfloat) d->openGLImageTextures->texelSize());
+
+    /**
+     * When zoomed out, the tiles are painted from the plane of the
+     * downscaled projection closest to the zoom, so the filtering never
+     * minifies the texture more than twice
+     */
+    const bool canUseProjectionPyramid =
+        d->useProjectionPyramid &&
+        KisOpenGL::supportsLoD() &&
+        (d->filterMode == KisOpenGL::TrilinearFilterMode ||
+         d->filterMode == KisOpenGL::HighQualityFiltering);
+
+    d->openGLImageTextures->setPreferredLevelOfDetail(
+        canUseProjectionPyramid ?
+            KisLodTransform::scaleToLod(qMax(scaleX, scaleY), d->numMipmapLevels) : 0);
+
+    QRect ir = d->openGLImageTextures->storedImageBounds();
+    QRect wr = widgetRectInImagePixels.toAlignedRect();
+
+    if (!d->wrapAroundMode) {
+        // if we don't want to paint wrapping images, just limit the
+        // processing area, and the code will handle all the rest
+        wr &= ir;
+    }
+
+    int firstColumn = d->xToColWithWrapCompensation(wr.left(), ir);
+    int lastColumn = d->xToColWithWrapCompensation(wr.right(), ir);
+    int firstRow = d->yToRowWithWrapCompensation(wr.top(), ir);
+    int lastRow = d->yToRowWithWrapCompensation(wr.bottom(), ir);
+
+    int minColumn = d->openGLImageTextures->xToCol(ir.left());
+    int maxColumn = d->openGLImageTextures->xToCol(ir.right());
+    int minRow = d->openGLImageTextures->yToRow(ir.top());
+    int maxRow = d->openGLImageTextures->yToRow(ir.bottom());
+
+    int imageColumns = maxColumn - minColumn + 1;
+    int imageRows = maxRow - minRow + 1;
+
+    /**
+     * The geometry of the tiles doesn't depend on the view, so unless
+     * the rendering is limited to a part of the image, the tiles are
+     * drawn from the static tile grid and panning, zooming or rotating
+     * the canvas only changes the transformation uniform
+     */
+    const bool useTileGrid =
+        KisOpenGL::hasOpenGL3() &&
+        renderingLimit.isEmpty() &&
+        updateTileGrid(minColumn, maxColumn, minRow, maxRow);
+
+    if (useTileGrid) {
+        d->tileGridVAO.bind();
+    }
+
+    QPointF currentWrappingTranslation;
+
+    for (int col = firstColumn; col <= lastColumn; col++) {
+        for (int row = firstRow; row <= lastRow; row++) {
+
+            int effectiveCol = col;
+            int effectiveRow = row;
+            QPointF tileWrappingTranslation;
+
+            if (effectiveCol > maxColumn || effectiveCol < minColumn) {
+                int translationStep = floor(qreal(col) / imageColumns);
+                int originCol = translationStep * imageColumns;
+                effectiveCol = col - originCol;
+                tileWrappingTranslation.rx() = translationStep * ir.width();
+            }
+
+            if (effectiveRow > maxRow || effectiveRow < minRow) {
+                int translationStep = floor(qreal(row) / imageRows);
+                int originRow = translationStep * imageRows;
+                effectiveRow = row - originRow;
+                tileWrappingTranslation.ry() = translationStep * ir.height();
+            }
+
+            KisTextureTile *tile =
+                    d->openGLImageTextures->getTextureTileCR(effectiveCol, effectiveRow);
+
+            if (!tile) {
+                warnUI << "OpenGL: Trying to paint texture tile but it has not been created yet.";
+                continue;
+            }
+
+            if (!d->openGLImageTextures->requestTileForPainting(tile)) {
+                // the tile has been evicted, it will be painted when fetched again
+                continue;
+            }
+
+            /*
+             * We create a float rect here to workaround Qt's
+             * "history reasons" in calculation of right()
+             * and bottom() coordinates of integer rects.
+             */
+
+            QRectF textureRect;
+            QRectF modelRect;
+
+            if (renderingLimit.isEmpty()) {
+                textureRect = tile->tileRectInTexturePixels();
+                modelRect = tile->tileRectInImagePixels().translated(tileWrappingTranslation.x(), tileWrappingTranslation.y());
+            } else {
+                const QRect limitedTileRect = tile->tileRectInImagePixels() & renderingLimit;
+                textureRect = tile->imageRectInTexturePixels(limitedTileRect);
+                modelRect = limitedTileRect.translated(tileWrappingTranslation.x(), tileWrappingTranslation.y());
+            }
+
+            int firstVertex = 0;
+
+            //Setup the geometry for rendering
+            if (useTileGrid) {
+                if (tileWrappingTranslation != currentWrappingTranslation) {
+                    QMatrix4x4 wrappedModelMatrix(modelMatrix);
+                    wrappedModelMatrix.translate(tileWrappingTranslation.x(), tileWrappingTranslation.y());
+                    d->displayShader->setUniformValue(d->displayShader->location(Uniform::ModelViewProjection), wrappedModelMatrix);
+                    currentWrappingTranslation = tileWrappingTranslation;
+                }
+
+                firstVertex = 6 * ((effectiveRow - minRow) * imageColumns + (effectiveCol - minColumn));
+            }
+            else if (KisOpenGL::hasOpenGL3()) {
+                rectToVertices(d->vertices, modelRect);
+                d->quadBuffers[0].bind();
+                d->quadBuffers[0].write(0, d->vertices, 3 * 6 * sizeof(float));
+
+                rectToTexCoords(d->texCoords, textureRect);
+                d->quadBuffers[1].bind();
+                d->quadBuffers[1].write(0, d->texCoords, 2 * 6 * sizeof(float));
+            }
+            else {
+                rectToVertices(d->vertices, modelRect);
+                d->displayShader->enableAttributeArray(PROGRAM_VERTEX_ATTRIBUTE);
+                d->displayShader->setAttributeArray(PROGRAM_VERTEX_ATTRIBUTE, d->vertices);
+
+                rectToTexCoords(d->texCoords, textureRect);
+                d->displayShader->enableAttributeArray(PROGRAM_TEXCOORD_ATTRIBUTE);
+                d->displayShader->setAttributeArray(PROGRAM_TEXCOORD_ATTRIBUTE, d->texCoords);
+            }
+
+            if (d->displayFilter) {
+                glActiveTexture(GL_TEXTURE0 + 1);
+                glBindTexture(GL_TEXTURE_3D, d->displayFilter->lutTexture());
+                d->displayShader->setUniformValue(d->displayShader->location(Uniform::Texture1), 1);
+            }
+
+            if (d->displayShaderCompiledWithDisplayLut) {
+                glActiveTexture(GL_TEXTURE0 + 2);
+                d->openGLImageTextures->displayLut()->bindToActiveTexture();
+                d->displayShader->setUniformValue(d->displayShader->location(Uniform::Texture2), 2);
+            }
+
+            glActiveTexture(GL_TEXTURE0);
+
+            const int currentLodPlane = tile->bindToActiveTexture(d->lodSwitchInProgress, mipmapsAreSampled);
+
+            if (d->displayShader->location(Uniform::FixedLodLevel) >= 0) {
+                d->displayShader->setUniformValue(d->displayShader->location(Uniform::FixedLodLevel),
+                                                  (GLfloat) currentLodPlane);
+            }
+
+            if (currentLodPlane > 0) {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+            } else if (SCALE_MORE_OR_EQUAL_TO(scaleX, scaleY, 2.0)) {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            } else {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+                switch(d->filterMode) {
+                case KisOpenGL::NearestFilterMode:
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                    break;
+                case KisOpenGL::BilinearFilterMode:
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    break;
+                case KisOpenGL::TrilinearFilterMode:
+                    // the deferred mipmap may be incomplete, don't refer to it
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                                    mipmapsAreSampled ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+                    break;
+                case KisOpenGL::HighQualityFiltering:
+                    if (SCALE_LESS_THAN(scaleX, scaleY, 0.5)) {
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+                    } else {
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    }
+                    break;
+                }
+            }
+
+            glDrawArrays(GL_TRIANGLES, firstVertex, 6);
+        }
+    }
+
+    if (useTileGrid) {
+        d->quadVAO.bind();
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    d->displayShader->release();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisable(GL_BLEND);
+}
+
+bool KisOpenGLCanvasRenderer::updateTileGrid(int minColumn, int maxColumn, int minRow, int maxRow)
+{
+    const QRect imageBounds = d->openGLImageTextures->storedImageBounds();
+
+    KisTextureTile *firstTile = d->openGLImageTextures->getTextureTileCR(minColumn, minRow);
+    if (!firstTile) return false;
+
+    /**
+     * The tiles are recreated when the image is resized or the texture
+     * settings change, the first tile is enough to notice that
+     */
+    if (imageBounds == d->tileGridImageBounds &&
+        firstTile->tileRectInImagePixels() == d->tileGridFirstTileRect &&
+        firstTile->tileRectInTexturePixels() == d->tileGridFirstTileTextureRect) {
+
+        return true;
+    }
+
+    const int numTiles = (maxColumn - minColumn + 1) * (maxRow - minRow + 1);
+
+    QVector<QVector3D> vertices(6 * numTiles);
+    QVector<QVector2D> texCoords(6 * numTiles);
+
+    int tileIndex = 0;
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minColumn; col <= maxColumn; col++) {
+            KisTextureTile *tile = d->openGLImageTextures->getTextureTileCR(col, row);
+            if (!tile) return false;
+
+            rectToVertices(vertices.data() + 6 * tileIndex, tile->tileRectInImagePixels());
+            rectToTexCoords(texCoords.data() + 6 * tileIndex, tile->tileRectInTexturePixels());
+            tileIndex++;
+        }
+    }
+
+    d->tileGridBuffers[0].bind();
+    d->tileGridBuffers[0].allocate(vertices.constData(), vertices.size() * 3 * sizeof(float));
+
+    d->tileGridBuffers[1].bind();
+    d->tileGridBuffers[1].allocate(texCoords.constData(), texCoords.size() * 2 * sizeof(float));
+
+    d->tileGridImageBounds = imageBounds;
+    d->tileGridFirstTileRect = firstTile->tileRectInImagePixels();
+    d->tileGridFirstTileTextureRect = firstTile->tileRectInTexturePixels();
+
+    return true;
+}
+
+QSize KisOpenGLCanvasRenderer::viewportDevicePixelSize() const
+{
+    // This is how QOpenGLCanvas sets the FBO and the viewport size. If
+    // devicePixelRatioF() is non-integral, the result is truncated.
+    const qreal ratio = d->canvasBridge->devicePixelRatioF();
+    int viewportWidth = static_cast<int>(d->widgetSize.width() * ratio);
+    int viewportHeight = static_cast<int>(d->widgetSize.height() * ratio);
+    return QSize(viewportWidth, viewportHeight);
+}
+
+QSizeF KisOpenGLCanvasRenderer::widgetSizeAlignedToDevicePixel() const
+{
+    const qreal ratio = d->canvasBridge->devicePixelRatioF();
+    QSize viewportSize = viewportDevicePixelSize();
+    qreal scaledWidth = viewportSize.width() / ratio;
+    qreal scaledHeight = viewportSize.height() / ratio;
+    return QSizeF(scaledWidth, scaledHeight);
+}
+
+void KisOpenGLCanvasRenderer::updateConfig()
+{
+    KisConfig cfg(true);
+    d->checkSizeScale = KisOpenGLImageTextures::BACKGROUND_TEXTURE_CHECK_SIZE / static_cast<GLfloat>(cfg.checkSize());
+    d->scrollCheckers = cfg.scrollCheckers();
+
+    d->openGLImageTextures->generateCheckerTexture(KisCanvasWidgetBase::createCheckersImage(cfg.checkSize()));
+    d->openGLImageTextures->updateConfig(cfg.useOpenGLTextureBuffer(), cfg.numMipmapLevels());
+    d->filterMode = (KisOpenGL::FilterMode) cfg.openGLFilteringMode();
+    d->useProjectionPyramid = cfg.useOpenGLProjectionPyramid();
+    d->numMipmapLevels = cfg.numMipmapLevels();
+
+    d->cursorColor = cfg.getCursorMainColor();
+}
+
+void KisOpenGLCanvasRenderer::updatePixelGridMode()
+{
+    KisConfig cfg(true);
+
+    d->pixelGridDrawingThreshold = cfg.getPixelGridDrawingThreshold();
+    d->pixelGridEnabled = cfg.pixelGridEnabled();
+    d->gridColor = cfg.getPixelGridColor();
+}
+
+void KisOpenGLCanvasRenderer::renderCanvasGL(const QRect &updateRect)
+{
+    if ((d->displayFilter && d->displayFilter->updateShader()) ||
+        (bool(d->displayFilter) != d->displayShaderCompiledWithDisplayFilterSupport) ||
+        (d->openGLImageTextures->displayShaderProgram() != d->displayShaderColorProgram)) {
+
+        KIS_SAFE_ASSERT_RECOVER_NOOP(d->canvasInitialized);
+
+        d->canvasInitialized = false; // TODO: check if actually needed?
+        initializeDisplayShader();
+        d->canvasInitialized = true;
+    }
+
+    if (KisOpenGL::hasOpenGL3()) {
+        d->quadVAO.bind();
+    }
+
+    if (!updateRect.isEmpty()) {
+        const qreal ratio = d->canvasBridge->devicePixelRatioF();
+        const QRect deviceUpdateRect = QRectF(updateRect.x() * ratio,
+                                              (d->widgetSize.height() - updateRect.y() - updateRect.height()) * ratio,
+                                              updateRect.width() * ratio,
+                                              updateRect.height() * ratio).toAlignedRect();
+
+        glScissor(deviceUpdateRect.x(), deviceUpdateRect.y(), deviceUpdateRect.width(), deviceUpdateRect.height());
+        glEnable(GL_SCISSOR_TEST);
+    }
+
+    drawBackground(updateRect);
+    drawCheckers(updateRect);
+    drawImage(updateRect);
+
+    if ((coordinatesConverter()->effectiveZoom() > d->pixelGridDrawingThreshold - 0.00001) && d->pixelGridEnabled) {
+        drawGrid(updateRect);
+    }
+
+    if (!updateRect.isEmpty()) {
+        glDisable(GL_SCISSOR_TEST);
+    }
+
+    if (KisOpenGL::hasOpenGL3()) {
+        d->quadVAO.release();
+    }
+}
+
+void KisOpenGLCanvasRenderer::setDisplayColorConverter(KisDisplayColorConverter *colorConverter)
+{
+    d->openGLImageTextures->setMonitorProfile(colorConverter->openGLCanvasSurfaceProfile(),
+                                              colorConverter->renderingIntent(),
+                                              colorConverter->conversionFlags());
+}
+
+void KisOpenGLCanvasRenderer::channelSelectionChanged(const QBitArray &channelFlags)
+{
+    d->openGLImageTextures->setChannelFlags(channelFlags);
+}
+
+void KisOpenGLCanvasRenderer::finishResizingImage(qint32 w, qint32 h)
+{
+    if (d->canvasInitialized) {
+        d->openGLImageTextures->slotImageSizeChanged(w, h);
+    }
+}
+
+KisUpdateInfoSP KisOpenGLCanvasRenderer::startUpdateCanvasProjection(const QRect & rc, const QBitArray &channelFlags)
+{
+    d->openGLImageTextures->setChannelFlags(channelFlags);
+    if (canvas()->proofingConfigUpdated()) {
+        d->openGLImageTextures->setProofingConfig(canvas()->proofingConfiguration());
+        canvas()->setProofingConfigUpdated(false);
+    }
+    return d->openGLImageTextures->updateCanvasCache(rc);
+}
+
+QRect KisOpenGLCanvasRenderer::updateCanvasProjection(KisUpdateInfoSP info)
+{
+    // See KisQPainterCanvas::updateCanvasProjection for more info
+    bool isOpenGLUpdateInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
+    if (isOpenGLUpdateInfo) {
+        d->openGLImageTextures->recalculateCache(info, d->lodSwitchInProgress);
+    }
+
+    // the dirty rect is in widget coordinates, it is used as a scissor
+    // rect in renderCanvasGL(), so only the changed area is repainted
+    const QRect dirty = kisGrowRect(coordinatesConverter()->imageToWidget(info->dirtyImageRect()).toAlignedRect(), 2);
+    return dirty;
+}
+
+KisOpenGLImageTexturesSP KisOpenGLCanvasRenderer::openGLImageTextures() const
+{
+    return d->openGLImageTextures;
+}
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPENGLCANVASRENDERER_H
+#define KISOPENGLCANVASRENDERER_H
+
+#ifndef Q_OS_MACOS
+#include <QOpenGLFunctions>
+#else
+#include <QOpenGLFunctions_3_2_Core>
+#endif
+
+#include "opengl/kis_opengl_image_textures.h"
+
+#include "kritaui_export.h"
+#include "kis_ui_types.h"
+
+class KisCanvas2;
+class KisCoordinatesConverter;
+class KisDisplayColorConverter;
+class KisDisplayFilter;
+class QOpenGLContext;
+class QPainterPath;
+
+#ifndef Q_MOC_RUN
+#ifndef Q_OS_MACOS
+#define GLFunctions QOpenGLFunctions
+#else
+#define GLFunctions QOpenGLFunctions_3_2_Core
+#endif
+#endif
+
+/**
+ * KisOpenGLCanvasRenderer renders the image textures, the checkers
+ * background, the pixel grid and the tool outlines of the canvas.
+ *
+ * The renderer doesn't know anything about the surface it paints on.
+ * Everything it needs from the canvas is requested through the
+ * CanvasBridge interface, so the same renderer and texture tiles of
+ * KisOpenGLImageTextures can be hosted by any widget providing an OpenGL
+ * context. All the rendering calls should be done with that context
+ * being current.
+ */
+class KRITAUI_EXPORT KisOpenGLCanvasRenderer
+#ifndef Q_MOC_RUN
+        : protected GLFunctions
+#endif
+{
+public:
+    /**
+     * The interface of the surface the renderer paints on
+     */
+    class CanvasBridge
+    {
+    public:
+        virtual ~CanvasBridge() {}
+
+        virtual KisCanvas2 *canvas() const = 0;
+        virtual QOpenGLContext *openglContext() const = 0;
+        virtual qreal devicePixelRatioF() const = 0;
+        virtual KisCoordinatesConverter *coordinatesConverter() const = 0;
+        virtual QColor borderColor() const = 0;
+    };
+
+public:
+    KisOpenGLCanvasRenderer(CanvasBridge *canvasBridge, KisImageWSP image, KisDisplayColorConverter *colorConverter);
+    ~KisOpenGLCanvasRenderer();
+
+    void initializeGL();
+
+    /**
+     * Resizes the viewport of the renderer, \p width and \p height
+     * are the size of the surface in logical pixels
+     */
+    void resizeGL(int width, int height);
+
+    /**
+     * Paints the background, the image and the pixel grid into
+     * \p updateRect of the surface. An empty rect means the whole
+     * surface.
+     */
+    void paintCanvasOnly(const QRect &updateRect);
+
+    void paintToolOutline(const QPainterPath &path);
+
+    QSizeF widgetSizeAlignedToDevicePixel() const;
+
+public:
+    void setDisplayFilter(QSharedPointer<KisDisplayFilter> displayFilter);
+    void setDisplayFilterImpl(QSharedPointer<KisDisplayFilter> displayFilter, bool initializing);
+    void notifyImageColorSpaceChanged(const KoColorSpace *cs);
+
+    void setWrapAroundViewingMode(bool value);
+    bool wrapAroundViewingMode() const;
+
+    void channelSelectionChanged(const QBitArray &channelFlags);
+    void setDisplayColorConverter(KisDisplayColorConverter *colorConverter);
+    void finishResizingImage(qint32 w, qint32 h);
+    KisUpdateInfoSP startUpdateCanvasProjection(const QRect & rc, const QBitArray &channelFlags);
+    QRect updateCanvasProjection(KisUpdateInfoSP info);
+
+    void setLodResetInProgress(bool value);
+
+    KisOpenGLImageTexturesSP openGLImageTextures() const;
+
+    void updateConfig();
+    void updatePixelGridMode();
+
+private:
+    void renderCanvasGL(const QRect &updateRect);
+
+    void initializeShaders();
+    void initializeDisplayShader();
+
+    void reportFailedShaderCompilation(const QString &context);
+    void drawBackground(const QRect &updateRect);
+    void drawImage(const QRect &updateRect);
+    void drawCheckers(const QRect &updateRect);
+    void drawGrid(const QRect &updateRect);
+    bool updateTileGrid(int minColumn, int maxColumn, int minRow, int maxRow);
+    QSize viewportDevicePixelSize() const;
+
+    KisCanvas2 *canvas() const;
+    KisCoordinatesConverter *coordinatesConverter() const;
+
+private:
+    Q_DISABLE_COPY(KisOpenGLCanvasRenderer)
+
+    struct Private;
+    Private * const d;
+};
+
+#endif // KISOPENGLCANVASRENDERER_H
@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisOpenGLDisplayLut.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+#include <kis_debug.h>
+#include "KisProofingConfiguration.h"
+#include "opengl/kis_texture_tile_update_info.h"
+
+#ifndef GL_TEXTURE_3D
+#define GL_TEXTURE_3D 0x806F
+#endif
+#ifndef GL_TEXTURE_WRAP_R
+#define GL_TEXTURE_WRAP_R 0x8072
+#endif
+#ifndef GL_RGB16F
+#define GL_RGB16F 0x881B
+#endif
+
+
+struct KisOpenGLDisplayLut::Private
+{
+    mutable QMutex mutex;
+
+    int gridSize = 0;
+    bool useShaper = false;
+    QVector<float> table;
+    bool tableDirty = false;
+
+    GLuint texture = 0;
+    int textureGridSize = 0;
+};
+
+KisOpenGLDisplayLut::KisOpenGLDisplayLut()
+    : m_d(new Private)
+{
+}
+
+KisOpenGLDisplayLut::~KisOpenGLDisplayLut()
+{
+    if (m_d->texture) {
+        QOpenGLContext *ctx = QOpenGLContext::currentContext();
+        KIS_SAFE_ASSERT_RECOVER_RETURN(ctx);
+
+        ctx->functions()->glDeleteTextures(1, &m_d->texture);
+    }
+}
+
+bool KisOpenGLDisplayLut::isSupported(const KoColorSpace *srcColorSpace)
+{
+    return srcColorSpace->colorModelId() == RGBAColorModelID;
+}
+
+void KisOpenGLDisplayLut::setTransform(const KoColorSpace *srcColorSpace,
+                                       const KoColorProfile *monitorProfile,
+                                       KoColorConversionTransformation::Intent renderingIntent,
+                                       KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                       KisProofingConfigurationSP proofingConfig,
+                                       int gridSize)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(isSupported(srcColorSpace));
+    KIS_SAFE_ASSERT_RECOVER_RETURN(gridSize > 1);
+
+    const bool useShaper =
+        srcColorSpace->colorDepthId() == Float16BitsColorDepthID ||
+        srcColorSpace->colorDepthId() == Float32BitsColorDepthID;
+
+    // the table is sampled in float to avoid any rounding of the grid
+    const KoColorSpace *gridSrcCs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                     Float32BitsColorDepthID.id(),
+                                                     srcColorSpace->profile());
+    const KoColorSpace *gridDstCs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                     Float32BitsColorDepthID.id(),
+                                                     monitorProfile);
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(gridSrcCs && gridDstCs);
+
+    const int numPixels = gridSize * gridSize * gridSize;
+    QVector<float> src(4 * numPixels);
+    QVector<float> dst(4 * numPixels);
+
+    QVector<float> gridValues(gridSize);
+    for (int i = 0; i < gridSize; i++) {
+        const float value = float(i) / (gridSize - 1);
+        gridValues[i] = useShaper ? value * value : value;
+    }
+
+    // the red channel is the fastest one, as the texture expects
+    float *srcPtr = src.data();
+    for (int b = 0; b < gridSize; b++) {
+        for (int g = 0; g < gridSize; g++) {
+            for (int r = 0; r < gridSize; r++) {
+                *srcPtr++ = gridValues[r];
+                *srcPtr++ = gridValues[g];
+                *srcPtr++ = gridValues[b];
+                *srcPtr++ = 1.0f;
+            }
+        }
+    }
+
+    const quint8 *srcBytes = reinterpret_cast<const quint8*>(src.constData());
+    quint8 *dstBytes = reinterpret_cast<quint8*>(dst.data());
+
+    if (proofingConfig &&
+        proofingConfig->conversionFlags.testFlag(KoColorConversionTransformation::SoftProofing)) {
+
+        const KoColorSpace *proofingSpace =
+            KoColorSpaceRegistry::instance()->colorSpace(proofingConfig->proofingModel,
+                                                         proofingConfig->proofingDepth,
+                                                         proofingConfig->proofingProfile);
+
+        QScopedPointer<KoColorConversionTransformation> transform(
+            KisTextureTileUpdateInfo::generateProofingTransform(gridSrcCs, gridDstCs, proofingSpace,
+                                                                renderingIntent,
+                                                                proofingConfig->intent,
+                                                                proofingConfig->conversionFlags,
+                                                                proofingConfig->warningColor,
+                                                                proofingConfig->adaptationState));
+
+        gridSrcCs->proofPixelsTo(srcBytes, dstBytes, numPixels, transform.data());
+    } else {
+        gridSrcCs->convertPixelsTo(srcBytes, dstBytes, gridDstCs, numPixels,
+                                   renderingIntent, conversionFlags);
+    }
+
+    QVector<float> table(3 * numPixels);
+    const float *dstPtr = dst.constData();
+    float *tablePtr = table.data();
+    for (int i = 0; i < numPixels; i++) {
+        *tablePtr++ = *dstPtr++;
+        *tablePtr++ = *dstPtr++;
+        *tablePtr++ = *dstPtr++;
+        dstPtr++;
+    }
+
+    QMutexLocker l(&m_d->mutex);
+    m_d->gridSize = gridSize;
+    m_d->useShaper = useShaper;
+    m_d->table.swap(table);
+    m_d->tableDirty = true;
+}
+
+void KisOpenGLDisplayLut::reset()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->gridSize = 0;
+    m_d->useShaper = false;
+    m_d->table.clear();
+    m_d->tableDirty = false;
+}
+
+bool KisOpenGLDisplayLut::isActive() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->gridSize > 0;
+}
+
+QByteArray KisOpenGLDisplayLut::shaderProgram() const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    QByteArray program;
+    if (m_d->gridSize <= 0) return program;
+
+    program.append("#define USE_DISPLAY_LUT\n");
+    program.append(QByteArray("#define DISPLAY_LUT_SIZE ") +
+                   QByteArray::number(m_d->gridSize) + ".0\n");
+    if (m_d->useShaper) {
+        program.append("#define DISPLAY_LUT_SHAPER\n");
+    }
+
+    return program;
+}
+
+void KisOpenGLDisplayLut::bindToActiveTexture()
+{
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(ctx);
+
+    QOpenGLExtraFunctions *f = ctx->extraFunctions();
+
+    if (!m_d->texture) {
+        f->glGenTextures(1, &m_d->texture);
+    }
+
+    f->glBindTexture(GL_TEXTURE_3D, m_d->texture);
+
+    QMutexLocker l(&m_d->mutex);
+    if (!m_d->tableDirty) return;
+
+    const int gridSize = m_d->gridSize;
+
+    if (gridSize != m_d->textureGridSize) {
+        f->glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        f->glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        f->glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        f->glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        f->glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        f->glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB16F,
+                        gridSize, gridSize, gridSize,
+                        0, GL_RGB, GL_FLOAT, m_d->table.constData());
+        m_d->textureGridSize = gridSize;
+    } else {
+        f->glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0,
+                           gridSize, gridSize, gridSize,
+                           GL_RGB, GL_FLOAT, m_d->table.constData());
+    }
+
+    m_d->tableDirty = false;
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISOPENGLDISPLAYLUT_H
+#define KISOPENGLDISPLAYLUT_H
+
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <KoColorConversionTransformation.h>
+
+class KoColorSpace;
+class KoColorProfile;
+
+class KisProofingConfiguration;
+typedef QSharedPointer<KisProofingConfiguration> KisProofingConfigurationSP;
+
+/**
+ * The display and soft-proofing conversions of the image to the monitor
+ * profile baked into a 3D texture, which is sampled by the display shader
+ * of the canvas.
+ *
+ * When the lookup table is active, the texture tiles are uploaded in the
+ * color space of the image and no color conversion happens on the CPU.
+ * The table is sampled with the RGB values of the image, so it works for
+ * RGB images only. The floating point images are sampled in the square
+ * root space to keep the precision in the shadows of the linear data.
+ *
+ * The table is baked in setTransform(), which can be called from any
+ * thread, and uploaded lazily in the GUI thread on the next binding.
+ */
+class KisOpenGLDisplayLut
+{
+public:
+    KisOpenGLDisplayLut();
+    ~KisOpenGLDisplayLut();
+
+    /**
+     * \return true if the image color space can be converted with the table
+     */
+    static bool isSupported(const KoColorSpace *srcColorSpace);
+
+    /**
+     * Bakes the conversion of \p srcColorSpace into \p monitorProfile into
+     * a table with \p gridSize samples per channel. When \p proofingConfig
+     * has soft-proofing enabled, the proofing transform is baked instead.
+     */
+    void setTransform(const KoColorSpace *srcColorSpace,
+                      const KoColorProfile *monitorProfile,
+                      KoColorConversionTransformation::Intent renderingIntent,
+                      KoColorConversionTransformation::ConversionFlags conversionFlags,
+                      KisProofingConfigurationSP proofingConfig,
+                      int gridSize);
+
+    /**
+     * Deactivates the table, the tiles are converted on the CPU again
+     */
+    void reset();
+
+    bool isActive() const;
+
+    /**
+     * \return the defines the display shader should be compiled with
+     * to sample the table, or an empty array if the table is not active
+     */
+    QByteArray shaderProgram() const;
+
+    /**
+     * Uploads the pending table and binds it to the 3D target of the
+     * active texture unit. Should be called in the GUI thread with the
+     * canvas context being current.
+     */
+    void bindToActiveTexture();
+
+private:
+    Q_DISABLE_COPY(KisOpenGLDisplayLut)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISOPENGLDISPLAYLUT_H
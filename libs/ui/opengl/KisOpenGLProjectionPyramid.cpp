@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisOpenGLProjectionPyramid.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
+#include <QVector>
+
+#include <KoColorSpace.h>
+
+#include <kis_debug.h>
+#include "kis_paint_device.h"
+#include "kis_lod_transform.h"
+
+
+struct KisOpenGLProjectionPyramid::Private
+{
+    QMutex mutex;
+
+    /**
+     * planes[i] and dirtyRegions[i] belong to the level i + 1, the
+     * level 0 is the projection itself
+     */
+    QVector<KisPaintDeviceSP> planes;
+    QVector<QRegion> dirtyRegions;
+
+    const KoColorSpace *colorSpace = 0;
+    QRect imageBounds;
+};
+
+KisOpenGLProjectionPyramid::KisOpenGLProjectionPyramid()
+    : m_d(new Private)
+{
+}
+
+KisOpenGLProjectionPyramid::~KisOpenGLProjectionPyramid()
+{
+}
+
+void KisOpenGLProjectionPyramid::setDirty(const QRect &rect)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    for (auto it = m_d->dirtyRegions.begin(); it != m_d->dirtyRegions.end(); ++it) {
+        *it += rect;
+    }
+}
+
+void KisOpenGLProjectionPyramid::reset()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->planes.clear();
+    m_d->dirtyRegions.clear();
+    m_d->colorSpace = 0;
+    m_d->imageBounds = QRect();
+}
+
+KisPaintDeviceSP KisOpenGLProjectionPyramid::plane(KisPaintDeviceSP projection, const QRect &imageBounds,
+                                                   const QRect &rect, int levelOfDetail)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(levelOfDetail > 0, projection);
+
+    QMutexLocker l(&m_d->mutex);
+
+    if (m_d->colorSpace != projection->colorSpace() ||
+        m_d->imageBounds != imageBounds) {
+
+        m_d->planes.clear();
+        m_d->dirtyRegions.clear();
+        m_d->colorSpace = projection->colorSpace();
+        m_d->imageBounds = imageBounds;
+    }
+
+    while (m_d->planes.size() < levelOfDetail) {
+        KisPaintDeviceSP plane = new KisPaintDevice(m_d->colorSpace);
+        plane->setDefaultPixel(projection->defaultPixel());
+
+        m_d->planes.append(plane);
+        m_d->dirtyRegions.append(QRegion(imageBounds));
+    }
+
+    KisPaintDeviceSP plane = m_d->planes[levelOfDetail - 1];
+    QRegion &dirtyRegion = m_d->dirtyRegions[levelOfDetail - 1];
+
+    /**
+     * The plane is downscaled right from the projection, so every
+     * level has a box filter of its own size and doesn't depend on
+     * the state of the other levels
+     */
+    const QRegion updateRegion =
+        dirtyRegion & KisLodTransform::alignedRect(rect & imageBounds, levelOfDetail);
+
+    Q_FOREACH (const QRect &rc, updateRegion.rects()) {
+        projection->generateLodCloneDevice(plane, rc, levelOfDetail);
+    }
+
+    dirtyRegion -= updateRegion;
+
+    return plane;
+}
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISOPENGLPROJECTIONPYRAMID_H
+#define KISOPENGLPROJECTIONPYRAMID_H
+
+#include <QScopedPointer>
+#include <QRect>
+
+#include "kritaui_export.h"
+#include "kis_types.h"
+
+/**
+ * The downscaled copies of the image projection, which are uploaded
+ * into the LodN planes of the texture tiles when the canvas is zoomed
+ * out, instead of sampling the full resolution of the tiles.
+ *
+ * There is one plane per level of detail, the plane of level N keeps
+ * the projection downscaled by 2^N with a box filter, in the coordinates
+ * of that level. The planes are the same as the ones of the image's own
+ * level of detail, so they can be uploaded with the usual LodN updates.
+ *
+ * The changed areas of the projection are tracked for every plane
+ * separately. A plane is created and brought up to date lazily, only
+ * for the areas the canvas fetches at that level, so keeping the
+ * pyramid costs nothing while the canvas is not zoomed out.
+ *
+ * All the methods can be called from any thread.
+ */
+class KRITAUI_EXPORT KisOpenGLProjectionPyramid
+{
+public:
+    KisOpenGLProjectionPyramid();
+    ~KisOpenGLProjectionPyramid();
+
+    /**
+     * Marks \p rect of the projection as changed in all the planes
+     */
+    void setDirty(const QRect &rect);
+
+    /**
+     * Drops all the planes, e.g. when the image is resized
+     */
+    void reset();
+
+    /**
+     * \return the plane of \p levelOfDetail of \p projection, which is
+     * up to date in \p rect, measured in image pixels. \p imageBounds
+     * are the bounds of the image, the planes are reset when they change.
+     */
+    KisPaintDeviceSP plane(KisPaintDeviceSP projection, const QRect &imageBounds,
+                           const QRect &rect, int levelOfDetail);
+
+private:
+    Q_DISABLE_COPY(KisOpenGLProjectionPyramid)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISOPENGLPROJECTIONPYRAMID_H
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisOpenGLTexturePool.h"
+
+#include <QHash>
+#include <QList>
+#include <QOpenGLContext>
+
+#include <kis_debug.h>
+#include "kis_texture_tile.h"
+
+#ifndef GL_UNSIGNED_SHORT
+#define GL_UNSIGNED_SHORT 0x1403
+#endif
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+
+namespace {
+
+/**
+ * The idle textures are real video memory, so keep just enough
+ * of them to recreate the tiles of a usual canvas
+ */
+const qint64 maxPooledTexturesSize = 256 * 1024 * 1024;
+
+struct PooledTexture {
+    GLint width;
+    GLint height;
+    GLint internalFormat;
+    GLint format;
+    GLint type;
+    GLuint texture;
+
+    bool matches(const KisGLTexturesInfo *info) const {
+        return width == info->width &&
+            height == info->height &&
+            internalFormat == info->internalFormat &&
+            format == info->format &&
+            type == info->type;
+    }
+};
+
+qint64 estimateTextureSize(const PooledTexture &texture)
+{
+    int channelSize = 1;
+
+    switch (texture.type) {
+    case GL_UNSIGNED_SHORT:
+    case GL_HALF_FLOAT:
+        channelSize = 2;
+        break;
+    case GL_FLOAT:
+        channelSize = 4;
+        break;
+    default:
+        break;
+    }
+
+    // all the tiles are RGBA and may have a mipmap chain allocated
+    return qint64(texture.width) * texture.height * 4 * channelSize * 4 / 3;
+}
+
+typedef QHash<QOpenGLContextGroup*, KisOpenGLTexturePool*> PoolsMap;
+Q_GLOBAL_STATIC(PoolsMap, s_pools)
+
+}
+
+struct KisOpenGLTexturePool::Private
+{
+    QList<PooledTexture> textures;
+    qint64 texturesSize = 0;
+};
+
+KisOpenGLTexturePool* KisOpenGLTexturePool::forContext(QOpenGLContext *ctx)
+{
+    QOpenGLContextGroup *group = ctx->shareGroup();
+
+    KisOpenGLTexturePool *pool = s_pools->value(group, 0);
+
+    if (!pool) {
+        pool = new KisOpenGLTexturePool();
+        s_pools->insert(group, pool);
+
+        // the textures are deleted together with the group
+        QObject::connect(group, &QObject::destroyed,
+                         [group] () {
+                             if (s_pools.exists()) {
+                                 delete s_pools->take(group);
+                             }
+                         });
+    }
+
+    return pool;
+}
+
+KisOpenGLTexturePool::KisOpenGLTexturePool()
+    : m_d(new Private)
+{
+}
+
+KisOpenGLTexturePool::~KisOpenGLTexturePool()
+{
+}
+
+GLuint KisOpenGLTexturePool::acquire(const KisGLTexturesInfo *info)
+{
+    // the most recently released textures are the most likely to be warm
+    for (int i = m_d->textures.size() - 1; i >= 0; i--) {
+        if (m_d->textures[i].matches(info)) {
+            const PooledTexture texture = m_d->textures.takeAt(i);
+            m_d->texturesSize -= estimateTextureSize(texture);
+            return texture.texture;
+        }
+    }
+
+    return 0;
+}
+
+void KisOpenGLTexturePool::release(GLuint texture, const KisGLTexturesInfo *info)
+{
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(ctx);
+
+    PooledTexture pooledTexture;
+    pooledTexture.width = info->width;
+    pooledTexture.height = info->height;
+    pooledTexture.internalFormat = info->internalFormat;
+    pooledTexture.format = info->format;
+    pooledTexture.type = info->type;
+    pooledTexture.texture = texture;
+
+    m_d->textures.append(pooledTexture);
+    m_d->texturesSize += estimateTextureSize(pooledTexture);
+
+    while (m_d->texturesSize > maxPooledTexturesSize && !m_d->textures.isEmpty()) {
+        const PooledTexture oldest = m_d->textures.takeFirst();
+        m_d->texturesSize -= estimateTextureSize(oldest);
+        ctx->functions()->glDeleteTextures(1, &oldest.texture);
+    }
+}
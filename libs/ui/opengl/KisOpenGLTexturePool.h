@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISOPENGLTEXTUREPOOL_H
+#define KISOPENGLTEXTUREPOOL_H
+
+#include <QScopedPointer>
+// no forward-declaration, used to get GL* primitive types defined
+#include <QOpenGLFunctions>
+
+class QOpenGLContext;
+struct KisGLTexturesInfo;
+
+/**
+ * A pool of the texture objects of the canvas tiles.
+ *
+ * The tiles give their textures back to the pool when they are evicted
+ * or destroyed, that is, when the image is resized, its color space is
+ * changed or the view is closed. The next tiles with the same size and
+ * format take the textures from the pool instead of asking the driver to
+ * allocate new storage.
+ *
+ * There is one pool per share group of the contexts, so all the canvases
+ * of Krita reuse the same textures. The pool keeps only a limited amount
+ * of idle textures, the oldest ones are deleted when the limit is reached.
+ *
+ * The level 0 of every pooled texture has the storage of the full tile
+ * size allocated, the content of the texture is undefined.
+ */
+class KisOpenGLTexturePool
+{
+public:
+    /**
+     * \return the pool of the share group of \p ctx. The pool is
+     * destroyed together with the group.
+     */
+    static KisOpenGLTexturePool* forContext(QOpenGLContext *ctx);
+
+    ~KisOpenGLTexturePool();
+
+    /**
+     * \return a texture with the level 0 storage allocated for \p info,
+     * or 0 if there is no idle texture of this size and format
+     */
+    GLuint acquire(const KisGLTexturesInfo *info);
+
+    /**
+     * Puts the \p texture allocated for \p info into the pool. Should be
+     * called with a context of the share group being current.
+     */
+    void release(GLuint texture, const KisGLTexturesInfo *info);
+
+private:
+    KisOpenGLTexturePool();
+    Q_DISABLE_COPY(KisOpenGLTexturePool)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISOPENGLTEXTUREPOOL_H
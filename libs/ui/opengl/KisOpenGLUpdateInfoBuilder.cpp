@@ -10,6 +10,7 @@
 #include "opengl/kis_texture_tile_info_pool.h"
 
 #include "KisProofingConfiguration.h"
+#include <KoLut3DColorConversionTransformation.h>
 
 #include <QReadWriteLock>
 #include <QReadLocker>
@@ -29,6 +30,7 @@ struct KRITAUI_NO_EXPORT KisOpenGLUpdateInfoBuilder::Private
 
     KisProofingConfigurationSP proofingConfig;
     QScopedPointer<KoColorConversionTransformation> proofingTransform;
+    QScopedPointer<KoColorConversionTransformation> displayTransform;
 
     KisTextureTileInfoPoolSP pool;
     QReadWriteLock lock;
@@ -66,6 +68,18 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                 m_d->proofingConfig->conversionFlags.testFlag(KoColorConversionTransformation::SoftProofing);
         };
 
+    auto needCreateDisplayTransform =
+        [this, projection] () {
+            const KoColorSpace *srcCs = projection->colorSpace();
+            const KoColorSpace *dstCs = m_d->conversionOptions.m_destinationColorSpace;
+
+            return m_d->conversionOptions.m_lutGridSize > 0 &&
+                !m_d->proofingTransform &&
+                (!m_d->displayTransform || !(*m_d->displayTransform->srcColorSpace() == *srcCs)) &&
+                !(*srcCs == *dstCs) &&
+                KoLut3DColorConversionTransformation::isSupported(srcCs, dstCs);
+        };
+
     // lazily create transform
     if (convertColorSpace && needCreateProofingTransform()) {
 
@@ -84,6 +98,34 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                                              m_d->proofingConfig->conversionFlags,
                                              m_d->proofingConfig->warningColor,
                                              m_d->proofingConfig->adaptationState));
+
+            /**
+             * Proofing transforms are expensive, so bake them into a
+             * lookup table when the user allowed that
+             */
+            if (m_d->conversionOptions.m_lutGridSize > 0) {
+                KoColorConversionTransformation *lut =
+                    KoLut3DColorConversionTransformation::create(m_d->proofingTransform.data(),
+                                                                 m_d->conversionOptions.m_lutGridSize);
+                if (lut) {
+                    m_d->proofingTransform.reset(lut);
+                }
+            }
+        }
+    }
+
+    if (convertColorSpace && needCreateDisplayTransform()) {
+
+        QWriteLocker locker(&m_d->lock);
+        if (needCreateDisplayTransform()) {
+            QScopedPointer<KoColorConversionTransformation> transform(
+                projection->colorSpace()->createColorConverter(m_d->conversionOptions.m_destinationColorSpace,
+                                                               m_d->conversionOptions.m_renderingIntent,
+                                                               m_d->conversionOptions.m_conversionFlags));
+
+            m_d->displayTransform.reset(
+                KoLut3DColorConversionTransformation::create(transform.data(),
+                                                             m_d->conversionOptions.m_lutGridSize));
         }
     }
 
@@ -114,6 +156,11 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
         channelFlags = m_d->channelFlags;
     }
 
+    const KoColorConversionTransformation *displayTransform =
+        m_d->displayTransform &&
+        *m_d->displayTransform->srcColorSpace() == *projection->colorSpace() ?
+            m_d->displayTransform.data() : 0;
+
     qint32 numItems = (lastColumn - firstColumn + 1) * (lastRow - firstRow + 1);
     info->tileList.reserve(numItems);
 
@@ -144,6 +191,8 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                 if (convertColorSpace) {
                     if (m_d->proofingTransform) {
                         tileInfo->proofTo(m_d->conversionOptions.m_destinationColorSpace, m_d->proofingConfig->conversionFlags, m_d->proofingTransform.data());
+                    } else if (displayTransform) {
+                        tileInfo->convertTo(m_d->conversionOptions.m_destinationColorSpace, displayTransform);
                     } else {
                         tileInfo->convertTo(m_d->conversionOptions.m_destinationColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags);
                     }
@@ -206,6 +255,8 @@ void KisOpenGLUpdateInfoBuilder::setConversionOptions(const ConversionOptions &o
     QWriteLocker lock(&m_d->lock);
 
     m_d->conversionOptions = options;
+    m_d->displayTransform.reset();
+    m_d->proofingTransform.reset();
 }
 
 void KisOpenGLUpdateInfoBuilder::setChannelFlags(const QBitArray &channelFrags, bool onlyOneChannelSelected, int selectedChannelIndex)
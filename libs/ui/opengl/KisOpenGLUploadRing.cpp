@@ -0,0 +1,254 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisOpenGLUploadRing.h"
+
+#include <cstring>
+
+#include <QOpenGLContext>
+#include <QVector>
+
+#include <kis_debug.h>
+#include "kis_opengl.h"
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D
+#endif
+
+namespace {
+
+typedef void* (QOPENGLF_APIENTRYP kis_glMapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+typedef GLboolean (QOPENGLF_APIENTRYP kis_glUnmapBuffer)(GLenum);
+typedef void (QOPENGLF_APIENTRYP kis_glBufferStorage)(GLenum, GLsizeiptr, const void*, GLbitfield);
+typedef GLsync (QOPENGLF_APIENTRYP kis_glFenceSync)(GLenum, GLbitfield);
+typedef GLenum (QOPENGLF_APIENTRYP kis_glClientWaitSync)(GLsync, GLbitfield, GLuint64);
+typedef void (QOPENGLF_APIENTRYP kis_glDeleteSync)(GLsync);
+
+const int numSegments = 4;
+
+/**
+ * Every upload starts at the aligned offset, which is enough
+ * for any pixel type used by the textures
+ */
+const int dataAlignment = 64;
+
+/**
+ * The number of the biggest uploads fitting into a segment. Fewer
+ * and bigger segments mean fewer fences to wait for.
+ */
+const int uploadsPerSegment = 4;
+
+/**
+ * The fences are inserted one segment ahead, so they are usually
+ * signaled long before the segment is reused
+ */
+const GLuint64 fenceTimeout = 1000000000; // 1s
+
+}
+
+struct KisOpenGLUploadRing::Private
+{
+    QOpenGLFunctions *f = 0;
+
+    kis_glMapBufferRange mapBufferRange = 0;
+    kis_glUnmapBuffer unmapBuffer = 0;
+    kis_glBufferStorage bufferStorage = 0;
+    kis_glFenceSync fenceSync = 0;
+    kis_glClientWaitSync clientWaitSync = 0;
+    kis_glDeleteSync deleteSync = 0;
+
+    GLuint buffer = 0;
+    quint8 *persistentData = 0;
+
+    int segmentSize = 0;
+    int currentSegment = 0;
+    int currentOffset = 0;
+    QVector<GLsync> fences;
+};
+
+KisOpenGLUploadRing::KisOpenGLUploadRing(QOpenGLContext *ctx)
+    : m_d(new Private)
+{
+    m_d->f = ctx->functions();
+    m_d->fences.fill(0, numSegments);
+
+    if (!KisOpenGL::supportsFenceSync()) return;
+
+    m_d->mapBufferRange = (kis_glMapBufferRange)ctx->getProcAddress("glMapBufferRange");
+    m_d->unmapBuffer = (kis_glUnmapBuffer)ctx->getProcAddress("glUnmapBuffer");
+    m_d->fenceSync = (kis_glFenceSync)ctx->getProcAddress("glFenceSync");
+    m_d->clientWaitSync = (kis_glClientWaitSync)ctx->getProcAddress("glClientWaitSync");
+    m_d->deleteSync = (kis_glDeleteSync)ctx->getProcAddress("glDeleteSync");
+
+    if (!ctx->isOpenGLES() &&
+        (ctx->format().version() >= qMakePair(4, 4) ||
+         ctx->hasExtension("GL_ARB_buffer_storage"))) {
+
+        m_d->bufferStorage = (kis_glBufferStorage)ctx->getProcAddress("glBufferStorage");
+    }
+
+    if (!isValid()) {
+        warnUI << "Could not find buffer mapping functions, disabling the texture upload ring.";
+    }
+}
+
+KisOpenGLUploadRing::~KisOpenGLUploadRing()
+{
+    destroyBuffer();
+}
+
+bool KisOpenGLUploadRing::isValid() const
+{
+    return m_d->mapBufferRange && m_d->unmapBuffer &&
+        m_d->fenceSync && m_d->clientWaitSync && m_d->deleteSync;
+}
+
+const GLvoid* KisOpenGLUploadRing::upload(const void *data, int size)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(isValid(), data);
+
+    const int alignedSize = (size + dataAlignment - 1) & ~(dataAlignment - 1);
+
+    if (alignedSize > m_d->segmentSize) {
+        allocate(uploadsPerSegment * alignedSize);
+    }
+
+    m_d->f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_d->buffer);
+
+    if (m_d->currentOffset + alignedSize > m_d->segmentSize) {
+        // all the commands reading the current segment are issued already
+        m_d->fences[m_d->currentSegment] = m_d->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        m_d->currentSegment = (m_d->currentSegment + 1) % numSegments;
+        m_d->currentOffset = 0;
+        waitForSegment(m_d->currentSegment);
+    }
+
+    const int offset = m_d->currentSegment * m_d->segmentSize + m_d->currentOffset;
+
+    if (m_d->persistentData) {
+        memcpy(m_d->persistentData + offset, data, size);
+    } else {
+        void *ptr = m_d->mapBufferRange(GL_PIXEL_UNPACK_BUFFER, offset, size,
+                                        GL_MAP_WRITE_BIT |
+                                        GL_MAP_INVALIDATE_RANGE_BIT |
+                                        GL_MAP_UNSYNCHRONIZED_BIT);
+        if (!ptr) {
+            release();
+            return data;
+        }
+
+        memcpy(ptr, data, size);
+        m_d->unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    m_d->currentOffset += alignedSize;
+
+    return reinterpret_cast<const GLvoid*>(static_cast<quintptr>(offset));
+}
+
+void KisOpenGLUploadRing::release()
+{
+    m_d->f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void KisOpenGLUploadRing::allocate(int segmentSize)
+{
+    destroyBuffer();
+
+    const int totalSize = numSegments * segmentSize;
+
+    m_d->f->glGenBuffers(1, &m_d->buffer);
+    m_d->f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_d->buffer);
+
+    if (m_d->bufferStorage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        m_d->bufferStorage(GL_PIXEL_UNPACK_BUFFER, totalSize, 0, flags);
+        m_d->persistentData =
+            static_cast<quint8*>(m_d->mapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, totalSize, flags));
+
+        // the immutable storage can still be mapped for every upload
+        // if the persistent mapping has failed
+    } else {
+        m_d->f->glBufferData(GL_PIXEL_UNPACK_BUFFER, totalSize, 0, GL_STREAM_DRAW);
+    }
+
+    m_d->f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    m_d->segmentSize = segmentSize;
+    m_d->currentSegment = 0;
+    m_d->currentOffset = 0;
+}
+
+void KisOpenGLUploadRing::destroyBuffer()
+{
+    /**
+     * The buffer may still be read by the pending upload commands,
+     * but GL keeps its storage alive until they are completed
+     */
+
+    for (int i = 0; i < m_d->fences.size(); i++) {
+        if (m_d->fences[i]) {
+            m_d->deleteSync(m_d->fences[i]);
+            m_d->fences[i] = 0;
+        }
+    }
+
+    if (m_d->buffer) {
+        if (m_d->persistentData) {
+            m_d->f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_d->buffer);
+            m_d->unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            m_d->f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            m_d->persistentData = 0;
+        }
+
+        m_d->f->glDeleteBuffers(1, &m_d->buffer);
+        m_d->buffer = 0;
+    }
+
+    m_d->segmentSize = 0;
+}
+
+void KisOpenGLUploadRing::waitForSegment(int segment)
+{
+    GLsync &fence = m_d->fences[segment];
+    if (!fence) return;
+
+    const GLenum result = m_d->clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+    if (result == GL_WAIT_FAILED) {
+        warnUI << "Failed to wait for the texture upload fence";
+    }
+
+    m_d->deleteSync(fence);
+    fence = 0;
+}
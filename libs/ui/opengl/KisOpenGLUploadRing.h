@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISOPENGLUPLOADRING_H
+#define KISOPENGLUPLOADRING_H
+
+#include <QScopedPointer>
+// no forward-declaration, used to get GL* primitive types defined
+#include <QOpenGLFunctions>
+
+class QOpenGLContext;
+
+/**
+ * A ring of pixel unpack buffer memory shared by all the texture tiles
+ * of the canvas.
+ *
+ * The tiles copy their update data into the ring and issue the texture
+ * upload commands from it, so the driver doesn't need to reallocate and
+ * synchronize a separate buffer for every uploaded tile.
+ *
+ * The ring is split into segments. When the uploads leave a segment, a
+ * fence is inserted after the upload commands reading it, and the fence
+ * is waited for before the segment is written to again. That is why the
+ * buffer can be mapped without implicit synchronization. When the
+ * context supports buffer storage (GL 4.4 or GL_ARB_buffer_storage),
+ * the buffer is mapped persistently once and never unmapped.
+ *
+ * The ring is valid only when the context supports fence sync and
+ * ranged buffer mapping. Otherwise the tiles upload the data directly.
+ */
+class KisOpenGLUploadRing
+{
+public:
+    KisOpenGLUploadRing(QOpenGLContext *ctx);
+    ~KisOpenGLUploadRing();
+
+    bool isValid() const;
+
+    /**
+     * Copies \p size bytes of \p data into the ring and binds the buffer
+     * to GL_PIXEL_UNPACK_BUFFER. Returns the pointer that should be passed
+     * to the upload command instead of the data, that is, the offset of
+     * the data in the bound buffer.
+     *
+     * Call release() once the upload commands are issued.
+     */
+    const GLvoid* upload(const void *data, int size);
+
+    /**
+     * Unbinds the buffer, so that the following upload commands
+     * read the client memory again
+     */
+    void release();
+
+private:
+    void allocate(int segmentSize);
+    void destroyBuffer();
+    void waitForSegment(int segment);
+
+private:
+    Q_DISABLE_COPY(KisOpenGLUploadRing)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISOPENGLUPLOADRING_H
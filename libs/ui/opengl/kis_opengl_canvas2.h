@@ -9,11 +9,6 @@
 #define KIS_OPENGL_CANVAS_2_H
 
 #include <QOpenGLWidget>
-#ifndef Q_OS_MACOS
-#include <QOpenGLFunctions>
-#else
-#include <QOpenGLFunctions_3_2_Core>
-#endif
 #include "canvas/kis_canvas_widget_base.h"
 #include "opengl/kis_opengl_image_textures.h"
 
@@ -22,29 +17,21 @@
 
 class KisCanvas2;
 class KisDisplayColorConverter;
-class QOpenGLShaderProgram;
 class QPainterPath;
 
-#ifndef Q_MOC_RUN
-#ifndef Q_OS_MACOS
-#define GLFunctions QOpenGLFunctions
-#else
-#define GLFunctions QOpenGLFunctions_3_2_Core
-#endif
-
-#endif
 /**
  * KisOpenGLCanvas is the widget that shows the actual image using OpenGL
  *
+ * The widget handles the events and paints the decorations, the image
+ * itself is rendered by KisOpenGLCanvasRenderer, which accesses the
+ * widget through a bridge interface only.
+ *
  * NOTE: if you change something in the event handling here, also change it
  * in the qpainter canvas.
  *
  */
 class KRITAUI_EXPORT KisOpenGLCanvas2
         : public QOpenGLWidget
-#ifndef Q_MOC_RUN
-        , protected GLFunctions
-#endif
         , public KisCanvasWidgetBase
 {
     Q_OBJECT
@@ -66,7 +53,6 @@ public: // QOpenGLWidget
     void inputMethodEvent(QInputMethodEvent *event) override;
 
 public:
-    void renderCanvasGL(const QRect &updateRect);
     void renderDecorations(const QRect &updateRect);
     void paintToolOutline(const QPainterPath &path);
 
@@ -92,8 +78,6 @@ public: // Implement kis_abstract_canvas_widget interface
     bool isBusy() const override;
     void setLodResetInProgress(bool value) override;
 
-    void setDisplayFilterImpl(QSharedPointer<KisDisplayFilter> displayFilter, bool initializing);
-
     KisOpenGLImageTexturesSP openGLImageTextures() const;
 
 public Q_SLOTS:
@@ -102,23 +86,13 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void slotShowFloatingMessage(const QString &message, int timeout, bool priority);
+    void slotFetchMissingTiles();
 
 protected: // KisCanvasWidgetBase
     bool callFocusNextPrevChild(bool next) override;
 
 private:
-    void initializeShaders();
-    void initializeDisplayShader();
-
-    void reportFailedShaderCompilation(const QString &context);
-    void drawBackground(const QRect &updateRect);
-    void drawImage(const QRect &updateRect);
-    void drawCheckers(const QRect &updateRect);
-    void drawGrid(const QRect &updateRect);
-    QSize viewportDevicePixelSize() const;
-    QSizeF widgetSizeAlignedToDevicePixel() const;
-
-private:
+    class CanvasBridge;
 
     struct Private;
     Private * const d;
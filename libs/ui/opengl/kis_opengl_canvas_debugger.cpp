@@ -22,6 +22,9 @@ struct KisOpenglCanvasDebugger::Private
           fpsSum(0),
           syncFlaggedCounter(0),
           syncFlaggedSum(0),
+          latencyCounter(0),
+          latencySum(0),
+          averageLatency(0),
           isEnabled(true) {}
 
     QElapsedTimer time;
@@ -32,6 +35,10 @@ struct KisOpenglCanvasDebugger::Private
     int syncFlaggedCounter;
     int syncFlaggedSum;
 
+    int latencyCounter;
+    int latencySum;
+    qreal averageLatency;
+
     bool isEnabled;
 };
 
@@ -70,6 +77,11 @@ qreal KisOpenglCanvasDebugger::accumulatedFps()
     return value;
 }
 
+qreal KisOpenglCanvasDebugger::averageFrameLatency()
+{
+    return m_d->averageLatency;
+}
+
 void KisOpenglCanvasDebugger::slotConfigChanged()
 {
     KisConfig cfg(true);
@@ -107,3 +119,17 @@ void KisOpenglCanvasDebugger::nofitySyncStatus(bool isBusy)
         m_d->syncFlaggedCounter = 0;
     }
 }
+
+void KisOpenglCanvasDebugger::nofityFrameLatency(int latency)
+{
+    if (!m_d->isEnabled) return;
+
+    m_d->latencySum += latency;
+    m_d->latencyCounter++;
+
+    if (m_d->latencyCounter >= 30) {
+        m_d->averageLatency = qreal(m_d->latencySum) / m_d->latencyCounter;
+        m_d->latencySum = 0;
+        m_d->latencyCounter = 0;
+    }
+}
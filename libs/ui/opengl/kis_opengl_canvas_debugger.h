@@ -24,7 +24,15 @@ public:
 
     void nofityPaintRequested();
     void nofitySyncStatus(bool value);
+
+    /**
+     * Reports the time in milliseconds between an update of the image
+     * and the swap of the canvas frame showing it
+     */
+    void nofityFrameLatency(int latency);
+
     qreal accumulatedFps();
+    qreal averageFrameLatency();
 
 private Q_SLOTS:
     void slotConfigChanged();
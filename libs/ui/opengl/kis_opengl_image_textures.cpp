@@ -19,6 +19,8 @@
 #include <QApplication>
 #include <QDesktopWidget>
 
+#include <algorithm>
+
 #include <KoColorSpaceRegistry.h>
 #include <KoColorProfile.h>
 #include <KoColorModelStandardIds.h>
@@ -27,6 +29,10 @@
 #include "kis_config.h"
 #include "KisPart.h"
 #include "KisOpenGLModeProber.h"
+#include "KisOpenGLUploadRing.h"
+#include "KisOpenGLDisplayLut.h"
+#include "KisOpenGLTexturePool.h"
+#include "KisOpenGLProjectionPyramid.h"
 #include "kis_fixed_paint_device.h"
 
 #ifdef HAVE_OPENEXR
@@ -56,6 +62,13 @@ KisOpenGLImageTextures::KisOpenGLImageTextures()
     : m_image(0)
     , m_monitorProfile(0)
     , m_internalColorManagementActive(true)
+    , m_texturesMemoryLimit(0)
+    , m_residentTexturesSize(0)
+    , m_currentFrame(0)
+    , m_projectionPyramid(new KisOpenGLProjectionPyramid())
+    , m_preferredLevelOfDetail(0)
+    , m_displayLut(new KisOpenGLDisplayLut())
+    , m_encodeSurfacePQ(false)
     , m_glFuncs(0)
     , m_useOcio(false)
     , m_initialized(false)
@@ -78,6 +91,13 @@ KisOpenGLImageTextures::KisOpenGLImageTextures(KisImageWSP image,
     , m_renderingIntent(renderingIntent)
     , m_conversionFlags(conversionFlags)
     , m_internalColorManagementActive(true)
+    , m_texturesMemoryLimit(0)
+    , m_residentTexturesSize(0)
+    , m_currentFrame(0)
+    , m_projectionPyramid(new KisOpenGLProjectionPyramid())
+    , m_preferredLevelOfDetail(0)
+    , m_displayLut(new KisOpenGLDisplayLut())
+    , m_encodeSurfacePQ(false)
     , m_glFuncs(0)
     , m_useOcio(false)
     , m_initialized(false)
@@ -120,6 +140,8 @@ KisOpenGLImageTextures::~KisOpenGLImageTextures()
     }
 
     destroyImageTextureTiles();
+    m_uploadRing.reset();
+
     if (m_checkerTexture) {
         m_glFuncs->glDeleteTextures(1, &(*m_checkerTexture));
     }
@@ -198,10 +220,21 @@ void KisOpenGLImageTextures::recreateImageTextureTiles()
     KisConfig config(true);
     KisOpenGL::FilterMode mode = (KisOpenGL::FilterMode)config.openGLFilteringMode();
 
+    m_texturesMemoryLimit = qint64(config.openGLTexturesMemoryLimit()) * 1024 * 1024;
+    m_residentTexturesSize = 0;
+    m_missingTiles.clear();
+    m_projectionPyramid->reset();
+
     QOpenGLContext *ctx = QOpenGLContext::currentContext();
     if (ctx) {
         QOpenGLFunctions *f = ctx->functions();
 
+        if (!m_uploadRing) {
+            m_uploadRing.reset(new KisOpenGLUploadRing(ctx));
+        }
+
+        KisOpenGLTexturePool *texturePool = KisOpenGLTexturePool::forContext(ctx);
+
         m_initialized = true;
         dbgUI  << "OpenGL: creating texture tiles of size" << m_texturesInfo.height << "x" << m_texturesInfo.width;
 
@@ -215,6 +248,8 @@ void KisOpenGLImageTextures::recreateImageTextureTiles()
                                                           emptyTileData,
                                                           mode,
                                                           config.useOpenGLTextureBuffer(),
+                                                          m_uploadRing.data(),
+                                                          texturePool,
                                                           config.numMipmapLevels(),
                                                           f);
                 m_textureTiles.append(tile);
@@ -247,6 +282,37 @@ KisOpenGLUpdateInfoSP KisOpenGLImageTextures::updateCacheNoConversion(const QRec
     return updateCacheImpl(rect, m_image, false);
 }
 
+KisOpenGLUpdateInfoSP KisOpenGLImageTextures::updateCanvasCache(const QRect& rect)
+{
+    if (!m_initialized) return new KisOpenGLUpdateInfo();
+
+    KisImageSP image = m_image;
+
+    /**
+     * The image's own LodN updates of the instant preview are uploaded
+     * as they are, the projection has not changed yet
+     */
+    if (image->currentLevelOfDetail() > 0) {
+        return updateCache(rect, image);
+    }
+
+    m_projectionPyramid->setDirty(rect);
+
+    const int levelOfDetail = m_preferredLevelOfDetail.load();
+    if (!levelOfDetail) {
+        return updateCache(rect, image);
+    }
+
+    KisPaintDeviceSP plane =
+        m_projectionPyramid->plane(image->projection(), image->bounds(), rect, levelOfDetail);
+
+    KisOpenGLUpdateInfoSP info =
+        m_updateInfoBuilder.buildUpdateInfo(rect, plane, image->bounds(), levelOfDetail, true);
+    info->assignProjectionPyramidUpdate(true);
+
+    return info;
+}
+
 // TODO: add sanity checks about the conformance of the passed srcImage!
 KisOpenGLUpdateInfoSP KisOpenGLImageTextures::updateCacheImpl(const QRect& rect, KisImageSP srcImage, bool convertColorSpace)
 {
@@ -264,12 +330,200 @@ void KisOpenGLImageTextures::recalculateCache(KisUpdateInfoSP info, bool blockMi
     KisOpenGLUpdateInfoSP glInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
     if(!glInfo) return;
 
+    const bool isPyramidUpdate = glInfo->isProjectionPyramidUpdate();
+
+    /**
+     * The canvas has been zoomed since the update was built, all the
+     * tiles are going to be fetched for the new level anyway
+     */
+    if (isPyramidUpdate && glInfo->levelOfDetail() != m_preferredLevelOfDetail.load()) {
+        return;
+    }
+
     KisTextureTileUpdateInfoSP tileInfo;
     Q_FOREACH (tileInfo, glInfo->tileList) {
         KisTextureTile *tile = getTextureTileCR(tileInfo->tileCol(), tileInfo->tileRow());
         KIS_ASSERT_RECOVER_RETURN(tile);
 
+        if (!tile->isResident()) {
+            // partial updates of the missing tiles are dropped, the
+            // entire tile is fetched when it is painted
+            if (!tileInfo->coversEntireTile() ||
+                !makeTileResident(tile, tileInfo->patchLevelOfDetail() > 0)) {
+
+                continue;
+            }
+        } else if (!tileInfo->coversEntireTile() &&
+                   !tile->canUpdatePartially(tileInfo->patchLevelOfDetail())) {
+
+            // the rest of the plane is outdated, fetch the entire tile instead
+            requestTileRefetch(tile);
+            continue;
+        }
+
         tile->update(*tileInfo, blockMipmapRegeneration);
+
+        if (isPyramidUpdate) {
+            tile->setBaseLevelOutdated(true);
+        }
+    }
+}
+
+void KisOpenGLImageTextures::setPreferredLevelOfDetail(int levelOfDetail)
+{
+    if (m_preferredLevelOfDetail.load() == levelOfDetail) return;
+
+    m_preferredLevelOfDetail.store(levelOfDetail);
+
+    /**
+     * The tiles are fetched for the new level as soon as they are
+     * painted, the requests being in flight are dropped as outdated
+     */
+    Q_FOREACH (KisTextureTile *tile, m_textureTiles) {
+        tile->setResidencyRequested(false);
+        tile->setNeedsRefetch(tile->isResident());
+    }
+}
+
+void KisOpenGLImageTextures::requestTileRefetch(KisTextureTile *tile)
+{
+    tile->setNeedsRefetch(false);
+
+    if (!tile->residencyRequested()) {
+        tile->setResidencyRequested(true);
+        m_missingTiles.append(tile->textureRectInImagePixels() & m_image->bounds());
+    }
+}
+
+void KisOpenGLImageTextures::startFrame(const QRect &visibleImageRect)
+{
+    m_currentFrame++;
+
+    /**
+     * The visible rect keeps its size (up to the rounding) only while
+     * the canvas is panned, the zooming and rotation are not predicted
+     */
+    const QSize sizeDelta = visibleImageRect.size() - m_visibleImageRect.size();
+
+    if (!m_visibleImageRect.isEmpty() &&
+        qAbs(sizeDelta.width()) <= 1 && qAbs(sizeDelta.height()) <= 1 &&
+        visibleImageRect.topLeft() != m_visibleImageRect.topLeft()) {
+
+        prefetchTiles(visibleImageRect, visibleImageRect.topLeft() - m_visibleImageRect.topLeft());
+    }
+
+    m_visibleImageRect = visibleImageRect;
+}
+
+void KisOpenGLImageTextures::prefetchTiles(const QRect &visibleImageRect, const QPoint &offset)
+{
+    /**
+     * The tiles are fetched a few frames ahead of the movement, but
+     * never further than half of the view, so that a single jerk of the
+     * stylus doesn't request the entire image
+     */
+    const int lookAheadFrames = 4;
+
+    const QPoint lookAhead(
+        qBound(-visibleImageRect.width() / 2, offset.x() * lookAheadFrames, visibleImageRect.width() / 2),
+        qBound(-visibleImageRect.height() / 2, offset.y() * lookAheadFrames, visibleImageRect.height() / 2));
+
+    const QRect prefetchRect = visibleImageRect.translated(lookAhead) & m_storedImageBounds;
+    if (prefetchRect.isEmpty()) return;
+
+    for (int row = yToRow(prefetchRect.top()); row <= yToRow(prefetchRect.bottom()); row++) {
+        for (int col = xToCol(prefetchRect.left()); col <= xToCol(prefetchRect.right()); col++) {
+            KisTextureTile *tile = getTextureTileCR(col, row);
+            if (!tile) continue;
+
+            if (!tile->isResident() || tile->needsRefetch()) {
+                // look like a recently painted tile, so it isn't the first to be evicted
+                tile->setLastUsedFrame(m_currentFrame);
+                requestTileRefetch(tile);
+            }
+        }
+    }
+}
+
+bool KisOpenGLImageTextures::requestTileForPainting(KisTextureTile *tile)
+{
+    tile->setLastUsedFrame(m_currentFrame);
+
+    if (tile->isResident()) {
+        // the current content is painted until the new one arrives
+        if (tile->needsRefetch()) {
+            requestTileRefetch(tile);
+        }
+        return true;
+    }
+
+    requestTileRefetch(tile);
+    return false;
+}
+
+QVector<QRect> KisOpenGLImageTextures::takeMissingTiles()
+{
+    QVector<QRect> tiles;
+    std::swap(tiles, m_missingTiles);
+    return tiles;
+}
+
+qint64 KisOpenGLImageTextures::tileTextureSize() const
+{
+    const KoColorSpace *cs = m_updateInfoBuilder.destinationColorSpace();
+    const qint64 baseLevelSize =
+        qint64(m_texturesInfo.width) * m_texturesInfo.height * (cs ? cs->pixelSize() : 4);
+
+    // the mipmap chain takes up to one third of the base level
+    return baseLevelSize * 4 / 3;
+}
+
+bool KisOpenGLImageTextures::makeTileResident(KisTextureTile *tile, bool fillContent)
+{
+    const qint64 tileSize = tileTextureSize();
+
+    if (m_residentTexturesSize + tileSize > m_texturesMemoryLimit) {
+        // nobody is going to paint the tile, so it is not worth evicting anything
+        if (!tile->residencyRequested()) return false;
+
+        /**
+         * Evict a bit more than needed, so that the next requested
+         * tiles would not need to look through all the tiles again
+         */
+        evictTiles(m_residentTexturesSize + tileSize - m_texturesMemoryLimit +
+                   m_texturesMemoryLimit / 8);
+    }
+
+    // the visible tiles are allocated even when they don't fit the limit
+    tile->makeResident(fillContent);
+    m_residentTexturesSize += tileSize;
+
+    return true;
+}
+
+void KisOpenGLImageTextures::evictTiles(qint64 size)
+{
+    QVector<KisTextureTile*> candidates;
+
+    Q_FOREACH (KisTextureTile *tile, m_textureTiles) {
+        if (tile->isResident() &&
+            !tile->textureRectInImagePixels().intersects(m_visibleImageRect)) {
+
+            candidates.append(tile);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [] (const KisTextureTile *lhs, const KisTextureTile *rhs) {
+                  return lhs->lastUsedFrame() < rhs->lastUsedFrame();
+              });
+
+    const qint64 tileSize = tileTextureSize();
+
+    for (auto it = candidates.begin(); it != candidates.end() && size > 0; ++it) {
+        (*it)->evict();
+        m_residentTexturesSize -= tileSize;
+        size -= tileSize;
     }
 }
 
@@ -431,7 +685,13 @@ void KisOpenGLImageTextures::setChannelFlags(const QBitArray &channelFlags)
 
 void KisOpenGLImageTextures::setProofingConfig(KisProofingConfigurationSP proofingConfig)
 {
-    m_updateInfoBuilder.setProofingConfig(proofingConfig);
+    m_proofingConfig = proofingConfig;
+
+    if (m_displayLut->isActive()) {
+        bakeDisplayLut();
+    } else {
+        m_updateInfoBuilder.setProofingConfig(proofingConfig);
+    }
 }
 
 void KisOpenGLImageTextures::getTextureSize(KisGLTexturesInfo *texturesInfo)
@@ -467,6 +727,22 @@ bool KisOpenGLImageTextures::internalColorManagementActive() const
     return m_internalColorManagementActive;
 }
 
+KisOpenGLDisplayLut *KisOpenGLImageTextures::displayLut() const
+{
+    return m_displayLut.data();
+}
+
+QByteArray KisOpenGLImageTextures::displayShaderProgram() const
+{
+    QByteArray program = m_displayLut->shaderProgram();
+
+    if (m_encodeSurfacePQ) {
+        program.append("#define ENCODE_SURFACE_PQ\n");
+    }
+
+    return program;
+}
+
 bool KisOpenGLImageTextures::setInternalColorManagementActive(bool value)
 {
     bool needsFinalRegeneration = m_internalColorManagementActive != value;
@@ -653,10 +929,42 @@ void KisOpenGLImageTextures::updateTextureFormat()
         m_internalColorManagementActive = true;
     }
 
+    const int lutGridSize = KisConfig(true).displayConversionLutGridSize();
+
+    /**
+     * The lookup table is sampled by the display shader, so the tiles
+     * can be uploaded in the image profile and the conversion doesn't
+     * cost anything on the CPU
+     */
+    const bool useDisplayLut =
+            m_internalColorManagementActive &&
+            lutGridSize > 0 &&
+            !useHDRMode &&
+            KisOpenGL::supportsLoD() &&
+            KisOpenGLDisplayLut::isSupported(m_image->colorSpace());
+
+    /**
+     * The PQ curve costs two powers per channel and its float encoding
+     * is only an intermediate for the surface, so on a PQ surface the
+     * tiles are kept in linear half floats and the curve is applied by
+     * the display shader instead of the CPU
+     */
+    m_encodeSurfacePQ =
+            useHDRMode &&
+            m_internalColorManagementActive &&
+            KisOpenGL::supportsLoD() &&
+            destinationColorDepthId == Float16BitsColorDepthID &&
+            m_monitorProfile == KoColorSpaceRegistry::instance()->p2020PQProfile();
+
+    const KoColorProfile *displayProfile =
+            m_encodeSurfacePQ ?
+                KoColorSpaceRegistry::instance()->p2020G10Profile() : m_monitorProfile;
+
     const KoColorProfile *profile =
-            m_internalColorManagementActive ||
-            colorModelId != destinationColorModelId ?
-                m_monitorProfile : m_image->colorSpace()->profile();
+            !useDisplayLut &&
+            (m_internalColorManagementActive ||
+             colorModelId != destinationColorModelId) ?
+                displayProfile : m_image->colorSpace()->profile();
 
     /**
      * TODO: add an optimization so that the tile->convertTo() method
@@ -668,9 +976,38 @@ void KisOpenGLImageTextures::updateTextureFormat()
                                                          destinationColorDepthId.id(),
                                                          profile);
 
-    m_updateInfoBuilder.setConversionOptions(
-        ConversionOptions(tilesDestinationColorSpace,
-                          m_renderingIntent,
-                          m_conversionFlags));
+    /**
+     * When the image is already in the color space of the textures, e.g.
+     * a linear half float image on an HDR surface, the tiles are uploaded
+     * as they are, without passing them through an identity transform
+     */
+    const bool skipConversion =
+            useDisplayLut ||
+            *tilesDestinationColorSpace == *m_image->colorSpace();
+
+    ConversionOptions options(tilesDestinationColorSpace,
+                              m_renderingIntent,
+                              skipConversion ?
+                                  KoColorConversionTransformation::Empty :
+                                  m_conversionFlags);
+    options.m_lutGridSize = useDisplayLut ? 0 : lutGridSize;
+
+    m_updateInfoBuilder.setConversionOptions(options);
+
+    if (useDisplayLut) {
+        bakeDisplayLut();
+        m_updateInfoBuilder.setProofingConfig(KisProofingConfigurationSP());
+    } else {
+        m_displayLut->reset();
+        m_updateInfoBuilder.setProofingConfig(m_proofingConfig);
+    }
+}
+
+void KisOpenGLImageTextures::bakeDisplayLut()
+{
+    m_displayLut->setTransform(m_image->colorSpace(), m_monitorProfile,
+                               m_renderingIntent, m_conversionFlags,
+                               m_proofingConfig,
+                               KisConfig(true).displayConversionLutGridSize());
 }
 
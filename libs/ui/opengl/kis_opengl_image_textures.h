@@ -8,6 +8,8 @@
 
 #include <QVector>
 #include <QMap>
+#include <QScopedPointer>
+#include <QAtomicInt>
 #include <QOpenGLFunctions>
 
 #include "kritaui_export.h"
@@ -22,6 +24,9 @@ class KisOpenGLImageTextures;
 typedef KisSharedPtr<KisOpenGLImageTextures> KisOpenGLImageTexturesSP;
 
 class KoColorProfile;
+class KisOpenGLUploadRing;
+class KisOpenGLDisplayLut;
+class KisOpenGLProjectionPyramid;
 class KisTextureTileUpdateInfoPoolCollection;
 typedef QSharedPointer<KisTextureTileInfoPool> KisTextureTileInfoPoolSP;
 
@@ -90,6 +95,20 @@ public:
     bool internalColorManagementActive() const;
     bool setInternalColorManagementActive(bool value);
 
+    /**
+     * The lookup table of the display conversion, which should be
+     * applied by the display shader when it is active. The tiles are
+     * not converted to the monitor profile in this case.
+     */
+    KisOpenGLDisplayLut* displayLut() const;
+
+    /**
+     * \return the defines the display shader should be compiled with to
+     * finish the conversion of the tiles into the surface: the sampling
+     * of the display lookup table and the PQ encoding of the HDR surface
+     */
+    QByteArray displayShaderProgram() const;
+
     /**
      * The background checkers texture.
      */
@@ -134,9 +153,52 @@ public:
         return 1.0 / m_texturesInfo.width;
     }
 
+    /**
+     * Starts painting a new frame of the canvas. The resident tiles
+     * intersecting \p visibleImageRect are never evicted.
+     *
+     * When the visible rect has moved since the previous frame, the
+     * tiles lying ahead of it in the direction of the movement are
+     * requested the same way as the missing ones, so that they are
+     * uploaded by the moment the view reaches them.
+     */
+    void startFrame(const QRect &visibleImageRect);
+
+    /**
+     * Marks \p tile as painted in the current frame. If the tile is not
+     * resident, it cannot be painted, its content is requested instead
+     * and the tile is reported by takeMissingTiles().
+     *
+     * \return true if the tile can be painted
+     */
+    bool requestTileForPainting(KisTextureTile *tile);
+
+    /**
+     * \return the image rects of the tiles requested since the last call,
+     * which should be fetched from the projection. Besides the missing
+     * tiles, it includes the resident tiles that need another level of
+     * detail of their content.
+     */
+    QVector<QRect> takeMissingTiles();
+
+    /**
+     * Sets the level of detail the canvas is going to paint the tiles
+     * with. When it is above zero, the canvas updates are uploaded into
+     * the LodN planes of the tiles from the downscaled projection and
+     * the tiles are painted with that plane. Should be called in the
+     * GUI thread.
+     */
+    void setPreferredLevelOfDetail(int levelOfDetail);
+
     KisOpenGLUpdateInfoSP updateCache(const QRect& rect, KisImageSP srcImage);
     KisOpenGLUpdateInfoSP updateCacheNoConversion(const QRect& rect);
 
+    /**
+     * Same as updateCache() for the image of the textures, but the update
+     * is built for the preferred level of detail of the canvas
+     */
+    KisOpenGLUpdateInfoSP updateCanvasCache(const QRect& rect);
+
     void recalculateCache(KisUpdateInfoSP info, bool blockMipmapRegeneration);
 
     void slotImageSizeChanged(qint32 w, qint32 h);
@@ -164,7 +226,14 @@ private:
     void getTextureSize(KisGLTexturesInfo *texturesInfo);
 
     void updateTextureFormat();
+    void bakeDisplayLut();
+
+    qint64 tileTextureSize() const;
+    bool makeTileResident(KisTextureTile *tile, bool fillContent);
+    void evictTiles(qint64 size);
+    void prefetchTiles(const QRect &visibleImageRect, const QPoint &offset);
     KisOpenGLUpdateInfoSP updateCacheImpl(const QRect& rect, KisImageSP srcImage, bool convertColorSpace);
+    void requestTileRefetch(KisTextureTile *tile);
 
 private:
     KisImageWSP m_image;
@@ -187,6 +256,39 @@ private:
     int m_numCols;
     QVector<KisTextureTile*> m_textureTiles;
 
+    /**
+     * The pixel buffer memory shared by all the texture tiles,
+     * it should outlive them
+     */
+    QScopedPointer<KisOpenGLUploadRing> m_uploadRing;
+
+    /**
+     * Only the tiles fitting into the memory limit are resident. When
+     * a missing tile is painted, the least recently used tiles outside
+     * the visible rect are evicted to free the space for it.
+     */
+    qint64 m_texturesMemoryLimit;
+    qint64 m_residentTexturesSize;
+    quint64 m_currentFrame;
+    QRect m_visibleImageRect;
+    QVector<QRect> m_missingTiles;
+
+    /**
+     * The downscaled projection uploaded when the canvas is zoomed out,
+     * the level is read by the update threads
+     */
+    QScopedPointer<KisOpenGLProjectionPyramid> m_projectionPyramid;
+    QAtomicInt m_preferredLevelOfDetail;
+
+    QScopedPointer<KisOpenGLDisplayLut> m_displayLut;
+
+    /**
+     * On a PQ surface the tiles are uploaded in linear Rec. 2020 and
+     * the display shader applies the PQ curve
+     */
+    bool m_encodeSurfacePQ;
+    KisProofingConfigurationSP m_proofingConfig;
+
     QOpenGLFunctions *m_glFuncs;
 
     bool m_useOcio;
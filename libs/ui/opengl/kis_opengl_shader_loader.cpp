@@ -24,6 +24,7 @@ std::map<Uniform, const char *> KisShaderProgram::names = {
    {TexelSize, "texelSize"},
    {Texture0, "texture0"},
    {Texture1, "texture1"},
+   {Texture2, "texture2"},
    {FixedLodLevel, "fixedLodLevel"},
    {FragmentColor, "fragColor"}
 };
@@ -122,7 +123,7 @@ KisShaderProgram *KisOpenGLShaderLoader::loadShader(QString vertPath, QString fr
  * Additionally, it picks the appropriate shader files depending on the availability
  * of OpenGL3.
  */
-KisShaderProgram *KisOpenGLShaderLoader::loadDisplayShader(QSharedPointer<KisDisplayFilter> displayFilter, bool useHiQualityFiltering)
+KisShaderProgram *KisOpenGLShaderLoader::loadDisplayShader(QSharedPointer<KisDisplayFilter> displayFilter, const QByteArray &colorProgram, bool useHiQualityFiltering)
 {
     QByteArray fragHeader;
 
@@ -141,6 +142,13 @@ KisShaderProgram *KisOpenGLShaderLoader::loadDisplayShader(QSharedPointer<KisDis
         fragHeader.append(displayFilter->program().toLatin1());
     }
 
+    // The lookup table of the internal color management and the PQ
+    // curve of the HDR surface are applied here instead of converting
+    // the tiles on the CPU. Only the modern shader supports them.
+    if (!colorProgram.isEmpty() && KisOpenGL::supportsLoD()) {
+        fragHeader.append(colorProgram);
+    }
+
     QString vertPath, fragPath;
     // Select appropriate shader files
     if (KisOpenGL::supportsLoD()) {
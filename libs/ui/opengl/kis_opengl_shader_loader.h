@@ -20,7 +20,7 @@
  * An enum for storing all uniform names used in shaders
  */
 enum Uniform { ModelViewProjection, TextureMatrix, ViewportScale,
-               TexelSize, Texture0, Texture1, FixedLodLevel, FragmentColor };
+               TexelSize, Texture0, Texture1, Texture2, FixedLodLevel, FragmentColor };
 
 /**
  * A wrapper class over Qt's QOpenGLShaderProgram to
@@ -70,7 +70,7 @@ public:
  */
 class KisOpenGLShaderLoader {
 public:
-    KisShaderProgram *loadDisplayShader(QSharedPointer<KisDisplayFilter> displayFilter, bool useHiQualityFiltering);
+    KisShaderProgram *loadDisplayShader(QSharedPointer<KisDisplayFilter> displayFilter, const QByteArray &colorProgram, bool useHiQualityFiltering);
     KisShaderProgram *loadCheckerShader();
     KisShaderProgram *loadSolidColorShader();
     KisShaderProgram *loadOverlayInvertedShader();
@@ -9,9 +9,9 @@
 #include "kis_texture_tile_update_info.h"
 
 #include <kis_debug.h>
-#if !defined(QT_OPENGL_ES)
-#include <QOpenGLBuffer>
-#endif
+#include <KisPerformanceCounters.h>
+#include "KisOpenGLUploadRing.h"
+#include "KisOpenGLTexturePool.h"
 
 #ifndef GL_BGRA
 #define GL_BGRA 0x814F
@@ -52,12 +52,13 @@ inline QRectF relativeRect(const QRect &br /* baseRect */,
 
 KisTextureTile::KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *texturesInfo,
                                const QByteArray &fillData, KisOpenGL::FilterMode filter,
-                               bool useBuffer, int numMipmapLevels, QOpenGLFunctions *fcn)
+                               bool useBuffer, KisOpenGLUploadRing *uploadRing,
+                               KisOpenGLTexturePool *texturePool,
+                               int numMipmapLevels, QOpenGLFunctions *fcn)
 
     : m_textureId(0)
-#ifdef USE_PIXEL_BUFFERS
-    , m_glBuffer(0)
-#endif
+    , m_uploadRing(uploadRing)
+    , m_texturePool(texturePool)
     , m_tileRectInImagePixels(imageRect)
     , m_filter(filter)
     , m_texturesInfo(texturesInfo)
@@ -65,59 +66,101 @@ KisTextureTile::KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *
     , m_preparedLodPlane(0)
     , m_useBuffer(useBuffer)
     , m_numMipmapLevels(numMipmapLevels)
+    , m_fillData(fillData)
+    , m_lastUsedFrame(0)
+    , m_residencyRequested(false)
+    , m_baseLevelOutdated(false)
+    , m_needsRefetch(false)
     , f(fcn)
 {
-    const GLvoid *fd = fillData.constData();
-
     m_textureRectInImagePixels =
             kisGrowRect(m_tileRectInImagePixels, texturesInfo->border);
 
     m_tileRectInTexturePixels = relativeRect(m_textureRectInImagePixels,
                                              m_tileRectInImagePixels,
                                              m_texturesInfo);
+}
 
-    f->glGenTextures(1, &m_textureId);
-    f->glBindTexture(GL_TEXTURE_2D, m_textureId);
+KisTextureTile::~KisTextureTile()
+{
+    evict();
+}
 
-    setTextureParameters();
+void KisTextureTile::makeResident(bool fillContent)
+{
+    if (m_textureId) return;
 
-#ifdef USE_PIXEL_BUFFERS
-    createTextureBuffer(fillData.constData(), fillData.size());
-    // we set fill data to 0 so the next glTexImage2D call uses our buffer
-    fd = 0;
-#endif
+    if (m_texturePool) {
+        m_textureId = m_texturePool->acquire(m_texturesInfo);
+    }
 
-    f->glTexImage2D(GL_TEXTURE_2D, 0,
-                 m_texturesInfo->internalFormat,
-                 m_texturesInfo->width,
-                 m_texturesInfo->height, 0,
-                 m_texturesInfo->format,
-                 m_texturesInfo->type, fd);
+    if (m_textureId) {
+        f->glBindTexture(GL_TEXTURE_2D, m_textureId);
 
-#ifdef USE_PIXEL_BUFFERS
-    if (m_useBuffer && m_glBuffer) {
-        m_glBuffer->release();
+        setTextureParameters();
+
+        // the storage is allocated already, only the content is undefined
+        if (fillContent) {
+            f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                               m_texturesInfo->width,
+                               m_texturesInfo->height,
+                               m_texturesInfo->format,
+                               m_texturesInfo->type, m_fillData.constData());
+        }
+    } else {
+        f->glGenTextures(1, &m_textureId);
+        f->glBindTexture(GL_TEXTURE_2D, m_textureId);
+
+        setTextureParameters();
+
+        f->glTexImage2D(GL_TEXTURE_2D, 0,
+                     m_texturesInfo->internalFormat,
+                     m_texturesInfo->width,
+                     m_texturesInfo->height, 0,
+                     m_texturesInfo->format,
+                     m_texturesInfo->type, fillContent ? m_fillData.constData() : 0);
     }
-#endif
 
+    m_preparedLodPlane = 0;
+    m_residencyRequested = false;
+    m_baseLevelOutdated = false;
+    m_needsRefetch = false;
     setNeedsMipmapRegeneration();
 }
 
-KisTextureTile::~KisTextureTile()
+void KisTextureTile::evict()
 {
-#ifdef USE_PIXEL_BUFFERS
-    delete m_glBuffer;
-#endif
-    f->glDeleteTextures(1, &m_textureId);
+    if (!m_textureId) return;
+
+    if (m_texturePool) {
+        m_texturePool->release(m_textureId, m_texturesInfo);
+    } else {
+        f->glDeleteTextures(1, &m_textureId);
+    }
+    m_textureId = 0;
+
+    m_needsMipmapRegeneration = false;
+    m_preparedLodPlane = 0;
+    m_baseLevelOutdated = false;
+    m_needsRefetch = false;
 }
 
-int KisTextureTile::bindToActiveTexture(bool blockMipmapRegeneration)
+int KisTextureTile::bindToActiveTexture(bool blockMipmapRegeneration, bool mipmapsAreSampled)
 {
     f->glBindTexture(GL_TEXTURE_2D, m_textureId);
 
     if (m_needsMipmapRegeneration && !blockMipmapRegeneration) {
-        f->glGenerateMipmap(GL_TEXTURE_2D);
-        setPreparedLodPlane(0);
+        if (mipmapsAreSampled) {
+            f->glGenerateMipmap(GL_TEXTURE_2D);
+            setPreparedLodPlane(0);
+        } else {
+            /**
+             * The mipmap is dirty only after Lod0 updates, so the base
+             * level is up to date and can be painted right away. The
+             * mipmap stays dirty until some zoom-out samples it.
+             */
+            m_preparedLodPlane = 0;
+        }
     }
 
     return m_preparedLodPlane;
@@ -140,6 +183,8 @@ void KisTextureTile::setPreparedLodPlane(int lod)
 
 void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blockMipmapRegeneration)
 {
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_textureId);
+
     f->initializeOpenGLFunctions();
     f->glBindTexture(GL_TEXTURE_2D, m_textureId);
 
@@ -150,10 +195,11 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
     const QPoint patchOffset = updateInfo.realPatchOffset();
 
     const GLvoid *fd = updateInfo.data();
+
+    KisPerformanceCounters::add(KisPerformanceCounters::TextureUploadBytes,
+                                qint64(patchSize.width()) * patchSize.height() * updateInfo.pixelSize());
 #ifdef USE_PIXEL_BUFFERS
-    if (!m_glBuffer) {
-        createTextureBuffer((const char*)updateInfo.data(), updateInfo.patchPixelsLength());
-    }
+    const bool useUploadRing = m_useBuffer && m_uploadRing && m_uploadRing->isValid();
 #endif
 
     /**
@@ -189,48 +235,46 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
     if (updateInfo.isEntireTileUpdated()) {
 
 #ifdef USE_PIXEL_BUFFERS
-        if (m_useBuffer) {
-
-            m_glBuffer->bind();
-            m_glBuffer->allocate(updateInfo.patchPixelsLength());
-
-            void *vid = m_glBuffer->map(QOpenGLBuffer::WriteOnly);
-            memcpy(vid, fd, updateInfo.patchPixelsLength());
-            m_glBuffer->unmap();
-
-            // we set fill data to 0 so the next glTexImage2D call uses our buffer
-            fd = 0;
+        if (useUploadRing) {
+            // the next glTexImage2D call reads the data from the bound buffer
+            fd = m_uploadRing->upload(fd, updateInfo.patchPixelsLength());
         }
 #endif
 
-        f->glTexImage2D(GL_TEXTURE_2D, patchLevelOfDetail,
-                     m_texturesInfo->internalFormat,
-                     patchSize.width(),
-                     patchSize.height(), 0,
-                     m_texturesInfo->format,
-                     m_texturesInfo->type,
-                     fd);
+        if (!patchLevelOfDetail &&
+            patchSize == QSize(m_texturesInfo->width, m_texturesInfo->height)) {
+
+            // the base level is allocated by makeResident(), don't make
+            // the driver reallocate it
+            f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                            patchSize.width(), patchSize.height(),
+                            m_texturesInfo->format,
+                            m_texturesInfo->type,
+                            fd);
+        } else {
+            f->glTexImage2D(GL_TEXTURE_2D, patchLevelOfDetail,
+                         m_texturesInfo->internalFormat,
+                         patchSize.width(),
+                         patchSize.height(), 0,
+                         m_texturesInfo->format,
+                         m_texturesInfo->type,
+                         fd);
+        }
 
 #ifdef USE_PIXEL_BUFFERS
-        if (m_useBuffer) {
-            m_glBuffer->release();
+        if (useUploadRing) {
+            m_uploadRing->release();
         }
 #endif
 
     }
     else {
 #ifdef USE_PIXEL_BUFFERS
-        if (m_useBuffer) {
-            m_glBuffer->bind();
+        if (useUploadRing) {
             int size = patchSize.width() * patchSize.height() * updateInfo.pixelSize();
-            m_glBuffer->allocate(size);
 
-            void *vid = m_glBuffer->map(QOpenGLBuffer::WriteOnly);
-            memcpy(vid, fd, size);
-            m_glBuffer->unmap();
-
-            // we set fill data to 0 so the next glTexImage2D call uses our buffer
-            fd = 0;
+            // the next glTexSubImage2D call reads the data from the bound buffer
+            fd = m_uploadRing->upload(fd, size);
         }
 #endif
 
@@ -242,8 +286,8 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
                         fd);
 
 #ifdef USE_PIXEL_BUFFERS
-        if (m_useBuffer) {
-            m_glBuffer->release();
+        if (useUploadRing) {
+            m_uploadRing->release();
         }
 #endif
 
@@ -351,7 +395,14 @@ void KisTextureTile::update(const KisTextureTileUpdateInfo &updateInfo, bool blo
     //     qDebug() << "    " << ppVar(patchLevelOfDetail);
     // }
 
+    if (updateInfo.coversEntireTile()) {
+        m_residencyRequested = false;
+    }
+
     if (!patchLevelOfDetail) {
+        if (updateInfo.coversEntireTile()) {
+            m_baseLevelOutdated = false;
+        }
         setNeedsMipmapRegeneration();
     } else {
         setPreparedLodPlane(patchLevelOfDetail);
@@ -365,26 +416,3 @@ QRectF KisTextureTile::imageRectInTexturePixels(const QRect &imageRect) const
                         m_texturesInfo);
 
 }
-
-#ifdef USE_PIXEL_BUFFERS
-void KisTextureTile::createTextureBuffer(const char *data, int size)
-{
-    if (m_useBuffer) {
-        if (!m_glBuffer) {
-            m_glBuffer = new QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer);
-            m_glBuffer->setUsagePattern(QOpenGLBuffer::DynamicDraw);
-            m_glBuffer->create();
-            m_glBuffer->bind();
-            m_glBuffer->allocate(size);
-        }
-        void *vid = m_glBuffer->map(QOpenGLBuffer::WriteOnly);
-        memcpy(vid, data, size);
-        m_glBuffer->unmap();
-
-    }
-    else {
-        delete m_glBuffer;
-        m_glBuffer = 0;
-    }
-}
-#endif
@@ -18,7 +18,8 @@
 #endif
 
 class KisTextureTileUpdateInfo;
-class QOpenGLBuffer;
+class KisOpenGLUploadRing;
+class KisOpenGLTexturePool;
 
 
 struct KisGLTexturesInfo {
@@ -52,7 +53,9 @@ class KisTextureTile
 public:
     KisTextureTile(const QRect &imageRect, const KisGLTexturesInfo *texturesInfo,
                    const QByteArray &fillData, KisOpenGL::FilterMode mode,
-                   bool useBuffer, int numMipmapLevels, QOpenGLFunctions *f);
+                   bool useBuffer, KisOpenGLUploadRing *uploadRing,
+                   KisOpenGLTexturePool *texturePool,
+                   int numMipmapLevels, QOpenGLFunctions *f);
     ~KisTextureTile();
 
     void setUseBuffer(bool useBuffer) {
@@ -79,12 +82,97 @@ public:
 
     QRectF imageRectInTexturePixels(const QRect &imageRect) const;
 
+    /**
+     * The texture of the tile is allocated lazily by the first update
+     * of the entire tile and can be evicted to save the video memory.
+     * A tile which isn't resident has no content and cannot be painted.
+     */
+    inline bool isResident() const {
+        return m_textureId;
+    }
+
+    /**
+     * Allocates the texture of the tile, the following update() call
+     * should upload the entire tile. When the update is going to upload
+     * a LodN plane only, \p fillContent should be true to initialize
+     * the base level with the empty data.
+     */
+    void makeResident(bool fillContent);
+
+    /**
+     * Gives the texture of the tile back to the pool, its content is lost
+     */
+    void evict();
+
+    /**
+     * The number of the last frame the tile has been painted in,
+     * used for selecting the tiles for eviction
+     */
+    inline quint64 lastUsedFrame() const {
+        return m_lastUsedFrame;
+    }
+
+    inline void setLastUsedFrame(quint64 frame) {
+        m_lastUsedFrame = frame;
+    }
+
+    /**
+     * Shows whether the content of the tile has been requested for
+     * painting, but hasn't been uploaded yet
+     */
+    inline bool residencyRequested() const {
+        return m_residencyRequested;
+    }
+
+    inline void setResidencyRequested(bool value) {
+        m_residencyRequested = value;
+    }
+
+    /**
+     * The base level of the tile is outdated when the recent updates
+     * of the tile were uploaded into a LodN plane only, which happens
+     * when the canvas is zoomed out. Only an update covering the entire
+     * tile brings the base level back.
+     */
+    inline bool baseLevelOutdated() const {
+        return m_baseLevelOutdated;
+    }
+
+    inline void setBaseLevelOutdated(bool value) {
+        m_baseLevelOutdated = value;
+    }
+
+    /**
+     * \return true if a part of the tile can be updated in the plane of
+     * \p levelOfDetail, that is, the rest of the plane is up to date
+     */
+    inline bool canUpdatePartially(int levelOfDetail) const {
+        return !m_baseLevelOutdated ||
+            (levelOfDetail > 0 && levelOfDetail == m_preparedLodPlane);
+    }
+
+    /**
+     * Shows whether the content of the resident tile should be fetched
+     * again the next time the tile is painted, e.g. because the canvas
+     * needs another level of detail of it
+     */
+    inline bool needsRefetch() const {
+        return m_needsRefetch;
+    }
+
+    inline void setNeedsRefetch(bool value) {
+        m_needsRefetch = value;
+    }
+
     /**
      * Binds the tile's testure to the current GL_TEXTURE_2D binding point,
      * regenerates the mipmap if needed and returns the levelOfDetail that
      * should be used for painting
+     *
+     * When \p mipmapsAreSampled is false, the dirty mipmap is not
+     * regenerated, but stays dirty until the canvas is zoomed out
      */
-    int bindToActiveTexture(bool blockMipmapRegeneration);
+    int bindToActiveTexture(bool blockMipmapRegeneration, bool mipmapsAreSampled);
 
 private:
     inline void setTextureParameters();
@@ -93,11 +181,8 @@ private:
     void setPreparedLodPlane(int lod);
 
     GLuint m_textureId;
-
-#ifdef USE_PIXEL_BUFFERS
-    void createTextureBuffer(const char*data, int size);
-    QOpenGLBuffer *m_glBuffer;
-#endif
+    KisOpenGLUploadRing *m_uploadRing;
+    KisOpenGLTexturePool *m_texturePool;
 
     QRect m_tileRectInImagePixels;
     QRectF m_tileRectInTexturePixels;
@@ -108,6 +193,11 @@ private:
     int m_preparedLodPlane;
     bool m_useBuffer;
     int m_numMipmapLevels;
+    QByteArray m_fillData;
+    quint64 m_lastUsedFrame;
+    bool m_residencyRequested;
+    bool m_baseLevelOutdated;
+    bool m_needsRefetch;
     QOpenGLFunctions *f;
     Q_DISABLE_COPY(KisTextureTile)
 };
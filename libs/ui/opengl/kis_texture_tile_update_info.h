@@ -199,6 +199,20 @@ public:
         }
     }
 
+    void convertTo(const KoColorSpace* dstCS,
+                   const KoColorConversionTransformation *transform)
+    {
+        if (m_patchRect.isValid()) {
+            const qint32 numPixels = m_patchRect.width() * m_patchRect.height();
+            DataBuffer conversionCache(dstCS->pixelSize(), m_pool);
+
+            transform->transform(m_patchPixels.data(), conversionCache.data(), numPixels);
+
+            m_patchColorSpace = dstCS;
+            conversionCache.swap(m_patchPixels);
+        }
+    }
+
     void proofTo(const KoColorSpace* dstCS,
                    KoColorConversionTransformation::ConversionFlags conversionFlags,
                    KoColorConversionTransformation *proofingTransform)
@@ -272,6 +286,20 @@ public:
         return m_patchRect == m_tileRect;
     }
 
+    /**
+     * The tiles on the image boundary are never updated entirely, the
+     * part of the tile outside the image is filled by repeating the
+     * bounding pixels of the patch instead.
+     *
+     * \return true if the patch defines all the content of the tile
+     */
+    inline bool coversEntireTile() const {
+        return (isLeftmost() || m_patchRect.left() == m_tileRect.left()) &&
+            (isTopmost() || m_patchRect.top() == m_tileRect.top()) &&
+            (isRightmost() || m_patchRect.right() == m_tileRect.right()) &&
+            (isBottommost() || m_patchRect.bottom() == m_tileRect.bottom());
+    }
+
     inline qint32 tileCol() const {
         return m_tileCol;
     }
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBatchExporterTest.h"
+
+#include <QTest>
+#include <QDir>
+#include <QTemporaryDir>
+
+#include "KisBatchExporter.h"
+
+namespace {
+QString writeJobList(const QTemporaryDir &dir, const QByteArray &contents)
+{
+    const QString fileName = dir.filePath("jobs.txt");
+
+    QFile file(fileName);
+    file.open(QIODevice::WriteOnly);
+    file.write(contents);
+
+    return fileName;
+}
+}
+
+void KisBatchExporterTest::testLoadJobList()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString fileName = writeJobList(dir,
+        "# comments and empty lines are skipped\n"
+        "\n"
+        "input 1.kra\toutput 1.png\n"
+        "/absolute/input.ora\tout/output.jpg\timage/jpeg\r\n");
+
+    QVector<KisBatchExporter::Job> jobs;
+    QString errorMessage;
+    QVERIFY(KisBatchExporter::loadJobList(fileName, &jobs, &errorMessage));
+    QVERIFY(errorMessage.isEmpty());
+
+    QCOMPARE(jobs.size(), 2);
+
+    const QDir baseDir(dir.path());
+
+    QCOMPARE(jobs[0].inputFileName, baseDir.absoluteFilePath("input 1.kra"));
+    QCOMPARE(jobs[0].outputFileName, baseDir.absoluteFilePath("output 1.png"));
+    QVERIFY(jobs[0].outputMimeType.isEmpty());
+
+    QCOMPARE(jobs[1].inputFileName, QString("/absolute/input.ora"));
+    QCOMPARE(jobs[1].outputFileName, baseDir.absoluteFilePath("out/output.jpg"));
+    QCOMPARE(jobs[1].outputMimeType, QByteArray("image/jpeg"));
+}
+
+void KisBatchExporterTest::testLoadMalformedJobList()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString fileName = writeJobList(dir,
+        "input.kra\toutput.png\n"
+        "input.kra output.png\n");
+
+    QVector<KisBatchExporter::Job> jobs;
+    QString errorMessage;
+    QVERIFY(!KisBatchExporter::loadJobList(fileName, &jobs, &errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+
+    QVERIFY(!KisBatchExporter::loadJobList(dir.filePath("missing.txt"), &jobs, &errorMessage));
+}
+
+QTEST_MAIN(KisBatchExporterTest)
@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBATCHEXPORTERTEST_H
+#define KISBATCHEXPORTERTEST_H
+
+#include <QtTest>
+
+class KisBatchExporterTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLoadJobList();
+    void testLoadMalformedJobList();
+};
+
+#endif // KISBATCHEXPORTERTEST_H
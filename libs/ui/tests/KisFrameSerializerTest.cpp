@@ -67,13 +67,23 @@ bool verifyTestFrame(int frameSeed, const KisFrameDataSerializer::Frame &frame)
 
 
 
+void KisFrameSerializerTest::testFrameDataSerialization_data()
+{
+    QTest::addColumn<int>("storageType");
+
+    QTest::newRow("on-disk") << int(KisFrameDataSerializer::OnDisk);
+    QTest::newRow("in-memory") << int(KisFrameDataSerializer::InMemory);
+}
+
 void KisFrameSerializerTest::testFrameDataSerialization()
 {
+    QFETCH(int, storageType);
+
     KisTextureTileInfoPoolRegistry poolRegistry;
     KisTextureTileInfoPoolSP pool = poolRegistry.getPool(maxTileSize, maxTileSize);
 
 
-    KisFrameDataSerializer serializer;
+    KisFrameDataSerializer serializer(KisFrameDataSerializer::StorageType(storageType), QString());
 
     KisFrameDataSerializer::Frame testFrame1 = generateTestFrame(2, pool);
     KisFrameDataSerializer::Frame testFrame2 = generateTestFrame(3, pool);
@@ -207,4 +217,50 @@ void KisFrameSerializerTest::testFrameArithmetics()
     }
 }
 
+void KisFrameSerializerTest::testSharedFrameTiles()
+{
+    KisTextureTileInfoPoolRegistry poolRegistry;
+    KisTextureTileInfoPoolSP pool = poolRegistry.getPool(maxTileSize, maxTileSize);
+
+    KisFrameDataSerializer serializer(KisFrameDataSerializer::InMemory, QString());
+
+    KisFrameDataSerializer::Frame baseFrame = generateTestFrame(2, pool);
+    KisFrameDataSerializer::Frame changedFrame = generateTestFrame(2, pool);
+
+    // change only the last tile of the frame
+    KisFrameDataSerializer::FrameTile &changedTile = changedFrame.frameTiles.back();
+    *reinterpret_cast<qint32*>(changedTile.data.data()) = 0;
+
+    KisFrameDataSerializer::Frame referenceFrame = changedFrame.clone();
+
+    const bool framesAreSame = KisFrameDataSerializer::subtractFrames(changedFrame, baseFrame);
+    QVERIFY(!framesAreSame);
+
+    for (size_t i = 0; i < changedFrame.frameTiles.size(); i++) {
+        const KisFrameDataSerializer::FrameTile &tile = changedFrame.frameTiles[i];
+        const bool isLastTile = i == changedFrame.frameTiles.size() - 1;
+
+        QCOMPARE(tile.isShared, !isLastTile);
+        QCOMPARE(!tile.data.data(), !isLastTile);
+    }
+
+    const int frameId = serializer.saveFrame(changedFrame);
+    KisFrameDataSerializer::Frame loadedFrame = serializer.loadFrame(frameId, pool);
+
+    QCOMPARE(loadedFrame.frameTiles.size(), changedFrame.frameTiles.size());
+    QVERIFY(loadedFrame.frameTiles.front().isShared);
+    QVERIFY(!loadedFrame.frameTiles.back().isShared);
+
+    KisFrameDataSerializer::addFrames(loadedFrame, baseFrame);
+
+    for (const KisFrameDataSerializer::FrameTile &tile : loadedFrame.frameTiles) {
+        QVERIFY(!tile.isShared);
+    }
+
+    boost::optional<qreal> result =
+        KisFrameDataSerializer::estimateFrameUniqueness(loadedFrame, referenceFrame, 1.0);
+    QVERIFY(!!result);
+    QCOMPARE(*result, 0.0);
+}
+
 QTEST_MAIN(KisFrameSerializerTest)
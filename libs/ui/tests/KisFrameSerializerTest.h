@@ -14,9 +14,11 @@ class KisFrameSerializerTest : public QObject
     Q_OBJECT
 
 private Q_SLOTS:
+    void testFrameDataSerialization_data();
     void testFrameDataSerialization();
     void testFrameUniquenessEstimation();
     void testFrameArithmetics();
+    void testSharedFrameTiles();
 
 };
 
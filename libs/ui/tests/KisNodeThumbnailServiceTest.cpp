@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisNodeThumbnailServiceTest.h"
+
+#include <QTest>
+#include <QSignalSpy>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_image.h"
+#include "kis_paint_layer.h"
+#include "kis_paint_device.h"
+#include "KisNodeThumbnailService.h"
+
+
+void KisNodeThumbnailServiceTest::testFirstThumbnail()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 512, 512, cs, "test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+
+    layer->paintDevice()->fill(QRect(0, 0, 256, 192), KoColor(Qt::red, cs));
+
+    KisNodeThumbnailService service;
+    service.setImage(image);
+
+    // the first thumbnail of a node is generated synchronously
+    QCOMPARE(service.thumbnail(layer, 64), layer->createThumbnail(64, 64, Qt::KeepAspectRatio));
+}
+
+void KisNodeThumbnailServiceTest::testIncrementalUpdate()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 512, 512, cs, "test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+
+    layer->paintDevice()->fill(QRect(0, 0, 256, 192), KoColor(Qt::red, cs));
+
+    KisNodeThumbnailService service;
+    service.setImage(image);
+    QSignalSpy spy(&service, SIGNAL(sigThumbnailUpdated(KisNodeSP)));
+
+    const QImage oldThumbnail = service.thumbnail(layer, 64);
+
+    // the change keeps the extent of the device
+    const QRect changedRect(40, 40, 60, 60);
+    layer->paintDevice()->fill(changedRect, KoColor(Qt::blue, cs));
+    service.notifyImageUpdated(changedRect);
+
+    // the old thumbnail is returned until the new one is ready
+    QCOMPARE(service.thumbnail(layer, 64), oldThumbnail);
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.size(), 1);
+
+    const QImage newThumbnail = service.thumbnail(layer, 64);
+    QVERIFY(newThumbnail != oldThumbnail);
+    QCOMPARE(newThumbnail, layer->createThumbnail(64, 64, Qt::KeepAspectRatio));
+}
+
+void KisNodeThumbnailServiceTest::testExtentChange()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 512, 512, cs, "test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+
+    layer->paintDevice()->fill(QRect(0, 0, 256, 192), KoColor(Qt::red, cs));
+
+    KisNodeThumbnailService service;
+    service.setImage(image);
+    QSignalSpy spy(&service, SIGNAL(sigThumbnailUpdated(KisNodeSP)));
+
+    service.thumbnail(layer, 64);
+
+    // the change grows the extent, so the thumbnail is remapped
+    // and the change is not reported
+    layer->paintDevice()->fill(QRect(300, 300, 100, 100), KoColor(Qt::blue, cs));
+    service.thumbnail(layer, 64);
+
+    QVERIFY(spy.wait());
+    QCOMPARE(service.thumbnail(layer, 64), layer->createThumbnail(64, 64, Qt::KeepAspectRatio));
+
+    // another size is scaled from the existing one until it is generated
+    QCOMPARE(service.thumbnail(layer, 32).size(),
+             layer->createThumbnail(32, 32, Qt::KeepAspectRatio).size());
+
+    QVERIFY(spy.wait());
+    QCOMPARE(service.thumbnail(layer, 32), layer->createThumbnail(32, 32, Qt::KeepAspectRatio));
+}
+
+QTEST_MAIN(KisNodeThumbnailServiceTest)
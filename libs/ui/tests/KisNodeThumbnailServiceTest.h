@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISNODETHUMBNAILSERVICETEST_H
+#define KISNODETHUMBNAILSERVICETEST_H
+
+#include <QtTest>
+
+class KisNodeThumbnailServiceTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFirstThumbnail();
+    void testIncrementalUpdate();
+    void testExtentChange();
+};
+
+#endif // KISNODETHUMBNAILSERVICETEST_H
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOpenGLProjectionPyramidTest.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <testutil.h>
+#include "kis_paint_device.h"
+#include "opengl/KisOpenGLProjectionPyramid.h"
+
+
+void KisOpenGLProjectionPyramidTest::testPlaneContent()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageBounds(0, 0, 300, 200);
+
+    KisPaintDeviceSP projection = new KisPaintDevice(cs);
+    projection->fill(QRect(10, 10, 100, 100), KoColor(Qt::red, cs));
+    projection->fill(QRect(151, 51, 120, 120), KoColor(Qt::blue, cs));
+
+    KisOpenGLProjectionPyramid pyramid;
+
+    for (int lod = 1; lod <= 3; lod++) {
+        KisPaintDeviceSP plane = pyramid.plane(projection, imageBounds, imageBounds, lod);
+
+        KisPaintDeviceSP reference = new KisPaintDevice(cs);
+        projection->generateLodCloneDevice(reference, imageBounds, lod);
+
+        QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(plane, reference));
+    }
+}
+
+void KisOpenGLProjectionPyramidTest::testIncrementalUpdate()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageBounds(0, 0, 300, 200);
+    const int lod = 2;
+
+    KisPaintDeviceSP projection = new KisPaintDevice(cs);
+    projection->fill(QRect(10, 10, 100, 100), KoColor(Qt::red, cs));
+
+    KisOpenGLProjectionPyramid pyramid;
+    KisPaintDeviceSP plane = pyramid.plane(projection, imageBounds, imageBounds, lod);
+
+    const QRect changedRect(150, 50, 100, 100);
+    projection->fill(changedRect, KoColor(Qt::blue, cs));
+
+    KisPaintDeviceSP reference = new KisPaintDevice(cs);
+    projection->generateLodCloneDevice(reference, imageBounds, lod);
+
+    // the changes are not picked up until the area is marked as dirty
+    plane = pyramid.plane(projection, imageBounds, imageBounds, lod);
+    QVERIFY(!TestUtil::comparePaintDevicesClever<quint8>(plane, reference));
+
+    pyramid.setDirty(changedRect);
+
+    // only the requested area is brought up to date
+    plane = pyramid.plane(projection, imageBounds, QRect(0, 0, 200, 200), lod);
+    QVERIFY(!TestUtil::comparePaintDevicesClever<quint8>(plane, reference));
+
+    plane = pyramid.plane(projection, imageBounds, imageBounds, lod);
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(plane, reference));
+}
+
+QTEST_MAIN(KisOpenGLProjectionPyramidTest)
@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPENGLPROJECTIONPYRAMIDTEST_H
+#define KISOPENGLPROJECTIONPYRAMIDTEST_H
+
+#include <QtTest>
+
+class KisOpenGLProjectionPyramidTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testPlaneContent();
+    void testIncrementalUpdate();
+};
+
+#endif // KISOPENGLPROJECTIONPYRAMIDTEST_H
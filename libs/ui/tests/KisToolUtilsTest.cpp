@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisToolUtilsTest.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_paint_device.h"
+#include "tool/kis_tool_utils.h"
+
+
+void KisToolUtilsTest::testPickColorRadius()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QPoint pos(100, 100);
+    const int radius = 11;
+    const int effectiveRadius = radius - 1;
+
+    dev->fill(QRect(0, 0, 200, 200), KoColor(Qt::red, cs));
+
+    // the corners of the bounding square are outside the circle
+    const KoColor blue(Qt::blue, cs);
+    dev->setPixel(pos.x() - effectiveRadius, pos.y() - effectiveRadius, blue);
+    dev->setPixel(pos.x() + effectiveRadius, pos.y() + effectiveRadius, blue);
+
+    KoColor color;
+
+    // the very first sample is always pure
+    QVERIFY(KisToolUtils::pickColor(color, dev, pos, 0, radius, 100));
+
+    QVERIFY(KisToolUtils::pickColor(color, dev, pos, 0, radius, 100));
+    QCOMPARE(color.toQColor(), QColor(Qt::red));
+
+    // the pixels inside the circle are averaged in
+    dev->fill(QRect(pos.x() - 5, pos.y(), 10, 5), blue);
+
+    QVERIFY(KisToolUtils::pickColor(color, dev, pos, 0, radius, 100));
+    QVERIFY(color.toQColor() != QColor(Qt::red));
+    QVERIFY(color.toQColor().blue() > 0);
+}
+
+QTEST_MAIN(KisToolUtilsTest)
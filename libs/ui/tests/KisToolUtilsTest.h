@@ -0,0 +1,19 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTOOLUTILSTEST_H
+#define KISTOOLUTILSTEST_H
+
+#include <QtTest>
+
+class KisToolUtilsTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testPickColorRadius();
+};
+
+#endif // KISTOOLUTILSTEST_H
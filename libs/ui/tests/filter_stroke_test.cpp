@@ -19,9 +19,10 @@
 class FilterStrokeTester : public utils::StrokeTester
 {
 public:
-    FilterStrokeTester(const QString &filterName)
+    FilterStrokeTester(const QString &filterName, bool progressivePreview = false)
         : StrokeTester(QString("filter_") + filterName, QSize(500, 500), ""),
-          m_filterName(filterName)
+          m_filterName(filterName),
+          m_progressivePreview(progressivePreview)
     {
         setBaseFuzziness(5);
     }
@@ -53,6 +54,23 @@ protected:
 
         Q_UNUSED(resources);
 
+        const QVector<QRect> rects = {
+            QRect(100,100,100,100),
+            QRect(200,100,100,100),
+            QRect(100,200,100,100)
+        };
+
+        if (m_progressivePreview) {
+            // the previews should be fully replaced by the final result
+            image->addJob(strokeId(), new KisFilterStrokeStrategy::PreviewPassMarker());
+
+            Q_FOREACH (const QRect &rc, rects) {
+                image->addJob(strokeId(), new KisFilterStrokeStrategy::PreviewData(rc, 2));
+            }
+
+            image->addJob(strokeId(), new KisFilterStrokeStrategy::PreviewPassMarker());
+        }
+
         image->addJob(strokeId(),
                       new KisFilterStrokeStrategy::
                       Data(QRect(100,100,100,100), true));
@@ -68,6 +86,7 @@ protected:
 
 private:
     QString m_filterName;
+    bool m_progressivePreview;
 };
 
 void FilterStrokeTest::testBlurFilter()
@@ -76,4 +95,10 @@ void FilterStrokeTest::testBlurFilter()
     tester.test();
 }
 
+void FilterStrokeTest::testBlurFilterProgressivePreview()
+{
+    FilterStrokeTester tester("blur", true);
+    tester.test();
+}
+
 QTEST_MAIN(FilterStrokeTest)
@@ -16,6 +16,7 @@ class FilterStrokeTest : public QObject
 
 private Q_SLOTS:
     void testBlurFilter();
+    void testBlurFilterProgressivePreview();
 };
 
 #endif /* __FILTER_STROKE_TEST_H */
@@ -9,6 +9,8 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QQueue>
+#include <QDateTime>
+#include <QDir>
 
 #include <klocalizedstring.h>
 
@@ -21,9 +23,12 @@
 #include "kis_image.h"
 #include "kis_painter.h"
 #include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_settings.h>
 #include <brushengine/kis_paintop_utils.h>
+#include <brushengine/KisStrokeRecording.h>
 
 #include "kis_update_time_monitor.h"
+#include "KisStrokeLatencyMonitor.h"
 #include "kis_stabilized_events_sampler.h"
 #include "KisStabilizerDelayedPaintHelper.h"
 #include "kis_config.h"
@@ -102,7 +107,28 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    // Motion prediction data, see predictedStrokeSegment()
+    int predictionHorizon = 0;
+    QPointF predictionPrevPos;
+    QPointF predictionLastPos;
+    qreal predictionSpeed = 0.0;
+
+    // The area around the predicted segment that has its tiles prefetched
+    qreal prefetchRadius = 0.0;
+    QRect lastPrefetchRect;
+
+    // The input events of the stroke, saved into strokeRecordingDirectory
+    QString strokeRecordingDirectory;
+    KisStrokeRecording strokeRecording;
+
+    // The jobs of the hands collected between beginMultiHandJob() and
+    // endMultiHandJob()
+    bool parallelMultihandPainting = false;
+    bool collectingHandJobs = false;
+    QVector<FreehandStrokeStrategy::Data*> handJobs;
+
     qreal effectiveSmoothnessDistance() const;
+    void addPaintJob(FreehandStrokeStrategy::Data *data);
 };
 
 
@@ -217,6 +243,12 @@ QPainterPath KisToolFreehandHelper::paintOpOutline(const QPointF &savedCursorPos
         outline.addEllipse(info.pos(), R, R);
     }
 
+    const QLineF predictedSegment = predictedStrokeSegment();
+    if (!predictedSegment.isNull()) {
+        outline.moveTo(predictedSegment.p1());
+        outline.lineTo(predictedSegment.p2());
+    }
+
     return outline;
 }
 
@@ -236,6 +268,9 @@ void KisToolFreehandHelper::initPaint(KoPointerEvent *event,
     m_d->strokeTime.start();
     KisPaintInformation pi =
         m_d->infoBuilder->startStroke(event, elapsedStrokeTime(), m_d->resourceManager);
+
+    KisStrokeLatencyMonitor::instance()->startStrokeMeasure();
+    pi.setInputEventId(KisStrokeLatencyMonitor::instance()->registerInputEvent());
     qreal startAngle = KisAlgebra2D::directionBetweenPoints(prevPoint, pixelCoords, 0.0);
 
     initPaintImpl(startAngle,
@@ -271,6 +306,19 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
 
     m_d->previousPaintInformation = pi;
 
+    m_d->predictionHorizon = KisConfig(true).freehandPredictionHorizon();
+    m_d->predictionPrevPos = pi.pos();
+    m_d->predictionLastPos = pi.pos();
+    m_d->predictionSpeed = 0.0;
+
+    m_d->parallelMultihandPainting = KisConfig(true).parallelMultihandPainting();
+
+    m_d->strokeRecordingDirectory = KisConfig(true).strokeRecordingDirectory();
+    m_d->strokeRecording.clear();
+    if (!m_d->strokeRecordingDirectory.isEmpty()) {
+        m_d->strokeRecording.addSample(pi);
+    }
+
     m_d->resources = new KisResourcesSnapshot(image,
                                               currentNode,
                                               resourceManager,
@@ -279,6 +327,11 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
         m_d->resources->setCurrentNode(overrideNode);
     }
 
+    // the size of the brush is the diameter, so this radius covers
+    // the rotated and scattered dabs as well
+    m_d->prefetchRadius = m_d->resources->currentPaintOpPreset()->settings()->paintOpSize();
+    m_d->lastPrefetchRect = QRect();
+
     const bool airbrushing = m_d->resources->needsAirbrushing();
     const bool useSpacingUpdates = m_d->resources->needsSpacingUpdates();
 
@@ -430,14 +483,76 @@ qreal KisToolFreehandHelper::Private::effectiveSmoothnessDistance() const
     return smoothingOptions->smoothnessDistance() * zoomingCoeff;
 }
 
+void KisToolFreehandHelper::Private::addPaintJob(FreehandStrokeStrategy::Data *data)
+{
+    if (collectingHandJobs) {
+        handJobs.append(data);
+    } else {
+        strokesFacade->addJob(strokeId, data);
+    }
+}
+
 void KisToolFreehandHelper::paintEvent(KoPointerEvent *event)
 {
     KisPaintInformation info =
             m_d->infoBuilder->continueStroke(event,
                                              elapsedStrokeTime());
     KisUpdateTimeMonitor::instance()->reportMouseMove(info.pos());
+    info.setInputEventId(KisStrokeLatencyMonitor::instance()->registerInputEvent());
+
+    m_d->predictionPrevPos = m_d->predictionLastPos;
+    m_d->predictionLastPos = info.pos();
+
+    // the speed is measured in view pixels per millisecond
+    m_d->predictionSpeed = info.drawingSpeed() / currentZoom();
+
+    if (!m_d->strokeRecordingDirectory.isEmpty()) {
+        m_d->strokeRecording.addSample(info);
+    }
 
     paint(info);
+
+    /**
+     * Let the stroke allocate the tiles the brush is going to reach
+     * in advance, while it is still painting the current dabs
+     */
+    const QLineF predictedSegment = predictedStrokeSegment();
+    if (!predictedSegment.isNull()) {
+        const qreal radius = m_d->prefetchRadius;
+        const QRect prefetchRect =
+            QRectF(predictedSegment.p1(), predictedSegment.p2()).normalized()
+                .adjusted(-radius, -radius, radius, radius).toAlignedRect();
+
+        if (!m_d->lastPrefetchRect.contains(prefetchRect)) {
+            m_d->strokesFacade->addJob(m_d->strokeId,
+                                       new FreehandStrokeStrategy::PrefetchData(0, prefetchRect));
+            m_d->lastPrefetchRect = prefetchRect;
+        }
+    }
+}
+
+QLineF KisToolFreehandHelper::predictedStrokeSegment() const
+{
+    if (m_d->strokeInfos.isEmpty() || m_d->predictionHorizon <= 0) {
+        return QLineF();
+    }
+
+    const QPointF direction = m_d->predictionLastPos - m_d->predictionPrevPos;
+    const qreal directionLength = KisAlgebra2D::norm(direction);
+
+    if (qFuzzyIsNull(directionLength) || qFuzzyIsNull(m_d->predictionSpeed)) {
+        return QLineF();
+    }
+
+    /**
+     * Never predict further than the distance between the two latest
+     * events, so a sudden stop of the pen produces only a short
+     * overshoot
+     */
+    const qreal distance = qMin(m_d->predictionSpeed * m_d->predictionHorizon, directionLength);
+
+    return QLineF(m_d->predictionLastPos,
+                  m_d->predictionLastPos + direction * distance / directionLength);
 }
 
 void KisToolFreehandHelper::paint(KisPaintInformation &info)
@@ -634,6 +749,19 @@ void KisToolFreehandHelper::endPaint()
 
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
+
+    KisStrokeLatencyMonitor::instance()->endStrokeMeasure();
+
+    if (!m_d->strokeRecording.isEmpty()) {
+        const QString fileName =
+            QString("stroke-%1.kst").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"));
+
+        if (!m_d->strokeRecording.save(QDir(m_d->strokeRecordingDirectory).filePath(fileName))) {
+            warnKrita << "Failed to save the stroke recording into" << m_d->strokeRecordingDirectory;
+        }
+
+        m_d->strokeRecording.clear();
+    }
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -660,10 +788,13 @@ void KisToolFreehandHelper::cancelPaint()
 
     // see a comment in endPaint()
     m_d->strokeInfos.clear();
+    m_d->strokeRecording.clear();
 
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
 
+    KisStrokeLatencyMonitor::instance()->endStrokeMeasure();
+
 }
 
 int KisToolFreehandHelper::elapsedStrokeTime() const
@@ -894,8 +1025,7 @@ void KisToolFreehandHelper::paintAt(int strokeInfoId,
                                     const KisPaintInformation &pi)
 {
     m_d->hasPaintAtLeastOnce = true;
-    m_d->strokesFacade->addJob(m_d->strokeId,
-                               new FreehandStrokeStrategy::Data(strokeInfoId, pi));
+    m_d->addPaintJob(new FreehandStrokeStrategy::Data(strokeInfoId, pi));
 
 }
 
@@ -904,8 +1034,7 @@ void KisToolFreehandHelper::paintLine(int strokeInfoId,
                                       const KisPaintInformation &pi2)
 {
     m_d->hasPaintAtLeastOnce = true;
-    m_d->strokesFacade->addJob(m_d->strokeId,
-                               new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
+    m_d->addPaintJob(new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
 
 }
 
@@ -940,10 +1069,29 @@ void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
 #endif
 
     m_d->hasPaintAtLeastOnce = true;
-    m_d->strokesFacade->addJob(m_d->strokeId,
-                               new FreehandStrokeStrategy::Data(strokeInfoId,
-                                                                pi1, control1, control2, pi2));
+    m_d->addPaintJob(new FreehandStrokeStrategy::Data(strokeInfoId,
+                                                      pi1, control1, control2, pi2));
+
+}
+
+void KisToolFreehandHelper::beginMultiHandJob()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->handJobs.isEmpty());
+    m_d->collectingHandJobs = m_d->parallelMultihandPainting;
+}
+
+void KisToolFreehandHelper::endMultiHandJob()
+{
+    m_d->collectingHandJobs = false;
+
+    if (m_d->handJobs.size() > 1) {
+        m_d->strokesFacade->addJob(m_d->strokeId,
+                                   new FreehandStrokeStrategy::MultiHandData(m_d->handJobs));
+    } else if (!m_d->handJobs.isEmpty()) {
+        m_d->strokesFacade->addJob(m_d->strokeId, m_d->handJobs.first());
+    }
 
+    m_d->handJobs.clear();
 }
 
 void KisToolFreehandHelper::createPainters(QVector<KisFreehandStrokeInfo*> &strokeInfos,
@@ -8,6 +8,7 @@
 #define __KIS_TOOL_FREEHAND_HELPER_H
 
 #include <QObject>
+#include <QLineF>
 #include <QVector>
 
 #include "kis_types.h"
@@ -67,6 +68,19 @@ public:
     void paintEvent(KoPointerEvent *event);
     void endPaint();
 
+    /**
+     * Extrapolates the motion of the pen from the latest input event
+     * using its current speed. The predicted segment is used only for
+     * the preview on the canvas, the stroke itself is painted with the
+     * real events only, so every new event simply replaces the previous
+     * prediction.
+     *
+     * @return the segment from the latest cursor position to the
+     * predicted one, or a null line if the prediction is disabled or
+     * there is no stroke running
+     */
+    QLineF predictedStrokeSegment() const;
+
     QPainterPath paintOpOutline(const QPointF &savedCursorPos,
                                 const KoPointerEvent *event,
                                 const KisPaintOpSettingsSP globalSettings,
@@ -115,6 +129,14 @@ protected:
                           const QPointF &control2,
                           const KisPaintInformation &pi2);
 
+    /**
+     * The segments of all the hands painted between the two calls are
+     * sent to the stroke as a single job, which lets the stroke paint
+     * the hands in parallel, see FreehandStrokeStrategy::MultiHandData
+     */
+    void beginMultiHandJob();
+    void endMultiHandJob();
+
     // hi-level methods for painting primitives
 
     virtual void paintAt(const KisPaintInformation &pi);
@@ -72,6 +72,8 @@ void adjustPointInformationRotation(KisPaintInformation &pi, const QTransform &t
 
 void KisToolMultihandHelper::paintAt(const KisPaintInformation &pi)
 {
+    beginMultiHandJob();
+
     for (int i = 0; i < d->transformations.size(); i++) {
         const QTransform &transform = d->transformations[i];
         KisPaintInformation __pi = pi;
@@ -79,11 +81,15 @@ void KisToolMultihandHelper::paintAt(const KisPaintInformation &pi)
         adjustPointInformationRotation(__pi, transform);
         paintAt(i, __pi);
     }
+
+    endMultiHandJob();
 }
 
 void KisToolMultihandHelper::paintLine(const KisPaintInformation &pi1,
                                        const KisPaintInformation &pi2)
 {
+    beginMultiHandJob();
+
     for (int i = 0; i < d->transformations.size(); i++) {
         const QTransform &transform = d->transformations[i];
 
@@ -97,6 +103,8 @@ void KisToolMultihandHelper::paintLine(const KisPaintInformation &pi1,
 
         paintLine(i, __pi1, __pi2);
     }
+
+    endMultiHandJob();
 }
 
 void KisToolMultihandHelper::paintBezierCurve(const KisPaintInformation &pi1,
@@ -104,6 +112,8 @@ void KisToolMultihandHelper::paintBezierCurve(const KisPaintInformation &pi1,
                                               const QPointF &control2,
                                               const KisPaintInformation &pi2)
 {
+    beginMultiHandJob();
+
     for (int i = 0; i < d->transformations.size(); i++) {
         const QTransform &transform = d->transformations[i];
 
@@ -120,4 +130,6 @@ void KisToolMultihandHelper::paintBezierCurve(const KisPaintInformation &pi1,
 
         paintBezierCurve(i, __pi1, __control1, __control2, __pi2);
     }
+
+    endMultiHandJob();
 }
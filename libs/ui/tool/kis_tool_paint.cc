@@ -368,6 +368,22 @@ void KisToolPaint::addPickerJob(const PickingJob &pickingJob)
         currentColor = canvas()->resourceManager()->backgroundColor();
     }
 
+    /**
+     * The paint devices can be read concurrently with the updates, so
+     * when the image is not in the level of detail mode, the color is
+     * sampled right away instead of waiting in the strokes queue behind
+     * the pending merges. The level of detail planes are sampled by the
+     * stroke, which knows how to map the point into them.
+     */
+    if (image()->currentLevelOfDetail() == 0) {
+        KoColor color;
+        if (KisToolUtils::pickColor(color, device, imagePoint, &currentColor,
+                                    m_pickerRadius, m_pickerBlend)) {
+            slotColorPickingFinished(color);
+        }
+        return;
+    }
+
     image()->addJob(m_pickerStrokeId,
                     new KisColorPickerStrokeStrategy::Data(device, imagePoint, currentColor));
 }
@@ -378,6 +394,11 @@ void KisToolPaint::beginAlternateAction(KoPointerEvent *event, AlternateAction a
         KIS_ASSERT_RECOVER_RETURN(!m_pickerStrokeId);
         setMode(SECONDARY_PAINT_MODE);
 
+        KisToolUtils::ColorPickerConfig config;
+        config.load();
+        m_pickerRadius = qMax(1, config.radius);
+        m_pickerBlend = config.blend;
+
         KisColorPickerStrokeStrategy *strategy = new KisColorPickerStrokeStrategy();
         connect(strategy, &KisColorPickerStrokeStrategy::sigColorUpdated,
                 this, &KisToolPaint::slotColorPickingFinished);
@@ -176,6 +176,8 @@ private:
 
     KisStrokeId m_pickerStrokeId;
     int m_pickingResource {0};
+    int m_pickerRadius {1};
+    int m_pickerBlend {100};
     typedef KisSignalCompressorWithParam<PickingJob> PickingCompressor;
     QScopedPointer<PickingCompressor> m_colorPickingCompressor;
 
@@ -7,10 +7,12 @@
 
 #include <kis_tool_utils.h>
 
+#include <cmath>
+#include <QtMath>
+
 #include <KoMixColorsOp.h>
 #include <kis_group_layer.h>
 #include <kis_transaction.h>
-#include <kis_sequential_iterator.h>
 #include <kis_properties_configuration.h>
 #include <kconfiggroup.h>
 #include <ksharedconfig.h>
@@ -37,25 +39,47 @@ namespace KisToolUtils {
 
         // Sampling radius.
         if (!pure && radius > 1) {
-            QVector<const quint8*> pixels;
             const int effectiveRadius = radius - 1;
+            const int pixelSize = cs->pixelSize();
 
             const QRect pickRect(pos.x() - effectiveRadius, pos.y() - effectiveRadius,
                                  2 * effectiveRadius + 1, 2 * effectiveRadius + 1);
-            KisSequentialConstIterator it(dev, pickRect);
 
             const int radiusSq = pow2(effectiveRadius);
 
-            while (it.nextPixel()) {
-                const QPoint realPos(it.x(),  it.y());
-                const QPoint pt = realPos - pos;
-                if (pow2(pt.x()) + pow2(pt.y()) < radiusSq) {
-                    pixels << it.oldRawData();
+            /**
+             * Read the whole area at once and pack the rows of the circle
+             * together, so that the colors are mixed from one contiguous
+             * array, which the mixing op processes much faster than an
+             * array of pointers to the pixels
+             */
+            QVector<quint8> pixels(pickRect.width() * pickRect.height() * pixelSize);
+            dev->readBytes(pixels.data(), pickRect);
+
+            quint8 *dstPtr = pixels.data();
+            int numPixels = 0;
+
+            for (int y = 0; y < pickRect.height(); y++) {
+                const int dy = y - effectiveRadius;
+
+                // the pixels of the row with dx^2 + dy^2 < radius^2
+                int halfWidth = qFloor(std::sqrt(qreal(radiusSq - pow2(dy))));
+                while (halfWidth >= 0 && pow2(halfWidth) + pow2(dy) >= radiusSq) {
+                    halfWidth--;
                 }
+                if (halfWidth < 0) continue;
+
+                const int spanWidth = 2 * halfWidth + 1;
+                const quint8 *srcPtr = pixels.constData() +
+                    (y * pickRect.width() + effectiveRadius - halfWidth) * pixelSize;
+
+                // the packed data never overtakes the source rows
+                memmove(dstPtr, srcPtr, spanWidth * pixelSize);
+                dstPtr += spanWidth * pixelSize;
+                numPixels += spanWidth;
             }
 
-            const quint8 **cpixels = const_cast<const quint8**>(pixels.constData());
-            cs->mixColorsOp()->mixColors(cpixels, pixels.size(), pickedColor.data());
+            cs->mixColorsOp()->mixColors(pixels.constData(), numPixels, pickedColor.data());
         } else {
             dev->pixel(pos.x(), pos.y(), &pickedColor);
         }
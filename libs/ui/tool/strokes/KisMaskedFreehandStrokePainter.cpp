@@ -11,6 +11,8 @@
 #include "KisFreehandStrokeInfo.h"
 #include "kis_paintop.h"
 #include "kis_paintop_preset.h"
+#include "kis_paint_device.h"
+#include "kis_random_accessor_ng.h"
 
 
 KisMaskedFreehandStrokePainter::KisMaskedFreehandStrokePainter(KisFreehandStrokeInfo *strokeData, KisFreehandStrokeInfo *maskData)
@@ -159,3 +161,30 @@ bool KisMaskedFreehandStrokePainter::hasMasking() const
     return m_mask;
 }
 
+bool KisMaskedFreehandStrokePainter::hasMirroringOrWrapAround() const
+{
+    KisPaintDeviceSP device = m_stroke->painter->device();
+
+    return m_stroke->painter->hasMirroring() ||
+        (device && device->defaultBounds()->wrapAroundMode());
+}
+
+void KisMaskedFreehandStrokePainter::prefetchTiles(const QRect &rect)
+{
+    applyToAllPainters([&] (KisFreehandStrokeInfo *data) {
+        KisPaintDeviceSP device = data->painter->device();
+        if (!device) return;
+
+        KisRandomAccessorSP it = device->createRandomAccessorNG();
+
+        // requesting the writable data of a single pixel is enough to
+        // create the whole tile and register it in the transaction
+        for (int y = rect.y(); y <= rect.bottom(); y += it->numContiguousRows(y)) {
+            for (int x = rect.x(); x <= rect.right(); x += it->numContiguousColumns(x)) {
+                it->moveTo(x, y);
+                it->rawData();
+            }
+        }
+    });
+}
+
@@ -65,6 +65,23 @@ public:
 
     bool hasMasking() const;
 
+    /**
+     * @return true if the painters may paint far from the painted
+     * segment, i.e. when the canvas mirroring or the wrap-around mode
+     * is active
+     */
+    bool hasMirroringOrWrapAround() const;
+
+    /**
+     * Creates the tiles of the painted devices in \p rect in advance,
+     * so that the brush doesn't have to allocate them and register
+     * their undo mementos when it reaches them. The pixels are not
+     * changed.
+     *
+     * Can be called concurrently with the painting functions.
+     */
+    void prefetchTiles(const QRect &rect);
+
 private:
     template <class Func>
     inline void applyToAllPainters(Func func);
@@ -6,13 +6,14 @@
 
 #include "KisMaskingBrushRenderer.h"
 
+#include <cstring>
+
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoChannelInfo.h>
 #include <KoCompositeOpRegistry.h>
 
-#include "kis_painter.h"
 #include "kis_paint_device.h"
 #include "kis_random_accessor_ng.h"
 
@@ -74,9 +75,16 @@ void KisMaskingBrushRenderer::updateProjection(const QRect &rc)
 {
     if (rc.isEmpty()) return;
 
-    KisPainter::copyAreaOptimized(rc.topLeft(), m_strokeDevice, m_dstDevice, rc);
+    /**
+     * The stroke pixels are copied into the destination and masked
+     * in the same pass, chunk by chunk, so that every destination
+     * tile is visited only once while it is still in cache
+     */
+
+    const int pixelSize = m_dstDevice->pixelSize();
 
     KisRandomAccessorSP dstIt = m_dstDevice->createRandomAccessorNG();
+    KisRandomConstAccessorSP strokeIt = m_strokeDevice->createRandomConstAccessorNG();
     KisRandomConstAccessorSP maskIt = m_maskDevice->createRandomConstAccessorNG();
 
     qint32 dstY = rc.y();
@@ -86,24 +94,39 @@ void KisMaskingBrushRenderer::updateProjection(const QRect &rc)
         qint32 dstX = rc.x();
 
         const qint32 numContiguousDstRows = dstIt->numContiguousRows(dstY);
+        const qint32 numContiguousStrokeRows = strokeIt->numContiguousRows(dstY);
         const qint32 numContiguousMaskRows = maskIt->numContiguousRows(dstY);
 
-        const qint32 rows = std::min({rowsRemaining, numContiguousDstRows, numContiguousMaskRows});
+        const qint32 rows = std::min({rowsRemaining, numContiguousDstRows,
+                                      numContiguousStrokeRows, numContiguousMaskRows});
 
         qint32 columnsRemaining = rc.width();
 
         while (columnsRemaining > 0) {
 
             const qint32 numContiguousDstColumns = dstIt->numContiguousColumns(dstX);
+            const qint32 numContiguousStrokeColumns = strokeIt->numContiguousColumns(dstX);
             const qint32 numContiguousMaskColumns = maskIt->numContiguousColumns(dstX);
-            const qint32 columns = std::min({columnsRemaining, numContiguousDstColumns, numContiguousMaskColumns});
+            const qint32 columns = std::min({columnsRemaining, numContiguousDstColumns,
+                                             numContiguousStrokeColumns, numContiguousMaskColumns});
 
             const qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
+            const qint32 strokeRowStride = strokeIt->rowStride(dstX, dstY);
             const qint32 maskRowStride = maskIt->rowStride(dstX, dstY);
 
             dstIt->moveTo(dstX, dstY);
+            strokeIt->moveTo(dstX, dstY);
             maskIt->moveTo(dstX, dstY);
 
+            quint8 *dstPtr = dstIt->rawData();
+            const quint8 *strokePtr = strokeIt->rawDataConst();
+
+            for (qint32 row = 0; row < rows; row++) {
+                memcpy(dstPtr, strokePtr, columns * pixelSize);
+                dstPtr += dstRowStride;
+                strokePtr += strokeRowStride;
+            }
+
             m_compositeOp->composite(maskIt->rawDataConst(), maskRowStride,
                                      dstIt->rawData(), dstRowStride,
                                      columns, rows);
@@ -116,4 +139,3 @@ void KisMaskingBrushRenderer::updateProjection(const QRect &rc)
         rowsRemaining -= rows;
     }
 }
-
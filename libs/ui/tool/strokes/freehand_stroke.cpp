@@ -17,11 +17,13 @@
 #include "kis_paintop.h"
 
 #include "kis_update_time_monitor.h"
+#include "KisStrokeLatencyMonitor.h"
 
 #include <brushengine/kis_stroke_random_source.h>
 #include <KisRunnableStrokeJobsInterface.h>
 #include "FreehandStrokeRunnableJobDataWithUpdate.h"
 #include <mutex>
+#include <QtConcurrent>
 
 #include "KisStrokeEfficiencyMeasurer.h"
 #include <KisStrokeSpeedMonitor.h>
@@ -29,6 +31,7 @@
 #include <strokes/KisMaskedFreehandStrokePainter.h>
 
 #include "brushengine/kis_paintop_utils.h"
+#include "kis_algebra_2d.h"
 #include "KisAsyncronousStrokeUpdateHelper.h"
 
 struct FreehandStrokeStrategy::Private
@@ -142,70 +145,48 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
         tryDoUpdate(d->forceUpdate);
 
     } else if (Data *d = dynamic_cast<Data*>(data)) {
-        KisMaskedFreehandStrokePainter *maskedPainter = this->maskedPainter(d->strokeInfoId);
+        KisUpdateTimeMonitor::instance()->reportPaintOpPreset(maskedPainter(d->strokeInfoId)->preset());
+
+        paintData(d, m_d->randomSource.source(), m_d->randomSource.perStrokeSource());
+        measureData(d);
+
+        tryDoUpdate();
+    } else if (MultiHandData *d = dynamic_cast<MultiHandData*>(data)) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN(!d->hands.isEmpty());
+
+        KisUpdateTimeMonitor::instance()->reportPaintOpPreset(maskedPainter(d->hands.first()->strokeInfoId)->preset());
 
-        KisUpdateTimeMonitor::instance()->reportPaintOpPreset(maskedPainter->preset());
         KisRandomSourceSP rnd = m_d->randomSource.source();
         KisPerStrokeRandomSourceSP strokeRnd = m_d->randomSource.perStrokeSource();
 
-        switch(d->type) {
-        case Data::POINT:
-            d->pi1.setRandomSource(rnd);
-            d->pi1.setPerStrokeRandomSource(strokeRnd);
-            maskedPainter->paintAt(d->pi1);
-            m_d->efficiencyMeasurer.addSample(d->pi1.pos());
-            break;
-        case Data::LINE:
-            d->pi1.setRandomSource(rnd);
-            d->pi2.setRandomSource(rnd);
-            d->pi1.setPerStrokeRandomSource(strokeRnd);
-            d->pi2.setPerStrokeRandomSource(strokeRnd);
-            maskedPainter->paintLine(d->pi1, d->pi2);
-            m_d->efficiencyMeasurer.addSample(d->pi2.pos());
-            break;
-        case Data::CURVE:
-            d->pi1.setRandomSource(rnd);
-            d->pi2.setRandomSource(rnd);
-            d->pi1.setPerStrokeRandomSource(strokeRnd);
-            d->pi2.setPerStrokeRandomSource(strokeRnd);
-            maskedPainter->paintBezierCurve(d->pi1,
-                                         d->control1,
-                                         d->control2,
-                                         d->pi2);
-            m_d->efficiencyMeasurer.addSample(d->pi2.pos());
-            break;
-        case Data::POLYLINE:
-            maskedPainter->paintPolyline(d->points, 0, d->points.size());
-            m_d->efficiencyMeasurer.addSamples(d->points);
-            break;
-        case Data::POLYGON:
-            maskedPainter->paintPolygon(d->points);
-            m_d->efficiencyMeasurer.addSamples(d->points);
-            break;
-        case Data::RECT:
-            maskedPainter->paintRect(d->rect);
-            m_d->efficiencyMeasurer.addSample(d->rect.topLeft());
-            m_d->efficiencyMeasurer.addSample(d->rect.topRight());
-            m_d->efficiencyMeasurer.addSample(d->rect.bottomRight());
-            m_d->efficiencyMeasurer.addSample(d->rect.bottomLeft());
-            break;
-        case Data::ELLIPSE:
-            maskedPainter->paintEllipse(d->rect);
-            // TODO: add speed measures
-            break;
-        case Data::PAINTER_PATH:
-            maskedPainter->paintPainterPath(d->path);
-            // TODO: add speed measures
-            break;
-        case Data::QPAINTER_PATH:
-            maskedPainter->drawPainterPath(d->path, d->pen);
-            break;
-        case Data::QPAINTER_PATH_FILL:
-            maskedPainter->drawAndFillPainterPath(d->path, d->pen, d->customColor);
-            break;
-        };
+        if (canPaintHandsInParallel(d->hands)) {
+            /**
+             * KisRandomSource is not thread-safe, so every hand gets its
+             * own source. The seeds are taken from the stroke's source,
+             * so the LoD and LoD0 strokes still get the same values.
+             */
+            QVector<std::pair<Data*, KisRandomSourceSP>> hands;
+            Q_FOREACH (Data *hand, d->hands) {
+                hands.append(std::make_pair(hand, KisRandomSourceSP(new KisRandomSource(int(rnd->generate())))));
+            }
+
+            QtConcurrent::blockingMap(hands,
+                [this, strokeRnd] (std::pair<Data*, KisRandomSourceSP> &hand) {
+                    paintData(hand.first, hand.second, strokeRnd);
+                });
+        } else {
+            Q_FOREACH (Data *hand, d->hands) {
+                paintData(hand, rnd, strokeRnd);
+            }
+        }
+
+        Q_FOREACH (Data *hand, d->hands) {
+            measureData(hand);
+        }
 
         tryDoUpdate();
+    } else if (PrefetchData *d = dynamic_cast<PrefetchData*>(data)) {
+        maskedPainter(d->strokeInfoId)->prefetchTiles(d->rect);
     } else {
         KisPainterBasedStrokeStrategy::doStrokeCallback(data);
 
@@ -218,6 +199,136 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
     }
 }
 
+void FreehandStrokeStrategy::paintData(Data *d, KisRandomSourceSP rnd, KisPerStrokeRandomSourceSP strokeRnd)
+{
+    KisMaskedFreehandStrokePainter *maskedPainter = this->maskedPainter(d->strokeInfoId);
+
+    switch(d->type) {
+    case Data::POINT:
+        d->pi1.setRandomSource(rnd);
+        d->pi1.setPerStrokeRandomSource(strokeRnd);
+        maskedPainter->paintAt(d->pi1);
+        break;
+    case Data::LINE:
+        d->pi1.setRandomSource(rnd);
+        d->pi2.setRandomSource(rnd);
+        d->pi1.setPerStrokeRandomSource(strokeRnd);
+        d->pi2.setPerStrokeRandomSource(strokeRnd);
+        maskedPainter->paintLine(d->pi1, d->pi2);
+        break;
+    case Data::CURVE:
+        d->pi1.setRandomSource(rnd);
+        d->pi2.setRandomSource(rnd);
+        d->pi1.setPerStrokeRandomSource(strokeRnd);
+        d->pi2.setPerStrokeRandomSource(strokeRnd);
+        maskedPainter->paintBezierCurve(d->pi1,
+                                     d->control1,
+                                     d->control2,
+                                     d->pi2);
+        break;
+    case Data::POLYLINE:
+        maskedPainter->paintPolyline(d->points, 0, d->points.size());
+        break;
+    case Data::POLYGON:
+        maskedPainter->paintPolygon(d->points);
+        break;
+    case Data::RECT:
+        maskedPainter->paintRect(d->rect);
+        break;
+    case Data::ELLIPSE:
+        maskedPainter->paintEllipse(d->rect);
+        break;
+    case Data::PAINTER_PATH:
+        maskedPainter->paintPainterPath(d->path);
+        break;
+    case Data::QPAINTER_PATH:
+        maskedPainter->drawPainterPath(d->path, d->pen);
+        break;
+    case Data::QPAINTER_PATH_FILL:
+        maskedPainter->drawAndFillPainterPath(d->path, d->pen, d->customColor);
+        break;
+    };
+
+    if (d->type == Data::POINT) {
+        KisStrokeLatencyMonitor::instance()->reportEventPainted(d->pi1.inputEventId());
+    } else if (d->type == Data::LINE || d->type == Data::CURVE) {
+        KisStrokeLatencyMonitor::instance()->reportEventPainted(d->pi2.inputEventId());
+    }
+}
+
+void FreehandStrokeStrategy::measureData(Data *d)
+{
+    switch(d->type) {
+    case Data::POINT:
+        m_d->efficiencyMeasurer.addSample(d->pi1.pos());
+        break;
+    case Data::LINE:
+    case Data::CURVE:
+        m_d->efficiencyMeasurer.addSample(d->pi2.pos());
+        break;
+    case Data::POLYLINE:
+    case Data::POLYGON:
+        m_d->efficiencyMeasurer.addSamples(d->points);
+        break;
+    case Data::RECT:
+        m_d->efficiencyMeasurer.addSample(d->rect.topLeft());
+        m_d->efficiencyMeasurer.addSample(d->rect.topRight());
+        m_d->efficiencyMeasurer.addSample(d->rect.bottomRight());
+        m_d->efficiencyMeasurer.addSample(d->rect.bottomLeft());
+        break;
+    default:
+        // TODO: add speed measures
+        break;
+    };
+}
+
+bool FreehandStrokeStrategy::canPaintHandsInParallel(const QVector<Data*> &hands)
+{
+    if (hands.size() < 2) return false;
+
+    QVector<QRect> areas;
+
+    Q_FOREACH (Data *hand, hands) {
+        KisMaskedFreehandStrokePainter *maskedPainter = this->maskedPainter(hand->strokeInfoId);
+        if (maskedPainter->hasMirroringOrWrapAround()) return false;
+
+        QRectF bounds;
+
+        switch (hand->type) {
+        case Data::POINT:
+            bounds = QRectF(hand->pi1.pos(), hand->pi1.pos());
+            break;
+        case Data::LINE:
+            bounds = QRectF(hand->pi1.pos(), hand->pi2.pos()).normalized();
+            break;
+        case Data::CURVE:
+            // the curve lies inside the convex hull of its control points
+            bounds = KisAlgebra2D::accumulateBounds(
+                QVector<QPointF>({hand->pi1.pos(), hand->control1, hand->control2, hand->pi2.pos()}));
+            break;
+        default:
+            return false;
+        }
+
+        /**
+         * The dabs may be bigger than the nominal size of the brush due
+         * to the sensors and may be scattered around the segment, so the
+         * margin is generous. The hands are usually far from each other
+         * anyway.
+         */
+        const qreal margin = 2.0 * maskedPainter->preset()->settings()->paintOpSize() + 2.0;
+        const QRect area = bounds.adjusted(-margin, -margin, margin, margin).toAlignedRect();
+
+        Q_FOREACH (const QRect &rc, areas) {
+            if (rc.intersects(area)) return false;
+        }
+
+        areas.append(area);
+    }
+
+    return true;
+}
+
 void FreehandStrokeStrategy::tryDoUpdate(bool forceEnd)
 {
     // we should enter this function only once!
@@ -308,6 +419,7 @@ void FreehandStrokeStrategy::issueSetDirtySignals()
 
         jobs.append(new KisRunnableStrokeJobData(
             [this, dirtyRects] () {
+                this->reportDirtyRectsLatency(dirtyRects);
                 this->targetNode()->setDirty(dirtyRects);
             },
             KisStrokeJobData::SEQUENTIAL));
@@ -315,12 +427,22 @@ void FreehandStrokeStrategy::issueSetDirtySignals()
         runnableJobsInterface()->addRunnableJobs(jobs);
 
     } else {
+        reportDirtyRectsLatency(dirtyRects);
         targetNode()->setDirty(dirtyRects);
     }
 
     //KisUpdateTimeMonitor::instance()->reportJobFinished(data, dirtyRects);
 }
 
+void FreehandStrokeStrategy::reportDirtyRectsLatency(const QVector<QRect> &dirtyRects)
+{
+    KisStrokeLatencyMonitor *monitor = KisStrokeLatencyMonitor::instance();
+    if (!monitor->isEnabled()) return;
+
+    monitor->reportDirtyRects(dirtyRects,
+                              targetNode()->projection()->defaultBounds()->currentLevelOfDetail());
+}
+
 KisStrokeStrategy* FreehandStrokeStrategy::createLodClone(int levelOfDetail)
 {
     if (!m_d->resources->presetAllowsLod()) return 0;
@@ -164,6 +164,72 @@ public:
         KoColor customColor;
     };
 
+    /**
+     * The segments of all the hands of a multihand stroke coming from the
+     * same input event. The hands are painted in parallel when the areas
+     * they are going to touch do not intersect, otherwise they are painted
+     * one after another, like separate Data jobs would be.
+     */
+    class MultiHandData : public KisStrokeJobData {
+    public:
+        MultiHandData(const QVector<Data*> &_hands)
+            : KisStrokeJobData(KisStrokeJobData::UNIQUELY_CONCURRENT),
+              hands(_hands)
+        {}
+
+        ~MultiHandData() override {
+            qDeleteAll(hands);
+        }
+
+        KisStrokeJobData* createLodClone(int levelOfDetail) override {
+            return new MultiHandData(*this, levelOfDetail);
+        }
+
+    private:
+        MultiHandData(const MultiHandData &rhs, int levelOfDetail)
+            : KisStrokeJobData(rhs)
+        {
+            Q_FOREACH (Data *hand, rhs.hands) {
+                hands << static_cast<Data*>(hand->createLodClone(levelOfDetail));
+            }
+        }
+
+    public:
+        QVector<Data*> hands;
+    };
+
+    /**
+     * Asks the stroke to create the tiles of the area the brush is
+     * predicted to reach soon, see KisMaskedFreehandStrokePainter::prefetchTiles().
+     * The job is concurrent, so it is run on a spare thread while the dabs
+     * are being painted.
+     */
+    class PrefetchData : public KisStrokeJobData {
+    public:
+        PrefetchData(int _strokeInfoId, const QRect &_rect)
+            : KisStrokeJobData(KisStrokeJobData::CONCURRENT),
+              strokeInfoId(_strokeInfoId),
+              rect(_rect)
+        {}
+
+        KisStrokeJobData* createLodClone(int levelOfDetail) override {
+            return new PrefetchData(*this, levelOfDetail);
+        }
+
+    private:
+        PrefetchData(const PrefetchData &rhs, int levelOfDetail)
+            : KisStrokeJobData(rhs),
+              strokeInfoId(rhs.strokeInfoId)
+        {
+            KisLodTransform t(levelOfDetail);
+            rect = t.map(rhs.rect);
+        }
+
+    public:
+        int strokeInfoId;
+        QRect rect;
+    };
+
 public:
     FreehandStrokeStrategy(KisResourcesSnapshotSP resources,
                            KisFreehandStrokeInfo *strokeInfo,
@@ -191,8 +257,13 @@ protected:
 private:
     void init();
 
+    void paintData(Data *d, KisRandomSourceSP rnd, KisPerStrokeRandomSourceSP strokeRnd);
+    void measureData(Data *d);
+    bool canPaintHandsInParallel(const QVector<Data*> &hands);
+
     void tryDoUpdate(bool forceEnd = false);
     void issueSetDirtySignals();
+    void reportDirtyRectsLatency(const QVector<QRect> &dirtyRects);
 
 private:
     struct Private;
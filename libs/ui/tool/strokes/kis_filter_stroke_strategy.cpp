@@ -9,7 +9,138 @@
 #include <filter/kis_filter.h>
 #include <filter/kis_filter_configuration.h>
 #include <kis_transaction.h>
+#include <kis_default_bounds_base.h>
 #include <KoCompositeOpRegistry.h>
+#include <KoColorSpace.h>
+#include <KoMixColorsOp.h>
+
+#include <cstring>
+
+
+namespace {
+
+/**
+ * Default bounds of the temporary devices of the preview passes. The
+ * filters check the level of detail of the device to scale their
+ * configuration.
+ */
+class LodPreviewDefaultBounds : public KisDefaultBoundsBase
+{
+public:
+    LodPreviewDefaultBounds(KisDefaultBoundsBaseSP base, int levelOfDetail)
+        : m_base(base),
+          m_levelOfDetail(levelOfDetail)
+    {
+    }
+
+    QRect bounds() const override {
+        return KisLodTransform(m_levelOfDetail).map(m_base->bounds());
+    }
+
+    bool wrapAroundMode() const override {
+        return m_base->wrapAroundMode();
+    }
+
+    int currentLevelOfDetail() const override {
+        return m_levelOfDetail;
+    }
+
+    int currentTime() const override {
+        return m_base->currentTime();
+    }
+
+    bool externalFrameActive() const override {
+        return m_base->externalFrameActive();
+    }
+
+    void* sourceCookie() const override {
+        return m_base->sourceCookie();
+    }
+
+private:
+    KisDefaultBoundsBaseSP m_base;
+    int m_levelOfDetail;
+};
+
+/**
+ * Averages the blocks of \p src into the pixels of \p dst,
+ * \p dstRect is in the coordinates of \p levelOfDetail
+ */
+void downscaleDevice(KisPaintDeviceSP src, KisPaintDeviceSP dst,
+                     const QRect &dstRect, int levelOfDetail)
+{
+    const int factor = 1 << levelOfDetail;
+    const int pixelSize = src->pixelSize();
+    const KoMixColorsOp *mixOp = src->colorSpace()->mixColorsOp();
+
+    const QRect srcRect = KisLodTransform::upscaledRect(dstRect, levelOfDetail);
+
+    QVector<quint8> srcRows(srcRect.width() * factor * pixelSize);
+    QVector<quint8> block(factor * factor * pixelSize);
+    QVector<quint8> dstRow(dstRect.width() * pixelSize);
+
+    for (int row = 0; row < dstRect.height(); row++) {
+        src->readBytes(srcRows.data(),
+                       QRect(srcRect.x(), srcRect.y() + row * factor,
+                             srcRect.width(), factor));
+
+        for (int col = 0; col < dstRect.width(); col++) {
+            quint8 *blockPtr = block.data();
+
+            for (int y = 0; y < factor; y++) {
+                const quint8 *srcPtr =
+                    srcRows.constData() + (y * srcRect.width() + col * factor) * pixelSize;
+                std::memcpy(blockPtr, srcPtr, factor * pixelSize);
+                blockPtr += factor * pixelSize;
+            }
+
+            mixOp->mixColors(block.constData(), factor * factor,
+                             dstRow.data() + col * pixelSize);
+        }
+
+        dst->writeBytes(dstRow.constData(),
+                        QRect(dstRect.x(), dstRect.y() + row, dstRect.width(), 1));
+    }
+}
+
+/**
+ * Stretches \p src of \p levelOfDetail into \p dstRect of \p dst
+ */
+void upscaleDevice(KisPaintDeviceSP src, KisPaintDeviceSP dst,
+                   const QRect &dstRect, int levelOfDetail)
+{
+    const int pixelSize = src->pixelSize();
+
+    const QRect srcRect =
+        KisLodTransform::scaledRect(KisLodTransform::alignedRect(dstRect, levelOfDetail), levelOfDetail);
+
+    QVector<quint8> srcRow(srcRect.width() * pixelSize);
+    QVector<quint8> dstRow(dstRect.width() * pixelSize);
+
+    int lastSrcY = srcRect.y() - 1;
+
+    for (int y = dstRect.top(); y <= dstRect.bottom(); y++) {
+        const int srcY = y >> levelOfDetail;
+
+        if (srcY != lastSrcY) {
+            src->readBytes(srcRow.data(), QRect(srcRect.x(), srcY, srcRect.width(), 1));
+
+            quint8 *dstPtr = dstRow.data();
+            for (int x = dstRect.left(); x <= dstRect.right(); x++) {
+                const int srcX = (x >> levelOfDetail) - srcRect.x();
+                std::memcpy(dstPtr, srcRow.constData() + srcX * pixelSize, pixelSize);
+                dstPtr += pixelSize;
+            }
+
+            lastSrcY = srcY;
+        }
+
+        dst->writeBytes(dstRow.constData(), QRect(dstRect.x(), y, dstRect.width(), 1));
+    }
+}
+
+}
+
 
 
 struct KisFilterStrokeStrategy::Private {
@@ -17,7 +148,8 @@ struct KisFilterStrokeStrategy::Private {
         : updatesFacade(0),
           cancelSilently(false),
           secondaryTransaction(0),
-          levelOfDetail(0)
+          levelOfDetail(0),
+          hasLodBuddy(false)
     {
     }
 
@@ -31,7 +163,8 @@ struct KisFilterStrokeStrategy::Private {
           filterDeviceBounds(),
           secondaryTransaction(0),
           progressHelper(),
-          levelOfDetail(0)
+          levelOfDetail(0),
+          hasLodBuddy(false)
     {
         KIS_ASSERT_RECOVER_RETURN(!rhs.filterDevice);
         KIS_ASSERT_RECOVER_RETURN(rhs.filterDeviceBounds.isEmpty());
@@ -52,6 +185,20 @@ struct KisFilterStrokeStrategy::Private {
     QScopedPointer<KisProcessingVisitor::ProgressHelper> progressHelper;
 
     int levelOfDetail;
+
+    /**
+     * The lod0 stroke is executed only after the lodN one has been
+     * finished, so the preview passes are useless for it
+     */
+    bool hasLodBuddy;
+
+    /**
+     * When the preview passes are used, the layer contains a coarse
+     * result when the full resolution jobs start, so they read the
+     * data from the snapshots of the original devices
+     */
+    KisPaintDeviceSP sourceSnapshot;
+    KisPaintDeviceSP targetSnapshot;
 };
 
 
@@ -121,23 +268,39 @@ void KisFilterStrokeStrategy::initStrokeCallback()
 void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
 {
     Data *d = dynamic_cast<Data*>(data);
+    PreviewData *previewJob = dynamic_cast<PreviewData*>(data);
+    PreviewPassMarker *previewMarker = dynamic_cast<PreviewPassMarker*>(data);
     CancelSilentlyMarker *cancelJob =
         dynamic_cast<CancelSilentlyMarker*>(data);
 
     if (d) {
         const QRect rc = d->processRect;
 
+        // the filter is going to be reverted anyway
+        if (isCancellationRequested()) return;
+
         if (!m_d->filterDeviceBounds.intersects(
                 m_d->filter->neededRect(rc, m_d->filterConfig.data(), m_d->levelOfDetail))) {
 
             return;
         }
 
-        m_d->filter->processImpl(m_d->filterDevice, rc,
+        if (m_d->sourceSnapshot) {
+            m_d->filter->process(m_d->sourceSnapshot, m_d->filterDevice, KisSelectionSP(), rc,
                                  m_d->filterConfig.data(),
                                  m_d->progressHelper->updater());
+        } else {
+            m_d->filter->processImpl(m_d->filterDevice, rc,
+                                     m_d->filterConfig.data(),
+                                     m_d->progressHelper->updater());
+        }
 
         if (m_d->secondaryTransaction) {
+            if (m_d->targetSnapshot) {
+                // remove the preview, the selection would blend it into the result otherwise
+                KisPainter::copyAreaOptimized(rc.topLeft(), m_d->targetSnapshot, targetDevice(), rc);
+            }
+
             KisPainter::copyAreaOptimized(rc.topLeft(), m_d->filterDevice, targetDevice(), rc, activeSelection());
 
             // Free memory
@@ -145,6 +308,21 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
         }
 
         m_d->node->setDirty(rc);
+    } else if (previewJob) {
+        if (isCancellationRequested()) return;
+        if (!m_d->sourceSnapshot) return;
+
+        processPreview(previewJob->processRect, previewJob->levelOfDetail);
+    } else if (previewMarker) {
+        if (m_d->levelOfDetail > 0 || m_d->hasLodBuddy) return;
+
+        if (!m_d->sourceSnapshot) {
+            m_d->sourceSnapshot = new KisPaintDevice(*m_d->filterDevice);
+
+            if (m_d->secondaryTransaction) {
+                m_d->targetSnapshot = new KisPaintDevice(*targetDevice());
+            }
+        }
     } else if (cancelJob) {
         m_d->cancelSilently = true;
     } else {
@@ -152,10 +330,49 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
     }
 }
 
+void KisFilterStrokeStrategy::processPreview(const QRect &rc, int levelOfDetail)
+{
+    if (!m_d->filterDeviceBounds.intersects(
+            m_d->filter->neededRect(rc, m_d->filterConfig.data(), m_d->levelOfDetail))) {
+
+        return;
+    }
+
+    const KisFilterConfigurationSP config = m_d->filterConfig;
+    const KoColorSpace *cs = m_d->sourceSnapshot->colorSpace();
+
+    const QRect lodRect =
+        KisLodTransform::scaledRect(KisLodTransform::alignedRect(rc, levelOfDetail), levelOfDetail);
+
+    const QRect lodNeedRect = m_d->filter->neededRect(lodRect, config.data(), levelOfDetail);
+
+    KisPaintDeviceSP lodDevice = new KisPaintDevice(cs);
+    lodDevice->setDefaultBounds(
+        new LodPreviewDefaultBounds(m_d->sourceSnapshot->defaultBounds(), levelOfDetail));
+    lodDevice->setDefaultPixel(m_d->sourceSnapshot->defaultPixel());
+
+    downscaleDevice(m_d->sourceSnapshot, lodDevice, lodNeedRect, levelOfDetail);
+
+    if (isCancellationRequested()) return;
+
+    m_d->filter->processImpl(lodDevice, lodRect, config.data(), 0);
+
+    if (isCancellationRequested()) return;
+
+    KisPaintDeviceSP previewDevice = new KisPaintDevice(cs);
+    upscaleDevice(lodDevice, previewDevice, rc, levelOfDetail);
+
+    KisPainter::copyAreaOptimized(rc.topLeft(), previewDevice, targetDevice(), rc, activeSelection());
+
+    m_d->node->setDirty(rc);
+}
+
 void KisFilterStrokeStrategy::cancelStrokeCallback()
 {
     delete m_d->secondaryTransaction;
     m_d->filterDevice = 0;
+    m_d->sourceSnapshot = 0;
+    m_d->targetSnapshot = 0;
 
     if (m_d->cancelSilently) {
         m_d->updatesFacade->disableDirtyRequests();
@@ -172,6 +389,8 @@ void KisFilterStrokeStrategy::finishStrokeCallback()
 {
     delete m_d->secondaryTransaction;
     m_d->filterDevice = 0;
+    m_d->sourceSnapshot = 0;
+    m_d->targetSnapshot = 0;
 
     KisPainterBasedStrokeStrategy::finishStrokeCallback();
 }
@@ -182,5 +401,6 @@ KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
     if (!m_d->node->supportsLodPainting()) return 0;
 
     KisFilterStrokeStrategy *clone = new KisFilterStrokeStrategy(*this, levelOfDetail);
+    m_d->hasLodBuddy = true;
     return clone;
 }
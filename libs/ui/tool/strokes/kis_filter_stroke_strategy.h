@@ -37,6 +37,45 @@ public:
 
     };
 
+    /**
+     * Renders a quick preview of \p processRect at \p levelOfDetail
+     * and stretches it into the layer. The full resolution jobs
+     * replace it later.
+     *
+     * The preview jobs should be preceded by a PreviewPassMarker, so
+     * that the passes of different resolutions don't overlap and the
+     * original data of the layer is kept for the later passes.
+     */
+    class PreviewData : public KisStrokeJobData {
+    public:
+        PreviewData(const QRect &_processRect, int _levelOfDetail)
+            : KisStrokeJobData(CONCURRENT),
+              processRect(_processRect),
+              levelOfDetail(_levelOfDetail) {}
+
+        KisStrokeJobData* createLodClone(int levelOfDetail) override {
+            Q_UNUSED(levelOfDetail);
+
+            // the previews are not needed for the lodN strokes,
+            // they will just skip the job
+            return new PreviewData(*this);
+        }
+
+        QRect processRect;
+        int levelOfDetail;
+    };
+
+    class PreviewPassMarker : public KisStrokeJobData {
+    public:
+        PreviewPassMarker()
+            : KisStrokeJobData(SEQUENTIAL)
+        {}
+
+        KisStrokeJobData* createLodClone(int /*levelOfDetail*/) override {
+            return new PreviewPassMarker(*this);
+        }
+    };
+
     class CancelSilentlyMarker : public KisStrokeJobData {
     public:
         CancelSilentlyMarker()
@@ -64,6 +103,9 @@ public:
 
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
+private:
+    void processPreview(const QRect &rc, int levelOfDetail);
+
 private:
     struct Private;
     Private* const m_d;
@@ -11,13 +11,22 @@
 #include <KisDocument.h>
 #include <KisPart.h>
 #include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QDataStream>
+#include <QDateTime>
+#include <QImageReader>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+#include <exiv2/exiv2.hpp>
 
 #include <kis_debug.h>
 
 namespace
 {
 
-QIcon createIcon(const QImage &source, const QSize &iconSize)
+QImage createIconImage(const QImage &source, const QSize &iconSize)
 {
     QImage result;
     const int maxIconSize = qMax(iconSize.width(), iconSize.height());
@@ -31,7 +40,134 @@ QIcon createIcon(const QImage &source, const QSize &iconSize)
     painter.setPen(QColor("#40808080"));
     painter.drawRect(result.rect().adjusted(0, 0, -1, -1));
 
-    return QIcon(QPixmap::fromImage(result));
+    return result;
+}
+
+/**
+ * The thumbnails are cached on disk, so that the icons of the documents
+ * on slow or network drives are not read again every time Krita starts.
+ * The name of the cached file is built from the path of the document,
+ * its size and the time of its modification, so a changed document
+ * gets a new thumbnail.
+ */
+QString cachedIconPath(const QFileInfo &fileInfo, const QSize &iconSize)
+{
+    const QString key = QString("%1|%2|%3|%4x%5")
+        .arg(fileInfo.absoluteFilePath())
+        .arg(fileInfo.size())
+        .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+        .arg(iconSize.width()).arg(iconSize.height());
+
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+
+    return dir + "/" + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex() + ".png";
+}
+
+QSize fittingSize(const QSize &size, int maxIconSize)
+{
+    return size.scaled(maxIconSize, maxIconSize, Qt::KeepAspectRatio);
+}
+
+/**
+ * @return the thumbnail stored in the image resources of a PSD file,
+ * or a null image if there is none
+ */
+QImage loadPsdThumbnail(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QImage();
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    // skip the header
+    QByteArray signature = file.read(4);
+    if (signature != "8BPS" || !file.seek(26)) return QImage();
+
+    quint32 colorModeDataLength = 0;
+    stream >> colorModeDataLength;
+    if (!file.seek(file.pos() + colorModeDataLength)) return QImage();
+
+    quint32 resourcesLength = 0;
+    stream >> resourcesLength;
+    const qint64 resourcesEnd = file.pos() + resourcesLength;
+
+    while (file.pos() + 12 <= resourcesEnd && stream.status() == QDataStream::Ok) {
+        if (file.read(4) != "8BIM") break;
+
+        quint16 id = 0;
+        quint8 nameLength = 0;
+        stream >> id >> nameLength;
+
+        // the name is a Pascal string padded to an even size
+        const int paddedNameLength = (nameLength + 2) & ~1;
+        if (!file.seek(file.pos() + paddedNameLength - 1)) break;
+
+        quint32 size = 0;
+        stream >> size;
+        const qint64 dataEnd = file.pos() + size;
+
+        // the thumbnail resources are a 28 bytes header followed by JFIF data
+        if ((id == 1036 || id == 1033) && size > 28) {
+            file.seek(file.pos() + 28);
+            QImage image;
+            image.loadFromData(file.read(size - 28), "JPEG");
+
+            if (id == 1033) {
+                // Photoshop 4.0 stores the thumbnails in BGR order
+                image = image.rgbSwapped();
+            }
+            return image;
+        }
+
+        if (!file.seek(dataEnd + (size & 1))) break;
+    }
+
+    return QImage();
+}
+
+/**
+ * @return the thumbnail embedded in the Exif metadata of a file, or a
+ * null image if there is none
+ */
+QImage loadExifThumbnail(const QString &path)
+{
+    try {
+        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(QFile::encodeName(path).toStdString());
+        if (!image.get()) return QImage();
+
+        image->readMetadata();
+
+        Exiv2::ExifThumbC thumbnail(image->exifData());
+        Exiv2::DataBuf data = thumbnail.copy();
+
+        QImage result;
+        if (data.size_ > 0) {
+            result.loadFromData(reinterpret_cast<const uchar*>(data.pData_), data.size_);
+        }
+        return result;
+
+    } catch (std::exception &e) {
+        dbgFile << "Could not read the Exif thumbnail of" << path << e.what();
+    }
+
+    return QImage();
+}
+
+/**
+ * Loads the image at @p path, decoding it directly at the size of the
+ * icon when the format supports it (e.g. the DCT scaling of JPEG)
+ */
+QImage loadScaledImage(const QString &path, int maxIconSize)
+{
+    QImageReader reader(path);
+    const QSize size = reader.size();
+
+    if (size.isValid() && (size.width() > maxIconSize || size.height() > maxIconSize)) {
+        reader.setScaledSize(fittingSize(size, maxIconSize));
+    }
+
+    return reader.read();
 }
 
 }
@@ -45,70 +181,83 @@ bool KisFileIconCreator::createFileIcon(QString path, QIcon &icon, qreal deviceP
 {
     iconSize *= devicePixelRatioF;
     QFileInfo fi(path);
-    if (fi.exists()) {
-        QString mimeType = KisMimeDatabase::mimeTypeForFile(path);
-        if (mimeType == KisDocument::nativeFormatMimeType()
-               || mimeType == "image/openraster") {
-
-            QScopedPointer<KoStore> store(KoStore::createStore(path, KoStore::Read));
-            if (store) {
-                QString thumbnailpath;
-                if (store->hasFile(QString("Thumbnails/thumbnail.png"))){
-                    thumbnailpath = QString("Thumbnails/thumbnail.png");
-                }
-                else if (store->hasFile(QString("mergedimage.png"))) {
-                    thumbnailpath = QString("mergedimage.png");
-                }
-                else if (store->hasFile(QString("preview.png"))) {
-                    thumbnailpath = QString("preview.png");
-                }
-                if (!thumbnailpath.isEmpty() && store->open(thumbnailpath)) {
-
-                    QByteArray bytes = store->read(store->size());
-                    store->close();
-                    QImage img;
-                    img.loadFromData(bytes);
-                    img.setDevicePixelRatio(devicePixelRatioF);
-
-                    icon = createIcon(img, iconSize);
-                    return true;
-
-                } else {
-                    return false;
-                }
-            } else {
-                return false;
+    if (!fi.exists()) {
+        return false;
+    }
+
+    const QString cachePath = cachedIconPath(fi, iconSize);
+
+    QImage result;
+    if (result.load(cachePath, "PNG")) {
+        result.setDevicePixelRatio(devicePixelRatioF);
+        icon = QIcon(QPixmap::fromImage(result));
+        return true;
+    }
+
+    const int maxIconSize = qMax(iconSize.width(), iconSize.height());
+    QImage img;
+
+    QString mimeType = KisMimeDatabase::mimeTypeForFile(path);
+    if (mimeType == KisDocument::nativeFormatMimeType()
+           || mimeType == "image/openraster") {
+
+        QScopedPointer<KoStore> store(KoStore::createStore(path, KoStore::Read));
+        if (store) {
+            // prefer the small previews over the merged image
+            QString thumbnailpath;
+            if (store->hasFile(QString("Thumbnails/thumbnail.png"))){
+                thumbnailpath = QString("Thumbnails/thumbnail.png");
+            }
+            else if (store->hasFile(QString("preview.png"))) {
+                thumbnailpath = QString("preview.png");
             }
-        } else if (mimeType == "image/tiff" || mimeType == "image/x-tiff") {
-            // Workaround for a bug in Qt tiff QImageIO plugin
-            QScopedPointer<KisDocument> doc;
-            doc.reset(KisPart::instance()->createTemporaryDocument());
-            doc->setFileBatchMode(true);
-            bool r = doc->openUrl(QUrl::fromLocalFile(path), KisDocument::DontAddToRecent);
-            if (r) {
-                KisPaintDeviceSP projection = doc->image()->projection();
-                const QRect bounds = projection->exactBounds();
-                const float ratio = static_cast<float>(bounds.width()) / bounds.height();
-                const int maxWidth = qMax(iconSize.width(), iconSize.height());
-                const int maxHeight = static_cast<int>(maxWidth * ratio);
-                const QImage &thumbnail = projection->createThumbnail(maxWidth, maxHeight, bounds);
-                icon = createIcon(thumbnail, iconSize);
-                return true;
-            } else {
-                return false;
+            else if (store->hasFile(QString("mergedimage.png"))) {
+                thumbnailpath = QString("mergedimage.png");
             }
-        } else {
-            QImage img;
-            img.setDevicePixelRatio(devicePixelRatioF);
-            img.load(path);
-            if (!img.isNull()) {
-                icon = createIcon(img, iconSize);
-                return true;
-            } else {
-                return false;
+            if (!thumbnailpath.isEmpty() && store->open(thumbnailpath)) {
+                QByteArray bytes = store->read(store->size());
+                store->close();
+                img.loadFromData(bytes);
             }
         }
+    } else if (mimeType == "image/tiff" || mimeType == "image/x-tiff") {
+        // Workaround for a bug in Qt tiff QImageIO plugin
+        QScopedPointer<KisDocument> doc;
+        doc.reset(KisPart::instance()->createTemporaryDocument());
+        doc->setFileBatchMode(true);
+        bool r = doc->openUrl(QUrl::fromLocalFile(path), KisDocument::DontAddToRecent);
+        if (r) {
+            KisPaintDeviceSP projection = doc->image()->projection();
+            const QRect bounds = projection->exactBounds();
+            const float ratio = static_cast<float>(bounds.width()) / bounds.height();
+            const int maxWidth = maxIconSize;
+            const int maxHeight = static_cast<int>(maxWidth * ratio);
+            img = projection->createThumbnail(maxWidth, maxHeight, bounds);
+        }
     } else {
+        if (mimeType == "image/vnd.adobe.photoshop" || mimeType == "image/x-psd") {
+            img = loadPsdThumbnail(path);
+        } else if (mimeType == "image/jpeg" || mimeType == "image/heic" || mimeType == "image/heif") {
+            img = loadExifThumbnail(path);
+        }
+
+        // the embedded thumbnails are used only if they are big enough for the icon
+        if (img.isNull() || (img.width() < maxIconSize && img.height() < maxIconSize)) {
+            img = loadScaledImage(path, maxIconSize);
+        }
+    }
+
+    if (img.isNull()) {
         return false;
     }
+
+    img.setDevicePixelRatio(devicePixelRatioF);
+    result = createIconImage(img, iconSize);
+
+    if (QDir().mkpath(QFileInfo(cachePath).absolutePath())) {
+        result.save(cachePath, "PNG");
+    }
+
+    icon = QIcon(QPixmap::fromImage(result));
+    return true;
 }
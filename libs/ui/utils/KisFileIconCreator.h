@@ -19,6 +19,11 @@
  * On Welcome Page and possibly other places there might be a need to show the user
  * a thumbnail of a file. This class tries to open a file and create a thumbnail out of it.
  *
+ * The previews embedded in the files are used whenever possible: the thumbnails stored
+ * in .kra and .ora files, the thumbnail resources of PSD files and the Exif thumbnails
+ * of JPEG and HEIF files. The created thumbnails are cached on disk, keyed by the path
+ * and the modification time of the file.
+ *
  * In theory creating the object is not needed, so if you, dear future reader, want to convert
  * the function inside to a static one, go ahead.
  *
@@ -27,6 +27,7 @@
 #include <KisResourceItemChooserSync.h>
 #include <KisResourceItemListView.h>
 #include <KisResourceLocator.h>
+#include <KisResourceThumbnailCache.h>
 
 #include <brushengine/kis_paintop_settings.h>
 #include <brushengine/kis_paintop_preset.h>
@@ -82,29 +83,27 @@ void KisPresetDelegate::paint(QPainter * painter, const QStyleOptionViewItem & o
 
     bool dirty = index.data(Qt::UserRole + KisAbstractResourceModel::Dirty).toBool();
 
-    QImage preview = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
-
-    if (preview.isNull()) {
-        preview = QImage(512, 512, QImage::Format_RGB32);
-        preview.fill(Qt::red);
-    }
-
-    QMap<QString, QVariant> metaData = index.data(Qt::UserRole + KisAbstractResourceModel::MetaData).value<QMap<QString, QVariant>>();
-
     qreal devicePixelRatioF = painter->device()->devicePixelRatioF();
 
     QRect paintRect = option.rect.adjusted(1, 1, -1, -1);
-    if (!m_showText) {
-        QImage previewHighDpi = preview.scaled(paintRect.size()*devicePixelRatioF, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        previewHighDpi.setDevicePixelRatio(devicePixelRatioF);
-        painter->drawImage(paintRect.x(), paintRect.y(), previewHighDpi);
+    QSize pixSize = m_showText ? QSize(paintRect.height(), paintRect.height()) : paintRect.size();
+    Qt::AspectRatioMode aspectMode = m_showText ? Qt::KeepAspectRatio : Qt::IgnoreAspectRatio;
+
+    // The thumbnails are decoded and scaled in the background, until the
+    // one of the right size is ready, the cache returns a thumbnail of
+    // another size or nothing at all
+    QImage preview = KisResourceThumbnailCache::instance()->thumbnail(index, pixSize * devicePixelRatioF, aspectMode);
+
+    QRect previewRect(paintRect.topLeft(), pixSize);
+    if (preview.isNull()) {
+        painter->fillRect(previewRect, option.palette.alternateBase());
     }
     else {
-        QSize pixSize(paintRect.height(), paintRect.height());
-        QImage previewHighDpi = preview.scaled(pixSize*devicePixelRatioF, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        previewHighDpi.setDevicePixelRatio(devicePixelRatioF);
-        painter->drawImage(paintRect.x(), paintRect.y(), previewHighDpi);
+        previewRect.setSize(preview.size().scaled(pixSize, aspectMode));
+        painter->drawImage(previewRect, preview);
+    }
 
+    if (m_showText) {
         // Put an asterisk after the preset if it is dirty. This will help in case the pixmap icon is too small
 
         QString dirtyPresetIndicator = QString("");
@@ -187,6 +186,9 @@ KisPresetChooser::KisPresetChooser(QWidget *parent, const char *name)
     connect(m_chooser, SIGNAL(resourceClicked(KoResourceSP )),
             this, SIGNAL(resourceClicked(KoResourceSP )));
 
+    connect(KisResourceThumbnailCache::instance(), SIGNAL(thumbnailReady(QString)),
+            m_chooser->itemView()->viewport(), SLOT(update()));
+
     m_mode = THUMBNAIL;
 
     connect(KisConfigNotifier::instance(), SIGNAL(configChanged()),
@@ -38,60 +38,65 @@ public:
     {
         const RGBPixel* src = reinterpret_cast<const RGBPixel*>(srcU8);
         RGBPixel* dst = reinterpret_cast<RGBPixel*>(dstU8);
-        float r, g, b, gray;
-        while (nPixels > 0) {
-
-            r = SCALE_TO_FLOAT(src->red);
-            g = SCALE_TO_FLOAT(src->green);
-            b = SCALE_TO_FLOAT(src->blue);
-
-            // https://www.tannerhelland.com/3643/grayscale-image-algorithm-vb6/
-            switch(m_type) {
-            case 0: // lightness
-            {
-                gray = (qMax(qMax(r, g), b) + qMin(qMin(r, g), b)) / 2;
-                break;
-            }
-            case 1: // luminosity BT 709
-            {
-                gray = r * 0.2126 + g * 0.7152 + b * 0.0722;
-                break;
-
-            }
-
-            case 2: // luminosity BT 601
-            {
-                gray = r * 0.299 + g * 0.587 + b * 0.114;
-                break;
-
-            }
-            case 3: // average
-            {
-                gray = (r + g + b) / 3;
-                break;
-            }
-            case 4: // min
-            {
-                gray = qMin(qMin(r, g), b);
-                break;
-            }
-            case 5: // min
-            {
-                gray = qMax(qMax(r, g), b);
-                break;
-            }
-
-            default:
-                gray = 0;
-            }
-            dst->red = SCALE_FROM_FLOAT(gray);
-            dst->green = SCALE_FROM_FLOAT(gray);
-            dst->blue = SCALE_FROM_FLOAT(gray);
-            dst->alpha = src->alpha;
-
-            --nPixels;
-            ++src;
-            ++dst;
+
+        /**
+         * The type is checked once per a row of pixels, so that the
+         * compiler could vectorize the loops of every type
+         */
+
+        // https://www.tannerhelland.com/3643/grayscale-image-algorithm-vb6/
+        switch(m_type) {
+        case 0: // lightness
+            transformImpl(src, dst, nPixels, [] (float r, float g, float b) {
+                return (qMax(qMax(r, g), b) + qMin(qMin(r, g), b)) * 0.5f;
+            });
+            break;
+        case 1: // luminosity BT 709
+            transformImpl(src, dst, nPixels, [] (float r, float g, float b) {
+                return r * 0.2126f + g * 0.7152f + b * 0.0722f;
+            });
+            break;
+        case 2: // luminosity BT 601
+            transformImpl(src, dst, nPixels, [] (float r, float g, float b) {
+                return r * 0.299f + g * 0.587f + b * 0.114f;
+            });
+            break;
+        case 3: // average
+            transformImpl(src, dst, nPixels, [] (float r, float g, float b) {
+                return (r + g + b) * (1.0f / 3.0f);
+            });
+            break;
+        case 4: // min
+            transformImpl(src, dst, nPixels, [] (float r, float g, float b) {
+                return qMin(qMin(r, g), b);
+            });
+            break;
+        case 5: // max
+            transformImpl(src, dst, nPixels, [] (float r, float g, float b) {
+                return qMax(qMax(r, g), b);
+            });
+            break;
+        default:
+            transformImpl(src, dst, nPixels, [] (float, float, float) {
+                return 0.0f;
+            });
+        }
+    }
+
+    template <class GrayFunction>
+    inline void transformImpl(const RGBPixel *src, RGBPixel *dst, qint32 nPixels, GrayFunction grayFunction) const
+    {
+        for (qint32 i = 0; i < nPixels; i++) {
+            const float gray = grayFunction(SCALE_TO_FLOAT(src[i].red),
+                                            SCALE_TO_FLOAT(src[i].green),
+                                            SCALE_TO_FLOAT(src[i].blue));
+
+            const _channel_type_ value = SCALE_FROM_FLOAT(gray);
+
+            dst[i].red = value;
+            dst[i].green = value;
+            dst[i].blue = value;
+            dst[i].alpha = src[i].alpha;
         }
     }
 
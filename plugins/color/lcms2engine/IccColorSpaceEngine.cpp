@@ -64,6 +64,23 @@ public:
         cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
 
     }
+
+    void transformLines(const quint8 *src, qint32 srcRowStride,
+                        quint8 *dst, qint32 dstRowStride,
+                        qint32 numPixels, qint32 numRows) const override
+    {
+#if LCMS_VERSION >= 2080
+        Q_ASSERT(m_transform);
+
+        // the formats are chunky, so the plane strides are not used
+        cmsDoTransformLineStride(m_transform, src, dst,
+                                 numPixels, numRows,
+                                 srcRowStride, dstRowStride,
+                                 0, 0);
+#else
+        KoColorConversionTransformation::transformLines(src, srcRowStride, dst, dstRowStride, numPixels, numRows);
+#endif
+    }
 private:
     mutable cmsHTRANSFORM m_transform;
 };
@@ -11,6 +11,7 @@
 #define KOLCMSCOLORSPACE_H_
 
 #include <array>
+#include <QVarLengthArray>
 #include <kis_lockless_stack.h>
 #include <KoColorSpaceAbstract.h>
 
@@ -104,35 +105,30 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
         {
             cmsDoTransform(cmstransform, const_cast<quint8 *>(src), dst, nPixels);
 
-            qint32 numPixels = nPixels;
-            qint32 pixelSize = m_colorSpace->pixelSize();
-            int index = 0;
+            if (_CSTraits::alpha_pos < 0) return;
+
+            const qint32 pixelSize = _CSTraits::pixelSize;
 
             if (cmsAlphaTransform) {
-                qreal *alpha = new qreal[nPixels];
-                qreal *dstalpha = new qreal[nPixels];
+                // the filters pass a row of a tile at most, so the
+                // buffers are usually allocated on the stack
+                QVarLengthArray<qreal, 256> alpha(nPixels);
+                QVarLengthArray<qreal, 256> dstalpha(nPixels);
 
-                while (index < nPixels) {
-                    alpha[index] = m_colorSpace->opacityF(src);
-                    src += pixelSize;
-                    index++;
+                for (qint32 i = 0; i < nPixels; i++) {
+                    alpha[i] = _CSTraits::opacityF(src + i * pixelSize);
                 }
 
-                cmsDoTransform(cmsAlphaTransform, const_cast<qreal *>(alpha), static_cast<qreal *>(dstalpha), nPixels);
-                for (int i = 0; i < numPixels; i++) {
-                    m_colorSpace->setOpacity(dst, dstalpha[i], 1);
-                    dst += pixelSize;
-                }
+                cmsDoTransform(cmsAlphaTransform, alpha.data(), dstalpha.data(), nPixels);
 
-                delete [] alpha;
-                delete [] dstalpha;
+                for (qint32 i = 0; i < nPixels; i++) {
+                    _CSTraits::setOpacity(dst + i * pixelSize, dstalpha[i], 1);
+                }
             } else {
-                while (numPixels > 0) {
-                    qreal alpha = m_colorSpace->opacityF(src);
-                    m_colorSpace->setOpacity(dst, alpha, 1);
-                    src += pixelSize;
-                    dst += pixelSize;
-                    numPixels--;
+                // the alpha is kept as it is, so there is no need to convert it to floats
+                for (qint32 i = 0; i < nPixels; i++) {
+                    _CSTraits::nativeArray(dst + i * pixelSize)[_CSTraits::alpha_pos] =
+                        _CSTraits::nativeArray(src + i * pixelSize)[_CSTraits::alpha_pos];
                 }
             }
         }
@@ -13,6 +13,9 @@
 #include "KoColorModelStandardIdsUtils.h"
 #include "KoColorConversionTransformationFactory.h"
 
+#include <QVector>
+#include <type_traits>
+
 #include <colorspaces/rgb_u8/RgbU8ColorSpace.h>
 #include <colorspaces/rgb_u16/RgbU16ColorSpace.h>
 #ifdef HAVE_OPENEXR
@@ -70,7 +73,7 @@ struct DstTraitsForSource<KoBgrU8Traits> {
 
 template <typename src_channel_type,
           typename dst_channel_type>
-struct RemoveSmpte2048Policy {
+struct RemoveSmpte2048Curve {
     static ALWAYS_INLINE dst_channel_type process(src_channel_type value) {
         return
             KoColorSpaceMaths<float, dst_channel_type>::scaleToA(
@@ -82,7 +85,7 @@ struct RemoveSmpte2048Policy {
 
 template <typename src_channel_type,
           typename dst_channel_type>
-struct ApplySmpte2048Policy {
+struct ApplySmpte2048Curve {
     static ALWAYS_INLINE dst_channel_type process(src_channel_type value) {
         return
             KoColorSpaceMaths<float, dst_channel_type>::scaleToA(
@@ -92,6 +95,108 @@ struct ApplySmpte2048Policy {
     }
 };
 
+/**
+ * Describes how the values of a channel type are mapped into the
+ * indexes of a lookup table. Only the types with at most 65536 distinct
+ * values are cached, the float values are passed to the curve directly.
+ */
+template <typename channel_type>
+struct CurveLutIndex {
+    static const bool isCached = false;
+};
+
+template <>
+struct CurveLutIndex<quint8> {
+    static const bool isCached = true;
+    static const int size = 256;
+    static ALWAYS_INLINE int index(quint8 value) { return value; }
+    static ALWAYS_INLINE quint8 value(int index) { return quint8(index); }
+};
+
+template <>
+struct CurveLutIndex<quint16> {
+    static const bool isCached = true;
+    static const int size = 65536;
+    static ALWAYS_INLINE int index(quint16 value) { return value; }
+    static ALWAYS_INLINE quint16 value(int index) { return quint16(index); }
+};
+
+#ifdef HAVE_OPENEXR
+template <>
+struct CurveLutIndex<half> {
+    static const bool isCached = true;
+    static const int size = 65536;
+    static ALWAYS_INLINE int index(half value) { return value.bits(); }
+    static ALWAYS_INLINE half value(int index) {
+        half result;
+        result.setBits(quint16(index));
+        return result;
+    }
+};
+#endif
+
+/**
+ * Applies \p Curve to the channel values. For 8-bit, 16-bit and half
+ * sources the curve is evaluated only once for every possible source
+ * value and the results are looked up in a table, which is shared by
+ * all the transformations with the same types. The table is fetched on
+ * construction of the policy, so the policy should be created once per
+ * transform() call.
+ */
+template <typename src_channel_type,
+          typename dst_channel_type,
+          template<typename, typename> class Curve,
+          typename EnableDummyType = void>
+struct CachedCurvePolicy {
+    static ALWAYS_INLINE dst_channel_type process(src_channel_type value) {
+        return Curve<src_channel_type, dst_channel_type>::process(value);
+    }
+};
+
+template <typename src_channel_type,
+          typename dst_channel_type,
+          template<typename, typename> class Curve>
+struct CachedCurvePolicy<src_channel_type, dst_channel_type, Curve,
+                         typename std::enable_if<CurveLutIndex<src_channel_type>::isCached>::type>
+{
+    typedef CurveLutIndex<src_channel_type> LutIndex;
+
+    CachedCurvePolicy()
+        : m_table(table().constData())
+    {
+    }
+
+    ALWAYS_INLINE dst_channel_type process(src_channel_type value) const {
+        return m_table[LutIndex::index(value)];
+    }
+
+private:
+    static const QVector<dst_channel_type>& table() {
+        // the initialization of function-local statics is thread-safe
+        static const QVector<dst_channel_type> s_table = createTable();
+        return s_table;
+    }
+
+    static QVector<dst_channel_type> createTable() {
+        QVector<dst_channel_type> result(LutIndex::size);
+        for (int i = 0; i < LutIndex::size; i++) {
+            result[i] = Curve<src_channel_type, dst_channel_type>::process(LutIndex::value(i));
+        }
+        return result;
+    }
+
+private:
+    const dst_channel_type *m_table;
+};
+
+template <typename src_channel_type,
+          typename dst_channel_type>
+using RemoveSmpte2048Policy = CachedCurvePolicy<src_channel_type, dst_channel_type, RemoveSmpte2048Curve>;
+
+template <typename src_channel_type,
+          typename dst_channel_type>
+using ApplySmpte2048Policy = CachedCurvePolicy<src_channel_type, dst_channel_type, ApplySmpte2048Curve>;
+
 template <typename src_channel_type,
           typename dst_channel_type>
 struct NoopPolicy {
@@ -128,10 +233,12 @@ struct ApplyRgbShaper : public KoColorConversionTransformation
         typedef typename DstCSTraits::channels_type dst_channel_type;
         typedef Policy<src_channel_type, dst_channel_type> ConcretePolicy;
 
+        ConcretePolicy policy;
+
         for (int i = 0; i < nPixels; i++) {
-            dstPixel->red = ConcretePolicy::process(srcPixel->red);
-            dstPixel->green = ConcretePolicy::process(srcPixel->green);
-            dstPixel->blue = ConcretePolicy::process(srcPixel->blue);
+            dstPixel->red = policy.process(srcPixel->red);
+            dstPixel->green = policy.process(srcPixel->green);
+            dstPixel->blue = policy.process(srcPixel->blue);
             dstPixel->alpha =
                 KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(
                 srcPixel->alpha);
@@ -5,9 +5,11 @@
 #include "TestColorSpaceRegistry.h"
 
 #include <QTest>
+#include <QScopedPointer>
 
 #include "KoColorSpaceRegistry.h"
 #include "KoColorSpace.h"
+#include "KoColorConversionCache.h"
 #include "RgbU8ColorSpace.h"
 #include "RgbU16ColorSpace.h"
 #include "LabColorSpace.h"
@@ -91,4 +93,77 @@ void TestColorSpaceRegistry::testLab()
 
 }
 
+void TestColorSpaceRegistry::testTransformLines()
+{
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->lab16();
+
+    QScopedPointer<KoColorConversionTransformation> transform(
+        srcCs->createColorConverter(dstCs,
+                                    KoColorConversionTransformation::internalRenderingIntent(),
+                                    KoColorConversionTransformation::internalConversionFlags()));
+    QVERIFY(transform);
+
+    const int numPixels = 13;
+    const int numRows = 7;
+
+    // the rows are padded in both buffers to check the strides
+    const int srcRowStride = (numPixels + 3) * srcCs->pixelSize();
+    const int dstRowStride = (numPixels + 5) * dstCs->pixelSize();
+
+    QByteArray src(srcRowStride * numRows, 0);
+    for (int i = 0; i < src.size(); i++) {
+        src[i] = char((i * 37) & 0xff);
+    }
+
+    QByteArray dstLines(dstRowStride * numRows, 0);
+    QByteArray dstRows(dstRowStride * numRows, 0);
+
+    transform->transformLines(reinterpret_cast<const quint8*>(src.constData()), srcRowStride,
+                              reinterpret_cast<quint8*>(dstLines.data()), dstRowStride,
+                              numPixels, numRows);
+
+    for (int row = 0; row < numRows; row++) {
+        transform->transform(reinterpret_cast<const quint8*>(src.constData()) + row * srcRowStride,
+                             reinterpret_cast<quint8*>(dstRows.data()) + row * dstRowStride,
+                             numPixels);
+    }
+
+    QCOMPARE(dstLines, dstRows);
+}
+
+void TestColorSpaceRegistry::testConversionCacheStatistics()
+{
+    KoColorConversionCache *cache = KoColorSpaceRegistry::instance()->colorConversionCache();
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->lab16();
+
+    const KoColorConversionCache::Statistics initialStats = cache->statistics();
+
+    {
+        KoCachedColorConversionTransformation cct =
+            cache->cachedConverter(srcCs, dstCs,
+                                   KoColorConversionTransformation::IntentSaturation,
+                                   KoColorConversionTransformation::Empty);
+        QVERIFY(cct.transformation());
+    }
+
+    const KoColorConversionCache::Statistics missStats = cache->statistics();
+    QCOMPARE(missStats.misses, initialStats.misses + 1);
+    QCOMPARE(missStats.hits, initialStats.hits);
+
+    {
+        KoCachedColorConversionTransformation cct =
+            cache->cachedConverter(srcCs, dstCs,
+                                   KoColorConversionTransformation::IntentSaturation,
+                                   KoColorConversionTransformation::Empty);
+        QVERIFY(cct.transformation());
+    }
+
+    const KoColorConversionCache::Statistics hitStats = cache->statistics();
+    QCOMPARE(hitStats.misses, missStats.misses);
+    QCOMPARE(hitStats.hits, missStats.hits + 1);
+}
+
 KISTEST_MAIN(TestColorSpaceRegistry)
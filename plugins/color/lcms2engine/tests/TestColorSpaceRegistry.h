@@ -15,6 +15,8 @@ private Q_SLOTS:
     void testRgbU8();
     void testRgbU16();
     void testLab();
+    void testTransformLines();
+    void testConversionCacheStatistics();
 };
 
 #endif
@@ -16,6 +16,8 @@
 #include "KoColor.h"
 #include "KoColorModelStandardIds.h"
 
+#include "LcmsRGBP2020PQColorSpaceTransformation.h"
+
 inline QString truncated(QString value) {
     value.truncate(24);
     return value;
@@ -171,4 +173,41 @@ void TestLcmsRGBP2020PQColorSpace::testConvertToCmyk()
     testRoundTrip(srcCS, dstCS, SDR);
 }
 
+template <typename src_channel_type,
+          typename dst_channel_type,
+          template<typename, typename> class Policy,
+          template<typename, typename> class Curve>
+void testCachedCurve()
+{
+    typedef CurveLutIndex<src_channel_type> LutIndex;
+    Policy<src_channel_type, dst_channel_type> policy;
+
+    for (int i = 0; i < LutIndex::size; i++) {
+        const src_channel_type value = LutIndex::value(i);
+        const dst_channel_type expected = Curve<src_channel_type, dst_channel_type>::process(value);
+        const dst_channel_type result = policy.process(value);
+
+        // NaN values of the half source are not equal even to themselves
+        if (expected != expected && result != result) continue;
+
+        if (result != expected) {
+            qDebug() << "index" << i << "expected" << float(expected) << "result" << float(result);
+            QFAIL("the cached curve differs from the direct one");
+        }
+    }
+}
+
+void TestLcmsRGBP2020PQColorSpace::testCachedCurves()
+{
+    testCachedCurve<quint8, float, RemoveSmpte2048Policy, RemoveSmpte2048Curve>();
+    testCachedCurve<quint16, float, RemoveSmpte2048Policy, RemoveSmpte2048Curve>();
+
+#ifdef HAVE_OPENEXR
+    testCachedCurve<quint16, half, RemoveSmpte2048Policy, RemoveSmpte2048Curve>();
+    testCachedCurve<half, quint16, ApplySmpte2048Policy, ApplySmpte2048Curve>();
+    testCachedCurve<half, float, ApplySmpte2048Policy, ApplySmpte2048Curve>();
+    testCachedCurve<half, float, RemoveSmpte2048Policy, RemoveSmpte2048Curve>();
+#endif
+}
+
 KISTEST_MAIN(TestLcmsRGBP2020PQColorSpace)
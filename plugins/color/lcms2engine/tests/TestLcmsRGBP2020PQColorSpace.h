@@ -15,6 +15,7 @@ private Q_SLOTS:
     void test();
     void testInternalConversions();
     void testConvertToCmyk();
+    void testCachedCurves();
 };
 
 #endif // TESTLCMSRGBP2020PQCOLORSPACE_H
@@ -248,3 +248,27 @@ void KisColorSelectorComponent::setLastMousePosition(int x, int y)
         m_lastY = y;
     }
 }
+
+QString KisColorSelectorComponent::renderCacheKey(const QString &componentName, const QSize &size, qreal devicePixelRatioF) const
+{
+    QString key = QString("%1/%2/%3/%4x%5@%6/%7/%8")
+        .arg(componentName)
+        .arg(int(m_parameter))
+        .arg(int(m_type))
+        .arg(size.width())
+        .arg(size.height())
+        .arg(devicePixelRatioF)
+        .arg(quintptr(colorSpace()))
+        .arg(quintptr(m_parent->converter()));
+
+    const qreal params[] = {m_hue, m_hsvSaturation, m_value,
+                            m_hslSaturation, m_lightness,
+                            m_hsiSaturation, m_intensity,
+                            m_hsySaturation, m_luma};
+
+    for (qreal param : params) {
+        key += QString("/%1").arg(param);
+    }
+
+    return key;
+}
@@ -98,6 +98,10 @@ protected:
     // Workaround for Bug 287001
     void setLastMousePosition(int x, int y);
 
+    /// returns the key of the background of the component in KisColorSelectorRenderCache,
+    /// the subclasses should append the values of their own settings the background depends on
+    QString renderCacheKey(const QString &componentName, const QSize &size, qreal devicePixelRatioF) const;
+
     qreal m_hue;
     qreal m_hsvSaturation;
     qreal m_value;
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_color_selector_render_cache.h"
+
+#include <QGlobalStatic>
+
+#include "kis_display_color_converter.h"
+
+Q_GLOBAL_STATIC(KisColorSelectorRenderCache, s_instance)
+
+KisColorSelectorRenderCache::KisColorSelectorRenderCache()
+{
+    // the cost is measured in kilobytes of the rendered images
+    m_entries.setMaxCost(16 * 1024);
+}
+
+KisColorSelectorRenderCache* KisColorSelectorRenderCache::instance()
+{
+    return s_instance;
+}
+
+bool KisColorSelectorRenderCache::fetch(const QString &key, Entry *entry) const
+{
+    Entry *cachedEntry = m_entries.object(key);
+    if (!cachedEntry) return false;
+
+    *entry = *cachedEntry;
+    return true;
+}
+
+void KisColorSelectorRenderCache::store(const QString &key, const Entry &entry, KisDisplayColorConverter *converter)
+{
+    if (converter) {
+        connect(converter, SIGNAL(displayConfigurationChanged()), SLOT(clear()), Qt::UniqueConnection);
+        connect(converter, SIGNAL(destroyed()), SLOT(clear()), Qt::UniqueConnection);
+    }
+
+    m_entries.insert(key, new Entry(entry), qMax(1, entry.pixelCache.byteCount() / 1024));
+}
+
+void KisColorSelectorRenderCache::clear()
+{
+    m_entries.clear();
+}
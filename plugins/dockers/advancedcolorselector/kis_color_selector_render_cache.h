@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_COLOR_SELECTOR_RENDER_CACHE_H
+#define KIS_COLOR_SELECTOR_RENDER_CACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QImage>
+#include <QPoint>
+
+#include "kis_types.h"
+
+class KisDisplayColorConverter;
+
+/**
+ * The rendered backgrounds of the color selector components shared
+ * between all the selectors, e.g. the docker and the popup palette.
+ *
+ * The components render their backgrounds pixel by pixel, converting
+ * every pixel through the display color converter, so rendering them
+ * is expensive. The key of an entry should include everything the
+ * background depends on: the kind of the component, its size, the
+ * parameters of the current color it uses and the color space. The
+ * cache is dropped when the display configuration of any of the
+ * converters used for the stored entries changes.
+ */
+class KisColorSelectorRenderCache : public QObject
+{
+    Q_OBJECT
+public:
+    struct Entry {
+        QImage pixelCache;
+        QPoint pixelCacheOffset;
+        KisPaintDeviceSP realPixelCache;
+    };
+
+public:
+    KisColorSelectorRenderCache();
+    static KisColorSelectorRenderCache* instance();
+
+    /**
+     * \return true and fills \p entry if there is an entry for \p key
+     */
+    bool fetch(const QString &key, Entry *entry) const;
+
+    /**
+     * Stores \p entry rendered with \p converter under \p key. The
+     * devices stored in the cache must not be changed afterwards.
+     */
+    void store(const QString &key, const Entry &entry, KisDisplayColorConverter *converter);
+
+private Q_SLOTS:
+    void clear();
+
+private:
+    QCache<QString, Entry> m_entries;
+};
+
+#endif // KIS_COLOR_SELECTOR_RENDER_CACHE_H
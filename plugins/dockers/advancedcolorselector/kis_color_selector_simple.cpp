@@ -23,6 +23,7 @@
 
 #include "kis_display_color_converter.h"
 #include "kis_acs_pixel_cache_renderer.h"
+#include "kis_color_selector_render_cache.h"
 
 
 KisColorSelectorSimple::KisColorSelectorSimple(KisColorSelector *parent) :
@@ -260,19 +261,31 @@ void KisColorSelectorSimple::setColor(const KoColor &color)
 void KisColorSelectorSimple::paint(QPainter* painter)
 {
     if(isDirty()) {
-        KisPaintDeviceSP realPixelCache;
-        QPoint pixelCacheOffset;
-        Acs::PixelCacheRenderer::render(this,
-                                        m_parent->converter(),
-                                        QRect(0, 0, width(), height()),
-                                        realPixelCache,
-                                        m_pixelCache,
-                                        pixelCacheOffset,
-                                        painter->device()->devicePixelRatioF());
+        const qreal devicePixelRatioF = painter->device()->devicePixelRatioF();
+        const QString cacheKey =
+            renderCacheKey("simple", QSize(width(), height()), devicePixelRatioF) +
+            QString("/%1/%2/%3/%4").arg(R).arg(G).arg(B).arg(Gamma);
 
-//        if (!pixelCacheOffset.isNull()) {
-//            warnKrita << "WARNING: offset of the rectangle selector is not null!";
-//        }
+        KisColorSelectorRenderCache::Entry entry;
+
+        if (KisColorSelectorRenderCache::instance()->fetch(cacheKey, &entry)) {
+            m_pixelCache = entry.pixelCache;
+        } else {
+            Acs::PixelCacheRenderer::render(this,
+                                            m_parent->converter(),
+                                            QRect(0, 0, width(), height()),
+                                            entry.realPixelCache,
+                                            m_pixelCache,
+                                            entry.pixelCacheOffset,
+                                            devicePixelRatioF);
+
+//            if (!entry.pixelCacheOffset.isNull()) {
+//                warnKrita << "WARNING: offset of the rectangle selector is not null!";
+//            }
+
+            entry.pixelCache = m_pixelCache;
+            KisColorSelectorRenderCache::instance()->store(cacheKey, entry, m_parent->converter());
+        }
     }
 
     painter->drawImage(0,0, m_pixelCache);
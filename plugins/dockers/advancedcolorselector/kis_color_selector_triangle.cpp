@@ -23,6 +23,7 @@
 
 #include "kis_display_color_converter.h"
 #include "kis_acs_pixel_cache_renderer.h"
+#include "kis_color_selector_render_cache.h"
 
 
 KisColorSelectorTriangle::KisColorSelectorTriangle(KisColorSelector* parent) :
@@ -67,10 +68,21 @@ void KisColorSelectorTriangle::updatePixelCache(qreal devicePixelRatioF)
 
     QPoint pixelCacheOffset;
 
-    if (m_cachedSize != QSize(width, height) && m_realPixelCache) {
-        m_realPixelCache = 0;
+    m_cacheDevicePixelRatioF = devicePixelRatioF; // save device pixel ratio of the cache
+
+    const QString cacheKey = renderCacheKey("triangle", QSize(width, height), devicePixelRatioF);
+    KisColorSelectorRenderCache::Entry entry;
+
+    if (KisColorSelectorRenderCache::instance()->fetch(cacheKey, &entry)) {
+        m_realPixelCache = entry.realPixelCache;
+        m_renderedPixelCache = entry.pixelCache;
+        return;
     }
 
+    // the previous device may be shared with the other selectors
+    // through the cache, so it is never rendered into again
+    m_realPixelCache = 0;
+
     Acs::PixelCacheRenderer::render(this,
                                     m_parent->converter(),
                                     QRect(0, 0, width, height),
@@ -79,8 +91,6 @@ void KisColorSelectorTriangle::updatePixelCache(qreal devicePixelRatioF)
                                     pixelCacheOffset,
                                     devicePixelRatioF);
 
-    m_cacheDevicePixelRatioF = devicePixelRatioF; // save device pixel ratio of the cache
-
 //    if (!pixelCacheOffset.isNull()) {
 //        warnKrita << "WARNING: offset of the triangle selector is not null!";
 //    }
@@ -92,6 +102,12 @@ void KisColorSelectorTriangle::updatePixelCache(qreal devicePixelRatioF)
     gc.setCompositionMode(QPainter::CompositionMode_Clear);
     gc.drawLine(QPointF(0, triangleHeight()), QPointF((triangleWidth()) / 2.0, 0));
     gc.drawLine(QPointF(triangleWidth() / 2.0 + 1.0, 0), QPointF(triangleWidth() + 1, triangleHeight()));
+    gc.end();
+
+    entry.realPixelCache = m_realPixelCache;
+    entry.pixelCache = m_renderedPixelCache;
+    entry.pixelCacheOffset = pixelCacheOffset;
+    KisColorSelectorRenderCache::instance()->store(cacheKey, entry, m_parent->converter());
 }
 
 KoColor KisColorSelectorTriangle::selectColor(int x, int y)
@@ -50,7 +50,6 @@ private:
 private:
     QImage m_renderedPixelCache;
     KisPaintDeviceSP m_realPixelCache;
-    QSize m_cachedSize;
     QPointF m_lastClickPos;
     qreal m_cacheDevicePixelRatioF {1.0};
 };
@@ -24,6 +24,7 @@
 
 #include "kis_display_color_converter.h"
 #include "kis_acs_pixel_cache_renderer.h"
+#include "kis_color_selector_render_cache.h"
 
 
 KisColorSelectorWheel::KisColorSelectorWheel(KisColorSelector *parent) :
@@ -179,15 +180,6 @@ void KisColorSelectorWheel::paint(QPainter* painter)
 {
 
     if(isDirty()) {
-        KisPaintDeviceSP realPixelCache;
-        Acs::PixelCacheRenderer::render(this, m_parent->converter(), QRect(0, 0, width(), height()), realPixelCache,
-                                        m_pixelCache, m_pixelCacheOffset, painter->device()->devicePixelRatioF());
-
-        //antialiasing for wheel
-        QPainter tmpPainter(&m_pixelCache);
-        tmpPainter.setRenderHint(QPainter::Antialiasing);
-        tmpPainter.setPen(QPen(QColor(0,0,0,0), 2.5));
-        tmpPainter.setCompositionMode(QPainter::CompositionMode_Clear);
         int size=qMin(width(), height());
 
         m_renderAreaSize = QSize(size,size);
@@ -196,10 +188,36 @@ void KisColorSelectorWheel::paint(QPainter* painter)
         m_toRenderArea.reset();
         m_toRenderArea.translate(-m_renderAreaOffsetX,-m_renderAreaOffsetY);
 
-        QPoint ellipseCenter(width() / 2 - size / 2, height() / 2 - size / 2);
-        ellipseCenter -= m_pixelCacheOffset;
+        const qreal devicePixelRatioF = painter->device()->devicePixelRatioF();
+        const QString cacheKey =
+            renderCacheKey("wheel", QSize(width(), height()), devicePixelRatioF) +
+            QString("/%1/%2/%3/%4").arg(R).arg(G).arg(B).arg(Gamma);
 
-        tmpPainter.drawEllipse(ellipseCenter.x(), ellipseCenter.y(), size, size);
+        KisColorSelectorRenderCache::Entry entry;
+
+        if (KisColorSelectorRenderCache::instance()->fetch(cacheKey, &entry)) {
+            m_pixelCache = entry.pixelCache;
+            m_pixelCacheOffset = entry.pixelCacheOffset;
+        } else {
+            Acs::PixelCacheRenderer::render(this, m_parent->converter(), QRect(0, 0, width(), height()), entry.realPixelCache,
+                                            m_pixelCache, m_pixelCacheOffset, devicePixelRatioF);
+
+            //antialiasing for wheel
+            QPainter tmpPainter(&m_pixelCache);
+            tmpPainter.setRenderHint(QPainter::Antialiasing);
+            tmpPainter.setPen(QPen(QColor(0,0,0,0), 2.5));
+            tmpPainter.setCompositionMode(QPainter::CompositionMode_Clear);
+
+            QPoint ellipseCenter(width() / 2 - size / 2, height() / 2 - size / 2);
+            ellipseCenter -= m_pixelCacheOffset;
+
+            tmpPainter.drawEllipse(ellipseCenter.x(), ellipseCenter.y(), size, size);
+            tmpPainter.end();
+
+            entry.pixelCache = m_pixelCache;
+            entry.pixelCacheOffset = m_pixelCacheOffset;
+            KisColorSelectorRenderCache::instance()->store(cacheKey, entry, m_parent->converter());
+        }
     }
 
     painter->drawImage(m_pixelCacheOffset.x(),m_pixelCacheOffset.y(), m_pixelCache);
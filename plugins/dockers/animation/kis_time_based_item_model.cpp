@@ -555,14 +555,27 @@ void KisTimeBasedItemModel::slotClipRangeChanged()
 void KisTimeBasedItemModel::slotCacheChanged()
 {
     const int numFrames = columnCount();
+    const int oldNumFrames = m_d->cachedFrames.size();
     m_d->cachedFrames.resize(numFrames);
 
+    int firstChanged = numFrames;
+    int lastChanged = -1;
+
     for (int i = 0; i < numFrames; i++) {
-        m_d->cachedFrames[i] =
+        const bool isCached =
             m_d->framesCache->frameStatus(i) == KisAnimationFrameCache::Cached;
+
+        if (i >= oldNumFrames || m_d->cachedFrames[i] != isCached) {
+            m_d->cachedFrames[i] = isCached;
+            firstChanged = qMin(firstChanged, i);
+            lastChanged = i;
+        }
     }
 
-    emit headerDataChanged(Qt::Horizontal, 0, numFrames);
+    // the cache is updated one frame at a time, so don't repaint the whole header
+    if (firstChanged <= lastChanged) {
+        emit headerDataChanged(Qt::Horizontal, firstChanged, lastChanged);
+    }
 }
 
 
@@ -119,6 +119,53 @@ void TimelineModelTest::testModel()
     QScopedPointer<TimelineFramesModel> model(new TimelineFramesModel(0));
 }
 
+#include "kis_keyframe_channel.h"
+
+void TimelineModelTest::testFramesIndexUpdates()
+{
+    constructImage();
+    m_shapeController->setImage(m_image);
+
+    m_layer1->enableAnimation();
+    KisKeyframeChannel *channel = m_layer1->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+    QVERIFY(channel);
+    channel->addKeyframe(10);
+
+    QScopedPointer<TimelineFramesModel> model(new TimelineFramesModel(0));
+    model->setDummiesFacade(m_shapeController, m_image, m_displayModeAdapter);
+
+    int row = -1;
+    for (int i = 0; i < model->rowCount(); i++) {
+        if (model->nodeAt(model->index(i, 0)) == m_layer1) {
+            row = i;
+        }
+    }
+    QVERIFY(row >= 0);
+
+    QVERIFY(model->data(model->index(row, 0), TimelineFramesModel::FrameExistsRole).toBool());
+    QVERIFY(!model->data(model->index(row, 5), TimelineFramesModel::FrameExistsRole).toBool());
+    QVERIFY(model->data(model->index(row, 10), TimelineFramesModel::FrameExistsRole).toBool());
+
+    QSignalSpy spy(model.data(), SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+    channel->addKeyframe(5);
+
+    // only the frames held by the new keyframe are reported
+    QCOMPARE(spy.count(), 1);
+    const QModelIndex topLeft = spy.first()[0].toModelIndex();
+    const QModelIndex bottomRight = spy.first()[1].toModelIndex();
+    QCOMPARE(topLeft.row(), row);
+    QCOMPARE(topLeft.column(), 5);
+    QCOMPARE(bottomRight.row(), row);
+    QCOMPARE(bottomRight.column(), 9);
+
+    // and the cached keyframes of the row are up to date
+    QVERIFY(model->data(model->index(row, 5), TimelineFramesModel::FrameExistsRole).toBool());
+
+    channel->removeKeyframe(10);
+    QVERIFY(!model->data(model->index(row, 10), TimelineFramesModel::FrameExistsRole).toBool());
+}
+
 struct TestingInterface : TimelineFramesModel::NodeManipulationInterface
 {
     TestingInterface(KisImageSP image) : m_image(image) {}
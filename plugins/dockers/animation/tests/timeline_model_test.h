@@ -25,6 +25,7 @@ private Q_SLOTS:
 
     void testConverter();
     void testModel();
+    void testFramesIndexUpdates();
     void testView();
     void testOnionSkins();
 
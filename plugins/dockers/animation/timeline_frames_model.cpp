@@ -11,6 +11,7 @@
 #include <QMimeData>
 #include <QPointer>
 #include <KisResourceModel.h>
+#include <algorithm>
 
 #include "kis_layer.h"
 #include "kis_config.h"
@@ -68,8 +69,60 @@ struct TimelineFramesModel::Private
     bool needFinishRemoveRows;
 
     QList<KisNodeDummy*> updateQueue;
+    /// the frames of the layers whose pixels have changed, the rest of their rows stays the same
+    QHash<KisNodeDummy*, KisTimeSpan> contentUpdateQueue;
     KisSignalCompressor updateTimer;
 
+    /**
+     * The keyframes of a layer collected once for all the cells of its
+     * row. The view asks for several roles of every visible cell on
+     * every repaint, which would otherwise look up the same keyframes
+     * in all the channels of the node each time.
+     */
+    struct FramesIndex {
+        QVector<int> keyframeTimes;
+        QVector<int> colorLabels;
+        /// -1 until the content of the keyframe is requested for the first time
+        QVector<qint8> hasContent;
+        QVector<int> specialKeyframeTimes;
+    };
+
+    mutable QHash<KisNodeDummy*, FramesIndex> framesIndexes;
+
+    FramesIndex& framesIndex(KisNodeDummy *dummy) const {
+        auto it = framesIndexes.find(dummy);
+        if (it != framesIndexes.end()) return *it;
+
+        FramesIndex index;
+
+        Q_FOREACH (KisKeyframeChannel *channel, dummy->node()->keyframeChannels()) {
+            QList<int> times = channel->allKeyframeTimes().values();
+            std::sort(times.begin(), times.end());
+
+            if (channel->id() == KisKeyframeChannel::Raster.id()) {
+                Q_FOREACH (int time, times) {
+                    index.keyframeTimes.append(time);
+                    index.colorLabels.append(channel->keyframeAt(time)->colorLabel());
+                }
+                index.hasContent.fill(-1, index.keyframeTimes.size());
+            } else {
+                Q_FOREACH (int time, times) {
+                    index.specialKeyframeTimes.append(time);
+                }
+            }
+        }
+
+        std::sort(index.specialKeyframeTimes.begin(), index.specialKeyframeTimes.end());
+
+        return *framesIndexes.insert(dummy, index);
+    }
+
+    /// \return the position of the keyframe active at \p column in \p index, or -1
+    static int activeKeyframePos(const FramesIndex &index, int column) {
+        auto it = std::upper_bound(index.keyframeTimes.begin(), index.keyframeTimes.end(), column);
+        return int(it - index.keyframeTimes.begin()) - 1;
+    }
+
     KisNodeDummy* parentOfRemovedNode;
     QScopedPointer<TimelineNodeListKeeper> converter;
 
@@ -93,45 +146,44 @@ struct TimelineFramesModel::Private
         KisNodeDummy *dummy = converter->dummyFromRow(row);
         if (!dummy) return false;
 
-        KisKeyframeChannel *primaryChannel = dummy->node()->getKeyframeChannel(KisKeyframeChannel::Raster.id());
-        return (primaryChannel && primaryChannel->keyframeAt(column));
+        const FramesIndex &index = framesIndex(dummy);
+        return std::binary_search(index.keyframeTimes.begin(), index.keyframeTimes.end(), column);
     }
 
     bool frameHasContent(int row, int column) {
         KisNodeDummy *dummy = converter->dummyFromRow(row);
+        if (!dummy) return false;
 
-        KisKeyframeChannel *primaryChannel = dummy->node()->getKeyframeChannel(KisKeyframeChannel::Raster.id());
-        if (!primaryChannel) return false;
+        FramesIndex &index = framesIndex(dummy);
+        const int pos = activeKeyframePos(index, column);
+        if (pos < 0) return false;
 
-        // first check if we are a key frame
-        KisRasterKeyframeSP frame = primaryChannel->activeKeyframeAt<KisRasterKeyframe>(column);
-        if (!frame) return false;
+        if (index.hasContent[pos] < 0) {
+            KisKeyframeChannel *primaryChannel = dummy->node()->getKeyframeChannel(KisKeyframeChannel::Raster.id());
+            KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(primaryChannel, false);
 
-        return frame->hasContent();
+            KisRasterKeyframeSP frame = primaryChannel->keyframeAt<KisRasterKeyframe>(index.keyframeTimes[pos]);
+            index.hasContent[pos] = frame && frame->hasContent();
+        }
+
+        return index.hasContent[pos];
     }
 
     bool specialKeyframeExists(int row, int column) {
         KisNodeDummy *dummy = converter->dummyFromRow(row);
         if (!dummy) return false;
-        Q_FOREACH(KisKeyframeChannel *channel, dummy->node()->keyframeChannels()) {
-            if (channel->id() != KisKeyframeChannel::Raster.id() && channel->keyframeAt(column)) {
-                return true;
-            }
-        }
-        return false;
+
+        const FramesIndex &index = framesIndex(dummy);
+        return std::binary_search(index.specialKeyframeTimes.begin(), index.specialKeyframeTimes.end(), column);
     }
 
     int frameColorLabel(int row, int column) {
         KisNodeDummy *dummy = converter->dummyFromRow(row);
         if (!dummy) return -1;
 
-        KisKeyframeChannel *primaryChannel = dummy->node()->getKeyframeChannel(KisKeyframeChannel::Raster.id());
-        if (!primaryChannel) return -1;
-
-        KisKeyframeSP frame = primaryChannel->activeKeyframeAt(column);
-        if (!frame) return -1;
-
-        return frame->colorLabel();
+        const FramesIndex &index = framesIndex(dummy);
+        const int pos = activeKeyframePos(index, column);
+        return pos >= 0 ? index.colorLabels[pos] : -1;
     }
 
     void setFrameColorLabel(int row, int column, int color) {
@@ -145,6 +197,7 @@ struct TimelineFramesModel::Private
         if (!frame) return;
 
         frame->setColorLabel(color);
+        framesIndexes.remove(dummy);
     }
 
     int layerColorLabel(int row) const {
@@ -208,6 +261,11 @@ TimelineFramesModel::TimelineFramesModel(QObject *parent)
       m_d(new Private)
 {
     connect(&m_d->updateTimer, SIGNAL(timeout()), SLOT(processUpdateQueue()));
+
+    // the dummies of the removed rows may be deleted, so forget them all
+    auto dropFramesIndexes = [this] () { m_d->framesIndexes.clear(); };
+    connect(this, &TimelineFramesModel::modelAboutToBeReset, this, dropFramesIndexes);
+    connect(this, &TimelineFramesModel::rowsAboutToBeRemoved, this, dropFramesIndexes);
 }
 
 TimelineFramesModel::~TimelineFramesModel()
@@ -304,7 +362,29 @@ void TimelineFramesModel::slotImageContentChanged()
     KisNodeDummy *dummy = m_d->converter->dummyFromRow(m_d->activeLayerIndex);
     if (!dummy) return;
 
-    slotDummyChanged(dummy);
+    /**
+     * Painting changes only the frames showing the current keyframe,
+     * unless the keyframe has clones elsewhere in the timeline
+     */
+    KisTimeSpan span = KisTimeSpan::infinite(0);
+
+    KisRasterKeyframeChannel *channel =
+        dynamic_cast<KisRasterKeyframeChannel*>(dummy->node()->getKeyframeChannel(KisKeyframeChannel::Raster.id()));
+
+    if (channel) {
+        const int time = m_d->image->animationInterface()->currentUITime();
+        const int keyframeTime = channel->activeKeyframeTime(time);
+
+        if (channel->clonesOf(keyframeTime).isEmpty()) {
+            const KisTimeSpan affectedSpan = channel->affectedFrames(time);
+            if (affectedSpan.isValid()) {
+                span = affectedSpan;
+            }
+        }
+    }
+
+    m_d->contentUpdateQueue[dummy] |= span;
+    m_d->updateTimer.start();
 }
 
 void TimelineFramesModel::processUpdateQueue()
@@ -313,6 +393,8 @@ void TimelineFramesModel::processUpdateQueue()
 
     Q_FOREACH (KisNodeDummy *dummy, m_d->updateQueue) {
         int row = m_d->converter->rowForDummy(dummy);
+        m_d->framesIndexes.remove(dummy);
+        m_d->contentUpdateQueue.remove(dummy);
 
         if (row >= 0) {
             emit headerDataChanged (Qt::Vertical, row, row);
@@ -320,6 +402,25 @@ void TimelineFramesModel::processUpdateQueue()
         }
     }
     m_d->updateQueue.clear();
+
+    for (auto it = m_d->contentUpdateQueue.constBegin(); it != m_d->contentUpdateQueue.constEnd(); ++it) {
+        int row = m_d->converter->rowForDummy(it.key());
+
+        if (row >= 0) {
+            notifyFramesChanged(row, it.value());
+        }
+    }
+    m_d->contentUpdateQueue.clear();
+}
+
+void TimelineFramesModel::notifyFramesChanged(int row, const KisTimeSpan &span)
+{
+    KisNodeDummy *dummy = m_d->converter ? m_d->converter->dummyFromRow(row) : 0;
+    if (dummy) {
+        m_d->framesIndexes.remove(dummy);
+    }
+
+    ModelWithExternalNotifications::notifyFramesChanged(row, span);
 }
 
 void TimelineFramesModel::slotCurrentNodeChanged(KisNodeSP node)
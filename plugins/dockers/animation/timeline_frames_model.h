@@ -137,6 +137,8 @@ public:
     void setNodeManipulationInterface(NodeManipulationInterface *iface);
     KisNodeSP nodeAt(QModelIndex index) const override;
 
+    void notifyFramesChanged(int row, const KisTimeSpan &span) override;
+
 protected:
     QMap<QString, KisKeyframeChannel *> channelsAt(QModelIndex index) const override;
     KisKeyframeChannel* channelByID(QModelIndex index, const QString &id) const;
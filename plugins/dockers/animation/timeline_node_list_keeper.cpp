@@ -11,8 +11,8 @@
 #include "timeline_frames_index_converter.h"
 
 #include <QSet>
-#include <KisSignalMapper.h>
 #include "kis_keyframe_channel.h"
+#include "kis_raster_keyframe_channel.h"
 #include "KisNodeDisplayModeAdapter.h"
 
 
@@ -41,7 +41,6 @@ struct TimelineNodeListKeeper::Private
     TimelineFramesIndexConverter converter;
 
     QVector<KisNodeDummy*> dummiesList;
-    KisSignalMapper dummiesUpdateMapper;
     QSet<KisNodeDummy*> connectionsSet;
 
     void populateDummiesList() {
@@ -79,8 +78,6 @@ TimelineNodeListKeeper::TimelineNodeListKeeper(ModelWithExternalNotifications *m
 
     m_d->populateDummiesList();
 
-    connect(&m_d->dummiesUpdateMapper, SIGNAL(mapped(QObject*)), SLOT(slotUpdateDummyContent(QObject*)));
-
     connect(m_d->displayModeAdapter, SIGNAL(sigNodeDisplayModeChanged(bool, bool)), SLOT(slotDisplayModeChanged()));
 }
 
@@ -124,15 +121,23 @@ void TimelineNodeListKeeper::updateActiveDummy(KisNodeDummy *dummy)
     }
 }
 
-void TimelineNodeListKeeper::slotUpdateDummyContent(QObject *_dummy)
+void TimelineNodeListKeeper::updateDummyContent(KisNodeDummy *dummy, KisKeyframeChannel *channel, const KisTimeSpan &affectedSpan)
 {
-    KisNodeDummy *dummy = qobject_cast<KisNodeDummy*>(_dummy);
     int pos = m_d->converter.rowForDummy(dummy);
     if (pos < 0) return;
 
-    QModelIndex index0 = m_d->model->index(pos, 0);
-    QModelIndex index1 = m_d->model->index(pos, m_d->model->columnCount() - 1);
-    m_d->model->callIndexChanged(index0, index1);
+    KisTimeSpan span = affectedSpan.isValid() ? affectedSpan : KisTimeSpan::infinite(0);
+
+    /**
+     * The clones of a keyframe are shown wherever they are, so
+     * changing one of them may change the cells of the others
+     */
+    KisRasterKeyframeChannel *rasterChannel = dynamic_cast<KisRasterKeyframeChannel*>(channel);
+    if (rasterChannel && !rasterChannel->clonesOf(span.start()).isEmpty()) {
+        span = KisTimeSpan::infinite(0);
+    }
+
+    m_d->model->notifyFramesChanged(pos, span);
 }
 
 void TimelineNodeListKeeper::Private::tryConnectDummy(KisNodeDummy *dummy)
@@ -150,8 +155,10 @@ void TimelineNodeListKeeper::Private::tryConnectDummy(KisNodeDummy *dummy)
     if (connectionsSet.contains(dummy)) return;
 
     Q_FOREACH(KisKeyframeChannel *channel, channels) {
-        connect(channel, SIGNAL(sigChannelUpdated(KisTimeSpan,QRect)), &dummiesUpdateMapper, SLOT(map()));
-        dummiesUpdateMapper.setMapping(channel, (QObject*)dummy);
+        QObject::connect(channel, &KisKeyframeChannel::sigChannelUpdated, q,
+            [this, dummy, channel] (const KisTimeSpan &span, const QRect &) {
+                q->updateDummyContent(dummy, channel, span);
+            });
     }
     connectionsSet.insert(dummy);
 }
@@ -170,7 +177,7 @@ void TimelineNodeListKeeper::Private::disconnectDummy(KisNodeDummy *dummy)
     }
 
     Q_FOREACH(KisKeyframeChannel *channel, channels) {
-        channel->disconnect(&dummiesUpdateMapper);
+        channel->disconnect(q);
     }
 
     connectionsSet.remove(dummy);
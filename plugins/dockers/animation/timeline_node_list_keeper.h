@@ -15,6 +15,7 @@
 #include "kritaanimationdocker_export.h"
 
 #include "kis_time_based_item_model.h"
+#include "kis_time_span.h"
 
 class KisNodeDummy;
 class KisDummiesFacadeBase;
@@ -49,10 +50,11 @@ private Q_SLOTS:
     void slotBeginRemoveDummy(KisNodeDummy *dummy);
     void slotDummyChanged(KisNodeDummy *dummy);
 
-    void slotUpdateDummyContent(QObject *dummy);
-
     void slotDisplayModeChanged();
 
+private:
+    void updateDummyContent(KisNodeDummy *dummy, KisKeyframeChannel *channel, const KisTimeSpan &affectedSpan);
+
 public:
     struct ModelWithExternalNotifications : public KisTimeBasedItemModel {
         ModelWithExternalNotifications(QObject *parent)
@@ -85,6 +87,18 @@ public:
         void callIndexChanged(const QModelIndex &index0, const QModelIndex &index1) {
             emit dataChanged(index0, index1);
         }
+
+        /**
+         * Called when the keyframes of \p row change within \p span,
+         * only the cells of the span are reported as changed
+         */
+        virtual void notifyFramesChanged(int row, const KisTimeSpan &span) {
+            const int lastColumn = span.isInfinite() ? columnCount() - 1 : qMin(span.end(), columnCount() - 1);
+            const int firstColumn = qMax(0, span.start());
+            if (firstColumn > lastColumn) return;
+
+            emit dataChanged(index(row, firstColumn), index(row, lastColumn));
+        }
     };
 
     struct OtherLayer {
@@ -132,10 +132,16 @@ void KisColorSelector::selectColor(const KisColor& color)
 void KisColorSelector::setFgColor(const KoColor& fgColor)
 {
     if (!m_widgetUpdatesSelf) {
+        const qreal oldLight = m_selectedColor.getX();
+
         m_fgColor = KisColor(fgColor, m_colorConverter, m_colorSpace, m_lumaR, m_lumaG, m_lumaB, m_lumaGamma);
         m_selectedColor = KisColor(fgColor, m_colorConverter, m_colorSpace, m_lumaR, m_lumaG, m_lumaB, m_lumaGamma);
 
-        m_isDirtyWheel = true;
+        // the wheel depends only on the lightness of the selected color,
+        // the selection itself is painted over it by drawOutline()
+        if (!qFuzzyCompare(oldLight, m_selectedColor.getX())) {
+            m_isDirtyWheel = true;
+        }
         m_isDirtyLightStrip = true;
         m_isDirtyColorPreview = true;
 #ifdef DEBUG_ARC_SELECTOR
@@ -13,6 +13,7 @@
 #include <QTime>
 #include <QPainter>
 #include <QPainterPath>
+#include <QtConcurrent>
 #include <functional>
 
 #include "KoChannelInfo.h"
@@ -21,19 +22,49 @@
 #include "kis_iterator_ng.h"
 #include "kis_canvas2.h"
 
+namespace {
+
+/**
+ * The size of the cells of the histogram cache, big enough to keep the
+ * memory of the cache small even for huge images
+ */
+const int histogramCellSize = 256;
+
+/**
+ * When the updates touch too many areas, their bounding rect is counted
+ * again instead
+ */
+const int maxDirtyRects = 64;
+
+}
+
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
-    : QLabel(parent, f), m_colorSpace(0), m_smoothHistogram(true)
+    : QLabel(parent, f), m_colorSpace(0), m_smoothHistogram(true),
+      m_computationRunning(false), m_updatePending(false)
 {
     setObjectName(name);
 }
 
 HistogramDockerWidget::~HistogramDockerWidget()
 {
-
+    // the running thread still uses the cache of the cells
+    if (m_workerThread) {
+        m_workerThread->wait();
+    }
 }
 
 void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas)
 {
+    /**
+     * The cache of the cells is owned by the running thread until it
+     * finishes, so the update is postponed till then
+     */
+    if (m_computationRunning) {
+        m_updatePending = true;
+        m_pendingCanvas = canvas;
+        return;
+    }
+
     if (canvas) {
         KisPaintDeviceSP paintDevice = canvas->image()->projection();
         QRect bounds = canvas->image()->bounds();
@@ -41,20 +72,58 @@ void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas)
         // remember to save the color space to paint the histogram data!
         m_colorSpace = paintDevice->colorSpace();
 
+        // the projection device changes when switching the images or
+        // entering the isolated mode, the cached cells are useless then
+        if (!m_lastPaintDevice.isValid() || m_lastPaintDevice != paintDevice.data()) {
+            m_cellCache = HistogramCellCache();
+            m_lastPaintDevice = paintDevice;
+        }
+
         KisPaintDeviceSP m_devClone = new KisPaintDevice(paintDevice->colorSpace());
 
         m_devClone->makeCloneFrom(paintDevice, bounds);
 
-        HistogramComputationThread *workerThread = new HistogramComputationThread(m_devClone, bounds);
+        HistogramComputationThread *workerThread = new HistogramComputationThread(m_devClone, bounds, &m_cellCache, m_dirtyRects);
+        m_dirtyRects.clear();
+        m_computationRunning = true;
+        m_workerThread = workerThread;
+
         connect(workerThread, &HistogramComputationThread::resultReady, this, &HistogramDockerWidget::receiveNewHistogram);
+        connect(workerThread, &HistogramComputationThread::finished, this, &HistogramDockerWidget::slotComputationFinished);
         connect(workerThread, &HistogramComputationThread::finished, workerThread, &QObject::deleteLater);
         workerThread->start();
     } else {
+        m_cellCache = HistogramCellCache();
+        m_lastPaintDevice = KisPaintDeviceWSP();
+        m_dirtyRects.clear();
         m_histogramData.clear();
         update();
     }
 }
 
+void HistogramDockerWidget::addDirtyRect(const QRect &rc)
+{
+    m_dirtyRects.append(rc);
+
+    if (m_dirtyRects.size() > maxDirtyRects) {
+        QRect bounds;
+        Q_FOREACH (const QRect &dirtyRect, m_dirtyRects) {
+            bounds |= dirtyRect;
+        }
+        m_dirtyRects = {bounds};
+    }
+}
+
+void HistogramDockerWidget::slotComputationFinished()
+{
+    m_computationRunning = false;
+
+    if (m_updatePending) {
+        m_updatePending = false;
+        updateHistogram(m_pendingCanvas);
+    }
+}
+
 void HistogramDockerWidget::receiveNewHistogram(HistVector *histogramData)
 {
     m_histogramData = *histogramData;
@@ -154,27 +223,90 @@ void HistogramComputationThread::run()
         bin.resize(std::numeric_limits<quint8>::max() + 1);
     }
 
-    QRect bounds = m_dev->exactBounds();
-    if (bounds.isEmpty())
-        return;
+    HistogramCellCache &cache = *m_cache;
+
+    if (!cache.colorSpace || *cache.colorSpace != *cs || cache.bounds != m_bounds) {
+        const int rows = (m_bounds.height() + histogramCellSize - 1) / histogramCellSize;
+
+        cache.colorSpace = cs;
+        cache.bounds = m_bounds;
+        cache.columns = (m_bounds.width() + histogramCellSize - 1) / histogramCellSize;
+        cache.cells.assign(cache.columns * rows, HistVector());
+        cache.validCells.assign(cache.columns * rows, false);
+    }
+
+    Q_FOREACH (const QRect &rc, m_dirtyRects) {
+        const QRect dirtyRect = rc & m_bounds;
+        if (dirtyRect.isEmpty()) continue;
+
+        const int left = (dirtyRect.left() - m_bounds.left()) / histogramCellSize;
+        const int right = (dirtyRect.right() - m_bounds.left()) / histogramCellSize;
+        const int top = (dirtyRect.top() - m_bounds.top()) / histogramCellSize;
+        const int bottom = (dirtyRect.bottom() - m_bounds.top()) / histogramCellSize;
+
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                cache.validCells[row * cache.columns + column] = false;
+            }
+        }
+    }
+
+    QVector<int> invalidCells;
+    for (int i = 0; i < int(cache.validCells.size()); ++i) {
+        if (!cache.validCells[i]) {
+            invalidCells << i;
+        }
+    }
+
+    const QRect bounds = m_dev->exactBounds();
+
+    QtConcurrent::blockingMap(invalidCells,
+        [&] (const int &cellIndex) {
+            HistVector &cellBins = cache.cells[cellIndex];
+            cellBins.assign(channelCount, std::vector<quint32>(std::numeric_limits<quint8>::max() + 1, 0));
+
+            const QRect cellRect =
+                QRect(m_bounds.left() + (cellIndex % cache.columns) * histogramCellSize,
+                      m_bounds.top() + (cellIndex / cache.columns) * histogramCellSize,
+                      histogramCellSize, histogramCellSize) & bounds;
 
-    quint32 toSkip = nSkip;
+            if (cellRect.isEmpty()) return;
 
-    KisSequentialConstIterator it(m_dev, m_dev->exactBounds());
+            quint32 toSkip = nSkip;
 
-    int numConseqPixels = it.nConseqPixels();
-    while (it.nextPixels(numConseqPixels)) {
+            KisSequentialConstIterator it(m_dev, cellRect);
 
-        numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    bins[chan][cs->scaleToU8(pixel, chan)]++;
+            int numConseqPixels = it.nConseqPixels();
+            while (it.nextPixels(numConseqPixels)) {
+
+                numConseqPixels = it.nConseqPixels();
+                const quint8* pixel = it.rawDataConst();
+                for (int k = 0; k < numConseqPixels; ++k) {
+                    if (--toSkip == 0) {
+                        for (int chan = 0; chan < (int)channelCount; ++chan) {
+                            cellBins[chan][cs->scaleToU8(pixel, chan)]++;
+                        }
+                        toSkip = nSkip;
+                    }
+                    pixel += pixelSize;
                 }
-                toSkip = nSkip;
             }
-            pixel += pixelSize;
+        });
+
+    Q_FOREACH (int cellIndex, invalidCells) {
+        cache.validCells[cellIndex] = true;
+    }
+
+    if (bounds.isEmpty())
+        return;
+
+    for (const HistVector &cellBins : cache.cells) {
+        for (int chan = 0; chan < (int)channelCount; ++chan) {
+            const std::vector<quint32> &src = cellBins[chan];
+            std::vector<quint32> &dst = bins[chan];
+            for (size_t i = 0; i < dst.size(); ++i) {
+                dst[i] += src[i];
+            }
         }
     }
 
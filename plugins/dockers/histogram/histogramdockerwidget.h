@@ -12,6 +12,8 @@
 #include <QWidget>
 #include <QLabel>
 #include <QThread>
+#include <QPointer>
+#include <QVector>
 #include "kis_types.h"
 #include <vector>
 
@@ -20,12 +22,28 @@ class KoColorSpace;
 
 typedef std::vector<std::vector<quint32> > HistVector; //Don't use QVector here - it's too slow for this purpose
 
+/**
+ * The histograms of the square cells of the image counted by the previous
+ * runs of HistogramComputationThread. The histogram of the image is the sum
+ * of the cells, so only the cells touched by the updates of the image are
+ * counted again.
+ */
+struct HistogramCellCache
+{
+    const KoColorSpace *colorSpace = 0;
+    QRect bounds;
+    int columns = 0;
+    std::vector<HistVector> cells;
+    std::vector<bool> validCells;
+};
+
 
 class HistogramComputationThread : public QThread
 {
     Q_OBJECT
 public:
-    HistogramComputationThread(KisPaintDeviceSP _dev, const QRect& _bounds) : m_dev(_dev), m_bounds(_bounds)
+    HistogramComputationThread(KisPaintDeviceSP _dev, const QRect& _bounds, HistogramCellCache *_cache, const QVector<QRect> &_dirtyRects)
+        : m_dev(_dev), m_bounds(_bounds), m_cache(_cache), m_dirtyRects(_dirtyRects)
     {}
 
     void run() override;
@@ -36,6 +54,8 @@ Q_SIGNALS:
 private:
     KisPaintDeviceSP m_dev;
     QRect m_bounds;
+    HistogramCellCache *m_cache;
+    QVector<QRect> m_dirtyRects;
     HistVector bins;
 };
 
@@ -61,8 +81,24 @@ public Q_SLOTS:
     void updateHistogram(KisCanvas2* canvas);
     void receiveNewHistogram(HistVector*);
 
+    /**
+     * @brief addDirtyRect marks the area of the image that should be
+     * counted again by the next update of the histogram
+     */
+    void addDirtyRect(const QRect &rc);
+
+private Q_SLOTS:
+    void slotComputationFinished();
+
 private:
     HistVector m_histogramData;
+    HistogramCellCache m_cellCache;
+    KisPaintDeviceWSP m_lastPaintDevice;
+    QVector<QRect> m_dirtyRects;
+    bool m_computationRunning;
+    bool m_updatePending;
+    QPointer<KisCanvas2> m_pendingCanvas;
+    QPointer<HistogramComputationThread> m_workerThread;
     const KoColorSpace* m_colorSpace;
     bool m_smoothHistogram;
 };
@@ -30,12 +30,15 @@ public:
     QRect tileRect;
 };
 
-OverviewThumbnailStrokeStrategy::OverviewThumbnailStrokeStrategy(KisPaintDeviceSP device, const QRect& rect, const QSize& thumbnailSize, bool isPixelArt)
+OverviewThumbnailStrokeStrategy::OverviewThumbnailStrokeStrategy(KisPaintDeviceSP device, const QRect& rect, const QSize& thumbnailSize, bool isPixelArt,
+                                                                 KisPaintDeviceSP thumbnailDevice, const QVector<QRect> &dirtyRects)
     : KisSimpleStrokeStrategy(QLatin1String("OverviewThumbnail")),
       m_device(device),
       m_rect(rect),
       m_thumbnailSize(thumbnailSize),
-      m_isPixelArt(isPixelArt)
+      m_isPixelArt(isPixelArt),
+      m_thumbnailDevice(thumbnailDevice),
+      m_dirtyRects(dirtyRects)
 {
     enableJob(KisSimpleStrokeStrategy::JOB_INIT, true, KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
     enableJob(KisSimpleStrokeStrategy::JOB_DOSTROKE);
@@ -51,6 +54,17 @@ OverviewThumbnailStrokeStrategy::~OverviewThumbnailStrokeStrategy()
 {
 }
 
+QSize OverviewThumbnailStrokeStrategy::thumbnailOversampledSize(const QSize &thumbnailSize, const QRect &imageRect)
+{
+    QSize size = oversample * thumbnailSize;
+
+    if ((size.width() > imageRect.width()) || (size.height() > imageRect.height())) {
+        size.scale(imageRect.size(), Qt::KeepAspectRatio);
+    }
+
+    return size;
+}
+
 KisStrokeStrategy *OverviewThumbnailStrokeStrategy::createLodClone(int levelOfDetail)
 {
     Q_UNUSED(levelOfDetail);
@@ -72,19 +86,44 @@ void OverviewThumbnailStrokeStrategy::initStrokeCallback()
 {
     const QRect imageRect = m_device->defaultBounds()->bounds();
 
-    m_thumbnailOversampledSize = oversample * m_thumbnailSize;
+    m_thumbnailOversampledSize = thumbnailOversampledSize(m_thumbnailSize, imageRect);
 
-    if ((m_thumbnailOversampledSize.width() > imageRect.width()) || (m_thumbnailOversampledSize.height() > imageRect.height())) {
-        m_thumbnailOversampledSize.scale(imageRect.size(), Qt::KeepAspectRatio);
+    if (!m_thumbnailDevice || !(*m_thumbnailDevice->colorSpace() == *m_device->colorSpace())) {
+        m_thumbnailDevice = new KisPaintDevice(m_device->colorSpace());
+        m_dirtyRects = {imageRect};
     }
 
-    m_thumbnailDevice = new KisPaintDevice(m_device->colorSpace());
+    /**
+     * Every pixel of the thumbnail is sampled from the image independently,
+     * so regenerating only the tiles touched by the dirty rects gives exactly
+     * the same result as regenerating the whole thumbnail
+     */
+    const qreal xScale = qreal(m_thumbnailOversampledSize.width()) / imageRect.width();
+    const qreal yScale = qreal(m_thumbnailOversampledSize.height()) / imageRect.height();
+
+    QVector<QRect> dirtyThumbnailRects;
+    Q_FOREACH (const QRect &rc, m_dirtyRects) {
+        const QRect dirtyRect = rc & imageRect;
+        if (dirtyRect.isEmpty()) continue;
+
+        const QPointF topLeft = dirtyRect.topLeft() - imageRect.topLeft();
+        const QPointF bottomRight = dirtyRect.bottomRight() - imageRect.topLeft() + QPoint(1, 1);
+
+        dirtyThumbnailRects << QRectF(QPointF(topLeft.x() * xScale, topLeft.y() * yScale),
+                                      QPointF(bottomRight.x() * xScale, bottomRight.y() * yScale))
+                               .toAlignedRect().adjusted(-1, -1, 1, 1);
+    }
 
     QVector<KisStrokeJobData*> jobsData;
 
     QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(QRect(QPoint(0, 0), m_thumbnailOversampledSize), QSize(thumbnailTileDim, thumbnailTileDim));
     Q_FOREACH (const QRect &tileRect, tileRects) {
-        jobsData << new OverviewThumbnailStrokeStrategy::ProcessData(tileRect);
+        Q_FOREACH (const QRect &dirtyRect, dirtyThumbnailRects) {
+            if (dirtyRect.intersects(tileRect)) {
+                jobsData << new OverviewThumbnailStrokeStrategy::ProcessData(tileRect);
+                break;
+            }
+        }
     }
 
     addMutatedJobs(jobsData);
@@ -105,17 +144,20 @@ void OverviewThumbnailStrokeStrategy::finishStrokeCallback()
 {
     QImage overviewImage;
 
+    // the oversampled device is kept for the next incremental update, so scale a copy
+    KisPaintDeviceSP scaledDevice = new KisPaintDevice(*m_thumbnailDevice);
+
     KoDummyUpdater updater;
     qreal xscale = m_thumbnailSize.width() / (qreal)m_thumbnailOversampledSize.width();
     qreal yscale = m_thumbnailSize.height() / (qreal)m_thumbnailOversampledSize.height();
     QString algorithm = m_isPixelArt ? "Box" : "Bilinear";
-    KisTransformWorker worker(m_thumbnailDevice, yscale, xscale, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+    KisTransformWorker worker(scaledDevice, yscale, xscale, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
                               &updater, KisFilterStrategyRegistry::instance()->value(algorithm));
     worker.run();
 
-    overviewImage = m_thumbnailDevice->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(),
-                                                       QRect(QPoint(0,0), m_thumbnailSize));
-    emit thumbnailUpdated(overviewImage);
+    overviewImage = scaledDevice->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(),
+                                                  QRect(QPoint(0,0), m_thumbnailSize));
+    emit thumbnailUpdated(overviewImage, m_thumbnailDevice);
 }
 
 void OverviewThumbnailStrokeStrategy::cancelStrokeCallback()
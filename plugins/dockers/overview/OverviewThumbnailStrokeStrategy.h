@@ -12,6 +12,7 @@
 #include <QRect>
 #include <QSize>
 #include <QImage>
+#include <QVector>
 
 #include "kis_types.h"
 #include "kis_simple_stroke_strategy.h"
@@ -21,9 +22,18 @@ class OverviewThumbnailStrokeStrategy : public QObject, public KisSimpleStrokeSt
 {
     Q_OBJECT
 public:
-    OverviewThumbnailStrokeStrategy(KisPaintDeviceSP device, const QRect& rect, const QSize& thumbnailSize, bool isPixelArt = false);
+    /**
+     * \p thumbnailDevice is the oversampled thumbnail generated by the
+     * previous stroke. Only the tiles of it covering \p dirtyRects of the
+     * image are regenerated from \p device, the rest is reused as it is.
+     * The device should have the size returned by thumbnailOversampledSize().
+     */
+    OverviewThumbnailStrokeStrategy(KisPaintDeviceSP device, const QRect& rect, const QSize& thumbnailSize, bool isPixelArt,
+                                    KisPaintDeviceSP thumbnailDevice, const QVector<QRect> &dirtyRects);
     ~OverviewThumbnailStrokeStrategy() override;
 
+    static QSize thumbnailOversampledSize(const QSize &thumbnailSize, const QRect &imageRect);
+
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
 private:
@@ -34,7 +44,8 @@ private:
 
 Q_SIGNALS:
     //Emitted when thumbnail is updated and overviewImage is fully generated.
-    void thumbnailUpdated(QImage pixmap);
+    //thumbnailDevice is the oversampled thumbnail to be passed to the next stroke.
+    void thumbnailUpdated(QImage pixmap, KisPaintDeviceSP thumbnailDevice);
 
 
 private:
@@ -46,6 +57,7 @@ private:
     QSize m_thumbnailOversampledSize;
     bool m_isPixelArt {false};
     KisPaintDeviceSP m_thumbnailDevice;
+    QVector<QRect> m_dirtyRects;
 };
 
 #endif // OVERVIEWTHUMBNAILSTROKESTRATEGY_H
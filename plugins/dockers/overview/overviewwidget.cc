@@ -12,6 +12,9 @@
 #include <QPainter>
 #include <QCursor>
 
+#include <functional>
+#include <numeric>
+
 #include <KoCanvasController.h>
 #include <KoZoomController.h>
 
@@ -49,13 +52,16 @@ void OverviewWidget::setCanvas(KoCanvasBase * canvas)
 
     m_canvas = dynamic_cast<KisCanvas2*>(canvas);
 
+    m_thumbnailDevice = 0;
+    m_dirtyRects.clear();
+
     if (m_canvas) {
         m_imageIdleWatcher.setTrackedImage(m_canvas->image());
 
         connect(&m_imageIdleWatcher, &KisIdleWatcher::startedIdleMode, this, &OverviewWidget::generateThumbnail);
 
-        connect(m_canvas->image(), SIGNAL(sigImageUpdated(QRect)),SLOT(startUpdateCanvasProjection()));
-        connect(m_canvas->image(), SIGNAL(sigSizeChanged(QPointF,QPointF)),SLOT(startUpdateCanvasProjection()));
+        connect(m_canvas->image(), SIGNAL(sigImageUpdated(QRect)),SLOT(slotImageUpdated(QRect)));
+        connect(m_canvas->image(), SIGNAL(sigSizeChanged(QPointF,QPointF)),SLOT(slotImageSizeChanged()));
 
         connect(m_canvas->canvasController()->proxyObject, SIGNAL(canvasOffsetXChanged(int)), this, SLOT(update()), Qt::UniqueConnection);
         connect(m_canvas->viewManager()->mainWindow(), SIGNAL(themeChanged()), this, SLOT(slotThemeChanged()));
@@ -119,6 +125,34 @@ void OverviewWidget::startUpdateCanvasProjection()
     m_imageIdleWatcher.startCountdown();
 }
 
+void OverviewWidget::slotImageUpdated(const QRect &rect)
+{
+    /**
+     * A long stroke emits thousands of updates, there is no point in
+     * tracking them separately, the thumbnail tiles are big anyway
+     */
+    const int maxDirtyRects = 64;
+
+    if (m_dirtyRects.size() >= maxDirtyRects) {
+        const QRect boundingRect =
+            std::accumulate(m_dirtyRects.constBegin(), m_dirtyRects.constEnd(),
+                            rect, std::bit_or<QRect>());
+        m_dirtyRects = {boundingRect};
+    } else {
+        m_dirtyRects << rect;
+    }
+
+    startUpdateCanvasProjection();
+}
+
+void OverviewWidget::slotImageSizeChanged()
+{
+    m_thumbnailDevice = 0;
+    m_dirtyRects.clear();
+
+    startUpdateCanvasProjection();
+}
+
 void OverviewWidget::showEvent(QShowEvent *event)
 {
     Q_UNUSED(event);
@@ -207,10 +241,34 @@ void OverviewWidget::generateThumbnail()
                     m_imageIdleWatcher.startCountdown();
                     return;
                 }
+
+                const QSize thumbnailDeviceSize =
+                    OverviewThumbnailStrokeStrategy::thumbnailOversampledSize(m_previewSize, image->bounds());
+
+                if (m_thumbnailDevice &&
+                    (m_thumbnailDeviceSize != thumbnailDeviceSize ||
+                     m_thumbnailDeviceImageBounds != image->bounds())) {
+
+                    m_thumbnailDevice = 0;
+                }
+
+                if (!m_thumbnailDevice) {
+                    m_dirtyRects = {image->bounds()};
+                }
+
+                m_thumbnailDeviceSize = thumbnailDeviceSize;
+                m_thumbnailDeviceImage = image;
+                m_thumbnailDeviceImageBounds = image->bounds();
+
                 OverviewThumbnailStrokeStrategy* stroke;
-                stroke = new OverviewThumbnailStrokeStrategy(image->projection(), image->bounds(), m_previewSize, isPixelArt());
+                stroke = new OverviewThumbnailStrokeStrategy(image->projection(), image->bounds(), m_previewSize, isPixelArt(),
+                                                             m_thumbnailDevice, m_dirtyRects);
+
+                // the stroke owns the device until it reports it back
+                m_thumbnailDevice = 0;
+                m_dirtyRects.clear();
 
-                connect(stroke, SIGNAL(thumbnailUpdated(QImage)), this, SLOT(updateThumbnail(QImage)));
+                connect(stroke, SIGNAL(thumbnailUpdated(QImage, KisPaintDeviceSP)), this, SLOT(updateThumbnail(QImage, KisPaintDeviceSP)));
 
                 strokeId = image->startStroke(stroke);
                 image->endStroke(strokeId);
@@ -219,8 +277,19 @@ void OverviewWidget::generateThumbnail()
     }
 }
 
-void OverviewWidget::updateThumbnail(QImage pixmap)
+void OverviewWidget::updateThumbnail(QImage pixmap, KisPaintDeviceSP thumbnailDevice)
 {
+    /**
+     * If the image has been resized or the canvas switched while the
+     * stroke was running, the device is already outdated
+     */
+    if (m_canvas &&
+        m_thumbnailDeviceImage.data() == m_canvas->image().data() &&
+        m_thumbnailDeviceImageBounds == m_canvas->image()->bounds()) {
+
+        m_thumbnailDevice = thumbnailDevice;
+    }
+
     m_pixmap = QPixmap::fromImage(pixmap);
     m_oldPixmap = m_pixmap.copy();
     m_image = pixmap;
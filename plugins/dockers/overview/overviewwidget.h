@@ -12,6 +12,7 @@
 #include <QWidget>
 #include <QPixmap>
 #include <QPointer>
+#include <QVector>
 
 #include <QMutex>
 #include "kis_idle_watcher.h"
@@ -38,8 +39,10 @@ public:
 
 public Q_SLOTS:
     void startUpdateCanvasProjection();
+    void slotImageUpdated(const QRect &rect);
+    void slotImageSizeChanged();
     void generateThumbnail();
-    void updateThumbnail(QImage pixmap);
+    void updateThumbnail(QImage pixmap, KisPaintDeviceSP thumbnailDevice);
     void slotThemeChanged();
 
 protected:
@@ -78,6 +81,18 @@ private:
     QImage m_image;
     QPointer<KisCanvas2> m_canvas;
 
+    /**
+     * The oversampled thumbnail of the last stroke and the areas of the
+     * image changed since then. The next stroke regenerates only the
+     * dirty tiles of it. The strokes own the device while running, so
+     * a cancelled stroke just makes the next one start from scratch.
+     */
+    KisPaintDeviceSP m_thumbnailDevice;
+    QSize m_thumbnailDeviceSize;
+    KisImageWSP m_thumbnailDeviceImage;
+    QRect m_thumbnailDeviceImageBounds;
+    QVector<QRect> m_dirtyRects;
+
 
     QPointF m_previewOrigin; // in the same coordinates space as m_previewSize
     QSize m_previewSize {QSize(100, 100)};
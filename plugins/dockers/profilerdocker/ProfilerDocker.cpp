@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "ProfilerDocker.h"
+
+#include <kpluginfactory.h>
+
+#include <KoDockFactoryBase.h>
+#include <KoDockRegistry.h>
+
+#include "ProfilerDockerDock.h"
+
+K_PLUGIN_FACTORY_WITH_JSON(ProfilerDockerPluginFactory,
+                           "krita_profilerdocker.json",
+                           registerPlugin<ProfilerDockerPlugin>();)
+
+class ProfilerDockerDockFactory : public KoDockFactoryBase {
+public:
+    ProfilerDockerDockFactory()
+    {
+    }
+
+    QString id() const override
+    {
+        return QString("ProfilerDocker");
+    }
+
+    virtual Qt::DockWidgetArea defaultDockWidgetArea() const
+    {
+        return Qt::RightDockWidgetArea;
+    }
+
+    QDockWidget* createDockWidget() override
+    {
+        ProfilerDockerDock *dockWidget = new ProfilerDockerDock();
+        dockWidget->setObjectName(id());
+
+        return dockWidget;
+    }
+
+    DockPosition defaultDockPosition() const override
+    {
+        return DockMinimized;
+    }
+};
+
+
+ProfilerDockerPlugin::ProfilerDockerPlugin(QObject *parent, const QVariantList &)
+    : QObject(parent)
+{
+    KoDockRegistry::instance()->add(new ProfilerDockerDockFactory());
+}
+
+ProfilerDockerPlugin::~ProfilerDockerPlugin()
+{
+}
+
+#include "ProfilerDocker.moc"
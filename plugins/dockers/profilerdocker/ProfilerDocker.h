@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef _PROFILER_DOCKER_H_
+#define _PROFILER_DOCKER_H_
+
+#include <QObject>
+#include <QVariant>
+
+class ProfilerDockerPlugin : public QObject
+{
+    Q_OBJECT
+public:
+    ProfilerDockerPlugin(QObject *parent, const QVariantList &);
+    ~ProfilerDockerPlugin() override;
+};
+
+#endif
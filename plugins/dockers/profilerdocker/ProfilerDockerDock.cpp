@@ -0,0 +1,309 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "ProfilerDockerDock.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QToolButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <klocalizedstring.h>
+#include <kformat.h>
+
+#include <KoIcon.h>
+#include <KoFileDialog.h>
+#include <kis_assert.h>
+
+#include "kis_canvas2.h"
+#include "kis_image.h"
+#include "kis_update_scheduler.h"
+#include "kis_memory_statistics_server.h"
+#include "KisDocument.h"
+#include "KisView.h"
+
+namespace {
+
+/// how often the scheduler is polled for the running jobs
+const int sampleInterval = 100;
+
+/// how often a new sample is published, in milliseconds
+const int publishInterval = 1000;
+
+/// one hour of samples
+const int maxSamples = 3600;
+
+enum MetricRow {
+    ThreadUtilisationRow = 0,
+    UpdatesQueueRow,
+    StrokesQueueRow,
+    DabsRow,
+    TextureUploadRow,
+    SwapInRow,
+    SwapOutRow,
+    ImageMemoryRow,
+    TotalMemoryRow,
+    SwapSizeRow,
+
+    NumRows
+};
+
+const qreal MiB = 1024.0 * 1024.0;
+
+}
+
+ProfilerDockerDock::ProfilerDockerDock()
+    : QDockWidget(i18n("Profiler"))
+{
+    QWidget *page = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(page);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_metricsView = new QTreeWidget(page);
+    m_metricsView->setColumnCount(2);
+    m_metricsView->setHeaderLabels(QStringList() << i18n("Metric") << i18n("Value"));
+    m_metricsView->setRootIsDecorated(false);
+    m_metricsView->setSelectionMode(QAbstractItemView::NoSelection);
+    m_metricsView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    const QStringList names = QStringList()
+        << i18n("Thread utilisation")
+        << i18n("Updates queue")
+        << i18n("Strokes queue")
+        << i18n("Dabs")
+        << i18n("Texture uploads")
+        << i18n("Swap-in")
+        << i18n("Swap-out")
+        << i18n("Image memory")
+        << i18n("Total memory")
+        << i18n("Swap size");
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(names.size() == NumRows);
+
+    Q_FOREACH (const QString &name, names) {
+        new QTreeWidgetItem(m_metricsView, QStringList() << name << QString());
+    }
+
+    layout->addWidget(m_metricsView, 1);
+
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    buttonsLayout->addStretch();
+
+    m_bnClear = new QToolButton(page);
+    m_bnClear->setIcon(koIcon("edit-clear"));
+    m_bnClear->setToolTip(i18n("Clear the recorded samples"));
+    m_bnClear->setAutoRaise(true);
+    connect(m_bnClear, SIGNAL(clicked()), SLOT(clearSamples()));
+    buttonsLayout->addWidget(m_bnClear);
+
+    m_bnSave = new QToolButton(page);
+    m_bnSave->setIcon(koIcon("document-save"));
+    m_bnSave->setToolTip(i18n("Export the recorded samples as CSV"));
+    m_bnSave->setAutoRaise(true);
+    connect(m_bnSave, SIGNAL(clicked()), SLOT(saveSamples()));
+    buttonsLayout->addWidget(m_bnSave);
+
+    layout->addLayout(buttonsLayout);
+
+    setWidget(page);
+
+    m_sampleTimer.setInterval(sampleInterval);
+    connect(&m_sampleTimer, SIGNAL(timeout()), SLOT(slotSample()));
+
+    m_timeSinceStart.start();
+    resetSampling();
+
+    setEnabled(false);
+}
+
+void ProfilerDockerDock::setCanvas(KoCanvasBase *canvas)
+{
+    if (m_canvas == canvas) return;
+
+    m_canvas = dynamic_cast<KisCanvas2*>(canvas);
+    setEnabled(m_canvas);
+
+    resetSampling();
+
+    if (m_canvas && isVisible()) {
+        m_sampleTimer.start();
+    } else {
+        m_sampleTimer.stop();
+    }
+}
+
+void ProfilerDockerDock::unsetCanvas()
+{
+    setEnabled(false);
+    m_canvas = 0;
+    m_sampleTimer.stop();
+}
+
+void ProfilerDockerDock::showEvent(QShowEvent *event)
+{
+    QDockWidget::showEvent(event);
+
+    resetSampling();
+
+    if (m_canvas) {
+        m_sampleTimer.start();
+    }
+}
+
+void ProfilerDockerDock::hideEvent(QHideEvent *event)
+{
+    QDockWidget::hideEvent(event);
+    m_sampleTimer.stop();
+}
+
+void ProfilerDockerDock::resetSampling()
+{
+    m_accumulatedUtilisation = 0.0;
+    m_numTicks = 0;
+
+    for (int i = 0; i < KisPerformanceCounters::NumCounters; i++) {
+        m_lastCounters[i] = KisPerformanceCounters::value(KisPerformanceCounters::Counter(i));
+    }
+
+    m_timeSincePublish.start();
+}
+
+void ProfilerDockerDock::slotSample()
+{
+    if (!m_canvas || !m_canvas->image()) return;
+
+    const KisUpdateSchedulerStatistics stats = m_canvas->image()->schedulerStatistics();
+
+    if (stats.threadsLimit > 0) {
+        m_accumulatedUtilisation +=
+            qreal(stats.numMergeJobs + stats.numStrokeJobs) / stats.threadsLimit;
+    }
+    m_numTicks++;
+
+    if (m_timeSincePublish.elapsed() >= publishInterval) {
+        publishSample();
+    }
+}
+
+void ProfilerDockerDock::publishSample()
+{
+    KisImageSP image = m_canvas->image();
+    const qreal seconds = qMax(qint64(1), m_timeSincePublish.elapsed()) / 1000.0;
+
+    Sample sample;
+    sample.time = m_timeSinceStart.elapsed();
+
+    QPointer<KisView> view = m_canvas->imageView();
+    if (view && view->document()) {
+        sample.document = view->document()->caption();
+    }
+
+    sample.threadUtilisation = m_numTicks ? m_accumulatedUtilisation / m_numTicks : 0.0;
+
+    const KisUpdateSchedulerStatistics stats = image->schedulerStatistics();
+    sample.updatesQueueSize = stats.updatesQueueSize;
+    sample.strokesQueueSize = stats.strokesQueueSize;
+
+    auto rate = [this, seconds] (KisPerformanceCounters::Counter counter) {
+        return (KisPerformanceCounters::value(counter) - m_lastCounters[counter]) / seconds;
+    };
+
+    sample.dabsPerSecond = rate(KisPerformanceCounters::RenderedDabs);
+    sample.textureUploadRate = rate(KisPerformanceCounters::TextureUploadBytes);
+    sample.swapInRate = rate(KisPerformanceCounters::SwappedInBytes);
+    sample.swapOutRate = rate(KisPerformanceCounters::SwappedOutBytes);
+
+    const KisMemoryStatisticsServer::Statistics memory =
+        KisMemoryStatisticsServer::instance()->fetchMemoryStatistics(image);
+
+    sample.imageMemory = memory.imageSize;
+    sample.totalMemory = memory.totalMemorySize;
+    sample.swapSize = memory.swapSize;
+
+    m_samples.append(sample);
+    if (m_samples.size() > maxSamples) {
+        m_samples.removeFirst();
+    }
+
+    showSample(sample);
+    resetSampling();
+}
+
+void ProfilerDockerDock::showSample(const Sample &sample)
+{
+    const KFormat format;
+
+    auto setValue = [this] (int row, const QString &value) {
+        m_metricsView->topLevelItem(row)->setText(1, value);
+    };
+
+    auto formatRate = [] (qreal bytesPerSecond) {
+        return i18nc("data transfer rate", "%1 MiB/s", QString::number(bytesPerSecond / MiB, 'f', 1));
+    };
+
+    setValue(ThreadUtilisationRow, i18nc("percentage", "%1%", qRound(sample.threadUtilisation * 100)));
+    setValue(UpdatesQueueRow, QString::number(sample.updatesQueueSize));
+    setValue(StrokesQueueRow, QString::number(sample.strokesQueueSize));
+    setValue(DabsRow, i18nc("dabs per second", "%1/s", qRound(sample.dabsPerSecond)));
+    setValue(TextureUploadRow, formatRate(sample.textureUploadRate));
+    setValue(SwapInRow, formatRate(sample.swapInRate));
+    setValue(SwapOutRow, formatRate(sample.swapOutRate));
+    setValue(ImageMemoryRow, format.formatByteSize(sample.imageMemory));
+    setValue(TotalMemoryRow, format.formatByteSize(sample.totalMemory));
+    setValue(SwapSizeRow, format.formatByteSize(sample.swapSize));
+}
+
+void ProfilerDockerDock::clearSamples()
+{
+    m_samples.clear();
+}
+
+void ProfilerDockerDock::saveSamples()
+{
+    KoFileDialog fileDialog(this, KoFileDialog::SaveFile, "profilerdocker");
+    fileDialog.setDefaultDir(QStandardPaths::writableLocation(QStandardPaths::DesktopLocation) + "/" +
+                             QString("krita_profile_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+    fileDialog.setMimeTypeFilters(QStringList() << "text/csv");
+    const QString filename = fileDialog.filename();
+    if (filename.isEmpty()) return;
+
+    QFile f(filename);
+    if (!f.open(QFile::WriteOnly | QFile::Text)) {
+        qWarning() << "Could not save the profiling samples to" << filename << f.errorString();
+        return;
+    }
+
+    QTextStream stream(&f);
+    stream.setCodec("UTF-8");
+
+    stream << "time_ms,document,thread_utilisation,updates_queue,strokes_queue,"
+              "dabs_per_s,texture_upload_bytes_per_s,swap_in_bytes_per_s,swap_out_bytes_per_s,"
+              "image_memory_bytes,total_memory_bytes,swap_bytes\n";
+
+    Q_FOREACH (const Sample &sample, m_samples) {
+        QString document = sample.document;
+        document.replace('"', "\"\"");
+
+        stream << sample.time << ','
+               << '"' << document << '"' << ','
+               << QString::number(sample.threadUtilisation, 'f', 3) << ','
+               << sample.updatesQueueSize << ','
+               << sample.strokesQueueSize << ','
+               << qRound64(sample.dabsPerSecond) << ','
+               << qRound64(sample.textureUploadRate) << ','
+               << qRound64(sample.swapInRate) << ','
+               << qRound64(sample.swapOutRate) << ','
+               << sample.imageMemory << ','
+               << sample.totalMemory << ','
+               << sample.swapSize << '\n';
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef _PROFILERDOCKER_DOCK_H_
+#define _PROFILERDOCKER_DOCK_H_
+
+#include <QDockWidget>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+#include <KoCanvasObserverBase.h>
+#include <KisPerformanceCounters.h>
+
+class QTreeWidget;
+class QToolButton;
+class KisCanvas2;
+
+/**
+ * Shows the live load of the active document: the utilisation of the
+ * working threads, the sizes of the update and stroke queues, the memory
+ * used by the image, and the process-wide rates of the rendered dabs,
+ * texture uploads and swapping. The samples are kept while the docker is
+ * visible and can be exported to a CSV file.
+ */
+class ProfilerDockerDock : public QDockWidget, public KoCanvasObserverBase {
+    Q_OBJECT
+public:
+    ProfilerDockerDock();
+
+    QString observerName() override { return "ProfilerDockerDock"; }
+    void setCanvas(KoCanvasBase *canvas) override;
+    void unsetCanvas() override;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private Q_SLOTS:
+    void slotSample();
+    void clearSamples();
+    void saveSamples();
+
+private:
+    struct Sample {
+        qint64 time = 0;
+        QString document;
+
+        qreal threadUtilisation = 0.0;
+        int updatesQueueSize = 0;
+        int strokesQueueSize = 0;
+
+        qreal dabsPerSecond = 0.0;
+        qreal textureUploadRate = 0.0;
+        qreal swapInRate = 0.0;
+        qreal swapOutRate = 0.0;
+
+        qint64 imageMemory = 0;
+        qint64 totalMemory = 0;
+        qint64 swapSize = 0;
+    };
+
+    void resetSampling();
+    void publishSample();
+    void showSample(const Sample &sample);
+
+private:
+    QPointer<KisCanvas2> m_canvas;
+
+    QTreeWidget *m_metricsView;
+    QToolButton *m_bnClear;
+    QToolButton *m_bnSave;
+
+    QTimer m_sampleTimer;
+    QElapsedTimer m_timeSinceStart;
+    QElapsedTimer m_timeSincePublish;
+
+    /// the utilisation of the threads is averaged over the sampling ticks
+    qreal m_accumulatedUtilisation = 0.0;
+    int m_numTicks = 0;
+
+    qint64 m_lastCounters[KisPerformanceCounters::NumCounters];
+
+    QVector<Sample> m_samples;
+};
+
+#endif
@@ -7,6 +7,8 @@
 #include "KisAsyncStoryboardThumbnailRenderer.h"
 #include "kis_image_animation_interface.h"
 #include "kis_image.h"
+#include "kis_paint_device.h"
+#include "KoColorSpaceRegistry.h"
 
 KisAsyncStoryboardThumbnailRenderer::KisAsyncStoryboardThumbnailRenderer(QObject *parent)
 {
@@ -18,14 +20,28 @@ KisAsyncStoryboardThumbnailRenderer::~KisAsyncStoryboardThumbnailRenderer()
 {
 }
 
+void KisAsyncStoryboardThumbnailRenderer::setThumbnailSize(const QSize &size)
+{
+    m_thumbnailSize = size;
+}
+
 void KisAsyncStoryboardThumbnailRenderer::frameCompletedCallback(int frameTime, const KisRegion &requestedRegion)
 {
     KisImageSP image = requestedImage();
-    KisPaintDeviceSP requestedFrame = image ? new KisPaintDevice(*image->projection(), KritaUtils::CopySnapshot) : nullptr;
 
-    if (requestedFrame) {
+    if (image) {
+        QImage thumbnail;
+
+        if (m_thumbnailSize.isEmpty()) {
+            thumbnail = image->projection()->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(), image->bounds());
+        } else {
+            // oversample a bit to keep the thumbnail as smooth as the scaled full-size image
+            thumbnail = image->projection()->createThumbnail(m_thumbnailSize.width(), m_thumbnailSize.height(),
+                                                             image->bounds(), 2);
+        }
+
         emit sigNotifyFrameCompleted(frameTime);
-        emit sigNotifyFrameCompleted(frameTime, requestedFrame);
+        emit sigNotifyFrameCompleted(frameTime, thumbnail);
     } else {
         emit sigNotifyFrameCancelled(frameTime);
     }
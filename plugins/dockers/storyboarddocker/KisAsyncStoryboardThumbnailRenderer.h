@@ -9,12 +9,18 @@
 
 #include <KisAsyncAnimationRendererBase.h>
 
+#include <QSize>
+#include <QImage>
+
 class KisPaintDevice;
 
 /**
  * @class KisAsyncStoryboardThumbnailRenderer
  * @brief requests regeneration of a frame. The regeneration should
  * be requested after switching the @c KisImage to the relevant frame.
+ *
+ * The projection is downscaled to the thumbnail size on the rendering
+ * thread, so the GUI thread gets only a small image to show.
  */
 class KisAsyncStoryboardThumbnailRenderer : public KisAsyncAnimationRendererBase
 {
@@ -23,16 +29,25 @@ public:
     KisAsyncStoryboardThumbnailRenderer(QObject *parent);
     ~KisAsyncStoryboardThumbnailRenderer();
 
+    /**
+     * @brief Sets the size the next rendered frames are downscaled to.
+     * An empty size means the full image size. Should not be called
+     * while a frame is being regenerated.
+     */
+    void setThumbnailSize(const QSize &size);
+
 protected:
     void frameCompletedCallback(int frame, const KisRegion &requestedRegion) override;
     void frameCancelledCallback(int frame) override;
     void clearFrameRegenerationState(bool isCancelled) override;
 
 Q_SIGNALS:
-    void sigNotifyFrameCompleted(int frameTime, KisPaintDeviceSP frameContents);
+    void sigNotifyFrameCompleted(int frameTime, const QImage &thumbnail);
     void sigNotifyFrameCompleted(int frameTime);
     void sigNotifyFrameCancelled(int frame);
 
+private:
+    QSize m_thumbnailSize;
 };
 
 #endif
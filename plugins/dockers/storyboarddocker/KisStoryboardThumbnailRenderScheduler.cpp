@@ -8,18 +8,29 @@
 #include "KisStoryboardThumbnailRenderScheduler.h"
 #include "KisAsyncStoryboardThumbnailRenderer.h"
 #include "kis_paint_device.h"
+#include "kis_image_config.h"
 
 KisStoryboardThumbnailRenderScheduler::KisStoryboardThumbnailRenderScheduler(QObject *parent)
-    : m_renderer(new KisAsyncStoryboardThumbnailRenderer(this))
 {
-    //connect signals to the renderer.
-    connect(m_renderer, SIGNAL(sigNotifyFrameCompleted(int,KisPaintDeviceSP)), this, SLOT(slotFrameRegenerationCompleted(int, KisPaintDeviceSP)));
-    connect(m_renderer, SIGNAL(sigFrameCancelled(int)), this, SLOT(slotFrameRegenerationCancelled(int)));
+    // the renderers share the threads of the image updates, so don't
+    // take more of them than the animation rendering does
+    const int numRenderers = qMax(1, KisImageConfig(true).frameRenderingClones());
+
+    for (int i = 0; i < numRenderers; i++) {
+        KisAsyncStoryboardThumbnailRenderer *renderer = new KisAsyncStoryboardThumbnailRenderer(this);
+
+        //connect signals to the renderer.
+        connect(renderer, SIGNAL(sigNotifyFrameCompleted(int,QImage)), this, SLOT(slotFrameRegenerationCompleted(int,QImage)));
+        connect(renderer, SIGNAL(sigFrameCancelled(int)), this, SLOT(slotFrameRegenerationCancelled(int)));
+
+        m_renderers.append(renderer);
+        m_currentFrames.append(-1);
+    }
 }
 
 KisStoryboardThumbnailRenderScheduler::~KisStoryboardThumbnailRenderScheduler()
 {
-    delete m_renderer;
+    qDeleteAll(m_renderers);
 }
 
 void KisStoryboardThumbnailRenderScheduler::setImage(KisImageSP image)
@@ -56,12 +67,15 @@ void KisStoryboardThumbnailRenderScheduler::scheduleFrameForRegeneration(int fra
 
 void KisStoryboardThumbnailRenderScheduler::cancelAllFrameRendering()
 {
-    m_affectedFramesQueue.empty();
-    m_changedFramesQueue.empty();
-    if (m_renderer->isActive()) {
-        m_renderer->cancelCurrentFrameRendering();
+    m_affectedFramesQueue.clear();
+    m_changedFramesQueue.clear();
+
+    for (int i = 0; i < m_renderers.size(); i++) {
+        if (m_renderers[i]->isActive()) {
+            m_renderers[i]->cancelCurrentFrameRendering();
+        }
+        m_currentFrames[i] = -1;
     }
-    m_currentFrame = -1;
 }
 
 void KisStoryboardThumbnailRenderScheduler::cancelFrameRendering(int frame)
@@ -69,9 +83,12 @@ void KisStoryboardThumbnailRenderScheduler::cancelFrameRendering(int frame)
     if (frame < 0) {
         return;
     }
-    if (m_renderer->isActive() && frame == m_currentFrame) {
-        m_renderer->cancelCurrentFrameRendering();
-        m_currentFrame = -1;
+
+    const int rendererIndex = m_currentFrames.indexOf(frame);
+
+    if (rendererIndex >= 0 && m_renderers[rendererIndex]->isActive()) {
+        m_renderers[rendererIndex]->cancelCurrentFrameRendering();
+        m_currentFrames[rendererIndex] = -1;
     }
     else if (m_changedFramesQueue.contains(frame)) {
         m_changedFramesQueue.removeAll(frame);
@@ -81,23 +98,41 @@ void KisStoryboardThumbnailRenderScheduler::cancelFrameRendering(int frame)
     }
 }
 
+void KisStoryboardThumbnailRenderScheduler::setVisibleFrames(const QSet<int> &frames)
+{
+    m_visibleFrames = frames;
+}
+
+void KisStoryboardThumbnailRenderScheduler::setThumbnailSize(const QSize &size)
+{
+    m_thumbnailSize = size;
+}
+
 void KisStoryboardThumbnailRenderScheduler::slotStartFrameRendering()
 {
-    //if the renderer is idle start rendering the frames in queues
-    if (!m_renderer->isActive()) {
-        renderNextFrame();
-    }
+    //start rendering the frames in queues on the idle renderers
+    renderNextFrame();
 }
 
 
-void KisStoryboardThumbnailRenderScheduler::slotFrameRegenerationCompleted(int frame, KisPaintDeviceSP contents)
+void KisStoryboardThumbnailRenderScheduler::slotFrameRegenerationCompleted(int frame, const QImage &thumbnail)
 {
-    emit sigFrameCompleted(frame, contents);
+    const int rendererIndex = m_renderers.indexOf(static_cast<KisAsyncStoryboardThumbnailRenderer*>(sender()));
+    if (rendererIndex >= 0 && m_currentFrames[rendererIndex] == frame) {
+        m_currentFrames[rendererIndex] = -1;
+    }
+
+    emit sigFrameCompleted(frame, thumbnail);
     renderNextFrame();
 }
 
 void KisStoryboardThumbnailRenderScheduler::slotFrameRegenerationCancelled(int frame)
 {
+    const int rendererIndex = m_renderers.indexOf(static_cast<KisAsyncStoryboardThumbnailRenderer*>(sender()));
+    if (rendererIndex >= 0 && m_currentFrames[rendererIndex] == frame) {
+        m_currentFrames[rendererIndex] = -1;
+    }
+
     emit sigFrameCancelled(frame);
     renderNextFrame();
 }
@@ -114,6 +149,22 @@ void KisStoryboardThumbnailRenderScheduler::sortAffectedFrameQueue()
                 });
 }
 
+int KisStoryboardThumbnailRenderScheduler::takeNextFrame(QVector<int> &queue) const
+{
+    int pos = 0;
+
+    for (int i = 0; i < queue.size(); i++) {
+        if (m_visibleFrames.contains(queue[i])) {
+            pos = i;
+            break;
+        }
+    }
+
+    const int frame = queue[pos];
+    queue.remove(pos);
+    return frame;
+}
+
 void KisStoryboardThumbnailRenderScheduler::renderNextFrame()
 {
     if (!m_image) {
@@ -123,22 +174,34 @@ void KisStoryboardThumbnailRenderScheduler::renderNextFrame()
         return;
     }
 
-    KisImageSP image = m_image->clone(false);
-    if (!m_changedFramesQueue.isEmpty()) {
-        int frame = m_changedFramesQueue.at(0);
-        image->requestTimeSwitch(frame);
-        m_renderer->startFrameRegeneration(image, frame);
-        m_currentFrame = frame;
-        m_changedFramesQueue.removeFirst();
-    }
-    else if (!m_affectedFramesQueue.isEmpty()) {
-        int frame = m_affectedFramesQueue.at(0);
+    for (int i = 0; i < m_renderers.size(); i++) {
+        KisAsyncStoryboardThumbnailRenderer *renderer = m_renderers[i];
+        if (renderer->isActive()) continue;
+
+        int frame = -1;
+
+        if (!m_changedFramesQueue.isEmpty()) {
+            frame = takeNextFrame(m_changedFramesQueue);
+        }
+        else if (!m_affectedFramesQueue.isEmpty()) {
+            frame = takeNextFrame(m_affectedFramesQueue);
+        }
+        else {
+            m_currentFrames[i] = -1;
+            break;
+        }
+
+        // the frame has changed again while being rendered, the old result is useless
+        const int busyRendererIndex = m_currentFrames.indexOf(frame);
+        if (busyRendererIndex >= 0 && m_renderers[busyRendererIndex]->isActive()) {
+            m_renderers[busyRendererIndex]->cancelCurrentFrameRendering();
+            m_currentFrames[busyRendererIndex] = -1;
+        }
+
+        KisImageSP image = m_image->clone(false);
         image->requestTimeSwitch(frame);
-        m_renderer->startFrameRegeneration(image, frame);
-        m_currentFrame = frame;
-        m_affectedFramesQueue.removeFirst();
-    }
-    else {
-        m_currentFrame = -1;
+        renderer->setThumbnailSize(m_thumbnailSize);
+        renderer->startFrameRegeneration(image, frame);
+        m_currentFrames[i] = frame;
     }
 }
@@ -9,6 +9,9 @@
 
 #include <QObject>
 #include <QVector>
+#include <QSet>
+#include <QSize>
+#include <QImage>
 
 #include <kis_image.h>
 
@@ -18,8 +21,12 @@ class KisAsyncStoryboardThumbnailRenderer;
 /**
  * @class KisStoryboardThumbnailRenderScheduler
  * @brief This class maintains queues of dirty frames sorted in the order of proximity
- * to the last changed frame. It regenerates the frames emits the paintdevice for each
- * of the frames. The m_changedFramesQueue list is given preference.
+ * to the last changed frame. It regenerates the frames and emits the thumbnail for each
+ * of the frames. The m_changedFramesQueue list is given preference, and within each
+ * queue the frames of the panels visible in the docker go first.
+ *
+ * Several frames are regenerated at the same time, each on its own clone of the
+ * image, as many as the frame rendering clones setting allows.
  */
 class KisStoryboardThumbnailRenderScheduler : public QObject
 {
@@ -53,15 +60,27 @@ public:
      */
     void cancelFrameRendering(int frame);
 
+    /**
+     * @brief Sets the frames of the panels currently visible in the docker,
+     * they are regenerated before the rest of the frames in the same queue.
+     */
+    void setVisibleFrames(const QSet<int> &frames);
+
+    /**
+     * @brief Sets the size the thumbnails are scaled to right after rendering,
+     * on the rendering thread. An empty size means the full image size.
+     */
+    void setThumbnailSize(const QSize &size);
+
 public Q_SLOTS:
     void slotStartFrameRendering();
 
 private Q_SLOTS:
     /**
-     * @brief Emits @c sigFrameCompleted(int,KisPaintDeviceSP) if the regeneration was complete
+     * @brief Emits @c sigFrameCompleted(int,QImage) if the regeneration was complete
      * and calls regenration of the next frame in queue.
      */
-    void slotFrameRegenerationCompleted(int frame, KisPaintDeviceSP contents);
+    void slotFrameRegenerationCompleted(int frame, const QImage &thumbnail);
 
     /**
      * @brief Emits @c sigFrameCancelled(int) and schedules the next frame for regenration.
@@ -75,22 +94,31 @@ private:
     void sortAffectedFrameQueue();
 
     /**
-     * @brief Renders the next frame, either from affected or changed queue. Changed
-     * queue is given preference. It removes the frame from the queue right after
-     * calling @c startFrameRegeneration()
+     * @brief Renders the next frames on all the idle renderers, either from affected
+     * or changed queue. Changed queue is given preference. It removes the frame from
+     * the queue right after calling @c startFrameRegeneration()
      */
     void renderNextFrame();
 
+    /**
+     * @brief Removes and returns the first visible frame of @p queue, or its
+     * first frame if none of them is visible.
+     */
+    int takeNextFrame(QVector<int> &queue) const;
+
 Q_SIGNALS:
-    void sigFrameCompleted(int frame, KisPaintDeviceSP dev);
+    void sigFrameCompleted(int frame, const QImage &thumbnail);
     void sigFrameCancelled(int frame);
 
 private:
     QVector<int> m_changedFramesQueue;
     QVector<int> m_affectedFramesQueue;
-    KisAsyncStoryboardThumbnailRenderer *m_renderer;
+    QVector<KisAsyncStoryboardThumbnailRenderer*> m_renderers;
+    /// the frame every renderer is busy with, or -1
+    QVector<int> m_currentFrames;
+    QSet<int> m_visibleFrames;
+    QSize m_thumbnailSize;
     KisImageSP m_image;
-    int m_currentFrame;
 };
 
 #endif
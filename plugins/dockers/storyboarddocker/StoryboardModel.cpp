@@ -10,6 +10,7 @@
 
 #include <QDebug>
 #include <QMimeData>
+#include <QScrollBar>
 
 
 #include <kis_icon.h>
@@ -27,13 +28,14 @@ StoryboardModel::StoryboardModel(QObject *parent)
         , m_lockBoards(false)
         , m_reorderingKeyframes(false)
         , m_imageIdleWatcher(10)
+        , m_view(0)
         , m_renderScheduler(new KisStoryboardThumbnailRenderScheduler(this))
         , m_renderSchedulingCompressor(1000,KisSignalCompressor::FIRST_ACTIVE)
 {
     connect(this, SIGNAL(rowsInserted(const QModelIndex, int, int)),
                 this, SLOT(slotInsertChildRows(const QModelIndex, int, int)));
 
-    connect(m_renderScheduler, SIGNAL(sigFrameCompleted(int, KisPaintDeviceSP)), this, SLOT(slotFrameRenderCompleted(int, KisPaintDeviceSP)));
+    connect(m_renderScheduler, SIGNAL(sigFrameCompleted(int, QImage)), this, SLOT(slotFrameRenderCompleted(int, QImage)));
     connect(m_renderScheduler, SIGNAL(sigFrameCancelled(int)), this, SLOT(slotFrameRenderCancelled(int)));
     connect(&m_renderSchedulingCompressor, SIGNAL(timeout()), this, SLOT(slotUpdateThumbnails()));
 }
@@ -253,14 +255,23 @@ bool StoryboardModel::setCommentScrollData(const QModelIndex & index, const QVar
 
 bool StoryboardModel::setThumbnailPixmapData(const QModelIndex & parentIndex, const KisPaintDeviceSP & dev)
 {
+    const QSize size = thumbnailSize();
+    QImage image = size.isEmpty() ?
+        dev->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(), m_image->bounds()) :
+        dev->createThumbnail(size.width(), size.height(), m_image->bounds(), 2);
 
+    return setThumbnailPixmapData(parentIndex, image);
+}
+
+bool StoryboardModel::setThumbnailPixmapData(const QModelIndex & parentIndex, const QImage & image)
+{
     QModelIndex index = this->index(0, 0, parentIndex);
-    QRect thumbnailRect = m_view->visualRect(parentIndex);
-    float scale = qMin(thumbnailRect.height() / (float)m_image->height(), (float)thumbnailRect.width() / m_image->width());
+    const QSize size = thumbnailSize();
 
-    QImage image = dev->convertToQImage(KoColorSpaceRegistry::instance()->rgb8()->profile(), m_image->bounds());
     QPixmap pxmap = QPixmap::fromImage(image);
-    pxmap = pxmap.scaled((1.5)*scale*m_image->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    if (!size.isEmpty() && pxmap.size() != size) {
+        pxmap = pxmap.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
 
     if (!index.parent().isValid())
         return false;
@@ -276,6 +287,20 @@ bool StoryboardModel::setThumbnailPixmapData(const QModelIndex & parentIndex, co
     return false;
 }
 
+QSize StoryboardModel::thumbnailSize() const
+{
+    if (!m_view || !m_image || m_items.isEmpty()) {
+        return QSize();
+    }
+
+    // all the items have thumbnails of the same size
+    QRect thumbnailRect = m_view->visualRect(index(0, 0));
+    float scale = qMin(thumbnailRect.height() / (float)m_image->height(), (float)thumbnailRect.width() / m_image->width());
+
+    QSize size = (1.5)*scale*m_image->size();
+    return size.isEmpty() ? QSize() : size;
+}
+
 bool StoryboardModel::updateDurationData(const QModelIndex& parentIndex)
 {
     if (!parentIndex.isValid()) {
@@ -645,6 +670,11 @@ int StoryboardModel::getFramesPerSecond() const
 void StoryboardModel::setView(StoryboardView *view)
 {
     m_view = view;
+
+    if (m_view) {
+        connect(m_view->horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(slotUpdateVisibleFrames()));
+        connect(m_view->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(slotUpdateVisibleFrames()));
+    }
 }
 
 void StoryboardModel::setImage(KisImageWSP image)
@@ -669,6 +699,7 @@ void StoryboardModel::setImage(KisImageWSP image)
     }
     m_lastScene = m_items.size();
 
+    slotUpdateVisibleFrames();
     m_imageIdleWatcher.startCountdown();
     connect(&m_imageIdleWatcher, SIGNAL(startedIdleMode()), m_renderScheduler, SLOT(slotStartFrameRendering()));
 
@@ -1165,6 +1196,7 @@ void StoryboardModel::slotUpdateThumbnailForFrame(int frame, bool delay)
         }
 
         m_renderScheduler->scheduleFrameForRegeneration(frame, affected);
+        slotUpdateVisibleFrames();
         m_renderScheduler->slotStartFrameRendering();
     }
 }
@@ -1220,11 +1252,11 @@ void StoryboardModel::slotUpdateThumbnails()
     }
 }
 
-void StoryboardModel::slotFrameRenderCompleted(int frame, KisPaintDeviceSP dev)
+void StoryboardModel::slotFrameRenderCompleted(int frame, const QImage &thumbnail)
 {
     QModelIndex index = indexFromFrame(frame);
     if (index.isValid()) {
-        setThumbnailPixmapData(index, dev);
+        setThumbnailPixmapData(index, thumbnail);
     }
 }
 
@@ -1233,6 +1265,26 @@ void StoryboardModel::slotFrameRenderCancelled(int frame)
     qDebug()<<"frame render for "<<frame<<" cancelled";
 }
 
+void StoryboardModel::slotUpdateVisibleFrames()
+{
+    if (!m_view) {
+        return;
+    }
+
+    QSet<int> visibleFrames;
+    const QRect viewportRect = m_view->viewport()->rect();
+
+    for (int row = 0; row < rowCount(); row++) {
+        QModelIndex parentIndex = index(row, 0);
+        if (m_view->visualRect(parentIndex).intersects(viewportRect)) {
+            visibleFrames.insert(index(StoryboardItem::FrameNumber, 0, parentIndex).data().toInt());
+        }
+    }
+
+    m_renderScheduler->setVisibleFrames(visibleFrames);
+    m_renderScheduler->setThumbnailSize(thumbnailSize());
+}
+
 void StoryboardModel::slotCommentDataChanged()
 {
     m_commentList = m_commentModel->m_commentList;
@@ -63,6 +63,22 @@ public:
      */
     bool setThumbnailPixmapData(const QModelIndex & parentIndex, const KisPaintDeviceSP & dev);
 
+    /**
+     * @brief Sets the Pixmap data.
+     * @param parentIndex The index of item whose thumbnail changed.
+     * @param image The new thumbnail, scaled to @c thumbnailSize() already
+     * or of the full image size.
+     * @return @c True if data was set
+     * @sa ThumbnailData
+     */
+    bool setThumbnailPixmapData(const QModelIndex & parentIndex, const QImage & image);
+
+    /**
+     * @return the size of the thumbnail pixmaps shown in the view for the
+     * current image, or an empty size if it is not known.
+     */
+    QSize thumbnailSize() const;
+
     /**
      * @brief updates the duration data of item at @c parentIndex to the number
      * of frame to the next @c keyframe in any @c layer.
@@ -243,15 +259,21 @@ private Q_SLOTS:
     /**
      * @brief called @c KisStoryboardThumbnailRenderScheduler when frame render is complete
      * @param frame The frame whose regeneration was requested
-     * @param dev The projection of the frame
+     * @param thumbnail The scaled projection of the frame
      */
-    void slotFrameRenderCompleted(int frame, KisPaintDeviceSP dev);
+    void slotFrameRenderCompleted(int frame, const QImage &thumbnail);
 
     /**
      * @brief called @c KisStoryboardThumbnailRenderScheduler when frame render is cancelled.
      */
     void slotFrameRenderCancelled(int frame);
 
+    /**
+     * @brief passes the frames of the items visible in the view and the
+     * thumbnail size to the render scheduler.
+     */
+    void slotUpdateVisibleFrames();
+
     void slotCommentDataChanged();
     void slotCommentRowInserted(const QModelIndex, int, int);
     void slotCommentRowRemoved(const QModelIndex, int, int);
@@ -16,6 +16,7 @@
 #include <QLabel>
 #include <QColor>
 #include <QRadioButton>
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 #include <kis_debug.h>
@@ -27,6 +28,7 @@
 #include <KoColorSpaceRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorSpaceTraits.h>
+#include <KoColorConversionTransformation.h>
 
 #include <kis_layer.h>
 #include <kis_paint_device.h>
@@ -38,13 +40,119 @@
 #include <kis_transaction.h>
 #include <kis_cursor.h>
 #include "kis_iterator_ng.h"
+#include "kis_sequential_iterator.h"
 #include "kis_selection_tool_helper.h"
 #include <kis_slider_spin_box.h>
+#include "krita_utils.h"
+
+namespace {
+
+/**
+ * The difference of the pixels that are never selected,
+ * since the fuzziness doesn't go above 200
+ */
+const quint8 unselectableDifference = 255;
+
+KoColor matchColor(enumAction action, const KoColorSpace *cs)
+{
+    KoColor match;
+    switch (action) {
+    case REDS:
+        match = KoColor(QColor(Qt::red), cs);
+        break;
+    case YELLOWS:
+        match = KoColor(QColor(Qt::yellow), cs);
+        break;
+    case GREENS:
+        match = KoColor(QColor(Qt::green), cs);
+        break;
+    case CYANS:
+        match = KoColor(QColor(Qt::cyan), cs);
+        break;
+    case BLUES:
+        match = KoColor(QColor(Qt::blue), cs);
+        break;
+    case MAGENTAS:
+        match = KoColor(QColor(Qt::magenta), cs);
+        break;
+    default:
+        ;
+    };
+    return match;
+}
+
+quint8 lightnessDifference(enumAction action, quint8 L)
+{
+    int difference = unselectableDifference;
+
+    switch (action) {
+    case HIGHLIGHTS:
+        difference = MAX_SELECTED - L;
+        break;
+    case MIDTONES:
+        difference = qAbs(L - MAX_SELECTED / 2);
+        break;
+    case SHADOWS:
+        difference = L - MIN_SELECTED;
+        break;
+    default:
+        ;
+    }
+
+    // the lightness ranges don't include their ends, so the difference
+    // is shifted to be selected when it is not greater than the fuzziness
+    return qMin(difference + 1, int(unselectableDifference));
+}
+
+void computeDifferences(KisPaintDeviceSP device, KisPaintDeviceSP map, const QRect &rc, enumAction action, const KoColor &match)
+{
+    const KoColorSpace *cs = device->colorSpace();
+    const KoColorSpace *lab = KoColorSpaceRegistry::instance()->lab16();
+    const int numPixels = rc.width() * rc.height();
+    const int pixelSize = cs->pixelSize();
+
+    QVector<quint8> pixels(numPixels * pixelSize);
+    device->readBytes(pixels.data(), rc);
+
+    QVector<quint8> labPixels;
+    if (action > MAGENTAS) {
+        labPixels.resize(numPixels * lab->pixelSize());
+
+        // the conversion is not thread-safe, so every patch needs its own converter
+        QScopedPointer<KoColorConversionTransformation> converter(
+            cs->createColorConverter(lab,
+                                     KoColorConversionTransformation::internalRenderingIntent(),
+                                     KoColorConversionTransformation::internalConversionFlags()));
+        converter->transform(pixels.constData(), labPixels.data(), numPixels);
+    }
+
+    QVector<quint8> differences(numPixels);
+
+    for (int i = 0; i < numPixels; i++) {
+        const quint8 *pixel = pixels.constData() + i * pixelSize;
+
+        // Don't try to select transparent pixels.
+        if (cs->opacityU8(pixel) <= OPACITY_TRANSPARENT_U8) {
+            differences[i] = unselectableDifference;
+        } else if (action > MAGENTAS) {
+            const quint8 L = lab->scaleToU8(labPixels.constData() + i * lab->pixelSize(), 0);
+            differences[i] = lightnessDifference(action, L);
+        } else {
+            differences[i] = cs->difference(match.data(), pixel);
+        }
+    }
+
+    map->writeBytes(differences.constData(), rc);
+}
+
+}
 
 DlgColorRange::DlgColorRange(KisViewManager *viewManager, QWidget *parent)
     : KoDialog(parent)
     , m_selectionCommandsAdded(0)
     , m_viewManager(viewManager)
+    , m_differenceMapSequenceNumber(-1)
+    , m_differenceMapAction(REDS)
 {
     setCaption(i18n("Color Range"));
     setButtons(Ok | Cancel);
@@ -150,94 +258,27 @@ void DlgColorRange::slotSelectClicked()
 
     QApplication::setOverrideCursor(KisCursor::waitCursor());
 
-    qint32 x, y, w, h;
-    rc.getRect(&x, &y, &w, &h);
+    const int fuzziness = m_page->intFuzziness->value();
 
-    const KoColorSpace *cs = m_viewManager->activeDevice()->colorSpace();
-    const KoColorSpace *lab = KoColorSpaceRegistry::instance()->lab16();
+    KisPaintDeviceSP map = differenceMap(device, rc);
 
-    KoColor match;
-    switch (m_currentAction) {
-    case REDS:
-        match = KoColor(QColor(Qt::red), cs);
-        break;
-    case YELLOWS:
-        match = KoColor(QColor(Qt::yellow), cs);
-        break;
-    case GREENS:
-        match = KoColor(QColor(Qt::green), cs);
-        break;
-    case CYANS:
-        match = KoColor(QColor(Qt::cyan), cs);
-        break;
-    case BLUES:
-        match = KoColor(QColor(Qt::blue), cs);
-        break;
-    case MAGENTAS:
-        match = KoColor(QColor(Qt::magenta), cs);
-        break;
-    default:
-        ;
-    };
+    KisSelectionSP selection = new KisSelection(new KisSelectionDefaultBounds(m_viewManager->activeDevice()));
+    KisPixelSelectionSP pixelSelection = selection->pixelSelection();
 
-    int fuzziness = m_page->intFuzziness->value();
+    const quint8 selectedValue = (m_mode == SELECTION_ADD) != m_invert ? MAX_SELECTED : MIN_SELECTED;
 
-    KisSelectionSP selection = new KisSelection(new KisSelectionDefaultBounds(m_viewManager->activeDevice()));
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc, KritaUtils::optimalPatchSize());
+
+    QtConcurrent::blockingMap(patches, [map, pixelSelection, fuzziness, selectedValue] (const QRect &patch) {
+        KisSequentialConstIterator mapIt(map, patch);
+        KisSequentialIterator selIt(pixelSelection, patch);
 
-    KisHLineConstIteratorSP hiter = m_viewManager->activeDevice()->createHLineConstIteratorNG(x, y, w);
-    KisHLineIteratorSP selIter = selection->pixelSelection()->createHLineIteratorNG(x, y, w);
-
-    for (int row = y; row < h - y; ++row) {
-        do {
-            // Don't try to select transparent pixels.
-            if (cs->opacityU8(hiter->oldRawData()) >  OPACITY_TRANSPARENT_U8) {
-
-                bool selected = false;
-
-                KoColor c(hiter->oldRawData(), cs);
-                if (m_currentAction > MAGENTAS) {
-                    c.convertTo(lab);
-                    quint8 L = lab->scaleToU8(c.data(), 0);
-
-                    switch (m_currentAction) {
-                    case HIGHLIGHTS:
-                        selected = (L > MAX_SELECTED - fuzziness);
-                        break;
-                    case MIDTONES:
-                        selected = (L > MAX_SELECTED / 2 - fuzziness && L < MAX_SELECTED / 2 + fuzziness);
-                        break;
-                    case SHADOWS:
-                        selected = (L < MIN_SELECTED + fuzziness);
-                        break;
-                    default:
-                        ;
-                    }
-                }
-                else {
-                    quint8 difference = cs->difference(match.data(), c.data());
-                    selected = (difference <= fuzziness);
-                }
-
-                if (selected) {
-                    if (!m_invert) {
-                        if (m_mode == SELECTION_ADD) {
-                            *(selIter->rawData()) =  MAX_SELECTED;
-                        } else if (m_mode == SELECTION_SUBTRACT) {
-                            *(selIter->rawData()) = MIN_SELECTED;
-                        }
-                    } else {
-                        if (m_mode == SELECTION_ADD) {
-                            *(selIter->rawData()) = MIN_SELECTED;
-                        } else if (m_mode == SELECTION_SUBTRACT) {
-                            *(selIter->rawData()) =  MAX_SELECTED;
-                        }
-                    }
-                }
+        while (mapIt.nextPixel() && selIt.nextPixel()) {
+            if (*mapIt.rawDataConst() <= fuzziness) {
+                *selIt.rawData() = selectedValue;
             }
-        } while (hiter->nextPixel() && selIter->nextPixel());
-        hiter->nextRow();
-        selIter->nextRow();
-    }
+        }
+    });
 
     selection->pixelSelection()->invalidateOutlineCache();
     KisSelectionToolHelper helper(m_viewManager->canvasBase(), kundo2_i18n("Color Range Selection"));
@@ -248,6 +289,37 @@ void DlgColorRange::slotSelectClicked()
     QApplication::restoreOverrideCursor();
 }
 
+KisPaintDeviceSP DlgColorRange::differenceMap(KisPaintDeviceSP device, const QRect &rc)
+{
+    if (m_differenceMap &&
+        m_differenceMapSource.isValid() &&
+        m_differenceMapSource == device.data() &&
+        m_differenceMapSequenceNumber == device->sequenceNumber() &&
+        m_differenceMapAction == m_currentAction &&
+        m_differenceMapRect == rc) {
+
+        return m_differenceMap;
+    }
+
+    KisPaintDeviceSP map = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    const KoColor match = matchColor(m_currentAction, device->colorSpace());
+    const enumAction action = m_currentAction;
+
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc, KritaUtils::optimalPatchSize());
+
+    QtConcurrent::blockingMap(patches, [device, map, action, match] (const QRect &patch) {
+        computeDifferences(device, map, patch, action, match);
+    });
+
+    m_differenceMap = map;
+    m_differenceMapSource = device;
+    m_differenceMapSequenceNumber = device->sequenceNumber();
+    m_differenceMapAction = m_currentAction;
+    m_differenceMapRect = rc;
+
+    return map;
+}
+
 void DlgColorRange::slotDeselectClicked()
 {
     if (!m_viewManager) return;
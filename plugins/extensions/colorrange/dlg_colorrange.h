@@ -73,6 +73,13 @@ private Q_SLOTS:
 private:
     QImage createMask(KisSelectionSP selection, KisPaintDeviceSP layer);
 
+    /**
+     * Returns the map of the differences between the pixels of \p device
+     * and the range of the current action. The map is cached, so changing
+     * the fuzziness only thresholds it again instead of rescanning the layer.
+     */
+    KisPaintDeviceSP differenceMap(KisPaintDeviceSP device, const QRect &rc);
+
 private:
 
     WdgColorRange *m_page;
@@ -82,6 +89,12 @@ private:
     QCursor m_oldCursor;
     enumAction m_currentAction;
     bool m_invert;
+
+    KisPaintDeviceSP m_differenceMap;
+    KisPaintDeviceWSP m_differenceMapSource;
+    int m_differenceMapSequenceNumber;
+    enumAction m_differenceMapAction;
+    QRect m_differenceMapRect;
 };
 
 
@@ -22,6 +22,7 @@
 #include <QMultiMap>
 #include <QSharedMemory>
 #include <QMessageBox>
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 #include <kpluginfactory.h>
@@ -348,9 +349,11 @@ void QMic::slotStartApplicator(QStringList gmicImages)
             gimg->assign(width, height, 1, spectrum);
             gimg->name = layerName;
 
-            gimg->_data = new float[width * height * spectrum * sizeof(float)];
-            dbgPlugins << "width" << width << "height" << height << "size" << width * height * spectrum * sizeof(float) << "shared memory size" << m.size();
-            memcpy(gimg->_data, m.constData(), width * height * spectrum * sizeof(float));
+            const size_t numValues = size_t(width) * height * spectrum;
+            dbgPlugins << "width" << width << "height" << height << "size" << numValues * sizeof(float) << "shared memory size" << m.size();
+
+            gimg->_data = new float[numValues];
+            memcpy(gimg->_data, m.constData(), qMin(numValues * sizeof(float), size_t(m.size())));
 
             dbgPlugins << "created gmic image" << gimg->name << gimg->_width << gimg->_height;
 
@@ -392,6 +395,13 @@ bool QMic::prepareCroppedImages(QByteArray *message, QRectF &rc, int inputMode)
         return false;
     }
 
+    struct LayerTransfer {
+        KisNodeSP node;
+        QRect rect;
+        QSharedMemory *memory;
+    };
+    QVector<LayerTransfer> transfers;
+
     for (int i = 0; i < nodes->size(); ++i) {
         KisNodeSP node = nodes->at(i);
         if (node && node->paintDevice()) {
@@ -417,27 +427,39 @@ bool QMic::prepareCroppedImages(QByteArray *message, QRectF &rc, int inputMode)
                 qWarning() << "Could not create shared memory segment" << m->error() << m->errorString();
                 return false;
             }
-            m->lock();
 
-            gmic_image<float> img;
-            img.assign(resultRect.width(), resultRect.height(), 1, 4);
-            img._data = reinterpret_cast<float*>(m->data());
+            transfers.append({node, resultRect, m});
+        }
+    }
 
-            KisQmicSimpleConvertor::convertToGmicImageFast(node->paintDevice(), &img, resultRect);
+    /**
+     * The layers are converted right into the shared memory segments in
+     * the planar float layout of G'Mic. They don't depend on each other,
+     * so all of them are converted at the same time.
+     */
+    QtConcurrent::blockingMap(transfers,
+        [] (const LayerTransfer &transfer) {
+            transfer.memory->lock();
 
-            message->append(m->key().toUtf8());
+            gmic_image<float> img;
+            img.assign(transfer.rect.width(), transfer.rect.height(), 1, 4);
+            img._data = reinterpret_cast<float*>(transfer.memory->data());
+
+            KisQmicSimpleConvertor::convertToGmicImageFast(transfer.node->paintDevice(), &img, transfer.rect);
 
-            m->unlock();
+            transfer.memory->unlock();
+        });
 
-            message->append(",");
-            message->append(node->name().toUtf8().toHex());
-            message->append(",");
-            message->append(QByteArray::number(resultRect.width()));
-            message->append(",");
-            message->append(QByteArray::number(resultRect.height()));
+    Q_FOREACH (const LayerTransfer &transfer, transfers) {
+        message->append(transfer.memory->key().toUtf8());
+        message->append(",");
+        message->append(transfer.node->name().toUtf8().toHex());
+        message->append(",");
+        message->append(QByteArray::number(transfer.rect.width()));
+        message->append(",");
+        message->append(QByteArray::number(transfer.rect.height()));
 
-            message->append("\n");
-        }
+        message->append("\n");
     }
 
     dbgPlugins << QString::fromUtf8(*message);
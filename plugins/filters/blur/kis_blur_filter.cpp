@@ -13,6 +13,7 @@
 
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
+#include <kis_gaussian_kernel.h>
 
 #include "kis_wdg_blur.h"
 #include "ui_wdgblur.h"
@@ -46,6 +47,7 @@ KisFilterConfigurationSP KisBlurFilter::defaultConfiguration(KisResourcesInterfa
     config->setProperty("rotate", 0);
     config->setProperty("strength", 0);
     config->setProperty("shape", 0);
+    config->setProperty("fastBlur", false);
     return config;
 }
 
@@ -65,6 +67,24 @@ void KisBlurFilter::processImpl(KisPaintDeviceSP device,
     const uint halfWidth = t.scale((config->getProperty("halfWidth", value)) ? value.toUInt() : 5);
     const uint halfHeight = t.scale((config->getProperty("halfHeight", value)) ? value.toUInt() : 5);
 
+    QBitArray channelFlags = config->channelFlags();
+    if (channelFlags.isEmpty()) {
+        channelFlags = QBitArray(device->colorSpace()->channelCount(), true);
+    }
+
+    /**
+     * The fast mode ignores the shape of the brush and blurs with
+     * a Gaussian of the same size, which is approximated with box
+     * blurs and costs the same for any size
+     */
+    if (config->getBool("fastBlur", false)) {
+        KisGaussianKernel::applyFastGaussian(device, rect,
+                                             halfWidth, halfHeight,
+                                             channelFlags, progressUpdater,
+                                             BORDER_REPEAT);
+        return;
+    }
+
     int shape = (config->getProperty("shape", value)) ? value.toInt() : 0;
     uint width = 2 * halfWidth + 1;
     uint height = 2 * halfHeight + 1;
@@ -86,14 +106,6 @@ void KisBlurFilter::processImpl(KisPaintDeviceSP device,
         break;
     }
 
-    QBitArray channelFlags;
-    if (config) {
-        channelFlags = config->channelFlags();
-    }
-    if (channelFlags.isEmpty() || !config) {
-        channelFlags = QBitArray(device->colorSpace()->channelCount(), true);
-    }
-
     KisConvolutionKernelSP kernel = KisConvolutionKernel::fromMaskGenerator(kas, rotate * M_PI / 180.0);
     delete kas;
     KisConvolutionPainter painter(device);
@@ -103,6 +115,12 @@ void KisBlurFilter::processImpl(KisPaintDeviceSP device,
 
 }
 
+int KisBlurFilter::fastBlurMargin(const KisFilterConfigurationSP config, int halfSize)
+{
+    return config->getBool("fastBlur", false) && halfSize > 0 ?
+        KisGaussianKernel::kernelSizeFromRadius(halfSize) / 2 : 0;
+}
+
 QRect KisBlurFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
 {
     KisLodTransformScalar t(lod);
@@ -111,7 +129,10 @@ QRect KisBlurFilter::neededRect(const QRect & rect, const KisFilterConfiguration
     const int halfWidth = t.scale(_config->getProperty("halfWidth", value) ? value.toUInt() : 5);
     const int halfHeight = t.scale(_config->getProperty("halfHeight", value) ? value.toUInt() : 5);
 
-    return rect.adjusted(-halfWidth * 2, -halfHeight * 2, halfWidth * 2, halfHeight * 2);
+    const int xMargin = qMax(halfWidth * 2, fastBlurMargin(_config, halfWidth));
+    const int yMargin = qMax(halfHeight * 2, fastBlurMargin(_config, halfHeight));
+
+    return rect.adjusted(-xMargin, -yMargin, xMargin, yMargin);
 }
 
 QRect KisBlurFilter::changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
@@ -122,5 +143,8 @@ QRect KisBlurFilter::changedRect(const QRect & rect, const KisFilterConfiguratio
     const int halfWidth = t.scale(_config->getProperty("halfWidth", value) ? value.toUInt() : 5);
     const int halfHeight = t.scale(_config->getProperty("halfHeight", value) ? value.toUInt() : 5);
 
-    return rect.adjusted(-halfWidth, -halfHeight, halfWidth, halfHeight);
+    const int xMargin = qMax(halfWidth, fastBlurMargin(_config, halfWidth));
+    const int yMargin = qMax(halfHeight, fastBlurMargin(_config, halfHeight));
+
+    return rect.adjusted(-xMargin, -yMargin, xMargin, yMargin);
 }
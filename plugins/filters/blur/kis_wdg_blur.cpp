@@ -33,6 +33,7 @@ KisWdgBlur::KisWdgBlur(QWidget * parent) : KisConfigWidget(parent)
     connect(widget()->intStrength, SIGNAL(valueChanged(int)), SIGNAL(sigConfigurationItemChanged()));
     connect(widget()->intAngle, SIGNAL(valueChanged(int)), SIGNAL(sigConfigurationItemChanged()));
     connect(widget()->cbShape, SIGNAL(activated(int)), SIGNAL(sigConfigurationItemChanged()));
+    connect(widget()->chkFast, SIGNAL(toggled(bool)), this, SLOT(fastToggled(bool)));
 }
 
 KisWdgBlur::~KisWdgBlur()
@@ -49,6 +50,7 @@ KisPropertiesConfigurationSP KisWdgBlur::configuration() const
     config->setProperty("rotate", widget()->intAngle->value());
     config->setProperty("strength", widget()->intStrength->value());
     config->setProperty("shape", widget()->cbShape->currentIndex());
+    config->setProperty("fastBlur", widget()->chkFast->isChecked());
     return config;
 }
 
@@ -73,6 +75,7 @@ void KisWdgBlur::setConfiguration(const KisPropertiesConfigurationSP config)
     if (config->getProperty("strength", value)) {
         widget()->intStrength->setValue(value.toUInt());
     }
+    widget()->chkFast->setChecked(config->getBool("fastBlur", false));
 }
 
 void KisWdgBlur::linkSpacingToggled(bool b)
@@ -81,6 +84,14 @@ void KisWdgBlur::linkSpacingToggled(bool b)
     widget()->intHalfHeight->setValue(widget()->intHalfWidth->value());
 }
 
+void KisWdgBlur::fastToggled(bool value)
+{
+    widget()->intStrength->setEnabled(!value);
+    widget()->intAngle->setEnabled(!value);
+    widget()->cbShape->setEnabled(!value);
+    emit sigConfigurationItemChanged();
+}
+
 void KisWdgBlur::spinBoxHalfWidthChanged(int v)
 {
     if (m_halfSizeLink) {
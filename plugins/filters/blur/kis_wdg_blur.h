@@ -30,6 +30,7 @@ private Q_SLOTS:
     void linkSpacingToggled(bool);
     void spinBoxHalfWidthChanged(int);
     void spinBoxHalfHeightChanged(int);
+    void fastToggled(bool);
 
 private:
 
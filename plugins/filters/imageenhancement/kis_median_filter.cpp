@@ -0,0 +1,417 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_median_filter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <KoConfig.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceMaths.h>
+#include <KoChannelInfo.h>
+#include <KoUpdater.h>
+
+#include <kis_debug.h>
+#include <kis_global.h>
+#include <widgets/kis_multi_integer_filter_widget.h>
+#include <filter/kis_filter_category_ids.h>
+#include <filter/kis_filter_configuration.h>
+#include <kis_processing_information.h>
+#include <kis_paint_device.h>
+#include "kis_lod_transform.h"
+
+namespace {
+
+/**
+ * A single channel of the pixels read from the device. The source
+ * rect is bigger than the destination one by the radius of the
+ * window on every side, so the window of the destination pixel
+ * (x, y) starts at the source pixel (x, y).
+ */
+template <typename T>
+struct ChannelData {
+    ChannelData(quint8 *_data, int _width, int _pixelSize, int _channelOffset)
+        : data(_data), width(_width), pixelSize(_pixelSize), channelOffset(_channelOffset)
+    {
+    }
+
+    inline T &value(int x, int y) const {
+        return *reinterpret_cast<T*>(data + (y * width + x) * pixelSize + channelOffset);
+    }
+
+    quint8 *data;
+    int width;
+    int pixelSize;
+    int channelOffset;
+};
+
+/**
+ * Reports the progress once per processed row of a channel and tells
+ * whether the processing should go on
+ */
+struct MedianProgress {
+    MedianProgress(KoUpdater *_updater, int _totalRows)
+        : updater(_updater), totalRows(qMax(1, _totalRows))
+    {
+    }
+
+    inline bool rowDone() {
+        rowsDone++;
+
+        if (!updater) return true;
+
+        updater->setProgress(100 * rowsDone / totalRows);
+        return !updater->interrupted();
+    }
+
+    KoUpdater *updater;
+    int totalRows;
+    int rowsDone = 0;
+};
+
+/**
+ * The constant-time median filter by Perreault and Hébert for 8-bit
+ * channels.
+ *
+ * Every column of the source keeps a histogram of the 2 * radius + 1
+ * pixels of the current row of windows. When the window moves to the
+ * right, the histogram of the column that enters it is added to the
+ * histogram of the window and the one of the column that leaves it is
+ * subtracted. The histograms are split into 16 coarse bins of 16 fine
+ * bins each: the coarse histogram of the window is updated for every
+ * pixel, while the fine bins are updated lazily, only when the median
+ * falls into their coarse bin.
+ */
+void medianConstantTime8(const ChannelData<quint8> &src, const ChannelData<quint8> &dst,
+                         int width, int height, int radius, MedianProgress &progress)
+{
+    const int numCoarseBins = 16;
+    const int binsPerCoarseBin = 16;
+    const int numFineBins = 256;
+    const int windowSize = 2 * radius + 1;
+    const int rank = windowSize * windowSize / 2;
+    const int srcWidth = width + 2 * radius;
+
+    std::vector<quint16> columnFine(srcWidth * numFineBins, 0);
+    std::vector<quint16> columnCoarse(srcWidth * numCoarseBins, 0);
+
+    auto updateColumn = [&] (int x, int y, int sign) {
+        const int value = src.value(x, y);
+        columnFine[x * numFineBins + value] += sign;
+        columnCoarse[x * numCoarseBins + (value >> 4)] += sign;
+    };
+
+    for (int x = 0; x < srcWidth; x++) {
+        for (int y = 0; y < windowSize; y++) {
+            updateColumn(x, y, 1);
+        }
+    }
+
+    quint16 kernelCoarse[numCoarseBins];
+    quint16 kernelFine[numFineBins];
+    int lastUpdate[numCoarseBins];
+
+    for (int y = 0; y < height; y++) {
+        if (y > 0) {
+            for (int x = 0; x < srcWidth; x++) {
+                updateColumn(x, y - 1, -1);
+                updateColumn(x, y + windowSize - 1, 1);
+            }
+        }
+
+        std::fill(kernelCoarse, kernelCoarse + numCoarseBins, 0);
+        std::fill(lastUpdate, lastUpdate + numCoarseBins, -windowSize - 1);
+
+        for (int x = 0; x < windowSize; x++) {
+            const quint16 *column = columnCoarse.data() + x * numCoarseBins;
+            for (int i = 0; i < numCoarseBins; i++) {
+                kernelCoarse[i] += column[i];
+            }
+        }
+
+        for (int x = 0; x < width; x++) {
+            if (x > 0) {
+                const quint16 *added = columnCoarse.data() + (x + windowSize - 1) * numCoarseBins;
+                const quint16 *removed = columnCoarse.data() + (x - 1) * numCoarseBins;
+                for (int i = 0; i < numCoarseBins; i++) {
+                    kernelCoarse[i] += added[i] - removed[i];
+                }
+            }
+
+            int count = 0;
+            int coarseBin = 0;
+            while (count + kernelCoarse[coarseBin] <= rank) {
+                count += kernelCoarse[coarseBin];
+                coarseBin++;
+            }
+
+            const int binOffset = coarseBin * binsPerCoarseBin;
+            quint16 *fine = kernelFine + binOffset;
+
+            if (x - lastUpdate[coarseBin] >= windowSize) {
+                std::fill(fine, fine + binsPerCoarseBin, 0);
+                for (int c = x; c < x + windowSize; c++) {
+                    const quint16 *column = columnFine.data() + c * numFineBins + binOffset;
+                    for (int i = 0; i < binsPerCoarseBin; i++) {
+                        fine[i] += column[i];
+                    }
+                }
+            } else {
+                for (int c = lastUpdate[coarseBin] + 1; c <= x; c++) {
+                    const quint16 *added = columnFine.data() + (c + windowSize - 1) * numFineBins + binOffset;
+                    const quint16 *removed = columnFine.data() + (c - 1) * numFineBins + binOffset;
+                    for (int i = 0; i < binsPerCoarseBin; i++) {
+                        fine[i] += added[i] - removed[i];
+                    }
+                }
+            }
+            lastUpdate[coarseBin] = x;
+
+            int fineBin = 0;
+            while (count + fine[fineBin] <= rank) {
+                count += fine[fineBin];
+                fineBin++;
+            }
+
+            dst.value(x, y) = binOffset + fineBin;
+        }
+
+        if (!progress.rowDone()) return;
+    }
+}
+
+/**
+ * Huang's sliding window median filter for 16-bit channels. The
+ * histogram of the window is updated with the columns that enter and
+ * leave it, which costs O(radius) per pixel. The histogram has two
+ * levels, 256 coarse bins of 256 fine bins, to find the median fast.
+ */
+void medianSlidingWindow16(const ChannelData<quint16> &src, const ChannelData<quint16> &dst,
+                           int width, int height, int radius, MedianProgress &progress)
+{
+    const int numCoarseBins = 256;
+    const int windowSize = 2 * radius + 1;
+    const int rank = windowSize * windowSize / 2;
+
+    std::vector<quint32> coarse(numCoarseBins, 0);
+    std::vector<quint32> fine(numCoarseBins * numCoarseBins, 0);
+
+    auto updateColumn = [&] (int x, int y, int sign) {
+        for (int row = y; row < y + windowSize; row++) {
+            const int value = src.value(x, row);
+            fine[value] += sign;
+            coarse[value >> 8] += sign;
+        }
+    };
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < windowSize; x++) {
+            updateColumn(x, y, 1);
+        }
+
+        for (int x = 0; x < width; x++) {
+            if (x > 0) {
+                updateColumn(x - 1, y, -1);
+                updateColumn(x + windowSize - 1, y, 1);
+            }
+
+            quint32 count = 0;
+            int coarseBin = 0;
+            while (count + coarse[coarseBin] <= quint32(rank)) {
+                count += coarse[coarseBin];
+                coarseBin++;
+            }
+
+            int value = coarseBin << 8;
+            while (count + fine[value] <= quint32(rank)) {
+                count += fine[value];
+                value++;
+            }
+
+            dst.value(x, y) = value;
+        }
+
+        // empty the histogram for the next row
+        for (int x = width - 1; x < width + windowSize - 1; x++) {
+            updateColumn(x, y, -1);
+        }
+
+        if (!progress.rowDone()) return;
+    }
+}
+
+/**
+ * The fallback for the floating point channels: selects the median of
+ * every window separately
+ */
+template <typename T>
+void medianSelect(const ChannelData<T> &src, const ChannelData<T> &dst,
+                  int width, int height, int radius, MedianProgress &progress)
+{
+    const int windowSize = 2 * radius + 1;
+    const int rank = windowSize * windowSize / 2;
+
+    std::vector<T> window(windowSize * windowSize);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            auto it = window.begin();
+            for (int row = y; row < y + windowSize; row++) {
+                for (int column = x; column < x + windowSize; column++) {
+                    *it++ = src.value(column, row);
+                }
+            }
+
+            std::nth_element(window.begin(), window.begin() + rank, window.end());
+            dst.value(x, y) = window[rank];
+        }
+
+        if (!progress.rowDone()) return;
+    }
+}
+
+template <typename T>
+void processChannel(quint8 *srcData, quint8 *dstData, int width, int height,
+                    int pixelSize, int channelOffset, int radius, MedianProgress &progress)
+{
+    ChannelData<T> src(srcData, width + 2 * radius, pixelSize, channelOffset);
+    ChannelData<T> dst(dstData, width, pixelSize, channelOffset);
+
+    medianSelect<T>(src, dst, width, height, radius, progress);
+}
+
+template <>
+void processChannel<quint8>(quint8 *srcData, quint8 *dstData, int width, int height,
+                            int pixelSize, int channelOffset, int radius, MedianProgress &progress)
+{
+    ChannelData<quint8> src(srcData, width + 2 * radius, pixelSize, channelOffset);
+    ChannelData<quint8> dst(dstData, width, pixelSize, channelOffset);
+
+    medianConstantTime8(src, dst, width, height, radius, progress);
+}
+
+template <>
+void processChannel<quint16>(quint8 *srcData, quint8 *dstData, int width, int height,
+                             int pixelSize, int channelOffset, int radius, MedianProgress &progress)
+{
+    ChannelData<quint16> src(srcData, width + 2 * radius, pixelSize, channelOffset);
+    ChannelData<quint16> dst(dstData, width, pixelSize, channelOffset);
+
+    medianSlidingWindow16(src, dst, width, height, radius, progress);
+}
+
+int scaledRadius(const KisFilterConfigurationSP config, int lod)
+{
+    KisLodTransformScalar t(lod);
+
+    const int radius = config ? config->getInt("radius", 1) : 1;
+    return qMax(0, qRound(t.scale(qreal(radius))));
+}
+
+}
+
+KisMedianFilter::KisMedianFilter()
+    : KisFilter(id(), FiltersCategoryEnhanceId, i18n("&Median..."))
+{
+    setSupportsPainting(true);
+    setSupportsAdjustmentLayers(true);
+    setSupportsLevelOfDetail(true);
+    setColorSpaceIndependence(FULLY_INDEPENDENT);
+}
+
+KisMedianFilter::~KisMedianFilter()
+{
+}
+
+KisConfigWidget * KisMedianFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool) const
+{
+    Q_UNUSED(dev);
+    vKisIntegerWidgetParam param;
+    param.push_back(KisIntegerWidgetParam(1, 50, 1, i18n("Radius"), "radius"));
+    return new KisMultiIntegerFilterWidget(id().id(), parent, id().id(), param);
+}
+
+KisFilterConfigurationSP  KisMedianFilter::defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const
+{
+    KisFilterConfigurationSP config = factoryConfiguration(resourcesInterface);
+    config->setProperty("radius", 1);
+    return config;
+}
+
+void KisMedianFilter::processImpl(KisPaintDeviceSP device,
+                                  const QRect& applyRect,
+                                  const KisFilterConfigurationSP config,
+                                  KoUpdater* progressUpdater
+                                  ) const
+{
+    Q_ASSERT(device);
+
+    const int radius = scaledRadius(config, device->defaultBounds()->currentLevelOfDetail());
+    if (radius <= 0 || applyRect.isEmpty()) return;
+
+    const KoColorSpace *cs = device->colorSpace();
+    const int pixelSize = cs->pixelSize();
+    const QRect srcRect = kisGrowRect(applyRect, radius);
+
+    std::vector<quint8> srcData(srcRect.width() * srcRect.height() * pixelSize);
+    std::vector<quint8> dstData(applyRect.width() * applyRect.height() * pixelSize);
+    device->readBytes(srcData.data(), srcRect);
+
+    const QList<KoChannelInfo*> channels = cs->channels();
+    MedianProgress progress(progressUpdater, channels.size() * applyRect.height());
+
+    Q_FOREACH (const KoChannelInfo *channel, channels) {
+        const int offset = channel->pos();
+
+        switch (channel->channelValueType()) {
+        case KoChannelInfo::UINT8:
+            processChannel<quint8>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+        case KoChannelInfo::UINT16:
+            processChannel<quint16>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+        case KoChannelInfo::UINT32:
+            processChannel<quint32>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+#ifdef HAVE_OPENEXR
+        case KoChannelInfo::FLOAT16:
+            processChannel<half>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+#endif
+        case KoChannelInfo::FLOAT32:
+            processChannel<float>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+        case KoChannelInfo::FLOAT64:
+            processChannel<double>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+        case KoChannelInfo::INT8:
+            processChannel<qint8>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+        case KoChannelInfo::INT16:
+            processChannel<qint16>(srcData.data(), dstData.data(), applyRect.width(), applyRect.height(), pixelSize, offset, radius, progress);
+            break;
+        default:
+            warnKrita << "KisMedianFilter: unsupported channel type" << channel->channelValueType();
+            return;
+        }
+
+        if (progressUpdater && progressUpdater->interrupted()) return;
+    }
+
+    device->writeBytes(dstData.data(), applyRect);
+}
+
+QRect KisMedianFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
+{
+    return kisGrowRect(rect, scaledRadius(_config, lod));
+}
+
+QRect KisMedianFilter::changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
+{
+    return neededRect(rect, _config, lod);
+}
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_MEDIAN_FILTER_H
+#define KIS_MEDIAN_FILTER_H
+
+#include <filter/kis_filter.h>
+#include "kis_config_widget.h"
+
+/**
+ * Replaces every channel of a pixel with the median of the channel in
+ * the square window around the pixel. It removes the salt-and-pepper
+ * noise and the specks of scanned line art without blurring the edges.
+ *
+ * The 8-bit channels use the constant-time algorithm of Perreault and
+ * Hébert with a histogram per column of the window, the 16-bit ones
+ * slide a two-level histogram along the row (Huang's algorithm) and the
+ * floating point ones fall back to selecting the median of every window.
+ */
+class KisMedianFilter : public KisFilter
+{
+public:
+    KisMedianFilter();
+    ~KisMedianFilter() override;
+public:
+
+    void processImpl(KisPaintDeviceSP device,
+                     const QRect& applyRect,
+                     const KisFilterConfigurationSP config,
+                     KoUpdater* progressUpdater
+                     ) const override;
+    KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
+
+    static inline KoID id() {
+        return KoID("median", i18n("Median"));
+    }
+
+    QRect changedRect(const QRect &rect, const KisFilterConfigurationSP _config, int lod) const override;
+    QRect neededRect(const QRect &rect, const KisFilterConfigurationSP _config, int lod) const override;
+
+protected:
+    KisFilterConfigurationSP  defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const override;
+};
+
+#endif
@@ -64,17 +64,10 @@ void KisWaveletNoiseReduction::processImpl(KisPaintDeviceSP device,
     //     dbgFilters << size <<"" << maxrectsize <<"" << srcTopLeft.x() <<"" << srcTopLeft.y();
 
     //     dbgFilters <<"Transforming...";
-    KisMathToolbox::KisWavelet* buff = 0;
     KisMathToolbox::KisWavelet* wav = 0;
 
     try {
-        buff = mathToolbox.initWavelet(device, applyRect);
-    } catch (const std::bad_alloc&) {
-        if (buff) delete buff;
-        return;
-    }
-    try {
-        wav = mathToolbox.fastWaveletTransformation(device, applyRect, buff);
+        wav = mathToolbox.fastWaveletTransformation(device, applyRect);
     } catch (const std::bad_alloc&) {
         if (wav) delete wav;
         return;
@@ -106,8 +99,7 @@ void KisWaveletNoiseReduction::processImpl(KisPaintDeviceSP device,
         pointsProcessed++;
     }
 
-    mathToolbox.fastWaveletUntransformation(device, applyRect, wav, buff);
+    mathToolbox.fastWaveletUntransformation(device, applyRect, wav);
 
     delete wav;
-    delete buff;
 }
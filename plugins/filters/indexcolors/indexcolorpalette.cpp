@@ -8,6 +8,9 @@
 
 #include <qmath.h>
 
+#include <algorithm>
+#include <limits>
+
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceRegistry.h>
 #include <filter/kis_filter_configuration.h>
@@ -185,3 +188,91 @@ void IndexColorPalette::mergeMostReduantColors()
         //insertShades(clrB, clrC, 1);
     }
 }
+
+IndexColorSearchTree::IndexColorSearchTree(const IndexColorPalette& palette)
+    : m_palette(palette)
+{
+    m_nodes.resize(m_palette.numColors());
+    for(int i = 0; i < m_nodes.size(); ++i)
+    {
+        scaledPosition(m_palette.colors[i], m_nodes[i].pos);
+        m_nodes[i].index = i;
+    }
+    build(0, m_nodes.size(), 0);
+}
+
+void IndexColorSearchTree::scaledPosition(LabColor clr, float* pos) const
+{
+    static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
+    pos[0] = clr.L / max * m_palette.similarityFactors.L;
+    pos[1] = clr.a / max * m_palette.similarityFactors.a;
+    pos[2] = clr.b / max * m_palette.similarityFactors.b;
+}
+
+void IndexColorSearchTree::build(int begin, int end, int depth)
+{
+    if(end - begin <= 1)
+    {
+        if(begin < end) m_nodes[begin].axis = 0;
+        return;
+    }
+
+    const int axis = depth % 3;
+    const int middle = (begin + end) / 2;
+    std::nth_element(m_nodes.begin() + begin, m_nodes.begin() + middle, m_nodes.begin() + end,
+                     [axis] (const Node& lhs, const Node& rhs) { return lhs.pos[axis] < rhs.pos[axis]; });
+    m_nodes[middle].axis = axis;
+
+    build(begin, middle, depth + 1);
+    build(middle + 1, end, depth + 1);
+}
+
+void IndexColorSearchTree::search(int begin, int end, const float* pos, LabColor clr, int* bestIndex, float* bestSimilarity, float* bestDistance) const
+{
+    if(begin >= end) return;
+
+    const int middle = (begin + end) / 2;
+    const Node& node = m_nodes[middle];
+
+    // The candidates are compared exactly as getNearestIndex() does it,
+    // including the preference of the first color of equally similar ones
+    const float similarity = m_palette.similarity(m_palette.colors[node.index], clr);
+    if(similarity > *bestSimilarity || (similarity == *bestSimilarity && node.index < *bestIndex))
+    {
+        *bestIndex = node.index;
+        *bestSimilarity = similarity;
+        const float dL = node.pos[0] - pos[0];
+        const float da = node.pos[1] - pos[1];
+        const float db = node.pos[2] - pos[2];
+        *bestDistance = dL * dL + da * da + db * db;
+    }
+
+    const float planeDistance = pos[node.axis] - node.pos[node.axis];
+    const bool nearIsLeft = planeDistance < 0;
+
+    if(nearIsLeft) search(begin, middle, pos, clr, bestIndex, bestSimilarity, bestDistance);
+    else search(middle + 1, end, pos, clr, bestIndex, bestSimilarity, bestDistance);
+
+    // The far side is skipped only when it is certainly worse, so the
+    // rounding of the scaled positions never changes the result
+    if(planeDistance * planeDistance <= *bestDistance * 1.0001f + 1e-9f)
+    {
+        if(nearIsLeft) search(middle + 1, end, pos, clr, bestIndex, bestSimilarity, bestDistance);
+        else search(begin, middle, pos, clr, bestIndex, bestSimilarity, bestDistance);
+    }
+}
+
+LabColor IndexColorSearchTree::getNearestIndex(LabColor clr) const
+{
+    if(m_nodes.isEmpty()) return clr;
+
+    float pos[3];
+    scaledPosition(clr, pos);
+
+    int bestIndex = m_nodes.size();
+    float bestSimilarity = -std::numeric_limits<float>::max();
+    float bestDistance = std::numeric_limits<float>::max();
+    search(0, m_nodes.size(), pos, clr, &bestIndex, &bestSimilarity, &bestDistance);
+
+    return m_palette.colors[bestIndex];
+}
@@ -47,4 +47,33 @@ struct IndexColorPalette
     QPair< int, int > getNeighbours(int mainClr) const;
 };
 
+/**
+ * Finds the same color as IndexColorPalette::getNearestIndex() without
+ * comparing the color with every color of the palette. The colors are
+ * stored in a k-d tree over the Lab space scaled by the similarity factors,
+ * so only the branches that may contain a more similar color are visited.
+ */
+class IndexColorSearchTree
+{
+public:
+    explicit IndexColorSearchTree(const IndexColorPalette& palette);
+
+    LabColor getNearestIndex(LabColor clr) const;
+
+private:
+    struct Node
+    {
+        float pos[3];
+        int index;
+        int axis;
+    };
+
+    void build(int begin, int end, int depth);
+    void search(int begin, int end, const float* pos, LabColor clr, int* bestIndex, float* bestSimilarity, float* bestDistance) const;
+    void scaledPosition(LabColor clr, float* pos) const;
+
+    IndexColorPalette m_palette;
+    QVector<Node> m_nodes;
+};
+
 #endif // INDEXCOLORPALETTE_H
@@ -87,9 +87,9 @@ KisFilterConfigurationSP KisFilterIndexColors::defaultConfiguration(KisResources
 
 KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palette, const KoColorSpace* cs, int alphaSteps)
     : m_colorSpace(cs),
-      m_psize(cs->pixelSize())
+      m_psize(cs->pixelSize()),
+      m_searchTree(palette)
 {
-    m_palette = palette;
 
     static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
     if(alphaSteps > 0)
@@ -106,24 +106,40 @@ KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palet
 
 void KisIndexColorTransformation::transform(const quint8* src, quint8* dst, qint32 nPixels) const
 {
-    union
+    union LabAColor
     {
         quint16 laba[4];
         LabColor lab;
-    } clr;
-    while (nPixels--)
+    };
+
+    // Convert all the pixels at once instead of one by one
+    QVector<LabAColor> clrs(nPixels);
+    m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(clrs.data()), nPixels);
+
+    // The flat areas of the image share the nearest color, so the search
+    // is repeated only when the color changes
+    LabColor lastClr = {0, 0, 0};
+    LabColor lastNearest = {0, 0, 0};
+    bool hasLast = false;
+
+    for(int i = 0; i < nPixels; ++i)
     {
-        m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(clr.laba), 1);
-        clr.lab = m_palette.getNearestIndex(clr.lab);
+        LabAColor& clr = clrs[i];
+        if(!hasLast || clr.lab.L != lastClr.L || clr.lab.a != lastClr.a || clr.lab.b != lastClr.b)
+        {
+            lastClr = clr.lab;
+            lastNearest = m_searchTree.getNearestIndex(clr.lab);
+            hasLast = true;
+        }
+        clr.lab = lastNearest;
         if(m_alphaStep)
         {
             quint16 amod = clr.laba[3] % m_alphaStep;
             clr.laba[3] = clr.laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
         }
-        m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(clr.laba), dst, 1);
-        src += m_psize;
-        dst += m_psize;
     }
+
+    m_colorSpace->fromLabA16(reinterpret_cast<const quint8 *>(clrs.constData()), dst, nPixels);
 }
 
 #include "indexcolors.moc"
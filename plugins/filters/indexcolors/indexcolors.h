@@ -45,7 +45,7 @@ public:
 private:
     const KoColorSpace* m_colorSpace;
     quint32 m_psize;
-    IndexColorPalette m_palette;
+    IndexColorSearchTree m_searchTree;
     quint16 m_alphaStep;
     quint16 m_alphaHalfStep;
 };
@@ -14,6 +14,8 @@
 #include "kis_oilpaint_filter.h"
 
 #include <stdlib.h>
+#include <algorithm>
+#include <deque>
 #include <vector>
 
 #include <QPoint>
@@ -29,6 +31,7 @@
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <KisSequentialIteratorProgress.h>
+#include <kis_sequential_iterator.h>
 #include <kis_layer.h>
 #include <filter/kis_filter_registry.h>
 #include <kis_global.h>
@@ -63,113 +66,200 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
     OilPaint(device, device, applyRect, brushSize, smooth, progressUpdater);
 }
 
+namespace {
+
+/**
+ * The intensities and the normalised channels of a row of the device
+ */
+struct OilPaintRow {
+    int y;
+    QVector<int> intensity;
+    QVector<float> channels;
+};
+
+/**
+ * The matrix of the pixel at \p pos. The matrix is shifted (not cropped)
+ * at the beginning of the line and cropped at its end, just like in the
+ * original algorithm
+ */
+inline void matrixRange(int pos, int radius, int first, int last, int *start, int *end)
+{
+    *start = qMax(pos - radius, first);
+    *end = qMin(*start + 2 * radius, last);
+}
+
+}
+
 // This method have been ported from Pieter Z. Voloshyn algorithm code.
 
 /* Function to apply the OilPaint effect.
  *
- * data             => The image data in RGBA mode.
- * w                => Width of image.
- * h                => Height of image.
- * BrushSize        => Brush size.
- * Smoothness       => Smooth value.
+ * Theory           => Using the most frequent color of a matrix around the pixel,
+ *                     we take the main color and simply write at the original
+ *                     position.
+ *
+ * The filter works in place: the matrices of the pixels read the pixels that
+ * have already been filtered above and to the left of them. To keep this
+ * behavior, the intensities and the channels of the rows covered by the
+ * matrices are kept in a rolling buffer, which is updated every time a pixel
+ * is written.
  *
- * Theory           => Using MostFrequentColor function we take the main color in
- *                     a matrix and simply write at the original position.
+ * The histogram of the matrix is not recalculated for every pixel: when the
+ * matrix moves to the right, only the columns that leave it and enter it are
+ * updated, so the cost of a pixel is O(Radius) instead of O(Radius^2).
  */
 
 void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
                                  int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
 {
-    KisSequentialConstIteratorProgress it(src, applyRect, progressUpdater);
-    KisSequentialIterator dstIt(dst, applyRect);
+    if (applyRect.isEmpty()) return;
 
-    while (it.nextPixel() && dstIt.nextPixel()) {
-        MostFrequentColor(src, dstIt.rawData(), applyRect, it.x(), it.y(), BrushSize, Smoothness);
-    }
-}
+    const KoColorSpace* cs = src->colorSpace();
+    const int channelCount = cs->channelCount();
+    const int pixelSize = cs->pixelSize();
+    const int width = applyRect.width();
 
-// This method has been ported from Pieter Z. Voloshyn's algorithm code in Digikam.
+    const int Radius = BrushSize;
+    const int Intensity = Smoothness;
+    const double Scale = Intensity / 255.0;
 
-/* Function to determine the most frequent color in a matrix
- *
- * Bits             => Bits array
- * Width            => Image width
- * Height           => Image height
- * X                => Position horizontal
- * Y                => Position vertical
- * Radius           => Is the radius of the matrix to be analyzed
- * Intensity        => Intensity to calculate
- *
- * Theory           => This function creates a matrix with the analyzed pixel in
- *                     the center of this matrix and find the most frequenty color
- */
+    QVector<float> channel(channelCount);
 
-void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& bounds, int X, int Y, int Radius, int Intensity) const
-{
-    uint I;
+    auto intensityOf = [&] (const quint8 *pixel) {
+        return int((uint)(cs->intensity8(pixel) * Scale));
+    };
 
-    double Scale = Intensity / 255.0;
+    std::deque<OilPaintRow> rows;
 
-    // Alloc some arrays to be used
-    uchar *IntensityCount = new uchar[(Intensity + 1) * sizeof(uchar)];
+    auto loadRow = [&] (int y) {
+        OilPaintRow row;
+        row.y = y;
+        row.intensity.resize(width);
+        row.channels.resize(width * channelCount);
 
-    const KoColorSpace* cs = src->colorSpace();
+        int *intensityPtr = row.intensity.data();
+        float *channelsPtr = row.channels.data();
 
-    QVector<float> channel(cs->channelCount());
-    QVector<float>* AverageChannels = new QVector<float>[(Intensity + 1)];
-
-    // Erase the array
-    memset(IntensityCount, 0, (Intensity + 1) * sizeof(uchar));
-
-    int startx = qMax(X - Radius, bounds.left());
-    int starty = qMax(Y - Radius, bounds.top());
-    int width = (2 * Radius) + 1;
-    if ((startx + width - 1) > bounds.right()) width = bounds.right() - startx + 1;
-    Q_ASSERT((startx + width - 1) <= bounds.right());
-    int height = (2 * Radius) + 1;
-    if ((starty + height) > bounds.bottom()) height = bounds.bottom() - starty + 1;
-    Q_ASSERT((starty + height - 1) <= bounds.bottom());
-    KisSequentialConstIterator srcIt(src, QRect(startx, starty, width, height));
-    while (srcIt.nextPixel()) {
-
-        cs->normalisedChannelsValue(srcIt.rawDataConst(), channel);
-
-        I = (uint)(cs->intensity8(srcIt.rawDataConst()) * Scale);
-        IntensityCount[I]++;
-
-        if (IntensityCount[I] == 1) {
-            AverageChannels[I] = channel;
-        } else {
-            for (int i = 0; i < channel.size(); i++) {
-                AverageChannels[I][i] += channel[i];
-            }
+        KisSequentialConstIterator srcIt(src, QRect(applyRect.left(), y, width, 1));
+        while (srcIt.nextPixel()) {
+            cs->normalisedChannelsValue(srcIt.rawDataConst(), channel);
+            std::copy(channel.constBegin(), channel.constEnd(), channelsPtr);
+            channelsPtr += channelCount;
+
+            *intensityPtr++ = intensityOf(srcIt.rawDataConst());
         }
-    }
 
-    I = 0;
-    int MaxInstance = 0;
+        rows.push_back(row);
+    };
+
+    QVector<int> IntensityCount(Intensity + 1);
+    QVector<double> AverageChannels((Intensity + 1) * channelCount);
+    QVector<quint8> dstPixels(width * pixelSize);
 
-    for (int i = 0 ; i <= Intensity ; ++i) {
-        if (IntensityCount[i] > MaxInstance) {
-            I = i;
-            MaxInstance = IntensityCount[i];
+    auto updateHistogram = [&] (int I, const float *channelsPtr, int sign) {
+        double *averagePtr = AverageChannels.data() + I * channelCount;
+
+        IntensityCount[I] += sign;
+        for (int i = 0; i < channelCount; i++) {
+            averagePtr[i] += sign * channelsPtr[i];
         }
-    }
+    };
+
+    auto updateColumn = [&] (int x, int starty, int endy, int sign) {
+        const int column = x - applyRect.left();
 
-    if (MaxInstance != 0) {
-        channel = AverageChannels[I];
-        for (int i = 0; i < channel.size(); i++) {
-            channel[i] /= MaxInstance;
+        for (int y = starty; y <= endy; y++) {
+            const OilPaintRow &row = rows[y - rows.front().y];
+            updateHistogram(row.intensity[column], row.channels.constData() + column * channelCount, sign);
         }
-        cs->fromNormalisedChannelsValue(dst, channel);
-    } else {
-        memset(dst, 0, cs->pixelSize());
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, 1);
+    };
+
+    if (progressUpdater) {
+        progressUpdater->setRange(applyRect.top(), applyRect.bottom() + 1);
     }
 
+    for (int Y = applyRect.top(); Y <= applyRect.bottom(); Y++) {
+        if (progressUpdater && progressUpdater->interrupted()) break;
+
+        int starty, endy;
+        matrixRange(Y, Radius, applyRect.top(), applyRect.bottom(), &starty, &endy);
 
-    delete [] IntensityCount;        // free all the arrays
-    delete [] AverageChannels;
+        while (!rows.empty() && rows.front().y < starty) {
+            rows.pop_front();
+        }
+
+        for (int y = rows.empty() ? starty : rows.back().y + 1; y <= endy; y++) {
+            loadRow(y);
+        }
+
+        OilPaintRow &currentRow = rows[Y - rows.front().y];
+
+        // Erase the arrays
+        std::fill(IntensityCount.begin(), IntensityCount.end(), 0);
+        std::fill(AverageChannels.begin(), AverageChannels.end(), 0.0);
+
+        int prevStartx = applyRect.left();
+        int prevEndx = applyRect.left() - 1;
+        quint8 *dstPtr = dstPixels.data();
+
+        for (int X = applyRect.left(); X <= applyRect.right(); X++) {
+            int startx, endx;
+            matrixRange(X, Radius, applyRect.left(), applyRect.right(), &startx, &endx);
+
+            for (int x = prevStartx; x < startx; x++) {
+                updateColumn(x, starty, endy, -1);
+            }
+
+            for (int x = prevEndx + 1; x <= endx; x++) {
+                updateColumn(x, starty, endy, 1);
+            }
+
+            prevStartx = startx;
+            prevEndx = endx;
+
+            int I = 0;
+            int MaxInstance = 0;
+
+            for (int i = 0 ; i <= Intensity ; ++i) {
+                if (IntensityCount[i] > MaxInstance) {
+                    I = i;
+                    MaxInstance = IntensityCount[i];
+                }
+            }
+
+            if (MaxInstance != 0) {
+                const double *averagePtr = AverageChannels.constData() + I * channelCount;
+                for (int i = 0; i < channelCount; i++) {
+                    channel[i] = averagePtr[i] / MaxInstance;
+                }
+                cs->fromNormalisedChannelsValue(dstPtr, channel);
+            } else {
+                memset(dstPtr, 0, pixelSize);
+                cs->setOpacity(dstPtr, OPACITY_OPAQUE_U8, 1);
+            }
+
+            // the filtered pixel replaces the original one in the
+            // matrices of all the following pixels
+            const int column = X - applyRect.left();
+            float *channelsPtr = currentRow.channels.data() + column * channelCount;
+
+            updateHistogram(currentRow.intensity[column], channelsPtr, -1);
+
+            cs->normalisedChannelsValue(dstPtr, channel);
+            std::copy(channel.constBegin(), channel.constEnd(), channelsPtr);
+            currentRow.intensity[column] = intensityOf(dstPtr);
+
+            updateHistogram(currentRow.intensity[column], channelsPtr, 1);
+
+            dstPtr += pixelSize;
+        }
+
+        dst->writeBytes(dstPixels.constData(), QRect(applyRect.left(), Y, width, 1));
+
+        if (progressUpdater) {
+            progressUpdater->setValue(Y + 1);
+        }
+    }
 }
 
 
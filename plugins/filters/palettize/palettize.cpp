@@ -274,70 +274,99 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
         KisDitherUtil alphaDitherUtil;
         if (alphaMode == AlphaMode::Dither) alphaDitherUtil.setConfiguration(*config, "alphaDither/");
 
+        const int pixelSize = colorspace->pixelSize();
+        const int workPixelSize = workColorspace->pixelSize();
+        QVector<quint8> workBuffer;
+        QVector<float> normalized(int(workColorspace->channelCount()));
+
+        /**
+         * The flat areas of the image search the tree for the same color
+         * over and over, so the candidates of the last searched color are
+         * reused until the color changes
+         */
+        SearchColor lastSearchColor;
+        std::vector<ColorCandidate> candidateColors;
+        candidateColors.reserve(size_t(colorCount));
+        double distanceSum = 0.0;
+
         KisSequentialIteratorProgress pixel(device, applyRect, progressUpdater);
-        while (pixel.nextPixel()) {
-            KoColor workColor(pixel.oldRawData(), colorspace);
-            workColor.convertTo(workColorspace);
-
-            // Find dither threshold
-            double threshold = 0.5;
-            if (ditherEnabled) {
-                threshold = ditherUtil.threshold(QPoint(pixel.x(), pixel.y()));
-
-                // Traditional per-channel ordered dithering
-                if (colorMode == ColorMode::PerChannelOffset) {
-                    QVector<float> normalized(int(workColorspace->channelCount()));
-                    workColorspace->normalisedChannelsValue(workColor.data(), normalized);
-                    for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
-                        normalized[channel] += (threshold - 0.5) * offsetScale;
+        int conseqPixels = pixel.nConseqPixels();
+        while (pixel.nextPixels(conseqPixels)) {
+            conseqPixels = pixel.nConseqPixels();
+
+            // Convert the whole run of pixels into the search colorspace at once
+            workBuffer.resize(conseqPixels * workPixelSize);
+            colorspace->convertPixelsTo(pixel.oldRawData(), workBuffer.data(), workColorspace, conseqPixels,
+                                        KoColorConversionTransformation::internalRenderingIntent(),
+                                        KoColorConversionTransformation::internalConversionFlags());
+
+            for (int i = 0; i < conseqPixels; ++i) {
+                const QPoint pt(pixel.x() + i, pixel.y());
+                const quint8 *oldPixel = pixel.oldRawData() + i * pixelSize;
+                quint8 *workColor = workBuffer.data() + i * workPixelSize;
+
+                // Find dither threshold
+                double threshold = 0.5;
+                if (ditherEnabled) {
+                    threshold = ditherUtil.threshold(pt);
+
+                    // Traditional per-channel ordered dithering
+                    if (colorMode == ColorMode::PerChannelOffset) {
+                        workColorspace->normalisedChannelsValue(workColor, normalized);
+                        for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
+                            normalized[channel] += (threshold - 0.5) * offsetScale;
+                        }
+                        workColorspace->fromNormalisedChannelsValue(workColor, normalized);
                     }
-                    workColorspace->fromNormalisedChannelsValue(workColor.data(), normalized);
                 }
-            }
 
-            // Get candidate colors and their distances
-            SearchColor searchColor;
-            memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor.data(), sizeof(SearchColor));
-            std::vector<ColorCandidate> candidateColors;
-            candidateColors.reserve(size_t(colorCount));
-            double distanceSum = 0.0;
-            for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && candidateColors.size() < colorCount; ++it) {
-                ColorCandidate candidate = it->second;
-                candidate.distance = boost::geometry::distance(searchColor, it->first);
-                candidateColors.push_back(candidate);
-                distanceSum += candidate.distance;
-            }
+                // Get candidate colors and their distances
+                SearchColor searchColor;
+                memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor, sizeof(SearchColor));
+                if (candidateColors.empty() || !boost::geometry::equals(searchColor, lastSearchColor)) {
+                    candidateColors.clear();
+                    distanceSum = 0.0;
+                    for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && candidateColors.size() < colorCount; ++it) {
+                        ColorCandidate candidate = it->second;
+                        candidate.distance = boost::geometry::distance(searchColor, it->first);
+                        candidateColors.push_back(candidate);
+                        distanceSum += candidate.distance;
+                    }
+                    lastSearchColor = searchColor;
+                }
 
-            // Select color candidate
-            quint16 selected;
-            if (ditherEnabled && colorMode == ColorMode::NearestColors) {
-                // Sort candidates by palette order for stable dither color ordering
-                const bool swap = candidateColors[0].index > candidateColors[1].index;
-                selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
-            }
-            else {
-                selected = 0;
-            }
-            ColorCandidate &candidate = candidateColors[selected];
-
-            // Set alpha
-            const double oldAlpha = colorspace->opacityF(pixel.oldRawData());
-            double newAlpha = oldAlpha;
-            if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
-                if (alphaMode == AlphaMode::Clip) {
-                    newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                // Select color candidate
+                quint16 selected;
+                if (ditherEnabled && colorMode == ColorMode::NearestColors) {
+                    // Sort candidates by palette order for stable dither color ordering
+                    const bool swap = candidateColors[0].index > candidateColors[1].index;
+                    selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
                 }
-                else if (alphaMode == AlphaMode::Index) {
-                    newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                else {
+                    selected = 0;
                 }
-                else if (alphaMode == AlphaMode::Dither) {
-                    newAlpha = oldAlpha < alphaDitherUtil.threshold(QPoint(pixel.x(), pixel.y())) ? 0.0 : 1.0;
+                const ColorCandidate &candidate = candidateColors[selected];
+
+                // Set alpha
+                const double oldAlpha = colorspace->opacityF(oldPixel);
+                double newAlpha = oldAlpha;
+                if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
+                    if (alphaMode == AlphaMode::Clip) {
+                        newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                    }
+                    else if (alphaMode == AlphaMode::Index) {
+                        newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                    }
+                    else if (alphaMode == AlphaMode::Dither) {
+                        newAlpha = oldAlpha < alphaDitherUtil.threshold(pt) ? 0.0 : 1.0;
+                    }
                 }
-            }
-            colorspace->setOpacity(candidate.color.data(), newAlpha, 1);
 
-            // Copy color to pixel
-            memcpy(pixel.rawData(), candidate.color.data(), colorspace->pixelSize());
+                // Copy color to pixel
+                quint8 *dstPixel = pixel.rawData() + i * pixelSize;
+                memcpy(dstPixel, candidate.color.data(), pixelSize);
+                colorspace->setOpacity(dstPixel, newAlpha, 1);
+            }
         }
     }
 }
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <limits>
 #include <utility>
 
 #include <kpluginfactory.h>
@@ -230,21 +231,40 @@ void KisScreentoneGenerator::generate(KisProcessingInformation dst,
     KisSelectionSP selection = new KisSelection(device->defaultBounds());
     KisSequentialIterator it(selection->pixelSelection(), bounds);
 
-    if (!config->getBool("invert", KisScreentoneConfigDefaults::invert())) {
-        while (it.nextPixel()) {
-            qreal x, y;
-            t.map(it.x(), it.y(), &x, &y);
+    const bool invert = config->getBool("invert", KisScreentoneConfigDefaults::invert());
 
-            qreal v = qBound(0.0, brightnessContrastFunction(screentoneFunction(x, y)), 1.0);
-            *it.rawData() = 255 - static_cast<quint8>(qRound(v * 255.0));
+    // The transform is affine, so the terms that depend on the row are
+    // calculated once per row. The sums are done in the same order as
+    // in QTransform::map() to get exactly the same values
+    const qreal m11 = t.m11();
+    const qreal m12 = t.m12();
+    const qreal tdx = t.dx();
+    const qreal tdy = t.dy();
+
+    int row = std::numeric_limits<int>::min();
+    qreal rowX = 0.0;
+    qreal rowY = 0.0;
+
+    int conseq = it.nConseqPixels();
+    while (it.nextPixels(conseq)) {
+        conseq = it.nConseqPixels();
+
+        if (it.y() != row) {
+            row = it.y();
+            rowX = t.m21() * row;
+            rowY = t.m22() * row;
         }
-    } else {
-        while (it.nextPixel()) {
-            qreal x, y;
-            t.map(it.x(), it.y(), &x, &y);
+
+        quint8 *dstPtr = it.rawData();
+        const int firstColumn = it.x();
+
+        for (int column = firstColumn; column < firstColumn + conseq; column++) {
+            const qreal x = m11 * column + rowX + tdx;
+            const qreal y = m12 * column + rowY + tdy;
 
             qreal v = qBound(0.0, brightnessContrastFunction(screentoneFunction(x, y)), 1.0);
-            *it.rawData() = static_cast<quint8>(qRound(v * 255.0));
+            const quint8 value = static_cast<quint8>(qRound(v * 255.0));
+            *dstPtr++ = invert ? value : 255 - value;
         }
     }
     checkUpdaterInterruptedAndSetPercent(progressUpdater, 25);
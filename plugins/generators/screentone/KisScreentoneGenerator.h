@@ -56,6 +56,8 @@ public:
     KisFilterConfigurationSP defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const override;
     KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
 
+    bool dependsOnImageBounds() const override { return false; }
+
 private:
     bool checkUpdaterInterruptedAndSetPercent(KoUpdater *progressUpdater, int percent) const;
 };
@@ -14,6 +14,11 @@ SeExprExpressionContext::SeExprExpressionContext(const QString &expr)
 {
 }
 
+SeExprExpressionContext::~SeExprExpressionContext()
+{
+    qDeleteAll(m_vars);
+}
+
 KSeExpr::ExprVarRef *SeExprExpressionContext::resolveVar(const std::string &name) const
 {
     return m_vars.value(name, nullptr);
@@ -6,9 +6,15 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-#include <KisSequentialIteratorProgress.h>
+#include <KoColorConversionTransformation.h>
 #include <KoUpdater.h>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThread>
+#include <QtConcurrent>
 #include <cstring>
+#include <memory>
+#include <vector>
 #include <filter/kis_filter_configuration.h>
 #include <generator/kis_generator_registry.h>
 #include <kis_debug.h>
@@ -21,6 +27,7 @@
 #include <kis_selection.h>
 #include <kis_types.h>
 #include <klocalizedstring.h>
+#include <krita_utils.h>
 #include <kpluginfactory.h>
 
 #include "SeExprExpressionContext.h"
@@ -96,6 +103,43 @@ KisConfigWidget *KisSeExprGenerator::createConfigurationWidget(QWidget *parent,
     return new KisWdgSeExpr(parent);
 }
 
+namespace
+{
+
+/**
+ * The size of the patches the generated rect is split into for the
+ * worker threads, aligned to the tiles of the device
+ */
+const QSize seExprPatchSize(128, 128);
+
+/**
+ * Every worker thread gets its own compiled copy of the expression
+ * and its own color converter, because neither the interpreter of
+ * KSeExpr nor the caches of the converter may be shared between
+ * threads
+ */
+struct SeExprWorkerContext {
+    SeExprWorkerContext(const QString &script, const QRect &wholeImageBounds, const KoColorSpace *src, const KoColorSpace *dst)
+        : expression(script)
+        , converter(KoColorSpaceRegistry::instance()->createColorConverter(src, dst, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags()))
+    {
+        expression.m_vars["u"] = new SeExprVariable();
+        expression.m_vars["v"] = new SeExprVariable();
+        expression.m_vars["w"] = new SeExprVariable(wholeImageBounds.width());
+        expression.m_vars["h"] = new SeExprVariable(wholeImageBounds.height());
+    }
+
+    bool isValid() const
+    {
+        return expression.isValid() && expression.returnType().isFP(3);
+    }
+
+    SeExprExpressionContext expression;
+    QScopedPointer<KoColorConversionTransformation> converter;
+};
+
+} // namespace
+
 void KisSeExprGenerator::generate(KisProcessingInformation dstInfo, const QSize &size, const KisFilterConfigurationSP config, KoUpdater *progressUpdater) const
 {
     KisPaintDeviceSP device = dstInfo.paintDevice();
@@ -109,40 +153,87 @@ void KisSeExprGenerator::generate(KisProcessingInformation dstInfo, const QSize
         QRect bounds = QRect(dstInfo.topLeft(), size);
         QRect whole_image_bounds = device->defaultBounds()->bounds();
 
-        SeExprExpressionContext expression(script);
+        // SeExpr already outputs floating-point RGB
+        const KoColorSpace *dst = device->colorSpace();
+        const KoColorSpace *src = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), KoColorSpaceRegistry::instance()->p709SRGBProfile());
 
-        expression.m_vars["u"] = new SeExprVariable();
-        expression.m_vars["v"] = new SeExprVariable();
-        expression.m_vars["w"] = new SeExprVariable(whole_image_bounds.width());
-        expression.m_vars["h"] = new SeExprVariable(whole_image_bounds.height());
+        const QVector<QRect> patches = KritaUtils::splitRectIntoPatches(bounds, seExprPatchSize);
+        if (patches.isEmpty()) return;
+
+        const int numWorkers = qBound(1, QThread::idealThreadCount(), patches.size());
+
+        std::vector<std::unique_ptr<SeExprWorkerContext>> contexts;
+
+        for (int i = 0; i < numWorkers; i++) {
+            contexts.emplace_back(new SeExprWorkerContext(script, whole_image_bounds, src, dst));
+
+            // the expression is the same for all the workers, so it
+            // is enough to check the first one only
+            if (i == 0 && !contexts.front()->isValid()) return;
+        }
+
+        const double pixel_stride_x = 1. / whole_image_bounds.width();
+        const double pixel_stride_y = 1. / whole_image_bounds.height();
+
+        if (progressUpdater) {
+            progressUpdater->setRange(0, patches.size());
+        }
 
-        if (expression.isValid() && expression.returnType().isFP(3)) {
-            double pixel_stride_x = 1. / whole_image_bounds.width();
-            double pixel_stride_y = 1. / whole_image_bounds.height();
-            double &u = expression.m_vars["u"]->m_value;
-            double &v = expression.m_vars["v"]->m_value;
+        QAtomicInt nextPatch(0);
+        QMutex progressMutex;
+        int patchesDone = 0;
 
-            // SeExpr already outputs floating-point RGB
-            const KoColorSpace *dst = device->colorSpace();
-            const KoColorSpace *src = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), KoColorSpaceRegistry::instance()->p709SRGBProfile());
-            auto conv = KoColorSpaceRegistry::instance()->createColorConverter(src, dst, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
+        auto processPatches = [&](std::unique_ptr<SeExprWorkerContext> &context) {
+            // the other workers are compiled lazily in their own threads
+            if (!context->isValid()) return;
 
-            KisSequentialIteratorProgress it(device, bounds, progressUpdater);
+            double &u = context->expression.m_vars["u"]->m_value;
+            double &v = context->expression.m_vars["v"]->m_value;
 
-            while (it.nextPixel()) {
-                u = pixel_stride_x * (it.x() + .5);
-                v = pixel_stride_y * (it.y() + .5);
+            QVector<float> srcPixels;
+            QVector<quint8> dstPixels;
 
-                const double *value = expression.evalFP();
+            int patchIndex;
+            while ((patchIndex = nextPatch.fetchAndAddOrdered(1)) < patches.size()) {
+                if (progressUpdater && progressUpdater->interrupted()) break;
 
-                KoColor c(src);
-                reinterpret_cast<float *>(c.data())[0] = value[0];
-                reinterpret_cast<float *>(c.data())[1] = value[1];
-                reinterpret_cast<float *>(c.data())[2] = value[2];
-                c.setOpacity(OPACITY_OPAQUE_F);
+                const QRect &rc = patches[patchIndex];
+                const int numPixels = rc.width() * rc.height();
 
-                conv->transform(c.data(), it.rawData(), 1);
+                srcPixels.resize(4 * numPixels);
+                dstPixels.resize(dst->pixelSize() * numPixels);
+
+                float *srcPtr = srcPixels.data();
+
+                for (int y = rc.top(); y <= rc.bottom(); y++) {
+                    v = pixel_stride_y * (y + .5);
+
+                    for (int x = rc.left(); x <= rc.right(); x++) {
+                        u = pixel_stride_x * (x + .5);
+
+                        const double *value = context->expression.evalFP();
+
+                        *srcPtr++ = value[0];
+                        *srcPtr++ = value[1];
+                        *srcPtr++ = value[2];
+                        *srcPtr++ = OPACITY_OPAQUE_F;
+                    }
+                }
+
+                context->converter->transform(reinterpret_cast<const quint8 *>(srcPixels.constData()), dstPixels.data(), numPixels);
+                device->writeBytes(dstPixels.constData(), rc);
+
+                if (progressUpdater) {
+                    QMutexLocker l(&progressMutex);
+                    progressUpdater->setValue(++patchesDone);
+                }
             }
+        };
+
+        if (numWorkers == 1) {
+            processPatches(contexts.front());
+        } else {
+            QtConcurrent::blockingMap(contexts, processPatches);
         }
     }
 }
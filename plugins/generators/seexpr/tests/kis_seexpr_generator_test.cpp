@@ -102,4 +102,44 @@ void KisSeExprGeneratorTest::testGenerationFromKoResource()
     }
 }
 
+void KisSeExprGeneratorTest::testPartialGeneration()
+{
+    KisGeneratorSP generator = KisGeneratorRegistry::instance()->get("seexpr");
+    QVERIFY(generator);
+
+    KisFilterConfigurationSP config = generator->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    QVERIFY(config);
+
+    config->setProperty("script", BASE_SCRIPT);
+
+    const QRect imageRect(0, 0, 256, 256);
+    const QRect partialRect(37, 53, 150, 120);
+
+    KisDefaultBoundsBaseSP bounds(new KisWrapAroundBoundsWrapper(new KisDefaultBounds(), imageRect));
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(bounds);
+
+    KisPaintDeviceSP partialDev = new KisPaintDevice(cs);
+    partialDev->setDefaultBounds(bounds);
+
+    KisFillPainter fillPainter(dev);
+    fillPainter.fillRect(imageRect.x(), imageRect.y(), imageRect.width(), imageRect.height(), config);
+
+    KisFillPainter partialFillPainter(partialDev);
+    partialFillPainter.fillRect(partialRect.x(), partialRect.y(), partialRect.width(), partialRect.height(), config);
+
+    // the pixels must not depend on how the rect was split between the threads
+    QCOMPARE(partialDev->exactBounds(), partialRect);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  dev->convertToQImage(nullptr, partialRect.x(), partialRect.y(), partialRect.width(), partialRect.height()),
+                                  partialDev->convertToQImage(nullptr, partialRect.x(), partialRect.y(), partialRect.width(), partialRect.height()))) {
+        partialDev->convertToQImage(nullptr, partialRect.x(), partialRect.y(), partialRect.width(), partialRect.height()).save("filtertest_partial.png");
+        QFAIL(QString("Failed to create image, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 KISTEST_MAIN(KisSeExprGeneratorTest)
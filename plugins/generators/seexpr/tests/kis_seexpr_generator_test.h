@@ -19,6 +19,7 @@ private Q_SLOTS:
     void initTestCase();
     void testGenerationFromScript();
     void testGenerationFromKoResource();
+    void testPartialGeneration();
 };
 
 #endif
@@ -15,6 +15,8 @@
 #include <KisSequentialIteratorProgress.h>
 #include <KoUpdater.h>
 #include <QCryptographicHash>
+#include <QVector>
+#include <limits>
 #include <filter/kis_filter_configuration.h>
 #include <generator/kis_generator_registry.h>
 #include <KoColorModelStandardIds.h>
@@ -72,38 +74,67 @@ void KisSimplexNoiseGenerator::generate(KisProcessingInformation dst, const QSiz
 
     bool looping = (config && config->getProperty("looping", property)) ? property.toBool() : false;
 
-    if( looping ){
-        float major_radius = 0.5f * frequency * ratio_x;
-        float minor_radius = 0.5f * frequency * ratio_y;
-        while(it.nextPixel()){
-            double x_phase = (double)it.x() / (double)whole_image_bounds.width() * M_PI * 2;
-            double y_phase = (double)it.y() / (double)(whole_image_bounds.height()) * M_PI * 2;
-            double x_coordinate = major_radius * map_range(cos(x_phase), -1.0, 1.0, 0.0, 1.0);
-            double y_coordinate = major_radius * map_range(sin(x_phase), -1.0, 1.0, 0.0, 1.0);
-            double z_coordinate = minor_radius * map_range(cos(y_phase), -1.0, 1.0, 0.0, 1.0);
-            double w_coordinate = minor_radius * map_range(sin(y_phase), -1.0, 1.0, 0.0, 1.0);
-            double value = open_simplex_noise4(noise_context, x_coordinate, y_coordinate, z_coordinate, w_coordinate);
-            value = map_range(value, -1.0, 1.0, 0.0, 1.0);
-
-            KoColor c(src);
-            reinterpret_cast<float *>(c.data())[0] = value;
-            c.setOpacity(OPACITY_OPAQUE_F);
-
-            conv->transform(c.data(), it.rawData(), 1);
+    /**
+     * Only the noise itself depends on both coordinates of the pixel, so
+     * the phases of the columns are calculated once for the whole rect
+     * and the pixels are converted in long runs instead of one by one
+     */
+    const int numColumns = bounds.width();
+    QVector<double> column_x(numColumns);
+    QVector<double> column_y(numColumns);
+
+    if (looping) {
+        const float major_radius = 0.5f * frequency * ratio_x;
+
+        for (int i = 0; i < numColumns; i++) {
+            double x_phase = (double)(bounds.x() + i) / (double)whole_image_bounds.width() * M_PI * 2;
+            column_x[i] = major_radius * map_range(cos(x_phase), -1.0, 1.0, 0.0, 1.0);
+            column_y[i] = major_radius * map_range(sin(x_phase), -1.0, 1.0, 0.0, 1.0);
         }
     } else {
-        while(it.nextPixel()){
-            double x_phase = (double)it.x() / (double)(whole_image_bounds.width()) * ratio_x;
-            double y_phase = (double)it.y() / (double)(whole_image_bounds.height()) * ratio_y;
-            double value = open_simplex_noise4(noise_context, x_phase * frequency, y_phase * frequency, x_phase * frequency, y_phase * frequency);
-            value = map_range(value, -1.0, 1.0, 0.0, 1.0);
+        for (int i = 0; i < numColumns; i++) {
+            double x_phase = (double)(bounds.x() + i) / (double)(whole_image_bounds.width()) * ratio_x;
+            column_x[i] = x_phase * frequency;
+        }
+    }
+
+    QVector<float> pixels(2 * numColumns);
+
+    int row = std::numeric_limits<int>::min();
+    double z_coordinate = 0.0;
+    double w_coordinate = 0.0;
+
+    int conseq = it.nConseqPixels();
+    while (it.nextPixels(conseq)) {
+        conseq = it.nConseqPixels();
 
-            KoColor c(src);
-            reinterpret_cast<float *>(c.data())[0] = value;
-            c.setOpacity(OPACITY_OPAQUE_F);
+        if (it.y() != row) {
+            row = it.y();
 
-            conv->transform(c.data(), it.rawData(), 1);
+            if (looping) {
+                const float minor_radius = 0.5f * frequency * ratio_y;
+                double y_phase = (double)row / (double)(whole_image_bounds.height()) * M_PI * 2;
+                z_coordinate = minor_radius * map_range(cos(y_phase), -1.0, 1.0, 0.0, 1.0);
+                w_coordinate = minor_radius * map_range(sin(y_phase), -1.0, 1.0, 0.0, 1.0);
+            } else {
+                double y_phase = (double)row / (double)(whole_image_bounds.height()) * ratio_y;
+                z_coordinate = y_phase * frequency;
+            }
         }
+
+        const int firstColumn = it.x() - bounds.x();
+        float *dstPtr = pixels.data();
+
+        for (int i = firstColumn; i < firstColumn + conseq; i++) {
+            double value = looping ?
+                open_simplex_noise4(noise_context, column_x[i], column_y[i], z_coordinate, w_coordinate) :
+                open_simplex_noise4(noise_context, column_x[i], z_coordinate, column_x[i], z_coordinate);
+
+            *dstPtr++ = map_range(value, -1.0, 1.0, 0.0, 1.0);
+            *dstPtr++ = OPACITY_OPAQUE_F;
+        }
+
+        conv->transform(reinterpret_cast<const quint8*>(pixels.constData()), it.rawData(), conseq);
     }
     delete conv;
     open_simplex_noise_free(noise_context);
@@ -31,6 +31,7 @@
 #include <QMessageBox>
 #include <QDomDocument>
 #include <QThread>
+#include <QSharedPointer>
 
 #include <QFileInfo>
 
@@ -45,9 +46,9 @@
 #include <kis_group_layer.h>
 #include <kis_image.h>
 #include <kis_paint_device.h>
+#include <KisConvertedBandReader.h>
 #include <kis_paint_layer.h>
 #include <kis_transaction.h>
-#include "kis_iterator_ng.h"
 #include <kis_exr_layers_sorter.h>
 
 #include <kis_meta_data_entry.h>
@@ -63,6 +64,14 @@
 // Do not translate!
 #define HDR_LAYER "HDR Layer"
 
+/**
+ * The number of scanlines read and written at once. It is a multiple of
+ * the line count of the blocks of all the EXR compressions, so that a
+ * band covers whole blocks, which OpenEXR compresses and decompresses
+ * on its own threads.
+ */
+static const int exrBandHeight = 256;
+
 template<typename _T_>
 struct Rgba {
     _T_ r;
@@ -125,7 +134,7 @@ void ExrPaintLayerInfo::updateImageType(ImageType channelType)
 
 struct ExrPaintLayerSaveInfo {
     QString name; ///< name of the layer with a "." at the end (ie "group1.group2.layer1.")
-    KisPaintDeviceSP layerDevice;
+    QSharedPointer<KisConvertedBandReader> layerReader;
     KisPaintLayerSP layer;
     QList<QString> channels;
     Imf::PixelType pixelType;
@@ -149,12 +158,12 @@ struct EXRConverter::Private {
     template <class WrapperType>
     void unmultiplyAlpha(typename WrapperType::pixel_type *pixel);
 
-    template<typename _T_>
-    void decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
+    class Decoder;
 
-    template<typename _T_>
-    void decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
+    template <class WrapperType>
+    class DecoderImpl;
 
+    Decoder* decoder(const ExrPaintLayerInfo &info, KisPaintLayerSP layer, int width, int xstart);
 
     QDomDocument loadExtraLayersInfo(const Imf::Header &header);
     bool checkExtraLayersInfoConsistent(const QDomDocument &doc, std::set<std::string> exrLayerNames);
@@ -251,6 +260,10 @@ struct RgbPixelWrapper
         return pixel.a;
     }
 
+    inline void setAlpha(T value) {
+        pixel.a = value;
+    }
+
     inline bool checkMultipliedColorsConsistent() const {
         return !(std::abs(pixel.a) < alphaEpsilon<T>() &&
                  (!qFuzzyIsNull(pixel.r) ||
@@ -291,6 +304,10 @@ struct GrayPixelWrapper
         return pixel.alpha;
     }
 
+    inline void setAlpha(T value) {
+        pixel.alpha = value;
+    }
+
     inline bool checkMultipliedColorsConsistent() const {
         return !(std::abs(pixel.alpha) < alphaEpsilon<T>() &&
                  !qFuzzyIsNull(pixel.gray));
@@ -369,113 +386,128 @@ void multiplyAlpha(Pixel *pixel)
     }
 }
 
-template<typename _T_>
-void EXRConverter::Private::decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+/**
+ * Decodes the EXR channels of a paint layer. The channels are read
+ * straight into a buffer of the pixel layout of the layer's color space,
+ * which is written into the layer a band of scanlines at a time.
+ */
+class EXRConverter::Private::Decoder
 {
-    typedef Rgba<_T_> Rgba;
-
-    QVector<Rgba> pixels(width * height);
-
-    bool hasAlpha = info.channelMap.contains("A");
-
-    Imf::FrameBuffer frameBuffer;
-    Rgba* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->r,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->g,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->b,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->a,
-                           sizeof(Rgba) * 1,
-                           sizeof(Rgba) * width));
-    }
-
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
-    Rgba *rgba = pixels.data();
-
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
-        }
-
-        typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
-
-        dst->red = rgba->r;
-        dst->green = rgba->g;
-        dst->blue = rgba->b;
-        if (hasAlpha) {
-            dst->alpha = rgba->a;
-        } else {
-            dst->alpha = 1.0;
-        }
-
-        ++rgba;
-    }
-}
+public:
+    virtual ~Decoder() {}
+    virtual void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) = 0;
+    virtual void decodeData(int ystart, int numLines) = 0;
+};
 
-template<typename _T_>
-void EXRConverter::Private::decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+template <class WrapperType>
+class EXRConverter::Private::DecoderImpl : public EXRConverter::Private::Decoder
 {
-    typedef typename GrayPixelWrapper<_T_>::channel_type channel_type;
-    typedef typename GrayPixelWrapper<_T_>::pixel_type pixel_type;
-
-    KIS_ASSERT_RECOVER_RETURN(
-                layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID);
-
-    QVector<pixel_type> pixels(width * height);
-
-    Q_ASSERT(info.channelMap.contains("G"));
-    dbgFile << "G -> " << info.channelMap["G"];
+public:
+    typedef typename WrapperType::channel_type channel_type;
+    typedef typename WrapperType::pixel_type pixel_type;
 
-    bool hasAlpha = info.channelMap.contains("A");
-    dbgFile << "Has Alpha:" << hasAlpha;
+    /**
+     * \p channelNames are the keys of the channel map in the order
+     * of the channels of pixel_type
+     */
+    DecoderImpl(EXRConverter::Private *d, const ExrPaintLayerInfo *info, KisPaintLayerSP layer,
+                const QStringList &channelNames, int width, int xstart, Imf::PixelType ptype)
+        : m_d(d),
+          m_info(info),
+          m_layer(layer),
+          m_channelNames(channelNames),
+          m_width(width),
+          m_xstart(xstart),
+          m_ptype(ptype),
+          m_pixels(width * exrBandHeight)
+    {
+    }
 
+    void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) override
+    {
+        char *frameBufferData = reinterpret_cast<char*>(m_pixels.data() - m_xstart - ystart * m_width);
 
-    Imf::FrameBuffer frameBuffer;
-    pixel_type* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->gray,
-                       sizeof(pixel_type) * 1,
-                       sizeof(pixel_type) * width));
+        for (int k = 0; k < m_channelNames.size(); ++k) {
+            if (!m_info->channelMap.contains(m_channelNames[k])) continue;
 
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->alpha,
-                           sizeof(pixel_type) * 1,
-                           sizeof(pixel_type) * width));
+            frameBuffer->insert(m_info->channelMap[m_channelNames[k]].toLatin1().constData(),
+                    Imf::Slice(m_ptype, frameBufferData + k * sizeof(channel_type),
+                               sizeof(pixel_type) * 1,
+                               sizeof(pixel_type) * m_width));
+        }
     }
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
-
-    pixel_type *srcPtr = pixels.data();
+    void decodeData(int ystart, int numLines) override
+    {
+        const bool hasAlpha = m_info->channelMap.contains("A");
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+        pixel_type *pixel = m_pixels.data();
+        for (int i = 0; i < m_width * numLines; ++i, ++pixel) {
+            if (hasAlpha) {
+                m_d->unmultiplyAlpha<WrapperType>(pixel);
+            } else {
+                WrapperType(*pixel).setAlpha(channel_type(1.0));
+            }
         }
 
-        pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
+        m_layer->paintDevice()->writeBytes(reinterpret_cast<const quint8*>(m_pixels.constData()),
+                                           QRect(m_xstart, ystart, m_width, numLines));
+    }
 
-        dstPtr->gray = srcPtr->gray;
-        dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+private:
+    EXRConverter::Private *m_d;
+    const ExrPaintLayerInfo *m_info;
+    KisPaintLayerSP m_layer;
+    QStringList m_channelNames;
+    int m_width;
+    int m_xstart;
+    Imf::PixelType m_ptype;
+    QVector<pixel_type> m_pixels;
+};
 
-        ++srcPtr;
-    } ;
+EXRConverter::Private::Decoder* EXRConverter::Private::decoder(const ExrPaintLayerInfo &info, KisPaintLayerSP layer, int width, int xstart)
+{
+    switch (info.channelMap.size()) {
+    case 1:
+    case 2: {
+        KIS_ASSERT_RECOVER_RETURN_VALUE(
+                    layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID, 0);
+
+        Q_ASSERT(info.channelMap.contains("G"));
+        dbgFile << "G -> " << info.channelMap["G"];
+
+        const QStringList channelNames = QStringList() << "G" << "A";
+
+        switch (info.imageType) {
+        case IT_FLOAT16:
+            return new DecoderImpl<GrayPixelWrapper<half> >(this, &info, layer, channelNames, width, xstart, Imf::HALF);
+        case IT_FLOAT32:
+            return new DecoderImpl<GrayPixelWrapper<float> >(this, &info, layer, channelNames, width, xstart, Imf::FLOAT);
+        case IT_UNKNOWN:
+        case IT_UNSUPPORTED:
+            qFatal("Impossible error");
+        }
+        break;
+    }
+    case 3:
+    case 4: {
+        const QStringList channelNames = QStringList() << "R" << "G" << "B" << "A";
+
+        switch (info.imageType) {
+        case IT_FLOAT16:
+            return new DecoderImpl<RgbPixelWrapper<half> >(this, &info, layer, channelNames, width, xstart, Imf::HALF);
+        case IT_FLOAT32:
+            return new DecoderImpl<RgbPixelWrapper<float> >(this, &info, layer, channelNames, width, xstart, Imf::FLOAT);
+        case IT_UNKNOWN:
+        case IT_UNSUPPORTED:
+            qFatal("Impossible error");
+        }
+        break;
+    }
+    default:
+        qFatal("Invalid number of channels: %i", info.channelMap.size());
+    }
+    return 0;
 }
 
 bool recCheckGroup(const ExrGroupLayerInfo& group, QStringList list, int idx1, int idx2)
@@ -820,7 +852,9 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
             d->image->addNode(info.groupLayer, groupLayerParent);
         }
 
-        // Load the layers
+        // Create the layers
+        QVector<QSharedPointer<Private::Decoder> > decoders;
+
         for (int i = informationObjects.size() - 1; i >= 0; --i) {
             ExrPaintLayerInfo& info = informationObjects[i];
             if (info.colorSpace) {
@@ -833,40 +867,11 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
 
                 layer->setCompositeOpId(COMPOSITE_OVER);
 
-                switch (info.channelMap.size()) {
-                case 1:
-                case 2:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData1<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData1<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
-                    break;
-                case 3:
-                case 4:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData4<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData4<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
-                    break;
-                default:
-                    qFatal("Invalid number of channels: %i", info.channelMap.size());
+                Private::Decoder *decoder = d->decoder(info, layer, width, dx);
+                if (decoder) {
+                    decoders.append(QSharedPointer<Private::Decoder>(decoder));
                 }
+
                 // Check if should set the channels
                 if (!info.remappedChannels.isEmpty()) {
                     QList<KisMetaData::Value> values;
@@ -886,6 +891,23 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
             }
         }
 
+        // Decode the layers. All the layers are read at once, so that
+        // every block of the file is decompressed only once.
+        for (int y = dy; y < dy + height; y += exrBandHeight) {
+            const int numLines = qMin(exrBandHeight, dy + height - y);
+
+            Imf::FrameBuffer frameBuffer;
+            Q_FOREACH (QSharedPointer<Private::Decoder> decoder, decoders) {
+                decoder->prepareFrameBuffer(&frameBuffer, y);
+            }
+            file.setFrameBuffer(frameBuffer);
+            file.readPixels(y, y + numLines - 1);
+
+            Q_FOREACH (QSharedPointer<Private::Decoder> decoder, decoders) {
+                decoder->decodeData(y, numLines);
+            }
+        }
+
         // After reading the image, notify the user about changed alpha.
         if (d->alphaWasModified) {
             QString msg =
@@ -951,7 +973,7 @@ class Encoder
 public:
     virtual ~Encoder() {}
     virtual void prepareFrameBuffer(Imf::FrameBuffer*, int line) = 0;
-    virtual void encodeData(int line) = 0;
+    virtual void encodeData(int line, int numLines) = 0;
 
 };
 
@@ -959,10 +981,10 @@ template<typename _T_, int size, int alphaPos>
 class EncoderImpl : public Encoder
 {
 public:
-    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width) : file(_file), info(_info), pixels(width), m_width(width) {}
+    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width) : file(_file), info(_info), pixels(width * exrBandHeight), m_width(width) {}
     ~EncoderImpl() override {}
     void prepareFrameBuffer(Imf::FrameBuffer*, int line) override;
-    void encodeData(int line) override;
+    void encodeData(int line, int numLines) override;
 private:
     typedef ExrPixel_<_T_, size> ExrPixel;
     Imf::OutputFile* file;
@@ -986,54 +1008,48 @@ void EncoderImpl<_T_, size, alphaPos>::prepareFrameBuffer(Imf::FrameBuffer* fram
 }
 
 template<typename _T_, int size, int alphaPos>
-void EncoderImpl<_T_, size, alphaPos>::encodeData(int line)
+void EncoderImpl<_T_, size, alphaPos>::encodeData(int line, int numLines)
 {
-    ExrPixel *rgba = pixels.data();
-    KisHLineConstIteratorSP it = info->layerDevice->createHLineConstIteratorNG(0, line, m_width);
-    do {
-        const _T_* dst = reinterpret_cast < const _T_* >(it->oldRawData());
+    // the pixels of the float color spaces have the layout of ExrPixel
+    info->layerReader->readBytes(reinterpret_cast<quint8*>(pixels.data()), QRect(0, line, m_width, numLines));
 
-        for (int i = 0; i < size; ++i) {
-            rgba->data[i] = dst[i];
-        }
-
-        if (alphaPos != -1) {
+    if (alphaPos != -1) {
+        ExrPixel *rgba = pixels.data();
+        for (int i = 0; i < m_width * numLines; ++i, ++rgba) {
             multiplyAlpha<_T_, ExrPixel, size, alphaPos>(rgba);
         }
-
-        ++rgba;
-    } while (it->nextPixel());
+    }
 }
 
 Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int width)
 {
-    dbgFile << "Create encoder for" << info.name << info.channels << info.layerDevice->colorSpace()->channelCount();
-    switch (info.layerDevice->colorSpace()->channelCount()) {
+    dbgFile << "Create encoder for" << info.name << info.channels << info.layerReader->colorSpace()->channelCount();
+    switch (info.layerReader->colorSpace()->channelCount()) {
     case 1: {
-        if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+        if (info.layerReader->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
             return new EncoderImpl < half, 1, -1 > (&file, &info, width);
-        } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+        } else if (info.layerReader->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
             return new EncoderImpl < float, 1, -1 > (&file, &info, width);
         }
         break;
     }
     case 2: {
-        if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+        if (info.layerReader->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
             return new EncoderImpl<half, 2, 1>(&file, &info, width);
-        } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+        } else if (info.layerReader->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
             return new EncoderImpl<float, 2, 1>(&file, &info, width);
         }
         break;
     }
     case 4: {
-        if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+        if (info.layerReader->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
             return new EncoderImpl<half, 4, 3>(&file, &info, width);
-        } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+        } else if (info.layerReader->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
             return new EncoderImpl<float, 4, 3>(&file, &info, width);
         }
@@ -1052,21 +1068,23 @@ void encodeData(Imf::OutputFile& file, const QList<ExrPaintLayerSaveInfo>& infor
         encoders.push_back(encoder(file, info, width));
     }
 
-    for (int y = 0; y < height; ++y) {
+    for (int y = 0; y < height; y += exrBandHeight) {
+        const int numLines = qMin(exrBandHeight, height - y);
+
         Imf::FrameBuffer frameBuffer;
         Q_FOREACH (Encoder* encoder, encoders) {
             encoder->prepareFrameBuffer(&frameBuffer, y);
         }
         file.setFrameBuffer(frameBuffer);
         Q_FOREACH (Encoder* encoder, encoders) {
-            encoder->encodeData(y);
+            encoder->encodeData(y, numLines);
         }
-        file.writePixels(1);
+        file.writePixels(numLines);
     }
     qDeleteAll(encoders);
 }
 
-KisPaintDeviceSP wrapLayerDevice(KisPaintDeviceSP device)
+QSharedPointer<KisConvertedBandReader> createLayerReader(KisPaintDeviceSP device)
 {
     const KoColorSpace *cs = device->colorSpace();
 
@@ -1082,12 +1100,8 @@ KisPaintDeviceSP wrapLayerDevice(KisPaintDeviceSP device)
             cs->colorDepthId().id());
     }
 
-    if (*cs != *device->colorSpace()) {
-        device = new KisPaintDevice(*device);
-        device->convertTo(cs);
-    }
-
-    return device;
+    // the pixels are converted band by band while encoding
+    return QSharedPointer<KisConvertedBandReader>(new KisConvertedBandReader(device, cs));
 }
 
 KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisPaintLayerSP layer)
@@ -1105,12 +1119,12 @@ KisImportExportErrorCode EXRConverter::buildFile(const QString &filename, KisPai
 
     ExrPaintLayerSaveInfo info;
     info.layer = layer;
-    info.layerDevice = wrapLayerDevice(layer->paintDevice());
+    info.layerReader = createLayerReader(layer->paintDevice());
     Imf::PixelType pixelType = Imf::NUM_PIXELTYPES;
-    if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+    if (info.layerReader->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
         pixelType = Imf::HALF;
     }
-    else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+    else if (info.layerReader->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
         pixelType = Imf::FLOAT;
     }
     header.channels().insert("R", Imf::Channel(pixelType));
@@ -1221,7 +1235,7 @@ void EXRConverter::Private::recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveIn
             ExrPaintLayerSaveInfo info;
             info.name = name + paintLayer->name() + '.';
             info.layer = paintLayer;
-            info.layerDevice = wrapLayerDevice(paintLayer->paintDevice());
+            info.layerReader = createLayerReader(paintLayer->paintDevice());
 
             if (info.name == QString(HDR_LAYER) + ".") {
                 info.channels.push_back("R");
@@ -1231,20 +1245,20 @@ void EXRConverter::Private::recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveIn
             }
             else {
 
-                if (info.layerDevice->colorSpace()->colorModelId() == RGBAColorModelID) {
+                if (info.layerReader->colorSpace()->colorModelId() == RGBAColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "R"));
                     info.channels.push_back(info.name + remap(current2original, "G"));
                     info.channels.push_back(info.name + remap(current2original, "B"));
                     info.channels.push_back(info.name + remap(current2original, "A"));
                 }
-                else if (info.layerDevice->colorSpace()->colorModelId() == GrayAColorModelID) {
+                else if (info.layerReader->colorSpace()->colorModelId() == GrayAColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "G"));
                     info.channels.push_back(info.name + remap(current2original, "A"));
                 }
-                else if (info.layerDevice->colorSpace()->colorModelId() == GrayColorModelID) {
+                else if (info.layerReader->colorSpace()->colorModelId() == GrayColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "G"));
                 }
-                else if (info.layerDevice->colorSpace()->colorModelId() == XYZAColorModelID) {
+                else if (info.layerReader->colorSpace()->colorModelId() == XYZAColorModelID) {
                     info.channels.push_back(info.name + remap(current2original, "X"));
                     info.channels.push_back(info.name + remap(current2original, "Y"));
                     info.channels.push_back(info.name + remap(current2original, "Z"));
@@ -1253,10 +1267,10 @@ void EXRConverter::Private::recBuildPaintLayerSaveInfo(QList<ExrPaintLayerSaveIn
 
             }
 
-            if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
+            if (info.layerReader->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
                 info.pixelType = Imf::HALF;
             }
-            else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
+            else if (info.layerReader->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
                 info.pixelType = Imf::FLOAT;
             }
             else {
@@ -33,6 +33,7 @@ extern "C" {
 
 #include <QFile>
 #include <QBuffer>
+#include <QVector>
 #include <QApplication>
 
 #include <klocalizedstring.h>
@@ -57,16 +58,22 @@ extern "C" {
 #include <kis_meta_data_store.h>
 #include <kis_meta_data_io_backend.h>
 #include <kis_paint_device.h>
+#include <KisConvertedBandReader.h>
 #include <kis_transform_worker.h>
 #include <kis_jpeg_source.h>
 #include <kis_jpeg_destination.h>
-#include "kis_iterator_ng.h"
 
 #define ICC_MARKER  (JPEG_APP0 + 2) /* JPEG marker code for ICC */
 #define ICC_OVERHEAD_LEN  14    /* size of non-profile data in APP2 */
 #define MAX_BYTES_IN_MARKER  65533  /* maximum data len of a JPEG marker */
 #define MAX_DATA_BYTES_IN_MARKER  (MAX_BYTES_IN_MARKER - ICC_OVERHEAD_LEN)
 
+/**
+ * The number of scanlines transferred between libjpeg and the paint
+ * device at once
+ */
+const int jpegBandHeight = 64;
+
 const char photoshopMarker[] = "Photoshop 3.0\0";
 //const char photoshopBimId_[] = "8BIM";
 const uint16_t photoshopIptc = 0x0404;
@@ -160,11 +167,23 @@ KisImportExportErrorCode KisJPEGConverter::decode(QIODevice *io)
         // read header
         jpeg_read_header(&cinfo, (boolean)true);
 
+        // Get the colorspace
+        QString modelId = getColorSpaceModelForColorType(cinfo.out_color_space);
+
+#ifdef JCS_ALPHA_EXTENSIONS
+        /**
+         * libjpeg-turbo can convert the pixels straight into the BGRA
+         * layout of RGBA8 with its SIMD routines, the alpha channel is
+         * filled with opaque values
+         */
+        if (cinfo.out_color_space == JCS_RGB) {
+            cinfo.out_color_space = JCS_EXT_BGRA;
+        }
+#endif
+
         // start reading
         jpeg_start_decompress(&cinfo);
 
-        // Get the colorspace
-        QString modelId = getColorSpaceModelForColorType(cinfo.out_color_space);
         if (modelId.isEmpty()) {
             dbgFile << "unsupported colorspace :" << cinfo.out_color_space;
             jpeg_destroy_decompress(&cinfo);
@@ -255,48 +274,64 @@ KisImportExportErrorCode KisJPEGConverter::decode(QIODevice *io)
         KisPaintLayerSP layer = KisPaintLayerSP(new KisPaintLayer(m_d->image.data(), m_d->image -> nextLayerName(), quint8_MAX));
 
         // Read data
-        JSAMPROW row_pointer = new JSAMPLE[cinfo.image_width*cinfo.num_components];
+        const int width = cinfo.image_width;
+        const int pixelSize = cs->pixelSize();
+        QVector<quint8> band(width * jpegBandHeight * pixelSize);
+        QVector<JSAMPLE> row(width * cinfo.output_components);
+
+        while (cinfo.output_scanline < cinfo.image_height) {
+            const int y = cinfo.output_scanline;
+            const int numRows = qMin(jpegBandHeight, int(cinfo.image_height) - y);
+
+            for (int i = 0; i < numRows; i++) {
+                quint8 *d = band.data() + i * width * pixelSize;
+
+#ifdef JCS_ALPHA_EXTENSIONS
+                if (cinfo.out_color_space == JCS_EXT_BGRA) {
+                    JSAMPROW row_pointer = d;
+                    jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+                    continue;
+                }
+#endif
 
-        for (; cinfo.output_scanline < cinfo.image_height;) {
-            KisHLineIteratorSP it = layer->paintDevice()->createHLineIteratorNG(0, cinfo.output_scanline, cinfo.image_width);
-            jpeg_read_scanlines(&cinfo, &row_pointer, 1);
-            quint8 *src = row_pointer;
-            switch (cinfo.out_color_space) {
-            case JCS_GRAYSCALE:
-                do {
-                    quint8 *d = it->rawData();
-                    d[0] = *(src++);
-                    if (transform) transform->transform(d, d, 1);
-                    d[1] = quint8_MAX;
+                JSAMPROW row_pointer = row.data();
+                jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+                const quint8 *src = row.constData();
 
-                } while (it->nextPixel());
-                break;
-            case JCS_RGB:
-                do {
-                    quint8 *d = it->rawData();
-                    d[2] = *(src++);
-                    d[1] = *(src++);
-                    d[0] = *(src++);
-                    if (transform) transform->transform(d, d, 1);
-                    d[3] = quint8_MAX;
-
-                } while (it->nextPixel());
-                break;
-            case JCS_CMYK:
-                do {
-                    quint8 *d = it->rawData();
-                    d[0] = quint8_MAX - *(src++);
-                    d[1] = quint8_MAX - *(src++);
-                    d[2] = quint8_MAX - *(src++);
-                    d[3] = quint8_MAX - *(src++);
-                    if (transform) transform->transform(d, d, 1);
-                    d[4] = quint8_MAX;
-
-                } while (it->nextPixel());
-                break;
-            default:
-                return ImportExportCodes::FormatFeaturesUnsupported;
+                switch (cinfo.out_color_space) {
+                case JCS_GRAYSCALE:
+                    for (int x = 0; x < width; x++, d += 2) {
+                        d[0] = *(src++);
+                        d[1] = quint8_MAX;
+                    }
+                    break;
+                case JCS_RGB:
+                    for (int x = 0; x < width; x++, d += 4) {
+                        d[2] = *(src++);
+                        d[1] = *(src++);
+                        d[0] = *(src++);
+                        d[3] = quint8_MAX;
+                    }
+                    break;
+                case JCS_CMYK:
+                    for (int x = 0; x < width; x++, d += 5) {
+                        d[0] = quint8_MAX - *(src++);
+                        d[1] = quint8_MAX - *(src++);
+                        d[2] = quint8_MAX - *(src++);
+                        d[3] = quint8_MAX - *(src++);
+                        d[4] = quint8_MAX;
+                    }
+                    break;
+                default:
+                    return ImportExportCodes::FormatFeaturesUnsupported;
+                }
+            }
+
+            if (transform) {
+                transform->transform(band.constData(), band.data(), width * numRows);
             }
+
+            layer->paintDevice()->writeBytes(band.constData(), QRect(0, y, width, numRows));
         }
 
         m_d->image->addNode(KisNodeSP(layer.data()), m_d->image->rootLayer().data());
@@ -433,7 +468,6 @@ KisImportExportErrorCode KisJPEGConverter::decode(QIODevice *io)
         // Finish decompression
         jpeg_finish_decompress(&cinfo);
         jpeg_destroy_decompress(&cinfo);
-        delete [] row_pointer;
         return ImportExportCodes::OK;
     }
     catch( std::runtime_error &e) {
@@ -467,18 +501,23 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
     J_COLOR_SPACE color_type = getColorTypeforColorSpace(cs);
 
     if (color_type == JCS_UNKNOWN) {
-        layer->paintDevice()->convertTo(KoColorSpaceRegistry::instance()->rgb8(), KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
         cs = KoColorSpaceRegistry::instance()->rgb8();
         color_type = JCS_RGB;
     }
 
     if (options.forceSRGB) {
-        const KoColorSpace* dst = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), layer->colorSpace()->colorDepthId().id(), "sRGB built-in - (lcms internal)");
-        layer->paintDevice()->convertTo(dst);
-        cs = dst;
+        cs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), cs->colorDepthId().id(), "sRGB built-in - (lcms internal)");
         color_type = JCS_RGB;
     }
 
+    /**
+     * JPEG has no alpha channel, so the pixels are flattened over the
+     * transparency fill color and converted into the color space of
+     * the file band by band, while writing the scanlines
+     */
+    KisConvertedBandReader reader(layer->paintDevice(), cs);
+    reader.setBackgroundColor(KoColor(options.transparencyFillColor, layer->colorSpace()));
+
     uint height = image->height();
     uint width = image->width();
     // Initialize structure
@@ -500,6 +539,14 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
         cinfo.input_components = cs->colorChannelCount(); // number of color channels per pixel */
         cinfo.in_color_space = color_type;   // colorspace of input image
 
+#ifdef JCS_ALPHA_EXTENSIONS
+        // libjpeg-turbo can read the BGRA pixels of RGBA8 directly, ignoring the alpha channel
+        if (color_type == JCS_RGB && cs->id() == "RGBA") {
+            cinfo.input_components = 4;
+            cinfo.in_color_space = JCS_EXT_BGRA;
+        }
+#endif
+
         // Set default compression parameters
         jpeg_set_defaults(&cinfo);
         // Customize them
@@ -623,100 +670,99 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
         }
 
 
-        KisPaintDeviceSP dev = new KisPaintDevice(layer->colorSpace());
-        KoColor c(options.transparencyFillColor, layer->colorSpace());
-        dev->fill(QRect(0, 0, width, height), c);
-        KisPainter gc(dev);
-        gc.bitBlt(QPoint(0, 0), layer->paintDevice(), QRect(0, 0, width, height));
-        gc.end();
-
-
         if (options.saveProfile) {
-            const KoColorProfile* colorProfile = layer->colorSpace()->profile();
+            const KoColorProfile* colorProfile = cs->profile();
             QByteArray colorProfileData = colorProfile->rawData();
             write_icc_profile(& cinfo, (uchar*) colorProfileData.data(), colorProfileData.size());
         }
 
         // Write data information
 
-        JSAMPROW row_pointer = new JSAMPLE[width*cinfo.input_components];
-        int color_nb_bits = 8 * layer->paintDevice()->pixelSize() / layer->paintDevice()->channelCount();
+        const int pixelSize = cs->pixelSize();
+        QVector<quint8> band(width * jpegBandHeight * pixelSize);
+        QVector<JSAMPLE> rows(width * jpegBandHeight * cinfo.input_components);
+        QVector<JSAMPROW> rowPointers(jpegBandHeight);
+        int color_nb_bits = 8 * cs->pixelSize() / cs->channelCount();
+
+        while (cinfo.next_scanline < height) {
+            const int y = cinfo.next_scanline;
+            const int numRows = qMin(jpegBandHeight, int(height) - y);
+
+            reader.readBytes(band.data(), QRect(0, y, width, numRows));
+
+#ifdef JCS_ALPHA_EXTENSIONS
+            if (cinfo.in_color_space == JCS_EXT_BGRA) {
+                for (int i = 0; i < numRows; i++) {
+                    rowPointers[i] = band.data() + i * width * pixelSize;
+                }
+                jpeg_write_scanlines(&cinfo, rowPointers.data(), numRows);
+                continue;
+            }
+#endif
+
+            const quint8 *d = band.constData();
+            quint8 *dst = rows.data();
+            const int numPixels = width * numRows;
 
-        for (; cinfo.next_scanline < height;) {
-            KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(0, cinfo.next_scanline, width);
-            quint8 *dst = row_pointer;
             switch (color_type) {
             case JCS_GRAYSCALE:
                 if (color_nb_bits == 16) {
-                    do {
-                        //const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                        const quint8 *d = it->oldRawData();
-                        *(dst++) = cs->scaleToU8(d, 0);//d[0] / quint8_MAX;
-
-                    } while (it->nextPixel());
+                    for (int i = 0; i < numPixels; i++, d += pixelSize) {
+                        *(dst++) = cs->scaleToU8(d, 0);
+                    }
                 } else {
-                    do {
-                        const quint8 *d = it->oldRawData();
+                    for (int i = 0; i < numPixels; i++, d += pixelSize) {
                         *(dst++) = d[0];
-
-                    } while (it->nextPixel());
+                    }
                 }
                 break;
             case JCS_RGB:
                 if (color_nb_bits == 16) {
-                    do {
-                        //const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                        const quint8 *d = it->oldRawData();
-                        *(dst++) = cs->scaleToU8(d, 2); //d[2] / quint8_MAX;
-                        *(dst++) = cs->scaleToU8(d, 1); //d[1] / quint8_MAX;
-                        *(dst++) = cs->scaleToU8(d, 0); //d[0] / quint8_MAX;
-
-                    } while (it->nextPixel());
+                    for (int i = 0; i < numPixels; i++, d += pixelSize) {
+                        *(dst++) = cs->scaleToU8(d, 2);
+                        *(dst++) = cs->scaleToU8(d, 1);
+                        *(dst++) = cs->scaleToU8(d, 0);
+                    }
                 } else {
-                    do {
-                        const quint8 *d = it->oldRawData();
+                    for (int i = 0; i < numPixels; i++, d += pixelSize) {
                         *(dst++) = d[2];
                         *(dst++) = d[1];
                         *(dst++) = d[0];
-
-                    } while (it->nextPixel());
+                    }
                 }
                 break;
             case JCS_CMYK:
                 if (color_nb_bits == 16) {
-                    do {
-                        //const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                        const quint8 *d = it->oldRawData();
-                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 0);//quint8_MAX - d[0] / quint8_MAX;
-                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 1);//quint8_MAX - d[1] / quint8_MAX;
-                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 2);//quint8_MAX - d[2] / quint8_MAX;
-                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 3);//quint8_MAX - d[3] / quint8_MAX;
-
-                    } while (it->nextPixel());
+                    for (int i = 0; i < numPixels; i++, d += pixelSize) {
+                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 0);
+                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 1);
+                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 2);
+                        *(dst++) = quint8_MAX - cs->scaleToU8(d, 3);
+                    }
                 } else {
-                    do {
-                        const quint8 *d = it->oldRawData();
+                    for (int i = 0; i < numPixels; i++, d += pixelSize) {
                         *(dst++) = quint8_MAX - d[0];
                         *(dst++) = quint8_MAX - d[1];
                         *(dst++) = quint8_MAX - d[2];
                         *(dst++) = quint8_MAX - d[3];
-
-                    } while (it->nextPixel());
+                    }
                 }
                 break;
             default:
-                delete [] row_pointer;
                 jpeg_destroy_compress(&cinfo);
                 return ImportExportCodes::FormatFeaturesUnsupported;
             }
-            jpeg_write_scanlines(&cinfo, &row_pointer, 1);
+
+            for (int i = 0; i < numRows; i++) {
+                rowPointers[i] = rows.data() + i * width * cinfo.input_components;
+            }
+            jpeg_write_scanlines(&cinfo, rowPointers.data(), numRows);
         }
 
 
         // Writing is over
         jpeg_finish_compress(&cinfo);
 
-        delete [] row_pointer;
         // Free memory
         jpeg_destroy_compress(&cinfo);
 
@@ -14,6 +14,7 @@
 
 #include <QRect>
 #include <QBuffer>
+#include <QtConcurrent>
 #include <QByteArray>
 #include <QMessageBox>
 #include <QApplication>
@@ -58,6 +59,7 @@
 #include "kis_paint_device_frames_interface.h"
 #include "kis_filter_registry.h"
 #include "kis_generator_registry.h"
+#include "kis_image_config.h"
 
 
 using namespace KRA;
@@ -120,6 +122,11 @@ KisKraLoadVisitor::KisKraLoadVisitor(KisImageSP image,
     m_syntaxVersion = syntaxVersion;
 }
 
+KisKraLoadVisitor::~KisKraLoadVisitor()
+{
+    waitForPendingReads();
+}
+
 void KisKraLoadVisitor::setExternalUri(const QString &uri)
 {
     m_external = true;
@@ -185,10 +192,16 @@ bool KisKraLoadVisitor::visit(KisPaintLayer *layer)
 {
     loadNodeKeyframes(layer);
 
-    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer))) {
+    /**
+     * The profile is assigned before the pixel data is read, because
+     * the pixel data is decompressed on the worker threads and the
+     * profile doesn't change the layout of the pixels
+     */
+    if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
         return false;
     }
-    if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
+    // the hidden layers are not needed to show the image
+    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer), !layer->visible(), true)) {
         return false;
     }
     if (!loadMetaData(layer)) {
@@ -511,22 +524,28 @@ QStringList KisKraLoadVisitor::warningMessages() const
 
 struct SimpleDevicePolicy
 {
+    SimpleDevicePolicy(bool keepCompressed)
+        : m_keepCompressed(keepCompressed) {}
+
     bool read(KisPaintDeviceSP dev, QIODevice *stream) {
-        return dev->read(stream);
+        return dev->read(stream, m_keepCompressed);
     }
 
     void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
         return dev->setDefaultPixel(defaultPixel);
     }
+
+    bool m_keepCompressed;
 };
 
 struct FramedDevicePolicy
 {
-    FramedDevicePolicy(int frameId)
-        :  m_frameId(frameId) {}
+    FramedDevicePolicy(int frameId, bool keepCompressed)
+        :  m_frameId(frameId),
+           m_keepCompressed(keepCompressed) {}
 
     bool read(KisPaintDeviceSP dev, QIODevice *stream) {
-        return dev->framesInterface()->readFrame(stream, m_frameId);
+        return dev->framesInterface()->readFrame(stream, m_frameId, m_keepCompressed);
     }
 
     void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
@@ -534,10 +553,13 @@ struct FramedDevicePolicy
     }
 
     int m_frameId;
+    bool m_keepCompressed;
 };
 
-bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location)
+bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool keepCompressed, bool readInParallel)
 {
+    const bool lazyLoading = KisImageConfig(true).lazyLoadHiddenLayers();
+
     // Layer data
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
     QList<int> frames;
@@ -547,13 +569,18 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
     }
 
     if (!frameInterface || frames.count() <= 1) {
-        return loadPaintDeviceFrame(device, location, SimpleDevicePolicy());
+        return loadPaintDeviceFrame(device, location, SimpleDevicePolicy(lazyLoading && keepCompressed), readInParallel);
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
 
+        QList<int> frameCopies;
+
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
-            if (keyframeChannel->frameFilename(id).isEmpty()) {
+            if (keyframeChannel->frameCopySource(id) >= 0) {
+                frameCopies << id;
+            }
+            else if (keyframeChannel->frameFilename(id).isEmpty()) {
                 m_warningMessages << i18n("Could not find keyframe pixel data for frame %1 in %2.", id, location);
             }
             else {
@@ -561,18 +588,30 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
                 QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
                 Q_ASSERT(!frameFilename.isEmpty());
 
-                if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
+                const bool keepFrameCompressed =
+                    lazyLoading && (keepCompressed || id != frameInterface->currentFrameId());
+
+                if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id, keepFrameCompressed), readInParallel)) {
                     m_warningMessages << i18n("Could not load keyframe pixel data for frame %1 in %2.", id, location);
                 }
             }
         }
+
+        if (!frameCopies.isEmpty()) {
+            waitForPendingReads(device);
+        }
+
+        // the copies share the tiles with their source frames until changed
+        Q_FOREACH (int id, frameCopies) {
+            frameInterface->uploadFrame(keyframeChannel->frameCopySource(id), id, device);
+        }
     }
 
     return true;
 }
 
 template<class DevicePolicy>
-bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy)
+bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy, bool readInParallel)
 {
     {
         const int pixelSize = device->colorSpace()->pixelSize();
@@ -590,6 +629,36 @@ bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QStr
     }
 
     if (m_store->open(location)) {
+        if (readInParallel) {
+            /**
+             * The store can be read only sequentially, so the entry is
+             * fetched here and only its decompression is moved to the
+             * worker threads
+             */
+            const QByteArray data = m_store->read(m_store->size());
+            m_store->close();
+
+            PendingRead pending;
+            pending.location = location;
+            pending.device = device;
+            pending.result = QtConcurrent::run(&m_decompressionPool,
+                [device, data, policy] () mutable {
+                    QByteArray buffer = data;
+                    QBuffer stream(&buffer);
+                    stream.open(QIODevice::ReadOnly);
+                    return policy.read(device, &stream);
+                });
+
+            m_pendingReads.append(pending);
+
+            // don't keep too many compressed entries in memory
+            while (m_pendingReads.size() > 2 * m_decompressionPool.maxThreadCount()) {
+                finishFirstPendingRead();
+            }
+
+            return true;
+        }
+
         if (!policy.read(device, m_store->device())) {
             m_warningMessages << i18n("Could not read pixel data: %1.", location);
             device->disconnect();
@@ -605,6 +674,38 @@ bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QStr
     return true;
 }
 
+void KisKraLoadVisitor::finishFirstPendingRead()
+{
+    PendingRead pending = m_pendingReads.takeFirst();
+
+    if (!pending.result.result()) {
+        m_warningMessages << i18n("Could not read pixel data: %1.", pending.location);
+        pending.device->disconnect();
+    }
+}
+
+void KisKraLoadVisitor::waitForPendingReads(KisPaintDeviceSP device)
+{
+    for (auto it = m_pendingReads.begin(); it != m_pendingReads.end();) {
+        if (it->device == device) {
+            if (!it->result.result()) {
+                m_warningMessages << i18n("Could not read pixel data: %1.", it->location);
+                device->disconnect();
+            }
+            it = m_pendingReads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KisKraLoadVisitor::waitForPendingReads()
+{
+    while (!m_pendingReads.isEmpty()) {
+        finishFirstPendingRead();
+    }
+}
+
 
 bool KisKraLoadVisitor::loadProfile(KisPaintDeviceSP device, const QString& location)
 {
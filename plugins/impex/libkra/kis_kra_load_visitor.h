@@ -10,6 +10,8 @@
 
 #include <QRect>
 #include <QStringList>
+#include <QThreadPool>
+#include <QFuture>
 
 // kritaimage
 #include "kis_types.h"
@@ -35,10 +37,20 @@ public:
                       QMap<KisNode *, QString> &keyframeFilenames,
                       const QString & name,
                       int syntaxVersion);
+    ~KisKraLoadVisitor() override;
 
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * The pixel data of the paint layers is decompressed on worker
+     * threads while the visitor reads the next entries of the store.
+     * Waits until all the pixel data is read into the devices. Should
+     * be called after the visit, before using the loaded layers or
+     * fetching the warning messages.
+     */
+    void waitForPendingReads();
+
     bool visit(KisNode*) override {
         return true;
     }
@@ -59,10 +71,19 @@ public:
 
 private:
 
-    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location);
+    /**
+     * If \p keepCompressed is true, the pixel data of the device is kept
+     * compressed in the swap until accessed, see KisPaintDevice::read().
+     * The frames of animated devices other than the current one are
+     * always kept compressed if the lazy loading is enabled.
+     */
+    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool keepCompressed = false, bool readInParallel = false);
 
     template<class DevicePolicy>
-    bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy);
+    bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy, bool readInParallel);
+
+    void waitForPendingReads(KisPaintDeviceSP device);
+    void finishFirstPendingRead();
 
     bool loadProfile(KisPaintDeviceSP device,  const QString& location);
     bool loadFilterConfiguration(KisFilterConfigurationSP kfc, const QString& location);
@@ -96,6 +117,15 @@ private:
     QStringList m_warningMessages;
     KoShapeControllerBase *m_shapeController;
     QMap<QByteArray, const KoColorProfile *> m_profileCache;
+
+    struct PendingRead {
+        QString location;
+        KisPaintDeviceSP device;
+        QFuture<bool> result;
+    };
+
+    QThreadPool m_decompressionPool;
+    QList<PendingRead> m_pendingReads;
 };
 
 #endif // KIS_KRA_LOAD_VISITOR_H_
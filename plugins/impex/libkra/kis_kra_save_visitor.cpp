@@ -11,6 +11,8 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <KoColorProfile.h>
 #include <KoStore.h>
@@ -43,7 +45,7 @@
 #include <kis_meta_data_io_backend.h>
 
 #include "kis_config.h"
-#include "kis_store_paintdevice_writer.h"
+#include "kis_paint_device_writer.h"
 #include "flake/kis_shape_selection.h"
 
 #include "kis_raster_keyframe_channel.h"
@@ -57,19 +59,57 @@
 
 using namespace KRA;
 
+namespace {
+
+class KisByteArrayPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    KisByteArrayPaintDeviceWriter(QByteArray *data, KisTileStreamCacheSP cache, bool storeRawTiles)
+        : m_data(data),
+          m_cache(cache),
+          m_storeRawTiles(storeRawTiles)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_data->append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_data->append(data, length);
+        return true;
+    }
+
+    KisTileStreamCache* tileStreamCache() const override {
+        return m_cache.data();
+    }
+
+    bool storeRawTiles() const override {
+        return m_storeRawTiles;
+    }
+
+private:
+    QByteArray *m_data;
+    KisTileStreamCacheSP m_cache;
+    bool m_storeRawTiles;
+};
+
+}
+
 KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<const KisNode*, QString> nodeFileNames)
     : KisNodeVisitor()
     , m_store(store)
     , m_external(false)
     , m_name(name)
     , m_nodeFileNames(nodeFileNames)
-    , m_writer(new KisStorePaintDeviceWriter(store))
 {
 }
 
 KisKraSaveVisitor::~KisKraSaveVisitor()
 {
-    delete m_writer;
+    // the data is useless if nobody has flushed it, just let the workers finish
+    m_compressionPool.waitForDone();
 }
 
 void KisKraSaveVisitor::setExternalUri(const QString &uri)
@@ -78,6 +118,11 @@ void KisKraSaveVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraSaveVisitor::setTileStreamCache(KisTileStreamCacheSP cache)
+{
+    m_tileStreamCache = cache;
+}
+
 bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -337,9 +382,6 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
                                         QString location)
 {
     // Layer data
-    KisConfig cfg(true);
-    m_store->setCompressionEnabled(cfg.compressKra());
-
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
     QList<int> frames;
 
@@ -355,6 +397,9 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
 
+            // the identical frames are stored only once
+            if (keyframeChannel->frameCopySource(id) >= 0) continue;
+
             QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
             Q_ASSERT(!frameFilename.isEmpty());
 
@@ -364,7 +409,6 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
         }
     }
 
-    m_store->setCompressionEnabled(true);
     return true;
 }
 
@@ -372,21 +416,67 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
 template<class DevicePolicy>
 bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy)
 {
-    if (m_store->open(location)) {
-        if (!policy.write(device, *m_writer)) {
-            device->disconnect();
-            m_store->close();
-            return false;
-        }
+    /**
+     * Compressing the tiles is the most expensive part of saving, so it
+     * is done on the worker threads into memory buffers, one device or
+     * frame per job. Only writing the buffers into the store stays
+     * serialized, in the same order the devices are visited.
+     */
+    KisConfig cfg(true);
+
+    const bool fastSave = cfg.fastSaveKra();
+
+    PendingWrite pending;
+    pending.location = location;
+    pending.compressionEnabled = cfg.compressKra() && !fastSave;
+    pending.defaultPixel = QByteArray((char*)policy.defaultPixel(device).data(), device->colorSpace()->pixelSize());
+    pending.device = device;
 
+    KisTileStreamCacheSP cache = m_tileStreamCache;
+    pending.data = QtConcurrent::run(&m_compressionPool,
+        [device, policy, cache, fastSave] () mutable {
+            QByteArray data;
+            KisByteArrayPaintDeviceWriter writer(&data, cache, fastSave);
+            return policy.write(device, writer) ? data : QByteArray();
+        });
+
+    m_pendingWrites.append(pending);
+
+    // keep only a few compressed devices in memory at a time
+    while (m_pendingWrites.size() > 2 * m_compressionPool.maxThreadCount()) {
+        flushFirstPendingWrite();
+    }
+
+    return true;
+}
+
+void KisKraSaveVisitor::flushFirstPendingWrite()
+{
+    PendingWrite pending = m_pendingWrites.takeFirst();
+    const QByteArray data = pending.data.result();
+
+    m_store->setCompressionEnabled(pending.compressionEnabled);
+
+    if (m_store->open(pending.location)) {
+        if (data.isNull() || m_store->write(data) != data.size()) {
+            pending.device->disconnect();
+            m_errorMessages << i18n("Failed to save the pixel data to %1.", pending.location);
+        }
         m_store->close();
     }
-    if (m_store->open(location + ".defaultpixel")) {
-        m_store->write((char*)policy.defaultPixel(device).data(), device->colorSpace()->pixelSize());
+    if (m_store->open(pending.location + ".defaultpixel")) {
+        m_store->write(pending.defaultPixel);
         m_store->close();
     }
 
-    return true;
+    m_store->setCompressionEnabled(true);
+}
+
+void KisKraSaveVisitor::flushPendingWrites()
+{
+    while (!m_pendingWrites.isEmpty()) {
+        flushFirstPendingWrite();
+    }
 }
 
 bool KisKraSaveVisitor::saveAnnotations(KisLayer* layer)
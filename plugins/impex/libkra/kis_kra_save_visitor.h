@@ -10,13 +10,16 @@
 
 #include <QRect>
 #include <QStringList>
+#include <QFuture>
+#include <QThreadPool>
+#include <QList>
 
 #include "kis_types.h"
 #include "kis_node_visitor.h"
 #include "kis_image.h"
+#include "tiles3/KisTileStreamCache.h"
 #include "kritalibkra_export.h"
 
-class KisPaintDeviceWriter;
 class KoStore;
 
 class KRITALIBKRA_EXPORT KisKraSaveVisitor : public KisNodeVisitor
@@ -29,6 +32,12 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * Sets the cache of the tiles compressed by the previous saves
+     * of the document, the unchanged tiles are not compressed again
+     */
+    void setTileStreamCache(KisTileStreamCacheSP cache);
+
     bool visit(KisNode*) override {
         return true;
     }
@@ -58,6 +67,15 @@ public:
     /// @return a list with everything that went wrong while saving
     QStringList errorMessages() const;
 
+    /**
+     * The pixel data of the paint devices is compressed on worker
+     * threads while the nodes are visited. Waits for all the data
+     * still being compressed and writes it into the store. Should be
+     * called after visiting the nodes and before checking
+     * errorMessages().
+     */
+    void flushPendingWrites();
+
 private:
 
     bool savePaintDevice(KisPaintDeviceSP device, QString location);
@@ -73,15 +91,29 @@ private:
     QString getLocation(KisNode* node, const QString& suffix = QString());
     QString getLocation(const QString &filename, const QString &suffix = QString());
 
+    /// writes the oldest pending compressed data into the store
+    void flushFirstPendingWrite();
+
 private:
+    struct PendingWrite {
+        QString location;
+        bool compressionEnabled;
+        QByteArray defaultPixel;
+        KisPaintDeviceSP device;
+        /// null if compressing the data has failed
+        QFuture<QByteArray> data;
+    };
 
     KoStore *m_store;
     bool m_external;
     QString m_uri;
     QString m_name;
     QMap<const KisNode*, QString> m_nodeFileNames;
-    KisPaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
+
+    KisTileStreamCacheSP m_tileStreamCache;
+    QThreadPool m_compressionPool;
+    QList<PendingWrite> m_pendingWrites;
 };
 
 #endif // KIS_KRA_SAVE_VISITOR_H_
@@ -293,7 +293,19 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
     if (external)
         visitor.setExternalUri(uri);
 
+    KisTileStreamCacheSP tileStreamCache = m_d->doc->tileStreamCache();
+    visitor.setTileStreamCache(tileStreamCache);
+
+    if (tileStreamCache) {
+        tileStreamCache->beginSaving();
+    }
+
     image->rootLayer()->accept(visitor);
+    visitor.flushPendingWrites();
+
+    if (tileStreamCache) {
+        tileStreamCache->endSaving();
+    }
 
     m_d->errorMessages.append(visitor.errorMessages());
     if (!m_d->errorMessages.isEmpty()) {
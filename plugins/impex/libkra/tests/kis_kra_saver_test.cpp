@@ -336,6 +336,77 @@ void KisKraSaverTest::testRoundTripAnimation()
 
 }
 
+#include "kis_raster_keyframe_channel.h"
+#include "kis_paint_device_frames_interface.h"
+
+void KisKraSaverTest::testRoundTripDuplicatedFrames()
+{
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    QRect imageRect(0,0,512,512);
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "test image");
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer1);
+
+    layer1->paintDevice()->fill(QRect(100, 100, 50, 50), KoColor(Qt::black, cs));
+
+    layer1->enableAnimation();
+    KisRasterKeyframeChannel *rasterChannel =
+        dynamic_cast<KisRasterKeyframeChannel*>(layer1->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true));
+    QVERIFY(rasterChannel);
+
+    // a hold, a changed copy and an independently drawn identical frame
+    rasterChannel->copyKeyframe(0, 10);
+    rasterChannel->copyKeyframe(0, 20);
+    rasterChannel->addKeyframe(30);
+
+    image->animationInterface()->switchCurrentTimeAsync(20);
+    image->waitForDone();
+    layer1->paintDevice()->fill(QRect(200, 50, 10, 10), KoColor(Qt::black, cs));
+
+    image->animationInterface()->switchCurrentTimeAsync(30);
+    image->waitForDone();
+    layer1->paintDevice()->fill(QRect(100, 100, 50, 50), KoColor(Qt::black, cs));
+
+    doc->setCurrentImage(image);
+    doc->exportDocumentSync(QUrl::fromLocalFile("roundtrip_duplicated_frames.kra"), doc->mimeType());
+
+    auto frameID = [] (KisRasterKeyframeChannel *channel, int time) {
+        return channel->keyframeAt<KisRasterKeyframe>(time)->frameID();
+    };
+
+    QCOMPARE(rasterChannel->frameCopySource(frameID(rasterChannel, 0)), -1);
+    QCOMPARE(rasterChannel->frameCopySource(frameID(rasterChannel, 10)), frameID(rasterChannel, 0));
+    QCOMPARE(rasterChannel->frameCopySource(frameID(rasterChannel, 20)), -1);
+    QCOMPARE(rasterChannel->frameCopySource(frameID(rasterChannel, 30)), frameID(rasterChannel, 0));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->loadNativeFormat("roundtrip_duplicated_frames.kra");
+    KisImageSP image2 = doc2->image();
+    KisPaintLayerSP layer2 = qobject_cast<KisPaintLayer*>(image2->root()->firstChild().data());
+    QVERIFY(layer2);
+
+    KisRasterKeyframeChannel *channel =
+        dynamic_cast<KisRasterKeyframeChannel*>(layer2->getKeyframeChannel(KisKeyframeChannel::Raster.id()));
+    QVERIFY(channel);
+    QCOMPARE(channel->keyframeCount(), 4);
+    QVERIFY(!channel->areClones(0, 10));
+
+    KisPaintDeviceFramesInterface *frames = layer2->paintDevice()->framesInterface();
+    QVERIFY(frames->frameContentEquals(frameID(channel, 0), frameID(channel, 10)));
+    QVERIFY(!frames->frameContentEquals(frameID(channel, 0), frameID(channel, 20)));
+    QVERIFY(frames->frameContentEquals(frameID(channel, 0), frameID(channel, 30)));
+
+    // the loaded copies are still independent frames
+    image2->animationInterface()->switchCurrentTimeAsync(10);
+    image2->waitForDone();
+    layer2->paintDevice()->fill(QRect(300, 300, 10, 10), KoColor(Qt::black, cs));
+
+    QCOMPARE(frames->frameBounds(frameID(channel, 0)), QRect(64, 64, 128, 128));
+    QVERIFY(!frames->frameContentEquals(frameID(channel, 0), frameID(channel, 10)));
+}
+
 #include "lazybrush/kis_lazy_fill_tools.h"
 
 void KisKraSaverTest::testRoundTripColorizeMask()
@@ -28,6 +28,7 @@ private Q_SLOTS:
     void testRoundTripLayerStyles();
 
     void testRoundTripAnimation();
+    void testRoundTripDuplicatedFrames();
 
     void testRoundTripColorizeMask();
 
@@ -63,6 +63,7 @@ KisImportExportErrorCode KisPNGExport::convert(KisDocument *document, QIODevice
     options.alpha = configuration->getBool("alpha", true);
     options.interlace = configuration->getBool("interlaced", false);
     options.compression = configuration->getInt("compression", 3);
+    options.compressionStrategy = KisPNGOptions::CompressionStrategy(configuration->getInt("compressionStrategy", KisPNGOptions::DefaultStrategy));
     options.tryToSaveAsIndexed = configuration->getBool("indexed", false);
     KoColor c(KoColorSpaceRegistry::instance()->rgb8());
     c.fromQColor(Qt::white);
@@ -101,6 +102,7 @@ KisPropertiesConfigurationSP KisPNGExport::defaultConfiguration(const QByteArray
     cfg->setProperty("alpha", true);
     cfg->setProperty("indexed", false);
     cfg->setProperty("compression", 3);
+    cfg->setProperty("compressionStrategy", KisPNGOptions::DefaultStrategy);
     cfg->setProperty("interlaced", false);
 
     KoColor fill_color(KoColorSpaceRegistry::instance()->rgb8());
@@ -172,6 +174,7 @@ void KisWdgOptionsPNG::setConfiguration(const KisPropertiesConfigurationSP cfg)
     interlacing->setChecked(cfg->getBool("interlaced", false));
     compressionLevel->setValue(cfg->getInt("compression", 3));
     compressionLevel->setRange(1, 9, 0);
+    cmbCompressionStrategy->setCurrentIndex(cfg->getInt("compressionStrategy", KisPNGOptions::DefaultStrategy));
 
     tryToSaveAsIndexed->setVisible(!isThereAlpha);
 
@@ -203,6 +206,7 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     bool alpha = this->alpha->isChecked();
     bool interlace = interlacing->isChecked();
     int compression = (int)compressionLevel->value();
+    int compressionStrategy = cmbCompressionStrategy->currentIndex();
     bool saveAsHDR = chkSaveAsHDR->isChecked();
     bool tryToSaveAsIndexed = !saveAsHDR && this->tryToSaveAsIndexed->isChecked();
     bool saveSRGB = !saveAsHDR && chkSRGB->isChecked();
@@ -217,6 +221,7 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     cfg->setProperty("alpha", alpha);
     cfg->setProperty("indexed", tryToSaveAsIndexed);
     cfg->setProperty("compression", compression);
+    cfg->setProperty("compressionStrategy", compressionStrategy);
     cfg->setProperty("interlaced", interlace);
     cfg->setProperty("transparencyFillcolor", transparencyFillcolor);
     cfg->setProperty("saveAsHDR", saveAsHDR);
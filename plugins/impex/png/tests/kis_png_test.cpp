@@ -14,6 +14,10 @@
 
 #include  <sdk/tests/testui.h>
 
+#include <kis_png_converter.h>
+#include <kis_paint_layer.h>
+#include <kis_sequential_iterator.h>
+
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
 #endif
@@ -163,5 +167,84 @@ void KisPngTest::testSaveHDR()
                     KoColorSpaceRegistry::instance()->p2020PQProfile()));
 }
 
+void KisPngTest::testRoundTripCompression_data()
+{
+    QTest::addColumn<QString>("colorDepthId");
+    QTest::addColumn<int>("compressionStrategy");
+    QTest::addColumn<bool>("interlaced");
+
+    QTest::newRow("8bit") << Integer8BitsColorDepthID.id() << int(KisPNGOptions::DefaultStrategy) << false;
+    QTest::newRow("8bit-rle") << Integer8BitsColorDepthID.id() << int(KisPNGOptions::RleStrategy) << false;
+    QTest::newRow("8bit-interlaced") << Integer8BitsColorDepthID.id() << int(KisPNGOptions::DefaultStrategy) << true;
+    QTest::newRow("16bit") << Integer16BitsColorDepthID.id() << int(KisPNGOptions::DefaultStrategy) << false;
+    QTest::newRow("16bit-rle") << Integer16BitsColorDepthID.id() << int(KisPNGOptions::RleStrategy) << false;
+}
+
+void KisPngTest::testRoundTripCompression()
+{
+    QFETCH(QString, colorDepthId);
+    QFETCH(int, compressionStrategy);
+    QFETCH(bool, interlaced);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId, "");
+
+    // big enough to be split into several deflate chunks
+    KisImageSP image = new KisImage(0, 640, 480, cs, "png test");
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "paint0", OPACITY_OPAQUE_U8);
+    image->addNode(paintLayer, image->root());
+
+    KisPaintDeviceSP device = paintLayer->paintDevice();
+    const int channelSize = cs->pixelSize() / cs->channelCount();
+
+    quint32 seed = 1;
+    KisSequentialIterator it(device, image->bounds());
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        for (int i = 0; i < cs->pixelSize(); i++) {
+            // half of the image is noise, the other half is a gradient
+            seed = seed * 1103515245 + 12345;
+            pixel[i] = it.x() < 320 ? quint8(seed >> 16) : quint8(it.y() + i);
+        }
+        // opaque alpha
+        memset(pixel + cs->alphaPos() * channelSize, 0xff, channelSize);
+    }
+
+    image->initialRefreshGraph();
+
+    {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        KisImportExportManager manager(doc.data());
+        doc->setFileBatchMode(true);
+        doc->setCurrentImage(image);
+
+        KisPropertiesConfigurationSP exportConfiguration = new KisPropertiesConfiguration();
+        exportConfiguration->setProperty("compression", 6);
+        exportConfiguration->setProperty("compressionStrategy", compressionStrategy);
+        exportConfiguration->setProperty("interlaced", interlaced);
+        exportConfiguration->setProperty("forceSRGB", false);
+        QVERIFY(doc->exportDocumentSync(QUrl::fromLocalFile("test_compression.png"), "image/png", exportConfiguration));
+    }
+
+    {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        KisImportExportManager manager(doc.data());
+        doc->setFileBatchMode(true);
+
+        KisImportExportErrorCode loadingStatus =
+            manager.importDocument("test_compression.png", QString());
+
+        QVERIFY(loadingStatus.isOk());
+
+        KisImageSP loadedImage = doc->image();
+        loadedImage->initialRefreshGraph();
+
+        QCOMPARE(loadedImage->colorSpace()->colorDepthId().id(), colorDepthId);
+
+        QPoint pt;
+        QVERIFY(TestUtil::comparePaintDevices(pt, device, loadedImage->projection()));
+    }
+}
+
 KISTEST_MAIN(KisPngTest)
 
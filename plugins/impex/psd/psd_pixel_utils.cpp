@@ -9,6 +9,7 @@
 #include <QtGlobal>
 #include <QMap>
 #include <QIODevice>
+#include <QtConcurrent>
 
 
 #include <KoColorSpace.h>
@@ -379,13 +380,26 @@ psd_status psd_unzip_with_prediction(psd_uchar *src_buf, psd_int src_len,
 /* End of third party block                                           */
 /**********************************************************************/
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice *io, QVector<ChannelInfo*> channelInfoRecords,
-                                            int row, int width, int channelSize, bool processMasks)
+struct RleRowJob {
+    const char *src;
+    int srcSize;
+    char *dst;
+};
+
+QMap<quint16, QByteArray> fetchChannelsPlanes(QIODevice *io, QVector<ChannelInfo*> channelInfoRecords,
+                                             int width, int height, int channelSize, bool processMasks)
 {
     const int uncompressedLength = width * channelSize;
 
     QMap<quint16, QByteArray> channelBytes;
-
+    QVector<QByteArray> compressedPlanes;
+    QVector<RleRowJob> rowJobs;
+
+    /**
+     * The file can be read only sequentially, so the compressed rows of all
+     * the channels are fetched first and then decompressed in parallel,
+     * every row into its place in the plane of its channel
+     */
     Q_FOREACH (ChannelInfo *channelInfo, channelInfoRecords) {
         // user supplied masks are ignored here
         if (!processMasks && channelInfo->channelId < -1) continue;
@@ -393,23 +407,55 @@ QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice *io, QVector<ChannelInfo*
         io->seek(channelInfo->channelDataStart + channelInfo->channelOffset);
 
         if (channelInfo->compressionType == Compression::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io->read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
+            channelBytes[channelInfo->channelId] = io->read(uncompressedLength * height);
+            channelInfo->channelOffset += uncompressedLength * height;
         }
         else if (channelInfo->compressionType == Compression::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io->read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
-            channelBytes.insert(channelInfo->channelId, uncompressedBytes);
-            channelInfo->channelOffset += rleLength;
+            int compressedLength = 0;
+            for (int row = 0; row < height; row++) {
+                compressedLength += channelInfo->rleRowLengths[row];
+            }
+
+            const QByteArray compressedBytes = io->read(compressedLength);
+            channelInfo->channelOffset += compressedLength;
+
+            compressedPlanes.append(compressedBytes);
+
+            // the plane is not shared, so the pointer stays valid
+            char *dstPtr = channelBytes.insert(channelInfo->channelId,
+                                               QByteArray(uncompressedLength * height, 0))->data();
+            const char *srcPtr = compressedBytes.constData();
+            const char *srcEnd = srcPtr + compressedBytes.size();
+
+            for (int row = 0; row < height; row++) {
+                const int rleLength = qMin(channelInfo->rleRowLengths[row], int(srcEnd - srcPtr));
+
+                RleRowJob job;
+                job.src = srcPtr;
+                job.srcSize = rleLength;
+                job.dst = dstPtr + row * uncompressedLength;
+                rowJobs.append(job);
+
+                srcPtr += rleLength;
+            }
         }
         else {
             QString error = QString("Unsupported Compression mode: %1").arg(channelInfo->compressionType);
-            dbgFile << "ERROR: fetchChannelsBytes:" << error;
+            dbgFile << "ERROR: fetchChannelsPlanes:" << error;
             throw KisAslReaderUtils::ASLParseException(error);
         }
     }
 
+    QtConcurrent::blockingMap(rowJobs,
+        [uncompressedLength] (const RleRowJob &job) {
+            const QByteArray bytes =
+                Compression::uncompress(uncompressedLength,
+                                        QByteArray::fromRawData(job.src, job.srcSize),
+                                        Compression::RLE);
+
+            memcpy(job.dst, bytes.constData(), qMin(bytes.size(), uncompressedLength));
+        });
+
     return channelBytes;
 }
 
@@ -437,22 +483,46 @@ void readCommon(KisPaintDeviceSP dev,
 
         QMap<quint16, QByteArray> channelBytes;
 
+        struct ZipChannelJob {
+            ChannelInfo *info;
+            QByteArray compressedBytes;
+            QByteArray uncompressedBytes;
+            bool status;
+        };
+
+        QVector<ZipChannelJob> jobs;
+
         Q_FOREACH (ChannelInfo *info, infoRecords) {
             io->seek(info->channelDataStart);
-            QByteArray compressedBytes = io->read(info->channelDataLength);
-            QByteArray uncompressedBytes(numPixels, 0);
 
-            bool status = false;
-            if (infoRecords.first()->compressionType == Compression::ZIP) {
-                status = psd_unzip_without_prediction((quint8*)compressedBytes.data(), compressedBytes.size(),
-                                                      (quint8*)uncompressedBytes.data(), uncompressedBytes.size());
-            } else {
-                status = psd_unzip_with_prediction((quint8*)compressedBytes.data(), compressedBytes.size(),
-                                                   (quint8*)uncompressedBytes.data(), uncompressedBytes.size(),
-                                                   layerRect.width(), channelSize * 8);
-            }
+            ZipChannelJob job;
+            job.info = info;
+            job.compressedBytes = io->read(info->channelDataLength);
+            job.uncompressedBytes = QByteArray(numPixels, 0);
+            job.status = false;
+            jobs.append(job);
+        }
 
-            if (!status) {
+        // the channels are independent, so they are inflated in parallel
+        const bool withPrediction = infoRecords.first()->compressionType == Compression::ZIPWithPrediction;
+        const int width = layerRect.width();
+
+        QtConcurrent::blockingMap(jobs,
+            [withPrediction, width, channelSize] (ZipChannelJob &job) {
+                if (!withPrediction) {
+                    job.status = psd_unzip_without_prediction((quint8*)job.compressedBytes.data(), job.compressedBytes.size(),
+                                                              (quint8*)job.uncompressedBytes.data(), job.uncompressedBytes.size());
+                } else {
+                    job.status = psd_unzip_with_prediction((quint8*)job.compressedBytes.data(), job.compressedBytes.size(),
+                                                           (quint8*)job.uncompressedBytes.data(), job.uncompressedBytes.size(),
+                                                           width, channelSize * 8);
+                }
+            });
+
+        Q_FOREACH (const ZipChannelJob &job, jobs) {
+            ChannelInfo *info = job.info;
+
+            if (!job.status) {
                 QString error = QString("Failed to unzip channel data: id = %1, compression = %2").arg(info->channelId).arg(info->compressionType);
                 dbgFile << "ERROR:" << error;
                 dbgFile << "      " << ppVar(info->channelId);
@@ -462,7 +532,7 @@ void readCommon(KisPaintDeviceSP dev,
                 throw KisAslReaderUtils::ASLParseException(error);
             }
 
-            channelBytes.insert(info->channelId, uncompressedBytes);
+            channelBytes.insert(info->channelId, job.uncompressedBytes);
         }
 
         KisSequentialIterator it(dev, layerRect);
@@ -473,19 +543,16 @@ void readCommon(KisPaintDeviceSP dev,
         }
 
     } else {
-        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0 ; i < layerRect.height(); i++) {
-            QMap<quint16, QByteArray> channelBytes;
-
-            channelBytes = fetchChannelsBytes(io, infoRecords,
-                                              i, layerRect.width(),
-                                              channelSize, processMasks);
+        const QMap<quint16, QByteArray> channelBytes =
+            fetchChannelsPlanes(io, infoRecords,
+                                layerRect.width(), layerRect.height(),
+                                channelSize, processMasks);
 
-            for (qint64 col = 0; col < layerRect.width(); col++){
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
-                it->nextPixel();
-            }
-            it->nextRow();
+        KisSequentialIterator it(dev, layerRect);
+        int col = 0;
+        while (it.nextPixel()) {
+            pixelFunc(channelSize, channelBytes, col, it.rawData());
+            col++;
         }
     }
 }
@@ -564,11 +631,21 @@ void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSi
         }
     }
 
-    quint32 stride = channelSize * rc.width();
+    const quint32 stride = channelSize * rc.width();
+
+    // the rows are packed in parallel and written in order
+    QVector<QByteArray> compressedRows(rc.height());
     for (qint32 row = 0; row < rc.height(); ++row) {
+        compressedRows[row] = QByteArray::fromRawData((const char*)plane + row * stride, stride);
+    }
+
+    QtConcurrent::blockingMap(compressedRows,
+        [] (QByteArray &row) {
+            row = Compression::compress(row, Compression::RLE);
+        });
 
-        QByteArray uncompressed = QByteArray::fromRawData((const char*)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, Compression::RLE);
+    for (qint32 row = 0; row < rc.height(); ++row) {
+        const QByteArray &compressed = compressedRows[row];
 
         KisAslWriterUtils::OffsetStreamPusher<quint16> rleExternalTag(io, 0, channelRLESizePos + row * sizeof(quint16));
 
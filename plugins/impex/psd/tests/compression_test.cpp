@@ -41,6 +41,25 @@ void CompressionTest::testCompressionRLE()
 }
 
 
+void CompressionTest::testCompressionRLEWorstCase()
+{
+    // short runs mixed with literals, and a single byte, which packs into two bytes
+    QByteArray ba;
+    for (int i = 0; i < 1000; ++i) {
+        ba.append("abcc", 4);
+    }
+
+    QByteArray compressed = Compression::compress(ba, Compression::RLE);
+    QByteArray uncompressed = Compression::uncompress(ba.size(), compressed, Compression::RLE);
+    QCOMPARE(uncompressed, ba);
+
+    ba = QByteArray(1, 'a');
+    compressed = Compression::compress(ba, Compression::RLE);
+    QCOMPARE(compressed.size(), 2);
+    uncompressed = Compression::uncompress(ba.size(), compressed, Compression::RLE);
+    QCOMPARE(uncompressed, ba);
+}
+
 void CompressionTest::testCompressionZIP()
 {
     QByteArray ba("Twee eeee aaaaa asdasda47892347981    wwwwwwwwwwwwWWWWWWWWWW");
@@ -15,6 +15,7 @@ class CompressionTest : public QObject
 private Q_SLOTS:
 
     void testCompressionRLE();
+    void testCompressionRLEWorstCase();
     void testCompressionZIP();
     void testCompressionUncompressed();
 
@@ -0,0 +1,2 @@
+/* Defines if your system has the Zlib library */
+#cmakedefine HAVE_ZLIB 1
@@ -217,6 +217,8 @@ KisPropertiesConfigurationSP KisTIFFOptions::toProperties() const
     cfg->setProperty("deflate", deflateCompress);
     cfg->setProperty("pixarlog", pixarLogCompress);
     cfg->setProperty("saveProfile", saveProfile);
+    cfg->setProperty("tiled", tiled);
+    cfg->setProperty("bigTiff", bigTiff);
 
     return cfg;
 }
@@ -245,6 +247,8 @@ void KisTIFFOptions::fromProperties(KisPropertiesConfigurationSP cfg)
     deflateCompress = cfg->getInt("deflate", 6);
     pixarLogCompress = cfg->getInt("pixarlog", 6);
     saveProfile = cfg->getBool("saveProfile", true);
+    tiled = cfg->getBool("tiled", false);
+    bigTiff = cfg->getBool("bigTiff", false);
 }
 
 
@@ -747,7 +751,8 @@ KisImportExportErrorCode KisTIFFConverter::buildFile(const QString &filename, Ki
 
     // Open file for writing
     TIFF *image;
-    if ((image = TIFFOpen(QFile::encodeName(filename), "w")) == 0) {
+    // "w8" writes a BigTIFF file, which can be bigger than 4 GiB
+    if ((image = TIFFOpen(QFile::encodeName(filename), options.bigTiff ? "w8" : "w")) == 0) {
         dbgFile << "Could not open the file for writing" << filename;
         return ImportExportCodes::NoAccessToWrite;
     }
@@ -37,6 +37,8 @@ struct KisTIFFOptions {
     quint16 deflateCompress = 6;
     quint16 pixarLogCompress = 6;
     bool saveProfile = true;
+    bool tiled = false;
+    bool bigTiff = false;
 
     KisPropertiesConfigurationSP toProperties() const;
     void fromProperties(KisPropertiesConfigurationSP cfg);
@@ -16,6 +16,10 @@
 
 #include "kis_tiff_writer_visitor.h"
 
+#include <QtConcurrent>
+
+#include <kis_assert.h>
+
 #include <KoColorProfile.h>
 #include <KoColorSpace.h>
 #include <KoID.h>
@@ -26,6 +30,11 @@
 #include <half.h>
 #endif
 
+#include "config_tiff.h"
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
+
 namespace
 {
     bool isBitDepthFloat(QString depth) {
@@ -98,6 +107,53 @@ namespace
         }
 
     }
+
+    bool samplesLayout(uint16 color_type, uint16 sample_format, quint8 *poses, uint8 &nbcolorssamples)
+    {
+        switch (color_type) {
+        case PHOTOMETRIC_MINISBLACK:
+            poses[0] = 0; poses[1] = 1;
+            nbcolorssamples = 1;
+            return true;
+        case PHOTOMETRIC_RGB:
+            if (sample_format == SAMPLEFORMAT_IEEEFP) {
+                poses[2] = 2; poses[1] = 1; poses[0] = 0; poses[3] = 3;
+            } else {
+                poses[0] = 2; poses[1] = 1; poses[2] = 0; poses[3] = 3;
+            }
+            nbcolorssamples = 3;
+            return true;
+        case PHOTOMETRIC_SEPARATED:
+            poses[0] = 0; poses[1] = 1; poses[2] = 2; poses[3] = 3; poses[4] = 4;
+            nbcolorssamples = 4;
+            return true;
+        case PHOTOMETRIC_ICCLAB:
+            poses[0] = 0; poses[1] = 1; poses[2] = 2; poses[3] = 3;
+            nbcolorssamples = 3;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    void applyHorizontalPredictor(quint8 *data, int width, int height, int samplesPerPixel)
+    {
+        T *row = reinterpret_cast<T*>(data);
+        const int rowSize = width * samplesPerPixel;
+
+        for (int y = 0; y < height; y++, row += rowSize) {
+            for (int i = rowSize - 1; i >= samplesPerPixel; i--) {
+                row[i] -= row[i - samplesPerPixel];
+            }
+        }
+    }
+
+    struct TileJob {
+        QRect rect;
+        ttile_t index;
+        QByteArray data;
+        bool compressed;
+    };
 }
 
 KisTIFFWriterVisitor::KisTIFFWriterVisitor(TIFF*image, KisTIFFOptions* options)
@@ -110,67 +166,6 @@ KisTIFFWriterVisitor::~KisTIFFWriterVisitor()
 {
 }
 
-bool KisTIFFWriterVisitor::copyDataToStrips(KisHLineConstIteratorSP it, tdata_t buff, uint8 depth, uint16 sample_format, uint8 nbcolorssamples, quint8* poses)
-{
-    if (depth == 32) {
-        Q_ASSERT(sample_format == SAMPLEFORMAT_IEEEFP);
-        float *dst = reinterpret_cast<float *>(buff);
-        do {
-            const float *d = reinterpret_cast<const float *>(it->oldRawData());
-            int i;
-            for (i = 0; i < nbcolorssamples; i++) {
-                *(dst++) = d[poses[i]];
-            }
-            if (m_options->alpha) *(dst++) = d[poses[i]];
-        } while (it->nextPixel());
-        return true;
-    }
-    else if (depth == 16 ) {
-        if (sample_format == SAMPLEFORMAT_IEEEFP) {
-#ifdef HAVE_OPENEXR
-            half *dst = reinterpret_cast<half *>(buff);
-            do {
-                const half *d = reinterpret_cast<const half *>(it->oldRawData());
-                int i;
-                for (i = 0; i < nbcolorssamples; i++) {
-                    *(dst++) = d[poses[i]];
-                }
-                if (m_options->alpha) *(dst++) = d[poses[i]];
-
-            } while (it->nextPixel());
-            return true;
-#endif
-        }
-        else {
-            quint16 *dst = reinterpret_cast<quint16 *>(buff);
-            do {
-                const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                int i;
-                for (i = 0; i < nbcolorssamples; i++) {
-                    *(dst++) = d[poses[i]];
-                }
-                if (m_options->alpha) *(dst++) = d[poses[i]];
-
-            } while (it->nextPixel());
-            return true;
-        }
-    }
-    else if (depth == 8) {
-        quint8 *dst = reinterpret_cast<quint8 *>(buff);
-        do {
-            const quint8 *d = it->oldRawData();
-            int i;
-            for (i = 0; i < nbcolorssamples; i++) {
-                *(dst++) = d[poses[i]];
-            }
-            if (m_options->alpha) *(dst++) = d[poses[i]];
-
-        } while (it->nextPixel());
-        return true;
-    }
-    return false;
-}
-
 bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
 {
     dbgFile << "visiting on layer" << layer->name() << "";
@@ -178,26 +173,34 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
 
     uint16 color_type;
     uint16 sample_format = SAMPLEFORMAT_UINT;
-    const KoColorSpace* destColorSpace;
+    const KoColorSpace* destColorSpace = 0;
+
+    /**
+     * The pixels of the color spaces TIFF doesn't support are converted
+     * band by band while writing, without a converted copy of the layer
+     */
+    KisConvertedBandReader reader(pd);
+
     // Check colorspace
     if (!writeColorSpaceInformation(image(), pd->colorSpace(), color_type, sample_format, destColorSpace)) { // unsupported colorspace
         if (!destColorSpace) {
             return false;
         }
-        pd.attach(new KisPaintDevice(*pd));
-        pd->convertTo(destColorSpace);
+        reader.setColorSpace(destColorSpace);
     }
 
+    const KoColorSpace *cs = reader.colorSpace();
+
     // Save depth
-    int depth = 8 * pd->pixelSize() / pd->channelCount();
+    int depth = 8 * cs->pixelSize() / cs->channelCount();
     TIFFSetField(image(), TIFFTAG_BITSPERSAMPLE, depth);
     // Save number of samples
     if (m_options->alpha) {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount());
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, cs->channelCount());
         uint16 sampleinfo[1] = { EXTRASAMPLE_UNASSALPHA };
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 1, sampleinfo);
     } else {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount() - 1);
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, cs->channelCount() - 1);
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 0);
     }
 
@@ -218,56 +221,169 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
 
     // Use contiguous configuration
     TIFFSetField(image(), TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-    // Use 8 rows per strip
-    TIFFSetField(image(), TIFFTAG_ROWSPERSTRIP, 8);
+
+    if (m_options->tiled) {
+        TIFFSetField(image(), TIFFTAG_TILEWIDTH, tileSize);
+        TIFFSetField(image(), TIFFTAG_TILELENGTH, tileSize);
+    } else {
+        // Use 8 rows per strip
+        TIFFSetField(image(), TIFFTAG_ROWSPERSTRIP, 8);
+    }
 
     // Save profile
     if (m_options->saveProfile) {
-        const KoColorProfile* profile = pd->colorSpace()->profile();
+        const KoColorProfile* profile = cs->profile();
         if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
             QByteArray ba = profile->rawData();
             TIFFSetField(image(), TIFFTAG_ICCPROFILE, ba.size(), ba.constData());
         }
     }
-    tsize_t stripsize = TIFFStripSize(image());
-    tdata_t buff = _TIFFmalloc(stripsize);
+    quint8 poses[5];
+    uint8 nbcolorssamples;
+    if (!samplesLayout(color_type, sample_format, poses, nbcolorssamples)) {
+        return false;
+    }
+
     qint32 height = layer->image()->height();
     qint32 width = layer->image()->width();
-    bool r = true;
-    for (int y = 0; y < height; y++) {
-        KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
-        switch (color_type) {
-        case PHOTOMETRIC_MINISBLACK: {
-                quint8 poses[] = { 0, 1 };
-                r = copyDataToStrips(it, buff, depth, sample_format, 1, poses);
-            }
-            break;
-        case PHOTOMETRIC_RGB: {
-                quint8 poses[4];
-                if (sample_format == SAMPLEFORMAT_IEEEFP) {
-                    poses[2] = 2; poses[1] = 1; poses[0] = 0; poses[3] = 3;
-                } else {
-                    poses[0] = 2; poses[1] = 1; poses[2] = 0; poses[3] = 3;
-                }
-                r = copyDataToStrips(it, buff, depth, sample_format, 3, poses);
-            }
-            break;
-        case PHOTOMETRIC_SEPARATED: {
-                quint8 poses[] = { 0, 1, 2, 3, 4 };
-                r = copyDataToStrips(it, buff, depth, sample_format, 4, poses);
-            }
-            break;
-        case PHOTOMETRIC_ICCLAB: {
-                quint8 poses[] = { 0, 1, 2, 3 };
-                r = copyDataToStrips(it, buff, depth, sample_format, 3, poses);
-            }
-            break;
+
+    if (m_options->tiled) {
+        if (!writeTiles(reader, width, height, depth, sample_format, nbcolorssamples, poses)) {
             return false;
         }
-        if (!r) return false;
+        TIFFWriteDirectory(image());
+        return true;
+    }
+
+    tsize_t stripsize = TIFFStripSize(image());
+    tdata_t buff = _TIFFmalloc(stripsize);
+    QVector<quint8> row(width * cs->pixelSize());
+    for (int y = 0; y < height; y++) {
+        reader.readBytes(row.data(), QRect(0, y, width, 1));
+        copyDataToTile(row.constData(), reinterpret_cast<quint8*>(buff), width, cs->pixelSize(),
+                       depth / 8, nbcolorssamples, poses);
         TIFFWriteScanline(image(), buff, y, (tsample_t) - 1);
     }
     _TIFFfree(buff);
     TIFFWriteDirectory(image());
     return true;
 }
+
+void KisTIFFWriterVisitor::copyDataToTile(const quint8 *src, quint8 *dst, int numPixels, int pixelSize,
+                                          int sampleSize, uint8 nbcolorssamples, const quint8 *poses)
+{
+    for (int i = 0; i < numPixels; i++, src += pixelSize) {
+        int j;
+        for (j = 0; j < nbcolorssamples; j++) {
+            memcpy(dst, src + poses[j] * sampleSize, sampleSize);
+            dst += sampleSize;
+        }
+        if (m_options->alpha) {
+            memcpy(dst, src + poses[j] * sampleSize, sampleSize);
+            dst += sampleSize;
+        }
+    }
+}
+
+bool KisTIFFWriterVisitor::writeTiles(const KisConvertedBandReader &reader, qint32 width, qint32 height,
+                                      uint8 depth, uint16 sample_format,
+                                      uint8 nbcolorssamples, const quint8 *poses)
+{
+    const int sampleSize = depth / 8;
+    const int samplesPerPixel = nbcolorssamples + (m_options->alpha ? 1 : 0);
+    const int pixelSize = reader.pixelSize();
+    const tsize_t tileBytes = TIFFTileSize(image());
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(tileBytes == tileSize * tileSize * samplesPerPixel * sampleSize, false);
+
+    /**
+     * Deflate and the integer horizontal predictor are simple enough to
+     * be applied to every tile on the worker threads, then the tiles are
+     * written raw. The tiles of the other codecs are only prepared on the
+     * workers and encoded by libtiff, which can't be used concurrently.
+     */
+    bool compressOnWorkers = false;
+    bool usePredictor = false;
+#ifdef HAVE_ZLIB
+    if (m_options->compressionType == COMPRESSION_ADOBE_DEFLATE ||
+        m_options->compressionType == COMPRESSION_DEFLATE) {
+
+        usePredictor = m_options->predictor == PREDICTOR_HORIZONTAL;
+        compressOnWorkers =
+            m_options->predictor == PREDICTOR_NONE ||
+            (usePredictor && sample_format == SAMPLEFORMAT_UINT && depth <= 16);
+    }
+#endif
+
+    const int deflateLevel = m_options->deflateCompress;
+
+    // only a single row of tiles is kept in memory at a time
+    for (qint32 y = 0; y < height; y += tileSize) {
+        QVector<TileJob> jobs;
+
+        for (qint32 x = 0; x < width; x += tileSize) {
+            TileJob job;
+            job.rect = QRect(x, y, tileSize, tileSize);
+            job.index = TIFFComputeTile(image(), x, y, 0, 0);
+            job.compressed = false;
+            jobs.append(job);
+        }
+
+        QtConcurrent::blockingMap(jobs,
+            [&] (TileJob &job) {
+                // the parts of the edge tiles outside the image are transparent
+                QByteArray pixels(job.rect.width() * job.rect.height() * pixelSize, Qt::Uninitialized);
+                reader.readBytes((quint8*)pixels.data(), job.rect);
+
+                job.data = QByteArray(tileBytes, Qt::Uninitialized);
+                copyDataToTile((const quint8*)pixels.constData(), (quint8*)job.data.data(),
+                               tileSize * tileSize, pixelSize, sampleSize, nbcolorssamples, poses);
+
+#ifdef HAVE_ZLIB
+                if (compressOnWorkers) {
+                    if (usePredictor) {
+                        if (depth == 8) {
+                            applyHorizontalPredictor<quint8>((quint8*)job.data.data(), tileSize, tileSize, samplesPerPixel);
+                        } else {
+                            applyHorizontalPredictor<quint16>((quint8*)job.data.data(), tileSize, tileSize, samplesPerPixel);
+                        }
+                    }
+
+                    uLongf compressedSize = compressBound(job.data.size());
+                    QByteArray compressed(compressedSize, Qt::Uninitialized);
+
+                    if (compress2((Bytef*)compressed.data(), &compressedSize,
+                                  (const Bytef*)job.data.constData(), job.data.size(),
+                                  deflateLevel) == Z_OK) {
+
+                        compressed.resize(compressedSize);
+                        job.data = compressed;
+                        job.compressed = true;
+                    }
+                }
+#else
+                Q_UNUSED(usePredictor);
+                Q_UNUSED(deflateLevel);
+#endif
+            });
+
+        Q_FOREACH (const TileJob &job, jobs) {
+            tmsize_t result;
+
+            if (job.compressed) {
+                result = TIFFWriteRawTile(image(), job.index, (void*)job.data.constData(), job.data.size());
+            } else if (!compressOnWorkers) {
+                result = TIFFWriteEncodedTile(image(), job.index, (void*)job.data.constData(), job.data.size());
+            } else {
+                warnFile << "Failed to compress a tile" << job.rect;
+                return false;
+            }
+
+            if (result < 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
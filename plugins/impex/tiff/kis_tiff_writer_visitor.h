@@ -24,6 +24,7 @@
 
 #include <kis_annotation.h>
 #include <kis_paint_device.h>
+#include <KisConvertedBandReader.h>
 #include <kis_group_layer.h>
 #include <kis_generator_layer.h>
 #include <kis_clone_layer.h>
@@ -106,9 +107,13 @@ private:
     inline TIFF* image() {
         return m_image;
     }
-    bool copyDataToStrips(KisHLineConstIteratorSP it, tdata_t buff, uint8 depth, uint16 sample_format, uint8 nbcolorssamples, quint8* poses);
+    void copyDataToTile(const quint8 *src, quint8 *dst, int numPixels, int pixelSize, int sampleSize, uint8 nbcolorssamples, const quint8 *poses);
+    bool writeTiles(const KisConvertedBandReader &reader, qint32 width, qint32 height, uint8 depth, uint16 sample_format, uint8 nbcolorssamples, const quint8 *poses);
     bool saveLayerProjection(KisLayer *);
 private:
+    /// the size of the tiles of the tiled TIFF files, should be a multiple of 16
+    static const int tileSize = 256;
+
     TIFF* m_image;
     KisTIFFOptions* m_options;
 };
@@ -14,6 +14,9 @@
 
 #include <KoColorModelStandardIds.h>
 #include <KoColor.h>
+#include <kis_paint_layer.h>
+#include <kis_surrogate_undo_store.h>
+#include <kis_properties_configuration.h>
 
 #include "kisexiv2/kis_exiv2.h"
 #include  <sdk/tests/testui.h>
@@ -106,6 +109,65 @@ void KisTiffTest::testRoundTripRGBF16()
 #endif
 }
 
+void KisTiffTest::testRoundTripTiled_data()
+{
+    QTest::addColumn<int>("compression");
+    QTest::addColumn<int>("predictor");
+    QTest::addColumn<bool>("bigTiff");
+
+    // the indexes of the compression and predictor combo boxes
+    QTest::newRow("none") << 0 << 0 << false;
+    QTest::newRow("deflate") << 2 << 0 << false;
+    QTest::newRow("deflate-predictor") << 2 << 1 << false;
+    QTest::newRow("lzw-predictor") << 3 << 1 << false;
+    QTest::newRow("deflate-bigtiff") << 2 << 1 << true;
+}
+
+void KisTiffTest::testRoundTripTiled()
+{
+    QFETCH(int, compression);
+    QFETCH(int, predictor);
+    QFETCH(bool, bigTiff);
+
+    // not a multiple of the tile size to check the edge tiles
+    QRect imageRect(0, 0, 700, 300);
+
+    QScopedPointer<KisDocument> doc0(KisPart::instance()->createDocument());
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "test image");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+    doc0->setCurrentImage(image);
+
+    layer->paintDevice()->fill(QRect(100, 100, 300, 100), KoColor(Qt::red, cs));
+    layer->paintDevice()->fill(QRect(500, 50, 200, 250), KoColor(Qt::blue, cs));
+    image->initialRefreshGraph();
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".tiff"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    KisPropertiesConfigurationSP cfg(new KisPropertiesConfiguration());
+    cfg->setProperty("compressiontype", compression);
+    cfg->setProperty("predictor", predictor);
+    cfg->setProperty("tiled", true);
+    cfg->setProperty("bigTiff", bigTiff);
+
+    doc0->setFileBatchMode(true);
+    QVERIFY(doc0->exportDocumentSync(QUrl::fromLocalFile(savedFile.fileName()), TiffMimetype.toLatin1(), cfg));
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    doc1->setFileBatchMode(true);
+    QVERIFY(doc1->importDocument(QUrl::fromLocalFile(savedFile.fileName())));
+    QVERIFY(doc1->image());
+
+    QImage ref0 = doc0->image()->projection()->convertToQImage(0, imageRect);
+    QImage ref1 = doc1->image()->projection()->convertToQImage(0, imageRect);
+
+    QCOMPARE(ref1, ref0);
+}
+
 void KisTiffTest::testSaveTiffColorSpace(QString colorModel, QString colorDepth, QString colorProfile)
 {
     const KoColorSpace *space = KoColorSpaceRegistry::instance()->colorSpace(colorModel, colorDepth, colorProfile);
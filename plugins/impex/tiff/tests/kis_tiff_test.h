@@ -15,6 +15,8 @@ class KisTiffTest : public QObject
 private Q_SLOTS:
     void testFiles();
     void testRoundTripRGBF16();
+    void testRoundTripTiled_data();
+    void testRoundTripTiled();
 
     void testSaveTiffColorSpace(QString colorModel, QString colorDepth, QString colorProfile);
     void testSaveTiffRgbaColorSpace();
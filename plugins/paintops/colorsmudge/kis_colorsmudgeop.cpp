@@ -235,15 +235,22 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     const qreal fpOpacity = (qreal(painter()->opacity()) / 255.0) * m_opacityOption.getOpacityf(info);
 
-    if (m_image && m_overlayModeOption.isChecked()) {
-        m_image->blockUpdates();
-        m_backgroundPainter->bitBlt(QPoint(), m_image->projection(), srcDabRect);
-        m_image->unblockUpdates();
-    }
-    else {
-        // IMPORTANT: Clear the temporary painting device to transparent black.
-        //            It will only clear the extents of the brush.
-        m_tempDev->clear(QRect(QPoint(), m_dstDabRect.size()));
+    /**
+     * In dulling mode the whole dab area of the temporary device is
+     * filled with the sampled color below, so its background would be
+     * overwritten anyway and is not prepared.
+     */
+    if (!useDullingMode) {
+        if (m_image && m_overlayModeOption.isChecked()) {
+            m_image->blockUpdates();
+            m_backgroundPainter->bitBlt(QPoint(), m_image->projection(), srcDabRect);
+            m_image->unblockUpdates();
+        }
+        else {
+            // IMPORTANT: Clear the temporary painting device to transparent black.
+            //            It will only clear the extents of the brush.
+            m_tempDev->clear(QRect(QPoint(), m_dstDabRect.size()));
+        }
     }
 
     // stored in the color space of the paintColor
@@ -15,6 +15,7 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <KisRollingMeanAccumulatorWrapper.h>
+#include <KisPerformanceCounters.h>
 
 #include "kis_algebra_2d.h"
 
@@ -347,6 +348,8 @@ QList<KisRenderedDab> KisDabRenderingQueue::takeReadyDabs(bool returnMutableDabs
 
     m_d->cleanPaintedDabs();
 
+    KisPerformanceCounters::add(KisPerformanceCounters::RenderedDabs, renderedDabs.size());
+
     if (someDabsLeft) {
         *someDabsLeft = m_d->hasPreparedDabsImpl();
     }
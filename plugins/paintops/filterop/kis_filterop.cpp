@@ -11,6 +11,7 @@
 #include "kis_filterop.h"
 
 #include <kis_debug.h>
+#include <kis_algebra_2d.h>
 
 #include <KoColorSpaceRegistry.h>
 #include <KoColorTransformation.h>
@@ -55,6 +56,18 @@ KisFilterOp::KisFilterOp(const KisPaintOpSettingsSP settings, KisPainter *painte
     m_filterConfiguration = static_cast<const KisFilterOpSettings *>(settings.data())->filterConfig();
     m_smudgeMode = settings->getBool(FILTER_SMUDGE_MODE);
 
+    /**
+     * In smudge mode every dab filters the result of the previous
+     * one, and the filters that don't support threading may depend
+     * on the whole processed area, so filter such dabs separately
+     */
+    m_useFilteredCells = !m_smudgeMode && m_filter && m_filter->supportsThreading();
+
+    if (m_useFilteredCells) {
+        m_filteredDevice = source()->createCompositionSourceDevice();
+        m_sourceCopy = source()->createCompositionSourceDevice();
+    }
+
     m_rotationOption.applyFanCornersInfo(this);
 }
 
@@ -62,6 +75,86 @@ KisFilterOp::~KisFilterOp()
 {
 }
 
+namespace {
+const int filteredCellSize = 64;
+const int maxFilteredCells = 256;
+
+inline qint64 cellKey(int cellX, int cellY) {
+    return (qint64(cellY) << 32) | quint32(cellX);
+}
+
+inline QRect cellRect(qint64 key) {
+    const int cellX = qint32(key & 0xffffffff);
+    const int cellY = qint32(key >> 32);
+    return QRect(cellX * filteredCellSize, cellY * filteredCellSize,
+                 filteredCellSize, filteredCellSize);
+}
+}
+
+void KisFilterOp::updateFilteredCells(const QRect &rect)
+{
+    const int left = KisAlgebra2D::divideFloor(rect.left(), filteredCellSize);
+    const int right = KisAlgebra2D::divideFloor(rect.right(), filteredCellSize);
+    const int top = KisAlgebra2D::divideFloor(rect.top(), filteredCellSize);
+    const int bottom = KisAlgebra2D::divideFloor(rect.bottom(), filteredCellSize);
+
+    const int lod = painter()->device()->defaultBounds()->currentLevelOfDetail();
+
+    /**
+     * The missing cells of every row are filtered in horizontal
+     * stripes, so that the border needed by the filter is fetched
+     * only once per stripe
+     */
+    for (int cellY = top; cellY <= bottom; cellY++) {
+        int cellX = left;
+
+        while (cellX <= right) {
+            if (m_filteredCells.contains(cellKey(cellX, cellY))) {
+                cellX++;
+                continue;
+            }
+
+            const int firstX = cellX;
+            while (cellX <= right && !m_filteredCells.contains(cellKey(cellX, cellY))) {
+                const qint64 key = cellKey(cellX, cellY);
+                m_filteredCells.insert(key);
+                m_filteredCellsOrder.enqueue(key);
+                cellX++;
+            }
+
+            const QRect stripeRect(firstX * filteredCellSize, cellY * filteredCellSize,
+                                   (cellX - firstX) * filteredCellSize, filteredCellSize);
+
+            const QRect neededRect = m_filter->neededRect(stripeRect, m_filterConfiguration, lod);
+
+            KisPainter copyPainter(m_sourceCopy);
+            copyPainter.setCompositeOp(COMPOSITE_COPY);
+            copyPainter.bitBltOldData(neededRect.topLeft(), source(), neededRect);
+            copyPainter.end();
+
+            KisTransaction transaction(m_sourceCopy);
+            m_filter->process(m_sourceCopy, stripeRect, m_filterConfiguration, 0);
+            transaction.end();
+
+            KisPainter resultPainter(m_filteredDevice);
+            resultPainter.setCompositeOp(COMPOSITE_COPY);
+            resultPainter.bitBlt(stripeRect.topLeft(), m_sourceCopy, stripeRect);
+            resultPainter.end();
+
+            m_sourceCopy->clear();
+        }
+    }
+}
+
+void KisFilterOp::evictFilteredCells()
+{
+    while (m_filteredCellsOrder.size() > maxFilteredCells) {
+        const qint64 key = m_filteredCellsOrder.dequeue();
+        m_filteredCells.remove(key);
+        m_filteredDevice->clear(cellRect(key));
+    }
+}
+
 KisSpacingInformation KisFilterOp::paintAt(const KisPaintInformation& info)
 {
     if (!painter()) {
@@ -105,6 +198,23 @@ KisSpacingInformation KisFilterOp::paintAt(const KisPaintInformation& info)
     Q_ASSERT(dstRect.size() == dabRect.size());
 
 
+    if (m_useFilteredCells) {
+        updateFilteredCells(dstRect);
+
+        painter()->bitBltWithFixedSelection(dstRect.x(), dstRect.y(),
+                                            m_filteredDevice, dab,
+                                            0, 0,
+                                            dstRect.x(), dstRect.y(),
+                                            dabRect.width(), dabRect.height());
+
+        painter()->renderMirrorMaskSafe(dstRect, m_filteredDevice, dstRect.x(), dstRect.y(), dab,
+                                        !m_dabCache->needSeparateOriginal());
+
+        evictFilteredCells();
+
+        return effectiveSpacing(scale, rotation, info);
+    }
+
     // Filter the paint device
     QRect neededRect = m_filter->neededRect(dstRect, m_filterConfiguration, painter()->device()->defaultBounds()->currentLevelOfDetail());
 
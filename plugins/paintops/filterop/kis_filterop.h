@@ -11,6 +11,9 @@
 #ifndef KIS_FILTEROP_H_
 #define KIS_FILTEROP_H_
 
+#include <QQueue>
+#include <QSet>
+
 #include "kis_brush_based_paintop.h"
 #include <kis_pressure_size_option.h>
 #include <kis_pressure_rotation_option.h>
@@ -37,6 +40,11 @@ protected:
 
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
 
+private:
+
+    void updateFilteredCells(const QRect &rect);
+    void evictFilteredCells();
+
 private:
 
     KisPaintDeviceSP m_tmpDevice;
@@ -45,6 +53,17 @@ private:
     KisFilterSP m_filter;
     KisFilterConfigurationSP m_filterConfiguration;
     bool m_smudgeMode;
+
+    /**
+     * When the result of the filter depends only on the original
+     * state of the source, the filtered pixels are cached in cells
+     * and reused by all the overlapping dabs of the stroke
+     */
+    bool m_useFilteredCells;
+    KisPaintDeviceSP m_filteredDevice;
+    KisPaintDeviceSP m_sourceCopy;
+    QSet<qint64> m_filteredCells;
+    QQueue<qint64> m_filteredCellsOrder;
 };
 
 #endif // KIS_FILTEROP_H_
@@ -13,9 +13,12 @@
 
 #include <QVariant>
 #include <QHash>
+#include <QMap>
 #include <QVector>
+#include <QtConcurrentMap>
 
 #include <kis_types.h>
+#include <kis_algebra_2d.h>
 #include <kis_random_accessor_ng.h>
 #include <kis_cross_device_color_picker.h>
 #include <kis_fixed_paint_device.h>
@@ -23,6 +26,7 @@
 
 #include <cmath>
 #include <ctime>
+#include <numeric>
 
 
 HairyBrush::HairyBrush()
@@ -124,8 +128,6 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     Bristle *bristle = 0;
     KoColor bristleColor(dab->colorSpace());
 
-    m_dabAccessor = dab->createRandomAccessorNG();
-
     m_dab = dab;
 
     // initialization block
@@ -232,8 +234,10 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         }
 
     }
+
+    applyInkSamples();
+
     m_dab = 0;
-    m_dabAccessor = 0;
 }
 
 
@@ -297,26 +301,114 @@ void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal
 inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color)
 {
     Q_UNUSED(bristle);
+    m_inkSamples.append({pos, color});
+}
+
+QRect HairyBrush::inkSampleRect(const InkSample &sample) const
+{
     if (m_properties->antialias) {
-        if (m_properties->useCompositing) {
-            paintParticle(pos, color);
-        } else {
-            paintParticle(pos, color, 1.0);
+        return QRect(int(sample.pos.x()), int(sample.pos.y()), 2, 2);
+    } else {
+        return QRect(qRound(sample.pos.x()), qRound(sample.pos.y()), 1, 1);
+    }
+}
+
+void HairyBrush::applyInkSamples()
+{
+    if (m_inkSamples.isEmpty()) return;
+
+    /**
+     * The samples are painted in parallel only when there are enough
+     * of them. Every thread gets the samples falling into one tile of
+     * the dab and paints only the pixels of this tile, so the threads
+     * never touch the same tile. Inside the tile the samples are
+     * painted in the order they were generated in, so the result is
+     * the same as if they were painted sequentially.
+     */
+    const int minSamplesForThreading = 4096;
+    const int cellSize = 64;
+
+    QRect totalRect;
+    Q_FOREACH (const InkSample &sample, m_inkSamples) {
+        totalRect |= inkSampleRect(sample);
+    }
+
+    if (m_inkSamples.size() < minSamplesForThreading ||
+        (totalRect.width() <= cellSize && totalRect.height() <= cellSize)) {
+
+        InkJob job;
+        job.clipRect = totalRect;
+        job.samples.resize(m_inkSamples.size());
+        std::iota(job.samples.begin(), job.samples.end(), 0);
+
+        applyInkJob(job);
+
+    } else {
+        QMap<qint64, InkJob> jobsMap;
+
+        for (int i = 0; i < m_inkSamples.size(); i++) {
+            const QRect rc = inkSampleRect(m_inkSamples[i]);
+
+            const int left = KisAlgebra2D::divideFloor(rc.left(), cellSize);
+            const int right = KisAlgebra2D::divideFloor(rc.right(), cellSize);
+            const int top = KisAlgebra2D::divideFloor(rc.top(), cellSize);
+            const int bottom = KisAlgebra2D::divideFloor(rc.bottom(), cellSize);
+
+            for (int cellY = top; cellY <= bottom; cellY++) {
+                for (int cellX = left; cellX <= right; cellX++) {
+                    const qint64 key = (qint64(cellY) << 32) | quint32(cellX);
+
+                    InkJob &job = jobsMap[key];
+                    if (job.samples.isEmpty()) {
+                        job.clipRect = QRect(cellX * cellSize, cellY * cellSize, cellSize, cellSize);
+                    }
+                    job.samples.append(i);
+                }
+            }
         }
+
+        QVector<InkJob> jobs;
+        jobs.reserve(jobsMap.size());
+        Q_FOREACH (const InkJob &job, jobsMap) {
+            jobs.append(job);
+        }
+
+        QtConcurrent::blockingMap(jobs, [this] (const InkJob &job) { applyInkJob(job); });
     }
-    else {
-        int ix = qRound(pos.x());
-        int iy = qRound(pos.y());
-        if (m_properties->useCompositing) {
-            plotPixel(ix, iy, color);
+
+    m_inkSamples.clear();
+}
+
+void HairyBrush::applyInkJob(const InkJob &job) const
+{
+    KisRandomAccessorSP accessor = m_dab->createRandomAccessorNG();
+
+    Q_FOREACH (int index, job.samples) {
+        const InkSample &sample = m_inkSamples[index];
+        const QPointF &pos = sample.pos;
+        const KoColor &color = sample.color;
+
+        if (m_properties->antialias) {
+            if (m_properties->useCompositing) {
+                paintParticle(accessor, job.clipRect, pos, color);
+            } else {
+                paintParticle(accessor, job.clipRect, pos, color, 1.0);
+            }
         }
         else {
-            darkenPixel(ix, iy, color);
+            int ix = qRound(pos.x());
+            int iy = qRound(pos.y());
+            if (m_properties->useCompositing) {
+                plotPixel(accessor, job.clipRect, ix, iy, color);
+            }
+            else {
+                darkenPixel(accessor, job.clipRect, ix, iy, color);
+            }
         }
     }
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
+void HairyBrush::paintParticle(KisRandomAccessorSP accessor, const QRect &clipRect, QPointF pos, const KoColor& color, qreal weight) const
 {
     // opacity top left, right, bottom left, right
     quint8 opacity = color.opacityU8();
@@ -327,38 +419,32 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     qreal fx = qAbs(pos.x() - ipx);
     qreal fy = qAbs(pos.y() - ipy);
 
-    quint8 btl = qRound((1.0 - fx) * (1.0 - fy) * opacity);
-    quint8 btr = qRound((fx)  * (1.0 - fy) * opacity);
-    quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
-    quint8 bbr = qRound((fx)  * (fy)  * opacity);
+    const quint8 btl = qRound((1.0 - fx) * (1.0 - fy) * opacity);
+    const quint8 btr = qRound((fx)  * (1.0 - fy) * opacity);
+    const quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
+    const quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
     const KoColorSpace * cs = m_dab->colorSpace();
 
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    auto addOpacity = [&] (int x, int y, quint8 pixelOpacity) {
+        if (!clipRect.contains(x, y)) return;
+
+        accessor->moveTo(x, y);
+        pixelOpacity = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, pixelOpacity + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+        memcpy(accessor->rawData(), color.data(), cs->pixelSize());
+        cs->setOpacity(accessor->rawData(), pixelOpacity, 1);
+    };
+
+    addOpacity(ipx, ipy, btl);
+    addOpacity(ipx + 1, ipy, btr);
+    addOpacity(ipx, ipy + 1, bbl);
+    addOpacity(ipx + 1, ipy + 1, bbr);
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
+void HairyBrush::paintParticle(KisRandomAccessorSP accessor, const QRect &clipRect, QPointF pos, const KoColor& color) const
 {
     // opacity top left, right, bottom left, right
-    memcpy(m_color.data(), color.data(), m_pixelSize);
+    KoColor pixelColor(color);
     quint8 opacity = color.opacityU8();
 
     int ipx = int (pos.x());
@@ -371,31 +457,35 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
+    pixelColor.setOpacity(btl);
+    plotPixel(accessor, clipRect, ipx  , ipy, pixelColor);
 
-    m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
+    pixelColor.setOpacity(btr);
+    plotPixel(accessor, clipRect, ipx + 1  , ipy, pixelColor);
 
-    m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
+    pixelColor.setOpacity(bbl);
+    plotPixel(accessor, clipRect, ipx  , ipy + 1, pixelColor);
 
-    m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
+    pixelColor.setOpacity(bbr);
+    plotPixel(accessor, clipRect, ipx + 1 , ipy + 1, pixelColor);
 }
 
 
-inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::plotPixel(KisRandomAccessorSP accessor, const QRect &clipRect, int wx, int wy, const KoColor &color) const
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
+    if (!clipRect.contains(wx, wy)) return;
+
+    accessor->moveTo(wx, wy);
+    m_compositeOp->composite(accessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
 }
 
-inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::darkenPixel(KisRandomAccessorSP accessor, const QRect &clipRect, int wx, int wy, const KoColor &color) const
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    if (!clipRect.contains(wx, wy)) return;
+
+    accessor->moveTo(wx, wy);
+    if (m_dab->colorSpace()->opacityU8(accessor->rawData()) < color.opacityU8()) {
+        memcpy(accessor->rawData(), color.data(), m_pixelSize);
     }
 }
 
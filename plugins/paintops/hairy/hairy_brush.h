@@ -74,16 +74,35 @@ public:
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
 private:
+    /// a single portion of ink left by a bristle on the dab
+    struct InkSample {
+        QPointF pos;
+        KoColor color;
+    };
+
+    /// the ink samples falling into one tile of the dab
+    struct InkJob {
+        QRect clipRect;
+        QVector<int> samples;
+    };
+
     /// paints single bristle
     void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
+    /// paints all the ink samples collected by addBristleInk()
+    void applyInkSamples();
+    /// paints the ink samples of the job, the pixels outside its clip rect are not touched
+    void applyInkJob(const InkJob &job) const;
+    /// the pixels touched by the ink sample
+    QRect inkSampleRect(const InkSample &sample) const;
+
     /// composite single pixel to dab
-    void plotPixel(int wx, int wy, const KoColor &color);
+    void plotPixel(KisRandomAccessorSP accessor, const QRect &clipRect, int wx, int wy, const KoColor &color) const;
     /// check the opacity of dab pixel and if the opacity is less then color, it will copy color to dab
-    void darkenPixel(int wx, int wy, const KoColor &color);
+    void darkenPixel(KisRandomAccessorSP accessor, const QRect &clipRect, int wx, int wy, const KoColor &color) const;
     /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
-    void paintParticle(QPointF pos, const KoColor& color, qreal weight);
+    void paintParticle(KisRandomAccessorSP accessor, const QRect &clipRect, QPointF pos, const KoColor& color, qreal weight) const;
     /// paint wu particle using composite operation
-    void paintParticle(QPointF pos, const KoColor& color);
+    void paintParticle(KisRandomAccessorSP accessor, const QRect &clipRect, QPointF pos, const KoColor& color) const;
     /// similar to sample input color in spray
     void colorifyBristles(KisPaintDeviceSP source, QPointF point);
 
@@ -111,7 +130,7 @@ private:
     QHash<QString, QVariant> m_params;
     // temporary device
     KisPaintDeviceSP m_dab;
-    KisRandomAccessorSP m_dabAccessor;
+    QVector<InkSample> m_inkSamples;
     const KoCompositeOp * m_compositeOp;
     quint32 m_pixelSize;
 
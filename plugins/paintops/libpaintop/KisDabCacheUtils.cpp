@@ -10,6 +10,7 @@
 #include "kis_paint_device.h"
 #include "kis_fixed_paint_device.h"
 #include "kis_color_source.h"
+#include "KisDabMaskCache.h"
 
 #include <kis_pressure_sharpness_option.h>
 #include <kis_texture_option.h>
@@ -43,9 +44,8 @@ QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
 }
 
 
-void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources, KisFixedPaintDeviceSP *dab)
+static void generateDabPixels(const DabGenerationInfo &di, DabRenderingResources *resources, KisFixedPaintDeviceSP *dab)
 {
-    KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
     const KoColorSpace *cs = (*dab)->colorSpace();
 
 
@@ -83,6 +83,20 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
                                di.softnessFactor,
                                di.lightnessStrength);
     }
+}
+
+void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources, KisFixedPaintDeviceSP *dab)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
+
+    if (di.maskCacheKey.isEmpty()) {
+        generateDabPixels(di, resources, dab);
+    } else if (!KisDabMaskCache::instance()->fetchDab(di.maskCacheKey, (*dab).data())) {
+        generateDabPixels(di, resources, dab);
+
+        // the dab is cached before mirroring, so the mirrored dabs share it
+        KisDabMaskCache::instance()->addDab(di.maskCacheKey, *dab);
+    }
 
     if (!di.mirrorProperties.isEmpty()) {
         (*dab)->mirror(di.mirrorProperties.horizontalMirror,
@@ -7,6 +7,7 @@
 #ifndef KISDABCACHEUTILS_H
 #define KISDABCACHEUTILS_H
 
+#include <QByteArray>
 #include <QRect>
 #include <QSize>
 
@@ -91,6 +92,12 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    /**
+     * The key of the dab in KisDabMaskCache, empty if the dab should
+     * not be shared between the strokes
+     */
+    QByteArray maskCacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
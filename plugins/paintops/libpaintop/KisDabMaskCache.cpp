@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDabMaskCache.h"
+
+#include <QGlobalStatic>
+
+#include <KoColorSpace.h>
+#include <KoColorProfile.h>
+
+#include <kis_assert.h>
+#include <kis_fixed_paint_device.h>
+
+struct KisDabMaskCache::CachedDab
+{
+    CachedDab(KisFixedPaintDeviceSP _dab) : dab(_dab) {}
+    KisFixedPaintDeviceSP dab;
+};
+
+namespace {
+qint64 dabBytes(const KisFixedPaintDevice &dab)
+{
+    return qint64(dab.bounds().width()) * dab.bounds().height() * dab.pixelSize();
+}
+
+int dabCost(const KisFixedPaintDevice &dab)
+{
+    return int(dabBytes(dab) / 1024) + 1;
+}
+
+/**
+ * The copies of KisFixedPaintDevice may share the pixel buffer, which
+ * is not detached on writing, so the pixels are always copied explicitly
+ */
+void copyDabPixels(const KisFixedPaintDevice &src, KisFixedPaintDevice *dst)
+{
+    dst->setRect(src.bounds());
+    dst->lazyGrowBufferWithoutInitialization();
+    memcpy(dst->data(), src.constData(), dabBytes(src));
+}
+}
+
+Q_GLOBAL_STATIC(KisDabMaskCache, s_instance)
+
+KisDabMaskCache::KisDabMaskCache(int maxMemory)
+    : m_cache(maxMemory)
+{
+}
+
+KisDabMaskCache::~KisDabMaskCache()
+{
+}
+
+KisDabMaskCache *KisDabMaskCache::instance()
+{
+    return s_instance;
+}
+
+QByteArray KisDabMaskCache::fullKey(const QByteArray &key, const KoColorSpace *cs)
+{
+    QByteArray result = key;
+    result += cs->id().toLatin1();
+
+    if (cs->profile()) {
+        result += cs->profile()->name().toUtf8();
+    }
+
+    return result;
+}
+
+bool KisDabMaskCache::fetchDab(const QByteArray &key, KisFixedPaintDevice *dst)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(dst, false);
+
+    const QByteArray cacheKey = fullKey(key, dst->colorSpace());
+    KisFixedPaintDeviceSP cachedDab;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        CachedDab *item = m_cache.object(cacheKey);
+        if (!item) return false;
+
+        cachedDab = item->dab;
+    }
+
+    // the stored dab is never changed, so it can be copied without the lock
+    copyDabPixels(*cachedDab, dst);
+    return true;
+}
+
+void KisDabMaskCache::addDab(const QByteArray &key, KisFixedPaintDeviceSP dab)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dab);
+
+    const int cost = dabCost(*dab);
+    if (cost > maxMemory()) return;
+
+    KisFixedPaintDeviceSP dabCopy = new KisFixedPaintDevice(dab->colorSpace());
+    copyDabPixels(*dab, dabCopy.data());
+
+    const QByteArray cacheKey = fullKey(key, dab->colorSpace());
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(cacheKey, new CachedDab(dabCopy), cost);
+}
+
+void KisDabMaskCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int KisDabMaskCache::memoryUsage() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.totalCost();
+}
+
+int KisDabMaskCache::maxMemory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
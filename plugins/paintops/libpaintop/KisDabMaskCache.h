@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDABMASKCACHE_H
+#define KISDABMASKCACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+
+#include <kis_types.h>
+
+#include "kritapaintop_export.h"
+
+class KoColorSpace;
+class KisFixedPaintDevice;
+
+/**
+ * A least-recently-used cache of the rendered dabs that lives across the
+ * strokes. When the artist keeps painting with the same preset, the dabs
+ * of the new stroke are fetched from the cache instead of being
+ * regenerated.
+ *
+ * The dabs are looked up by a key built by KisDabCacheBase from the
+ * brush and the quantized dab parameters, so the cache may return a dab
+ * that slightly differs from the requested one, the same way as the
+ * in-stroke cache does. The total size of the stored dabs is bounded by
+ * maxMemory(), the least recently used dabs are dropped first.
+ *
+ * The cache is thread-safe.
+ */
+class PAINTOP_EXPORT KisDabMaskCache
+{
+public:
+    /**
+     * The default memory limit of the global cache in KiB
+     */
+    static const int DefaultMaxMemory = 64 * 1024;
+
+    KisDabMaskCache(int maxMemory = DefaultMaxMemory);
+    ~KisDabMaskCache();
+
+    static KisDabMaskCache *instance();
+
+    /**
+     * Copies the dab stored with \p key into \p dst. Only the dabs of
+     * the color space of \p dst are looked up.
+     *
+     * @return true if the dab has been found
+     */
+    bool fetchDab(const QByteArray &key, KisFixedPaintDevice *dst);
+
+    /**
+     * Stores a copy of \p dab with \p key. The dab is not stored if it
+     * doesn't fit the memory limit of the cache.
+     */
+    void addDab(const QByteArray &key, KisFixedPaintDeviceSP dab);
+
+    void clear();
+
+    /**
+     * @return the memory used by the stored dabs in KiB
+     */
+    int memoryUsage() const;
+
+    /**
+     * @return the memory limit of the cache in KiB
+     */
+    int maxMemory() const;
+
+private:
+    static QByteArray fullKey(const QByteArray &key, const KoColorSpace *cs);
+
+private:
+    struct CachedDab;
+
+    mutable QMutex m_mutex;
+    QCache<QByteArray, CachedDab> m_cache;
+};
+
+#endif // KISDABMASKCACHE_H
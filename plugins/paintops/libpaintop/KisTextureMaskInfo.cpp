@@ -232,6 +232,56 @@ void KisTextureMaskInfo::recalculateMask()
         m_mask->convertFromQImage(mask, 0);
     }
     m_maskBounds = QRect(0, 0, width, height);
+
+    /**
+     * Keep flat copies of the mask in both the formats used by the
+     * texturing modes, so that the dabs could be textured without
+     * creating and filling a temporary paint device
+     */
+    const KoColorSpace *alphaCs = KoColorSpaceRegistry::instance()->alpha8();
+    const KoColorSpace *colorCs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QVector<quint8> maskData(width * height * cs->pixelSize());
+    m_mask->readBytes(maskData.data(), m_maskBounds);
+
+    m_alphaMaskData.resize(width * height * alphaCs->pixelSize());
+    m_colorMaskData.resize(width * height * colorCs->pixelSize());
+
+    cs->convertPixelsTo(maskData.constData(), m_alphaMaskData.data(), alphaCs, width * height,
+                        KoColorConversionTransformation::internalRenderingIntent(),
+                        KoColorConversionTransformation::internalConversionFlags());
+
+    cs->convertPixelsTo(maskData.constData(), m_colorMaskData.data(), colorCs, width * height,
+                        KoColorConversionTransformation::internalRenderingIntent(),
+                        KoColorConversionTransformation::internalConversionFlags());
+}
+
+void KisTextureMaskInfo::readTiledRow(MaskFormat format, int x, int y, int numPixels, quint8 *dst) const
+{
+    const int width = m_maskBounds.width();
+    const int height = m_maskBounds.height();
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(width > 0 && height > 0);
+
+    const QVector<quint8> &data = format == AlphaMask ? m_alphaMaskData : m_colorMaskData;
+    const int pixelSize = format == AlphaMask ? 1 : 4;
+
+    auto wrap = [] (int value, int size) {
+        const int result = value % size;
+        return result >= 0 ? result : result + size;
+    };
+
+    const quint8 *srcRow = data.constData() + wrap(y, height) * width * pixelSize;
+    int srcX = wrap(x, width);
+
+    while (numPixels > 0) {
+        const int chunk = qMin(width - srcX, numPixels);
+        memcpy(dst, srcRow + srcX * pixelSize, chunk * pixelSize);
+
+        dst += chunk * pixelSize;
+        numPixels -= chunk;
+        srcX = 0;
+    }
 }
 
 bool KisTextureMaskInfo::hasAlpha() {
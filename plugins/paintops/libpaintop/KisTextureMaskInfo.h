@@ -11,6 +11,7 @@
 #include <kis_paint_device.h>
 #include <QSharedPointer>
 #include <QMutex>
+#include <QVector>
 
 
 #include <boost/operators.hpp>
@@ -40,6 +41,19 @@ public:
 
     QRect maskBounds() const;
 
+    enum MaskFormat {
+        AlphaMask, ///< one byte per pixel, the layout of alpha8()
+        ColorMask  ///< four bytes per pixel, the layout of rgb8()
+    };
+
+    /**
+     * Copies \p numPixels pixels of the mask, tiled over the whole
+     * plane, starting at (\p x, \p y) into \p dst. It is the same as
+     * filling a device of the corresponding color space with the mask,
+     * but reads directly from the flat buffers of the mask.
+     */
+    void readTiledRow(MaskFormat format, int x, int y, int numPixels, quint8 *dst) const;
+
     bool fillProperties(const KisPropertiesConfigurationSP setting, KisResourcesInterfaceSP resourcesInterface);
 
     void recalculateMask();
@@ -65,6 +79,9 @@ private:
     KisPaintDeviceSP m_mask;
     QRect m_maskBounds;
 
+    QVector<quint8> m_alphaMaskData;
+    QVector<quint8> m_colorMaskData;
+
 };
 
 typedef QSharedPointer<KisTextureMaskInfo> KisTextureMaskInfoSP;
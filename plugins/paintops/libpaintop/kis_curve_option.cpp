@@ -7,6 +7,7 @@
 #include "kis_curve_option.h"
 
 #include <QDomNode>
+#include <QVarLengthArray>
 
 #include "kis_algebra_2d.h"
 
@@ -398,7 +399,7 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
 
     if (m_useCurve) {
         QMap<DynamicSensorType, KisDynamicSensorSP>::const_iterator i;
-        QList<double> sensorValues;
+        QVarLengthArray<qreal, 16> sensorValues;
         for (i = m_sensorMap.constBegin(); i != m_sensorMap.constEnd(); ++i) {
             KisDynamicSensorSP s(i.value());
 
@@ -411,7 +412,7 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
                     components.absoluteOffset = valueFromCurve;
                     components.hasAbsoluteOffset =true;
                 } else {
-                    sensorValues << valueFromCurve;
+                    sensorValues.append(valueFromCurve);
                     components.hasScaling = true;
                 }
             }
@@ -423,9 +424,8 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
 
             if (m_curveMode == 1){           // add
                 components.scaling = 0;
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling += i;
+                for (qreal value : sensorValues) {
+                    components.scaling += value;
                 }
             } else if (m_curveMode == 2){    //max
                 components.scaling = *std::max_element(sensorValues.begin(), sensorValues.end());
@@ -439,9 +439,8 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
                 components.scaling = max-min;
 
             } else {                         //multuply - default
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling *= i;
+                for (qreal value : sensorValues) {
+                    components.scaling *= value;
                 }
             }
         }
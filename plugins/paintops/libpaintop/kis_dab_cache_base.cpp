@@ -7,6 +7,7 @@
 #include "kis_dab_cache_base.h"
 
 #include <KoColor.h>
+#include <KoColorSpace.h>
 #include "kis_color_source.h"
 #include "kis_paint_device.h"
 #include "kis_brush.h"
@@ -19,6 +20,10 @@
 
 #include <kundo2command.h>
 
+#include <QDataStream>
+#include <QDomDocument>
+#include <cmath>
+
 struct PrecisionValues {
     qreal angle;
     qreal sizeFrac;
@@ -82,7 +87,11 @@ struct KisDabCacheBase::Private {
 
     SavedDabParameters lastSavedDabParameters;
 
+    KisBrush *signatureBrush = 0;
+    QByteArray brushSignature;
+
     static qreal positiveFraction(qreal x);
+    const QByteArray& fetchBrushSignature(KisBrushSP brush);
 };
 
 
@@ -168,6 +177,61 @@ qreal KisDabCacheBase::Private::positiveFraction(qreal x) {
     return fraction;
 }
 
+const QByteArray& KisDabCacheBase::Private::fetchBrushSignature(KisBrushSP brush)
+{
+    /**
+     * The settings of the brush cannot change during the stroke, so
+     * the signature is recalculated only when the brush changes
+     */
+    if (signatureBrush != brush.data()) {
+        QDomDocument doc;
+        QDomElement element = doc.createElement("brush");
+        brush->toXML(doc, element);
+        doc.appendChild(element);
+
+        brushSignature = brush->md5() + doc.toByteArray();
+        signatureBrush = brush.data();
+    }
+
+    return brushSignature;
+}
+
+QByteArray KisDabCacheBase::maskCacheKey(const SavedDabParameters &params,
+                                         const QByteArray &brushSignature,
+                                         bool useColor,
+                                         int precisionLevel)
+{
+    const PrecisionValues &prec = precisionLevels[precisionLevel];
+
+    // the dab from the cache may be anywhere inside the bucket, the
+    // same way as the dab reused by the in-stroke cache
+    auto bucket = [] (qreal value, qreal step) {
+        return qint64(std::floor(value / step));
+    };
+
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+
+    stream << brushSignature
+           << params.index
+           << params.width
+           << params.height
+           << bucket(params.angle, prec.angle)
+           << bucket(params.subPixelX, prec.subPixel)
+           << bucket(params.subPixelY, prec.subPixel)
+           << bucket(params.softnessFactor, prec.softnessFactor)
+           << bucket(params.lightnessStrength, prec.lightnessStrength)
+           << bucket(params.ratio, prec.ratio);
+
+    if (useColor) {
+        stream << params.color.colorSpace()->id()
+               << QByteArray(reinterpret_cast<const char*>(params.color.data()),
+                             params.color.colorSpace()->pixelSize());
+    }
+
+    return key;
+}
+
 inline
 KisDabCacheBase::DabPosition
 KisDabCacheBase::calculateDabRect(KisBrushSP brush,
@@ -278,6 +342,22 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
         m_d->lastSavedDabParameters = newParams;
     }
 
+    /**
+     * Only the imprecise levels are shared between the strokes, the
+     * most precise one would never hit the cache anyway
+     */
+    const bool isImageStamp = resources->brush->brushApplication() == IMAGESTAMP;
+    const int maxPrecisionLevel = int(sizeof(precisionLevels) / sizeof(PrecisionValues)) - 1;
+
+    if (!*shouldUseCache && (di->solidColorFill || isImageStamp) &&
+        precisionLevel < maxPrecisionLevel) {
+
+        di->maskCacheKey = maskCacheKey(newParams,
+                                        m_d->fetchBrushSignature(resources->brush),
+                                        !isImageStamp,
+                                        precisionLevel);
+    }
+
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
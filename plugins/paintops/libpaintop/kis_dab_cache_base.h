@@ -98,6 +98,11 @@ private:
                                                qreal lightnessStrength,
                                                MirrorProperties mirrorProperties);
 
+    static QByteArray maskCacheKey(const SavedDabParameters &params,
+                                   const QByteArray &brushSignature,
+                                   bool useColor,
+                                   int precisionLevel);
+
     inline KisDabCacheBase::DabPosition
     calculateDabRect(KisBrushSP brush, const QPointF &cursorPoint,
                      KisDabShape,
@@ -367,7 +367,7 @@ qreal KisDynamicSensor::parameter(const KisPaintInformation& info)
     return parameter(info, m_curve, m_customCurve);
 }
 
-qreal KisDynamicSensor::parameter(const KisPaintInformation& info, const KisCubicCurve curve, const bool customCurve)
+qreal KisDynamicSensor::parameter(const KisPaintInformation& info, const KisCubicCurve &curve, const bool customCurve)
 {
     const qreal val = value(info);
     if (customCurve) {
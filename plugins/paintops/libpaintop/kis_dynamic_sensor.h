@@ -118,8 +118,12 @@ public:
      * curve -- a custom, temporary curve that should be used instead of the one for the sensor
      * customCurve -- if it's a new curve or not; should always be true if the function is called from outside
      * (aka not in parameter(info) function)
+     *
+     * The curve is passed by reference, so that the transfer table cached
+     * inside it is reused by all the dabs of the stroke instead of being
+     * rebuilt for a temporary copy on every call.
      */
-    qreal parameter(const KisPaintInformation& info, const KisCubicCurve curve, const bool customCurve);
+    qreal parameter(const KisPaintInformation& info, const KisCubicCurve &curve, const bool customCurve);
 
     /**
      * This function is call before beginning a stroke to reset the sensor.
@@ -28,9 +28,7 @@
 #include <KoResource.h>
 #include <KoResourceServerProvider.h>
 #include <kis_paint_device.h>
-#include <kis_fill_painter.h>
 #include <kis_painter.h>
-#include <kis_iterator_ng.h>
 #include <kis_fixed_paint_device.h>
 #include <KisGradientSlider.h>
 #include "kis_embedded_pattern_manager.h"
@@ -266,29 +264,27 @@ bool KisTextureProperties::applyingGradient(const KisPropertiesConfiguration *se
 void KisTextureProperties::applyLightness(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info) {
     if (!m_enabled) return;
 
-    KisPaintDeviceSP mask = m_maskInfo->mask();
-    const QRect maskBounds = m_maskInfo->maskBounds();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->hasMask());
 
-    KisPaintDeviceSP fillMaskDevice = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    const QRect maskBounds = m_maskInfo->maskBounds();
     const QRect rect = dab->bounds();
 
-    KIS_SAFE_ASSERT_RECOVER_RETURN(mask);
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
-    KisFillPainter fillMaskPainter(fillMaskDevice);
-    fillMaskPainter.fillRect(x - 1, y - 1, rect.width() + 2, rect.height() + 2, mask, maskBounds);
-    fillMaskPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
     quint8* dabData = dab->data();
 
-    KisSequentialConstIterator it(fillMaskDevice, QRect(x, y, rect.width(), rect.height()));
-    while (it.nextPixel()) {
-        const QRgb *maskQRgb = reinterpret_cast<const QRgb*>(it.oldRawData());
-        dab->colorSpace()->fillGrayBrushWithColorAndLightnessWithStrength(dabData, maskQRgb, dabData, pressure, 1);
-        dabData += dab->pixelSize();
+    QVector<QRgb> maskRow(rect.width());
+
+    for (int row = 0; row < rect.height(); ++row) {
+        m_maskInfo->readTiledRow(KisTextureMaskInfo::ColorMask, x, y + row, rect.width(),
+                                 reinterpret_cast<quint8*>(maskRow.data()));
+
+        for (int col = 0; col < rect.width(); ++col) {
+            dab->colorSpace()->fillGrayBrushWithColorAndLightnessWithStrength(dabData, &maskRow[col], dabData, pressure, 1);
+            dabData += dab->pixelSize();
+        }
     }
 }
 
@@ -296,23 +292,14 @@ void KisTextureProperties::applyGradient(KisFixedPaintDeviceSP dab, const QPoint
     if (!m_enabled) return;
 
     KIS_SAFE_ASSERT_RECOVER_RETURN(m_gradient && m_gradient->valid());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->hasMask());
 
-    KisPaintDeviceSP fillDevice = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
     QRect rect = dab->bounds();
-
-    KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KIS_SAFE_ASSERT_RECOVER_RETURN(mask);
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
-
-    KisFillPainter fillPainter(fillDevice);
-    fillPainter.fillRect(x - 1, y - 1, rect.width() + 2, rect.height() + 2, mask, maskBounds);
-    fillPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
     quint8* dabData = dab->data();
 
@@ -324,12 +311,16 @@ void KisTextureProperties::applyGradient(KisFixedPaintDeviceSP dab, const QPoint
     quint8* colors[2];
     m_cachedGradient.setColorSpace(dab->colorSpace()); //Change colorspace here so we don't have to convert each pixel drawn
 
-    KisHLineIteratorSP iter = fillDevice->createHLineIteratorNG(x, y, rect.width());
+    QVector<QRgb> maskRow(rect.width());
+
     for (int row = 0; row < rect.height(); ++row) {
+        m_maskInfo->readTiledRow(KisTextureMaskInfo::ColorMask, x, y + row, rect.width(),
+                                 reinterpret_cast<quint8*>(maskRow.data()));
+
         for (int col = 0; col < rect.width(); ++col) {
 
-            const QRgb* maskQRgb = reinterpret_cast<const QRgb*>(iter->oldRawData());
-            qreal gradientvalue = qreal(qGray(*maskQRgb))/255.0;//qreal(*iter->oldRawData()) / 255.0;
+            const QRgb* maskQRgb = &maskRow[col];
+            qreal gradientvalue = qreal(qGray(*maskQRgb))/255.0;
             KoColor paintcolor;
             paintcolor.setColor(m_cachedGradient.cachedAt(gradientvalue), dab->colorSpace());
             qreal paintOpacity = paintcolor.opacityF() * (qreal(qAlpha(*maskQRgb)) / 255.0);
@@ -339,10 +330,8 @@ void KisTextureProperties::applyGradient(KisFixedPaintDeviceSP dab, const QPoint
             colors[1] = dabColor.data();
             colorMix->mixColors(colors, colorWeights, 2, dabData);
 
-            iter->nextPixel();
             dabData += dab->pixelSize();
         }
-        iter->nextRow();
     }
 }
 
@@ -359,44 +348,56 @@ void KisTextureProperties::apply(KisFixedPaintDeviceSP dab, const QPoint &offset
         return;
     }
 
-    KisPaintDeviceSP fillDevice = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
-    QRect rect = dab->bounds();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->hasMask());
 
-    KisPaintDeviceSP mask = m_maskInfo->mask();
+    QRect rect = dab->bounds();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KIS_SAFE_ASSERT_RECOVER_RETURN(mask);
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
-
-    KisFillPainter fillPainter(fillDevice);
-    fillPainter.fillRect(x - 1, y - 1, rect.width() + 2, rect.height() + 2, mask, maskBounds);
-    fillPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
     quint8* dabData = dab->data();
 
-    KisHLineIteratorSP iter = fillDevice->createHLineIteratorNG(x, y, rect.width());
-    for (int row = 0; row < rect.height(); ++row) {
-        for (int col = 0; col < rect.width(); ++col) {
-            if (m_texturingMode == MULTIPLY) {
-                dab->colorSpace()->multiplyAlpha(dabData, quint8(*iter->oldRawData() * pressure), 1);
+    const KoColorSpace *dabCs = dab->colorSpace();
+    const int dabRowStride = rect.width() * dab->pixelSize();
+
+    QVector<quint8> maskRow(rect.width());
+
+    if (m_texturingMode == MULTIPLY) {
+        /**
+         * Scale the whole row of the mask by the pressure and apply it
+         * in one call. The result is the same as of multiplying every
+         * pixel separately with multiplyAlpha().
+         */
+        for (int row = 0; row < rect.height(); ++row) {
+            quint8 *mask = maskRow.data();
+            m_maskInfo->readTiledRow(KisTextureMaskInfo::AlphaMask, x, y + row, rect.width(), mask);
+
+            for (int col = 0; col < rect.width(); ++col) {
+                mask[col] = quint8(mask[col] * pressure);
             }
-            else {
-                int pressureOffset = (1.0 - pressure) * 255;
 
-                qint16 maskA = *iter->oldRawData() + pressureOffset;
-                quint8 dabA = dab->colorSpace()->opacityU8(dabData);
+            dabCs->applyAlphaU8Mask(dabData, mask, rect.width());
+            dabData += dabRowStride;
+        }
+    }
+    else {
+        const int pressureOffset = (1.0 - pressure) * 255;
+
+        for (int row = 0; row < rect.height(); ++row) {
+            const quint8 *mask = maskRow.data();
+            m_maskInfo->readTiledRow(KisTextureMaskInfo::AlphaMask, x, y + row, rect.width(), maskRow.data());
+
+            for (int col = 0; col < rect.width(); ++col) {
+                qint16 maskA = mask[col] + pressureOffset;
+                quint8 dabA = dabCs->opacityU8(dabData);
 
                 dabA = qMax(0, (qint16)dabA - maskA);
-                dab->colorSpace()->setOpacity(dabData, dabA, 1);
-            }
+                dabCs->setOpacity(dabData, dabA, 1);
 
-            iter->nextPixel();
-            dabData += dab->pixelSize();
+                dabData += dab->pixelSize();
+            }
         }
-        iter->nextRow();
     }
 }
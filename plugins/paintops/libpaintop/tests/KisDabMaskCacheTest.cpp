@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDabMaskCacheTest.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_fixed_paint_device.h>
+
+#include "KisDabMaskCache.h"
+
+namespace {
+KisFixedPaintDeviceSP createDab(const KoColorSpace *cs, int size, quint8 value)
+{
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, size, size));
+    dab->initialize(value);
+    return dab;
+}
+}
+
+void KisDabMaskCacheTest::testFetch()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisDabMaskCache cache;
+
+    KisFixedPaintDeviceSP dst = new KisFixedPaintDevice(cs);
+    QVERIFY(!cache.fetchDab("dab", dst.data()));
+
+    KisFixedPaintDeviceSP dab = createDab(cs, 16, 42);
+    cache.addDab("dab", dab);
+
+    // changing the original dab doesn't change the cached one
+    dab->initialize(0);
+
+    QVERIFY(cache.fetchDab("dab", dst.data()));
+    QCOMPARE(dst->bounds(), QRect(0, 0, 16, 16));
+    QCOMPARE(dst->data()[0], quint8(42));
+    QCOMPARE(dst->data()[16 * 16 * cs->pixelSize() - 1], quint8(42));
+
+    QVERIFY(!cache.fetchDab("other", dst.data()));
+
+    cache.clear();
+    QVERIFY(!cache.fetchDab("dab", dst.data()));
+    QCOMPARE(cache.memoryUsage(), 0);
+}
+
+void KisDabMaskCacheTest::testColorSpace()
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+    KisDabMaskCache cache;
+
+    cache.addDab("dab", createDab(rgb8, 16, 42));
+
+    KisFixedPaintDeviceSP dst16 = new KisFixedPaintDevice(rgb16);
+    QVERIFY(!cache.fetchDab("dab", dst16.data()));
+
+    KisFixedPaintDeviceSP dst8 = new KisFixedPaintDevice(rgb8);
+    QVERIFY(cache.fetchDab("dab", dst8.data()));
+}
+
+void KisDabMaskCacheTest::testMemoryLimit()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // every 32x32 RGBA dab needs 5 KiB of the 12 KiB budget
+    KisDabMaskCache cache(12);
+    QCOMPARE(cache.maxMemory(), 12);
+
+    cache.addDab("dab1", createDab(cs, 32, 1));
+    cache.addDab("dab2", createDab(cs, 32, 2));
+
+    KisFixedPaintDeviceSP dst = new KisFixedPaintDevice(cs);
+
+    // make the first dab the most recently used one
+    QVERIFY(cache.fetchDab("dab1", dst.data()));
+
+    cache.addDab("dab3", createDab(cs, 32, 3));
+    QVERIFY(cache.memoryUsage() <= cache.maxMemory());
+
+    QVERIFY(cache.fetchDab("dab1", dst.data()));
+    QVERIFY(!cache.fetchDab("dab2", dst.data()));
+    QVERIFY(cache.fetchDab("dab3", dst.data()));
+
+    // the dabs bigger than the whole cache are not stored
+    cache.addDab("huge", createDab(cs, 64, 4));
+    QVERIFY(!cache.fetchDab("huge", dst.data()));
+    QVERIFY(cache.fetchDab("dab3", dst.data()));
+}
+
+QTEST_MAIN(KisDabMaskCacheTest)
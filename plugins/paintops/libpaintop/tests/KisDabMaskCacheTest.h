@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDABMASKCACHETEST_H
+#define KISDABMASKCACHETEST_H
+
+#include <QtTest>
+
+class KisDabMaskCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFetch();
+    void testColorSpace();
+    void testMemoryLimit();
+};
+
+#endif // KISDABMASKCACHETEST_H
@@ -75,6 +75,12 @@ KisSpacingInformation KisMyPaintPaintOp::paintAt(const KisPaintInformation& info
 
     mypaint_brush_set_base_value(m_brush->brush(), MYPAINT_BRUSH_SETTING_RADIUS_LOGARITHMIC, log(radius));
 
+    /**
+     * The dabs of the stroke are queued by the surface and
+     * drawn in a single batch in the end of the atomic section
+     */
+    mypaint_surface_begin_atomic(m_surface->surface());
+
     m_isStrokeStarted = mypaint_brush_get_state(m_brush->brush(), MYPAINT_BRUSH_STATE_STROKE_STARTED);
     if (!m_isStrokeStarted) {
 
@@ -90,6 +96,9 @@ KisSpacingInformation KisMyPaintPaintOp::paintAt(const KisPaintInformation& info
     mypaint_brush_stroke_to(m_brush->brush(), m_surface->surface(), info.pos().x(), info.pos().y(), info.pressure(),
                            info.xTilt(), info.yTilt(), m_dtime);
 
+    MyPaintRectangle changedRect;
+    mypaint_surface_end_atomic(m_surface->surface(), &changedRect);
+
     m_previousTime = info.currentTime();
 
     return computeSpacing(info, lodScale);
@@ -11,9 +11,11 @@
 #include <KoColorSpaceMaths.h>
 #include <QtMath>
 #include <kis_algebra_2d.h>
+#include <kis_assert.h>
 #include <kis_cross_device_color_picker.h>
 #include <kis_image.h>
 #include <kis_node.h>
+#include <kis_random_accessor_ng.h>
 #include <kis_sequential_iterator.h>
 #include <qmath.h>
 
@@ -37,12 +39,15 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
 
     m_surface->draw_dab = this->draw_dab;
     m_surface->get_color = this->get_color;
+    m_surface->begin_atomic = this->begin_atomic;
+    m_surface->end_atomic = this->end_atomic;
     m_surface->destroy = destroy_internal_surface_callback;
     m_surface->bitDepth = painter->device()->colorSpace()->channels()[0]->channelValueType();
 }
 
 KisMyPaintSurface::~KisMyPaintSurface()
 {
+    flushDabs();
     mypaint_surface_unref(m_surface);
 }
 
@@ -50,29 +55,110 @@ int KisMyPaintSurface::draw_dab(MyPaintSurface *self, float x, float y, float ra
                                 float color_b, float opaque, float hardness, float color_a,
                                 float aspect_ratio, float angle, float lock_alpha, float colorize) {
 
+    Q_UNUSED(lock_alpha);
+
     MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    KisMyPaintSurface *owner = surface->m_owner;
 
-    if (surface->bitDepth == KoChannelInfo::UINT8) {
-        return surface->m_owner->drawDabImpl<quint8>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+    /*GIMP's draw_dab code*/
+    const double angle_rad = kisDegreesToRadians(angle);
+
+    Dab dab;
+    dab.x = x;
+    dab.y = y;
+    dab.radius = radius;
+    dab.color_r = color_r;
+    dab.color_g = color_g;
+    dab.color_b = color_b;
+    dab.color_a = color_a;
+
+    dab.one_over_radius2 = 1.0f / (radius * radius);
+    dab.cs = cos(angle_rad);
+    dab.sn = sin(angle_rad);
+
+    hardness = CLAMP (hardness, 0.0f, 1.0f);
+    dab.hardness = hardness;
+    dab.segment1_slope = -(1.0f / hardness - 1.0f);
+    dab.segment2_slope = -hardness / (1.0f - hardness);
+    aspect_ratio = max(1.0f, aspect_ratio);
+    dab.aspect_ratio = aspect_ratio;
+
+    float r_aa_start = radius - 1.0f;
+    r_aa_start = max(r_aa_start, 0.0f);
+    dab.r_aa_start = (r_aa_start * r_aa_start) / aspect_ratio;
+
+    dab.normal_mode = opaque * (1.0f - colorize);
+    dab.colorize = opaque * colorize;
+
+    const QPoint pt = QPoint(x - radius - 1, y - radius - 1);
+    const QSize sz = QSize(2 * (radius+1), 2 * (radius+1));
+    dab.rect = QRect(pt, sz);
+
+    if (owner->m_atomicDepth > 0) {
+        owner->m_queuedDabs.append(dab);
+    } else {
+        owner->drawDabs(QVector<Dab>() << dab);
     }
-    else if (surface->bitDepth == KoChannelInfo::UINT16) {
-        return surface->m_owner->drawDabImpl<quint16>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+
+    return 1;
+}
+
+void KisMyPaintSurface::begin_atomic(MyPaintSurface *self)
+{
+    MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    surface->m_owner->m_atomicDepth++;
+}
+
+void KisMyPaintSurface::end_atomic(MyPaintSurface *self, MyPaintRectangle *roi)
+{
+    MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    KisMyPaintSurface *owner = surface->m_owner;
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(owner->m_atomicDepth > 0);
+    owner->m_atomicDepth = qMax(0, owner->m_atomicDepth - 1);
+
+    if (roi) {
+        QRect changedRect;
+        Q_FOREACH (const Dab &dab, owner->m_queuedDabs) {
+            changedRect |= dab.rect;
+        }
+
+        roi->x = changedRect.x();
+        roi->y = changedRect.y();
+        roi->width = changedRect.width();
+        roi->height = changedRect.height();
+    }
+
+    if (!owner->m_atomicDepth) {
+        owner->flushDabs();
+    }
+}
+
+void KisMyPaintSurface::flushDabs()
+{
+    if (m_queuedDabs.isEmpty()) return;
+
+    drawDabs(m_queuedDabs);
+    m_queuedDabs.clear();
+}
+
+void KisMyPaintSurface::drawDabs(const QVector<Dab> &dabs)
+{
+    const KoChannelInfo::enumChannelValueType bitDepth = m_surface->bitDepth;
+
+    if (bitDepth == KoChannelInfo::UINT8) {
+        drawDabsImpl<quint8>(dabs);
+    }
+    else if (bitDepth == KoChannelInfo::UINT16) {
+        drawDabsImpl<quint16>(dabs);
     }
 #if defined HAVE_OPENEXR
-    else if (surface->bitDepth == KoChannelInfo::FLOAT16) {
-        return surface->m_owner->drawDabImpl<half>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+    else if (bitDepth == KoChannelInfo::FLOAT16) {
+        drawDabsImpl<half>(dabs);
     }
 #endif
     else {
-        return surface->m_owner->drawDabImpl<float>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+        drawDabsImpl<float>(dabs);
     }
 }
 
@@ -80,6 +166,10 @@ void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float
                             float * color_r, float * color_g, float * color_b, float * color_a) {
 
     MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+
+    // the sampled area may be covered by the queued dabs
+    surface->m_owner->flushDabs();
+
     if (surface->bitDepth == KoChannelInfo::UINT8) {
         surface->m_owner->getColorImpl<quint8>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
@@ -97,126 +187,171 @@ void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float
 }
 
 
-/*GIMP's draw_dab and get_color code*/
 template <typename channelType>
-int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                float color_b, float opaque, float hardness, float color_a,
-                                float aspect_ratio, float angle, float lock_alpha, float colorize) {
-
-    const float one_over_radius2 = 1.0f / (radius * radius);
-    const double angle_rad = kisDegreesToRadians(angle);
-    const float cs = cos(angle_rad);
-    const float sn = sin(angle_rad);
-    float normal_mode;
-    float segment1_slope;
-    float segment2_slope;
-    float r_aa_start;
+void KisMyPaintSurface::drawDabsImpl(const QVector<Dab> &dabs) {
+
+    /**
+     * The area of the dabs is walked tile by tile, and all the dabs
+     * overlapping a tile are blended directly into the memory of the
+     * tile. That is, every tile is fetched only once for the whole batch
+     * of dabs, and the dabs are still applied to every pixel in their
+     * original order.
+     */
 
-    hardness = CLAMP (hardness, 0.0f, 1.0f);
-    segment1_slope = -(1.0f / hardness - 1.0f);
-    segment2_slope = -hardness / (1.0f - hardness);
-    aspect_ratio = max(1.0f, aspect_ratio);
+    KisPaintDeviceSP device = painter()->device();
+    const int pixelSize = device->pixelSize();
 
-    r_aa_start = radius - 1.0f;
-    r_aa_start = max(r_aa_start, 0.0f);
-    r_aa_start = (r_aa_start * r_aa_start) / aspect_ratio;
+    QRect totalRect;
+    Q_FOREACH (const Dab &dab, dabs) {
+        totalRect |= dab.rect;
+    }
 
-    normal_mode = opaque * (1.0f - colorize);
-    colorize = opaque * colorize;
+    KisRandomAccessorSP dstIt = device->createRandomAccessorNG();
 
-    const KoColorSpace *colorSpace = painter()->device()->colorSpace();
-    const QPoint pt = QPoint(x - radius - 1, y - radius - 1);
-    const QSize sz = QSize(2 * (radius+1), 2 * (radius+1));
+    qint32 dstY = totalRect.y();
+    qint32 rowsRemaining = totalRect.height();
 
-    const QRect dabRectAligned = QRect(pt, sz);
-    const QPointF center = QPointF(x, y);
+    while (rowsRemaining > 0) {
+        qint32 dstX = totalRect.x();
 
-    KisAlgebra2D::OuterCircle outer(center, radius);
+        const qint32 rows = qMin(rowsRemaining, dstIt->numContiguousRows(dstY));
+        qint32 columnsRemaining = totalRect.width();
 
-    KisSequentialIterator it(painter()->device(), dabRectAligned);
+        while (columnsRemaining > 0) {
+            const qint32 columns = qMin(columnsRemaining, dstIt->numContiguousColumns(dstX));
+            const QRect tileRect(dstX, dstY, columns, rows);
 
-    while(it.nextPixel()) {
+            const qint32 rowStride = dstIt->rowStride(dstX, dstY);
+            dstIt->moveTo(dstX, dstY);
+            quint8 *tileData = dstIt->rawData();
 
-        QPoint pt(it.x(), it.y());
+            Q_FOREACH (const Dab &dab, dabs) {
+                const QRect rc = tileRect & dab.rect;
+                if (rc.isEmpty()) continue;
 
-        if(outer.fadeSq(pt) > 1.0f)
-            continue;
+                quint8 *data = tileData +
+                    (rc.y() - dstY) * rowStride +
+                    (rc.x() - dstX) * pixelSize;
 
-        float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
-        float opacity;
+                blendDab<channelType>(dab, rc, data, rowStride, pixelSize);
+            }
 
-        if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
-        }
-        else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
+            dstX += columns;
+            columnsRemaining -= columns;
         }
 
-        base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
-        alpha = base_alpha * normal_mode;
+        dstY += rows;
+        rowsRemaining -= rows;
+    }
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
-        float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+    Q_FOREACH (const Dab &dab, dabs) {
+        painter()->addDirtyRect(dab.rect);
+    }
+}
 
-        b = nativeArray[0]/unitValue;
-        g = nativeArray[1]/unitValue;
-        r = nativeArray[2]/unitValue;
-        dst_alpha = nativeArray[3]/unitValue;
+/*GIMP's draw_dab and get_color code*/
+template <typename channelType>
+void KisMyPaintSurface::blendDab(const Dab &dab, const QRect &rc, quint8 *data, int rowStride, int pixelSize) {
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
-        }
+    const float x = dab.x;
+    const float y = dab.y;
 
-        a = alpha * (color_a - dst_alpha) + dst_alpha;
+    const float color_r = dab.color_r;
+    const float color_g = dab.color_g;
+    const float color_b = dab.color_b;
+    const float color_a = dab.color_a;
 
-        if (a > 0.0f) {
+    const float normal_mode = dab.normal_mode;
+    const float colorize = dab.colorize;
 
-            float src_term = (alpha * color_a) / a;
-            float dst_term = 1.0f - src_term;
-            r = color_r * src_term + r * dst_term;
-            g = color_g * src_term + g * dst_term;
-            b = color_b * src_term + b * dst_term;
-        }
+    const QPointF center = QPointF(x, y);
+    KisAlgebra2D::OuterCircle outer(center, dab.radius);
 
-        if (colorize > 0.0f && base_alpha > 0.0f) {
+    const float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
 
-            alpha = base_alpha * colorize;
-            a = alpha + dst_alpha - alpha * dst_alpha;
+    for (int yp = rc.top(); yp <= rc.bottom(); yp++) {
+        quint8 *pixel = data;
 
-            if (a > 0.0f) {
+        for (int xp = rc.left(); xp <= rc.right(); xp++, pixel += pixelSize) {
+
+            QPoint pt(xp, yp);
+
+            if(outer.fadeSq(pt) > 1.0f)
+                continue;
+
+            float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
+
+            if (dab.radius < 3.0) {
+                rr = calculate_rr_antialiased (xp, yp, x, y, dab.aspect_ratio, dab.sn, dab.cs, dab.one_over_radius2, dab.r_aa_start);
+            }
+            else {
+                rr = calculate_rr (xp, yp, x, y, dab.aspect_ratio, dab.sn, dab.cs, dab.one_over_radius2);
+            }
 
-                float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
-                float out_r = r, out_g = g, out_b = b;
+            base_alpha = calculate_alpha_for_rr (rr, dab.hardness, dab.segment1_slope, dab.segment2_slope);
+            alpha = base_alpha * normal_mode;
+
+            channelType* nativeArray = reinterpret_cast<channelType*>(pixel);
+
+            b = nativeArray[0]/unitValue;
+            g = nativeArray[1]/unitValue;
+            r = nativeArray[2]/unitValue;
+            dst_alpha = nativeArray[3]/unitValue;
+
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
+
+            a = alpha * (color_a - dst_alpha) + dst_alpha;
+
+            if (a > 0.0f) {
 
-                float src_term = alpha / a;
+                float src_term = (alpha * color_a) / a;
                 float dst_term = 1.0f - src_term;
+                r = color_r * src_term + r * dst_term;
+                g = color_g * src_term + g * dst_term;
+                b = color_b * src_term + b * dst_term;
+            }
+
+            if (colorize > 0.0f && base_alpha > 0.0f) {
+
+                alpha = base_alpha * colorize;
+                a = alpha + dst_alpha - alpha * dst_alpha;
+
+                if (a > 0.0f) {
 
-                RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
-                RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
+                    float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
+                    float out_r = r, out_g = g, out_b = b;
 
-                out_h = pixel_h;
-                out_s = pixel_s;
+                    float src_term = alpha / a;
+                    float dst_term = 1.0f - src_term;
 
-                HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+                    RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
+                    RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
 
-                r = (float)out_r * src_term + r * dst_term;
-                g = (float)out_g * src_term + g * dst_term;
-                b = (float)out_b * src_term + b * dst_term;
+                    out_h = pixel_h;
+                    out_s = pixel_s;
+
+                    HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+
+                    r = (float)out_r * src_term + r * dst_term;
+                    g = (float)out_g * src_term + g * dst_term;
+                    b = (float)out_b * src_term + b * dst_term;
+                }
             }
-        }
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
+
+            nativeArray[0] = b * unitValue;
+            nativeArray[1] = g * unitValue;
+            nativeArray[2] = r * unitValue;
+            nativeArray[3] = a * unitValue;
         }
 
-        nativeArray[0] = b * unitValue;
-        nativeArray[1] = g * unitValue;
-        nativeArray[2] = r * unitValue;
-        nativeArray[3] = a * unitValue;
+        data += rowStride;
     }
-
-    painter()->addDirtyRect(dabRectAligned);
-    return 1;
 }
 
 template <typename channelType>
@@ -8,6 +8,7 @@
 #define KIS_MYPAINT_SURFACE_H
 
 #include <QObject>
+#include <QVector>
 
 #include <kis_paint_device.h>
 #include <kis_painter.h>
@@ -46,10 +47,21 @@ public:
     static void get_color(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a);
 
-    template <typename channelType>
-    int drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                    float color_b, float opaque, float hardness, float color_a,
-                                    float aspect_ratio, float angle, float lock_alpha, float colorize);
+    /**
+     * mypaint_surface_begin_atomic:
+     *
+     * Starts queueing the dabs. The queued dabs are drawn in
+     * end_atomic() or before the next get_color() call.
+     */
+    static void begin_atomic(MyPaintSurface *self);
+
+    static void end_atomic(MyPaintSurface *self, MyPaintRectangle *roi);
+
+    /**
+     * Draws all the dabs queued since the beginning of the atomic
+     * section into the device of the painter
+     */
+    void flushDabs();
 
     template <typename channelType>
     void getColorImpl(MyPaintSurface *self, float x, float y, float radius,
@@ -74,11 +86,48 @@ public:
 
     MyPaintSurface* surface();
 
+private:
+    /**
+     * The parameters of a dab, precalculated for the blending of
+     * its pixels
+     */
+    struct Dab {
+        QRect rect;
+        float x;
+        float y;
+        float radius;
+        float color_r;
+        float color_g;
+        float color_b;
+        float color_a;
+        float hardness;
+        float segment1_slope;
+        float segment2_slope;
+        float aspect_ratio;
+        float sn;
+        float cs;
+        float one_over_radius2;
+        float r_aa_start;
+        float normal_mode;
+        float colorize;
+    };
+
+    void drawDabs(const QVector<Dab> &dabs);
+
+    template <typename channelType>
+    void drawDabsImpl(const QVector<Dab> &dabs);
+
+    template <typename channelType>
+    void blendDab(const Dab &dab, const QRect &rc, quint8 *data, int rowStride, int pixelSize);
+
 private:
     KisPainter *m_painter;
     KisPaintDeviceSP m_imageDevice;
     MyPaintSurfaceInternal *m_surface;
     KisImageSP m_image;
+
+    int m_atomicDepth = 0;
+    QVector<Dab> m_queuedDabs;
 };
 
 #endif // KIS_MYPAINT_SURFACE_H
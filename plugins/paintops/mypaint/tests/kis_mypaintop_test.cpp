@@ -78,6 +78,47 @@ void KisMyPaintOpTest::testGetColor() {
     QVERIFY(qFuzzyCompare((float)qRound(a), 1.0L));
 }
 
+void KisMyPaintOpTest::testBatchedDabs() {
+
+    KisPaintDeviceSP dst1 = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    KisPaintDeviceSP dst2 = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    KisPainter painter1(dst1);
+    KisPainter painter2(dst2);
+
+    QScopedPointer<KisMyPaintSurface> surface1(new KisMyPaintSurface(&painter1, dst1));
+    QScopedPointer<KisMyPaintSurface> surface2(new KisMyPaintSurface(&painter2, dst2));
+
+    auto drawDabs = [] (KisMyPaintSurface *surface) {
+        for (int i = 0; i < 20; i++) {
+            surface->draw_dab(surface->surface(), 50 + 7.3 * i, 60 + 3.1 * i, 2 + 2.5 * i,
+                              0.1 * (i % 10), 0.5, 1.0 - 0.05 * i, 0.7, 0.5, 1, 1.5, 15 * i, 0, (i % 3) * 0.3);
+        }
+    };
+
+    drawDabs(surface1.data());
+
+    mypaint_surface_begin_atomic(surface2->surface());
+    drawDabs(surface2.data());
+    QVERIFY(dst2->exactBounds().isEmpty());
+
+    MyPaintRectangle roi;
+    mypaint_surface_end_atomic(surface2->surface(), &roi);
+
+    QCOMPARE(dst2->exactBounds(), dst1->exactBounds());
+    QVERIFY(QRect(roi.x, roi.y, roi.width, roi.height).contains(dst1->exactBounds()));
+
+    const QRect rc = dst1->exactBounds();
+    QImage image1 = dst1->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height());
+    QImage image2 = dst2->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height());
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, image1, image2)) {
+        image2.save("mypaint_test_batched_dabs.png");
+        QFAIL(QString("Failed to create identical image, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 void KisMyPaintOpTest::testLoading() {
 
     QScopedPointer<KisMyPaintPaintOpPreset> brush (new KisMyPaintPaintOpPreset(QString(FILES_DATA_DIR) + QDir::separator() + "basic.myb"));
@@ -13,6 +13,7 @@
 #include <KoShapeManager.h>
 #include <KoShapeContainer.h>
 #include <KoShapeContainerModel.h>
+#include <KoShapePaintingContext.h>
 #include <KoCanvasResourceProvider.h>
 #include <commands/KoShapeMoveCommand.h>
 #include <KoSnapGuide.h>
@@ -35,8 +36,16 @@ ShapeMoveStrategy::ShapeMoveStrategy(KoToolBase *tool, KoSelection *selection, c
         m_selectedShapes << shape;
         m_previousPositions << shape->absolutePosition(KoFlake::Center);
         m_newPositions << shape->absolutePosition(KoFlake::Center);
+        m_previousBoundingRects << shape->boundingRect();
     }
 
+    /**
+     * On the OpenGL canvas the moved shapes are painted right on the canvas,
+     * where QPainter fills and strokes them on the GPU, and they are
+     * rasterized into the layer only once, when the interaction ends.
+     */
+    m_paintPreview = m_canvas->canvasIsOpenGL();
+
     KoFlake::AnchorPosition anchor =
             KoFlake::AnchorPosition(
                 m_canvas->resourceManager()->resource(KoFlake::HotPosition).toInt());
@@ -71,6 +80,8 @@ void ShapeMoveStrategy::moveSelection(const QPointF &diff)
 {
     Q_ASSERT(m_newPositions.count());
 
+    QRectF previewDirtyRect;
+
     int i = 0;
     Q_FOREACH (KoShape *shape, m_selectedShapes) {
         QPointF delta = m_previousPositions.at(i) + diff - shape->absolutePosition(KoFlake::Center);
@@ -83,9 +94,18 @@ void ShapeMoveStrategy::moveSelection(const QPointF &diff)
 
         const QRectF oldDirtyRect = shape->boundingRect();
         shape->setAbsolutePosition(newPos, KoFlake::Center);
-        shape->updateAbsolute(oldDirtyRect | oldDirtyRect.translated(delta));
+
+        if (m_paintPreview) {
+            previewDirtyRect |= oldDirtyRect | oldDirtyRect.translated(delta);
+        } else {
+            shape->updateAbsolute(oldDirtyRect | oldDirtyRect.translated(delta));
+        }
         i++;
     }
+
+    if (m_paintPreview) {
+        m_canvas->updateCanvas(previewDirtyRect);
+    }
 }
 
 KUndo2Command *ShapeMoveStrategy::createCommand()
@@ -100,10 +120,38 @@ KUndo2Command *ShapeMoveStrategy::createCommand()
 void ShapeMoveStrategy::finishInteraction(Qt::KeyboardModifiers modifiers)
 {
     Q_UNUSED(modifiers);
+
+    if (!m_paintPreview) return;
+
+    m_paintPreview = false;
+
+    int i = 0;
+    Q_FOREACH (KoShape *shape, m_selectedShapes) {
+        shape->updateAbsolute(m_previousBoundingRects.at(i) | shape->boundingRect());
+        i++;
+    }
+}
+
+void ShapeMoveStrategy::cancelInteraction()
+{
+    // undoing the move command updates both the initial and the current positions
+    m_paintPreview = false;
+    KoInteractionStrategy::cancelInteraction();
 }
 
 void ShapeMoveStrategy::paint(QPainter &painter, const KoViewConverter &converter)
 {
-    Q_UNUSED(painter);
-    Q_UNUSED(converter);
+    if (!m_paintPreview) return;
+
+    painter.save();
+    painter.setTransform(converter.documentToView(), true);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    KoShapePaintingContext paintContext(m_canvas, false);
+
+    Q_FOREACH (KoShape *shape, m_selectedShapes) {
+        KoShapeManager::renderSingleShape(shape, painter, paintContext);
+    }
+
+    painter.restore();
 }
@@ -39,11 +39,14 @@ public:
     void handleMouseMove(const QPointF &mouseLocation, Qt::KeyboardModifiers modifiers) override;
     KUndo2Command *createCommand() override;
     void finishInteraction(Qt::KeyboardModifiers modifiers) override;
+    void cancelInteraction() override;
     void paint(QPainter &painter, const KoViewConverter &converter) override;
 private:
     void moveSelection(const QPointF &diff);
     QList<QPointF> m_previousPositions;
     QList<QPointF> m_newPositions;
+    QList<QRectF> m_previousBoundingRects;
+    bool m_paintPreview = false;
     QPointF m_start, m_finalMove, m_initialOffset;
     QList<KoShape *> m_selectedShapes;
     QPointer<KoCanvasBase> m_canvas;
@@ -30,6 +30,8 @@
 //#include "kis_random_accessor_ng.h"
 
 #include <QList>
+#include <QThread>
+#include <QtConcurrent>
 #include <kis_transform_worker.h>
 #include <kis_filter_strategy.h>
 #include "KoColor.h"
@@ -46,6 +48,14 @@ const quint8 MASK_CLEAR = 0;
 
 class MaskedImage; //forward decl for the forward decl below
 template <typename T> float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo);
+template <typename T, int channels> float rowDistance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo, int numPixels, float maskedCost);
+
+//number of bands the axis of size \p size is split into for the parallel processing
+int parallelBandsCount(int size)
+{
+    const int minBandSize = 16;
+    return qBound(1, size / minBandSize, 2 * QThread::idealThreadCount());
+}
 
 
 class ImageView
@@ -200,6 +210,7 @@ class MaskedImage : public KisShared
 private:
 
     template <typename T> friend float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo);
+    template <typename T, int channels> friend float rowDistance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo, int numPixels, float maskedCost);
 
     QRect imageSize;
     int nChannels;
@@ -238,6 +249,9 @@ private:
 public:
     std::function< float(const MaskedImage&, int, int, const MaskedImage& , int , int ) > distance;
 
+    //sums the distances of \p numPixels consecutive pixels of a row, the masked pixels cost \p maskedCost
+    std::function< float(const MaskedImage&, int, int, const MaskedImage& , int , int, int, float ) > rowDistance;
+
     void toPaintDevice(KisPaintDeviceSP imageDev, QRect rect, KisSelectionSP selection)
     {
         if (!selection) {
@@ -274,18 +288,43 @@ public:
 
         //Use RGB traits to assign actual pixel data types.
         distance = &distance_impl<KoRgbU8Traits::channels_type>;
+        setRowDistance<KoRgbU8Traits::channels_type>();
 
-        if( colorDepthId == Integer16BitsColorDepthID )
+        if( colorDepthId == Integer16BitsColorDepthID ) {
             distance = &distance_impl<KoRgbU16Traits::channels_type>;
+            setRowDistance<KoRgbU16Traits::channels_type>();
+        }
 #ifdef HAVE_OPENEXR
-        if( colorDepthId == Float16BitsColorDepthID )
+        if( colorDepthId == Float16BitsColorDepthID ) {
             distance = &distance_impl<KoRgbF16Traits::channels_type>;
+            setRowDistance<KoRgbF16Traits::channels_type>();
+        }
 #endif
-        if( colorDepthId == Float32BitsColorDepthID )
+        if( colorDepthId == Float32BitsColorDepthID ) {
             distance = &distance_impl<KoRgbF32Traits::channels_type>;
+            setRowDistance<KoRgbF32Traits::channels_type>();
+        }
 
-        if( colorDepthId == Float64BitsColorDepthID )
+        if( colorDepthId == Float64BitsColorDepthID ) {
             distance = &distance_impl<KoRgbF64Traits::channels_type>;
+            setRowDistance<KoRgbF64Traits::channels_type>();
+        }
+    }
+
+    //the kernels with the fixed channel count let the compiler vectorize the channels loop
+    template <typename T> void setRowDistance()
+    {
+        switch (nChannels) {
+        case 3:
+            rowDistance = &rowDistance_impl<T, 3>;
+            break;
+        case 4:
+            rowDistance = &rowDistance_impl<T, 4>;
+            break;
+        default:
+            rowDistance = &rowDistance_impl<T, 0>;
+            break;
+        }
     }
 
     MaskedImage(KisPaintDeviceSP _imageDev, KisPaintDeviceSP _maskDev, QRect _maskRect)
@@ -382,6 +421,7 @@ public:
         clone->cs = this->cs;
         clone->csMask = this->csMask;
         clone->distance = this->distance;
+        clone->rowDistance = this->rowDistance;
         return clone;
     }
 
@@ -439,7 +479,7 @@ public:
         cs->fromNormalisedChannelsValue(imageData(x, y), value);
     }
 
-    inline void mixColors(std::vector< quint8* > pixels, std::vector< float > w, float wsum,  quint8* dst)
+    inline void mixColors(const std::vector< quint8* > &pixels, const std::vector< float > &w, float wsum,  quint8* dst)
     {
         const KoMixColorsOp* mixOp = cs->mixColorsOp();
 
@@ -492,6 +532,42 @@ template <typename T> float distance_impl(const MaskedImage& my, int x, int y, c
     return dsq / (KoColorSpaceMathsTraits<float>::unitValue * KoColorSpaceMathsTraits<float>::unitValue / MAX_DIST );
 }
 
+//Row version of distance_impl(). Produces the sum of the distances of the pixels of the two rows, when any of the
+//two pixels is masked, maskedCost is added instead. When channels is zero, the channel count is taken from the image.
+template <typename T, int channels> float rowDistance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo, int numPixels, float maskedCost)
+{
+    const int nchannels = channels > 0 ? channels : my.channelCount();
+    const int pixelSize = my.imageData.pixel_size();
+    const quint8 *v1 = my.imageData(x, y);
+    const quint8 *v2 = other.imageData(xo, yo);
+    const quint8 *m1 = my.maskData(x, y);
+    const quint8 *m2 = other.maskData(xo, yo);
+
+    float dsq = 0;
+    int numMasked = 0;
+
+    for (int i = 0; i < numPixels; i++, v1 += pixelSize, v2 += pixelSize) {
+        if (m1[i] > MASK_CLEAR || m2[i] > MASK_CLEAR) {
+            numMasked++;
+            continue;
+        }
+
+        const T *c1 = reinterpret_cast<const T*>(v1);
+        const T *c2 = reinterpret_cast<const T*>(v2);
+
+        float pixelDsq = 0;
+        for (int chan = 0; chan < nchannels; chan++) {
+            //It's very important not to lose precision in the next line
+            float v = ((float)c1[chan] - (float)c2[chan]);
+            pixelDsq += v * v;
+        }
+        dsq += pixelDsq;
+    }
+
+    return dsq / (KoColorSpaceMathsTraits<float>::unitValue * KoColorSpaceMathsTraits<float>::unitValue / MAX_DIST ) +
+           numMasked * maskedCost;
+}
+
 
 typedef KisSharedPtr<MaskedImage> MaskedImageSP;
 
@@ -514,15 +590,52 @@ class NearestNeighborField : public KisShared
 {
 
 private:
+    //a band of rows of the field processed by a single thread
+    struct FieldBand {
+        int top;
+        int bottom;
+        std::mt19937 random;
+    };
+
+    template< typename T> T randomInt(std::mt19937 &random, T range)
+    {
+        return std::uniform_int_distribution<T>(0, range - 1)(random);
+    }
+
     template< typename T> T randomInt(T range)
     {
-        return rand() % range;
+        return randomInt(m_random, range);
+    }
+
+    //splits the rows of the field into bands with own random generators
+    QVector<FieldBand> splitIntoBands(void)
+    {
+        const int numBands = parallelBandsCount(imSize.height());
+
+        QVector<FieldBand> bands;
+        for (int i = 0; i < numBands; i++) {
+            FieldBand band;
+            band.top = i * imSize.height() / numBands;
+            band.bottom = (i + 1) * imSize.height() / numBands - 1;
+            band.random.seed(m_random());
+            bands.append(band);
+        }
+        return bands;
     }
 
     //compute initial value of the distance term
     void initialize(void)
     {
-        for (int y = 0; y < imSize.height(); y++) {
+        QVector<FieldBand> bands = splitIntoBands();
+
+        QtConcurrent::blockingMap(bands, [this] (FieldBand &band) {
+            initializeBand(band);
+        });
+    }
+
+    void initializeBand(FieldBand &band)
+    {
+        for (int y = band.top; y <= band.bottom; y++) {
             for (int x = 0; x < imSize.width(); x++) {
                 field[x][y].distance = distance(x, y, field[x][y].x, field[x][y].y);
 
@@ -530,8 +643,8 @@ private:
                 int iter = 0;
                 const int maxretry = 20;
                 while (field[x][y].distance == MAX_DIST && iter < maxretry) {
-                    field[x][y].x = randomInt(imSize.width() + 1);
-                    field[x][y].y = randomInt(imSize.height() + 1);
+                    field[x][y].x = randomInt(band.random, imSize.width() + 1);
+                    field[x][y].y = randomInt(band.random, imSize.height() + 1);
                     field[x][y].distance = distance(x, y, field[x][y].x, field[x][y].y);
                     iter++;
                 }
@@ -558,6 +671,7 @@ private:
 
 private:
     int patchSize; //patch size
+    std::mt19937 m_random;
 public:
     MaskedImageSP input;
     MaskedImageSP output;
@@ -609,29 +723,56 @@ public:
     }
 
     //multi-pass NN-field minimization (see "PatchMatch" paper referenced above - page 4)
+    //
+    //The bands of rows are minimized in parallel. The propagation reads the neighbouring
+    //row only, so the even bands are processed first and the odd ones next, then no thread
+    //reads the rows another thread is writing to.
     void minimize(int pass)
     {
-        int min_x = 0;
-        int min_y = 0;
-        int max_x = imSize.width() - 1;
-        int max_y = imSize.height() - 1;
+        QVector<FieldBand> bands = splitIntoBands();
+
+        QVector<FieldBand> evenBands;
+        QVector<FieldBand> oddBands;
+        for (int i = 0; i < bands.size(); i++) {
+            (i % 2 ? oddBands : evenBands).append(bands[i]);
+        }
 
         for (int i = 0; i < pass; i++) {
             //scanline order
-            for (int y = min_y; y < max_y; y++)
-                for (int x = min_x; x <= max_x; x++)
-                    if (field[x][y].distance > 0)
-                        minimizeLink(x, y, 1);
+            minimizeBands(evenBands, 1);
+            minimizeBands(oddBands, 1);
 
             //reverse scanline order
-            for (int y = max_y; y >= min_y; y--)
-                for (int x = max_x; x >= min_x; x--)
+            minimizeBands(oddBands, -1);
+            minimizeBands(evenBands, -1);
+        }
+    }
+
+    void minimizeBands(QVector<FieldBand> &bands, int dir)
+    {
+        QtConcurrent::blockingMap(bands, [this, dir] (FieldBand &band) {
+            minimizeBand(band, dir);
+        });
+    }
+
+    void minimizeBand(FieldBand &band, int dir)
+    {
+        const int max_x = imSize.width() - 1;
+
+        if (dir > 0) {
+            for (int y = band.top; y <= band.bottom; y++)
+                for (int x = 0; x <= max_x; x++)
                     if (field[x][y].distance > 0)
-                        minimizeLink(x, y, -1);
+                        minimizeLink(x, y, 1, band.random);
+        } else {
+            for (int y = band.bottom; y >= band.top; y--)
+                for (int x = max_x; x >= 0; x--)
+                    if (field[x][y].distance > 0)
+                        minimizeLink(x, y, -1, band.random);
         }
     }
 
-    void minimizeLink(int x, int y, int dir)
+    void minimizeLink(int x, int y, int dir, std::mt19937 &random)
     {
         int xp, yp, dp;
 
@@ -664,8 +805,8 @@ public:
         int xpi = field[x][y].x;
         int ypi = field[x][y].y;
         while (wi > 0) {
-            xp = xpi + randomInt(2 * wi) - wi;
-            yp = ypi + randomInt(2 * wi) - wi;
+            xp = xpi + randomInt(random, 2 * wi) - wi;
+            yp = ypi + randomInt(random, 2 * wi) - wi;
             xp = std::max(0, std::min(output->size().width() - 1, xp));
             yp = std::max(0, std::min(output->size().height() - 1, yp));
 
@@ -682,56 +823,40 @@ public:
     //compute distance between two patches
     int distance(int x, int y, int xp, int yp)
     {
-        float distance = 0;
-        float wsum = 0;
-        float ssdmax = nColors * 255 * 255;
-
-        //for each pixel in the source patch
-        for (int dy = -patchSize; dy <= patchSize; dy++) {
-            for (int dx = -patchSize; dx <= patchSize; dx++) {
-                wsum += ssdmax;
-                int xks = x + dx;
-                int yks = y + dy;
+        const int patchWidth = 2 * patchSize + 1;
+        const float ssdmax = nColors * 255 * 255;
+        const float wsum = patchWidth * patchWidth * ssdmax;
 
-                if (xks < 0 || xks >= input->size().width()) {
-                    distance += ssdmax;
-                    continue;
-                }
+        const QRect inputSize = input->size();
+        const QRect outputSize = output->size();
 
-                if (yks < 0 || yks >= input->size().height()) {
-                    distance += ssdmax;
-                    continue;
-                }
+        //the part of the patch that lies inside both images, the rest is counted as "infinity"
+        const int dxMin = std::max(-patchSize, std::max(-x, -xp));
+        const int dxMax = std::min(patchSize, std::min(inputSize.width() - 1 - x, outputSize.width() - 1 - xp));
+        const int rowPixels = dxMax - dxMin + 1;
 
-                //cannot use masked pixels as a valid source of information
-                if (input->isMasked(xks, yks)) {
-                    distance += ssdmax;
-                    continue;
-                }
+        if (rowPixels <= 0) {
+            return MAX_DIST;
+        }
 
-                //corresponding pixel in target patch
-                int xkt = xp + dx;
-                int ykt = yp + dy;
-                if (xkt < 0 || xkt >= output->size().width()) {
-                    distance += ssdmax;
-                    continue;
-                }
-                if (ykt < 0 || ykt >= output->size().height()) {
-                    distance += ssdmax;
-                    continue;
-                }
+        float distance = 0;
 
-                //cannot use masked pixels as a valid source of information
-                if (output->isMasked(xkt, ykt)) {
-                    distance += ssdmax;
-                    continue;
-                }
+        //for each row of the source patch
+        for (int dy = -patchSize; dy <= patchSize; dy++) {
+            int yks = y + dy;
+            int ykt = yp + dy;
 
-                //SSD distance between pixels
-                float ssd = input->distance(*input, xks, yks, *output, xkt, ykt);
-                distance += ssd;
+            if (yks < 0 || yks >= inputSize.height() ||
+                ykt < 0 || ykt >= outputSize.height()) {
 
+                distance += patchWidth * ssdmax;
+                continue;
             }
+
+            distance += (patchWidth - rowPixels) * ssdmax;
+
+            //SSD distance between the rows, masked pixels cannot be used as a valid source of information
+            distance += input->rowDistance(*input, x + dxMin, yks, *output, xp + dxMin, ykt, rowPixels, ssdmax);
         }
         return (int)(MAX_DIST * (distance / wsum));
     }
@@ -892,74 +1017,83 @@ void NearestNeighborField::ExpectationStep(NearestNeighborFieldSP nnf, MaskedIma
     int H_source = source->size().height();
     int W_source = source->size().width();
 
-    std::vector< quint8* > pixels;
-    std::vector< float > weights;
-    pixels.reserve(R * R);
-    weights.reserve(R * R);
-    for (int x = 0 ; x < W_target ; ++x) {
-        for (int y = 0 ; y < H_target; ++y) {
-            float wsum = 0;
-            pixels.clear();
-            weights.clear();
-
-
-            if (!source->containsMasked(x, y, R + 4) /*&& upscale*/) {
-                //speedup computation by copying parts that are not masked.
-                pixels.push_back(source->getImagePixel(x, y));
-                weights.push_back(1.f);
-                target->mixColors(pixels, weights, 1.f, target->getImagePixel(x, y));
-            } else {
-                for (int dx = -R ; dx <= R; ++dx) {
-                    for (int dy = -R ; dy <= R ; ++dy) {
-                        // xpt,ypt = center pixel of the target patch
-                        int xpt = x + dx;
-                        int ypt = y + dy;
-
-                        int xst, yst;
-                        float w;
+    //every pixel of the target is mixed independently, so the columns are split into bands
+    const int numBands = parallelBandsCount(W_target);
+    QVector<QPair<int, int>> bands;
+    for (int i = 0; i < numBands; i++) {
+        bands.append(qMakePair(i * W_target / numBands, (i + 1) * W_target / numBands));
+    }
 
-                        if (!upscale) {
-                            if (xpt < 0 || xpt >= W_nnf || ypt < 0 || ypt >= H_nnf)
+    QtConcurrent::blockingMap(bands, [&] (const QPair<int, int> &band) {
+        std::vector< quint8* > pixels;
+        std::vector< float > weights;
+        pixels.reserve(R * R);
+        weights.reserve(R * R);
+        for (int x = band.first ; x < band.second ; ++x) {
+            for (int y = 0 ; y < H_target; ++y) {
+                float wsum = 0;
+                pixels.clear();
+                weights.clear();
+
+
+                if (!source->containsMasked(x, y, R + 4) /*&& upscale*/) {
+                    //speedup computation by copying parts that are not masked.
+                    pixels.push_back(source->getImagePixel(x, y));
+                    weights.push_back(1.f);
+                    target->mixColors(pixels, weights, 1.f, target->getImagePixel(x, y));
+                } else {
+                    for (int dx = -R ; dx <= R; ++dx) {
+                        for (int dy = -R ; dy <= R ; ++dy) {
+                            // xpt,ypt = center pixel of the target patch
+                            int xpt = x + dx;
+                            int ypt = y + dy;
+
+                            int xst, yst;
+                            float w;
+
+                            if (!upscale) {
+                                if (xpt < 0 || xpt >= W_nnf || ypt < 0 || ypt >= H_nnf)
+                                    continue;
+
+                                xst = nnf->field[xpt][ypt].x;
+                                yst = nnf->field[xpt][ypt].y;
+                                float dp = nnf->field[xpt][ypt].distance;
+                                // similarity measure between the two patches
+                                w = nnf->similarity[dp];
+
+                            } else {
+                                if (xpt < 0 || (xpt / 2) >= W_nnf || ypt < 0 || (ypt / 2) >= H_nnf)
+                                    continue;
+                                xst = 2 * nnf->field[xpt / 2][ypt / 2].x + (xpt % 2);
+                                yst = 2 * nnf->field[xpt / 2][ypt / 2].y + (ypt % 2);
+                                float dp = nnf->field[xpt / 2][ypt / 2].distance;
+                                // similarity measure between the two patches
+                                w = nnf->similarity[dp];
+                            }
+
+                            int xs = xst - dx;
+                            int ys = yst - dy;
+
+                            if (xs < 0 || xs >= W_source || ys < 0 || ys >= H_source)
                                 continue;
 
-                            xst = nnf->field[xpt][ypt].x;
-                            yst = nnf->field[xpt][ypt].y;
-                            float dp = nnf->field[xpt][ypt].distance;
-                            // similarity measure between the two patches
-                            w = nnf->similarity[dp];
-
-                        } else {
-                            if (xpt < 0 || (xpt / 2) >= W_nnf || ypt < 0 || (ypt / 2) >= H_nnf)
+                            if (source->isMasked(xs, ys))
                                 continue;
-                            xst = 2 * nnf->field[xpt / 2][ypt / 2].x + (xpt % 2);
-                            yst = 2 * nnf->field[xpt / 2][ypt / 2].y + (ypt % 2);
-                            float dp = nnf->field[xpt / 2][ypt / 2].distance;
-                            // similarity measure between the two patches
-                            w = nnf->similarity[dp];
-                        }
-
-                        int xs = xst - dx;
-                        int ys = yst - dy;
-
-                        if (xs < 0 || xs >= W_source || ys < 0 || ys >= H_source)
-                            continue;
-
-                        if (source->isMasked(xs, ys))
-                            continue;
 
-                        pixels.push_back(source->getImagePixel(xs, ys));
-                        weights.push_back(w);
-                        wsum += w;
+                            pixels.push_back(source->getImagePixel(xs, ys));
+                            weights.push_back(w);
+                            wsum += w;
+                        }
                     }
-                }
 
-                if (wsum < 1)
-                    continue;
+                    if (wsum < 1)
+                        continue;
 
-                target->mixColors(pixels, weights, wsum, target->getImagePixel(x, y));
+                    target->mixColors(pixels, weights, wsum, target->getImagePixel(x, y));
+                }
             }
         }
-    }
+    });
 }
 
 QRect getMaskBoundingBox(KisPaintDeviceSP maskDev)
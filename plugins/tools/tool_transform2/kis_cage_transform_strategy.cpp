@@ -85,3 +85,22 @@ QImage KisCageTransformStrategy::calculateTransformedImage(ToolTransformArgs &cu
     worker.setTransformedCage(transfPoints);
     return worker.runOnQImage(dstOffset);
 }
+
+bool KisCageTransformStrategy::calculateTransformedMesh(ToolTransformArgs &currentArgs,
+                                                        const QRectF &srcBounds,
+                                                        const QVector<QPointF> &origPoints,
+                                                        const QVector<QPointF> &transfPoints,
+                                                        QVector<QPolygonF> *srcPolygons,
+                                                        QVector<QPolygonF> *dstPolygons)
+{
+    Q_UNUSED(currentArgs);
+    Q_UNUSED(srcBounds);
+    Q_UNUSED(origPoints);
+    Q_UNUSED(transfPoints);
+    Q_UNUSED(srcPolygons);
+    Q_UNUSED(dstPolygons);
+
+    // the cage is not a function of a regular grid, so it
+    // keeps rasterizing the preview on the CPU
+    return false;
+}
@@ -42,6 +42,13 @@ protected:
                                      const QPointF &srcOffset,
                                      QPointF *dstOffset) override;
 
+    bool calculateTransformedMesh(ToolTransformArgs &currentArgs,
+                                  const QRectF &srcBounds,
+                                  const QVector<QPointF> &origPoints,
+                                  const QVector<QPointF> &transfPoints,
+                                  QVector<QPolygonF> *srcPolygons,
+                                  QVector<QPolygonF> *dstPolygons) override;
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
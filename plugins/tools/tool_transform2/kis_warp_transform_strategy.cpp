@@ -21,6 +21,7 @@
 #include "kis_algebra_2d.h"
 #include "KisHandlePainterHelper.h"
 #include "kis_signal_compressor.h"
+#include "kis_config.h"
 
 
 
@@ -43,6 +44,8 @@ struct KisWarpTransformStrategy::Private
           pointWasDragged(false),
           recalculateSignalCompressor(40, KisSignalCompressor::FIRST_ACTIVE)
     {
+        KisConfig cfg(true);
+        useMeshPreview = cfg.useOpenGL();
     }
 
     KisWarpTransformStrategy * const q;
@@ -65,6 +68,16 @@ struct KisWarpTransformStrategy::Private
 
     QImage transformedImage;
 
+    /**
+     * On the OpenGL canvas the original image is uploaded as a texture
+     * once and the preview is painted as a textured mesh, which is much
+     * cheaper than rasterizing the warp on every mouse move
+     */
+    bool useMeshPreview;
+    QVector<QPolygonF> meshSrcPolygons;
+    QVector<QPolygonF> meshDstPolygons;
+    QPointF meshSrcOffset;
+
     int pointIndexUnderCursor;
 
     enum Mode {
@@ -235,7 +248,28 @@ void KisWarpTransformStrategy::paint(QPainter &gc)
 
     gc.setOpacity(m_d->transaction.basePreviewOpacity());
     gc.setTransform(m_d->paintingTransform, true);
-    gc.drawImage(m_d->paintingOffset, m_d->transformedImage);
+
+    if (!m_d->meshDstPolygons.isEmpty()) {
+        const QTransform baseTransform = gc.transform();
+        const QImage &srcImage = originalImage();
+
+        gc.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+        for (int i = 0; i < m_d->meshSrcPolygons.size(); i++) {
+            const QPolygonF srcPolygon = m_d->meshSrcPolygons[i].translated(-m_d->meshSrcOffset);
+            QTransform cellTransform;
+
+            if (!QTransform::quadToQuad(srcPolygon, m_d->meshDstPolygons[i], cellTransform)) {
+                continue;
+            }
+
+            const QRectF srcRect = srcPolygon.boundingRect();
+            gc.setTransform(cellTransform * baseTransform);
+            gc.drawImage(srcRect.topLeft(), srcImage, srcRect);
+        }
+    } else {
+        gc.drawImage(m_d->paintingOffset, m_d->transformedImage);
+    }
 
     gc.restore();
 
@@ -593,6 +627,39 @@ void KisWarpTransformStrategy::Private::recalculateTransformations()
 
     paintingOffset = transaction.originalTopLeft();
 
+    meshSrcPolygons.clear();
+    meshDstPolygons.clear();
+
+    if (useMeshPreview && !q->originalImage().isNull() && !currentArgs.isEditingTransformPoints()) {
+        if (useFlakeOptimization) {
+            useFlakeOptimization = false;
+
+            for (int i = 0; i < currentArgs.numPoints(); ++i) {
+                thumbOrigPoints[i] = imageToThumb(currentArgs.origPoints()[i], false);
+                thumbTransfPoints[i] = imageToThumb(currentArgs.transfPoints()[i], false);
+            }
+        }
+
+        meshSrcOffset = imageToThumb(transaction.originalTopLeft(), false);
+        const QRectF srcBounds(meshSrcOffset, q->originalImage().size());
+
+        if (q->calculateTransformedMesh(currentArgs, srcBounds,
+                                        thumbOrigPoints, thumbTransfPoints,
+                                        &meshSrcPolygons, &meshDstPolygons)) {
+
+            // the original image is painted directly, so its texture
+            // stays cached between the updates
+            transformedImage = QImage();
+            paintingTransform = resultThumbTransform;
+            handlesTransform = scaleTransform;
+            emit q->requestCanvasUpdate();
+            return;
+        }
+
+        meshSrcPolygons.clear();
+        meshDstPolygons.clear();
+    }
+
     if (!q->originalImage().isNull() && !currentArgs.isEditingTransformPoints()) {
         QPointF origTLInFlake = imageToThumb(transaction.originalTopLeft(), useFlakeOptimization);
 
@@ -636,4 +703,19 @@ QImage KisWarpTransformStrategy::calculateTransformedImage(ToolTransformArgs &cu
         srcOffset, dstOffset);
 }
 
+bool KisWarpTransformStrategy::calculateTransformedMesh(ToolTransformArgs &currentArgs,
+                                                        const QRectF &srcBounds,
+                                                        const QVector<QPointF> &origPoints,
+                                                        const QVector<QPointF> &transfPoints,
+                                                        QVector<QPolygonF> *srcPolygons,
+                                                        QVector<QPolygonF> *dstPolygons)
+{
+    return KisWarpTransformWorker::transformMesh(
+        currentArgs.warpType(),
+        origPoints, transfPoints,
+        currentArgs.alpha(),
+        srcBounds,
+        srcPolygons, dstPolygons);
+}
+
 #include "moc_kis_warp_transform_strategy.cpp"
@@ -19,6 +19,8 @@ class ToolTransformArgs;
 class TransformTransactionProperties;
 class QCursor;
 class QImage;
+class QRectF;
+class QPolygonF;
 
 enum TransformType {
     WARP_TRANSFORM,
@@ -81,6 +83,19 @@ protected:
                                              const QVector<QPointF> &transfPoints,
                                              const QPointF &srcOffset,
                                              QPointF *dstOffset);
+
+    /**
+     * Calculates the cells of the transformed grid instead of the
+     * transformed image, so that the preview could be painted as a
+     * textured mesh by the canvas. Returns false if the strategy
+     * doesn't support mesh previews.
+     */
+    virtual bool calculateTransformedMesh(ToolTransformArgs &currentArgs,
+                                          const QRectF &srcBounds,
+                                          const QVector<QPointF> &origPoints,
+                                          const QVector<QPointF> &transfPoints,
+                                          QVector<QPolygonF> *srcPolygons,
+                                          QVector<QPolygonF> *dstPolygons);
 private:
     struct Private;
     const QScopedPointer<Private> m_d;